@@ -11,8 +11,39 @@ struct ShadowUniforms {
     float    normalBias;
     float    maxRayDistance;
     uint     reversedZ;      // 1 if using reversed-Z, 0 otherwise
+    uint     traceDownsample; // one ray per traceDownsample^2 pixels
+    uint     frameIndex;
+    float    lightConeTan;    // tan of the light's angular radius; 0 traces hard shadows
 };
 
+// Ray placement; keep in sync with Shaders/Shared/shadow_trace.slang, which the
+// denoiser uses to find the pixel each texel was traced from.
+static inline uint2 shadowTracePixel(uint2 texel, uint downsample, uint frameIndex) {
+    if (downsample < 2u) {
+        return texel;
+    }
+    const uint2 bayerOrder[4] = { uint2(0u, 0u), uint2(1u, 1u), uint2(1u, 0u), uint2(0u, 1u) };
+    uint slot = (frameIndex + (texel.x & 1u) + (texel.y & 1u) * 2u) & 3u;
+    return texel * 2u + bayerOrder[slot];
+}
+
+static inline float shadowTraceNoise(uint2 pixel, uint frameIndex, float2 offset) {
+    float2 p = float2(pixel) + offset + 5.588238 * float(frameIndex & 63u);
+    return fract(52.9829189 * fract(dot(p, float2(0.06711056, 0.00583715))));
+}
+
+static inline float3 sampleLightCone(float3 lightDir, uint2 pixel, uint frameIndex, float coneTan) {
+    if (coneTan <= 0.0) {
+        return lightDir;
+    }
+    float radius = sqrt(shadowTraceNoise(pixel, frameIndex, float2(0.0, 0.0))) * coneTan;
+    float angle = 6.28318531 * shadowTraceNoise(pixel, frameIndex, float2(47.0, 17.0));
+    float3 up = fabs(lightDir.y) < 0.999 ? float3(0.0, 1.0, 0.0) : float3(1.0, 0.0, 0.0);
+    float3 tangent = normalize(cross(up, lightDir));
+    float3 bitangent = cross(lightDir, tangent);
+    return normalize(lightDir + (tangent * cos(angle) + bitangent * sin(angle)) * radius);
+}
+
 static inline bool isSkyDepth(float depth, constant ShadowUniforms& uniforms) {
     float skyClear = uniforms.reversedZ ? 0.0 : 1.0;
     return fabs(depth - skyClear) < 1e-6;
@@ -112,15 +143,18 @@ kernel void shadowRayMain(
     instance_acceleration_structure tlas [[buffer(1)]],
     texture2d<float, access::read> depthTex [[texture(0)]],
     texture2d<float, access::write> shadowMap [[texture(1)]],
-    uint2 tid [[thread_position_in_grid]])
+    uint2 texel [[thread_position_in_grid]])
 {
-    if (tid.x >= uniforms.screenWidth || tid.y >= uniforms.screenHeight)
+    uint downsample = max(uniforms.traceDownsample, 1u);
+    uint2 screenSize = uint2(uniforms.screenWidth, uniforms.screenHeight);
+    if (any(texel >= (screenSize + downsample - 1u) / downsample))
         return;
+    uint2 tid = min(shadowTracePixel(texel, downsample, uniforms.frameIndex), screenSize - 1u);
 
     float depth = depthTex.read(tid).x;
 
     if (isSkyDepth(depth, uniforms)) {
-        shadowMap.write(float4(1.0), tid);
+        shadowMap.write(float4(1.0), texel);
         return;
     }
 
@@ -132,7 +166,7 @@ kernel void shadowRayMain(
     // Trace shadow ray
     ray shadowRay;
     shadowRay.origin = origin;
-    shadowRay.direction = lightDir;
+    shadowRay.direction = sampleLightCone(lightDir, tid, uniforms.frameIndex, uniforms.lightConeTan);
     shadowRay.min_distance = 0.001;
     shadowRay.max_distance = uniforms.maxRayDistance;
 
@@ -142,5 +176,5 @@ kernel void shadowRayMain(
     auto result = inter.intersect(shadowRay, tlas);
 
     float shadow = (result.type == intersection_type::none) ? 1.0 : 0.0;
-    shadowMap.write(float4(shadow), tid);
+    shadowMap.write(float4(shadow), texel);
 }
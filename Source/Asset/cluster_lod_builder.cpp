@@ -1,9 +1,15 @@
 #include "cluster_lod_builder.h"
 
+#include "mapped_file.h"
 #include "mesh_loader.h"
+#include "mesh_signature.h"
+#include "parallel_for.h"
 #include "rhi_resource_utils.h"
+#include "startup_profile.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cfloat>
@@ -16,27 +22,31 @@
 #include <limits>
 #include <meshoptimizer.h>
 #include <numeric>
+#include <span>
 #include <spdlog/spdlog.h>
 #include <sstream>
 #include <system_error>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace {
 
-static constexpr size_t kLodMaxVertices = 32;
-static constexpr size_t kLodMinTriangles = 8;
-static constexpr size_t kLodMaxTriangles = 32;
 static constexpr size_t kPartitionSize = 8;
 static constexpr size_t kHierarchyNodeWidth = 8;
 static constexpr float kSimplifyRatio = 0.5f;
 static constexpr float kSimplifyThreshold = 0.85f;
 static constexpr float kClusterSplit = 2.0f;
+// Interleaved normal xyz + uv per vertex for meshopt_simplifyWithAttributes. UVs
+// weigh more than normals so seams and texture detail outlive shading creases.
+static constexpr size_t kSimplifyAttributeCount = 5;
+static constexpr float kSimplifyAttributeWeights[kSimplifyAttributeCount] = {0.25f, 0.25f, 0.25f, 0.5f, 0.5f};
 
 constexpr char kClusterLodCacheMagic[8] = {'M', 'L', 'C', 'L', 'O', 'D', '0', '1'};
-constexpr uint32_t kClusterLodCacheVersion = 2;
-constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
-constexpr uint64_t kFnvPrime = 1099511628211ull;
+constexpr uint32_t kClusterLodCacheVersion = 10;
+constexpr uint64_t kClusterLodCacheSectionAlignment = 64;
+constexpr bool kCompressClusterLodCacheIndices = true;
 constexpr uint32_t kInvalidIndex = UINT32_MAX;
 
 struct Cluster {
@@ -53,11 +63,87 @@ struct BoundsResult {
     float error = 0.0f;
 };
 
+// Adds the scope's wall time to a ClusterLODStageTimings counter; a null counter
+// skips the clock reads.
+class StageTimer {
+public:
+    explicit StageTimer(std::atomic<uint64_t>* counter)
+        : m_counter(counter),
+          m_start(counter ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+
+    ~StageTimer() {
+        if (m_counter) {
+            const auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_counter->fetch_add(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    std::atomic<uint64_t>* m_counter;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+std::atomic<uint64_t>* stageCounter(ClusterLODStageTimings* timings, std::atomic<uint64_t> ClusterLODStageTimings::*stage) {
+    return timings ? &(timings->*stage) : nullptr;
+}
+
+struct GroupSimplifyResult {
+    BoundsResult bounds;
+    bool isTerminal = true;
+    // Reduced by the meshopt_simplifySloppy fallback, or not reducible at all.
+    bool usedSloppy = false;
+    bool stuck = false;
+    float nextError = 0.0f;
+    std::vector<Cluster> newClusters;
+};
+
 struct NodeRange {
     uint32_t offset = 0;
     uint32_t count = 0;
 };
 
+enum ClusterLODCacheSectionIndex : uint32_t {
+    kCacheSectionMeshlets = 0,
+    kCacheSectionMeshletVertices,
+    kCacheSectionPackedTriangles,
+    kCacheSectionBounds,
+    kCacheSectionMaterialIDs,
+    kCacheSectionGroupMeshletIndices,
+    kCacheSectionGroups,
+    kCacheSectionNodes,
+    kCacheSectionLevels,
+    kCacheSectionPrimitiveGroupRoots,
+    kCacheSectionPackedClusters,
+    kCacheSectionClusterVertexData,
+    kCacheSectionClusterIndexData,
+    kCacheSectionGroupPages,
+    kCacheSectionCount
+};
+
+// Raw sections are mapped in place. Varint sections store each uint32 as
+// LEB128; DeltaVarint stores the zigzagged difference to the previous element
+// first, which suits the mostly-ascending meshlet and group index lists.
+enum ClusterLODCacheEncoding : uint32_t {
+    kCacheEncodingRaw = 0,
+    kCacheEncodingVarint,
+    kCacheEncodingDeltaVarint
+};
+
+struct ClusterLODCacheSection {
+    uint64_t offset = 0;
+    uint64_t count = 0;
+    uint64_t byteSize = 0;
+    uint32_t elementSize = 0;
+    uint32_t encoding = kCacheEncodingRaw;
+};
+
+// Sections start on kClusterLodCacheSectionAlignment boundaries so a mapped
+// cache file can be viewed in place without copying into vectors.
 struct ClusterLODCacheHeader {
     char magic[8] = {};
     uint32_t version = 0;
@@ -66,28 +152,61 @@ struct ClusterLODCacheHeader {
     uint32_t maxTriangles = 0;
     uint32_t partitionSize = 0;
     uint32_t hierarchyNodeWidth = 0;
+    uint32_t sectionCount = 0;
     uint32_t reserved0 = 0;
     float simplifyRatio = 0.0f;
     float simplifyThreshold = 0.0f;
     float clusterSplit = 0.0f;
     float reserved1 = 0.0f;
     uint64_t meshSignature = 0;
-    uint64_t meshletCount = 0;
-    uint64_t meshletVertexCount = 0;
-    uint64_t packedTriangleCount = 0;
-    uint64_t boundsCount = 0;
-    uint64_t materialCount = 0;
-    uint64_t groupMeshletIndexCount = 0;
-    uint64_t groupCount = 0;
-    uint64_t nodeCount = 0;
-    uint64_t levelCount = 0;
-    uint64_t primitiveGroupRootCount = 0;
+    uint64_t fileSize = 0;
+    ClusterLODCacheSection sections[kCacheSectionCount] = {};
+};
+
+// Non-owning view over a complete ClusterLOD payload, backed either by
+// ClusterLODData vectors or by a mapped cache file.
+struct ClusterLODPayloadView {
+    std::span<const GPUMeshlet> meshlets;
+    std::span<const unsigned int> meshletVertices;
+    std::span<const uint32_t> packedTriangles;
+    std::span<const GPUMeshletBounds> bounds;
+    std::span<const uint32_t> materialIDs;
+    std::span<const uint32_t> groupMeshletIndices;
+    std::span<const GPUClusterGroup> groups;
+    std::span<const GPULodNode> nodes;
+    std::span<const ClusterLODLevel> levels;
+    std::span<const uint32_t> primitiveGroupLodRoots;
+    std::span<const PackedCluster> packedClusters;
+    std::span<const uint8_t> clusterVertexData;
+    std::span<const uint8_t> clusterIndexData;
+    std::span<const ClusterLODPage> pages;
 };
 
 static_assert(std::is_trivially_copyable_v<ClusterLODCacheHeader>);
 static_assert(std::is_trivially_copyable_v<GPUClusterGroup>);
 static_assert(std::is_trivially_copyable_v<GPULodNode>);
 static_assert(std::is_trivially_copyable_v<ClusterLODLevel>);
+static_assert(std::is_trivially_copyable_v<PackedCluster>);
+static_assert(std::is_trivially_copyable_v<ClusterLODPage>);
+
+ClusterLODPayloadView makePayloadView(const ClusterLODData& data) {
+    ClusterLODPayloadView view;
+    view.meshlets = data.allMeshlets;
+    view.meshletVertices = data.allMeshletVertices;
+    view.packedTriangles = data.allPackedTriangles;
+    view.bounds = data.allBounds;
+    view.materialIDs = data.allMaterialIDs;
+    view.groupMeshletIndices = data.groupMeshletIndices;
+    view.groups = data.groups;
+    view.nodes = data.nodes;
+    view.levels = data.levels;
+    view.primitiveGroupLodRoots = data.primitiveGroupLodRoots;
+    view.packedClusters = data.packedClusters;
+    view.clusterVertexData = data.clusterVertexData;
+    view.clusterIndexData = data.clusterIndexData;
+    view.pages = data.pages;
+    return view;
+}
 
 void releaseClusterLODHandles(ClusterLODData& data) {
     rhiReleaseHandle(data.meshletBuffer);
@@ -104,47 +223,6 @@ void releaseClusterLODHandles(ClusterLODData& data) {
     rhiReleaseHandle(data.clusterIndexDataBuffer);
 }
 
-void hashBytes(uint64_t& hash, const void* data, size_t size) {
-    const auto* bytes = static_cast<const uint8_t*>(data);
-    for (size_t i = 0; i < size; ++i) {
-        hash ^= bytes[i];
-        hash *= kFnvPrime;
-    }
-}
-
-template <typename T>
-void hashValue(uint64_t& hash, const T& value) {
-    static_assert(std::is_trivially_copyable_v<T>);
-    hashBytes(hash, &value, sizeof(T));
-}
-
-uint64_t computeMeshSignature(const LoadedMesh& mesh) {
-    uint64_t hash = kFnvOffsetBasis;
-    hashValue(hash, mesh.vertexCount);
-    hashValue(hash, mesh.indexCount);
-    hashValue(hash, mesh.hasBakedRootScale);
-    hashValue(hash, mesh.bakedRootScale);
-
-    if (!mesh.cpuPositions.empty()) {
-        hashBytes(hash, mesh.cpuPositions.data(), mesh.cpuPositions.size() * sizeof(float));
-    }
-    if (!mesh.cpuIndices.empty()) {
-        hashBytes(hash, mesh.cpuIndices.data(), mesh.cpuIndices.size() * sizeof(uint32_t));
-    }
-
-    const uint32_t primitiveGroupCount = static_cast<uint32_t>(mesh.primitiveGroups.size());
-    hashValue(hash, primitiveGroupCount);
-    for (const auto& group : mesh.primitiveGroups) {
-        hashValue(hash, group.indexOffset);
-        hashValue(hash, group.indexCount);
-        hashValue(hash, group.vertexOffset);
-        hashValue(hash, group.vertexCount);
-        hashValue(hash, group.materialIndex);
-    }
-
-    return hash;
-}
-
 std::string sanitizeCacheStem(std::string stem) {
     if (stem.empty()) {
         return "scene";
@@ -177,41 +255,175 @@ std::filesystem::path makeCacheFilePath(const std::string& sourcePath,
     return std::filesystem::path(cacheDirectory) / fileName.str();
 }
 
-template <typename T>
-bool writeVector(std::ofstream& file, const std::vector<T>& values) {
-    static_assert(std::is_trivially_copyable_v<T>);
-    if (values.empty()) {
-        return true;
-    }
+uint64_t alignCacheOffset(uint64_t offset) {
+    return (offset + kClusterLodCacheSectionAlignment - 1) & ~(kClusterLodCacheSectionAlignment - 1);
+}
 
-    const size_t byteSize = values.size() * sizeof(T);
-    if (byteSize > static_cast<size_t>(std::numeric_limits<std::streamsize>::max())) {
+// Visits every payload array in cache section order. View may be const (save)
+// or mutable (mapping a loaded file back into spans).
+template <typename View, typename Fn>
+void forEachCacheSection(View& view, Fn&& fn) {
+    fn(kCacheSectionMeshlets, view.meshlets);
+    fn(kCacheSectionMeshletVertices, view.meshletVertices);
+    fn(kCacheSectionPackedTriangles, view.packedTriangles);
+    fn(kCacheSectionBounds, view.bounds);
+    fn(kCacheSectionMaterialIDs, view.materialIDs);
+    fn(kCacheSectionGroupMeshletIndices, view.groupMeshletIndices);
+    fn(kCacheSectionGroups, view.groups);
+    fn(kCacheSectionNodes, view.nodes);
+    fn(kCacheSectionLevels, view.levels);
+    fn(kCacheSectionPrimitiveGroupRoots, view.primitiveGroupLodRoots);
+    fn(kCacheSectionPackedClusters, view.packedClusters);
+    fn(kCacheSectionClusterVertexData, view.clusterVertexData);
+    fn(kCacheSectionClusterIndexData, view.clusterIndexData);
+    fn(kCacheSectionGroupPages, view.pages);
+}
+
+bool writeCacheSection(std::ofstream& file,
+                       const ClusterLODCacheSection& section,
+                       const void* data,
+                       uint64_t& cursor) {
+    static constexpr char kPadding[kClusterLodCacheSectionAlignment] = {};
+    if (section.offset < cursor || section.offset - cursor > sizeof(kPadding)) {
         return false;
     }
+    file.write(kPadding, static_cast<std::streamsize>(section.offset - cursor));
 
-    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(byteSize));
+    const uint64_t byteSize = section.byteSize;
+    if (byteSize > static_cast<uint64_t>(std::numeric_limits<std::streamsize>::max())) {
+        return false;
+    }
+    if (byteSize > 0) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(byteSize));
+    }
+    cursor = section.offset + byteSize;
     return static_cast<bool>(file);
 }
 
 template <typename T>
-bool readVector(std::ifstream& file, uint64_t count, std::vector<T>& out) {
+bool mapCacheSection(const MappedFile& file,
+                     const ClusterLODCacheSection& section,
+                     std::span<const T>& out) {
     static_assert(std::is_trivially_copyable_v<T>);
-    if (count == 0) {
-        out.clear();
-        return true;
+    if (section.encoding != kCacheEncodingRaw ||
+        section.elementSize != sizeof(T) ||
+        section.offset % kClusterLodCacheSectionAlignment != 0 ||
+        section.offset > file.size() ||
+        section.count > (file.size() - section.offset) / sizeof(T) ||
+        section.byteSize != section.count * sizeof(T)) {
+        return false;
+    }
+
+    out = std::span<const T>(reinterpret_cast<const T*>(file.data() + section.offset),
+                             static_cast<size_t>(section.count));
+    return true;
+}
+
+template <typename T>
+constexpr bool kIsCacheIndexElement = std::is_integral_v<T> && sizeof(T) == sizeof(uint32_t);
+
+uint32_t cacheSectionEncoding(uint32_t sectionIndex) {
+    if (!kCompressClusterLodCacheIndices) {
+        return kCacheEncodingRaw;
+    }
+
+    switch (sectionIndex) {
+    // Group meshlet indices stay raw so streaming can read each group's slice
+    // straight from the file.
+    case kCacheSectionMeshletVertices:
+        return kCacheEncodingDeltaVarint;
+    case kCacheSectionPackedTriangles:
+        return kCacheEncodingVarint;
+    default:
+        return kCacheEncodingRaw;
+    }
+}
+
+template <typename T>
+void encodeCacheIndices(std::span<const T> values, uint32_t encoding, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(values.size() * 2);
+
+    uint32_t previous = 0;
+    for (const T value : values) {
+        uint32_t word = static_cast<uint32_t>(value);
+        if (encoding == kCacheEncodingDeltaVarint) {
+            const int32_t delta = static_cast<int32_t>(word - previous);
+            previous = static_cast<uint32_t>(value);
+            word = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        }
+        while (word >= 0x80u) {
+            out.push_back(static_cast<uint8_t>(word | 0x80u));
+            word >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(word));
+    }
+}
+
+bool decodeCacheIndices(const uint8_t* data,
+                        size_t byteSize,
+                        uint64_t count,
+                        uint32_t encoding,
+                        std::vector<uint32_t>& out) {
+    if (encoding != kCacheEncodingVarint && encoding != kCacheEncodingDeltaVarint) {
+        return false;
     }
-    if (count > static_cast<uint64_t>(std::numeric_limits<size_t>::max() / sizeof(T))) {
+    if (count > byteSize) {
         return false;
     }
 
     out.resize(static_cast<size_t>(count));
-    const size_t byteSize = out.size() * sizeof(T);
-    if (byteSize > static_cast<size_t>(std::numeric_limits<std::streamsize>::max())) {
-        return false;
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + byteSize;
+    uint32_t previous = 0;
+    for (uint32_t& value : out) {
+        uint32_t word = 0;
+        uint32_t shift = 0;
+        for (;;) {
+            if (cursor == end || shift > 28) {
+                return false;
+            }
+            const uint8_t byte = *cursor++;
+            word |= static_cast<uint32_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0) {
+                break;
+            }
+            shift += 7;
+        }
+
+        if (encoding == kCacheEncodingDeltaVarint) {
+            const uint32_t delta = (word >> 1) ^ (0u - (word & 1u));
+            word = previous + delta;
+            previous = word;
+        }
+        value = word;
     }
+    return cursor == end;
+}
 
-    file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(byteSize));
-    return static_cast<bool>(file);
+// Views one index section of a mapped cache file, decoding it into storage when
+// it is compressed.
+template <typename T>
+bool readCacheIndexSection(const MappedFile& file,
+                           const ClusterLODCacheSection& section,
+                           std::vector<uint32_t>& storage,
+                           std::span<const T>& out) {
+    static_assert(kIsCacheIndexElement<T>);
+    if (section.encoding == kCacheEncodingRaw) {
+        return mapCacheSection(file, section, out);
+    }
+    if (section.elementSize != sizeof(T) ||
+        section.offset > file.size() ||
+        section.byteSize > file.size() - section.offset ||
+        !decodeCacheIndices(file.data() + section.offset,
+                            static_cast<size_t>(section.byteSize),
+                            section.count,
+                            section.encoding,
+                            storage)) {
+        return false;
+    }
+    out = std::span<const T>(reinterpret_cast<const T*>(storage.data()), storage.size());
+    return true;
 }
 
 BoundsResult computeBounds(const float* positions,
@@ -270,12 +482,23 @@ BoundsResult mergeBounds(const std::vector<Cluster>& clusters,
     return result;
 }
 
+// Simplified groups are reclusterized to the base meshlet caps. The flex builder may
+// stop a cluster early at a quarter of the triangle cap (rounded to meshopt's
+// multiple of 4) when splitting it gives tighter spatial bounds.
+uint32_t lodMinTriangles(const RhiMeshletSizeLimits& sizeLimits) {
+    return std::max(8u, (sizeLimits.maxTriangles / 4u) & ~3u);
+}
+
 std::vector<Cluster> clusterize(const float* positions,
                                 size_t vertexCount,
                                 size_t stride,
                                 const unsigned int* indices,
-                                size_t indexCount) {
-    size_t maxMeshlets = meshopt_buildMeshletsBound(indexCount, kLodMaxVertices, kLodMinTriangles);
+                                size_t indexCount,
+                                const RhiMeshletSizeLimits& sizeLimits) {
+    const size_t maxVertices = sizeLimits.maxVertices;
+    const size_t minTriangles = lodMinTriangles(sizeLimits);
+    const size_t maxTriangles = sizeLimits.maxTriangles;
+    size_t maxMeshlets = meshopt_buildMeshletsBound(indexCount, maxVertices, minTriangles);
     std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
     std::vector<unsigned int> meshletVertices(indexCount);
     std::vector<unsigned char> meshletTriangles(indexCount);
@@ -289,9 +512,9 @@ std::vector<Cluster> clusterize(const float* positions,
         positions,
         vertexCount,
         stride,
-        kLodMaxVertices,
-        kLodMinTriangles,
-        kLodMaxTriangles,
+        maxVertices,
+        minTriangles,
+        maxTriangles,
         0.0f,
         kClusterSplit);
     meshlets.resize(count);
@@ -730,12 +953,227 @@ uint32_t buildLocalHierarchy(ClusterLODData& data) {
     return 0;
 }
 
+// Fallback for groups the topology-preserving simplifier cannot reduce (dense UV
+// seams, many open edges). meshopt_simplifySloppy is not sparse, so it runs on a
+// compacted copy of the group's vertices. Every vertex on an open edge of the
+// merged patch is locked, which covers the borders shared with neighbouring
+// groups, so the result stays crack-free like the LockBorder pass. Returns the
+// simplified indices in mesh vertex space; error is in absolute units.
+size_t simplifyGroupSloppy(const std::vector<unsigned int>& mergedIndices,
+                           const float* positions,
+                           size_t stride,
+                           const std::vector<unsigned int>& positionRemap,
+                           size_t targetIndexCount,
+                           std::vector<unsigned int>& out,
+                           float& outError) {
+    std::unordered_map<unsigned int, unsigned int> localIndexOf;
+    localIndexOf.reserve(mergedIndices.size());
+    std::vector<unsigned int> meshIndexOf;
+    std::vector<unsigned int> localIndices(mergedIndices.size());
+    for (size_t i = 0; i < mergedIndices.size(); ++i) {
+        const auto [it, inserted] =
+            localIndexOf.emplace(mergedIndices[i], static_cast<unsigned int>(meshIndexOf.size()));
+        if (inserted) {
+            meshIndexOf.push_back(mergedIndices[i]);
+        }
+        localIndices[i] = it->second;
+    }
+
+    const size_t localVertexCount = meshIndexOf.size();
+    std::vector<float> localPositions(localVertexCount * 3);
+    for (size_t i = 0; i < localVertexCount; ++i) {
+        const float* position = reinterpret_cast<const float*>(
+            reinterpret_cast<const unsigned char*>(positions) + size_t(meshIndexOf[i]) * stride);
+        std::memcpy(&localPositions[i * 3], position, sizeof(float) * 3);
+    }
+
+    // Open edges are counted on welded positions so UV-seam duplicates do not read
+    // as borders.
+    const auto edgeKey = [&](unsigned int a, unsigned int b) {
+        const uint64_t weldedA = positionRemap[a];
+        const uint64_t weldedB = positionRemap[b];
+        return weldedA < weldedB ? (weldedA << 32) | weldedB : (weldedB << 32) | weldedA;
+    };
+    std::unordered_map<uint64_t, uint32_t> edgeUses;
+    edgeUses.reserve(mergedIndices.size());
+    for (size_t i = 0; i + 2 < mergedIndices.size(); i += 3) {
+        for (size_t edge = 0; edge < 3; ++edge) {
+            ++edgeUses[edgeKey(mergedIndices[i + edge], mergedIndices[i + (edge + 1) % 3])];
+        }
+    }
+    std::unordered_set<unsigned int> lockedPositions;
+    for (size_t i = 0; i + 2 < mergedIndices.size(); i += 3) {
+        for (size_t edge = 0; edge < 3; ++edge) {
+            const unsigned int a = mergedIndices[i + edge];
+            const unsigned int b = mergedIndices[i + (edge + 1) % 3];
+            if (edgeUses[edgeKey(a, b)] == 1) {
+                lockedPositions.insert(positionRemap[a]);
+                lockedPositions.insert(positionRemap[b]);
+            }
+        }
+    }
+    std::vector<unsigned char> localLocks(localVertexCount, 0);
+    for (size_t i = 0; i < localVertexCount; ++i) {
+        localLocks[i] = lockedPositions.count(positionRemap[meshIndexOf[i]]) != 0 ? 1 : 0;
+    }
+
+    out.resize(localIndices.size());
+    float relativeError = 0.0f;
+    const size_t simplifiedSize = meshopt_simplifySloppy(out.data(),
+                                                         localIndices.data(),
+                                                         localIndices.size(),
+                                                         localPositions.data(),
+                                                         localVertexCount,
+                                                         sizeof(float) * 3,
+                                                         localLocks.data(),
+                                                         targetIndexCount,
+                                                         FLT_MAX,
+                                                         &relativeError);
+    out.resize(simplifiedSize);
+    for (unsigned int& index : out) {
+        index = meshIndexOf[index];
+    }
+    outError = relativeError * meshopt_simplifyScale(localPositions.data(), localVertexCount, sizeof(float) * 3);
+    return simplifiedSize;
+}
+
+// attributes: kSimplifyAttributeCount floats per vertex, or null for a
+// positions-only simplification.
+GroupSimplifyResult simplifyGroup(const std::vector<Cluster>& clusters,
+                                  const std::vector<int>& group,
+                                  const float* positions,
+                                  size_t vertexCount,
+                                  size_t stride,
+                                  const float* attributes,
+                                  const std::vector<unsigned int>& positionRemap,
+                                  const RhiMeshletSizeLimits& sizeLimits,
+                                  ClusterLODStageTimings* timings) {
+    GroupSimplifyResult result{};
+
+    std::vector<unsigned int> mergedIndices;
+    for (int clusterIndex : group) {
+        const auto& clusterIndices = clusters[clusterIndex].indices;
+        mergedIndices.insert(mergedIndices.end(), clusterIndices.begin(), clusterIndices.end());
+    }
+
+    result.bounds = mergeBounds(clusters, group);
+
+    const size_t targetIndexCount = size_t((mergedIndices.size() / 3) * kSimplifyRatio) * 3;
+    result.isTerminal = mergedIndices.size() < 6 || targetIndexCount < 3;
+    if (result.isTerminal) {
+        return result;
+    }
+
+    std::vector<unsigned int> simplifiedIndices(mergedIndices.size());
+    float simplifyError = 0.0f;
+    {
+        StageTimer simplifyTimer(stageCounter(timings, &ClusterLODStageTimings::simplifyNs));
+        constexpr unsigned int kSimplifyOptions =
+            meshopt_SimplifySparse | meshopt_SimplifyLockBorder | meshopt_SimplifyErrorAbsolute;
+        const size_t simplifiedSize = attributes
+            ? meshopt_simplifyWithAttributes(simplifiedIndices.data(),
+                                             mergedIndices.data(),
+                                             mergedIndices.size(),
+                                             positions,
+                                             vertexCount,
+                                             stride,
+                                             attributes,
+                                             sizeof(float) * kSimplifyAttributeCount,
+                                             kSimplifyAttributeWeights,
+                                             kSimplifyAttributeCount,
+                                             nullptr,
+                                             targetIndexCount,
+                                             FLT_MAX,
+                                             kSimplifyOptions,
+                                             &simplifyError)
+            : meshopt_simplify(simplifiedIndices.data(),
+                               mergedIndices.data(),
+                               mergedIndices.size(),
+                               positions,
+                               vertexCount,
+                               stride,
+                               targetIndexCount,
+                               FLT_MAX,
+                               kSimplifyOptions,
+                               &simplifyError);
+        simplifiedIndices.resize(simplifiedSize);
+
+        if (simplifiedIndices.size() > size_t(mergedIndices.size() * kSimplifyThreshold)) {
+            std::vector<unsigned int> sloppyIndices;
+            float sloppyError = 0.0f;
+            simplifyGroupSloppy(
+                mergedIndices, positions, stride, positionRemap, targetIndexCount, sloppyIndices, sloppyError);
+            if (sloppyIndices.size() >= 3 &&
+                sloppyIndices.size() <= size_t(mergedIndices.size() * kSimplifyThreshold)) {
+                simplifiedIndices = std::move(sloppyIndices);
+                simplifyError = sloppyError;
+                result.usedSloppy = true;
+            }
+        }
+    }
+
+    if (simplifiedIndices.size() > size_t(mergedIndices.size() * kSimplifyThreshold) ||
+        simplifiedIndices.size() < 3) {
+        result.isTerminal = true;
+        result.stuck = true;
+        return result;
+    }
+
+    result.nextError = std::max(result.bounds.error, simplifyError);
+    StageTimer meshletizeTimer(stageCounter(timings, &ClusterLODStageTimings::meshletizeNs));
+    result.newClusters = clusterize(
+        positions,
+        vertexCount,
+        stride,
+        simplifiedIndices.data(),
+        simplifiedIndices.size(),
+        sizeLimits);
+
+    for (auto& cluster : result.newClusters) {
+        cluster.center[0] = result.bounds.center[0];
+        cluster.center[1] = result.bounds.center[1];
+        cluster.center[2] = result.bounds.center[2];
+        cluster.radius = result.bounds.radius;
+        cluster.error = result.nextError;
+    }
+    return result;
+}
+
+// Interleaves the mesh's normals and UVs for meshopt_simplifyWithAttributes, from
+// the CPU copies when present and the shared buffers otherwise. Leaves out empty
+// when either attribute is not CPU-readable.
+void buildSimplifyAttributes(const LoadedMesh& mesh, std::vector<float>& out) {
+    out.clear();
+    const size_t vertexCount = mesh.vertexCount;
+    const bool cpuAttributes = !mesh.cpuNormals.empty() || !mesh.cpuUVs.empty();
+    const auto* normals = cpuAttributes ? mesh.cpuNormals.data()
+                                        : static_cast<const float*>(rhiBufferContents(mesh.normalBuffer));
+    const auto* uvs = cpuAttributes ? mesh.cpuUVs.data()
+                                    : static_cast<const float*>(rhiBufferContents(mesh.uvBuffer));
+    const size_t normalBytes = cpuAttributes ? mesh.cpuNormals.size() * sizeof(float) : mesh.normalBuffer.size();
+    const size_t uvBytes = cpuAttributes ? mesh.cpuUVs.size() * sizeof(float) : mesh.uvBuffer.size();
+    if (!normals || !uvs ||
+        normalBytes < vertexCount * 3 * sizeof(float) ||
+        uvBytes < vertexCount * 2 * sizeof(float)) {
+        return;
+    }
+
+    out.resize(vertexCount * kSimplifyAttributeCount);
+    for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+        float* attribute = &out[vertexIndex * kSimplifyAttributeCount];
+        std::memcpy(attribute, &normals[vertexIndex * 3], sizeof(float) * 3);
+        std::memcpy(attribute + 3, &uvs[vertexIndex * 2], sizeof(float) * 2);
+    }
+}
+
 bool buildPrimitiveGroupClusterLOD(const LoadedMesh& mesh,
                                    const MeshletData& meshletData,
                                    uint32_t primitiveGroupIndex,
                                    uint32_t baseMeshletStart,
                                    uint32_t baseMeshletCount,
                                    const std::vector<unsigned int>& positionRemap,
+                                   const float* simplifyAttributes,
+                                   ClusterLODStageTimings* timings,
                                    ClusterLODData& out) {
     out = ClusterLODData{};
     if (baseMeshletCount == 0) {
@@ -774,27 +1212,42 @@ bool buildPrimitiveGroupClusterLOD(const LoadedMesh& mesh,
         level.groupStart = static_cast<uint32_t>(out.groups.size());
         level.rootNode = kInvalidIndex;
 
-        const auto groups = partitionClusters(
-            clusters,
-            pending,
-            positionRemap,
-            allPositions,
-            mesh.vertexCount,
-            kPositionStride);
-        lockBoundary(locks, groups, clusters, positionRemap);
+        std::vector<std::vector<int>> groups;
+        {
+            StageTimer partitionTimer(stageCounter(timings, &ClusterLODStageTimings::partitionNs));
+            groups = partitionClusters(
+                clusters,
+                pending,
+                positionRemap,
+                allPositions,
+                mesh.vertexCount,
+                kPositionStride);
+            lockBoundary(locks, groups, clusters, positionRemap);
+        }
+
+        // Simplification and re-clusterization of each group only reads that group's
+        // clusters, so it runs in parallel; emission stays in group order.
+        std::vector<GroupSimplifyResult> groupResults(groups.size());
+        Parallel::parallelFor(groups.size(), [&](size_t groupIndex) {
+            groupResults[groupIndex] = simplifyGroup(clusters,
+                                                     groups[groupIndex],
+                                                     allPositions,
+                                                     mesh.vertexCount,
+                                                     kPositionStride,
+                                                     simplifyAttributes,
+                                                     positionRemap,
+                                                     meshletData.sizeLimits,
+                                                     timings);
+        });
 
         std::vector<int> newPending;
         newPending.reserve(pending.size());
         const uint32_t nextLevelMeshletStart = static_cast<uint32_t>(out.allMeshlets.size());
 
-        for (const auto& group : groups) {
-            std::vector<unsigned int> mergedIndices;
-            for (int clusterIndex : group) {
-                const auto& clusterIndices = clusters[clusterIndex].indices;
-                mergedIndices.insert(mergedIndices.end(), clusterIndices.begin(), clusterIndices.end());
-            }
-
-            BoundsResult groupBounds = mergeBounds(clusters, group);
+        for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+            const auto& group = groups[groupIndex];
+            GroupSimplifyResult& result = groupResults[groupIndex];
+            const BoundsResult& groupBounds = result.bounds;
 
             GPUClusterGroup gpuGroup{};
             gpuGroup.center[0] = groupBounds.center[0];
@@ -809,60 +1262,22 @@ bool buildPrimitiveGroupClusterLOD(const LoadedMesh& mesh,
                 out.groupMeshletIndices.push_back(clusters[clusterIndex].meshletIndex);
             }
 
-            const size_t targetIndexCount = size_t((mergedIndices.size() / 3) * kSimplifyRatio) * 3;
-            bool isTerminal = mergedIndices.size() < 6 || targetIndexCount < 3;
-            std::vector<unsigned int> simplifiedIndices;
-            float simplifyError = 0.0f;
-
-            if (!isTerminal) {
-                simplifiedIndices.resize(mergedIndices.size());
-                const size_t simplifiedSize = meshopt_simplify(
-                    simplifiedIndices.data(),
-                    mergedIndices.data(),
-                    mergedIndices.size(),
-                    allPositions,
-                    mesh.vertexCount,
-                    kPositionStride,
-                    targetIndexCount,
-                    FLT_MAX,
-                    meshopt_SimplifySparse |
-                        meshopt_SimplifyLockBorder |
-                        meshopt_SimplifyErrorAbsolute,
-                    &simplifyError);
-                simplifiedIndices.resize(simplifiedSize);
-
-                if (simplifiedIndices.size() > size_t(mergedIndices.size() * kSimplifyThreshold) ||
-                    simplifiedIndices.size() < 3) {
-                    isTerminal = true;
-                }
-            }
-
-            if (isTerminal) {
+            out.sloppyGroupCount += result.usedSloppy ? 1u : 0u;
+            out.stuckGroupCount += result.stuck ? 1u : 0u;
+            if (result.isTerminal) {
                 out.groups.push_back(gpuGroup);
                 continue;
             }
 
-            const float nextError = std::max(groupBounds.error, simplifyError);
-            gpuGroup.parentError = nextError;
+            gpuGroup.parentError = result.nextError;
             out.groups.push_back(gpuGroup);
 
             for (int clusterIndex : group) {
                 clusters[clusterIndex].indices.clear();
             }
 
-            auto newClusters = clusterize(
-                allPositions,
-                mesh.vertexCount,
-                kPositionStride,
-                simplifiedIndices.data(),
-                simplifiedIndices.size());
-
-            for (auto& cluster : newClusters) {
-                cluster.center[0] = groupBounds.center[0];
-                cluster.center[1] = groupBounds.center[1];
-                cluster.center[2] = groupBounds.center[2];
-                cluster.radius = groupBounds.radius;
-                cluster.error = nextError;
+            StageTimer emitTimer(stageCounter(timings, &ClusterLODStageTimings::meshletizeNs));
+            for (auto& cluster : result.newClusters) {
                 cluster.meshletIndex = emitSimplifiedMeshlet(
                     cluster,
                     materialID,
@@ -927,7 +1342,11 @@ bool buildPrimitiveGroupClusterLOD(const LoadedMesh& mesh,
         return false;
     }
 
-    const uint32_t rootNode = buildLocalHierarchy(out);
+    uint32_t rootNode = kInvalidIndex;
+    {
+        StageTimer hierarchyTimer(stageCounter(timings, &ClusterLODStageTimings::hierarchyNs));
+        rootNode = buildLocalHierarchy(out);
+    }
     out.primitiveGroupLodRoots.assign(1, rootNode);
     out.totalMeshletCount = static_cast<uint32_t>(out.allMeshlets.size());
     out.totalGroupCount = static_cast<uint32_t>(out.groups.size());
@@ -945,6 +1364,8 @@ void appendClusterLOD(const ClusterLODData& local,
     const uint32_t groupMeshletIndexOffset = static_cast<uint32_t>(out.groupMeshletIndices.size());
     const uint32_t groupOffset = static_cast<uint32_t>(out.groups.size());
     const uint32_t nodeOffset = static_cast<uint32_t>(out.nodes.size());
+    out.sloppyGroupCount += local.sloppyGroupCount;
+    out.stuckGroupCount += local.stuckGroupCount;
 
     out.allMeshletVertices.insert(
         out.allMeshletVertices.end(),
@@ -1010,22 +1431,100 @@ void appendClusterLOD(const ClusterLODData& local,
     }
 }
 
-bool validateClusterLodPayload(const ClusterLODData& data,
+// Spreads the low 10 bits of value to every third bit for a 30-bit Morton code.
+uint32_t spreadMortonBits(uint32_t value) {
+    value &= 0x3ffu;
+    value = (value | (value << 16)) & 0x030000ffu;
+    value = (value | (value << 8)) & 0x0300f00fu;
+    value = (value | (value << 4)) & 0x030c30c3u;
+    value = (value | (value << 2)) & 0x09249249u;
+    return value;
+}
+
+// Rewrites groupMeshletIndices so groups of the same LOD depth sit next to each
+// other in Morton order of their centers, and cuts the result into pages of at
+// most kClusterLodPageBytes without splitting a group. Groups that stream in
+// together then read and copy contiguous ranges. Only clusterStart moves; group,
+// node and level indices are unchanged.
+void layoutGroupPages(ClusterLODData& data) {
+    data.pages.clear();
+    const size_t groupCount = data.groups.size();
+    if (groupCount == 0) {
+        return;
+    }
+
+    std::vector<uint32_t> groupDepth(groupCount, 0u);
+    for (const ClusterLODLevel& level : data.levels) {
+        for (uint32_t i = 0; i < level.groupCount && level.groupStart + i < groupCount; ++i) {
+            groupDepth[level.groupStart + i] = level.depth;
+        }
+    }
+
+    float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (const GPUClusterGroup& group : data.groups) {
+        for (int axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], group.center[axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], group.center[axis]);
+        }
+    }
+
+    std::vector<uint64_t> sortKeys(groupCount);
+    for (size_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
+        const GPUClusterGroup& group = data.groups[groupIndex];
+        uint32_t morton = 0u;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float extent = boundsMax[axis] - boundsMin[axis];
+            const float t = extent > 0.0f ? (group.center[axis] - boundsMin[axis]) / extent : 0.0f;
+            const uint32_t cell = static_cast<uint32_t>(std::clamp(t, 0.0f, 1.0f) * 1023.0f);
+            morton |= spreadMortonBits(cell) << axis;
+        }
+        sortKeys[groupIndex] = (uint64_t(groupDepth[groupIndex]) << 32) | morton;
+    }
+
+    std::vector<uint32_t> order(groupCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return sortKeys[a] < sortKeys[b];
+    });
+
+    constexpr uint32_t kPageIndices = kClusterLodPageBytes / sizeof(uint32_t);
+    std::vector<uint32_t> reordered;
+    reordered.reserve(data.groupMeshletIndices.size());
+    for (uint32_t groupIndex : order) {
+        GPUClusterGroup& group = data.groups[groupIndex];
+        const uint32_t indexStart = static_cast<uint32_t>(reordered.size());
+        ClusterLODPage* page = data.pages.empty() ? nullptr : &data.pages.back();
+        if (!page || page->depth != groupDepth[groupIndex] ||
+            (page->indexCount > 0u && page->indexCount + group.clusterCount > kPageIndices)) {
+            page = &data.pages.emplace_back(ClusterLODPage{indexStart, 0u, 0u, groupDepth[groupIndex]});
+        }
+        reordered.insert(reordered.end(),
+                         data.groupMeshletIndices.begin() + group.clusterStart,
+                         data.groupMeshletIndices.begin() + group.clusterStart + group.clusterCount);
+        group.clusterStart = indexStart;
+        page->indexCount += group.clusterCount;
+        ++page->groupCount;
+    }
+    data.groupMeshletIndices = std::move(reordered);
+}
+
+bool validateClusterLodPayload(const ClusterLODPayloadView& data,
                                uint32_t expectedPrimitiveGroupCount) {
-    if (data.allMeshlets.empty()) {
+    if (data.meshlets.empty()) {
         spdlog::error("ClusterLOD payload is empty");
         return false;
     }
-    if (data.allBounds.size() != data.allMeshlets.size()) {
+    if (data.bounds.size() != data.meshlets.size()) {
         spdlog::error("ClusterLOD bounds count {} does not match meshlet count {}",
-                      data.allBounds.size(),
-                      data.allMeshlets.size());
+                      data.bounds.size(),
+                      data.meshlets.size());
         return false;
     }
-    if (data.allMaterialIDs.size() != data.allMeshlets.size()) {
+    if (data.materialIDs.size() != data.meshlets.size()) {
         spdlog::error("ClusterLOD material count {} does not match meshlet count {}",
-                      data.allMaterialIDs.size(),
-                      data.allMeshlets.size());
+                      data.materialIDs.size(),
+                      data.meshlets.size());
         return false;
     }
     if (data.primitiveGroupLodRoots.size() != expectedPrimitiveGroupCount) {
@@ -1035,19 +1534,19 @@ bool validateClusterLodPayload(const ClusterLODData& data,
         return false;
     }
 
-    for (const GPUMeshlet& meshlet : data.allMeshlets) {
-        if (static_cast<size_t>(meshlet.vertex_offset) + meshlet.vertex_count > data.allMeshletVertices.size()) {
+    for (const GPUMeshlet& meshlet : data.meshlets) {
+        if (static_cast<size_t>(meshlet.vertex_offset) + meshlet.vertex_count > data.meshletVertices.size()) {
             spdlog::error("ClusterLOD meshlet vertex range [{}, {}) is out of bounds {}",
                           meshlet.vertex_offset,
                           static_cast<size_t>(meshlet.vertex_offset) + meshlet.vertex_count,
-                          data.allMeshletVertices.size());
+                          data.meshletVertices.size());
             return false;
         }
-        if (static_cast<size_t>(meshlet.triangle_offset) + meshlet.triangle_count > data.allPackedTriangles.size()) {
+        if (static_cast<size_t>(meshlet.triangle_offset) + meshlet.triangle_count > data.packedTriangles.size()) {
             spdlog::error("ClusterLOD meshlet triangle range [{}, {}) is out of bounds {}",
                           meshlet.triangle_offset,
                           static_cast<size_t>(meshlet.triangle_offset) + meshlet.triangle_count,
-                          data.allPackedTriangles.size());
+                          data.packedTriangles.size());
             return false;
         }
     }
@@ -1062,7 +1561,7 @@ bool validateClusterLodPayload(const ClusterLODData& data,
         }
         for (uint32_t childIndex = 0; childIndex < group.clusterCount; ++childIndex) {
             const uint32_t meshletIndex = data.groupMeshletIndices[group.clusterStart + childIndex];
-            if (meshletIndex >= data.allMeshlets.size()) {
+            if (meshletIndex >= data.meshlets.size()) {
                 spdlog::error("ClusterLOD group references invalid meshlet {}", meshletIndex);
                 return false;
             }
@@ -1082,11 +1581,11 @@ bool validateClusterLodPayload(const ClusterLODData& data,
             return false;
         }
         if (level.meshletCount > 0 &&
-            static_cast<size_t>(level.meshletStart) + level.meshletCount > data.allMeshlets.size()) {
+            static_cast<size_t>(level.meshletStart) + level.meshletCount > data.meshlets.size()) {
             spdlog::error("ClusterLOD level meshlet range [{}, {}) is out of bounds {}",
                           level.meshletStart,
                           static_cast<size_t>(level.meshletStart) + level.meshletCount,
-                          data.allMeshlets.size());
+                          data.meshlets.size());
             return false;
         }
         if (level.rootNode != kInvalidIndex && level.rootNode >= data.nodes.size()) {
@@ -1118,6 +1617,23 @@ bool validateClusterLodPayload(const ClusterLODData& data,
         }
     }
 
+    size_t pagedIndexCount = 0;
+    for (const ClusterLODPage& page : data.pages) {
+        if (page.indexStart != pagedIndexCount) {
+            spdlog::error("ClusterLOD page at {} does not follow the previous page ending at {}",
+                          page.indexStart,
+                          pagedIndexCount);
+            return false;
+        }
+        pagedIndexCount += page.indexCount;
+    }
+    if (!data.pages.empty() && pagedIndexCount != data.groupMeshletIndices.size()) {
+        spdlog::error("ClusterLOD pages cover {} of {} group meshlet indices",
+                      pagedIndexCount,
+                      data.groupMeshletIndices.size());
+        return false;
+    }
+
     for (uint32_t rootNode : data.primitiveGroupLodRoots) {
         if (rootNode != kInvalidIndex && rootNode >= data.nodes.size()) {
             spdlog::error("ClusterLOD primitive group root {} is out of bounds {}", rootNode, data.nodes.size());
@@ -1125,9 +1641,34 @@ bool validateClusterLodPayload(const ClusterLODData& data,
         }
     }
 
+    if (!data.packedClusters.empty() && data.clusterVertexData.size() < kClusterVertexGridHeaderBytes) {
+        spdlog::error("ClusterLOD packed vertex data is missing its grid header");
+        return false;
+    }
+    if (data.packedClusters.size() != data.meshlets.size()) {
+        spdlog::error("ClusterLOD packed cluster count {} does not match meshlet count {}",
+                      data.packedClusters.size(),
+                      data.meshlets.size());
+        return false;
+    }
+    for (size_t clusterIndex = 0; clusterIndex < data.packedClusters.size(); ++clusterIndex) {
+        const PackedCluster& cluster = data.packedClusters[clusterIndex];
+        const GPUMeshlet& meshlet = data.meshlets[clusterIndex];
+        const size_t vertexEnd = static_cast<size_t>(cluster.vertexByteOffset) +
+            clusterVertexDataBytes(cluster, meshlet.vertex_count);
+        const size_t indexEnd =
+            static_cast<size_t>(cluster.indexByteOffset) + static_cast<size_t>(meshlet.triangle_count) * 3;
+        if (vertexEnd > data.clusterVertexData.size() || indexEnd > data.clusterIndexData.size()) {
+            spdlog::error("ClusterLOD packed cluster data range is out of bounds");
+            return false;
+        }
+    }
+
     return true;
 }
 
+} // namespace
+
 void buildPackedClusterData(const LoadedMesh& mesh, ClusterLODData& data) {
     const size_t meshletCount = data.allMeshlets.size();
     data.packedClusters.resize(meshletCount);
@@ -1135,8 +1676,43 @@ void buildPackedClusterData(const LoadedMesh& mesh, ClusterLODData& data) {
     data.clusterIndexData.clear();
 
     // Reserve approximate space
-    data.clusterVertexData.reserve(meshletCount * 32 * 12);
-    data.clusterIndexData.reserve(meshletCount * 32 * 3);
+    data.clusterVertexData.reserve(kClusterVertexGridHeaderBytes +
+                                   meshletCount * (kClusterVertexHeaderBytes + data.sizeLimits.maxVertices * 6));
+    data.clusterIndexData.reserve(meshletCount * data.sizeLimits.maxTriangles * 3);
+
+    // Mesh-wide position grid with kClusterVertexGridBits per axis over the largest
+    // extent; see cluster_types.h for the layout.
+    float gridMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float gridMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (unsigned int vertexIndex : data.allMeshletVertices) {
+        const float* pos = &mesh.cpuPositions[size_t(vertexIndex) * 3];
+        for (int axis = 0; axis < 3; ++axis) {
+            gridMin[axis] = std::min(gridMin[axis], pos[axis]);
+            gridMax[axis] = std::max(gridMax[axis], pos[axis]);
+        }
+    }
+    if (data.allMeshletVertices.empty()) {
+        gridMin[0] = gridMin[1] = gridMin[2] = 0.0f;
+        gridMax[0] = gridMax[1] = gridMax[2] = 0.0f;
+    }
+    constexpr uint32_t kGridMaxCoordinate = (1u << kClusterVertexGridBits) - 1u;
+    const float gridExtent = std::max({gridMax[0] - gridMin[0], gridMax[1] - gridMin[1], gridMax[2] - gridMin[2]});
+    const float gridStep = gridExtent > 0.0f ? gridExtent / float(kGridMaxCoordinate) : 1.0f;
+    const float gridHeader[4] = {gridMin[0], gridMin[1], gridMin[2], gridStep};
+    const auto appendBytes = [&](const void* source, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(source);
+        data.clusterVertexData.insert(data.clusterVertexData.end(), bytes, bytes + size);
+    };
+    appendBytes(gridHeader, sizeof(gridHeader));
+    const auto gridPoint = [&](uint32_t globalVertexIndex, uint32_t point[3]) {
+        const float* pos = &mesh.cpuPositions[size_t(globalVertexIndex) * 3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float scaled = std::round((pos[axis] - gridMin[axis]) / gridStep);
+            point[axis] = static_cast<uint32_t>(std::clamp(scaled, 0.0f, float(kGridMaxCoordinate)));
+        }
+    };
+    uint32_t quantizedClusterCount = 0;
+    std::vector<uint32_t> clusterGridPoints;
 
     // Build a LOD level lookup: meshlet index → LOD level
     std::vector<uint8_t> meshletLodLevel(meshletCount, 0);
@@ -1162,13 +1738,34 @@ void buildPackedClusterData(const LoadedMesh& mesh, ClusterLODData& data) {
             ? static_cast<uint8_t>(data.allMaterialIDs[i] & 0xFF) : 0;
         pc.reserved = 0;
 
-        // Vertex data: copy positions as contiguous float3 array
+        // Vertex data: grid points as uint16 offsets from the cluster's grid origin,
+        // or absolute uint32 grid points when the cluster spans more than 16 bits.
         pc.vertexByteOffset = static_cast<uint32_t>(data.clusterVertexData.size());
+        clusterGridPoints.resize(size_t(m.vertex_count) * 3);
+        uint32_t origin[4] = {UINT32_MAX, UINT32_MAX, UINT32_MAX, 0u};
+        uint32_t span = 0;
         for (uint32_t v = 0; v < m.vertex_count; v++) {
-            uint32_t globalVertexIndex = data.allMeshletVertices[m.vertex_offset + v];
-            const float* pos = &mesh.cpuPositions[globalVertexIndex * 3];
-            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(pos);
-            data.clusterVertexData.insert(data.clusterVertexData.end(), bytes, bytes + 12);
+            uint32_t* point = &clusterGridPoints[size_t(v) * 3];
+            gridPoint(data.allMeshletVertices[m.vertex_offset + v], point);
+            for (int axis = 0; axis < 3; ++axis) {
+                origin[axis] = std::min(origin[axis], point[axis]);
+            }
+        }
+        for (size_t c = 0; c < clusterGridPoints.size(); ++c) {
+            span = std::max(span, clusterGridPoints[c] - origin[c % 3]);
+        }
+
+        if (m.vertex_count > 0 && span <= UINT16_MAX) {
+            pc.attributeBits |= kClusterVertexQuantized16;
+            ++quantizedClusterCount;
+            appendBytes(origin, sizeof(origin));
+            for (size_t c = 0; c < clusterGridPoints.size(); ++c) {
+                const uint16_t offset = static_cast<uint16_t>(clusterGridPoints[c] - origin[c % 3]);
+                appendBytes(&offset, sizeof(offset));
+            }
+            data.clusterVertexData.resize((data.clusterVertexData.size() + 3u) & ~size_t(3u), 0u);
+        } else {
+            appendBytes(clusterGridPoints.data(), clusterGridPoints.size() * sizeof(uint32_t));
         }
 
         // Index data: copy raw uint8 local triangle indices
@@ -1181,99 +1778,104 @@ void buildPackedClusterData(const LoadedMesh& mesh, ClusterLODData& data) {
         }
     }
 
-    spdlog::info("Packed {} clusters: vertex data {:.1f} KB, index data {:.1f} KB",
+    spdlog::info("Packed {} clusters ({} quantized to 16 bits): vertex data {:.1f} KB, index data {:.1f} KB",
                  meshletCount,
+                 quantizedClusterCount,
                  data.clusterVertexData.size() / 1024.0,
                  data.clusterIndexData.size() / 1024.0);
 }
 
-bool uploadClusterLodBuffers(const RhiDevice& device, ClusterLODData& data) {
-    if (data.allMeshlets.empty()) {
+namespace {
+
+bool uploadClusterLodBuffers(const RhiDevice& device,
+                             const ClusterLODPayloadView& payload,
+                             ClusterLODData& data) {
+    if (payload.meshlets.empty()) {
         return false;
     }
 
-    const uint32_t expectedPrimitiveGroupCount = data.primitiveGroupLodRoots.empty()
+    const uint32_t expectedPrimitiveGroupCount = payload.primitiveGroupLodRoots.empty()
         ? 1u
-        : static_cast<uint32_t>(data.primitiveGroupLodRoots.size());
-    if (!validateClusterLodPayload(data, expectedPrimitiveGroupCount)) {
+        : static_cast<uint32_t>(payload.primitiveGroupLodRoots.size());
+    if (!validateClusterLodPayload(payload, expectedPrimitiveGroupCount)) {
         return false;
     }
 
-    data.meshletBuffer = rhiCreateSharedBuffer(
+    data.meshletBuffer = rhiCreateDeviceBuffer(
         device,
-        data.allMeshlets.data(),
-        data.allMeshlets.size() * sizeof(GPUMeshlet),
+        payload.meshlets.data(),
+        payload.meshlets.size() * sizeof(GPUMeshlet),
         "LOD Meshlets");
-    data.meshletVerticesBuffer = rhiCreateSharedBuffer(
+    data.meshletVerticesBuffer = rhiCreateDeviceBuffer(
         device,
-        data.allMeshletVertices.data(),
-        data.allMeshletVertices.size() * sizeof(unsigned int),
+        payload.meshletVertices.data(),
+        payload.meshletVertices.size() * sizeof(unsigned int),
         "LOD Meshlet Vertices");
-    data.meshletTrianglesBuffer = rhiCreateSharedBuffer(
+    data.meshletTrianglesBuffer = rhiCreateDeviceBuffer(
         device,
-        data.allPackedTriangles.data(),
-        data.allPackedTriangles.size() * sizeof(uint32_t),
+        payload.packedTriangles.data(),
+        payload.packedTriangles.size() * sizeof(uint32_t),
         "LOD Meshlet Triangles");
-    data.boundsBuffer = rhiCreateSharedBuffer(
+    data.boundsBuffer = rhiCreateDeviceBuffer(
         device,
-        data.allBounds.data(),
-        data.allBounds.size() * sizeof(GPUMeshletBounds),
+        payload.bounds.data(),
+        payload.bounds.size() * sizeof(GPUMeshletBounds),
         "LOD Meshlet Bounds");
-    data.materialIDsBuffer = rhiCreateSharedBuffer(
+    data.materialIDsBuffer = rhiCreateDeviceBuffer(
         device,
-        data.allMaterialIDs.data(),
-        data.allMaterialIDs.size() * sizeof(uint32_t),
+        payload.materialIDs.data(),
+        payload.materialIDs.size() * sizeof(uint32_t),
         "LOD Meshlet Material IDs");
 
-    if (!data.groupMeshletIndices.empty()) {
-        data.groupMeshletIndicesBuffer = rhiCreateSharedBuffer(
+    if (!payload.groupMeshletIndices.empty()) {
+        data.groupMeshletIndicesBuffer = rhiCreateDeviceBuffer(
             device,
-            data.groupMeshletIndices.data(),
-            data.groupMeshletIndices.size() * sizeof(uint32_t),
+            payload.groupMeshletIndices.data(),
+            payload.groupMeshletIndices.size() * sizeof(uint32_t),
             "LOD Group Meshlet Indices");
     }
-    if (!data.groups.empty()) {
-        data.groupBuffer = rhiCreateSharedBuffer(
+    if (!payload.groups.empty()) {
+        data.groupBuffer = rhiCreateDeviceBuffer(
             device,
-            data.groups.data(),
-            data.groups.size() * sizeof(GPUClusterGroup),
+            payload.groups.data(),
+            payload.groups.size() * sizeof(GPUClusterGroup),
             "LOD Groups");
     }
-    if (!data.nodes.empty()) {
-        data.nodeBuffer = rhiCreateSharedBuffer(
+    if (!payload.nodes.empty()) {
+        data.nodeBuffer = rhiCreateDeviceBuffer(
             device,
-            data.nodes.data(),
-            data.nodes.size() * sizeof(GPULodNode),
+            payload.nodes.data(),
+            payload.nodes.size() * sizeof(GPULodNode),
             "LOD Nodes");
     }
-    if (!data.levels.empty()) {
-        data.levelBuffer = rhiCreateSharedBuffer(
+    if (!payload.levels.empty()) {
+        data.levelBuffer = rhiCreateDeviceBuffer(
             device,
-            data.levels.data(),
-            data.levels.size() * sizeof(ClusterLODLevel),
+            payload.levels.data(),
+            payload.levels.size() * sizeof(ClusterLODLevel),
             "LOD Levels");
     }
 
     // Upload packed cluster buffers
-    if (!data.packedClusters.empty()) {
-        data.packedClusterBuffer = rhiCreateSharedBuffer(
+    if (!payload.packedClusters.empty()) {
+        data.packedClusterBuffer = rhiCreateDeviceBuffer(
             device,
-            data.packedClusters.data(),
-            data.packedClusters.size() * sizeof(PackedCluster),
+            payload.packedClusters.data(),
+            payload.packedClusters.size() * sizeof(PackedCluster),
             "Packed Clusters");
     }
-    if (!data.clusterVertexData.empty()) {
-        data.clusterVertexDataBuffer = rhiCreateSharedBuffer(
+    if (!payload.clusterVertexData.empty()) {
+        data.clusterVertexDataBuffer = rhiCreateDeviceBuffer(
             device,
-            data.clusterVertexData.data(),
-            data.clusterVertexData.size(),
+            payload.clusterVertexData.data(),
+            payload.clusterVertexData.size(),
             "Cluster Vertex Data");
     }
-    if (!data.clusterIndexData.empty()) {
-        data.clusterIndexDataBuffer = rhiCreateSharedBuffer(
+    if (!payload.clusterIndexData.empty()) {
+        data.clusterIndexDataBuffer = rhiCreateDeviceBuffer(
             device,
-            data.clusterIndexData.data(),
-            data.clusterIndexData.size(),
+            payload.clusterIndexData.data(),
+            payload.clusterIndexData.size(),
             "Cluster Index Data");
     }
 
@@ -1282,30 +1884,49 @@ bool uploadClusterLodBuffers(const RhiDevice& device, ClusterLODData& data) {
         !data.meshletTrianglesBuffer.nativeHandle() ||
         !data.boundsBuffer.nativeHandle() ||
         !data.materialIDsBuffer.nativeHandle() ||
-        (!data.groupMeshletIndices.empty() && !data.groupMeshletIndicesBuffer.nativeHandle()) ||
-        (!data.groups.empty() && !data.groupBuffer.nativeHandle()) ||
-        (!data.nodes.empty() && !data.nodeBuffer.nativeHandle()) ||
-        (!data.levels.empty() && !data.levelBuffer.nativeHandle())) {
+        (!payload.groupMeshletIndices.empty() && !data.groupMeshletIndicesBuffer.nativeHandle()) ||
+        (!payload.groups.empty() && !data.groupBuffer.nativeHandle()) ||
+        (!payload.nodes.empty() && !data.nodeBuffer.nativeHandle()) ||
+        (!payload.levels.empty() && !data.levelBuffer.nativeHandle())) {
         releaseClusterLODHandles(data);
         spdlog::error("Failed to create GPU buffers for ClusterLOD payload");
         return false;
     }
 
-    data.totalMeshletCount = static_cast<uint32_t>(data.allMeshlets.size());
-    data.totalGroupCount = static_cast<uint32_t>(data.groups.size());
-    data.totalNodeCount = static_cast<uint32_t>(data.nodes.size());
-    data.lodLevelCount = static_cast<uint32_t>(data.levels.size());
+    data.totalMeshletCount = static_cast<uint32_t>(payload.meshlets.size());
+    data.totalGroupCount = static_cast<uint32_t>(payload.groups.size());
+    data.totalNodeCount = static_cast<uint32_t>(payload.nodes.size());
+    data.groupMeshletIndexCount = static_cast<uint32_t>(payload.groupMeshletIndices.size());
+    data.lodLevelCount = static_cast<uint32_t>(payload.levels.size());
     return true;
 }
 
+// Drops the in-memory group meshlet indices once a raw copy exists in the cache;
+// the streaming service reads each group's slice from the file on demand.
+void pageGroupMeshletIndicesFromFile(ClusterLODData& data,
+                                     const std::filesystem::path& cachePath,
+                                     const ClusterLODCacheSection& section) {
+    if (section.encoding != kCacheEncodingRaw || section.count != data.groupMeshletIndexCount) {
+        return;
+    }
+
+    data.groupPageFilePath = cachePath.string();
+    data.groupPageFileOffset = section.offset;
+    data.groupMeshletIndices.clear();
+    data.groupMeshletIndices.shrink_to_fit();
+}
+
+} // namespace
+
 bool saveClusterLODToCache(const LoadedMesh& mesh,
                            const std::string& sourcePath,
                            const std::string& cacheDirectory,
-                           const ClusterLODData& data) {
+                           ClusterLODData& data) {
     const uint32_t expectedPrimitiveGroupCount = mesh.primitiveGroups.empty()
         ? 1u
         : static_cast<uint32_t>(mesh.primitiveGroups.size());
-    if (!validateClusterLodPayload(data, expectedPrimitiveGroupCount)) {
+    const ClusterLODPayloadView payload = makePayloadView(data);
+    if (!validateClusterLodPayload(payload, expectedPrimitiveGroupCount)) {
         spdlog::warn("Skipping ClusterLOD cache write because payload validation failed");
         return false;
     }
@@ -1326,25 +1947,38 @@ bool saveClusterLODToCache(const LoadedMesh& mesh,
     ClusterLODCacheHeader header{};
     std::memcpy(header.magic, kClusterLodCacheMagic, sizeof(header.magic));
     header.version = kClusterLodCacheVersion;
-    header.maxVertices = static_cast<uint32_t>(kLodMaxVertices);
-    header.minTriangles = static_cast<uint32_t>(kLodMinTriangles);
-    header.maxTriangles = static_cast<uint32_t>(kLodMaxTriangles);
+    header.maxVertices = data.sizeLimits.maxVertices;
+    header.minTriangles = lodMinTriangles(data.sizeLimits);
+    header.maxTriangles = data.sizeLimits.maxTriangles;
     header.partitionSize = static_cast<uint32_t>(kPartitionSize);
     header.hierarchyNodeWidth = static_cast<uint32_t>(kHierarchyNodeWidth);
+    header.sectionCount = kCacheSectionCount;
     header.simplifyRatio = kSimplifyRatio;
     header.simplifyThreshold = kSimplifyThreshold;
     header.clusterSplit = kClusterSplit;
     header.meshSignature = meshSignature;
-    header.meshletCount = data.allMeshlets.size();
-    header.meshletVertexCount = data.allMeshletVertices.size();
-    header.packedTriangleCount = data.allPackedTriangles.size();
-    header.boundsCount = data.allBounds.size();
-    header.materialCount = data.allMaterialIDs.size();
-    header.groupMeshletIndexCount = data.groupMeshletIndices.size();
-    header.groupCount = data.groups.size();
-    header.nodeCount = data.nodes.size();
-    header.levelCount = data.levels.size();
-    header.primitiveGroupRootCount = data.primitiveGroupLodRoots.size();
+
+    std::array<std::vector<uint8_t>, kCacheSectionCount> encodedSections;
+    uint64_t layoutCursor = sizeof(header);
+    uint64_t rawPayloadBytes = 0;
+    forEachCacheSection(payload, [&](uint32_t sectionIndex, const auto& values) {
+        using Element = std::remove_cv_t<typename std::remove_reference_t<decltype(values)>::element_type>;
+        ClusterLODCacheSection& section = header.sections[sectionIndex];
+        section.offset = alignCacheOffset(layoutCursor);
+        section.count = values.size();
+        section.elementSize = static_cast<uint32_t>(sizeof(Element));
+        section.byteSize = values.size_bytes();
+        if constexpr (kIsCacheIndexElement<Element>) {
+            section.encoding = cacheSectionEncoding(sectionIndex);
+            if (section.encoding != kCacheEncodingRaw) {
+                encodeCacheIndices(values, section.encoding, encodedSections[sectionIndex]);
+                section.byteSize = encodedSections[sectionIndex].size();
+            }
+        }
+        rawPayloadBytes += values.size_bytes();
+        layoutCursor = section.offset + section.byteSize;
+    });
+    header.fileSize = layoutCursor;
 
     std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
@@ -1353,32 +1987,101 @@ bool saveClusterLODToCache(const LoadedMesh& mesh,
     }
 
     file.write(reinterpret_cast<const char*>(&header), sizeof(header));
-    const bool ok = static_cast<bool>(file) &&
-                    writeVector(file, data.allMeshlets) &&
-                    writeVector(file, data.allMeshletVertices) &&
-                    writeVector(file, data.allPackedTriangles) &&
-                    writeVector(file, data.allBounds) &&
-                    writeVector(file, data.allMaterialIDs) &&
-                    writeVector(file, data.groupMeshletIndices) &&
-                    writeVector(file, data.groups) &&
-                    writeVector(file, data.nodes) &&
-                    writeVector(file, data.levels) &&
-                    writeVector(file, data.primitiveGroupLodRoots);
+    bool ok = static_cast<bool>(file);
+    uint64_t writeCursor = sizeof(header);
+    forEachCacheSection(payload, [&](uint32_t sectionIndex, const auto& values) {
+        const ClusterLODCacheSection& section = header.sections[sectionIndex];
+        const void* sectionData = section.encoding != kCacheEncodingRaw
+            ? static_cast<const void*>(encodedSections[sectionIndex].data())
+            : static_cast<const void*>(values.data());
+        ok = ok && writeCacheSection(file, section, sectionData, writeCursor);
+    });
     if (!ok) {
         spdlog::warn("Failed to write ClusterLOD cache file {}", cachePath.string());
         return false;
     }
 
-    spdlog::info("Saved ClusterLOD cache with {} meshlets, {} groups, {} nodes to {}",
+    spdlog::info("Saved ClusterLOD cache with {} meshlets, {} groups, {} nodes to {} ({:.1f} KB, raw {:.1f} KB)",
                  data.totalMeshletCount,
                  data.totalGroupCount,
                  data.totalNodeCount,
-                 cachePath.string());
+                 cachePath.string(),
+                 header.fileSize / 1024.0,
+                 rawPayloadBytes / 1024.0);
+    file.close();
+    data.cacheFilePath = cachePath.string();
+    pageGroupMeshletIndicesFromFile(data, cachePath, header.sections[kCacheSectionGroupMeshletIndices]);
     return true;
 }
 
+std::shared_ptr<const ClusterLODGeometry> loadClusterLODGeometry(const ClusterLODData& data) {
+    auto geometry = std::make_shared<ClusterLODGeometry>();
+    if (data.cacheFilePath.empty()) {
+        if (data.allMeshletVertices.empty() || data.allPackedTriangles.empty()) {
+            return nullptr;
+        }
+        geometry->meshletVertices = data.allMeshletVertices;
+        geometry->packedTriangles = data.allPackedTriangles;
+        return geometry;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    ClusterLODCacheHeader header{};
+    if (!file->open(data.cacheFilePath) || file->size() < sizeof(header)) {
+        spdlog::warn("Failed to map ClusterLOD cache file {}", data.cacheFilePath);
+        return nullptr;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kClusterLodCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kClusterLodCacheVersion ||
+        header.sectionCount != kCacheSectionCount ||
+        header.meshSignature != data.sourceSceneSignature ||
+        header.fileSize != file->size()) {
+        spdlog::warn("ClusterLOD cache {} no longer matches the loaded hierarchy", data.cacheFilePath);
+        return nullptr;
+    }
+    if (!readCacheIndexSection(*file,
+                               header.sections[kCacheSectionMeshletVertices],
+                               geometry->decodedMeshletVertices,
+                               geometry->meshletVertices) ||
+        !readCacheIndexSection(*file,
+                               header.sections[kCacheSectionPackedTriangles],
+                               geometry->decodedPackedTriangles,
+                               geometry->packedTriangles)) {
+        spdlog::warn("Failed to read ClusterLOD geometry from {}", data.cacheFilePath);
+        return nullptr;
+    }
+    geometry->file = std::move(file);
+    return geometry;
+}
+
+size_t releaseClusterLODCpuArrays(ClusterLODData& data) {
+    if (data.cacheFilePath.empty()) {
+        return 0;
+    }
+
+    size_t freedBytes = 0;
+    auto release = [&freedBytes](auto& values) {
+        using Element = typename std::remove_reference_t<decltype(values)>::value_type;
+        freedBytes += values.capacity() * sizeof(Element);
+        values.clear();
+        values.shrink_to_fit();
+    };
+    release(data.allMeshletVertices);
+    release(data.allPackedTriangles);
+    release(data.allBounds);
+    release(data.allMaterialIDs);
+    release(data.packedClusters);
+    release(data.clusterVertexData);
+    release(data.clusterIndexData);
+    return freedBytes;
+}
+
+namespace {
+
 bool loadClusterLODFromCache(const RhiDevice& device,
                              const LoadedMesh& mesh,
+                             const RhiMeshletSizeLimits& sizeLimits,
                              const std::string& sourcePath,
                              const std::string& cacheDirectory,
                              ClusterLODData& out) {
@@ -1388,18 +2091,18 @@ bool loadClusterLODFromCache(const RhiDevice& device,
         return false;
     }
 
-    std::ifstream file(cachePath, std::ios::binary);
-    if (!file.is_open()) {
-        spdlog::warn("Failed to open ClusterLOD cache file {}", cachePath.string());
+    MappedFile file;
+    if (!file.open(cachePath)) {
+        spdlog::warn("Failed to map ClusterLOD cache file {}", cachePath.string());
         return false;
     }
 
     ClusterLODCacheHeader header{};
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-    if (!file) {
+    if (file.size() < sizeof(header)) {
         spdlog::warn("Failed to read ClusterLOD cache header {}", cachePath.string());
         return false;
     }
+    std::memcpy(&header, file.data(), sizeof(header));
 
     const uint32_t expectedPrimitiveGroupCount = mesh.primitiveGroups.empty()
         ? 1u
@@ -1407,56 +2110,98 @@ bool loadClusterLODFromCache(const RhiDevice& device,
 
     if (std::memcmp(header.magic, kClusterLodCacheMagic, sizeof(header.magic)) != 0 ||
         header.version != kClusterLodCacheVersion ||
-        header.maxVertices != kLodMaxVertices ||
-        header.minTriangles != kLodMinTriangles ||
-        header.maxTriangles != kLodMaxTriangles ||
+        header.sectionCount != kCacheSectionCount ||
+        header.maxVertices != sizeLimits.maxVertices ||
+        header.minTriangles != lodMinTriangles(sizeLimits) ||
+        header.maxTriangles != sizeLimits.maxTriangles ||
         header.partitionSize != kPartitionSize ||
         header.hierarchyNodeWidth != kHierarchyNodeWidth ||
         std::fabs(header.simplifyRatio - kSimplifyRatio) > 1e-6f ||
         std::fabs(header.simplifyThreshold - kSimplifyThreshold) > 1e-6f ||
         std::fabs(header.clusterSplit - kClusterSplit) > 1e-6f ||
         header.meshSignature != meshSignature ||
-        header.primitiveGroupRootCount != expectedPrimitiveGroupCount) {
+        header.sections[kCacheSectionPrimitiveGroupRoots].count != expectedPrimitiveGroupCount) {
         spdlog::warn("ClusterLOD cache {} is incompatible with the current mesh", cachePath.string());
         return false;
     }
 
-    ClusterLODData cached;
-    cached.sourceSceneSignature = meshSignature;
-    if (!readVector(file, header.meshletCount, cached.allMeshlets) ||
-        !readVector(file, header.meshletVertexCount, cached.allMeshletVertices) ||
-        !readVector(file, header.packedTriangleCount, cached.allPackedTriangles) ||
-        !readVector(file, header.boundsCount, cached.allBounds) ||
-        !readVector(file, header.materialCount, cached.allMaterialIDs) ||
-        !readVector(file, header.groupMeshletIndexCount, cached.groupMeshletIndices) ||
-        !readVector(file, header.groupCount, cached.groups) ||
-        !readVector(file, header.nodeCount, cached.nodes) ||
-        !readVector(file, header.levelCount, cached.levels) ||
-        !readVector(file, header.primitiveGroupRootCount, cached.primitiveGroupLodRoots)) {
-        spdlog::warn("Failed to read ClusterLOD cache payload {}", cachePath.string());
+    if (header.fileSize != file.size()) {
+        spdlog::warn("ClusterLOD cache {} size {} does not match header size {}",
+                     cachePath.string(),
+                     file.size(),
+                     header.fileSize);
         return false;
     }
 
-    const auto currentOffset = file.tellg();
-    file.seekg(0, std::ios::end);
-    const auto endOffset = file.tellg();
-    if (currentOffset != endOffset) {
-        spdlog::warn("ClusterLOD cache {} has unexpected trailing data", cachePath.string());
+    ClusterLODPayloadView payload;
+    std::array<std::vector<uint32_t>, kCacheSectionCount> decodedSections;
+    bool mapped = true;
+    forEachCacheSection(payload, [&](uint32_t sectionIndex, auto& values) {
+        using Element = std::remove_cv_t<typename std::remove_reference_t<decltype(values)>::element_type>;
+        const ClusterLODCacheSection& section = header.sections[sectionIndex];
+        if (!mapped) {
+            return;
+        }
+        if (section.encoding == kCacheEncodingRaw) {
+            mapped = mapCacheSection(file, section, values);
+            return;
+        }
+        if constexpr (kIsCacheIndexElement<Element>) {
+            std::vector<uint32_t>& decoded = decodedSections[sectionIndex];
+            mapped = section.elementSize == sizeof(Element) &&
+                     section.offset <= file.size() &&
+                     section.byteSize <= file.size() - section.offset &&
+                     decodeCacheIndices(file.data() + section.offset,
+                                        static_cast<size_t>(section.byteSize),
+                                        section.count,
+                                        section.encoding,
+                                        decoded);
+            if (mapped) {
+                values = std::span<const Element>(reinterpret_cast<const Element*>(decoded.data()),
+                                                  decoded.size());
+            }
+        } else {
+            mapped = false;
+        }
+    });
+    if (!mapped) {
+        spdlog::warn("Failed to read ClusterLOD cache payload {}", cachePath.string());
         return false;
     }
 
-    if (!validateClusterLodPayload(cached, expectedPrimitiveGroupCount)) {
+    if (!validateClusterLodPayload(payload, expectedPrimitiveGroupCount)) {
         spdlog::warn("ClusterLOD cache {} failed payload validation", cachePath.string());
         return false;
     }
 
-    buildPackedClusterData(mesh, cached);
-
-    if (!uploadClusterLodBuffers(device, cached)) {
+    // GPU-only arrays are uploaded straight from the mapping; only the arrays
+    // read on the CPU (streaming residency, stats) are copied out. Group meshlet
+    // indices stay in the file and are paged in per group by streaming.
+    ClusterLODData cached;
+    cached.sourceSceneSignature = meshSignature;
+    cached.sizeLimits = sizeLimits;
+    cached.cacheFilePath = cachePath.string();
+    cached.allMeshlets.assign(payload.meshlets.begin(), payload.meshlets.end());
+    cached.groups.assign(payload.groups.begin(), payload.groups.end());
+    cached.nodes.assign(payload.nodes.begin(), payload.nodes.end());
+    cached.levels.assign(payload.levels.begin(), payload.levels.end());
+    cached.primitiveGroupLodRoots.assign(payload.primitiveGroupLodRoots.begin(),
+                                         payload.primitiveGroupLodRoots.end());
+    cached.pages.assign(payload.pages.begin(), payload.pages.end());
+
+    if (!uploadClusterLodBuffers(device, payload, cached)) {
         spdlog::warn("Failed to create GPU ClusterLOD buffers from cache {}", cachePath.string());
         return false;
     }
 
+    const ClusterLODCacheSection& groupPageSection = header.sections[kCacheSectionGroupMeshletIndices];
+    if (groupPageSection.encoding == kCacheEncodingRaw) {
+        pageGroupMeshletIndicesFromFile(cached, cachePath, groupPageSection);
+    } else {
+        cached.groupMeshletIndices.assign(payload.groupMeshletIndices.begin(),
+                                          payload.groupMeshletIndices.end());
+    }
+
     out = std::move(cached);
     spdlog::info("Loaded ClusterLOD cache with {} meshlets, {} groups, {} nodes from {}",
                  out.totalMeshletCount,
@@ -1466,17 +2211,221 @@ bool loadClusterLODFromCache(const RhiDevice& device,
     return true;
 }
 
+// Per-primitive-group entry holding one buildPrimitiveGroupClusterLOD result.
+// Meshlet vertex indices are relative to the group's first vertex; material IDs
+// are not stored and come from the current primitive group on load.
+constexpr char kClusterLodGroupCacheMagic[8] = {'M', 'L', 'C', 'L', 'G', 'R', 'P', '1'};
+constexpr uint32_t kClusterLodGroupCacheVersion = 2;
+
+struct ClusterLODGroupCacheHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t maxVertices = 0;
+    uint32_t minTriangles = 0;
+    uint32_t maxTriangles = 0;
+    uint32_t partitionSize = 0;
+    uint32_t hierarchyNodeWidth = 0;
+    float simplifyRatio = 0.0f;
+    float simplifyThreshold = 0.0f;
+    float clusterSplit = 0.0f;
+    uint32_t rootNode = kInvalidIndex;
+    uint64_t groupSignature = 0;
+    uint64_t meshletCount = 0;
+    uint64_t meshletVertexCount = 0;
+    uint64_t packedTriangleCount = 0;
+    uint64_t groupMeshletIndexCount = 0;
+    uint64_t groupCount = 0;
+    uint64_t nodeCount = 0;
+    uint64_t levelCount = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<ClusterLODGroupCacheHeader>);
+
+std::filesystem::path makeGroupCacheFilePath(const std::string& cacheDirectory, uint64_t groupSignature) {
+    std::ostringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << std::nouppercase << groupSignature
+             << ".meshletlodgroup";
+    return std::filesystem::path(cacheDirectory) / "primitive_groups" / fileName.str();
+}
+
+ClusterLODGroupCacheHeader makeGroupCacheHeader(const RhiMeshletSizeLimits& sizeLimits, uint64_t groupSignature) {
+    ClusterLODGroupCacheHeader header{};
+    std::memcpy(header.magic, kClusterLodGroupCacheMagic, sizeof(header.magic));
+    header.version = kClusterLodGroupCacheVersion;
+    header.maxVertices = sizeLimits.maxVertices;
+    header.minTriangles = lodMinTriangles(sizeLimits);
+    header.maxTriangles = sizeLimits.maxTriangles;
+    header.partitionSize = static_cast<uint32_t>(kPartitionSize);
+    header.hierarchyNodeWidth = static_cast<uint32_t>(kHierarchyNodeWidth);
+    header.simplifyRatio = kSimplifyRatio;
+    header.simplifyThreshold = kSimplifyThreshold;
+    header.clusterSplit = kClusterSplit;
+    header.groupSignature = groupSignature;
+    return header;
+}
+
+template <typename T>
+bool writeGroupCacheArray(std::ofstream& file, const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (!values.empty()) {
+        file.write(reinterpret_cast<const char*>(values.data()),
+                   static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+    return static_cast<bool>(file);
+}
+
+template <typename T>
+bool readGroupCacheArray(std::ifstream& file, uint64_t count, std::vector<T>& out) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (count > (uint64_t(1) << 32)) {
+        return false;
+    }
+    out.resize(static_cast<size_t>(count));
+    if (!out.empty()) {
+        file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size() * sizeof(T)));
+    }
+    return static_cast<bool>(file);
+}
+
+bool readPrimitiveGroupClusterLOD(const std::filesystem::path& cachePath,
+                                  uint64_t groupSignature,
+                                  const LoadedMesh::PrimitiveGroup& group,
+                                  const RhiMeshletSizeLimits& sizeLimits,
+                                  ClusterLODData& out) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    ClusterLODGroupCacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const ClusterLODGroupCacheHeader expected = makeGroupCacheHeader(sizeLimits, groupSignature);
+    if (!file ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version ||
+        header.maxVertices != expected.maxVertices ||
+        header.minTriangles != expected.minTriangles ||
+        header.maxTriangles != expected.maxTriangles ||
+        header.partitionSize != expected.partitionSize ||
+        header.hierarchyNodeWidth != expected.hierarchyNodeWidth ||
+        std::fabs(header.simplifyRatio - expected.simplifyRatio) > 1e-6f ||
+        std::fabs(header.simplifyThreshold - expected.simplifyThreshold) > 1e-6f ||
+        std::fabs(header.clusterSplit - expected.clusterSplit) > 1e-6f ||
+        header.groupSignature != groupSignature) {
+        return false;
+    }
+
+    ClusterLODData cached;
+    if (!readGroupCacheArray(file, header.meshletCount, cached.allMeshlets) ||
+        !readGroupCacheArray(file, header.meshletVertexCount, cached.allMeshletVertices) ||
+        !readGroupCacheArray(file, header.packedTriangleCount, cached.allPackedTriangles) ||
+        !readGroupCacheArray(file, header.meshletCount, cached.allBounds) ||
+        !readGroupCacheArray(file, header.groupMeshletIndexCount, cached.groupMeshletIndices) ||
+        !readGroupCacheArray(file, header.groupCount, cached.groups) ||
+        !readGroupCacheArray(file, header.nodeCount, cached.nodes) ||
+        !readGroupCacheArray(file, header.levelCount, cached.levels)) {
+        return false;
+    }
+
+    for (unsigned int& vertex : cached.allMeshletVertices) {
+        if (vertex >= group.vertexCount) {
+            return false;
+        }
+        vertex += group.vertexOffset;
+    }
+    cached.allMaterialIDs.assign(cached.allMeshlets.size(), group.materialIndex);
+    cached.primitiveGroupLodRoots.assign(1, header.rootNode);
+
+    // The assembled payload is validated again when the whole-mesh cache is written.
+    if (header.rootNode >= cached.nodes.size()) {
+        return false;
+    }
+    for (const GPUClusterGroup& clusterGroup : cached.groups) {
+        if (size_t(clusterGroup.clusterStart) + clusterGroup.clusterCount > cached.groupMeshletIndices.size()) {
+            return false;
+        }
+    }
+    for (uint32_t meshletIndex : cached.groupMeshletIndices) {
+        if (meshletIndex >= cached.allMeshlets.size()) {
+            return false;
+        }
+    }
+    for (const GPULodNode& node : cached.nodes) {
+        const size_t childLimit = node.isLeaf != 0 ? cached.groups.size() : cached.nodes.size();
+        if (size_t(node.childOffset) + node.childCount > childLimit) {
+            return false;
+        }
+    }
+    for (const ClusterLODLevel& level : cached.levels) {
+        if (size_t(level.groupStart) + level.groupCount > cached.groups.size() ||
+            size_t(level.meshletStart) + level.meshletCount > cached.allMeshlets.size()) {
+            return false;
+        }
+    }
+    for (const GPUMeshlet& meshlet : cached.allMeshlets) {
+        if (size_t(meshlet.vertex_offset) + meshlet.vertex_count > cached.allMeshletVertices.size() ||
+            size_t(meshlet.triangle_offset) + meshlet.triangle_count > cached.allPackedTriangles.size()) {
+            return false;
+        }
+    }
+    out = std::move(cached);
+    return true;
+}
+
+void savePrimitiveGroupClusterLOD(const std::filesystem::path& cachePath,
+                                  uint64_t groupSignature,
+                                  const LoadedMesh::PrimitiveGroup& group,
+                                  const RhiMeshletSizeLimits& sizeLimits,
+                                  const ClusterLODData& local) {
+    if (local.primitiveGroupLodRoots.empty() || local.primitiveGroupLodRoots[0] == kInvalidIndex) {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(cachePath.parent_path(), error);
+
+    ClusterLODGroupCacheHeader header = makeGroupCacheHeader(sizeLimits, groupSignature);
+    header.rootNode = local.primitiveGroupLodRoots[0];
+    header.meshletCount = local.allMeshlets.size();
+    header.meshletVertexCount = local.allMeshletVertices.size();
+    header.packedTriangleCount = local.allPackedTriangles.size();
+    header.groupMeshletIndexCount = local.groupMeshletIndices.size();
+    header.groupCount = local.groups.size();
+    header.nodeCount = local.nodes.size();
+    header.levelCount = local.levels.size();
+
+    std::vector<unsigned int> localVertices(local.allMeshletVertices);
+    for (unsigned int& vertex : localVertices) {
+        vertex -= group.vertexOffset;
+    }
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const bool ok = static_cast<bool>(file) &&
+                    writeGroupCacheArray(file, local.allMeshlets) &&
+                    writeGroupCacheArray(file, localVertices) &&
+                    writeGroupCacheArray(file, local.allPackedTriangles) &&
+                    writeGroupCacheArray(file, local.allBounds) &&
+                    writeGroupCacheArray(file, local.groupMeshletIndices) &&
+                    writeGroupCacheArray(file, local.groups) &&
+                    writeGroupCacheArray(file, local.nodes) &&
+                    writeGroupCacheArray(file, local.levels);
+    if (!ok) {
+        file.close();
+        std::filesystem::remove(cachePath, error);
+        spdlog::warn("Failed to write ClusterLOD group cache {}", cachePath.string());
+    }
+}
+
 } // namespace
 
-bool buildClusterLOD(const RhiDevice& device,
-                     const LoadedMesh& mesh,
-                     const MeshletData& meshletData,
-                     ClusterLODData& out) {
-    releaseClusterLOD(out);
+bool buildClusterLODCpu(const LoadedMesh& mesh,
+                        const MeshletData& meshletData,
+                        ClusterLODData& out,
+                        ClusterLODStageTimings* timings,
+                        const std::string& groupCacheDirectory) {
     out = ClusterLODData{};
     out.sourceSceneSignature = computeMeshSignature(mesh);
-
-    const auto buildStart = std::chrono::steady_clock::now();
+    out.sizeLimits = meshletData.sizeLimits;
 
     const float* allPositions = mesh.cpuPositions.empty()
         ? static_cast<const float*>(rhiBufferContents(mesh.positionBuffer))
@@ -1491,9 +2440,6 @@ bool buildClusterLOD(const RhiDevice& device,
         : static_cast<uint32_t>(mesh.primitiveGroups.size());
     out.primitiveGroupLodRoots.assign(primitiveGroupCount, kInvalidIndex);
 
-    std::vector<unsigned int> positionRemap(mesh.vertexCount);
-    meshopt_generatePositionRemap(positionRemap.data(), allPositions, mesh.vertexCount, sizeof(float) * 3);
-
     std::vector<uint32_t> meshletPrefix(primitiveGroupCount + 1, 0);
     for (uint32_t groupIndex = 0; groupIndex < primitiveGroupCount; ++groupIndex) {
         const uint32_t meshletCount = (groupIndex < meshletData.meshletsPerGroup.size())
@@ -1502,26 +2448,159 @@ bool buildClusterLOD(const RhiDevice& device,
         meshletPrefix[groupIndex + 1] = meshletPrefix[groupIndex] + meshletCount;
     }
 
+    // Primitive groups are independent; build them concurrently into per-group slots
+    // and append in index order so the output matches a serial build byte for byte.
+    std::vector<ClusterLODData> localResults(primitiveGroupCount);
+    std::vector<uint8_t> localBuilt(primitiveGroupCount, 0);
+    const auto primitiveGroupAt = [&](uint32_t primitiveGroupIndex) {
+        return mesh.primitiveGroups.empty()
+            ? LoadedMesh::PrimitiveGroup{0u, mesh.indexCount, 0u, mesh.vertexCount, 0u}
+            : mesh.primitiveGroups[primitiveGroupIndex];
+    };
+
+    std::vector<uint64_t> groupSignatures(primitiveGroupCount, 0u);
+    Parallel::parallelFor(primitiveGroupCount, [&](size_t index) {
+        const uint32_t primitiveGroupIndex = static_cast<uint32_t>(index);
+        if (meshletPrefix[primitiveGroupIndex + 1] != meshletPrefix[primitiveGroupIndex]) {
+            groupSignatures[primitiveGroupIndex] =
+                computePrimitiveGroupSignature(mesh, primitiveGroupAt(primitiveGroupIndex));
+        }
+    });
+
+    // A group repeating an earlier group's geometry and material (the same glTF
+    // mesh referenced twice, a duplicated primitive) shares that group's hierarchy
+    // instead of building and storing its own.
+    std::vector<uint32_t> sharedSourceGroup(primitiveGroupCount, kInvalidIndex);
+    uint32_t sharedGroupCount = 0;
+    {
+        std::unordered_map<uint64_t, std::vector<uint32_t>> groupsBySignature;
+        for (uint32_t primitiveGroupIndex = 0; primitiveGroupIndex < primitiveGroupCount; ++primitiveGroupIndex) {
+            const uint64_t signature = groupSignatures[primitiveGroupIndex];
+            if (signature == 0u) {
+                continue;
+            }
+            std::vector<uint32_t>& candidates = groupsBySignature[signature];
+            for (uint32_t candidate : candidates) {
+                if (primitiveGroupAt(candidate).materialIndex == primitiveGroupAt(primitiveGroupIndex).materialIndex &&
+                    meshletPrefix[candidate + 1] - meshletPrefix[candidate] ==
+                        meshletPrefix[primitiveGroupIndex + 1] - meshletPrefix[primitiveGroupIndex]) {
+                    sharedSourceGroup[primitiveGroupIndex] = candidate;
+                    ++sharedGroupCount;
+                    break;
+                }
+            }
+            if (sharedSourceGroup[primitiveGroupIndex] == kInvalidIndex) {
+                candidates.push_back(primitiveGroupIndex);
+            }
+        }
+    }
+    const auto isSharedGroup = [&](uint32_t primitiveGroupIndex) {
+        return sharedSourceGroup[primitiveGroupIndex] != kInvalidIndex;
+    };
+
+    // Groups whose geometry is unchanged come from their per-group cache entry;
+    // only the rest pay for the position remap and the build.
+    if (!groupCacheDirectory.empty()) {
+        Parallel::parallelFor(primitiveGroupCount, [&](size_t index) {
+            const uint32_t primitiveGroupIndex = static_cast<uint32_t>(index);
+            const uint64_t signature = groupSignatures[primitiveGroupIndex];
+            if (signature == 0u || isSharedGroup(primitiveGroupIndex)) {
+                return;
+            }
+            const LoadedMesh::PrimitiveGroup group = primitiveGroupAt(primitiveGroupIndex);
+            const bool hit = readPrimitiveGroupClusterLOD(makeGroupCacheFilePath(groupCacheDirectory, signature),
+                                                          signature,
+                                                          group,
+                                                          meshletData.sizeLimits,
+                                                          localResults[primitiveGroupIndex]);
+            StartupProfile::recordCache("cluster LOD groups", hit);
+            localBuilt[primitiveGroupIndex] = hit ? 1u : 0u;
+        });
+    }
+
+    uint32_t groupsToBuild = 0;
+    uint32_t groupCacheHits = 0;
     for (uint32_t primitiveGroupIndex = 0; primitiveGroupIndex < primitiveGroupCount; ++primitiveGroupIndex) {
+        if (meshletPrefix[primitiveGroupIndex + 1] == meshletPrefix[primitiveGroupIndex] ||
+            isSharedGroup(primitiveGroupIndex)) {
+            continue;
+        }
+        if (localBuilt[primitiveGroupIndex] != 0) {
+            ++groupCacheHits;
+        } else {
+            ++groupsToBuild;
+        }
+    }
+    if (!groupCacheDirectory.empty()) {
+        spdlog::info("ClusterLOD: reused {} of {} primitive groups from the group cache",
+                     groupCacheHits,
+                     groupCacheHits + groupsToBuild);
+    }
+    if (sharedGroupCount > 0) {
+        spdlog::info("ClusterLOD: {} of {} primitive groups share the hierarchy of an identical group",
+                     sharedGroupCount,
+                     primitiveGroupCount);
+    }
+
+    std::vector<unsigned int> positionRemap;
+    std::vector<float> simplifyAttributes;
+    if (groupsToBuild > 0) {
+        positionRemap.resize(mesh.vertexCount);
+        meshopt_generatePositionRemap(positionRemap.data(), allPositions, mesh.vertexCount, sizeof(float) * 3);
+        buildSimplifyAttributes(mesh, simplifyAttributes);
+    }
+
+    Parallel::parallelFor(primitiveGroupCount, [&](size_t index) {
+        const uint32_t primitiveGroupIndex = static_cast<uint32_t>(index);
         const uint32_t baseMeshletStart = meshletPrefix[primitiveGroupIndex];
         const uint32_t baseMeshletCount = meshletPrefix[primitiveGroupIndex + 1] - baseMeshletStart;
-        if (baseMeshletCount == 0) {
-            continue;
+        if (baseMeshletCount == 0 || localBuilt[primitiveGroupIndex] != 0 || isSharedGroup(primitiveGroupIndex)) {
+            return;
+        }
+
+        localBuilt[primitiveGroupIndex] = buildPrimitiveGroupClusterLOD(mesh,
+                                                                        meshletData,
+                                                                        primitiveGroupIndex,
+                                                                        baseMeshletStart,
+                                                                        baseMeshletCount,
+                                                                        positionRemap,
+                                                                        simplifyAttributes.empty()
+                                                                            ? nullptr
+                                                                            : simplifyAttributes.data(),
+                                                                        timings,
+                                                                        localResults[primitiveGroupIndex])
+            ? 1u
+            : 0u;
+        const uint64_t signature = groupSignatures[primitiveGroupIndex];
+        if (localBuilt[primitiveGroupIndex] != 0 && signature != 0u && !groupCacheDirectory.empty()) {
+            savePrimitiveGroupClusterLOD(makeGroupCacheFilePath(groupCacheDirectory, signature),
+                                         signature,
+                                         primitiveGroupAt(primitiveGroupIndex),
+                                         meshletData.sizeLimits,
+                                         localResults[primitiveGroupIndex]);
         }
+    });
 
-        ClusterLODData local;
-        if (!buildPrimitiveGroupClusterLOD(mesh,
-                                           meshletData,
-                                           primitiveGroupIndex,
-                                           baseMeshletStart,
-                                           baseMeshletCount,
-                                           positionRemap,
-                                           local)) {
+    for (uint32_t primitiveGroupIndex = 0; primitiveGroupIndex < primitiveGroupCount; ++primitiveGroupIndex) {
+        const uint32_t baseMeshletCount =
+            meshletPrefix[primitiveGroupIndex + 1] - meshletPrefix[primitiveGroupIndex];
+        if (baseMeshletCount == 0 || isSharedGroup(primitiveGroupIndex)) {
+            continue;
+        }
+        if (localBuilt[primitiveGroupIndex] == 0) {
             spdlog::warn("ClusterLOD: failed to build primitive group {} hierarchy", primitiveGroupIndex);
             continue;
         }
 
-        appendClusterLOD(local, primitiveGroupIndex, out);
+        appendClusterLOD(localResults[primitiveGroupIndex], primitiveGroupIndex, out);
+        localResults[primitiveGroupIndex] = ClusterLODData{};
+    }
+    // Sources always precede the groups sharing them, so their roots are final here.
+    for (uint32_t primitiveGroupIndex = 0; primitiveGroupIndex < primitiveGroupCount; ++primitiveGroupIndex) {
+        if (isSharedGroup(primitiveGroupIndex)) {
+            out.primitiveGroupLodRoots[primitiveGroupIndex] =
+                out.primitiveGroupLodRoots[sharedSourceGroup[primitiveGroupIndex]];
+        }
     }
 
     if (out.allMeshlets.empty() || out.groups.empty() || out.nodes.empty()) {
@@ -1529,9 +2608,23 @@ bool buildClusterLOD(const RhiDevice& device,
         return false;
     }
 
+    StageTimer packTimer(stageCounter(timings, &ClusterLODStageTimings::packNs));
+    layoutGroupPages(out);
     buildPackedClusterData(mesh, out);
+    return true;
+}
+
+bool buildClusterLOD(const RhiDevice& device,
+                     const LoadedMesh& mesh,
+                     const MeshletData& meshletData,
+                     ClusterLODData& out,
+                     const std::string& groupCacheDirectory) {
+    releaseClusterLOD(out);
+    out = ClusterLODData{};
 
-    if (!uploadClusterLodBuffers(device, out)) {
+    const auto buildStart = std::chrono::steady_clock::now();
+    if (!buildClusterLODCpu(mesh, meshletData, out, nullptr, groupCacheDirectory) ||
+        !uploadClusterLodBuffers(device, makePayloadView(out), out)) {
         return false;
     }
 
@@ -1555,14 +2648,18 @@ bool loadOrBuildClusterLOD(const RhiDevice& device,
                            const std::string& sourcePath,
                            const std::string& cacheDirectory,
                            ClusterLODData& out) {
+    StartupProfile::Phase phase("Cluster LOD");
     releaseClusterLOD(out);
     out = ClusterLODData{};
 
-    if (loadClusterLODFromCache(device, mesh, sourcePath, cacheDirectory, out)) {
+    const bool cached = loadClusterLODFromCache(device, mesh, meshletData.sizeLimits, sourcePath, cacheDirectory, out);
+    phase.setCacheHit(cached);
+    StartupProfile::recordCache("cluster LOD", cached);
+    if (cached) {
         return true;
     }
 
-    if (!buildClusterLOD(device, mesh, meshletData, out)) {
+    if (!buildClusterLOD(device, mesh, meshletData, out, cacheDirectory)) {
         return false;
     }
 
@@ -1585,12 +2682,17 @@ void releaseClusterLOD(ClusterLODData& data) {
     data.nodes.clear();
     data.levels.clear();
     data.primitiveGroupLodRoots.clear();
+    data.pages.clear();
     data.packedClusters.clear();
     data.clusterVertexData.clear();
     data.clusterIndexData.clear();
     data.totalMeshletCount = 0;
     data.totalGroupCount = 0;
     data.totalNodeCount = 0;
+    data.groupMeshletIndexCount = 0;
+    data.groupPageFilePath.clear();
+    data.groupPageFileOffset = 0u;
+    data.cacheFilePath.clear();
     data.lodLevelCount = 0;
     data.sourceSceneSignature = 0u;
 }
@@ -1609,10 +2711,20 @@ void drawClusterLODStats(const ClusterLODData& data) {
     ImGui::Text("Total Meshlets: %u", data.totalMeshletCount);
     ImGui::Text("Total Groups: %u", data.totalGroupCount);
     ImGui::Text("Total Nodes: %u", data.totalNodeCount);
+    ImGui::Text("Streaming Pages: %u (%u KB max)",
+                static_cast<uint32_t>(data.pages.size()),
+                kClusterLodPageBytes / 1024u);
+    if (data.sloppyGroupCount > 0 || data.stuckGroupCount > 0) {
+        ImGui::Text("Sloppy Fallback Groups: %u, Stuck Groups: %u", data.sloppyGroupCount, data.stuckGroupCount);
+    }
     ImGui::Separator();
 
     if (ImGui::TreeNode("Per-Level Details")) {
-        for (const ClusterLODLevel& level : data.levels) {
+        // Levels of a primitive group are stored consecutively by depth, so the
+        // reduction is measured against the previous entry of the same group.
+        uint32_t previousTriangleCount = 0;
+        for (size_t levelIndex = 0; levelIndex < data.levels.size(); ++levelIndex) {
+            const ClusterLODLevel& level = data.levels[levelIndex];
             uint32_t triangleCount = 0;
             for (uint32_t meshletIndex = level.meshletStart;
                  meshletIndex < level.meshletStart + level.meshletCount;
@@ -1620,13 +2732,27 @@ void drawClusterLODStats(const ClusterLODData& data) {
                 triangleCount += data.allMeshlets[meshletIndex].triangle_count;
             }
 
-            ImGui::Text("Group %u / LOD %u: %u meshlets, %u tris, %u groups, root %u",
-                        level.primitiveGroupIndex,
-                        level.depth,
-                        level.meshletCount,
-                        triangleCount,
-                        level.groupCount,
-                        level.rootNode);
+            const bool hasPrevious = levelIndex > 0 &&
+                data.levels[levelIndex - 1].primitiveGroupIndex == level.primitiveGroupIndex;
+            if (hasPrevious && previousTriangleCount > 0) {
+                ImGui::Text("Group %u / LOD %u: %u meshlets, %u tris (%.2fx reduction), %u groups, root %u",
+                            level.primitiveGroupIndex,
+                            level.depth,
+                            level.meshletCount,
+                            triangleCount,
+                            triangleCount > 0 ? double(previousTriangleCount) / double(triangleCount) : 0.0,
+                            level.groupCount,
+                            level.rootNode);
+            } else {
+                ImGui::Text("Group %u / LOD %u: %u meshlets, %u tris, %u groups, root %u",
+                            level.primitiveGroupIndex,
+                            level.depth,
+                            level.meshletCount,
+                            triangleCount,
+                            level.groupCount,
+                            level.rootNode);
+            }
+            previousTriangleCount = triangleCount;
         }
         ImGui::TreePop();
     }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <cfloat>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -44,6 +47,18 @@ struct ClusterLODLevel {
     uint32_t rootNode;          // root node for this LOD level
 };
 
+// Streaming page: a contiguous run of groupMeshletIndices holding whole groups of
+// one LOD depth, in Morton order of their centers. Pages are at most
+// kClusterLodPageBytes unless a single group is larger; they tile the array.
+struct ClusterLODPage {
+    uint32_t indexStart;        // offset into groupMeshletIndices
+    uint32_t indexCount;
+    uint32_t groupCount;
+    uint32_t depth;
+};
+
+constexpr uint32_t kClusterLodPageBytes = 64u * 1024u;
+
 // Complete LOD hierarchy output
 struct ClusterLODData {
     // All LOD levels' meshlet data (LOD 0 first)
@@ -59,6 +74,15 @@ struct ClusterLODData {
     std::vector<GPULodNode>       nodes;
     std::vector<ClusterLODLevel>  levels;
     std::vector<uint32_t>         primitiveGroupLodRoots;
+    std::vector<ClusterLODPage>   pages;
+
+    // When groupMeshletIndices has been dropped from host memory, each group's
+    // [clusterStart, clusterStart + clusterCount) slice is read from this file.
+    std::string                   groupPageFilePath;
+    uint64_t                      groupPageFileOffset = 0u;
+    // Cache file this hierarchy was loaded from or saved to; empty when a fresh
+    // build could not be saved. Arrays released from host memory are re-read from it.
+    std::string                   cacheFilePath;
 
     // GPU buffers (filled after upload)
     RhiBufferHandle meshletBuffer;
@@ -82,27 +106,84 @@ struct ClusterLODData {
     uint32_t totalMeshletCount = 0;
     uint32_t totalGroupCount = 0;
     uint32_t totalNodeCount = 0;
+    uint32_t groupMeshletIndexCount = 0;
     uint32_t lodLevelCount = 0;
+    // Simplify groups reduced by the sloppy fallback or left terminal because they
+    // would not reduce. Only counted by a fresh build; zero when loaded from cache.
+    uint32_t sloppyGroupCount = 0;
+    uint32_t stuckGroupCount = 0;
     uint64_t sourceSceneSignature = 0u;
+    RhiMeshletSizeLimits sizeLimits;
 };
 
 struct LoadedMesh;
 
+// Time spent in each buildClusterLODCpu stage. Primitive groups and simplify
+// groups build in parallel, so the counters add up worker time, not wall time.
+struct ClusterLODStageTimings {
+    std::atomic<uint64_t> partitionNs{0};  // meshopt_partitionClusters + boundary locks
+    std::atomic<uint64_t> simplifyNs{0};   // per-group simplify incl. sloppy fallback
+    std::atomic<uint64_t> meshletizeNs{0}; // reclusterizing simplified groups
+    std::atomic<uint64_t> hierarchyNs{0};  // per-primitive-group LOD node tree
+    std::atomic<uint64_t> packNs{0};       // buildPackedClusterData
+};
+
 // Build cluster LOD hierarchy from existing meshlet data.
 // mesh: source mesh with CPU positions/indices
 // meshletData: LOD 0 meshlets (must have cpuMeshlets etc. populated)
 // out: receives the full LOD hierarchy + GPU buffers
+// groupCacheDirectory: when set, primitive groups are reused from and written to
+// per-group entries keyed by their geometry signature
 bool buildClusterLOD(const RhiDevice& device,
                      const LoadedMesh& mesh,
                      const MeshletData& meshletData,
-                     ClusterLODData& out);
+                     ClusterLODData& out,
+                     const std::string& groupCacheDirectory = {});
+// CPU half of buildClusterLOD: the hierarchy and packed cluster data without GPU
+// buffers. out must not own GPU buffers; timings may be null.
+bool buildClusterLODCpu(const LoadedMesh& mesh,
+                        const MeshletData& meshletData,
+                        ClusterLODData& out,
+                        ClusterLODStageTimings* timings = nullptr,
+                        const std::string& groupCacheDirectory = {});
+// Fills packedClusters / clusterVertexData / clusterIndexData from the hierarchy.
+void buildPackedClusterData(const LoadedMesh& mesh, ClusterLODData& data);
 bool loadOrBuildClusterLOD(const RhiDevice& device,
                            const LoadedMesh& mesh,
                            const MeshletData& meshletData,
                            const std::string& sourcePath,
                            const std::string& cacheDirectory,
                            ClusterLODData& out);
+// Writes the ClusterLOD cache loadOrBuildClusterLOD reads, keyed by source path
+// and mesh signature. Afterwards data pages its group meshlet indices from the file.
+bool saveClusterLODToCache(const LoadedMesh& mesh,
+                           const std::string& sourcePath,
+                           const std::string& cacheDirectory,
+                           ClusterLODData& data);
 void releaseClusterLOD(ClusterLODData& data);
 
+class MappedFile;
+
+// Meshlet vertices and packed triangles of every LOD level, for CPU readers such
+// as the ray-traced LOD cuts. Read from data.cacheFilePath when there is one, so it
+// survives releaseClusterLODCpuArrays; compressed sections are decoded into the
+// storage here. Without a cache file the arrays of data are borrowed and data must
+// outlive the result. Null when neither source is available.
+struct ClusterLODGeometry {
+    std::span<const unsigned int> meshletVertices;
+    std::span<const uint32_t> packedTriangles;
+
+    std::shared_ptr<const MappedFile> file;
+    std::vector<uint32_t> decodedMeshletVertices;
+    std::vector<uint32_t> decodedPackedTriangles;
+};
+std::shared_ptr<const ClusterLODGeometry> loadClusterLODGeometry(const ClusterLODData& data);
+
+// Drops the host copies of arrays only the GPU reads after upload (meshlet
+// vertices, packed triangles, bounds, material IDs and the packed cluster data),
+// keeping the hierarchy, allMeshlets and pages. Does nothing without a cache file
+// to re-read them from; returns the bytes freed.
+size_t releaseClusterLODCpuArrays(ClusterLODData& data);
+
 // Render LOD stats in ImGui
 void drawClusterLODStats(const ClusterLODData& data);
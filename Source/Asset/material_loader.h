@@ -7,13 +7,12 @@
 #include "rhi_backend.h"
 
 static constexpr uint32_t INVALID_TEXTURE_INDEX = 0xFFFFFFFF;
-static constexpr uint32_t MAX_SCENE_TEXTURES = 96;
 
 struct GPUMaterial {
     uint32_t baseColorTexIndex;
     uint32_t normalTexIndex;
     uint32_t metallicRoughnessTexIndex;
-    uint32_t alphaMode; // 0=OPAQUE, 1=MASK
+    uint32_t alphaMode; // 0=OPAQUE, 1=MASK, 2=BLEND
 
     float baseColorFactor[4];
     float metallicFactor;
@@ -29,4 +28,6 @@ struct LoadedMaterials {
     RhiBufferHandle materialBuffer;
     RhiSamplerHandle sampler;
     uint32_t materialCount = 0;
+    // materialBuffer's contents, for CPU-side choices such as ray tracing hit groups.
+    std::vector<GPUMaterial> cpuMaterials;
 };
@@ -13,6 +13,10 @@ struct LoadedMesh {
     RhiBufferHandle indexBuffer;
     std::vector<float> cpuPositions;
     std::vector<uint32_t> cpuIndices;
+    // Filled only without GPU buffers (offline cooking); otherwise normals and UVs
+    // are read from the shared normalBuffer / uvBuffer.
+    std::vector<float> cpuNormals;
+    std::vector<float> cpuUVs;
     uint32_t vertexCount = 0;
     uint32_t indexCount  = 0;
     float bboxMin[3] = {};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "fast_hash.h"
+#include "mesh_loader.h"
+
+#include <cstdint>
+#include <vector>
+
+// Content signature used to key the meshlet and ClusterLOD caches.
+inline uint64_t computeMeshSignature(const LoadedMesh& mesh) {
+    FastHash::Hasher hasher;
+    hasher.addValue(mesh.vertexCount);
+    hasher.addValue(mesh.indexCount);
+    hasher.addValue(mesh.hasBakedRootScale);
+    hasher.addValue(mesh.bakedRootScale);
+
+    if (!mesh.cpuPositions.empty()) {
+        hasher.addBytes(mesh.cpuPositions.data(), mesh.cpuPositions.size() * sizeof(float));
+    }
+    if (!mesh.cpuIndices.empty()) {
+        hasher.addBytes(mesh.cpuIndices.data(), mesh.cpuIndices.size() * sizeof(uint32_t));
+    }
+
+    const uint32_t primitiveGroupCount = static_cast<uint32_t>(mesh.primitiveGroups.size());
+    hasher.addValue(primitiveGroupCount);
+    if (!mesh.primitiveGroups.empty()) {
+        hasher.addBytes(mesh.primitiveGroups.data(),
+                        mesh.primitiveGroups.size() * sizeof(LoadedMesh::PrimitiveGroup));
+    }
+
+    return hasher.finish();
+}
+
+// Content signature of one primitive group: its positions and its indices relative
+// to the group's first vertex, so it survives edits to other groups and shifts of
+// the group within the mesh buffers. Keys the per-group meshlet and ClusterLOD
+// cache entries. Returns 0 when the group has no CPU geometry to hash.
+inline uint64_t computePrimitiveGroupSignature(const LoadedMesh& mesh,
+                                               const LoadedMesh::PrimitiveGroup& group) {
+    if (size_t(group.vertexOffset + group.vertexCount) * 3 > mesh.cpuPositions.size() ||
+        size_t(group.indexOffset) + group.indexCount > mesh.cpuIndices.size() ||
+        group.indexCount == 0) {
+        return 0u;
+    }
+
+    FastHash::Hasher hasher;
+    hasher.addValue(group.vertexCount);
+    hasher.addValue(group.indexCount);
+    hasher.addValue(mesh.hasBakedRootScale);
+    hasher.addValue(mesh.bakedRootScale);
+    hasher.addBytes(mesh.cpuPositions.data() + size_t(group.vertexOffset) * 3,
+                    size_t(group.vertexCount) * 3 * sizeof(float));
+
+    std::vector<uint32_t> localIndices(mesh.cpuIndices.begin() + group.indexOffset,
+                                       mesh.cpuIndices.begin() + group.indexOffset + group.indexCount);
+    for (uint32_t& index : localIndices) {
+        index -= group.vertexOffset;
+    }
+    hasher.addBytes(localIndices.data(), localIndices.size() * sizeof(uint32_t));
+    return hasher.finish();
+}
@@ -1,9 +1,14 @@
 #include "meshlet_builder.h"
 #include "mesh_loader.h"
+#include "meshlet_constants.h"
+#include "mesh_signature.h"
+#include "parallel_for.h"
 #include "rhi_resource_utils.h"
+#include "startup_profile.h"
 
 #include <meshoptimizer.h>
 #include <spdlog/spdlog.h>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstring>
@@ -16,16 +21,16 @@
 #include <type_traits>
 #include <vector>
 
-static constexpr size_t MAX_VERTICES  = 32;
-static constexpr size_t MAX_TRIANGLES = 32;
 static constexpr float  CONE_WEIGHT   = 0.5f;
 
+static_assert(RhiMeshletSizeLimits{}.maxVertices == kMeshletDefaultMaxVertices &&
+                  RhiMeshletSizeLimits{}.maxTriangles == kMeshletDefaultMaxTriangles,
+              "RhiMeshletSizeLimits defaults must match the shader fallbacks in meshlet_constants.h");
+
 namespace {
 
 constexpr char kMeshletCacheMagic[8] = {'M', 'L', 'M', 'S', 'H', 'L', 'T', '1'};
-constexpr uint32_t kMeshletCacheVersion = 2;
-constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
-constexpr uint64_t kFnvPrime = 1099511628211ull;
+constexpr uint32_t kMeshletCacheVersion = 4;
 
 struct MeshletCacheHeader {
     char magic[8] = {};
@@ -45,6 +50,24 @@ struct MeshletCacheHeader {
 
 static_assert(std::is_trivially_copyable_v<MeshletCacheHeader>);
 
+// Per-primitive-group entry; vertex indices are relative to the group's first vertex.
+constexpr char kMeshletGroupCacheMagic[8] = {'M', 'L', 'M', 'S', 'G', 'R', 'P', '1'};
+constexpr uint32_t kMeshletGroupCacheVersion = 1;
+
+struct MeshletGroupCacheHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t maxVertices = 0;
+    uint32_t maxTriangles = 0;
+    float coneWeight = 0.0f;
+    uint64_t groupSignature = 0;
+    uint64_t meshletCount = 0;
+    uint64_t vertexCount = 0;
+    uint64_t rawTriangleByteCount = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<MeshletGroupCacheHeader>);
+
 void releaseMeshletHandles(MeshletData& meshlets) {
     rhiReleaseHandle(meshlets.meshletBuffer);
     rhiReleaseHandle(meshlets.meshletVertices);
@@ -54,53 +77,12 @@ void releaseMeshletHandles(MeshletData& meshlets) {
     meshlets.meshletCount = 0;
 }
 
-void hashBytes(uint64_t& hash, const void* data, size_t size) {
-    const auto* bytes = static_cast<const uint8_t*>(data);
-    for (size_t i = 0; i < size; ++i) {
-        hash ^= bytes[i];
-        hash *= kFnvPrime;
-    }
-}
-
-template <typename T>
-void hashValue(uint64_t& hash, const T& value) {
-    static_assert(std::is_trivially_copyable_v<T>);
-    hashBytes(hash, &value, sizeof(T));
-}
-
 uint32_t expectedMeshletGroupCount(const LoadedMesh& mesh) {
     return mesh.primitiveGroups.empty()
         ? 1u
         : static_cast<uint32_t>(mesh.primitiveGroups.size());
 }
 
-uint64_t computeMeshSignature(const LoadedMesh& mesh) {
-    uint64_t hash = kFnvOffsetBasis;
-    hashValue(hash, mesh.vertexCount);
-    hashValue(hash, mesh.indexCount);
-    hashValue(hash, mesh.hasBakedRootScale);
-    hashValue(hash, mesh.bakedRootScale);
-
-    if (!mesh.cpuPositions.empty()) {
-        hashBytes(hash, mesh.cpuPositions.data(), mesh.cpuPositions.size() * sizeof(float));
-    }
-    if (!mesh.cpuIndices.empty()) {
-        hashBytes(hash, mesh.cpuIndices.data(), mesh.cpuIndices.size() * sizeof(uint32_t));
-    }
-
-    const uint32_t primitiveGroupCount = static_cast<uint32_t>(mesh.primitiveGroups.size());
-    hashValue(hash, primitiveGroupCount);
-    for (const auto& group : mesh.primitiveGroups) {
-        hashValue(hash, group.indexOffset);
-        hashValue(hash, group.indexCount);
-        hashValue(hash, group.vertexOffset);
-        hashValue(hash, group.vertexCount);
-        hashValue(hash, group.materialIndex);
-    }
-
-    return hash;
-}
-
 std::string sanitizeCacheStem(std::string stem) {
     if (stem.empty()) {
         return "scene";
@@ -133,6 +115,13 @@ std::filesystem::path makeCacheFilePath(const std::string& sourcePath,
     return std::filesystem::path(cacheDirectory) / fileName.str();
 }
 
+std::filesystem::path makeGroupCacheFilePath(const std::string& cacheDirectory, uint64_t groupSignature) {
+    std::ostringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << std::nouppercase << groupSignature
+             << ".meshletgroup";
+    return std::filesystem::path(cacheDirectory) / "primitive_groups" / fileName.str();
+}
+
 bool packRawTriangles(const std::vector<unsigned char>& rawTriangles,
                       std::vector<uint32_t>& outPackedTriangles) {
     if ((rawTriangles.size() % 3) != 0) {
@@ -187,6 +176,15 @@ bool validateMeshletPayload(const MeshletData& data, uint32_t expectedGroupCount
 
     const size_t packedTriangleCount = data.cpuMeshletTriangles.size() / 3;
     for (const auto& meshlet : data.cpuMeshlets) {
+        if (meshlet.vertex_count > data.sizeLimits.maxVertices ||
+            meshlet.triangle_count > data.sizeLimits.maxTriangles) {
+            spdlog::error("Meshlet with {} verts, {} tris exceeds the {}v/{}t size limits",
+                          meshlet.vertex_count,
+                          meshlet.triangle_count,
+                          data.sizeLimits.maxVertices,
+                          data.sizeLimits.maxTriangles);
+            return false;
+        }
         if (static_cast<size_t>(meshlet.vertex_offset) + meshlet.vertex_count > data.cpuMeshletVertices.size()) {
             spdlog::error("Meshlet vertex range [{}, {}) is out of bounds {}",
                           meshlet.vertex_offset,
@@ -219,15 +217,15 @@ bool uploadMeshletBuffers(const RhiDevice& device, MeshletData& data) {
         return false;
     }
 
-    data.meshletBuffer = rhiCreateSharedBuffer(
+    data.meshletBuffer = rhiCreateDeviceBuffer(
         device, data.cpuMeshlets.data(), data.cpuMeshlets.size() * sizeof(GPUMeshlet), "Meshlets");
-    data.meshletVertices = rhiCreateSharedBuffer(
+    data.meshletVertices = rhiCreateDeviceBuffer(
         device, data.cpuMeshletVertices.data(), data.cpuMeshletVertices.size() * sizeof(uint32_t), "Meshlet Vertices");
-    data.meshletTriangles = rhiCreateSharedBuffer(
+    data.meshletTriangles = rhiCreateDeviceBuffer(
         device, packedTriangles.data(), packedTriangles.size() * sizeof(uint32_t), "Meshlet Triangles");
-    data.boundsBuffer = rhiCreateSharedBuffer(
+    data.boundsBuffer = rhiCreateDeviceBuffer(
         device, data.cpuBounds.data(), data.cpuBounds.size() * sizeof(GPUMeshletBounds), "Meshlet Bounds");
-    data.materialIDs = rhiCreateSharedBuffer(
+    data.materialIDs = rhiCreateDeviceBuffer(
         device, data.cpuMaterialIDs.data(), data.cpuMaterialIDs.size() * sizeof(uint32_t), "Meshlet Material IDs");
 
     if (!data.meshletBuffer.nativeHandle() ||
@@ -281,6 +279,8 @@ bool readVector(std::ifstream& file, uint64_t count, std::vector<T>& out) {
     return static_cast<bool>(file);
 }
 
+} // namespace
+
 bool saveMeshletsToCache(const LoadedMesh& mesh,
                          const std::string& sourcePath,
                          const std::string& cacheDirectory,
@@ -307,8 +307,8 @@ bool saveMeshletsToCache(const LoadedMesh& mesh,
     MeshletCacheHeader header;
     std::memcpy(header.magic, kMeshletCacheMagic, sizeof(header.magic));
     header.version = kMeshletCacheVersion;
-    header.maxVertices = static_cast<uint32_t>(MAX_VERTICES);
-    header.maxTriangles = static_cast<uint32_t>(MAX_TRIANGLES);
+    header.maxVertices = data.sizeLimits.maxVertices;
+    header.maxTriangles = data.sizeLimits.maxTriangles;
     header.coneWeight = CONE_WEIGHT;
     header.meshSignature = meshSignature;
     header.meshletCount = data.cpuMeshlets.size();
@@ -341,8 +341,8 @@ bool saveMeshletsToCache(const LoadedMesh& mesh,
     return true;
 }
 
-bool loadMeshletsFromCache(const RhiDevice& device,
-                           const LoadedMesh& mesh,
+bool readMeshletsFromCache(const LoadedMesh& mesh,
+                           const RhiMeshletSizeLimits& sizeLimits,
                            const std::string& sourcePath,
                            const std::string& cacheDirectory,
                            MeshletData& out) {
@@ -367,8 +367,8 @@ bool loadMeshletsFromCache(const RhiDevice& device,
 
     if (std::memcmp(header.magic, kMeshletCacheMagic, sizeof(header.magic)) != 0 ||
         header.version != kMeshletCacheVersion ||
-        header.maxVertices != MAX_VERTICES ||
-        header.maxTriangles != MAX_TRIANGLES ||
+        header.maxVertices != sizeLimits.maxVertices ||
+        header.maxTriangles != sizeLimits.maxTriangles ||
         std::fabs(header.coneWeight - CONE_WEIGHT) > 1e-6f ||
         header.meshSignature != meshSignature ||
         header.meshletsPerGroupCount != expectedMeshletGroupCount(mesh)) {
@@ -377,6 +377,7 @@ bool loadMeshletsFromCache(const RhiDevice& device,
     }
 
     MeshletData cached;
+    cached.sizeLimits = sizeLimits;
     if (!readVector(file, header.meshletsPerGroupCount, cached.meshletsPerGroup) ||
         !readVector(file, header.meshletCount, cached.cpuMeshlets) ||
         !readVector(file, header.meshletVertexCount, cached.cpuMeshletVertices) ||
@@ -400,232 +401,388 @@ bool loadMeshletsFromCache(const RhiDevice& device,
         return false;
     }
 
+    out = std::move(cached);
+    spdlog::info("Loaded {} meshlets from cache {}", out.cpuMeshlets.size(), cachePath.string());
+    return true;
+}
+
+namespace {
+
+bool loadMeshletsFromCache(const RhiDevice& device,
+                           const LoadedMesh& mesh,
+                           const RhiMeshletSizeLimits& sizeLimits,
+                           const std::string& sourcePath,
+                           const std::string& cacheDirectory,
+                           MeshletData& out) {
+    MeshletData cached;
+    if (!readMeshletsFromCache(mesh, sizeLimits, sourcePath, cacheDirectory, cached)) {
+        return false;
+    }
     if (!uploadMeshletBuffers(device, cached)) {
-        spdlog::warn("Failed to create GPU meshlet buffers from cache {}", cachePath.string());
+        spdlog::warn("Failed to create GPU meshlet buffers from cache for {}", sourcePath);
         return false;
     }
-
     out = std::move(cached);
-    spdlog::info("Loaded {} meshlets from cache {}", out.meshletCount, cachePath.string());
     return true;
 }
 
-} // namespace
-
-bool buildMeshlets(const RhiDevice& device, const LoadedMesh& mesh, MeshletData& out) {
-    out.meshletsPerGroup.clear();
-
-    const auto buildStart = std::chrono::steady_clock::now();
+struct GroupMeshletScratch {
+    std::vector<GPUMeshlet> meshlets;        // offsets local to this group's arrays
+    std::vector<unsigned int> vertices;      // mesh-global vertex indices
+    std::vector<unsigned char> rawTriangles; // 3 bytes per triangle, tightly packed
+    std::vector<GPUMeshletBounds> bounds;
+};
 
-    const auto* allPositions = mesh.cpuPositions.empty()
-        ? static_cast<const float*>(rhiBufferContents(mesh.positionBuffer))
-        : mesh.cpuPositions.data();
-    const auto* allIndices = mesh.cpuIndices.empty()
-        ? static_cast<const uint32_t*>(rhiBufferContents(mesh.indexBuffer))
-        : mesh.cpuIndices.data();
-    constexpr size_t kPositionStride = sizeof(float) * 3;
+bool readGroupMeshletsFromCache(const std::filesystem::path& cachePath,
+                                uint64_t groupSignature,
+                                const LoadedMesh::PrimitiveGroup& group,
+                                const RhiMeshletSizeLimits& sizeLimits,
+                                GroupMeshletScratch& out) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
 
-    if (!allPositions || !allIndices) {
-        spdlog::error("Meshlet builder requires CPU-readable position and index data");
+    MeshletGroupCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file ||
+        std::memcmp(header.magic, kMeshletGroupCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kMeshletGroupCacheVersion ||
+        header.maxVertices != sizeLimits.maxVertices ||
+        header.maxTriangles != sizeLimits.maxTriangles ||
+        std::fabs(header.coneWeight - CONE_WEIGHT) > 1e-6f ||
+        header.groupSignature != groupSignature) {
         return false;
     }
 
-    // Accumulated output across all primitive groups
-    std::vector<GPUMeshlet> allGpuMeshlets;
-    std::vector<unsigned int> allMeshletVertices;
-    std::vector<uint32_t> allPackedTriangles;
-    std::vector<unsigned char> allRawTriangles;
-    std::vector<GPUMeshletBounds> allBounds;
-    std::vector<uint32_t> allMaterialIDs;
+    GroupMeshletScratch cached;
+    if (!readVector(file, header.meshletCount, cached.meshlets) ||
+        !readVector(file, header.vertexCount, cached.vertices) ||
+        !readVector(file, header.rawTriangleByteCount, cached.rawTriangles) ||
+        !readVector(file, header.meshletCount, cached.bounds)) {
+        return false;
+    }
 
-    size_t meshletBound = 0;
-    if (mesh.primitiveGroups.empty()) {
-        meshletBound = meshopt_buildMeshletsBound(mesh.indexCount, MAX_VERTICES, MAX_TRIANGLES);
-    } else {
-        for (const auto& group : mesh.primitiveGroups) {
-            meshletBound += meshopt_buildMeshletsBound(group.indexCount, MAX_VERTICES, MAX_TRIANGLES);
+    for (const GPUMeshlet& meshlet : cached.meshlets) {
+        if (size_t(meshlet.vertex_offset) + meshlet.vertex_count > cached.vertices.size() ||
+            (size_t(meshlet.triangle_offset) + meshlet.triangle_count) * 3 > cached.rawTriangles.size()) {
+            return false;
         }
     }
-    allGpuMeshlets.reserve(meshletBound);
-    allBounds.reserve(meshletBound);
-    allMaterialIDs.reserve(meshletBound);
+    for (unsigned int& vertex : cached.vertices) {
+        if (vertex >= group.vertexCount) {
+            return false;
+        }
+        vertex += group.vertexOffset;
+    }
+    out = std::move(cached);
+    return true;
+}
 
-    std::vector<meshopt_Meshlet> meshlets;
-    std::vector<unsigned int> meshletVertices;
-    std::vector<unsigned char> meshletTriangles;
-    std::vector<uint32_t> localIndices;
+void saveGroupMeshletsToCache(const std::filesystem::path& cachePath,
+                              uint64_t groupSignature,
+                              const LoadedMesh::PrimitiveGroup& group,
+                              const RhiMeshletSizeLimits& sizeLimits,
+                              const GroupMeshletScratch& scratch) {
+    std::error_code createError;
+    std::filesystem::create_directories(cachePath.parent_path(), createError);
 
-    auto buildGroupMeshlets = [&](const LoadedMesh::PrimitiveGroup& group) {
-        const uint32_t* groupIndices = allIndices + group.indexOffset;
-        size_t groupIndexCount = group.indexCount;
-        const uint32_t groupVertexOffset = group.vertexOffset;
-        const uint32_t groupVertexCount = group.vertexCount;
-        const auto* groupPositions = allPositions + static_cast<size_t>(groupVertexOffset) * 3;
+    MeshletGroupCacheHeader header;
+    std::memcpy(header.magic, kMeshletGroupCacheMagic, sizeof(header.magic));
+    header.version = kMeshletGroupCacheVersion;
+    header.maxVertices = sizeLimits.maxVertices;
+    header.maxTriangles = sizeLimits.maxTriangles;
+    header.coneWeight = CONE_WEIGHT;
+    header.groupSignature = groupSignature;
+    header.meshletCount = scratch.meshlets.size();
+    header.vertexCount = scratch.vertices.size();
+    header.rawTriangleByteCount = scratch.rawTriangles.size();
 
-        if (groupIndexCount == 0 || groupVertexCount == 0) {
-            out.meshletsPerGroup.push_back(0);
-            return true;
-        }
+    std::vector<unsigned int> localVertices(scratch.vertices);
+    for (unsigned int& vertex : localVertices) {
+        vertex -= group.vertexOffset;
+    }
 
-        // Compute worst-case buffer sizes for this group
-        size_t maxMeshlets = meshopt_buildMeshletsBound(groupIndexCount, MAX_VERTICES, MAX_TRIANGLES);
-        meshlets.resize(maxMeshlets);
-        meshletVertices.resize(maxMeshlets * MAX_VERTICES);
-        meshletTriangles.resize(maxMeshlets * MAX_TRIANGLES * 3);
-
-        const uint32_t groupVertexEnd = groupVertexOffset + groupVertexCount;
-        const uint32_t* meshletSourceIndices = groupIndices;
-        if (groupVertexOffset != 0 || groupVertexCount != mesh.vertexCount) {
-            localIndices.resize(groupIndexCount);
-            for (size_t i = 0; i < groupIndexCount; ++i) {
-                const uint32_t index = groupIndices[i];
-                if (index < groupVertexOffset || index >= groupVertexEnd) {
-                    spdlog::error("Primitive group index {} out of range [{}, {})",
-                                  index,
-                                  groupVertexOffset,
-                                  groupVertexEnd);
-                    return false;
-                }
-                localIndices[i] = index - groupVertexOffset;
-            }
-            meshletSourceIndices = localIndices.data();
-        }
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const bool ok = static_cast<bool>(file) &&
+                    writeVector(file, scratch.meshlets) &&
+                    writeVector(file, localVertices) &&
+                    writeVector(file, scratch.rawTriangles) &&
+                    writeVector(file, scratch.bounds);
+    if (!ok) {
+        file.close();
+        std::filesystem::remove(cachePath, createError);
+        spdlog::warn("Failed to write meshlet group cache {}", cachePath.string());
+    }
+}
 
-        // Build meshlets for this group
-        size_t meshletCount = meshopt_buildMeshlets(
-            meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
-            meshletSourceIndices, groupIndexCount,
-            groupPositions, groupVertexCount, kPositionStride,
-            MAX_VERTICES, MAX_TRIANGLES, CONE_WEIGHT);
-
-        meshlets.resize(meshletCount);
-
-        // Optimize each meshlet
-        for (size_t i = 0; i < meshletCount; i++) {
-            meshopt_optimizeMeshlet(
-                &meshletVertices[meshlets[i].vertex_offset],
-                &meshletTriangles[meshlets[i].triangle_offset],
-                meshlets[i].triangle_count,
-                meshlets[i].vertex_count);
-        }
+bool buildGroupMeshlets(const LoadedMesh::PrimitiveGroup& group,
+                        const float* allPositions,
+                        const uint32_t* allIndices,
+                        uint32_t meshVertexCount,
+                        const RhiMeshletSizeLimits& sizeLimits,
+                        GroupMeshletScratch& out) {
+    constexpr size_t kPositionStride = sizeof(float) * 3;
+    const uint32_t* groupIndices = allIndices + group.indexOffset;
+    const size_t groupIndexCount = group.indexCount;
+    const uint32_t groupVertexOffset = group.vertexOffset;
+    const uint32_t groupVertexCount = group.vertexCount;
+    const auto* groupPositions = allPositions + static_cast<size_t>(groupVertexOffset) * 3;
 
-        // Compute bounds
-        for (size_t i = 0; i < meshletCount; i++) {
-            meshopt_Bounds bounds = meshopt_computeMeshletBounds(
-                &meshletVertices[meshlets[i].vertex_offset],
-                &meshletTriangles[meshlets[i].triangle_offset],
-                meshlets[i].triangle_count,
-                groupPositions, groupVertexCount, kPositionStride);
-
-            GPUMeshletBounds gb;
-            gb.center_radius[0] = bounds.center[0];
-            gb.center_radius[1] = bounds.center[1];
-            gb.center_radius[2] = bounds.center[2];
-            gb.center_radius[3] = bounds.radius;
-            gb.cone_apex_pad[0] = bounds.cone_apex[0];
-            gb.cone_apex_pad[1] = bounds.cone_apex[1];
-            gb.cone_apex_pad[2] = bounds.cone_apex[2];
-            gb.cone_apex_pad[3] = 0.0f;
-            gb.cone_axis_cutoff[0] = bounds.cone_axis[0];
-            gb.cone_axis_cutoff[1] = bounds.cone_axis[1];
-            gb.cone_axis_cutoff[2] = bounds.cone_axis[2];
-            gb.cone_axis_cutoff[3] = bounds.cone_cutoff;
-            allBounds.push_back(gb);
-        }
+    if (groupIndexCount == 0 || groupVertexCount == 0) {
+        return true;
+    }
 
-        // Merge vertex indices (global offsets into allMeshletVertices)
-        size_t vertexBaseOffset = allMeshletVertices.size();
-        if (meshletCount > 0) {
-            const meshopt_Meshlet& last = meshlets.back();
-            size_t usedVertices = last.vertex_offset + last.vertex_count;
-            allMeshletVertices.reserve(allMeshletVertices.size() + usedVertices);
-            for (size_t i = 0; i < usedVertices; ++i) {
-                allMeshletVertices.push_back(meshletVertices[i] + groupVertexOffset);
-            }
-        }
+    // Compute worst-case buffer sizes for this group
+    const size_t maxVertices = sizeLimits.maxVertices;
+    const size_t maxTriangles = sizeLimits.maxTriangles;
+    const size_t maxMeshlets = meshopt_buildMeshletsBound(groupIndexCount, maxVertices, maxTriangles);
+    std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+    std::vector<unsigned int> meshletVertices(maxMeshlets * maxVertices);
+    std::vector<unsigned char> meshletTriangles(maxMeshlets * maxTriangles * 3);
+    std::vector<uint32_t> localIndices;
 
-        // Pack triangles and merge
-        size_t packedBaseOffset = allPackedTriangles.size();
-        size_t rawTriBaseOffset = allRawTriangles.size();
-        for (size_t i = 0; i < meshletCount; i++) {
-            const meshopt_Meshlet& m = meshlets[i];
-            for (size_t t = 0; t < m.triangle_count; t++) {
-                size_t srcIdx = m.triangle_offset + t * 3;
-                uint32_t v0 = meshletTriangles[srcIdx + 0];
-                uint32_t v1 = meshletTriangles[srcIdx + 1];
-                uint32_t v2 = meshletTriangles[srcIdx + 2];
-                allPackedTriangles.push_back(v0 | (v1 << 8) | (v2 << 16));
-                allRawTriangles.push_back(meshletTriangles[srcIdx + 0]);
-                allRawTriangles.push_back(meshletTriangles[srcIdx + 1]);
-                allRawTriangles.push_back(meshletTriangles[srcIdx + 2]);
+    const uint32_t groupVertexEnd = groupVertexOffset + groupVertexCount;
+    const uint32_t* meshletSourceIndices = groupIndices;
+    if (groupVertexOffset != 0 || groupVertexCount != meshVertexCount) {
+        localIndices.resize(groupIndexCount);
+        for (size_t i = 0; i < groupIndexCount; ++i) {
+            const uint32_t index = groupIndices[i];
+            if (index < groupVertexOffset || index >= groupVertexEnd) {
+                spdlog::error("Primitive group index {} out of range [{}, {})",
+                              index,
+                              groupVertexOffset,
+                              groupVertexEnd);
+                return false;
             }
+            localIndices[i] = index - groupVertexOffset;
         }
-
-        // Build GPU meshlet descriptors with global offsets
-        size_t triOffset = packedBaseOffset;
-        for (size_t i = 0; i < meshletCount; i++) {
-            GPUMeshlet gm;
-            gm.vertex_offset   = static_cast<uint32_t>(vertexBaseOffset + meshlets[i].vertex_offset);
-            gm.triangle_offset = static_cast<uint32_t>(triOffset);
-            gm.vertex_count    = meshlets[i].vertex_count;
-            gm.triangle_count  = meshlets[i].triangle_count;
-            allGpuMeshlets.push_back(gm);
-            triOffset += meshlets[i].triangle_count;
+        meshletSourceIndices = localIndices.data();
+    }
+
+    // Build meshlets for this group
+    const size_t meshletCount = meshopt_buildMeshlets(
+        meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
+        meshletSourceIndices, groupIndexCount,
+        groupPositions, groupVertexCount, kPositionStride,
+        maxVertices, maxTriangles, CONE_WEIGHT);
+    meshlets.resize(meshletCount);
+
+    out.meshlets.reserve(meshletCount);
+    out.bounds.reserve(meshletCount);
+    for (size_t i = 0; i < meshletCount; i++) {
+        const meshopt_Meshlet& m = meshlets[i];
+        meshopt_optimizeMeshlet(
+            &meshletVertices[m.vertex_offset],
+            &meshletTriangles[m.triangle_offset],
+            m.triangle_count,
+            m.vertex_count);
+
+        meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+            &meshletVertices[m.vertex_offset],
+            &meshletTriangles[m.triangle_offset],
+            m.triangle_count,
+            groupPositions, groupVertexCount, kPositionStride);
+
+        GPUMeshletBounds gb;
+        gb.center_radius[0] = bounds.center[0];
+        gb.center_radius[1] = bounds.center[1];
+        gb.center_radius[2] = bounds.center[2];
+        gb.center_radius[3] = bounds.radius;
+        gb.cone_apex_pad[0] = bounds.cone_apex[0];
+        gb.cone_apex_pad[1] = bounds.cone_apex[1];
+        gb.cone_apex_pad[2] = bounds.cone_apex[2];
+        gb.cone_apex_pad[3] = 0.0f;
+        gb.cone_axis_cutoff[0] = bounds.cone_axis[0];
+        gb.cone_axis_cutoff[1] = bounds.cone_axis[1];
+        gb.cone_axis_cutoff[2] = bounds.cone_axis[2];
+        gb.cone_axis_cutoff[3] = bounds.cone_cutoff;
+        out.bounds.push_back(gb);
+    }
+
+    // Vertex indices are contiguous in meshopt output; rebase them to mesh-global indices
+    if (meshletCount > 0) {
+        const meshopt_Meshlet& last = meshlets.back();
+        const size_t usedVertices = last.vertex_offset + last.vertex_count;
+        out.vertices.resize(usedVertices);
+        for (size_t i = 0; i < usedVertices; ++i) {
+            out.vertices[i] = meshletVertices[i] + groupVertexOffset;
         }
+    }
 
-        // All meshlets in this group share the same material
-        for (size_t i = 0; i < meshletCount; i++) {
-            allMaterialIDs.push_back(group.materialIndex);
-        }
+    // Triangles are compacted (meshopt pads triangle offsets) and addressed in triangle units
+    uint32_t triangleOffset = 0;
+    for (size_t i = 0; i < meshletCount; i++) {
+        const meshopt_Meshlet& m = meshlets[i];
+        const size_t byteCount = static_cast<size_t>(m.triangle_count) * 3;
+        out.rawTriangles.insert(out.rawTriangles.end(),
+                                meshletTriangles.begin() + m.triangle_offset,
+                                meshletTriangles.begin() + m.triangle_offset + byteCount);
 
-        out.meshletsPerGroup.push_back(static_cast<uint32_t>(meshletCount));
-        return true;
-    };
+        GPUMeshlet gm;
+        gm.vertex_offset   = m.vertex_offset;
+        gm.triangle_offset = triangleOffset;
+        gm.vertex_count    = m.vertex_count;
+        gm.triangle_count  = m.triangle_count;
+        out.meshlets.push_back(gm);
+        triangleOffset += m.triangle_count;
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool buildMeshletsCpu(const LoadedMesh& mesh,
+                      const RhiMeshletSizeLimits& sizeLimits,
+                      MeshletData& out,
+                      const std::string& groupCacheDirectory) {
+    out.meshletsPerGroup.clear();
+    out.sizeLimits = sizeLimits;
 
-    if (mesh.primitiveGroups.empty()) {
+    const auto* allPositions = mesh.cpuPositions.empty()
+        ? static_cast<const float*>(rhiBufferContents(mesh.positionBuffer))
+        : mesh.cpuPositions.data();
+    const auto* allIndices = mesh.cpuIndices.empty()
+        ? static_cast<const uint32_t*>(rhiBufferContents(mesh.indexBuffer))
+        : mesh.cpuIndices.data();
+
+    if (!allPositions || !allIndices) {
+        spdlog::error("Meshlet builder requires CPU-readable position and index data");
+        return false;
+    }
+
+    std::vector<LoadedMesh::PrimitiveGroup> groups = mesh.primitiveGroups;
+    if (groups.empty()) {
         LoadedMesh::PrimitiveGroup group;
         group.indexOffset = 0;
         group.indexCount = mesh.indexCount;
         group.vertexOffset = 0;
         group.vertexCount = mesh.vertexCount;
         group.materialIndex = 0;
-        if (!buildGroupMeshlets(group)) {
+        groups.push_back(group);
+    }
+
+    // Each primitive group builds into its own scratch in parallel; the results are
+    // then concatenated in group order using prefix sums over the per-group counts.
+    std::vector<GroupMeshletScratch> groupScratch(groups.size());
+    std::vector<uint8_t> groupBuilt(groups.size(), 0);
+    std::atomic<uint32_t> groupCacheHits{0};
+    Parallel::parallelFor(groups.size(), [&](size_t groupIndex) {
+        const LoadedMesh::PrimitiveGroup& group = groups[groupIndex];
+        const uint64_t groupSignature =
+            groupCacheDirectory.empty() ? 0u : computePrimitiveGroupSignature(mesh, group);
+        std::filesystem::path groupCachePath;
+        if (groupSignature != 0u) {
+            groupCachePath = makeGroupCacheFilePath(groupCacheDirectory, groupSignature);
+            const bool hit = readGroupMeshletsFromCache(
+                groupCachePath, groupSignature, group, sizeLimits, groupScratch[groupIndex]);
+            StartupProfile::recordCache("meshlet groups", hit);
+            if (hit) {
+                groupBuilt[groupIndex] = 1u;
+                groupCacheHits.fetch_add(1u, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        groupBuilt[groupIndex] = buildGroupMeshlets(group,
+                                                    allPositions,
+                                                    allIndices,
+                                                    mesh.vertexCount,
+                                                    sizeLimits,
+                                                    groupScratch[groupIndex])
+            ? 1u
+            : 0u;
+        if (groupBuilt[groupIndex] != 0u && groupSignature != 0u) {
+            saveGroupMeshletsToCache(groupCachePath, groupSignature, group, sizeLimits, groupScratch[groupIndex]);
+        }
+    });
+    if (!groupCacheDirectory.empty()) {
+        spdlog::info("Meshlets: reused {} of {} primitive groups from the group cache",
+                     groupCacheHits.load(std::memory_order_relaxed),
+                     groups.size());
+    }
+
+    size_t meshletTotal = 0;
+    size_t vertexTotal = 0;
+    size_t rawTriangleTotal = 0;
+    out.meshletsPerGroup.reserve(groups.size());
+    for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+        if (groupBuilt[groupIndex] == 0) {
             return false;
         }
-    } else {
-        for (const auto& group : mesh.primitiveGroups) {
-            if (!buildGroupMeshlets(group)) {
-                return false;
-            }
+        const GroupMeshletScratch& scratch = groupScratch[groupIndex];
+        out.meshletsPerGroup.push_back(static_cast<uint32_t>(scratch.meshlets.size()));
+        meshletTotal += scratch.meshlets.size();
+        vertexTotal += scratch.vertices.size();
+        rawTriangleTotal += scratch.rawTriangles.size();
+    }
+
+    std::vector<GPUMeshlet> allGpuMeshlets;
+    std::vector<unsigned int> allMeshletVertices;
+    std::vector<unsigned char> allRawTriangles;
+    std::vector<GPUMeshletBounds> allBounds;
+    std::vector<uint32_t> allMaterialIDs;
+    allGpuMeshlets.reserve(meshletTotal);
+    allMeshletVertices.reserve(vertexTotal);
+    allRawTriangles.reserve(rawTriangleTotal);
+    allBounds.reserve(meshletTotal);
+    allMaterialIDs.reserve(meshletTotal);
+
+    for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+        GroupMeshletScratch& scratch = groupScratch[groupIndex];
+        const uint32_t vertexBaseOffset = static_cast<uint32_t>(allMeshletVertices.size());
+        const uint32_t triangleBaseOffset = static_cast<uint32_t>(allRawTriangles.size() / 3);
+        for (GPUMeshlet meshlet : scratch.meshlets) {
+            meshlet.vertex_offset += vertexBaseOffset;
+            meshlet.triangle_offset += triangleBaseOffset;
+            allGpuMeshlets.push_back(meshlet);
         }
+        allMeshletVertices.insert(allMeshletVertices.end(), scratch.vertices.begin(), scratch.vertices.end());
+        allRawTriangles.insert(allRawTriangles.end(), scratch.rawTriangles.begin(), scratch.rawTriangles.end());
+        allBounds.insert(allBounds.end(), scratch.bounds.begin(), scratch.bounds.end());
+        allMaterialIDs.insert(allMaterialIDs.end(), scratch.meshlets.size(), groups[groupIndex].materialIndex);
+        scratch = GroupMeshletScratch{};
     }
 
-    size_t totalMeshlets = allGpuMeshlets.size();
-    if (totalMeshlets == 0) {
+    if (allGpuMeshlets.empty()) {
         spdlog::error("No meshlets built");
         return false;
     }
 
     // Retain CPU-side copies for LOD building
-    out.cpuMeshlets = allGpuMeshlets;
-    out.cpuMeshletVertices = allMeshletVertices;
+    out.cpuMeshlets = std::move(allGpuMeshlets);
+    out.cpuMeshletVertices = std::move(allMeshletVertices);
     out.cpuMeshletTriangles = std::move(allRawTriangles);
-    out.cpuBounds = allBounds;
-    out.cpuMaterialIDs = allMaterialIDs;
-    if (!uploadMeshletBuffers(device, out)) {
+    out.cpuBounds = std::move(allBounds);
+    out.cpuMaterialIDs = std::move(allMaterialIDs);
+    return true;
+}
+
+bool buildMeshlets(const RhiDevice& device,
+                   const LoadedMesh& mesh,
+                   const RhiMeshletSizeLimits& sizeLimits,
+                   MeshletData& out,
+                   const std::string& groupCacheDirectory) {
+    const auto buildStart = std::chrono::steady_clock::now();
+    if (!buildMeshletsCpu(mesh, sizeLimits, out, groupCacheDirectory) || !uploadMeshletBuffers(device, out)) {
         return false;
     }
+    const size_t totalMeshlets = out.cpuMeshlets.size();
 
     // Print stats
     size_t totalTris = 0, totalVerts = 0;
-    for (const auto& gm : allGpuMeshlets) {
+    for (const auto& gm : out.cpuMeshlets) {
         totalTris += gm.triangle_count;
         totalVerts += gm.vertex_count;
     }
     const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::steady_clock::now() - buildStart).count();
-    spdlog::info("Built {} meshlets from {} groups (avg {} verts, {} tris per meshlet)",
+    spdlog::info("Built {} meshlets ({}v/{}t max) from {} groups (avg {} verts, {} tris per meshlet)",
                  totalMeshlets,
+                 sizeLimits.maxVertices,
+                 sizeLimits.maxTriangles,
                  out.meshletsPerGroup.size(),
                  totalVerts / totalMeshlets,
                  totalTris / totalMeshlets);
@@ -636,14 +793,19 @@ bool buildMeshlets(const RhiDevice& device, const LoadedMesh& mesh, MeshletData&
 
 bool loadOrBuildMeshlets(const RhiDevice& device,
                          const LoadedMesh& mesh,
+                         const RhiMeshletSizeLimits& sizeLimits,
                          const std::string& sourcePath,
                          const std::string& cacheDirectory,
                          MeshletData& out) {
-    if (loadMeshletsFromCache(device, mesh, sourcePath, cacheDirectory, out)) {
+    StartupProfile::Phase phase("Meshlets");
+    const bool cached = loadMeshletsFromCache(device, mesh, sizeLimits, sourcePath, cacheDirectory, out);
+    phase.setCacheHit(cached);
+    StartupProfile::recordCache("meshlets", cached);
+    if (cached) {
         return true;
     }
 
-    if (!buildMeshlets(device, mesh, out)) {
+    if (!buildMeshlets(device, mesh, sizeLimits, out, cacheDirectory)) {
         return false;
     }
 
@@ -31,6 +31,8 @@ struct MeshletData {
     RhiBufferHandle materialIDs;
     uint32_t meshletCount = 0;
     std::vector<uint32_t> meshletsPerGroup;
+    // Caps the meshlets were built to; cluster LOD reclusterizes to the same caps.
+    RhiMeshletSizeLimits sizeLimits;
 
     // CPU-side data retained for LOD building
     std::vector<GPUMeshlet>       cpuMeshlets;
@@ -40,9 +42,33 @@ struct MeshletData {
     std::vector<uint32_t>         cpuMaterialIDs;
 };
 
-bool buildMeshlets(const RhiDevice& device, const LoadedMesh& mesh, MeshletData& out);
+// CPU half of buildMeshlets: fills the cpu* arrays without creating GPU buffers.
+// With a groupCacheDirectory, each primitive group is first looked up there by
+// its geometry signature and written back when built, so a mesh whose whole-mesh
+// cache missed only rebuilds the groups that changed.
+bool buildMeshletsCpu(const LoadedMesh& mesh,
+                      const RhiMeshletSizeLimits& sizeLimits,
+                      MeshletData& out,
+                      const std::string& groupCacheDirectory = {});
+bool buildMeshlets(const RhiDevice& device,
+                   const LoadedMesh& mesh,
+                   const RhiMeshletSizeLimits& sizeLimits,
+                   MeshletData& out,
+                   const std::string& groupCacheDirectory = {});
 bool loadOrBuildMeshlets(const RhiDevice& device,
                          const LoadedMesh& mesh,
+                         const RhiMeshletSizeLimits& sizeLimits,
                          const std::string& sourcePath,
                          const std::string& cacheDirectory,
                          MeshletData& out);
+// Meshlet cache files, keyed by source path and mesh signature. Reading only
+// fills the cpu* arrays; loadOrBuildMeshlets uploads them afterwards.
+bool saveMeshletsToCache(const LoadedMesh& mesh,
+                         const std::string& sourcePath,
+                         const std::string& cacheDirectory,
+                         const MeshletData& data);
+bool readMeshletsFromCache(const LoadedMesh& mesh,
+                           const RhiMeshletSizeLimits& sizeLimits,
+                           const std::string& sourcePath,
+                           const std::string& cacheDirectory,
+                           MeshletData& out);
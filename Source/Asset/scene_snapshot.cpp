@@ -0,0 +1,558 @@
+#include "scene_snapshot.h"
+#include "scene.h"
+#include "fast_hash.h"
+#include "mapped_file.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+namespace {
+
+constexpr char kSceneSnapshotMagic[8] = {'M', 'L', 'S', 'C', 'E', 'N', 'E', '1'};
+constexpr uint32_t kSceneSnapshotVersion = 2;
+constexpr uint32_t kSnapshotFlagBC7 = 1u << 0;
+
+struct SceneSnapshotHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t flags = 0;
+    uint64_t sourceSignature = 0;
+    uint64_t payloadSize = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<SceneSnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<ScenePrimitive>);
+static_assert(std::is_trivially_copyable_v<SceneMeshInfo>);
+static_assert(std::is_trivially_copyable_v<SceneMaterial>);
+static_assert(std::is_trivially_copyable_v<SceneCamera>);
+static_assert(std::is_trivially_copyable_v<SceneLight>);
+static_assert(std::is_trivially_copyable_v<TranscodedMipLevel>);
+
+std::string sanitizeCacheStem(std::string stem) {
+    if (stem.empty()) {
+        return "scene";
+    }
+
+    for (char& ch : stem) {
+        const bool isAlphaNum =
+            (ch >= 'a' && ch <= 'z') ||
+            (ch >= 'A' && ch <= 'Z') ||
+            (ch >= '0' && ch <= '9');
+        if (!isAlphaNum && ch != '-' && ch != '_') {
+            ch = '_';
+        }
+    }
+    return stem;
+}
+
+std::filesystem::path makeSnapshotPath(const std::string& sourcePath,
+                                       const std::string& cacheDirectory,
+                                       uint64_t signature) {
+    std::ostringstream fileName;
+    fileName << sanitizeCacheStem(std::filesystem::path(sourcePath).stem().string())
+             << "_"
+             << std::hex
+             << std::setw(16)
+             << std::setfill('0')
+             << std::nouppercase
+             << signature
+             << ".scenesnapshot";
+    return std::filesystem::path(cacheDirectory) / fileName.str();
+}
+
+// Streams the payload in the order SnapshotReader consumes it. Vectors and
+// strings are a 64-bit element count followed by the raw elements.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ofstream& file) : m_file(file) {}
+
+    template <typename T>
+    void value(const T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void vector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        value(static_cast<uint64_t>(values.size()));
+        write(values.data(), values.size() * sizeof(T));
+    }
+
+    void string(const std::string& s) {
+        value(static_cast<uint64_t>(s.size()));
+        write(s.data(), s.size());
+    }
+
+    uint64_t bytesWritten() const { return m_bytes; }
+
+private:
+    void write(const void* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        m_bytes += size;
+    }
+
+    std::ofstream& m_file;
+    uint64_t m_bytes = 0;
+};
+
+// Bounds-checked cursor over the mapped payload; any overrun latches ok() false.
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    template <typename T>
+    void value(T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        read(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void vector(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const uint64_t count = readCount(sizeof(T));
+        values.resize(static_cast<size_t>(count));
+        read(values.data(), values.size() * sizeof(T));
+    }
+
+    void string(std::string& s) {
+        const uint64_t count = readCount(1);
+        s.resize(static_cast<size_t>(count));
+        read(s.data(), s.size());
+    }
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    uint64_t readCount(size_t elementSize) {
+        uint64_t count = 0;
+        value(count);
+        if (!m_ok || count > static_cast<uint64_t>(m_end - m_cursor) / elementSize) {
+            m_ok = false;
+            return 0;
+        }
+        return count;
+    }
+
+    void read(void* out, size_t size) {
+        if (!m_ok || size > static_cast<size_t>(m_end - m_cursor)) {
+            m_ok = false;
+            return;
+        }
+        if (size != 0) {
+            std::memcpy(out, m_cursor, size);
+        }
+        m_cursor += size;
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_ok = true;
+};
+
+void writeScene(SnapshotWriter& w, const Scene& scene) {
+    w.string(scene.filePath());
+    w.vector(scene.positions);
+    w.vector(scene.normals);
+    w.vector(scene.uvs);
+    w.vector(scene.indices);
+    w.vector(scene.skinJoints);
+    w.vector(scene.skinWeights);
+    w.vector(scene.morphDeltas);
+    w.vector(scene.primitives);
+    w.vector(scene.meshInfos);
+    w.vector(scene.materials);
+
+    w.value(static_cast<uint64_t>(scene.images.size()));
+    for (const SceneImage& image : scene.images) {
+        w.value(image.width);
+        w.value(image.height);
+        w.value(image.channels);
+        w.string(image.uri);
+    }
+
+    w.value(static_cast<uint64_t>(scene.nodes.size()));
+    for (const SceneNodeData& node : scene.nodes) {
+        w.string(node.name);
+        w.value(node.parent);
+        w.vector(node.children);
+        w.value(node.translation);
+        w.value(node.rotation);
+        w.value(node.scale);
+        w.value(node.hasMatrix);
+        w.value(node.localMatrix);
+        w.value(node.mesh);
+        w.value(node.light);
+        w.value(node.camera);
+        w.vector(node.instanceMatrices);
+        w.value(node.skin);
+        w.vector(node.morphWeights);
+    }
+
+    w.vector(scene.rootNodes);
+    w.vector(scene.cameras);
+    w.vector(scene.lights);
+
+    w.value(static_cast<uint64_t>(scene.skins.size()));
+    for (const SceneSkin& skin : scene.skins) {
+        w.string(skin.name);
+        w.vector(skin.joints);
+        w.vector(skin.inverseBindMatrices);
+    }
+    w.value(static_cast<uint64_t>(scene.animations.size()));
+    for (const SceneAnimation& animation : scene.animations) {
+        w.string(animation.name);
+        w.value(animation.duration);
+        w.value(static_cast<uint64_t>(animation.samplers.size()));
+        for (const SceneAnimationSampler& sampler : animation.samplers) {
+            w.value(sampler.interpolation);
+            w.value(sampler.components);
+            w.vector(sampler.times);
+            w.vector(sampler.values);
+        }
+        w.vector(animation.channels);
+    }
+
+    w.value(scene.bboxMin);
+    w.value(scene.bboxMax);
+    w.value(scene.hasBakedRootScale);
+    w.value(scene.bakedRootScale);
+}
+
+void readScene(SnapshotReader& r, Scene& scene, std::string& filePath) {
+    r.string(filePath);
+    r.vector(scene.positions);
+    r.vector(scene.normals);
+    r.vector(scene.uvs);
+    r.vector(scene.indices);
+    r.vector(scene.skinJoints);
+    r.vector(scene.skinWeights);
+    r.vector(scene.morphDeltas);
+    r.vector(scene.primitives);
+    r.vector(scene.meshInfos);
+    r.vector(scene.materials);
+
+    uint64_t imageCount = 0;
+    r.value(imageCount);
+    for (uint64_t i = 0; i < imageCount && r.ok(); ++i) {
+        SceneImage& image = scene.images.emplace_back();
+        r.value(image.width);
+        r.value(image.height);
+        r.value(image.channels);
+        r.string(image.uri);
+    }
+
+    uint64_t nodeCount = 0;
+    r.value(nodeCount);
+    for (uint64_t i = 0; i < nodeCount && r.ok(); ++i) {
+        SceneNodeData& node = scene.nodes.emplace_back();
+        r.string(node.name);
+        r.value(node.parent);
+        r.vector(node.children);
+        r.value(node.translation);
+        r.value(node.rotation);
+        r.value(node.scale);
+        r.value(node.hasMatrix);
+        r.value(node.localMatrix);
+        r.value(node.mesh);
+        r.value(node.light);
+        r.value(node.camera);
+        r.vector(node.instanceMatrices);
+        r.value(node.skin);
+        r.vector(node.morphWeights);
+    }
+
+    r.vector(scene.rootNodes);
+    r.vector(scene.cameras);
+    r.vector(scene.lights);
+
+    uint64_t skinCount = 0;
+    r.value(skinCount);
+    for (uint64_t i = 0; i < skinCount && r.ok(); ++i) {
+        SceneSkin& skin = scene.skins.emplace_back();
+        r.string(skin.name);
+        r.vector(skin.joints);
+        r.vector(skin.inverseBindMatrices);
+    }
+    uint64_t animationCount = 0;
+    r.value(animationCount);
+    for (uint64_t i = 0; i < animationCount && r.ok(); ++i) {
+        SceneAnimation& animation = scene.animations.emplace_back();
+        r.string(animation.name);
+        r.value(animation.duration);
+        uint64_t samplerCount = 0;
+        r.value(samplerCount);
+        for (uint64_t s = 0; s < samplerCount && r.ok(); ++s) {
+            SceneAnimationSampler& sampler = animation.samplers.emplace_back();
+            r.value(sampler.interpolation);
+            r.value(sampler.components);
+            r.vector(sampler.times);
+            r.vector(sampler.values);
+        }
+        r.vector(animation.channels);
+    }
+
+    r.value(scene.bboxMin);
+    r.value(scene.bboxMax);
+    r.value(scene.hasBakedRootScale);
+    r.value(scene.bakedRootScale);
+}
+
+// Indices must stay inside the vertex range and node links inside the node
+// table; everything downstream indexes with them unchecked.
+bool validateScene(const Scene& scene) {
+    if (scene.positions.size() % 3 != 0 ||
+        scene.normals.size() != scene.positions.size() ||
+        scene.uvs.size() != scene.positions.size() / 3 * 2) {
+        return false;
+    }
+    const uint64_t vertexCount = scene.positions.size() / 3;
+    if ((!scene.skinJoints.empty() && scene.skinJoints.size() != vertexCount * 4) ||
+        scene.skinWeights.size() != scene.skinJoints.size()) {
+        return false;
+    }
+    for (const ScenePrimitive& primitive : scene.primitives) {
+        if (static_cast<uint64_t>(primitive.indexOffset) + primitive.indexCount > scene.indices.size() ||
+            static_cast<uint64_t>(primitive.vertexOffset) + primitive.vertexCount > vertexCount ||
+            (primitive.skinned && scene.skinJoints.empty()) ||
+            primitive.morphDeltaOffset + uint64_t(primitive.morphTargetCount) * primitive.vertexCount * 6 >
+                scene.morphDeltas.size()) {
+            return false;
+        }
+    }
+    if (std::any_of(scene.indices.begin(), scene.indices.end(),
+                    [vertexCount](uint32_t index) { return index >= vertexCount; })) {
+        return false;
+    }
+    for (const SceneMeshInfo& mesh : scene.meshInfos) {
+        if (static_cast<uint64_t>(mesh.firstPrimitive) + mesh.primitiveCount > scene.primitives.size()) {
+            return false;
+        }
+    }
+
+    const int nodeCount = static_cast<int>(scene.nodes.size());
+    for (const SceneNodeData& node : scene.nodes) {
+        if (node.parent < -1 || node.parent >= nodeCount ||
+            node.mesh >= static_cast<int>(scene.meshInfos.size()) ||
+            node.skin >= static_cast<int>(scene.skins.size()) ||
+            node.instanceMatrices.size() % 16 != 0) {
+            return false;
+        }
+        for (int child : node.children) {
+            if (child < 0 || child >= nodeCount) {
+                return false;
+            }
+        }
+    }
+    for (const SceneSkin& skin : scene.skins) {
+        if (skin.inverseBindMatrices.size() != skin.joints.size() * 16 ||
+            std::any_of(skin.joints.begin(), skin.joints.end(),
+                        [nodeCount](int joint) { return joint < 0 || joint >= nodeCount; })) {
+            return false;
+        }
+    }
+    for (const SceneAnimation& animation : scene.animations) {
+        for (const SceneAnimationSampler& sampler : animation.samplers) {
+            const uint64_t valuesPerKey = sampler.interpolation == SceneAnimationSampler::CubicSpline ? 3 : 1;
+            if (sampler.values.size() != sampler.times.size() * sampler.components * valuesPerKey) {
+                return false;
+            }
+        }
+        for (const SceneAnimationChannel& channel : animation.channels) {
+            if (channel.node < 0 || channel.node >= nodeCount || channel.sampler >= animation.samplers.size()) {
+                return false;
+            }
+        }
+    }
+    return std::all_of(scene.rootNodes.begin(), scene.rootNodes.end(),
+                       [nodeCount](int root) { return root >= 0 && root < nodeCount; });
+}
+
+bool validateTexture(const TranscodedTexture& texture) {
+    if (texture.mips.empty()) {
+        return texture.data.empty();
+    }
+    return std::all_of(texture.mips.begin(), texture.mips.end(), [&](const TranscodedMipLevel& mip) {
+        return mip.offset <= texture.data.size() && mip.size <= texture.data.size() - mip.offset;
+    });
+}
+
+} // namespace
+
+uint64_t computeSceneSourceSignature(const std::string& gltfPath) {
+    const std::filesystem::path path(gltfPath);
+    std::error_code error;
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(path.parent_path().empty()
+                                                                     ? std::filesystem::path(".")
+                                                                     : path.parent_path(),
+                                                                 error)) {
+        if (entry.is_regular_file(error)) {
+            files.push_back(entry.path().filename());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    FastHash::Hasher hasher;
+    hasher.addValue(kSceneSnapshotVersion);
+    const std::string normalized = path.lexically_normal().generic_string();
+    hasher.addBytes(normalized.data(), normalized.size());
+    for (const std::filesystem::path& name : files) {
+        const std::filesystem::path file = path.parent_path() / name;
+        const std::string fileName = name.generic_string();
+        const uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(file, error));
+        const int64_t writeTime = static_cast<int64_t>(
+            std::filesystem::last_write_time(file, error).time_since_epoch().count());
+        hasher.addBytes(fileName.data(), fileName.size());
+        hasher.addValue(size);
+        hasher.addValue(writeTime);
+    }
+    return hasher.finish();
+}
+
+bool loadSceneSnapshot(const std::string& gltfPath,
+                       const std::string& cacheDirectory,
+                       bool bc7Textures,
+                       Scene& scene,
+                       std::vector<TranscodedTexture>& textures) {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t signature = computeSceneSourceSignature(gltfPath);
+    const std::filesystem::path snapshotPath = makeSnapshotPath(gltfPath, cacheDirectory, signature);
+    if (!std::filesystem::exists(snapshotPath)) {
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(snapshotPath)) {
+        spdlog::warn("Failed to map scene snapshot {}", snapshotPath.string());
+        return false;
+    }
+
+    SceneSnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        spdlog::warn("Scene snapshot {} is truncated", snapshotPath.string());
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSceneSnapshotMagic, sizeof(header.magic)) != 0 ||
+        header.version != kSceneSnapshotVersion ||
+        header.sourceSignature != signature ||
+        header.payloadSize != file.size() - sizeof(header)) {
+        spdlog::warn("Scene snapshot {} is incompatible with the current source", snapshotPath.string());
+        return false;
+    }
+    if (((header.flags & kSnapshotFlagBC7) != 0) != bc7Textures) {
+        spdlog::info("Scene snapshot {} was built for another texture format, reloading glTF",
+                     snapshotPath.string());
+        return false;
+    }
+
+    scene.clear();
+    SnapshotReader reader(file.data() + sizeof(header), static_cast<size_t>(header.payloadSize));
+    std::string filePath;
+    readScene(reader, scene, filePath);
+
+    uint64_t textureCount = 0;
+    reader.value(textureCount);
+    std::vector<TranscodedTexture> chains;
+    for (uint64_t i = 0; i < textureCount && reader.ok(); ++i) {
+        TranscodedTexture& texture = chains.emplace_back();
+        uint32_t format = 0;
+        reader.value(format);
+        texture.format = static_cast<RhiFormat>(format);
+        reader.value(texture.width);
+        reader.value(texture.height);
+        reader.vector(texture.mips);
+        reader.vector(texture.data);
+    }
+
+    if (!reader.ok() || !reader.atEnd() || filePath != gltfPath || !validateScene(scene) ||
+        chains.size() > scene.images.size() || !std::all_of(chains.begin(), chains.end(), validateTexture)) {
+        spdlog::warn("Scene snapshot {} failed payload validation", snapshotPath.string());
+        scene.clear();
+        return false;
+    }
+
+    scene.m_filePath = gltfPath;
+    scene.m_loaded = true;
+    textures = std::move(chains);
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Scene restored from snapshot {} ({:.1f} MB, {} nodes, {} textures) in {:.1f} ms",
+                 snapshotPath.string(),
+                 static_cast<double>(file.size()) / (1024.0 * 1024.0),
+                 scene.nodes.size(), textures.size(), ms);
+    return true;
+}
+
+bool saveSceneSnapshot(const Scene& scene,
+                       const std::string& cacheDirectory,
+                       bool bc7Textures,
+                       const std::vector<const TranscodedTexture*>& textures) {
+    if (!scene.isLoaded() || textures.size() > scene.images.size()) {
+        return false;
+    }
+
+    std::error_code createError;
+    std::filesystem::create_directories(cacheDirectory, createError);
+    if (createError) {
+        spdlog::warn("Failed to create scene snapshot directory {}: {}", cacheDirectory, createError.message());
+        return false;
+    }
+
+    const uint64_t signature = computeSceneSourceSignature(scene.filePath());
+    const std::filesystem::path snapshotPath = makeSnapshotPath(scene.filePath(), cacheDirectory, signature);
+    std::ofstream file(snapshotPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open scene snapshot for write: {}", snapshotPath.string());
+        return false;
+    }
+
+    // The payload size is patched in once everything has been streamed.
+    SceneSnapshotHeader header;
+    std::memcpy(header.magic, kSceneSnapshotMagic, sizeof(header.magic));
+    header.version = kSceneSnapshotVersion;
+    header.flags = bc7Textures ? kSnapshotFlagBC7 : 0u;
+    header.sourceSignature = signature;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    SnapshotWriter writer(file);
+    writeScene(writer, scene);
+    writer.value(static_cast<uint64_t>(textures.size()));
+    const TranscodedTexture emptyTexture;
+    for (const TranscodedTexture* source : textures) {
+        const TranscodedTexture& texture = source ? *source : emptyTexture;
+        writer.value(static_cast<uint32_t>(texture.format));
+        writer.value(texture.width);
+        writer.value(texture.height);
+        writer.vector(texture.mips);
+        writer.vector(texture.data);
+    }
+
+    header.payloadSize = writer.bytesWritten();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        spdlog::warn("Failed to write scene snapshot {}", snapshotPath.string());
+        std::filesystem::remove(snapshotPath, createError);
+        return false;
+    }
+
+    spdlog::info("Saved scene snapshot {} ({:.1f} MB)", snapshotPath.string(),
+                 static_cast<double>(sizeof(header) + header.payloadSize) / (1024.0 * 1024.0));
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "texture_transcoder.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Scene;
+
+// Versioned binary image of a parsed Scene and its GPU-ready texture chains,
+// stored in the cache directory and keyed by computeSceneSourceSignature().
+// Restoring it is one mapped read that replaces the glTF parse, the image decode
+// and the per-texture cache lookups; restored images carry no pixels, so the
+// chains must be handed to SceneGpu::setPrebuiltTextures. Meshlets and ClusterLOD
+// keep their own caches, keyed by mesh content.
+
+// Path, size and modification time of the glTF and every file beside it; cheap
+// enough to check on each start and changes whenever a referenced file does.
+uint64_t computeSceneSourceSignature(const std::string& gltfPath);
+
+// bc7Textures must match how the chains would be built on this device; a
+// snapshot written with the other choice is ignored.
+bool loadSceneSnapshot(const std::string& gltfPath,
+                       const std::string& cacheDirectory,
+                       bool bc7Textures,
+                       Scene& scene,
+                       std::vector<TranscodedTexture>& textures);
+
+// textures[i] is the chain built for scene.images[i]; null entries are stored empty.
+bool saveSceneSnapshot(const Scene& scene,
+                       const std::string& cacheDirectory,
+                       bool bc7Textures,
+                       const std::vector<const TranscodedTexture*>& textures);
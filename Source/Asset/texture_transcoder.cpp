@@ -0,0 +1,488 @@
+#include "texture_transcoder.h"
+#include "fast_hash.h"
+#include "parallel_for.h"
+#include "startup_profile.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+namespace {
+
+constexpr char kTextureCacheMagic[8] = {'M', 'L', 'T', 'E', 'X', 'B', 'C', '7'};
+constexpr uint32_t kTextureCacheVersion = 1;
+constexpr size_t kBC7BlockBytes = 16;
+
+struct TextureCacheHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t format = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipCount = 0;
+    uint32_t reserved = 0;
+    uint64_t pixelSignature = 0;
+    uint64_t dataSize = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<TextureCacheHeader>);
+static_assert(std::is_trivially_copyable_v<TranscodedMipLevel>);
+
+// 4-bit index interpolation weights shared by every BC7 mode with 16 palette entries.
+constexpr int32_t kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+uint32_t mipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    uint32_t dim = std::max(width, height);
+    while (dim > 1) {
+        dim >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+void downsampleRGBA8(const std::vector<uint8_t>& src,
+                     uint32_t srcWidth,
+                     uint32_t srcHeight,
+                     uint32_t dstWidth,
+                     uint32_t dstHeight,
+                     std::vector<uint8_t>& dst) {
+    dst.resize(static_cast<size_t>(dstWidth) * dstHeight * 4u);
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        const uint32_t y0 = std::min(y * 2u, srcHeight - 1u);
+        const uint32_t y1 = std::min(y * 2u + 1u, srcHeight - 1u);
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            const uint32_t x0 = std::min(x * 2u, srcWidth - 1u);
+            const uint32_t x1 = std::min(x * 2u + 1u, srcWidth - 1u);
+            const uint8_t* p00 = &src[(static_cast<size_t>(y0) * srcWidth + x0) * 4u];
+            const uint8_t* p01 = &src[(static_cast<size_t>(y0) * srcWidth + x1) * 4u];
+            const uint8_t* p10 = &src[(static_cast<size_t>(y1) * srcWidth + x0) * 4u];
+            const uint8_t* p11 = &src[(static_cast<size_t>(y1) * srcWidth + x1) * 4u];
+            uint8_t* out = &dst[(static_cast<size_t>(y) * dstWidth + x) * 4u];
+            for (uint32_t c = 0; c < 4; ++c) {
+                out[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2u) / 4u);
+            }
+        }
+    }
+}
+
+class BlockBitWriter {
+public:
+    void write(uint32_t value, uint32_t bitCount) {
+        for (uint32_t i = 0; i < bitCount; ++i, ++m_bit) {
+            const uint8_t bit = static_cast<uint8_t>((value >> i) & 1u);
+            m_bytes[m_bit >> 3] |= static_cast<uint8_t>(bit << (m_bit & 7u));
+        }
+    }
+
+    const uint8_t* bytes() const { return m_bytes; }
+
+private:
+    uint8_t m_bytes[kBC7BlockBytes] = {};
+    uint32_t m_bit = 0;
+};
+
+// Mode 6: one subset, 7-bit RGBA endpoints with a p-bit each, 4-bit indices.
+// The endpoints follow the principal axis of the block and all four p-bit
+// combinations are scored, which keeps the encoder single-pass.
+void encodeBC7Mode6(const int32_t pixels[16][4], uint8_t* outBlock) {
+    float mean[4] = {};
+    for (uint32_t i = 0; i < 16; ++i) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            mean[c] += static_cast<float>(pixels[i][c]);
+        }
+    }
+    for (float& value : mean) {
+        value /= 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (uint32_t i = 0; i < 16; ++i) {
+        float d[4];
+        for (uint32_t c = 0; c < 4; ++c) {
+            d[c] = static_cast<float>(pixels[i][c]) - mean[c];
+        }
+        for (uint32_t r = 0; r < 4; ++r) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                covariance[r][c] += d[r] * d[c];
+            }
+        }
+    }
+
+    float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        for (uint32_t r = 0; r < 4; ++r) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                next[r] += covariance[r][c] * axis[c];
+            }
+        }
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] +
+                                       next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f) {
+            break;
+        }
+        for (uint32_t c = 0; c < 4; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float minT = 0.0f;
+    float maxT = 0.0f;
+    for (uint32_t i = 0; i < 16; ++i) {
+        float t = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c) {
+            t += (static_cast<float>(pixels[i][c]) - mean[c]) * axis[c];
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    float endpoints[2][4];
+    for (uint32_t c = 0; c < 4; ++c) {
+        endpoints[0][c] = std::clamp(mean[c] + minT * axis[c], 0.0f, 255.0f);
+        endpoints[1][c] = std::clamp(mean[c] + maxT * axis[c], 0.0f, 255.0f);
+    }
+
+    uint32_t bestError = UINT32_MAX;
+    int32_t bestQuantized[2][4] = {};
+    uint32_t bestPBits[2] = {};
+    uint32_t bestIndices[16] = {};
+
+    for (uint32_t pBitMask = 0; pBitMask < 4; ++pBitMask) {
+        const uint32_t pBits[2] = {pBitMask & 1u, pBitMask >> 1};
+        int32_t quantized[2][4];
+        int32_t expanded[2][4];
+        for (uint32_t e = 0; e < 2; ++e) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                const float scaled = (endpoints[e][c] - static_cast<float>(pBits[e])) * 0.5f;
+                quantized[e][c] = std::clamp(static_cast<int32_t>(std::lround(scaled)), 0, 127);
+                expanded[e][c] = (quantized[e][c] << 1) | static_cast<int32_t>(pBits[e]);
+            }
+        }
+
+        int32_t palette[16][4];
+        for (uint32_t i = 0; i < 16; ++i) {
+            const int32_t w = kBC7Weights4[i];
+            for (uint32_t c = 0; c < 4; ++c) {
+                palette[i][c] = ((64 - w) * expanded[0][c] + w * expanded[1][c] + 32) >> 6;
+            }
+        }
+
+        uint32_t error = 0;
+        uint32_t indices[16];
+        for (uint32_t p = 0; p < 16; ++p) {
+            uint32_t bestPixelError = UINT32_MAX;
+            uint32_t bestIndex = 0;
+            for (uint32_t i = 0; i < 16; ++i) {
+                uint32_t pixelError = 0;
+                for (uint32_t c = 0; c < 4; ++c) {
+                    const int32_t d = pixels[p][c] - palette[i][c];
+                    pixelError += static_cast<uint32_t>(d * d);
+                }
+                if (pixelError < bestPixelError) {
+                    bestPixelError = pixelError;
+                    bestIndex = i;
+                }
+            }
+            indices[p] = bestIndex;
+            error += bestPixelError;
+        }
+
+        if (error < bestError) {
+            bestError = error;
+            std::memcpy(bestQuantized, quantized, sizeof(bestQuantized));
+            std::memcpy(bestIndices, indices, sizeof(bestIndices));
+            bestPBits[0] = pBits[0];
+            bestPBits[1] = pBits[1];
+        }
+    }
+
+    // The anchor index is stored with its top bit implied zero; swapping the
+    // endpoints mirrors the palette because the weight table is symmetric.
+    if (bestIndices[0] >= 8) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            std::swap(bestQuantized[0][c], bestQuantized[1][c]);
+        }
+        std::swap(bestPBits[0], bestPBits[1]);
+        for (uint32_t& index : bestIndices) {
+            index = 15u - index;
+        }
+    }
+
+    BlockBitWriter writer;
+    writer.write(1u << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c) {
+        writer.write(static_cast<uint32_t>(bestQuantized[0][c]), 7);
+        writer.write(static_cast<uint32_t>(bestQuantized[1][c]), 7);
+    }
+    writer.write(bestPBits[0], 1);
+    writer.write(bestPBits[1], 1);
+    writer.write(bestIndices[0], 3);
+    for (uint32_t i = 1; i < 16; ++i) {
+        writer.write(bestIndices[i], 4);
+    }
+    std::memcpy(outBlock, writer.bytes(), kBC7BlockBytes);
+}
+
+void encodeLevelBC7(const std::vector<uint8_t>& rgba,
+                    uint32_t width,
+                    uint32_t height,
+                    uint8_t* outBlocks) {
+    const uint32_t blocksX = (width + 3u) / 4u;
+    const uint32_t blocksY = (height + 3u) / 4u;
+    Parallel::parallelFor(blocksY, [&](size_t blockY) {
+        int32_t pixels[16][4];
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            for (uint32_t y = 0; y < 4; ++y) {
+                const uint32_t sy = std::min(static_cast<uint32_t>(blockY) * 4u + y, height - 1u);
+                for (uint32_t x = 0; x < 4; ++x) {
+                    const uint32_t sx = std::min(blockX * 4u + x, width - 1u);
+                    const uint8_t* src = &rgba[(static_cast<size_t>(sy) * width + sx) * 4u];
+                    for (uint32_t c = 0; c < 4; ++c) {
+                        pixels[y * 4u + x][c] = src[c];
+                    }
+                }
+            }
+            encodeBC7Mode6(pixels, outBlocks + (blockY * blocksX + blockX) * kBC7BlockBytes);
+        }
+    });
+}
+
+uint64_t computeTextureSignature(const uint8_t* rgba, uint32_t width, uint32_t height) {
+    FastHash::Hasher hasher;
+    hasher.addValue(width);
+    hasher.addValue(height);
+    hasher.addBytes(rgba, static_cast<size_t>(width) * height * 4u);
+    return hasher.finish();
+}
+
+std::filesystem::path makeTextureCachePath(const std::string& cacheDirectory, uint64_t signature) {
+    std::ostringstream fileName;
+    fileName << "texture_"
+             << std::hex
+             << std::setw(16)
+             << std::setfill('0')
+             << std::nouppercase
+             << signature
+             << ".texcache";
+    return std::filesystem::path(cacheDirectory) / fileName.str();
+}
+
+bool validateTranscodedTexture(const TranscodedTexture& texture) {
+    if (texture.mips.size() != mipLevelCount(texture.width, texture.height)) {
+        return false;
+    }
+
+    uint32_t width = texture.width;
+    uint32_t height = texture.height;
+    uint64_t expectedOffset = 0;
+    for (const TranscodedMipLevel& mip : texture.mips) {
+        const uint64_t bytesPerRow = static_cast<uint64_t>((width + 3u) / 4u) * kBC7BlockBytes;
+        const uint64_t size = bytesPerRow * ((height + 3u) / 4u);
+        if (mip.width != width || mip.height != height || mip.offset != expectedOffset ||
+            mip.bytesPerRow != bytesPerRow || mip.size != size) {
+            return false;
+        }
+        expectedOffset += size;
+        width = std::max(width >> 1, 1u);
+        height = std::max(height >> 1, 1u);
+    }
+    return expectedOffset == texture.data.size();
+}
+
+bool loadTextureFromCache(const std::filesystem::path& cachePath,
+                          uint64_t signature,
+                          uint32_t width,
+                          uint32_t height,
+                          TranscodedTexture& out) {
+    if (!std::filesystem::exists(cachePath)) {
+        return false;
+    }
+
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open texture cache file {}", cachePath.string());
+        return false;
+    }
+
+    TextureCacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file ||
+        std::memcmp(header.magic, kTextureCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != kTextureCacheVersion ||
+        header.format != static_cast<uint32_t>(RhiFormat::BC7RGBAUnorm) ||
+        header.pixelSignature != signature ||
+        header.width != width ||
+        header.height != height ||
+        header.mipCount != mipLevelCount(width, height)) {
+        spdlog::warn("Texture cache {} is incompatible with the current image", cachePath.string());
+        return false;
+    }
+
+    TranscodedTexture cached;
+    cached.format = RhiFormat::BC7RGBAUnorm;
+    cached.width = width;
+    cached.height = height;
+    cached.mips.resize(header.mipCount);
+    cached.data.resize(header.dataSize);
+    file.read(reinterpret_cast<char*>(cached.mips.data()),
+              static_cast<std::streamsize>(cached.mips.size() * sizeof(TranscodedMipLevel)));
+    file.read(reinterpret_cast<char*>(cached.data.data()),
+              static_cast<std::streamsize>(cached.data.size()));
+    if (!file || file.peek() != std::char_traits<char>::eof()) {
+        spdlog::warn("Failed to read texture cache payload {}", cachePath.string());
+        return false;
+    }
+
+    if (!validateTranscodedTexture(cached)) {
+        spdlog::warn("Texture cache {} failed payload validation", cachePath.string());
+        return false;
+    }
+
+    out = std::move(cached);
+    return true;
+}
+
+bool saveTextureToCache(const std::filesystem::path& cachePath,
+                        uint64_t signature,
+                        const TranscodedTexture& texture) {
+    TextureCacheHeader header;
+    std::memcpy(header.magic, kTextureCacheMagic, sizeof(header.magic));
+    header.version = kTextureCacheVersion;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.width = texture.width;
+    header.height = texture.height;
+    header.mipCount = static_cast<uint32_t>(texture.mips.size());
+    header.pixelSignature = signature;
+    header.dataSize = texture.data.size();
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open texture cache file for write: {}", cachePath.string());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(texture.mips.data()),
+               static_cast<std::streamsize>(texture.mips.size() * sizeof(TranscodedMipLevel)));
+    file.write(reinterpret_cast<const char*>(texture.data.data()),
+               static_cast<std::streamsize>(texture.data.size()));
+    if (!file) {
+        spdlog::warn("Failed to write texture cache file {}", cachePath.string());
+        return false;
+    }
+    return true;
+}
+
+void initMipLayout(RhiFormat format, uint32_t width, uint32_t height, TranscodedTexture& texture) {
+    const bool blockCompressed = format == RhiFormat::BC7RGBAUnorm;
+    texture.format = format;
+    texture.width = width;
+    texture.height = height;
+    texture.mips.resize(mipLevelCount(width, height));
+
+    uint64_t totalSize = 0;
+    for (uint32_t level = 0; level < texture.mips.size(); ++level) {
+        TranscodedMipLevel& mip = texture.mips[level];
+        mip.width = std::max(width >> level, 1u);
+        mip.height = std::max(height >> level, 1u);
+        mip.offset = totalSize;
+        if (blockCompressed) {
+            mip.bytesPerRow = static_cast<uint64_t>((mip.width + 3u) / 4u) * kBC7BlockBytes;
+            mip.size = mip.bytesPerRow * ((mip.height + 3u) / 4u);
+        } else {
+            mip.bytesPerRow = static_cast<uint64_t>(mip.width) * 4u;
+            mip.size = mip.bytesPerRow * mip.height;
+        }
+        totalSize += mip.size;
+    }
+    texture.data.resize(totalSize);
+}
+
+} // namespace
+
+bool buildTextureMipChainRGBA8(const uint8_t* rgba,
+                               uint32_t width,
+                               uint32_t height,
+                               TranscodedTexture& out) {
+    if (!rgba || width == 0 || height == 0) {
+        return false;
+    }
+
+    TranscodedTexture texture;
+    initMipLayout(RhiFormat::RGBA8Unorm, width, height, texture);
+    std::memcpy(texture.data.data(), rgba, texture.mips[0].size);
+
+    std::vector<uint8_t> level(rgba, rgba + texture.mips[0].size);
+    std::vector<uint8_t> nextLevel;
+    for (uint32_t levelIndex = 1; levelIndex < texture.mips.size(); ++levelIndex) {
+        const TranscodedMipLevel& prev = texture.mips[levelIndex - 1];
+        const TranscodedMipLevel& mip = texture.mips[levelIndex];
+        downsampleRGBA8(level, prev.width, prev.height, mip.width, mip.height, nextLevel);
+        std::memcpy(texture.data.data() + mip.offset, nextLevel.data(), mip.size);
+        level.swap(nextLevel);
+    }
+
+    out = std::move(texture);
+    return true;
+}
+
+bool transcodeTextureBC7(const uint8_t* rgba,
+                         uint32_t width,
+                         uint32_t height,
+                         TranscodedTexture& out) {
+    if (!rgba || width == 0 || height == 0) {
+        return false;
+    }
+
+    TranscodedTexture texture;
+    initMipLayout(RhiFormat::BC7RGBAUnorm, width, height, texture);
+    const uint32_t levelCount = static_cast<uint32_t>(texture.mips.size());
+
+    std::vector<uint8_t> level(rgba, rgba + static_cast<size_t>(width) * height * 4u);
+    std::vector<uint8_t> nextLevel;
+    for (uint32_t levelIndex = 0; levelIndex < levelCount; ++levelIndex) {
+        const TranscodedMipLevel& mip = texture.mips[levelIndex];
+        encodeLevelBC7(level, mip.width, mip.height, texture.data.data() + mip.offset);
+        if (levelIndex + 1 < levelCount) {
+            const TranscodedMipLevel& next = texture.mips[levelIndex + 1];
+            downsampleRGBA8(level, mip.width, mip.height, next.width, next.height, nextLevel);
+            level.swap(nextLevel);
+        }
+    }
+
+    out = std::move(texture);
+    return true;
+}
+
+bool loadOrTranscodeTexture(const uint8_t* rgba,
+                            uint32_t width,
+                            uint32_t height,
+                            const std::string& cacheDirectory,
+                            TranscodedTexture& out) {
+    if (!rgba || width == 0 || height == 0) {
+        return false;
+    }
+
+    const uint64_t signature = computeTextureSignature(rgba, width, height);
+    const std::filesystem::path cachePath = makeTextureCachePath(cacheDirectory, signature);
+    const bool cached = loadTextureFromCache(cachePath, signature, width, height, out);
+    StartupProfile::recordCache("BC7 textures", cached);
+    if (cached) {
+        return true;
+    }
+
+    if (!transcodeTextureBC7(rgba, width, height, out)) {
+        return false;
+    }
+    saveTextureToCache(cachePath, signature, out);
+    return true;
+}
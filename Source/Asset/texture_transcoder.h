@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rhi_backend.h"
+
+struct TranscodedMipLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t offset = 0;        // byte offset into TranscodedTexture::data
+    uint64_t size = 0;
+    uint64_t bytesPerRow = 0;   // one row of 4x4 blocks for block formats
+};
+
+// Complete, GPU-ready mip chain for one material image.
+struct TranscodedTexture {
+    RhiFormat format = RhiFormat::Undefined;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<TranscodedMipLevel> mips;
+    std::vector<uint8_t> data;
+};
+
+// Box-filters a full mip chain from RGBA8 pixels and BC7-encodes every level.
+bool transcodeTextureBC7(const uint8_t* rgba,
+                         uint32_t width,
+                         uint32_t height,
+                         TranscodedTexture& out);
+
+// Box-filters a full RGBA8 mip chain for devices that cannot sample BC7.
+bool buildTextureMipChainRGBA8(const uint8_t* rgba,
+                               uint32_t width,
+                               uint32_t height,
+                               TranscodedTexture& out);
+
+// Loads the transcoded chain from cacheDirectory, keyed by a hash of the source
+// pixels, or transcodes and writes it on first use.
+bool loadOrTranscodeTexture(const uint8_t* rgba,
+                            uint32_t width,
+                            uint32_t height,
+                            const std::string& cacheDirectory,
+                            TranscodedTexture& out);
@@ -0,0 +1,79 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<bool> g_countingEnabled{false};
+std::atomic<uint64_t> g_allocationCount{0};
+std::atomic<uint64_t> g_allocationBytes{0};
+
+void* countedAllocate(std::size_t size) {
+    if (g_countingEnabled.load(std::memory_order_relaxed)) {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        g_allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return std::malloc(size != 0 ? size : 1);
+}
+
+} // namespace
+
+namespace AllocationCounter {
+
+void setEnabled(bool enabled) {
+    g_countingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+Counts current() {
+    return Counts{g_allocationCount.load(std::memory_order_relaxed),
+                  g_allocationBytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace AllocationCounter
+
+void* operator new(std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
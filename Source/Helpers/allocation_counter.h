@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Process-wide operator new counter (allocation_counter.cpp replaces the global
+// operator new/delete). Counting is off until a caller enables it, so the
+// replacement costs one relaxed load per allocation in normal runs. Aligned new
+// overloads are not replaced and go uncounted.
+namespace AllocationCounter {
+
+struct Counts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+void setEnabled(bool enabled);
+Counts current();
+
+// Counts the allocations made on any thread while it is alive.
+class Scope {
+public:
+    Scope() {
+        setEnabled(true);
+        m_start = current();
+    }
+    ~Scope() { setEnabled(false); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    Counts elapsed() const {
+        const Counts now = current();
+        return Counts{now.allocations - m_start.allocations, now.bytes - m_start.bytes};
+    }
+
+private:
+    Counts m_start;
+};
+
+} // namespace AllocationCounter
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Positional reads from one file, serviced in submission order by a background
+// thread. Each read returns a ticket; a ticket is complete once every read up to
+// and including it has landed in its destination. Failed reads zero-fill their
+// destination and bump failedReadCount().
+class AsyncFileReader {
+public:
+    AsyncFileReader() = default;
+    ~AsyncFileReader() { close(); }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    bool open(const std::filesystem::path& path) {
+        close();
+
+#ifdef _WIN32
+        m_file = CreateFileW(path.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+                             nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+#else
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) {
+            return false;
+        }
+#endif
+
+        m_path = path;
+        m_stopping = false;
+        m_worker = std::thread([this]() { workerLoop(); });
+        return true;
+    }
+
+    void close() {
+        if (m_worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            m_worker.join();
+        }
+
+#ifdef _WIN32
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+        m_fd = -1;
+#endif
+        m_path.clear();
+        m_requests.clear();
+        m_nextTicket = 0u;
+        m_completedTicket.store(0u, std::memory_order_relaxed);
+    }
+
+    bool isOpen() const { return m_worker.joinable(); }
+    const std::filesystem::path& path() const { return m_path; }
+    uint64_t failedReadCount() const { return m_failedReadCount.load(std::memory_order_relaxed); }
+
+    // Queues a read of sizeBytes at fileOffset into dst. dst must stay valid until
+    // the returned ticket completes. Returns 0 when the reader is closed. A read
+    // that continues the last queued one in both the file and memory extends it
+    // and returns its ticket.
+    uint64_t read(void* dst, uint64_t fileOffset, uint64_t sizeBytes) {
+        if (!isOpen() || !dst) {
+            return 0u;
+        }
+
+        uint64_t ticket = 0u;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_requests.empty()) {
+                Request& last = m_requests.back();
+                if (last.fileOffset + last.sizeBytes == fileOffset &&
+                    last.dst + last.sizeBytes == static_cast<uint8_t*>(dst)) {
+                    last.sizeBytes += sizeBytes;
+                    return last.ticket;
+                }
+            }
+            ticket = ++m_nextTicket;
+            m_requests.push_back({static_cast<uint8_t*>(dst), fileOffset, sizeBytes, ticket});
+        }
+        m_wake.notify_one();
+        return ticket;
+    }
+
+    bool isComplete(uint64_t ticket) const {
+        return m_completedTicket.load(std::memory_order_acquire) >= ticket;
+    }
+
+    void wait(uint64_t ticket) {
+        if (isComplete(ticket)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_completed.wait(lock, [&]() { return isComplete(ticket); });
+    }
+
+    void waitIdle() {
+        uint64_t lastTicket = 0u;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lastTicket = m_nextTicket;
+        }
+        wait(lastTicket);
+    }
+
+private:
+    struct Request {
+        uint8_t* dst = nullptr;
+        uint64_t fileOffset = 0u;
+        uint64_t sizeBytes = 0u;
+        uint64_t ticket = 0u;
+    };
+
+    bool readFully(uint8_t* dst, uint64_t fileOffset, uint64_t sizeBytes) const {
+        while (sizeBytes > 0u) {
+#ifdef _WIN32
+            const DWORD chunk = static_cast<DWORD>(std::min<uint64_t>(sizeBytes, 1ull << 30));
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(fileOffset & 0xffffffffull);
+            overlapped.OffsetHigh = static_cast<DWORD>(fileOffset >> 32);
+            DWORD bytesRead = 0;
+            if (!ReadFile(m_file, dst, chunk, &bytesRead, &overlapped) || bytesRead == 0) {
+                return false;
+            }
+#else
+            const size_t chunk = static_cast<size_t>(std::min<uint64_t>(sizeBytes, 1ull << 30));
+            const ssize_t bytesRead = ::pread(m_fd, dst, chunk, static_cast<off_t>(fileOffset));
+            if (bytesRead <= 0) {
+                return false;
+            }
+#endif
+            dst += bytesRead;
+            fileOffset += uint64_t(bytesRead);
+            sizeBytes -= uint64_t(bytesRead);
+        }
+        return true;
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Request request{};
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&]() { return m_stopping || !m_requests.empty(); });
+                if (m_requests.empty()) {
+                    return;
+                }
+                request = m_requests.front();
+                m_requests.pop_front();
+            }
+
+            if (!readFully(request.dst, request.fileOffset, request.sizeBytes)) {
+                std::memset(request.dst, 0, static_cast<size_t>(request.sizeBytes));
+                m_failedReadCount.fetch_add(1u, std::memory_order_relaxed);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_completedTicket.store(request.ticket, std::memory_order_release);
+            }
+            m_completed.notify_all();
+        }
+    }
+
+    std::filesystem::path m_path;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+#else
+    int m_fd = -1;
+#endif
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_completed;
+    std::deque<Request> m_requests;
+    uint64_t m_nextTicket = 0u;
+    std::atomic<uint64_t> m_completedTicket{0u};
+    std::atomic<uint64_t> m_failedReadCount{0u};
+    bool m_stopping = false;
+};
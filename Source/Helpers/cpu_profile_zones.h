@@ -0,0 +1,25 @@
+#pragma once
+
+#include <tracy/Tracy.hpp>
+#include <microprofile.h>
+
+// One zone in both Tracy and microprofile, so CPU captures from either tool
+// show the same frame phases. name must be a string literal.
+#define METALLIC_CPU_ZONE(group, name, color) \
+    ZoneScopedN(name);                        \
+    MICROPROFILE_SCOPEI(group, name, color)
+
+// Colors shared by the frame-phase zones.
+#define METALLIC_CPU_ZONE_STREAMING 0xff3399ff
+#define METALLIC_CPU_ZONE_SCENE 0xff33cc66
+#define METALLIC_CPU_ZONE_RECORDING 0xffcc66ff
+
+// Allocation tracking (METALLIC_TRACY_MEMORY=ON). Each pool shows up as a named
+// memory pool in Tracy's memory view; ptr only has to be unique within the pool.
+#if defined(TRACY_ENABLE) && defined(METALLIC_TRACY_MEMORY)
+#define METALLIC_TRACY_ALLOC(ptr, bytes, pool) TracyAllocN(ptr, bytes, pool)
+#define METALLIC_TRACY_FREE(ptr, pool) TracyFreeN(ptr, pool)
+#else
+#define METALLIC_TRACY_ALLOC(ptr, bytes, pool) ((void)(ptr), (void)(bytes))
+#define METALLIC_TRACY_FREE(ptr, pool) ((void)(ptr))
+#endif
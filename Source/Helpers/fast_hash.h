@@ -0,0 +1,160 @@
+#pragma once
+
+#include "parallel_for.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// XXH64-compatible hashing. The four independent accumulators of the stripe loop
+// keep the multiplier pipelines busy, so a pass runs close to memory bandwidth
+// instead of the one-multiply-per-byte rate of FNV.
+namespace FastHash {
+
+inline constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+inline constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+inline constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+inline constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+inline constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+// Inputs above this size are split into fixed chunks hashed on worker threads.
+// The chunk size is part of the digest definition, so results never depend on
+// the thread count.
+inline constexpr size_t kParallelChunkSize = size_t(4) << 20;
+
+inline uint64_t rotl(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint64_t read64(const uint8_t* bytes) {
+    uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const uint8_t* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+inline uint64_t xxh64(const void* data, size_t size, uint64_t seed = 0) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = bytes + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = round(v1, read64(bytes + 0));
+            v2 = round(v2, read64(bytes + 8));
+            v3 = round(v3, read64(bytes + 16));
+            v4 = round(v4, read64(bytes + 24));
+            bytes += 32;
+        } while (bytes <= limit);
+
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    } else {
+        hash = seed + kPrime5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    while (bytes + 8 <= end) {
+        hash ^= round(0, read64(bytes));
+        hash = rotl(hash, 27) * kPrime1 + kPrime4;
+        bytes += 8;
+    }
+    if (bytes + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(bytes)) * kPrime1;
+        hash = rotl(hash, 23) * kPrime2 + kPrime3;
+        bytes += 4;
+    }
+    while (bytes < end) {
+        hash ^= static_cast<uint64_t>(*bytes) * kPrime5;
+        hash = rotl(hash, 11) * kPrime1;
+        ++bytes;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Hashes large buffers as independent kParallelChunkSize chunks, then hashes the
+// chunk digests. Small buffers fall back to a single xxh64 pass.
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+    if (size <= kParallelChunkSize) {
+        return xxh64(data, size, seed);
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const size_t chunkCount = (size + kParallelChunkSize - 1) / kParallelChunkSize;
+    std::vector<uint64_t> chunkHashes(chunkCount);
+    Parallel::parallelFor(chunkCount, [&](size_t chunkIndex) {
+        const size_t offset = chunkIndex * kParallelChunkSize;
+        const size_t chunkSize = (size - offset < kParallelChunkSize) ? size - offset : kParallelChunkSize;
+        chunkHashes[chunkIndex] = xxh64(bytes + offset, chunkSize, seed);
+    });
+    return xxh64(chunkHashes.data(), chunkHashes.size() * sizeof(uint64_t), seed ^ static_cast<uint64_t>(size));
+}
+
+// Incremental combiner for mixing a handful of digests and small values.
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0) : m_state(seed + kPrime5) {}
+
+    void addDigest(uint64_t digest) {
+        m_state ^= round(0, digest);
+        m_state = rotl(m_state, 27) * kPrime1 + kPrime4;
+    }
+
+    template <typename T>
+    void addValue(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        addDigest(xxh64(&value, sizeof(T)));
+    }
+
+    void addBytes(const void* data, size_t size) {
+        addDigest(hashBytes(data, size));
+    }
+
+    uint64_t finish() const {
+        uint64_t hash = m_state;
+        hash ^= hash >> 33;
+        hash *= kPrime2;
+        hash ^= hash >> 29;
+        hash *= kPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+private:
+    uint64_t m_state;
+};
+
+} // namespace FastHash
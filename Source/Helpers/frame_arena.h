@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// Linear allocator for data that lives for one frame: per-frame lists, pass scratch
+// arrays, anything a std::pmr container can hold. Allocation is a bump of an atomic
+// offset, so passes recording in parallel share one arena; deallocate is a no-op and
+// reset() rewinds everything at once. When a frame overflows the block, reset() folds
+// the overflow into one bigger block, so a steady frame stops touching the heap.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t initialBytes = 256u * 1024u) { addBlock(initialBytes); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Only while nothing allocates from the arena or still uses its memory.
+    void reset() {
+        size_t usedBytes = 0;
+        for (const auto& block : m_blocks) {
+            usedBytes += std::min(block->used.load(std::memory_order_relaxed), block->capacity);
+        }
+        m_peakBytes = std::max(m_peakBytes, usedBytes);
+        if (m_blocks.size() > 1u) {
+            const size_t totalBytes = capacity();
+            m_blocks.clear();
+            addBlock(totalBytes);
+        }
+        m_blocks.back()->used.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const {
+        size_t totalBytes = 0;
+        for (const auto& block : m_blocks) {
+            totalBytes += block->capacity;
+        }
+        return totalBytes;
+    }
+    size_t peakBytes() const { return m_peakBytes; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t capacity = 0;
+        std::atomic<size_t> used{0};
+    };
+
+    void addBlock(size_t bytes) {
+        auto block = std::make_unique<Block>();
+        block->memory = std::make_unique<std::byte[]>(bytes);
+        block->capacity = bytes;
+        m_current.store(block.get(), std::memory_order_release);
+        m_blocks.push_back(std::move(block));
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        const size_t reserved = bytes + alignment - 1u;
+        for (;;) {
+            Block* block = m_current.load(std::memory_order_acquire);
+            const size_t offset = block->used.fetch_add(reserved, std::memory_order_relaxed);
+            if (offset + reserved <= block->capacity) {
+                const auto address = reinterpret_cast<uintptr_t>(block->memory.get()) + offset;
+                const uintptr_t aligned = (address + alignment - 1u) & ~uintptr_t(alignment - 1u);
+                return reinterpret_cast<void*>(aligned);
+            }
+            std::lock_guard<std::mutex> lock(m_growMutex);
+            if (m_current.load(std::memory_order_relaxed) == block) {
+                addBlock(std::max(block->capacity * 2u, reserved));
+            }
+        }
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    std::atomic<Block*> m_current{nullptr};
+    std::mutex m_growMutex;
+    size_t m_peakBytes = 0;
+};
+
+// One arena per frame in flight, so a frame's lists stay valid while the next one is
+// built. beginFrame() rewinds the arena the frame reuses.
+class FrameArenaRing {
+public:
+    explicit FrameArenaRing(uint32_t frameCount) {
+        for (uint32_t i = 0; i < std::max(frameCount, 1u); ++i) {
+            m_arenas.push_back(std::make_unique<FrameArena>());
+        }
+    }
+
+    FrameArena& beginFrame(uint64_t frameIndex) {
+        FrameArena& arena = *m_arenas[frameIndex % m_arenas.size()];
+        arena.reset();
+        return arena;
+    }
+
+private:
+    std::vector<std::unique_ptr<FrameArena>> m_arenas;
+};
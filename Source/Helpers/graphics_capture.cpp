@@ -0,0 +1,67 @@
+#include "graphics_capture.h"
+
+#if defined(_WIN32) && __has_include(<renderdoc_app.h>)
+#define METALLIC_ENABLE_RENDERDOC 1
+#else
+#define METALLIC_ENABLE_RENDERDOC 0
+#endif
+
+#if METALLIC_ENABLE_RENDERDOC
+#include <renderdoc_app.h>
+#include <spdlog/spdlog.h>
+#include <windows.h>
+#endif
+
+namespace GraphicsCapture {
+
+#if METALLIC_ENABLE_RENDERDOC
+
+namespace {
+
+// RenderDoc injects renderdoc.dll before the app starts; loading it ourselves
+// would not hook the already created device.
+RENDERDOC_API_1_1_2* renderDocApi() {
+    static RENDERDOC_API_1_1_2* api = []() -> RENDERDOC_API_1_1_2* {
+        HMODULE module = GetModuleHandleA("renderdoc.dll");
+        if (!module) {
+            return nullptr;
+        }
+        auto getApi = reinterpret_cast<pRENDERDOC_GetAPI>(GetProcAddress(module, "RENDERDOC_GetAPI"));
+        RENDERDOC_API_1_1_2* result = nullptr;
+        if (!getApi || getApi(eRENDERDOC_API_Version_1_1_2, reinterpret_cast<void**>(&result)) != 1) {
+            spdlog::warn("RenderDoc is attached but its in-app API is unavailable");
+            return nullptr;
+        }
+        return result;
+    }();
+    return api;
+}
+
+} // namespace
+
+bool available() {
+    return renderDocApi() != nullptr;
+}
+
+bool triggerNextFrame() {
+    RENDERDOC_API_1_1_2* api = renderDocApi();
+    if (!api) {
+        return false;
+    }
+    api->TriggerCapture();
+    return true;
+}
+
+#else
+
+bool available() {
+    return false;
+}
+
+bool triggerNextFrame() {
+    return false;
+}
+
+#endif
+
+} // namespace GraphicsCapture
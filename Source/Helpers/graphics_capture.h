@@ -0,0 +1,14 @@
+#pragma once
+
+// Programmatic frame captures through the RenderDoc in-app API. Only works when
+// the process was launched from (or injected by) RenderDoc and the build found
+// renderdoc_app.h (METALLIC_RENDERDOC_DIR); otherwise every call is a no-op.
+namespace GraphicsCapture {
+
+// Whether a capture tool is attached to this process.
+bool available();
+
+// Captures the next presented frame. Returns false when no tool is attached.
+bool triggerNextFrame();
+
+} // namespace GraphicsCapture
@@ -0,0 +1,342 @@
+#pragma once
+
+#include "cpu_profile_zones.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Engine-wide worker pool. One worker per core beyond the calling thread, started on
+// first use and kept for the life of the process, so per-frame parallel work does not
+// pay for thread creation.
+//
+// Every worker owns a deque: it pushes and pops its own jobs at the back, where the data
+// is still warm, and steals from the front of the other deques when it runs dry. Jobs
+// from threads outside the pool go to a queue per submitting thread, which workers
+// serve round-robin, so a loader thread's backlog cannot starve the render thread's
+// jobs. wait() runs queued jobs of the counter it waits on until that counter drains,
+// which lets jobs wait on nested work (parallelFor inside parallelFor) without fibers.
+// It never picks up another counter's jobs: a frame waiting on its own parallelFor
+// must not end up running a slice of a background scene build.
+namespace Jobs {
+
+inline uint32_t hardwareThreadCount() {
+    const uint32_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1u;
+}
+
+class JobCounter;
+
+// A queued job and the counter it counts toward.
+struct QueuedJob {
+    std::function<void()> run;
+    const JobCounter* counter = nullptr;
+    explicit operator bool() const { return static_cast<bool>(run); }
+};
+
+// Outstanding jobs of one group. Continuations queued with JobSystem::runAfter are
+// released when it reaches zero. Only destroy a counter after JobSystem::wait on it.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_pending{0};
+    std::mutex m_continuationMutex;
+    std::vector<QueuedJob> m_continuations;
+};
+
+class JobSystem {
+public:
+    static JobSystem& instance() {
+        static JobSystem system;
+        return system;
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    // Threads that run jobs, counting the thread that waits.
+    uint32_t threadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1u; }
+
+    // Index of the calling pool worker, or UINT32_MAX on any other thread.
+    static uint32_t currentWorker() { return tWorkerIndex; }
+
+    void run(JobCounter& counter, std::function<void()> job) {
+        counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+        push({[this, &counter, job = std::move(job)]() {
+                  job();
+                  finish(counter);
+              },
+              &counter});
+    }
+
+    // Queues job once every job of dependency has finished; counts toward counter.
+    void runAfter(JobCounter& dependency, JobCounter& counter, std::function<void()> job) {
+        counter.m_pending.fetch_add(1, std::memory_order_relaxed);
+        QueuedJob continuation{[this, &counter, job = std::move(job)]() {
+                                   job();
+                                   finish(counter);
+                               },
+                               &counter};
+        {
+            std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+            if (!dependency.done()) {
+                dependency.m_continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+        push(std::move(continuation));
+    }
+
+    // Runs counter's queued jobs on the calling thread until it drains. Jobs of other
+    // counters are left to the workers.
+    void wait(JobCounter& counter) {
+        uint32_t idleSpins = 0;
+        while (!counter.done()) {
+            if (QueuedJob job = take(&counter)) {
+                job.run();
+                idleSpins = 0;
+            } else if (++idleSpins < 64u) {
+                std::this_thread::yield();
+            } else {
+                // The remaining jobs are running elsewhere; back off instead of spinning.
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        // The last finish() drops the count while holding this lock; once we hold it,
+        // nothing touches the counter any more and the caller may destroy it.
+        std::lock_guard<std::mutex> lock(counter.m_continuationMutex);
+    }
+
+    // Work that has to happen on the main thread (window, ImGui, queue submission).
+    // Queued from any thread; runs at the next pumpMainThread().
+    void runOnMainThread(std::function<void()> job) {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_mainThreadJobs.push_back(std::move(job));
+    }
+
+    void pumpMainThread() {
+        std::vector<std::function<void()>> jobs;
+        {
+            std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+            jobs.swap(m_mainThreadJobs);
+        }
+        for (auto& job : jobs) {
+            job();
+        }
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    struct ExternalQueue {
+        std::thread::id thread;
+        std::deque<QueuedJob> jobs;
+    };
+
+    JobSystem() {
+        const uint32_t workerCount = hardwareThreadCount() - 1u;
+        m_workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+        m_threads.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            m_threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    void push(QueuedJob job) {
+        // Counted before it is visible, so the count never drops below the queued jobs
+        // and a sleeping worker cannot miss it (see workerLoop).
+        m_queuedJobs.fetch_add(1);
+        const uint32_t worker = tWorkerIndex;
+        if (worker != UINT32_MAX && worker < m_workers.size()) {
+            std::lock_guard<std::mutex> lock(m_workers[worker]->mutex);
+            m_workers[worker]->jobs.push_back(std::move(job));
+        } else {
+            std::lock_guard<std::mutex> lock(m_sharedMutex);
+            externalQueue(std::this_thread::get_id()).jobs.push_back(std::move(job));
+        }
+        if (m_sleepingWorkers.load() > 0) {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_wake.notify_one();
+        }
+    }
+
+    // Caller holds m_sharedMutex. Threads outside the pool are few and long-lived, so
+    // their queues are kept once created.
+    ExternalQueue& externalQueue(std::thread::id thread) {
+        for (ExternalQueue& queue : m_externalQueues) {
+            if (queue.thread == thread) {
+                return queue;
+            }
+        }
+        m_externalQueues.push_back({thread, {}});
+        return m_externalQueues.back();
+    }
+
+    // Removes and returns the first job of only (any job when only is null), searching
+    // from the back or the front.
+    static QueuedJob takeFrom(std::deque<QueuedJob>& jobs, const JobCounter* only, bool fromBack) {
+        if (jobs.empty()) {
+            return {};
+        }
+        if (!only) {
+            QueuedJob job = fromBack ? std::move(jobs.back()) : std::move(jobs.front());
+            fromBack ? jobs.pop_back() : jobs.pop_front();
+            return job;
+        }
+        const auto matches = [only](const QueuedJob& job) { return job.counter == only; };
+        if (fromBack) {
+            auto it = std::find_if(jobs.rbegin(), jobs.rend(), matches);
+            if (it == jobs.rend()) {
+                return {};
+            }
+            QueuedJob job = std::move(*it);
+            jobs.erase(std::next(it).base());
+            return job;
+        }
+        auto it = std::find_if(jobs.begin(), jobs.end(), matches);
+        if (it == jobs.end()) {
+            return {};
+        }
+        QueuedJob job = std::move(*it);
+        jobs.erase(it);
+        return job;
+    }
+
+    // Own deque from the back, then the external queues round-robin, then steal from the
+    // front of the other workers, starting next to the caller so thieves spread out.
+    // With only set, just that counter's jobs are candidates.
+    QueuedJob take(const JobCounter* only = nullptr) {
+        if (m_queuedJobs.load(std::memory_order_acquire) == 0) {
+            return {};
+        }
+        QueuedJob job;
+        const uint32_t self = tWorkerIndex;
+        const auto workerCount = static_cast<uint32_t>(m_workers.size());
+        if (self < workerCount) {
+            Worker& own = *m_workers[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            job = takeFrom(own.jobs, only, true);
+        }
+        if (!job) {
+            std::lock_guard<std::mutex> lock(m_sharedMutex);
+            const auto queueCount = static_cast<uint32_t>(m_externalQueues.size());
+            for (uint32_t offset = 0; !job && offset < queueCount; ++offset) {
+                const uint32_t queue = (m_nextExternalQueue + offset) % queueCount;
+                job = takeFrom(m_externalQueues[queue].jobs, only, false);
+                if (job) {
+                    m_nextExternalQueue = (queue + 1u) % queueCount;
+                }
+            }
+        }
+        for (uint32_t offset = 1; !job && offset <= workerCount; ++offset) {
+            const uint32_t victim = ((self < workerCount ? self : 0u) + offset) % workerCount;
+            if (victim == self) {
+                continue;
+            }
+            Worker& other = *m_workers[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            job = takeFrom(other.jobs, only, false);
+        }
+        if (job) {
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void finish(JobCounter& counter) {
+        std::vector<QueuedJob> released;
+        {
+            // Taken before the decrement so runAfter never parks a continuation on a
+            // counter that has already released its list.
+            std::lock_guard<std::mutex> lock(counter.m_continuationMutex);
+            if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                released.swap(counter.m_continuations);
+            }
+        }
+        for (auto& continuation : released) {
+            push(std::move(continuation));
+        }
+    }
+
+    void workerLoop(uint32_t index) {
+        tWorkerIndex = index;
+        const std::string threadName = "Job Worker " + std::to_string(index);
+#ifdef TRACY_ENABLE
+        tracy::SetThreadName(threadName.c_str());
+#endif
+        MICROPROFILE_ONTHREADCREATE(threadName.c_str());
+
+        for (;;) {
+            if (QueuedJob job = take()) {
+                METALLIC_CPU_ZONE("Jobs", "Job", 0xff808080);
+                job.run();
+                continue;
+            }
+            // Sequentially consistent with push(): either the pusher sees this worker
+            // asleep and notifies, or the predicate sees the new job.
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepingWorkers.fetch_add(1);
+            m_wake.wait(lock, [this]() { return m_stopping || m_queuedJobs.load() > 0; });
+            m_sleepingWorkers.fetch_sub(1);
+            if (m_stopping) {
+                break;
+            }
+        }
+        MICROPROFILE_ONTHREADEXIT();
+    }
+
+    inline static thread_local uint32_t tWorkerIndex = UINT32_MAX;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_sharedMutex;
+    std::vector<ExternalQueue> m_externalQueues;
+    uint32_t m_nextExternalQueue = 0;
+    std::atomic<uint32_t> m_queuedJobs{0};
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<uint32_t> m_sleepingWorkers{0};
+    bool m_stopping = false;
+
+    std::mutex m_mainThreadMutex;
+    std::vector<std::function<void()>> m_mainThreadJobs;
+};
+
+} // namespace Jobs
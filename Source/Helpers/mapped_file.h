@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only mapping of an entire file. Pages are faulted in on first access, so
+// callers can hand sub-ranges straight to upload paths without staging copies.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::filesystem::path& path) {
+        close();
+
+#ifdef _WIN32
+        m_file = CreateFileW(path.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                             nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart <= 0) {
+            close();
+            return false;
+        }
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) {
+            close();
+            return false;
+        }
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        const size_t size = static_cast<size_t>(fileStat.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+
+        madvise(mapped, size, MADV_WILLNEED);
+        m_data = static_cast<const uint8_t*>(mapped);
+        m_size = size;
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
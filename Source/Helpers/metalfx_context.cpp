@@ -0,0 +1,213 @@
+#ifdef __APPLE__
+
+#include "metalfx_context.h"
+
+#include <Metal/Metal.hpp>
+#include <MetalFX/MetalFX.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "metal_frame_graph.h"
+
+static float presetOutputScale(MetalFXPreset preset) {
+    switch (preset) {
+    case MetalFXPreset::Quality:     return 1.5f;
+    case MetalFXPreset::Balanced:    return 1.7f;
+    case MetalFXPreset::Performance: return 2.0f;
+    default:                         return 1.0f;
+    }
+}
+
+static MTL::Texture* mutableMetalTexture(const RhiTexture* texture) {
+    return texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr;
+}
+
+const char* metalFXPresetName(MetalFXPreset preset) {
+    switch (preset) {
+    case MetalFXPreset::Off:         return "Off";
+    case MetalFXPreset::Native:      return "Native (AA only)";
+    case MetalFXPreset::Quality:     return "Quality";
+    case MetalFXPreset::Balanced:    return "Balanced";
+    case MetalFXPreset::Performance: return "Performance";
+    default:                         return "Unknown";
+    }
+}
+
+MetalFXContext::~MetalFXContext() {
+    shutdown();
+}
+
+bool MetalFXContext::init(void* deviceHandle) {
+    shutdown();
+
+    m_device = static_cast<MTL::Device*>(deviceHandle);
+    auto* processInfo = NS::ProcessInfo::processInfo();
+    if (!m_device || !processInfo->isOperatingSystemAtLeastVersion({13, 0, 0}) ||
+        !MTLFX::TemporalScalerDescriptor::supportsDevice(m_device)) {
+        spdlog::info("MetalFX temporal upscaling is NOT available");
+        m_device = nullptr;
+        return false;
+    }
+
+    // The supported scale range query arrived a release after the scaler itself.
+    m_minScale = 1.0f;
+    m_maxScale = 2.0f;
+    if (processInfo->isOperatingSystemAtLeastVersion({14, 0, 0})) {
+        m_minScale = MTLFX::TemporalScalerDescriptor::supportedInputContentMinScale(m_device);
+        m_maxScale = MTLFX::TemporalScalerDescriptor::supportedInputContentMaxScale(m_device);
+    }
+
+    m_available = true;
+    m_needsReset = true;
+    spdlog::info("MetalFX temporal upscaling is available (scale {:.2f}x - {:.2f}x)",
+                 m_minScale, m_maxScale);
+    return true;
+}
+
+void MetalFXContext::shutdown() {
+    releaseScaler();
+    m_device = nullptr;
+    m_available = false;
+}
+
+void MetalFXContext::setPreset(MetalFXPreset preset) {
+    if (preset == m_preset) {
+        return;
+    }
+    m_preset = preset;
+    m_needsReset = true;
+}
+
+std::string MetalFXContext::statusString() const {
+    if (!m_available) {
+        return "MetalFX: Unavailable";
+    }
+    std::string status = "MetalFX: ";
+    status += metalFXPresetName(m_preset);
+    if (m_scaler) {
+        status += " (" + std::to_string(m_inputWidth) + "x" + std::to_string(m_inputHeight) +
+                  " -> " + std::to_string(m_outputWidth) + "x" + std::to_string(m_outputHeight) + ")";
+    }
+    return status;
+}
+
+bool MetalFXContext::getOptimalRenderSize(uint32_t displayWidth,
+                                          uint32_t displayHeight,
+                                          uint32_t& outRenderWidth,
+                                          uint32_t& outRenderHeight) const {
+    if (!m_available || !isEnabled() || displayWidth == 0 || displayHeight == 0) {
+        return false;
+    }
+
+    const float scale = std::clamp(presetOutputScale(m_preset), m_minScale, m_maxScale);
+    outRenderWidth = std::max(1u, static_cast<uint32_t>(std::lround(displayWidth / scale)));
+    outRenderHeight = std::max(1u, static_cast<uint32_t>(std::lround(displayHeight / scale)));
+    return true;
+}
+
+bool MetalFXContext::evaluate(const UpscalerEvaluateInputs& inputs,
+                              RhiComputeCommandEncoder& encoder) {
+    if (!m_available || !isEnabled()) {
+        return false;
+    }
+
+    MTL::Texture* color = mutableMetalTexture(inputs.colorInput);
+    MTL::Texture* depth = mutableMetalTexture(inputs.depth);
+    MTL::Texture* motion = mutableMetalTexture(inputs.motionVectors);
+    MTL::Texture* output = mutableMetalTexture(inputs.colorOutput);
+    if (!color || !depth || !motion || !output || !ensureScaler(inputs)) {
+        return false;
+    }
+
+    const MTL::TextureUsage requiredOutputUsage = m_scaler->outputTextureUsage();
+    if ((output->usage() & requiredOutputUsage) != requiredOutputUsage) {
+        spdlog::warn("MetalFX: output texture is missing required usage flags");
+        return false;
+    }
+
+    MTL::CommandBuffer* commandBuffer = metalEndEncodingForCommandBuffer(encoder);
+    if (!commandBuffer) {
+        return false;
+    }
+
+    m_scaler->setColorTexture(color);
+    m_scaler->setDepthTexture(depth);
+    m_scaler->setMotionTexture(motion);
+    m_scaler->setOutputTexture(output);
+    m_scaler->setJitterOffsetX(inputs.jitterOffsetX);
+    m_scaler->setJitterOffsetY(inputs.jitterOffsetY);
+    m_scaler->setMotionVectorScaleX(inputs.mvecScaleX);
+    m_scaler->setMotionVectorScaleY(inputs.mvecScaleY);
+    m_scaler->setDepthReversed(inputs.depthInverted);
+    m_scaler->setReset(inputs.reset || m_needsReset);
+    m_scaler->encodeToCommandBuffer(commandBuffer);
+    m_needsReset = false;
+    return true;
+}
+
+bool MetalFXContext::ensureScaler(const UpscalerEvaluateInputs& inputs) {
+    const MTL::Texture* color = metalTexture(inputs.colorInput);
+    const MTL::Texture* depth = metalTexture(inputs.depth);
+    const MTL::Texture* motion = metalTexture(inputs.motionVectors);
+    const MTL::Texture* output = metalTexture(static_cast<const RhiTexture*>(inputs.colorOutput));
+
+    const uint32_t inputWidth = static_cast<uint32_t>(color->width());
+    const uint32_t inputHeight = static_cast<uint32_t>(color->height());
+    const uint32_t outputWidth = static_cast<uint32_t>(output->width());
+    const uint32_t outputHeight = static_cast<uint32_t>(output->height());
+    if (m_scaler &&
+        m_inputWidth == inputWidth && m_inputHeight == inputHeight &&
+        m_outputWidth == outputWidth && m_outputHeight == outputHeight &&
+        m_colorFormat == color->pixelFormat() && m_depthFormat == depth->pixelFormat() &&
+        m_motionFormat == motion->pixelFormat() && m_outputFormat == output->pixelFormat()) {
+        return true;
+    }
+
+    releaseScaler();
+
+    auto* desc = MTLFX::TemporalScalerDescriptor::alloc()->init();
+    desc->setColorTextureFormat(color->pixelFormat());
+    desc->setDepthTextureFormat(depth->pixelFormat());
+    desc->setMotionTextureFormat(motion->pixelFormat());
+    desc->setOutputTextureFormat(output->pixelFormat());
+    desc->setInputWidth(inputWidth);
+    desc->setInputHeight(inputHeight);
+    desc->setOutputWidth(outputWidth);
+    desc->setOutputHeight(outputHeight);
+    // The source is scene-referred HDR ahead of tonemapping.
+    desc->setAutoExposureEnabled(true);
+    m_scaler = desc->newTemporalScaler(m_device);
+    desc->release();
+
+    if (!m_scaler) {
+        spdlog::error("MetalFX: failed to create temporal scaler {}x{} -> {}x{}",
+                      inputWidth, inputHeight, outputWidth, outputHeight);
+        return false;
+    }
+
+    m_inputWidth = inputWidth;
+    m_inputHeight = inputHeight;
+    m_outputWidth = outputWidth;
+    m_outputHeight = outputHeight;
+    m_colorFormat = color->pixelFormat();
+    m_depthFormat = depth->pixelFormat();
+    m_motionFormat = motion->pixelFormat();
+    m_outputFormat = output->pixelFormat();
+    m_needsReset = true;
+    spdlog::info("MetalFX: temporal scaler {}x{} -> {}x{}",
+                 inputWidth, inputHeight, outputWidth, outputHeight);
+    return true;
+}
+
+void MetalFXContext::releaseScaler() {
+    if (m_scaler) {
+        m_scaler->release();
+        m_scaler = nullptr;
+    }
+    m_inputWidth = m_inputHeight = 0;
+    m_outputWidth = m_outputHeight = 0;
+}
+
+#endif // __APPLE__
@@ -0,0 +1,84 @@
+#pragma once
+
+// MetalFX temporal upscaling integration for the Metal backend.
+// This is the macOS counterpart of StreamlineContext: it drives the authored
+// MetalFXUpscalePass through IUpscalerIntegration.
+
+#ifdef __APPLE__
+
+#include <cstdint>
+#include <string>
+
+#include "rhi_interop.h"
+
+namespace MTL {
+class Device;
+}
+namespace MTLFX {
+class TemporalScaler;
+}
+
+// Output-to-input scale presets. Native keeps the render resolution and uses
+// MetalFX purely as temporal anti-aliasing.
+enum class MetalFXPreset : uint32_t {
+    Off = 0,
+    Native,
+    Quality,      // 1.5x  (67% render resolution)
+    Balanced,     // 1.7x  (59% render resolution)
+    Performance,  // 2.0x  (50% render resolution)
+    Count
+};
+
+const char* metalFXPresetName(MetalFXPreset preset);
+
+class MetalFXContext : public IUpscalerIntegration {
+public:
+    MetalFXContext() = default;
+    ~MetalFXContext() override;
+
+    MetalFXContext(const MetalFXContext&) = delete;
+    MetalFXContext& operator=(const MetalFXContext&) = delete;
+
+    // Returns false when the device has no MetalFX temporal scaler support.
+    bool init(void* deviceHandle);
+    void shutdown();
+
+    MetalFXPreset preset() const { return m_preset; }
+    void setPreset(MetalFXPreset preset);
+
+    bool isAvailable() const override { return m_available; }
+    bool isEnabled() const override { return m_preset != MetalFXPreset::Off; }
+    std::string statusString() const override;
+    bool getOptimalRenderSize(uint32_t displayWidth,
+                              uint32_t displayHeight,
+                              uint32_t& outRenderWidth,
+                              uint32_t& outRenderHeight) const override;
+    // Ends the pass's compute encoder and records the scaler into its command buffer.
+    bool evaluate(const UpscalerEvaluateInputs& inputs,
+                  RhiComputeCommandEncoder& encoder) override;
+    void resetHistory() override { m_needsReset = true; }
+
+private:
+    bool ensureScaler(const UpscalerEvaluateInputs& inputs);
+    void releaseScaler();
+
+    MTL::Device* m_device = nullptr;
+    MTLFX::TemporalScaler* m_scaler = nullptr;
+    bool m_available = false;
+    bool m_needsReset = true;
+    MetalFXPreset m_preset = MetalFXPreset::Off;
+    float m_minScale = 1.0f;
+    float m_maxScale = 1.0f;
+
+    // Scaler creation parameters; a mismatch recreates the scaler.
+    uint32_t m_inputWidth = 0;
+    uint32_t m_inputHeight = 0;
+    uint32_t m_outputWidth = 0;
+    uint32_t m_outputHeight = 0;
+    uint64_t m_colorFormat = 0;
+    uint64_t m_depthFormat = 0;
+    uint64_t m_motionFormat = 0;
+    uint64_t m_outputFormat = 0;
+};
+
+#endif // __APPLE__
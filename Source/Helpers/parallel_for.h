@@ -0,0 +1,54 @@
+#pragma once
+
+#include "job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Parallel {
+
+inline uint32_t hardwareWorkerCount() {
+    return Jobs::hardwareThreadCount();
+}
+
+// Runs fn(index) for every index in [0, count) on the shared job system. Indices are
+// claimed from a shared counter, so callers that write into per-index output slots stay
+// deterministic regardless of scheduling. The caller claims indices too and then helps
+// run this loop's queued jobs until it is done, so nested calls from inside a job spread
+// across idle workers instead of running inline, and the caller never picks up
+// unrelated work queued by other threads.
+template <typename Fn>
+void parallelFor(size_t count, Fn&& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    Jobs::JobSystem& jobs = Jobs::JobSystem::instance();
+    const size_t threadCount = std::min<size_t>(count, jobs.threadCount());
+    if (threadCount <= 1) {
+        for (size_t index = 0; index < count; ++index) {
+            fn(index);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex{0};
+    auto claimLoop = [&]() {
+        for (size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+             index < count;
+             index = nextIndex.fetch_add(1, std::memory_order_relaxed)) {
+            fn(index);
+        }
+    };
+
+    Jobs::JobCounter counter;
+    for (size_t i = 1; i < threadCount; ++i) {
+        jobs.run(counter, claimLoop);
+    }
+    claimLoop();
+    jobs.wait(counter);
+}
+
+} // namespace Parallel
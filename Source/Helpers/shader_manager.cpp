@@ -4,9 +4,17 @@
 #include "rhi_resource_utils.h"
 #include "rhi_shader_utils.h"
 #include "slang_compiler.h"
+#include "startup_profile.h"
 
+#include "parallel_for.h"
+
+#include <json.hpp>
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 
 namespace {
 
@@ -88,38 +96,128 @@ ShaderManager::ShaderManager(RhiDeviceHandle device,
 {}
 
 ShaderManager::~ShaderManager() {
+    if (m_backgroundThread.joinable()) {
+        m_backgroundThread.join();
+    }
+    for (PipelineJob& job : m_backgroundJobs) {
+        releaseOwnedHandle(job.graphicsResult);
+        releaseOwnedHandle(job.computeResult);
+    }
+    for (auto& [key, permutation] : m_permutations) {
+        releaseOwnedHandle(permutation.pipeline);
+    }
     releaseOwnedHandle(m_vertexPipeline);
     releaseOwnedHandle(m_meshPipeline);
+    releaseOwnedHandle(m_forwardIndirectPipeline);
     releaseOwnedHandle(m_visPipeline);
     releaseOwnedHandle(m_visIndirectPipeline);
+    releaseOwnedHandle(m_visIndirectAlphaMaskedPipeline);
+    releaseOwnedHandle(m_visSoftwareResolvePipeline);
+    releaseOwnedHandle(m_transparencyAccumulatePipeline);
+    releaseOwnedHandle(m_transparencyRevealagePipeline);
     releaseOwnedHandle(m_computePipeline);
+    releaseOwnedHandle(m_lightingClassifyPipeline);
+    releaseOwnedHandle(m_lightingSkyTilesPipeline);
+    releaseOwnedHandle(m_lightingUntexturedTilesPipeline);
+    releaseOwnedHandle(m_lightingTexturedTilesPipeline);
+    releaseOwnedHandle(m_viewportPickPipeline);
+    releaseOwnedHandle(m_lightingCoarseTilesPipeline);
+    releaseOwnedHandle(m_lightingShadingRatePipeline);
+    releaseOwnedHandle(m_lightCullPipeline);
+    releaseOwnedHandle(m_shadowCascadeResolvePipeline);
+    releaseOwnedHandle(m_shadowDenoisePipeline);
+    releaseOwnedHandle(m_ambientOcclusionPipeline);
+    releaseOwnedHandle(m_oitCompositePipeline);
     releaseOwnedHandle(m_clusterStreamingUpdatePipeline);
     releaseOwnedHandle(m_instanceClassifyPipeline);
+    releaseOwnedHandle(m_indexedDrawBuildPipeline);
+    releaseOwnedHandle(m_transformHierarchyPipeline);
+    releaseOwnedHandle(m_skinningPipeline);
+    releaseOwnedHandle(m_skinningRefitPipeline);
+    releaseOwnedHandle(m_instanceBvhCullPipeline);
     releaseOwnedHandle(m_cullPipeline);
+    releaseOwnedHandle(m_cullContinuationPipeline);
+    releaseOwnedHandle(m_cullContinuationPublishPipeline);
+    releaseOwnedHandle(m_cullVisibleHistoryReplayPipeline);
+    releaseOwnedHandle(m_cullVisibleHistoryClearPipeline);
+    releaseOwnedHandle(m_cullVisibleHistoryPublishPipeline);
     releaseOwnedHandle(m_clusterStreamingAgeFilterPipeline);
+    releaseOwnedHandle(m_clusterStreamingRequestCompactPipeline);
     releaseOwnedHandle(m_hzbBuildPipeline);
+    releaseOwnedHandle(m_hzbDownsamplePipeline);
+    releaseOwnedHandle(m_softwareRasterClearPipeline);
+    releaseOwnedHandle(m_softwareRasterPipeline);
     releaseOwnedHandle(m_buildIndirectPipeline);
+    releaseOwnedHandle(m_worklistResetPipeline);
     releaseOwnedHandle(m_meshletVisPipeline);
     releaseOwnedHandle(m_skyPipeline);
+    releaseOwnedHandle(m_atmosphereTransmittancePipeline);
+    releaseOwnedHandle(m_atmosphereDirectIrradiancePipeline);
+    releaseOwnedHandle(m_atmosphereSingleScatteringPipeline);
+    releaseOwnedHandle(m_atmosphereScatteringDensityPipeline);
+    releaseOwnedHandle(m_atmosphereIndirectIrradiancePipeline);
+    releaseOwnedHandle(m_atmosphereMultipleScatteringPipeline);
+    releaseOwnedHandle(m_atmosphereSkyViewPipeline);
+    releaseOwnedHandle(m_atmosphereSkyIrradiancePipeline);
     releaseOwnedHandle(m_tonemapPipeline);
     releaseOwnedHandle(m_outputPipeline);
-    releaseOwnedHandle(m_histogramPipeline);
     releaseOwnedHandle(m_autoExposurePipeline);
     releaseOwnedHandle(m_taaPipeline);
+    releaseOwnedHandle(m_taaTiledPipeline);
+    releaseOwnedHandle(m_temporalUpscalePipeline);
+    releaseOwnedHandle(m_fusedPostPipeline);
+    releaseOwnedHandle(m_postPyramidPipeline);
     releaseOwnedHandle(m_clusterRenderPipeline);
     releaseOwnedHandle(m_tonemapSampler);
+    releaseOwnedHandle(m_postPyramidSampler);
     releaseOwnedHandle(m_vertexDesc);
     delete m_rtCtx;
 }
 
 PipelineRuntimeContext& ShaderManager::runtimeContext() { return *m_rtCtx; }
+
+RhiSamplerHandle ShaderManager::createPostPyramidSampler() const {
+    RhiSamplerDesc samplerDesc;
+    samplerDesc.minFilter = RhiSamplerFilterMode::Linear;
+    samplerDesc.magFilter = RhiSamplerFilterMode::Linear;
+    samplerDesc.mipFilter = RhiSamplerMipFilterMode::Linear;
+    samplerDesc.addressModeS = RhiSamplerAddressMode::ClampToEdge;
+    samplerDesc.addressModeT = RhiSamplerAddressMode::ClampToEdge;
+    return rhiCreateSampler(m_device, samplerDesc);
+}
+
+template <typename Handle>
+void ShaderManager::retireOwnedHandle(Handle& handle) {
+    void* nativeHandle = handle.nativeHandle();
+    handle.setNativeHandle(nullptr);
+    if (!nativeHandle) {
+        return;
+    }
+    if (m_rtCtx && m_rtCtx->rhi) {
+        m_rtCtx->rhi->deferRelease([nativeHandle]() { rhiReleaseNativeHandle(nativeHandle); });
+    } else {
+        rhiReleaseNativeHandle(nativeHandle);
+    }
+}
 bool ShaderManager::hasSkyPipeline() const { return m_skyPipeline.nativeHandle() != nullptr; }
 
 void ShaderManager::setGlobalDefines(const std::vector<std::pair<std::string, std::string>>& defines) {
+    waitForBackgroundPipelines();
     m_globalDefines = defines;
 }
 
+bool ShaderManager::hasGlobalDefine(const char* name) const {
+    return std::any_of(m_globalDefines.begin(), m_globalDefines.end(), [name](const auto& define) {
+        return define.first == name;
+    });
+}
+
+RhiFormat ShaderManager::visibilityFormat() const {
+    return hasGlobalDefine("METALLIC_VISIBILITY_64") ? RhiFormat::RG32Uint : RhiFormat::R32Uint;
+}
+
 void ShaderManager::setCompileMode(ShaderCompileMode mode) {
+    waitForBackgroundPipelines();
     m_compileMode = mode;
 }
 
@@ -149,15 +247,29 @@ void ShaderManager::createVertexDescriptor() {
 }
 
 void ShaderManager::syncRuntimeContext() {
+    m_rtCtx->visibility64 = visibilityFormat() == RhiFormat::RG32Uint;
+    m_rtCtx->inlineRayQuery = hasGlobalDefine("METALLIC_INLINE_RAY_QUERY");
+    m_rtCtx->hzb16 = hasGlobalDefine("METALLIC_HZB_16");
+    m_rtCtx->gpuDebugMessages = hasGlobalDefine("METALLIC_GPU_DEBUG_MESSAGES");
     m_rtCtx->renderPipelinesRhi.clear();
     if (m_vertexPipeline.nativeHandle())
         m_rtCtx->renderPipelinesRhi["ForwardPass"] = m_vertexPipeline;
     if (m_meshPipeline.nativeHandle())
         m_rtCtx->renderPipelinesRhi["ForwardMeshPass"] = m_meshPipeline;
+    if (m_forwardIndirectPipeline.nativeHandle())
+        m_rtCtx->renderPipelinesRhi["ForwardIndirectPass"] = m_forwardIndirectPipeline;
     if (m_visPipeline.nativeHandle())
         m_rtCtx->renderPipelinesRhi["VisibilityPass"] = m_visPipeline;
     if (m_visIndirectPipeline.nativeHandle())
         m_rtCtx->renderPipelinesRhi["VisibilityIndirectPass"] = m_visIndirectPipeline;
+    if (m_visIndirectAlphaMaskedPipeline.nativeHandle())
+        m_rtCtx->renderPipelinesRhi["VisibilityIndirectAlphaMaskedPass"] = m_visIndirectAlphaMaskedPipeline;
+    if (m_visSoftwareResolvePipeline.nativeHandle())
+        m_rtCtx->renderPipelinesRhi["VisibilitySoftwareResolvePass"] = m_visSoftwareResolvePipeline;
+    if (m_transparencyAccumulatePipeline.nativeHandle())
+        m_rtCtx->renderPipelinesRhi["TransparencyAccumulatePass"] = m_transparencyAccumulatePipeline;
+    if (m_transparencyRevealagePipeline.nativeHandle())
+        m_rtCtx->renderPipelinesRhi["TransparencyRevealagePass"] = m_transparencyRevealagePipeline;
     if (m_clusterRenderPipeline.nativeHandle())
         m_rtCtx->renderPipelinesRhi["ClusterRenderPass"] = m_clusterRenderPipeline;
     if (m_skyPipeline.nativeHandle())
@@ -170,273 +282,833 @@ void ShaderManager::syncRuntimeContext() {
     m_rtCtx->computePipelinesRhi.clear();
     if (m_computePipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["DeferredLightingPass"] = m_computePipeline;
+    if (m_lightingClassifyPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingClassifyPass"] = m_lightingClassifyPipeline;
+    if (m_lightingSkyTilesPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingSkyTilesPass"] = m_lightingSkyTilesPipeline;
+    if (m_lightingUntexturedTilesPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingUntexturedTilesPass"] =
+            m_lightingUntexturedTilesPipeline;
+    if (m_lightingTexturedTilesPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingTexturedTilesPass"] = m_lightingTexturedTilesPipeline;
+    if (m_viewportPickPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["ViewportPickPass"] = m_viewportPickPipeline;
+    if (m_lightingCoarseTilesPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingCoarseTilesPass"] = m_lightingCoarseTilesPipeline;
+    if (m_lightingShadingRatePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["DeferredLightingShadingRatePass"] = m_lightingShadingRatePipeline;
+    if (m_lightCullPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["LightCullPass"] = m_lightCullPipeline;
+    if (m_shadowCascadeResolvePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["ShadowCascadeResolvePass"] = m_shadowCascadeResolvePipeline;
+    if (m_shadowDenoisePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["ShadowDenoisePass"] = m_shadowDenoisePipeline;
+    if (m_ambientOcclusionPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AmbientOcclusionPass"] = m_ambientOcclusionPipeline;
+    if (m_oitCompositePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["OitCompositePass"] = m_oitCompositePipeline;
     if (m_clusterStreamingUpdatePipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["ClusterStreamingUpdatePass"] =
             m_clusterStreamingUpdatePipeline;
     if (m_instanceClassifyPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["InstanceClassifyPass"] = m_instanceClassifyPipeline;
+    if (m_indexedDrawBuildPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["IndexedDrawBuildPass"] = m_indexedDrawBuildPipeline;
+    if (m_transformHierarchyPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["TransformHierarchyPass"] = m_transformHierarchyPipeline;
+    if (m_skinningPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["SkinningPass"] = m_skinningPipeline;
+    if (m_skinningRefitPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["SkinningRefitPass"] = m_skinningRefitPipeline;
+    if (m_instanceBvhCullPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["InstanceBvhCullPass"] = m_instanceBvhCullPipeline;
     if (m_cullPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["MeshletCullPass"] = m_cullPipeline;
+    if (m_cullContinuationPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["MeshletCullContinuationPass"] = m_cullContinuationPipeline;
+    if (m_cullContinuationPublishPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["MeshletCullContinuationPublishPass"] =
+            m_cullContinuationPublishPipeline;
+    if (m_cullVisibleHistoryReplayPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["MeshletCullVisibleHistoryReplayPass"] =
+            m_cullVisibleHistoryReplayPipeline;
+    if (m_cullVisibleHistoryClearPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["MeshletCullVisibleHistoryClearPass"] =
+            m_cullVisibleHistoryClearPipeline;
+    if (m_cullVisibleHistoryPublishPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["MeshletCullVisibleHistoryPublishPass"] =
+            m_cullVisibleHistoryPublishPipeline;
     if (m_clusterStreamingAgeFilterPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["ClusterStreamingAgeFilterPass"] =
             m_clusterStreamingAgeFilterPipeline;
+    if (m_clusterStreamingRequestCompactPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["ClusterStreamingRequestCompactPass"] =
+            m_clusterStreamingRequestCompactPipeline;
     if (m_hzbBuildPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["HZBBuildPass"] = m_hzbBuildPipeline;
+    if (m_hzbDownsamplePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["HZBDownsamplePass"] = m_hzbDownsamplePipeline;
+    if (m_softwareRasterClearPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["SoftwareRasterClearPass"] = m_softwareRasterClearPipeline;
+    if (m_softwareRasterPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["SoftwareRasterPass"] = m_softwareRasterPipeline;
     if (m_buildIndirectPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["BuildIndirectPass"] = m_buildIndirectPipeline;
+    if (m_worklistResetPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["WorklistResetPass"] = m_worklistResetPipeline;
     if (m_meshletVisPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["MeshletVisualizePass"] = m_meshletVisPipeline;
-    if (m_histogramPipeline.nativeHandle())
-        m_rtCtx->computePipelinesRhi["HistogramPass"] = m_histogramPipeline;
+    if (m_atmosphereTransmittancePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereTransmittancePass"] = m_atmosphereTransmittancePipeline;
+    if (m_atmosphereDirectIrradiancePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereDirectIrradiancePass"] = m_atmosphereDirectIrradiancePipeline;
+    if (m_atmosphereSingleScatteringPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereSingleScatteringPass"] = m_atmosphereSingleScatteringPipeline;
+    if (m_atmosphereScatteringDensityPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereScatteringDensityPass"] = m_atmosphereScatteringDensityPipeline;
+    if (m_atmosphereIndirectIrradiancePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereIndirectIrradiancePass"] = m_atmosphereIndirectIrradiancePipeline;
+    if (m_atmosphereMultipleScatteringPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereMultipleScatteringPass"] = m_atmosphereMultipleScatteringPipeline;
+    if (m_atmosphereSkyViewPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereSkyViewPass"] = m_atmosphereSkyViewPipeline;
+    if (m_atmosphereSkyIrradiancePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["AtmosphereSkyIrradiancePass"] = m_atmosphereSkyIrradiancePipeline;
     if (m_autoExposurePipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["AutoExposurePass"] = m_autoExposurePipeline;
     if (m_taaPipeline.nativeHandle())
         m_rtCtx->computePipelinesRhi["TAAPass"] = m_taaPipeline;
+    if (m_taaTiledPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["TAATiledPass"] = m_taaTiledPipeline;
+    if (m_temporalUpscalePipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["TemporalUpscalePass"] = m_temporalUpscalePipeline;
+    if (m_fusedPostPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["FusedPostPass"] = m_fusedPostPipeline;
+    if (m_postPyramidPipeline.nativeHandle())
+        m_rtCtx->computePipelinesRhi["PostPyramidPass"] = m_postPyramidPipeline;
+    for (const auto& [key, permutation] : m_permutations) {
+        if (permutation.pipeline.nativeHandle())
+            m_rtCtx->computePipelinesRhi[key] = permutation.pipeline;
+    }
 
     if (m_tonemapSampler.nativeHandle())
         m_rtCtx->samplersRhi["tonemap"] = m_tonemapSampler;
     else
         m_rtCtx->samplersRhi.erase("tonemap");
+    if (m_postPyramidSampler.nativeHandle())
+        m_rtCtx->samplersRhi["postPyramid"] = m_postPyramidSampler;
+    else
+        m_rtCtx->samplersRhi.erase("postPyramid");
 }
 
-bool ShaderManager::buildAll() {
-    createVertexDescriptor();
-
-    std::string errorMessage;
-
-    if (m_profile.forwardVertex) {
-        m_vertexPipeline = reloadVertexShader("Shaders/Vertex/bunny", &errorMessage);
-        if (!m_vertexPipeline.nativeHandle()) {
-            spdlog::error("Failed to create vertex pipeline: {}",
-                          formatError(&errorMessage, "Slang vertex shader compilation failed"));
-            return false;
+std::vector<ShaderManager::PipelineJob> ShaderManager::collectPipelineJobs() {
+    std::vector<PipelineJob> jobs;
+    auto add = [&](bool enabled, PipelineJob job) {
+        if (!enabled) {
+            if (job.graphicsTarget) {
+                retireOwnedHandle(*job.graphicsTarget);
+            }
+            if (job.computeTarget) {
+                retireOwnedHandle(*job.computeTarget);
+            }
+            return;
         }
-    } else {
-        releaseOwnedHandle(m_vertexPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.forwardMesh && m_supportsMeshShaders) {
-        m_meshPipeline = reloadMeshShader("Shaders/Mesh/meshlet",
-                                          patchMeshShaderSource,
-                                          RhiFormat::RGBA16Float,
-                                          RhiFormat::D32Float,
-                                          &errorMessage);
-        if (!m_meshPipeline.nativeHandle()) {
-            spdlog::error("Failed to create mesh pipeline: {}",
-                          formatError(&errorMessage, "Slang mesh shader compilation failed"));
+        if (!job.consumer) {
+            job.consumer = job.key;
+        }
+        jobs.push_back(std::move(job));
+    };
+    // Mesh-shader pipelines are skipped (and logged) when the device cannot run them.
+    auto meshEnabled = [&](bool profileEnabled, const char* label, bool needsVisibilityValidation) {
+        if (!profileEnabled) {
             return false;
         }
-    } else if (m_profile.forwardMesh) {
-        spdlog::info("Skipping mesh pipeline validation because mesh shaders are not supported");
-        releaseOwnedHandle(m_meshPipeline);
-    } else {
-        releaseOwnedHandle(m_meshPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.visibility && m_supportsMeshShaders && m_validateVisibilityPipelines) {
-        m_visPipeline = reloadMeshShader("Shaders/Visibility/visibility",
-                                         patchVisibilityShaderSource,
-                                         RhiFormat::R32Uint,
-                                         RhiFormat::D32Float,
-                                         &errorMessage);
-        if (!m_visPipeline.nativeHandle()) {
-            spdlog::error("Failed to create visibility pipeline: {}",
-                          formatError(&errorMessage, "Slang visibility shader compilation failed"));
+        if (!m_supportsMeshShaders) {
+            spdlog::info("Skipping {} pipeline because mesh shaders are not supported", label);
             return false;
         }
-    } else if (m_profile.visibility && !m_supportsMeshShaders) {
-        spdlog::info("Skipping visibility pipeline validation because mesh shaders are not supported");
-        releaseOwnedHandle(m_visPipeline);
-    } else if (m_profile.visibility) {
-        spdlog::info("Skipping visibility pipeline validation on Vulkan due to Slang PerPrimitiveEXT blocker: {}",
-                     kSlangVisibilityPerPrimitiveIssueUrl);
-        releaseOwnedHandle(m_visPipeline);
-    } else {
-        releaseOwnedHandle(m_visPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.visibilityIndirect && m_supportsMeshShaders && m_validateVisibilityPipelines) {
-        m_visIndirectPipeline = reloadMeshShader("Shaders/Visibility/visibility_indirect",
-                                                 patchVisibilityShaderSource,
-                                                 RhiFormat::R32Uint,
-                                                 RhiFormat::D32Float,
-                                                 &errorMessage);
-        if (!m_visIndirectPipeline.nativeHandle()) {
-            spdlog::error("Failed to create visibility indirect pipeline: {}",
-                          formatError(&errorMessage, "Slang visibility indirect shader compilation failed"));
+        if (needsVisibilityValidation && !m_validateVisibilityPipelines) {
+            spdlog::info("Skipping {} pipeline on Vulkan due to Slang PerPrimitiveEXT blocker: {}",
+                         label,
+                         kSlangVisibilityPerPrimitiveIssueUrl);
             return false;
         }
-    } else if (m_profile.visibilityIndirect && !m_supportsMeshShaders) {
-        spdlog::info("Skipping visibility indirect pipeline validation because mesh shaders are not supported");
-        releaseOwnedHandle(m_visIndirectPipeline);
-    } else if (m_profile.visibilityIndirect) {
-        spdlog::info("Skipping visibility indirect pipeline validation on Vulkan due to Slang PerPrimitiveEXT blocker: {}",
-                     kSlangVisibilityPerPrimitiveIssueUrl);
-        releaseOwnedHandle(m_visIndirectPipeline);
-    } else {
-        releaseOwnedHandle(m_visIndirectPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.clusterRender && m_supportsMeshShaders) {
-        m_clusterRenderPipeline = reloadMeshShader("Shaders/Mesh/cluster_render",
-                                                    nullptr,
-                                                    RhiFormat::RGBA8Unorm,
-                                                    RhiFormat::D32Float,
-                                                    &errorMessage);
-        if (!m_clusterRenderPipeline.nativeHandle()) {
-            spdlog::warn("Failed to create cluster render pipeline: {}",
-                         formatError(&errorMessage, "Slang cluster render shader compilation failed"));
+        return true;
+    };
+    auto graphics = [](const char* key, const char* label, PipelineKind kind, const char* shaderPath,
+                       RhiFormat colorFormat, RhiFormat depthFormat, bool required,
+                       RhiGraphicsPipelineHandle& target) {
+        PipelineJob job;
+        job.key = key;
+        job.label = label;
+        job.kind = kind;
+        job.shaderPath = shaderPath;
+        job.colorFormat = colorFormat;
+        job.depthFormat = depthFormat;
+        job.required = required;
+        job.graphicsTarget = &target;
+        return job;
+    };
+    auto compute = [](const char* key, const char* label, const char* shaderPath, const char* entryPoint,
+                      bool required, RhiComputePipelineHandle& target) {
+        PipelineJob job;
+        job.key = key;
+        job.label = label;
+        job.kind = PipelineKind::Compute;
+        job.shaderPath = shaderPath;
+        job.entryPoint = entryPoint;
+        job.required = required;
+        job.computeTarget = &target;
+        return job;
+    };
+
+    add(m_profile.forwardVertex,
+        graphics("ForwardPass", "vertex", PipelineKind::Vertex, "Shaders/Vertex/bunny",
+                 RhiFormat::RGBA16Float, RhiFormat::D32Float, true, m_vertexPipeline));
+    // GPU-driven forward draws pull their vertices, so they need no vertex descriptor
+    // and build like a fullscreen pipeline.
+    PipelineJob forwardIndirectJob =
+        graphics("ForwardIndirectPass", "forward indirect", PipelineKind::Fullscreen, "Shaders/Vertex/forward_indirect",
+                 RhiFormat::RGBA16Float, RhiFormat::D32Float, false, m_forwardIndirectPipeline);
+    forwardIndirectJob.consumer = "ForwardPass";
+    add(m_profile.forwardVertex && m_profile.meshletCull, std::move(forwardIndirectJob));
+    PipelineJob indexedDrawBuildJob = compute("IndexedDrawBuildPass", "indexed draw build",
+                                              "Shaders/Vertex/indexed_draw_build", "computeMain", false,
+                                              m_indexedDrawBuildPipeline);
+    indexedDrawBuildJob.consumer = "IndexedDrawCullPass";
+    add(m_profile.forwardVertex && m_profile.meshletCull, std::move(indexedDrawBuildJob));
+
+    PipelineJob meshJob = graphics("ForwardMeshPass", "mesh", PipelineKind::Mesh, "Shaders/Mesh/meshlet",
+                                   RhiFormat::RGBA16Float, RhiFormat::D32Float, true, m_meshPipeline);
+    add(meshEnabled(m_profile.forwardMesh, "mesh", false), std::move(meshJob));
+
+    PipelineJob visJob = graphics("VisibilityPass", "visibility", PipelineKind::Mesh,
+                                  "Shaders/Visibility/visibility",
+                                  visibilityFormat(), RhiFormat::D32Float, true, m_visPipeline);
+    add(meshEnabled(m_profile.visibility, "visibility", true), std::move(visJob));
+
+    PipelineJob visIndirectJob = graphics("VisibilityIndirectPass", "visibility indirect", PipelineKind::Mesh,
+                                          "Shaders/Visibility/visibility_indirect",
+                                          visibilityFormat(), RhiFormat::D32Float, true, m_visIndirectPipeline);
+    visIndirectJob.consumer = "VisibilityPass";
+    add(meshEnabled(m_profile.visibilityIndirect, "visibility indirect", true), std::move(visIndirectJob));
+    // Alpha-tested clusters get their own pipeline so only it carries the discard.
+    PipelineJob visIndirectMaskedJob =
+        graphics("VisibilityIndirectAlphaMaskedPass", "visibility indirect alpha masked", PipelineKind::Mesh,
+                 "Shaders/Visibility/visibility_indirect",
+                 visibilityFormat(), RhiFormat::D32Float, true, m_visIndirectAlphaMaskedPipeline);
+    visIndirectMaskedJob.entryPoint = "fragmentAlphaMaskedMain";
+    visIndirectMaskedJob.consumer = "VisibilityPass";
+    add(meshEnabled(m_profile.visibilityIndirect, "visibility indirect alpha masked", true),
+        std::move(visIndirectMaskedJob));
+    // Weighted-blended OIT over the kMeshletDrawTransparentBit clusters: one pipeline
+    // per target, since render pipelines here have a single color attachment.
+    const auto transparencyJob = [&](const char* key, const char* label, const char* fragmentEntry,
+                                     RhiFormat colorFormat, RhiBlendMode blendMode,
+                                     RhiGraphicsPipelineHandle& target) {
+        PipelineJob job = graphics(key, label, PipelineKind::Mesh, "Shaders/Visibility/transparency",
+                                   colorFormat, RhiFormat::D32Float, false, target);
+        job.entryPoint = fragmentEntry;
+        job.blendMode = blendMode;
+        job.depthWrite = false;
+        job.consumer = "TransparencyPass";
+        add(meshEnabled(m_profile.visibilityIndirect, label, true), std::move(job));
+    };
+    transparencyJob("TransparencyAccumulatePass", "transparency accumulate", "accumulateMain",
+                    RhiFormat::RGBA16Float, RhiBlendMode::Additive, m_transparencyAccumulatePipeline);
+    transparencyJob("TransparencyRevealagePass", "transparency revealage", "revealageMain",
+                    RhiFormat::R16Float, RhiBlendMode::InverseModulate, m_transparencyRevealagePipeline);
+
+    // The compute rasterizer needs 64-bit buffer atomics, which only the Vulkan
+    // capability defines report; without it every cluster stays on the mesh shader.
+    const bool softwareRasterEnabled =
+        m_profile.visibilityIndirect && kShaderBackend == RhiBackendType::Vulkan &&
+        hasGlobalDefine("METALLIC_INT64_ATOMICS");
+    PipelineJob softwareResolveJob =
+        graphics("VisibilitySoftwareResolvePass", "visibility software resolve", PipelineKind::Fullscreen,
+                 "Shaders/Visibility/visibility_swraster_resolve",
+                 visibilityFormat(), RhiFormat::D32Float, false, m_visSoftwareResolvePipeline);
+    softwareResolveJob.consumer = "VisibilityPass";
+    add(softwareRasterEnabled, std::move(softwareResolveJob));
+    PipelineJob softwareRasterClearJob =
+        compute("SoftwareRasterClearPass", "software raster clear", "Shaders/Visibility/visibility_swraster",
+                "clearMain", false, m_softwareRasterClearPipeline);
+    softwareRasterClearJob.consumer = "SoftwareRasterPass";
+    add(softwareRasterEnabled, std::move(softwareRasterClearJob));
+    add(softwareRasterEnabled,
+        compute("SoftwareRasterPass", "software raster", "Shaders/Visibility/visibility_swraster",
+                "rasterMain", false, m_softwareRasterPipeline));
+
+    add(meshEnabled(m_profile.clusterRender, "cluster render", false),
+        graphics("ClusterRenderPass", "cluster render", PipelineKind::Mesh, "Shaders/Mesh/cluster_render",
+                 RhiFormat::RGBA8Unorm, RhiFormat::D32Float, false, m_clusterRenderPipeline));
+
+    add(m_profile.meshletCull,
+        compute("ClusterStreamingUpdatePass", "cluster streaming update",
+                "Shaders/Streaming/stream_update_scene", "computeMain", true,
+                m_clusterStreamingUpdatePipeline));
+    add(m_profile.meshletCull,
+        compute("InstanceClassifyPass", "instance classify",
+                "Shaders/Visibility/instance_classify", "computeMain", true, m_instanceClassifyPipeline));
+    add(m_profile.meshletCull,
+        compute("TransformHierarchyPass", "transform hierarchy",
+                "Shaders/Visibility/transform_hierarchy", "computeMain", false,
+                m_transformHierarchyPipeline));
+    add(m_profile.meshletCull,
+        compute("SkinningPass", "skinning",
+                "Shaders/Visibility/skinning", "skinMain", false, m_skinningPipeline));
+    PipelineJob skinningRefitJob = compute("SkinningRefitPass", "skinning meshlet refit",
+                                           "Shaders/Visibility/skinning", "refitMain", false,
+                                           m_skinningRefitPipeline);
+    skinningRefitJob.consumer = "SkinningPass";
+    add(m_profile.meshletCull, std::move(skinningRefitJob));
+    PipelineJob instanceBvhCullJob = compute("InstanceBvhCullPass", "instance BVH cull",
+                                             "Shaders/Visibility/instance_classify", "bvhCullMain", false,
+                                             m_instanceBvhCullPipeline);
+    instanceBvhCullJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(instanceBvhCullJob));
+    add(m_profile.meshletCull,
+        compute("MeshletCullPass", "meshlet cull",
+                "Shaders/Visibility/meshlet_cull", "computeMain", true, m_cullPipeline));
+    PipelineJob cullContinuationJob = compute("MeshletCullContinuationPass", "meshlet cull continuation",
+                                              "Shaders/Visibility/meshlet_cull", "continuationMain", false,
+                                              m_cullContinuationPipeline);
+    cullContinuationJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(cullContinuationJob));
+    PipelineJob cullContinuationPublishJob =
+        compute("MeshletCullContinuationPublishPass", "meshlet cull continuation publish",
+                "Shaders/Visibility/meshlet_cull", "continuationPublishMain", false,
+                m_cullContinuationPublishPipeline);
+    cullContinuationPublishJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(cullContinuationPublishJob));
+    PipelineJob cullVisibleHistoryReplayJob =
+        compute("MeshletCullVisibleHistoryReplayPass", "meshlet cull visible history replay",
+                "Shaders/Visibility/meshlet_cull", "visibleHistoryReplayMain", false,
+                m_cullVisibleHistoryReplayPipeline);
+    cullVisibleHistoryReplayJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(cullVisibleHistoryReplayJob));
+    PipelineJob cullVisibleHistoryClearJob =
+        compute("MeshletCullVisibleHistoryClearPass", "meshlet cull visible history clear",
+                "Shaders/Visibility/meshlet_cull", "visibleHistoryClearMain", false,
+                m_cullVisibleHistoryClearPipeline);
+    cullVisibleHistoryClearJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(cullVisibleHistoryClearJob));
+    PipelineJob cullVisibleHistoryPublishJob =
+        compute("MeshletCullVisibleHistoryPublishPass", "meshlet cull visible history publish",
+                "Shaders/Visibility/meshlet_cull", "visibleHistoryPublishMain", false,
+                m_cullVisibleHistoryPublishPipeline);
+    cullVisibleHistoryPublishJob.consumer = "MeshletCullPass";
+    add(m_profile.meshletCull, std::move(cullVisibleHistoryPublishJob));
+    add(m_profile.meshletCull,
+        compute("ClusterStreamingAgeFilterPass", "cluster streaming age filter",
+                "Shaders/Streaming/stream_agefilter_groups", "computeMain", true,
+                m_clusterStreamingAgeFilterPipeline));
+    add(m_profile.meshletCull,
+        compute("ClusterStreamingRequestCompactPass", "cluster streaming request compact",
+                "Shaders/Streaming/stream_compact_requests", "computeMain", true,
+                m_clusterStreamingRequestCompactPipeline));
+    add(m_profile.hzbBuild,
+        compute("HZBBuildPass", "HZB build", "Shaders/Visibility/hzb_build", "computeMain", true,
+                m_hzbBuildPipeline));
+    // The single-dispatch build reads other threadgroups' mip writes, which needs
+    // device-coherent storage images; Metal keeps the per-mip dispatches.
+    PipelineJob hzbDownsampleJob =
+        compute("HZBDownsamplePass", "HZB single-pass downsample", "Shaders/Visibility/hzb_downsample",
+                "computeMain", false, m_hzbDownsamplePipeline);
+    hzbDownsampleJob.consumer = "HZBBuildPass";
+    add(m_profile.hzbBuild && kShaderBackend == RhiBackendType::Vulkan, std::move(hzbDownsampleJob));
+    add(m_profile.buildIndirect,
+        compute("BuildIndirectPass", "build indirect", "Shaders/Visibility/build_indirect", "computeMain", true,
+                m_buildIndirectPipeline));
+    PipelineJob worklistResetJob = compute("WorklistResetPass", "worklist reset",
+                                           "Shaders/Visibility/build_indirect", "resetMain", false,
+                                           m_worklistResetPipeline);
+    worklistResetJob.consumer = "MeshletCullPass";
+    add(m_profile.buildIndirect, std::move(worklistResetJob));
+
+    PipelineJob lightingJob = compute("DeferredLightingPass", "deferred lighting",
+                                      "Shaders/Visibility/deferred_lighting", "computeMain", true,
+                                      m_computePipeline);
+    add(m_profile.deferredLighting, std::move(lightingJob));
+    // Tile-classified lighting: optional, the pass falls back to computeMain without it.
+    const auto lightingTileJob = [&](const char* key, const char* label, const char* entryPoint,
+                                     RhiComputePipelineHandle& target) {
+        PipelineJob job = compute(key, label, "Shaders/Visibility/deferred_lighting", entryPoint, false, target);
+        job.consumer = "DeferredLightingPass";
+        add(m_profile.deferredLighting, std::move(job));
+    };
+    lightingTileJob("DeferredLightingClassifyPass", "deferred lighting classify", "classifyTilesMain",
+                    m_lightingClassifyPipeline);
+    lightingTileJob("DeferredLightingSkyTilesPass", "deferred lighting sky tiles", "shadeSkyTilesMain",
+                    m_lightingSkyTilesPipeline);
+    lightingTileJob("DeferredLightingUntexturedTilesPass", "deferred lighting untextured tiles",
+                    "shadeUntexturedTilesMain", m_lightingUntexturedTilesPipeline);
+    lightingTileJob("DeferredLightingTexturedTilesPass", "deferred lighting textured tiles",
+                    "shadeTexturedTilesMain", m_lightingTexturedTilesPipeline);
+    lightingTileJob("DeferredLightingCoarseTilesPass", "deferred lighting coarse tiles",
+                    "shadeCoarseTilesMain", m_lightingCoarseTilesPipeline);
+    lightingTileJob("DeferredLightingShadingRatePass", "deferred lighting shading rate",
+                    "buildShadingRateMain", m_lightingShadingRatePipeline);
+    // Editor click-to-select; ViewportPickPass records nothing without it.
+    add(m_profile.deferredLighting,
+        compute("ViewportPickPass", "viewport pick",
+                "Shaders/Visibility/viewport_pick", "computeMain", false, m_viewportPickPipeline));
+    // Point and spot lights are skipped without it.
+    PipelineJob lightCullJob = compute("LightCullPass", "light cull", "Shaders/Visibility/light_cull",
+                                       "cullMain", false, m_lightCullPipeline);
+    lightCullJob.consumer = "DeferredLightingPass";
+    add(m_profile.deferredLighting, std::move(lightCullJob));
+    add(m_profile.deferredLighting,
+        compute("ShadowCascadeResolvePass", "shadow cascade resolve",
+                "Shaders/Visibility/shadow_cascade_resolve", "computeMain", false,
+                m_shadowCascadeResolvePipeline));
+    // ShadowRayPass traces one ray per pixel without it.
+    add(m_profile.deferredLighting,
+        compute("ShadowDenoisePass", "shadow denoise", "Shaders/Raytracing/shadow_denoise", "denoiseMain",
+                false, m_shadowDenoisePipeline));
+    // AmbientOcclusionPass records nothing without it or without inline ray queries.
+    add(m_profile.deferredLighting,
+        compute("AmbientOcclusionPass", "ambient occlusion", "Shaders/Raytracing/ambient_occlusion",
+                "computeMain", false, m_ambientOcclusionPipeline));
+    // Resolves TransparencyPass's accumulation over the lit image.
+    add(m_profile.deferredLighting,
+        compute("OitCompositePass", "OIT composite", "Shaders/Visibility/oit_composite", "computeMain",
+                false, m_oitCompositePipeline));
+
+    add(m_profile.meshletVisualize,
+        compute("MeshletVisualizePass", "meshlet visualize",
+                "Shaders/Visibility/meshlet_visualize", "computeMain", false, m_meshletVisPipeline));
+    add(m_profile.sky,
+        graphics("SkyPass", "sky", PipelineKind::Fullscreen, "Shaders/Atmosphere/sky",
+                 RhiFormat::RGBA16Float, RhiFormat::Undefined, false, m_skyPipeline));
+    // AtmospherePass builds SkyPass's tables and sky-view LUT with these.
+    const auto atmosphereJob = [&](const char* key, const char* label, const char* entryPoint,
+                                   RhiComputePipelineHandle& target) {
+        PipelineJob job = compute(key, label, "Shaders/Atmosphere/atmosphere_precompute", entryPoint, false, target);
+        job.consumer = "AtmospherePass";
+        add(m_profile.sky, std::move(job));
+    };
+    atmosphereJob("AtmosphereTransmittancePass", "atmosphere transmittance", "transmittanceMain",
+                  m_atmosphereTransmittancePipeline);
+    atmosphereJob("AtmosphereDirectIrradiancePass", "atmosphere direct irradiance", "directIrradianceMain",
+                  m_atmosphereDirectIrradiancePipeline);
+    atmosphereJob("AtmosphereSingleScatteringPass", "atmosphere single scattering", "singleScatteringMain",
+                  m_atmosphereSingleScatteringPipeline);
+    atmosphereJob("AtmosphereScatteringDensityPass", "atmosphere scattering density", "scatteringDensityMain",
+                  m_atmosphereScatteringDensityPipeline);
+    atmosphereJob("AtmosphereIndirectIrradiancePass", "atmosphere indirect irradiance", "indirectIrradianceMain",
+                  m_atmosphereIndirectIrradiancePipeline);
+    atmosphereJob("AtmosphereMultipleScatteringPass", "atmosphere multiple scattering", "multipleScatteringMain",
+                  m_atmosphereMultipleScatteringPipeline);
+    atmosphereJob("AtmosphereSkyViewPass", "atmosphere sky view", "skyViewMain",
+                  m_atmosphereSkyViewPipeline);
+    atmosphereJob("AtmosphereSkyIrradiancePass", "atmosphere sky irradiance", "skyIrradianceMain",
+                  m_atmosphereSkyIrradiancePipeline);
+    add(m_profile.tonemap,
+        graphics("TonemapPass", "tonemap", PipelineKind::Fullscreen, "Shaders/Post/tonemap",
+                 RhiFormat::RGBA8Srgb, RhiFormat::Undefined, true, m_tonemapPipeline));
+    add(m_profile.output,
+        graphics("OutputPass", "output passthrough", PipelineKind::Fullscreen, "Shaders/Post/passthrough",
+                 RhiFormat::BGRA8Unorm, RhiFormat::Undefined, true, m_outputPipeline));
+
+    add(m_profile.autoExposure,
+        compute("AutoExposurePass", "auto-exposure", "Shaders/Post/auto_exposure", "autoExposureMain", false,
+                m_autoExposurePipeline));
+    add(m_profile.taa,
+        compute("TAAPass", "TAA", "Shaders/Post/taa", "taaMain", false, m_taaPipeline));
+    // Groupshared neighborhood variant; TAAPass falls back to taaMain without it.
+    PipelineJob taaTiledJob = compute("TAATiledPass", "TAA tiled", "Shaders/Post/taa", "taaTiledMain", false,
+                                      m_taaTiledPipeline);
+    taaTiledJob.consumer = "TAAPass";
+    add(m_profile.taa, std::move(taaTiledJob));
+    // Display-resolution resolve that stands in for TAA when the render scale drops.
+    add(m_profile.taa,
+        compute("TemporalUpscalePass", "temporal upscale", "Shaders/Post/temporal_upscale",
+                "temporalUpscaleMain", false, m_temporalUpscalePipeline));
+    // TAA, exposure and tonemap in one dispatch for pipelines that use FusedPostPass.
+    add(m_profile.taa && m_profile.tonemap,
+        compute("FusedPostPass", "fused post", "Shaders/Post/fused_post", "fusedPostMain", false,
+                m_fusedPostPipeline));
+    // Bloom / depth-of-field pyramid; TonemapPass and FusedPostPass combine it.
+    add(m_profile.tonemap,
+        compute("PostPyramidPass", "post pyramid", "Shaders/Post/post_pyramid", "postPyramidMain", false,
+                m_postPyramidPipeline));
+
+    // Permutations rebuild with their base pipeline's shader and entry point, and go
+    // away with it.
+    const size_t baseJobCount = jobs.size();
+    for (auto& [key, permutation] : m_permutations) {
+        auto base = std::find_if(jobs.begin(), jobs.begin() + static_cast<std::ptrdiff_t>(baseJobCount),
+                                 [&](const PipelineJob& job) {
+                                     return job.kind == PipelineKind::Compute && permutation.baseKey == job.key;
+                                 });
+        if (base == jobs.begin() + static_cast<std::ptrdiff_t>(baseJobCount)) {
+            retireOwnedHandle(permutation.pipeline);
+            continue;
         }
+        PipelineJob job = *base;
+        job.key = key.c_str();
+        job.required = false;
+        job.defines = permutation.defines;
+        job.computeTarget = &permutation.pipeline;
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+void ShaderManager::compilePipelineJob(PipelineJob& job) {
+    switch (job.kind) {
+        case PipelineKind::Vertex:
+            job.graphicsResult = reloadVertexShader(job.shaderPath, &job.error);
+            break;
+        case PipelineKind::Fullscreen:
+            job.graphicsResult = reloadFullscreenShader(job.shaderPath, job.colorFormat, job.depthFormat,
+                                                        &job.error);
+            break;
+        case PipelineKind::Mesh:
+            job.graphicsResult = reloadMeshShader(job.shaderPath, job.colorFormat, job.depthFormat, &job.error,
+                                                  job.entryPoint ? job.entryPoint : "fragmentMain",
+                                                  job.blendMode, job.depthWrite);
+            break;
+        case PipelineKind::Compute:
+            job.computeResult = reloadComputeShader(job.shaderPath, job.entryPoint, &job.error,
+                                                    &job.defines);
+            break;
+    }
+}
+
+// Slang sessions and PSO creation are independent per pipeline, so every job compiles on
+// its own worker; results land in the job and are applied on the calling thread.
+void ShaderManager::compilePipelineJobs(std::vector<PipelineJob>& jobs) {
+    const auto start = std::chrono::steady_clock::now();
+    // Every worker leases its own Slang session; results land in their job's slot and
+    // diagnostics are published in job order, so the outcome is the same as a serial build.
+    std::vector<std::vector<SlangDiagnosticRecord>> diagnostics(jobs.size());
+    Parallel::parallelFor(jobs.size(), [&](size_t index) {
+        SlangDiagnosticCapture capture;
+        compilePipelineJob(jobs[index]);
+        diagnostics[index] = capture.take();
+    });
+    for (std::vector<SlangDiagnosticRecord>& records : diagnostics) {
+        publishSlangDiagnostics(std::move(records));
+    }
+    if (!jobs.empty()) {
+        spdlog::info("Compiled {} pipelines in {:.1f} ms on {} workers",
+                     jobs.size(),
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+                     std::min<size_t>(jobs.size(), Parallel::hardwareWorkerCount()));
+    }
+}
+
+bool ShaderManager::pipelineJobSucceeded(const PipelineJob& job) {
+    return job.graphicsTarget ? job.graphicsResult.nativeHandle() != nullptr
+                              : job.computeResult.nativeHandle() != nullptr;
+}
+
+void ShaderManager::applyPipelineJob(PipelineJob& job) {
+    if (job.graphicsTarget) {
+        retireOwnedHandle(*job.graphicsTarget);
+        *job.graphicsTarget = job.graphicsResult;
+        job.graphicsResult = {};
     } else {
-        releaseOwnedHandle(m_clusterRenderPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.meshletCull) {
-        m_clusterStreamingUpdatePipeline =
-            reloadComputeShader("Shaders/Streaming/stream_update_scene",
-                                "computeMain",
-                                nullptr,
-                                &errorMessage);
-        if (!m_clusterStreamingUpdatePipeline.nativeHandle()) {
-            spdlog::error("Failed to create cluster streaming update pipeline: {}",
-                          formatError(&errorMessage,
-                                      "Slang cluster streaming update shader compilation failed"));
-            return false;
+        retireOwnedHandle(*job.computeTarget);
+        *job.computeTarget = job.computeResult;
+        job.computeResult = {};
+    }
+}
+
+void ShaderManager::waitForBackgroundPipelines() {
+    if (m_backgroundThread.joinable()) {
+        m_backgroundThread.join();
+    }
+    pollBackgroundPipelines();
+}
+
+bool ShaderManager::pollBackgroundPipelines() {
+    if (!m_backgroundThread.joinable() || !m_backgroundDone.load(std::memory_order_acquire)) {
+        return false;
+    }
+    m_backgroundThread.join();
+
+    uint32_t published = 0;
+    for (PipelineJob& job : m_backgroundJobs) {
+        if (pipelineJobSucceeded(job)) {
+            applyPipelineJob(job);
+            ++published;
+        } else if (!job.defines.empty()) {
+            spdlog::warn("Failed to create {} permutation {}; using the generic pipeline: {}",
+                         job.label,
+                         job.key,
+                         formatError(&job.error, "Slang shader compilation failed"));
+        } else if (m_backgroundIsReload) {
+            spdlog::error("Hot-reload {} PSO: {}; keeping previous pipeline",
+                          job.label,
+                          formatError(&job.error, "Unknown failure"));
+        } else {
+            spdlog::warn("Failed to create {} pipeline; pass disabled: {}",
+                         job.label,
+                         formatError(&job.error, "Slang shader compilation failed"));
         }
-    } else {
-        releaseOwnedHandle(m_clusterStreamingUpdatePipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.meshletCull) {
-        m_instanceClassifyPipeline = reloadComputeShader("Shaders/Visibility/instance_classify",
-                                                         "computeMain",
-                                                         nullptr,
-                                                         &errorMessage);
-        if (!m_instanceClassifyPipeline.nativeHandle()) {
-            spdlog::error("Failed to create instance classify pipeline: {}",
-                          formatError(&errorMessage, "Slang instance classify shader compilation failed"));
-            return false;
+    }
+    m_backgroundJobs.clear();
+    syncRuntimeContext();
+    spdlog::info("Published {} background-compiled pipelines", published);
+    return published > 0;
+}
+
+void ShaderManager::startBackgroundPipelines(bool isReload) {
+    m_backgroundIsReload = isReload;
+    m_backgroundDone.store(false, std::memory_order_relaxed);
+    m_backgroundThread = std::thread([this]() {
+        compilePipelineJobs(m_backgroundJobs);
+        m_backgroundDone.store(true, std::memory_order_release);
+    });
+}
+
+void ShaderManager::watchPipelineShaders(const PipelineJob& job) {
+    std::vector<std::string>& files = m_pipelineShaderFiles[job.key];
+    for (const std::string& path : files) {
+        auto it = m_watchedShaderFiles.find(path);
+        if (it != m_watchedShaderFiles.end()) {
+            auto& keys = it->second.pipelineKeys;
+            keys.erase(std::remove(keys.begin(), keys.end(), job.key), keys.end());
         }
+    }
 
-        errorMessage.clear();
-        m_cullPipeline = reloadComputeShader("Shaders/Visibility/meshlet_cull",
-                                             "computeMain",
-                                             nullptr,
-                                             &errorMessage);
-        if (!m_cullPipeline.nativeHandle()) {
-            spdlog::error("Failed to create meshlet cull pipeline: {}",
-                          formatError(&errorMessage, "Slang meshlet cull shader compilation failed"));
-            return false;
+    // Re-collected on every rebuild so added or removed #includes are picked up.
+    files = collectSlangShaderFiles(job.shaderPath, m_projectRoot.c_str());
+    for (const std::string& path : files) {
+        WatchedShaderFile& file = m_watchedShaderFiles[path];
+        std::error_code ec;
+        file.writeTime = std::filesystem::last_write_time(path, ec);
+        file.pipelineKeys.emplace_back(job.key);
+    }
+}
+
+bool ShaderManager::pollPipelinePermutations() {
+    // Requests stay queued while another build is in flight.
+    if (m_backgroundThread.joinable()) {
+        return false;
+    }
+    std::unordered_set<std::string> newKeys;
+    for (ComputePermutationRequests::Request& request : m_rtCtx->computePermutationRequests.take()) {
+        // Built, or failed once: either way the pass already has its answer.
+        if (m_permutations.count(request.key) != 0) {
+            continue;
         }
+        PipelinePermutationEntry entry;
+        entry.baseKey = std::move(request.baseKey);
+        entry.defines = std::move(request.defines);
+        newKeys.insert(request.key);
+        m_permutations.emplace(std::move(request.key), std::move(entry));
+    }
+    if (newKeys.empty()) {
+        return false;
+    }
 
-        errorMessage.clear();
-        m_clusterStreamingAgeFilterPipeline =
-            reloadComputeShader("Shaders/Streaming/stream_agefilter_groups",
-                                "computeMain",
-                                nullptr,
-                                &errorMessage);
-        if (!m_clusterStreamingAgeFilterPipeline.nativeHandle()) {
-            spdlog::error("Failed to create cluster streaming age filter pipeline: {}",
-                          formatError(&errorMessage,
-                                      "Slang cluster streaming age filter shader compilation failed"));
-            return false;
+    for (PipelineJob& job : collectPipelineJobs()) {
+        if (newKeys.count(job.key) != 0) {
+            watchPipelineShaders(job);
+            m_backgroundJobs.push_back(std::move(job));
         }
-    } else {
-        releaseOwnedHandle(m_instanceClassifyPipeline);
-        releaseOwnedHandle(m_cullPipeline);
-        releaseOwnedHandle(m_clusterStreamingAgeFilterPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.hzbBuild) {
-        m_hzbBuildPipeline = reloadComputeShader("Shaders/Visibility/hzb_build",
-                                                 "computeMain",
-                                                 nullptr,
-                                                 &errorMessage);
-        if (!m_hzbBuildPipeline.nativeHandle()) {
-            spdlog::error("Failed to create HZB build pipeline: {}",
-                          formatError(&errorMessage, "Slang HZB build shader compilation failed"));
-            return false;
+    }
+    if (m_backgroundJobs.empty()) {
+        return false;
+    }
+    spdlog::info("Compiling {} pipeline permutations in the background", m_backgroundJobs.size());
+    startBackgroundPipelines(false);
+    return true;
+}
+
+void ShaderManager::addPipelinePermutation(const std::string& baseKey,
+                                           const std::vector<std::pair<std::string, std::string>>& defines) {
+    std::string key = computePermutationKey(baseKey, defines);
+    if (m_permutations.count(key) != 0) {
+        return;
+    }
+    PipelinePermutationEntry entry;
+    entry.baseKey = baseKey;
+    entry.defines = defines;
+    m_permutations.emplace(std::move(key), std::move(entry));
+}
+
+bool ShaderManager::pollShaderChanges() {
+    // A build in flight finishes first; its pipelines were compiled from whatever
+    // was on disk when it started, so later edits are still seen on the next poll.
+    if (!m_shaderWatchEnabled || m_watchedShaderFiles.empty() || m_backgroundThread.joinable()) {
+        return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastShaderWatch < kShaderWatchInterval) {
+        return false;
+    }
+    m_lastShaderWatch = now;
+
+    std::unordered_set<std::string> dirtyKeys;
+    for (auto& [path, file] : m_watchedShaderFiles) {
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(path, ec);
+        // Missing mid-save (editors that write and rename); retried next poll.
+        if (ec || writeTime == file.writeTime) {
+            continue;
         }
-    } else {
-        releaseOwnedHandle(m_hzbBuildPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.buildIndirect) {
-        m_buildIndirectPipeline = reloadComputeShader("Shaders/Visibility/build_indirect",
-                                                      "computeMain",
-                                                      nullptr,
-                                                      &errorMessage);
-        if (!m_buildIndirectPipeline.nativeHandle()) {
-            spdlog::error("Failed to create build indirect pipeline: {}",
-                          formatError(&errorMessage, "Slang build indirect shader compilation failed"));
-            return false;
+        file.writeTime = writeTime;
+        dirtyKeys.insert(file.pipelineKeys.begin(), file.pipelineKeys.end());
+    }
+    if (dirtyKeys.empty()) {
+        return false;
+    }
+
+    for (PipelineJob& job : collectPipelineJobs()) {
+        if (dirtyKeys.count(job.key) != 0) {
+            watchPipelineShaders(job);
+            m_backgroundJobs.push_back(std::move(job));
         }
-    } else {
-        releaseOwnedHandle(m_buildIndirectPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.deferredLighting) {
-        m_computePipeline = reloadComputeShader("Shaders/Visibility/deferred_lighting",
-                                                "computeMain",
-                                                patchComputeShaderSource,
-                                                &errorMessage);
-        if (!m_computePipeline.nativeHandle()) {
-            spdlog::error("Failed to create deferred lighting pipeline: {}",
-                          formatError(&errorMessage, "Slang deferred lighting shader compilation failed"));
-            return false;
+    }
+    if (m_backgroundJobs.empty()) {
+        return false;
+    }
+    spdlog::info("Shader sources changed; recompiling {} pipelines in the background",
+                 m_backgroundJobs.size());
+    startBackgroundPipelines(true);
+    return true;
+}
+
+void ShaderManager::setPipelineManifestPath(std::string path) {
+    m_manifestPath = std::move(path);
+}
+
+void ShaderManager::notePipelineUse(const std::string& passType) {
+    m_usedPassTypes.insert(passType);
+}
+
+bool ShaderManager::loadPipelineManifest(std::unordered_set<std::string>& keys) const {
+    if (m_manifestPath.empty()) {
+        return false;
+    }
+    std::ifstream file(m_manifestPath);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#') {
+            keys.insert(line);
         }
-    } else {
-        releaseOwnedHandle(m_computePipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.meshletVisualize) {
-        m_meshletVisPipeline = reloadComputeShader("Shaders/Visibility/meshlet_visualize",
-                                                   "computeMain",
-                                                   nullptr,
-                                                   &errorMessage);
-        if (!m_meshletVisPipeline.nativeHandle()) {
-            spdlog::warn("Failed to compile meshlet visualize shader; visualization disabled: {}",
-                         formatError(&errorMessage, "Slang meshlet visualize shader compilation failed"));
+    }
+    return true;
+}
+
+bool ShaderManager::savePipelineManifest() const {
+    if (m_manifestPath.empty() || m_usedPassTypes.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(m_manifestPath).parent_path(), ec);
+    std::ofstream file(m_manifestPath, std::ios::trunc);
+    if (!file) {
+        spdlog::warn("Failed to write pipeline manifest {}", m_manifestPath);
+        return false;
+    }
+    file << "# Pipelines used by the last run; prewarmed before the first frame\n";
+    for (const auto& [key, consumer] : m_pipelineConsumers) {
+        if (m_usedPassTypes.count(consumer) != 0) {
+            file << key << '\n';
         }
-    } else {
-        releaseOwnedHandle(m_meshletVisPipeline);
     }
+    return true;
+}
 
-    errorMessage.clear();
-    if (m_profile.sky) {
-        m_skyPipeline = reloadFullscreenShader("Shaders/Atmosphere/sky",
-                                               RhiFormat::RGBA16Float,
-                                               &errorMessage);
-        if (!m_skyPipeline.nativeHandle()) {
-            spdlog::warn("Sky shader compile failed; atmosphere sky disabled: {}",
-                         formatError(&errorMessage, "Slang sky shader compilation failed"));
+std::vector<ShaderPipelineStats> ShaderManager::collectPipelineStats() const {
+    std::vector<ShaderPipelineStats> stats;
+    for (const auto& [key, pipeline] : m_rtCtx->renderPipelinesRhi) {
+        if (pipeline.nativeHandle()) {
+            stats.push_back({key, false, rhiPipelineExecutableStats(m_device, pipeline)});
         }
-    } else {
-        releaseOwnedHandle(m_skyPipeline);
     }
+    for (const auto& [key, pipeline] : m_rtCtx->computePipelinesRhi) {
+        if (pipeline.nativeHandle()) {
+            stats.push_back({key, true, rhiPipelineExecutableStats(m_device, pipeline)});
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](const ShaderPipelineStats& a, const ShaderPipelineStats& b) {
+        return a.key < b.key;
+    });
+    return stats;
+}
 
-    errorMessage.clear();
-    if (m_profile.tonemap) {
-        m_tonemapPipeline = reloadFullscreenShader("Shaders/Post/tonemap",
-                                                   RhiFormat::RGBA8Srgb,
-                                                   &errorMessage);
-        if (!m_tonemapPipeline.nativeHandle()) {
-            spdlog::error("Failed to create tonemap pipeline: {}",
-                          formatError(&errorMessage, "Slang tonemap shader compilation failed"));
-            return false;
+bool ShaderManager::writePipelineStatsReport(const std::string& path) const {
+    nlohmann::json report = nlohmann::json::array();
+    for (const ShaderPipelineStats& pipeline : collectPipelineStats()) {
+        nlohmann::json executables = nlohmann::json::array();
+        for (const RhiPipelineExecutableStats& executable : pipeline.executables) {
+            nlohmann::json statistics = nlohmann::json::object();
+            for (const RhiShaderStatistic& statistic : executable.statistics) {
+                statistics[statistic.name] = statistic.value;
+            }
+            executables.push_back({{"name", executable.name},
+                                   {"subgroupSize", executable.subgroupSize},
+                                   {"statistics", std::move(statistics)}});
+        }
+        report.push_back({{"pipeline", pipeline.key},
+                          {"compute", pipeline.compute},
+                          {"executables", std::move(executables)}});
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        spdlog::warn("Failed to write shader stats report {}", path);
+        return false;
+    }
+    file << report.dump(2) << '\n';
+    spdlog::info("Wrote shader stats for {} pipelines to {}", report.size(), path);
+    return true;
+}
+
+// Required pipelines and the ones the manifest lists are built before returning; the
+// rest build in the background and show up through pollBackgroundPipelines(). Passes
+// already skip work while their pipeline is missing, so nothing waits on them.
+bool ShaderManager::buildAll() {
+    StartupProfile::Phase phase("ShaderManager::buildAll");
+    waitForBackgroundPipelines();
+    createVertexDescriptor();
+
+    std::vector<PipelineJob> jobs = collectPipelineJobs();
+    m_pipelineConsumers.clear();
+    m_watchedShaderFiles.clear();
+    m_pipelineShaderFiles.clear();
+    for (const PipelineJob& job : jobs) {
+        m_pipelineConsumers.emplace_back(job.key, job.consumer);
+        watchPipelineShaders(job);
+    }
+    std::unordered_set<std::string> manifestKeys;
+    const bool haveManifest = loadPipelineManifest(manifestKeys);
+    std::vector<PipelineJob> warmJobs;
+    for (PipelineJob& job : jobs) {
+        if (!haveManifest || job.required || manifestKeys.count(job.key) != 0) {
+            warmJobs.push_back(std::move(job));
+        } else {
+            m_backgroundJobs.push_back(std::move(job));
+        }
+    }
+    compilePipelineJobs(warmJobs);
+
+    bool success = true;
+    for (PipelineJob& job : warmJobs) {
+        if (pipelineJobSucceeded(job)) {
+            applyPipelineJob(job);
+        } else if (job.required) {
+            spdlog::error("Failed to create {} pipeline: {}",
+                          job.label,
+                          formatError(&job.error, "Slang shader compilation failed"));
+            success = false;
+        } else {
+            spdlog::warn("Failed to create {} pipeline; pass disabled: {}",
+                         job.label,
+                         formatError(&job.error, "Slang shader compilation failed"));
         }
-    } else {
-        releaseOwnedHandle(m_tonemapPipeline);
     }
 
     if (m_profile.tonemap || m_profile.output) {
@@ -449,66 +1121,31 @@ bool ShaderManager::buildAll() {
         m_tonemapSampler = rhiCreateSampler(m_device, samplerDesc);
         if (!m_tonemapSampler.nativeHandle()) {
             spdlog::error("Failed to create tonemap sampler state");
-            return false;
+            success = false;
         }
     } else {
         releaseOwnedHandle(m_tonemapSampler);
     }
 
-    errorMessage.clear();
-    if (m_profile.output) {
-        m_outputPipeline = reloadFullscreenShader("Shaders/Post/passthrough",
-                                                  RhiFormat::BGRA8Unorm,
-                                                  &errorMessage);
-        if (!m_outputPipeline.nativeHandle()) {
-            spdlog::error("Failed to create output passthrough pipeline: {}",
-                          formatError(&errorMessage, "Slang passthrough shader compilation failed"));
-            return false;
+    if (m_profile.tonemap) {
+        m_postPyramidSampler = createPostPyramidSampler();
+        if (!m_postPyramidSampler.nativeHandle()) {
+            spdlog::warn("Failed to create post pyramid sampler; bloom and depth of field disabled");
         }
     } else {
-        releaseOwnedHandle(m_outputPipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.autoExposure) {
-        m_histogramPipeline = reloadComputeShader("Shaders/Post/auto_exposure",
-                                                  "histogramMain",
-                                                  nullptr,
-                                                  &errorMessage);
-        if (!m_histogramPipeline.nativeHandle()) {
-            spdlog::warn("Failed to compile histogram shader; auto-exposure disabled: {}",
-                         formatError(&errorMessage, "Slang histogram shader compilation failed"));
-        }
+        releaseOwnedHandle(m_postPyramidSampler);
+    }
 
-        errorMessage.clear();
-        m_autoExposurePipeline = reloadComputeShader("Shaders/Post/auto_exposure",
-                                                     "exposureMain",
-                                                     nullptr,
-                                                     &errorMessage);
-        if (!m_autoExposurePipeline.nativeHandle()) {
-            spdlog::warn("Failed to compile auto-exposure shader; auto-exposure disabled: {}",
-                         formatError(&errorMessage, "Slang auto-exposure shader compilation failed"));
-        }
-    } else {
-        releaseOwnedHandle(m_histogramPipeline);
-        releaseOwnedHandle(m_autoExposurePipeline);
-    }
-
-    errorMessage.clear();
-    if (m_profile.taa) {
-        m_taaPipeline = reloadComputeShader("Shaders/Post/taa",
-                                            "taaMain",
-                                            nullptr,
-                                            &errorMessage);
-        if (!m_taaPipeline.nativeHandle()) {
-            spdlog::warn("Failed to compile TAA shader; TAA disabled: {}",
-                         formatError(&errorMessage, "Slang TAA shader compilation failed"));
-        }
-    } else {
-        releaseOwnedHandle(m_taaPipeline);
+    if (!success) {
+        m_backgroundJobs.clear();
+        return false;
     }
 
     syncRuntimeContext();
+    if (!m_backgroundJobs.empty()) {
+        spdlog::info("Compiling {} pipelines not in the manifest in the background", m_backgroundJobs.size());
+        startBackgroundPipelines(false);
+    }
     return true;
 }
 
@@ -518,7 +1155,11 @@ RhiGraphicsPipelineHandle ShaderManager::reloadVertexShader(const char* shaderPa
     opts.generateDebugInfo = (m_compileMode == ShaderCompileMode::Debug);
     opts.defines = m_globalDefines;
 
-    std::string source = compileGraphics(shaderPath, m_projectRoot.c_str(), &opts);
+    std::string source;
+    {
+        StartupProfile::Phase compilePhase("Slang compile");
+        source = compileGraphics(shaderPath, m_projectRoot.c_str(), &opts);
+    }
     if (source.empty()) {
         if (errorMessage) {
             *errorMessage = "Slang vertex shader compilation returned empty source";
@@ -534,7 +1175,11 @@ RhiGraphicsPipelineHandle ShaderManager::reloadVertexShader(const char* shaderPa
     pipelineDesc.vertexDescriptor = &m_vertexDesc;
 
     std::string localError;
-    RhiGraphicsPipelineHandle pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    RhiGraphicsPipelineHandle pipeline;
+    {
+        StartupProfile::Phase pipelinePhase("Pipeline creation");
+        pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    }
     if (!pipeline.nativeHandle() && errorMessage) {
         *errorMessage = std::move(localError);
     }
@@ -543,13 +1188,18 @@ RhiGraphicsPipelineHandle ShaderManager::reloadVertexShader(const char* shaderPa
 
 RhiGraphicsPipelineHandle ShaderManager::reloadFullscreenShader(const char* shaderPath,
                                                                 RhiFormat colorFormat,
+                                                                RhiFormat depthFormat,
                                                                 std::string* errorMessage) {
     SlangCompileOptions opts;
     opts.optimized = (m_compileMode == ShaderCompileMode::Release);
     opts.generateDebugInfo = (m_compileMode == ShaderCompileMode::Debug);
     opts.defines = m_globalDefines;
 
-    std::string source = compileGraphics(shaderPath, m_projectRoot.c_str(), &opts);
+    std::string source;
+    {
+        StartupProfile::Phase compilePhase("Slang compile");
+        source = compileGraphics(shaderPath, m_projectRoot.c_str(), &opts);
+    }
     if (source.empty()) {
         if (errorMessage) {
             *errorMessage = "Slang fullscreen shader compilation returned empty source";
@@ -561,9 +1211,14 @@ RhiGraphicsPipelineHandle ShaderManager::reloadFullscreenShader(const char* shad
     pipelineDesc.vertexEntry = "vertexMain";
     pipelineDesc.fragmentEntry = "fragmentMain";
     pipelineDesc.colorFormat = colorFormat;
+    pipelineDesc.depthFormat = depthFormat;
 
     std::string localError;
-    RhiGraphicsPipelineHandle pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    RhiGraphicsPipelineHandle pipeline;
+    {
+        StartupProfile::Phase pipelinePhase("Pipeline creation");
+        pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    }
     if (!pipeline.nativeHandle() && errorMessage) {
         *errorMessage = std::move(localError);
     }
@@ -571,16 +1226,22 @@ RhiGraphicsPipelineHandle ShaderManager::reloadFullscreenShader(const char* shad
 }
 
 RhiGraphicsPipelineHandle ShaderManager::reloadMeshShader(const char* shaderPath,
-                                                          std::string (*patchFn)(RhiBackendType, const std::string&),
                                                           RhiFormat colorFormat,
                                                           RhiFormat depthFormat,
-                                                          std::string* errorMessage) {
+                                                          std::string* errorMessage,
+                                                          const char* fragmentEntry,
+                                                          RhiBlendMode blendMode,
+                                                          bool depthWrite) {
     SlangCompileOptions opts;
     opts.optimized = (m_compileMode == ShaderCompileMode::Release);
     opts.generateDebugInfo = (m_compileMode == ShaderCompileMode::Debug);
     opts.defines = m_globalDefines;
 
-    std::string source = compileMesh(shaderPath, m_projectRoot.c_str(), &opts);
+    std::string source;
+    {
+        StartupProfile::Phase compilePhase("Slang compile");
+        source = compileMesh(shaderPath, m_projectRoot.c_str(), &opts);
+    }
     if (source.empty()) {
         if (errorMessage) {
             *errorMessage = "Slang mesh shader compilation returned empty source";
@@ -588,18 +1249,20 @@ RhiGraphicsPipelineHandle ShaderManager::reloadMeshShader(const char* shaderPath
         return {};
     }
 
-    if (patchFn) {
-        source = patchFn(kShaderBackend, source);
-    }
-
     RhiRenderPipelineSourceDesc pipelineDesc;
     pipelineDesc.meshEntry = "meshMain";
-    pipelineDesc.fragmentEntry = "fragmentMain";
+    pipelineDesc.fragmentEntry = fragmentEntry;
     pipelineDesc.colorFormat = colorFormat;
     pipelineDesc.depthFormat = depthFormat;
+    pipelineDesc.blendMode = blendMode;
+    pipelineDesc.depthWrite = depthWrite;
 
     std::string localError;
-    RhiGraphicsPipelineHandle pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    RhiGraphicsPipelineHandle pipeline;
+    {
+        StartupProfile::Phase pipelinePhase("Pipeline creation");
+        pipeline = rhiCreateRenderPipelineFromSource(m_device, source, pipelineDesc, localError);
+    }
     if (!pipeline.nativeHandle() && errorMessage) {
         *errorMessage = std::move(localError);
     }
@@ -608,14 +1271,21 @@ RhiGraphicsPipelineHandle ShaderManager::reloadMeshShader(const char* shaderPath
 
 RhiComputePipelineHandle ShaderManager::reloadComputeShader(const char* shaderPath,
                                                             const char* entryPoint,
-                                                            std::string (*patchFn)(RhiBackendType, const std::string&),
-                                                            std::string* errorMessage) {
+                                                            std::string* errorMessage,
+                                                            const std::vector<std::pair<std::string, std::string>>* extraDefines) {
     SlangCompileOptions opts;
     opts.optimized = (m_compileMode == ShaderCompileMode::Release);
     opts.generateDebugInfo = (m_compileMode == ShaderCompileMode::Debug);
     opts.defines = m_globalDefines;
+    if (extraDefines) {
+        opts.defines.insert(opts.defines.end(), extraDefines->begin(), extraDefines->end());
+    }
 
-    std::string source = compileCompute(shaderPath, m_projectRoot.c_str(), entryPoint, &opts);
+    std::string source;
+    {
+        StartupProfile::Phase compilePhase("Slang compile");
+        source = compileCompute(shaderPath, m_projectRoot.c_str(), entryPoint, &opts);
+    }
     if (source.empty()) {
         if (errorMessage) {
             *errorMessage = "Slang compute shader compilation returned empty source";
@@ -623,228 +1293,85 @@ RhiComputePipelineHandle ShaderManager::reloadComputeShader(const char* shaderPa
         return {};
     }
 
-    if (patchFn) {
-        source = patchFn(kShaderBackend, source);
-    }
-
     std::string localError;
-    RhiComputePipelineHandle pipeline = rhiCreateComputePipelineFromSource(m_device, source, entryPoint, localError);
+    RhiComputePipelineHandle pipeline;
+    {
+        StartupProfile::Phase pipelinePhase("Pipeline creation");
+        pipeline = rhiCreateComputePipelineFromSource(m_device, source, entryPoint, localError);
+    }
     if (!pipeline.nativeHandle() && errorMessage) {
         *errorMessage = std::move(localError);
     }
     return pipeline;
 }
 
-std::pair<int, int> ShaderManager::reloadAll() {
-    int reloaded = 0;
-    int failed = 0;
-    std::string errorMessage;
-
-    auto reloadPipeline = [&](bool enabled, auto& target, const char* label, auto&& reloadFn) {
-        if (!enabled) {
-            releaseOwnedHandle(target);
-            return;
+// Only the Slang step runs: its on-disk cache is the archive, and pipeline creation
+// stays with the device the shipped binary runs on.
+std::pair<int, int> ShaderManager::bakeShaders() {
+    waitForBackgroundPipelines();
+
+    std::vector<PipelineJob> jobs = collectPipelineJobs();
+    std::vector<uint8_t> baked(jobs.size(), 0u);
+    const auto start = std::chrono::steady_clock::now();
+    Parallel::parallelFor(jobs.size(), [&](size_t index) {
+        const PipelineJob& job = jobs[index];
+        SlangCompileOptions opts;
+        opts.optimized = (m_compileMode == ShaderCompileMode::Release);
+        opts.generateDebugInfo = (m_compileMode == ShaderCompileMode::Debug);
+        opts.defines = m_globalDefines;
+        opts.defines.insert(opts.defines.end(), job.defines.begin(), job.defines.end());
+
+        std::string output;
+        switch (job.kind) {
+            case PipelineKind::Vertex:
+            case PipelineKind::Fullscreen:
+                output = compileGraphics(job.shaderPath, m_projectRoot.c_str(), &opts);
+                break;
+            case PipelineKind::Mesh:
+                output = compileMesh(job.shaderPath, m_projectRoot.c_str(), &opts);
+                break;
+            case PipelineKind::Compute:
+                output = compileCompute(job.shaderPath, m_projectRoot.c_str(), job.entryPoint, &opts);
+                break;
         }
+        baked[index] = output.empty() ? 0u : 1u;
+    });
 
-        errorMessage.clear();
-        auto pipeline = reloadFn(errorMessage);
-        if (pipeline.nativeHandle()) {
-            releaseOwnedHandle(target);
-            target = pipeline;
-            reloaded++;
+    int succeeded = 0;
+    int failed = 0;
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        if (baked[index]) {
+            succeeded++;
         } else {
-            spdlog::error("Hot-reload {}: {}", label, formatError(&errorMessage, "Unknown failure"));
+            spdlog::error("Shader bake {} ({}): Slang compilation failed", jobs[index].label, jobs[index].key);
             failed++;
         }
-    };
-
-    reloadPipeline(m_profile.forwardVertex,
-                   m_vertexPipeline,
-                   "vertex PSO",
-                   [&](std::string& localError) {
-                       return reloadVertexShader("Shaders/Vertex/bunny", &localError);
-                   });
-
-    if (m_profile.forwardMesh) {
-        if (m_supportsMeshShaders) {
-            reloadPipeline(true,
-                           m_meshPipeline,
-                           "mesh PSO",
-                           [&](std::string& localError) {
-                               return reloadMeshShader("Shaders/Mesh/meshlet",
-                                                       patchMeshShaderSource,
-                                                       RhiFormat::RGBA16Float,
-                                                       RhiFormat::D32Float,
-                                                       &localError);
-                           });
-        } else {
-            spdlog::info("Skipping mesh PSO hot-reload because mesh shaders are not supported");
-            releaseOwnedHandle(m_meshPipeline);
-        }
-    } else {
-        releaseOwnedHandle(m_meshPipeline);
     }
+    spdlog::info("Baked {} of {} pipelines in {:.1f} ms",
+                 succeeded, jobs.size(),
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return {succeeded, failed};
+}
 
-    if (m_profile.visibility) {
-        if (!m_supportsMeshShaders) {
-            spdlog::info("Skipping visibility PSO hot-reload because mesh shaders are not supported");
-            releaseOwnedHandle(m_visPipeline);
-        } else if (!m_validateVisibilityPipelines) {
-            spdlog::info("Skipping visibility PSO hot-reload on Vulkan due to Slang PerPrimitiveEXT blocker: {}",
-                         kSlangVisibilityPerPrimitiveIssueUrl);
-            releaseOwnedHandle(m_visPipeline);
-        } else {
-            reloadPipeline(true,
-                           m_visPipeline,
-                           "visibility PSO",
-                           [&](std::string& localError) {
-                               return reloadMeshShader("Shaders/Visibility/visibility",
-                                                       patchVisibilityShaderSource,
-                                                       RhiFormat::R32Uint,
-                                                       RhiFormat::D32Float,
-                                                       &localError);
-                           });
-        }
-    } else {
-        releaseOwnedHandle(m_visPipeline);
-    }
+std::pair<int, int> ShaderManager::reloadAll() {
+    waitForBackgroundPipelines();
 
-    if (m_profile.visibilityIndirect) {
-        if (!m_supportsMeshShaders) {
-            spdlog::info("Skipping visibility indirect PSO hot-reload because mesh shaders are not supported");
-            releaseOwnedHandle(m_visIndirectPipeline);
-        } else if (!m_validateVisibilityPipelines) {
-            spdlog::info("Skipping visibility indirect PSO hot-reload on Vulkan due to Slang PerPrimitiveEXT blocker: {}",
-                         kSlangVisibilityPerPrimitiveIssueUrl);
-            releaseOwnedHandle(m_visIndirectPipeline);
+    int reloaded = 0;
+    int failed = 0;
+    std::vector<PipelineJob> jobs = collectPipelineJobs();
+    for (const PipelineJob& job : jobs) {
+        watchPipelineShaders(job);
+    }
+    compilePipelineJobs(jobs);
+    for (PipelineJob& job : jobs) {
+        if (pipelineJobSucceeded(job)) {
+            applyPipelineJob(job);
+            reloaded++;
         } else {
-            reloadPipeline(true,
-                           m_visIndirectPipeline,
-                           "visibility indirect PSO",
-                           [&](std::string& localError) {
-                               return reloadMeshShader("Shaders/Visibility/visibility_indirect",
-                                                       patchVisibilityShaderSource,
-                                                       RhiFormat::R32Uint,
-                                                       RhiFormat::D32Float,
-                                                       &localError);
-                           });
+            spdlog::error("Hot-reload {} PSO: {}", job.label, formatError(&job.error, "Unknown failure"));
+            failed++;
         }
-    } else {
-        releaseOwnedHandle(m_visIndirectPipeline);
-    }
-
-    if (m_profile.clusterRender && m_supportsMeshShaders) {
-        reloadPipeline(true,
-                       m_clusterRenderPipeline,
-                       "cluster render PSO",
-                       [&](std::string& localError) {
-                           return reloadMeshShader("Shaders/Mesh/cluster_render",
-                                                   nullptr,
-                                                   RhiFormat::RGBA8Unorm,
-                                                   RhiFormat::D32Float,
-                                                   &localError);
-                       });
-    } else {
-        releaseOwnedHandle(m_clusterRenderPipeline);
-    }
-
-    reloadPipeline(m_profile.meshletCull,
-                   m_clusterStreamingUpdatePipeline,
-                   "cluster streaming update PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Streaming/stream_update_scene",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.meshletCull,
-                   m_instanceClassifyPipeline,
-                   "instance classify PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/instance_classify",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.meshletCull,
-                   m_cullPipeline,
-                   "meshlet cull PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/meshlet_cull",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.meshletCull,
-                   m_clusterStreamingAgeFilterPipeline,
-                   "cluster streaming age filter PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Streaming/stream_agefilter_groups",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.hzbBuild,
-                   m_hzbBuildPipeline,
-                   "HZB build PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/hzb_build",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.buildIndirect,
-                   m_buildIndirectPipeline,
-                   "build indirect PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/build_indirect",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.deferredLighting,
-                   m_computePipeline,
-                   "deferred lighting PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/deferred_lighting",
-                                                  "computeMain",
-                                                  patchComputeShaderSource,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.meshletVisualize,
-                   m_meshletVisPipeline,
-                   "meshlet visualize PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Visibility/meshlet_visualize",
-                                                  "computeMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
-
-    reloadPipeline(m_profile.sky,
-                   m_skyPipeline,
-                   "sky PSO",
-                   [&](std::string& localError) {
-                       return reloadFullscreenShader("Shaders/Atmosphere/sky",
-                                                     RhiFormat::RGBA16Float,
-                                                     &localError);
-                   });
-
-    reloadPipeline(m_profile.tonemap,
-                   m_tonemapPipeline,
-                   "tonemap PSO",
-                   [&](std::string& localError) {
-                       return reloadFullscreenShader("Shaders/Post/tonemap",
-                                                     RhiFormat::RGBA8Srgb,
-                                                     &localError);
-                   });
+    }
 
     if (m_profile.tonemap || m_profile.output) {
         if (!m_tonemapSampler.nativeHandle()) {
@@ -861,52 +1388,16 @@ std::pair<int, int> ShaderManager::reloadAll() {
             }
         }
     } else {
-        releaseOwnedHandle(m_tonemapSampler);
+        retireOwnedHandle(m_tonemapSampler);
     }
 
-    reloadPipeline(m_profile.output,
-                   m_outputPipeline,
-                   "output PSO",
-                   [&](std::string& localError) {
-                       return reloadFullscreenShader("Shaders/Post/passthrough",
-                                                     RhiFormat::BGRA8Unorm,
-                                                     &localError);
-                   });
-
-    if (m_profile.autoExposure) {
-        reloadPipeline(true,
-                       m_histogramPipeline,
-                       "histogram PSO",
-                       [&](std::string& localError) {
-                           return reloadComputeShader("Shaders/Post/auto_exposure",
-                                                      "histogramMain",
-                                                      nullptr,
-                                                      &localError);
-                       });
-
-        reloadPipeline(true,
-                       m_autoExposurePipeline,
-                       "auto-exposure PSO",
-                       [&](std::string& localError) {
-                           return reloadComputeShader("Shaders/Post/auto_exposure",
-                                                      "exposureMain",
-                                                      nullptr,
-                                                      &localError);
-                       });
+    if (m_profile.tonemap) {
+        if (!m_postPyramidSampler.nativeHandle()) {
+            m_postPyramidSampler = createPostPyramidSampler();
+        }
     } else {
-        releaseOwnedHandle(m_histogramPipeline);
-        releaseOwnedHandle(m_autoExposurePipeline);
-    }
-
-    reloadPipeline(m_profile.taa,
-                   m_taaPipeline,
-                   "TAA PSO",
-                   [&](std::string& localError) {
-                       return reloadComputeShader("Shaders/Post/taa",
-                                                  "taaMain",
-                                                  nullptr,
-                                                  &localError);
-                   });
+        retireOwnedHandle(m_postPyramidSampler);
+    }
 
     syncRuntimeContext();
     return {reloaded, failed};
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -69,6 +75,13 @@ struct ShaderManagerProfile {
     }
 };
 
+// Driver statistics for one pipeline the runtime context publishes.
+struct ShaderPipelineStats {
+    std::string key;
+    bool compute = false;
+    std::vector<RhiPipelineExecutableStats> executables;
+};
+
 class ShaderManager {
 public:
     ShaderManager(RhiDeviceHandle device,
@@ -80,16 +93,60 @@ public:
     ~ShaderManager();
 
     // Initial creation of all pipelines + samplers. Returns false on fatal failure.
+    // Pipelines compile in parallel; with a warm-up manifest, optional pipelines the
+    // last run never used finish in the background (see pollBackgroundPipelines).
     bool buildAll();
 
     // F5 hot-reload (swap-on-success per pipeline). Returns {reloaded, failed}.
     std::pair<int,int> reloadAll();
 
+    // Shader file watcher. Every kShaderWatchInterval at most, checks the sources and
+    // includes of every pipeline for new modification times and recompiles only the
+    // pipelines that use a changed file, in the background; the old pipelines keep
+    // rendering until pollBackgroundPipelines publishes the new ones. Call once per
+    // frame; returns true when a rebuild started.
+    bool pollShaderChanges();
+    void setShaderWatchEnabled(bool enabled) { m_shaderWatchEnabled = enabled; }
+
+    // Starts background builds of the compute permutations passes queued through
+    // PipelineRuntimeContext::findComputePermutation; pollBackgroundPipelines publishes
+    // them. Each permutation is attempted once and then rebuilt with its base pipeline
+    // on reloads. Call once per frame; returns true when builds started.
+    bool pollPipelinePermutations();
+
+    // Registers a compute permutation of baseKey ahead of any request, so the next
+    // buildAll(), reloadAll() or bakeShaders() compiles it with the other pipelines.
+    void addPipelinePermutation(const std::string& baseKey,
+                                const std::vector<std::pair<std::string, std::string>>& defines);
+
+    // Offline prebuild for MetallicShaderBake: compiles every pipeline and registered
+    // permutation the profile enables into the Slang shader cache without creating
+    // pipeline objects, so no device is needed. Returns {baked, failed}.
+    std::pair<int,int> bakeShaders();
+
+    // Publishes background-compiled pipelines into the runtime context once they are
+    // all done. Call once per frame; returns true when new pipelines became available.
+    bool pollBackgroundPipelines();
+
+    // Warm-up manifest: pass types noted during a run are saved so the next cold start
+    // builds their pipelines before the first frame. Set the path before buildAll().
+    void setPipelineManifestPath(std::string path);
+    void notePipelineUse(const std::string& passType);
+    bool savePipelineManifest() const;
+
+    // Shader performance lint: register, spill and occupancy statistics of every
+    // published pipeline and permutation, sorted by key. Queried from the driver on
+    // each call, so callers cache the result. The report writes the same data as JSON
+    // so kernel regressions show up as a diff.
+    std::vector<ShaderPipelineStats> collectPipelineStats() const;
+    bool writePipelineStatsReport(const std::string& path) const;
+
     // Import external textures/samplers into the runtime context.
     void importTexture(const std::string& name, const RhiTexture& texture);
     void importSampler(const std::string& name, const RhiSampler& sampler);
 
     // Engine-wide preprocessor defines applied to all shader compilations.
+    // METALLIC_VISIBILITY_64 switches the visibility target to RG32Uint.
     void setGlobalDefines(const std::vector<std::pair<std::string, std::string>>& defines);
 
     // Change compile mode (takes effect on next buildAll/reloadAll).
@@ -100,6 +157,9 @@ public:
     bool hasSkyPipeline() const;
 
 private:
+    bool hasGlobalDefine(const char* name) const;
+    RhiFormat visibilityFormat() const;
+
     RhiDeviceHandle m_device;
     std::string m_projectRoot;
     bool m_supportsMeshShaders = true;
@@ -113,40 +173,152 @@ private:
     // Owned pipeline states
     RhiGraphicsPipelineHandle m_vertexPipeline;
     RhiGraphicsPipelineHandle m_meshPipeline;
+    RhiGraphicsPipelineHandle m_forwardIndirectPipeline;
     RhiGraphicsPipelineHandle m_visPipeline;
     RhiGraphicsPipelineHandle m_visIndirectPipeline;
+    RhiGraphicsPipelineHandle m_visIndirectAlphaMaskedPipeline;
+    RhiGraphicsPipelineHandle m_visSoftwareResolvePipeline;
+    RhiGraphicsPipelineHandle m_transparencyAccumulatePipeline;
+    RhiGraphicsPipelineHandle m_transparencyRevealagePipeline;
     RhiComputePipelineHandle m_computePipeline;
+    RhiComputePipelineHandle m_lightingClassifyPipeline;
+    RhiComputePipelineHandle m_lightingSkyTilesPipeline;
+    RhiComputePipelineHandle m_lightingUntexturedTilesPipeline;
+    RhiComputePipelineHandle m_lightingTexturedTilesPipeline;
+    RhiComputePipelineHandle m_viewportPickPipeline;
+    RhiComputePipelineHandle m_lightingCoarseTilesPipeline;
+    RhiComputePipelineHandle m_lightingShadingRatePipeline;
+    RhiComputePipelineHandle m_lightCullPipeline;
+    RhiComputePipelineHandle m_shadowCascadeResolvePipeline;
+    RhiComputePipelineHandle m_shadowDenoisePipeline;
+    RhiComputePipelineHandle m_ambientOcclusionPipeline;
+    RhiComputePipelineHandle m_oitCompositePipeline;
     RhiComputePipelineHandle m_clusterStreamingUpdatePipeline;
     RhiComputePipelineHandle m_instanceClassifyPipeline;
+    RhiComputePipelineHandle m_indexedDrawBuildPipeline;
+    RhiComputePipelineHandle m_transformHierarchyPipeline;
+    RhiComputePipelineHandle m_skinningPipeline;
+    RhiComputePipelineHandle m_skinningRefitPipeline;
+    RhiComputePipelineHandle m_instanceBvhCullPipeline;
     RhiComputePipelineHandle m_cullPipeline;
+    RhiComputePipelineHandle m_cullContinuationPipeline;
+    RhiComputePipelineHandle m_cullContinuationPublishPipeline;
+    RhiComputePipelineHandle m_cullVisibleHistoryReplayPipeline;
+    RhiComputePipelineHandle m_cullVisibleHistoryClearPipeline;
+    RhiComputePipelineHandle m_cullVisibleHistoryPublishPipeline;
     RhiComputePipelineHandle m_clusterStreamingAgeFilterPipeline;
+    RhiComputePipelineHandle m_clusterStreamingRequestCompactPipeline;
     RhiComputePipelineHandle m_hzbBuildPipeline;
+    RhiComputePipelineHandle m_hzbDownsamplePipeline;
+    RhiComputePipelineHandle m_softwareRasterClearPipeline;
+    RhiComputePipelineHandle m_softwareRasterPipeline;
     RhiComputePipelineHandle m_buildIndirectPipeline;
+    RhiComputePipelineHandle m_worklistResetPipeline;
     RhiComputePipelineHandle m_meshletVisPipeline;
     RhiGraphicsPipelineHandle m_skyPipeline;
+    RhiComputePipelineHandle m_atmosphereTransmittancePipeline;
+    RhiComputePipelineHandle m_atmosphereDirectIrradiancePipeline;
+    RhiComputePipelineHandle m_atmosphereSingleScatteringPipeline;
+    RhiComputePipelineHandle m_atmosphereScatteringDensityPipeline;
+    RhiComputePipelineHandle m_atmosphereIndirectIrradiancePipeline;
+    RhiComputePipelineHandle m_atmosphereMultipleScatteringPipeline;
+    RhiComputePipelineHandle m_atmosphereSkyViewPipeline;
+    RhiComputePipelineHandle m_atmosphereSkyIrradiancePipeline;
     RhiGraphicsPipelineHandle m_tonemapPipeline;
     RhiGraphicsPipelineHandle m_outputPipeline;
-    RhiComputePipelineHandle m_histogramPipeline;
     RhiComputePipelineHandle m_autoExposurePipeline;
     RhiComputePipelineHandle m_taaPipeline;
+    RhiComputePipelineHandle m_taaTiledPipeline;
+    RhiComputePipelineHandle m_temporalUpscalePipeline;
+    RhiComputePipelineHandle m_fusedPostPipeline;
+    RhiComputePipelineHandle m_postPyramidPipeline;
     RhiGraphicsPipelineHandle m_clusterRenderPipeline;
     RhiSamplerHandle m_tonemapSampler;
+    RhiSamplerHandle m_postPyramidSampler;  // trilinear, for the bloom / DoF pyramid
+
+    enum class PipelineKind { Vertex, Fullscreen, Mesh, Compute };
+
+    struct PipelineJob {
+        const char* key = nullptr;      // runtime context entry
+        const char* consumer = nullptr; // pass type that draws with it
+        const char* label = nullptr;
+        PipelineKind kind = PipelineKind::Compute;
+        const char* shaderPath = nullptr;
+        const char* entryPoint = nullptr; // compute kernel, or a mesh pipeline's fragment entry
+        std::vector<std::pair<std::string, std::string>> defines; // permutation defines
+        RhiFormat colorFormat = RhiFormat::Undefined;
+        RhiFormat depthFormat = RhiFormat::Undefined;
+        RhiBlendMode blendMode = RhiBlendMode::Opaque; // mesh pipelines only
+        bool depthWrite = true;
+        bool required = true;
+        RhiGraphicsPipelineHandle* graphicsTarget = nullptr;
+        RhiComputePipelineHandle* computeTarget = nullptr;
+        RhiGraphicsPipelineHandle graphicsResult;
+        RhiComputePipelineHandle computeResult;
+        std::string error;
+    };
+
+    std::string m_manifestPath;
+    std::unordered_set<std::string> m_usedPassTypes;
+    std::vector<std::pair<std::string, std::string>> m_pipelineConsumers; // {key, consumer}
+    std::vector<PipelineJob> m_backgroundJobs;
+    std::thread m_backgroundThread;
+    std::atomic<bool> m_backgroundDone{true};
+    bool m_backgroundIsReload = false; // failed jobs keep their previous pipeline
+
+    // Reverse dependency graph for the watcher: canonical file path -> pipelines
+    // that compile it, and pipeline key -> its files.
+    struct WatchedShaderFile {
+        std::filesystem::file_time_type writeTime;
+        std::vector<std::string> pipelineKeys;
+    };
+    static constexpr std::chrono::milliseconds kShaderWatchInterval{250};
+    bool m_shaderWatchEnabled = true;
+    std::chrono::steady_clock::time_point m_lastShaderWatch;
+    std::unordered_map<std::string, WatchedShaderFile> m_watchedShaderFiles;
+    std::unordered_map<std::string, std::vector<std::string>> m_pipelineShaderFiles;
+
+    // Compute permutations by runtime-context key; the map owns their handles.
+    struct PipelinePermutationEntry {
+        std::string baseKey;
+        std::vector<std::pair<std::string, std::string>> defines;
+        RhiComputePipelineHandle pipeline;
+    };
+    std::unordered_map<std::string, PipelinePermutationEntry> m_permutations;
 
     void createVertexDescriptor();
+    RhiSamplerHandle createPostPyramidSampler() const;
     void syncRuntimeContext();
 
+    // Jobs for every pipeline the profile enables; disabled pipelines are released.
+    std::vector<PipelineJob> collectPipelineJobs();
+    void compilePipelineJob(PipelineJob& job);
+    void compilePipelineJobs(std::vector<PipelineJob>& jobs);
+    static bool pipelineJobSucceeded(const PipelineJob& job);
+    void applyPipelineJob(PipelineJob& job);
+    // Releases a replaced handle once the frames that may still bind it have retired.
+    template <typename Handle>
+    void retireOwnedHandle(Handle& handle);
+    void startBackgroundPipelines(bool isReload);
+    void waitForBackgroundPipelines();
+    void watchPipelineShaders(const PipelineJob& job);
+    bool loadPipelineManifest(std::unordered_set<std::string>& keys) const;
+
     // Internal reload helpers (return empty handle on failure)
     RhiGraphicsPipelineHandle reloadVertexShader(const char* shaderPath, std::string* errorMessage = nullptr);
     RhiGraphicsPipelineHandle reloadFullscreenShader(const char* shaderPath,
                                                      RhiFormat colorFormat,
+                                                     RhiFormat depthFormat,
                                                      std::string* errorMessage = nullptr);
     RhiGraphicsPipelineHandle reloadMeshShader(
         const char* shaderPath,
-        std::string (*patchFn)(RhiBackendType, const std::string&),
         RhiFormat colorFormat, RhiFormat depthFormat,
-        std::string* errorMessage = nullptr);
+        std::string* errorMessage = nullptr,
+        const char* fragmentEntry = "fragmentMain",
+        RhiBlendMode blendMode = RhiBlendMode::Opaque,
+        bool depthWrite = true);
     RhiComputePipelineHandle reloadComputeShader(
         const char* shaderPath, const char* entryPoint,
-        std::string (*patchFn)(RhiBackendType, const std::string&),
-        std::string* errorMessage = nullptr);
+        std::string* errorMessage = nullptr,
+        const std::vector<std::pair<std::string, std::string>>* extraDefines = nullptr);
 };
@@ -1,5 +1,7 @@
 #include "slang_compiler.h"
 
+#include "bindless_scene_constants.h"
+
 #include <slang.h>
 #include <slang-com-ptr.h>
 #include <spdlog/spdlog.h>
@@ -10,6 +12,8 @@
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <regex>
 #include <set>
@@ -32,6 +36,7 @@ struct SlangTargetConfig {
 };
 
 void logDiagnostics(const char* prefix, const char* shaderPath, slang::IBlob* diagnostics);
+uint64_t hashMix(uint64_t seed, const void* data, size_t size);
 
 constexpr uint32_t kSpirvHeaderWordCount = 5;
 constexpr uint16_t kSpirvOpCapability = 17;
@@ -53,13 +58,10 @@ std::unordered_map<uint64_t, SlangShaderBindingLayout> g_bindingLayoutCache;
 std::mutex g_recentDiagnosticsMutex;
 std::vector<SlangDiagnosticRecord> g_recentDiagnostics;
 constexpr size_t kMaxRecentDiagnostics = 12;
+thread_local SlangDiagnosticCapture* t_diagnosticCapture = nullptr;
 
-void recordDiagnostic(const char* stage, const char* shaderPath, std::string message) {
+void appendRecentDiagnostic(SlangDiagnosticRecord record) {
     std::scoped_lock lock(g_recentDiagnosticsMutex);
-    SlangDiagnosticRecord record;
-    record.stage = stage ? stage : "Slang";
-    record.shaderPath = shaderPath ? shaderPath : "";
-    record.message = std::move(message);
     g_recentDiagnostics.push_back(std::move(record));
     if (g_recentDiagnostics.size() > kMaxRecentDiagnostics) {
         g_recentDiagnostics.erase(
@@ -69,10 +71,24 @@ void recordDiagnostic(const char* stage, const char* shaderPath, std::string mes
     }
 }
 
+void recordDiagnostic(const char* stage, const char* shaderPath, std::string message) {
+    SlangDiagnosticRecord record;
+    record.stage = stage ? stage : "Slang";
+    record.shaderPath = shaderPath ? shaderPath : "";
+    record.message = std::move(message);
+    if (t_diagnosticCapture) {
+        t_diagnosticCapture->add(std::move(record));
+    } else {
+        appendRecentDiagnostic(std::move(record));
+    }
+}
+
 // --- SPIR-V on-disk cache ---
 
 constexpr uint32_t kSpirvMagic = 0x07230203u;
 std::string g_shaderCacheDir; // empty = disabled
+// Read-only archive baked by MetallicShaderBake; consulted after g_shaderCacheDir.
+std::string g_prebuiltShaderCacheDir; // empty = none
 
 std::mutex g_compileStatsMutex;
 SlangCompileStats g_compileStats;
@@ -93,6 +109,70 @@ std::string resolveShaderFilePath(const std::string& basePath) {
     return {};
 }
 
+// --- Per-file scan cache ---
+//
+// Cache keys and the hot-reload watcher hash the same shared headers for every
+// pipeline, so each file's content hash and #include list are kept until its
+// modification time or size changes.
+
+struct ShaderFileScan {
+    std::filesystem::file_time_type writeTime;
+    uintmax_t size = 0;
+    uint64_t contentHash = 0;
+    std::vector<std::string> includes; // as written, resolved by the caller
+};
+
+std::mutex g_fileScanMutex;
+std::unordered_map<std::string, ShaderFileScan> g_fileScans;
+
+bool scanShaderFile(const std::string& absPath, ShaderFileScan& outScan) {
+    std::error_code ec;
+    const auto writeTime = std::filesystem::last_write_time(absPath, ec);
+    if (ec) {
+        return false;
+    }
+    const uintmax_t size = std::filesystem::file_size(absPath, ec);
+    if (ec) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_fileScanMutex);
+        auto it = g_fileScans.find(absPath);
+        if (it != g_fileScans.end() && it->second.writeTime == writeTime && it->second.size == size) {
+            outScan = it->second;
+            return true;
+        }
+    }
+
+    std::ifstream file(absPath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ShaderFileScan scan;
+    scan.writeTime = writeTime;
+    scan.size = size;
+    scan.contentHash = hashMix(1469598103934665603ull, content.data(), content.size());
+
+    // Match #include "relative/path" (not angle-bracket system includes).
+    static const std::regex includeRegex(R"RE(^\s*#\s*include\s+"([^"]+)")RE");
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::smatch match;
+        if (std::regex_search(line, match, includeRegex)) {
+            scan.includes.push_back(match[1].str());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(g_fileScanMutex);
+    g_fileScans[absPath] = scan;
+    outScan = std::move(scan);
+    return true;
+}
+
 // Scan a shader file for #include "..." directives and recursively collect
 // all transitive dependencies. Returns sorted, deduplicated absolute paths.
 void collectDependenciesRecursive(const std::string& filePath,
@@ -109,29 +189,21 @@ void collectDependenciesRecursive(const std::string& filePath,
     }
     visited.insert(absPath);
 
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    ShaderFileScan scan;
+    if (!scanShaderFile(absPath, scan)) {
         return;
     }
 
-    // Match #include "relative/path" (not angle-bracket system includes).
-    static const std::regex includeRegex(R"RE(^\s*#\s*include\s+"([^"]+)")RE");
-    std::string line;
     std::filesystem::path parentDir = std::filesystem::path(filePath).parent_path();
-
-    while (std::getline(file, line)) {
-        std::smatch match;
-        if (std::regex_search(line, match, includeRegex)) {
-            std::string includePath = match[1].str();
-            // Resolve relative to the including file's directory first.
-            std::filesystem::path resolved = parentDir / includePath;
-            if (!std::filesystem::exists(resolved) && !searchPath.empty()) {
-                // Fall back to the search path.
-                resolved = std::filesystem::path(searchPath) / includePath;
-            }
-            if (std::filesystem::exists(resolved)) {
-                collectDependenciesRecursive(resolved.string(), searchPath, visited);
-            }
+    for (const std::string& includePath : scan.includes) {
+        // Resolve relative to the including file's directory first.
+        std::filesystem::path resolved = parentDir / includePath;
+        if (!std::filesystem::exists(resolved) && !searchPath.empty()) {
+            // Fall back to the search path.
+            resolved = std::filesystem::path(searchPath) / includePath;
+        }
+        if (std::filesystem::exists(resolved)) {
+            collectDependenciesRecursive(resolved.string(), searchPath, visited);
         }
     }
 }
@@ -182,6 +254,17 @@ uint64_t hashMix(uint64_t seed, const void* data, size_t size) {
     return seed;
 }
 
+// Mix a file's content hash into `seed`; unreadable files leave it unchanged.
+uint64_t hashMixFileContents(uint64_t seed, const std::string& path) {
+    std::error_code ec;
+    const std::filesystem::path absPath = std::filesystem::canonical(path, ec);
+    ShaderFileScan scan;
+    if (ec || !scanShaderFile(absPath.string(), scan)) {
+        return seed;
+    }
+    return hashMix(seed, &scan.contentHash, sizeof(scan.contentHash));
+}
+
 // Build a stable 64-bit key from backend + shader file content + entry points +
 // compile options + transitive include dependencies.
 uint64_t computeSpirvCacheKey(RhiBackendType backend,
@@ -203,23 +286,7 @@ uint64_t computeSpirvCacheKey(RhiBackendType backend,
 
     // Hash file content so the cache is invalidated when the source changes.
     // Slang's loadModule expects paths without extension — try .slang first.
-    {
-        std::ifstream file(std::string(shaderPath) + ".slang",
-                           std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
-            file.open(shaderPath, std::ios::binary | std::ios::ate);
-        }
-        if (file.is_open()) {
-            const std::streamsize sz = file.tellg();
-            if (sz > 0) {
-                std::vector<uint8_t> buf(static_cast<size_t>(sz));
-                file.seekg(0, std::ios::beg);
-                if (file.read(reinterpret_cast<char*>(buf.data()), sz)) {
-                    h = hashMix(h, buf.data(), buf.size());
-                }
-            }
-        }
-    }
+    h = hashMixFileContents(h, resolveShaderFilePath(shaderPath));
 
     for (const char* ep : entryPoints) {
         if (ep) {
@@ -229,21 +296,8 @@ uint64_t computeSpirvCacheKey(RhiBackendType backend,
 
     // Hash transitive #include dependencies so edits to shared headers
     // (e.g. bindless_scene.slang, visibility_constants.h) invalidate the cache.
-    {
-        auto deps = collectShaderDependencies(shaderPath, searchPath);
-        for (const auto& depPath : deps) {
-            std::ifstream depFile(depPath, std::ios::binary | std::ios::ate);
-            if (depFile.is_open()) {
-                const std::streamsize sz = depFile.tellg();
-                if (sz > 0) {
-                    std::vector<uint8_t> buf(static_cast<size_t>(sz));
-                    depFile.seekg(0, std::ios::beg);
-                    if (depFile.read(reinterpret_cast<char*>(buf.data()), sz)) {
-                        h = hashMix(h, buf.data(), buf.size());
-                    }
-                }
-            }
-        }
+    for (const auto& depPath : collectShaderDependencies(shaderPath, searchPath)) {
+        h = hashMixFileContents(h, depPath);
     }
 
     // Hash compile options so that debug/release or different defines produce
@@ -266,14 +320,14 @@ uint64_t computeSpirvCacheKey(RhiBackendType backend,
 }
 
 // Returns empty vector if not cached or cache file is missing / invalid.
-std::vector<uint32_t> tryLoadSpirvCache(uint64_t key) {
-    if (g_shaderCacheDir.empty()) {
+std::vector<uint32_t> tryLoadSpirvCache(uint64_t key, const std::string& cacheDir) {
+    if (cacheDir.empty()) {
         return {};
     }
     std::ostringstream oss;
     oss << std::hex << std::setw(16) << std::setfill('0') << key << ".spirv.bin";
     const std::filesystem::path cachePath =
-        std::filesystem::path(g_shaderCacheDir) / oss.str();
+        std::filesystem::path(cacheDir) / oss.str();
 
     std::ifstream in(cachePath, std::ios::binary | std::ios::ate);
     if (!in.is_open()) {
@@ -298,9 +352,9 @@ std::vector<uint32_t> tryLoadSpirvCache(uint64_t key) {
     return words;
 }
 
-// Write SPIR-V words atomically: temp file then rename.
-void writeSpirvCache(uint64_t key, const std::vector<uint32_t>& words) {
-    if (g_shaderCacheDir.empty() || words.empty()) {
+// Write a cache file atomically into g_shaderCacheDir: temp file then rename.
+void writeShaderCacheFile(uint64_t key, const char* suffix, const char* data, size_t size) {
+    if (g_shaderCacheDir.empty() || size == 0) {
         return;
     }
 
@@ -313,7 +367,7 @@ void writeSpirvCache(uint64_t key, const std::vector<uint32_t>& words) {
     }
 
     std::ostringstream oss;
-    oss << std::hex << std::setw(16) << std::setfill('0') << key << ".spirv.bin";
+    oss << std::hex << std::setw(16) << std::setfill('0') << key << suffix;
     const std::filesystem::path cachePath =
         std::filesystem::path(g_shaderCacheDir) / oss.str();
     const std::string tmpPath = cachePath.string() + ".tmp";
@@ -323,8 +377,7 @@ void writeSpirvCache(uint64_t key, const std::vector<uint32_t>& words) {
         spdlog::warn("SlangShaderCache: could not write '{}'", tmpPath);
         return;
     }
-    out.write(reinterpret_cast<const char*>(words.data()),
-              static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+    out.write(data, static_cast<std::streamsize>(size));
     out.close();
 
     std::filesystem::rename(tmpPath, cachePath, ec);
@@ -335,19 +388,43 @@ void writeSpirvCache(uint64_t key, const std::vector<uint32_t>& words) {
     }
 }
 
+void writeSpirvCache(uint64_t key, const std::vector<uint32_t>& words) {
+    writeShaderCacheFile(key, ".spirv.bin", reinterpret_cast<const char*>(words.data()),
+                         words.size() * sizeof(uint32_t));
+}
+
+// --- Generated source cache (Metal path: Slang MSL output keyed like SPIR-V) ---
+
+std::string tryLoadSourceCache(uint64_t key, const std::string& cacheDir) {
+    if (cacheDir.empty()) {
+        return {};
+    }
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << key << ".source.txt";
+    std::ifstream in(std::filesystem::path(cacheDir) / oss.str(), std::ios::binary);
+    if (!in.is_open()) {
+        return {};
+    }
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeSourceCache(uint64_t key, const std::string& source) {
+    writeShaderCacheFile(key, ".source.txt", source.data(), source.size());
+}
+
 // --- Binding-layout companion cache (persists Slang reflection alongside SPIR-V) ---
 
-std::filesystem::path bindingLayoutCachePath(uint64_t key) {
+std::filesystem::path bindingLayoutCachePath(uint64_t key, const std::string& cacheDir) {
     std::ostringstream oss;
     oss << std::hex << std::setw(16) << std::setfill('0') << key << ".layout.bin";
-    return std::filesystem::path(g_shaderCacheDir) / oss.str();
+    return std::filesystem::path(cacheDir) / oss.str();
 }
 
 void writeBindingLayoutCache(uint64_t key, const SlangShaderBindingLayout& layout) {
     if (g_shaderCacheDir.empty()) {
         return;
     }
-    const auto path = bindingLayoutCachePath(key);
+    const auto path = bindingLayoutCachePath(key, g_shaderCacheDir);
     const std::string tmpPath = path.string() + ".tmp";
 
     std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
@@ -380,11 +457,11 @@ void writeBindingLayoutCache(uint64_t key, const SlangShaderBindingLayout& layou
     }
 }
 
-bool tryLoadBindingLayoutCache(uint64_t key, SlangShaderBindingLayout& outLayout) {
-    if (g_shaderCacheDir.empty()) {
+bool tryLoadBindingLayoutCache(uint64_t key, const std::string& cacheDir, SlangShaderBindingLayout& outLayout) {
+    if (cacheDir.empty()) {
         return false;
     }
-    const auto path = bindingLayoutCachePath(key);
+    const auto path = bindingLayoutCachePath(key, cacheDir);
     std::ifstream in(path, std::ios::binary);
     if (!in.is_open()) {
         return false;
@@ -791,24 +868,16 @@ void logDiagnostics(const char* prefix, const char* shaderPath, slang::IBlob* di
     recordDiagnostic(prefix, shaderPath, message ? message : "");
 }
 
-bool createSession(const SlangTargetConfig& targetConfig,
+bool createSession(slang::IGlobalSession* globalSession,
+                   const SlangTargetConfig& targetConfig,
                    const char* shaderPath,
                    const char* searchPath,
                    const SlangCompileOptions* options,
-                   Slang::ComPtr<slang::IGlobalSession>& outGlobalSession,
                    Slang::ComPtr<slang::ISession>& outSession) {
-    if (SLANG_FAILED(slang::createGlobalSession(outGlobalSession.writeRef()))) {
-        spdlog::error("Slang: failed to create global session for {}", shaderPath);
-        recordDiagnostic("Slang global session error",
-                         shaderPath,
-                         "Failed to create Slang global session");
-        return false;
-    }
-
     slang::SessionDesc sessionDesc = {};
     slang::TargetDesc targetDesc = {};
     targetDesc.format = targetConfig.format;
-    targetDesc.profile = outGlobalSession->findProfile(targetConfig.profile);
+    targetDesc.profile = globalSession->findProfile(targetConfig.profile);
 
     // Apply optimization level.
     std::vector<slang::CompilerOptionEntry> compilerOptions;
@@ -841,8 +910,11 @@ bool createSession(const SlangTargetConfig& targetConfig,
 
     // Apply preprocessor defines.
     std::vector<slang::PreprocessorMacroDesc> macros;
+    if (targetConfig.format == SLANG_METAL) {
+        macros.push_back({"METALLIC_METAL_ARGUMENT_BUFFERS", "1"});
+    }
     if (options) {
-        macros.reserve(options->defines.size());
+        macros.reserve(macros.size() + options->defines.size());
         for (const auto& [key, value] : options->defines) {
             slang::PreprocessorMacroDesc macro;
             macro.name = key.c_str();
@@ -855,7 +927,7 @@ bool createSession(const SlangTargetConfig& targetConfig,
         sessionDesc.preprocessorMacroCount = static_cast<SlangInt>(macros.size());
     }
 
-    if (SLANG_FAILED(outGlobalSession->createSession(sessionDesc, outSession.writeRef()))) {
+    if (SLANG_FAILED(globalSession->createSession(sessionDesc, outSession.writeRef()))) {
         spdlog::error("Slang: failed to create {} session for {}",
                       targetConfig.backendLabel,
                       shaderPath);
@@ -868,6 +940,133 @@ bool createSession(const SlangTargetConfig& targetConfig,
     return true;
 }
 
+// --- Session pool ---
+//
+// Creating a global session reloads Slang's core module, which dominates the
+// cost of small compiles. Global sessions and their sessions are single-threaded,
+// so each parallel compile leases a whole SlangSessionContext and returns it when
+// done; the pool grows to the number of concurrent compiles and lives for the
+// process. Each context keeps one session per target/search path/options, and a
+// session keeps every module it loaded, so recompiling another entry point of
+// the same file skips the parse.
+
+struct PooledSlangSession {
+    Slang::ComPtr<slang::ISession> session;
+    // Shader file plus transitive includes, hashed when the module was loaded.
+    std::unordered_map<std::string, uint64_t> moduleSourceHashes;
+};
+
+struct SlangSessionContext {
+    Slang::ComPtr<slang::IGlobalSession> globalSession;
+    std::unordered_map<uint64_t, PooledSlangSession> sessions;
+};
+
+std::mutex g_sessionPoolMutex;
+std::vector<std::unique_ptr<SlangSessionContext>> g_idleSessionContexts;
+
+class SlangSessionLease {
+public:
+    SlangSessionLease() {
+        {
+            std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+            if (!g_idleSessionContexts.empty()) {
+                m_context = std::move(g_idleSessionContexts.back());
+                g_idleSessionContexts.pop_back();
+            }
+        }
+        if (!m_context) {
+            m_context = std::make_unique<SlangSessionContext>();
+        }
+    }
+
+    ~SlangSessionLease() {
+        // A context whose global session failed to create is not worth keeping.
+        if (!m_context->globalSession) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+        g_idleSessionContexts.push_back(std::move(m_context));
+    }
+
+    SlangSessionLease(const SlangSessionLease&) = delete;
+    SlangSessionLease& operator=(const SlangSessionLease&) = delete;
+
+    SlangSessionContext& context() { return *m_context; }
+
+private:
+    std::unique_ptr<SlangSessionContext> m_context;
+};
+
+uint64_t computeSessionKey(const SlangTargetConfig& targetConfig,
+                           const char* searchPath,
+                           const SlangCompileOptions* options) {
+    constexpr uint64_t kOffsetBasis = 1469598103934665603ull;
+    uint64_t h = kOffsetBasis;
+    const auto format = static_cast<uint32_t>(targetConfig.format);
+    h = hashMix(h, &format, sizeof(format));
+    if (targetConfig.profile) {
+        h = hashMix(h, targetConfig.profile, std::strlen(targetConfig.profile) + 1);
+    }
+    if (searchPath) {
+        h = hashMix(h, searchPath, std::strlen(searchPath) + 1);
+    }
+    if (options) {
+        const uint8_t optFlags = (options->optimized ? 1u : 0u) |
+                                 (options->generateDebugInfo ? 2u : 0u);
+        h = hashMix(h, &optFlags, sizeof(optFlags));
+        for (const auto& [key, value] : options->defines) {
+            h = hashMix(h, key.c_str(), key.size() + 1);
+            h = hashMix(h, value.c_str(), value.size() + 1);
+        }
+    }
+    return h;
+}
+
+uint64_t computeModuleSourceHash(const char* shaderPath, const char* searchPath) {
+    constexpr uint64_t kOffsetBasis = 1469598103934665603ull;
+    uint64_t h = hashMixFileContents(kOffsetBasis, resolveShaderFilePath(shaderPath));
+    for (const auto& depPath : collectShaderDependencies(shaderPath, searchPath)) {
+        h = hashMixFileContents(h, depPath);
+    }
+    return h;
+}
+
+// Returns the context's session for this configuration, creating the global
+// session and the session as needed. Slang cannot unload a module, so a session
+// that loaded `shaderPath` from sources that have since changed is replaced.
+PooledSlangSession* acquirePooledSession(SlangSessionContext& context,
+                                         const SlangTargetConfig& targetConfig,
+                                         const char* shaderPath,
+                                         const char* searchPath,
+                                         const SlangCompileOptions* options,
+                                         uint64_t moduleSourceHash,
+                                         uint64_t& outSessionKey) {
+    if (!context.globalSession &&
+        SLANG_FAILED(slang::createGlobalSession(context.globalSession.writeRef()))) {
+        spdlog::error("Slang: failed to create global session for {}", shaderPath);
+        recordDiagnostic("Slang global session error",
+                         shaderPath,
+                         "Failed to create Slang global session");
+        return nullptr;
+    }
+
+    outSessionKey = computeSessionKey(targetConfig, searchPath, options);
+    auto it = context.sessions.find(outSessionKey);
+    if (it != context.sessions.end()) {
+        auto moduleIt = it->second.moduleSourceHashes.find(shaderPath);
+        if (moduleIt == it->second.moduleSourceHashes.end() || moduleIt->second == moduleSourceHash) {
+            return &it->second;
+        }
+        context.sessions.erase(it);
+    }
+
+    PooledSlangSession pooled;
+    if (!createSession(context.globalSession, targetConfig, shaderPath, searchPath, options, pooled.session)) {
+        return nullptr;
+    }
+    return &context.sessions.emplace(outSessionKey, std::move(pooled)).first->second;
+}
+
 slang::IModule* loadModule(slang::ISession* session,
                            const char* shaderPath,
                            const char* searchPath,
@@ -930,28 +1129,153 @@ bool buildLinkedProgram(slang::ISession* session,
     return true;
 }
 
+// Pins the bindless scene argument buffer (bindless_scene.slang) to the slot
+// MetalBindlessSceneTable binds on every encoder.
+std::string patchBindlessSceneMetalSource(const std::string& source) {
+    static const std::string kSlot =
+        "[[buffer(" + std::to_string(METALLIC_METAL_BINDLESS_BUFFER_INDEX) + ")]]";
+    return std::regex_replace(source,
+        std::regex(R"((\*\s*bindlessScene\w*)\s*\[\[buffer\(\d+\)\]\])"),
+        "$1 " + kSlot);
+}
+
+// MSL spelling of a scalar or vector varying type; empty for anything else.
+std::string metalVaryingTypeName(slang::TypeReflection* type) {
+    if (!type) {
+        return {};
+    }
+    const char* scalar = nullptr;
+    switch (type->getScalarType()) {
+    case slang::TypeReflection::ScalarType::Float32: scalar = "float"; break;
+    case slang::TypeReflection::ScalarType::Float16: scalar = "half"; break;
+    case slang::TypeReflection::ScalarType::UInt32: scalar = "uint"; break;
+    case slang::TypeReflection::ScalarType::Int32: scalar = "int"; break;
+    default: return {};
+    }
+    if (type->getKind() == slang::TypeReflection::Kind::Scalar) {
+        return scalar;
+    }
+    if (type->getKind() == slang::TypeReflection::Kind::Vector) {
+        return std::string(scalar) + std::to_string(type->getElementCount());
+    }
+    return {};
+}
+
+struct MetalVarying {
+    std::string typeName;
+    std::string fieldName;
+    std::string userName; // TEXCOORD1 -> TEXCOORD_1, index 0 drops the suffix
+};
+
+// Reflects the user varyings of every mesh entry point's vertex and primitive
+// outputs. Slang's MSL leaves them without [[user(...)]] attributes, so the
+// fragment stage cannot link against them; the semantics say what to add.
+std::vector<MetalVarying> collectMeshVaryings(slang::IComponentType* linkedProgram) {
+    std::vector<MetalVarying> varyings;
+    Slang::ComPtr<slang::IBlob> diagnostics;
+    slang::ProgramLayout* reflection = linkedProgram->getLayout(0, diagnostics.writeRef());
+    if (!reflection) {
+        return varyings;
+    }
+
+    for (SlangUInt entryIndex = 0; entryIndex < reflection->getEntryPointCount(); ++entryIndex) {
+        slang::EntryPointReflection* entryPoint = reflection->getEntryPointByIndex(entryIndex);
+        if (!entryPoint || entryPoint->getStage() != SLANG_STAGE_MESH) {
+            continue;
+        }
+        for (unsigned paramIndex = 0; paramIndex < entryPoint->getParameterCount(); ++paramIndex) {
+            slang::VariableLayoutReflection* param = entryPoint->getParameterByIndex(paramIndex);
+            slang::TypeLayoutReflection* typeLayout = param ? param->getTypeLayout() : nullptr;
+            // Output arrays and mesh output wrappers: descend to the element struct.
+            while (typeLayout && typeLayout->getKind() != slang::TypeReflection::Kind::Struct &&
+                   typeLayout->getElementTypeLayout()) {
+                typeLayout = typeLayout->getElementTypeLayout();
+            }
+            if (!typeLayout || typeLayout->getKind() != slang::TypeReflection::Kind::Struct) {
+                continue;
+            }
+            for (unsigned fieldIndex = 0; fieldIndex < typeLayout->getFieldCount(); ++fieldIndex) {
+                slang::VariableLayoutReflection* field = typeLayout->getFieldByIndex(fieldIndex);
+                const char* semantic = field ? field->getSemanticName() : nullptr;
+                if (!semantic || !field->getName() || std::strncmp(semantic, "SV_", 3) == 0) {
+                    continue;
+                }
+                MetalVarying varying;
+                varying.typeName = metalVaryingTypeName(field->getType());
+                if (varying.typeName.empty()) {
+                    continue;
+                }
+                varying.fieldName = field->getName();
+                varying.userName = semantic;
+                if (const size_t semanticIndex = field->getSemanticIndex(); semanticIndex != 0) {
+                    varying.userName += "_" + std::to_string(semanticIndex);
+                }
+                varyings.push_back(std::move(varying));
+            }
+        }
+    }
+    return varyings;
+}
+
+// Metal differences Slang's output does not cover yet, derived from the linked
+// program rather than from which pipeline asked: the bindless slot, and the
+// user attributes mesh varyings need. Runs before the source is cached.
+std::string adaptMetalSource(std::string source, slang::IComponentType* linkedProgram) {
+    for (const MetalVarying& varying : collectMeshVaryings(linkedProgram)) {
+        source = std::regex_replace(source,
+            std::regex("(\\b" + varying.typeName + "\\s+\\w*" + varying.fieldName + "\\w*)\\s*;"),
+            "$1 [[user(" + varying.userName + ")]];");
+    }
+    return patchBindlessSceneMetalSource(source);
+}
+
 std::string compileSlangComponentToSource(RhiBackendType backend,
                                           const char* shaderPath,
                                           const char* searchPath,
                                           const std::vector<const char*>& entryPoints,
                                           const char* label,
                                           const SlangCompileOptions* options) {
+    // Source output shares the SPIR-V cache key; the backend is part of it and the
+    // file suffix keeps the two kinds apart.
+    const uint64_t cacheKey = computeSpirvCacheKey(backend, shaderPath, searchPath, entryPoints, options);
+    for (const std::string* cacheDir : {&g_shaderCacheDir, &g_prebuiltShaderCacheDir}) {
+        std::string cached = tryLoadSourceCache(cacheKey, *cacheDir);
+        if (!cached.empty()) {
+            spdlog::debug("SlangShaderCache: source cache hit for '{}' in '{}'", shaderPath, *cacheDir);
+            std::lock_guard<std::mutex> lock(g_compileStatsMutex);
+            g_compileStats.cacheHits++;
+            return cached;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_compileStatsMutex);
+        g_compileStats.cacheMisses++;
+    }
+
     SlangTargetConfig targetConfig;
     if (!resolveSlangTarget(backend, SlangOutputKind::SourceText, targetConfig)) {
         return {};
     }
 
-    Slang::ComPtr<slang::IGlobalSession> globalSession;
-    Slang::ComPtr<slang::ISession> session;
-    if (!createSession(targetConfig, shaderPath, searchPath, options, globalSession, session)) {
+    const uint64_t moduleSourceHash = computeModuleSourceHash(shaderPath, searchPath);
+    SlangSessionLease lease;
+    uint64_t sessionKey = 0;
+    PooledSlangSession* pooled = acquirePooledSession(
+        lease.context(), targetConfig, shaderPath, searchPath, options, moduleSourceHash, sessionKey);
+    if (!pooled) {
         return {};
     }
+    slang::ISession* session = pooled->session;
 
     Slang::ComPtr<slang::IBlob> diagnostics;
     slang::IModule* module = loadModule(session, shaderPath, searchPath, label, diagnostics);
     if (!module) {
+        // Start the next attempt from a clean session rather than whatever the
+        // failed load left behind.
+        lease.context().sessions.erase(sessionKey);
         return {};
     }
+    pooled->moduleSourceHashes[shaderPath] = moduleSourceHash;
 
     Slang::ComPtr<slang::IComponentType> linkedProgram;
     if (!buildLinkedProgram(session, module, entryPoints, shaderPath, diagnostics, linkedProgram)) {
@@ -964,8 +1288,13 @@ std::string compileSlangComponentToSource(RhiBackendType backend,
         return {};
     }
 
-    return std::string(static_cast<const char*>(sourceCode->getBufferPointer()),
+    std::string source(static_cast<const char*>(sourceCode->getBufferPointer()),
                        sourceCode->getBufferSize());
+    if (backend == RhiBackendType::Metal) {
+        source = adaptMetalSource(std::move(source), linkedProgram);
+    }
+    writeSourceCache(cacheKey, source);
+    return source;
 }
 
 std::vector<uint32_t> compileSlangComponentToBinary(RhiBackendType backend,
@@ -974,17 +1303,19 @@ std::vector<uint32_t> compileSlangComponentToBinary(RhiBackendType backend,
                                                     const std::vector<const char*>& entryPoints,
                                                     const char* label,
                                                     const SlangCompileOptions* options) {
-    // Check the on-disk SPIR-V cache before invoking Slang.
+    // Check the on-disk SPIR-V cache, then the shipped archive, before invoking
+    // Slang. SPIR-V and its layout always come from the same directory.
     const uint64_t cacheKey = computeSpirvCacheKey(backend, shaderPath, searchPath, entryPoints, options);
-    {
-        std::vector<uint32_t> cached = tryLoadSpirvCache(cacheKey);
+    for (const std::string* cacheDir : {&g_shaderCacheDir, &g_prebuiltShaderCacheDir}) {
+        std::vector<uint32_t> cached = tryLoadSpirvCache(cacheKey, *cacheDir);
         if (!cached.empty()) {
             SlangShaderBindingLayout layout;
-            if (tryLoadBindingLayoutCache(cacheKey, layout)) {
-                if (stripSpuriousGeometryCapability(cached, shaderPath)) {
+            if (tryLoadBindingLayoutCache(cacheKey, *cacheDir, layout)) {
+                if (stripSpuriousGeometryCapability(cached, shaderPath) && cacheDir == &g_shaderCacheDir) {
                     writeSpirvCache(cacheKey, cached);
                 }
-                spdlog::debug("SlangShaderCache: cache hit for '{}' ({} words)", shaderPath, cached.size());
+                spdlog::debug("SlangShaderCache: cache hit for '{}' ({} words) in '{}'",
+                              shaderPath, cached.size(), *cacheDir);
                 // Restore the binding layout into the in-memory cache so that
                 // findSlangBindingLayoutForBinary() succeeds for callers.
                 cacheBindingLayout(cached.data(), cached.size() * sizeof(uint32_t), layout);
@@ -1015,17 +1346,25 @@ std::vector<uint32_t> compileSlangComponentToBinary(RhiBackendType backend,
         return {};
     }
 
-    Slang::ComPtr<slang::IGlobalSession> globalSession;
-    Slang::ComPtr<slang::ISession> session;
-    if (!createSession(targetConfig, shaderPath, searchPath, options, globalSession, session)) {
+    const uint64_t moduleSourceHash = computeModuleSourceHash(shaderPath, searchPath);
+    SlangSessionLease lease;
+    uint64_t sessionKey = 0;
+    PooledSlangSession* pooled = acquirePooledSession(
+        lease.context(), targetConfig, shaderPath, searchPath, options, moduleSourceHash, sessionKey);
+    if (!pooled) {
         return {};
     }
+    slang::ISession* session = pooled->session;
 
     Slang::ComPtr<slang::IBlob> diagnostics;
     slang::IModule* module = loadModule(session, shaderPath, searchPath, label, diagnostics);
     if (!module) {
+        // Start the next attempt from a clean session rather than whatever the
+        // failed load left behind.
+        lease.context().sessions.erase(sessionKey);
         return {};
     }
+    pooled->moduleSourceHashes[shaderPath] = moduleSourceHash;
 
     Slang::ComPtr<slang::IComponentType> linkedProgram;
     if (!buildLinkedProgram(session, module, entryPoints, shaderPath, diagnostics, linkedProgram)) {
@@ -1076,70 +1415,37 @@ std::vector<uint32_t> compileSlangComponentToBinary(RhiBackendType backend,
     return words;
 }
 
-std::string patchMeshMetalSource(const std::string& source) {
-    std::string patched = source;
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((float3\s+\w*viewNormal\w*)\s*;)"),
-        "$1 [[user(NORMAL)]];");
-    patched = std::regex_replace(patched,
-        std::regex(R"((float3\s+\w*viewPos\w*)\s*;)"),
-        "$1 [[user(TEXCOORD)]];");
-    patched = std::regex_replace(patched,
-        std::regex(R"((float2\s+\w*uv\w*)\s*;)"),
-        "$1 [[user(TEXCOORD_1)]];");
-    patched = std::regex_replace(patched,
-        std::regex(R"((\[\[flat\]\]\s+uint\s+\w*materialID\w*)\s*;)"),
-        "$1 [[user(TEXCOORD_2)]];");
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((array<texture2d<float,\s*access::sample>,\s*int\(\d+\)>\s+\w+))"),
-        "$1 [[texture(0)]]");
-
-    return patched;
-}
-
-std::string patchVisibilityMetalSource(const std::string& source) {
-    std::string patched = source;
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((float2\s+\w*uv\w*)\s*;)"),
-        "$1 [[user(TEXCOORD)]];");
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((uint\s+\w*visibility\w*)\s*;)"),
-        "$1 [[user(TEXCOORD_1)]];");
-    patched = std::regex_replace(patched,
-        std::regex(R"((uint\s+\w*materialID\w*)\s*;)"),
-        "$1 [[user(TEXCOORD_2)]];");
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((array<texture2d<float,\s*access::sample>,\s*int\(\d+\)>\s+\w+))"),
-        "$1 [[texture(0)]]");
-
-    return patched;
-}
-
-std::string patchComputeMetalSource(const std::string& source) {
-    std::string patched = source;
-
-    patched = std::regex_replace(patched,
-        std::regex(R"((array<texture2d<float,\s*access::sample>,\s*int\(\d+\)>\s+\w+)(\s*,))"),
-        "$1 [[texture(3)]]$2");
-
-    return patched;
-}
-
 } // namespace
 
 void setSlangShaderCacheDir(const std::string& dir) {
     g_shaderCacheDir = dir;
 }
 
+void setSlangPrebuiltShaderCacheDir(const std::string& dir) {
+    g_prebuiltShaderCacheDir = dir;
+}
+
 void setSlangCompileCallback(SlangCompileCallback callback) {
     g_compileCallback = std::move(callback);
 }
 
+std::vector<std::string> collectSlangShaderFiles(const char* shaderPath, const char* searchPath) {
+    if (!shaderPath) {
+        return {};
+    }
+    std::string rootFile = resolveShaderFilePath(shaderPath);
+    if (rootFile.empty() && searchPath) {
+        rootFile = resolveShaderFilePath((std::filesystem::path(searchPath) / shaderPath).string());
+    }
+    if (rootFile.empty()) {
+        return {};
+    }
+
+    std::set<std::string> visited;
+    collectDependenciesRecursive(rootFile, searchPath ? searchPath : "", visited);
+    return {visited.begin(), visited.end()};
+}
+
 std::string compileSlangGraphicsSource(RhiBackendType backend,
                                        const char* shaderPath,
                                        const char* searchPath,
@@ -1214,6 +1520,19 @@ std::vector<uint32_t> compileSlangComputeBinary(RhiBackendType backend,
                                          options);
 }
 
+std::vector<uint32_t> compileSlangRayTracingBinary(RhiBackendType backend,
+                                                   const char* shaderPath,
+                                                   const char* searchPath,
+                                                   const std::vector<const char*>& entryPoints,
+                                                   const SlangCompileOptions* options) {
+    return compileSlangComponentToBinary(backend,
+                                         shaderPath,
+                                         searchPath,
+                                         entryPoints,
+                                         "raytracing",
+                                         options);
+}
+
 bool findSlangBindingLayoutForBinary(const void* data,
                                      size_t size,
                                      SlangShaderBindingLayout& outLayout) {
@@ -1231,21 +1550,29 @@ bool findSlangBindingLayoutForBinary(const void* data,
     return true;
 }
 
-std::string patchMeshShaderSource(RhiBackendType backend, const std::string& source) {
-    return backend == RhiBackendType::Metal ? patchMeshMetalSource(source) : source;
+
+std::vector<SlangDiagnosticRecord> getRecentSlangDiagnostics() {
+    std::scoped_lock lock(g_recentDiagnosticsMutex);
+    return g_recentDiagnostics;
 }
 
-std::string patchVisibilityShaderSource(RhiBackendType backend, const std::string& source) {
-    return backend == RhiBackendType::Metal ? patchVisibilityMetalSource(source) : source;
+SlangDiagnosticCapture::SlangDiagnosticCapture() : m_previous(t_diagnosticCapture) {
+    t_diagnosticCapture = this;
 }
 
-std::string patchComputeShaderSource(RhiBackendType backend, const std::string& source) {
-    return backend == RhiBackendType::Metal ? patchComputeMetalSource(source) : source;
+SlangDiagnosticCapture::~SlangDiagnosticCapture() {
+    t_diagnosticCapture = m_previous;
+    publishSlangDiagnostics(take());
 }
 
-std::vector<SlangDiagnosticRecord> getRecentSlangDiagnostics() {
-    std::scoped_lock lock(g_recentDiagnosticsMutex);
-    return g_recentDiagnostics;
+void publishSlangDiagnostics(std::vector<SlangDiagnosticRecord> records) {
+    for (SlangDiagnosticRecord& record : records) {
+        if (t_diagnosticCapture) {
+            t_diagnosticCapture->add(std::move(record));
+        } else {
+            appendRecentDiagnostic(std::move(record));
+        }
+    }
 }
 
 void clearRecentSlangDiagnostics() {
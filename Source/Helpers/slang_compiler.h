@@ -17,7 +17,8 @@ struct SlangCompileOptions {
 };
 
 // Backend-aware Slang compilation helpers.
-// Source output is currently used by the Metal path.
+// Source output is currently used by the Metal path; it is returned already adapted
+// to the Metal bindings and mesh varyings the runtime expects.
 // SPIR-V output is currently used by the Vulkan path.
 
 std::string compileSlangGraphicsSource(RhiBackendType backend,
@@ -47,6 +48,13 @@ std::vector<uint32_t> compileSlangComputeBinary(RhiBackendType backend,
                                                 const char* searchPath = nullptr,
                                                 const char* entryPoint = "computeMain",
                                                 const SlangCompileOptions* options = nullptr);
+// Ray generation, miss and hit entry points linked into one module for
+// RhiContext::createRayTracingPipelineFromSource.
+std::vector<uint32_t> compileSlangRayTracingBinary(RhiBackendType backend,
+                                                   const char* shaderPath,
+                                                   const char* searchPath,
+                                                   const std::vector<const char*>& entryPoints,
+                                                   const SlangCompileOptions* options = nullptr);
 
 struct SlangDiagnosticRecord {
     std::string stage;
@@ -57,6 +65,29 @@ struct SlangDiagnosticRecord {
 std::vector<SlangDiagnosticRecord> getRecentSlangDiagnostics();
 void clearRecentSlangDiagnostics();
 
+// Holds back the diagnostics compiles on this thread record while the scope is
+// alive. Parallel builds capture one scope per job and publish them in job order,
+// so getRecentSlangDiagnostics does not depend on which worker finished first.
+// Records still held when the scope ends go to the enclosing scope or the recent list.
+class SlangDiagnosticCapture {
+public:
+    SlangDiagnosticCapture();
+    ~SlangDiagnosticCapture();
+
+    SlangDiagnosticCapture(const SlangDiagnosticCapture&) = delete;
+    SlangDiagnosticCapture& operator=(const SlangDiagnosticCapture&) = delete;
+
+    void add(SlangDiagnosticRecord record) { m_records.push_back(std::move(record)); }
+    std::vector<SlangDiagnosticRecord> take() { return std::move(m_records); }
+
+private:
+    SlangDiagnosticCapture* m_previous = nullptr;
+    std::vector<SlangDiagnosticRecord> m_records;
+};
+
+// Adds records to the recent diagnostics, or to the thread's capture scope.
+void publishSlangDiagnostics(std::vector<SlangDiagnosticRecord> records);
+
 enum class SlangShaderBindingType : uint8_t {
     UniformBuffer,
     StorageBuffer,
@@ -83,15 +114,20 @@ bool findSlangBindingLayoutForBinary(const void* data,
                                      size_t size,
                                      SlangShaderBindingLayout& outLayout);
 
-// Backend-specific Slang output workarounds.
-std::string patchMeshShaderSource(RhiBackendType backend, const std::string& source);
-std::string patchVisibilityShaderSource(RhiBackendType backend, const std::string& source);
-std::string patchComputeShaderSource(RhiBackendType backend, const std::string& source);
+// A shader file and its transitive #include dependencies as canonical paths,
+// for hot-reload watching. Relative paths resolve against the working directory,
+// then searchPath. Empty when the shader file is missing.
+std::vector<std::string> collectSlangShaderFiles(const char* shaderPath, const char* searchPath);
 
-// Set the directory used to cache compiled SPIR-V binaries between runs.
+// Set the directory used to cache compiled SPIR-V binaries (and generated MSL on Metal) between runs.
 // Must be called before any compileSlang*Binary calls. Empty string disables the cache.
 void setSlangShaderCacheDir(const std::string& dir);
 
+// Set a read-only directory of prebuilt SPIR-V (see MetallicShaderBake) that is
+// searched after the writable cache misses. Entries use the same keys, so an
+// archive only hits when shader sources, defines and options match the bake.
+void setSlangPrebuiltShaderCacheDir(const std::string& dir);
+
 // Callback invoked after every successful SPIR-V compilation (including cache hits).
 // Parameters: source file path, SPIR-V data pointer, SPIR-V size in bytes.
 using SlangCompileCallback = std::function<void(const char* sourcePath, const uint32_t* spirvData, size_t spirvSizeBytes)>;
@@ -0,0 +1,193 @@
+#include "startup_profile.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace StartupProfile {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseRecord {
+    const char* name = nullptr;
+    Clock::time_point start;
+    Clock::time_point end;
+    uint32_t depth = 0u;
+    uint8_t cacheState = 0u;
+};
+
+struct CacheCounts {
+    uint64_t hits = 0u;
+    uint64_t misses = 0u;
+};
+
+std::atomic<bool> g_recording{true};
+std::mutex g_mutex;
+Clock::time_point g_begin = Clock::now();
+std::vector<PhaseRecord> g_phases;
+std::map<std::string, CacheCounts> g_caches;
+// Nesting is tracked per thread; phases on workers start again at depth 0.
+thread_local uint32_t t_depth = 0u;
+
+double millisecondsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+void begin() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_begin = Clock::now();
+    g_phases.clear();
+    g_caches.clear();
+    g_recording.store(true, std::memory_order_relaxed);
+}
+
+void recordCache(const char* cache, bool hit) {
+    addCacheCounts(cache, hit ? 1u : 0u, hit ? 0u : 1u);
+}
+
+void addCacheCounts(const char* cache, uint64_t hits, uint64_t misses) {
+    if (!g_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    CacheCounts& counts = g_caches[cache];
+    counts.hits += hits;
+    counts.misses += misses;
+}
+
+Phase::Phase(const char* name) {
+    if (!g_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    m_name = name;
+    m_depth = t_depth++;
+    m_start = Clock::now();
+}
+
+Phase::~Phase() {
+    if (!m_name) {
+        return;
+    }
+    const Clock::time_point end = Clock::now();
+    --t_depth;
+    if (!g_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_phases.push_back(PhaseRecord{m_name, m_start, end, m_depth, m_cacheState});
+}
+
+void finish(const std::string& reportPath) {
+    if (!g_recording.exchange(false)) {
+        return;
+    }
+    const Clock::time_point end = Clock::now();
+
+    struct PhaseSummary {
+        std::string name;
+        uint32_t depth = 0u;
+        uint32_t calls = 0u;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        Clock::time_point firstStart = Clock::time_point::max();
+        Clock::time_point lastEnd = Clock::time_point::min();
+        uint32_t cacheHits = 0u;
+        uint32_t cacheMisses = 0u;
+    };
+    std::vector<PhaseSummary> summaries;
+    std::map<std::string, CacheCounts> caches;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::map<std::string, size_t> indexByName;
+        for (const PhaseRecord& record : g_phases) {
+            auto [it, inserted] = indexByName.try_emplace(record.name, summaries.size());
+            if (inserted) {
+                summaries.emplace_back().name = record.name;
+                summaries.back().depth = record.depth;
+            }
+            PhaseSummary& summary = summaries[it->second];
+            const double ms = millisecondsBetween(record.start, record.end);
+            ++summary.calls;
+            summary.totalMs += ms;
+            summary.maxMs = std::max(summary.maxMs, ms);
+            summary.depth = std::min(summary.depth, record.depth);
+            summary.firstStart = std::min(summary.firstStart, record.start);
+            summary.lastEnd = std::max(summary.lastEnd, record.end);
+            summary.cacheHits += record.cacheState == 1u ? 1u : 0u;
+            summary.cacheMisses += record.cacheState == 2u ? 1u : 0u;
+        }
+        caches = g_caches;
+    }
+    std::sort(summaries.begin(), summaries.end(), [](const PhaseSummary& a, const PhaseSummary& b) {
+        return a.firstStart < b.firstStart;
+    });
+
+    const double totalMs = millisecondsBetween(g_begin, end);
+    spdlog::info("Startup took {:.1f} ms:", totalMs);
+    nlohmann::json phases = nlohmann::json::array();
+    for (const PhaseSummary& summary : summaries) {
+        const double wallMs = millisecondsBetween(summary.firstStart, summary.lastEnd);
+        std::string cache;
+        if (summary.cacheHits + summary.cacheMisses > 0u) {
+            cache = summary.cacheMisses == 0u ? " [cache hit]"
+                  : summary.cacheHits == 0u   ? " [cache miss]"
+                                              : " [cache " + std::to_string(summary.cacheHits) + "/" +
+                                                    std::to_string(summary.cacheHits + summary.cacheMisses) + " hits]";
+        }
+        if (summary.calls > 1u) {
+            spdlog::info("  {:{}}{:<{}} {:9.1f} ms wall, {:9.1f} ms in {} calls{}", "", summary.depth * 2u,
+                         summary.name, 36u - std::min(summary.depth * 2u, 30u), wallMs, summary.totalMs,
+                         summary.calls, cache);
+        } else {
+            spdlog::info("  {:{}}{:<{}} {:9.1f} ms{}", "", summary.depth * 2u, summary.name,
+                         36u - std::min(summary.depth * 2u, 30u), wallMs, cache);
+        }
+        nlohmann::json phase{
+            {"name", summary.name},
+            {"depth", summary.depth},
+            {"startMs", millisecondsBetween(g_begin, summary.firstStart)},
+            {"wallMs", wallMs},
+            {"totalMs", summary.totalMs},
+            {"maxMs", summary.maxMs},
+            {"calls", summary.calls},
+        };
+        if (summary.cacheHits + summary.cacheMisses > 0u) {
+            phase["cacheHits"] = summary.cacheHits;
+            phase["cacheMisses"] = summary.cacheMisses;
+        }
+        phases.push_back(std::move(phase));
+    }
+    nlohmann::json cacheJson = nlohmann::json::object();
+    for (const auto& [name, counts] : caches) {
+        spdlog::info("  {} cache: {} hits, {} misses", name, counts.hits, counts.misses);
+        cacheJson[name] = {{"hits", counts.hits}, {"misses", counts.misses}};
+    }
+
+    if (reportPath.empty()) {
+        return;
+    }
+    std::error_code error;
+    const std::filesystem::path parent = std::filesystem::path(reportPath).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+    std::ofstream report(reportPath, std::ios::trunc);
+    if (!report) {
+        spdlog::warn("Failed to write startup profile {}", reportPath);
+        return;
+    }
+    report << nlohmann::json{{"totalMs", totalMs}, {"phases", phases}, {"caches", cacheJson}}.dump(2);
+}
+
+} // namespace StartupProfile
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Wall-clock breakdown of startup: scoped phases (scene load, asset builds, shader
+// compiles, BLAS builds) plus cache hit/miss counts, from begin() until finish()
+// logs the summary and writes the JSON report. Phases may run on worker threads;
+// a phase entered several times is reported with its call count, summed time and
+// the wall time from its first start to its last end. Recording stops at finish(),
+// so later reloads do not show up.
+namespace StartupProfile {
+
+void begin();
+
+// Tallies a cache lookup, e.g. recordCache("meshlets", true) for a meshlet cache hit.
+void recordCache(const char* cache, bool hit);
+void addCacheCounts(const char* cache, uint64_t hits, uint64_t misses);
+
+// Empty reportPath only logs the summary.
+void finish(const std::string& reportPath);
+
+class Phase {
+public:
+    // name must outlive the profile, normally a string literal.
+    explicit Phase(const char* name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+    // Marks the phase as served from (or missing) its cache.
+    void setCacheHit(bool hit) { m_cacheState = hit ? 1 : 2; }
+
+private:
+    const char* m_name = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+    uint32_t m_depth = 0u;
+    uint8_t m_cacheState = 0u;
+};
+
+} // namespace StartupProfile
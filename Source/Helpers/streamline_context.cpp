@@ -1,6 +1,7 @@
 #ifdef _WIN32
 
 #include "streamline_context.h"
+#include "frame_context.h"
 #include "vulkan_resource_handles.h"
 #include "vulkan_resource_state_tracker.h"
 #include <spdlog/spdlog.h>
@@ -11,6 +12,9 @@
 #include <vulkan/vulkan.h>
 #include <sl.h>
 #include <sl_dlss.h>
+#include <sl_dlss_g.h>
+#include <sl_reflex.h>
+#include <sl_pcl.h>
 #include <sl_helpers_vk.h>
 #include <sl_consts.h>
 #include <string_view>
@@ -21,6 +25,15 @@
 static constexpr uint64_t kSlSdkVersion = sl::kSDKVersion;
 static constexpr uint32_t kDefaultViewportId = 0;
 
+// Frame Generation and Reflex are optional; each is checked on its own after
+// device creation and the rest keeps working without it.
+static const sl::Feature kSlFeatures[] = {
+    sl::kFeatureDLSS,
+    sl::kFeatureDLSS_G,
+    sl::kFeatureReflex,
+    sl::kFeaturePCL,
+};
+
 static void slLogCallback(sl::LogType type, const char* msg) {
     switch (type) {
     case sl::LogType::eInfo:  spdlog::info("[Streamline] {}", msg); break;
@@ -132,9 +145,9 @@ static VkImageLayout getTrackedLayout(const VulkanResourceStateTracker* tracker,
                                       const RhiTexture* texture,
                                       VkImageLayout fallback) {
     if (tracker) {
-        const VkImage image = getVulkanImage(texture);
-        if (image != VK_NULL_HANDLE) {
-            const VkImageLayout tracked = tracker->getLayout(image);
+        const VulkanTextureResource* resource = getVulkanTextureResource(texture);
+        if (resource && resource->image != VK_NULL_HANDLE) {
+            const VkImageLayout tracked = tracker->getLayout(*resource);
             if (tracked != VK_IMAGE_LAYOUT_UNDEFINED || fallback == VK_IMAGE_LAYOUT_UNDEFINED) {
                 return tracked;
             }
@@ -163,6 +176,18 @@ static StreamlineDlssFrameData::VulkanTextureInfo makeTextureInfo(const RhiTextu
     return info;
 }
 
+static sl::PCLMarker toSlPclMarker(LatencyMarker marker) {
+    switch (marker) {
+    case LatencyMarker::SimulationStart:   return sl::PCLMarker::eSimulationStart;
+    case LatencyMarker::SimulationEnd:     return sl::PCLMarker::eSimulationEnd;
+    case LatencyMarker::RenderSubmitStart: return sl::PCLMarker::eRenderSubmitStart;
+    case LatencyMarker::RenderSubmitEnd:   return sl::PCLMarker::eRenderSubmitEnd;
+    case LatencyMarker::PresentStart:      return sl::PCLMarker::ePresentStart;
+    case LatencyMarker::PresentEnd:        return sl::PCLMarker::ePresentEnd;
+    default:                               return sl::PCLMarker::eSimulationStart;
+    }
+}
+
 static HMODULE findStreamlineModule(const wchar_t* moduleName) {
     if (!moduleName || moduleName[0] == L'\0') {
         return nullptr;
@@ -211,8 +236,8 @@ bool StreamlineContext::init(const char* projectRoot, uint32_t applicationId) {
     pref.flags = sl::PreferenceFlags::eDisableCLStateTracking
                | sl::PreferenceFlags::eUseManualHooking
                | sl::PreferenceFlags::eUseFrameBasedResourceTagging;
-    pref.featuresToLoad = &sl::kFeatureDLSS;
-    pref.numFeaturesToLoad = 1;
+    pref.featuresToLoad = kSlFeatures;
+    pref.numFeaturesToLoad = static_cast<uint32_t>(_countof(kSlFeatures));
     pref.renderAPI = sl::RenderAPI::eVulkan;
     pref.applicationId = applicationId;
 
@@ -265,25 +290,35 @@ bool StreamlineContext::init(const char* projectRoot, uint32_t applicationId) {
 bool StreamlineContext::queryVulkanRequirements(StreamlineVulkanRequirements& out) const {
     if (!m_initialized) return false;
 
-    sl::FeatureRequirements requirements{};
-    sl::Result result = slGetFeatureRequirements(sl::kFeatureDLSS, requirements);
-    if (result != sl::Result::eOk) {
-        spdlog::warn("slGetFeatureRequirements(DLSS) failed (result={})", static_cast<int>(result));
-        return false;
-    }
-
     out.instanceExtensions.clear();
     out.deviceExtensions.clear();
     out.needsTimelineSemaphore = false;
 
-    // Copy required Vulkan instance extensions
-    for (uint32_t i = 0; i < requirements.vkNumInstanceExtensions; i++) {
-        out.instanceExtensions.push_back(requirements.vkInstanceExtensions[i]);
-    }
+    auto appendUnique = [](std::vector<const char*>& list, const char* ext) {
+        for (const char* existing : list) {
+            if (std::string_view(existing) == ext) return;
+        }
+        list.push_back(ext);
+    };
 
-    // Copy required Vulkan device extensions
-    for (uint32_t i = 0; i < requirements.vkNumDeviceExtensions; i++) {
-        out.deviceExtensions.push_back(requirements.vkDeviceExtensions[i]);
+    // DLSS is required; the optional features only add their extensions when the
+    // plugin loaded.
+    for (const sl::Feature feature : kSlFeatures) {
+        sl::FeatureRequirements requirements{};
+        sl::Result result = slGetFeatureRequirements(feature, requirements);
+        if (result != sl::Result::eOk) {
+            if (feature == sl::kFeatureDLSS) {
+                spdlog::warn("slGetFeatureRequirements(DLSS) failed (result={})", static_cast<int>(result));
+                return false;
+            }
+            continue;
+        }
+        for (uint32_t i = 0; i < requirements.vkNumInstanceExtensions; i++) {
+            appendUnique(out.instanceExtensions, requirements.vkInstanceExtensions[i]);
+        }
+        for (uint32_t i = 0; i < requirements.vkNumDeviceExtensions; i++) {
+            appendUnique(out.deviceExtensions, requirements.vkDeviceExtensions[i]);
+        }
     }
 
     // Always request timeline semaphore — DLSS needs it and it's core in Vulkan 1.2+
@@ -346,6 +381,17 @@ bool StreamlineContext::setVulkanDevice(VkInstance instance,
                       static_cast<int>(dlssResult));
     }
 
+    m_frameGenerationAvailable =
+        m_dlssAvailable && slIsFeatureSupported(sl::kFeatureDLSS_G, adapterInfo) == sl::Result::eOk;
+    m_reflexAvailable = slIsFeatureSupported(sl::kFeatureReflex, adapterInfo) == sl::Result::eOk &&
+                        slIsFeatureSupported(sl::kFeaturePCL, adapterInfo) == sl::Result::eOk;
+    spdlog::info("DLSS Frame Generation is {}available, Reflex is {}available",
+                 m_frameGenerationAvailable ? "" : "NOT ",
+                 m_reflexAvailable ? "" : "NOT ");
+    if (m_reflexAvailable) {
+        setReflexEnabled(true);
+    }
+
     return true;
 }
 
@@ -404,11 +450,14 @@ bool StreamlineContext::setDlssOptions(DlssPreset preset, uint32_t outputWidth,
 bool StreamlineContext::evaluate(const StreamlineDlssFrameData& data) {
     if (!m_dlssAvailable || m_currentPreset == DlssPreset::Off) return false;
 
-    sl::FrameToken* frameToken = nullptr;
-    sl::Result result = slGetNewFrameToken(frameToken, &data.frameIndex);
-    if (result != sl::Result::eOk || !frameToken) {
-        spdlog::error("slGetNewFrameToken failed");
-        return false;
+    sl::Result result = sl::Result::eOk;
+    sl::FrameToken* frameToken = static_cast<sl::FrameToken*>(m_frameToken);
+    if (!frameToken) {
+        result = slGetNewFrameToken(frameToken, &data.frameIndex);
+        if (result != sl::Result::eOk || !frameToken) {
+            spdlog::error("slGetNewFrameToken failed");
+            return false;
+        }
     }
 
     sl::ViewportHandle viewport{kDefaultViewportId};
@@ -514,7 +563,7 @@ bool StreamlineContext::evaluate(const UpscalerEvaluateInputs& inputs,
         VkCommandBuffer commandBuffer = static_cast<VkCommandBuffer>(encoder.nativeHandle());
         if (commandBuffer != VK_NULL_HANDLE) {
             m_imageLayoutTracker->transition(commandBuffer,
-                                             data.colorOutput,
+                                             *getVulkanTextureResource(inputs.colorOutput),
                                              VK_IMAGE_LAYOUT_GENERAL,
                                              VK_IMAGE_ASPECT_COLOR_BIT);
         }
@@ -570,11 +619,111 @@ void StreamlineContext::resetHistory() {
     m_needsReset = true;
 }
 
+bool StreamlineContext::setFrameGenerationEnabled(bool enabled) {
+    if (!m_frameGenerationAvailable) return !enabled;
+    if (enabled == m_frameGenerationEnabled) return true;
+
+    sl::DLSSGOptions options{};
+    options.mode = enabled ? sl::DLSSGMode::eOn : sl::DLSSGMode::eOff;
+    options.numFramesToGenerate = 1;
+
+    sl::ViewportHandle viewport{kDefaultViewportId};
+    sl::Result result = slDLSSGSetOptions(viewport, options);
+    if (result != sl::Result::eOk) {
+        spdlog::warn("slDLSSGSetOptions failed (result={}); Frame Generation stays {}",
+                     static_cast<int>(result), m_frameGenerationEnabled ? "on" : "off");
+        return false;
+    }
+    m_frameGenerationEnabled = enabled;
+    spdlog::info("DLSS Frame Generation {}", enabled ? "enabled" : "disabled");
+    return true;
+}
+
+bool StreamlineContext::setReflexEnabled(bool enabled) {
+    if (!m_reflexAvailable) return !enabled;
+
+    sl::ReflexOptions options{};
+    options.mode = enabled ? sl::ReflexMode::eLowLatency : sl::ReflexMode::eOff;
+    options.useMarkersToOptimize = enabled;
+    sl::Result result = slReflexSetOptions(options);
+    if (result != sl::Result::eOk) {
+        spdlog::warn("slReflexSetOptions failed (result={})", static_cast<int>(result));
+        return false;
+    }
+    m_reflexEnabled = enabled;
+    return true;
+}
+
+void StreamlineContext::beginFrame(uint32_t frameIndex) {
+    m_frameToken = nullptr;
+    if (!m_vulkanSet || (!m_dlssAvailable && !m_reflexAvailable)) return;
+
+    sl::FrameToken* frameToken = nullptr;
+    if (slGetNewFrameToken(frameToken, &frameIndex) != sl::Result::eOk || !frameToken) {
+        return;
+    }
+    m_frameToken = frameToken;
+    if (m_reflexEnabled) {
+        slReflexSleep(*frameToken);
+    }
+    markLatency(LatencyMarker::SimulationStart);
+}
+
+void StreamlineContext::markLatency(LatencyMarker marker) {
+    if (!m_reflexAvailable || !m_frameToken) return;
+    slPCLSetMarker(toSlPclMarker(marker), *static_cast<sl::FrameToken*>(m_frameToken));
+}
+
+bool StreamlineContext::queryLatency(LatencyTelemetry& out) const {
+    out = LatencyTelemetry{};
+    if (!m_reflexAvailable) return false;
+
+    sl::ReflexState state{};
+    if (slReflexGetState(state) != sl::Result::eOk || !state.latencyReportAvailable) {
+        return false;
+    }
+
+    // Report times are in microseconds; frames the driver has not filled are zero.
+    double pcLatency = 0.0, simulation = 0.0, renderSubmit = 0.0, present = 0.0, gpuFrame = 0.0;
+    uint32_t frames = 0;
+    for (const sl::ReflexReport& report : state.frameReport) {
+        if (report.frameID == 0 || report.gpuRenderEndTime < report.simStartTime) continue;
+        pcLatency += static_cast<double>(report.gpuRenderEndTime - report.simStartTime);
+        simulation += static_cast<double>(report.simEndTime - report.simStartTime);
+        renderSubmit += static_cast<double>(report.renderSubmitEndTime - report.renderSubmitStartTime);
+        present += static_cast<double>(report.presentEndTime - report.presentStartTime);
+        gpuFrame += static_cast<double>(report.gpuFrameTimeInUs);
+        ++frames;
+    }
+    if (frames == 0) return false;
+
+    const double toMs = 1.0 / (1000.0 * frames);
+    out.available = true;
+    out.pcLatencyMs = static_cast<float>(pcLatency * toMs);
+    out.simulationMs = static_cast<float>(simulation * toMs);
+    out.renderSubmitMs = static_cast<float>(renderSubmit * toMs);
+    out.presentMs = static_cast<float>(present * toMs);
+    out.gpuFrameMs = static_cast<float>(gpuFrame * toMs);
+    out.framesPresented = 1;
+    if (m_frameGenerationEnabled) {
+        sl::DLSSGState frameGenState{};
+        sl::ViewportHandle viewport{kDefaultViewportId};
+        if (slDLSSGGetState(viewport, frameGenState) == sl::Result::eOk) {
+            out.framesPresented = std::max(frameGenState.numFramesActuallyPresented, 1u);
+        }
+    }
+    return true;
+}
+
 void StreamlineContext::shutdown() {
     if (!m_initialized) return;
 
     if (m_dlssAvailable) {
         sl::ViewportHandle viewport{kDefaultViewportId};
+        if (m_frameGenerationEnabled) {
+            setFrameGenerationEnabled(false);
+            slFreeResources(sl::kFeatureDLSS_G, viewport);
+        }
         slFreeResources(sl::kFeatureDLSS, viewport);
     }
 
@@ -582,6 +731,11 @@ void StreamlineContext::shutdown() {
     m_initialized = false;
     m_vulkanSet = false;
     m_dlssAvailable = false;
+    m_frameGenerationAvailable = false;
+    m_frameGenerationEnabled = false;
+    m_reflexAvailable = false;
+    m_reflexEnabled = false;
+    m_frameToken = nullptr;
     m_vkGetDeviceProcAddrProxy = nullptr;
     m_vkBeginCommandBufferHook = nullptr;
     m_vkCmdBindPipelineHook = nullptr;
@@ -593,7 +747,10 @@ std::string StreamlineContext::statusString() const {
     if (!m_initialized) return "Streamline: Not initialized";
     if (!m_vulkanSet) return "Streamline: Vulkan not configured";
     if (!m_dlssAvailable) return "DLSS: Unavailable (non-NVIDIA or unsupported GPU)";
-    return "DLSS: Available";
+    std::string status = "DLSS: Available";
+    if (m_frameGenerationEnabled) status += ", Frame Generation on";
+    if (m_reflexEnabled) status += ", Reflex on";
+    return status;
 }
 
 #else // !METALLIC_HAS_STREAMLINE — stub implementation
@@ -637,6 +794,23 @@ bool StreamlineContext::getOptimalRenderSize(uint32_t, uint32_t,
 
 void StreamlineContext::resetHistory() {}
 
+bool StreamlineContext::setFrameGenerationEnabled(bool enabled) {
+    return !enabled;
+}
+
+bool StreamlineContext::setReflexEnabled(bool enabled) {
+    return !enabled;
+}
+
+void StreamlineContext::beginFrame(uint32_t) {}
+
+void StreamlineContext::markLatency(LatencyMarker) {}
+
+bool StreamlineContext::queryLatency(LatencyTelemetry& out) const {
+    out = LatencyTelemetry{};
+    return false;
+}
+
 void StreamlineContext::shutdown() {}
 
 std::string StreamlineContext::statusString() const {
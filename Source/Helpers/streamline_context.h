@@ -1,6 +1,7 @@
 #pragma once
 
-// Streamline / DLSS Super Resolution integration for Vulkan.
+// Streamline integration for Vulkan: DLSS Super Resolution, DLSS Frame Generation
+// and Reflex low latency with PC latency markers.
 // This is a Windows-only, Vulkan-only integration layer.
 // When METALLIC_HAS_STREAMLINE is not defined, all functions are stubs.
 
@@ -28,6 +29,7 @@ typedef VkImage_T* VkImage;
 typedef VkImageView_T* VkImageView;
 
 class RhiTexture;
+struct LatencyTelemetry;
 
 // DLSS quality presets (mirrors sl::DLSSMode ordering)
 enum class DlssPreset : uint32_t {
@@ -43,6 +45,16 @@ enum class DlssPreset : uint32_t {
 
 const char* dlssPresetName(DlssPreset preset);
 
+// PC latency markers, in the order the main loop reaches them each frame
+enum class LatencyMarker : uint32_t {
+    SimulationStart = 0,
+    SimulationEnd,
+    RenderSubmitStart,
+    RenderSubmitEnd,
+    PresentStart,
+    PresentEnd
+};
+
 // Requirements that Streamline/DLSS needs from the Vulkan device
 struct StreamlineVulkanRequirements {
     std::vector<const char*> instanceExtensions;
@@ -140,6 +152,10 @@ public:
 
     // Query DLSS availability on current adapter
     bool isDlssAvailable() const { return m_dlssAvailable; }
+    bool isFrameGenerationAvailable() const { return m_frameGenerationAvailable; }
+    bool isFrameGenerationEnabled() const { return m_frameGenerationEnabled; }
+    bool isReflexAvailable() const { return m_reflexAvailable; }
+    bool isReflexEnabled() const { return m_reflexEnabled; }
     bool isAvailable() const override { return m_dlssAvailable; }
     bool isEnabled() const override { return m_currentPreset != DlssPreset::Off; }
     bool isInitialized() const { return m_initialized; }
@@ -169,6 +185,23 @@ public:
     // Reset temporal history (call on resize, camera cut, pipeline reload, preset change)
     void resetHistory() override;
 
+    // DLSS Frame Generation reuses the constants and the depth / motion vector tags
+    // evaluate() sets, so only enable it while DLSS evaluates every frame.
+    // Returns false when the mode could not be applied; no-op when unchanged.
+    bool setFrameGenerationEnabled(bool enabled);
+
+    // Reflex low latency mode. While enabled, beginFrame() sleeps to keep the CPU
+    // just ahead of the GPU.
+    bool setReflexEnabled(bool enabled);
+
+    // Fetch this frame's token and run the Reflex sleep. Call once per frame before
+    // input is sampled; markLatency() and evaluate() then use the same token.
+    void beginFrame(uint32_t frameIndex);
+    void markLatency(LatencyMarker marker);
+
+    // Averages over the frames in the driver's latency report
+    bool queryLatency(LatencyTelemetry& out) const;
+
     // Shutdown
     void shutdown();
 
@@ -179,6 +212,11 @@ private:
     bool m_initialized = false;
     bool m_vulkanSet = false;
     bool m_dlssAvailable = false;
+    bool m_frameGenerationAvailable = false;
+    bool m_frameGenerationEnabled = false;
+    bool m_reflexAvailable = false;
+    bool m_reflexEnabled = false;
+    void* m_frameToken = nullptr; // sl::FrameToken* from beginFrame(), owned by Streamline
     DlssPreset m_currentPreset = DlssPreset::Off;
     uint32_t m_currentOutputWidth = 0;
     uint32_t m_currentOutputHeight = 0;
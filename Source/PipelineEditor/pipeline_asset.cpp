@@ -1,9 +1,11 @@
 #include "pipeline_asset.h"
 
+#include "fast_hash.h"
 #include "pass_registry.h"
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <limits>
 #include <queue>
 #include <random>
@@ -45,7 +47,7 @@ bool isKnownResourceKind(const std::string& kind) {
 }
 
 bool isKnownEdgeDirection(const std::string& direction) {
-    return direction == "input" || direction == "output";
+    return direction == "input" || direction == "output" || direction == "bypass";
 }
 
 const PassSlotInfo* findSlotInfo(const std::vector<PassSlotInfo>& slots, const std::string& key) {
@@ -86,6 +88,7 @@ PassDecl parsePassDecl(const Json& j) {
     pass.type = getOrDefault<std::string>(j, "type", {});
     pass.enabled = getOrDefault<bool>(j, "enabled", true);
     pass.sideEffect = getOrDefault<bool>(j, "sideEffect", false);
+    pass.condition = getOrDefault<std::string>(j, "condition", {});
     if (j.contains("config")) {
         pass.config = j["config"];
     }
@@ -129,6 +132,9 @@ OrderedJson toJson(const PassDecl& pass) {
     j["type"] = pass.type;
     j["enabled"] = pass.enabled;
     j["sideEffect"] = pass.sideEffect;
+    if (!pass.condition.empty()) {
+        j["condition"] = pass.condition;
+    }
     j["config"] = pass.config;
     j["editorPos"] = serializeEditorPos(pass.editorPos);
     return j;
@@ -160,15 +166,24 @@ std::string generatePipelineAssetGuid() {
 }
 
 PipelineAsset PipelineAsset::load(const std::string& path) {
-    std::ifstream file(path);
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         spdlog::error("PipelineAsset: failed to open '{}'", path);
         return {};
     }
+    const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    const uint64_t sourceHash = FastHash::hashBytes(text.data(), text.size());
+    const std::string binaryPath = compiledPath(path);
+    {
+        PipelineAsset compiled;
+        if (loadCompiled(binaryPath, sourceHash, compiled)) {
+            spdlog::debug("PipelineAsset: '{}' loaded from its compiled form", path);
+            return compiled;
+        }
+    }
 
     try {
-        Json j;
-        file >> j;
+        const Json j = Json::parse(text);
 
         const int schemaVersion = j.value("schemaVersion", 0);
         if (schemaVersion != kPipelineAssetSchemaVersion) {
@@ -201,6 +216,7 @@ PipelineAsset PipelineAsset::load(const std::string& path) {
             }
         }
 
+        asset.saveCompiled(binaryPath, sourceHash);
         return asset;
     } catch (const std::exception& e) {
         spdlog::error("PipelineAsset: JSON parse error in '{}': {}", path, e.what());
@@ -209,7 +225,7 @@ PipelineAsset PipelineAsset::load(const std::string& path) {
 }
 
 void PipelineAsset::save(const std::string& path) const {
-    std::ofstream file(path);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
     if (!file.is_open()) {
         spdlog::error("PipelineAsset: failed to write '{}'", path);
         return;
@@ -288,8 +304,23 @@ void PipelineAsset::save(const std::string& path) const {
     }
     j["edges"] = std::move(edgeArray);
 
-    file << j.dump(2);
+    const std::string text = j.dump(2);
+    file << text;
+    file.close();
+    if (!file) {
+        spdlog::error("PipelineAsset: failed to write '{}'", path);
+        return;
+    }
     spdlog::info("PipelineAsset: saved '{}'", path);
+
+    // Compile what a load of this text produces, including the edge order written above.
+    PipelineAsset saved;
+    saved.schemaVersion = kPipelineAssetSchemaVersion;
+    saved.name = name;
+    saved.resources = resources;
+    saved.passes = passes;
+    saved.edges = std::move(sortedEdges);
+    saved.saveCompiled(compiledPath(path), FastHash::hashBytes(text.data(), text.size()));
 }
 
 bool PipelineAsset::validate(std::string& errorMsg) const {
@@ -396,7 +427,21 @@ bool PipelineAsset::validate(std::string& errorMsg) const {
                        " slot '" + edge.slotKey + "' on pass '" + pass->name + "'";
             return false;
         }
-        if (!resourceKindAllowed(*slotInfo, resource->kind)) {
+        if (edge.direction == "bypass") {
+            if (pass->condition.empty()) {
+                errorMsg = "Bypass edge '" + edge.id + "' is on pass '" + pass->name + "', which has no condition";
+                return false;
+            }
+            if (!findEdge(edge.passId, "output", edge.slotKey)) {
+                errorMsg = "Bypass edge '" + edge.id + "' names unbound output slot '" + edge.slotKey +
+                           "' on pass '" + pass->name + "'";
+                return false;
+            }
+            if (resource->kind == "backbuffer") {
+                errorMsg = "Bypass edge '" + edge.id + "' cannot read the backbuffer";
+                return false;
+            }
+        } else if (!resourceKindAllowed(*slotInfo, resource->kind)) {
             errorMsg = "Edge '" + edge.id + "' binds resource '" + resource->name +
                        "' with incompatible kind '" + resource->kind + "'";
             return false;
@@ -451,6 +496,77 @@ bool PipelineAsset::validate(std::string& errorMsg) const {
 }
 
 std::vector<size_t> PipelineAsset::topologicalSort(bool includeDisabled) const {
+    if (includeDisabled) {
+        return sortPasses(true);
+    }
+    const PipelineGraphIndex& index = graphIndex();
+    return std::vector<size_t>(index.passOrder.begin(), index.passOrder.end());
+}
+
+uint64_t PipelineAsset::structureHash() const {
+    FastHash::Hasher hasher;
+    auto addString = [&hasher](const std::string& value) {
+        hasher.addValue(value.size());
+        hasher.addBytes(value.data(), value.size());
+    };
+    hasher.addValue(resources.size());
+    for (const auto& resource : resources) {
+        addString(resource.id);
+        addString(resource.kind);
+    }
+    hasher.addValue(passes.size());
+    for (const auto& pass : passes) {
+        addString(pass.id);
+        hasher.addValue(pass.enabled);
+    }
+    hasher.addValue(edges.size());
+    for (const auto& edge : edges) {
+        addString(edge.passId);
+        addString(edge.direction);
+        addString(edge.resourceId);
+    }
+    return hasher.finish();
+}
+
+const PipelineGraphIndex& PipelineAsset::graphIndex() const {
+    const uint64_t hash = structureHash();
+    if (m_graphIndexValid && m_graphIndex.structureHash == hash) {
+        return m_graphIndex;
+    }
+
+    PipelineGraphIndex index;
+    index.structureHash = hash;
+    const std::vector<size_t> order = sortPasses(false);
+    index.passOrder.assign(order.begin(), order.end());
+
+    std::unordered_map<std::string, uint32_t> passPosition;
+    for (size_t position = 0; position < order.size(); ++position) {
+        passPosition.emplace(passes[order[position]].id, static_cast<uint32_t>(position));
+    }
+    std::unordered_map<std::string, size_t> resourceIndex;
+    for (size_t i = 0; i < resources.size(); ++i) {
+        resourceIndex.emplace(resources[i].id, i);
+    }
+    index.firstUse.assign(resources.size(), PipelineGraphIndex::kUnused);
+    index.lastUse.assign(resources.size(), PipelineGraphIndex::kUnused);
+    for (const auto& edge : edges) {
+        auto positionIt = passPosition.find(edge.passId);
+        auto resourceIt = resourceIndex.find(edge.resourceId);
+        if (positionIt == passPosition.end() || resourceIt == resourceIndex.end()) {
+            continue;
+        }
+        uint32_t& first = index.firstUse[resourceIt->second];
+        uint32_t& last = index.lastUse[resourceIt->second];
+        first = first == PipelineGraphIndex::kUnused ? positionIt->second : std::min(first, positionIt->second);
+        last = last == PipelineGraphIndex::kUnused ? positionIt->second : std::max(last, positionIt->second);
+    }
+
+    m_graphIndex = std::move(index);
+    m_graphIndexValid = true;
+    return m_graphIndex;
+}
+
+std::vector<size_t> PipelineAsset::sortPasses(bool includeDisabled) const {
     std::unordered_map<std::string, size_t> passIndex;
     for (size_t i = 0; i < passes.size(); ++i) {
         if (!includeDisabled && !passes[i].enabled) {
@@ -482,8 +598,9 @@ std::vector<size_t> PipelineAsset::topologicalSort(bool includeDisabled) const {
     std::vector<std::vector<size_t>> adj(passes.size());
     std::vector<size_t> inDegree(passes.size(), 0);
 
+    // A bypass source has to exist before anything reads the output it stands in for.
     for (const auto& edge : edges) {
-        if (edge.direction != "input") {
+        if (edge.direction != "input" && edge.direction != "bypass") {
             continue;
         }
         auto consumerIt = passIndex.find(edge.passId);
@@ -624,3 +741,35 @@ void PipelineAsset::removeEdgesForResource(const std::string& resourceId) {
         std::remove_if(edges.begin(), edges.end(), [&](const EdgeDecl& edge) { return edge.resourceId == resourceId; }),
         edges.end());
 }
+
+bool PipelineAsset::sameRuntimeGraph(const PipelineAsset& other) const {
+    if (resources.size() != other.resources.size() || passes.size() != other.passes.size() ||
+        edges.size() != other.edges.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < resources.size(); ++i) {
+        const ResourceDecl& lhs = resources[i];
+        const ResourceDecl& rhs = other.resources[i];
+        if (lhs.id != rhs.id || lhs.name != rhs.name || lhs.kind != rhs.kind || lhs.type != rhs.type ||
+            lhs.format != rhs.format || lhs.size != rhs.size || lhs.importKey != rhs.importKey) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < passes.size(); ++i) {
+        const PassDecl& lhs = passes[i];
+        const PassDecl& rhs = other.passes[i];
+        if (lhs.id != rhs.id || lhs.name != rhs.name || lhs.type != rhs.type || lhs.enabled != rhs.enabled ||
+            lhs.sideEffect != rhs.sideEffect || lhs.condition != rhs.condition || lhs.config != rhs.config) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const EdgeDecl& lhs = edges[i];
+        const EdgeDecl& rhs = other.edges[i];
+        if (lhs.passId != rhs.passId || lhs.slotKey != rhs.slotKey || lhs.direction != rhs.direction ||
+            lhs.resourceId != rhs.resourceId) {
+            return false;
+        }
+    }
+    return true;
+}
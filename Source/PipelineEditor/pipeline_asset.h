@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -29,6 +30,9 @@ struct PassDecl {
     std::string type;    // maps to PassRegistry type name
     bool enabled = true;
     bool sideEffect = false;
+    // Names a PipelineRuntimeContext::passConditions flag checked every frame; while it
+    // is false the frame graph culls the pass instead of the pipeline being rebuilt.
+    std::string condition;
     nlohmann::json config;  // pass-specific configuration
     std::array<float, 2> editorPos = {0.0f, 0.0f};
 };
@@ -38,10 +42,24 @@ struct EdgeDecl {
     std::string id;
     std::string passId;
     std::string slotKey;
-    std::string direction; // "input" | "output"
+    // "input" | "output" | "bypass". A bypass edge names an output slot of a pass
+    // with a condition and the resource that stands in for it while the pass is culled.
+    std::string direction;
     std::string resourceId;
 };
 
+// Graph facts derived from the declarations, stored in the compiled form so a load does
+// not recompute them. passOrder is topologicalSort(false); firstUse/lastUse give, per
+// resource, the first and last position in it touching the resource (kUnused if none).
+struct PipelineGraphIndex {
+    static constexpr uint32_t kUnused = UINT32_MAX;
+
+    uint64_t structureHash = 0;
+    std::vector<uint32_t> passOrder;
+    std::vector<uint32_t> firstUse;
+    std::vector<uint32_t> lastUse;
+};
+
 // Complete pipeline asset
 struct PipelineAsset {
     int schemaVersion = kPipelineAssetSchemaVersion;
@@ -50,18 +68,31 @@ struct PipelineAsset {
     std::vector<PassDecl> passes;
     std::vector<EdgeDecl> edges;
 
-    // Load pipeline from JSON file
+    // Load pipeline from JSON file. A compiled form next to it (compiledPath) whose
+    // source hash matches the JSON is used instead of parsing, and is rewritten when stale.
     static PipelineAsset load(const std::string& path);
 
-    // Save pipeline to JSON file
+    // Save pipeline to JSON file, plus its compiled form
     void save(const std::string& path) const;
 
+    // Binary form of a pipeline: interned strings, edges resolved to pass and resource
+    // indices, pass configs as MessagePack and the graph index. Keyed by the hash of
+    // the JSON text it was compiled from.
+    static std::string compiledPath(const std::string& jsonPath);
+    bool saveCompiled(const std::string& path, uint64_t sourceHash) const;
+    static bool loadCompiled(const std::string& path, uint64_t sourceHash, PipelineAsset& asset);
+
     // Validate the pipeline DAG (check for cycles, missing resources, etc.)
     bool validate(std::string& errorMsg) const;
 
     // Get topologically sorted pass order
     std::vector<size_t> topologicalSort(bool includeDisabled = true) const;
 
+    // Recomputed only when structureHash() no longer matches, so edits are picked up.
+    const PipelineGraphIndex& graphIndex() const;
+    // Hash of everything the graph index depends on: ids, kinds, enabled flags, edges.
+    uint64_t structureHash() const;
+
     ResourceDecl* findResourceById(const std::string& id);
     const ResourceDecl* findResourceById(const std::string& id) const;
 
@@ -80,4 +111,13 @@ struct PipelineAsset {
 
     void removeEdgesForPass(const std::string& passId);
     void removeEdgesForResource(const std::string& resourceId);
+
+    // True when both assets build the same graph; editor positions are ignored.
+    bool sameRuntimeGraph(const PipelineAsset& other) const;
+
+private:
+    std::vector<size_t> sortPasses(bool includeDisabled) const;
+
+    mutable PipelineGraphIndex m_graphIndex;
+    mutable bool m_graphIndexValid = false;
 };
@@ -0,0 +1,380 @@
+#include "pipeline_asset.h"
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+constexpr char kCompiledPipelineMagic[8] = {'M', 'L', 'P', 'I', 'P', 'E', '0', '1'};
+constexpr uint32_t kCompiledPipelineVersion = 1;
+
+struct CompiledPipelineHeader {
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t schemaVersion = 0;
+    uint64_t sourceHash = 0;
+    uint64_t payloadSize = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<CompiledPipelineHeader>);
+
+enum class CompiledEdgeDirection : uint8_t { Input, Output, Bypass };
+
+// Strings are written once into a table and referenced by index everywhere else.
+class StringTable {
+public:
+    uint32_t intern(const std::string& value) {
+        auto [it, inserted] = m_lookup.try_emplace(value, static_cast<uint32_t>(m_strings.size()));
+        if (inserted) {
+            m_strings.push_back(value);
+        }
+        return it->second;
+    }
+
+    const std::vector<std::string>& strings() const { return m_strings; }
+
+private:
+    std::unordered_map<std::string, uint32_t> m_lookup;
+    std::vector<std::string> m_strings;
+};
+
+class CompiledWriter {
+public:
+    template <typename T>
+    void value(const T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void vector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        value(static_cast<uint32_t>(values.size()));
+        bytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void bytes(const void* data, size_t size) {
+        const auto* begin = static_cast<const uint8_t*>(data);
+        m_data.insert(m_data.end(), begin, begin + size);
+    }
+
+    const std::vector<uint8_t>& data() const { return m_data; }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// Bounds-checked cursor; any overrun or out-of-range index latches ok() false.
+class CompiledReader {
+public:
+    CompiledReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+
+    template <typename T>
+    void value(T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        read(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void vector(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const uint32_t count = readCount(sizeof(T));
+        values.resize(count);
+        read(values.data(), values.size() * sizeof(T));
+    }
+
+    uint32_t readCount(size_t elementSize) {
+        uint32_t count = 0;
+        value(count);
+        if (!m_ok || count > static_cast<size_t>(m_end - m_cursor) / elementSize) {
+            m_ok = false;
+            return 0;
+        }
+        return count;
+    }
+
+    const uint8_t* take(size_t size) {
+        if (!m_ok || size > static_cast<size_t>(m_end - m_cursor)) {
+            m_ok = false;
+            return nullptr;
+        }
+        const uint8_t* data = m_cursor;
+        m_cursor += size;
+        return data;
+    }
+
+    uint32_t index(uint32_t limit) {
+        uint32_t v = 0;
+        value(v);
+        if (v >= limit) {
+            m_ok = false;
+            return 0;
+        }
+        return v;
+    }
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_cursor == m_end; }
+
+private:
+    void read(void* out, size_t size) {
+        if (const uint8_t* data = take(size); data && size != 0) {
+            std::memcpy(out, data, size);
+        }
+    }
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    bool m_ok = true;
+};
+
+bool compiledDirection(const std::string& direction, CompiledEdgeDirection& out) {
+    if (direction == "input") {
+        out = CompiledEdgeDirection::Input;
+    } else if (direction == "output") {
+        out = CompiledEdgeDirection::Output;
+    } else if (direction == "bypass") {
+        out = CompiledEdgeDirection::Bypass;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* directionName(CompiledEdgeDirection direction) {
+    switch (direction) {
+    case CompiledEdgeDirection::Input:
+        return "input";
+    case CompiledEdgeDirection::Output:
+        return "output";
+    case CompiledEdgeDirection::Bypass:
+        return "bypass";
+    }
+    return "input";
+}
+
+} // namespace
+
+std::string PipelineAsset::compiledPath(const std::string& jsonPath) {
+    return std::filesystem::path(jsonPath).replace_extension(".pipelinebin").string();
+}
+
+bool PipelineAsset::saveCompiled(const std::string& path, uint64_t sourceHash) const {
+    std::unordered_map<std::string, uint32_t> passIndex;
+    std::unordered_map<std::string, uint32_t> resourceIndex;
+    for (size_t i = 0; i < passes.size(); ++i) {
+        passIndex.emplace(passes[i].id, static_cast<uint32_t>(i));
+    }
+    for (size_t i = 0; i < resources.size(); ++i) {
+        resourceIndex.emplace(resources[i].id, static_cast<uint32_t>(i));
+    }
+
+    // Edges that do not resolve only exist in pipelines that fail validation; those
+    // keep loading from JSON so the error is reported the usual way.
+    StringTable strings;
+    CompiledWriter body;
+    body.value(strings.intern(name));
+
+    body.value(static_cast<uint32_t>(resources.size()));
+    for (const auto& resource : resources) {
+        body.value(strings.intern(resource.id));
+        body.value(strings.intern(resource.name));
+        body.value(strings.intern(resource.kind));
+        body.value(strings.intern(resource.type));
+        body.value(strings.intern(resource.format));
+        body.value(strings.intern(resource.size));
+        body.value(strings.intern(resource.importKey));
+        body.value(resource.editorPos);
+    }
+
+    body.value(static_cast<uint32_t>(passes.size()));
+    for (const auto& pass : passes) {
+        body.value(strings.intern(pass.id));
+        body.value(strings.intern(pass.name));
+        body.value(strings.intern(pass.type));
+        body.value(strings.intern(pass.condition));
+        body.value(static_cast<uint8_t>(pass.enabled));
+        body.value(static_cast<uint8_t>(pass.sideEffect));
+        body.value(pass.editorPos);
+        const std::vector<uint8_t> config = nlohmann::json::to_msgpack(pass.config);
+        body.vector(config);
+    }
+
+    body.value(static_cast<uint32_t>(edges.size()));
+    for (const auto& edge : edges) {
+        auto passIt = passIndex.find(edge.passId);
+        auto resourceIt = resourceIndex.find(edge.resourceId);
+        CompiledEdgeDirection direction{};
+        if (passIt == passIndex.end() || resourceIt == resourceIndex.end() ||
+            !compiledDirection(edge.direction, direction)) {
+            return false;
+        }
+        body.value(strings.intern(edge.id));
+        body.value(passIt->second);
+        body.value(strings.intern(edge.slotKey));
+        body.value(direction);
+        body.value(resourceIt->second);
+    }
+
+    const PipelineGraphIndex& index = graphIndex();
+    body.value(index.structureHash);
+    body.vector(index.passOrder);
+    body.vector(index.firstUse);
+    body.vector(index.lastUse);
+
+    CompiledWriter payload;
+    payload.value(static_cast<uint32_t>(strings.strings().size()));
+    for (const std::string& value : strings.strings()) {
+        payload.value(static_cast<uint32_t>(value.size()));
+        payload.bytes(value.data(), value.size());
+    }
+    payload.bytes(body.data().data(), body.data().size());
+
+    CompiledPipelineHeader header;
+    std::memcpy(header.magic, kCompiledPipelineMagic, sizeof(header.magic));
+    header.version = kCompiledPipelineVersion;
+    header.schemaVersion = static_cast<uint32_t>(schemaVersion);
+    header.sourceHash = sourceHash;
+    header.payloadSize = payload.data().size();
+
+    // Written beside and renamed over, so a concurrent load never sees a partial file.
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::debug("PipelineAsset: cannot write compiled form '{}'", path);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data().data()),
+                   static_cast<std::streamsize>(payload.data().size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool PipelineAsset::loadCompiled(const std::string& path, uint64_t sourceHash, PipelineAsset& asset) {
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        return false;
+    }
+    MappedFile file;
+    CompiledPipelineHeader header;
+    if (!file.open(path) || file.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kCompiledPipelineMagic, sizeof(header.magic)) != 0 ||
+        header.version != kCompiledPipelineVersion ||
+        header.schemaVersion != static_cast<uint32_t>(kPipelineAssetSchemaVersion) ||
+        header.sourceHash != sourceHash ||
+        header.payloadSize != file.size() - sizeof(header)) {
+        return false;
+    }
+
+    CompiledReader reader(file.data() + sizeof(header), static_cast<size_t>(header.payloadSize));
+    std::vector<std::string> strings(reader.readCount(sizeof(uint32_t)));
+    for (std::string& value : strings) {
+        const uint32_t length = reader.readCount(1);
+        if (const uint8_t* data = reader.take(length)) {
+            value.assign(reinterpret_cast<const char*>(data), length);
+        }
+    }
+    static const std::string kEmpty;
+    const auto stringCount = static_cast<uint32_t>(strings.size());
+    auto string = [&]() -> const std::string& {
+        const uint32_t i = reader.index(stringCount);
+        return reader.ok() ? strings[i] : kEmpty;
+    };
+
+    PipelineAsset loaded;
+    loaded.schemaVersion = static_cast<int>(header.schemaVersion);
+    loaded.name = string();
+
+    loaded.resources.resize(reader.readCount(sizeof(uint32_t)));
+    for (ResourceDecl& resource : loaded.resources) {
+        resource.id = string();
+        resource.name = string();
+        resource.kind = string();
+        resource.type = string();
+        resource.format = string();
+        resource.size = string();
+        resource.importKey = string();
+        reader.value(resource.editorPos);
+    }
+
+    loaded.passes.resize(reader.readCount(sizeof(uint32_t)));
+    for (PassDecl& pass : loaded.passes) {
+        pass.id = string();
+        pass.name = string();
+        pass.type = string();
+        pass.condition = string();
+        uint8_t enabled = 0;
+        uint8_t sideEffect = 0;
+        reader.value(enabled);
+        reader.value(sideEffect);
+        pass.enabled = enabled != 0;
+        pass.sideEffect = sideEffect != 0;
+        reader.value(pass.editorPos);
+        const uint32_t configSize = reader.readCount(1);
+        const uint8_t* config = reader.take(configSize);
+        if (config) {
+            pass.config = nlohmann::json::from_msgpack(config, config + configSize, true, false);
+            if (pass.config.is_discarded()) {
+                return false;
+            }
+        }
+    }
+
+    const auto passCount = static_cast<uint32_t>(loaded.passes.size());
+    const auto resourceCount = static_cast<uint32_t>(loaded.resources.size());
+    loaded.edges.resize(reader.readCount(sizeof(uint32_t)));
+    for (EdgeDecl& edge : loaded.edges) {
+        edge.id = string();
+        const uint32_t passIndex = reader.index(passCount);
+        edge.slotKey = string();
+        CompiledEdgeDirection direction{};
+        reader.value(direction);
+        edge.direction = directionName(direction);
+        const uint32_t resourceIndex = reader.index(resourceCount);
+        if (!reader.ok()) {
+            break;
+        }
+        edge.passId = loaded.passes[passIndex].id;
+        edge.resourceId = loaded.resources[resourceIndex].id;
+    }
+
+    PipelineGraphIndex index;
+    reader.value(index.structureHash);
+    reader.vector(index.passOrder);
+    reader.vector(index.firstUse);
+    reader.vector(index.lastUse);
+    if (!reader.ok() || !reader.atEnd() ||
+        index.firstUse.size() != loaded.resources.size() || index.lastUse.size() != loaded.resources.size() ||
+        std::any_of(index.passOrder.begin(), index.passOrder.end(), [&](uint32_t p) { return p >= passCount; })) {
+        spdlog::warn("PipelineAsset: compiled form '{}' is corrupt, parsing JSON", path);
+        return false;
+    }
+
+    loaded.m_graphIndex = std::move(index);
+    loaded.m_graphIndexValid = true;
+    asset = std::move(loaded);
+    return true;
+}
@@ -3,7 +3,9 @@
 #include "frame_context.h"
 #include "render_pass.h"
 
+#include <memory>
 #include <string_view>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
@@ -91,7 +93,18 @@ bool PipelineBuilder::build(const PipelineAsset& asset,
     if (!asset.validate(m_lastError)) {
         return false;
     }
+    m_pipelineName = asset.name;
 
+    // Hand the old graph's transients back so the rebuilt graph can reuse them.
+    if (rtCtx.resourceFactory) {
+        m_fg.resetTransients(rtCtx.resourceFactory);
+    }
+    // Passes own persistent resources (history targets, pipelines) that frames in
+    // flight may still reference; the old graph is destroyed once those retire.
+    if (rtCtx.rhi) {
+        auto retiredGraph = std::make_shared<FrameGraph>(std::move(m_fg));
+        rtCtx.rhi->deferRelease([retiredGraph]() mutable { retiredGraph.reset(); });
+    }
     m_fg = FrameGraph{};
     m_resourceMap.clear();
     m_passes.clear();
@@ -212,6 +225,10 @@ bool PipelineBuilder::build(const PipelineAsset& asset,
             }
             m_resourceMap[binding.resourceId] = output;
         }
+
+        if (!passDecl.condition.empty()) {
+            applyPassCondition(asset, passDecl, rtCtx, m_fg.passCount() - 1u);
+        }
     }
 
     for (const auto& resource : asset.resources) {
@@ -234,6 +251,44 @@ bool PipelineBuilder::build(const PipelineAsset& asset,
     return true;
 }
 
+void PipelineBuilder::applyPassCondition(const PipelineAsset& asset,
+                                         const PassDecl& passDecl,
+                                         const PipelineRuntimeContext& rtCtx,
+                                         uint32_t passIndex) {
+    auto conditionIt = rtCtx.passConditions.find(passDecl.condition);
+    if (conditionIt == rtCtx.passConditions.end() || !conditionIt->second) {
+        spdlog::warn("PipelineBuilder: pass '{}' names unknown condition '{}'; it always runs",
+                     passDecl.name,
+                     passDecl.condition);
+        return;
+    }
+
+    // Culling the pass without its stand-ins would leave readers with nothing bound.
+    std::vector<std::pair<FGResource, FGResource>> bypasses;
+    for (const auto& edge : asset.edges) {
+        if (edge.passId != passDecl.id || edge.direction != "bypass") {
+            continue;
+        }
+        const EdgeDecl* outputEdge = asset.findEdge(passDecl.id, "output", edge.slotKey);
+        auto outputIt = outputEdge ? m_resourceMap.find(outputEdge->resourceId) : m_resourceMap.end();
+        auto sourceIt = m_resourceMap.find(edge.resourceId);
+        if (outputIt == m_resourceMap.end() || sourceIt == m_resourceMap.end() ||
+            !outputIt->second.isValid() || !sourceIt->second.isValid()) {
+            spdlog::warn("PipelineBuilder: pass '{}' cannot resolve the bypass of output slot '{}'; it always runs",
+                         passDecl.name,
+                         edge.slotKey);
+            return;
+        }
+        bypasses.emplace_back(outputIt->second, sourceIt->second);
+    }
+
+    const bool* flag = conditionIt->second;
+    m_fg.setPassCondition(passIndex, [flag]() { return *flag; });
+    for (const auto& [output, source] : bypasses) {
+        m_fg.setPassBypass(passIndex, output, source);
+    }
+}
+
 void PipelineBuilder::updateFrame(RhiTexture* backbuffer, const FrameContext* frameCtx) {
     if (m_backbufferRes.isValid()) {
         m_fg.updateImport(m_backbufferRes, backbuffer);
@@ -261,6 +316,35 @@ void PipelineBuilder::setRuntimeContext(const PipelineRuntimeContext* ctx) {
     }
 }
 
+void PipelineBuilder::collectCostProfile(PipelineCostProfile& profile) const {
+    profile.pipelineName = m_pipelineName;
+    profile.renderWidth = m_builtWidth;
+    profile.renderHeight = m_builtHeight;
+    const FrameGraph::TransientMemoryStats& memory = m_fg.transientMemoryStats();
+    profile.placedTextureCount = memory.placedTextureCount;
+    profile.aliasedTextureCount = memory.aliasedTextureCount;
+    profile.transientRequestedBytes = memory.requestedBytes;
+    profile.transientHeapBytes = memory.heapBytes;
+
+    std::vector<FGPassCost> costs;
+    m_fg.collectPassCosts(costs);
+    profile.passes.clear();
+    profile.passes.reserve(costs.size());
+    for (const FGPassCost& cost : costs) {
+        PipelinePassCost pass;
+        pass.name = cost.name;
+        pass.live = cost.live;
+        if (cost.gpuTiming) {
+            pass.gpuAvgMs = cost.gpuTiming->avgMs;
+            pass.gpuMaxMs = cost.gpuTiming->maxMs;
+        }
+        pass.gpuMerged = cost.gpuMerged;
+        pass.cpuRecordMs = cost.cpuRecordMs;
+        pass.transientBytes = cost.transientBytes;
+        profile.passes.push_back(std::move(pass));
+    }
+}
+
 FGResource PipelineBuilder::getResource(const std::string& name) const {
     auto it = m_resourceMap.find(name);
     if (it != m_resourceMap.end()) {
@@ -278,6 +362,7 @@ RhiFormat PipelineBuilder::parsePixelFormat(const std::string& format) const {
         {"RG8Unorm", RhiFormat::RG8Unorm},
         {"RG16Float", RhiFormat::RG16Float},
         {"RG32Float", RhiFormat::RG32Float},
+        {"RG32Uint", RhiFormat::RG32Uint},
         {"RGBA8Unorm", RhiFormat::RGBA8Unorm},
         {"RGBA8Srgb", RhiFormat::RGBA8Srgb},
         {"RGBA8_SRGB", RhiFormat::RGBA8Srgb},
@@ -3,6 +3,7 @@
 #include "pipeline_asset.h"
 #include "frame_graph.h"
 #include "pass_registry.h"
+#include "pipeline_cost_profile.h"
 #include <unordered_map>
 #include <vector>
 
@@ -47,9 +48,17 @@ public:
     // Get all created passes
     const std::vector<RenderPass*>& passes() const { return m_passes; }
 
+    // Snapshot of per-pass costs for the Pipeline Editor; frameIndex is left to the caller.
+    void collectCostProfile(PipelineCostProfile& profile) const;
+
 private:
     RhiFormat parsePixelFormat(const std::string& format) const;
     FGTextureDesc parseTextureDesc(const ResourceDecl& decl, int width, int height) const;
+    // Hooks a pass with a condition up to its runtime flag and bypass edges.
+    void applyPassCondition(const PipelineAsset& asset,
+                            const PassDecl& passDecl,
+                            const PipelineRuntimeContext& rtCtx,
+                            uint32_t passIndex);
 
     const RenderContext& m_ctx;
     std::string m_lastError;
@@ -59,6 +68,7 @@ private:
     // Cached state
     FrameGraph m_fg;
     FGResource m_backbufferRes;
+    std::string m_pipelineName;
     int m_builtWidth = 0;
     int m_builtHeight = 0;
     bool m_built = false;
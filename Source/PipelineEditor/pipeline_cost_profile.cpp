@@ -0,0 +1,220 @@
+#include "pipeline_cost_profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Json = nlohmann::json;
+
+// Matches the names PipelineBuilder::parsePixelFormat accepts.
+uint32_t formatBytesPerPixel(const std::string& format, bool& known) {
+    static const std::unordered_map<std::string, uint32_t> bytesPerPixel = {
+        {"R8Unorm", 1u},
+        {"R16Float", 2u},
+        {"R32Float", 4u},
+        {"R32Uint", 4u},
+        {"RG8Unorm", 2u},
+        {"RG16Float", 4u},
+        {"RG32Float", 8u},
+        {"RG32Uint", 8u},
+        {"RGBA8Unorm", 4u},
+        {"RGBA8Srgb", 4u},
+        {"RGBA8_SRGB", 4u},
+        {"BGRA8Unorm", 4u},
+        {"RGBA16Float", 8u},
+        {"RGBA32Float", 16u},
+        {"Depth32Float", 4u},
+        {"Depth16Unorm", 2u},
+    };
+    auto it = bytesPerPixel.find(format);
+    known = it != bytesPerPixel.end();
+    return known ? it->second : 4u;
+}
+
+// Same rules as PipelineBuilder::parseTextureDesc.
+void resourceExtent(const ResourceDecl& resource, int screenWidth, int screenHeight, int& width, int& height) {
+    width = screenWidth;
+    height = screenHeight;
+    const size_t xPos = resource.size.find('x');
+    if (resource.size == "screen" || resource.size.empty() || xPos == std::string::npos) {
+        return;
+    }
+    width = std::atoi(resource.size.substr(0, xPos).c_str());
+    height = std::atoi(resource.size.substr(xPos + 1).c_str());
+}
+
+} // namespace
+
+std::string PipelineCostProfile::defaultChannelPath() {
+    if (const char* path = std::getenv("METALLIC_COST_PROFILE")) {
+        if (path[0] != '\0') {
+            return path;
+        }
+    }
+    std::error_code error;
+    const std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(error);
+    if (error) {
+        return "metallic_cost_profile.json";
+    }
+    return (tempDirectory / "metallic_cost_profile.json").string();
+}
+
+bool PipelineCostProfile::publish(const std::string& path) const {
+    Json passArray = Json::array();
+    for (const auto& pass : passes) {
+        passArray.push_back({{"name", pass.name},
+                             {"live", pass.live},
+                             {"gpuAvgMs", pass.gpuAvgMs},
+                             {"gpuMaxMs", pass.gpuMaxMs},
+                             {"gpuMerged", pass.gpuMerged},
+                             {"cpuRecordMs", pass.cpuRecordMs},
+                             {"transientBytes", pass.transientBytes}});
+    }
+    const Json j = {{"pipeline", pipelineName},
+                    {"frameIndex", frameIndex},
+                    {"renderWidth", renderWidth},
+                    {"renderHeight", renderHeight},
+                    {"placedTextureCount", placedTextureCount},
+                    {"aliasedTextureCount", aliasedTextureCount},
+                    {"transientRequestedBytes", transientRequestedBytes},
+                    {"transientHeapBytes", transientHeapBytes},
+                    {"passes", std::move(passArray)}};
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out << j.dump();
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool PipelineCostProfile::read(const std::string& path, PipelineCostProfile& profile) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    try {
+        Json j;
+        file >> j;
+
+        PipelineCostProfile parsed;
+        parsed.pipelineName = j.value("pipeline", std::string{});
+        parsed.frameIndex = j.value("frameIndex", uint64_t{0});
+        parsed.renderWidth = j.value("renderWidth", 0);
+        parsed.renderHeight = j.value("renderHeight", 0);
+        parsed.placedTextureCount = j.value("placedTextureCount", 0u);
+        parsed.aliasedTextureCount = j.value("aliasedTextureCount", 0u);
+        parsed.transientRequestedBytes = j.value("transientRequestedBytes", uint64_t{0});
+        parsed.transientHeapBytes = j.value("transientHeapBytes", uint64_t{0});
+        if (j.contains("passes")) {
+            for (const auto& passJson : j.at("passes")) {
+                PipelinePassCost pass;
+                pass.name = passJson.value("name", std::string{});
+                pass.live = passJson.value("live", false);
+                pass.gpuAvgMs = passJson.value("gpuAvgMs", 0.0f);
+                pass.gpuMaxMs = passJson.value("gpuMaxMs", 0.0f);
+                pass.gpuMerged = passJson.value("gpuMerged", false);
+                pass.cpuRecordMs = passJson.value("cpuRecordMs", 0.0f);
+                pass.transientBytes = passJson.value("transientBytes", uint64_t{0});
+                parsed.passes.push_back(std::move(pass));
+            }
+        }
+        profile = std::move(parsed);
+        return true;
+    } catch (const std::exception& e) {
+        spdlog::debug("PipelineCostProfile: ignoring unreadable '{}': {}", path, e.what());
+        return false;
+    }
+}
+
+const PipelinePassCost* PipelineCostProfile::findPass(const std::string& name) const {
+    for (const auto& pass : passes) {
+        if (pass.name == name) {
+            return &pass;
+        }
+    }
+    return nullptr;
+}
+
+PipelineMemoryEstimate estimatePipelineTransientMemory(const PipelineAsset& asset, int width, int height) {
+    PipelineMemoryEstimate estimate;
+    estimate.width = width;
+    estimate.height = height;
+
+    const std::vector<size_t> order = asset.topologicalSort(false);
+    std::unordered_map<std::string, uint32_t> passPosition;
+    for (size_t position = 0; position < order.size(); ++position) {
+        passPosition.emplace(asset.passes[order[position]].id, static_cast<uint32_t>(position));
+    }
+
+    struct Lifetime {
+        uint32_t first = UINT32_MAX;
+        uint32_t last = 0;
+        std::string producerId;
+    };
+    std::unordered_map<std::string, Lifetime> lifetimes;
+    for (const auto& edge : asset.edges) {
+        auto positionIt = passPosition.find(edge.passId);
+        if (positionIt == passPosition.end()) {
+            continue;
+        }
+        const ResourceDecl* resource = asset.findResourceById(edge.resourceId);
+        if (!resource || resource->kind != "transient" || resource->type != "texture") {
+            continue;
+        }
+        Lifetime& lifetime = lifetimes[resource->id];
+        const uint32_t position = positionIt->second;
+        if (edge.direction == "output" && position < lifetime.first) {
+            lifetime.first = position;
+            lifetime.producerId = edge.passId;
+        }
+        lifetime.last = std::max(lifetime.last, position);
+    }
+
+    std::vector<int64_t> liveDelta(order.size() + 1, 0);
+    for (const auto& [resourceId, lifetime] : lifetimes) {
+        if (lifetime.first == UINT32_MAX) {
+            continue; // read but never produced; validation reports it
+        }
+        const ResourceDecl* resource = asset.findResourceById(resourceId);
+        int resourceWidth = 0;
+        int resourceHeight = 0;
+        resourceExtent(*resource, width, height, resourceWidth, resourceHeight);
+        bool knownFormat = false;
+        const uint64_t bytes = uint64_t(std::max(resourceWidth, 0)) * uint64_t(std::max(resourceHeight, 0)) *
+                               formatBytesPerPixel(resource->format, knownFormat);
+
+        ++estimate.textureCount;
+        estimate.unknownFormatCount += knownFormat ? 0u : 1u;
+        estimate.totalBytes += bytes;
+        estimate.resourceBytes[resourceId] = bytes;
+        estimate.passBytes[lifetime.producerId] += bytes;
+        liveDelta[lifetime.first] += static_cast<int64_t>(bytes);
+        liveDelta[std::max(lifetime.first, lifetime.last) + 1] -= static_cast<int64_t>(bytes);
+    }
+
+    int64_t liveBytes = 0;
+    for (size_t position = 0; position < order.size(); ++position) {
+        liveBytes += liveDelta[position];
+        estimate.peakBytes = std::max(estimate.peakBytes, static_cast<uint64_t>(liveBytes));
+    }
+    return estimate;
+}
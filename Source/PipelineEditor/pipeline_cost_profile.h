@@ -0,0 +1,58 @@
+#pragma once
+
+#include "pipeline_asset.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Measured cost of one frame graph pass, keyed by the PassDecl name it was built from.
+struct PipelinePassCost {
+    std::string name;
+    bool live = false;          // culled passes are listed with zero cost
+    float gpuAvgMs = 0.0f;
+    float gpuMaxMs = 0.0f;
+    bool gpuMerged = false;     // GPU time covers the whole merged render pass
+    float cpuRecordMs = 0.0f;   // command recording on the CPU, last frame
+    uint64_t transientBytes = 0; // transients the pass creates
+};
+
+// Per-pass costs of the pipeline a running Metallic is drawing. The renderer publishes it
+// to a small JSON file that the Pipeline Editor polls; the file is replaced atomically so
+// the editor never reads a half-written snapshot.
+struct PipelineCostProfile {
+    std::string pipelineName;
+    uint64_t frameIndex = 0;
+    int renderWidth = 0;
+    int renderHeight = 0;
+    uint32_t placedTextureCount = 0;
+    uint32_t aliasedTextureCount = 0;
+    uint64_t transientRequestedBytes = 0;
+    uint64_t transientHeapBytes = 0;
+    std::vector<PipelinePassCost> passes;
+
+    // METALLIC_COST_PROFILE overrides the default file in the temp directory.
+    static std::string defaultChannelPath();
+
+    bool publish(const std::string& path) const;
+    static bool read(const std::string& path, PipelineCostProfile& profile);
+
+    const PipelinePassCost* findPass(const std::string& name) const;
+};
+
+// Transient texture memory estimated from the asset alone, at a given screen size.
+// Lifetimes follow the topological pass order; peakBytes is what perfect aliasing of
+// disjoint lifetimes would need, so real heaps land between it and totalBytes.
+struct PipelineMemoryEstimate {
+    int width = 0;
+    int height = 0;
+    uint64_t totalBytes = 0;
+    uint64_t peakBytes = 0;
+    uint32_t textureCount = 0;
+    uint32_t unknownFormatCount = 0; // counted as BGRA8, like PipelineBuilder does
+    std::unordered_map<std::string, uint64_t> resourceBytes; // by resource id
+    std::unordered_map<std::string, uint64_t> passBytes;     // produced, by pass id
+};
+
+PipelineMemoryEstimate estimatePipelineTransientMemory(const PipelineAsset& asset, int width, int height);
@@ -1,7 +1,9 @@
 #define NS_PRIVATE_IMPLEMENTATION
 #define MTL_PRIVATE_IMPLEMENTATION
 #define CA_PRIVATE_IMPLEMENTATION
+#define MTLFX_PRIVATE_IMPLEMENTATION
 
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
+#include <MetalFX/MetalFX.hpp>
 #include <QuartzCore/QuartzCore.hpp>
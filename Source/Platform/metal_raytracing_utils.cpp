@@ -2,6 +2,7 @@
 
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace {
@@ -49,6 +50,7 @@ void fillInstanceDescriptor(MTL::AccelerationStructureInstanceDescriptor& destin
 
 bool writeInstanceDescriptors(void* instanceDescriptorBufferHandle,
                               const MetalRayTracingInstanceDesc* instances,
+                              uint32_t firstInstance,
                               uint32_t instanceCount,
                               std::string& errorMessage) {
     auto* descriptorBuffer = metalBuffer(instanceDescriptorBufferHandle);
@@ -63,7 +65,7 @@ bool writeInstanceDescriptors(void* instanceDescriptorBufferHandle,
         return false;
     }
 
-    for (uint32_t index = 0; index < instanceCount; ++index) {
+    for (uint32_t index = firstInstance; index < firstInstance + instanceCount; ++index) {
         fillInstanceDescriptor(destination[index], instances[index]);
     }
     return true;
@@ -139,9 +141,13 @@ bool metalBuildBottomLevelAccelerationStructure(void* deviceHandle,
         return false;
     }
 
+    auto* compactedSizeBuffer = device->newBuffer(sizeof(uint32_t), MTL::ResourceStorageModeShared);
     auto* commandBuffer = commandQueue->commandBuffer();
     auto* encoder = commandBuffer->accelerationStructureCommandEncoder();
     encoder->buildAccelerationStructure(accelerationStructure, accelerationDescriptor, scratchBuffer, 0);
+    if (compactedSizeBuffer) {
+        encoder->writeCompactedAccelerationStructureSize(accelerationStructure, compactedSizeBuffer, 0);
+    }
     encoder->endEncoding();
     commandBuffer->commit();
     commandBuffer->waitUntilCompleted();
@@ -152,6 +158,27 @@ bool metalBuildBottomLevelAccelerationStructure(void* deviceHandle,
         descriptor->release();
     }
 
+    // Copy into an allocation of the compacted size; on any failure the
+    // uncompacted BLAS is kept.
+    const uint32_t compactedSize =
+        compactedSizeBuffer ? *static_cast<const uint32_t*>(compactedSizeBuffer->contents()) : 0u;
+    if (compactedSizeBuffer) {
+        compactedSizeBuffer->release();
+    }
+    if (compactedSize > 0 && compactedSize < accelerationStructure->size()) {
+        auto* compacted = device->newAccelerationStructure(compactedSize);
+        if (compacted) {
+            auto* compactCommandBuffer = commandQueue->commandBuffer();
+            auto* compactEncoder = compactCommandBuffer->accelerationStructureCommandEncoder();
+            compactEncoder->copyAndCompactAccelerationStructure(accelerationStructure, compacted);
+            compactEncoder->endEncoding();
+            compactCommandBuffer->commit();
+            compactCommandBuffer->waitUntilCompleted();
+            accelerationStructure->release();
+            accelerationStructure = compacted;
+        }
+    }
+
     outAccelerationStructure = accelerationStructure;
     return true;
 }
@@ -188,7 +215,7 @@ bool metalBuildTopLevelAccelerationStructure(void* deviceHandle,
         errorMessage = "Failed to allocate TLAS instance descriptor buffer";
         return false;
     }
-    if (!writeInstanceDescriptors(outInstanceDescriptorBuffer, instances, instanceCount, errorMessage)) {
+    if (!writeInstanceDescriptors(outInstanceDescriptorBuffer, instances, 0, instanceCount, errorMessage)) {
         static_cast<MTL::Buffer*>(outInstanceDescriptorBuffer)->release();
         outInstanceDescriptorBuffer = nullptr;
         return false;
@@ -200,10 +227,13 @@ bool metalBuildTopLevelAccelerationStructure(void* deviceHandle,
     accelerationDescriptor->setInstanceDescriptorType(MTL::AccelerationStructureInstanceDescriptorTypeDefault);
     accelerationDescriptor->setInstancedAccelerationStructures(
         accelerationStructureArray(referencedAccelerationStructures, referencedAccelerationStructureCount));
+    accelerationDescriptor->setUsage(MTL::AccelerationStructureUsageRefit);
 
+    // The scratch buffer is kept for per-frame refits and in-place rebuilds.
     auto sizes = device->accelerationStructureSizes(accelerationDescriptor);
     outAccelerationStructure = device->newAccelerationStructure(sizes.accelerationStructureSize);
-    outScratchBuffer = device->newBuffer(sizes.buildScratchBufferSize, MTL::ResourceStorageModePrivate);
+    outScratchBuffer = device->newBuffer(std::max(sizes.buildScratchBufferSize, sizes.refitScratchBufferSize),
+                                         MTL::ResourceStorageModePrivate);
     if (!outAccelerationStructure || !outScratchBuffer) {
         errorMessage = "Failed to allocate TLAS resources";
         if (outAccelerationStructure) {
@@ -239,6 +269,9 @@ bool metalUpdateTopLevelAccelerationStructure(void* commandBufferHandle,
                                               uint32_t referencedAccelerationStructureCount,
                                               const MetalRayTracingInstanceDesc* instances,
                                               uint32_t instanceCount,
+                                              uint32_t firstDirtyInstance,
+                                              uint32_t dirtyInstanceCount,
+                                              bool rebuild,
                                               void* accelerationStructureHandle,
                                               void* instanceDescriptorBufferHandle,
                                               void* scratchBufferHandle,
@@ -257,7 +290,16 @@ bool metalUpdateTopLevelAccelerationStructure(void* commandBufferHandle,
         return false;
     }
 
-    if (!writeInstanceDescriptors(instanceDescriptorBufferHandle, instances, instanceCount, errorMessage)) {
+    if (firstDirtyInstance > instanceCount || dirtyInstanceCount > instanceCount - firstDirtyInstance) {
+        errorMessage = "TLAS dirty instance range exceeds the instance count";
+        return false;
+    }
+
+    if (!writeInstanceDescriptors(instanceDescriptorBufferHandle,
+                                  instances,
+                                  firstDirtyInstance,
+                                  dirtyInstanceCount,
+                                  errorMessage)) {
         return false;
     }
 
@@ -267,12 +309,23 @@ bool metalUpdateTopLevelAccelerationStructure(void* commandBufferHandle,
     accelerationDescriptor->setInstanceDescriptorType(MTL::AccelerationStructureInstanceDescriptorTypeDefault);
     accelerationDescriptor->setInstancedAccelerationStructures(
         accelerationStructureArray(referencedAccelerationStructures, referencedAccelerationStructureCount));
+    accelerationDescriptor->setUsage(MTL::AccelerationStructureUsageRefit);
 
+    // A refit keeps the hierarchy and only moves its bounds; a nil destination
+    // refits in place.
     auto* encoder = commandBuffer->accelerationStructureCommandEncoder();
-    encoder->buildAccelerationStructure(metalAccelerationStructure(accelerationStructureHandle),
-                                        accelerationDescriptor,
-                                        metalBuffer(scratchBufferHandle),
-                                        0);
+    if (rebuild) {
+        encoder->buildAccelerationStructure(metalAccelerationStructure(accelerationStructureHandle),
+                                            accelerationDescriptor,
+                                            metalBuffer(scratchBufferHandle),
+                                            0);
+    } else {
+        encoder->refitAccelerationStructure(metalAccelerationStructure(accelerationStructureHandle),
+                                            accelerationDescriptor,
+                                            nullptr,
+                                            metalBuffer(scratchBufferHandle),
+                                            0);
+    }
     encoder->endEncoding();
     accelerationDescriptor->release();
     return true;
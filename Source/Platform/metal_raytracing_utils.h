@@ -41,6 +41,9 @@ bool metalUpdateTopLevelAccelerationStructure(void* commandBufferHandle,
                                               uint32_t referencedAccelerationStructureCount,
                                               const MetalRayTracingInstanceDesc* instances,
                                               uint32_t instanceCount,
+                                              uint32_t firstDirtyInstance,
+                                              uint32_t dirtyInstanceCount,
+                                              bool rebuild,
                                               void* accelerationStructureHandle,
                                               void* instanceDescriptorBufferHandle,
                                               void* scratchBufferHandle,
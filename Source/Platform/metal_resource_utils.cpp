@@ -3,6 +3,10 @@
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace {
 
 MTL::Device* metalDevice(void* handle) {
@@ -34,6 +38,7 @@ MTL::PixelFormat metalPixelFormat(RhiFormat format) {
     case RhiFormat::RGBA16Float: return MTL::PixelFormatRGBA16Float;
     case RhiFormat::RGBA32Float: return MTL::PixelFormatRGBA32Float;
     case RhiFormat::D32Float: return MTL::PixelFormatDepth32Float;
+    case RhiFormat::BC7RGBAUnorm: return MTL::PixelFormatBC7_RGBAUnorm;
     case RhiFormat::Undefined:
     default:
         return MTL::PixelFormatInvalid;
@@ -57,6 +62,7 @@ MTL::TextureUsage metalTextureUsage(RhiTextureUsage usage) {
 MTL::StorageMode metalStorageMode(RhiTextureStorageMode storageMode) {
     switch (storageMode) {
     case RhiTextureStorageMode::Shared: return MTL::StorageModeShared;
+    case RhiTextureStorageMode::Memoryless: return MTL::StorageModeMemoryless;
     case RhiTextureStorageMode::Private:
     default:
         return MTL::StorageModePrivate;
@@ -90,6 +96,35 @@ MTL::SamplerAddressMode metalSamplerAddressMode(MetalSamplerAddressMode mode) {
     }
 }
 
+std::mutex g_queueResidencyMutex;
+std::unordered_map<void*, MTL::ResidencySet*> g_queueResidencySets;
+
+struct MetalTransferQueue {
+    MTL::CommandQueue* queue = nullptr;
+    MTL::SharedEvent* event = nullptr;
+    uint64_t lastSignaledValue = 0;
+};
+
+std::mutex g_transferQueueMutex;
+MetalTransferQueue g_transferQueue;
+
+bool metalSupportsResidencySets() {
+    static const bool supported =
+        NS::ProcessInfo::processInfo()->isOperatingSystemAtLeastVersion({15, 0, 0});
+    return supported;
+}
+
+std::vector<const MTL::Allocation*> metalAllocations(const void* const* handles, size_t count) {
+    std::vector<const MTL::Allocation*> allocations;
+    allocations.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (handles[i]) {
+            allocations.push_back(static_cast<const MTL::Allocation*>(handles[i]));
+        }
+    }
+    return allocations;
+}
+
 } // namespace
 
 void* metalCreateSharedBuffer(void* deviceHandle,
@@ -221,6 +256,25 @@ void metalGenerateMipmaps(void* commandQueueHandle, void* textureHandle) {
     commandBuffer->waitUntilCompleted();
 }
 
+void metalGenerateMipmaps(void* commandQueueHandle, void* const* textureHandles, size_t textureCount) {
+    auto* commandQueue = metalCommandQueue(commandQueueHandle);
+    if (!commandQueue || textureCount == 0) {
+        return;
+    }
+
+    auto* commandBuffer = commandQueue->commandBuffer();
+    auto* blitEncoder = commandBuffer->blitCommandEncoder();
+    for (size_t i = 0; i < textureCount; ++i) {
+        auto* texture = metalTexture(textureHandles[i]);
+        if (texture && texture->mipmapLevelCount() > 1) {
+            blitEncoder->generateMipmaps(texture);
+        }
+    }
+    blitEncoder->endEncoding();
+    commandBuffer->commit();
+    commandBuffer->waitUntilCompleted();
+}
+
 void* metalCreateSampler(void* deviceHandle, const MetalSamplerDesc& desc) {
     auto* device = metalDevice(deviceHandle);
     if (!device) {
@@ -234,6 +288,7 @@ void* metalCreateSampler(void* deviceHandle, const MetalSamplerDesc& desc) {
     samplerDesc->setSAddressMode(metalSamplerAddressMode(desc.addressModeS));
     samplerDesc->setTAddressMode(metalSamplerAddressMode(desc.addressModeT));
     samplerDesc->setRAddressMode(metalSamplerAddressMode(desc.addressModeR));
+    samplerDesc->setSupportArgumentBuffers(true);
 
     auto* sampler = device->newSamplerState(samplerDesc);
     samplerDesc->release();
@@ -261,6 +316,17 @@ bool metalSupportsRaytracing(void* deviceHandle) {
     return device && device->supportsRaytracing();
 }
 
+bool metalSupportsTextureFormat(void* deviceHandle, RhiFormat format) {
+    auto* device = metalDevice(deviceHandle);
+    if (!device || metalPixelFormat(format) == MTL::PixelFormatInvalid) {
+        return false;
+    }
+    if (format == RhiFormat::BC7RGBAUnorm) {
+        return device->supportsBCTextureCompression();
+    }
+    return true;
+}
+
 uint32_t metalTextureWidth(void* textureHandle) {
     auto* texture = metalTexture(textureHandle);
     return texture ? static_cast<uint32_t>(texture->width()) : 0;
@@ -271,6 +337,149 @@ uint32_t metalTextureHeight(void* textureHandle) {
     return texture ? static_cast<uint32_t>(texture->height()) : 0;
 }
 
+bool metalAddQueueResidency(void* commandQueueHandle, const void* const* allocationHandles, size_t count) {
+    auto* commandQueue = metalCommandQueue(commandQueueHandle);
+    if (!commandQueue || !metalSupportsResidencySets()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_queueResidencyMutex);
+    MTL::ResidencySet*& residencySet = g_queueResidencySets[commandQueueHandle];
+    if (!residencySet) {
+        auto* desc = MTL::ResidencySetDescriptor::alloc()->init();
+        desc->setLabel(NS::String::string("Queue Residency", NS::UTF8StringEncoding));
+        NS::Error* error = nullptr;
+        residencySet = commandQueue->device()->newResidencySet(desc, &error);
+        desc->release();
+        if (!residencySet) {
+            g_queueResidencySets.erase(commandQueueHandle);
+            return false;
+        }
+        commandQueue->addResidencySet(residencySet);
+    }
+
+    auto allocations = metalAllocations(allocationHandles, count);
+    residencySet->addAllocations(allocations.data(), allocations.size());
+    residencySet->commit();
+    return true;
+}
+
+void metalRemoveQueueResidency(void* commandQueueHandle, const void* const* allocationHandles, size_t count) {
+    std::lock_guard<std::mutex> lock(g_queueResidencyMutex);
+    auto it = g_queueResidencySets.find(commandQueueHandle);
+    if (it == g_queueResidencySets.end()) {
+        return;
+    }
+    auto allocations = metalAllocations(allocationHandles, count);
+    it->second->removeAllocations(allocations.data(), allocations.size());
+    it->second->commit();
+}
+
+void metalReleaseQueueResidency(void* commandQueueHandle) {
+    std::lock_guard<std::mutex> lock(g_queueResidencyMutex);
+    auto it = g_queueResidencySets.find(commandQueueHandle);
+    if (it == g_queueResidencySets.end()) {
+        return;
+    }
+    if (auto* commandQueue = metalCommandQueue(commandQueueHandle)) {
+        commandQueue->removeResidencySet(it->second);
+    }
+    it->second->release();
+    g_queueResidencySets.erase(it);
+}
+
+bool metalCreateTransferQueue(void* deviceHandle) {
+    metalDestroyTransferQueue();
+
+    auto* device = metalDevice(deviceHandle);
+    if (!device) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_transferQueueMutex);
+    g_transferQueue.queue = device->newCommandQueue();
+    g_transferQueue.event = device->newSharedEvent();
+    if (!g_transferQueue.queue || !g_transferQueue.event) {
+        if (g_transferQueue.queue) {
+            g_transferQueue.queue->release();
+        }
+        if (g_transferQueue.event) {
+            g_transferQueue.event->release();
+        }
+        g_transferQueue = {};
+        return false;
+    }
+    g_transferQueue.queue->setLabel(NS::String::string("Transfer Queue", NS::UTF8StringEncoding));
+    g_transferQueue.event->setLabel(NS::String::string("Transfer Timeline", NS::UTF8StringEncoding));
+    return true;
+}
+
+void metalDestroyTransferQueue() {
+    std::lock_guard<std::mutex> lock(g_transferQueueMutex);
+    if (g_transferQueue.event) {
+        // Let in-flight copies land before the queue goes away.
+        g_transferQueue.event->waitUntilSignaledValue(g_transferQueue.lastSignaledValue, UINT64_MAX);
+        g_transferQueue.event->release();
+    }
+    if (g_transferQueue.queue) {
+        g_transferQueue.queue->release();
+    }
+    g_transferQueue = {};
+}
+
+bool metalHasTransferQueue() {
+    std::lock_guard<std::mutex> lock(g_transferQueueMutex);
+    return g_transferQueue.queue != nullptr;
+}
+
+uint64_t metalSubmitBufferCopies(void* srcBufferHandle,
+                                 void* dstBufferHandle,
+                                 const MetalBufferCopy* copies,
+                                 size_t count) {
+    auto* srcBuffer = static_cast<MTL::Buffer*>(srcBufferHandle);
+    auto* dstBuffer = static_cast<MTL::Buffer*>(dstBufferHandle);
+    if (!srcBuffer || !dstBuffer || !copies || count == 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(g_transferQueueMutex);
+    if (!g_transferQueue.queue) {
+        return 0;
+    }
+
+    MTL::CommandBuffer* commandBuffer = g_transferQueue.queue->commandBuffer();
+    if (!commandBuffer) {
+        return 0;
+    }
+    commandBuffer->setLabel(NS::String::string("Streaming Transfer", NS::UTF8StringEncoding));
+
+    MTL::BlitCommandEncoder* encoder = commandBuffer->blitCommandEncoder();
+    for (size_t i = 0; i < count; ++i) {
+        if (copies[i].size == 0) {
+            continue;
+        }
+        encoder->copyFromBuffer(srcBuffer, copies[i].srcOffset, dstBuffer, copies[i].dstOffset, copies[i].size);
+    }
+    encoder->endEncoding();
+
+    const uint64_t signalValue = ++g_transferQueue.lastSignaledValue;
+    commandBuffer->encodeSignalEvent(g_transferQueue.event, signalValue);
+    commandBuffer->commit();
+    return signalValue;
+}
+
+void metalEncodeTransferWait(void* commandBufferHandle, uint64_t value) {
+    auto* commandBuffer = static_cast<MTL::CommandBuffer*>(commandBufferHandle);
+    if (!commandBuffer || value == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_transferQueueMutex);
+    if (g_transferQueue.event) {
+        commandBuffer->encodeWait(g_transferQueue.event, value);
+    }
+}
+
 void* metalRetainHandle(void* handle) {
     auto* object = metalObject(handle);
     return object ? object->retain() : nullptr;
@@ -65,12 +65,41 @@ void metalUploadTexture3D(void* textureHandle,
                           size_t bytesPerImage,
                           uint32_t mipLevel = 0);
 void metalGenerateMipmaps(void* commandQueueHandle, void* textureHandle);
+void metalGenerateMipmaps(void* commandQueueHandle, void* const* textureHandles, size_t textureCount);
 
 void* metalCreateSampler(void* deviceHandle, const MetalSamplerDesc& desc);
 void* metalCreateDepthStencilState(void* deviceHandle, bool depthWriteEnabled, bool reversedZ);
 bool metalSupportsRaytracing(void* deviceHandle);
+bool metalSupportsTextureFormat(void* deviceHandle, RhiFormat format);
 uint32_t metalTextureWidth(void* textureHandle);
 uint32_t metalTextureHeight(void* textureHandle);
 
+// Queue-wide residency set (macOS 15+). Allocations added here stay resident for
+// every command buffer on the queue, so encoders need no useResource for them.
+// Add returns false when residency sets are unavailable.
+bool metalAddQueueResidency(void* commandQueueHandle, const void* const* allocationHandles, size_t count);
+void metalRemoveQueueResidency(void* commandQueueHandle, const void* const* allocationHandles, size_t count);
+void metalReleaseQueueResidency(void* commandQueueHandle);
+
+struct MetalBufferCopy {
+    uint64_t srcOffset = 0;
+    uint64_t dstOffset = 0;
+    uint64_t size = 0;
+};
+
+// Secondary command queue for streaming copies. Each submission signals the next
+// value of a shared event; render command buffers wait on that value before reading
+// the destination, the same contract as a Vulkan transfer timeline semaphore.
+bool metalCreateTransferQueue(void* deviceHandle);
+void metalDestroyTransferQueue();
+bool metalHasTransferQueue();
+// Returns the signal value for the copies, or 0 when there is no transfer queue.
+uint64_t metalSubmitBufferCopies(void* srcBufferHandle,
+                                 void* dstBufferHandle,
+                                 const MetalBufferCopy* copies,
+                                 size_t count);
+// Encodes a wait on the transfer event; must be called between encoders.
+void metalEncodeTransferWait(void* commandBufferHandle, uint64_t value);
+
 void* metalRetainHandle(void* handle);
 void metalReleaseHandle(void* handle);
@@ -1,6 +1,7 @@
 #include "metal_runtime.h"
 
 #include "glfw_metal_bridge.h"
+#include "metal_resource_utils.h"
 
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
@@ -73,6 +74,7 @@ void destroyMetalRuntime(MetalRuntimeContext& runtime) {
         runtime.tracyContext = nullptr;
     }
     if (runtime.commandQueue) {
+        metalReleaseQueueResidency(runtime.commandQueue);
         metalCommandQueue(runtime.commandQueue)->release();
         runtime.commandQueue = nullptr;
     }
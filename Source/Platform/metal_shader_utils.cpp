@@ -3,8 +3,18 @@
 #include <Foundation/Foundation.hpp>
 #include <Metal/Metal.hpp>
 
+#include <filesystem>
+#include <mutex>
+
 namespace {
 
+// Process-wide PSO archive, like the Metal transfer queue. ShaderManager creates
+// pipelines on several workers, so recording into it is serialized.
+std::mutex g_pipelineArchiveMutex;
+MTL::BinaryArchive* g_pipelineArchive = nullptr;
+std::string g_pipelineArchivePath;
+bool g_pipelineArchiveDirty = false;
+
 MTL::Device* metalDevice(void* handle) {
     return static_cast<MTL::Device*>(handle);
 }
@@ -16,6 +26,7 @@ MTL::VertexDescriptor* metalVertexDescriptor(void* handle) {
 MTL::PixelFormat metalPixelFormat(RhiFormat format) {
     switch (format) {
     case RhiFormat::R32Uint: return MTL::PixelFormatR32Uint;
+    case RhiFormat::RG32Uint: return MTL::PixelFormatRG32Uint;
     case RhiFormat::RGBA8Srgb: return MTL::PixelFormatRGBA8Unorm_sRGB;
     case RhiFormat::RGBA16Float: return MTL::PixelFormatRGBA16Float;
     case RhiFormat::BGRA8Unorm: return MTL::PixelFormatBGRA8Unorm;
@@ -41,6 +52,22 @@ std::string metalErrorMessage(NS::Error* error, const char* fallback) {
     return fallback ? fallback : "Unknown Metal error";
 }
 
+void applyMetalBlendMode(MTL::RenderPipelineColorAttachmentDescriptor* attachment, RhiBlendMode mode) {
+    if (mode == RhiBlendMode::Opaque) {
+        return;
+    }
+    const bool additive = mode == RhiBlendMode::Additive;
+    attachment->setBlendingEnabled(true);
+    attachment->setRgbBlendOperation(MTL::BlendOperationAdd);
+    attachment->setAlphaBlendOperation(MTL::BlendOperationAdd);
+    attachment->setSourceRGBBlendFactor(additive ? MTL::BlendFactorOne : MTL::BlendFactorZero);
+    attachment->setSourceAlphaBlendFactor(additive ? MTL::BlendFactorOne : MTL::BlendFactorZero);
+    attachment->setDestinationRGBBlendFactor(additive ? MTL::BlendFactorOne
+                                                      : MTL::BlendFactorOneMinusSourceColor);
+    attachment->setDestinationAlphaBlendFactor(additive ? MTL::BlendFactorOne
+                                                        : MTL::BlendFactorOneMinusSourceAlpha);
+}
+
 MTL::Library* metalLibrary(void* handle) {
     return static_cast<MTL::Library*>(handle);
 }
@@ -54,6 +81,46 @@ MTL::LanguageVersion metalLanguageVersion(uint32_t version) {
     }
 }
 
+MTL::BinaryArchive* retainPipelineArchive() {
+    std::lock_guard<std::mutex> lock(g_pipelineArchiveMutex);
+    if (g_pipelineArchive) {
+        g_pipelineArchive->retain();
+    }
+    return g_pipelineArchive;
+}
+
+// Creates a pipeline through the open archive: the first attempt only accepts an
+// archived binary, a miss compiles normally and records the pipeline's functions so
+// the next run finds them. create(options) builds the pipeline from descriptor.
+template <typename Descriptor, typename Create>
+void* createArchivedPipeline(Descriptor* descriptor,
+                             Create create,
+                             bool (MTL::BinaryArchive::*record)(const Descriptor*, NS::Error**)) {
+    MTL::BinaryArchive* archive = retainPipelineArchive();
+    if (!archive) {
+        return create(MTL::PipelineOptionNone);
+    }
+
+    const NS::Object* archives[] = {archive};
+    auto* archiveArray = NS::Array::alloc()->init(archives, 1);
+    descriptor->setBinaryArchives(archiveArray);
+    void* pipeline = create(MTL::PipelineOptionFailOnBinaryArchiveMiss);
+    if (!pipeline) {
+        pipeline = create(MTL::PipelineOptionNone);
+        if (pipeline) {
+            std::lock_guard<std::mutex> lock(g_pipelineArchiveMutex);
+            NS::Error* error = nullptr;
+            if ((archive->*record)(descriptor, &error)) {
+                g_pipelineArchiveDirty = true;
+            }
+        }
+    }
+    descriptor->setBinaryArchives(nullptr);
+    archiveArray->release();
+    archive->release();
+    return pipeline;
+}
+
 MTL::Library* metalCreateLibraryImpl(void* deviceHandle,
                                      const std::string& source,
                                      const MetalShaderLibraryDesc& desc,
@@ -161,21 +228,24 @@ void* metalCreateRenderPipelineFromSource(void* deviceHandle,
         pipelineDesc->setMeshFunction(meshFunction);
         pipelineDesc->setFragmentFunction(fragmentFunction);
         pipelineDesc->colorAttachments()->object(0)->setPixelFormat(colorFormat);
+        applyMetalBlendMode(pipelineDesc->colorAttachments()->object(0), desc.blendMode);
         if (depthFormat != MTL::PixelFormatInvalid) {
             pipelineDesc->setDepthAttachmentPixelFormat(depthFormat);
         }
 
         NS::Error* error = nullptr;
-        MTL::RenderPipelineReflection* reflection = nullptr;
-        pipeline = device->newRenderPipelineState(
+        pipeline = createArchivedPipeline(
             pipelineDesc,
-            MTL::PipelineOptionNone,
-            &reflection,
-            &error);
+            [&](MTL::PipelineOption options) -> void* {
+                MTL::RenderPipelineReflection* reflection = nullptr;
+                void* state = device->newRenderPipelineState(pipelineDesc, options, &reflection, &error);
+                if (reflection) {
+                    reflection->release();
+                }
+                return state;
+            },
+            &MTL::BinaryArchive::addMeshRenderPipelineFunctions);
 
-        if (reflection) {
-            reflection->release();
-        }
         pipelineDesc->release();
         meshFunction->release();
         if (fragmentFunction) fragmentFunction->release();
@@ -203,6 +273,7 @@ void* metalCreateRenderPipelineFromSource(void* deviceHandle,
         pipelineDesc->setVertexFunction(vertexFunction);
         pipelineDesc->setFragmentFunction(fragmentFunction);
         pipelineDesc->colorAttachments()->object(0)->setPixelFormat(colorFormat);
+        applyMetalBlendMode(pipelineDesc->colorAttachments()->object(0), desc.blendMode);
         if (depthFormat != MTL::PixelFormatInvalid) {
             pipelineDesc->setDepthAttachmentPixelFormat(depthFormat);
         }
@@ -211,7 +282,12 @@ void* metalCreateRenderPipelineFromSource(void* deviceHandle,
         }
 
         NS::Error* error = nullptr;
-        pipeline = device->newRenderPipelineState(pipelineDesc, &error);
+        pipeline = createArchivedPipeline(
+            pipelineDesc,
+            [&](MTL::PipelineOption options) -> void* {
+                return device->newRenderPipelineState(pipelineDesc, options, nullptr, &error);
+            },
+            &MTL::BinaryArchive::addRenderPipelineFunctions);
 
         pipelineDesc->release();
         if (vertexFunction) vertexFunction->release();
@@ -247,8 +323,17 @@ void* metalCreateComputePipelineFromLibrary(void* deviceHandle,
         return nullptr;
     }
 
+    auto* pipelineDesc = MTL::ComputePipelineDescriptor::alloc()->init();
+    pipelineDesc->setComputeFunction(function);
+
     NS::Error* error = nullptr;
-    void* pipeline = device->newComputePipelineState(function, &error);
+    void* pipeline = createArchivedPipeline(
+        pipelineDesc,
+        [&](MTL::PipelineOption options) -> void* {
+            return device->newComputePipelineState(pipelineDesc, options, nullptr, &error);
+        },
+        &MTL::BinaryArchive::addComputePipelineFunctions);
+    pipelineDesc->release();
     function->release();
 
     if (!pipeline) {
@@ -277,3 +362,116 @@ void* metalCreateComputePipelineFromSource(void* deviceHandle,
 
     return pipeline;
 }
+
+std::vector<RhiPipelineExecutableStats> metalRenderPipelineStats(void* pipelineHandle) {
+    std::vector<RhiPipelineExecutableStats> executables;
+    auto* pipeline = static_cast<MTL::RenderPipelineState*>(pipelineHandle);
+    if (!pipeline) {
+        return executables;
+    }
+    // Vertex pipelines report zero for the mesh limits.
+    if (pipeline->maxTotalThreadsPerMeshThreadgroup() != 0) {
+        RhiPipelineExecutableStats& mesh = executables.emplace_back();
+        mesh.name = "Mesh";
+        mesh.subgroupSize = static_cast<uint32_t>(pipeline->meshThreadExecutionWidth());
+        mesh.statistics.push_back({"Max Threads Per Threadgroup",
+                                   "Largest mesh threadgroup the compiled shader can run",
+                                   static_cast<double>(pipeline->maxTotalThreadsPerMeshThreadgroup())});
+    }
+    return executables;
+}
+
+std::vector<RhiPipelineExecutableStats> metalComputePipelineStats(void* pipelineHandle) {
+    std::vector<RhiPipelineExecutableStats> executables;
+    auto* pipeline = static_cast<MTL::ComputePipelineState*>(pipelineHandle);
+    if (!pipeline) {
+        return executables;
+    }
+    RhiPipelineExecutableStats& compute = executables.emplace_back();
+    compute.name = "Compute";
+    compute.subgroupSize = static_cast<uint32_t>(pipeline->threadExecutionWidth());
+    compute.statistics.push_back({"Max Threads Per Threadgroup",
+                                  "Largest threadgroup the compiled kernel can run",
+                                  static_cast<double>(pipeline->maxTotalThreadsPerThreadgroup())});
+    compute.statistics.push_back({"Static Threadgroup Memory",
+                                  "Bytes of threadgroup memory the kernel declares",
+                                  static_cast<double>(pipeline->staticThreadgroupMemoryLength())});
+    return executables;
+}
+
+bool metalOpenPipelineArchive(void* deviceHandle, const std::string& path, std::string& errorMessage) {
+    auto* device = metalDevice(deviceHandle);
+    if (!device) {
+        errorMessage = "Missing Metal device";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_pipelineArchiveMutex);
+    if (g_pipelineArchive) {
+        g_pipelineArchive->release();
+        g_pipelineArchive = nullptr;
+    }
+
+    auto* archiveDesc = MTL::BinaryArchiveDescriptor::alloc()->init();
+    NS::URL* url = nullptr;
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+        url = NS::URL::alloc()->initFileURLWithPath(NS::String::string(path.c_str(), NS::UTF8StringEncoding));
+        archiveDesc->setUrl(url);
+    }
+
+    NS::Error* error = nullptr;
+    g_pipelineArchive = device->newBinaryArchive(archiveDesc, &error);
+    if (!g_pipelineArchive && url) {
+        // Written by another OS or GPU: start over with an empty archive.
+        archiveDesc->setUrl(nullptr);
+        g_pipelineArchive = device->newBinaryArchive(archiveDesc, &error);
+    }
+    archiveDesc->release();
+    if (url) {
+        url->release();
+    }
+
+    if (!g_pipelineArchive) {
+        errorMessage = metalErrorMessage(error, "Failed to create Metal binary archive");
+        return false;
+    }
+    g_pipelineArchivePath = path;
+    g_pipelineArchiveDirty = false;
+    return true;
+}
+
+bool metalSavePipelineArchive(std::string& errorMessage) {
+    std::lock_guard<std::mutex> lock(g_pipelineArchiveMutex);
+    if (!g_pipelineArchive || !g_pipelineArchiveDirty) {
+        return true;
+    }
+
+    const std::filesystem::path archivePath(g_pipelineArchivePath);
+    std::error_code ec;
+    if (archivePath.has_parent_path()) {
+        std::filesystem::create_directories(archivePath.parent_path(), ec);
+    }
+
+    auto* url = NS::URL::alloc()->initFileURLWithPath(
+        NS::String::string(g_pipelineArchivePath.c_str(), NS::UTF8StringEncoding));
+    NS::Error* error = nullptr;
+    const bool saved = g_pipelineArchive->serializeToURL(url, &error);
+    url->release();
+    if (!saved) {
+        errorMessage = metalErrorMessage(error, "Failed to serialize Metal binary archive");
+        return false;
+    }
+    g_pipelineArchiveDirty = false;
+    return true;
+}
+
+void metalClosePipelineArchive() {
+    std::lock_guard<std::mutex> lock(g_pipelineArchiveMutex);
+    if (g_pipelineArchive) {
+        g_pipelineArchive->release();
+        g_pipelineArchive = nullptr;
+    }
+    g_pipelineArchivePath.clear();
+    g_pipelineArchiveDirty = false;
+}
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "rhi_backend.h"
 
@@ -22,6 +23,7 @@ struct MetalRenderPipelineDesc {
     RhiFormat colorFormat = RhiFormat::BGRA8Unorm;
     RhiFormat depthFormat = RhiFormat::Undefined;
     void* vertexDescriptorHandle = nullptr;
+    RhiBlendMode blendMode = RhiBlendMode::Opaque;
 };
 
 struct MetalShaderLibraryDesc {
@@ -44,3 +46,16 @@ void* metalCreateComputePipelineFromSource(void* deviceHandle,
                                            const std::string& source,
                                            const char* entryPoint,
                                            std::string& errorMessage);
+
+// Metal exposes no register or spill counts, only the threadgroup limits the compiler
+// settled on; a lower maximum than requested points at register pressure.
+std::vector<RhiPipelineExecutableStats> metalRenderPipelineStats(void* pipelineHandle);
+std::vector<RhiPipelineExecutableStats> metalComputePipelineStats(void* pipelineHandle);
+
+// MTLBinaryArchive-backed PSO cache, the Metal counterpart of VulkanPipelineCacheManager.
+// While an archive is open, every pipeline created above is looked up in it first and
+// recorded into it on a miss. Save writes it back to path when something was added; an
+// archive the device cannot read is replaced by an empty one.
+bool metalOpenPipelineArchive(void* deviceHandle, const std::string& path, std::string& errorMessage);
+bool metalSavePipelineArchive(std::string& errorMessage);
+void metalClosePipelineArchive();
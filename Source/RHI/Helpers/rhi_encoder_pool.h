@@ -0,0 +1,56 @@
+#pragma once
+
+#include "rhi_backend.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Storage for one backend encoder type. acquire() constructs the encoder in a free slot
+// and returns it with an RhiEncoderRelease that destroys it and frees the slot, so a
+// pass costs no heap allocation once the pool has grown to the passes a thread keeps
+// open at once (usually one).
+template <typename Encoder>
+class RhiEncoderPool {
+public:
+    RhiEncoderPool() = default;
+    RhiEncoderPool(const RhiEncoderPool&) = delete;
+    RhiEncoderPool& operator=(const RhiEncoderPool&) = delete;
+
+    template <typename Base, typename... Args>
+    RhiEncoderPtr<Base> acquire(Args&&... args) {
+        Slot* slot = nullptr;
+        if (m_free.empty()) {
+            m_slots.push_back(std::make_unique<Slot>());
+            slot = m_slots.back().get();
+        } else {
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+        Encoder* encoder = new (slot->storage) Encoder(std::forward<Args>(args)...);
+        return RhiEncoderPtr<Base>(encoder, RhiEncoderRelease{&RhiEncoderPool::recycle, this, slot});
+    }
+
+private:
+    struct Slot {
+        alignas(Encoder) std::byte storage[sizeof(Encoder)];
+    };
+
+    static void recycle(void* pool, void* slot) {
+        static_cast<RhiEncoderPool*>(pool)->m_free.push_back(static_cast<Slot*>(slot));
+    }
+
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    std::vector<Slot*> m_free;
+};
+
+// Pools live per recording thread: command buffers come and go every frame, while the
+// threads that record (main, render, job workers) persist, and parallel recording
+// never shares a pool.
+template <typename Encoder>
+RhiEncoderPool<Encoder>& rhiThreadEncoderPool() {
+    thread_local RhiEncoderPool<Encoder> pool;
+    return pool;
+}
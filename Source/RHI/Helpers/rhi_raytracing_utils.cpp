@@ -3,6 +3,7 @@
 #ifdef __APPLE__
 
 #include "metal_raytracing_utils.h"
+#include "rhi_resource_utils.h"
 
 #include <vector>
 
@@ -65,6 +66,78 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& device,
     return true;
 }
 
+// Metal builds each BLAS through metalBuildBottomLevelAccelerationStructure, which
+// waits for it, so a batch is already complete when it is returned.
+struct RhiAccelerationStructureBuildBatchState {
+    std::vector<RhiAccelerationStructureHandle> accelerationStructures;
+};
+
+bool rhiSubmitBottomLevelAccelerationStructureBuilds(const RhiDevice& device,
+                                                     const RhiCommandQueue& commandQueue,
+                                                     const RhiBottomLevelBuildInput* inputs,
+                                                     uint32_t inputCount,
+                                                     RhiAccelerationStructureBuildBatch& outBatch,
+                                                     std::string& errorMessage) {
+    rhiCancelAccelerationStructureBuilds(outBatch);
+    if (!inputs || inputCount == 0) {
+        errorMessage = "BLAS batch requires at least one build";
+        return false;
+    }
+
+    RhiAccelerationStructureBuildBatch batch;
+    batch.state = new RhiAccelerationStructureBuildBatchState{};
+    batch.state->accelerationStructures.resize(inputCount);
+    for (uint32_t index = 0; index < inputCount; ++index) {
+        const RhiBottomLevelBuildInput& input = inputs[index];
+        if (!input.positionBuffer || !input.indexBuffer) {
+            errorMessage = "BLAS batch build is missing its position or index buffer";
+            rhiCancelAccelerationStructureBuilds(batch);
+            return false;
+        }
+        if (!rhiBuildBottomLevelAccelerationStructure(device,
+                                                      commandQueue,
+                                                      *input.positionBuffer,
+                                                      input.positionStride,
+                                                      *input.indexBuffer,
+                                                      input.geometryRanges,
+                                                      input.geometryCount,
+                                                      batch.state->accelerationStructures[index],
+                                                      errorMessage)) {
+            rhiCancelAccelerationStructureBuilds(batch);
+            return false;
+        }
+    }
+
+    outBatch = batch;
+    return true;
+}
+
+RhiAccelerationStructureBuildStatus rhiPollAccelerationStructureBuilds(
+    RhiAccelerationStructureBuildBatch& batch,
+    bool /*wait*/,
+    std::vector<RhiAccelerationStructureHandle>& outAccelerationStructures,
+    std::string& errorMessage) {
+    if (!batch.state) {
+        errorMessage = "No acceleration structure builds are pending";
+        return RhiAccelerationStructureBuildStatus::Failed;
+    }
+    outAccelerationStructures = std::move(batch.state->accelerationStructures);
+    delete batch.state;
+    batch.state = nullptr;
+    return RhiAccelerationStructureBuildStatus::Complete;
+}
+
+void rhiCancelAccelerationStructureBuilds(RhiAccelerationStructureBuildBatch& batch) {
+    if (!batch.state) {
+        return;
+    }
+    for (auto& accelerationStructure : batch.state->accelerationStructures) {
+        rhiReleaseHandle(accelerationStructure);
+    }
+    delete batch.state;
+    batch.state = nullptr;
+}
+
 bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& device,
                                            const RhiCommandQueue& commandQueue,
                                            const RhiAccelerationStructure* const* referencedAccelerationStructures,
@@ -110,6 +183,9 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
                                             uint32_t referencedAccelerationStructureCount,
                                             const RhiRayTracingInstanceDesc* instances,
                                             uint32_t instanceCount,
+                                            uint32_t firstDirtyInstance,
+                                            uint32_t dirtyInstanceCount,
+                                            bool rebuild,
                                             const RhiAccelerationStructure& accelerationStructure,
                                             const RhiBuffer& instanceDescriptorBuffer,
                                             const RhiBuffer& scratchBuffer,
@@ -127,6 +203,9 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
                                                     referencedAccelerationStructureCount,
                                                     metalInstances.empty() ? nullptr : metalInstances.data(),
                                                     instanceCount,
+                                                    firstDirtyInstance,
+                                                    dirtyInstanceCount,
+                                                    rebuild,
                                                     accelerationStructure.nativeHandle(),
                                                     instanceDescriptorBuffer.nativeHandle(),
                                                     scratchBuffer.nativeHandle(),
@@ -154,6 +233,9 @@ struct VulkanRayTracingFunctions {
     PFN_vkGetAccelerationStructureDeviceAddressKHR getAccelerationStructureDeviceAddress = nullptr;
     PFN_vkCmdBuildAccelerationStructuresKHR cmdBuildAccelerationStructures = nullptr;
     PFN_vkGetBufferDeviceAddress getBufferDeviceAddress = nullptr;
+    // Only needed for BLAS compaction, which is skipped without them.
+    PFN_vkCmdWriteAccelerationStructuresPropertiesKHR cmdWriteAccelerationStructuresProperties = nullptr;
+    PFN_vkCmdCopyAccelerationStructureKHR cmdCopyAccelerationStructure = nullptr;
 
     bool valid() const {
         return createAccelerationStructure &&
@@ -190,6 +272,12 @@ VulkanRayTracingFunctions loadRayTracingFunctions(VkDevice device) {
             reinterpret_cast<PFN_vkGetBufferDeviceAddress>(
                 vkGetDeviceProcAddr(device, "vkGetBufferDeviceAddressKHR"));
     }
+    functions.cmdWriteAccelerationStructuresProperties =
+        reinterpret_cast<PFN_vkCmdWriteAccelerationStructuresPropertiesKHR>(
+            vkGetDeviceProcAddr(device, "vkCmdWriteAccelerationStructuresPropertiesKHR"));
+    functions.cmdCopyAccelerationStructure =
+        reinterpret_cast<PFN_vkCmdCopyAccelerationStructureKHR>(
+            vkGetDeviceProcAddr(device, "vkCmdCopyAccelerationStructureKHR"));
     return functions;
 }
 
@@ -268,6 +356,8 @@ bool createBufferHandle(const VulkanResourceContextInfo& context,
     vmaInfo.externalMemoryHandleTypes =
         vulkanHostVisibleExternalMemoryHandleTypes(vmaInfo.hostVisible,
                                                    context.externalHostMemoryEnabled);
+    // Scratch, instance and SBT buffers are accounted with the structures they build.
+    vmaInfo.memoryTag = RhiMemoryTag::AccelerationStructures;
     vmaInfo.debugName = debugName;
 
     auto resource = vmaCreateBufferResource(vmaInfo);
@@ -305,6 +395,8 @@ bool createAccelerationStructureHandle(const VulkanResourceContextInfo& context,
     vmaInfo.externalMemoryHandleTypes =
         vulkanHostVisibleExternalMemoryHandleTypes(vmaInfo.hostVisible,
                                                    context.externalHostMemoryEnabled);
+    vmaInfo.memoryTag = RhiMemoryTag::AccelerationStructures;
+    vmaInfo.debugName = "AccelerationStructure";
 
     auto bufferResource = vmaCreateBufferResource(vmaInfo);
     if (!bufferResource) {
@@ -447,11 +539,12 @@ bool buildInstanceDescriptors(const VulkanRayTracingFunctions& functions,
                               const RhiAccelerationStructure* const* referencedAccelerationStructures,
                               uint32_t referencedAccelerationStructureCount,
                               const RhiRayTracingInstanceDesc* instances,
+                              uint32_t firstInstance,
                               uint32_t instanceCount,
                               std::vector<VkAccelerationStructureInstanceKHR>& outInstances,
                               std::string& errorMessage) {
     outInstances.resize(instanceCount);
-    for (uint32_t index = 0; index < instanceCount; ++index) {
+    for (uint32_t index = firstInstance; index < firstInstance + instanceCount; ++index) {
         const RhiRayTracingInstanceDesc& instance = instances[index];
         if (instance.accelerationStructureIndex >= referencedAccelerationStructureCount) {
             errorMessage = "TLAS instance references an invalid BLAS index";
@@ -474,12 +567,12 @@ bool buildInstanceDescriptors(const VulkanRayTracingFunctions& functions,
 
         VkAccelerationStructureInstanceKHR vkInstance{};
         vkInstance.transform = toVkTransformMatrix(instance.transform);
-        vkInstance.instanceCustomIndex = index;
+        vkInstance.instanceCustomIndex = instance.instanceId & 0xFFFFFFu;
         vkInstance.mask = static_cast<uint8_t>(instance.mask & 0xFF);
-        vkInstance.instanceShaderBindingTableRecordOffset = 0;
+        vkInstance.instanceShaderBindingTableRecordOffset = instance.hitGroupOffset & 0xFFFFFFu;
         vkInstance.flags = instance.opaque ? VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR : 0;
         vkInstance.accelerationStructureReference = accelerationStructureAddress;
-        outInstances[index] = vkInstance;
+        outInstances[index - firstInstance] = vkInstance;
     }
 
     return true;
@@ -487,8 +580,11 @@ bool buildInstanceDescriptors(const VulkanRayTracingFunctions& functions,
 
 bool uploadInstanceDescriptors(const VulkanResourceContextInfo& context,
                                const std::vector<VkAccelerationStructureInstanceKHR>& instances,
+                               uint32_t firstInstance,
                                VulkanBufferResource& instanceBuffer,
                                std::string& errorMessage) {
+    const size_t uploadOffset =
+        static_cast<size_t>(firstInstance) * sizeof(VkAccelerationStructureInstanceKHR);
     const size_t uploadSize =
         instances.size() * sizeof(VkAccelerationStructureInstanceKHR);
     if (uploadSize == 0 || instanceBuffer.mappedData == nullptr || instanceBuffer.allocation == nullptr) {
@@ -496,9 +592,9 @@ bool uploadInstanceDescriptors(const VulkanResourceContextInfo& context,
         return false;
     }
 
-    std::memcpy(instanceBuffer.mappedData, instances.data(), uploadSize);
+    std::memcpy(static_cast<uint8_t*>(instanceBuffer.mappedData) + uploadOffset, instances.data(), uploadSize);
     const VkResult flushResult =
-        vmaFlushAllocation(context.allocator, instanceBuffer.allocation, 0, uploadSize);
+        vmaFlushAllocation(context.allocator, instanceBuffer.allocation, uploadOffset, uploadSize);
     if (flushResult != VK_SUCCESS) {
         errorMessage = "Failed to flush Vulkan TLAS instance buffer (VkResult: " +
             std::to_string(flushResult) + ")";
@@ -508,28 +604,77 @@ bool uploadInstanceDescriptors(const VulkanResourceContextInfo& context,
     return true;
 }
 
-} // namespace
-
-bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
-                                              const RhiCommandQueue& commandQueue,
-                                              const RhiBuffer& positionBuffer,
-                                              uint32_t positionStride,
-                                              const RhiBuffer& indexBuffer,
-                                              const RhiRayTracingGeometryRange* geometryRanges,
-                                              uint32_t geometryCount,
-                                              RhiAccelerationStructureHandle& outAccelerationStructure,
-                                              std::string& errorMessage) {
-    const VulkanResourceContextInfo& context = vulkanGetResourceContext();
-    if (!ensureRayTracingContext(context, errorMessage)) {
-        return false;
+// Pool for the compacted sizes of queryCount BLASes, or null when compaction is
+// unavailable.
+VkQueryPool createCompactedSizeQuery(const VulkanResourceContextInfo& context,
+                                     const VulkanRayTracingFunctions& functions,
+                                     uint32_t queryCount = 1) {
+    if (!functions.cmdWriteAccelerationStructuresProperties || !functions.cmdCopyAccelerationStructure) {
+        return VK_NULL_HANDLE;
     }
-
-    const VulkanRayTracingFunctions functions = loadRayTracingFunctions(context.device);
-    if (!functions.valid()) {
-        errorMessage = "Failed to load Vulkan ray tracing function pointers";
-        return false;
+    VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    queryPoolInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+    queryPoolInfo.queryCount = queryCount;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    if (vkCreateQueryPool(context.device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
     }
+    return queryPool;
+}
 
+// Orders earlier builds before later build-stage work: compacted size queries,
+// copies, and builds reusing the same scratch memory.
+void recordBuildBarrier(VkCommandBuffer commandBuffer) {
+    VkMemoryBarrier2 buildBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2};
+    buildBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    buildBarrier.srcAccessMask = VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    buildBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    buildBarrier.dstAccessMask = VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+                                 VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+    VkDependencyInfo buildDependency{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    buildDependency.memoryBarrierCount = 1;
+    buildDependency.pMemoryBarriers = &buildBarrier;
+    vkCmdPipelineBarrier2(commandBuffer, &buildDependency);
+}
+
+// Recorded right after the builds; query firstQuery + i reads accelerationStructures[i].
+void recordCompactedSizeQuery(const VulkanRayTracingFunctions& functions,
+                              VkCommandBuffer commandBuffer,
+                              const VkAccelerationStructureKHR* accelerationStructures,
+                              uint32_t accelerationStructureCount,
+                              VkQueryPool queryPool,
+                              uint32_t firstQuery = 0) {
+    vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, accelerationStructureCount);
+    recordBuildBarrier(commandBuffer);
+    functions.cmdWriteAccelerationStructuresProperties(commandBuffer,
+                                                       accelerationStructureCount,
+                                                       accelerationStructures,
+                                                       VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+                                                       queryPool,
+                                                       firstQuery);
+}
+
+// Geometry and sizes of one BLAS build. buildInfo points into geometries, so a
+// filled desc stays where it was described.
+struct BottomLevelBuildDesc {
+    std::vector<VkAccelerationStructureGeometryKHR> geometries;
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR> buildRanges;
+    VkAccelerationStructureBuildGeometryInfoKHR buildInfo{
+        VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR};
+    VkAccelerationStructureBuildSizesInfoKHR sizeInfo{
+        VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
+};
+
+bool describeBottomLevelBuild(const VulkanResourceContextInfo& context,
+                              const VulkanRayTracingFunctions& functions,
+                              const RhiBuffer& positionBuffer,
+                              uint32_t positionStride,
+                              const RhiBuffer& indexBuffer,
+                              const RhiRayTracingGeometryRange* geometryRanges,
+                              uint32_t geometryCount,
+                              BottomLevelBuildDesc& out,
+                              std::string& errorMessage) {
     if (!geometryRanges || geometryCount == 0) {
         errorMessage = "BLAS build requires at least one geometry range";
         return false;
@@ -557,8 +702,8 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
         return false;
     }
 
-    std::vector<VkAccelerationStructureGeometryKHR> geometries(geometryCount);
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR> buildRanges(geometryCount);
+    out.geometries.resize(geometryCount);
+    out.buildRanges.resize(geometryCount);
     std::vector<uint32_t> primitiveCounts(geometryCount);
     for (uint32_t index = 0; index < geometryCount; ++index) {
         const RhiRayTracingGeometryRange& range = geometryRanges[index];
@@ -581,32 +726,120 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
         geometry.geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR;
         geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
         geometry.geometry.triangles = triangles;
-        geometries[index] = geometry;
+        out.geometries[index] = geometry;
 
         VkAccelerationStructureBuildRangeInfoKHR buildRange{};
         buildRange.primitiveCount = range.indexCount / 3;
         buildRange.primitiveOffset = range.indexOffset * sizeof(uint32_t);
         buildRange.firstVertex = 0;
         buildRange.transformOffset = 0;
-        buildRanges[index] = buildRange;
+        out.buildRanges[index] = buildRange;
         primitiveCounts[index] = buildRange.primitiveCount;
     }
 
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo{
-        VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR};
-    buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    buildInfo.geometryCount = geometryCount;
-    buildInfo.pGeometries = geometries.data();
+    out.buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+    out.buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
+                          VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
+    out.buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+    out.buildInfo.geometryCount = geometryCount;
+    out.buildInfo.pGeometries = out.geometries.data();
 
-    VkAccelerationStructureBuildSizesInfoKHR sizeInfo{
-        VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
     functions.getBuildSizes(context.device,
                             VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-                            &buildInfo,
+                            &out.buildInfo,
                             primitiveCounts.data(),
-                            &sizeInfo);
+                            &out.sizeInfo);
+    return true;
+}
+
+// Copies a built BLAS into an allocation of its compacted size and swaps it in.
+// Any failure keeps the uncompacted BLAS, which is still valid.
+void compactBottomLevelAccelerationStructure(const VulkanResourceContextInfo& context,
+                                             const VulkanRayTracingFunctions& functions,
+                                             const RhiCommandQueue& commandQueue,
+                                             VkQueryPool compactedSizeQuery,
+                                             VkDeviceSize buildSize,
+                                             RhiAccelerationStructureHandle& accelerationStructure) {
+    VkDeviceSize compactedSize = 0;
+    const VkResult queryResult = vkGetQueryPoolResults(context.device,
+                                                       compactedSizeQuery,
+                                                       0,
+                                                       1,
+                                                       sizeof(compactedSize),
+                                                       &compactedSize,
+                                                       sizeof(compactedSize),
+                                                       VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    if (queryResult != VK_SUCCESS || compactedSize == 0 || compactedSize >= buildSize) {
+        return;
+    }
+
+    std::string errorMessage;
+    RhiAccelerationStructureHandle compacted;
+    if (!createAccelerationStructureHandle(context,
+                                           functions,
+                                           VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+                                           compactedSize,
+                                           compacted,
+                                           errorMessage)) {
+        return;
+    }
+
+    VkCopyAccelerationStructureInfoKHR copyInfo{VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR};
+    copyInfo.src = getVulkanAccelerationStructureHandle(&accelerationStructure);
+    copyInfo.dst = getVulkanAccelerationStructureHandle(&compacted);
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+    const bool copySucceeded = submitImmediateBuild(
+        context,
+        commandQueue,
+        [&](VkCommandBuffer commandBuffer) {
+            functions.cmdCopyAccelerationStructure(commandBuffer, &copyInfo);
+        },
+        errorMessage);
+    if (!copySucceeded) {
+        rhiReleaseHandle(compacted);
+        return;
+    }
+
+    rhiReleaseHandle(accelerationStructure);
+    accelerationStructure = compacted;
+}
+
+} // namespace
+
+bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
+                                              const RhiCommandQueue& commandQueue,
+                                              const RhiBuffer& positionBuffer,
+                                              uint32_t positionStride,
+                                              const RhiBuffer& indexBuffer,
+                                              const RhiRayTracingGeometryRange* geometryRanges,
+                                              uint32_t geometryCount,
+                                              RhiAccelerationStructureHandle& outAccelerationStructure,
+                                              std::string& errorMessage) {
+    const VulkanResourceContextInfo& context = vulkanGetResourceContext();
+    if (!ensureRayTracingContext(context, errorMessage)) {
+        return false;
+    }
+
+    const VulkanRayTracingFunctions functions = loadRayTracingFunctions(context.device);
+    if (!functions.valid()) {
+        errorMessage = "Failed to load Vulkan ray tracing function pointers";
+        return false;
+    }
+
+    BottomLevelBuildDesc desc;
+    if (!describeBottomLevelBuild(context,
+                                  functions,
+                                  positionBuffer,
+                                  positionStride,
+                                  indexBuffer,
+                                  geometryRanges,
+                                  geometryCount,
+                                  desc,
+                                  errorMessage)) {
+        return false;
+    }
+    VkAccelerationStructureBuildGeometryInfoKHR& buildInfo = desc.buildInfo;
+    const VkAccelerationStructureBuildSizesInfoKHR& sizeInfo = desc.sizeInfo;
 
     RhiAccelerationStructureHandle accelerationStructure;
     if (!createAccelerationStructureHandle(context,
@@ -642,7 +875,9 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
     buildInfo.dstAccelerationStructure = getVulkanAccelerationStructureHandle(&accelerationStructure);
     buildInfo.scratchData.deviceAddress = scratchAddress;
 
-    const VkAccelerationStructureBuildRangeInfoKHR* buildRangePointers[] = {buildRanges.data()};
+    VkQueryPool compactedSizeQuery = createCompactedSizeQuery(context, functions);
+
+    const VkAccelerationStructureBuildRangeInfoKHR* buildRangePointers[] = {desc.buildRanges.data()};
     const bool buildSucceeded = submitImmediateBuild(
         context,
         commandQueue,
@@ -651,19 +886,450 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& /*device*/,
                                                      1,
                                                      &buildInfo,
                                                      buildRangePointers);
+            if (compactedSizeQuery != VK_NULL_HANDLE) {
+                recordCompactedSizeQuery(functions,
+                                         commandBuffer,
+                                         &buildInfo.dstAccelerationStructure,
+                                         1,
+                                         compactedSizeQuery);
+            }
         },
         errorMessage);
 
     rhiReleaseHandle(scratchBuffer);
     if (!buildSucceeded) {
+        if (compactedSizeQuery != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(context.device, compactedSizeQuery, nullptr);
+        }
         rhiReleaseHandle(accelerationStructure);
         return false;
     }
 
+    if (compactedSizeQuery != VK_NULL_HANDLE) {
+        compactBottomLevelAccelerationStructure(context,
+                                                functions,
+                                                commandQueue,
+                                                compactedSizeQuery,
+                                                sizeInfo.accelerationStructureSize,
+                                                accelerationStructure);
+        vkDestroyQueryPool(context.device, compactedSizeQuery, nullptr);
+    }
+
     outAccelerationStructure = accelerationStructure;
     return true;
 }
 
+// Scratch shared by the builds of one batch. Builds that do not fit start another
+// pass after a barrier, reusing the pool from its start.
+constexpr VkDeviceSize kBatchScratchPoolBytes = VkDeviceSize(64) << 20;
+
+struct RhiAccelerationStructureBuildBatchState {
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    VkQueryPool compactedSizeQueries = VK_NULL_HANDLE;
+    RhiBufferHandle scratchBuffer;
+    std::vector<RhiAccelerationStructureHandle> accelerationStructures;
+    std::vector<VkDeviceSize> buildSizes;
+    // Compacted copies in flight, matched to accelerationStructures; empty handles
+    // keep the original.
+    std::vector<RhiAccelerationStructureHandle> compacted;
+    bool compacting = false;
+};
+
+namespace {
+
+VkDeviceSize alignScratch(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+VkDeviceSize scratchOffsetAlignment(const VulkanResourceContextInfo& context) {
+    VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties{
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+    VkPhysicalDeviceProperties2 properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+    properties.pNext = &accelerationStructureProperties;
+    vkGetPhysicalDeviceProperties2(context.physicalDevice, &properties);
+    return std::max<VkDeviceSize>(
+        accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment, 1);
+}
+
+void destroyBuildBatch(RhiAccelerationStructureBuildBatch& batch, bool releaseAccelerationStructures) {
+    RhiAccelerationStructureBuildBatchState* state = batch.state;
+    if (!state) {
+        return;
+    }
+    if (state->fence != VK_NULL_HANDLE) {
+        vkDestroyFence(state->device, state->fence, nullptr);
+    }
+    if (state->commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(state->device, state->commandPool, nullptr);
+    }
+    if (state->compactedSizeQueries != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(state->device, state->compactedSizeQueries, nullptr);
+    }
+    rhiReleaseHandle(state->scratchBuffer);
+    for (auto& compacted : state->compacted) {
+        rhiReleaseHandle(compacted);
+    }
+    if (releaseAccelerationStructures) {
+        for (auto& accelerationStructure : state->accelerationStructures) {
+            rhiReleaseHandle(accelerationStructure);
+        }
+    }
+    delete state;
+    batch.state = nullptr;
+}
+
+bool beginBatchCommandBuffers(const RhiAccelerationStructureBuildBatchState& state,
+                              uint32_t count,
+                              std::vector<VkCommandBuffer>& outCommandBuffers,
+                              std::string& errorMessage) {
+    outCommandBuffers.assign(count, VK_NULL_HANDLE);
+    VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocateInfo.commandPool = state.commandPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = count;
+    VkResult result = vkAllocateCommandBuffers(state.device, &allocateInfo, outCommandBuffers.data());
+    if (result != VK_SUCCESS) {
+        errorMessage = "Failed to allocate Vulkan BLAS batch command buffers (VkResult: " +
+            std::to_string(result) + ")";
+        return false;
+    }
+
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    for (VkCommandBuffer commandBuffer : outCommandBuffers) {
+        result = vulkanBeginCommandBufferHooked(commandBuffer, &beginInfo);
+        if (result != VK_SUCCESS) {
+            errorMessage = "Failed to begin Vulkan BLAS batch command buffer (VkResult: " +
+                std::to_string(result) + ")";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ends the command buffers and submits them together, signalling the batch fence.
+bool submitBatchCommandBuffers(RhiAccelerationStructureBuildBatchState& state,
+                               const std::vector<VkCommandBuffer>& commandBuffers,
+                               std::string& errorMessage) {
+    for (VkCommandBuffer commandBuffer : commandBuffers) {
+        const VkResult result = vkEndCommandBuffer(commandBuffer);
+        if (result != VK_SUCCESS) {
+            errorMessage = "Failed to end Vulkan BLAS batch command buffer (VkResult: " +
+                std::to_string(result) + ")";
+            return false;
+        }
+    }
+
+    VkResult result = vkResetFences(state.device, 1, &state.fence);
+    if (result == VK_SUCCESS) {
+        VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+        submitInfo.pCommandBuffers = commandBuffers.data();
+        result = vkQueueSubmit(state.queue, 1, &submitInfo, state.fence);
+    }
+    if (result != VK_SUCCESS) {
+        errorMessage = "Failed to submit Vulkan BLAS batch (VkResult: " + std::to_string(result) + ")";
+        return false;
+    }
+    return true;
+}
+
+// Reads the compacted sizes of a finished batch and submits copies for the BLASes
+// that shrink. Returns false when nothing was submitted; any failure keeps the
+// uncompacted BLASes, which are still valid.
+bool submitBatchCompaction(const VulkanResourceContextInfo& context,
+                           const VulkanRayTracingFunctions& functions,
+                           RhiAccelerationStructureBuildBatchState& state) {
+    state.compacting = true;
+    rhiReleaseHandle(state.scratchBuffer);
+
+    const uint32_t count = static_cast<uint32_t>(state.accelerationStructures.size());
+    std::vector<VkDeviceSize> compactedSizes(count, 0);
+    const VkResult queryResult = vkGetQueryPoolResults(state.device,
+                                                       state.compactedSizeQueries,
+                                                       0,
+                                                       count,
+                                                       compactedSizes.size() * sizeof(VkDeviceSize),
+                                                       compactedSizes.data(),
+                                                       sizeof(VkDeviceSize),
+                                                       VK_QUERY_RESULT_64_BIT);
+    if (queryResult != VK_SUCCESS) {
+        return false;
+    }
+
+    state.compacted.resize(count);
+    std::vector<VkCopyAccelerationStructureInfoKHR> copies;
+    for (uint32_t index = 0; index < count; ++index) {
+        if (compactedSizes[index] == 0 || compactedSizes[index] >= state.buildSizes[index]) {
+            continue;
+        }
+        std::string errorMessage;
+        if (!createAccelerationStructureHandle(context,
+                                               functions,
+                                               VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+                                               compactedSizes[index],
+                                               state.compacted[index],
+                                               errorMessage)) {
+            continue;
+        }
+        VkCopyAccelerationStructureInfoKHR copyInfo{VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR};
+        copyInfo.src = getVulkanAccelerationStructureHandle(&state.accelerationStructures[index]);
+        copyInfo.dst = getVulkanAccelerationStructureHandle(&state.compacted[index]);
+        copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+        copies.push_back(copyInfo);
+    }
+    if (copies.empty()) {
+        return false;
+    }
+
+    std::string errorMessage;
+    std::vector<VkCommandBuffer> commandBuffers;
+    bool submitted = vkResetCommandPool(state.device, state.commandPool, 0) == VK_SUCCESS &&
+                     beginBatchCommandBuffers(state, 1, commandBuffers, errorMessage);
+    if (submitted) {
+        recordBuildBarrier(commandBuffers[0]);
+        for (const VkCopyAccelerationStructureInfoKHR& copyInfo : copies) {
+            functions.cmdCopyAccelerationStructure(commandBuffers[0], &copyInfo);
+        }
+        submitted = submitBatchCommandBuffers(state, commandBuffers, errorMessage);
+    }
+    if (!submitted) {
+        for (auto& compacted : state.compacted) {
+            rhiReleaseHandle(compacted);
+        }
+    }
+    return submitted;
+}
+
+} // namespace
+
+bool rhiSubmitBottomLevelAccelerationStructureBuilds(const RhiDevice& /*device*/,
+                                                     const RhiCommandQueue& commandQueue,
+                                                     const RhiBottomLevelBuildInput* inputs,
+                                                     uint32_t inputCount,
+                                                     RhiAccelerationStructureBuildBatch& outBatch,
+                                                     std::string& errorMessage) {
+    rhiCancelAccelerationStructureBuilds(outBatch);
+
+    const VulkanResourceContextInfo& context = vulkanGetResourceContext();
+    if (!ensureRayTracingContext(context, errorMessage)) {
+        return false;
+    }
+
+    const VulkanRayTracingFunctions functions = loadRayTracingFunctions(context.device);
+    if (!functions.valid()) {
+        errorMessage = "Failed to load Vulkan ray tracing function pointers";
+        return false;
+    }
+
+    if (!inputs || inputCount == 0) {
+        errorMessage = "BLAS batch requires at least one build";
+        return false;
+    }
+
+    VkQueue queue = static_cast<VkQueue>(commandQueue.nativeHandle());
+    if (queue == VK_NULL_HANDLE) {
+        queue = context.graphicsQueue;
+    }
+    if (queue == VK_NULL_HANDLE) {
+        errorMessage = "Missing Vulkan graphics queue for acceleration structure build";
+        return false;
+    }
+
+    std::vector<BottomLevelBuildDesc> descs(inputCount);
+    for (uint32_t index = 0; index < inputCount; ++index) {
+        const RhiBottomLevelBuildInput& input = inputs[index];
+        if (!input.positionBuffer || !input.indexBuffer) {
+            errorMessage = "BLAS batch build is missing its position or index buffer";
+            return false;
+        }
+        if (!describeBottomLevelBuild(context,
+                                      functions,
+                                      *input.positionBuffer,
+                                      input.positionStride,
+                                      *input.indexBuffer,
+                                      input.geometryRanges,
+                                      input.geometryCount,
+                                      descs[index],
+                                      errorMessage)) {
+            return false;
+        }
+    }
+
+    RhiAccelerationStructureBuildBatch batch;
+    batch.state = new RhiAccelerationStructureBuildBatchState{};
+    RhiAccelerationStructureBuildBatchState& state = *batch.state;
+    state.device = context.device;
+    state.queue = queue;
+    state.accelerationStructures.resize(inputCount);
+    state.buildSizes.resize(inputCount);
+
+    const VkDeviceSize alignment = scratchOffsetAlignment(context);
+    VkDeviceSize largestScratch = 0;
+    VkDeviceSize totalScratch = 0;
+    for (uint32_t index = 0; index < inputCount; ++index) {
+        state.buildSizes[index] = descs[index].sizeInfo.accelerationStructureSize;
+        if (!createAccelerationStructureHandle(context,
+                                               functions,
+                                               VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+                                               state.buildSizes[index],
+                                               state.accelerationStructures[index],
+                                               errorMessage)) {
+            destroyBuildBatch(batch, true);
+            return false;
+        }
+        const VkDeviceSize scratchSize = alignScratch(descs[index].sizeInfo.buildScratchSize, alignment);
+        largestScratch = std::max(largestScratch, scratchSize);
+        totalScratch += scratchSize;
+    }
+
+    const VkDeviceSize scratchPoolSize = std::max(largestScratch, std::min(totalScratch, kBatchScratchPoolBytes));
+    if (!createBufferHandle(context,
+                            functions,
+                            scratchPoolSize + alignment,
+                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                            false,
+                            "Vulkan BLAS Batch Scratch",
+                            state.scratchBuffer,
+                            errorMessage)) {
+        destroyBuildBatch(batch, true);
+        return false;
+    }
+    const VkDeviceAddress scratchAddress = getBufferDeviceAddress(functions, state.scratchBuffer);
+    if (scratchAddress == 0) {
+        errorMessage = "Failed to get a Vulkan scratch buffer device address for BLAS batch";
+        destroyBuildBatch(batch, true);
+        return false;
+    }
+    const VkDeviceAddress scratchBase = alignScratch(scratchAddress, alignment);
+
+    // A pass is a run of builds whose scratch fits the pool side by side; each one
+    // records into its own command buffer.
+    std::vector<uint32_t> passStarts;
+    std::vector<VkAccelerationStructureKHR> handles(inputCount);
+    std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> buildRangePointers(inputCount);
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildInfos(inputCount);
+    VkDeviceSize scratchOffset = 0;
+    for (uint32_t index = 0; index < inputCount; ++index) {
+        const VkDeviceSize scratchSize = alignScratch(descs[index].sizeInfo.buildScratchSize, alignment);
+        if (passStarts.empty() || scratchOffset + scratchSize > scratchPoolSize) {
+            passStarts.push_back(index);
+            scratchOffset = 0;
+        }
+        handles[index] = getVulkanAccelerationStructureHandle(&state.accelerationStructures[index]);
+        buildInfos[index] = descs[index].buildInfo;
+        buildInfos[index].dstAccelerationStructure = handles[index];
+        buildInfos[index].scratchData.deviceAddress = scratchBase + scratchOffset;
+        buildRangePointers[index] = descs[index].buildRanges.data();
+        scratchOffset += scratchSize;
+    }
+    passStarts.push_back(inputCount);
+
+    state.compactedSizeQueries = createCompactedSizeQuery(context, functions, inputCount);
+
+    VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = context.graphicsQueueFamily;
+    VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    if (vkCreateCommandPool(context.device, &poolInfo, nullptr, &state.commandPool) != VK_SUCCESS ||
+        vkCreateFence(context.device, &fenceInfo, nullptr, &state.fence) != VK_SUCCESS) {
+        errorMessage = "Failed to create Vulkan BLAS batch command pool or fence";
+        destroyBuildBatch(batch, true);
+        return false;
+    }
+
+    const uint32_t passCount = static_cast<uint32_t>(passStarts.size() - 1);
+    std::vector<VkCommandBuffer> commandBuffers;
+    if (!beginBatchCommandBuffers(state, passCount, commandBuffers, errorMessage)) {
+        destroyBuildBatch(batch, true);
+        return false;
+    }
+    for (uint32_t pass = 0; pass < passCount; ++pass) {
+        VkCommandBuffer commandBuffer = commandBuffers[pass];
+        const uint32_t first = passStarts[pass];
+        const uint32_t count = passStarts[pass + 1] - first;
+        if (pass != 0) {
+            // The previous pass is done with the scratch pool.
+            recordBuildBarrier(commandBuffer);
+        }
+        functions.cmdBuildAccelerationStructures(commandBuffer,
+                                                 count,
+                                                 buildInfos.data() + first,
+                                                 buildRangePointers.data() + first);
+        if (state.compactedSizeQueries != VK_NULL_HANDLE) {
+            recordCompactedSizeQuery(functions,
+                                     commandBuffer,
+                                     handles.data() + first,
+                                     count,
+                                     state.compactedSizeQueries,
+                                     first);
+        }
+    }
+    if (!submitBatchCommandBuffers(state, commandBuffers, errorMessage)) {
+        destroyBuildBatch(batch, true);
+        return false;
+    }
+
+    outBatch = batch;
+    return true;
+}
+
+RhiAccelerationStructureBuildStatus rhiPollAccelerationStructureBuilds(
+    RhiAccelerationStructureBuildBatch& batch,
+    bool wait,
+    std::vector<RhiAccelerationStructureHandle>& outAccelerationStructures,
+    std::string& errorMessage) {
+    RhiAccelerationStructureBuildBatchState* state = batch.state;
+    if (!state) {
+        errorMessage = "No acceleration structure builds are pending";
+        return RhiAccelerationStructureBuildStatus::Failed;
+    }
+
+    for (;;) {
+        const VkResult fenceResult =
+            vkWaitForFences(state->device, 1, &state->fence, VK_TRUE, wait ? UINT64_MAX : 0);
+        if (fenceResult == VK_TIMEOUT) {
+            return RhiAccelerationStructureBuildStatus::Pending;
+        }
+        if (fenceResult != VK_SUCCESS) {
+            errorMessage = "Failed waiting for Vulkan BLAS batch (VkResult: " +
+                std::to_string(fenceResult) + ")";
+            destroyBuildBatch(batch, true);
+            return RhiAccelerationStructureBuildStatus::Failed;
+        }
+        if (state->compacting || state->compactedSizeQueries == VK_NULL_HANDLE ||
+            !submitBatchCompaction(vulkanGetResourceContext(), loadRayTracingFunctions(state->device), *state)) {
+            break;
+        }
+        if (!wait) {
+            return RhiAccelerationStructureBuildStatus::Pending;
+        }
+    }
+
+    for (size_t index = 0; index < state->compacted.size(); ++index) {
+        if (state->compacted[index].nativeHandle()) {
+            rhiReleaseHandle(state->accelerationStructures[index]);
+            state->accelerationStructures[index] = state->compacted[index];
+            state->compacted[index] = RhiAccelerationStructureHandle();
+        }
+    }
+    outAccelerationStructures = std::move(state->accelerationStructures);
+    state->accelerationStructures.clear();
+    destroyBuildBatch(batch, false);
+    return RhiAccelerationStructureBuildStatus::Complete;
+}
+
+void rhiCancelAccelerationStructureBuilds(RhiAccelerationStructureBuildBatch& batch) {
+    if (!batch.state) {
+        return;
+    }
+    vkWaitForFences(batch.state->device, 1, &batch.state->fence, VK_TRUE, UINT64_MAX);
+    destroyBuildBatch(batch, true);
+}
+
 bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& /*device*/,
                                            const RhiCommandQueue& commandQueue,
                                            const RhiAccelerationStructure* const* referencedAccelerationStructures,
@@ -699,6 +1365,7 @@ bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& /*device*/,
                                   referencedAccelerationStructures,
                                   referencedAccelerationStructureCount,
                                   instances,
+                                  0,
                                   instanceCount,
                                   vkInstances,
                                   errorMessage)) {
@@ -722,7 +1389,7 @@ bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& /*device*/,
 
     auto* instanceBufferResource = getVulkanBufferResource(instanceDescriptorBuffer);
     if (!instanceBufferResource ||
-        !uploadInstanceDescriptors(context, vkInstances, *instanceBufferResource, errorMessage)) {
+        !uploadInstanceDescriptors(context, vkInstances, 0, *instanceBufferResource, errorMessage)) {
         rhiReleaseHandle(instanceDescriptorBuffer);
         return false;
     }
@@ -821,6 +1488,9 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
                                             uint32_t referencedAccelerationStructureCount,
                                             const RhiRayTracingInstanceDesc* instances,
                                             uint32_t instanceCount,
+                                            uint32_t firstDirtyInstance,
+                                            uint32_t dirtyInstanceCount,
+                                            bool rebuild,
                                             const RhiAccelerationStructure& accelerationStructure,
                                             const RhiBuffer& instanceDescriptorBuffer,
                                             const RhiBuffer& scratchBuffer,
@@ -844,6 +1514,10 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
         errorMessage = "TLAS update requires at least one instance";
         return false;
     }
+    if (firstDirtyInstance > instanceCount || dirtyInstanceCount > instanceCount - firstDirtyInstance) {
+        errorMessage = "TLAS dirty instance range exceeds the instance count";
+        return false;
+    }
 
     auto* accelerationStructureResource =
         getVulkanAccelerationStructureResource(&accelerationStructure);
@@ -858,18 +1532,19 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
         return false;
     }
 
+    // Descriptors outside the dirty range are still in the buffer from earlier frames.
     std::vector<VkAccelerationStructureInstanceKHR> vkInstances;
-    if (!buildInstanceDescriptors(functions,
-                                  referencedAccelerationStructures,
-                                  referencedAccelerationStructureCount,
-                                  instances,
-                                  instanceCount,
-                                  vkInstances,
-                                  errorMessage)) {
-        return false;
-    }
-
-    if (!uploadInstanceDescriptors(context, vkInstances, *instanceBufferResource, errorMessage)) {
+    if (dirtyInstanceCount > 0 &&
+        (!buildInstanceDescriptors(functions,
+                                   referencedAccelerationStructures,
+                                   referencedAccelerationStructureCount,
+                                   instances,
+                                   firstDirtyInstance,
+                                   dirtyInstanceCount,
+                                   vkInstances,
+                                   errorMessage) ||
+         !uploadInstanceDescriptors(context, vkInstances, firstDirtyInstance, *instanceBufferResource,
+                                    errorMessage))) {
         return false;
     }
 
@@ -888,8 +1563,10 @@ bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& comman
     buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
     buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
                       VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
-    buildInfo.srcAccelerationStructure = accelerationStructureResource->accelerationStructure;
+    buildInfo.mode = rebuild ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR
+                             : VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+    buildInfo.srcAccelerationStructure =
+        rebuild ? VK_NULL_HANDLE : accelerationStructureResource->accelerationStructure;
     buildInfo.dstAccelerationStructure = accelerationStructureResource->accelerationStructure;
     buildInfo.geometryCount = 1;
     buildInfo.pGeometries = &geometry;
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "rhi_backend.h"
 
@@ -15,8 +16,15 @@ struct RhiRayTracingInstanceDesc {
     uint32_t accelerationStructureIndex = 0;
     uint32_t mask = 0xFF;
     bool opaque = true;
+    // What InstanceID() returns in hit shaders (24 bits).
+    uint32_t instanceId = 0;
+    // Hit-region record of the BLAS's first geometry; geometry g uses record
+    // hitGroupOffset + g (24 bits). Only ray tracing pipelines read either field.
+    uint32_t hitGroupOffset = 0;
 };
 
+// BLASes are built compactable and copied into a compacted allocation before
+// being returned.
 bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& device,
                                               const RhiCommandQueue& commandQueue,
                                               const RhiBuffer& positionBuffer,
@@ -27,6 +35,51 @@ bool rhiBuildBottomLevelAccelerationStructure(const RhiDevice& device,
                                               RhiAccelerationStructureHandle& outAccelerationStructure,
                                               std::string& errorMessage);
 
+struct RhiBottomLevelBuildInput {
+    const RhiBuffer* positionBuffer = nullptr;
+    uint32_t positionStride = 0;
+    const RhiBuffer* indexBuffer = nullptr;
+    const RhiRayTracingGeometryRange* geometryRanges = nullptr;
+    uint32_t geometryCount = 0;
+};
+
+struct RhiAccelerationStructureBuildBatchState;
+
+// BLAS builds submitted by rhiSubmitBottomLevelAccelerationStructureBuilds and not
+// yet collected by rhiPollAccelerationStructureBuilds.
+struct RhiAccelerationStructureBuildBatch {
+    RhiAccelerationStructureBuildBatchState* state = nullptr;
+    bool pending() const { return state != nullptr; }
+};
+
+enum class RhiAccelerationStructureBuildStatus {
+    Pending,
+    Complete,
+    Failed,
+};
+
+// Records one BLAS per input into a few command buffers that share one pooled
+// scratch allocation and submits them without waiting. The inputs' buffers must
+// stay alive until the batch completes. Compaction runs as a second submission
+// started by the poll that sees the builds finish.
+bool rhiSubmitBottomLevelAccelerationStructureBuilds(const RhiDevice& device,
+                                                     const RhiCommandQueue& commandQueue,
+                                                     const RhiBottomLevelBuildInput* inputs,
+                                                     uint32_t inputCount,
+                                                     RhiAccelerationStructureBuildBatch& outBatch,
+                                                     std::string& errorMessage);
+
+// Advances the batch, blocking only with wait. On Complete the BLASes, in input
+// order, move to outAccelerationStructures; Complete and Failed both end the batch.
+RhiAccelerationStructureBuildStatus rhiPollAccelerationStructureBuilds(
+    RhiAccelerationStructureBuildBatch& batch,
+    bool wait,
+    std::vector<RhiAccelerationStructureHandle>& outAccelerationStructures,
+    std::string& errorMessage);
+
+// Waits for the batch and releases everything it built.
+void rhiCancelAccelerationStructureBuilds(RhiAccelerationStructureBuildBatch& batch);
+
 bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& device,
                                            const RhiCommandQueue& commandQueue,
                                            const RhiAccelerationStructure* const* referencedAccelerationStructures,
@@ -38,11 +91,18 @@ bool rhiBuildTopLevelAccelerationStructure(const RhiDevice& device,
                                            RhiBufferHandle& outScratchBuffer,
                                            std::string& errorMessage);
 
+// Rewrites instances [firstDirtyInstance, firstDirtyInstance + dirtyInstanceCount)
+// of the descriptor buffer and refits the TLAS in place. instanceCount must match
+// the build. rebuild rebuilds it in place instead, for when referenced BLASes
+// were replaced and a refit would keep the old bounds hierarchy.
 bool rhiUpdateTopLevelAccelerationStructure(const RhiNativeCommandBuffer& commandBuffer,
                                             const RhiAccelerationStructure* const* referencedAccelerationStructures,
                                             uint32_t referencedAccelerationStructureCount,
                                             const RhiRayTracingInstanceDesc* instances,
                                             uint32_t instanceCount,
+                                            uint32_t firstDirtyInstance,
+                                            uint32_t dirtyInstanceCount,
+                                            bool rebuild,
                                             const RhiAccelerationStructure& accelerationStructure,
                                             const RhiBuffer& instanceDescriptorBuffer,
                                             const RhiBuffer& scratchBuffer,
@@ -1,10 +1,47 @@
 #include "rhi_resource_utils.h"
 
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+void rhiWriteCombinedCopy(void* dst, const void* src, size_t size) {
+#if defined(__SSE2__) || defined(_M_X64)
+    auto* dstBytes = static_cast<std::byte*>(dst);
+    const auto* srcBytes = static_cast<const std::byte*>(src);
+    if ((reinterpret_cast<uintptr_t>(dstBytes) & 15u) == 0 && size >= 64) {
+        const size_t streamedSize = size & ~size_t(63);
+        for (size_t offset = 0; offset < streamedSize; offset += 64) {
+            // Four full 16-byte stores fill a write-combining buffer in one burst.
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + offset));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + offset + 16));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + offset + 32));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcBytes + offset + 48));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + offset), a);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + offset + 16), b);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + offset + 32), c);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dstBytes + offset + 48), d);
+        }
+        std::memcpy(dstBytes + streamedSize, srcBytes + streamedSize, size - streamedSize);
+        // Order the streaming stores before the submit that lets the GPU read them.
+        _mm_sfence();
+        return;
+    }
+#endif
+    std::memcpy(dst, src, size);
+}
+
 #ifdef __APPLE__
+#include "bindless_scene_constants.h"
 #include "metal_resource_utils.h"
 
+#include <vector>
+
 namespace {
 
+// Material textures are bound per stage through the texture argument table.
+
 MetalSamplerFilter toMetalFilter(RhiSamplerFilterMode filter) {
     switch (filter) {
     case RhiSamplerFilterMode::Nearest:
@@ -44,6 +81,28 @@ RhiBufferHandle rhiCreateSharedBuffer(const RhiDevice& device,
     return RhiBufferHandle(metalCreateSharedBuffer(device.nativeHandle(), initialData, size, debugName), size);
 }
 
+// Shared storage is already GPU-visible on unified memory, so every memory class
+// maps to it and there is nothing to stream.
+RhiBufferHandle rhiCreateBuffer(const RhiDevice& device,
+                                const RhiBufferDesc& desc,
+                                RhiUploadTicket* /*ticket*/) {
+    return rhiCreateSharedBuffer(device, desc.initialData, desc.size, desc.debugName);
+}
+
+RhiBufferHandle rhiCreateDeviceBuffer(const RhiDevice& device,
+                                      const void* initialData,
+                                      size_t size,
+                                      const char* debugName,
+                                      RhiUploadTicket* /*ticket*/) {
+    return rhiCreateSharedBuffer(device, initialData, size, debugName);
+}
+
+bool rhiIsUploadComplete(const RhiUploadTicket& /*ticket*/) {
+    return true;
+}
+
+void rhiWaitForUpload(const RhiUploadTicket& /*ticket*/) {}
+
 void* rhiBufferContents(const RhiBuffer& buffer) {
     return metalBufferContents(buffer.nativeHandle());
 }
@@ -97,6 +156,15 @@ void rhiUploadTexture2D(const RhiTexture& texture,
     metalUploadTexture2D(texture.nativeHandle(), width, height, data, bytesPerRow, mipLevel);
 }
 
+void rhiStageTexture2D(const RhiTexture& texture,
+                       uint32_t width,
+                       uint32_t height,
+                       const void* data,
+                       size_t bytesPerRow,
+                       uint32_t mipLevel) {
+    rhiUploadTexture2D(texture, width, height, data, bytesPerRow, mipLevel);
+}
+
 void rhiUploadTexture3D(const RhiTexture& texture,
                         uint32_t width,
                         uint32_t height,
@@ -119,6 +187,19 @@ void rhiGenerateMipmaps(const RhiCommandQueue& commandQueue, const RhiTexture& t
     metalGenerateMipmaps(commandQueue.nativeHandle(), texture.nativeHandle());
 }
 
+void rhiGenerateMipmaps(const RhiCommandQueue& commandQueue,
+                        const RhiTexture* const* textures,
+                        size_t textureCount) {
+    std::vector<void*> textureHandles;
+    textureHandles.reserve(textureCount);
+    for (size_t i = 0; i < textureCount; ++i) {
+        if (textures[i] && textures[i]->nativeHandle()) {
+            textureHandles.push_back(textures[i]->nativeHandle());
+        }
+    }
+    metalGenerateMipmaps(commandQueue.nativeHandle(), textureHandles.data(), textureHandles.size());
+}
+
 RhiSamplerHandle rhiCreateSampler(const RhiDevice& device, const RhiSamplerDesc& desc) {
     MetalSamplerDesc metalDesc;
     metalDesc.minFilter = toMetalFilter(desc.minFilter);
@@ -141,6 +222,41 @@ bool rhiSupportsRaytracing(const RhiDevice& device) {
     return metalSupportsRaytracing(device.nativeHandle());
 }
 
+bool rhiSupportsTextureFormat(const RhiDevice& device, RhiFormat format) {
+    return metalSupportsTextureFormat(device.nativeHandle(), format);
+}
+
+uint32_t rhiMaxSceneTextureCount(const RhiDevice& /*device*/) {
+    return METALLIC_BINDLESS_MAX_SAMPLED_IMAGES;
+}
+
+bool rhiAddQueueResidency(const RhiCommandQueue& commandQueue,
+                          const void* const* nativeHandles,
+                          size_t count) {
+    return metalAddQueueResidency(commandQueue.nativeHandle(), nativeHandles, count);
+}
+
+void rhiRemoveQueueResidency(const RhiCommandQueue& commandQueue,
+                             const void* const* nativeHandles,
+                             size_t count) {
+    metalRemoveQueueResidency(commandQueue.nativeHandle(), nativeHandles, count);
+}
+
+uint64_t rhiSubmitAsyncBufferCopies(const RhiBuffer& srcBuffer,
+                                    const RhiBuffer& dstBuffer,
+                                    const RhiBufferCopyRegion* regions,
+                                    size_t count) {
+    std::vector<MetalBufferCopy> copies;
+    copies.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        copies.push_back({regions[i].srcOffset, regions[i].dstOffset, regions[i].size});
+    }
+    return metalSubmitBufferCopies(srcBuffer.nativeHandle(),
+                                   dstBuffer.nativeHandle(),
+                                   copies.data(),
+                                   copies.size());
+}
+
 RhiTextureHandle rhiRetainTexture(const RhiTexture& texture) {
     return RhiTextureHandle(metalRetainHandle(texture.nativeHandle()),
                             texture.width(),
@@ -155,15 +271,20 @@ void rhiReleaseNativeHandle(void* handle) {
 
 #include "vulkan_backend.h"
 #include "vulkan_frame_graph.h"
+#include "vulkan_pipeline_library.h"
 #include "vulkan_resource_handles.h"
 #include "vulkan_upload_service.h"
+#include "bindless_scene_constants.h"
 
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <cstring>
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 namespace {
 
@@ -303,6 +424,111 @@ RhiContext* resolveOwningContext(const RhiDevice& device, const char* functionNa
     return context;
 }
 
+void recordGenerateMipmaps(VkCommandBuffer cmd, const VulkanTextureResource* res) {
+    // Uploads leave every level in SHADER_READ; bring the source level back to
+    // TRANSFER_DST so the blit chain below starts from a known layout.
+    VkImageMemoryBarrier2 baseBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    baseBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    baseBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+    baseBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    baseBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    baseBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    baseBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    baseBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    baseBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    baseBarrier.image = res->image;
+    baseBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    VkDependencyInfo baseDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    baseDep.imageMemoryBarrierCount = 1;
+    baseDep.pImageMemoryBarriers = &baseBarrier;
+    vkCmdPipelineBarrier2(cmd, &baseDep);
+
+    for (uint32_t i = 1; i < res->mipLevels; ++i) {
+        VkImageMemoryBarrier2 initBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        initBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
+        initBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+        initBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        initBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        initBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        initBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        initBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        initBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        initBarrier.image = res->image;
+        initBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+
+        VkDependencyInfo initDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        initDep.imageMemoryBarrierCount = 1;
+        initDep.pImageMemoryBarriers = &initBarrier;
+        vkCmdPipelineBarrier2(cmd, &initDep);
+    }
+
+    int32_t mipWidth = static_cast<int32_t>(res->width);
+    int32_t mipHeight = static_cast<int32_t>(res->height);
+
+    for (uint32_t i = 1; i < res->mipLevels; ++i) {
+        // Transition level i-1 to TRANSFER_SRC
+        VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = res->image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 1, 0, 1};
+
+        VkDependencyInfo depInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        depInfo.imageMemoryBarrierCount = 1;
+        depInfo.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &depInfo);
+
+        // Blit from level i-1 to level i
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, 1};
+        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1};
+        blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
+
+        vkCmdBlitImage(cmd,
+                       res->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       res->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &blit, VK_FILTER_LINEAR);
+
+        // Transition level i-1 to SHADER_READ
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier2(cmd, &depInfo);
+
+        if (mipWidth > 1) mipWidth /= 2;
+        if (mipHeight > 1) mipHeight /= 2;
+    }
+
+    // Transition last mip level to SHADER_READ
+    VkImageMemoryBarrier2 lastBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+    lastBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    lastBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    lastBarrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+    lastBarrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+    lastBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    lastBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    lastBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    lastBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    lastBarrier.image = res->image;
+    lastBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, res->mipLevels - 1, 1, 0, 1};
+
+    VkDependencyInfo lastDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+    lastDep.imageMemoryBarrierCount = 1;
+    lastDep.pImageMemoryBarriers = &lastBarrier;
+    vkCmdPipelineBarrier2(cmd, &lastDep);
+}
+
 } // namespace
 
 void vulkanSetResourceContext(VkDevice device,
@@ -337,6 +563,10 @@ void vulkanSetStreamlineHookedCommandsEnabled(bool enabled) {
     g_vkResCtx.streamlineHooksEnabled = enabled;
 }
 
+void vulkanSetResizableBarEnabled(bool enabled) {
+    g_vkResCtx.resizableBarEnabled = enabled;
+}
+
 void vulkanSetStreamlineCommandHooks(void* beginCommandBufferHook,
                                      void* cmdBindPipelineHook,
                                      void* cmdBindDescriptorSetsHook) {
@@ -472,6 +702,49 @@ void vulkanClearResourceContext() {
     g_vkResCtx = {};
 }
 
+namespace {
+
+std::mutex g_stateSlotMutex;
+std::vector<uint32_t> g_freeStateSlots;
+uint32_t g_nextStateSlot = 0;
+
+} // namespace
+
+uint32_t vulkanResourceStateSlot(const VulkanResourceHeader& header) {
+    std::atomic_ref<uint32_t> slot(header.stateSlot);
+    uint32_t current = slot.load(std::memory_order_acquire);
+    if (current != UINT32_MAX) {
+        return current;
+    }
+
+    uint32_t assigned = UINT32_MAX;
+    {
+        std::lock_guard<std::mutex> lock(g_stateSlotMutex);
+        if (!g_freeStateSlots.empty()) {
+            assigned = g_freeStateSlots.back();
+            g_freeStateSlots.pop_back();
+        } else {
+            assigned = g_nextStateSlot++;
+        }
+    }
+    // Parallel recording threads may race on a resource's first use.
+    if (!slot.compare_exchange_strong(current, assigned, std::memory_order_acq_rel)) {
+        std::lock_guard<std::mutex> lock(g_stateSlotMutex);
+        g_freeStateSlots.push_back(assigned);
+        return current;
+    }
+    return assigned;
+}
+
+void vulkanReleaseResourceStateSlot(const VulkanResourceHeader& header) {
+    const uint32_t slot = std::atomic_ref<uint32_t>(header.stateSlot).exchange(UINT32_MAX);
+    if (slot == UINT32_MAX) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_stateSlotMutex);
+    g_freeStateSlots.push_back(slot);
+}
+
 RhiBufferHandle rhiCreateSharedBuffer(const RhiDevice& device,
                                       const void* initialData,
                                       size_t size,
@@ -480,6 +753,87 @@ RhiBufferHandle rhiCreateSharedBuffer(const RhiDevice& device,
     return context ? context->createSharedBuffer(initialData, size, debugName) : RhiBufferHandle{};
 }
 
+RhiBufferHandle rhiCreateBuffer(const RhiDevice& device,
+                                const RhiBufferDesc& desc,
+                                RhiUploadTicket* ticket) {
+    if (desc.size == 0) {
+        return {};
+    }
+    if (desc.memory == RhiBufferMemory::Upload) {
+        return rhiCreateSharedBuffer(device, desc.initialData, desc.size, desc.debugName);
+    }
+    // Device-local contents can only be filled through the upload service.
+    if (!g_vkResCtx.initialized || (desc.memory == RhiBufferMemory::DeviceLocal && !g_uploadService)) {
+        return rhiCreateSharedBuffer(device, desc.initialData, desc.size, desc.debugName);
+    }
+
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    usage = vulkanEnableBufferDeviceAddress(usage, g_vkResCtx.bufferDeviceAddressEnabled);
+    usage = vulkanEnableAccelerationStructureBuildInput(usage, g_vkResCtx.rayTracingEnabled);
+
+    VmaBufferCreateInfo vmaInfo{};
+    vmaInfo.device = g_vkResCtx.device;
+    vmaInfo.allocator = g_vkResCtx.allocator;
+    vmaInfo.size = desc.size;
+    vmaInfo.usage = usage;
+    vulkanApplyBufferMemory(vmaInfo, desc.memory);
+    // Concurrent sharing spares a queue family ownership transfer per streamed buffer.
+    vmaInfo.sharedWithTransferQueue =
+        desc.sharedWithTransferQueue ||
+        (desc.memory == RhiBufferMemory::DeviceLocal && g_uploadService->hasTransferQueue());
+    vmaInfo.graphicsQueueFamily = g_vkResCtx.graphicsQueueFamily;
+    vmaInfo.transferQueueFamily = g_vkResCtx.transferQueueFamily;
+    vmaInfo.debugName = desc.debugName;
+
+    auto resource = vmaCreateBufferResource(vmaInfo);
+    if (!resource) {
+        spdlog::warn("Failed to create {} buffer {}; using a shared buffer",
+                     desc.memory == RhiBufferMemory::DeviceLocal ? "device-local" : "host-visible",
+                     desc.debugName ? desc.debugName : "");
+        return rhiCreateSharedBuffer(device, desc.initialData, desc.size, desc.debugName);
+    }
+
+    auto* buffer = new VulkanBufferResource(*resource);
+    if (desc.initialData) {
+        if (buffer->mappedData) {
+            std::memcpy(buffer->mappedData, desc.initialData, desc.size);
+        } else {
+            const VulkanUploadService::UploadTicket upload =
+                g_uploadService->streamBuffer(buffer->buffer, 0, desc.initialData, desc.size);
+            if (ticket) {
+                ticket->merge({upload.transferValue});
+            }
+        }
+    }
+    return RhiBufferHandle(buffer, desc.size);
+}
+
+RhiBufferHandle rhiCreateDeviceBuffer(const RhiDevice& device,
+                                      const void* initialData,
+                                      size_t size,
+                                      const char* debugName,
+                                      RhiUploadTicket* ticket) {
+    RhiBufferDesc desc;
+    desc.size = size;
+    desc.initialData = initialData;
+    desc.memory = RhiBufferMemory::DeviceLocal;
+    desc.debugName = debugName;
+    return rhiCreateBuffer(device, desc, ticket);
+}
+
+bool rhiIsUploadComplete(const RhiUploadTicket& ticket) {
+    return !g_uploadService || g_uploadService->isComplete({ticket.value});
+}
+
+void rhiWaitForUpload(const RhiUploadTicket& ticket) {
+    if (g_uploadService) {
+        g_uploadService->wait({ticket.value});
+    }
+}
+
 void* rhiBufferContents(const RhiBuffer& buffer) {
     auto* res = getVulkanBufferResource(buffer);
     return res ? res->mappedData : nullptr;
@@ -530,13 +884,13 @@ void rhiUploadTexture2D(const RhiTexture& texture,
     auto* res = static_cast<VulkanTextureResource*>(texture.nativeHandle());
     if (!res || !data) return;
 
-    const bool deferShaderReadTransition = res->mipLevels > 1 && mipLevel == 0;
-    size_t imageSize = bytesPerRow * height;
+    const bool blockCompressed = rhiIsBlockCompressedFormat(fromVkFormat(res->format));
+    const uint32_t rowCount = blockCompressed ? (height + 3u) / 4u : height;
+    size_t imageSize = bytesPerRow * rowCount;
 
     if (g_uploadService) {
         g_uploadService->immediateUploadTexture2D(res->image, width, height,
-                                                   data, imageSize, mipLevel,
-                                                   deferShaderReadTransition);
+                                                   data, imageSize, mipLevel, false);
         return;
     }
 
@@ -547,6 +901,7 @@ void rhiUploadTexture2D(const RhiTexture& texture,
     stagingVmaInfo.size = imageSize;
     stagingVmaInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     stagingVmaInfo.hostVisible = true;
+    stagingVmaInfo.memoryTag = RhiMemoryTag::Staging;
     stagingVmaInfo.externalMemoryHandleTypes =
         vulkanHostVisibleExternalMemoryHandleTypes(stagingVmaInfo.hostVisible,
                                                    g_vkResCtx.externalHostMemoryEnabled);
@@ -591,22 +946,40 @@ void rhiUploadTexture2D(const RhiTexture& texture,
     region.imageExtent = {width, height, 1};
     vkCmdCopyBufferToImage(cmd, stagingBuffer, res->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
-    if (!deferShaderReadTransition) {
-        // Transition to SHADER_READ
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
-                               VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        vkCmdPipelineBarrier2(cmd, &depInfo);
-    }
+    // Transition to SHADER_READ
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
+                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier2(cmd, &depInfo);
 
     endOneTimeCommands(g_vkResCtx.device, pool, g_vkResCtx.graphicsQueue, cmd);
+    vulkanUntrackAllocation(stagingAlloc);
     vmaDestroyBuffer(g_vkResCtx.allocator, stagingBuffer, stagingAlloc);
 }
 
+void rhiStageTexture2D(const RhiTexture& texture,
+                       uint32_t width,
+                       uint32_t height,
+                       const void* data,
+                       size_t bytesPerRow,
+                       uint32_t mipLevel) {
+    auto* res = static_cast<VulkanTextureResource*>(texture.nativeHandle());
+    if (!res || !data) return;
+
+    const bool blockCompressed = rhiIsBlockCompressedFormat(fromVkFormat(res->format));
+    const uint32_t rowCount = blockCompressed ? (height + 3u) / 4u : height;
+    const size_t imageSize = bytesPerRow * rowCount;
+    if (g_uploadService &&
+        g_uploadService->stageTexture2D(res->image, width, height, data, imageSize, mipLevel)) {
+        return;
+    }
+    rhiUploadTexture2D(texture, width, height, data, bytesPerRow, mipLevel);
+}
+
 void rhiUploadTexture3D(const RhiTexture& texture,
                         uint32_t width,
                         uint32_t height,
@@ -633,6 +1006,7 @@ void rhiUploadTexture3D(const RhiTexture& texture,
     stagingVmaInfo.size = imageSize;
     stagingVmaInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     stagingVmaInfo.hostVisible = true;
+    stagingVmaInfo.memoryTag = RhiMemoryTag::Staging;
     stagingVmaInfo.externalMemoryHandleTypes =
         vulkanHostVisibleExternalMemoryHandleTypes(stagingVmaInfo.hostVisible,
                                                    g_vkResCtx.externalHostMemoryEnabled);
@@ -680,101 +1054,39 @@ void rhiUploadTexture3D(const RhiTexture& texture,
     vkCmdPipelineBarrier2(cmd, &depInfo);
 
     endOneTimeCommands(g_vkResCtx.device, pool, g_vkResCtx.graphicsQueue, cmd);
+    vulkanUntrackAllocation(stagingAlloc);
     vmaDestroyBuffer(g_vkResCtx.allocator, stagingBuffer, stagingAlloc);
 }
 
 void rhiGenerateMipmaps(const RhiCommandQueue& /*commandQueue*/, const RhiTexture& texture) {
     auto* res = static_cast<VulkanTextureResource*>(texture.nativeHandle());
-    if (!res || res->mipLevels <= 1) return;
+    if (!res || res->mipLevels <= 1 || rhiIsBlockCompressedFormat(fromVkFormat(res->format))) return;
 
     VkCommandPool pool = getUploadPool();
     VkCommandBuffer cmd = beginOneTimeCommands(g_vkResCtx.device, pool);
+    recordGenerateMipmaps(cmd, res);
+    endOneTimeCommands(g_vkResCtx.device, pool, g_vkResCtx.graphicsQueue, cmd);
+}
 
-    for (uint32_t i = 1; i < res->mipLevels; ++i) {
-        VkImageMemoryBarrier2 initBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-        initBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
-        initBarrier.srcAccessMask = VK_ACCESS_2_NONE;
-        initBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        initBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        initBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        initBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        initBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        initBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        initBarrier.image = res->image;
-        initBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+void rhiGenerateMipmaps(const RhiCommandQueue& /*commandQueue*/,
+                        const RhiTexture* const* textures,
+                        size_t textureCount) {
+    VkCommandPool pool = VK_NULL_HANDLE;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    for (size_t i = 0; i < textureCount; ++i) {
+        auto* res = textures[i] ? static_cast<VulkanTextureResource*>(textures[i]->nativeHandle()) : nullptr;
+        if (!res || res->mipLevels <= 1 || rhiIsBlockCompressedFormat(fromVkFormat(res->format))) continue;
 
-        VkDependencyInfo initDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-        initDep.imageMemoryBarrierCount = 1;
-        initDep.pImageMemoryBarriers = &initBarrier;
-        vkCmdPipelineBarrier2(cmd, &initDep);
+        if (cmd == VK_NULL_HANDLE) {
+            pool = getUploadPool();
+            cmd = beginOneTimeCommands(g_vkResCtx.device, pool);
+        }
+        recordGenerateMipmaps(cmd, res);
     }
 
-    int32_t mipWidth = static_cast<int32_t>(res->width);
-    int32_t mipHeight = static_cast<int32_t>(res->height);
-
-    for (uint32_t i = 1; i < res->mipLevels; ++i) {
-        // Transition level i-1 to TRANSFER_SRC
-        VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = res->image;
-        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 1, 0, 1};
-
-        VkDependencyInfo depInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-        depInfo.imageMemoryBarrierCount = 1;
-        depInfo.pImageMemoryBarriers = &barrier;
-        vkCmdPipelineBarrier2(cmd, &depInfo);
-
-        // Blit from level i-1 to level i
-        VkImageBlit blit{};
-        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, 1};
-        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1};
-        blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1};
-
-        vkCmdBlitImage(cmd,
-                       res->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       res->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       1, &blit, VK_FILTER_LINEAR);
-
-        // Transition level i-1 to SHADER_READ
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
-        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        vkCmdPipelineBarrier2(cmd, &depInfo);
-
-        if (mipWidth > 1) mipWidth /= 2;
-        if (mipHeight > 1) mipHeight /= 2;
+    if (cmd != VK_NULL_HANDLE) {
+        endOneTimeCommands(g_vkResCtx.device, pool, g_vkResCtx.graphicsQueue, cmd);
     }
-
-    // Transition last mip level to SHADER_READ
-    VkImageMemoryBarrier2 lastBarrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-    lastBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-    lastBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-    lastBarrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
-    lastBarrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-    lastBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    lastBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    lastBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    lastBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    lastBarrier.image = res->image;
-    lastBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, res->mipLevels - 1, 1, 0, 1};
-
-    VkDependencyInfo lastDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-    lastDep.imageMemoryBarrierCount = 1;
-    lastDep.pImageMemoryBarriers = &lastBarrier;
-    vkCmdPipelineBarrier2(cmd, &lastDep);
-
-    endOneTimeCommands(g_vkResCtx.device, pool, g_vkResCtx.graphicsQueue, cmd);
 }
 
 RhiSamplerHandle rhiCreateSampler(const RhiDevice& device, const RhiSamplerDesc& desc) {
@@ -794,6 +1106,72 @@ bool rhiSupportsRaytracing(const RhiDevice& /*device*/) {
     return g_vkResCtx.rayTracingEnabled;
 }
 
+bool rhiSupportsTextureFormat(const RhiDevice& /*device*/, RhiFormat format) {
+    const VkFormat vkFormat = toVkFormat(format);
+    if (g_vkResCtx.physicalDevice == VK_NULL_HANDLE || vkFormat == VK_FORMAT_UNDEFINED) {
+        return false;
+    }
+
+    // The device enables textureCompressionBC whenever the adapter reports it.
+    if (rhiIsBlockCompressedFormat(format)) {
+        VkPhysicalDeviceFeatures features{};
+        vkGetPhysicalDeviceFeatures(g_vkResCtx.physicalDevice, &features);
+        if (features.textureCompressionBC != VK_TRUE) {
+            return false;
+        }
+    }
+
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(g_vkResCtx.physicalDevice, vkFormat, &properties);
+    const VkFormatFeatureFlags required =
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+uint32_t rhiMaxSceneTextureCount(const RhiDevice& /*device*/) {
+    return METALLIC_BINDLESS_MAX_SAMPLED_IMAGES;
+}
+
+// Vulkan allocations are always resident, but useResource also emits the
+// build-to-read barriers, so callers must keep calling it.
+bool rhiAddQueueResidency(const RhiCommandQueue& /*commandQueue*/,
+                          const void* const* /*nativeHandles*/,
+                          size_t /*count*/) {
+    return false;
+}
+
+void rhiRemoveQueueResidency(const RhiCommandQueue& /*commandQueue*/,
+                             const void* const* /*nativeHandles*/,
+                             size_t /*count*/) {}
+
+uint64_t rhiSubmitAsyncBufferCopies(const RhiBuffer& srcBuffer,
+                                    const RhiBuffer& dstBuffer,
+                                    const RhiBufferCopyRegion* regions,
+                                    size_t count) {
+    VulkanUploadService* uploadService = vulkanGetUploadService();
+    const VkBuffer vkSrcBuffer = getVulkanBufferHandle(&srcBuffer);
+    const VkBuffer vkDstBuffer = getVulkanBufferHandle(&dstBuffer);
+    if (!uploadService || !uploadService->hasTransferQueue() ||
+        vkSrcBuffer == VK_NULL_HANDLE || vkDstBuffer == VK_NULL_HANDLE) {
+        return 0;
+    }
+
+    std::vector<VkBufferCopy> bufferCopies;
+    bufferCopies.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (regions[i].size != 0) {
+            bufferCopies.push_back({regions[i].srcOffset, regions[i].dstOffset, regions[i].size});
+        }
+    }
+    if (bufferCopies.empty()) {
+        return 0;
+    }
+    return uploadService->submitAsyncBufferCopies(vkSrcBuffer,
+                                                  vkDstBuffer,
+                                                  bufferCopies.data(),
+                                                  static_cast<uint32_t>(bufferCopies.size()));
+}
+
 RhiTextureHandle rhiRetainTexture(const RhiTexture& texture) {
     auto* res = static_cast<VulkanTextureResource*>(texture.nativeHandle());
     if (res) {
@@ -835,6 +1213,11 @@ void rhiReleaseNativeHandle(void* handle) {
     }
     case VulkanResourceType::Pipeline: {
         auto* pipeline = static_cast<VulkanPipelineResource*>(handle);
+        if (pipeline->linkState) {
+            vulkanReleasePipelineLinkState(*pipeline->linkState);
+            pipeline->linkState.reset();
+        }
+        pipeline->rayTracing.reset();
         if (pipeline->pipeline != VK_NULL_HANDLE) {
             vkDestroyPipeline(pipeline->device, pipeline->pipeline, nullptr);
             pipeline->pipeline = VK_NULL_HANDLE;
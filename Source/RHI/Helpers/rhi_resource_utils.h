@@ -7,6 +7,33 @@ RhiBufferHandle rhiCreateSharedBuffer(const RhiDevice& device,
                                       size_t size,
                                       const char* debugName = nullptr);
 void* rhiBufferContents(const RhiBuffer& buffer);
+// Copies into mapped write-combined memory (Upload, DynamicDeviceLocal) with
+// non-temporal stores so the destination never pollutes the CPU caches.
+// Falls back to memcpy where streaming stores are unavailable.
+void rhiWriteCombinedCopy(void* dst, const void* src, size_t size);
+
+// Completion handle for rhiCreateBuffer uploads; tickets from one batch can
+// be merged and waited on once. A default ticket is already complete.
+struct RhiUploadTicket {
+    uint64_t value = 0;
+    void merge(const RhiUploadTicket& other) { value = other.value > value ? other.value : value; }
+};
+
+// Persistent buffer in desc.memory. DeviceLocal initial data is streamed in on the
+// transfer queue where the backend has one; it may be freed on return, but the GPU
+// contents are only valid once the ticket completes. Host-visible classes are
+// filled directly. Falls back to rhiCreateSharedBuffer.
+RhiBufferHandle rhiCreateBuffer(const RhiDevice& device,
+                                const RhiBufferDesc& desc,
+                                RhiUploadTicket* ticket = nullptr);
+// rhiCreateBuffer with RhiBufferMemory::DeviceLocal.
+RhiBufferHandle rhiCreateDeviceBuffer(const RhiDevice& device,
+                                      const void* initialData,
+                                      size_t size,
+                                      const char* debugName = nullptr,
+                                      RhiUploadTicket* ticket = nullptr);
+bool rhiIsUploadComplete(const RhiUploadTicket& ticket);
+void rhiWaitForUpload(const RhiUploadTicket& ticket);
 
 RhiTextureHandle rhiCreateTexture2D(const RhiDevice& device,
                                     uint32_t width,
@@ -23,12 +50,28 @@ RhiTextureHandle rhiCreateTexture3D(const RhiDevice& device,
                                     RhiFormat format,
                                     RhiTextureStorageMode storageMode,
                                     RhiTextureUsage usage);
+
+inline bool rhiIsBlockCompressedFormat(RhiFormat format) {
+    return format == RhiFormat::BC7RGBAUnorm;
+}
+
+// Block-compressed textures cannot go through rhiGenerateMipmaps; upload every
+// level explicitly, with bytesPerRow covering one row of 4x4 blocks.
 void rhiUploadTexture2D(const RhiTexture& texture,
                         uint32_t width,
                         uint32_t height,
                         const void* data,
                         size_t bytesPerRow,
                         uint32_t mipLevel = 0);
+// Like rhiUploadTexture2D, but on Vulkan the copy is recorded at the start of the
+// next frame's command buffer instead of submitting and waiting for the queue.
+// The texture must not be sampled before that frame.
+void rhiStageTexture2D(const RhiTexture& texture,
+                       uint32_t width,
+                       uint32_t height,
+                       const void* data,
+                       size_t bytesPerRow,
+                       uint32_t mipLevel = 0);
 void rhiUploadTexture3D(const RhiTexture& texture,
                         uint32_t width,
                         uint32_t height,
@@ -38,12 +81,44 @@ void rhiUploadTexture3D(const RhiTexture& texture,
                         size_t bytesPerImage,
                         uint32_t mipLevel = 0);
 void rhiGenerateMipmaps(const RhiCommandQueue& commandQueue, const RhiTexture& texture);
+// Records mip generation for every texture into a single submission.
+void rhiGenerateMipmaps(const RhiCommandQueue& commandQueue,
+                        const RhiTexture* const* textures,
+                        size_t textureCount);
 
 RhiSamplerHandle rhiCreateSampler(const RhiDevice& device, const RhiSamplerDesc& desc);
 RhiDepthStencilStateHandle rhiCreateDepthStencilState(const RhiDevice& device,
                                                       bool depthWriteEnabled,
                                                       bool reversedZ);
 bool rhiSupportsRaytracing(const RhiDevice& device);
+bool rhiSupportsTextureFormat(const RhiDevice& device, RhiFormat format);
+// Upper bound on material textures the scene passes can address.
+uint32_t rhiMaxSceneTextureCount(const RhiDevice& device);
+
+// Keeps buffers and acceleration structures resident for every command buffer
+// on the queue so passes can skip per-dispatch useResource calls. Returns false
+// where the backend has no queue-level residency; callers then keep their
+// useResource calls. Remove handles before releasing them.
+bool rhiAddQueueResidency(const RhiCommandQueue& commandQueue,
+                          const void* const* nativeHandles,
+                          size_t count);
+void rhiRemoveQueueResidency(const RhiCommandQueue& commandQueue,
+                             const void* const* nativeHandles,
+                             size_t count);
+
+struct RhiBufferCopyRegion {
+    uint64_t srcOffset = 0;
+    uint64_t dstOffset = 0;
+    uint64_t size = 0;
+};
+
+// Submits buffer copies on the backend's secondary transfer queue. Returns the
+// timeline value a command buffer must wait on before reading the destination,
+// or 0 when there is no transfer queue and the caller has to copy inline.
+uint64_t rhiSubmitAsyncBufferCopies(const RhiBuffer& srcBuffer,
+                                    const RhiBuffer& dstBuffer,
+                                    const RhiBufferCopyRegion* regions,
+                                    size_t count);
 
 RhiTextureHandle rhiRetainTexture(const RhiTexture& texture);
 void rhiReleaseNativeHandle(void* handle);
@@ -82,6 +157,7 @@ struct VulkanResourceContextInfo {
     bool initialized = false;
     bool streamlineHooksEnabled = false;
     bool debugUtilsEnabled = false;
+    bool resizableBarEnabled = false; // DynamicDeviceLocal buffers are placed in mapped VRAM
     void* streamlineBeginCommandBufferHook = nullptr;
     void* streamlineCmdBindPipelineHook = nullptr;
     void* streamlineCmdBindDescriptorSetsHook = nullptr;
@@ -104,6 +180,7 @@ void vulkanSetResourceContext(VkDevice device,
 const VulkanResourceContextInfo& vulkanGetResourceContext();
 void vulkanClearResourceContext();
 void vulkanSetStreamlineHookedCommandsEnabled(bool enabled);
+void vulkanSetResizableBarEnabled(bool enabled);
 void vulkanSetStreamlineCommandHooks(void* beginCommandBufferHook,
                                      void* cmdBindPipelineHook,
                                      void* cmdBindDescriptorSetsHook);
@@ -58,6 +58,7 @@ RhiGraphicsPipelineHandle rhiCreateRenderPipelineFromSource(const RhiDevice& dev
     metalDesc.colorFormat = desc.colorFormat;
     metalDesc.depthFormat = desc.depthFormat;
     metalDesc.vertexDescriptorHandle = desc.vertexDescriptor ? desc.vertexDescriptor->nativeHandle() : nullptr;
+    metalDesc.blendMode = desc.blendMode;
     return RhiGraphicsPipelineHandle(
         metalCreateRenderPipelineFromSource(device.nativeHandle(), source, metalDesc, errorMessage));
 }
@@ -70,6 +71,24 @@ RhiComputePipelineHandle rhiCreateComputePipelineFromSource(const RhiDevice& dev
         metalCreateComputePipelineFromSource(device.nativeHandle(), source, entryPoint, errorMessage));
 }
 
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& /*device*/,
+                                                                   const RhiGraphicsPipeline& pipeline) {
+    return metalRenderPipelineStats(pipeline.nativeHandle());
+}
+
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& /*device*/,
+                                                                   const RhiComputePipeline& pipeline) {
+    return metalComputePipelineStats(pipeline.nativeHandle());
+}
+
+RhiComputePipelineHandle rhiCreateRayTracingPipelineFromSource(const RhiDevice& /*device*/,
+                                                               const std::string& /*source*/,
+                                                               const RhiRayTracingPipelineSourceDesc& /*desc*/,
+                                                               std::string& errorMessage) {
+    errorMessage = "Ray tracing pipelines are not supported on Metal";
+    return {};
+}
+
 #elif defined(_WIN32)
 
 #include "vulkan_resource_handles.h"
@@ -188,4 +207,25 @@ RhiComputePipelineHandle rhiCreateComputePipelineFromSource(const RhiDevice& dev
                    : RhiComputePipelineHandle{};
 }
 
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& device,
+                                                                   const RhiGraphicsPipeline& pipeline) {
+    RhiContext* context = resolveOwningContext(device, "rhiPipelineExecutableStats");
+    return context ? context->pipelineExecutableStats(pipeline) : std::vector<RhiPipelineExecutableStats>{};
+}
+
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& device,
+                                                                   const RhiComputePipeline& pipeline) {
+    RhiContext* context = resolveOwningContext(device, "rhiPipelineExecutableStats");
+    return context ? context->pipelineExecutableStats(pipeline) : std::vector<RhiPipelineExecutableStats>{};
+}
+
+RhiComputePipelineHandle rhiCreateRayTracingPipelineFromSource(const RhiDevice& device,
+                                                               const std::string& source,
+                                                               const RhiRayTracingPipelineSourceDesc& desc,
+                                                               std::string& errorMessage) {
+    RhiContext* context = resolveOwningContext(device, "rhiCreateRayTracingPipelineFromSource");
+    return context ? context->createRayTracingPipelineFromSource(source, desc, errorMessage)
+                   : RhiComputePipelineHandle{};
+}
+
 #endif
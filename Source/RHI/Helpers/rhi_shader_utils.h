@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "rhi_backend.h"
 
@@ -32,6 +33,18 @@ RhiComputePipelineHandle rhiCreateComputePipelineFromSource(const RhiDevice& dev
                                                             const char* entryPoint,
                                                             std::string& errorMessage);
 
+// Register, spill and occupancy statistics of a compiled pipeline (see
+// RhiContext::pipelineExecutableStats). Metal only reports threadgroup limits.
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& device,
+                                                                   const RhiGraphicsPipeline& pipeline);
+std::vector<RhiPipelineExecutableStats> rhiPipelineExecutableStats(const RhiDevice& device,
+                                                                   const RhiComputePipeline& pipeline);
+
 #ifdef _WIN32
 #include <vulkan/vulkan.h>
 #endif
+// Fails with errorMessage set unless the context supports RhiFeatures::rayTracingPipeline.
+RhiComputePipelineHandle rhiCreateRayTracingPipelineFromSource(const RhiDevice& device,
+                                                               const std::string& source,
+                                                               const RhiRayTracingPipelineSourceDesc& desc,
+                                                               std::string& errorMessage);
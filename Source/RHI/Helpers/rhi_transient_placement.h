@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Packs frame graph transients into shared heaps. Two allocations may overlap in
+// memory only when their pass intervals [firstPass, lastPass] are disjoint.
+// Backends supply sizes/alignments from their own memory requirement queries.
+
+struct RhiTransientAllocationInfo {
+    uint64_t sizeBytes = 0;
+    uint64_t alignment = 1;
+    uint32_t memoryTypeBits = ~0u; // Vulkan memory type mask; ~0u when not applicable
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+};
+
+struct RhiTransientPlacement {
+    uint32_t heapIndex = UINT32_MAX;
+    uint64_t offset = 0;
+    bool aliased = false; // shares bytes with at least one other allocation
+};
+
+struct RhiTransientHeapLayout {
+    uint64_t sizeBytes = 0;
+    uint64_t alignment = 1;
+    uint32_t memoryTypeBits = ~0u;
+};
+
+inline uint64_t rhiAlignTransientOffset(uint64_t value, uint64_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+// Largest-first, lowest-offset placement. Returns one placement per allocation and
+// fills outHeaps with the size each heap must be created with.
+inline std::vector<RhiTransientPlacement> rhiPlaceTransientAllocations(
+    const std::vector<RhiTransientAllocationInfo>& allocations,
+    std::vector<RhiTransientHeapLayout>& outHeaps) {
+    std::vector<RhiTransientPlacement> placements(allocations.size());
+    outHeaps.clear();
+
+    std::vector<uint32_t> order(allocations.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return allocations[lhs].sizeBytes > allocations[rhs].sizeBytes;
+    });
+
+    struct Occupied {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+    };
+    std::vector<std::vector<uint32_t>> heapMembers;
+    std::vector<Occupied> conflicts;
+
+    for (uint32_t index : order) {
+        const RhiTransientAllocationInfo& allocation = allocations[index];
+        uint32_t bestHeap = UINT32_MAX;
+        uint64_t bestOffset = 0;
+
+        for (uint32_t heapIndex = 0; heapIndex < outHeaps.size(); ++heapIndex) {
+            const RhiTransientHeapLayout& heap = outHeaps[heapIndex];
+            if ((heap.memoryTypeBits & allocation.memoryTypeBits) == 0u) {
+                continue;
+            }
+
+            conflicts.clear();
+            for (uint32_t member : heapMembers[heapIndex]) {
+                const RhiTransientAllocationInfo& other = allocations[member];
+                if (other.lastPass < allocation.firstPass || allocation.lastPass < other.firstPass) {
+                    continue;
+                }
+                conflicts.push_back({placements[member].offset,
+                                     placements[member].offset + other.sizeBytes});
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [](const Occupied& lhs, const Occupied& rhs) {
+                return lhs.begin < rhs.begin;
+            });
+
+            uint64_t offset = 0;
+            for (const Occupied& conflict : conflicts) {
+                offset = rhiAlignTransientOffset(offset, allocation.alignment);
+                if (offset + allocation.sizeBytes <= conflict.begin) {
+                    break;
+                }
+                offset = std::max(offset, conflict.end);
+            }
+            offset = rhiAlignTransientOffset(offset, allocation.alignment);
+
+            // Prefer the slot that grows its heap the least; reuse beats a new heap.
+            const uint64_t growth =
+                offset + allocation.sizeBytes > heap.sizeBytes ? offset + allocation.sizeBytes - heap.sizeBytes : 0u;
+            const uint64_t bestGrowth =
+                bestHeap == UINT32_MAX
+                    ? UINT64_MAX
+                    : (bestOffset + allocation.sizeBytes > outHeaps[bestHeap].sizeBytes
+                           ? bestOffset + allocation.sizeBytes - outHeaps[bestHeap].sizeBytes
+                           : 0u);
+            if (growth < bestGrowth) {
+                bestHeap = heapIndex;
+                bestOffset = offset;
+            }
+        }
+
+        if (bestHeap == UINT32_MAX) {
+            bestHeap = static_cast<uint32_t>(outHeaps.size());
+            bestOffset = 0;
+            outHeaps.push_back({0u, 1u, allocation.memoryTypeBits});
+            heapMembers.emplace_back();
+        }
+
+        RhiTransientHeapLayout& heap = outHeaps[bestHeap];
+        heap.sizeBytes = std::max(heap.sizeBytes, bestOffset + allocation.sizeBytes);
+        heap.alignment = std::max(heap.alignment, allocation.alignment);
+        heap.memoryTypeBits &= allocation.memoryTypeBits;
+        heapMembers[bestHeap].push_back(index);
+        placements[index].heapIndex = bestHeap;
+        placements[index].offset = bestOffset;
+    }
+
+    for (const std::vector<uint32_t>& members : heapMembers) {
+        for (size_t lhs = 0; lhs < members.size(); ++lhs) {
+            for (size_t rhs = lhs + 1; rhs < members.size(); ++rhs) {
+                const uint32_t a = members[lhs];
+                const uint32_t b = members[rhs];
+                if (placements[a].offset < placements[b].offset + allocations[b].sizeBytes &&
+                    placements[b].offset < placements[a].offset + allocations[a].sizeBytes) {
+                    placements[a].aliased = true;
+                    placements[b].aliased = true;
+                }
+            }
+        }
+    }
+    return placements;
+}
+
+// Linear placement without aliasing: each allocation goes at the next aligned offset
+// of the first heap with the same key (e.g. the memory kind) and a compatible memory
+// type. Pass intervals are ignored. Returns one placement per allocation.
+inline std::vector<RhiTransientPlacement> rhiPackTransientAllocationsLinear(
+    const std::vector<RhiTransientAllocationInfo>& allocations,
+    const std::vector<uint32_t>& heapKeys,
+    std::vector<RhiTransientHeapLayout>& outHeaps) {
+    std::vector<RhiTransientPlacement> placements(allocations.size());
+    std::vector<uint32_t> outKeys;
+    outHeaps.clear();
+
+    for (uint32_t index = 0; index < allocations.size(); ++index) {
+        const RhiTransientAllocationInfo& allocation = allocations[index];
+        uint32_t heapIndex = 0;
+        while (heapIndex < outHeaps.size() &&
+               (outKeys[heapIndex] != heapKeys[index] ||
+                (outHeaps[heapIndex].memoryTypeBits & allocation.memoryTypeBits) == 0u)) {
+            ++heapIndex;
+        }
+        if (heapIndex == outHeaps.size()) {
+            outHeaps.push_back({0u, 1u, allocation.memoryTypeBits});
+            outKeys.push_back(heapKeys[index]);
+        }
+
+        RhiTransientHeapLayout& heap = outHeaps[heapIndex];
+        const uint64_t offset = rhiAlignTransientOffset(heap.sizeBytes, allocation.alignment);
+        heap.sizeBytes = offset + allocation.sizeBytes;
+        heap.alignment = std::max(heap.alignment, allocation.alignment);
+        heap.memoryTypeBits &= allocation.memoryTypeBits;
+        placements[index].heapIndex = heapIndex;
+        placements[index].offset = offset;
+    }
+    return placements;
+}
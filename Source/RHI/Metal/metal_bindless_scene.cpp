@@ -0,0 +1,160 @@
+#include "metal_bindless_scene.h"
+
+#ifdef __APPLE__
+
+#include "bindless_scene_constants.h"
+#include "metal_resource_utils.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t kTextureSlots = METALLIC_BINDLESS_MAX_SAMPLED_IMAGES;
+constexpr uint32_t kSamplerSlots = METALLIC_BINDLESS_MAX_SAMPLERS;
+
+uint64_t* resourceIdSlots(MTL::Buffer* buffer) {
+    return static_cast<uint64_t*>(buffer->contents());
+}
+
+} // namespace
+
+MetalBindlessSceneTable::~MetalBindlessSceneTable() {
+    shutdown();
+}
+
+bool MetalBindlessSceneTable::init(void* deviceHandle, void* commandQueueHandle) {
+    shutdown();
+
+    auto* device = static_cast<MTL::Device*>(deviceHandle);
+    if (!device || device->argumentBuffersSupport() < MTL::ArgumentBuffersTier2) {
+        return false;
+    }
+
+    const size_t byteSize = size_t(kTextureSlots + kSamplerSlots) * sizeof(uint64_t);
+    m_buffer = device->newBuffer(byteSize, MTL::ResourceStorageModeShared);
+    if (!m_buffer) {
+        return false;
+    }
+    m_buffer->setLabel(NS::String::string("Bindless Scene Table", NS::UTF8StringEncoding));
+    std::fill_n(resourceIdSlots(m_buffer), kTextureSlots + kSamplerSlots, uint64_t(0));
+
+    m_commandQueue = commandQueueHandle;
+    m_textures.assign(kTextureSlots, nullptr);
+    m_samplers.assign(kSamplerSlots, nullptr);
+    m_queueResident = metalAddQueueResidency(m_commandQueue, nullptr, 0);
+    return true;
+}
+
+void MetalBindlessSceneTable::shutdown() {
+    for (uint32_t index = 0; index < m_textures.size(); ++index) {
+        setTextureSlot(index, nullptr);
+    }
+    for (auto* sampler : m_samplers) {
+        if (sampler) {
+            sampler->release();
+        }
+    }
+    m_textures.clear();
+    m_samplers.clear();
+    m_nonResidentTextures.clear();
+    if (m_buffer) {
+        m_buffer->release();
+        m_buffer = nullptr;
+    }
+    m_commandQueue = nullptr;
+    m_queueResident = false;
+}
+
+void MetalBindlessSceneTable::setTextureSlot(uint32_t index, MTL::Texture* texture) {
+    MTL::Texture* previous = m_textures[index];
+    if (previous == texture) {
+        return;
+    }
+
+    m_textures[index] = texture;
+    if (texture) {
+        texture->retain();
+        if (m_queueResident) {
+            const void* handle = texture;
+            metalAddQueueResidency(m_commandQueue, &handle, 1);
+        }
+    }
+    if (previous) {
+        const bool stillReferenced =
+            std::find(m_textures.begin(), m_textures.end(), previous) != m_textures.end();
+        if (m_queueResident && !stillReferenced) {
+            const void* handle = previous;
+            metalRemoveQueueResidency(m_commandQueue, &handle, 1);
+        }
+        previous->release();
+    }
+    resourceIdSlots(m_buffer)[index] = texture ? texture->gpuResourceID()._impl : 0;
+}
+
+bool MetalBindlessSceneTable::updateSampledTextures(const RhiTexture* const* textures,
+                                                    uint32_t firstIndex,
+                                                    uint32_t count) {
+    if (!m_buffer || firstIndex > kTextureSlots || count > kTextureSlots - firstIndex) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto* texture = textures[i] ? static_cast<MTL::Texture*>(textures[i]->nativeHandle()) : nullptr;
+        setTextureSlot(firstIndex + i, texture);
+    }
+
+    if (!m_queueResident) {
+        m_nonResidentTextures.clear();
+        for (auto* texture : m_textures) {
+            if (texture) {
+                m_nonResidentTextures.push_back(texture);
+            }
+        }
+    }
+    return true;
+}
+
+bool MetalBindlessSceneTable::updateSampler(uint32_t index, const RhiSampler& sampler) {
+    auto* samplerState = static_cast<MTL::SamplerState*>(sampler.nativeHandle());
+    if (!m_buffer || index >= kSamplerSlots || !samplerState) {
+        return false;
+    }
+
+    samplerState->retain();
+    if (m_samplers[index]) {
+        m_samplers[index]->release();
+    }
+    m_samplers[index] = samplerState;
+    resourceIdSlots(m_buffer)[kTextureSlots + index] = samplerState->gpuResourceID()._impl;
+    return true;
+}
+
+void MetalBindlessSceneTable::bind(MTL::RenderCommandEncoder* encoder) const {
+    if (!m_buffer || !encoder) {
+        return;
+    }
+    encoder->setVertexBuffer(m_buffer, 0, METALLIC_METAL_BINDLESS_BUFFER_INDEX);
+    encoder->setObjectBuffer(m_buffer, 0, METALLIC_METAL_BINDLESS_BUFFER_INDEX);
+    encoder->setMeshBuffer(m_buffer, 0, METALLIC_METAL_BINDLESS_BUFFER_INDEX);
+    encoder->setFragmentBuffer(m_buffer, 0, METALLIC_METAL_BINDLESS_BUFFER_INDEX);
+    if (!m_nonResidentTextures.empty()) {
+        encoder->useResources(m_nonResidentTextures.data(),
+                              m_nonResidentTextures.size(),
+                              MTL::ResourceUsageRead,
+                              MTL::RenderStageMesh | MTL::RenderStageFragment);
+    }
+}
+
+void MetalBindlessSceneTable::bind(MTL::ComputeCommandEncoder* encoder) const {
+    if (!m_buffer || !encoder) {
+        return;
+    }
+    encoder->setBuffer(m_buffer, 0, METALLIC_METAL_BINDLESS_BUFFER_INDEX);
+    if (!m_nonResidentTextures.empty()) {
+        encoder->useResources(m_nonResidentTextures.data(),
+                              m_nonResidentTextures.size(),
+                              MTL::ResourceUsageRead);
+    }
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef __APPLE__
+
+#include "rhi_backend.h"
+
+#include <Metal/Metal.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Tier-2 argument buffer mirroring Shaders/Shared/bindless_scene.slang: the
+// texture resource IDs, followed by the sampler resource IDs. Bound once per
+// encoder at METALLIC_METAL_BINDLESS_BUFFER_INDEX. Textures go into the queue
+// residency set where available, otherwise each encoder declares them with
+// useResources.
+class MetalBindlessSceneTable {
+public:
+    MetalBindlessSceneTable() = default;
+    ~MetalBindlessSceneTable();
+
+    MetalBindlessSceneTable(const MetalBindlessSceneTable&) = delete;
+    MetalBindlessSceneTable& operator=(const MetalBindlessSceneTable&) = delete;
+
+    bool init(void* deviceHandle, void* commandQueueHandle);
+    void shutdown();
+
+    bool updateSampledTextures(const RhiTexture* const* textures, uint32_t firstIndex, uint32_t count);
+    bool updateSampler(uint32_t index, const RhiSampler& sampler);
+
+    bool isValid() const { return m_buffer != nullptr; }
+    void bind(MTL::RenderCommandEncoder* encoder) const;
+    void bind(MTL::ComputeCommandEncoder* encoder) const;
+
+private:
+    void setTextureSlot(uint32_t index, MTL::Texture* texture);
+
+    MTL::Buffer* m_buffer = nullptr;
+    void* m_commandQueue = nullptr;
+    // Retained so slot contents outlive their owners while the table references them.
+    std::vector<MTL::Texture*> m_textures;
+    std::vector<MTL::SamplerState*> m_samplers;
+    std::vector<const MTL::Resource*> m_nonResidentTextures;
+    bool m_queueResident = false;
+};
+
+#endif
@@ -3,10 +3,16 @@
 #ifdef __APPLE__
 
 #include "imgui_metal_bridge.h"
+#include "metal_bindless_scene.h"
+#include "metal_resource_utils.h"
+#include "rhi_encoder_pool.h"
+#include "rhi_transient_placement.h"
 
 #include <array>
 #include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 namespace {
 
@@ -117,12 +123,83 @@ std::vector<MTL::Texture*> collectMetalTextures(const RhiTexture* const* texture
     return result;
 }
 
-class MetalOwnedTexture final : public RhiTexture {
+// Objects an encoder last set on one of its Metal binding tables. Sets that would
+// leave a slot as it was are skipped; a buffer that only moves gets the cheaper
+// offset update. setBytes data has no object to compare, so it only clears its slot.
+template <size_t SlotCount>
+class MetalBindingTable {
 public:
-    explicit MetalOwnedTexture(MTL::Texture* texture)
-        : m_texture(texture) {}
+    enum class Change { None, Offset, Object };
+
+    Change update(uint32_t index, const void* object, uint64_t offset = 0) {
+        if (index >= SlotCount) {
+            return Change::Object;
+        }
+        Slot& slot = m_slots[index];
+        if (slot.valid && slot.object == object) {
+            if (slot.offset == offset || !object) {
+                return Change::None;
+            }
+            slot.offset = offset;
+            return Change::Offset;
+        }
+        slot = {object, offset, true};
+        return Change::Object;
+    }
+
+    void invalidate(uint32_t index) {
+        if (index < SlotCount) {
+            m_slots[index].valid = false;
+        }
+    }
+
+    void invalidateAll() { m_slots.fill({}); }
+
+private:
+    struct Slot {
+        const void* object = nullptr;
+        uint64_t offset = 0;
+        bool valid = false;
+    };
+    std::array<Slot, SlotCount> m_slots{};
+};
+
+constexpr size_t kMetalBufferSlots = 31;
+constexpr size_t kMetalTextureSlots = 128;
+constexpr size_t kMetalSamplerSlots = 16;
+
+// Placement heap shared by aliased frame graph textures or sub-allocated buffers;
+// released with the last resource.
+struct MetalTransientHeap {
+    MTL::Heap* heap = nullptr;
+
+    ~MetalTransientHeap() {
+        if (heap) {
+            heap->release();
+        }
+    }
+};
+
+// Frame graph texture; mipped textures keep one view per level for setTextureMip().
+class MetalFrameGraphTexture : public RhiTexture {
+public:
+    explicit MetalFrameGraphTexture(MTL::Texture* texture, std::shared_ptr<MetalTransientHeap> heap = {})
+        : m_texture(texture), m_heap(std::move(heap)) {
+        const NS::UInteger mipCount = m_texture ? m_texture->mipmapLevelCount() : 1;
+        for (NS::UInteger mip = 0; mipCount > 1 && mip < mipCount; ++mip) {
+            m_mipViews.push_back(m_texture->newTextureView(m_texture->pixelFormat(),
+                                                           m_texture->textureType(),
+                                                           NS::Range(mip, 1),
+                                                           NS::Range(0, 1)));
+        }
+    }
 
-    ~MetalOwnedTexture() override {
+    ~MetalFrameGraphTexture() override {
+        for (MTL::Texture* view : m_mipViews) {
+            if (view) {
+                view->release();
+            }
+        }
         if (m_texture) {
             m_texture->release();
         }
@@ -131,15 +208,49 @@ public:
     void* nativeHandle() const override { return m_texture; }
     uint32_t width() const override { return m_texture ? static_cast<uint32_t>(m_texture->width()) : 0; }
     uint32_t height() const override { return m_texture ? static_cast<uint32_t>(m_texture->height()) : 0; }
+    uint32_t mipLevelCount() const override {
+        return m_texture ? static_cast<uint32_t>(m_texture->mipmapLevelCount()) : 1;
+    }
+
+    MTL::Texture* mipView(uint32_t mipLevel) const {
+        if (mipLevel < m_mipViews.size()) {
+            return m_mipViews[mipLevel];
+        }
+        return mipLevel == 0 ? m_texture : nullptr;
+    }
 
 private:
     MTL::Texture* m_texture = nullptr;
+    std::shared_ptr<MetalTransientHeap> m_heap;
+    std::vector<MTL::Texture*> m_mipViews;
+};
+
+class MetalOwnedTexture final : public MetalFrameGraphTexture {
+public:
+    explicit MetalOwnedTexture(MTL::Texture* texture)
+        : MetalFrameGraphTexture(texture) {}
 };
 
+class MetalPlacedTexture final : public MetalFrameGraphTexture {
+public:
+    MetalPlacedTexture(MTL::Texture* texture, std::shared_ptr<MetalTransientHeap> heap)
+        : MetalFrameGraphTexture(texture, std::move(heap)) {}
+};
+
+MTL::Texture* metalTextureMip(const RhiTexture* texture, uint32_t mipLevel) {
+    if (!texture) {
+        return nullptr;
+    }
+    if (const auto* frameGraphTexture = dynamic_cast<const MetalFrameGraphTexture*>(texture)) {
+        return frameGraphTexture->mipView(mipLevel);
+    }
+    return mipLevel == 0 ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr;
+}
+
 class MetalOwnedBuffer final : public RhiBuffer {
 public:
-    MetalOwnedBuffer(MTL::Buffer* buffer, size_t byteSize)
-        : m_buffer(buffer), m_size(byteSize) {}
+    MetalOwnedBuffer(MTL::Buffer* buffer, size_t byteSize, std::shared_ptr<MetalTransientHeap> heap = {})
+        : m_buffer(buffer), m_size(byteSize), m_heap(std::move(heap)) {}
 
     ~MetalOwnedBuffer() override {
         if (m_buffer) {
@@ -150,10 +261,12 @@ public:
     size_t size() const override { return m_size; }
     void* nativeHandle() const override { return m_buffer; }
     void* mappedData() override { return m_buffer ? m_buffer->contents() : nullptr; }
+    uint64_t gpuAddress() const override { return m_buffer ? m_buffer->gpuAddress() : 0; }
 
 private:
     MTL::Buffer* m_buffer = nullptr;
     size_t m_size = 0;
+    std::shared_ptr<MetalTransientHeap> m_heap; // set for buffers placed in a heap
 };
 
 class MetalRenderCommandEncoder final : public RhiRenderCommandEncoder {
@@ -181,35 +294,111 @@ public:
         viewport.zfar = 1.0;
         m_encoder->setViewport(viewport);
     }
-    void setDepthStencilState(const RhiDepthStencilState* state) override { m_encoder->setDepthStencilState(metalDepthStencilState(state)); }
-    void setFrontFacingWinding(RhiWinding winding) override { m_encoder->setFrontFacingWinding(metalWinding(winding)); }
-    void setCullMode(RhiCullMode cullMode) override { m_encoder->setCullMode(metalCullMode(cullMode)); }
-    void setRenderPipeline(const RhiGraphicsPipeline& pipeline) override { m_encoder->setRenderPipelineState(metalRenderPipeline(pipeline)); }
-    void setVertexBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override { m_encoder->setVertexBuffer(metalBuffer(buffer), offset, index); }
-    void setFragmentBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override { m_encoder->setFragmentBuffer(metalBuffer(buffer), offset, index); }
-    void setMeshBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override { m_encoder->setMeshBuffer(metalBuffer(buffer), offset, index); }
-    void setVertexBytes(const void* data, size_t size, uint32_t index) override { m_encoder->setVertexBytes(data, size, index); }
-    void setFragmentBytes(const void* data, size_t size, uint32_t index) override { m_encoder->setFragmentBytes(data, size, index); }
-    void setMeshBytes(const void* data, size_t size, uint32_t index) override { m_encoder->setMeshBytes(data, size, index); }
+    void setDepthStencilState(const RhiDepthStencilState* state) override {
+        MTL::DepthStencilState* metalState = metalDepthStencilState(state);
+        if (m_hasDepthStencilState && metalState == m_depthStencilState) return;
+        m_depthStencilState = metalState;
+        m_hasDepthStencilState = true;
+        m_encoder->setDepthStencilState(metalState);
+    }
+    void setFrontFacingWinding(RhiWinding winding) override {
+        if (m_hasWinding && winding == m_winding) return;
+        m_winding = winding;
+        m_hasWinding = true;
+        m_encoder->setFrontFacingWinding(metalWinding(winding));
+    }
+    void setCullMode(RhiCullMode cullMode) override {
+        if (m_hasCullMode && cullMode == m_cullMode) return;
+        m_cullMode = cullMode;
+        m_hasCullMode = true;
+        m_encoder->setCullMode(metalCullMode(cullMode));
+    }
+    void setRenderPipeline(const RhiGraphicsPipeline& pipeline) override {
+        MTL::RenderPipelineState* state = metalRenderPipeline(pipeline);
+        if (state && state == m_pipelineState) return;
+        m_pipelineState = state;
+        m_encoder->setRenderPipelineState(state);
+    }
+    void setVertexBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
+        MTL::Buffer* metal = metalBuffer(buffer);
+        switch (m_vertexBuffers.update(index, metal, offset)) {
+        case BufferTable::Change::None: break;
+        case BufferTable::Change::Offset: m_encoder->setVertexBufferOffset(offset, index); break;
+        case BufferTable::Change::Object: m_encoder->setVertexBuffer(metal, offset, index); break;
+        }
+    }
+    void setFragmentBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
+        MTL::Buffer* metal = metalBuffer(buffer);
+        switch (m_fragmentBuffers.update(index, metal, offset)) {
+        case BufferTable::Change::None: break;
+        case BufferTable::Change::Offset: m_encoder->setFragmentBufferOffset(offset, index); break;
+        case BufferTable::Change::Object: m_encoder->setFragmentBuffer(metal, offset, index); break;
+        }
+    }
+    void setMeshBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
+        MTL::Buffer* metal = metalBuffer(buffer);
+        switch (m_meshBuffers.update(index, metal, offset)) {
+        case BufferTable::Change::None: break;
+        case BufferTable::Change::Offset: m_encoder->setMeshBufferOffset(offset, index); break;
+        case BufferTable::Change::Object: m_encoder->setMeshBuffer(metal, offset, index); break;
+        }
+    }
+    void setMeshBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            setMeshBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
+    void setFragmentBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            setFragmentBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
+    void setVertexBytes(const void* data, size_t size, uint32_t index) override {
+        m_vertexBuffers.invalidate(index);
+        m_encoder->setVertexBytes(data, size, index);
+    }
+    void setFragmentBytes(const void* data, size_t size, uint32_t index) override {
+        m_fragmentBuffers.invalidate(index);
+        m_encoder->setFragmentBytes(data, size, index);
+    }
+    void setMeshBytes(const void* data, size_t size, uint32_t index) override {
+        m_meshBuffers.invalidate(index);
+        m_encoder->setMeshBytes(data, size, index);
+    }
     void setPushConstants(const void* data, size_t size) override {
-        m_encoder->setVertexBytes(data, size, 0);
-        m_encoder->setFragmentBytes(data, size, 0);
+        setVertexBytes(data, size, 0);
+        setFragmentBytes(data, size, 0);
+    }
+    void setFragmentTexture(const RhiTexture* texture, uint32_t index) override {
+        MTL::Texture* metal = texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr;
+        if (m_fragmentTextures.update(index, metal) != TextureTable::Change::None) {
+            m_encoder->setFragmentTexture(metal, index);
+        }
     }
-    void setFragmentTexture(const RhiTexture* texture, uint32_t index) override { m_encoder->setFragmentTexture(texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr, index); }
     void setFragmentTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) override {
         auto metalTextures = collectMetalTextures(textures, count);
-        if (count > 0) {
+        if (anyChanged(m_fragmentTextures, metalTextures, startIndex)) {
             m_encoder->setFragmentTextures(metalTextures.data(), NS::Range(startIndex, count));
         }
     }
     void setMeshTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) override {
         auto metalTextures = collectMetalTextures(textures, count);
-        if (count > 0) {
+        if (anyChanged(m_meshTextures, metalTextures, startIndex)) {
             m_encoder->setMeshTextures(metalTextures.data(), NS::Range(startIndex, count));
         }
     }
-    void setFragmentSampler(const RhiSampler* sampler, uint32_t index) override { m_encoder->setFragmentSamplerState(metalSampler(sampler), index); }
-    void setMeshSampler(const RhiSampler* sampler, uint32_t index) override { m_encoder->setMeshSamplerState(metalSampler(sampler), index); }
+    void setFragmentSampler(const RhiSampler* sampler, uint32_t index) override {
+        MTL::SamplerState* metal = metalSampler(sampler);
+        if (m_fragmentSamplers.update(index, metal) != SamplerTable::Change::None) {
+            m_encoder->setFragmentSamplerState(metal, index);
+        }
+    }
+    void setMeshSampler(const RhiSampler* sampler, uint32_t index) override {
+        MTL::SamplerState* metal = metalSampler(sampler);
+        if (m_meshSamplers.update(index, metal) != SamplerTable::Change::None) {
+            m_encoder->setMeshSamplerState(metal, index);
+        }
+    }
     void drawPrimitives(RhiPrimitiveType primitiveType, uint32_t vertexStart, uint32_t vertexCount) override {
         m_encoder->drawPrimitives(metalPrimitiveType(primitiveType), vertexStart, vertexCount);
     }
@@ -224,6 +413,27 @@ public:
                                          metalBuffer(&indexBuffer),
                                          indexBufferOffset);
     }
+    // Metal has no GPU draw count outside indirect command buffers, so every command
+    // is issued; the ones past the count draw nothing (see RhiRenderCommandEncoder).
+    void drawIndexedPrimitivesIndirectCount(RhiPrimitiveType primitiveType,
+                                            RhiIndexType indexType,
+                                            const RhiBuffer& indexBuffer,
+                                            uint64_t indexBufferOffset,
+                                            const RhiBuffer& argumentBuffer,
+                                            uint64_t argumentOffset,
+                                            const RhiBuffer& /*countBuffer*/,
+                                            uint64_t /*countOffset*/,
+                                            uint32_t maxDrawCount) override {
+        constexpr uint64_t kCommandStride = sizeof(MTL::DrawIndexedPrimitivesIndirectArguments);
+        for (uint32_t drawIndex = 0; drawIndex < maxDrawCount; ++drawIndex) {
+            m_encoder->drawIndexedPrimitives(metalPrimitiveType(primitiveType),
+                                             metalIndexType(indexType),
+                                             metalBuffer(&indexBuffer),
+                                             indexBufferOffset,
+                                             metalBuffer(&argumentBuffer),
+                                             argumentOffset + drawIndex * kCommandStride);
+        }
+    }
     void drawMeshThreadgroups(RhiSize3D threadgroupsPerGrid,
                               RhiSize3D threadsPerObjectThreadgroup,
                               RhiSize3D threadsPerMeshThreadgroup) override {
@@ -242,17 +452,58 @@ public:
     }
     void renderImGuiDrawData() override {
         imguiRenderDrawData(m_encoder->commandBuffer(), m_encoder);
+        // ImGui sets its own pipeline, state and bindings.
+        m_pipelineState = nullptr;
+        m_hasDepthStencilState = false;
+        m_hasWinding = false;
+        m_hasCullMode = false;
+        m_vertexBuffers.invalidateAll();
+        m_fragmentBuffers.invalidateAll();
+        m_meshBuffers.invalidateAll();
+        m_fragmentTextures.invalidateAll();
+        m_meshTextures.invalidateAll();
+        m_fragmentSamplers.invalidateAll();
+        m_meshSamplers.invalidateAll();
     }
 
 private:
+    using BufferTable = MetalBindingTable<kMetalBufferSlots>;
+    using TextureTable = MetalBindingTable<kMetalTextureSlots>;
+    using SamplerTable = MetalBindingTable<kMetalSamplerSlots>;
+
+    // Updates every slot, so the table matches whatever the batch call then sets.
+    static bool anyChanged(TextureTable& table, const std::vector<MTL::Texture*>& textures, uint32_t startIndex) {
+        bool changed = false;
+        for (size_t i = 0; i < textures.size(); ++i) {
+            changed |= table.update(startIndex + static_cast<uint32_t>(i), textures[i]) != TextureTable::Change::None;
+        }
+        return changed;
+    }
+
     MTL::RenderCommandEncoder* m_encoder = nullptr;
     TracyMetalGpuZone m_zone = nullptr;
+    MTL::RenderPipelineState* m_pipelineState = nullptr;
+    MTL::DepthStencilState* m_depthStencilState = nullptr;
+    RhiWinding m_winding = RhiWinding::Clockwise;
+    RhiCullMode m_cullMode = RhiCullMode::None;
+    bool m_hasDepthStencilState = false;
+    bool m_hasWinding = false;
+    bool m_hasCullMode = false;
+    BufferTable m_vertexBuffers;
+    BufferTable m_fragmentBuffers;
+    BufferTable m_meshBuffers;
+    TextureTable m_fragmentTextures;
+    TextureTable m_meshTextures;
+    SamplerTable m_fragmentSamplers;
+    SamplerTable m_meshSamplers;
 };
 
 class MetalComputeCommandEncoder final : public RhiComputeCommandEncoder {
 public:
-    MetalComputeCommandEncoder(MTL::ComputeCommandEncoder* encoder, TracyMetalGpuZone zone)
-        : m_encoder(encoder), m_zone(zone) {}
+    MetalComputeCommandEncoder(MTL::ComputeCommandEncoder* encoder,
+                               TracyMetalGpuZone zone,
+                               MTL::CommandBuffer* commandBuffer)
+        : m_encoder(encoder), m_zone(zone), m_commandBuffer(commandBuffer) {}
 
     ~MetalComputeCommandEncoder() override {
         if (m_encoder) {
@@ -264,20 +515,59 @@ public:
     }
 
     void* nativeHandle() const override { return m_encoder; }
-    void setComputePipeline(const RhiComputePipeline& pipeline) override { m_encoder->setComputePipelineState(metalComputePipeline(pipeline)); }
-    void setBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override { m_encoder->setBuffer(metalBuffer(buffer), offset, index); }
-    void setBytes(const void* data, size_t size, uint32_t index) override { m_encoder->setBytes(data, size, index); }
-    void setPushConstants(const void* data, size_t size) override { m_encoder->setBytes(data, size, 0); }
-    void setTexture(const RhiTexture* texture, uint32_t index) override { m_encoder->setTexture(texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr, index); }
+    void setComputePipeline(const RhiComputePipeline& pipeline) override {
+        MTL::ComputePipelineState* state = metalComputePipeline(pipeline);
+        if (state && state == m_pipelineState) return;
+        m_pipelineState = state;
+        m_encoder->setComputePipelineState(state);
+    }
+    void setBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
+        MTL::Buffer* metal = metalBuffer(buffer);
+        switch (m_buffers.update(index, metal, offset)) {
+        case BufferTable::Change::None: break;
+        case BufferTable::Change::Offset: m_encoder->setBufferOffset(offset, index); break;
+        case BufferTable::Change::Object: m_encoder->setBuffer(metal, offset, index); break;
+        }
+    }
+    void setBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            setBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
+    void setBytes(const void* data, size_t size, uint32_t index) override {
+        m_buffers.invalidate(index);
+        m_encoder->setBytes(data, size, index);
+    }
+    void setPushConstants(const void* data, size_t size) override { setBytes(data, size, 0); }
+    void setTexture(const RhiTexture* texture, uint32_t index) override {
+        bindTexture(texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr, index);
+    }
     void setStorageTexture(const RhiTexture* texture, uint32_t index) override { setTexture(texture, index); }
     void setTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) override {
         auto metalTextures = collectMetalTextures(textures, count);
-        if (count > 0) {
+        bool changed = false;
+        for (uint32_t i = 0; i < count; ++i) {
+            changed |= m_textures.update(startIndex + i, metalTextures[i]) != TextureTable::Change::None;
+        }
+        if (changed) {
             m_encoder->setTextures(metalTextures.data(), NS::Range(startIndex, count));
         }
     }
-    void setSampler(const RhiSampler* sampler, uint32_t index) override { m_encoder->setSamplerState(metalSampler(sampler), index); }
+    void setTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) override {
+        bindTexture(metalTextureMip(texture, mipLevel), index);
+    }
+    void setStorageTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) override {
+        setTextureMip(texture, mipLevel, index);
+    }
+    void setSampler(const RhiSampler* sampler, uint32_t index) override {
+        MTL::SamplerState* metal = metalSampler(sampler);
+        if (m_samplers.update(index, metal) != SamplerTable::Change::None) {
+            m_encoder->setSamplerState(metal, index);
+        }
+    }
     void setAccelerationStructure(const RhiAccelerationStructure* accelerationStructure, uint32_t index) override {
+        // Shares the buffer argument table.
+        m_buffers.invalidate(index);
         m_encoder->setAccelerationStructure(metalAccelerationStructure(accelerationStructure), index);
     }
     void useResource(const RhiBuffer& resource, RhiResourceUsage usage) override {
@@ -298,9 +588,32 @@ public:
                                         metalSize(threadsPerThreadgroup));
     }
 
+    MTL::CommandBuffer* endEncodingForCommandBuffer() {
+        if (m_encoder) {
+            m_encoder->endEncoding();
+            m_encoder = nullptr;
+        }
+        return m_commandBuffer;
+    }
+
 private:
+    using BufferTable = MetalBindingTable<kMetalBufferSlots>;
+    using TextureTable = MetalBindingTable<kMetalTextureSlots>;
+    using SamplerTable = MetalBindingTable<kMetalSamplerSlots>;
+
+    void bindTexture(MTL::Texture* texture, uint32_t index) {
+        if (m_textures.update(index, texture) != TextureTable::Change::None) {
+            m_encoder->setTexture(texture, index);
+        }
+    }
+
     MTL::ComputeCommandEncoder* m_encoder = nullptr;
     TracyMetalGpuZone m_zone = nullptr;
+    MTL::CommandBuffer* m_commandBuffer = nullptr;
+    MTL::ComputePipelineState* m_pipelineState = nullptr;
+    BufferTable m_buffers;
+    TextureTable m_textures;
+    SamplerTable m_samplers;
 };
 
 class MetalBlitCommandEncoder final : public RhiBlitCommandEncoder {
@@ -384,9 +697,106 @@ TracyMetalGpuZone beginBlitZone(TracyMetalCtxHandle tracyContext,
 
 } // namespace
 
+MetalTransientPool::Key MetalTransientPool::textureKey(const RhiTextureDesc& desc) {
+    Key key;
+    key.texture = true;
+    key.format = static_cast<uint32_t>(desc.format);
+    key.usage = static_cast<uint32_t>(desc.usage);
+    key.storage = static_cast<uint32_t>(desc.storageMode);
+    key.mipLevels = desc.mipLevels;
+    key.width = desc.width;
+    key.height = desc.height;
+    return key;
+}
+
+MetalTransientPool::Key MetalTransientPool::bufferKey(const RhiBufferDesc& desc) {
+    Key key;
+    key.storage = static_cast<uint32_t>(desc.memory);
+    key.width = desc.size;
+    return key;
+}
+
+bool MetalTransientPool::take(const Key& key, Entry& out) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->second.empty()) {
+        m_cacheMisses++;
+        return false;
+    }
+    out = std::move(it->second.back());
+    it->second.pop_back();
+    if (it->second.empty()) {
+        m_entries.erase(it);
+    }
+    m_pooledBytes -= out.bytes;
+    m_cacheHits++;
+    return true;
+}
+
+void MetalTransientPool::insert(const Key& key, Entry entry) {
+    entry.releaseOrder = m_nextReleaseOrder++;
+    m_pooledBytes += entry.bytes;
+    m_entries[key].push_back(std::move(entry));
+    evictToBudget();
+}
+
+void MetalTransientPool::evictToBudget() {
+    while (m_pooledBytes > m_maxPooledBytes && !m_entries.empty()) {
+        // Each bucket is in release order, so the oldest entry is a bucket front.
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->second.front().releaseOrder < oldest->second.front().releaseOrder) {
+                oldest = it;
+            }
+        }
+        m_pooledBytes -= oldest->second.front().bytes;
+        oldest->second.erase(oldest->second.begin());
+        if (oldest->second.empty()) {
+            m_entries.erase(oldest);
+        }
+    }
+}
+
+std::unique_ptr<RhiTexture> MetalTransientPool::acquireTexture(const RhiTextureDesc& desc) {
+    Entry entry;
+    return take(textureKey(desc), entry) ? std::move(entry.texture) : nullptr;
+}
+
+std::unique_ptr<RhiBuffer> MetalTransientPool::acquireBuffer(const RhiBufferDesc& desc) {
+    Entry entry;
+    return take(bufferKey(desc), entry) ? std::move(entry.buffer) : nullptr;
+}
+
+void MetalTransientPool::releaseTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) {
+    auto* metalTexture = texture ? static_cast<MTL::Texture*>(texture->nativeHandle()) : nullptr;
+    if (!metalTexture) {
+        return;
+    }
+    Entry entry;
+    entry.bytes = metalTexture->allocatedSize();
+    entry.texture = std::move(texture);
+    insert(textureKey(desc), std::move(entry));
+}
+
+void MetalTransientPool::releaseBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) {
+    auto* metalBuffer = buffer ? static_cast<MTL::Buffer*>(buffer->nativeHandle()) : nullptr;
+    if (!metalBuffer) {
+        return;
+    }
+    Entry entry;
+    entry.bytes = metalBuffer->allocatedSize();
+    entry.buffer = std::move(buffer);
+    insert(bufferKey(desc), std::move(entry));
+}
+
 std::unique_ptr<RhiTexture> MetalFrameGraphBackend::createTexture(const RhiTextureDesc& desc) {
+    if (auto pooled = m_transientPool.acquireTexture(desc)) {
+        return pooled;
+    }
     auto* textureDesc = MTL::TextureDescriptor::texture2DDescriptor(
-        metalPixelFormat(desc.format), desc.width, desc.height, false);
+        metalPixelFormat(desc.format), desc.width, desc.height, desc.mipLevels > 1);
+    if (desc.mipLevels > 1) {
+        textureDesc->setMipmapLevelCount(desc.mipLevels);
+    }
     textureDesc->setStorageMode(metalStorageMode(desc.storageMode));
     textureDesc->setUsage(metalTextureUsage(desc.usage));
     MTL::Texture* texture = m_device->newTexture(textureDesc);
@@ -394,13 +804,187 @@ std::unique_ptr<RhiTexture> MetalFrameGraphBackend::createTexture(const RhiTextu
     return std::make_unique<MetalOwnedTexture>(texture);
 }
 
+// Memoryless storage needs the tile memory of Apple-family GPUs.
+bool MetalFrameGraphBackend::supportsMemorylessTextures() const {
+    return m_device && m_device->supportsFamily(MTL::GPUFamilyApple1);
+}
+
+bool MetalFrameGraphBackend::createPlacedTextures(std::vector<RhiTransientTextureRequest>& requests,
+                                                  uint64_t& outHeapBytes) {
+    outHeapBytes = 0;
+    std::vector<MTL::TextureDescriptor*> descriptors(requests.size(), nullptr);
+    std::vector<RhiTransientAllocationInfo> allocations(requests.size());
+    auto releaseDescriptors = [&]() {
+        for (MTL::TextureDescriptor* descriptor : descriptors) {
+            if (descriptor) {
+                descriptor->release();
+            }
+        }
+    };
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const RhiTextureDesc& desc = requests[i].desc;
+        auto* textureDesc = MTL::TextureDescriptor::texture2DDescriptor(
+            metalPixelFormat(desc.format), desc.width, desc.height, desc.mipLevels > 1);
+        if (desc.mipLevels > 1) {
+            textureDesc->setMipmapLevelCount(desc.mipLevels);
+        }
+        textureDesc->setStorageMode(MTL::StorageModePrivate);
+        textureDesc->setUsage(metalTextureUsage(desc.usage));
+        textureDesc->retain();
+        descriptors[i] = textureDesc;
+
+        const MTL::SizeAndAlign sizeAndAlign = m_device->heapTextureSizeAndAlign(textureDesc);
+        allocations[i].sizeBytes = sizeAndAlign.size;
+        allocations[i].alignment = sizeAndAlign.align;
+        allocations[i].firstPass = requests[i].firstPass;
+        allocations[i].lastPass = requests[i].lastPass;
+    }
+
+    std::vector<RhiTransientHeapLayout> heapLayouts;
+    const std::vector<RhiTransientPlacement> placements =
+        rhiPlaceTransientAllocations(allocations, heapLayouts);
+
+    // Tracked heaps let Metal order each new occupant after the previous one.
+    std::vector<std::shared_ptr<MetalTransientHeap>> heaps;
+    for (const RhiTransientHeapLayout& layout : heapLayouts) {
+        auto* heapDesc = MTL::HeapDescriptor::alloc()->init();
+        heapDesc->setType(MTL::HeapTypePlacement);
+        heapDesc->setStorageMode(MTL::StorageModePrivate);
+        heapDesc->setHazardTrackingMode(MTL::HazardTrackingModeTracked);
+        heapDesc->setSize(layout.sizeBytes);
+        auto heap = std::make_shared<MetalTransientHeap>();
+        heap->heap = m_device->newHeap(heapDesc);
+        heapDesc->release();
+        if (!heap->heap) {
+            releaseDescriptors();
+            return false;
+        }
+        heaps.push_back(std::move(heap));
+        outHeapBytes += layout.sizeBytes;
+    }
+
+    std::vector<MTL::Texture*> textures(requests.size(), nullptr);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        textures[i] = heaps[placements[i].heapIndex]->heap->newTexture(descriptors[i], placements[i].offset);
+        if (!textures[i]) {
+            for (MTL::Texture* texture : textures) {
+                if (texture) {
+                    texture->release();
+                }
+            }
+            releaseDescriptors();
+            outHeapBytes = 0;
+            return false;
+        }
+    }
+    releaseDescriptors();
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].texture = std::make_unique<MetalPlacedTexture>(textures[i], heaps[placements[i].heapIndex]);
+        requests[i].heapIndex = placements[i].heapIndex;
+        requests[i].heapOffset = placements[i].offset;
+        requests[i].sizeBytes = allocations[i].sizeBytes;
+        requests[i].aliased = placements[i].aliased;
+    }
+    return true;
+}
+
+bool MetalFrameGraphBackend::createSubAllocatedBuffers(std::vector<RhiTransientBufferRequest>& requests,
+                                                       uint64_t& outHeapBytes) {
+    outHeapBytes = 0;
+    auto resourceOptions = [](const RhiBufferDesc& desc) {
+        return rhiBufferMemoryIsHostVisible(desc.memory) ? MTL::ResourceStorageModeShared
+                                                         : MTL::ResourceStorageModePrivate;
+    };
+
+    std::vector<RhiTransientAllocationInfo> allocations(requests.size());
+    std::vector<uint32_t> heapKeys(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const MTL::SizeAndAlign sizeAndAlign =
+            m_device->heapBufferSizeAndAlign(requests[i].desc.size, resourceOptions(requests[i].desc));
+        allocations[i].sizeBytes = sizeAndAlign.size;
+        allocations[i].alignment = sizeAndAlign.align;
+        heapKeys[i] = rhiBufferMemoryIsHostVisible(requests[i].desc.memory) ? 1u : 0u;
+    }
+
+    std::vector<RhiTransientHeapLayout> heapLayouts;
+    const std::vector<RhiTransientPlacement> placements =
+        rhiPackTransientAllocationsLinear(allocations, heapKeys, heapLayouts);
+
+    std::vector<uint32_t> heapHostVisible(heapLayouts.size(), 0u);
+    for (size_t i = 0; i < placements.size(); ++i) {
+        heapHostVisible[placements[i].heapIndex] = heapKeys[i];
+    }
+
+    std::vector<std::shared_ptr<MetalTransientHeap>> heaps;
+    for (uint32_t heapIndex = 0; heapIndex < heapLayouts.size(); ++heapIndex) {
+        auto* heapDesc = MTL::HeapDescriptor::alloc()->init();
+        heapDesc->setType(MTL::HeapTypePlacement);
+        heapDesc->setStorageMode(heapHostVisible[heapIndex] != 0u ? MTL::StorageModeShared
+                                                                  : MTL::StorageModePrivate);
+        heapDesc->setHazardTrackingMode(MTL::HazardTrackingModeTracked);
+        heapDesc->setSize(heapLayouts[heapIndex].sizeBytes);
+        auto heap = std::make_shared<MetalTransientHeap>();
+        heap->heap = m_device->newHeap(heapDesc);
+        heapDesc->release();
+        if (!heap->heap) {
+            return false;
+        }
+        heaps.push_back(std::move(heap));
+        outHeapBytes += heapLayouts[heapIndex].sizeBytes;
+    }
+
+    std::vector<MTL::Buffer*> buffers(requests.size(), nullptr);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const RhiBufferDesc& desc = requests[i].desc;
+        buffers[i] = heaps[placements[i].heapIndex]->heap->newBuffer(desc.size, resourceOptions(desc),
+                                                                     placements[i].offset);
+        if (!buffers[i]) {
+            for (MTL::Buffer* buffer : buffers) {
+                if (buffer) {
+                    buffer->release();
+                }
+            }
+            outHeapBytes = 0;
+            return false;
+        }
+        if (desc.initialData && buffers[i]->contents()) {
+            std::memcpy(buffers[i]->contents(), desc.initialData, desc.size);
+        }
+        if (desc.debugName) {
+            buffers[i]->setLabel(NS::String::string(desc.debugName, NS::UTF8StringEncoding));
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].buffer =
+            std::make_unique<MetalOwnedBuffer>(buffers[i], requests[i].desc.size, heaps[placements[i].heapIndex]);
+        requests[i].heapIndex = placements[i].heapIndex;
+        requests[i].heapOffset = placements[i].offset;
+        requests[i].sizeBytes = allocations[i].sizeBytes;
+    }
+    return true;
+}
+
 std::unique_ptr<RhiBuffer> MetalFrameGraphBackend::createBuffer(const RhiBufferDesc& desc) {
-    const MTL::ResourceOptions options = desc.hostVisible
+    const bool hostVisible = rhiBufferMemoryIsHostVisible(desc.memory);
+    if (auto pooled = m_transientPool.acquireBuffer(desc)) {
+        if (desc.initialData && pooled->mappedData()) {
+            std::memcpy(pooled->mappedData(), desc.initialData, desc.size);
+        }
+        if (desc.debugName) {
+            static_cast<MTL::Buffer*>(pooled->nativeHandle())
+                ->setLabel(NS::String::string(desc.debugName, NS::UTF8StringEncoding));
+        }
+        return pooled;
+    }
+    const MTL::ResourceOptions options = hostVisible
         ? MTL::ResourceStorageModeShared
         : MTL::ResourceStorageModePrivate;
 
     MTL::Buffer* buffer = nullptr;
-    if (desc.initialData && desc.hostVisible) {
+    if (desc.initialData && hostVisible) {
         buffer = m_device->newBuffer(desc.initialData, desc.size, options);
     } else {
         buffer = m_device->newBuffer(desc.size, options);
@@ -416,11 +1000,22 @@ std::unique_ptr<RhiBuffer> MetalFrameGraphBackend::createBuffer(const RhiBufferD
     return std::make_unique<MetalOwnedBuffer>(buffer, desc.size);
 }
 
-MetalCommandBuffer::MetalCommandBuffer(void* commandBufferHandle, TracyMetalCtxHandle tracyContext)
+void MetalFrameGraphBackend::recycleTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) {
+    m_transientPool.releaseTexture(std::move(texture), desc);
+}
+
+void MetalFrameGraphBackend::recycleBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) {
+    m_transientPool.releaseBuffer(std::move(buffer), desc);
+}
+
+MetalCommandBuffer::MetalCommandBuffer(void* commandBufferHandle,
+                                       TracyMetalCtxHandle tracyContext,
+                                       const MetalBindlessSceneTable* bindlessScene)
     : m_commandBuffer(static_cast<MTL::CommandBuffer*>(commandBufferHandle)),
-      m_tracyContext(tracyContext) {}
+      m_tracyContext(tracyContext),
+      m_bindlessScene(bindlessScene) {}
 
-std::unique_ptr<RhiRenderCommandEncoder> MetalCommandBuffer::beginRenderPass(const RhiRenderPassDesc& desc) {
+RhiEncoderPtr<RhiRenderCommandEncoder> MetalCommandBuffer::beginRenderPass(const RhiRenderPassDesc& desc) {
     auto* renderPassDesc = MTL::RenderPassDescriptor::alloc()->init();
 
     for (uint32_t index = 0; index < desc.colorAttachmentCount; ++index) {
@@ -444,25 +1039,35 @@ std::unique_ptr<RhiRenderCommandEncoder> MetalCommandBuffer::beginRenderPass(con
     TracyMetalGpuZone zone = beginRenderZone(m_tracyContext, renderPassDesc, desc.label ? desc.label : "Render Pass", slot);
     MTL::RenderCommandEncoder* encoder = m_commandBuffer->renderCommandEncoder(renderPassDesc);
     renderPassDesc->release();
-    return std::make_unique<MetalRenderCommandEncoder>(encoder, zone);
+    if (m_bindlessScene) {
+        m_bindlessScene->bind(encoder);
+    }
+    return rhiThreadEncoderPool<MetalRenderCommandEncoder>().acquire<RhiRenderCommandEncoder>(encoder, zone);
 }
 
-std::unique_ptr<RhiComputeCommandEncoder> MetalCommandBuffer::beginComputePass(const RhiComputePassDesc& desc) {
+RhiEncoderPtr<RhiComputeCommandEncoder> MetalCommandBuffer::beginComputePass(const RhiComputePassDesc& desc) {
     auto* computePassDesc = MTL::ComputePassDescriptor::alloc()->init();
     const uint32_t slot = m_zoneIndex++ % 128u;
     TracyMetalGpuZone zone = beginComputeZone(m_tracyContext, computePassDesc, desc.label ? desc.label : "Compute Pass", slot);
     MTL::ComputeCommandEncoder* encoder = m_commandBuffer->computeCommandEncoder(computePassDesc);
     computePassDesc->release();
-    return std::make_unique<MetalComputeCommandEncoder>(encoder, zone);
+    if (m_bindlessScene) {
+        m_bindlessScene->bind(encoder);
+    }
+    return rhiThreadEncoderPool<MetalComputeCommandEncoder>().acquire<RhiComputeCommandEncoder>(encoder, zone, m_commandBuffer);
 }
 
-std::unique_ptr<RhiBlitCommandEncoder> MetalCommandBuffer::beginBlitPass(const RhiBlitPassDesc& desc) {
+RhiEncoderPtr<RhiBlitCommandEncoder> MetalCommandBuffer::beginBlitPass(const RhiBlitPassDesc& desc) {
     auto* blitPassDesc = MTL::BlitPassDescriptor::alloc()->init();
     const uint32_t slot = m_zoneIndex++ % 128u;
     TracyMetalGpuZone zone = beginBlitZone(m_tracyContext, blitPassDesc, desc.label ? desc.label : "Blit Pass", slot);
     MTL::BlitCommandEncoder* encoder = m_commandBuffer->blitCommandEncoder(blitPassDesc);
     blitPassDesc->release();
-    return std::make_unique<MetalBlitCommandEncoder>(encoder, zone);
+    return rhiThreadEncoderPool<MetalBlitCommandEncoder>().acquire<RhiBlitCommandEncoder>(encoder, zone);
+}
+
+void MetalCommandBuffer::waitForTransfer(uint64_t value) {
+    metalEncodeTransferWait(m_commandBuffer, value);
 }
 
 MTL::Texture* metalTexture(RhiTexture* texture) {
@@ -485,6 +1090,10 @@ MTL::BlitCommandEncoder* metalEncoder(RhiBlitCommandEncoder& encoder) {
     return static_cast<MTL::BlitCommandEncoder*>(encoder.nativeHandle());
 }
 
+MTL::CommandBuffer* metalEndEncodingForCommandBuffer(RhiComputeCommandEncoder& encoder) {
+    return static_cast<MetalComputeCommandEncoder&>(encoder).endEncodingForCommandBuffer();
+}
+
 MTL::PixelFormat metalPixelFormat(RhiFormat format) {
     switch (format) {
     case RhiFormat::R8Unorm: return MTL::PixelFormatR8Unorm;
@@ -494,6 +1103,7 @@ MTL::PixelFormat metalPixelFormat(RhiFormat format) {
     case RhiFormat::RG8Unorm: return MTL::PixelFormatRG8Unorm;
     case RhiFormat::RG16Float: return MTL::PixelFormatRG16Float;
     case RhiFormat::RG32Float: return MTL::PixelFormatRG32Float;
+    case RhiFormat::RG32Uint: return MTL::PixelFormatRG32Uint;
     case RhiFormat::RGBA8Unorm: return MTL::PixelFormatRGBA8Unorm;
     case RhiFormat::RGBA8Srgb: return MTL::PixelFormatRGBA8Unorm_sRGB;
     case RhiFormat::BGRA8Unorm: return MTL::PixelFormatBGRA8Unorm;
@@ -501,6 +1111,7 @@ MTL::PixelFormat metalPixelFormat(RhiFormat format) {
     case RhiFormat::RGBA32Float: return MTL::PixelFormatRGBA32Float;
     case RhiFormat::D32Float: return MTL::PixelFormatDepth32Float;
     case RhiFormat::D16Unorm: return MTL::PixelFormatDepth16Unorm;
+    case RhiFormat::BC7RGBAUnorm: return MTL::PixelFormatBC7_RGBAUnorm;
     case RhiFormat::Undefined:
     default: return MTL::PixelFormatInvalid;
     }
@@ -515,6 +1126,7 @@ RhiFormat metalToRhiFormat(MTL::PixelFormat format) {
     case MTL::PixelFormatRG8Unorm: return RhiFormat::RG8Unorm;
     case MTL::PixelFormatRG16Float: return RhiFormat::RG16Float;
     case MTL::PixelFormatRG32Float: return RhiFormat::RG32Float;
+    case MTL::PixelFormatRG32Uint: return RhiFormat::RG32Uint;
     case MTL::PixelFormatRGBA8Unorm: return RhiFormat::RGBA8Unorm;
     case MTL::PixelFormatRGBA8Unorm_sRGB: return RhiFormat::RGBA8Srgb;
     case MTL::PixelFormatBGRA8Unorm: return RhiFormat::BGRA8Unorm;
@@ -522,6 +1134,7 @@ RhiFormat metalToRhiFormat(MTL::PixelFormat format) {
     case MTL::PixelFormatRGBA32Float: return RhiFormat::RGBA32Float;
     case MTL::PixelFormatDepth32Float: return RhiFormat::D32Float;
     case MTL::PixelFormatDepth16Unorm: return RhiFormat::D16Unorm;
+    case MTL::PixelFormatBC7_RGBAUnorm: return RhiFormat::BC7RGBAUnorm;
     default: return RhiFormat::Undefined;
     }
 }
@@ -543,6 +1156,7 @@ MTL::TextureUsage metalTextureUsage(RhiTextureUsage usage) {
 MTL::StorageMode metalStorageMode(RhiTextureStorageMode storageMode) {
     switch (storageMode) {
     case RhiTextureStorageMode::Shared: return MTL::StorageModeShared;
+    case RhiTextureStorageMode::Memoryless: return MTL::StorageModeMemoryless;
     case RhiTextureStorageMode::Private:
     default: return MTL::StorageModePrivate;
     }
@@ -7,6 +7,12 @@
 
 #include <Metal/Metal.hpp>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 class MetalImportedTexture final : public RhiTexture {
 public:
     explicit MetalImportedTexture(void* textureHandle = nullptr)
@@ -22,6 +28,72 @@ private:
     MTL::Texture* m_texture = nullptr;
 };
 
+// Frame graph transients handed back on a graph rebuild, kept for the next
+// matching create call. Command buffers retain the Metal objects they use, so
+// entries can be reused or evicted right away. Evicts least recently released
+// entries once the pool exceeds its byte budget.
+class MetalTransientPool {
+public:
+    explicit MetalTransientPool(uint64_t maxPooledBytes = 256ull * 1024 * 1024)
+        : m_maxPooledBytes(maxPooledBytes) {}
+
+    std::unique_ptr<RhiTexture> acquireTexture(const RhiTextureDesc& desc);
+    std::unique_ptr<RhiBuffer> acquireBuffer(const RhiBufferDesc& desc);
+    void releaseTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc);
+    void releaseBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc);
+
+    uint64_t pooledBytes() const { return m_pooledBytes; }
+    uint32_t cacheHits() const { return m_cacheHits; }
+    uint32_t cacheMisses() const { return m_cacheMisses; }
+
+private:
+    // Packed texture or buffer descriptor; equal keys are interchangeable.
+    struct Key {
+        bool texture = false;
+        uint32_t format = 0;
+        uint32_t usage = 0;
+        uint32_t storage = 0;
+        uint32_t mipLevels = 0;
+        uint64_t width = 0; // byte size for buffers
+        uint32_t height = 0;
+        bool operator==(const Key& other) const {
+            return texture == other.texture && format == other.format && usage == other.usage &&
+                   storage == other.storage && mipLevels == other.mipLevels &&
+                   width == other.width && height == other.height;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = std::hash<uint64_t>{}(k.width);
+            h ^= std::hash<uint32_t>{}(k.height) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}(k.format) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}(k.usage) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}((k.storage << 8) | (k.mipLevels << 1) | (k.texture ? 1u : 0u)) +
+                 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    struct Entry {
+        std::unique_ptr<RhiTexture> texture;
+        std::unique_ptr<RhiBuffer> buffer;
+        uint64_t bytes = 0;
+        uint64_t releaseOrder = 0;
+    };
+
+    static Key textureKey(const RhiTextureDesc& desc);
+    static Key bufferKey(const RhiBufferDesc& desc);
+    bool take(const Key& key, Entry& out);
+    void insert(const Key& key, Entry entry);
+    void evictToBudget();
+
+    std::unordered_map<Key, std::vector<Entry>, KeyHash> m_entries;
+    uint64_t m_maxPooledBytes = 0;
+    uint64_t m_pooledBytes = 0;
+    uint64_t m_nextReleaseOrder = 0;
+    uint32_t m_cacheHits = 0;
+    uint32_t m_cacheMisses = 0;
+};
+
 class MetalFrameGraphBackend final : public RhiFrameGraphBackend {
 public:
     explicit MetalFrameGraphBackend(void* deviceHandle)
@@ -29,22 +101,38 @@ public:
 
     std::unique_ptr<RhiTexture> createTexture(const RhiTextureDesc& desc) override;
     std::unique_ptr<RhiBuffer> createBuffer(const RhiBufferDesc& desc) override;
+    bool createPlacedTextures(std::vector<RhiTransientTextureRequest>& requests,
+                              uint64_t& outHeapBytes) override;
+    bool createSubAllocatedBuffers(std::vector<RhiTransientBufferRequest>& requests,
+                                   uint64_t& outHeapBytes) override;
+    bool supportsMemorylessTextures() const override;
+    void recycleTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) override;
+    void recycleBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) override;
+
+    const MetalTransientPool& transientPool() const { return m_transientPool; }
 
 private:
     MTL::Device* m_device = nullptr;
+    MetalTransientPool m_transientPool;
 };
 
+class MetalBindlessSceneTable;
+
 class MetalCommandBuffer final : public RhiCommandBuffer {
 public:
-    MetalCommandBuffer(void* commandBufferHandle, TracyMetalCtxHandle tracyContext = nullptr);
+    MetalCommandBuffer(void* commandBufferHandle,
+                       TracyMetalCtxHandle tracyContext = nullptr,
+                       const MetalBindlessSceneTable* bindlessScene = nullptr);
 
-    std::unique_ptr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) override;
-    std::unique_ptr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) override;
-    std::unique_ptr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) override;
+    RhiEncoderPtr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) override;
+    RhiEncoderPtr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) override;
+    RhiEncoderPtr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) override;
+    void waitForTransfer(uint64_t value) override;
 
 private:
     MTL::CommandBuffer* m_commandBuffer = nullptr;
     TracyMetalCtxHandle m_tracyContext = nullptr;
+    const MetalBindlessSceneTable* m_bindlessScene = nullptr;
     uint32_t m_zoneIndex = 0;
 };
 
@@ -53,6 +141,10 @@ const MTL::Texture* metalTexture(const RhiTexture* texture);
 MTL::RenderCommandEncoder* metalEncoder(RhiRenderCommandEncoder& encoder);
 MTL::ComputeCommandEncoder* metalEncoder(RhiComputeCommandEncoder& encoder);
 MTL::BlitCommandEncoder* metalEncoder(RhiBlitCommandEncoder& encoder);
+// Ends a compute pass early and returns its command buffer, for framework encoders
+// (MetalFX) that record directly into the command buffer. The pass must not use the
+// encoder afterwards.
+MTL::CommandBuffer* metalEndEncodingForCommandBuffer(RhiComputeCommandEncoder& encoder);
 
 MTL::PixelFormat metalPixelFormat(RhiFormat format);
 RhiFormat metalToRhiFormat(MTL::PixelFormat format);
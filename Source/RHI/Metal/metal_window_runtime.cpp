@@ -2,22 +2,39 @@
 
 #ifdef __APPLE__
 
+#include "bindless_scene_constants.h"
 #include "imgui_metal_bridge.h"
+#include "metal_bindless_scene.h"
 #include "metal_frame_graph.h"
+#include "metal_resource_utils.h"
 #include "metal_runtime.h"
+#include "metal_shader_utils.h"
 
 namespace {
 
+constexpr const char* kMetalPipelineArchivePath = "cache/pipelines/metal_pipelines.binarchive";
+
 class MetalWindowRuntime final : public RhiWindowRuntime {
 public:
     explicit MetalWindowRuntime(MetalRuntimeContext runtime)
         : m_runtime(runtime),
           m_device(runtime.device),
-          m_commandQueue(runtime.commandQueue) {}
+          m_commandQueue(runtime.commandQueue) {
+        m_bindlessScene.init(runtime.device, runtime.commandQueue);
+        metalCreateTransferQueue(runtime.device);
+        // Without an archive pipelines still compile, just without the warm start.
+        std::string archiveError;
+        metalOpenPipelineArchive(runtime.device, kMetalPipelineArchivePath, archiveError);
+    }
 
     ~MetalWindowRuntime() override {
         shutdownImGui();
         cleanupFrameState();
+        std::string archiveError;
+        metalSavePipelineArchive(archiveError);
+        metalClosePipelineArchive();
+        m_bindlessScene.shutdown();
+        metalDestroyTransferQueue();
         destroyMetalRuntime(m_runtime);
     }
 
@@ -75,7 +92,15 @@ public:
 
     std::unique_ptr<RhiCommandBuffer> createCommandBuffer() const override {
         return std::make_unique<MetalCommandBuffer>(m_commandBuffer.nativeHandle(),
-                                                    m_runtime.tracyContext);
+                                                    m_runtime.tracyContext,
+                                                    m_bindlessScene.isValid() ? &m_bindlessScene : nullptr);
+    }
+
+    bool updateBindlessSceneTextures(const RhiTexture* const* textures,
+                                     uint32_t count,
+                                     const RhiSampler& sampler) override {
+        return m_bindlessScene.updateSampledTextures(textures, 0, count) &&
+               m_bindlessScene.updateSampler(METALLIC_BINDLESS_SCENE_SAMPLER_INDEX, sampler);
     }
 
     void initImGui() override {
@@ -115,6 +140,7 @@ private:
     RhiCommandQueueHandle m_commandQueue;
     RhiNativeCommandBufferHandle m_commandBuffer;
     RhiTextureHandle m_backbufferTexture;
+    MetalBindlessSceneTable m_bindlessScene;
     void* m_autoreleasePool = nullptr;
     void* m_drawable = nullptr;
     bool m_imguiInitialized = false;
@@ -2,6 +2,8 @@
 
 #ifdef _WIN32
 #include <algorithm>
+#include <fstream>
+#include <limits>
 #include <spdlog/spdlog.h>
 #include <vector>
 
@@ -9,6 +11,31 @@ namespace {
 
 constexpr uint32_t kMaxTimestampQueriesPerFrame = 512;
 constexpr uint32_t kMaxPipelineStatisticQueriesPerFrame = 128;
+constexpr uint32_t kMaxPerformanceQueriesPerFrame = 64;
+constexpr uint32_t kMaxPerformanceCounters = 8;
+
+const char* performanceCounterUnitName(VkPerformanceCounterUnitKHR unit) {
+    switch (unit) {
+    case VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR:
+        return "bytes";
+    case VK_PERFORMANCE_COUNTER_UNIT_BYTES_PER_SECOND_KHR:
+        return "bytes/s";
+    default:
+        return "";
+    }
+}
+
+std::string csvQuoted(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
 
 } // namespace
 
@@ -94,7 +121,122 @@ bool VulkanGpuProfiler::init(VkPhysicalDevice physicalDevice,
     return true;
 }
 
+bool VulkanGpuProfiler::initPerformanceCounters(VkInstance instance,
+                                                VkPhysicalDevice physicalDevice,
+                                                uint32_t queueFamilyIndex) {
+    if (m_device == VK_NULL_HANDLE || instance == VK_NULL_HANDLE || m_frames.empty()) {
+        return false;
+    }
+
+    const auto enumerateCounters =
+        reinterpret_cast<PFN_vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR>(
+            vkGetInstanceProcAddr(instance, "vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR"));
+    const auto getPassCount = reinterpret_cast<PFN_vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR"));
+    const auto acquireProfilingLock = reinterpret_cast<PFN_vkAcquireProfilingLockKHR>(
+        vkGetDeviceProcAddr(m_device, "vkAcquireProfilingLockKHR"));
+    const auto releaseProfilingLock = reinterpret_cast<PFN_vkReleaseProfilingLockKHR>(
+        vkGetDeviceProcAddr(m_device, "vkReleaseProfilingLockKHR"));
+    if (!enumerateCounters || !getPassCount || !acquireProfilingLock || !releaseProfilingLock) {
+        spdlog::warn("VulkanGpuProfiler: VK_KHR_performance_query entry points missing; vendor counters disabled");
+        return false;
+    }
+
+    uint32_t counterCount = 0;
+    enumerateCounters(physicalDevice, queueFamilyIndex, &counterCount, nullptr, nullptr);
+    std::vector<VkPerformanceCounterKHR> counters(counterCount,
+                                                  VkPerformanceCounterKHR{VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR});
+    std::vector<VkPerformanceCounterDescriptionKHR> descriptions(
+        counterCount, VkPerformanceCounterDescriptionKHR{VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR});
+    if (counterCount == 0 ||
+        enumerateCounters(physicalDevice, queueFamilyIndex, &counterCount, counters.data(), descriptions.data()) !=
+            VK_SUCCESS) {
+        return false;
+    }
+
+    // Memory traffic is what pipeline statistics cannot show. Scopes open inside
+    // dynamic rendering, which only command-scoped counters allow.
+    std::vector<uint32_t> selected;
+    for (uint32_t index = 0; index < counterCount && selected.size() < kMaxPerformanceCounters; ++index) {
+        const VkPerformanceCounterKHR& counter = counters[index];
+        if (counter.scope == VK_PERFORMANCE_COUNTER_SCOPE_COMMAND_KHR &&
+            (counter.unit == VK_PERFORMANCE_COUNTER_UNIT_BYTES_KHR ||
+             counter.unit == VK_PERFORMANCE_COUNTER_UNIT_BYTES_PER_SECOND_KHR)) {
+            selected.push_back(index);
+        }
+    }
+
+    // Counter sets needing several passes would have every submit replayed, so
+    // drop counters until the rest fit in one.
+    VkQueryPoolPerformanceCreateInfoKHR performanceInfo{VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR};
+    performanceInfo.queueFamilyIndex = queueFamilyIndex;
+    while (!selected.empty()) {
+        performanceInfo.counterIndexCount = static_cast<uint32_t>(selected.size());
+        performanceInfo.pCounterIndices = selected.data();
+        uint32_t passCount = 0;
+        getPassCount(physicalDevice, &performanceInfo, &passCount);
+        if (passCount == 1) {
+            break;
+        }
+        selected.pop_back();
+    }
+    if (selected.empty()) {
+        spdlog::info("VulkanGpuProfiler: no single-pass bandwidth counters on this device");
+        return false;
+    }
+
+    VkAcquireProfilingLockInfoKHR lockInfo{VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR};
+    lockInfo.timeout = UINT64_MAX;
+    if (acquireProfilingLock(m_device, &lockInfo) != VK_SUCCESS) {
+        spdlog::warn("VulkanGpuProfiler: failed to acquire the profiling lock; vendor counters disabled");
+        return false;
+    }
+    m_vkReleaseProfilingLockKHR = releaseProfilingLock;
+
+    for (FrameState& frame : m_frames) {
+        VkQueryPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        poolInfo.pNext = &performanceInfo;
+        poolInfo.queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+        poolInfo.queryCount = kMaxPerformanceQueriesPerFrame;
+        if (vkCreateQueryPool(m_device, &poolInfo, nullptr, &frame.performancePool) != VK_SUCCESS) {
+            spdlog::warn("VulkanGpuProfiler: failed to create performance query pool; vendor counters disabled");
+            destroyPerformanceCounters();
+            return false;
+        }
+        // Performance queries may not be reset inside the command buffers that use them.
+        vkResetQueryPool(m_device, frame.performancePool, 0, kMaxPerformanceQueriesPerFrame);
+    }
+
+    for (uint32_t index : selected) {
+        VulkanPerformanceCounterInfo& info = m_performanceCounters.emplace_back();
+        info.name = descriptions[index].name;
+        info.category = descriptions[index].category;
+        info.unit = performanceCounterUnitName(counters[index].unit);
+        m_performanceCounterStorage.push_back(counters[index].storage);
+    }
+    spdlog::info("VulkanGpuProfiler: sampling {} of {} performance counters", selected.size(), counterCount);
+    return true;
+}
+
+void VulkanGpuProfiler::destroyPerformanceCounters() {
+    for (FrameState& frame : m_frames) {
+        if (frame.performancePool != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(m_device, frame.performancePool, nullptr);
+        }
+        frame.performancePool = VK_NULL_HANDLE;
+        frame.nextPerformanceQuery = 0;
+        frame.performanceQueryOpen = false;
+    }
+    if (m_vkReleaseProfilingLockKHR && m_device != VK_NULL_HANDLE) {
+        m_vkReleaseProfilingLockKHR(m_device);
+    }
+    m_vkReleaseProfilingLockKHR = nullptr;
+    m_performanceCounters.clear();
+    m_performanceCounterStorage.clear();
+}
+
 void VulkanGpuProfiler::destroy() {
+    destroyPerformanceCounters();
     for (FrameState& frame : m_frames) {
         if (frame.timestampPool != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
             vkDestroyQueryPool(m_device, frame.timestampPool, nullptr);
@@ -118,6 +260,8 @@ void VulkanGpuProfiler::destroy() {
     m_pipelineStatisticsMask = 0;
     m_pipelineStatisticValueCount = 0;
     m_latestFrame = {};
+    m_passHistory.clear();
+    m_passCounters.clear();
 }
 
 void VulkanGpuProfiler::beginFrame(uint32_t frameIndex, uint64_t completedFrameIndex) {
@@ -129,11 +273,16 @@ void VulkanGpuProfiler::beginFrame(uint32_t frameIndex, uint64_t completedFrameI
     if (frame.hasSubmittedFrame) {
         collectFrame(frame);
     }
+    if (frame.performancePool != VK_NULL_HANDLE && frame.nextPerformanceQuery > 0) {
+        vkResetQueryPool(m_device, frame.performancePool, 0, frame.nextPerformanceQuery);
+    }
 
     frame.frameIndex = completedFrameIndex;
     frame.hasSubmittedFrame = true;
     frame.nextTimestampQuery = 0;
     frame.nextPipelineStatsQuery = 0;
+    frame.nextPerformanceQuery = 0;
+    frame.performanceQueryOpen = false;
     frame.scopes.clear();
     m_activeFrameIndex = frameIndex;
 }
@@ -173,10 +322,21 @@ void VulkanGpuProfiler::beginScope(VkCommandBuffer commandBuffer,
                          scope.startQuery);
 
     if (allowPipelineStats &&
+        m_pipelineStatisticsEnabled &&
         frame.pipelineStatsPool != VK_NULL_HANDLE &&
         frame.nextPipelineStatsQuery < kMaxPipelineStatisticQueriesPerFrame) {
         scope.pipelineStatsQuery = frame.nextPipelineStatsQuery++;
         vkCmdBeginQuery(commandBuffer, frame.pipelineStatsPool, scope.pipelineStatsQuery, 0);
+
+        // Only one performance query may be active at a time.
+        if (m_performanceCountersEnabled &&
+            frame.performancePool != VK_NULL_HANDLE &&
+            !frame.performanceQueryOpen &&
+            frame.nextPerformanceQuery < kMaxPerformanceQueriesPerFrame) {
+            scope.performanceQuery = frame.nextPerformanceQuery++;
+            vkCmdBeginQuery(commandBuffer, frame.performancePool, scope.performanceQuery, 0);
+            frame.performanceQueryOpen = true;
+        }
     }
 
     frame.scopes.push_back(std::move(scope));
@@ -197,6 +357,10 @@ void VulkanGpuProfiler::endScope(VkCommandBuffer commandBuffer, ScopeHandle& han
     }
 
     PendingScope& scope = frame.scopes[handle.pendingIndex];
+    if (scope.performanceQuery != UINT32_MAX && frame.performancePool != VK_NULL_HANDLE) {
+        vkCmdEndQuery(commandBuffer, frame.performancePool, scope.performanceQuery);
+        frame.performanceQueryOpen = false;
+    }
     if (scope.pipelineStatsQuery != UINT32_MAX && frame.pipelineStatsPool != VK_NULL_HANDLE) {
         vkCmdEndQuery(commandBuffer, frame.pipelineStatsPool, scope.pipelineStatsQuery);
     }
@@ -248,6 +412,28 @@ void VulkanGpuProfiler::collectFrame(FrameState& frame) {
         }
     }
 
+    const uint32_t performanceCounterCount = static_cast<uint32_t>(m_performanceCounters.size());
+    std::vector<VkPerformanceCounterResultKHR> performanceResults;
+    if (frame.performancePool != VK_NULL_HANDLE &&
+        frame.nextPerformanceQuery > 0 &&
+        performanceCounterCount > 0) {
+        performanceResults.resize(static_cast<size_t>(frame.nextPerformanceQuery) * performanceCounterCount);
+        const VkResult performanceResult =
+            vkGetQueryPoolResults(m_device,
+                                  frame.performancePool,
+                                  0,
+                                  frame.nextPerformanceQuery,
+                                  performanceResults.size() * sizeof(VkPerformanceCounterResultKHR),
+                                  performanceResults.data(),
+                                  sizeof(VkPerformanceCounterResultKHR) * performanceCounterCount,
+                                  0);
+        if (performanceResult != VK_SUCCESS) {
+            spdlog::warn("VulkanGpuProfiler: failed to read performance queries ({})",
+                         static_cast<int>(performanceResult));
+            performanceResults.clear();
+        }
+    }
+
     VulkanGpuFrameDiagnostics completed{};
     completed.frameIndex = frame.frameIndex;
     completed.scopes.reserve(frame.scopes.size());
@@ -274,6 +460,15 @@ void VulkanGpuProfiler::collectFrame(FrameState& frame) {
             timing.pipelineStats = buildPipelineStatsSnapshot(pipelineStats.data() + valueOffset);
         }
 
+        if (!performanceResults.empty() && scope.performanceQuery != UINT32_MAX) {
+            const size_t resultOffset = static_cast<size_t>(scope.performanceQuery) * performanceCounterCount;
+            timing.performanceCounters.reserve(performanceCounterCount);
+            for (uint32_t counter = 0; counter < performanceCounterCount; ++counter) {
+                timing.performanceCounters.push_back(
+                    performanceCounterValue(performanceResults[resultOffset + counter], counter));
+            }
+        }
+
         completed.scopes.push_back(std::move(timing));
     }
 
@@ -283,9 +478,158 @@ void VulkanGpuProfiler::collectFrame(FrameState& frame) {
                   return lhs.durationMs > rhs.durationMs;
               });
 
+    accumulatePassCounters(completed);
     m_latestFrame = std::move(completed);
 }
 
+double VulkanGpuProfiler::performanceCounterValue(const VkPerformanceCounterResultKHR& result,
+                                                  uint32_t counter) const {
+    switch (m_performanceCounterStorage[counter]) {
+    case VK_PERFORMANCE_COUNTER_STORAGE_INT32_KHR:
+        return static_cast<double>(result.int32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_INT64_KHR:
+        return static_cast<double>(result.int64);
+    case VK_PERFORMANCE_COUNTER_STORAGE_UINT32_KHR:
+        return static_cast<double>(result.uint32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR:
+        return static_cast<double>(result.uint64);
+    case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT32_KHR:
+        return static_cast<double>(result.float32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT64_KHR:
+        return result.float64;
+    default:
+        return 0.0;
+    }
+}
+
+void VulkanGpuProfiler::setCounterWindow(uint32_t frames) {
+    m_counterWindow = std::max(frames, 1u);
+}
+
+void VulkanGpuProfiler::accumulatePassCounters(const VulkanGpuFrameDiagnostics& frame) {
+    std::map<std::string, PassSample> frameSamples;
+    for (const VulkanGpuScopeTiming& scope : frame.scopes) {
+        PassSample& sample = frameSamples[scope.label];
+        sample.frameIndex = frame.frameIndex;
+        sample.durationMs += scope.durationMs;
+        if (scope.pipelineStats.valid) {
+            sample.hasStatistics = true;
+            sample.stats.taskShaderInvocations += scope.pipelineStats.taskShaderInvocations;
+            sample.stats.meshShaderInvocations += scope.pipelineStats.meshShaderInvocations;
+            sample.stats.vertexShaderInvocations += scope.pipelineStats.vertexShaderInvocations;
+            sample.stats.fragmentShaderInvocations += scope.pipelineStats.fragmentShaderInvocations;
+            sample.stats.computeShaderInvocations += scope.pipelineStats.computeShaderInvocations;
+        }
+        if (!scope.performanceCounters.empty()) {
+            sample.counters.resize(scope.performanceCounters.size(), 0.0);
+            for (size_t counter = 0; counter < scope.performanceCounters.size(); ++counter) {
+                sample.counters[counter] += scope.performanceCounters[counter];
+            }
+        }
+    }
+    for (auto& [label, sample] : frameSamples) {
+        m_passHistory[label].push_back(std::move(sample));
+    }
+
+    m_passCounters.clear();
+    for (auto it = m_passHistory.begin(); it != m_passHistory.end();) {
+        std::deque<PassSample>& samples = it->second;
+        while (!samples.empty() && samples.front().frameIndex + m_counterWindow <= frame.frameIndex) {
+            samples.pop_front();
+        }
+        if (samples.empty()) {
+            it = m_passHistory.erase(it);
+            continue;
+        }
+
+        VulkanGpuPassCounters counters{};
+        counters.label = it->first;
+        counters.frames = static_cast<uint32_t>(samples.size());
+        counters.minMs = std::numeric_limits<double>::max();
+        for (const PassSample& sample : samples) {
+            counters.meanMs += sample.durationMs;
+            counters.minMs = std::min(counters.minMs, sample.durationMs);
+            counters.maxMs = std::max(counters.maxMs, sample.durationMs);
+            if (sample.hasStatistics) {
+                ++counters.statisticsFrames;
+                counters.taskShaderInvocations += static_cast<double>(sample.stats.taskShaderInvocations);
+                counters.meshShaderInvocations += static_cast<double>(sample.stats.meshShaderInvocations);
+                counters.vertexShaderInvocations += static_cast<double>(sample.stats.vertexShaderInvocations);
+                counters.fragmentShaderInvocations += static_cast<double>(sample.stats.fragmentShaderInvocations);
+                counters.computeShaderInvocations += static_cast<double>(sample.stats.computeShaderInvocations);
+            }
+            if (!sample.counters.empty()) {
+                ++counters.counterFrames;
+                counters.performanceCounters.resize(sample.counters.size(), 0.0);
+                for (size_t counter = 0; counter < sample.counters.size(); ++counter) {
+                    counters.performanceCounters[counter] += sample.counters[counter];
+                }
+            }
+        }
+        counters.meanMs /= static_cast<double>(counters.frames);
+        if (counters.statisticsFrames > 0) {
+            const double statisticsFrames = static_cast<double>(counters.statisticsFrames);
+            counters.taskShaderInvocations /= statisticsFrames;
+            counters.meshShaderInvocations /= statisticsFrames;
+            counters.vertexShaderInvocations /= statisticsFrames;
+            counters.fragmentShaderInvocations /= statisticsFrames;
+            counters.computeShaderInvocations /= statisticsFrames;
+        }
+        for (double& value : counters.performanceCounters) {
+            value /= static_cast<double>(counters.counterFrames);
+        }
+        m_passCounters.push_back(std::move(counters));
+        ++it;
+    }
+
+    std::sort(m_passCounters.begin(),
+              m_passCounters.end(),
+              [](const VulkanGpuPassCounters& lhs, const VulkanGpuPassCounters& rhs) {
+                  return lhs.meanMs > rhs.meanMs;
+              });
+}
+
+bool VulkanGpuProfiler::writePassCountersCsv(const std::string& path) const {
+    std::ofstream csv(path, std::ios::trunc);
+    if (!csv) {
+        spdlog::error("VulkanGpuProfiler: failed to write pass counters to {}", path);
+        return false;
+    }
+
+    csv << "pass,frames,mean_ms,min_ms,max_ms,task_invocations,mesh_invocations,vertex_invocations,"
+           "fragment_invocations,compute_invocations";
+    for (const VulkanPerformanceCounterInfo& info : m_performanceCounters) {
+        csv << ',' << csvQuoted(info.unit.empty() ? info.name : info.name + " (" + info.unit + ")");
+    }
+    csv << '\n';
+    for (const VulkanGpuPassCounters& pass : m_passCounters) {
+        csv << csvQuoted(pass.label) << ',' << pass.frames << ',' << pass.meanMs << ',' << pass.minMs << ','
+            << pass.maxMs;
+        // Empty cells where the window never sampled the pass.
+        const double invocations[] = {pass.taskShaderInvocations,
+                                      pass.meshShaderInvocations,
+                                      pass.vertexShaderInvocations,
+                                      pass.fragmentShaderInvocations,
+                                      pass.computeShaderInvocations};
+        for (double value : invocations) {
+            csv << ',';
+            if (pass.statisticsFrames > 0) {
+                csv << value;
+            }
+        }
+        for (size_t counter = 0; counter < m_performanceCounters.size(); ++counter) {
+            csv << ',';
+            if (counter < pass.performanceCounters.size()) {
+                csv << pass.performanceCounters[counter];
+            }
+        }
+        csv << '\n';
+    }
+    spdlog::info("VulkanGpuProfiler: wrote {} pass counters over {} frames to {}",
+                 m_passCounters.size(), m_counterWindow, path);
+    return true;
+}
+
 VulkanPipelineStatisticsSnapshot VulkanGpuProfiler::buildPipelineStatsSnapshot(const uint64_t* values) const {
     VulkanPipelineStatisticsSnapshot snapshot{};
     if (!values || m_pipelineStatisticsMask == 0) {
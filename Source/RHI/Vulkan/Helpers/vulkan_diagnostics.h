@@ -3,6 +3,8 @@
 #ifdef _WIN32
 
 #include <cstdint>
+#include <deque>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -21,10 +23,19 @@ struct VulkanPipelineStatisticsSnapshot {
     uint64_t meshShaderInvocations = 0;
 };
 
+// A VK_KHR_performance_query counter the profiler samples per scope.
+struct VulkanPerformanceCounterInfo {
+    std::string name;
+    std::string category;
+    std::string unit;
+};
+
 struct VulkanGpuScopeTiming {
     std::string label;
     double durationMs = 0.0;
     VulkanPipelineStatisticsSnapshot pipelineStats{};
+    // In VulkanGpuProfiler::performanceCounters() order; empty when not sampled.
+    std::vector<double> performanceCounters;
 };
 
 struct VulkanGpuFrameDiagnostics {
@@ -33,6 +44,24 @@ struct VulkanGpuFrameDiagnostics {
     std::vector<VulkanGpuScopeTiming> scopes;
 };
 
+// One pass aggregated over the profiler's rolling window. Scopes sharing a label
+// within a frame are summed first; means are per frame the pass ran in.
+struct VulkanGpuPassCounters {
+    std::string label;
+    uint32_t frames = 0;          // frames in the window that ran this pass
+    uint32_t statisticsFrames = 0; // ... of which carried pipeline statistics
+    uint32_t counterFrames = 0;    // ... of which carried performance counters
+    double meanMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double taskShaderInvocations = 0.0;
+    double meshShaderInvocations = 0.0;
+    double vertexShaderInvocations = 0.0;
+    double fragmentShaderInvocations = 0.0;
+    double computeShaderInvocations = 0.0;
+    std::vector<double> performanceCounters;
+};
+
 struct VulkanToolingInfo {
     bool debugUtils = false;
     bool validationMessenger = false;
@@ -40,6 +69,8 @@ struct VulkanToolingInfo {
     bool diagnosticCheckpoints = false;
     bool deviceFault = false;
     bool pipelineStatistics = false;
+    bool pipelineExecutableStats = false; // VK_KHR_pipeline_executable_properties
+    bool performanceQuery = false;        // VK_KHR_performance_query + host query reset
 };
 
 class VulkanGpuProfiler {
@@ -59,6 +90,12 @@ public:
               VkDevice device,
               uint32_t framesInFlight,
               bool meshShaders);
+    // Picks the single-pass subset of the queue family's byte and bandwidth counters
+    // and holds the profiling lock until destroy(). Call after init() on devices
+    // created with VK_KHR_performance_query and hostQueryReset.
+    bool initPerformanceCounters(VkInstance instance,
+                                 VkPhysicalDevice physicalDevice,
+                                 uint32_t queueFamilyIndex);
     void destroy();
 
     void beginFrame(uint32_t frameIndex, uint64_t completedFrameIndex);
@@ -71,6 +108,23 @@ public:
 
     const VulkanGpuFrameDiagnostics& latestFrame() const { return m_latestFrame; }
     bool supportsPipelineStatistics() const { return m_pipelineStatisticsMask != 0; }
+    // Pipeline statistics queries cost more than timestamps, so scopes only request
+    // them while enabled.
+    void setPipelineStatisticsEnabled(bool enabled) { m_pipelineStatisticsEnabled = enabled; }
+    bool pipelineStatisticsEnabled() const { return m_pipelineStatisticsEnabled; }
+
+    const std::vector<VulkanPerformanceCounterInfo>& performanceCounters() const { return m_performanceCounters; }
+    bool supportsPerformanceCounters() const { return !m_performanceCounters.empty(); }
+    // Vendor counters only run on scopes that also take pipeline statistics, one
+    // scope at a time.
+    void setPerformanceCountersEnabled(bool enabled) { m_performanceCountersEnabled = enabled; }
+    bool performanceCountersEnabled() const { return m_performanceCountersEnabled; }
+
+    // Per-pass aggregates over the last counterWindow() completed frames, slowest first.
+    const std::vector<VulkanGpuPassCounters>& passCounters() const { return m_passCounters; }
+    void setCounterWindow(uint32_t frames);
+    uint32_t counterWindow() const { return m_counterWindow; }
+    bool writePassCountersCsv(const std::string& path) const;
 
 private:
     struct PendingScope {
@@ -78,13 +132,25 @@ private:
         uint32_t startQuery = UINT32_MAX;
         uint32_t endQuery = UINT32_MAX;
         uint32_t pipelineStatsQuery = UINT32_MAX;
+        uint32_t performanceQuery = UINT32_MAX;
+    };
+
+    struct PassSample {
+        uint64_t frameIndex = 0;
+        double durationMs = 0.0;
+        bool hasStatistics = false;
+        VulkanPipelineStatisticsSnapshot stats{};
+        std::vector<double> counters;
     };
 
     struct FrameState {
         VkQueryPool timestampPool = VK_NULL_HANDLE;
         VkQueryPool pipelineStatsPool = VK_NULL_HANDLE;
+        VkQueryPool performancePool = VK_NULL_HANDLE;
         uint32_t nextTimestampQuery = 0;
         uint32_t nextPipelineStatsQuery = 0;
+        uint32_t nextPerformanceQuery = 0;
+        bool performanceQueryOpen = false;
         uint64_t frameIndex = 0;
         bool hasSubmittedFrame = false;
         std::vector<PendingScope> scopes;
@@ -93,6 +159,9 @@ private:
     void collectFrame(FrameState& frame);
     VulkanPipelineStatisticsSnapshot buildPipelineStatsSnapshot(const uint64_t* values) const;
     void resetFrameQueries(VkCommandBuffer commandBuffer, FrameState& frame) const;
+    void destroyPerformanceCounters();
+    double performanceCounterValue(const VkPerformanceCounterResultKHR& result, uint32_t counter) const;
+    void accumulatePassCounters(const VulkanGpuFrameDiagnostics& frame);
 
     VkDevice m_device = VK_NULL_HANDLE;
     float m_timestampPeriod = 0.0f;
@@ -100,8 +169,18 @@ private:
     uint32_t m_activeFrameIndex = 0;
     VkQueryPipelineStatisticFlags m_pipelineStatisticsMask = 0;
     uint32_t m_pipelineStatisticValueCount = 0;
+    bool m_pipelineStatisticsEnabled = false;
     std::vector<FrameState> m_frames;
     VulkanGpuFrameDiagnostics m_latestFrame{};
+
+    std::vector<VulkanPerformanceCounterInfo> m_performanceCounters;
+    std::vector<VkPerformanceCounterStorageKHR> m_performanceCounterStorage;
+    PFN_vkReleaseProfilingLockKHR m_vkReleaseProfilingLockKHR = nullptr;
+    bool m_performanceCountersEnabled = false;
+
+    uint32_t m_counterWindow = 120;
+    std::map<std::string, std::deque<PassSample>> m_passHistory;
+    std::vector<VulkanGpuPassCounters> m_passCounters;
 };
 
 #endif // _WIN32
@@ -0,0 +1,130 @@
+#include "vulkan_memory_accounting.h"
+
+#ifdef _WIN32
+
+#include <vk_mem_alloc.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+VulkanMemoryAccounting& vulkanMemoryAccounting() {
+    static VulkanMemoryAccounting accounting;
+    return accounting;
+}
+
+void VulkanMemoryAccounting::track(VmaAllocator allocator,
+                                   VmaAllocation allocation,
+                                   RhiMemoryTag tag,
+                                   const char* name) {
+    VmaAllocationInfo allocationInfo{};
+    vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+    VkMemoryPropertyFlags memoryFlags = 0;
+    vmaGetAllocationMemoryProperties(allocator, allocation, &memoryFlags);
+
+    VulkanMemoryAllocationRecord record;
+    record.name = name && name[0] != '\0' ? name : "(unnamed)";
+    record.tag = tag;
+    record.bytes = allocationInfo.size;
+    record.deviceLocal = (memoryFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    VulkanMemoryTagStats& stats = m_tags[static_cast<size_t>(tag)];
+    if (record.deviceLocal) {
+        stats.deviceLocalBytes += record.bytes;
+        stats.peakDeviceLocalBytes = std::max(stats.peakDeviceLocalBytes, stats.deviceLocalBytes);
+    } else {
+        stats.hostBytes += record.bytes;
+    }
+    ++stats.allocationCount;
+    m_allocations[allocation] = std::move(record);
+}
+
+void VulkanMemoryAccounting::untrack(VmaAllocation allocation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_allocations.find(allocation);
+    if (it == m_allocations.end()) {
+        return;
+    }
+    const VulkanMemoryAllocationRecord& record = it->second;
+    VulkanMemoryTagStats& stats = m_tags[static_cast<size_t>(record.tag)];
+    if (record.deviceLocal) {
+        stats.deviceLocalBytes -= std::min(stats.deviceLocalBytes, record.bytes);
+    } else {
+        stats.hostBytes -= std::min(stats.hostBytes, record.bytes);
+    }
+    stats.allocationCount -= std::min(stats.allocationCount, 1u);
+    m_allocations.erase(it);
+}
+
+VulkanMemoryAccountingSnapshot VulkanMemoryAccounting::snapshot(size_t topAllocationCount) const {
+    VulkanMemoryAccountingSnapshot result;
+    std::vector<const VulkanMemoryAllocationRecord*> deviceLocal;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        result.tags = m_tags;
+        deviceLocal.reserve(m_allocations.size());
+        for (const auto& [allocation, record] : m_allocations) {
+            if (record.deviceLocal) {
+                deviceLocal.push_back(&record);
+            }
+        }
+        const size_t count = std::min(topAllocationCount, deviceLocal.size());
+        std::partial_sort(deviceLocal.begin(), deviceLocal.begin() + count, deviceLocal.end(),
+                          [](const VulkanMemoryAllocationRecord* a, const VulkanMemoryAllocationRecord* b) {
+                              return a->bytes > b->bytes;
+                          });
+        result.topAllocations.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.topAllocations.push_back(*deviceLocal[i]);
+        }
+    }
+    for (const VulkanMemoryTagStats& stats : result.tags) {
+        result.trackedDeviceLocalBytes += stats.deviceLocalBytes;
+        result.trackedHostBytes += stats.hostBytes;
+    }
+    return result;
+}
+
+void VulkanMemoryAccounting::resetPeaks() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (VulkanMemoryTagStats& stats : m_tags) {
+        stats.peakDeviceLocalBytes = stats.deviceLocalBytes;
+    }
+}
+
+bool VulkanMemoryAccounting::checkBudget(uint64_t deviceLocalUsageBytes, uint64_t deviceLocalBudgetBytes) {
+    if (deviceLocalBudgetBytes == 0u) {
+        return false;
+    }
+    const bool over = static_cast<double>(deviceLocalUsageBytes) >
+                      kBudgetWarningFraction * static_cast<double>(deviceLocalBudgetBytes);
+    if (over && !m_overBudgetWarning) {
+        const VulkanMemoryAccountingSnapshot current = snapshot(0);
+        std::array<size_t, static_cast<size_t>(RhiMemoryTag::Count)> order{};
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return current.tags[a].deviceLocalBytes > current.tags[b].deviceLocalBytes;
+        });
+        std::string breakdown;
+        for (size_t i = 0; i < 3; ++i) {
+            const VulkanMemoryTagStats& stats = current.tags[order[i]];
+            if (stats.deviceLocalBytes == 0u) {
+                break;
+            }
+            if (!breakdown.empty()) {
+                breakdown += ", ";
+            }
+            breakdown += std::string(rhiMemoryTagName(static_cast<RhiMemoryTag>(order[i]))) + " " +
+                         std::to_string(stats.deviceLocalBytes / (1024 * 1024)) + " MB";
+        }
+        spdlog::warn("VRAM usage {} MB is above {:.0f}% of the {} MB budget (largest: {})",
+                     deviceLocalUsageBytes / (1024 * 1024), kBudgetWarningFraction * 100.0,
+                     deviceLocalBudgetBytes / (1024 * 1024), breakdown);
+    }
+    m_overBudgetWarning = over;
+    return over;
+}
+
+#endif // _WIN32
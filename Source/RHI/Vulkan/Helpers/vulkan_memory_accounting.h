@@ -0,0 +1,95 @@
+#pragma once
+
+#ifdef _WIN32
+
+#include "rhi_backend.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct VmaAllocator_T;
+typedef VmaAllocator_T* VmaAllocator;
+struct VmaAllocation_T;
+typedef VmaAllocation_T* VmaAllocation;
+
+// =========================================================================
+// VulkanMemoryAccounting — VRAM use per subsystem
+// =========================================================================
+//
+// vmaCreateBufferResource / vmaCreateImageResource record every allocation
+// with an RhiMemoryTag (explicit, or the creating thread's RhiMemoryTagScope),
+// and the destroy helpers drop it again. Device-local and host-visible bytes
+// are kept apart: only the former count against the VRAM budget. Allocations
+// made with raw vmaCreateBuffer are not seen unless the call site tracks them.
+
+struct VulkanMemoryTagStats {
+    uint64_t deviceLocalBytes = 0u;
+    uint64_t peakDeviceLocalBytes = 0u;
+    uint64_t hostBytes = 0u;
+    uint32_t allocationCount = 0u;
+};
+
+struct VulkanMemoryAllocationRecord {
+    std::string name;
+    RhiMemoryTag tag = RhiMemoryTag::Untagged;
+    uint64_t bytes = 0u;
+    bool deviceLocal = true;
+};
+
+struct VulkanMemoryAccountingSnapshot {
+    std::array<VulkanMemoryTagStats, static_cast<size_t>(RhiMemoryTag::Count)> tags{};
+    uint64_t trackedDeviceLocalBytes = 0u;
+    uint64_t trackedHostBytes = 0u;
+    // Largest device-local allocations, biggest first.
+    std::vector<VulkanMemoryAllocationRecord> topAllocations;
+};
+
+class VulkanMemoryAccounting {
+public:
+    // Share of the device-local budget above which checkBudget() warns.
+    static constexpr double kBudgetWarningFraction = 0.9;
+
+    void track(VmaAllocator allocator, VmaAllocation allocation, RhiMemoryTag tag, const char* name);
+    void untrack(VmaAllocation allocation);
+
+    VulkanMemoryAccountingSnapshot snapshot(size_t topAllocationCount) const;
+    void resetPeaks();
+
+    // Logs once each time device-local usage crosses kBudgetWarningFraction of
+    // the budget, with the tags holding the most memory. Returns true while over.
+    bool checkBudget(uint64_t deviceLocalUsageBytes, uint64_t deviceLocalBudgetBytes);
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<VmaAllocation, VulkanMemoryAllocationRecord> m_allocations;
+    std::array<VulkanMemoryTagStats, static_cast<size_t>(RhiMemoryTag::Count)> m_tags{};
+    bool m_overBudgetWarning = false;
+};
+
+VulkanMemoryAccounting& vulkanMemoryAccounting();
+
+// Tag Untagged picks up the calling thread's RhiMemoryTagScope.
+inline void vulkanTrackAllocation(VmaAllocator allocator,
+                                  VmaAllocation allocation,
+                                  RhiMemoryTag tag,
+                                  const char* name) {
+    if (allocation) {
+        vulkanMemoryAccounting().track(allocator,
+                                       allocation,
+                                       tag != RhiMemoryTag::Untagged ? tag : RhiMemoryTagScope::current(),
+                                       name);
+    }
+}
+
+// Safe for allocations that were never tracked.
+inline void vulkanUntrackAllocation(VmaAllocation allocation) {
+    if (allocation) {
+        vulkanMemoryAccounting().untrack(allocation);
+    }
+}
+
+#endif // _WIN32
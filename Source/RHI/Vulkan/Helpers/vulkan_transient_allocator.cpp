@@ -2,7 +2,9 @@
 
 #ifdef _WIN32
 
+#include "cpu_profile_zones.h"
 #include "rhi_backend.h"
+#include "vulkan_resource_handles.h"
 
 #include <vk_mem_alloc.h>
 #include <spdlog/spdlog.h>
@@ -17,6 +19,24 @@ VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
     return (value + alignment - 1) & ~(alignment - 1);
 }
 
+VkDeviceSize allocationBytes(VmaAllocator allocator, VmaAllocation allocation) {
+    if (!allocator || !allocation) return 0;
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(allocator, allocation, &info);
+    return info.size;
+}
+
+// Global so a ring recreated at the same address never matches a stale block.
+std::atomic<uint64_t> g_nextUploadRingEpoch{1};
+
+// The block of the current slice this thread is sub-allocating from.
+struct UploadRingThreadBlock {
+    uint64_t epoch = 0;
+    VkDeviceSize head = 0;
+    VkDeviceSize end = 0;
+};
+thread_local UploadRingThreadBlock t_uploadRingBlock;
+
 } // namespace
 
 // =========================================================================
@@ -48,17 +68,24 @@ void VulkanUploadRing::init(VkDevice device, VmaAllocator allocator,
             destroy();
             return;
         }
+        vulkanTrackAllocation(allocator, m_slices[i].allocation, RhiMemoryTag::Staging, "UploadRing");
         m_slices[i].mappedData = resultInfo.pMappedData;
-        m_slices[i].head = 0;
     }
+    m_head.store(0, std::memory_order_relaxed);
+    m_epoch.store(g_nextUploadRingEpoch.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
 
     spdlog::info("VulkanUploadRing: initialized with {} MB per frame, {} slices",
                  capacityPerFrame / (1024 * 1024), framesInFlight);
 }
 
 void VulkanUploadRing::destroy() {
+    std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
     for (auto& slice : m_slices) {
+        for (OverflowChunk& chunk : slice.overflow) {
+            destroyOverflowChunk(chunk);
+        }
         if (slice.buffer != VK_NULL_HANDLE && m_allocator) {
+            vulkanUntrackAllocation(slice.allocation);
             vmaDestroyBuffer(m_allocator, slice.buffer, slice.allocation);
         }
         slice = {};
@@ -67,9 +94,46 @@ void VulkanUploadRing::destroy() {
 }
 
 void VulkanUploadRing::beginFrame(uint32_t frameIndex) {
+    std::unique_lock<std::shared_mutex> lock(m_frameGate);
+    if (m_slices.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+        m_usedLastFrame = usedThisFrame() + m_overflowUsedThisFrame;
+        m_peakUsed = std::max(m_peakUsed, m_usedLastFrame);
+        m_overflowUsedThisFrame = 0;
+        ++m_frameCounter;
+
+        // The new slice's last frame has retired: its chunks are free again. Only
+        // chunks that sat idle through kOverflowIdleFrames are given back.
+        Slice& slice = m_slices[frameIndex % static_cast<uint32_t>(m_slices.size())];
+        for (OverflowChunk& chunk : slice.overflow) {
+            chunk.head = 0;
+            if (m_frameCounter - chunk.lastUsedFrame > kOverflowIdleFrames) {
+                destroyOverflowChunk(chunk);
+            }
+        }
+        slice.overflow.erase(
+            std::remove_if(slice.overflow.begin(), slice.overflow.end(),
+                           [](const OverflowChunk& chunk) { return chunk.buffer == VK_NULL_HANDLE; }),
+            slice.overflow.end());
+    }
     m_currentFrame = frameIndex % static_cast<uint32_t>(m_slices.size());
-    if (!m_slices.empty()) {
-        m_slices[m_currentFrame].head = 0;
+    m_head.store(0, std::memory_order_relaxed);
+    m_epoch.store(g_nextUploadRingEpoch.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
+VkDeviceSize VulkanUploadRing::reserve(VkDeviceSize size, VkDeviceSize alignment) {
+    VkDeviceSize head = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+        const VkDeviceSize alignedOffset = alignUp(head, alignment);
+        if (alignedOffset + size > m_capacityPerFrame) {
+            return UINT64_MAX;
+        }
+        if (m_head.compare_exchange_weak(head, alignedOffset + size, std::memory_order_relaxed)) {
+            return alignedOffset;
+        }
     }
 }
 
@@ -78,71 +142,205 @@ VulkanUploadRing::Allocation VulkanUploadRing::allocate(VkDeviceSize size, VkDev
         return {};
     }
 
-    auto& slice = m_slices[m_currentFrame];
-    const VkDeviceSize alignedOffset = alignUp(slice.head, alignment);
-    if (alignedOffset + size > m_capacityPerFrame) {
-        return {}; // exhausted — caller should fall back to one-shot staging
+    const uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+    VkDeviceSize offset = UINT64_MAX;
+    if (size <= kThreadBlockSize / 4) {
+        UploadRingThreadBlock& block = t_uploadRingBlock;
+        VkDeviceSize alignedOffset = alignUp(block.head, alignment);
+        if (block.epoch != epoch || alignedOffset + size > block.end) {
+            const VkDeviceSize blockOffset = reserve(kThreadBlockSize, 256);
+            if (blockOffset != UINT64_MAX) {
+                block = {epoch, blockOffset, blockOffset + kThreadBlockSize};
+                alignedOffset = alignUp(block.head, alignment);
+            }
+        }
+        if (block.epoch == epoch && alignedOffset + size <= block.end) {
+            offset = alignedOffset;
+            block.head = alignedOffset + size;
+        }
+    }
+    if (offset == UINT64_MAX) {
+        offset = reserve(size, alignment);
+    }
+    if (offset == UINT64_MAX) {
+        return allocateOverflow(size, alignment, epoch);
     }
 
+    const Slice& slice = m_slices[m_currentFrame];
     Allocation result;
     result.buffer = slice.buffer;
-    result.offset = alignedOffset;
-    result.mappedPtr = static_cast<uint8_t*>(slice.mappedData) + alignedOffset;
-    slice.head = alignedOffset + size;
+    result.offset = offset;
+    result.mappedPtr = static_cast<uint8_t*>(slice.mappedData) + offset;
+    result.epoch = epoch;
+    return result;
+}
+
+VulkanUploadRing::Allocation VulkanUploadRing::allocateOverflow(VkDeviceSize size, VkDeviceSize alignment,
+                                                               uint64_t epoch) {
+    std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+    Slice& slice = m_slices[m_currentFrame];
+
+    OverflowChunk* target = nullptr;
+    VkDeviceSize offset = 0;
+    VkDeviceSize heldBytes = 0;
+    for (OverflowChunk& chunk : slice.overflow) {
+        heldBytes += chunk.capacity;
+        const VkDeviceSize alignedOffset = alignUp(chunk.head, alignment);
+        if (!target && alignedOffset + size <= chunk.capacity) {
+            target = &chunk;
+            offset = alignedOffset;
+        }
+    }
+
+    if (!target) {
+        const VkDeviceSize chunkSize = std::max(alignUp(size, kThreadBlockSize), kMinOverflowChunkSize);
+        if (heldBytes + chunkSize > kMaxOverflowBytesPerSlice) {
+            return {}; // caller falls back to one-shot staging
+        }
+
+        VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bufferInfo.size = chunkSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                          VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+        OverflowChunk chunk;
+        chunk.capacity = chunkSize;
+        VmaAllocationInfo resultInfo{};
+        if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo,
+                            &chunk.buffer, &chunk.allocation, &resultInfo) != VK_SUCCESS) {
+            spdlog::warn("VulkanUploadRing: failed to create a {} MB overflow chunk",
+                         chunkSize / (1024 * 1024));
+            return {};
+        }
+        vulkanTrackAllocation(m_allocator, chunk.allocation, RhiMemoryTag::Staging, "UploadRingOverflow");
+        chunk.mappedData = resultInfo.pMappedData;
+        slice.overflow.push_back(chunk);
+        target = &slice.overflow.back();
+        offset = 0;
+    }
+
+    target->head = offset + size;
+    target->lastUsedFrame = m_frameCounter;
+    m_overflowUsedThisFrame += size;
+    ++m_overflowAllocations;
+
+    Allocation result;
+    result.buffer = target->buffer;
+    result.offset = offset;
+    result.mappedPtr = static_cast<uint8_t*>(target->mappedData) + offset;
+    result.epoch = epoch;
     return result;
 }
 
+void VulkanUploadRing::destroyOverflowChunk(OverflowChunk& chunk) {
+    if (chunk.buffer != VK_NULL_HANDLE && m_allocator) {
+        vulkanUntrackAllocation(chunk.allocation);
+        vmaDestroyBuffer(m_allocator, chunk.buffer, chunk.allocation);
+    }
+    chunk = {};
+}
+
 VkDeviceSize VulkanUploadRing::usedThisFrame() const {
     if (m_slices.empty()) return 0;
-    return m_slices[m_currentFrame].head;
+    return std::min(m_head.load(std::memory_order_relaxed), m_capacityPerFrame);
+}
+
+VulkanUploadRing::Stats VulkanUploadRing::stats() const {
+    std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+    Stats stats;
+    stats.capacityPerFrame = m_capacityPerFrame;
+    stats.usedLastFrame = m_usedLastFrame;
+    stats.peakUsed = m_peakUsed;
+    stats.overflowAllocations = m_overflowAllocations;
+    for (const Slice& slice : m_slices) {
+        for (const OverflowChunk& chunk : slice.overflow) {
+            stats.overflowBytes += chunk.capacity;
+            ++stats.overflowChunks;
+        }
+    }
+    return stats;
+}
+
+void VulkanUploadRing::resetPeak() {
+    std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+    m_peakUsed = m_usedLastFrame;
 }
 
 // =========================================================================
 // VulkanTransientPool
 // =========================================================================
 
-void VulkanTransientPool::init(uint32_t maxPooledTextures, uint32_t maxPooledBuffers) {
+// Idle pooled memory, as seen by Tracy's memory view under METALLIC_TRACY_MEMORY.
+static constexpr const char* kTransientPoolTracyName = "Vulkan Transient Pool";
+
+void VulkanTransientPool::init(VmaAllocator allocator,
+                               uint32_t maxPooledTextures,
+                               uint32_t maxPooledBuffers,
+                               uint64_t maxPooledBytes) {
+    m_allocator = allocator;
     m_maxPooledTextures = maxPooledTextures;
     m_maxPooledBuffers  = maxPooledBuffers;
-    spdlog::info("VulkanTransientPool: initialized (maxTextures={}, maxBuffers={})",
-                 maxPooledTextures, maxPooledBuffers);
+    m_maxPooledBytes = maxPooledBytes;
+    spdlog::info("VulkanTransientPool: initialized (maxTextures={}, maxBuffers={}, maxBytes={} MB)",
+                 maxPooledTextures, maxPooledBuffers, maxPooledBytes / (1024 * 1024));
 }
 
 void VulkanTransientPool::destroy() {
+    for (const auto& [key, entries] : m_texturePool) {
+        for (const PooledTexture& entry : entries) {
+            METALLIC_TRACY_FREE(entry.resource.get(), kTransientPoolTracyName);
+        }
+    }
+    for (const auto& [key, entries] : m_bufferPool) {
+        for (const PooledBuffer& entry : entries) {
+            METALLIC_TRACY_FREE(entry.resource.get(), kTransientPoolTracyName);
+        }
+    }
     m_texturePool.clear();
     m_bufferPool.clear();
     m_totalPooledTextures = 0;
     m_totalPooledBuffers  = 0;
+    m_pooledBytes = 0;
 }
 
-void VulkanTransientPool::beginFrame() {
-    // Nothing to do — resources stay in the pool until acquired or evicted.
+void VulkanTransientPool::beginFrame(uint64_t frameSerial, uint64_t completedSerial) {
+    m_frameSerial = frameSerial;
+    m_completedSerial = completedSerial;
 }
 
 std::unique_ptr<RhiTexture> VulkanTransientPool::acquireTexture(const RhiTextureDesc& desc) {
     TextureKey key{desc.width, desc.height, static_cast<uint32_t>(desc.format),
-                   static_cast<uint32_t>(desc.usage)};
+                   static_cast<uint32_t>(desc.usage), static_cast<uint32_t>(desc.storageMode),
+                   desc.mipLevels};
     auto it = m_texturePool.find(key);
     if (it != m_texturePool.end() && !it->second.empty()) {
-        auto texture = std::move(it->second.back());
+        PooledTexture entry = std::move(it->second.back());
         it->second.pop_back();
         --m_totalPooledTextures;
+        m_pooledBytes -= entry.bytes;
         ++m_cacheHits;
-        return texture;
+        METALLIC_TRACY_FREE(entry.resource.get(), kTransientPoolTracyName);
+        return std::move(entry.resource);
     }
     ++m_cacheMisses;
     return nullptr;
 }
 
 std::unique_ptr<RhiBuffer> VulkanTransientPool::acquireBuffer(const RhiBufferDesc& desc) {
-    BufferKey key{desc.size, desc.hostVisible, desc.sharedWithTransferQueue};
+    BufferKey key{desc.size, desc.memory, desc.sharedWithTransferQueue};
     auto it = m_bufferPool.find(key);
     if (it != m_bufferPool.end() && !it->second.empty()) {
-        auto buffer = std::move(it->second.back());
+        PooledBuffer entry = std::move(it->second.back());
         it->second.pop_back();
         --m_totalPooledBuffers;
+        m_pooledBytes -= entry.bytes;
         ++m_cacheHits;
-        return buffer;
+        METALLIC_TRACY_FREE(entry.resource.get(), kTransientPoolTracyName);
+        return std::move(entry.resource);
     }
     ++m_cacheMisses;
     return nullptr;
@@ -151,29 +349,204 @@ std::unique_ptr<RhiBuffer> VulkanTransientPool::acquireBuffer(const RhiBufferDes
 void VulkanTransientPool::releaseTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) {
     if (!texture) return;
 
-    // Evict if pool is full
-    if (m_totalPooledTextures >= m_maxPooledTextures) {
-        return; // let the unique_ptr destroy it
+    // Make room by evicting; if nothing has retired yet, let the unique_ptr destroy it
+    while (m_totalPooledTextures >= m_maxPooledTextures) {
+        if (!evictOldestRetired()) {
+            return;
+        }
     }
 
+    const VulkanTextureResource* resource = getVulkanTextureResource(texture.get());
+    PooledTexture entry;
+    entry.bytes = resource ? allocationBytes(m_allocator, resource->allocation) : 0;
+    entry.releaseSerial = m_frameSerial;
+    entry.resource = std::move(texture);
+
     TextureKey key{desc.width, desc.height, static_cast<uint32_t>(desc.format),
-                   static_cast<uint32_t>(desc.usage)};
-    m_texturePool[key].push_back(std::move(texture));
+                   static_cast<uint32_t>(desc.usage), static_cast<uint32_t>(desc.storageMode),
+                   desc.mipLevels};
+    m_pooledBytes += entry.bytes;
+    METALLIC_TRACY_ALLOC(entry.resource.get(), entry.bytes, kTransientPoolTracyName);
+    m_texturePool[key].push_back(std::move(entry));
     ++m_totalPooledTextures;
 }
 
 void VulkanTransientPool::releaseBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) {
     if (!buffer) return;
 
-    if (m_totalPooledBuffers >= m_maxPooledBuffers) {
-        return;
+    while (m_totalPooledBuffers >= m_maxPooledBuffers) {
+        if (!evictOldestRetired()) {
+            return;
+        }
     }
 
-    BufferKey key{desc.size, desc.hostVisible, desc.sharedWithTransferQueue};
-    m_bufferPool[key].push_back(std::move(buffer));
+    const VulkanBufferResource* resource = getVulkanBufferResource(buffer.get());
+    PooledBuffer entry;
+    entry.bytes = resource ? allocationBytes(m_allocator, resource->allocation) : 0;
+    entry.releaseSerial = m_frameSerial;
+    entry.resource = std::move(buffer);
+
+    BufferKey key{desc.size, desc.memory, desc.sharedWithTransferQueue};
+    m_pooledBytes += entry.bytes;
+    METALLIC_TRACY_ALLOC(entry.resource.get(), entry.bytes, kTransientPoolTracyName);
+    m_bufferPool[key].push_back(std::move(entry));
     ++m_totalPooledBuffers;
 }
 
+bool VulkanTransientPool::evictOldestRetired() {
+    // Entries within a bucket are in release order, so only each front can be oldest.
+    std::vector<PooledTexture>* oldestTextures = nullptr;
+    std::vector<PooledBuffer>* oldestBuffers = nullptr;
+    uint64_t oldestSerial = UINT64_MAX;
+    for (auto& [key, entries] : m_texturePool) {
+        if (!entries.empty() && isRetired(entries.front().releaseSerial) &&
+            entries.front().releaseSerial < oldestSerial) {
+            oldestSerial = entries.front().releaseSerial;
+            oldestTextures = &entries;
+        }
+    }
+    for (auto& [key, entries] : m_bufferPool) {
+        if (!entries.empty() && isRetired(entries.front().releaseSerial) &&
+            entries.front().releaseSerial < oldestSerial) {
+            oldestSerial = entries.front().releaseSerial;
+            oldestBuffers = &entries;
+            oldestTextures = nullptr;
+        }
+    }
+
+    uint64_t bytes = 0;
+    if (oldestBuffers) {
+        bytes = oldestBuffers->front().bytes;
+        METALLIC_TRACY_FREE(oldestBuffers->front().resource.get(), kTransientPoolTracyName);
+        oldestBuffers->erase(oldestBuffers->begin());
+        --m_totalPooledBuffers;
+    } else if (oldestTextures) {
+        bytes = oldestTextures->front().bytes;
+        METALLIC_TRACY_FREE(oldestTextures->front().resource.get(), kTransientPoolTracyName);
+        oldestTextures->erase(oldestTextures->begin());
+        --m_totalPooledTextures;
+    } else {
+        return false;
+    }
+    m_pooledBytes -= bytes;
+    m_evictedBytes += bytes;
+    return true;
+}
+
+void VulkanTransientPool::trim(uint64_t deviceLocalHeadroomBytes) {
+    uint64_t shortfall = deviceLocalHeadroomBytes < kMinDeviceLocalHeadroom
+        ? kMinDeviceLocalHeadroom - deviceLocalHeadroomBytes
+        : 0;
+    while (m_pooledBytes > m_maxPooledBytes || shortfall > 0) {
+        const uint64_t before = m_pooledBytes;
+        if (!evictOldestRetired()) {
+            break;
+        }
+        const uint64_t freed = before - m_pooledBytes;
+        shortfall = shortfall > freed ? shortfall - freed : 0;
+    }
+}
+
+uint32_t VulkanTransientPool::defragment(VkDevice device, uint32_t maxMoves) {
+    if (!m_allocator || device == VK_NULL_HANDLE || maxMoves == 0) {
+        return 0;
+    }
+
+    // Candidates are keyed by allocation so proposed moves can be matched.
+    std::unordered_map<VmaAllocation, VulkanBufferResource*> movable;
+    for (auto& [key, entries] : m_bufferPool) {
+        // Mapped pointers would go stale; concurrent sharing is not recreated here.
+        if (key.memory != RhiBufferMemory::DeviceLocal || key.sharedWithTransferQueue) {
+            continue;
+        }
+        for (PooledBuffer& entry : entries) {
+            VulkanBufferResource* resource = getVulkanBufferResource(entry.resource.get());
+            if (resource && resource->allocation && resource->ownsBuffer && isRetired(entry.releaseSerial)) {
+                movable.emplace(resource->allocation, resource);
+            }
+        }
+    }
+    if (movable.empty()) {
+        return 0;
+    }
+
+    VmaDefragmentationInfo defragInfo{};
+    defragInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT;
+    defragInfo.maxAllocationsPerPass = maxMoves;
+    VmaDefragmentationContext context = nullptr;
+    if (vmaBeginDefragmentation(m_allocator, &defragInfo, &context) != VK_SUCCESS) {
+        return 0;
+    }
+
+    // Moves of allocations outside the pool are ignored, so passes are capped too.
+    constexpr uint32_t kMaxPasses = 8;
+    uint32_t moved = 0;
+    std::vector<VkBuffer> retiredBuffers;
+    for (uint32_t passIndex = 0; passIndex < kMaxPasses && moved < maxMoves; ++passIndex) {
+        VmaDefragmentationPassMoveInfo pass{};
+        if (vmaBeginDefragmentationPass(m_allocator, context, &pass) == VK_SUCCESS) {
+            break; // nothing left to move
+        }
+
+        std::vector<VulkanBufferResource*> passResources(pass.moveCount, nullptr);
+        for (uint32_t i = 0; i < pass.moveCount; ++i) {
+            VmaDefragmentationMove& move = pass.pMoves[i];
+            auto it = movable.find(move.srcAllocation);
+            if (it == movable.end() || moved >= maxMoves) {
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            VulkanBufferResource* resource = it->second;
+            VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+            bufferInfo.size = resource->size;
+            bufferInfo.usage = resource->usageFlags;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            VkBuffer newBuffer = VK_NULL_HANDLE;
+            if (vkCreateBuffer(device, &bufferInfo, nullptr, &newBuffer) != VK_SUCCESS ||
+                vmaBindBufferMemory(m_allocator, move.dstTmpAllocation, newBuffer) != VK_SUCCESS) {
+                if (newBuffer != VK_NULL_HANDLE) {
+                    vkDestroyBuffer(device, newBuffer, nullptr);
+                }
+                move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                continue;
+            }
+
+            // Pooled transient contents are undefined, so there is nothing to copy.
+            retiredBuffers.push_back(resource->buffer);
+            resource->buffer = newBuffer;
+            passResources[i] = resource;
+            m_defragmentedBytes += resource->size;
+            ++moved;
+        }
+
+        const VkResult passResult = vmaEndDefragmentationPass(m_allocator, context, &pass);
+        for (VkBuffer buffer : retiredBuffers) {
+            vkDestroyBuffer(device, buffer, nullptr);
+        }
+        retiredBuffers.clear();
+        for (VulkanBufferResource* resource : passResources) {
+            if (resource && vulkanBufferUsesDeviceAddress(resource->usageFlags)) {
+                VkBufferDeviceAddressInfo addressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+                addressInfo.buffer = resource->buffer;
+                resource->deviceAddress = vkGetBufferDeviceAddress(device, &addressInfo);
+            }
+        }
+        if (passResult == VK_SUCCESS) {
+            break;
+        }
+    }
+
+    VmaDefragmentationStats stats{};
+    vmaEndDefragmentation(m_allocator, context, &stats);
+    m_defragmentedBuffers += moved;
+    if (moved != 0) {
+        spdlog::info("VulkanTransientPool: defragmentation moved {} buffers, freed {} blocks",
+                     moved, stats.deviceMemoryBlocksFreed);
+    }
+    return moved;
+}
+
 uint32_t VulkanTransientPool::pooledTextureCount() const {
     return m_totalPooledTextures;
 }
@@ -211,6 +584,7 @@ void VulkanReadbackHeap::init(VkDevice device, VmaAllocator allocator,
             destroy();
             return;
         }
+        vulkanTrackAllocation(allocator, m_slices[i].allocation, RhiMemoryTag::Staging, "ReadbackHeap");
         m_slices[i].mappedData = resultInfo.pMappedData;
         m_slices[i].head = 0;
     }
@@ -222,6 +596,7 @@ void VulkanReadbackHeap::init(VkDevice device, VmaAllocator allocator,
 void VulkanReadbackHeap::destroy() {
     for (auto& slice : m_slices) {
         if (slice.buffer != VK_NULL_HANDLE && m_allocator) {
+            vulkanUntrackAllocation(slice.allocation);
             vmaDestroyBuffer(m_allocator, slice.buffer, slice.allocation);
         }
         slice = {};
@@ -2,9 +2,11 @@
 
 #ifdef _WIN32
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +20,7 @@ typedef VmaAllocation_T* VmaAllocation;
 
 struct RhiTextureDesc;
 struct RhiBufferDesc;
+enum class RhiBufferMemory;
 class RhiTexture;
 class RhiBuffer;
 class RhiFrameGraphBackend;
@@ -28,6 +31,17 @@ class RhiFrameGraphBackend;
 //
 // Replaces per-upload staging allocation with a persistent mapped ring.
 // Double-buffered (one slice per frame-in-flight).
+//
+// allocate() is thread-safe: the slice head is an atomic bump, and small requests
+// come from a block each thread reserves from the slice, so loader threads rarely
+// touch the shared head. Threads that stage outside the frame loop hold
+// stagingScope() from allocate() until the upload is queued, so beginFrame()
+// cannot recycle a slice in between.
+//
+// When a slice is exhausted, allocate() chains overflow chunks onto it instead of
+// failing. They are reset with their slice once its frame has retired and freed
+// after kOverflowIdleFrames frames without use, so a burst keeps its capacity for
+// the next few bursts without pinning it forever.
 
 class VulkanUploadRing {
 public:
@@ -42,36 +56,87 @@ public:
     void destroy();
 
     // Call at the start of each frame (after fence wait) to reset the ring head.
+    // Waits for threads inside a stagingScope().
     void beginFrame(uint32_t frameIndex);
 
     struct Allocation {
         VkBuffer  buffer    = VK_NULL_HANDLE;
         VkDeviceSize offset = 0;
         void*     mappedPtr = nullptr;
+        uint64_t  epoch     = 0; // frame the slice belongs to; see epoch()
         bool valid() const { return buffer != VK_NULL_HANDLE; }
     };
 
-    // Sub-allocate from the current frame's ring.
-    // Returns invalid allocation if the ring is exhausted.
+    std::shared_lock<std::shared_mutex> stagingScope() {
+        return std::shared_lock<std::shared_mutex>(m_frameGate);
+    }
+    // Changes on every beginFrame(); unique across rings.
+    uint64_t epoch() const { return m_epoch.load(std::memory_order_acquire); }
+
+    // Sub-allocate from the current frame's ring, or from an overflow chunk once
+    // the slice is full. Returns an invalid allocation only when the slice's
+    // overflow would pass kMaxOverflowBytesPerSlice or a chunk cannot be created.
     Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
 
+    // Per-thread block size; larger requests bump the shared head directly.
+    static constexpr VkDeviceSize kThreadBlockSize = 1024 * 1024;
+    // Overflow chunks are at least this large so a burst of small uploads adds few.
+    static constexpr VkDeviceSize kMinOverflowChunkSize = 16ull * 1024 * 1024;
+    static constexpr VkDeviceSize kMaxOverflowBytesPerSlice = 256ull * 1024 * 1024;
+    static constexpr uint64_t kOverflowIdleFrames = 240;
+
     bool isValid() const { return !m_slices.empty(); }
     VkDeviceSize capacityPerFrame() const { return m_capacityPerFrame; }
     VkDeviceSize usedThisFrame() const;
 
+    struct Stats {
+        VkDeviceSize capacityPerFrame = 0;
+        VkDeviceSize usedLastFrame = 0;      // ring + overflow bytes of the last finished frame
+        VkDeviceSize peakUsed = 0;           // high-water mark of usedLastFrame
+        VkDeviceSize overflowBytes = 0;      // overflow chunk memory held across all slices
+        uint32_t overflowChunks = 0;
+        uint64_t overflowAllocations = 0;    // allocations served by overflow chunks
+    };
+    Stats stats() const;
+    void resetPeak();
+
 private:
-    struct Slice {
+    struct OverflowChunk {
         VkBuffer buffer = VK_NULL_HANDLE;
         VmaAllocation allocation = nullptr;
         void* mappedData = nullptr;
+        VkDeviceSize capacity = 0;
         VkDeviceSize head = 0;
+        uint64_t lastUsedFrame = 0;
     };
 
+    struct Slice {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = nullptr;
+        void* mappedData = nullptr;
+        std::vector<OverflowChunk> overflow;
+    };
+
+    // Returns the aligned offset, or UINT64_MAX when the slice is exhausted.
+    VkDeviceSize reserve(VkDeviceSize size, VkDeviceSize alignment);
+    Allocation allocateOverflow(VkDeviceSize size, VkDeviceSize alignment, uint64_t epoch);
+    void destroyOverflowChunk(OverflowChunk& chunk);
+
     VkDevice     m_device    = VK_NULL_HANDLE;
     VmaAllocator m_allocator = nullptr;
     VkDeviceSize m_capacityPerFrame = 0;
     uint32_t     m_currentFrame = 0;
     std::vector<Slice> m_slices;
+    std::atomic<VkDeviceSize> m_head{0}; // current slice
+    std::atomic<uint64_t> m_epoch{0};
+    std::shared_mutex m_frameGate;
+
+    mutable std::mutex m_overflowMutex;  // guards Slice::overflow and the counters below
+    uint64_t     m_frameCounter = 0;
+    VkDeviceSize m_overflowUsedThisFrame = 0;
+    VkDeviceSize m_usedLastFrame = 0;
+    VkDeviceSize m_peakUsed = 0;
+    uint64_t     m_overflowAllocations = 0;
 };
 
 // =========================================================================
@@ -81,6 +146,13 @@ private:
 // Transient textures/buffers that are created and destroyed each frame by the
 // FrameGraph are instead returned to this pool and reused when a matching
 // descriptor is requested on a future frame.
+//
+// Entries are stamped with the frame serial that released them and are only
+// destroyed or moved once that frame has retired on the GPU. The pool is capped
+// by bytes as well as by object count; trim() evicts retired entries, least
+// recently used first, and also gives memory back when device-local headroom
+// runs low. defragment() compacts VMA blocks by relocating retired
+// device-local pooled buffers, whose contents are undefined anyway.
 
 class VulkanTransientPool {
 public:
@@ -90,11 +162,15 @@ public:
     VulkanTransientPool(const VulkanTransientPool&) = delete;
     VulkanTransientPool& operator=(const VulkanTransientPool&) = delete;
 
-    void init(uint32_t maxPooledTextures = 128, uint32_t maxPooledBuffers = 64);
+    void init(VmaAllocator allocator,
+              uint32_t maxPooledTextures = 128,
+              uint32_t maxPooledBuffers = 64,
+              uint64_t maxPooledBytes = 512ull * 1024 * 1024);
     void destroy();
 
-    // Call at the start of each frame.
-    void beginFrame();
+    // Call at the start of each frame. frameSerial is the serial of the frame
+    // about to be recorded; completedSerial the newest one the GPU finished.
+    void beginFrame(uint64_t frameSerial, uint64_t completedSerial);
 
     // Acquire a resource matching `desc` from the pool.
     // Returns nullptr if none available — caller should create a fresh one.
@@ -105,9 +181,26 @@ public:
     void releaseTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc);
     void releaseBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc);
 
+    // Evicts retired entries until the pool fits its byte budget and, when
+    // deviceLocalHeadroomBytes is below kMinDeviceLocalHeadroom, until the
+    // shortfall has been released. Pass UINT64_MAX when the budget is unknown.
+    void trim(uint64_t deviceLocalHeadroomBytes);
+
+    // Runs one bounded VMA defragmentation over the default pools. Only retired
+    // device-local pooled buffers are moved; every other proposed move is
+    // skipped. Returns the number of buffers relocated.
+    uint32_t defragment(VkDevice device, uint32_t maxMoves);
+
+    static constexpr uint64_t kMinDeviceLocalHeadroom = 256ull * 1024 * 1024;
+
     // Stats
     uint32_t pooledTextureCount() const;
     uint32_t pooledBufferCount() const;
+    uint64_t pooledBytes() const { return m_pooledBytes; }
+    uint64_t maxPooledBytes() const { return m_maxPooledBytes; }
+    uint64_t evictedBytes() const { return m_evictedBytes; }
+    uint64_t defragmentedBytes() const { return m_defragmentedBytes; }
+    uint32_t defragmentedBuffers() const { return m_defragmentedBuffers; }
     uint32_t cacheHits() const   { return m_cacheHits; }
     uint32_t cacheMisses() const { return m_cacheMisses; }
     void resetStats() { m_cacheHits = 0; m_cacheMisses = 0; }
@@ -119,9 +212,12 @@ private:
         uint32_t height;
         uint32_t format;
         uint32_t usage;
+        uint32_t storageMode;
+        uint32_t mipLevels;
         bool operator==(const TextureKey& other) const {
             return width == other.width && height == other.height &&
-                   format == other.format && usage == other.usage;
+                   format == other.format && usage == other.usage &&
+                   storageMode == other.storageMode && mipLevels == other.mipLevels;
         }
     };
     struct TextureKeyHash {
@@ -130,36 +226,59 @@ private:
             h ^= std::hash<uint32_t>{}(k.height) + 0x9e3779b9 + (h << 6) + (h >> 2);
             h ^= std::hash<uint32_t>{}(k.format) + 0x9e3779b9 + (h << 6) + (h >> 2);
             h ^= std::hash<uint32_t>{}(k.usage)  + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}(k.storageMode) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}(k.mipLevels) + 0x9e3779b9 + (h << 6) + (h >> 2);
             return h;
         }
     };
 
     struct BufferKey {
         uint64_t size;
-        bool hostVisible;
+        RhiBufferMemory memory;
         bool sharedWithTransferQueue;
         bool operator==(const BufferKey& other) const {
             return size == other.size &&
-                   hostVisible == other.hostVisible &&
+                   memory == other.memory &&
                    sharedWithTransferQueue == other.sharedWithTransferQueue;
         }
     };
     struct BufferKeyHash {
         size_t operator()(const BufferKey& k) const {
             size_t h = std::hash<uint64_t>{}(k.size);
-            h ^= std::hash<bool>{}(k.hostVisible) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<uint32_t>{}(static_cast<uint32_t>(k.memory)) + 0x9e3779b9 + (h << 6) + (h >> 2);
             h ^= std::hash<bool>{}(k.sharedWithTransferQueue) + 0x9e3779b9 + (h << 6) + (h >> 2);
             return h;
         }
     };
 
-    std::unordered_map<TextureKey, std::vector<std::unique_ptr<RhiTexture>>, TextureKeyHash> m_texturePool;
-    std::unordered_map<BufferKey, std::vector<std::unique_ptr<RhiBuffer>>, BufferKeyHash>   m_bufferPool;
+    template <typename T>
+    struct PooledEntry {
+        std::unique_ptr<T> resource;
+        uint64_t bytes = 0;
+        uint64_t releaseSerial = 0;
+    };
+    using PooledTexture = PooledEntry<RhiTexture>;
+    using PooledBuffer = PooledEntry<RhiBuffer>;
+
+    bool isRetired(uint64_t releaseSerial) const { return releaseSerial <= m_completedSerial; }
+    // Destroys the least recently released retired entry; false if there is none.
+    bool evictOldestRetired();
 
+    std::unordered_map<TextureKey, std::vector<PooledTexture>, TextureKeyHash> m_texturePool;
+    std::unordered_map<BufferKey, std::vector<PooledBuffer>, BufferKeyHash>   m_bufferPool;
+
+    VmaAllocator m_allocator = nullptr;
     uint32_t m_maxPooledTextures = 128;
     uint32_t m_maxPooledBuffers  = 64;
+    uint64_t m_maxPooledBytes = 512ull * 1024 * 1024;
     uint32_t m_totalPooledTextures = 0;
     uint32_t m_totalPooledBuffers  = 0;
+    uint64_t m_pooledBytes = 0;
+    uint64_t m_frameSerial = 0;
+    uint64_t m_completedSerial = 0;
+    uint64_t m_evictedBytes = 0;
+    uint64_t m_defragmentedBytes = 0;
+    uint32_t m_defragmentedBuffers = 0;
     uint32_t m_cacheHits   = 0;
     uint32_t m_cacheMisses = 0;
 };
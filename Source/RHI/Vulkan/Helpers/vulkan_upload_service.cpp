@@ -2,6 +2,7 @@
 
 #ifdef _WIN32
 
+#include "vulkan_memory_accounting.h"
 #include "vulkan_transient_allocator.h"
 
 #include <vk_mem_alloc.h>
@@ -9,6 +10,20 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
+
+namespace {
+
+// Deferred buffer uploads are staged in chunks so a large one can use the ring
+// space that is left instead of falling back to a one-off staging buffer.
+constexpr VkDeviceSize kStagingChunkSize = 4ull * 1024 * 1024;
+// Persistent buffer that immediate uploads stream through.
+constexpr VkDeviceSize kStreamingStagingSize = 16ull * 1024 * 1024;
+// Per-slot chunk size for streamed uploads; small enough that the first copy
+// starts early, large enough to keep the submission count down.
+constexpr VkDeviceSize kStreamSlotSize = 8ull * 1024 * 1024;
+
+} // namespace
 
 // =========================================================================
 // VulkanUploadService
@@ -33,6 +48,8 @@ void VulkanUploadService::init(VkDevice device,
     m_transferTimelineValue = 0;
     m_uploadRing = uploadRing;
     m_currentTransferFrame = 0;
+    m_framesInFlight = std::max(1u, framesInFlight);
+    m_frameCounter = 0;
 
     // Command pool for immediate (blocking) uploads on the graphics queue
     VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
@@ -50,19 +67,40 @@ void VulkanUploadService::init(VkDevice device,
             transferPoolInfo.queueFamilyIndex = transferQueueFamily;
             vkCreateCommandPool(device, &transferPoolInfo, nullptr, &frame.commandPool);
         }
+
+        VkCommandPoolCreateInfo streamPoolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        streamPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        streamPoolInfo.queueFamilyIndex = transferQueueFamily;
+        vkCreateCommandPool(device, &streamPoolInfo, nullptr, &m_streamCommandPool);
     }
+    m_nextStreamSlot = 0;
+    m_streamedWaitValue.store(0, std::memory_order_relaxed);
 
     spdlog::info("VulkanUploadService: initialized (transferQueue={})",
                  m_transferQueue != VK_NULL_HANDLE ? "available" : "none");
 }
 
 void VulkanUploadService::destroy() {
+    flushTransferBatch();
     if (m_transferQueue != VK_NULL_HANDLE) {
         vkQueueWaitIdle(m_transferQueue);
     }
 
-    freeStandaloneStaging();
-    m_pendingUploads.clear();
+    PendingNode* node = m_pendingHead.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+        if (node->upload.standaloneAllocation) {
+            destroyStandaloneStaging(node->upload.srcBuffer, node->upload.standaloneAllocation);
+        }
+        PendingNode* next = node->next;
+        delete node;
+        node = next;
+    }
+    freeRetiredStaging(true);
+    if (m_streamingStaging.buffer != VK_NULL_HANDLE) {
+        destroyStandaloneStaging(m_streamingStaging.buffer, m_streamingStaging.allocation);
+        m_streamingStaging = {};
+    }
+    destroyStreamSlots();
 
     if (m_immediateCommandPool != VK_NULL_HANDLE) {
         vkDestroyCommandPool(m_device, m_immediateCommandPool, nullptr);
@@ -79,7 +117,11 @@ void VulkanUploadService::destroy() {
 }
 
 void VulkanUploadService::beginFrame(uint32_t frameIndex) {
+    // A batch left open belongs to the previous frame's pool.
+    flushTransferBatch();
+    m_frameCounter = frameIndex;
     if (m_transferFrames.empty() || m_device == VK_NULL_HANDLE) {
+        freeRetiredStaging(false);
         return;
     }
 
@@ -111,16 +153,17 @@ void VulkanUploadService::beginFrame(uint32_t frameIndex) {
     if (commandPool != VK_NULL_HANDLE) {
         vkResetCommandPool(m_device, commandPool, 0);
     }
+    freeRetiredStaging(false);
 }
 
 // --- Staging allocation ---
 
-VulkanUploadService::StagingAlloc VulkanUploadService::allocateStaging(VkDeviceSize size) {
+VulkanUploadService::StagingAlloc VulkanUploadService::allocateStaging(VkDeviceSize size, bool allowRing) {
     // Try ring buffer first
-    if (m_uploadRing && m_uploadRing->isValid()) {
+    if (allowRing && m_uploadRing && m_uploadRing->isValid()) {
         auto ringAlloc = m_uploadRing->allocate(size);
         if (ringAlloc.valid()) {
-            return {ringAlloc.buffer, ringAlloc.offset, ringAlloc.mappedPtr, true, nullptr};
+            return {ringAlloc.buffer, ringAlloc.offset, ringAlloc.mappedPtr, true, nullptr, ringAlloc.epoch};
         }
     }
 
@@ -140,37 +183,132 @@ VulkanUploadService::StagingAlloc VulkanUploadService::allocateStaging(VkDeviceS
     if (vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo,
                         &buffer, &allocation, &resultInfo) != VK_SUCCESS) {
         spdlog::error("VulkanUploadService: failed to allocate standalone staging buffer ({} bytes)", size);
-        return {VK_NULL_HANDLE, 0, nullptr, false, nullptr};
+        return {VK_NULL_HANDLE, 0, nullptr, false, nullptr, 0};
     }
+    vulkanTrackAllocation(m_allocator, allocation, RhiMemoryTag::Staging, "UploadStaging");
 
-    m_standaloneStagingBuffers.push_back({buffer, allocation});
-    return {buffer, 0, resultInfo.pMappedData, false, allocation};
+    return {buffer, 0, resultInfo.pMappedData, false, allocation, 0};
 }
 
-void VulkanUploadService::freeStandaloneStaging() {
-    for (auto& s : m_standaloneStagingBuffers) {
-        if (s.buffer != VK_NULL_HANDLE && m_allocator) {
-            vmaDestroyBuffer(m_allocator, s.buffer, s.allocation);
+void VulkanUploadService::destroyStandaloneStaging(VkBuffer buffer, VmaAllocation allocation) {
+    if (buffer != VK_NULL_HANDLE && m_allocator) {
+        vulkanUntrackAllocation(allocation);
+        vmaDestroyBuffer(m_allocator, buffer, allocation);
+    }
+}
+
+bool VulkanUploadService::ensureStreamingStaging() {
+    if (m_streamingStaging.buffer != VK_NULL_HANDLE) {
+        return true;
+    }
+    const StagingAlloc staging = allocateStaging(kStreamingStagingSize, false);
+    if (!staging.mappedPtr) {
+        return false;
+    }
+    m_streamingStaging = {staging.buffer, staging.standaloneAllocation, staging.mappedPtr};
+    return true;
+}
+
+void VulkanUploadService::retireStaging(const std::vector<DeferredUpload>& uploads) {
+    for (const DeferredUpload& upload : uploads) {
+        if (upload.standaloneAllocation) {
+            m_retiredStaging.push_back({upload.srcBuffer, upload.standaloneAllocation, m_frameCounter});
         }
     }
-    m_standaloneStagingBuffers.clear();
+}
+
+void VulkanUploadService::freeRetiredStaging(bool all) {
+    auto retired = std::remove_if(m_retiredStaging.begin(), m_retiredStaging.end(),
+        [&](const StandaloneStaging& s) {
+            if (!all && s.frame + m_framesInFlight > m_frameCounter) {
+                return false;
+            }
+            destroyStandaloneStaging(s.buffer, s.allocation);
+            return true;
+        });
+    m_retiredStaging.erase(retired, m_retiredStaging.end());
+}
+
+// --- Pending upload queue ---
+
+void VulkanUploadService::enqueue(const DeferredUpload* uploads, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    // Link the batch newest first, then splice it onto the list in one CAS.
+    PendingNode* first = nullptr;
+    PendingNode* last = nullptr;
+    for (size_t index = 0; index < count; ++index) {
+        auto* node = new PendingNode{uploads[index]};
+        node->next = first;
+        first = node;
+        if (!last) {
+            last = node;
+        }
+    }
+    last->next = m_pendingHead.load(std::memory_order_relaxed);
+    while (!m_pendingHead.compare_exchange_weak(last->next, first,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+}
+
+std::vector<VulkanUploadService::DeferredUpload> VulkanUploadService::takePendingUploads() {
+    std::vector<DeferredUpload> uploads;
+    PendingNode* node = m_pendingHead.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+        uploads.push_back(node->upload);
+        PendingNode* next = node->next;
+        delete node;
+        node = next;
+    }
+    std::reverse(uploads.begin(), uploads.end());
+
+    // An upload staged just before the ring advanced can be queued after that
+    // frame's drain. Its slice is still intact (staging holds the ring's frame
+    // gate) but is recycled before this frame retires, so move it forward.
+    const uint64_t epoch = m_uploadRing ? m_uploadRing->epoch() : 0u;
+    for (DeferredUpload& upload : uploads) {
+        if (upload.ringEpoch == 0u || upload.ringEpoch == epoch) {
+            continue;
+        }
+        const StagingAlloc staging = allocateStaging(upload.size);
+        if (!staging.mappedPtr) {
+            upload.size = 0;
+            continue;
+        }
+        std::memcpy(staging.mappedPtr, upload.stagingPtr, static_cast<size_t>(upload.size));
+        upload.srcBuffer = staging.buffer;
+        upload.srcOffset = staging.offset;
+        upload.stagingPtr = staging.mappedPtr;
+        upload.ringEpoch = staging.ringEpoch;
+        upload.standaloneAllocation = staging.standaloneAllocation;
+    }
+    return uploads;
 }
 
 // --- Deferred staging ---
 
+bool VulkanUploadService::stageCopy(DeferredUpload& upload, const void* data) {
+    auto staging = allocateStaging(upload.size);
+    if (!staging.mappedPtr) return false;
+
+    std::memcpy(staging.mappedPtr, data, static_cast<size_t>(upload.size));
+    upload.srcBuffer = staging.buffer;
+    upload.srcOffset = staging.offset;
+    upload.stagingPtr = staging.mappedPtr;
+    upload.ringEpoch = staging.ringEpoch;
+    upload.standaloneAllocation = staging.standaloneAllocation;
+    return true;
+}
+
 bool VulkanUploadService::stageTexture2D(VkImage dstImage, uint32_t width, uint32_t height,
                                           const void* data, size_t dataSize, uint32_t mipLevel,
                                           bool deferShaderReadTransition) {
     if (!data || dataSize == 0) return false;
 
-    auto staging = allocateStaging(static_cast<VkDeviceSize>(dataSize));
-    if (!staging.mappedPtr) return false;
-
-    std::memcpy(staging.mappedPtr, data, dataSize);
-
     DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
     upload.size = static_cast<VkDeviceSize>(dataSize);
     upload.dstImage = dstImage;
     upload.width = width;
@@ -181,7 +319,13 @@ bool VulkanUploadService::stageTexture2D(VkImage dstImage, uint32_t width, uint3
     upload.dstBuffer = VK_NULL_HANDLE;
     upload.dstBufferOffset = 0;
     upload.isTexture = true;
-    m_pendingUploads.push_back(upload);
+
+    std::shared_lock<std::shared_mutex> scope;
+    if (m_uploadRing) {
+        scope = m_uploadRing->stagingScope();
+    }
+    if (!stageCopy(upload, data)) return false;
+    enqueue(&upload, 1);
     return true;
 }
 
@@ -190,14 +334,7 @@ bool VulkanUploadService::stageTexture3D(VkImage dstImage, uint32_t width, uint3
                                           uint32_t mipLevel) {
     if (!data || dataSize == 0) return false;
 
-    auto staging = allocateStaging(static_cast<VkDeviceSize>(dataSize));
-    if (!staging.mappedPtr) return false;
-
-    std::memcpy(staging.mappedPtr, data, dataSize);
-
     DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
     upload.size = static_cast<VkDeviceSize>(dataSize);
     upload.dstImage = dstImage;
     upload.width = width;
@@ -208,7 +345,13 @@ bool VulkanUploadService::stageTexture3D(VkImage dstImage, uint32_t width, uint3
     upload.dstBuffer = VK_NULL_HANDLE;
     upload.dstBufferOffset = 0;
     upload.isTexture = true;
-    m_pendingUploads.push_back(upload);
+
+    std::shared_lock<std::shared_mutex> scope;
+    if (m_uploadRing) {
+        scope = m_uploadRing->stagingScope();
+    }
+    if (!stageCopy(upload, data)) return false;
+    enqueue(&upload, 1);
     return true;
 }
 
@@ -216,15 +359,7 @@ bool VulkanUploadService::stageBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset
                                        const void* data, VkDeviceSize size) {
     if (!data || size == 0) return false;
 
-    auto staging = allocateStaging(size);
-    if (!staging.mappedPtr) return false;
-
-    std::memcpy(staging.mappedPtr, data, static_cast<size_t>(size));
-
     DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
-    upload.size = size;
     upload.dstImage = VK_NULL_HANDLE;
     upload.width = 0;
     upload.height = 0;
@@ -232,9 +367,29 @@ bool VulkanUploadService::stageBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset
     upload.mipLevel = 0;
     upload.deferShaderReadTransition = false;
     upload.dstBuffer = dstBuffer;
-    upload.dstBufferOffset = dstOffset;
     upload.isTexture = false;
-    m_pendingUploads.push_back(upload);
+
+    std::shared_lock<std::shared_mutex> scope;
+    if (m_uploadRing) {
+        scope = m_uploadRing->stagingScope();
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    std::vector<DeferredUpload> chunks;
+    chunks.reserve(static_cast<size_t>((size + kStagingChunkSize - 1) / kStagingChunkSize));
+    for (VkDeviceSize chunkOffset = 0; chunkOffset < size; chunkOffset += kStagingChunkSize) {
+        upload.size = std::min(kStagingChunkSize, size - chunkOffset);
+        upload.dstBufferOffset = dstOffset + chunkOffset;
+        if (!stageCopy(upload, bytes + chunkOffset)) {
+            for (const DeferredUpload& chunk : chunks) {
+                destroyStandaloneStaging(chunk.standaloneAllocation ? chunk.srcBuffer : VK_NULL_HANDLE,
+                                         chunk.standaloneAllocation);
+            }
+            return false;
+        }
+        chunks.push_back(upload);
+    }
+    enqueue(chunks.data(), chunks.size());
     return true;
 }
 
@@ -291,15 +446,19 @@ void VulkanUploadService::recordBufferCopy(VkCommandBuffer cmd, const DeferredUp
 }
 
 void VulkanUploadService::recordPendingUploads(VkCommandBuffer cmd) {
-    for (const auto& upload : m_pendingUploads) {
+    const std::vector<DeferredUpload> uploads = takePendingUploads();
+    for (const auto& upload : uploads) {
+        if (upload.size == 0) {
+            continue;
+        }
         if (upload.isTexture) {
             recordTextureCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
         } else {
             recordBufferCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
         }
     }
-    m_pendingUploads.clear();
-    // Note: standalone staging buffers freed after the command buffer completes (next frame's fence)
+    // Standalone staging buffers are freed once this frame retires.
+    retireStaging(uploads);
 }
 
 // --- One-shot command buffer helpers ---
@@ -343,62 +502,130 @@ VkCommandBuffer VulkanUploadService::beginAsyncTransferCommands() {
     return beginOneTimeCommands(commandPool);
 }
 
-uint64_t VulkanUploadService::submitAsyncTransferCommands(VkCommandBuffer cmd) {
-    if (cmd == VK_NULL_HANDLE ||
-        m_transferQueue == VK_NULL_HANDLE ||
-        m_transferTimelineSemaphore == VK_NULL_HANDLE) {
-        return 0;
+VkCommandBuffer VulkanUploadService::openTransferBatch() {
+    if (m_batchCommandBuffer != VK_NULL_HANDLE) {
+        return m_batchCommandBuffer;
     }
-
-    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
-        spdlog::error("VulkanUploadService: failed to end async transfer command buffer");
-        return 0;
+    if (m_transferQueue == VK_NULL_HANDLE || m_transferTimelineSemaphore == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
     }
 
-    ++m_transferTimelineValue;
-
-    VkSemaphoreSubmitInfo signalInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
-    signalInfo.semaphore = m_transferTimelineSemaphore;
-    signalInfo.value = m_transferTimelineValue;
-    signalInfo.stageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-
-    VkCommandBufferSubmitInfo cmdInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
-    cmdInfo.commandBuffer = cmd;
+    m_batchCommandBuffer = beginAsyncTransferCommands();
+    if (m_batchCommandBuffer == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+    // Nothing else signals the timeline until the batch is submitted: every other
+    // submission goes through submitTransferLocked(), which submits it first.
+    m_batchTimelineValue = ++m_transferTimelineValue;
+    m_transferFrames[m_currentTransferFrame].lastSubmittedTimelineValue = m_batchTimelineValue;
+    return m_batchCommandBuffer;
+}
 
-    VkSubmitInfo2 submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
-    submitInfo.commandBufferInfoCount = 1;
-    submitInfo.pCommandBufferInfos = &cmdInfo;
-    submitInfo.signalSemaphoreInfoCount = 1;
-    submitInfo.pSignalSemaphoreInfos = &signalInfo;
+uint64_t VulkanUploadService::submitTransferLocked(VkCommandBuffer cmd) {
+    std::array<VkCommandBufferSubmitInfo, 2> cmdInfos{};
+    std::array<VkSemaphoreSubmitInfo, 2> signalInfos{};
+    std::array<VkSubmitInfo2, 2> submitInfos{};
+    uint32_t submitCount = 0;
+    const auto addSubmit = [&](VkCommandBuffer commandBuffer, uint64_t signalValue) {
+        cmdInfos[submitCount] = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
+        cmdInfos[submitCount].commandBuffer = commandBuffer;
+        signalInfos[submitCount] = {VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
+        signalInfos[submitCount].semaphore = m_transferTimelineSemaphore;
+        signalInfos[submitCount].value = signalValue;
+        signalInfos[submitCount].stageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        submitInfos[submitCount] = {VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
+        submitInfos[submitCount].commandBufferInfoCount = 1;
+        submitInfos[submitCount].pCommandBufferInfos = &cmdInfos[submitCount];
+        submitInfos[submitCount].signalSemaphoreInfoCount = 1;
+        submitInfos[submitCount].pSignalSemaphoreInfos = &signalInfos[submitCount];
+        ++submitCount;
+    };
+
+    const uint64_t batchValue = m_batchTimelineValue;
+    bool batchRecorded = false;
+    if (m_batchCommandBuffer != VK_NULL_HANDLE) {
+        batchRecorded = vkEndCommandBuffer(m_batchCommandBuffer) == VK_SUCCESS;
+        if (batchRecorded) {
+            addSubmit(m_batchCommandBuffer, batchValue);
+        } else {
+            spdlog::error("VulkanUploadService: failed to end the frame's transfer batch");
+        }
+        m_batchCommandBuffer = VK_NULL_HANDLE;
+        m_batchTimelineValue = 0u;
+    }
+    const uint64_t transferValue = cmd != VK_NULL_HANDLE ? m_transferTimelineValue + 1u : 0u;
+    if (cmd != VK_NULL_HANDLE) {
+        addSubmit(cmd, transferValue);
+    }
 
-    if (vkQueueSubmit2(m_transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+    const bool submitted =
+        submitCount == 0u ||
+        vkQueueSubmit2(m_transferQueue, submitCount, submitInfos.data(), VK_NULL_HANDLE) == VK_SUCCESS;
+    if (!submitted) {
         spdlog::error("VulkanUploadService: failed to submit async transfer queue");
+    }
+    if (batchValue != 0u && (!batchRecorded || !submitted)) {
+        // Callers already wait on the batch's value; signal it from the host so
+        // nothing hangs on copies that never ran.
+        VkSemaphoreSignalInfo signalInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO};
+        signalInfo.semaphore = m_transferTimelineSemaphore;
+        signalInfo.value = batchValue;
+        vkSignalSemaphore(m_device, &signalInfo);
+    }
+    if (!submitted || cmd == VK_NULL_HANDLE) {
         return 0;
     }
+    m_transferTimelineValue = transferValue;
+    return transferValue;
+}
 
-    if (m_currentTransferFrame < m_transferFrames.size()) {
-        m_transferFrames[m_currentTransferFrame].lastSubmittedTimelineValue = m_transferTimelineValue;
-    }
+uint64_t VulkanUploadService::submitTransfer(VkCommandBuffer cmd) {
+    // Streamed uploads submit from loader threads alongside the frame's copies.
+    std::lock_guard<std::mutex> lock(m_transferSubmitMutex);
+    return submitTransferLocked(cmd);
+}
 
-    return m_transferTimelineValue;
+void VulkanUploadService::flushTransferBatch() {
+    std::lock_guard<std::mutex> lock(m_transferSubmitMutex);
+    if (m_batchCommandBuffer != VK_NULL_HANDLE) {
+        submitTransferLocked(VK_NULL_HANDLE);
+    }
 }
 
 // --- Immediate uploads ---
 
+void VulkanUploadService::immediateUploadTexture(DeferredUpload upload, const void* data) {
+    std::lock_guard<std::mutex> lock(m_immediateMutex);
+
+    // Textures are copied in one region; only ones larger than the streaming
+    // buffer need a one-off staging buffer.
+    StagingAlloc staging{};
+    if (upload.size <= kStreamingStagingSize && ensureStreamingStaging()) {
+        staging = {m_streamingStaging.buffer, 0, m_streamingStaging.mappedPtr, false, nullptr, 0};
+    } else {
+        staging = allocateStaging(upload.size, false);
+    }
+    if (!staging.mappedPtr) return;
+
+    std::memcpy(staging.mappedPtr, data, static_cast<size_t>(upload.size));
+
+    VkCommandBuffer cmd = beginOneTimeCommands(m_immediateCommandPool);
+    recordTextureCopy(cmd, upload, staging.buffer, staging.offset);
+    endOneTimeCommands(m_immediateCommandPool, m_graphicsQueue, cmd);
+
+    // GPU is idle after vkQueueWaitIdle
+    if (staging.standaloneAllocation) {
+        destroyStandaloneStaging(staging.buffer, staging.standaloneAllocation);
+    }
+}
+
 void VulkanUploadService::immediateUploadTexture2D(VkImage dstImage, uint32_t width,
                                                     uint32_t height, const void* data,
                                                     size_t dataSize, uint32_t mipLevel,
                                                     bool deferShaderReadTransition) {
     if (!data || dataSize == 0 || m_device == VK_NULL_HANDLE) return;
 
-    auto staging = allocateStaging(static_cast<VkDeviceSize>(dataSize));
-    if (!staging.mappedPtr) return;
-
-    std::memcpy(staging.mappedPtr, data, dataSize);
-
     DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
     upload.size = static_cast<VkDeviceSize>(dataSize);
     upload.dstImage = dstImage;
     upload.width = width;
@@ -407,13 +634,7 @@ void VulkanUploadService::immediateUploadTexture2D(VkImage dstImage, uint32_t wi
     upload.mipLevel = mipLevel;
     upload.deferShaderReadTransition = deferShaderReadTransition;
     upload.isTexture = true;
-
-    VkCommandBuffer cmd = beginOneTimeCommands(m_immediateCommandPool);
-    recordTextureCopy(cmd, upload, staging.buffer, staging.offset);
-    endOneTimeCommands(m_immediateCommandPool, m_graphicsQueue, cmd);
-
-    // Free standalone staging immediately (GPU is idle after vkQueueWaitIdle)
-    freeStandaloneStaging();
+    immediateUploadTexture(upload, data);
 }
 
 void VulkanUploadService::immediateUploadTexture3D(VkImage dstImage, uint32_t width,
@@ -422,14 +643,7 @@ void VulkanUploadService::immediateUploadTexture3D(VkImage dstImage, uint32_t wi
                                                     uint32_t mipLevel) {
     if (!data || dataSize == 0 || m_device == VK_NULL_HANDLE) return;
 
-    auto staging = allocateStaging(static_cast<VkDeviceSize>(dataSize));
-    if (!staging.mappedPtr) return;
-
-    std::memcpy(staging.mappedPtr, data, dataSize);
-
     DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
     upload.size = static_cast<VkDeviceSize>(dataSize);
     upload.dstImage = dstImage;
     upload.width = width;
@@ -438,34 +652,161 @@ void VulkanUploadService::immediateUploadTexture3D(VkImage dstImage, uint32_t wi
     upload.mipLevel = mipLevel;
     upload.deferShaderReadTransition = false;
     upload.isTexture = true;
-
-    VkCommandBuffer cmd = beginOneTimeCommands(m_immediateCommandPool);
-    recordTextureCopy(cmd, upload, staging.buffer, staging.offset);
-    endOneTimeCommands(m_immediateCommandPool, m_graphicsQueue, cmd);
-    freeStandaloneStaging();
+    immediateUploadTexture(upload, data);
 }
 
 void VulkanUploadService::immediateUploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset,
                                                  const void* data, VkDeviceSize size) {
     if (!data || size == 0 || m_device == VK_NULL_HANDLE) return;
 
-    auto staging = allocateStaging(size);
-    if (!staging.mappedPtr) return;
+    std::lock_guard<std::mutex> lock(m_immediateMutex);
+    if (!ensureStreamingStaging()) return;
+
+    // Stream through the persistent staging buffer one chunk at a time.
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (VkDeviceSize chunkOffset = 0; chunkOffset < size; chunkOffset += kStreamingStagingSize) {
+        DeferredUpload upload{};
+        upload.size = std::min(kStreamingStagingSize, size - chunkOffset);
+        upload.dstBuffer = dstBuffer;
+        upload.dstBufferOffset = dstOffset + chunkOffset;
+        upload.isTexture = false;
+        std::memcpy(m_streamingStaging.mappedPtr, bytes + chunkOffset, static_cast<size_t>(upload.size));
+
+        VkCommandBuffer cmd = beginOneTimeCommands(m_immediateCommandPool);
+        recordBufferCopy(cmd, upload, m_streamingStaging.buffer, 0);
+        endOneTimeCommands(m_immediateCommandPool, m_graphicsQueue, cmd);
+    }
+}
 
-    std::memcpy(staging.mappedPtr, data, static_cast<size_t>(size));
+// --- Streamed buffer uploads ---
 
-    DeferredUpload upload{};
-    upload.srcBuffer = staging.buffer;
-    upload.srcOffset = staging.offset;
-    upload.size = size;
-    upload.dstBuffer = dstBuffer;
-    upload.dstBufferOffset = dstOffset;
-    upload.isTexture = false;
+bool VulkanUploadService::ensureStreamSlots() {
+    for (StreamSlot& slot : m_streamSlots) {
+        if (slot.buffer == VK_NULL_HANDLE) {
+            const StagingAlloc staging = allocateStaging(kStreamSlotSize, false);
+            if (!staging.mappedPtr) {
+                return false;
+            }
+            slot.buffer = staging.buffer;
+            slot.allocation = staging.standaloneAllocation;
+            slot.mappedPtr = staging.mappedPtr;
+        }
+        if (slot.cmd == VK_NULL_HANDLE) {
+            VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = m_streamCommandPool;
+            allocInfo.commandBufferCount = 1;
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &slot.cmd) != VK_SUCCESS) {
+                slot.cmd = VK_NULL_HANDLE;
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
-    VkCommandBuffer cmd = beginOneTimeCommands(m_immediateCommandPool);
-    recordBufferCopy(cmd, upload, staging.buffer, staging.offset);
-    endOneTimeCommands(m_immediateCommandPool, m_graphicsQueue, cmd);
-    freeStandaloneStaging();
+void VulkanUploadService::destroyStreamSlots() {
+    for (StreamSlot& slot : m_streamSlots) {
+        if (slot.cmd != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(m_device, m_streamCommandPool, 1, &slot.cmd);
+        }
+        destroyStandaloneStaging(slot.buffer, slot.allocation);
+        slot = {};
+    }
+    if (m_streamCommandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(m_device, m_streamCommandPool, nullptr);
+        m_streamCommandPool = VK_NULL_HANDLE;
+    }
+}
+
+VulkanUploadService::UploadTicket VulkanUploadService::streamBuffer(VkBuffer dstBuffer,
+                                                                    VkDeviceSize dstOffset,
+                                                                    const void* data,
+                                                                    VkDeviceSize size) {
+    UploadTicket ticket;
+    if (!data || size == 0 || dstBuffer == VK_NULL_HANDLE || m_device == VK_NULL_HANDLE) {
+        return ticket;
+    }
+    if (m_transferQueue == VK_NULL_HANDLE ||
+        m_transferTimelineSemaphore == VK_NULL_HANDLE ||
+        m_streamCommandPool == VK_NULL_HANDLE) {
+        immediateUploadBuffer(dstBuffer, dstOffset, data, size);
+        return ticket;
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    if (!ensureStreamSlots()) {
+        spdlog::warn("VulkanUploadService: streamed upload slots unavailable, uploading immediately");
+        immediateUploadBuffer(dstBuffer, dstOffset, data, size);
+        return ticket;
+    }
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (VkDeviceSize chunkOffset = 0; chunkOffset < size; chunkOffset += kStreamSlotSize) {
+        StreamSlot& slot = m_streamSlots[m_nextStreamSlot];
+        m_nextStreamSlot = (m_nextStreamSlot + 1u) % kStreamSlotCount;
+        // Only blocks once every slot has a copy in flight.
+        wait({slot.transferValue});
+
+        const VkDeviceSize chunkSize = std::min(kStreamSlotSize, size - chunkOffset);
+        std::memcpy(slot.mappedPtr, bytes + chunkOffset, static_cast<size_t>(chunkSize));
+
+        VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkResetCommandBuffer(slot.cmd, 0);
+        vkBeginCommandBuffer(slot.cmd, &beginInfo);
+        VkBufferCopy region{};
+        region.srcOffset = 0;
+        region.dstOffset = dstOffset + chunkOffset;
+        region.size = chunkSize;
+        vkCmdCopyBuffer(slot.cmd, slot.buffer, dstBuffer, 1, &region);
+
+        slot.transferValue =
+            vkEndCommandBuffer(slot.cmd) == VK_SUCCESS ? submitTransfer(slot.cmd) : 0u;
+        if (slot.transferValue == 0u) {
+            spdlog::error("VulkanUploadService: streamed upload failed at offset {}, finishing immediately",
+                          chunkOffset);
+            immediateUploadBuffer(dstBuffer, dstOffset + chunkOffset,
+                                  bytes + chunkOffset, size - chunkOffset);
+            break;
+        }
+        ticket.transferValue = slot.transferValue;
+    }
+
+    uint64_t waitValue = m_streamedWaitValue.load(std::memory_order_relaxed);
+    while (waitValue < ticket.transferValue &&
+           !m_streamedWaitValue.compare_exchange_weak(waitValue, ticket.transferValue,
+                                                      std::memory_order_acq_rel)) {
+    }
+    return ticket;
+}
+
+bool VulkanUploadService::isComplete(UploadTicket ticket) const {
+    if (ticket.transferValue == 0u || m_transferTimelineSemaphore == VK_NULL_HANDLE) {
+        return true;
+    }
+    uint64_t completedValue = 0u;
+    if (vkGetSemaphoreCounterValue(m_device, m_transferTimelineSemaphore, &completedValue) != VK_SUCCESS) {
+        return false;
+    }
+    return completedValue >= ticket.transferValue;
+}
+
+void VulkanUploadService::wait(UploadTicket ticket) {
+    if (isComplete(ticket)) {
+        return;
+    }
+    // The value may belong to the batch, which signals nothing until submitted.
+    flushTransferBatch();
+    VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &m_transferTimelineSemaphore;
+    waitInfo.pValues = &ticket.transferValue;
+    if (vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        spdlog::warn("VulkanUploadService: waiting for streamed upload {} failed", ticket.transferValue);
+        std::lock_guard<std::mutex> lock(m_transferSubmitMutex);
+        vkQueueWaitIdle(m_transferQueue);
+    }
 }
 
 // --- Async transfer queue ---
@@ -473,24 +814,33 @@ void VulkanUploadService::immediateUploadBuffer(VkBuffer dstBuffer, VkDeviceSize
 uint64_t VulkanUploadService::submitAsyncTransfer() {
     if (m_transferQueue == VK_NULL_HANDLE ||
         m_transferTimelineSemaphore == VK_NULL_HANDLE ||
-        m_pendingUploads.empty()) {
-        return 0;
-    }
-
-    VkCommandBuffer cmd = beginAsyncTransferCommands();
-    if (cmd == VK_NULL_HANDLE) {
+        !hasPendingUploads()) {
         return 0;
     }
 
-    for (const auto& upload : m_pendingUploads) {
-        if (upload.isTexture) {
-            recordTextureCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
-        } else {
-            recordBufferCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
+    std::vector<DeferredUpload> uploads;
+    uint64_t transferValue = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_transferSubmitMutex);
+        VkCommandBuffer cmd = openTransferBatch();
+        if (cmd == VK_NULL_HANDLE) {
+            return 0;
         }
+        uploads = takePendingUploads();
+        for (const auto& upload : uploads) {
+            if (upload.size == 0) {
+                continue;
+            }
+            if (upload.isTexture) {
+                recordTextureCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
+            } else {
+                recordBufferCopy(cmd, upload, upload.srcBuffer, upload.srcOffset);
+            }
+        }
+        transferValue = m_batchTimelineValue;
     }
-    m_pendingUploads.clear();
-    return submitAsyncTransferCommands(cmd);
+    retireStaging(uploads);
+    return transferValue;
 }
 
 uint64_t VulkanUploadService::submitAsyncBufferCopies(VkBuffer srcBuffer,
@@ -506,13 +856,14 @@ uint64_t VulkanUploadService::submitAsyncBufferCopies(VkBuffer srcBuffer,
         return 0;
     }
 
-    VkCommandBuffer cmd = beginAsyncTransferCommands();
+    std::lock_guard<std::mutex> lock(m_transferSubmitMutex);
+    VkCommandBuffer cmd = openTransferBatch();
     if (cmd == VK_NULL_HANDLE) {
         return 0;
     }
 
     vkCmdCopyBuffer(cmd, srcBuffer, dstBuffer, regionCount, regions);
-    return submitAsyncTransferCommands(cmd);
+    return m_batchTimelineValue;
 }
 
 // =========================================================================
@@ -531,6 +882,8 @@ void VulkanReadbackService::init(VkDevice device, VulkanReadbackHeap* readbackHe
 void VulkanReadbackService::destroy() {
     m_pendingThisFrame.clear();
     m_inFlight.clear();
+    m_callbacks.clear();
+    m_callbackScratch.clear();
     m_device = VK_NULL_HANDLE;
     m_readbackHeap = nullptr;
 }
@@ -549,6 +902,38 @@ void VulkanReadbackService::beginFrame(uint32_t frameIndex) {
                 return (frameIndex - r.frameIndex) > m_framesInFlight * 2;
             }),
         m_inFlight.end());
+
+    // Resolve callbacks in submission order. A callback may request another readback,
+    // so take the ready ones out before calling any of them.
+    std::vector<PendingCallback> ready;
+    auto firstPending = std::stable_partition(m_callbacks.begin(), m_callbacks.end(),
+        [&](const PendingCallback& c) { return isReady(c.request, frameIndex); });
+    ready.assign(std::make_move_iterator(m_callbacks.begin()), std::make_move_iterator(firstPending));
+    m_callbacks.erase(m_callbacks.begin(), firstPending);
+    for (PendingCallback& c : ready) {
+        m_callbackScratch.resize(static_cast<size_t>(c.request.size));
+        if (readData(c.request, m_callbackScratch.data(), c.request.size)) {
+            c.onReady(m_callbackScratch.data(), c.request.size);
+        }
+    }
+}
+
+VulkanReadbackService::ReadbackRequest
+VulkanReadbackService::requestBufferReadback(VkBuffer srcBuffer, VkDeviceSize srcOffset,
+                                             VkDeviceSize size, const void* owner,
+                                             ReadbackCallback onReady) {
+    ReadbackRequest req = scheduleBufferReadback(srcBuffer, srcOffset, size);
+    if (req.valid() && onReady) {
+        m_callbacks.push_back({req, owner, std::move(onReady)});
+    }
+    return req;
+}
+
+void VulkanReadbackService::cancelReadbacks(const void* owner) {
+    m_callbacks.erase(
+        std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+            [&](const PendingCallback& c) { return c.owner == owner; }),
+        m_callbacks.end());
 }
 
 VulkanReadbackService::ReadbackRequest
@@ -583,8 +968,51 @@ VulkanReadbackService::scheduleBufferReadback(VkBuffer srcBuffer, VkDeviceSize s
     return req;
 }
 
+VulkanReadbackService::ReadbackRequest
+VulkanReadbackService::scheduleImageReadback(VkImage srcImage, uint32_t width, uint32_t height,
+                                              uint32_t bytesPerPixel) {
+    const VkDeviceSize size = VkDeviceSize(width) * height * bytesPerPixel;
+    if (!m_readbackHeap || !m_readbackHeap->isValid() || srcImage == VK_NULL_HANDLE || size == 0) {
+        return {};
+    }
+
+    auto heapAlloc = m_readbackHeap->allocate(size);
+    if (!heapAlloc.valid()) {
+        spdlog::warn("VulkanReadbackService: readback heap full, dropping image request");
+        return {};
+    }
+
+    uint32_t id = m_nextId++;
+    PendingReadback pending{};
+    pending.id = id;
+    pending.srcImage = srcImage;
+    pending.width = width;
+    pending.height = height;
+    pending.heapOffset = heapAlloc.offset;
+    pending.dstBuffer = heapAlloc.buffer;
+    pending.size = size;
+    pending.frameIndex = m_currentFrame;
+    m_pendingThisFrame.push_back(pending);
+
+    ReadbackRequest req{};
+    req.id = id;
+    req.frameSubmitted = m_currentFrame;
+    req.heapOffset = heapAlloc.offset;
+    req.size = size;
+    return req;
+}
+
 void VulkanReadbackService::recordPendingReadbacks(VkCommandBuffer cmd) {
     for (const auto& r : m_pendingThisFrame) {
+        if (r.srcImage != VK_NULL_HANDLE) {
+            VkBufferImageCopy imageRegion{};
+            imageRegion.bufferOffset = r.heapOffset;
+            imageRegion.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+            imageRegion.imageExtent = {r.width, r.height, 1};
+            vkCmdCopyImageToBuffer(cmd, r.srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   r.dstBuffer, 1, &imageRegion);
+            continue;
+        }
         VkBufferCopy region{};
         region.srcOffset = r.srcOffset;
         region.dstOffset = r.heapOffset;
@@ -4,7 +4,12 @@
 
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 struct VmaAllocator_T;
@@ -24,12 +29,31 @@ class VulkanReadbackHeap;
 // - Deferred per-frame uploads recorded into a command buffer
 // - Async transfer queue path (when available) with timeline semaphore sync
 //
-// For immediate uploads that exceed the ring capacity, falls back to a
-// temporary VMA staging buffer (same as the old one-shot pattern but
-// centralized).
+// The stage*() calls are thread-safe so asset loaders can stage from worker
+// threads: ring space is an atomic bump, and staged uploads go onto a lock-free
+// list that recordPendingUploads()/submitAsyncTransfer() drain on the main
+// thread. Buffer uploads are staged in ring-sized chunks. A full ring slice grows
+// overflow chunks (see VulkanUploadRing); only what those cannot hold falls back
+// to a temporary VMA staging buffer, which is freed once its frame has retired.
+//
+// Immediate uploads stream through a persistent staging buffer in chunks and are
+// serialized with each other; they still submit to the graphics queue, so they
+// must not overlap frame submission.
+//
+// Streamed buffer uploads (streamBuffer) are the non-blocking path for large
+// payloads such as scene geometry: chunks are copied through a small set of
+// staging slots on the transfer queue, and the CPU only waits when it needs a
+// slot whose previous copy is still in flight. The returned ticket completes
+// once the last chunk has landed.
 
 class VulkanUploadService {
 public:
+    // Transfer timeline value that covers an upload; 0 means already complete.
+    struct UploadTicket {
+        uint64_t transferValue = 0;
+        void merge(UploadTicket other) { transferValue = std::max(transferValue, other.transferValue); }
+    };
+
     void init(VkDevice device,
               VmaAllocator allocator,
               VkQueue graphicsQueue,
@@ -67,17 +91,35 @@ public:
     void immediateUploadBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset,
                                const void* data, VkDeviceSize size);
 
+    // --- Streamed (overlapped) buffer uploads ---
+
+    // Copies data into dstBuffer on the transfer queue; data may be freed on
+    // return. dstBuffer must be shared with the transfer queue family. Without a
+    // transfer queue this falls back to immediateUploadBuffer(). Thread-safe.
+    UploadTicket streamBuffer(VkBuffer dstBuffer, VkDeviceSize dstOffset,
+                              const void* data, VkDeviceSize size);
+    bool isComplete(UploadTicket ticket) const;
+    void wait(UploadTicket ticket);
+    // Highest streamed value since the last call, for the next graphics submit
+    // to wait on; 0 when nothing was streamed.
+    uint64_t consumeStreamedWaitValue() { return m_streamedWaitValue.exchange(0, std::memory_order_acq_rel); }
+
     // --- Async transfer queue ---
 
-    // Submit pending uploads to dedicated transfer queue.
-    // Returns timeline semaphore value to wait on, or 0 if no transfer queue.
+    // Both record into the frame's transfer batch, one command buffer that is
+    // submitted once by flushTransferBatch() (or by the next streamed upload, which
+    // has to signal the timeline after it). Return the timeline value the batch
+    // will signal, or 0 if there is no transfer queue.
     uint64_t submitAsyncTransfer();
     uint64_t submitAsyncBufferCopies(VkBuffer srcBuffer,
                                      VkBuffer dstBuffer,
                                      const VkBufferCopy* regions,
                                      uint32_t regionCount);
+    // Submits the frame's transfer batch with one vkQueueSubmit2. Call before the
+    // graphics submit that waits on it; beginFrame() flushes a forgotten batch.
+    void flushTransferBatch();
 
-    bool hasPendingUploads() const { return !m_pendingUploads.empty(); }
+    bool hasPendingUploads() const { return m_pendingHead.load(std::memory_order_acquire) != nullptr; }
     bool hasTransferQueue() const { return m_transferQueue != VK_NULL_HANDLE; }
 
 private:
@@ -95,6 +137,15 @@ private:
         VkDeviceSize dstBufferOffset;
         // Type tag
         bool isTexture;
+        // Staging source; ringEpoch is 0 for standalone buffers.
+        const void* stagingPtr;
+        uint64_t ringEpoch;
+        VmaAllocation standaloneAllocation;
+    };
+
+    struct PendingNode {
+        DeferredUpload upload;
+        PendingNode* next = nullptr;
     };
 
     // Staging helpers
@@ -104,15 +155,38 @@ private:
         void* mappedPtr;
         bool fromRing; // true = ring suballoc, false = standalone VMA buffer
         VmaAllocation standaloneAllocation; // only when fromRing==false
+        uint64_t ringEpoch;
     };
-    StagingAlloc allocateStaging(VkDeviceSize size);
-    void freeStandaloneStaging();
+    StagingAlloc allocateStaging(VkDeviceSize size, bool allowRing = true);
+    void destroyStandaloneStaging(VkBuffer buffer, VmaAllocation allocation);
+    // Copies data into staging memory and points upload at it. The caller holds
+    // the ring's staging scope until the upload is queued.
+    bool stageCopy(DeferredUpload& upload, const void* data);
+    // Queues uploads as one batch so a drain never sees part of it.
+    void enqueue(const DeferredUpload* uploads, size_t count);
+    // Main thread. Returns the queued uploads in staging order, re-staging any
+    // whose ring slice belongs to an earlier frame.
+    std::vector<DeferredUpload> takePendingUploads();
+    void retireStaging(const std::vector<DeferredUpload>& uploads);
+    void freeRetiredStaging(bool all);
+    bool ensureStreamingStaging();
+    void immediateUploadTexture(DeferredUpload upload, const void* data);
 
     // One-shot command buffer helpers
     VkCommandBuffer beginOneTimeCommands(VkCommandPool pool);
     void endOneTimeCommands(VkCommandPool pool, VkQueue queue, VkCommandBuffer cmd);
     VkCommandBuffer beginAsyncTransferCommands();
-    uint64_t submitAsyncTransferCommands(VkCommandBuffer cmd);
+    // Begins the frame's batch and reserves its timeline value; null without a
+    // transfer queue. Callers hold m_transferSubmitMutex.
+    VkCommandBuffer openTransferBatch();
+    // Submits the open batch, then cmd (when not null) signalling the next timeline
+    // value, in one call. Returns cmd's value, or 0. Callers hold m_transferSubmitMutex.
+    uint64_t submitTransferLocked(VkCommandBuffer cmd);
+    // Submits an ended command buffer to the transfer queue, signalling the next
+    // timeline value. Returns that value, or 0 on failure.
+    uint64_t submitTransfer(VkCommandBuffer cmd);
+    bool ensureStreamSlots();
+    void destroyStreamSlots();
 
     // Record copy commands for a single upload
     static void recordTextureCopy(VkCommandBuffer cmd, const DeferredUpload& upload,
@@ -127,8 +201,12 @@ private:
     VkQueue m_transferQueue = VK_NULL_HANDLE;
     uint32_t m_transferQueueFamily = UINT32_MAX;
     VkSemaphore m_transferTimelineSemaphore = VK_NULL_HANDLE;
+    std::mutex m_transferSubmitMutex; // transfer queue + timeline value + batch
     uint64_t m_transferTimelineValue = 0;
+    VkCommandBuffer m_batchCommandBuffer = VK_NULL_HANDLE;
+    uint64_t m_batchTimelineValue = 0;
     VulkanUploadRing* m_uploadRing = nullptr;
+    std::mutex m_immediateMutex; // immediate command pool + streaming staging
     VkCommandPool m_immediateCommandPool = VK_NULL_HANDLE;
     uint32_t m_currentTransferFrame = 0;
     struct TransferFrame {
@@ -136,14 +214,40 @@ private:
         uint64_t lastSubmittedTimelineValue = 0;
     };
     std::vector<TransferFrame> m_transferFrames;
-    std::vector<DeferredUpload> m_pendingUploads;
-
-    // Standalone staging buffers that need cleanup after submit
+    uint32_t m_framesInFlight = 2;
+    uint64_t m_frameCounter = 0;
+    std::atomic<PendingNode*> m_pendingHead{nullptr}; // newest first
+
+    // Persistent staging buffer for immediate uploads.
+    struct StreamingStaging {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = nullptr;
+        void* mappedPtr = nullptr;
+    };
+    StreamingStaging m_streamingStaging;
+
+    // Staging slots for streamBuffer(); a slot is reused once its copy retired.
+    struct StreamSlot {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = nullptr;
+        void* mappedPtr = nullptr;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint64_t transferValue = 0;
+    };
+    static constexpr uint32_t kStreamSlotCount = 4;
+    std::mutex m_streamMutex;
+    VkCommandPool m_streamCommandPool = VK_NULL_HANDLE;
+    std::array<StreamSlot, kStreamSlotCount> m_streamSlots{};
+    uint32_t m_nextStreamSlot = 0;
+    std::atomic<uint64_t> m_streamedWaitValue{0};
+
+    // Standalone staging buffers recorded into a frame, freed once it retires.
     struct StandaloneStaging {
         VkBuffer buffer;
         VmaAllocation allocation;
+        uint64_t frame;
     };
-    std::vector<StandaloneStaging> m_standaloneStagingBuffers;
+    std::vector<StandaloneStaging> m_retiredStaging;
 };
 
 // =========================================================================
@@ -172,6 +276,24 @@ public:
     ReadbackRequest scheduleBufferReadback(VkBuffer srcBuffer, VkDeviceSize srcOffset,
                                             VkDeviceSize size);
 
+    // Schedule a readback of mip 0 of a 2D color image into tightly packed rows.
+    // The image must be in TRANSFER_SRC_OPTIMAL when the copy is recorded.
+    ReadbackRequest scheduleImageReadback(VkImage srcImage, uint32_t width, uint32_t height,
+                                           uint32_t bytesPerPixel);
+
+    // Called from beginFrame() on the first frame the request is ready, which is also
+    // the last frame before its heap slice is reused. data is only valid during the call.
+    using ReadbackCallback = std::function<void(const void* data, VkDeviceSize size)>;
+
+    // scheduleBufferReadback() resolved by callback instead of polling. owner tags the
+    // request for cancelReadbacks(); pass the object the callback captures.
+    ReadbackRequest requestBufferReadback(VkBuffer srcBuffer, VkDeviceSize srcOffset,
+                                          VkDeviceSize size, const void* owner,
+                                          ReadbackCallback onReady);
+
+    // Drops every unresolved callback registered with owner. Call before the owner dies.
+    void cancelReadbacks(const void* owner);
+
     // Record pending readback copy commands into the command buffer.
     void recordPendingReadbacks(VkCommandBuffer cmd);
 
@@ -189,6 +311,9 @@ private:
         uint32_t id;
         VkBuffer srcBuffer;
         VkDeviceSize srcOffset;
+        VkImage srcImage;        // set for image readbacks instead of srcBuffer
+        uint32_t width;
+        uint32_t height;
         VkBuffer dstBuffer;      // readback heap buffer for the frame
         VkDeviceSize heapOffset;
         VkDeviceSize size;
@@ -202,6 +327,14 @@ private:
     uint32_t m_nextId = 1;
     std::vector<PendingReadback> m_pendingThisFrame;
     std::vector<PendingReadback> m_inFlight; // submitted, waiting for fence
+
+    struct PendingCallback {
+        ReadbackRequest request;
+        const void* owner;
+        ReadbackCallback onReady;
+    };
+    std::vector<PendingCallback> m_callbacks;
+    std::vector<uint8_t> m_callbackScratch;
 };
 
 #endif // _WIN32
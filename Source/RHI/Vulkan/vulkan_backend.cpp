@@ -1,8 +1,11 @@
 #include "vulkan_backend.h"
+#include "cpu_profile_zones.h"
 #include "rhi_resource_utils.h"
 #include "slang_compiler.h"
 #include "vulkan_resource_handles.h"
 #include "vulkan_pipeline_cache.h"
+#include "vulkan_pipeline_library.h"
+#include "vulkan_rt_pipeline.h"
 #include "vulkan_diagnostics.h"
 #include "vulkan_transient_allocator.h"
 
@@ -69,6 +72,9 @@ using VkPhysicalDeviceSubgroupSizeControlProperties =
 #include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <optional>
 #include <set>
 #include <span>
@@ -83,7 +89,7 @@ void vulkanLoadMeshShaderFunctions(VkDevice device);
 
 namespace {
 
-constexpr uint32_t kMaxFramesInFlight = 2;
+constexpr uint32_t kMaxFramesInFlight = kRhiMaxFramesInFlight;
 constexpr uint32_t kPushConstantSize = 256;
 const char* kValidationLayerName = "VK_LAYER_KHRONOS_validation";
 const char* kRenderDocLayerName = "VK_LAYER_RENDERDOC_Capture";
@@ -173,6 +179,7 @@ VkFormat toVkFormat(RhiFormat format) {
     case RhiFormat::RG8Unorm: return VK_FORMAT_R8G8_UNORM;
     case RhiFormat::RG16Float: return VK_FORMAT_R16G16_SFLOAT;
     case RhiFormat::RG32Float: return VK_FORMAT_R32G32_SFLOAT;
+    case RhiFormat::RG32Uint: return VK_FORMAT_R32G32_UINT;
     case RhiFormat::BGRA8Unorm: return VK_FORMAT_B8G8R8A8_UNORM;
     case RhiFormat::RGBA8Unorm: return VK_FORMAT_R8G8B8A8_UNORM;
     case RhiFormat::RGBA8Srgb: return VK_FORMAT_R8G8B8A8_SRGB;
@@ -180,6 +187,7 @@ VkFormat toVkFormat(RhiFormat format) {
     case RhiFormat::RGBA32Float: return VK_FORMAT_R32G32B32A32_SFLOAT;
     case RhiFormat::D32Float: return VK_FORMAT_D32_SFLOAT;
     case RhiFormat::D16Unorm: return VK_FORMAT_D16_UNORM;
+    case RhiFormat::BC7RGBAUnorm: return VK_FORMAT_BC7_UNORM_BLOCK;
     case RhiFormat::Undefined:
     default: return VK_FORMAT_UNDEFINED;
     }
@@ -194,6 +202,7 @@ RhiFormat fromVkFormat(VkFormat format) {
     case VK_FORMAT_R8G8_UNORM: return RhiFormat::RG8Unorm;
     case VK_FORMAT_R16G16_SFLOAT: return RhiFormat::RG16Float;
     case VK_FORMAT_R32G32_SFLOAT: return RhiFormat::RG32Float;
+    case VK_FORMAT_R32G32_UINT: return RhiFormat::RG32Uint;
     case VK_FORMAT_B8G8R8A8_UNORM:
     case VK_FORMAT_B8G8R8A8_SRGB: return RhiFormat::BGRA8Unorm;
     case VK_FORMAT_R8G8B8A8_UNORM: return RhiFormat::RGBA8Unorm;
@@ -202,6 +211,7 @@ RhiFormat fromVkFormat(VkFormat format) {
     case VK_FORMAT_R32G32B32A32_SFLOAT: return RhiFormat::RGBA32Float;
     case VK_FORMAT_D32_SFLOAT: return RhiFormat::D32Float;
     case VK_FORMAT_D16_UNORM: return RhiFormat::D16Unorm;
+    case VK_FORMAT_BC7_UNORM_BLOCK: return RhiFormat::BC7RGBAUnorm;
     default: return RhiFormat::Undefined;
     }
 }
@@ -300,6 +310,7 @@ void destroyPipelineLayouts(VulkanPipelineResource& resource) {
     resource.setLayouts.clear();
     resource.setLayoutOwnership.clear();
     resource.bindlessSetIndex = UINT32_MAX;
+    resource.pushDescriptorSetIndex = UINT32_MAX;
 
     if (resource.ownsLayout && resource.layout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(resource.device, resource.layout, nullptr);
@@ -365,7 +376,8 @@ bool buildPipelineResourceLayout(VkDevice device,
                                  size_t size,
                                  VulkanPipelineResource& outResource,
                                  std::string& errorMessage,
-                                 bool useDescriptorBuffer = false) {
+                                 bool useDescriptorBuffer = false,
+                                 uint32_t maxPushDescriptors = 0) {
     SlangShaderBindingLayout shaderLayout;
     if (!findSlangBindingLayoutForBinary(data, size, shaderLayout)) {
         errorMessage = "Missing cached Slang reflection for SPIR-V shader";
@@ -472,6 +484,23 @@ bool buildPipelineResourceLayout(VkDevice device,
         }
     }
 
+    // One set per layout may be a push descriptor set. Take the largest per-pass set
+    // that fits, so the common case needs no pool allocation or descriptor update.
+    uint32_t largestPushableCount = 0;
+    for (size_t setIndex = 0; setIndex < perSetBindings.size() && maxPushDescriptors != 0; ++setIndex) {
+        if (bindlessSetPresent && vulkanIsBindlessSetIndex(static_cast<uint32_t>(setIndex))) {
+            continue;
+        }
+        uint32_t descriptorCount = 0;
+        for (const VkDescriptorSetLayoutBinding& binding : perSetBindings[setIndex]) {
+            descriptorCount += binding.descriptorCount;
+        }
+        if (descriptorCount > largestPushableCount && descriptorCount <= maxPushDescriptors) {
+            largestPushableCount = descriptorCount;
+            outResource.pushDescriptorSetIndex = static_cast<uint32_t>(setIndex);
+        }
+    }
+
     outResource.setLayouts.resize(perSetBindings.size(), VK_NULL_HANDLE);
     outResource.setLayoutOwnership.assign(perSetBindings.size(), 1);
     for (size_t setIndex = 0; setIndex < perSetBindings.size(); ++setIndex) {
@@ -526,6 +555,9 @@ bool buildPipelineResourceLayout(VkDevice device,
         if (useDescriptorBuffer) {
             layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
         }
+        if (outResource.pushDescriptorSetIndex == static_cast<uint32_t>(setIndex)) {
+            layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
 
         const VkResult result = vkCreateDescriptorSetLayout(device,
                                                             &layoutInfo,
@@ -992,6 +1024,7 @@ public:
         }
         return m_resource.mappedData;
     }
+    uint64_t gpuAddress() const override { return m_resource.deviceAddress; }
     VkBuffer handle() const { return m_resource.buffer; }
 
 private:
@@ -1034,14 +1067,44 @@ public:
             reinterpret_cast<PFN_vkGetDeviceProcAddr>(createInfo.vkGetDeviceProcAddrProxy);
         m_requestedWidth = createInfo.width;
         m_requestedHeight = createInfo.height;
+        m_framesInFlight = std::clamp(createInfo.framesInFlight, 2u, kMaxFramesInFlight);
         createInstance(createInfo);
         createSurface(createInfo.window);
         pickPhysicalDevice(createInfo.requireVulkan14);
         populateLimits();
         createLogicalDevice(createInfo);
         m_pipelineCache.load(m_device, m_physicalDevice, createInfo.pipelineCacheDir);
+        m_pipelineCache.setCreationCacheControl(m_pipelineCreationCacheControlSupported);
+        if (m_toolingInfo.pipelineExecutableStats) {
+            m_vkGetPipelineExecutablePropertiesKHR = reinterpret_cast<PFN_vkGetPipelineExecutablePropertiesKHR>(
+                vkGetDeviceProcAddr(m_device, "vkGetPipelineExecutablePropertiesKHR"));
+            m_vkGetPipelineExecutableStatisticsKHR = reinterpret_cast<PFN_vkGetPipelineExecutableStatisticsKHR>(
+                vkGetDeviceProcAddr(m_device, "vkGetPipelineExecutableStatisticsKHR"));
+            m_toolingInfo.pipelineExecutableStats =
+                m_vkGetPipelineExecutablePropertiesKHR && m_vkGetPipelineExecutableStatisticsKHR;
+        }
+        if (m_features.graphicsPipelineLibrary) {
+            m_pipelineLibraries.init(m_device, m_pipelineCache.handle(), pipelineCreateFlags());
+        }
         resolveStreamlinePresentHooks();
-        m_gpuProfiler.init(m_physicalDevice, m_device, kMaxFramesInFlight, m_features.meshShaders);
+        if (m_features.presentWait) {
+            m_vkWaitForPresentKHR =
+                reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR"));
+            m_features.presentWait = m_vkWaitForPresentKHR != nullptr;
+        }
+        m_lowLatencyPresentWait = createInfo.lowLatencyPresentWait && m_features.presentWait;
+        spdlog::info("Vulkan: {} frames in flight, present wait {}",
+                     m_framesInFlight,
+                     m_features.presentWait ? "available" : "unavailable");
+        m_features.resizableBar = detectResizableBar();
+        spdlog::info("Vulkan: resizable BAR {}; dynamic per-frame buffers live in {}",
+                     m_features.resizableBar ? "available" : "unavailable",
+                     m_features.resizableBar ? "mapped VRAM" : "host memory");
+        m_gpuProfiler.init(m_physicalDevice, m_device, m_framesInFlight, m_features.meshShaders);
+        if (m_toolingInfo.performanceQuery) {
+            m_toolingInfo.performanceQuery =
+                m_gpuProfiler.initPerformanceCounters(m_instance, m_physicalDevice, m_queueFamilies.graphics.value());
+        }
         createVmaAllocator();
         createCommandObjects();
         createDescriptorPool();
@@ -1051,9 +1114,9 @@ public:
         // Transient memory subsystems (after VMA is ready)
         constexpr VkDeviceSize kUploadRingSize  = 64 * 1024 * 1024; // 64 MB per frame
         constexpr VkDeviceSize kReadbackHeapSize = 16 * 1024 * 1024; // 16 MB per frame
-        m_uploadRing.init(m_device, m_allocator, kUploadRingSize, kMaxFramesInFlight);
-        m_transientPool.init(128, 64);
-        m_readbackHeap.init(m_device, m_allocator, kReadbackHeapSize, kMaxFramesInFlight);
+        m_uploadRing.init(m_device, m_allocator, kUploadRingSize, m_framesInFlight);
+        m_transientPool.init(m_allocator, 128, 64);
+        m_readbackHeap.init(m_device, m_allocator, kReadbackHeapSize, m_framesInFlight);
 
         vulkanSetResourceContext(m_device,
                                  m_physicalDevice,
@@ -1066,6 +1129,7 @@ public:
                                  m_features.rayTracing,
                                  m_toolingInfo.debugUtils,
                                  createInfo.vkGetDeviceProcAddrProxy);
+        vulkanSetResizableBarEnabled(m_features.resizableBar);
         vulkanLoadMeshShaderFunctions(m_device);
         applyDebugObjectNames();
         logSubgroupProperties(m_subgroupProperties);
@@ -1074,6 +1138,7 @@ public:
     ~VulkanContext() override {
         waitIdle();
         cleanupSwapchain();
+        destroyRetiredSwapchains(UINT64_MAX);
         vulkanClearResourceContext();
 
         if (m_descriptorPool != VK_NULL_HANDLE) {
@@ -1081,6 +1146,9 @@ public:
         }
 
         for (auto& frame : m_frames) {
+            for (const ParallelRecordingPool& pool : frame.parallelPools) {
+                vkDestroyCommandPool(m_device, pool.commandPool, nullptr);
+            }
             if (frame.computeCommandPool != VK_NULL_HANDLE) {
                 vkDestroyCommandPool(m_device, frame.computeCommandPool, nullptr);
             }
@@ -1098,6 +1166,9 @@ public:
         if (m_computeTimelineSemaphore != VK_NULL_HANDLE) {
             vkDestroySemaphore(m_device, m_computeTimelineSemaphore, nullptr);
         }
+        if (m_graphicsTimelineSemaphore != VK_NULL_HANDLE) {
+            vkDestroySemaphore(m_device, m_graphicsTimelineSemaphore, nullptr);
+        }
         if (m_transferTimelineSemaphore != VK_NULL_HANDLE) {
             vkDestroySemaphore(m_device, m_transferTimelineSemaphore, nullptr);
         }
@@ -1111,6 +1182,7 @@ public:
             vmaDestroyAllocator(m_allocator);
         }
 
+        m_pipelineLibraries.destroy();
         m_pipelineCache.save();
         m_pipelineCache.destroy();
 
@@ -1145,6 +1217,47 @@ public:
         telemetry.graphicsPipelinesCompiled = m_pipelineCache.graphicsPipelinesCompiled();
         telemetry.computePipelinesCompiled = m_pipelineCache.computePipelinesCompiled();
         telemetry.totalCompileMs = m_pipelineCache.totalCompileMs();
+        telemetry.cacheEntryHits = m_pipelineCache.entryHits();
+        telemetry.cacheEntryMisses = m_pipelineCache.entryMisses();
+        telemetry.cacheEntryStale = m_pipelineCache.entryStale();
+        telemetry.cacheEntriesRejected = m_pipelineCache.entriesRejected();
+        telemetry.cacheEntriesWritten = m_pipelineCache.entriesWritten();
+        telemetry.pipelineLibrariesEnabled = m_pipelineLibraries.isEnabled();
+        telemetry.pipelinesFastLinked = m_pipelineLibraries.fastLinkedCount();
+        telemetry.pipelinesOptimized = m_pipelineLibraries.optimizedCount();
+        telemetry.pipelinesAwaitingOptimization = m_pipelineLibraries.pendingOptimizedCount();
+        return telemetry;
+    }
+    VulkanMemoryTelemetry memoryTelemetry() const {
+        VulkanMemoryTelemetry telemetry;
+        if (m_allocator) {
+            const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+            vmaGetMemoryProperties(m_allocator, &memoryProperties);
+            std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+            vmaGetHeapBudgets(m_allocator, budgets.data());
+            for (uint32_t heapIndex = 0; heapIndex < memoryProperties->memoryHeapCount; ++heapIndex) {
+                if ((memoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0) {
+                    continue;
+                }
+                const VmaStatistics& statistics = budgets[heapIndex].statistics;
+                telemetry.deviceLocalBlockCount += statistics.blockCount;
+                telemetry.deviceLocalAllocationCount += statistics.allocationCount;
+                telemetry.deviceLocalBlockBytes += statistics.blockBytes;
+                telemetry.deviceLocalAllocationBytes += statistics.allocationBytes;
+            }
+        }
+        telemetry.pooledTransientBytes = m_transientPool.pooledBytes();
+        telemetry.maxPooledTransientBytes = m_transientPool.maxPooledBytes();
+        telemetry.evictedTransientBytes = m_transientPool.evictedBytes();
+        telemetry.defragmentedBuffers = m_transientPool.defragmentedBuffers();
+        telemetry.defragmentedBytes = m_transientPool.defragmentedBytes();
+        const VulkanUploadRing::Stats uploadRing = m_uploadRing.stats();
+        telemetry.uploadRingCapacityBytes = uploadRing.capacityPerFrame;
+        telemetry.uploadRingUsedBytes = uploadRing.usedLastFrame;
+        telemetry.uploadRingPeakBytes = uploadRing.peakUsed;
+        telemetry.uploadRingOverflowBytes = uploadRing.overflowBytes;
+        telemetry.uploadRingOverflowChunks = uploadRing.overflowChunks;
+        telemetry.uploadRingOverflowAllocations = uploadRing.overflowAllocations;
         return telemetry;
     }
     bool isDeviceLost() const { return m_deviceLost; }
@@ -1159,6 +1272,9 @@ public:
             recreateSwapchain();
             m_pendingResize = false;
         }
+        if (!waitForPresentLatency()) {
+            return false;
+        }
 
         FrameResources& frame = m_frames[m_frameIndex];
         if (!handleRuntimeResult(vkWaitForFences(m_device, 1, &frame.inFlight, VK_TRUE, UINT64_MAX),
@@ -1167,6 +1283,9 @@ public:
         }
         m_completedGraphicsSubmissionSerial =
             std::max(m_completedGraphicsSubmissionSerial, frame.lastSubmittedGraphicsSerial);
+        m_pipelineLibraries.publishOptimized(m_submittedFrameCounter, m_completedGraphicsSubmissionSerial);
+        runDeferredReleases(m_completedGraphicsSubmissionSerial);
+        destroyRetiredSwapchains(m_completedGraphicsSubmissionSerial);
 
         VkResult acquireResult = acquireNextImageKHR(
             m_device,
@@ -1208,6 +1327,15 @@ public:
                 return false;
             }
         }
+        for (ParallelRecordingPool& pool : frame.parallelPools) {
+            if (!handleRuntimeResult(vkResetCommandPool(m_device, pool.commandPool, 0),
+                                     "Failed to reset parallel recording command pool")) {
+                return false;
+            }
+            pool.usedCount = 0u;
+        }
+
+        resetQueueSegments(frame);
 
         VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
@@ -1229,7 +1357,8 @@ public:
 
         // Notify transient subsystems that this frame's resources are safe to reuse.
         m_uploadRing.beginFrame(m_frameIndex);
-        m_transientPool.beginFrame();
+        m_transientPool.beginFrame(m_submittedFrameCounter + 1u, m_completedGraphicsSubmissionSerial);
+        maintainTransientPool();
         m_readbackHeap.beginFrame(m_frameIndex);
 
         return true;
@@ -1251,9 +1380,30 @@ public:
             return;
         }
 
-        // Upgraded to VkQueueSubmit2 for timeline semaphore compatibility.
-        VkCommandBufferSubmitInfo cmdSubmitInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO};
-        cmdSubmitInfo.commandBuffer = frame.commandBuffer;
+        // Async compute segments go first; any graphics value they wait on is signalled by
+        // the graphics batches submitted below (timeline semaphores allow wait-before-signal).
+        if (!submitClosedComputeSegments()) {
+            return;
+        }
+
+        // Upgraded to VkQueueSubmit2 for timeline semaphore compatibility. Segments closed by
+        // splitQueueSegments() are submitted as earlier batches of the same call.
+        const size_t batchCount = m_closedGraphicsSegments.size() + 1u;
+        std::vector<VkCommandBufferSubmitInfo> cmdSubmitInfos(
+            batchCount, VkCommandBufferSubmitInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO});
+        std::vector<VkSemaphoreSubmitInfo> segmentWaitInfos(
+            batchCount, VkSemaphoreSubmitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO});
+        std::vector<VkSemaphoreSubmitInfo> segmentSignalInfos(
+            batchCount, VkSemaphoreSubmitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO});
+        std::vector<VkSubmitInfo2> submitInfos(batchCount, VkSubmitInfo2{VK_STRUCTURE_TYPE_SUBMIT_INFO_2});
+
+        // The final batch carries the frame fence, so it also waits for all async compute
+        // work closed this frame before the command pools can be reset.
+        uint64_t finalComputeWaitValue = m_graphicsSegmentWaitValue;
+        if (!m_closedComputeSegments.empty()) {
+            finalComputeWaitValue =
+                std::max(finalComputeWaitValue, m_lastClosedComputeSignalValue);
+        }
 
         VkSemaphoreSubmitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO};
         waitInfo.semaphore = frame.imageAvailable;
@@ -1278,21 +1428,55 @@ public:
             waitInfos.push_back(queuedWaitInfo);
         }
 
-        VkSubmitInfo2 submitInfo2{VK_STRUCTURE_TYPE_SUBMIT_INFO_2};
-        submitInfo2.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
-        submitInfo2.pWaitSemaphoreInfos = waitInfos.data();
-        submitInfo2.commandBufferInfoCount = 1;
-        submitInfo2.pCommandBufferInfos = &cmdSubmitInfo;
-        submitInfo2.signalSemaphoreInfoCount = 1;
-        submitInfo2.pSignalSemaphoreInfos = &signalInfo;
+        for (size_t batch = 0; batch < batchCount; ++batch) {
+            const bool finalBatch = batch + 1u == batchCount;
+            const uint64_t segmentWaitValue =
+                finalBatch ? finalComputeWaitValue : m_closedGraphicsSegments[batch].waitValue;
+            cmdSubmitInfos[batch].commandBuffer =
+                finalBatch ? frame.commandBuffer : m_closedGraphicsSegments[batch].commandBuffer;
+
+            VkSubmitInfo2& submitInfo2 = submitInfos[batch];
+            submitInfo2.commandBufferInfoCount = 1;
+            submitInfo2.pCommandBufferInfos = &cmdSubmitInfos[batch];
+            if (segmentWaitValue != 0u) {
+                segmentWaitInfos[batch].semaphore = m_computeTimelineSemaphore;
+                segmentWaitInfos[batch].value = segmentWaitValue;
+                segmentWaitInfos[batch].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            }
+            // The swapchain and queued timeline waits guard the first work of the frame.
+            if (batch == 0u) {
+                if (segmentWaitValue != 0u) {
+                    waitInfos.push_back(segmentWaitInfos[batch]);
+                }
+                submitInfo2.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
+                submitInfo2.pWaitSemaphoreInfos = waitInfos.data();
+            } else if (segmentWaitValue != 0u) {
+                submitInfo2.waitSemaphoreInfoCount = 1;
+                submitInfo2.pWaitSemaphoreInfos = &segmentWaitInfos[batch];
+            }
+            if (finalBatch) {
+                submitInfo2.signalSemaphoreInfoCount = 1;
+                submitInfo2.pSignalSemaphoreInfos = &signalInfo;
+            } else {
+                segmentSignalInfos[batch].semaphore = m_graphicsTimelineSemaphore;
+                segmentSignalInfos[batch].value = m_closedGraphicsSegments[batch].signalValue;
+                segmentSignalInfos[batch].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                submitInfo2.signalSemaphoreInfoCount = 1;
+                submitInfo2.pSignalSemaphoreInfos = &segmentSignalInfos[batch];
+            }
+        }
 
-        if (!handleRuntimeResult(vkQueueSubmit2(m_graphicsQueue, 1, &submitInfo2, frame.inFlight),
+        if (!handleRuntimeResult(vkQueueSubmit2(m_graphicsQueue,
+                                                static_cast<uint32_t>(batchCount),
+                                                submitInfos.data(),
+                                                frame.inFlight),
                                  "Failed to submit graphics queue")) {
             return;
         }
         frame.lastSubmittedGraphicsSerial = m_submittedFrameCounter + 1u;
         m_submittedFrameCounter = frame.lastSubmittedGraphicsSerial;
         m_pendingGraphicsTimelineWaits.clear();
+        m_closedGraphicsSegments.clear();
 
         VkPresentInfoKHR presentInfo{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
         presentInfo.waitSemaphoreCount = 1;
@@ -1301,6 +1485,15 @@ public:
         presentInfo.pSwapchains = &m_swapchain;
         presentInfo.pImageIndices = &m_imageIndex;
 
+        VkPresentIdKHR presentIdInfo{VK_STRUCTURE_TYPE_PRESENT_ID_KHR};
+        uint64_t presentId = 0;
+        if (m_features.presentWait) {
+            presentId = ++m_presentId;
+            presentIdInfo.swapchainCount = 1;
+            presentIdInfo.pPresentIds = &presentId;
+            presentInfo.pNext = &presentIdInfo;
+        }
+
         const VkResult presentResult = queuePresentKHR(m_presentQueue, &presentInfo);
         if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || m_pendingResize) {
             recreateSwapchain();
@@ -1311,7 +1504,7 @@ public:
             throw std::runtime_error("Failed to present Vulkan swapchain image.");
         }
 
-        m_frameIndex = (m_frameIndex + 1) % kMaxFramesInFlight;
+        m_frameIndex = (m_frameIndex + 1) % m_framesInFlight;
     }
 
     void resize(uint32_t width, uint32_t height) override {
@@ -1329,6 +1522,15 @@ public:
                 markDeviceLost("vkDeviceWaitIdle reported device lost");
             }
         }
+        // Nothing is in flight any more (or never will complete after a device loss).
+        runDeferredReleases(UINT64_MAX);
+    }
+
+    void deferRelease(std::function<void()> release) override {
+        if (!release) {
+            return;
+        }
+        m_deferredReleases.push_back({m_submittedFrameCounter + 1u, std::move(release)});
     }
 
     uint64_t completedGraphicsSubmissionSerial() override {
@@ -1337,6 +1539,11 @@ public:
     }
 
     uint64_t nextGraphicsSubmissionSerial() const override { return m_submittedFrameCounter + 1u; }
+    uint32_t framesInFlight() const override { return m_framesInFlight; }
+    void setLowLatencyPresentWait(bool enabled) override {
+        m_lowLatencyPresentWait = enabled && m_features.presentWait;
+    }
+    bool lowLatencyPresentWait() const override { return m_lowLatencyPresentWait; }
 
     RhiCommandContext& commandContext() override { return m_commandContext; }
     uint32_t drawableWidth() const override { return m_swapchainExtent.width; }
@@ -1525,7 +1732,8 @@ public:
 
         auto* resource = new VulkanPipelineResource{};
         resource->device = m_device;
-        if (!buildPipelineResourceLayout(m_device, source.data(), source.size(), *resource, errorMessage, m_features.descriptorBuffer)) {
+        if (!buildPipelineResourceLayout(m_device, source.data(), source.size(), *resource, errorMessage,
+                                         m_features.descriptorBuffer, m_limits.maxPushDescriptors)) {
             vkDestroyShaderModule(m_device, shaderModule, nullptr);
             delete resource;
             return {};
@@ -1592,6 +1800,18 @@ public:
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        if (desc.blendMode != RhiBlendMode::Opaque) {
+            const bool additive = desc.blendMode == RhiBlendMode::Additive;
+            colorBlendAttachment.blendEnable = VK_TRUE;
+            colorBlendAttachment.srcColorBlendFactor = additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ZERO;
+            colorBlendAttachment.dstColorBlendFactor =
+                additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+            colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+            colorBlendAttachment.srcAlphaBlendFactor = additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ZERO;
+            colorBlendAttachment.dstAlphaBlendFactor =
+                additive ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        }
 
         VkPipelineColorBlendStateCreateInfo colorBlending{VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
         colorBlending.attachmentCount = 1;
@@ -1611,7 +1831,7 @@ public:
         VkPipelineDepthStencilStateCreateInfo depthStencil{VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO};
         if (hasDepth) {
             depthStencil.depthTestEnable = VK_TRUE;
-            depthStencil.depthWriteEnable = VK_TRUE;
+            depthStencil.depthWriteEnable = desc.depthWrite ? VK_TRUE : VK_FALSE;
             depthStencil.depthCompareOp = VK_COMPARE_OP_GREATER_OR_EQUAL;
         }
 
@@ -1634,20 +1854,48 @@ public:
         pipelineInfo.pColorBlendState = &colorBlending;
         pipelineInfo.pDynamicState = &dynamicState;
         pipelineInfo.pDepthStencilState = hasDepth ? &depthStencil : nullptr;
-        if (m_features.descriptorBuffer) {
-            pipelineInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-        }
+        pipelineInfo.flags |= pipelineCreateFlags();
         pipelineInfo.layout = resource->layout;
         pipelineInfo.renderPass = VK_NULL_HANDLE;
 
+        // Per-pipeline cache key: SPIR-V plus every piece of state that changes the PSO.
+        uint64_t cacheKey = VulkanPipelineCacheManager::hashKey(source.data(), source.size());
+        const auto hashState = [&](const void* data, size_t size) {
+            cacheKey = VulkanPipelineCacheManager::hashKey(data, size, cacheKey);
+        };
+        for (const VkPipelineShaderStageCreateInfo& stage : stages) {
+            hashState(&stage.stage, sizeof(stage.stage));
+            hashState(stage.pName, std::strlen(stage.pName));
+        }
+        hashState(&colorFormat, sizeof(colorFormat));
+        hashState(&depthFormat, sizeof(depthFormat));
+        hashState(&pipelineInfo.flags, sizeof(pipelineInfo.flags));
+        hashState(vertexBindings.data(), vertexBindings.size() * sizeof(VkVertexInputBindingDescription));
+        hashState(vertexAttributes.data(), vertexAttributes.size() * sizeof(VkVertexInputAttributeDescription));
+
         VkPipeline pipeline = VK_NULL_HANDLE;
+        VkResult result = VK_SUCCESS;
+        std::shared_ptr<VulkanPipelineLinkState> linkState;
         const auto t0gfx1 = std::chrono::high_resolution_clock::now();
-        const VkResult result = vkCreateGraphicsPipelines(m_device,
-                                                          m_pipelineCache.handle(),
-                                                          1,
-                                                          &pipelineInfo,
-                                                          nullptr,
-                                                          &pipeline);
+        if (m_pipelineLibraries.isEnabled()) {
+            // Library entries hold the shader library binaries, so they get their own keys.
+            const char kLibraryTag = 'L';
+            hashState(&kLibraryTag, sizeof(kLibraryTag));
+            VulkanPipelineCacheEntry cacheEntry = m_pipelineCache.beginEntry(cacheKey);
+            std::string linkError;
+            pipeline = m_pipelineLibraries.createLinkedPipeline(
+                pipelineInfo,
+                cacheEntry.cache != VK_NULL_HANDLE ? cacheEntry.cache : m_pipelineCache.handle(),
+                linkState,
+                linkError);
+            m_pipelineCache.endEntry(cacheEntry, pipeline != VK_NULL_HANDLE && !cacheEntry.loaded);
+            if (pipeline == VK_NULL_HANDLE) {
+                spdlog::warn("VulkanPipeline: {}; falling back to a monolithic pipeline", linkError);
+            }
+        }
+        if (pipeline == VK_NULL_HANDLE) {
+            result = m_pipelineCache.createGraphicsPipeline(cacheKey, pipelineInfo, pipeline);
+        }
         const double msGfx1 = std::chrono::duration<double, std::milli>(
             std::chrono::high_resolution_clock::now() - t0gfx1).count();
         vkDestroyShaderModule(m_device, shaderModule, nullptr);
@@ -1659,9 +1907,15 @@ public:
             return {};
         }
         m_pipelineCache.recordCompile(msGfx1, /*isGraphics=*/true);
-        spdlog::debug("VulkanPipeline: graphics pipeline compiled in {:.1f} ms", msGfx1);
+        spdlog::debug("VulkanPipeline: graphics pipeline {} in {:.1f} ms",
+                      linkState ? "fast-linked" : "compiled",
+                      msGfx1);
 
         resource->pipeline = pipeline;
+        if (linkState) {
+            resource->linkState = linkState;
+            m_pipelineLibraries.queueOptimizedLink(resource, std::move(linkState));
+        }
         if (resource->layout != VK_NULL_HANDLE) {
             std::string layoutName = "Graphics Pipeline Layout";
             vulkanSetObjectDebugName(m_device,
@@ -1707,7 +1961,8 @@ public:
 
         auto* resource = new VulkanPipelineResource{};
         resource->device = m_device;
-        if (!buildPipelineResourceLayout(m_device, source.data(), source.size(), *resource, errorMessage, m_features.descriptorBuffer)) {
+        if (!buildPipelineResourceLayout(m_device, source.data(), source.size(), *resource, errorMessage,
+                                         m_features.descriptorBuffer, m_limits.maxPushDescriptors)) {
             vkDestroyShaderModule(m_device, shaderModule, nullptr);
             delete resource;
             return {};
@@ -1719,18 +1974,14 @@ public:
         pipelineInfo.stage.module = shaderModule;
         pipelineInfo.stage.pName = "main";
         pipelineInfo.layout = resource->layout;
-        if (m_features.descriptorBuffer) {
-            pipelineInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
-        }
+        pipelineInfo.flags |= pipelineCreateFlags();
+
+        uint64_t cacheKey = VulkanPipelineCacheManager::hashKey(source.data(), source.size());
+        cacheKey = VulkanPipelineCacheManager::hashKey(&pipelineInfo.flags, sizeof(pipelineInfo.flags), cacheKey);
 
         VkPipeline pipeline = VK_NULL_HANDLE;
         const auto t0cmp = std::chrono::high_resolution_clock::now();
-        const VkResult result = vkCreateComputePipelines(m_device,
-                                                         m_pipelineCache.handle(),
-                                                         1,
-                                                         &pipelineInfo,
-                                                         nullptr,
-                                                         &pipeline);
+        const VkResult result = m_pipelineCache.createComputePipeline(cacheKey, pipelineInfo, pipeline);
         const double msCmp = std::chrono::duration<double, std::milli>(
             std::chrono::high_resolution_clock::now() - t0cmp).count();
         vkDestroyShaderModule(m_device, shaderModule, nullptr);
@@ -1758,6 +2009,86 @@ public:
         return RhiComputePipelineHandle(resource);
     }
 
+    std::vector<RhiPipelineExecutableStats> pipelineExecutableStats(const RhiGraphicsPipeline& pipeline) override {
+        const VulkanPipelineResource* resource = getVulkanPipelineResource(pipeline);
+        return queryPipelineExecutableStats(resource ? resource->pipeline : VK_NULL_HANDLE);
+    }
+
+    std::vector<RhiPipelineExecutableStats> pipelineExecutableStats(const RhiComputePipeline& pipeline) override {
+        const VulkanPipelineResource* resource = getVulkanPipelineResource(pipeline);
+        return queryPipelineExecutableStats(resource ? resource->pipeline : VK_NULL_HANDLE);
+    }
+
+    RhiComputePipelineHandle createRayTracingPipelineFromSource(const std::string& source,
+                                                                const RhiRayTracingPipelineSourceDesc& desc,
+                                                                std::string& errorMessage) override {
+        if (!m_features.rayTracingPipeline) {
+            errorMessage = "Ray tracing pipelines are not supported on this device";
+            return {};
+        }
+        if (!desc.rayGenEntry || desc.closestHitEntries.empty()) {
+            errorMessage = "Ray tracing pipeline needs a ray generation entry and at least one hit group";
+            return {};
+        }
+        if (source.empty() || (source.size() % sizeof(uint32_t)) != 0) {
+            errorMessage = "SPIR-V source is empty or not aligned to 4 bytes";
+            return {};
+        }
+
+        // The reflected layout uses VK_SHADER_STAGE_ALL, so the descriptor manager
+        // binds it for ray tracing stages the same way it does for compute.
+        auto* resource = new VulkanPipelineResource{};
+        resource->device = m_device;
+        if (!buildPipelineResourceLayout(m_device, source.data(), source.size(), *resource, errorMessage,
+                                         m_features.descriptorBuffer, m_limits.maxPushDescriptors)) {
+            delete resource;
+            return {};
+        }
+
+        RtPipelineDesc rtDesc;
+        rtDesc.shaderCode = source.data();
+        rtDesc.shaderCodeSize = source.size();
+        rtDesc.rayGenEntry = desc.rayGenEntry;
+        for (const char* entry : desc.missEntries) {
+            rtDesc.missEntries.emplace_back(entry);
+        }
+        for (const char* entry : desc.closestHitEntries) {
+            RtShaderGroupDesc group;
+            group.type = RtShaderGroupType::TrianglesHit;
+            group.closestHitEntry = entry;
+            rtDesc.hitGroups.push_back(std::move(group));
+        }
+        rtDesc.hitRecordGroups = desc.hitRecordGroups;
+        rtDesc.maxRecursionDepth = std::min(std::max(desc.maxRecursionDepth, 1u),
+                                            std::max(m_rtPipelineProperties.maxRayRecursionDepth, 1u));
+        rtDesc.layout = resource->layout;
+
+        std::unique_ptr<VulkanRayTracingPipeline> pipeline =
+            createVulkanRayTracingPipelineImpl(m_device,
+                                               m_physicalDevice,
+                                               m_allocator,
+                                               m_pipelineCache.handle(),
+                                               rtDesc,
+                                               m_rtPipelineProperties.shaderGroupHandleSize,
+                                               m_rtPipelineProperties.shaderGroupHandleAlignment,
+                                               m_rtPipelineProperties.shaderGroupBaseAlignment,
+                                               errorMessage,
+                                               m_features.descriptorBuffer);
+        if (!pipeline) {
+            destroyPipelineLayouts(*resource);
+            delete resource;
+            return {};
+        }
+        resource->rayTracing = std::shared_ptr<VulkanRayTracingPipeline>(std::move(pipeline));
+        if (resource->layout != VK_NULL_HANDLE) {
+            vulkanSetObjectDebugName(m_device,
+                                     VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+                                     vkObjectHandle(resource->layout),
+                                     "Ray Tracing Pipeline Layout");
+        }
+        return RhiComputePipelineHandle(resource);
+    }
+
     VkImage currentSwapchainImage() const {
         return m_imageIndex < m_swapchainImages.size() ? m_swapchainImages[m_imageIndex] : VK_NULL_HANDLE;
     }
@@ -1782,18 +2113,29 @@ public:
         return m_frames[m_frameIndex].computeCommandBuffer;
     }
 
-    // End and submit the async compute command buffer to the dedicated compute queue.
-    // Uses a timeline semaphore signal if available; otherwise a simple submit.
-    // Returns the timeline value to wait on (0 if no timeline semaphore).
+    // End the trailing async compute segment. With timeline semaphores it is submitted
+    // together with the other segments in endFrame(), and the final graphics batch waits
+    // for it; otherwise it is submitted immediately. Returns the timeline value to wait on
+    // (0 if no timeline semaphore).
     uint64_t scheduleAsyncComputeSubmit() {
         if (m_deviceLost) {
             return 0;
         }
-        const FrameResources& frame = m_frames[m_frameIndex];
+        FrameResources& frame = m_frames[m_frameIndex];
         if (frame.computeCommandBuffer == VK_NULL_HANDLE || m_computeQueue == VK_NULL_HANDLE) {
             return 0;
         }
 
+        if (supportsQueueSegments()) {
+            if (!closeComputeSegment(frame)) {
+                return 0;
+            }
+            frame.computeCommandBuffer = VK_NULL_HANDLE;
+            m_graphicsSegmentWaitValue =
+                std::max(m_graphicsSegmentWaitValue, m_lastClosedComputeSignalValue);
+            return m_lastClosedComputeSignalValue;
+        }
+
         if (!handleRuntimeResult(vkEndCommandBuffer(frame.computeCommandBuffer),
                                  "Failed to end async compute command buffer")) {
             return 0;
@@ -1825,6 +2167,56 @@ public:
         return signalValue;
     }
 
+    bool supportsQueueSegments() const {
+        return m_computeQueue != VK_NULL_HANDLE &&
+               m_computeTimelineSemaphore != VK_NULL_HANDLE &&
+               m_graphicsTimelineSemaphore != VK_NULL_HANDLE;
+    }
+
+    uint32_t computeQueueFamily() const {
+        return m_queueFamilies.compute.value_or(m_queueFamilies.graphics.value_or(0));
+    }
+
+    // Closes the open graphics and async compute segments and opens new ones, so work
+    // recorded afterwards on the other queue waits for everything recorded so far on
+    // 'fromAsyncCompute's queue. Work on the source queue keeps its submission order.
+    bool splitQueueSegments(bool fromAsyncCompute) {
+        if (m_deviceLost || !supportsQueueSegments()) {
+            return false;
+        }
+        FrameResources& frame = m_frames[m_frameIndex];
+        if (frame.computeCommandBuffer == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        if (!handleRuntimeResult(vkEndCommandBuffer(frame.commandBuffer),
+                                 "Failed to end graphics queue segment")) {
+            return false;
+        }
+        QueueSegment graphicsSegment{};
+        graphicsSegment.commandBuffer = frame.commandBuffer;
+        graphicsSegment.waitValue = m_graphicsSegmentWaitValue;
+        graphicsSegment.signalValue = ++m_graphicsTimelineValue;
+        m_closedGraphicsSegments.push_back(graphicsSegment);
+
+        if (!closeComputeSegment(frame)) {
+            return false;
+        }
+
+        if (fromAsyncCompute) {
+            m_graphicsSegmentWaitValue = m_lastClosedComputeSignalValue;
+            m_computeSegmentWaitValue = 0;
+        } else {
+            m_computeSegmentWaitValue = graphicsSegment.signalValue;
+            m_graphicsSegmentWaitValue = 0;
+        }
+
+        return openQueueSegment(frame.commandPool, frame.graphicsSegments, frame.graphicsSegmentCount,
+                                frame.commandBuffer) &&
+               openQueueSegment(frame.computeCommandPool, frame.computeSegments, frame.computeSegmentCount,
+                                frame.computeCommandBuffer);
+    }
+
     bool hasEnabledExtension(const char* extensionName) const {
         return std::any_of(m_enabledExtensions.begin(), m_enabledExtensions.end(),
                            [extensionName](const std::string& ext) { return ext == extensionName; });
@@ -1874,7 +2266,7 @@ public:
         vmaInfo.size = desc.size;
         vmaInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         vmaInfo.usage = vulkanEnableBufferDeviceAddress(vmaInfo.usage, m_features.bufferDeviceAddress);
-        vmaInfo.hostVisible = desc.hostVisible;
+        vulkanApplyBufferMemory(vmaInfo, desc.memory);
         vmaInfo.sharedWithTransferQueue = desc.sharedWithTransferQueue;
         vmaInfo.graphicsQueueFamily = m_queueFamilies.graphics.value_or(0);
         vmaInfo.transferQueueFamily = m_queueFamilies.transfer.value_or(UINT32_MAX);
@@ -1888,7 +2280,7 @@ public:
         }
 
         if (desc.initialData) {
-            if (!desc.hostVisible) {
+            if (!vmaInfo.hostVisible) {
                 throw std::runtime_error("Device-local uploads are not implemented yet for Vulkan vertex buffers.");
             }
             if (!resource->mappedData) {
@@ -2064,6 +2456,24 @@ public:
         return vkAcquireNextImageKHR(device, swapchain, timeout, semaphore, fence, imageIndex);
     }
 
+    // Leaves one present queued behind the one just submitted; waiting on the latest
+    // would serialise CPU recording with scan-out.
+    bool waitForPresentLatency() {
+        if (!m_lowLatencyPresentWait || m_swapchain == VK_NULL_HANDLE || m_presentId < 2u) {
+            return true;
+        }
+
+        constexpr uint64_t kPresentWaitTimeoutNs = 100ull * 1000ull * 1000ull;
+        const VkResult result =
+            m_vkWaitForPresentKHR(m_device, m_swapchain, m_presentId - 1u, kPresentWaitTimeoutNs);
+        if (result == VK_ERROR_DEVICE_LOST) {
+            markDeviceLost("vkWaitForPresentKHR reported device lost");
+            return false;
+        }
+        // Timeouts and out-of-date swapchains fall through to the acquire path.
+        return true;
+    }
+
     VkResult queuePresentKHR(VkQueue queue, const VkPresentInfoKHR* presentInfo) const {
         if (m_vkQueuePresentKHRProxy) {
             return m_vkQueuePresentKHRProxy(queue, presentInfo);
@@ -2071,16 +2481,179 @@ public:
         return vkQueuePresentKHR(queue, presentInfo);
     }
 
+    struct ParallelRecordingPool {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers;
+        uint32_t usedCount = 0;
+    };
+
     struct FrameResources {
         VkCommandPool commandPool = VK_NULL_HANDLE;
-        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE; // open graphics segment
         VkSemaphore imageAvailable = VK_NULL_HANDLE;
         VkFence inFlight = VK_NULL_HANDLE;
         VkCommandPool computeCommandPool = VK_NULL_HANDLE;
-        VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE; // open async compute segment
         uint64_t lastSubmittedGraphicsSerial = 0u;
+        // Command buffers reused by queue segments; element 0 is allocated with the frame.
+        std::vector<VkCommandBuffer> graphicsSegments;
+        std::vector<VkCommandBuffer> computeSegments;
+        uint32_t graphicsSegmentCount = 1u;
+        uint32_t computeSegmentCount = 1u;
+        // Secondary command buffers for parallel frame graph recording, one pool per slot.
+        std::vector<ParallelRecordingPool> parallelPools;
+    };
+
+    // A closed command buffer waiting for endFrame(). waitValue is the other queue's
+    // timeline value it depends on (0 for none).
+    struct QueueSegment {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t waitValue = 0;
+        uint64_t signalValue = 0;
     };
 
+    void resetQueueSegments(FrameResources& frame) {
+        m_closedGraphicsSegments.clear();
+        m_closedComputeSegments.clear();
+        m_graphicsSegmentWaitValue = 0;
+        m_computeSegmentWaitValue = 0;
+        m_lastClosedComputeSignalValue = 0;
+        frame.graphicsSegmentCount = 1u;
+        frame.computeSegmentCount = 1u;
+        if (!frame.graphicsSegments.empty()) {
+            frame.commandBuffer = frame.graphicsSegments[0];
+        }
+        if (!frame.computeSegments.empty()) {
+            frame.computeCommandBuffer = frame.computeSegments[0];
+        }
+    }
+
+    bool openQueueSegment(VkCommandPool pool,
+                          std::vector<VkCommandBuffer>& segments,
+                          uint32_t& segmentCount,
+                          VkCommandBuffer& commandBuffer) {
+        if (segmentCount == segments.size()) {
+            VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocInfo.commandPool = pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            VkCommandBuffer segment = VK_NULL_HANDLE;
+            if (!handleRuntimeResult(vkAllocateCommandBuffers(m_device, &allocInfo, &segment),
+                                     "Failed to allocate queue segment command buffer")) {
+                return false;
+            }
+            segments.push_back(segment);
+        }
+        commandBuffer = segments[segmentCount++];
+
+        VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        return handleRuntimeResult(vkBeginCommandBuffer(commandBuffer, &beginInfo),
+                                   "Failed to begin queue segment command buffer");
+    }
+
+    bool closeComputeSegment(FrameResources& frame) {
+        if (!handleRuntimeResult(vkEndCommandBuffer(frame.computeCommandBuffer),
+                                 "Failed to end async compute segment")) {
+            return false;
+        }
+        QueueSegment segment{};
+        segment.commandBuffer = frame.computeCommandBuffer;
+        segment.waitValue = m_computeSegmentWaitValue;
+        segment.signalValue = ++m_computeTimelineValue;
+        m_closedComputeSegments.push_back(segment);
+        m_lastClosedComputeSignalValue = segment.signalValue;
+        return true;
+    }
+
+    bool submitClosedComputeSegments() {
+        if (m_closedComputeSegments.empty()) {
+            return true;
+        }
+
+        const size_t batchCount = m_closedComputeSegments.size();
+        std::vector<VkCommandBufferSubmitInfo> cmdInfos(
+            batchCount, VkCommandBufferSubmitInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO});
+        std::vector<VkSemaphoreSubmitInfo> waitInfos(
+            batchCount, VkSemaphoreSubmitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO});
+        std::vector<VkSemaphoreSubmitInfo> signalInfos(
+            batchCount, VkSemaphoreSubmitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO});
+        std::vector<VkSubmitInfo2> submitInfos(batchCount, VkSubmitInfo2{VK_STRUCTURE_TYPE_SUBMIT_INFO_2});
+        for (size_t batch = 0; batch < batchCount; ++batch) {
+            const QueueSegment& segment = m_closedComputeSegments[batch];
+            cmdInfos[batch].commandBuffer = segment.commandBuffer;
+            signalInfos[batch].semaphore = m_computeTimelineSemaphore;
+            signalInfos[batch].value = segment.signalValue;
+            signalInfos[batch].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+            VkSubmitInfo2& submitInfo = submitInfos[batch];
+            submitInfo.commandBufferInfoCount = 1;
+            submitInfo.pCommandBufferInfos = &cmdInfos[batch];
+            submitInfo.signalSemaphoreInfoCount = 1;
+            submitInfo.pSignalSemaphoreInfos = &signalInfos[batch];
+            if (segment.waitValue != 0u) {
+                waitInfos[batch].semaphore = m_graphicsTimelineSemaphore;
+                waitInfos[batch].value = segment.waitValue;
+                waitInfos[batch].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                submitInfo.waitSemaphoreInfoCount = 1;
+                submitInfo.pWaitSemaphoreInfos = &waitInfos[batch];
+            }
+        }
+
+        const bool submitted = handleRuntimeResult(
+            vkQueueSubmit2(m_computeQueue, static_cast<uint32_t>(batchCount), submitInfos.data(), VK_NULL_HANDLE),
+            "Failed to submit async compute queue");
+        m_closedComputeSegments.clear();
+        return submitted;
+    }
+
+    // Begins a secondary command buffer from slot's pool. Only one thread may record
+    // from a slot at a time; all slots are reset with the frame.
+    VkCommandBuffer beginParallelCommandBuffer(uint32_t slot) {
+        if (m_deviceLost) {
+            return VK_NULL_HANDLE;
+        }
+        FrameResources& frame = m_frames[m_frameIndex];
+        while (frame.parallelPools.size() <= slot) {
+            VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_queueFamilies.graphics.value();
+            ParallelRecordingPool pool;
+            if (!handleRuntimeResult(vkCreateCommandPool(m_device, &poolInfo, nullptr, &pool.commandPool),
+                                     "Failed to create parallel recording command pool")) {
+                return VK_NULL_HANDLE;
+            }
+            frame.parallelPools.push_back(std::move(pool));
+        }
+
+        ParallelRecordingPool& pool = frame.parallelPools[slot];
+        if (pool.usedCount == pool.commandBuffers.size()) {
+            VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocInfo.commandPool = pool.commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            if (!handleRuntimeResult(vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer),
+                                     "Failed to allocate parallel recording command buffer")) {
+                return VK_NULL_HANDLE;
+            }
+            pool.commandBuffers.push_back(commandBuffer);
+        }
+        VkCommandBuffer commandBuffer = pool.commandBuffers[pool.usedCount++];
+
+        // Each secondary begins and ends its own dynamic rendering instances, so nothing
+        // is inherited from the primary.
+        VkCommandBufferInheritanceInfo inheritanceInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+        VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        if (!handleRuntimeResult(vulkanBeginCommandBufferHooked(commandBuffer, &beginInfo),
+                                 "Failed to begin parallel recording command buffer")) {
+            return VK_NULL_HANDLE;
+        }
+        return commandBuffer;
+    }
+
     struct QueuedSemaphoreWait {
         VkSemaphore semaphore = VK_NULL_HANDLE;
         uint64_t value = 0;
@@ -2256,7 +2829,7 @@ public:
                                      vkObjectHandle(m_pipelineCache.handle()),
                                      "Metallic Pipeline Cache");
         }
-        for (uint32_t i = 0; i < kMaxFramesInFlight; ++i) {
+        for (uint32_t i = 0; i < m_framesInFlight; ++i) {
             const std::string poolName = "Frame " + std::to_string(i) + " Graphics Command Pool";
             const std::string cmdName = "Frame " + std::to_string(i) + " Graphics Command Buffer";
             const std::string imageAvailableName = "Frame " + std::to_string(i) + " Image Available";
@@ -2335,6 +2908,12 @@ public:
                                      vkObjectHandle(m_computeTimelineSemaphore),
                                      "Async Compute Timeline");
         }
+        if (m_graphicsTimelineSemaphore != VK_NULL_HANDLE) {
+            vulkanSetObjectDebugName(m_device,
+                                     VK_OBJECT_TYPE_SEMAPHORE,
+                                     vkObjectHandle(m_graphicsTimelineSemaphore),
+                                     "Graphics Segment Timeline");
+        }
         if (m_transferTimelineSemaphore != VK_NULL_HANDLE) {
             vulkanSetObjectDebugName(m_device,
                                      VK_OBJECT_TYPE_SEMAPHORE,
@@ -2444,6 +3023,7 @@ public:
                 m_deviceInfo.adapterName = m_physicalDeviceProperties.deviceName;
                 m_deviceInfo.driverName = vkVersionString(m_physicalDeviceProperties.driverVersion);
                 m_deviceInfo.apiVersion = m_physicalDeviceProperties.apiVersion;
+                m_deviceInfo.vendorID = m_physicalDeviceProperties.vendorID;
                 return;
             }
         }
@@ -2485,6 +3065,9 @@ public:
             m_limits.maxMeshOutputPrimitives = meshProps.maxMeshOutputPrimitives;
             m_limits.maxMeshWorkGroupInvocations = meshProps.maxMeshWorkGroupInvocations;
             m_limits.maxTaskWorkGroupInvocations = meshProps.maxTaskWorkGroupInvocations;
+            m_limits.maxPreferredMeshWorkGroupInvocations = meshProps.maxPreferredMeshWorkGroupInvocations;
+            m_limits.maxTaskPayloadSize = meshProps.maxTaskPayloadSize;
+            m_limits.maxMeshSharedMemorySize = meshProps.maxMeshSharedMemorySize;
         }
 
         // Descriptors
@@ -2499,6 +3082,16 @@ public:
         m_limits.maxDescriptorSetStorageBuffers = vkLimits.maxDescriptorSetStorageBuffers;
         m_limits.maxDescriptorSetSampledImages = vkLimits.maxDescriptorSetSampledImages;
         m_limits.maxDescriptorSetStorageImages = vkLimits.maxDescriptorSetStorageImages;
+        if (m_features.pushDescriptors) {
+            VkPhysicalDevicePushDescriptorPropertiesKHR pushDescriptorProps{
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR};
+            VkPhysicalDeviceProperties2 props2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+            props2.pNext = &pushDescriptorProps;
+            vkGetPhysicalDeviceProperties2(m_physicalDevice, &props2);
+            m_limits.maxPushDescriptors = pushDescriptorProps.maxPushDescriptors;
+            spdlog::info("Vulkan: push descriptors enabled (maxPushDescriptors={})",
+                         m_limits.maxPushDescriptors);
+        }
 
         // Memory
         m_limits.nonCoherentAtomSize = vkLimits.nonCoherentAtomSize;
@@ -2650,6 +3243,8 @@ public:
             hasExtension(extensions, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
         const bool descriptorBufferAvailable =
             hasExtension(extensions, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        const bool pushDescriptorAvailable =
+            hasExtension(extensions, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
         const bool shaderAtomicInt64Available =
             hasExtension(extensions, VK_KHR_SHADER_ATOMIC_INT64_EXTENSION_NAME) ||
             properties.apiVersion >= VK_API_VERSION_1_2;
@@ -2658,8 +3253,23 @@ public:
             properties.apiVersion >= VK_API_VERSION_1_3;
         const bool robustness2Available =
             hasExtension(extensions, VK_EXT_ROBUSTNESS_2_EXTENSION_NAME);
+        const bool graphicsPipelineLibraryAvailable =
+            hasExtension(extensions, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+            hasExtension(extensions, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        const bool pipelineCreationCacheControlAvailable =
+            hasExtension(extensions, VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME) ||
+            properties.apiVersion >= VK_API_VERSION_1_3;
+        const bool presentWaitAvailable =
+            hasExtension(extensions, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+            hasExtension(extensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        const bool invocationReorderAvailable =
+            hasExtension(extensions, VK_NV_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME);
         m_memoryBudgetAvailable = hasExtension(extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
         m_deviceFaultAvailable = hasExtension(extensions, VK_EXT_DEVICE_FAULT_EXTENSION_NAME);
+        const bool pipelineExecutablePropertiesAvailable =
+            hasExtension(extensions, VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+        const bool performanceQueryAvailable =
+            hasExtension(extensions, VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
         m_diagnosticCheckpointsAvailable =
             hasExtension(extensions, VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME);
         m_diagnosticsConfigAvailable =
@@ -2690,6 +3300,20 @@ public:
             VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT};
         VkPhysicalDeviceRobustness2FeaturesEXT robustness2Features{
             VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT};
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+        VkPhysicalDevicePipelineCreationCacheControlFeatures cacheControlFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES};
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+        VkPhysicalDeviceRayTracingInvocationReorderFeaturesNV invocationReorderFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_FEATURES_NV};
+        VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR pipelineExecutableFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR};
+        VkPhysicalDevicePerformanceQueryFeaturesKHR performanceQueryFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR};
         VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
         features2.pNext = &vulkan11Features;
         vulkan11Features.pNext = &vulkan12Features;
@@ -2707,6 +3331,31 @@ public:
         accelerationStructureFeatures.pNext = &descriptorBufferFeatures;
         descriptorBufferFeatures.pNext =
             robustness2Available ? static_cast<void*>(&robustness2Features) : nullptr;
+        if (graphicsPipelineLibraryAvailable) {
+            graphicsPipelineLibraryFeatures.pNext = features2.pNext;
+            features2.pNext = &graphicsPipelineLibraryFeatures;
+        }
+        if (pipelineCreationCacheControlAvailable) {
+            cacheControlFeatures.pNext = features2.pNext;
+            features2.pNext = &cacheControlFeatures;
+        }
+        if (presentWaitAvailable) {
+            presentWaitFeatures.pNext = features2.pNext;
+            presentIdFeatures.pNext = &presentWaitFeatures;
+            features2.pNext = &presentIdFeatures;
+        }
+        if (invocationReorderAvailable) {
+            invocationReorderFeatures.pNext = features2.pNext;
+            features2.pNext = &invocationReorderFeatures;
+        }
+        if (pipelineExecutablePropertiesAvailable) {
+            pipelineExecutableFeatures.pNext = features2.pNext;
+            features2.pNext = &pipelineExecutableFeatures;
+        }
+        if (performanceQueryAvailable) {
+            performanceQueryFeatures.pNext = features2.pNext;
+            features2.pNext = &performanceQueryFeatures;
+        }
         vkGetPhysicalDeviceFeatures2(device, &features2);
 
         if (dynamicRenderingFeatures.dynamicRendering != VK_TRUE ||
@@ -2723,6 +3372,14 @@ public:
         m_toolingInfo.pipelineStatistics = features2.features.pipelineStatisticsQuery == VK_TRUE;
         m_toolingInfo.deviceFault = m_deviceFaultAvailable;
         m_toolingInfo.diagnosticCheckpoints = m_diagnosticCheckpointsAvailable;
+        m_toolingInfo.pipelineExecutableStats =
+            pipelineExecutablePropertiesAvailable &&
+            pipelineExecutableFeatures.pipelineExecutableInfo == VK_TRUE;
+        // Performance query pools are reset from the host between frames.
+        m_toolingInfo.performanceQuery =
+            performanceQueryAvailable &&
+            performanceQueryFeatures.performanceCounterQueryPools == VK_TRUE &&
+            vulkan12Features.hostQueryReset == VK_TRUE;
 
         m_features.dynamicRendering = true;
         m_features.synchronization2 = true;
@@ -2744,19 +3401,31 @@ public:
             m_features.rayTracing &&
             rayTracingPipelineAvailable &&
             rayTracingPipelineFeatures.rayTracingPipeline == VK_TRUE;
+        m_features.rayTracingInvocationReorder =
+            m_features.rayTracingPipeline &&
+            invocationReorderAvailable &&
+            invocationReorderFeatures.rayTracingInvocationReorder == VK_TRUE;
         m_features.externalHostMemory = externalMemoryHostAvailable;
+        m_features.presentWait =
+            presentWaitAvailable &&
+            presentIdFeatures.presentId == VK_TRUE &&
+            presentWaitFeatures.presentWait == VK_TRUE;
         m_features.descriptorBuffer =
             descriptorBufferAvailable &&
             descriptorBufferFeatures.descriptorBuffer == VK_TRUE;
+        // The descriptor buffer path already writes descriptors without pools.
+        m_features.pushDescriptors = pushDescriptorAvailable && !m_features.descriptorBuffer;
         m_features.shaderBufferInt64Atomics =
             shaderAtomicInt64Available &&
             vulkan12Features.shaderBufferInt64Atomics == VK_TRUE;
+        m_features.shaderFloat16 = vulkan12Features.shaderFloat16 == VK_TRUE;
         m_storageBuffer16BitAccessEnabled = vulkan11Features.storageBuffer16BitAccess == VK_TRUE;
         m_uniformAndStorageBuffer8BitAccessEnabled =
             vulkan12Features.uniformAndStorageBuffer8BitAccess == VK_TRUE;
         m_uniformAndStorageBuffer16BitAccessEnabled =
             vulkan11Features.uniformAndStorageBuffer16BitAccess == VK_TRUE;
         m_shaderInt64Enabled = features2.features.shaderInt64 == VK_TRUE;
+        m_textureCompressionBCEnabled = features2.features.textureCompressionBC == VK_TRUE;
         m_subgroupSizeControlAvailable = subgroupSizeControlAvailable;
         m_subgroupSizeControlSupported =
             subgroupSizeControlAvailable &&
@@ -2768,6 +3437,23 @@ public:
         m_nullDescriptorEnabled =
             robustness2Available &&
             robustness2Features.nullDescriptor == VK_TRUE;
+        m_pipelineCreationCacheControlSupported =
+            pipelineCreationCacheControlAvailable &&
+            cacheControlFeatures.pipelineCreationCacheControl == VK_TRUE;
+
+        // Without fast linking a library link can cost as much as a full compile, so
+        // the library path is only worth taking when the driver advertises it.
+        m_features.graphicsPipelineLibrary = false;
+        if (graphicsPipelineLibraryAvailable &&
+            graphicsPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE) {
+            VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphicsPipelineLibraryProps{
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT};
+            VkPhysicalDeviceProperties2 props2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+            props2.pNext = &graphicsPipelineLibraryProps;
+            vkGetPhysicalDeviceProperties2(device, &props2);
+            m_features.graphicsPipelineLibrary =
+                graphicsPipelineLibraryProps.graphicsPipelineLibraryFastLinking == VK_TRUE;
+        }
 
         // Query RT pipeline properties when supported.
         if (m_features.rayTracingPipeline) {
@@ -2822,12 +3508,18 @@ public:
         if (m_features.rayTracingPipeline) {
             deviceExtensions.push_back(VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME);
         }
+        if (m_features.rayTracingInvocationReorder) {
+            deviceExtensions.push_back(VK_NV_RAY_TRACING_INVOCATION_REORDER_EXTENSION_NAME);
+        }
         if (m_features.externalHostMemory) {
             deviceExtensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
         }
         if (m_features.descriptorBuffer) {
             deviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
         }
+        if (m_features.pushDescriptors) {
+            deviceExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+        }
         if (m_memoryBudgetAvailable) {
             deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
         }
@@ -2843,9 +3535,34 @@ public:
         if (m_nullDescriptorEnabled) {
             deviceExtensions.push_back(VK_EXT_ROBUSTNESS_2_EXTENSION_NAME);
         }
+        if (!createInfo.enablePipelineLibraries) {
+            m_features.graphicsPipelineLibrary = false;
+        }
+        if (m_features.graphicsPipelineLibrary) {
+            deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        }
+        if (m_pipelineCreationCacheControlSupported &&
+            m_physicalDeviceProperties.apiVersion < VK_API_VERSION_1_3) {
+            deviceExtensions.push_back(VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME);
+        }
         if (m_deviceFaultAvailable) {
             deviceExtensions.push_back(VK_EXT_DEVICE_FAULT_EXTENSION_NAME);
         }
+        if (!createInfo.capturePipelineStatistics) {
+            m_toolingInfo.pipelineExecutableStats = false;
+            m_toolingInfo.performanceQuery = false;
+        }
+        if (m_toolingInfo.pipelineExecutableStats) {
+            deviceExtensions.push_back(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+        }
+        if (m_toolingInfo.performanceQuery) {
+            deviceExtensions.push_back(VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME);
+        }
+        if (m_features.presentWait) {
+            deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
         if (m_diagnosticCheckpointsAvailable) {
             deviceExtensions.push_back(VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME);
         }
@@ -2923,6 +3640,29 @@ public:
             VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT};
         robustness2Features.nullDescriptor = m_nullDescriptorEnabled ? VK_TRUE : VK_FALSE;
 
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+        graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+
+        VkPhysicalDevicePipelineCreationCacheControlFeatures cacheControlFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES};
+        cacheControlFeatures.pipelineCreationCacheControl = VK_TRUE;
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+        presentIdFeatures.presentId = VK_TRUE;
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+        presentWaitFeatures.presentWait = VK_TRUE;
+        VkPhysicalDeviceRayTracingInvocationReorderFeaturesNV invocationReorderFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_INVOCATION_REORDER_FEATURES_NV};
+        invocationReorderFeatures.rayTracingInvocationReorder = VK_TRUE;
+        VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR pipelineExecutableFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR};
+        pipelineExecutableFeatures.pipelineExecutableInfo = VK_TRUE;
+        VkPhysicalDevicePerformanceQueryFeaturesKHR performanceQueryFeatures{
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR};
+        performanceQueryFeatures.performanceCounterQueryPools = VK_TRUE;
+
         void* optionalFeatureChain = nullptr;
         if (m_features.rayTracing) {
             optionalFeatureChain = &accelerationStructureFeatures;
@@ -2949,6 +3689,31 @@ public:
             robustness2Features.pNext = sync2Features.pNext;
             sync2Features.pNext = &robustness2Features;
         }
+        if (m_features.graphicsPipelineLibrary) {
+            graphicsPipelineLibraryFeatures.pNext = sync2Features.pNext;
+            sync2Features.pNext = &graphicsPipelineLibraryFeatures;
+        }
+        if (m_pipelineCreationCacheControlSupported) {
+            cacheControlFeatures.pNext = sync2Features.pNext;
+            sync2Features.pNext = &cacheControlFeatures;
+        }
+        if (m_features.presentWait) {
+            presentWaitFeatures.pNext = sync2Features.pNext;
+            presentIdFeatures.pNext = &presentWaitFeatures;
+            sync2Features.pNext = &presentIdFeatures;
+        }
+        if (m_features.rayTracingInvocationReorder) {
+            invocationReorderFeatures.pNext = sync2Features.pNext;
+            sync2Features.pNext = &invocationReorderFeatures;
+        }
+        if (m_toolingInfo.pipelineExecutableStats) {
+            pipelineExecutableFeatures.pNext = sync2Features.pNext;
+            sync2Features.pNext = &pipelineExecutableFeatures;
+        }
+        if (m_toolingInfo.performanceQuery) {
+            performanceQueryFeatures.pNext = sync2Features.pNext;
+            sync2Features.pNext = &performanceQueryFeatures;
+        }
 
         VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES};
         dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
@@ -2968,13 +3733,16 @@ public:
             m_features.shaderBufferInt64Atomics ? VK_TRUE : VK_FALSE;
         vulkan12Features.uniformAndStorageBuffer8BitAccess =
             m_uniformAndStorageBuffer8BitAccessEnabled ? VK_TRUE : VK_FALSE;
+        vulkan12Features.shaderFloat16 = m_features.shaderFloat16 ? VK_TRUE : VK_FALSE;
         vulkan12Features.timelineSemaphore =
             (createInfo.enableTimelineSemaphore && m_timelineSemaphoreSupported) ? VK_TRUE : VK_FALSE;
+        vulkan12Features.hostQueryReset = m_toolingInfo.performanceQuery ? VK_TRUE : VK_FALSE;
         vulkan11Features.pNext = &vulkan12Features;
 
         VkPhysicalDeviceFeatures2 features2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
         features2.features.pipelineStatisticsQuery = m_toolingInfo.pipelineStatistics ? VK_TRUE : VK_FALSE;
         features2.features.shaderInt64 = m_shaderInt64Enabled ? VK_TRUE : VK_FALSE;
+        features2.features.textureCompressionBC = m_textureCompressionBCEnabled ? VK_TRUE : VK_FALSE;
         if (createInfo.enableTimelineSemaphore && m_timelineSemaphoreSupported) {
             m_features.timelineSemaphore = true;
         } else {
@@ -3021,6 +3789,8 @@ public:
             vkGetDeviceQueue(m_device, m_queueFamilies.transfer.value(), 0, &m_transferQueue);
             spdlog::info("Vulkan: dedicated transfer queue (family {})", m_queueFamilies.transfer.value());
         }
+        m_features.asyncComputeQueue = m_computeQueue != VK_NULL_HANDLE;
+        m_features.transferQueue = m_transferQueue != VK_NULL_HANDLE;
 
         vulkanSetObjectDebugName(m_device,
                                  VK_OBJECT_TYPE_DEVICE,
@@ -3048,10 +3818,11 @@ public:
         }
 
         if (m_features.rayTracingPipeline) {
-            spdlog::info("Vulkan: ray tracing pipeline enabled (handleSize={}, baseAlign={}, maxRecursion={})",
+            spdlog::info("Vulkan: ray tracing pipeline enabled (handleSize={}, baseAlign={}, maxRecursion={}, reorder={})",
                          m_rtPipelineProperties.shaderGroupHandleSize,
                          m_rtPipelineProperties.shaderGroupBaseAlignment,
-                         m_rtPipelineProperties.maxRayRecursionDepth);
+                         m_rtPipelineProperties.maxRayRecursionDepth,
+                         m_features.rayTracingInvocationReorder);
         }
         if (m_nullDescriptorEnabled) {
             spdlog::info("Vulkan: null descriptors enabled via VK_EXT_robustness2");
@@ -3059,7 +3830,7 @@ public:
     }
 
     void createCommandObjects() {
-        for (size_t i = 0; i < kMaxFramesInFlight; ++i) {
+        for (size_t i = 0; i < m_framesInFlight; ++i) {
             VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
             poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
             poolInfo.queueFamilyIndex = m_queueFamilies.graphics.value();
@@ -3072,6 +3843,7 @@ public:
             allocInfo.commandBufferCount = 1;
             checkVk(vkAllocateCommandBuffers(m_device, &allocInfo, &m_frames[i].commandBuffer),
                     "Failed to allocate Vulkan command buffer");
+            m_frames[i].graphicsSegments.push_back(m_frames[i].commandBuffer);
 
             VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
             VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
@@ -3096,6 +3868,7 @@ public:
                 computeAllocInfo.commandBufferCount = 1;
                 checkVk(vkAllocateCommandBuffers(m_device, &computeAllocInfo, &m_frames[i].computeCommandBuffer),
                         "Failed to allocate Vulkan async compute command buffer");
+                m_frames[i].computeSegments.push_back(m_frames[i].computeCommandBuffer);
             }
         }
 
@@ -3109,6 +3882,9 @@ public:
         if (m_computeQueue != VK_NULL_HANDLE && m_features.timelineSemaphore) {
             checkVk(vkCreateSemaphore(m_device, &timelineSemaphoreInfo, nullptr, &m_computeTimelineSemaphore),
                     "Failed to create compute timeline semaphore");
+            // Signalled by graphics queue segments that async compute work waits on.
+            checkVk(vkCreateSemaphore(m_device, &timelineSemaphoreInfo, nullptr, &m_graphicsTimelineSemaphore),
+                    "Failed to create graphics timeline semaphore");
         }
         if (m_transferQueue != VK_NULL_HANDLE && m_features.timelineSemaphore) {
             checkVk(vkCreateSemaphore(m_device, &timelineSemaphoreInfo, nullptr, &m_transferTimelineSemaphore),
@@ -3147,8 +3923,10 @@ public:
             return;
         }
 
-        waitIdle();
-        cleanupSwapchain();
+        // The old swapchain, its views and present semaphores may still be referenced by
+        // frames in flight; retire them by serial instead of draining the device. The
+        // next frame's submission also covers presents queued against the old images.
+        VkSwapchainKHR oldSwapchain = retireSwapchain();
 
         const SwapchainSupportDetails support = querySwapchainSupport(m_physicalDevice, m_surface);
         if (support.formats.empty() || support.presentModes.empty()) {
@@ -3159,7 +3937,7 @@ public:
         const VkPresentModeKHR presentMode = choosePresentMode(support.presentModes);
         m_swapchainExtent = chooseSwapExtent(support.capabilities, m_requestedWidth, m_requestedHeight);
 
-        uint32_t imageCount = support.capabilities.minImageCount + 1;
+        uint32_t imageCount = std::max(support.capabilities.minImageCount + 1, m_framesInFlight);
         if (support.capabilities.maxImageCount > 0 && imageCount > support.capabilities.maxImageCount) {
             imageCount = support.capabilities.maxImageCount;
         }
@@ -3186,7 +3964,7 @@ public:
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = oldSwapchain;
 
         checkVk(vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapchain),
                 "Failed to create Vulkan swapchain");
@@ -3200,6 +3978,8 @@ public:
         m_swapchainImageLayouts.assign(createdImageCount, VK_IMAGE_LAYOUT_UNDEFINED);
         m_swapchainRenderFinished.resize(createdImageCount, VK_NULL_HANDLE);
         m_imagesInFlight.assign(createdImageCount, VK_NULL_HANDLE);
+        // Present IDs are per swapchain.
+        m_presentId = 0;
 
         for (size_t i = 0; i < m_swapchainImages.size(); ++i) {
             VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
@@ -3247,6 +4027,178 @@ public:
         }
     }
 
+    VkSwapchainKHR retireSwapchain() {
+        RetiredSwapchain retired;
+        retired.swapchain = m_swapchain;
+        retired.imageViews = std::move(m_swapchainImageViews);
+        retired.renderFinished = std::move(m_swapchainRenderFinished);
+        retired.releaseSerial = m_submittedFrameCounter + 1u;
+        m_swapchain = VK_NULL_HANDLE;
+        m_swapchainImageViews.clear();
+        m_swapchainRenderFinished.clear();
+        m_swapchainImages.clear();
+        m_swapchainImageLayouts.clear();
+        m_imagesInFlight.clear();
+        if (retired.swapchain == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+        const VkSwapchainKHR oldSwapchain = retired.swapchain;
+        m_retiredSwapchains.push_back(std::move(retired));
+        return oldSwapchain;
+    }
+
+    void destroyRetiredSwapchains(uint64_t completedSerial) {
+        m_retiredSwapchains.erase(
+            std::remove_if(m_retiredSwapchains.begin(),
+                           m_retiredSwapchains.end(),
+                           [&](const RetiredSwapchain& retired) {
+                               if (retired.releaseSerial > completedSerial) {
+                                   return false;
+                               }
+                               for (VkImageView imageView : retired.imageViews) {
+                                   if (imageView != VK_NULL_HANDLE) {
+                                       vkDestroyImageView(m_device, imageView, nullptr);
+                                   }
+                               }
+                               for (VkSemaphore renderFinished : retired.renderFinished) {
+                                   if (renderFinished != VK_NULL_HANDLE) {
+                                       vkDestroySemaphore(m_device, renderFinished, nullptr);
+                                   }
+                               }
+                               vkDestroySwapchainKHR(m_device, retired.swapchain, nullptr);
+                               return true;
+                           }),
+            m_retiredSwapchains.end());
+    }
+
+    // Releases run in submission order; a release may itself defer more work.
+    void runDeferredReleases(uint64_t completedSerial) {
+        size_t ready = 0;
+        while (ready < m_deferredReleases.size() &&
+               m_deferredReleases[ready].first <= completedSerial) {
+            ++ready;
+        }
+        if (ready == 0) {
+            return;
+        }
+        std::vector<std::pair<uint64_t, std::function<void()>>> releases(
+            std::make_move_iterator(m_deferredReleases.begin()),
+            std::make_move_iterator(m_deferredReleases.begin() + static_cast<std::ptrdiff_t>(ready)));
+        m_deferredReleases.erase(m_deferredReleases.begin(),
+                                 m_deferredReleases.begin() + static_cast<std::ptrdiff_t>(ready));
+        for (auto& [serial, release] : releases) {
+            release();
+        }
+    }
+
+    // Flags every graphics and compute pipeline is created with. Capturing statistics
+    // is part of the pipeline cache key, so toggling it never loads a stale binary.
+    VkPipelineCreateFlags pipelineCreateFlags() const {
+        VkPipelineCreateFlags flags = 0;
+        if (m_features.descriptorBuffer) {
+            flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+        if (m_toolingInfo.pipelineExecutableStats) {
+            flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+        }
+        return flags;
+    }
+
+    std::vector<RhiPipelineExecutableStats> queryPipelineExecutableStats(VkPipeline pipeline) const {
+        std::vector<RhiPipelineExecutableStats> executables;
+        if (!m_toolingInfo.pipelineExecutableStats || pipeline == VK_NULL_HANDLE) {
+            return executables;
+        }
+
+        VkPipelineInfoKHR pipelineInfo{VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR};
+        pipelineInfo.pipeline = pipeline;
+        uint32_t executableCount = 0;
+        if (m_vkGetPipelineExecutablePropertiesKHR(m_device, &pipelineInfo, &executableCount, nullptr) != VK_SUCCESS) {
+            return executables;
+        }
+        std::vector<VkPipelineExecutablePropertiesKHR> properties(
+            executableCount, VkPipelineExecutablePropertiesKHR{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_PROPERTIES_KHR});
+        if (m_vkGetPipelineExecutablePropertiesKHR(m_device, &pipelineInfo, &executableCount, properties.data()) !=
+            VK_SUCCESS) {
+            return executables;
+        }
+
+        executables.reserve(executableCount);
+        for (uint32_t executableIndex = 0; executableIndex < executableCount; ++executableIndex) {
+            RhiPipelineExecutableStats& executable = executables.emplace_back();
+            executable.name = properties[executableIndex].name;
+            executable.subgroupSize = properties[executableIndex].subgroupSize;
+
+            VkPipelineExecutableInfoKHR executableInfo{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR};
+            executableInfo.pipeline = pipeline;
+            executableInfo.executableIndex = executableIndex;
+            uint32_t statisticCount = 0;
+            if (m_vkGetPipelineExecutableStatisticsKHR(m_device, &executableInfo, &statisticCount, nullptr) !=
+                VK_SUCCESS) {
+                continue;
+            }
+            std::vector<VkPipelineExecutableStatisticKHR> statistics(
+                statisticCount, VkPipelineExecutableStatisticKHR{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR});
+            if (m_vkGetPipelineExecutableStatisticsKHR(m_device, &executableInfo, &statisticCount, statistics.data()) !=
+                VK_SUCCESS) {
+                continue;
+            }
+            executable.statistics.reserve(statisticCount);
+            for (const VkPipelineExecutableStatisticKHR& statistic : statistics) {
+                RhiShaderStatistic& out = executable.statistics.emplace_back();
+                out.name = statistic.name;
+                out.description = statistic.description;
+                switch (statistic.format) {
+                case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+                    out.value = statistic.value.b32 ? 1.0 : 0.0;
+                    break;
+                case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+                    out.value = static_cast<double>(statistic.value.i64);
+                    break;
+                case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+                    out.value = static_cast<double>(statistic.value.u64);
+                    break;
+                case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR:
+                    out.value = statistic.value.f64;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+        return executables;
+    }
+
+    // Resizable BAR exposes (nearly) all of VRAM as host-visible device-local memory.
+    // Without it such a type may still exist, but only as the legacy 256 MiB window.
+    bool detectResizableBar() const {
+        constexpr VkDeviceSize kLegacyBarWindow = 256ull * 1024ull * 1024ull;
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+        vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memoryProperties);
+
+        VkDeviceSize largestDeviceLocalHeap = 0;
+        for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; ++heapIndex) {
+            const VkMemoryHeap& heap = memoryProperties.memoryHeaps[heapIndex];
+            if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0) {
+                largestDeviceLocalHeap = std::max(largestDeviceLocalHeap, heap.size);
+            }
+        }
+
+        constexpr VkMemoryPropertyFlags kMappedVram =
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        for (uint32_t typeIndex = 0; typeIndex < memoryProperties.memoryTypeCount; ++typeIndex) {
+            const VkMemoryType& type = memoryProperties.memoryTypes[typeIndex];
+            if ((type.propertyFlags & kMappedVram) != kMappedVram) {
+                continue;
+            }
+            const VkDeviceSize heapSize = memoryProperties.memoryHeaps[type.heapIndex].size;
+            if (heapSize > kLegacyBarWindow && heapSize == largestDeviceLocalHeap) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     void refreshCompletedGraphicsSubmissionSerial() {
         if (m_device == VK_NULL_HANDLE || m_deviceLost) {
             return;
@@ -3269,6 +4221,22 @@ public:
         }
     }
 
+    // Trims the transient pool against the VRAM budget and occasionally compacts
+    // VMA blocks. Both are throttled; a session's allocations change slowly.
+    void maintainTransientPool() {
+        constexpr uint64_t kBudgetCheckInterval = 30;
+        constexpr uint64_t kDefragmentInterval = 600;
+        constexpr uint32_t kMaxDefragmentMoves = 16;
+        const uint64_t frameSerial = m_submittedFrameCounter + 1u;
+        if (frameSerial % kBudgetCheckInterval == 0) {
+            const VulkanMemoryBudgetInfo budget = getVulkanMemoryBudgetInfo(*this);
+            m_transientPool.trim(budget.available ? budget.deviceLocalHeadroomBytes : UINT64_MAX);
+        }
+        if (frameSerial % kDefragmentInterval == 0) {
+            m_transientPool.defragment(m_device, kMaxDefragmentMoves);
+        }
+    }
+
     void populateNativeHandles() {
         m_nativeHandles.instance = m_instance;
         m_nativeHandles.physicalDevice = m_physicalDevice;
@@ -3298,6 +4266,18 @@ public:
         if (m_features.bufferDeviceAddress) {
             allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
         }
+#ifdef METALLIC_TRACY_MEMORY
+        // Reports every VkDeviceMemory block VMA allocates or frees to one Tracy pool.
+        static const VmaDeviceMemoryCallbacks deviceMemoryCallbacks{
+            [](VmaAllocator, uint32_t, VkDeviceMemory memory, VkDeviceSize size, void*) {
+                METALLIC_TRACY_ALLOC(reinterpret_cast<void*>(memory), size, "VMA Device Memory");
+            },
+            [](VmaAllocator, uint32_t, VkDeviceMemory memory, VkDeviceSize, void*) {
+                METALLIC_TRACY_FREE(reinterpret_cast<void*>(memory), "VMA Device Memory");
+            },
+            nullptr};
+        allocatorInfo.pDeviceMemoryCallbacks = &deviceMemoryCallbacks;
+#endif
         checkVk(vmaCreateAllocator(&allocatorInfo, &m_allocator), "Failed to create VMA allocator");
     }
 
@@ -3349,8 +4329,16 @@ public:
     VkQueue m_transferQueue = VK_NULL_HANDLE;
     VkSemaphore m_computeTimelineSemaphore = VK_NULL_HANDLE;
     VkSemaphore m_transferTimelineSemaphore = VK_NULL_HANDLE;
+    VkSemaphore m_graphicsTimelineSemaphore = VK_NULL_HANDLE;
     uint64_t m_computeTimelineValue = 0;
     uint64_t m_transferTimelineValue = 0;
+    uint64_t m_graphicsTimelineValue = 0;
+    // Queue segments of the current frame (see splitQueueSegments).
+    std::vector<QueueSegment> m_closedGraphicsSegments;
+    std::vector<QueueSegment> m_closedComputeSegments;
+    uint64_t m_graphicsSegmentWaitValue = 0;
+    uint64_t m_computeSegmentWaitValue = 0;
+    uint64_t m_lastClosedComputeSignalValue = 0;
     QueueFamilyIndices m_queueFamilies;
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
     std::array<FrameResources, kMaxFramesInFlight> m_frames{};
@@ -3364,8 +4352,24 @@ public:
     std::vector<VkSemaphore> m_swapchainRenderFinished;
     std::vector<VkFence> m_imagesInFlight;
 
+    struct RetiredSwapchain {
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkSemaphore> renderFinished;
+        uint64_t releaseSerial = 0; // graphics serial after which nothing references it
+    };
+    std::vector<RetiredSwapchain> m_retiredSwapchains;
+    // {graphics serial, release}; serials are non-decreasing.
+    std::vector<std::pair<uint64_t, std::function<void()>>> m_deferredReleases;
+
+    uint32_t m_framesInFlight = 2;
     uint32_t m_frameIndex = 0;
     uint32_t m_imageIndex = 0;
+    uint64_t m_presentId = 0;
+    bool m_lowLatencyPresentWait = false;
+    PFN_vkWaitForPresentKHR m_vkWaitForPresentKHR = nullptr;
+    PFN_vkGetPipelineExecutablePropertiesKHR m_vkGetPipelineExecutablePropertiesKHR = nullptr;
+    PFN_vkGetPipelineExecutableStatisticsKHR m_vkGetPipelineExecutableStatisticsKHR = nullptr;
     uint64_t m_submittedFrameCounter = 0;
     uint64_t m_completedGraphicsSubmissionSerial = 0;
     uint32_t m_requestedWidth = 0;
@@ -3384,8 +4388,10 @@ public:
     bool m_subgroupSizeControlSupported = false;
     bool m_computeFullSubgroupsSupported = false;
     bool m_shaderInt64Enabled = false;
+    bool m_textureCompressionBCEnabled = false;
     bool m_timelineSemaphoreSupported = false;
     bool m_nullDescriptorEnabled = false;
+    bool m_pipelineCreationCacheControlSupported = false;
     std::string m_deviceLostMessage;
 
     RhiFeatures m_features{};
@@ -3399,6 +4405,7 @@ public:
     VulkanToolingInfo m_toolingInfo{};
     std::vector<std::string> m_enabledExtensions;
     VulkanPipelineCacheManager m_pipelineCache;
+    VulkanPipelineLibraryLinker m_pipelineLibraries;
     VulkanGpuProfiler m_gpuProfiler;
     VulkanUploadRing m_uploadRing;
     VulkanTransientPool m_transientPool;
@@ -3462,6 +4469,22 @@ uint64_t vulkanScheduleAsyncComputeSubmit(RhiContext& context) {
     return static_cast<VulkanContext&>(context).scheduleAsyncComputeSubmit();
 }
 
+bool vulkanSupportsQueueSegments(RhiContext& context) {
+    return static_cast<VulkanContext&>(context).supportsQueueSegments();
+}
+
+bool vulkanSplitQueueSegments(RhiContext& context, bool fromAsyncCompute) {
+    return static_cast<VulkanContext&>(context).splitQueueSegments(fromAsyncCompute);
+}
+
+uint32_t getVulkanComputeQueueFamily(RhiContext& context) {
+    return static_cast<VulkanContext&>(context).computeQueueFamily();
+}
+
+VkCommandBuffer vulkanBeginParallelCommandBuffer(RhiContext& context, uint32_t slot) {
+    return static_cast<VulkanContext&>(context).beginParallelCommandBuffer(slot);
+}
+
 void vulkanEnqueueGraphicsTimelineWait(RhiContext& context,
                                        VkSemaphore semaphore,
                                        uint64_t value,
@@ -3526,6 +4549,10 @@ VulkanMemoryBudgetInfo getVulkanMemoryBudgetInfo(RhiContext& context) {
     return budgetInfo;
 }
 
+VulkanMemoryTelemetry getVulkanMemoryTelemetry(RhiContext& context) {
+    return static_cast<VulkanContext&>(context).memoryTelemetry();
+}
+
 bool vulkanIsDeviceLost(RhiContext& context) {
     return static_cast<VulkanContext&>(context).isDeviceLost();
 }
@@ -31,9 +31,24 @@ VkImageLayout getVulkanCurrentBackbufferLayout(RhiContext& context);
 VkQueue getVulkanComputeQueue(RhiContext& context);             // nullptr if unavailable
 VkCommandBuffer getVulkanCurrentComputeCommandBuffer(RhiContext& context); // nullptr if unavailable
 
-// End async compute command buffer and submit to the dedicated compute queue.
+// End the async compute command buffer. With timeline semaphores the frame's final graphics
+// submission waits for it.
 // Returns the timeline semaphore signal value (0 if no timeline semaphore or no compute queue).
 uint64_t vulkanScheduleAsyncComputeSubmit(RhiContext& context);
+
+// Queue segments let the frame graph order work across the graphics and async compute
+// queues within one frame. Requires a dedicated compute queue and timeline semaphores.
+bool vulkanSupportsQueueSegments(RhiContext& context);
+// Closes the current graphics and async compute command buffers and opens new ones; work
+// recorded next on the other queue waits for the source queue's closed segment. All
+// segments are submitted in endFrame(). Refetch the current command buffers afterwards.
+bool vulkanSplitQueueSegments(RhiContext& context, bool fromAsyncCompute);
+uint32_t getVulkanComputeQueueFamily(RhiContext& context);
+
+// Begins a secondary command buffer for parallel frame graph recording from the current
+// frame's pool for 'slot'. Returns nullptr on failure.
+VkCommandBuffer vulkanBeginParallelCommandBuffer(RhiContext& context, uint32_t slot);
+
 void vulkanEnqueueGraphicsTimelineWait(RhiContext& context,
                                        VkSemaphore semaphore,
                                        uint64_t value,
@@ -46,6 +61,16 @@ struct VulkanPipelineCacheTelemetry {
     uint32_t graphicsPipelinesCompiled = 0;
     uint32_t computePipelinesCompiled = 0;
     double totalCompileMs = 0.0;
+    // Per-pipeline cache entries
+    uint32_t cacheEntryHits = 0;
+    uint32_t cacheEntryMisses = 0;
+    uint32_t cacheEntryStale = 0;      // found on disk but the driver still had to compile
+    uint32_t cacheEntriesRejected = 0; // failed validation and were deleted
+    uint32_t cacheEntriesWritten = 0;
+    bool pipelineLibrariesEnabled = false;
+    uint32_t pipelinesFastLinked = 0;
+    uint32_t pipelinesOptimized = 0;
+    uint32_t pipelinesAwaitingOptimization = 0;
 };
 
 struct VulkanMemoryBudgetInfo {
@@ -59,10 +84,37 @@ struct VulkanMemoryBudgetInfo {
     uint64_t deviceLocalHeadroomBytes = 0u;
 };
 
+// VMA block usage on device-local heaps plus transient pool and upload ring upkeep.
+struct VulkanMemoryTelemetry {
+    uint32_t deviceLocalBlockCount = 0;
+    uint32_t deviceLocalAllocationCount = 0;
+    uint64_t deviceLocalBlockBytes = 0u;
+    uint64_t deviceLocalAllocationBytes = 0u;
+    uint64_t pooledTransientBytes = 0u;
+    uint64_t maxPooledTransientBytes = 0u;
+    uint64_t evictedTransientBytes = 0u;
+    uint32_t defragmentedBuffers = 0;
+    uint64_t defragmentedBytes = 0u;
+    uint64_t uploadRingCapacityBytes = 0u;   // per frame slice
+    uint64_t uploadRingUsedBytes = 0u;       // last finished frame, overflow included
+    uint64_t uploadRingPeakBytes = 0u;
+    uint64_t uploadRingOverflowBytes = 0u;   // overflow chunks currently held
+    uint32_t uploadRingOverflowChunks = 0;
+    uint64_t uploadRingOverflowAllocations = 0u;
+
+    // Share of device-local block memory not backing any allocation.
+    double fragmentation() const {
+        return deviceLocalBlockBytes == 0u
+            ? 0.0
+            : 1.0 - static_cast<double>(deviceLocalAllocationBytes) / static_cast<double>(deviceLocalBlockBytes);
+    }
+};
+
 const VulkanGpuFrameDiagnostics& getVulkanLatestFrameDiagnostics(RhiContext& context);
 const VulkanToolingInfo& getVulkanToolingInfo(RhiContext& context);
 VulkanPipelineCacheTelemetry getVulkanPipelineCacheTelemetry(RhiContext& context);
 VulkanMemoryBudgetInfo getVulkanMemoryBudgetInfo(RhiContext& context);
+VulkanMemoryTelemetry getVulkanMemoryTelemetry(RhiContext& context);
 bool vulkanIsDeviceLost(RhiContext& context);
 const std::string& vulkanDeviceLostMessage(RhiContext& context);
 VulkanGpuProfiler* getVulkanGpuProfiler(RhiContext& context);
@@ -2,6 +2,7 @@
 
 #ifdef _WIN32
 
+#include "cpu_profile_zones.h"
 #include "rhi_resource_utils.h"
 #include "vulkan_resource_handles.h"
 
@@ -80,13 +81,19 @@ void VulkanDescriptorBufferManager::init(
     const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props,
     VkDeviceSize minUniformBufferOffsetAlignment,
     VkDeviceSize nonCoherentAtomSize,
-    VkDeviceSize maxUniformBufferRange) {
+    VkDeviceSize maxUniformBufferRange,
+    uint32_t framesInFlight) {
 
     m_device = device;
     m_allocator = allocator;
     m_uniformUploadAlignment = std::max<VkDeviceSize>(minUniformBufferOffsetAlignment, 16);
     m_nonCoherentAtomSize = std::max<VkDeviceSize>(nonCoherentAtomSize, 1);
     m_maxUniformBufferRange = maxUniformBufferRange;
+    // One transient buffer and one bindless copy per frame in flight; the first
+    // resetFrame() moves to slot 0.
+    m_frameCount = std::clamp(framesInFlight, 1u, static_cast<uint32_t>(m_frames.size()));
+    m_frameIndex = m_frameCount - 1u;
+    m_bindlessCopies.reset(m_frameCount);
 
     // Store descriptor sizes
     m_sampledImageDescSize = props.sampledImageDescriptorSize;
@@ -143,19 +150,21 @@ void VulkanDescriptorBufferManager::init(
         device, m_bindlessSetLayout, kVulkanBindlessAccelerationStructureBinding,
         &m_bindlessAccelerationStructureOffset);
 
-    // Create the persistent bindless descriptor buffer
+    // Create the persistent bindless descriptor buffer. The layout size is already
+    // aligned, so every copy starts at a valid descriptor buffer offset.
     m_bindlessBuffer = createDescriptorBufferVma(
-        device, allocator, m_bindlessSetLayoutSize,
+        device, allocator, m_bindlessSetLayoutSize * m_frameCount,
         &m_bindlessAllocation, &m_bindlessMapped, &m_bindlessBufferAddress,
         "BindlessDescriptorBuffer");
     if (m_bindlessBuffer == VK_NULL_HANDLE) {
         throw std::runtime_error("Failed to create bindless descriptor buffer");
     }
-    m_bindlessBufferSize = m_bindlessSetLayoutSize;
+    m_bindlessBufferSize = m_bindlessSetLayoutSize * m_frameCount;
     std::memset(m_bindlessMapped, 0, static_cast<size_t>(m_bindlessBufferSize));
 
     // Create per-frame transient descriptor buffers
-    for (auto& frame : m_frames) {
+    for (uint32_t frameIndex = 0; frameIndex < m_frameCount; ++frameIndex) {
+        FrameState& frame = m_frames[frameIndex];
         frame.descriptorCapacity = kDefaultTransientDescriptorBufferSize;
         frame.descriptorBuffer = createDescriptorBufferVma(
             device, allocator, frame.descriptorCapacity,
@@ -168,8 +177,8 @@ void VulkanDescriptorBufferManager::init(
     }
 
     spdlog::info("Vulkan: descriptor buffer manager initialized "
-                 "(bindlessSize={}, transientSize={}, alignment={})",
-                 m_bindlessSetLayoutSize, kDefaultTransientDescriptorBufferSize,
+                 "(bindlessSize={} x {}, transientSize={}, alignment={})",
+                 m_bindlessSetLayoutSize, m_frameCount, kDefaultTransientDescriptorBufferSize,
                  m_descriptorBufferOffsetAlignment);
 }
 
@@ -183,6 +192,8 @@ void VulkanDescriptorBufferManager::destroy() {
         m_bindlessBuffer = VK_NULL_HANDLE;
         m_bindlessAllocation = nullptr;
     }
+    m_bindlessMapped = nullptr;
+    m_bindlessCopies.reset(m_frameCount);
 
     if (m_bindlessSetLayout != VK_NULL_HANDLE) {
         vulkanReleaseBindlessSetLayout(m_device);
@@ -194,10 +205,18 @@ void VulkanDescriptorBufferManager::destroy() {
 }
 
 void VulkanDescriptorBufferManager::resetFrame() {
-    m_frameIndex = (m_frameIndex + 1) % static_cast<uint32_t>(m_frames.size());
+    m_frameIndex = (m_frameIndex + 1) % m_frameCount;
     FrameState& frame = currentFrame();
     frame.descriptorHead = 0;
     frame.uniformHead = 0;
+    // The frame that last read this bindless copy has retired; bring it up to date.
+    copyPendingBindlessWrites(m_frameIndex);
+}
+
+void VulkanDescriptorBufferManager::flushBindlessCopies() {
+    for (uint32_t copy = 0; copy < m_frameCount; ++copy) {
+        copyPendingBindlessWrites(copy);
+    }
 }
 
 PendingBufferBinding VulkanDescriptorBufferManager::uploadInlineUniformData(const void* data,
@@ -222,7 +241,7 @@ PendingBufferBinding VulkanDescriptorBufferManager::uploadInlineUniformData(cons
     }
 
     auto* dst = static_cast<std::byte*>(frame.uniformMapped) + alignedOffset;
-    std::memcpy(dst, data, size);
+    rhiWriteCombinedCopy(dst, data, size);
 
     const VkDeviceSize flushOffset = alignDown(alignedOffset, m_nonCoherentAtomSize);
     const VkDeviceSize flushSize =
@@ -239,7 +258,7 @@ PendingBufferBinding VulkanDescriptorBufferManager::uploadInlineUniformData(cons
     return binding;
 }
 
-// --- Bindless updates (write directly into persistent bindless descriptor buffer) ---
+// --- Bindless updates (write into the current frame's copy of the bindless buffer) ---
 
 void VulkanDescriptorBufferManager::updateBindlessSampledTextures(const RhiTexture* const* textures,
                                                                    uint32_t startIndex,
@@ -256,11 +275,12 @@ bool VulkanDescriptorBufferManager::updateBindlessSampledTexture(uint32_t index,
     const VkImageView imageView = getVulkanImageView(texture);
     if (imageView == VK_NULL_HANDLE) return false;
 
-    void* dst = static_cast<std::byte*>(m_bindlessMapped) +
+    void* dst = currentBindlessCopy() +
                 m_bindlessSampledImageOffset +
                 index * m_sampledImageDescSize;
     writeImageDescriptor(dst, imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                          VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, m_sampledImageDescSize);
+    m_bindlessCopies.recordWrite(kVulkanBindlessSampledImageBinding, index, m_frameIndex);
     return true;
 }
 
@@ -270,10 +290,11 @@ bool VulkanDescriptorBufferManager::updateBindlessSampler(uint32_t index,
     const VkSampler vkSampler = getVulkanSamplerHandle(sampler);
     if (vkSampler == VK_NULL_HANDLE) return false;
 
-    void* dst = static_cast<std::byte*>(m_bindlessMapped) +
+    void* dst = currentBindlessCopy() +
                 m_bindlessSamplerOffset +
                 index * m_samplerDescSize;
     writeSamplerDescriptor(dst, vkSampler);
+    m_bindlessCopies.recordWrite(kVulkanBindlessSamplerBinding, index, m_frameIndex);
     return true;
 }
 
@@ -283,11 +304,12 @@ bool VulkanDescriptorBufferManager::updateBindlessStorageImage(uint32_t index,
     const VkImageView imageView = getVulkanImageView(texture);
     if (imageView == VK_NULL_HANDLE) return false;
 
-    void* dst = static_cast<std::byte*>(m_bindlessMapped) +
+    void* dst = currentBindlessCopy() +
                 m_bindlessStorageImageOffset +
                 index * m_storageImageDescSize;
     writeImageDescriptor(dst, imageView, VK_IMAGE_LAYOUT_GENERAL,
                          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_storageImageDescSize);
+    m_bindlessCopies.recordWrite(kVulkanBindlessStorageImageBinding, index, m_frameIndex);
     return true;
 }
 
@@ -303,11 +325,12 @@ bool VulkanDescriptorBufferManager::updateBindlessStorageBuffer(uint32_t index,
     VkDeviceAddress address = resource->deviceAddress + offset;
     VkDeviceSize actualRange = (range == VK_WHOLE_SIZE) ? (resource->size - offset) : range;
 
-    void* dst = static_cast<std::byte*>(m_bindlessMapped) +
+    void* dst = currentBindlessCopy() +
                 m_bindlessStorageBufferOffset +
                 index * m_storageBufferDescSize;
     writeBufferDescriptor(dst, address, actualRange,
                           VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_storageBufferDescSize);
+    m_bindlessCopies.recordWrite(kVulkanBindlessStorageBufferBinding, index, m_frameIndex);
     return true;
 }
 
@@ -320,10 +343,11 @@ bool VulkanDescriptorBufferManager::updateBindlessAccelerationStructure(
         getVulkanAccelerationStructureDeviceAddress(accelerationStructure);
     if (address == 0) return false;
 
-    void* dst = static_cast<std::byte*>(m_bindlessMapped) +
+    void* dst = currentBindlessCopy() +
                 m_bindlessAccelerationStructureOffset +
                 index * m_accelerationStructureDescSize;
     writeAccelerationStructureDescriptor(dst, address);
+    m_bindlessCopies.recordWrite(kVulkanBindlessAccelerationStructureBinding, index, m_frameIndex);
     return true;
 }
 
@@ -338,6 +362,7 @@ void VulkanDescriptorBufferManager::flushAndBind(
     const std::array<PendingSamplerBinding, kMaxSamplerBindings>& samplers,
     const std::array<PendingAccelerationStructureBinding,
                      kMaxAccelerationStructureBindings>& accelerationStructures) {
+    METALLIC_CPU_ZONE("Descriptors", "DescriptorBuffer::FlushAndBind", METALLIC_CPU_ZONE_RECORDING);
 
     if (pipeline.layout == VK_NULL_HANDLE || pipeline.setLayouts.empty()) {
         return;
@@ -366,9 +391,9 @@ void VulkanDescriptorBufferManager::flushAndBind(
 
     for (uint32_t setIndex = 0; setIndex < pipeline.setLayouts.size(); ++setIndex) {
         if (hasBindlessSet && setIndex == pipeline.bindlessSetIndex) {
-            // Bindless set: use the persistent bindless buffer
+            // Bindless set: use this frame's copy of the persistent bindless buffer
             setEntries[setIndex].bufferIndex = bindlessBufferIdx;
-            setEntries[setIndex].offset = 0; // base of bindless buffer
+            setEntries[setIndex].offset = m_frameIndex * m_bindlessSetLayoutSize;
             setEntries[setIndex].valid = true;
             continue;
         }
@@ -539,7 +564,57 @@ void VulkanDescriptorBufferManager::flushAndBind(
 // --- Private helpers ---
 
 VulkanDescriptorBufferManager::FrameState& VulkanDescriptorBufferManager::currentFrame() {
-    return m_frames[m_frameIndex % static_cast<uint32_t>(m_frames.size())];
+    return m_frames[m_frameIndex % m_frameCount];
+}
+
+std::byte* VulkanDescriptorBufferManager::currentBindlessCopy() const {
+    return static_cast<std::byte*>(m_bindlessMapped) + m_frameIndex * m_bindlessSetLayoutSize;
+}
+
+bool VulkanDescriptorBufferManager::bindlessDescriptorRange(uint32_t binding,
+                                                            uint32_t arrayElement,
+                                                            VkDeviceSize& offset,
+                                                            VkDeviceSize& size) const {
+    switch (binding) {
+    case kVulkanBindlessSampledImageBinding:
+        offset = m_bindlessSampledImageOffset;
+        size = m_sampledImageDescSize;
+        break;
+    case kVulkanBindlessSamplerBinding:
+        offset = m_bindlessSamplerOffset;
+        size = m_samplerDescSize;
+        break;
+    case kVulkanBindlessStorageImageBinding:
+        offset = m_bindlessStorageImageOffset;
+        size = m_storageImageDescSize;
+        break;
+    case kVulkanBindlessStorageBufferBinding:
+        offset = m_bindlessStorageBufferOffset;
+        size = m_storageBufferDescSize;
+        break;
+    case kVulkanBindlessAccelerationStructureBinding:
+        offset = m_bindlessAccelerationStructureOffset;
+        size = m_accelerationStructureDescSize;
+        break;
+    default:
+        return false;
+    }
+    offset += arrayElement * size;
+    return true;
+}
+
+void VulkanDescriptorBufferManager::copyPendingBindlessWrites(uint32_t targetCopy) {
+    if (!m_bindlessMapped) return;
+
+    auto* base = static_cast<std::byte*>(m_bindlessMapped);
+    m_bindlessCopies.drain(targetCopy, [&](uint32_t binding, uint32_t arrayElement, uint32_t sourceCopy) {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        if (!bindlessDescriptorRange(binding, arrayElement, offset, size)) return;
+        std::memcpy(base + targetCopy * m_bindlessSetLayoutSize + offset,
+                    base + sourceCopy * m_bindlessSetLayoutSize + offset,
+                    static_cast<size_t>(size));
+    });
 }
 
 void VulkanDescriptorBufferManager::destroyFrameState(FrameState& frame) {
@@ -549,6 +624,7 @@ void VulkanDescriptorBufferManager::destroyFrameState(FrameState& frame) {
         frame.descriptorAllocation = nullptr;
     }
     if (frame.uniformBuffer != VK_NULL_HANDLE && m_allocator != nullptr) {
+        vulkanUntrackAllocation(frame.uniformAllocation);
         vmaDestroyBuffer(m_allocator, frame.uniformBuffer, frame.uniformAllocation);
         frame.uniformBuffer = VK_NULL_HANDLE;
         frame.uniformAllocation = nullptr;
@@ -564,6 +640,7 @@ bool VulkanDescriptorBufferManager::ensureFrameUniformUploadCapacity(FrameState&
     }
 
     if (frame.uniformBuffer != VK_NULL_HANDLE && frame.uniformAllocation != nullptr) {
+        vulkanUntrackAllocation(frame.uniformAllocation);
         vmaDestroyBuffer(m_allocator, frame.uniformBuffer, frame.uniformAllocation);
         frame.uniformBuffer = VK_NULL_HANDLE;
         frame.uniformAllocation = nullptr;
@@ -575,7 +652,7 @@ bool VulkanDescriptorBufferManager::ensureFrameUniformUploadCapacity(FrameState&
     bufferInfo.allocator = m_allocator;
     bufferInfo.size = nextPowerOf2(requiredSize);
     bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
-    bufferInfo.hostVisible = true;
+    vulkanApplyBufferMemory(bufferInfo, RhiBufferMemory::DynamicDeviceLocal);
     bufferInfo.debugName = "DescBufInlineUniformUpload";
 
     const char* errorMessage = nullptr;
@@ -589,7 +666,7 @@ bool VulkanDescriptorBufferManager::ensureFrameUniformUploadCapacity(FrameState&
     if (resource->mappedData == nullptr && resource->allocation != nullptr) {
         void* mappedData = nullptr;
         if (vmaMapMemory(m_allocator, resource->allocation, &mappedData) != VK_SUCCESS) {
-            vmaDestroyBuffer(m_allocator, resource->buffer, resource->allocation);
+            vmaDestroyBufferResource(*resource);
             spdlog::warn("Failed to map frame uniform upload buffer");
             return false;
         }
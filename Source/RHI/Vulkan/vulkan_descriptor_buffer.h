@@ -7,6 +7,7 @@
 #include <vulkan/vulkan.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 struct VmaAllocator_T;
@@ -30,7 +31,8 @@ public:
               const VkPhysicalDeviceDescriptorBufferPropertiesEXT& props,
               VkDeviceSize minUniformBufferOffsetAlignment,
               VkDeviceSize nonCoherentAtomSize,
-              VkDeviceSize maxUniformBufferRange);
+              VkDeviceSize maxUniformBufferRange,
+              uint32_t framesInFlight);
     void destroy();
 
     // --- IVulkanDescriptorBackend ---
@@ -50,6 +52,7 @@ public:
     bool updateBindlessAccelerationStructure(
         uint32_t index,
         const RhiAccelerationStructure* accelerationStructure) override;
+    void flushBindlessCopies() override;
 
     void flushAndBind(
         VkCommandBuffer cmd,
@@ -62,7 +65,7 @@ public:
                          kMaxAccelerationStructureBindings>& accelerationStructures) override;
 
 private:
-    // --- Bindless descriptor buffer (persistent, updated in-place) ---
+    // --- Bindless descriptor buffer (persistent, one set-sized copy per frame in flight) ---
     VkBuffer m_bindlessBuffer = VK_NULL_HANDLE;
     VmaAllocation m_bindlessAllocation = nullptr;
     void* m_bindlessMapped = nullptr;
@@ -78,6 +81,7 @@ private:
 
     VkDescriptorSetLayout m_bindlessSetLayout = VK_NULL_HANDLE;
     VkDeviceSize m_bindlessSetLayoutSize = 0;
+    VulkanBindlessCopyQueue m_bindlessCopies;
 
     // --- Per-frame transient descriptor buffer (for set 0 per-draw descriptors) ---
     struct FrameState {
@@ -95,7 +99,8 @@ private:
         VkDeviceSize uniformHead = 0;
         VkDeviceSize uniformCapacity = 0;
     };
-    std::array<FrameState, 2> m_frames{};
+    std::array<FrameState, kRhiMaxFramesInFlight> m_frames{};
+    uint32_t m_frameCount = 2;
     uint32_t m_frameIndex = 1;
 
     // Descriptor sizes from VkPhysicalDeviceDescriptorBufferPropertiesEXT
@@ -126,6 +131,12 @@ private:
     void destroyFrameState(FrameState& frame);
     bool ensureFrameUniformUploadCapacity(FrameState& frame, VkDeviceSize requiredSize);
     VkDeviceSize allocateTransientDescriptorSpace(VkDeviceSize size);
+    // Start of the current frame's bindless copy in m_bindlessMapped.
+    std::byte* currentBindlessCopy() const;
+    // Byte offset and size of one bindless descriptor within a copy.
+    bool bindlessDescriptorRange(uint32_t binding, uint32_t arrayElement,
+                                 VkDeviceSize& offset, VkDeviceSize& size) const;
+    void copyPendingBindlessWrites(uint32_t targetCopy);
     void writeImageDescriptor(void* dst, VkImageView imageView, VkImageLayout layout,
                               VkDescriptorType type, VkDeviceSize descSize);
     void writeSamplerDescriptor(void* dst, VkSampler sampler);
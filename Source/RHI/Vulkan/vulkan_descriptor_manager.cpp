@@ -2,6 +2,7 @@
 
 #ifdef _WIN32
 
+#include "cpu_profile_zones.h"
 #include "rhi_resource_utils.h"
 #include "vulkan_resource_handles.h"
 
@@ -56,17 +57,18 @@ VkDescriptorPool createDescriptorPool(VkDevice device) {
     return pool;
 }
 
-VkDescriptorPool createBindlessDescriptorPool(VkDevice device) {
+VkDescriptorPool createBindlessDescriptorPool(VkDevice device, uint32_t setCount) {
     std::array<VkDescriptorPoolSize, 5> poolSizes = {{
-        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, kVulkanBindlessMaxSampledImages},
-        {VK_DESCRIPTOR_TYPE_SAMPLER, kVulkanBindlessMaxSamplers},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kVulkanBindlessMaxStorageImages},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kVulkanBindlessMaxStorageBuffers},
-        {VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, kVulkanBindlessMaxAccelerationStructures},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, setCount * kVulkanBindlessMaxSampledImages},
+        {VK_DESCRIPTOR_TYPE_SAMPLER, setCount * kVulkanBindlessMaxSamplers},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount * kVulkanBindlessMaxStorageImages},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount * kVulkanBindlessMaxStorageBuffers},
+        {VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+         setCount * kVulkanBindlessMaxAccelerationStructures},
     }};
 
     VkDescriptorPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    poolInfo.maxSets = 1;
+    poolInfo.maxSets = setCount;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
 
@@ -161,13 +163,22 @@ void VulkanDescriptorManager::init(VkDevice device,
                                    VmaAllocator allocator,
                                    VkDeviceSize minUniformBufferOffsetAlignment,
                                    VkDeviceSize nonCoherentAtomSize,
-                                   VkDeviceSize maxUniformBufferRange) {
+                                   VkDeviceSize maxUniformBufferRange,
+                                   uint32_t framesInFlight) {
     m_device = device;
     m_physicalDevice = physicalDevice;
     m_allocator = allocator;
     m_uniformUploadAlignment = std::max<VkDeviceSize>(minUniformBufferOffsetAlignment, 16);
     m_nonCoherentAtomSize = std::max<VkDeviceSize>(nonCoherentAtomSize, 1);
     m_maxUniformBufferRange = maxUniformBufferRange;
+    // One transient pool and one bindless copy per frame in flight; the first
+    // resetFrame() moves to slot 0.
+    m_frameCount = std::clamp(framesInFlight, 1u, static_cast<uint32_t>(m_frames.size()));
+    m_frameIndex = m_frameCount - 1u;
+    m_bindlessCopies.reset(m_frameCount);
+    // Null unless VK_KHR_push_descriptor was enabled; layouts only use push sets then.
+    m_vkCmdPushDescriptorSetKHR = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+        vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR"));
     createPools();
 
     std::string errorMessage;
@@ -177,14 +188,16 @@ void VulkanDescriptorManager::init(VkDevice device,
                                      : errorMessage);
     }
 
-    m_bindlessPool = createBindlessDescriptorPool(m_device);
+    m_bindlessPool = createBindlessDescriptorPool(m_device, m_frameCount);
 
     VkDescriptorSetAllocateInfo allocInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
     allocInfo.descriptorPool = m_bindlessPool;
     allocInfo.descriptorSetCount = 1;
     allocInfo.pSetLayouts = &m_bindlessSetLayout;
-    checkVk(vkAllocateDescriptorSets(m_device, &allocInfo, &m_bindlessSet),
-            "Failed to allocate bindless descriptor set");
+    for (uint32_t frameIndex = 0; frameIndex < m_frameCount; ++frameIndex) {
+        checkVk(vkAllocateDescriptorSets(m_device, &allocInfo, &m_frames[frameIndex].bindlessSet),
+                "Failed to allocate bindless descriptor set");
+    }
 }
 
 void VulkanDescriptorManager::destroy() {
@@ -196,24 +209,59 @@ void VulkanDescriptorManager::destroy() {
         vkDestroyDescriptorPool(m_device, m_bindlessPool, nullptr);
         m_bindlessPool = VK_NULL_HANDLE;
     }
-    m_bindlessSet = VK_NULL_HANDLE;
+    for (auto& frame : m_frames) {
+        frame.bindlessSet = VK_NULL_HANDLE;
+    }
+    m_bindlessCopies.reset(m_frameCount);
     if (m_bindlessSetLayout != VK_NULL_HANDLE) {
         vulkanReleaseBindlessSetLayout(m_device);
         m_bindlessSetLayout = VK_NULL_HANDLE;
     }
+    m_vkCmdPushDescriptorSetKHR = nullptr;
     m_allocator = nullptr;
     m_physicalDevice = VK_NULL_HANDLE;
     m_device = VK_NULL_HANDLE;
 }
 
 void VulkanDescriptorManager::resetFrame() {
-    m_frameIndex = (m_frameIndex + 1) % static_cast<uint32_t>(m_frames.size());
+    m_frameIndex = (m_frameIndex + 1) % m_frameCount;
 
     FrameState& frame = currentFrame();
     if (frame.pool != VK_NULL_HANDLE) {
         vkResetDescriptorPool(m_device, frame.pool, 0);
     }
     frame.uniformUpload.head = 0;
+    // The frame that last bound this copy has retired, so it can take the writes it missed.
+    copyPendingBindlessWrites(m_frameIndex);
+}
+
+void VulkanDescriptorManager::flushBindlessCopies() {
+    for (uint32_t copy = 0; copy < m_frameCount; ++copy) {
+        copyPendingBindlessWrites(copy);
+    }
+}
+
+void VulkanDescriptorManager::copyPendingBindlessWrites(uint32_t targetCopy) {
+    const VkDescriptorSet dstSet = m_frames[targetCopy].bindlessSet;
+    if (dstSet == VK_NULL_HANDLE) {
+        return;
+    }
+
+    std::vector<VkCopyDescriptorSet> copies;
+    m_bindlessCopies.drain(targetCopy, [&](uint32_t binding, uint32_t arrayElement, uint32_t sourceCopy) {
+        VkCopyDescriptorSet copy{VK_STRUCTURE_TYPE_COPY_DESCRIPTOR_SET};
+        copy.srcSet = m_frames[sourceCopy].bindlessSet;
+        copy.srcBinding = binding;
+        copy.srcArrayElement = arrayElement;
+        copy.dstSet = dstSet;
+        copy.dstBinding = binding;
+        copy.dstArrayElement = arrayElement;
+        copy.descriptorCount = 1;
+        copies.push_back(copy);
+    });
+    if (!copies.empty()) {
+        vkUpdateDescriptorSets(m_device, 0, nullptr, static_cast<uint32_t>(copies.size()), copies.data());
+    }
 }
 
 PendingBufferBinding VulkanDescriptorManager::uploadInlineUniformData(const void* data, size_t size) {
@@ -239,7 +287,7 @@ PendingBufferBinding VulkanDescriptorManager::uploadInlineUniformData(const void
     }
 
     std::byte* dst = static_cast<std::byte*>(frame.uniformUpload.mappedData) + alignedOffset;
-    std::memcpy(dst, data, size);
+    rhiWriteCombinedCopy(dst, data, size);
 
     const VkDeviceSize flushOffset = alignDown(alignedOffset, m_nonCoherentAtomSize);
     const VkDeviceSize flushSize =
@@ -269,7 +317,7 @@ void VulkanDescriptorManager::updateBindlessSampledTextures(const RhiTexture* co
 }
 
 bool VulkanDescriptorManager::updateBindlessSampledTexture(uint32_t index, const RhiTexture* texture) {
-    if (m_bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxSampledImages) {
+    if (currentFrame().bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxSampledImages) {
         return false;
     }
 
@@ -283,18 +331,19 @@ bool VulkanDescriptorManager::updateBindlessSampledTexture(uint32_t index, const
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
     VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    write.dstSet = m_bindlessSet;
+    write.dstSet = currentFrame().bindlessSet;
     write.dstBinding = kVulkanBindlessSampledImageBinding;
     write.dstArrayElement = index;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
     write.pImageInfo = &imageInfo;
     vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    m_bindlessCopies.recordWrite(write.dstBinding, index, m_frameIndex);
     return true;
 }
 
 bool VulkanDescriptorManager::updateBindlessSampler(uint32_t index, const RhiSampler* sampler) {
-    if (m_bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxSamplers) {
+    if (currentFrame().bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxSamplers) {
         return false;
     }
 
@@ -307,18 +356,19 @@ bool VulkanDescriptorManager::updateBindlessSampler(uint32_t index, const RhiSam
     imageInfo.sampler = vkSampler;
 
     VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    write.dstSet = m_bindlessSet;
+    write.dstSet = currentFrame().bindlessSet;
     write.dstBinding = kVulkanBindlessSamplerBinding;
     write.dstArrayElement = index;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
     write.pImageInfo = &imageInfo;
     vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    m_bindlessCopies.recordWrite(write.dstBinding, index, m_frameIndex);
     return true;
 }
 
 bool VulkanDescriptorManager::updateBindlessStorageImage(uint32_t index, const RhiTexture* texture) {
-    if (m_bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxStorageImages) {
+    if (currentFrame().bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxStorageImages) {
         return false;
     }
 
@@ -332,13 +382,14 @@ bool VulkanDescriptorManager::updateBindlessStorageImage(uint32_t index, const R
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    write.dstSet = m_bindlessSet;
+    write.dstSet = currentFrame().bindlessSet;
     write.dstBinding = kVulkanBindlessStorageImageBinding;
     write.dstArrayElement = index;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
     write.pImageInfo = &imageInfo;
     vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    m_bindlessCopies.recordWrite(write.dstBinding, index, m_frameIndex);
     return true;
 }
 
@@ -346,7 +397,7 @@ bool VulkanDescriptorManager::updateBindlessStorageBuffer(uint32_t index,
                                                           const RhiBuffer* buffer,
                                                           VkDeviceSize offset,
                                                           VkDeviceSize range) {
-    if (m_bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxStorageBuffers) {
+    if (currentFrame().bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxStorageBuffers) {
         return false;
     }
 
@@ -361,20 +412,21 @@ bool VulkanDescriptorManager::updateBindlessStorageBuffer(uint32_t index,
     bufferInfo.range = range == VK_WHOLE_SIZE ? resource->size - offset : range;
 
     VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    write.dstSet = m_bindlessSet;
+    write.dstSet = currentFrame().bindlessSet;
     write.dstBinding = kVulkanBindlessStorageBufferBinding;
     write.dstArrayElement = index;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     write.pBufferInfo = &bufferInfo;
     vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    m_bindlessCopies.recordWrite(write.dstBinding, index, m_frameIndex);
     return true;
 }
 
 bool VulkanDescriptorManager::updateBindlessAccelerationStructure(
     uint32_t index,
     const RhiAccelerationStructure* accelerationStructure) {
-    if (m_bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxAccelerationStructures) {
+    if (currentFrame().bindlessSet == VK_NULL_HANDLE || index >= kVulkanBindlessMaxAccelerationStructures) {
         return false;
     }
 
@@ -391,12 +443,13 @@ bool VulkanDescriptorManager::updateBindlessAccelerationStructure(
 
     VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
     write.pNext = &accelerationInfo;
-    write.dstSet = m_bindlessSet;
+    write.dstSet = currentFrame().bindlessSet;
     write.dstBinding = kVulkanBindlessAccelerationStructureBinding;
     write.dstArrayElement = index;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
     vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    m_bindlessCopies.recordWrite(write.dstBinding, index, m_frameIndex);
     return true;
 }
 
@@ -409,6 +462,7 @@ void VulkanDescriptorManager::flushAndBind(
     const std::array<PendingSamplerBinding, kMaxSamplerBindings>& samplers,
     const std::array<PendingAccelerationStructureBinding,
                      kMaxAccelerationStructureBindings>& accelerationStructures) {
+    METALLIC_CPU_ZONE("Descriptors", "DescriptorSets::FlushAndBind", METALLIC_CPU_ZONE_RECORDING);
 
     if (pipeline.layout == VK_NULL_HANDLE || pipeline.setLayouts.empty()) {
         return;
@@ -423,16 +477,27 @@ void VulkanDescriptorManager::flushAndBind(
     transientSetIndices.reserve(pipeline.setLayouts.size());
 
     const bool pipelineUsesBindlessSet =
-        pipeline.bindlessSetIndex < pipeline.setLayouts.size() && m_bindlessSet != VK_NULL_HANDLE;
+        pipeline.bindlessSetIndex < pipeline.setLayouts.size() && frame.bindlessSet != VK_NULL_HANDLE;
     if (pipeline.bindlessSetIndex < pipeline.setLayouts.size() && !pipelineUsesBindlessSet) {
         spdlog::warn("Pipeline expects bindless set {}, but the global bindless set is unavailable",
                      pipeline.bindlessSetIndex);
         return;
     }
 
+    const uint32_t pushSetIndex = pipeline.pushDescriptorSetIndex;
+    const bool pipelineUsesPushSet = pushSetIndex < pipeline.setLayouts.size();
+    if (pipelineUsesPushSet && m_vkCmdPushDescriptorSetKHR == nullptr) {
+        spdlog::warn("Pipeline expects push descriptor set {}, but vkCmdPushDescriptorSetKHR is unavailable",
+                     pushSetIndex);
+        return;
+    }
+
     for (uint32_t setIndex = 0; setIndex < pipeline.setLayouts.size(); ++setIndex) {
         if (pipelineUsesBindlessSet && setIndex == pipeline.bindlessSetIndex) {
-            boundSets[setIndex] = m_bindlessSet;
+            boundSets[setIndex] = frame.bindlessSet;
+            continue;
+        }
+        if (pipelineUsesPushSet && setIndex == pushSetIndex) {
             continue;
         }
 
@@ -471,10 +536,29 @@ void VulkanDescriptorManager::flushAndBind(
     std::vector<VkWriteDescriptorSetAccelerationStructureKHR> accelerationInfos;
     accelerationInfos.reserve(kMaxAccelerationStructureBindings);
 
+    // Writes for the push set are recorded into the command buffer instead of
+    // updating a pool set; dstSet is ignored for them.
+    std::vector<VkWriteDescriptorSet> pushWrites;
+    auto writableSet = [&](const VulkanDescriptorBindingLocation& location) {
+        return (pipelineUsesPushSet && location.set == pushSetIndex) ||
+               (location.set < boundSets.size() && boundSets[location.set] != VK_NULL_HANDLE);
+    };
+    auto appendWrite = [&](const VulkanDescriptorBindingLocation& location, VkWriteDescriptorSet write) {
+        write.dstBinding = location.binding;
+        write.dstArrayElement = location.arrayElement;
+        write.descriptorCount = 1;
+        write.descriptorType = location.descriptorType;
+        if (pipelineUsesPushSet && location.set == pushSetIndex) {
+            pushWrites.push_back(write);
+        } else {
+            write.dstSet = boundSets[location.set];
+            writes.push_back(write);
+        }
+    };
+
     for (uint32_t logicalIndex = 0; logicalIndex < kMaxBufferBindings; ++logicalIndex) {
         const VulkanDescriptorBindingLocation& location = pipeline.bufferBindings[logicalIndex];
-        if (!location.valid() || buffers[logicalIndex].buffer == VK_NULL_HANDLE ||
-            location.set >= boundSets.size() || boundSets[location.set] == VK_NULL_HANDLE) {
+        if (!location.valid() || buffers[logicalIndex].buffer == VK_NULL_HANDLE || !writableSet(location)) {
             continue;
         }
 
@@ -483,19 +567,13 @@ void VulkanDescriptorManager::flushAndBind(
                                buffers[logicalIndex].range});
 
         VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-        write.dstSet = boundSets[location.set];
-        write.dstBinding = location.binding;
-        write.dstArrayElement = location.arrayElement;
-        write.descriptorCount = 1;
-        write.descriptorType = location.descriptorType;
         write.pBufferInfo = &bufferInfos.back();
-        writes.push_back(write);
+        appendWrite(location, write);
     }
 
     for (uint32_t logicalIndex = 0; logicalIndex < kMaxTextureBindings; ++logicalIndex) {
         const VulkanDescriptorBindingLocation& location = pipeline.textureBindings[logicalIndex];
-        if (!location.valid() || textures[logicalIndex].imageView == VK_NULL_HANDLE ||
-            location.set >= boundSets.size() || boundSets[location.set] == VK_NULL_HANDLE) {
+        if (!location.valid() || textures[logicalIndex].imageView == VK_NULL_HANDLE || !writableSet(location)) {
             continue;
         }
 
@@ -507,19 +585,13 @@ void VulkanDescriptorManager::flushAndBind(
         imageInfos.push_back(imageInfo);
 
         VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-        write.dstSet = boundSets[location.set];
-        write.dstBinding = location.binding;
-        write.dstArrayElement = location.arrayElement;
-        write.descriptorCount = 1;
-        write.descriptorType = location.descriptorType;
         write.pImageInfo = &imageInfos.back();
-        writes.push_back(write);
+        appendWrite(location, write);
     }
 
     for (uint32_t logicalIndex = 0; logicalIndex < kMaxSamplerBindings; ++logicalIndex) {
         const VulkanDescriptorBindingLocation& location = pipeline.samplerBindings[logicalIndex];
-        if (!location.valid() || samplers[logicalIndex].sampler == VK_NULL_HANDLE ||
-            location.set >= boundSets.size() || boundSets[location.set] == VK_NULL_HANDLE) {
+        if (!location.valid() || samplers[logicalIndex].sampler == VK_NULL_HANDLE || !writableSet(location)) {
             continue;
         }
 
@@ -528,13 +600,8 @@ void VulkanDescriptorManager::flushAndBind(
         imageInfos.push_back(samplerInfo);
 
         VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-        write.dstSet = boundSets[location.set];
-        write.dstBinding = location.binding;
-        write.dstArrayElement = location.arrayElement;
-        write.descriptorCount = 1;
-        write.descriptorType = location.descriptorType;
         write.pImageInfo = &imageInfos.back();
-        writes.push_back(write);
+        appendWrite(location, write);
     }
 
     int32_t fallbackLocationIndex = -1;
@@ -558,8 +625,7 @@ void VulkanDescriptorManager::flushAndBind(
     auto appendAccelerationStructureWrite = [&](uint32_t pendingIndex, uint32_t locationIndex) {
         const VulkanDescriptorBindingLocation& location =
             pipeline.accelerationStructureBindings[locationIndex];
-        if (!location.valid() || location.set >= boundSets.size() ||
-            boundSets[location.set] == VK_NULL_HANDLE) {
+        if (!location.valid() || !writableSet(location)) {
             return;
         }
 
@@ -572,12 +638,7 @@ void VulkanDescriptorManager::flushAndBind(
 
         VkWriteDescriptorSet write{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
         write.pNext = &accelerationInfos.back();
-        write.dstSet = boundSets[location.set];
-        write.dstBinding = location.binding;
-        write.dstArrayElement = location.arrayElement;
-        write.descriptorCount = 1;
-        write.descriptorType = location.descriptorType;
-        writes.push_back(write);
+        appendWrite(location, write);
     };
 
     bool wroteAnyAccelerationStructure = false;
@@ -606,24 +667,47 @@ void VulkanDescriptorManager::flushAndBind(
         vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
     }
 
-    vulkanCmdBindDescriptorSetsHooked(cmd,
-                                      bindPoint,
-                                      pipeline.layout,
-                                      0,
-                                      static_cast<uint32_t>(boundSets.size()),
-                                      boundSets.data(),
-                                      0,
-                                      nullptr);
+    // A push set cannot be bound, so bind the sets on either side of it separately.
+    uint32_t firstSet = 0;
+    while (firstSet < boundSets.size()) {
+        if (pipelineUsesPushSet && firstSet == pushSetIndex) {
+            ++firstSet;
+            continue;
+        }
+        uint32_t endSet = firstSet;
+        while (endSet < boundSets.size() && !(pipelineUsesPushSet && endSet == pushSetIndex)) {
+            ++endSet;
+        }
+        vulkanCmdBindDescriptorSetsHooked(cmd,
+                                          bindPoint,
+                                          pipeline.layout,
+                                          firstSet,
+                                          endSet - firstSet,
+                                          boundSets.data() + firstSet,
+                                          0,
+                                          nullptr);
+        firstSet = endSet;
+    }
+
+    if (!pushWrites.empty()) {
+        m_vkCmdPushDescriptorSetKHR(cmd,
+                                    bindPoint,
+                                    pipeline.layout,
+                                    pushSetIndex,
+                                    static_cast<uint32_t>(pushWrites.size()),
+                                    pushWrites.data());
+    }
 }
 
 void VulkanDescriptorManager::createPools() {
-    for (auto& frame : m_frames) {
-        frame.pool = createDescriptorPool(m_device);
+    for (uint32_t frameIndex = 0; frameIndex < m_frameCount; ++frameIndex) {
+        m_frames[frameIndex].pool = createDescriptorPool(m_device);
     }
 }
 
 void VulkanDescriptorManager::destroyFrameState(FrameState& frame) {
     if (frame.uniformUpload.buffer != VK_NULL_HANDLE && frame.uniformUpload.allocation != nullptr) {
+        vulkanUntrackAllocation(frame.uniformUpload.allocation);
         vmaDestroyBuffer(m_allocator,
                          frame.uniformUpload.buffer,
                          frame.uniformUpload.allocation);
@@ -648,6 +732,7 @@ bool VulkanDescriptorManager::ensureFrameUniformUploadCapacity(FrameState& frame
     }
 
     if (frame.uniformUpload.buffer != VK_NULL_HANDLE && frame.uniformUpload.allocation != nullptr) {
+        vulkanUntrackAllocation(frame.uniformUpload.allocation);
         vmaDestroyBuffer(m_allocator,
                          frame.uniformUpload.buffer,
                          frame.uniformUpload.allocation);
@@ -659,7 +744,8 @@ bool VulkanDescriptorManager::ensureFrameUniformUploadCapacity(FrameState& frame
     bufferInfo.allocator = m_allocator;
     bufferInfo.size = nextUploadCapacity(requiredSize);
     bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.hostVisible = true;
+    // Read straight from mapped VRAM with resizable BAR; host memory otherwise.
+    vulkanApplyBufferMemory(bufferInfo, RhiBufferMemory::DynamicDeviceLocal);
     bufferInfo.debugName = "InlineUniformUpload";
 
     const char* errorMessage = nullptr;
@@ -673,7 +759,7 @@ bool VulkanDescriptorManager::ensureFrameUniformUploadCapacity(FrameState& frame
     if (resource->mappedData == nullptr && resource->allocation != nullptr) {
         void* mappedData = nullptr;
         if (vmaMapMemory(m_allocator, resource->allocation, &mappedData) != VK_SUCCESS) {
-            vmaDestroyBuffer(m_allocator, resource->buffer, resource->allocation);
+            vmaDestroyBufferResource(*resource);
             spdlog::warn("Failed to map frame uniform upload buffer");
             return false;
         }
@@ -689,7 +775,7 @@ bool VulkanDescriptorManager::ensureFrameUniformUploadCapacity(FrameState& frame
 }
 
 VulkanDescriptorManager::FrameState& VulkanDescriptorManager::currentFrame() {
-    return m_frames[m_frameIndex % static_cast<uint32_t>(m_frames.size())];
+    return m_frames[m_frameIndex % m_frameCount];
 }
 
 bool vulkanRetainBindlessSetLayout(VkDevice device,
@@ -5,10 +5,14 @@
 #include <vulkan/vulkan.h>
 
 #include "bindless_scene_constants.h"
+#include "rhi_backend.h"
 
 #include <array>
 #include <cstddef>
+#include <iterator>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class RhiAccelerationStructure;
@@ -23,6 +27,7 @@ typedef VmaAllocation_T* VmaAllocation;
 
 struct VulkanPipelineResource;
 struct VulkanTextureResource;
+struct VulkanBufferResource;
 
 constexpr uint32_t kMaxBufferBindings = 32;
 constexpr uint32_t kMaxTextureBindings = 128;
@@ -50,6 +55,7 @@ struct PendingBufferBinding {
     VkDeviceSize range = VK_WHOLE_SIZE;
     bool dirty = false;
     bool trackState = true;
+    const VulkanBufferResource* resource = nullptr; // state tracking; null for inline data
 };
 
 struct PendingTextureBinding {
@@ -58,6 +64,8 @@ struct PendingTextureBinding {
     VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     bool dirty = false;
     bool isStorage = false;
+    uint32_t baseMipLevel = 0; // mips the view covers, for layout tracking
+    uint32_t mipLevelCount = VK_REMAINING_MIP_LEVELS;
 };
 
 struct PendingSamplerBinding {
@@ -70,6 +78,50 @@ struct PendingAccelerationStructureBinding {
     bool dirty = false;
 };
 
+// Both backends keep the bindless set once per frame in flight, so a frame can
+// rewrite its own copy while the GPU still reads the copies of earlier frames. A
+// write lands in the current copy; the others pick it up when their slot comes round.
+class VulkanBindlessCopyQueue {
+public:
+    void reset(uint32_t copyCount) {
+        m_copyCount = copyCount;
+        m_pending.clear();
+    }
+
+    // A later write to the same element replaces any copy still pending for it.
+    void recordWrite(uint32_t binding, uint32_t arrayElement, uint32_t sourceCopy) {
+        const uint32_t allCopies = (1u << m_copyCount) - 1u;
+        m_pending[(static_cast<uint64_t>(binding) << 32) | arrayElement] = {
+            sourceCopy, allCopies & ~(1u << sourceCopy)};
+    }
+
+    // Calls copy(binding, arrayElement, sourceCopy) for each write targetCopy has missed.
+    template <typename CopyFn>
+    void drain(uint32_t targetCopy, CopyFn&& copy) {
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            Entry& entry = it->second;
+            if ((entry.pendingCopies & (1u << targetCopy)) != 0u) {
+                copy(static_cast<uint32_t>(it->first >> 32),
+                     static_cast<uint32_t>(it->first),
+                     entry.sourceCopy);
+                entry.pendingCopies &= ~(1u << targetCopy);
+            }
+            it = entry.pendingCopies == 0u ? m_pending.erase(it) : std::next(it);
+        }
+    }
+
+    uint32_t copyCount() const { return m_copyCount; }
+
+private:
+    struct Entry {
+        uint32_t sourceCopy = 0;
+        uint32_t pendingCopies = 0;
+    };
+
+    std::unordered_map<uint64_t, Entry> m_pending;
+    uint32_t m_copyCount = 1;
+};
+
 struct VulkanPipelineResource;
 
 // Abstract base for descriptor backends (pool-based or descriptor-buffer-based).
@@ -91,6 +143,9 @@ public:
     virtual bool updateBindlessAccelerationStructure(
         uint32_t index,
         const RhiAccelerationStructure* accelerationStructure) = 0;
+    // Copies every queued bindless write into all per-frame copies. Only call while
+    // the device is idle, before destroying resources that queued writes reference.
+    virtual void flushBindlessCopies() = 0;
     virtual void flushAndBind(
         VkCommandBuffer cmd,
         VkPipelineBindPoint bindPoint,
@@ -109,7 +164,8 @@ public:
               VmaAllocator allocator,
               VkDeviceSize minUniformBufferOffsetAlignment,
               VkDeviceSize nonCoherentAtomSize,
-              VkDeviceSize maxUniformBufferRange);
+              VkDeviceSize maxUniformBufferRange,
+              uint32_t framesInFlight);
     void destroy();
     void resetFrame() override;
 
@@ -126,6 +182,7 @@ public:
                                      VkDeviceSize range = VK_WHOLE_SIZE) override;
     bool updateBindlessAccelerationStructure(uint32_t index,
                                              const RhiAccelerationStructure* accelerationStructure) override;
+    void flushBindlessCopies() override;
 
     void flushAndBind(VkCommandBuffer cmd,
                       VkPipelineBindPoint bindPoint,
@@ -147,6 +204,7 @@ private:
 
     struct FrameState {
         VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkDescriptorSet bindlessSet = VK_NULL_HANDLE; // allocated from m_bindlessPool
         FrameUniformUpload uniformUpload;
     };
 
@@ -154,20 +212,88 @@ private:
     void destroyFrameState(FrameState& frame);
     bool ensureFrameUniformUploadCapacity(FrameState& frame, VkDeviceSize requiredSize);
     FrameState& currentFrame();
+    void copyPendingBindlessWrites(uint32_t targetCopy);
 
     VkDevice m_device = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VmaAllocator m_allocator = nullptr;
     VkDescriptorPool m_bindlessPool = VK_NULL_HANDLE;
     VkDescriptorSetLayout m_bindlessSetLayout = VK_NULL_HANDLE;
-    VkDescriptorSet m_bindlessSet = VK_NULL_HANDLE;
-    std::array<FrameState, 2> m_frames{};
+    VulkanBindlessCopyQueue m_bindlessCopies;
+    std::array<FrameState, kRhiMaxFramesInFlight> m_frames{};
+    PFN_vkCmdPushDescriptorSetKHR m_vkCmdPushDescriptorSetKHR = nullptr;
+    uint32_t m_frameCount = 2;
     uint32_t m_frameIndex = 1;
     VkDeviceSize m_uniformUploadAlignment = 16;
     VkDeviceSize m_nonCoherentAtomSize = 1;
     VkDeviceSize m_maxUniformBufferRange = 65536;
 };
 
+// Serializes access to another descriptor backend so encoders recording on worker
+// threads can share it. resetFrame() must still only run between frames.
+class VulkanLockedDescriptorBackend final : public IVulkanDescriptorBackend {
+public:
+    explicit VulkanLockedDescriptorBackend(IVulkanDescriptorBackend& backend) : m_backend(backend) {}
+
+    void resetFrame() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backend.resetFrame();
+    }
+    PendingBufferBinding uploadInlineUniformData(const void* data, size_t size) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.uploadInlineUniformData(data, size);
+    }
+    void updateBindlessSampledTextures(const RhiTexture* const* textures,
+                                       uint32_t startIndex,
+                                       uint32_t count) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backend.updateBindlessSampledTextures(textures, startIndex, count);
+    }
+    bool updateBindlessSampledTexture(uint32_t index, const RhiTexture* texture) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.updateBindlessSampledTexture(index, texture);
+    }
+    bool updateBindlessSampler(uint32_t index, const RhiSampler* sampler) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.updateBindlessSampler(index, sampler);
+    }
+    bool updateBindlessStorageImage(uint32_t index, const RhiTexture* texture) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.updateBindlessStorageImage(index, texture);
+    }
+    bool updateBindlessStorageBuffer(uint32_t index,
+                                     const RhiBuffer* buffer,
+                                     VkDeviceSize offset = 0,
+                                     VkDeviceSize range = VK_WHOLE_SIZE) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.updateBindlessStorageBuffer(index, buffer, offset, range);
+    }
+    bool updateBindlessAccelerationStructure(uint32_t index,
+                                             const RhiAccelerationStructure* accelerationStructure) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_backend.updateBindlessAccelerationStructure(index, accelerationStructure);
+    }
+    void flushBindlessCopies() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backend.flushBindlessCopies();
+    }
+    void flushAndBind(VkCommandBuffer cmd,
+                      VkPipelineBindPoint bindPoint,
+                      const VulkanPipelineResource& pipeline,
+                      const std::array<PendingBufferBinding, kMaxBufferBindings>& buffers,
+                      const std::array<PendingTextureBinding, kMaxTextureBindings>& textures,
+                      const std::array<PendingSamplerBinding, kMaxSamplerBindings>& samplers,
+                      const std::array<PendingAccelerationStructureBinding,
+                                       kMaxAccelerationStructureBindings>& accelerationStructures) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backend.flushAndBind(cmd, bindPoint, pipeline, buffers, textures, samplers, accelerationStructures);
+    }
+
+private:
+    IVulkanDescriptorBackend& m_backend;
+    std::mutex m_mutex;
+};
+
 bool vulkanRetainBindlessSetLayout(VkDevice device,
                                    VkDescriptorSetLayout& outLayout,
                                    std::string* errorMessage = nullptr,
@@ -1,5 +1,7 @@
 #include "vulkan_frame_graph.h"
+#include "vulkan_backend.h"
 #include "vulkan_diagnostics.h"
+#include "vulkan_rt_pipeline.h"
 #include "vulkan_transient_allocator.h"
 
 #ifdef _WIN32
@@ -10,11 +12,15 @@
 #include "imgui.h"
 #include "imgui_impl_vulkan.h"
 
+#include <spdlog/spdlog.h>
+
 #include <array>
 #include <cstring>
 #include <stdexcept>
 
+#include "rhi_encoder_pool.h"
 #include "rhi_resource_utils.h"
+#include "rhi_transient_placement.h"
 
 // Mesh shader extension function pointers (loaded dynamically)
 static PFN_vkCmdDrawMeshTasksEXT pfnCmdDrawMeshTasksEXT = nullptr;
@@ -99,17 +105,82 @@ VkAccessFlags2 bufferAccessMaskForUsage(RhiResourceUsage usage) {
 }
 
 void requireTrackedBufferState(VulkanResourceStateTracker* tracker,
-                               VkBuffer buffer,
+                               const VulkanBufferResource* buffer,
                                VkDeviceSize offset,
                                VkPipelineStageFlags2 dstStage,
                                VkAccessFlags2 dstAccess) {
-    if (!tracker || buffer == VK_NULL_HANDLE || dstAccess == VK_ACCESS_2_NONE) {
+    if (!tracker || !buffer || dstAccess == VK_ACCESS_2_NONE) {
         return;
     }
 
-    tracker->requireBufferState(buffer, offset, VK_WHOLE_SIZE, dstStage, dstAccess);
+    tracker->requireBufferState(*buffer, offset, VK_WHOLE_SIZE, dstStage, dstAccess);
+}
+
+PendingBufferBinding pendingBufferBinding(const RhiBuffer* buffer, VkDeviceSize offset) {
+    PendingBufferBinding binding;
+    binding.buffer = getVulkanBufferHandle(buffer);
+    binding.offset = offset;
+    binding.range = buffer->size();
+    binding.resource = getVulkanBufferResource(buffer);
+    return binding;
+}
+
+// Encoders keep their pending bindings as shadow state: a set that leaves a slot as
+// it was is dropped, and descriptors are only flushed again after a real change.
+bool sameBinding(const PendingBufferBinding& a, const PendingBufferBinding& b) {
+    return a.buffer == b.buffer && a.offset == b.offset && a.range == b.range &&
+           a.trackState == b.trackState && a.resource == b.resource;
+}
+
+bool sameBinding(const PendingTextureBinding& a, const PendingTextureBinding& b) {
+    return a.resource == b.resource && a.imageView == b.imageView && a.layout == b.layout &&
+           a.isStorage == b.isStorage && a.baseMipLevel == b.baseMipLevel &&
+           a.mipLevelCount == b.mipLevelCount;
+}
+
+bool sameBinding(const PendingSamplerBinding& a, const PendingSamplerBinding& b) {
+    return a.sampler == b.sampler;
+}
+
+bool sameBinding(const PendingAccelerationStructureBinding& a, const PendingAccelerationStructureBinding& b) {
+    return a.accelerationStructure == b.accelerationStructure;
+}
+
+// Stores binding in slot; false when the slot already held it.
+template <typename Binding>
+bool updateBinding(Binding& slot, const Binding& binding) {
+    if (sameBinding(slot, binding)) {
+        return false;
+    }
+    slot = binding;
+    return true;
 }
 
+// Push constants last recorded under a pipeline layout. They survive pipeline
+// binds with the same layout, so an identical push is skipped until it changes.
+class PushConstantShadow {
+public:
+    bool update(VkPipelineLayout layout, const void* data, size_t size) {
+        if (layout == m_layout && size == m_size && size <= m_bytes.size() &&
+            std::memcmp(m_bytes.data(), data, size) == 0) {
+            return false;
+        }
+        m_layout = size <= m_bytes.size() ? layout : VK_NULL_HANDLE;
+        m_size = size;
+        if (m_layout != VK_NULL_HANDLE) {
+            std::memcpy(m_bytes.data(), data, size);
+        }
+        return true;
+    }
+
+    void invalidate() { m_layout = VK_NULL_HANDLE; }
+
+private:
+    VkPipelineLayout m_layout = VK_NULL_HANDLE;
+    size_t m_size = 0;
+    std::array<uint8_t, 256> m_bytes{};
+};
+
 } // namespace
 
 // Owned texture with VMA allocation backed by a shared VulkanTextureResource wrapper.
@@ -125,6 +196,7 @@ public:
     void* nativeHandle() const override { return const_cast<VulkanTextureResource*>(&m_resource); }
     uint32_t width() const override { return m_resource.width; }
     uint32_t height() const override { return m_resource.height; }
+    uint32_t mipLevelCount() const override { return m_resource.mipLevels; }
 
     VkImage image() const { return m_resource.image; }
     VkImageView imageView() const { return m_resource.imageView; }
@@ -153,6 +225,7 @@ public:
         }
         return m_resource.mappedData;
     }
+    uint64_t gpuAddress() const override { return m_resource.deviceAddress; }
 
     VkBuffer buffer() const { return m_resource.buffer; }
 
@@ -236,25 +309,40 @@ public:
     void setDepthStencilState(const RhiDepthStencilState* /*state*/) override {}
 
     void setFrontFacingWinding(RhiWinding winding) override {
-        m_frontFace =
+        const VkFrontFace frontFace =
             winding == RhiWinding::Clockwise ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        if (frontFace == m_frontFace) {
+            return;
+        }
+        m_frontFace = frontFace;
         if (m_renderingBegun) {
             vkCmdSetFrontFace(m_commandBuffer, m_frontFace);
         }
     }
 
     void setCullMode(RhiCullMode cullMode) override {
-        m_cullMode = VK_CULL_MODE_NONE;
-        if (cullMode == RhiCullMode::Front) m_cullMode = VK_CULL_MODE_FRONT_BIT;
-        else if (cullMode == RhiCullMode::Back) m_cullMode = VK_CULL_MODE_BACK_BIT;
+        VkCullModeFlags vkCullMode = VK_CULL_MODE_NONE;
+        if (cullMode == RhiCullMode::Front) vkCullMode = VK_CULL_MODE_FRONT_BIT;
+        else if (cullMode == RhiCullMode::Back) vkCullMode = VK_CULL_MODE_BACK_BIT;
+        if (vkCullMode == m_cullMode) {
+            return;
+        }
+        m_cullMode = vkCullMode;
         if (m_renderingBegun) {
             vkCmdSetCullMode(m_commandBuffer, m_cullMode);
         }
     }
 
     void setRenderPipeline(const RhiGraphicsPipeline& pipeline) override {
-        m_boundPipeline = getVulkanPipelineResource(pipeline);
-        m_boundPipelineHandle = getVulkanPipelineHandle(pipeline);
+        const VulkanPipelineResource* resource = getVulkanPipelineResource(pipeline);
+        const VkPipeline handle = getVulkanPipelineHandle(pipeline);
+        if (resource == m_boundPipeline && handle == m_boundPipelineHandle) {
+            return;
+        }
+        m_boundPipeline = resource;
+        m_boundPipelineHandle = handle;
+        // Binding locations are per pipeline.
+        m_descriptorsDirty = true;
         if (m_renderingBegun && m_boundPipelineHandle != VK_NULL_HANDLE) {
             vulkanCmdBindPipelineHooked(m_commandBuffer,
                                         VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -266,20 +354,32 @@ public:
         if (!buffer) return;
         VkBuffer vkBuf = getVulkanBufferHandle(buffer);
         VkDeviceSize vkOffset = offset;
-        if (index < kMaxBufferBindings) {
-            m_pendingVertexBuffers[index] = {vkBuf, vkOffset, buffer->size()};
+        if (index < kMaxBufferBindings &&
+            !updateBinding(m_pendingVertexBuffers[index], pendingBufferBinding(buffer, vkOffset))) {
+            return;
         }
         vkCmdBindVertexBuffers(m_commandBuffer, index, 1, &vkBuf, &vkOffset);
     }
 
     void setFragmentBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
         if (!buffer || index >= kMaxBufferBindings) return;
-        m_pendingBuffers[index] = {getVulkanBufferHandle(buffer), offset, buffer->size()};
+        m_descriptorsDirty |= updateBinding(m_pendingBuffers[index], pendingBufferBinding(buffer, offset));
     }
 
     void setMeshBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
         if (!buffer || index >= kMaxBufferBindings) return;
-        m_pendingBuffers[index] = {getVulkanBufferHandle(buffer), offset, buffer->size()};
+        m_descriptorsDirty |= updateBinding(m_pendingBuffers[index], pendingBufferBinding(buffer, offset));
+    }
+
+    // Mesh and fragment buffers share one descriptor table.
+    void setMeshBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            setMeshBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
+
+    void setFragmentBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        setMeshBuffers(bindings, count);
     }
 
     void setVertexBytes(const void* data, size_t size, uint32_t index) override {
@@ -287,6 +387,7 @@ public:
             return;
         }
         m_pendingBuffers[index] = m_descriptorManager->uploadInlineUniformData(data, size);
+        m_descriptorsDirty = true;
     }
 
     void setFragmentBytes(const void* data, size_t size, uint32_t index) override {
@@ -294,6 +395,7 @@ public:
             return;
         }
         m_pendingBuffers[index] = m_descriptorManager->uploadInlineUniformData(data, size);
+        m_descriptorsDirty = true;
     }
 
     void setMeshBytes(const void* data, size_t size, uint32_t index) override {
@@ -301,10 +403,12 @@ public:
             return;
         }
         m_pendingBuffers[index] = m_descriptorManager->uploadInlineUniformData(data, size);
+        m_descriptorsDirty = true;
     }
 
     void setPushConstants(const void* data, size_t size) override {
         if (!m_boundPipeline || m_boundPipeline->layout == VK_NULL_HANDLE) return;
+        if (!m_pushConstants.update(m_boundPipeline->layout, data, size)) return;
         vkCmdPushConstants(m_commandBuffer, m_boundPipeline->layout,
                            VK_SHADER_STAGE_ALL, 0,
                            static_cast<uint32_t>(size), data);
@@ -314,14 +418,14 @@ public:
         if (index >= kMaxTextureBindings) return;
         auto* resource = getVulkanTextureResource(texture);
         VkImageView view = getVulkanImageView(texture);
-        m_pendingTextures[index] = {resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false};
+        m_descriptorsDirty |= updateBinding(
+            m_pendingTextures[index],
+            PendingTextureBinding{resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false});
     }
 
     void setFragmentTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) override {
         for (uint32_t i = 0; i < count && (startIndex + i) < kMaxTextureBindings; ++i) {
-            auto* resource = getVulkanTextureResource(textures[i]);
-            VkImageView view = getVulkanImageView(textures[i]);
-            m_pendingTextures[startIndex + i] = {resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false};
+            setFragmentTexture(textures[i], startIndex + i);
         }
     }
 
@@ -331,7 +435,8 @@ public:
 
     void setFragmentSampler(const RhiSampler* sampler, uint32_t index) override {
         if (!sampler || index >= kMaxSamplerBindings) return;
-        m_pendingSamplers[index] = {getVulkanSamplerHandle(sampler), true};
+        m_descriptorsDirty |= updateBinding(m_pendingSamplers[index],
+                                            PendingSamplerBinding{getVulkanSamplerHandle(sampler), true});
     }
 
     void setMeshSampler(const RhiSampler* sampler, uint32_t index) override {
@@ -349,19 +454,54 @@ public:
                                const RhiBuffer& indexBuffer,
                                uint64_t indexBufferOffset) override {
         requireTrackedBufferState(m_stateTracker,
-                                  getVulkanBufferHandle(&indexBuffer),
+                                  getVulkanBufferResource(&indexBuffer),
                                   indexBufferOffset,
                                   VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
                                   VK_ACCESS_2_INDEX_READ_BIT);
 
         flushDescriptors(VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-        VkIndexType vkIndexType = (indexType == RhiIndexType::UInt16) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
-        vkCmdBindIndexBuffer(m_commandBuffer, getVulkanBufferHandle(&indexBuffer),
-                             indexBufferOffset, vkIndexType);
+        bindIndexBuffer(indexBuffer, indexBufferOffset, indexType);
         vkCmdDrawIndexed(m_commandBuffer, indexCount, 1, 0, 0, 0);
     }
 
+    void drawIndexedPrimitivesIndirectCount(RhiPrimitiveType /*primitiveType*/,
+                                            RhiIndexType indexType,
+                                            const RhiBuffer& indexBuffer,
+                                            uint64_t indexBufferOffset,
+                                            const RhiBuffer& argumentBuffer,
+                                            uint64_t argumentOffset,
+                                            const RhiBuffer& countBuffer,
+                                            uint64_t countOffset,
+                                            uint32_t maxDrawCount) override {
+        requireTrackedBufferState(m_stateTracker,
+                                  getVulkanBufferResource(&indexBuffer),
+                                  indexBufferOffset,
+                                  VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
+                                  VK_ACCESS_2_INDEX_READ_BIT);
+        requireTrackedBufferState(m_stateTracker,
+                                  getVulkanBufferResource(&argumentBuffer),
+                                  argumentOffset,
+                                  VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                                  VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+        requireTrackedBufferState(m_stateTracker,
+                                  getVulkanBufferResource(&countBuffer),
+                                  countOffset,
+                                  VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                                  VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+
+        flushDescriptors(VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+        bindIndexBuffer(indexBuffer, indexBufferOffset, indexType);
+        vkCmdDrawIndexedIndirectCount(m_commandBuffer,
+                                      getVulkanBufferHandle(&argumentBuffer),
+                                      argumentOffset,
+                                      getVulkanBufferHandle(&countBuffer),
+                                      countOffset,
+                                      maxDrawCount,
+                                      sizeof(VkDrawIndexedIndirectCommand));
+    }
+
     void drawMeshThreadgroups(RhiSize3D threadgroupsPerGrid,
                               RhiSize3D /*threadsPerObjectThreadgroup*/,
                               RhiSize3D /*threadsPerMeshThreadgroup*/) override {
@@ -379,7 +519,7 @@ public:
                                       RhiSize3D /*threadsPerObjectThreadgroup*/,
                                       RhiSize3D /*threadsPerMeshThreadgroup*/) override {
         requireTrackedBufferState(m_stateTracker,
-                                  getVulkanBufferHandle(&indirectBuffer),
+                                  getVulkanBufferResource(&indirectBuffer),
                                   indirectBufferOffset,
                                   VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
                                   VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
@@ -400,10 +540,30 @@ public:
         if (m_commandBuffer != VK_NULL_HANDLE) {
             ensureRenderingStarted();
             ImGui_ImplVulkan_RenderDrawData(drawData, m_commandBuffer);
+            // ImGui binds its own pipeline, buffers and descriptors.
+            m_boundPipeline = nullptr;
+            m_boundPipelineHandle = VK_NULL_HANDLE;
+            m_pendingVertexBuffers.fill({});
+            m_boundIndexBuffer = VK_NULL_HANDLE;
+            m_pushConstants.invalidate();
+            m_descriptorsDirty = true;
         }
     }
 
 private:
+    void bindIndexBuffer(const RhiBuffer& indexBuffer, uint64_t offset, RhiIndexType indexType) {
+        const VkBuffer vkBuffer = getVulkanBufferHandle(&indexBuffer);
+        const VkIndexType vkIndexType =
+            (indexType == RhiIndexType::UInt16) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        if (vkBuffer == m_boundIndexBuffer && offset == m_boundIndexOffset && vkIndexType == m_boundIndexType) {
+            return;
+        }
+        vkCmdBindIndexBuffer(m_commandBuffer, vkBuffer, offset, vkIndexType);
+        m_boundIndexBuffer = vkBuffer;
+        m_boundIndexOffset = offset;
+        m_boundIndexType = vkIndexType;
+    }
+
     void ensureRenderingStarted() {
         if (m_renderingBegun) {
             return;
@@ -453,8 +613,13 @@ private:
                 continue;
             }
 
-            m_stateTracker->requireImageState(texture.resource->image, texture.layout,
-                                              imageAspectMask(texture.resource));
+            m_stateTracker->requireImageSubresourceState(*texture.resource,
+                                                         {imageAspectMask(texture.resource),
+                                                          texture.baseMipLevel,
+                                                          texture.mipLevelCount,
+                                                          0,
+                                                          VK_REMAINING_ARRAY_LAYERS},
+                                                         texture.layout);
         }
     }
 
@@ -473,7 +638,7 @@ private:
                 }
 
                 requireTrackedBufferState(m_stateTracker,
-                                          binding.buffer,
+                                          binding.resource,
                                           binding.offset,
                                           shaderStage,
                                           bufferAccessMaskForDescriptorType(location.descriptorType, true));
@@ -486,7 +651,7 @@ private:
             }
 
             requireTrackedBufferState(m_stateTracker,
-                                      vertexBuffer.buffer,
+                                      vertexBuffer.resource,
                                       vertexBuffer.offset,
                                       VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
                                       VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
@@ -496,7 +661,8 @@ private:
     void flushDescriptors(VkPipelineBindPoint bindPoint) {
         ensureRenderingStarted();
 
-        if (m_descriptorManager && m_boundPipeline) {
+        // The sets bound by the last flush stay valid until a binding or the pipeline changes.
+        if (m_descriptorManager && m_boundPipeline && m_descriptorsDirty) {
             m_descriptorManager->flushAndBind(m_commandBuffer,
                                               bindPoint,
                                               *m_boundPipeline,
@@ -504,6 +670,7 @@ private:
                                               m_pendingTextures,
                                               m_pendingSamplers,
                                               m_pendingAccelerationStructures);
+            m_descriptorsDirty = false;
         }
     }
 
@@ -525,6 +692,11 @@ private:
     VkFrontFace m_frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
     const VulkanPipelineResource* m_boundPipeline = nullptr;
     VkPipeline m_boundPipelineHandle = VK_NULL_HANDLE;
+    VkBuffer m_boundIndexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize m_boundIndexOffset = 0;
+    VkIndexType m_boundIndexType = VK_INDEX_TYPE_UINT32;
+    PushConstantShadow m_pushConstants;
+    bool m_descriptorsDirty = true;
     std::array<PendingBufferBinding, kMaxBufferBindings> m_pendingVertexBuffers{};
     std::array<PendingBufferBinding, kMaxBufferBindings> m_pendingBuffers{};
     std::array<PendingTextureBinding, kMaxTextureBindings> m_pendingTextures{};
@@ -550,7 +722,7 @@ public:
         m_pendingAccelerationStructures.fill({});
         vulkanBeginDebugLabel(m_commandBuffer, label);
         if (m_gpuProfiler) {
-            m_gpuProfiler->beginScope(m_commandBuffer, label, m_gpuScope, false);
+            m_gpuProfiler->beginScope(m_commandBuffer, label, m_gpuScope, true);
         }
     }
 
@@ -564,7 +736,18 @@ public:
     void* nativeHandle() const override { return m_commandBuffer; }
 
     void setComputePipeline(const RhiComputePipeline& pipeline) override {
-        m_boundPipeline = getVulkanPipelineResource(pipeline);
+        const VulkanPipelineResource* resource = getVulkanPipelineResource(pipeline);
+        if (resource && resource == m_boundPipeline) {
+            return;
+        }
+        m_boundPipeline = resource;
+        m_descriptorsDirty = true;
+        if (m_boundPipeline && m_boundPipeline->rayTracing) {
+            vulkanCmdBindPipelineHooked(m_commandBuffer,
+                                        VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR,
+                                        m_boundPipeline->rayTracing->pipeline());
+            return;
+        }
         vulkanCmdBindPipelineHooked(m_commandBuffer,
                                     VK_PIPELINE_BIND_POINT_COMPUTE,
                                     getVulkanPipelineHandle(pipeline));
@@ -572,7 +755,13 @@ public:
 
     void setBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) override {
         if (!buffer || index >= kMaxBufferBindings) return;
-        m_pendingBuffers[index] = {getVulkanBufferHandle(buffer), offset, buffer->size()};
+        m_descriptorsDirty |= updateBinding(m_pendingBuffers[index], pendingBufferBinding(buffer, offset));
+    }
+
+    void setBuffers(const RhiBufferBinding* bindings, uint32_t count) override {
+        for (uint32_t i = 0; i < count; ++i) {
+            setBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
     }
 
     void setBytes(const void* data, size_t size, uint32_t index) override {
@@ -580,10 +769,12 @@ public:
             return;
         }
         m_pendingBuffers[index] = m_descriptorManager->uploadInlineUniformData(data, size);
+        m_descriptorsDirty = true;
     }
 
     void setPushConstants(const void* data, size_t size) override {
         if (!m_boundPipeline || m_boundPipeline->layout == VK_NULL_HANDLE) return;
+        if (!m_pushConstants.update(m_boundPipeline->layout, data, size)) return;
         vkCmdPushConstants(m_commandBuffer, m_boundPipeline->layout,
                            VK_SHADER_STAGE_ALL, 0,
                            static_cast<uint32_t>(size), data);
@@ -593,27 +784,49 @@ public:
         if (index >= kMaxTextureBindings) return;
         auto* resource = getVulkanTextureResource(texture);
         VkImageView view = getVulkanImageView(texture);
-        m_pendingTextures[index] = {resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false};
+        m_descriptorsDirty |= updateBinding(
+            m_pendingTextures[index],
+            PendingTextureBinding{resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false});
     }
 
     void setStorageTexture(const RhiTexture* texture, uint32_t index) override {
         if (index >= kMaxTextureBindings) return;
         auto* resource = getVulkanTextureResource(texture);
         VkImageView view = getVulkanImageView(texture);
-        m_pendingTextures[index] = {resource, view, VK_IMAGE_LAYOUT_GENERAL, true, true};
+        m_descriptorsDirty |= updateBinding(
+            m_pendingTextures[index],
+            PendingTextureBinding{resource, view, VK_IMAGE_LAYOUT_GENERAL, true, true});
     }
 
     void setTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) override {
         for (uint32_t i = 0; i < count && (startIndex + i) < kMaxTextureBindings; ++i) {
-            auto* resource = getVulkanTextureResource(textures[i]);
-            VkImageView view = getVulkanImageView(textures[i]);
-            m_pendingTextures[startIndex + i] = {resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false};
+            setTexture(textures[i], startIndex + i);
         }
     }
 
+    void setTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) override {
+        if (index >= kMaxTextureBindings) return;
+        auto* resource = getVulkanTextureResource(texture);
+        VkImageView view = getVulkanImageMipView(texture, mipLevel);
+        m_descriptorsDirty |= updateBinding(
+            m_pendingTextures[index],
+            PendingTextureBinding{resource, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true, false,
+                                  mipLevel, 1});
+    }
+
+    void setStorageTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) override {
+        if (index >= kMaxTextureBindings) return;
+        auto* resource = getVulkanTextureResource(texture);
+        VkImageView view = getVulkanImageMipView(texture, mipLevel);
+        m_descriptorsDirty |= updateBinding(
+            m_pendingTextures[index],
+            PendingTextureBinding{resource, view, VK_IMAGE_LAYOUT_GENERAL, true, true, mipLevel, 1});
+    }
+
     void setSampler(const RhiSampler* sampler, uint32_t index) override {
         if (!sampler || index >= kMaxSamplerBindings) return;
-        m_pendingSamplers[index] = {getVulkanSamplerHandle(sampler), true};
+        m_descriptorsDirty |= updateBinding(m_pendingSamplers[index],
+                                            PendingSamplerBinding{getVulkanSamplerHandle(sampler), true});
     }
 
     void setAccelerationStructure(const RhiAccelerationStructure* accelerationStructure, uint32_t index) override {
@@ -636,10 +849,9 @@ public:
             return;
         }
 
-        m_pendingAccelerationStructures[resolvedIndex] = {
-            getVulkanAccelerationStructureHandle(accelerationStructure),
-            true,
-        };
+        m_descriptorsDirty |= updateBinding(
+            m_pendingAccelerationStructures[resolvedIndex],
+            PendingAccelerationStructureBinding{getVulkanAccelerationStructureHandle(accelerationStructure), true});
     }
 
     void useResource(const RhiBuffer& resource, RhiResourceUsage usage) override {
@@ -648,7 +860,7 @@ public:
         }
 
         requireTrackedBufferState(m_stateTracker,
-                                  getVulkanBufferHandle(&resource),
+                                  getVulkanBufferResource(&resource),
                                   0,
                                   VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
                                   bufferAccessMaskForUsage(usage));
@@ -698,7 +910,7 @@ public:
                                       uint64_t indirectBufferOffset,
                                       RhiSize3D /*threadsPerThreadgroup*/) override {
         requireTrackedBufferState(m_stateTracker,
-                                  getVulkanBufferHandle(&indirectBuffer),
+                                  getVulkanBufferResource(&indirectBuffer),
                                   indirectBufferOffset,
                                   VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
                                   VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
@@ -709,6 +921,34 @@ public:
                               indirectBufferOffset);
     }
 
+    void traceRays(RhiSize3D rays) override {
+        if (!m_boundPipeline || !m_boundPipeline->rayTracing) {
+            return;
+        }
+        flushDescriptors(VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR);
+        // The state tracker places its transitions at the compute stage; chain them
+        // and earlier compute writes to the ray tracing stages, and the trace's
+        // writes to whatever reads them next.
+        if (m_stateTracker) {
+            m_stateTracker->globalMemoryBarrier(
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT |
+                    VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+            m_stateTracker->flushBarriers(m_commandBuffer);
+        }
+        vulkanCmdTraceRays(m_commandBuffer, *m_boundPipeline->rayTracing, rays.width, rays.height, rays.depth);
+        if (m_stateTracker) {
+            m_stateTracker->globalMemoryBarrier(
+                VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+            m_stateTracker->flushBarriers(m_commandBuffer);
+        }
+    }
+
 private:
     void transitionPendingTextures() {
         if (!m_stateTracker) {
@@ -728,8 +968,13 @@ private:
                 continue;
             }
 
-            m_stateTracker->requireImageState(texture.resource->image, texture.layout,
-                                              imageAspectMask(texture.resource));
+            m_stateTracker->requireImageSubresourceState(*texture.resource,
+                                                         {imageAspectMask(texture.resource),
+                                                          texture.baseMipLevel,
+                                                          texture.mipLevelCount,
+                                                          0,
+                                                          VK_REMAINING_ARRAY_LAYERS},
+                                                         texture.layout);
         }
     }
 
@@ -746,14 +991,14 @@ private:
             }
 
             requireTrackedBufferState(m_stateTracker,
-                                      binding.buffer,
+                                      binding.resource,
                                       binding.offset,
                                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
                                       bufferAccessMaskForDescriptorType(location.descriptorType));
         }
     }
 
-    void flushDescriptors() {
+    void flushDescriptors(VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_COMPUTE) {
         transitionPendingTextures();
         transitionPendingBuffers();
 
@@ -762,14 +1007,20 @@ private:
             m_stateTracker->flushBarriers(m_commandBuffer);
         }
 
-        if (m_descriptorManager && m_boundPipeline) {
+        // The sets bound by the last flush stay valid until a binding, the pipeline or
+        // the bind point changes. Barriers above still run: they track the hazards
+        // between dispatches, not the bindings.
+        if (m_descriptorManager && m_boundPipeline &&
+            (m_descriptorsDirty || bindPoint != m_descriptorBindPoint)) {
             m_descriptorManager->flushAndBind(m_commandBuffer,
-                                              VK_PIPELINE_BIND_POINT_COMPUTE,
+                                              bindPoint,
                                               *m_boundPipeline,
                                               m_pendingBuffers,
                                               m_pendingTextures,
                                               m_pendingSamplers,
                                               m_pendingAccelerationStructures);
+            m_descriptorsDirty = false;
+            m_descriptorBindPoint = bindPoint;
         }
     }
 
@@ -796,6 +1047,9 @@ private:
     VulkanGpuProfiler* m_gpuProfiler = nullptr;
     VulkanGpuProfiler::ScopeHandle m_gpuScope{};
     const VulkanPipelineResource* m_boundPipeline = nullptr;
+    PushConstantShadow m_pushConstants;
+    bool m_descriptorsDirty = true;
+    VkPipelineBindPoint m_descriptorBindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
     std::array<PendingBufferBinding, kMaxBufferBindings> m_pendingBuffers{};
     std::array<PendingTextureBinding, kMaxTextureBindings> m_pendingTextures{};
     std::array<PendingSamplerBinding, kMaxSamplerBindings> m_pendingSamplers{};
@@ -837,11 +1091,20 @@ public:
                      uint32_t destinationLevel,
                      RhiOrigin3D destinationOrigin) override {
         // Ensure source and destination are in correct transfer layouts
-        if (m_stateTracker) {
-            m_stateTracker->requireImageState(getVulkanImage(&source),
-                                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-            m_stateTracker->requireImageState(getVulkanImage(&destination),
-                                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        // Only the copied mips transition, so the other mips keep their state.
+        const VulkanTextureResource* sourceResource = getVulkanTextureResource(&source);
+        const VulkanTextureResource* destinationResource = getVulkanTextureResource(&destination);
+        if (m_stateTracker && sourceResource && destinationResource) {
+            m_stateTracker->requireImageSubresourceState(*sourceResource,
+                                                         {VK_IMAGE_ASPECT_COLOR_BIT, sourceLevel, 1, 0, 1},
+                                                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                         VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                                         VK_ACCESS_2_TRANSFER_READ_BIT);
+            m_stateTracker->requireImageSubresourceState(*destinationResource,
+                                                         {VK_IMAGE_ASPECT_COLOR_BIT, destinationLevel, 1, 0, 1},
+                                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                         VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                                         VK_ACCESS_2_TRANSFER_WRITE_BIT);
             m_stateTracker->flushBarriers(m_commandBuffer);
         }
 
@@ -882,6 +1145,103 @@ bool isDepthFormat(RhiFormat format) {
     return format == RhiFormat::D32Float || format == RhiFormat::D16Unorm;
 }
 
+// FrameGraph scopes history allocations; everything else it creates is transient.
+RhiMemoryTag frameGraphMemoryTag() {
+    const RhiMemoryTag scoped = RhiMemoryTagScope::current();
+    return scoped != RhiMemoryTag::Untagged ? scoped : RhiMemoryTag::Transients;
+}
+
+// Device memory shared by placed frame graph textures or sub-allocated buffers; freed
+// with the last resource.
+struct VulkanTransientHeap {
+    VmaAllocator allocator = nullptr;
+    VmaAllocation allocation = nullptr;
+    void* mappedData = nullptr; // host-visible buffer heaps only
+
+    ~VulkanTransientHeap() {
+        if (allocation) {
+            vulkanUntrackAllocation(allocation);
+            vmaFreeMemory(allocator, allocation);
+        }
+    }
+};
+
+// Texture bound at an offset inside a VulkanTransientHeap. Owns its image and view only.
+class VulkanPlacedTexture final : public RhiTexture {
+public:
+    VulkanPlacedTexture(VulkanTextureResource resource, std::shared_ptr<VulkanTransientHeap> heap)
+        : m_resource(resource), m_heap(std::move(heap)) {}
+
+    ~VulkanPlacedTexture() override {
+        vulkanReleaseResourceStateSlot(m_resource.header);
+        vulkanDestroyMipViews(m_resource);
+        if (m_resource.imageView != VK_NULL_HANDLE) {
+            vkDestroyImageView(m_resource.device, m_resource.imageView, nullptr);
+        }
+        if (m_resource.image != VK_NULL_HANDLE) {
+            vkDestroyImage(m_resource.device, m_resource.image, nullptr);
+        }
+    }
+
+    void* nativeHandle() const override { return const_cast<VulkanTextureResource*>(&m_resource); }
+    uint32_t width() const override { return m_resource.width; }
+    uint32_t height() const override { return m_resource.height; }
+    uint32_t mipLevelCount() const override { return m_resource.mipLevels; }
+
+private:
+    VulkanTextureResource m_resource{};
+    std::shared_ptr<VulkanTransientHeap> m_heap;
+};
+
+// Buffer bound at an offset inside a VulkanTransientHeap. Owns its VkBuffer only.
+class VulkanPlacedBuffer final : public RhiBuffer {
+public:
+    VulkanPlacedBuffer(VulkanBufferResource resource, std::shared_ptr<VulkanTransientHeap> heap)
+        : m_resource(resource), m_heap(std::move(heap)) {}
+
+    ~VulkanPlacedBuffer() override {
+        vulkanReleaseResourceStateSlot(m_resource.header);
+        if (m_resource.buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_resource.device, m_resource.buffer, nullptr);
+        }
+    }
+
+    size_t size() const override { return m_resource.size; }
+    void* nativeHandle() const override { return const_cast<VulkanBufferResource*>(&m_resource); }
+    void* mappedData() override { return m_resource.mappedData; }
+    uint64_t gpuAddress() const override { return m_resource.deviceAddress; }
+
+private:
+    VulkanBufferResource m_resource{};
+    std::shared_ptr<VulkanTransientHeap> m_heap;
+};
+
+// Memory for a heap of sub-allocated buffers of one RhiBufferMemory kind. Host-visible
+// heaps stay mapped and coherent, so buffers get a mapped pointer without flushes.
+VmaAllocationCreateInfo transientBufferHeapAllocInfo(RhiBufferMemory memory) {
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    switch (memory) {
+        case RhiBufferMemory::DeviceLocal:
+            allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            break;
+        case RhiBufferMemory::Readback:
+            allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            allocInfo.preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+            break;
+        case RhiBufferMemory::DynamicDeviceLocal:
+        case RhiBufferMemory::Upload:
+            allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            allocInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            if (memory == RhiBufferMemory::DynamicDeviceLocal && vulkanGetResourceContext().resizableBarEnabled) {
+                allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            }
+            break;
+    }
+    return allocInfo;
+}
+
 } // namespace
 
 // --- Format conversion helpers (non-static, declared in header) ---
@@ -895,6 +1255,7 @@ VkFormat toVkFormat(RhiFormat format) {
     case RhiFormat::RG8Unorm:    return VK_FORMAT_R8G8_UNORM;
     case RhiFormat::RG16Float:   return VK_FORMAT_R16G16_SFLOAT;
     case RhiFormat::RG32Float:   return VK_FORMAT_R32G32_SFLOAT;
+    case RhiFormat::RG32Uint:    return VK_FORMAT_R32G32_UINT;
     case RhiFormat::RGBA8Unorm:  return VK_FORMAT_R8G8B8A8_UNORM;
     case RhiFormat::RGBA8Srgb:   return VK_FORMAT_R8G8B8A8_SRGB;
     case RhiFormat::BGRA8Unorm:  return VK_FORMAT_B8G8R8A8_UNORM;
@@ -902,6 +1263,7 @@ VkFormat toVkFormat(RhiFormat format) {
     case RhiFormat::RGBA32Float: return VK_FORMAT_R32G32B32A32_SFLOAT;
     case RhiFormat::D32Float:    return VK_FORMAT_D32_SFLOAT;
     case RhiFormat::D16Unorm:    return VK_FORMAT_D16_UNORM;
+    case RhiFormat::BC7RGBAUnorm: return VK_FORMAT_BC7_UNORM_BLOCK;
     case RhiFormat::Undefined:
     default:                     return VK_FORMAT_UNDEFINED;
     }
@@ -916,6 +1278,7 @@ RhiFormat fromVkFormat(VkFormat format) {
     case VK_FORMAT_R8G8_UNORM:            return RhiFormat::RG8Unorm;
     case VK_FORMAT_R16G16_SFLOAT:         return RhiFormat::RG16Float;
     case VK_FORMAT_R32G32_SFLOAT:         return RhiFormat::RG32Float;
+    case VK_FORMAT_R32G32_UINT:           return RhiFormat::RG32Uint;
     case VK_FORMAT_R8G8B8A8_UNORM:        return RhiFormat::RGBA8Unorm;
     case VK_FORMAT_R8G8B8A8_SRGB:         return RhiFormat::RGBA8Srgb;
     case VK_FORMAT_B8G8R8A8_UNORM:
@@ -924,6 +1287,7 @@ RhiFormat fromVkFormat(VkFormat format) {
     case VK_FORMAT_R32G32B32A32_SFLOAT:   return RhiFormat::RGBA32Float;
     case VK_FORMAT_D32_SFLOAT:            return RhiFormat::D32Float;
     case VK_FORMAT_D16_UNORM:             return RhiFormat::D16Unorm;
+    case VK_FORMAT_BC7_UNORM_BLOCK:       return RhiFormat::BC7RGBAUnorm;
     default:                              return RhiFormat::Undefined;
     }
 }
@@ -944,10 +1308,53 @@ VkImageUsageFlags toVkImageUsage(RhiTextureUsage usage) {
     return flags;
 }
 
+namespace {
+
+VkImageCreateInfo frameGraphImageInfo(const RhiTextureDesc& desc) {
+    VkImageUsageFlags usage = toVkImageUsage(desc.usage);
+    if (isDepthFormat(desc.format)) {
+        usage &= ~VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    }
+    if (desc.storageMode == RhiTextureStorageMode::Memoryless) {
+        // Lazily allocated memory only accepts attachment usage.
+        usage &= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+
+    VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = toVkFormat(desc.format);
+    imageInfo.extent = {desc.width, desc.height, 1};
+    imageInfo.mipLevels = std::max(desc.mipLevels, 1u);
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    return imageInfo;
+}
+
+} // namespace
+
 // --- VulkanFrameGraphBackend ---
 
 VulkanFrameGraphBackend::VulkanFrameGraphBackend(VkDevice device, VkPhysicalDevice physicalDevice, VmaAllocator allocator)
-    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator) {}
+    : m_device(device), m_physicalDevice(physicalDevice), m_allocator(allocator) {
+    if (physicalDevice == VK_NULL_HANDLE) {
+        return;
+    }
+    // Tile-based GPUs expose lazily allocated memory; desktop GPUs usually do not.
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0) {
+            m_lazilyAllocatedMemory = true;
+            break;
+        }
+    }
+}
 
 std::unique_ptr<RhiTexture> VulkanFrameGraphBackend::createTexture(const RhiTextureDesc& desc) {
     // Try the transient pool first (avoids VMA allocation if a matching resource is cached).
@@ -958,30 +1365,14 @@ std::unique_ptr<RhiTexture> VulkanFrameGraphBackend::createTexture(const RhiText
         }
     }
 
-    VkFormat vkFormat = toVkFormat(desc.format);
-    bool depth = isDepthFormat(desc.format);
-
-    VkImageUsageFlags usage = toVkImageUsage(desc.usage);
-    if (depth) {
-        usage &= ~VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-        usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-    }
-
     VmaImageCreateInfo vmaInfo{};
     vmaInfo.device = m_device;
     vmaInfo.allocator = m_allocator;
-    vmaInfo.depth = depth;
-    vmaInfo.imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    vmaInfo.imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    vmaInfo.imageInfo.format = vkFormat;
-    vmaInfo.imageInfo.extent = {desc.width, desc.height, 1};
-    vmaInfo.imageInfo.mipLevels = 1;
-    vmaInfo.imageInfo.arrayLayers = 1;
-    vmaInfo.imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    vmaInfo.imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    vmaInfo.imageInfo.usage = usage;
-    vmaInfo.imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    vmaInfo.imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    vmaInfo.depth = isDepthFormat(desc.format);
+    vmaInfo.imageInfo = frameGraphImageInfo(desc);
+    vmaInfo.lazilyAllocated = desc.storageMode == RhiTextureStorageMode::Memoryless;
+    vmaInfo.memoryTag = frameGraphMemoryTag();
+    vmaInfo.debugName = "FrameGraph Texture";
 
     const char* errorMsg = nullptr;
     auto resource = vmaCreateImageResource(vmaInfo, &errorMsg);
@@ -998,6 +1389,9 @@ std::unique_ptr<RhiBuffer> VulkanFrameGraphBackend::createBuffer(const RhiBuffer
     if (m_transientPool) {
         auto pooled = m_transientPool->acquireBuffer(desc);
         if (pooled) {
+            if (desc.initialData && rhiBufferMemoryIsHostVisible(desc.memory) && pooled->mappedData()) {
+                std::memcpy(pooled->mappedData(), desc.initialData, desc.size);
+            }
             return pooled;
         }
     }
@@ -1013,13 +1407,14 @@ std::unique_ptr<RhiBuffer> VulkanFrameGraphBackend::createBuffer(const RhiBuffer
     vmaInfo.allocator = m_allocator;
     vmaInfo.size = desc.size;
     vmaInfo.usage = usage;
-    vmaInfo.hostVisible = desc.hostVisible;
+    vulkanApplyBufferMemory(vmaInfo, desc.memory);
     vmaInfo.sharedWithTransferQueue = desc.sharedWithTransferQueue;
     vmaInfo.graphicsQueueFamily = resourceContext.graphicsQueueFamily;
     vmaInfo.transferQueueFamily = resourceContext.transferQueueFamily;
     vmaInfo.externalMemoryHandleTypes =
         vulkanHostVisibleExternalMemoryHandleTypes(vmaInfo.hostVisible,
                                                    resourceContext.externalHostMemoryEnabled);
+    vmaInfo.memoryTag = frameGraphMemoryTag();
     vmaInfo.debugName = desc.debugName;
 
     const char* errorMsg = nullptr;
@@ -1035,6 +1430,258 @@ std::unique_ptr<RhiBuffer> VulkanFrameGraphBackend::createBuffer(const RhiBuffer
     return std::make_unique<VulkanOwnedBuffer>(*resource);
 }
 
+void VulkanFrameGraphBackend::recycleTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) {
+    if (m_transientPool) {
+        m_transientPool->releaseTexture(std::move(texture), desc);
+    }
+}
+
+void VulkanFrameGraphBackend::recycleBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) {
+    if (m_transientPool) {
+        m_transientPool->releaseBuffer(std::move(buffer), desc);
+    }
+}
+
+bool VulkanFrameGraphBackend::createPlacedTextures(std::vector<RhiTransientTextureRequest>& requests,
+                                                   uint64_t& outHeapBytes) {
+    outHeapBytes = 0;
+    std::vector<VulkanTextureResource> resources(requests.size());
+    auto destroyImages = [&]() {
+        for (auto& resource : resources) {
+            vulkanDestroyMipViews(resource);
+            if (resource.imageView != VK_NULL_HANDLE) {
+                vkDestroyImageView(m_device, resource.imageView, nullptr);
+            }
+            if (resource.image != VK_NULL_HANDLE) {
+                vkDestroyImage(m_device, resource.image, nullptr);
+            }
+        }
+    };
+
+    std::vector<RhiTransientAllocationInfo> allocations(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const VkImageCreateInfo imageInfo = frameGraphImageInfo(requests[i].desc);
+        VulkanTextureResource& resource = resources[i];
+        if (vkCreateImage(m_device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: placed image creation failed, using dedicated transients");
+            destroyImages();
+            return false;
+        }
+        resource.device = m_device;
+        resource.allocator = m_allocator;
+        resource.width = imageInfo.extent.width;
+        resource.height = imageInfo.extent.height;
+        resource.mipLevels = imageInfo.mipLevels;
+        resource.format = imageInfo.format;
+        resource.usage = requests[i].desc.usage;
+
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(m_device, resource.image, &requirements);
+        allocations[i].sizeBytes = requirements.size;
+        allocations[i].alignment = requirements.alignment;
+        allocations[i].memoryTypeBits = requirements.memoryTypeBits;
+        allocations[i].firstPass = requests[i].firstPass;
+        allocations[i].lastPass = requests[i].lastPass;
+    }
+
+    std::vector<RhiTransientHeapLayout> heapLayouts;
+    const std::vector<RhiTransientPlacement> placements =
+        rhiPlaceTransientAllocations(allocations, heapLayouts);
+
+    std::vector<std::shared_ptr<VulkanTransientHeap>> heaps;
+    heaps.reserve(heapLayouts.size());
+    for (const RhiTransientHeapLayout& layout : heapLayouts) {
+        VkMemoryRequirements requirements{};
+        requirements.size = layout.sizeBytes;
+        requirements.alignment = layout.alignment;
+        requirements.memoryTypeBits = layout.memoryTypeBits;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+        auto heap = std::make_shared<VulkanTransientHeap>();
+        heap->allocator = m_allocator;
+        if (vmaAllocateMemory(m_allocator, &requirements, &allocInfo, &heap->allocation, nullptr) !=
+            VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to allocate a {:.1f} MB transient heap",
+                         double(layout.sizeBytes) / (1024.0 * 1024.0));
+            heap->allocation = nullptr;
+            destroyImages();
+            return false;
+        }
+        vmaSetAllocationName(m_allocator, heap->allocation, "FrameGraph Transient Heap");
+        vulkanTrackAllocation(m_allocator, heap->allocation, RhiMemoryTag::Transients, "FrameGraph Transient Heap");
+        heaps.push_back(std::move(heap));
+        outHeapBytes += layout.sizeBytes;
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        VulkanTextureResource& resource = resources[i];
+        const RhiTransientPlacement& placement = placements[i];
+        if (vmaBindImageMemory2(m_allocator, heaps[placement.heapIndex]->allocation,
+                                placement.offset, resource.image, nullptr) != VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to bind a placed transient image");
+            destroyImages();
+            outHeapBytes = 0;
+            return false;
+        }
+
+        VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        viewInfo.image = resource.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = resource.format;
+        viewInfo.subresourceRange.aspectMask = isDepthFormat(requests[i].desc.format)
+                                                   ? VK_IMAGE_ASPECT_DEPTH_BIT
+                                                   : VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = resource.mipLevels;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(m_device, &viewInfo, nullptr, &resource.imageView) != VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to create a placed transient image view");
+            destroyImages();
+            outHeapBytes = 0;
+            return false;
+        }
+        if (resource.mipLevels > 1 &&
+            (requests[i].desc.usage & RhiTextureUsage::ShaderWrite) != RhiTextureUsage::None &&
+            !vulkanCreateMipViews(resource, viewInfo.subresourceRange.aspectMask)) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to create placed transient mip views");
+            destroyImages();
+            outHeapBytes = 0;
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].texture =
+            std::make_unique<VulkanPlacedTexture>(resources[i], heaps[placements[i].heapIndex]);
+        requests[i].heapIndex = placements[i].heapIndex;
+        requests[i].heapOffset = placements[i].offset;
+        requests[i].sizeBytes = allocations[i].sizeBytes;
+        requests[i].aliased = placements[i].aliased;
+    }
+    return true;
+}
+
+bool VulkanFrameGraphBackend::createSubAllocatedBuffers(std::vector<RhiTransientBufferRequest>& requests,
+                                                        uint64_t& outHeapBytes) {
+    outHeapBytes = 0;
+    const VulkanResourceContextInfo& resourceContext = vulkanGetResourceContext();
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    usage = vulkanEnableBufferDeviceAddress(usage, resourceContext.bufferDeviceAddressEnabled);
+
+    std::vector<VulkanBufferResource> resources(requests.size());
+    auto destroyBuffers = [&]() {
+        for (auto& resource : resources) {
+            if (resource.buffer != VK_NULL_HANDLE) {
+                vkDestroyBuffer(m_device, resource.buffer, nullptr);
+            }
+        }
+    };
+
+    std::vector<RhiTransientAllocationInfo> allocations(requests.size());
+    std::vector<uint32_t> heapKeys(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        bufferInfo.size = requests[i].desc.size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VulkanBufferResource& resource = resources[i];
+        if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &resource.buffer) != VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: sub-allocated buffer creation failed, using dedicated transients");
+            destroyBuffers();
+            return false;
+        }
+        resource.device = m_device;
+        resource.allocator = m_allocator;
+        resource.size = requests[i].desc.size;
+        resource.usageFlags = usage;
+
+        VkMemoryRequirements requirements{};
+        vkGetBufferMemoryRequirements(m_device, resource.buffer, &requirements);
+        allocations[i].sizeBytes = requirements.size;
+        allocations[i].alignment = requirements.alignment;
+        allocations[i].memoryTypeBits = requirements.memoryTypeBits;
+        heapKeys[i] = static_cast<uint32_t>(requests[i].desc.memory);
+    }
+
+    std::vector<RhiTransientHeapLayout> heapLayouts;
+    const std::vector<RhiTransientPlacement> placements =
+        rhiPackTransientAllocationsLinear(allocations, heapKeys, heapLayouts);
+
+    std::vector<RhiBufferMemory> heapMemory(heapLayouts.size(), RhiBufferMemory::DeviceLocal);
+    for (size_t i = 0; i < placements.size(); ++i) {
+        heapMemory[placements[i].heapIndex] = requests[i].desc.memory;
+    }
+
+    std::vector<std::shared_ptr<VulkanTransientHeap>> heaps;
+    heaps.reserve(heapLayouts.size());
+    for (uint32_t heapIndex = 0; heapIndex < heapLayouts.size(); ++heapIndex) {
+        const RhiTransientHeapLayout& layout = heapLayouts[heapIndex];
+        VkMemoryRequirements requirements{};
+        requirements.size = layout.sizeBytes;
+        requirements.alignment = layout.alignment;
+        requirements.memoryTypeBits = layout.memoryTypeBits;
+        const VmaAllocationCreateInfo allocInfo = transientBufferHeapAllocInfo(heapMemory[heapIndex]);
+
+        auto heap = std::make_shared<VulkanTransientHeap>();
+        heap->allocator = m_allocator;
+        VmaAllocationInfo allocationInfo{};
+        if (vmaAllocateMemory(m_allocator, &requirements, &allocInfo, &heap->allocation, &allocationInfo) !=
+            VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to allocate a {:.1f} MB transient buffer heap",
+                         double(layout.sizeBytes) / (1024.0 * 1024.0));
+            heap->allocation = nullptr;
+            destroyBuffers();
+            return false;
+        }
+        heap->mappedData = allocationInfo.pMappedData;
+        vmaSetAllocationName(m_allocator, heap->allocation, "FrameGraph Transient Buffer Heap");
+        vulkanTrackAllocation(m_allocator, heap->allocation, RhiMemoryTag::Transients,
+                              "FrameGraph Transient Buffer Heap");
+        heaps.push_back(std::move(heap));
+        outHeapBytes += layout.sizeBytes;
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        VulkanBufferResource& resource = resources[i];
+        const RhiTransientPlacement& placement = placements[i];
+        const VulkanTransientHeap& heap = *heaps[placement.heapIndex];
+        if (vmaBindBufferMemory2(m_allocator, heap.allocation, placement.offset, resource.buffer, nullptr) !=
+            VK_SUCCESS) {
+            spdlog::warn("VulkanFrameGraphBackend: failed to bind a sub-allocated transient buffer");
+            destroyBuffers();
+            outHeapBytes = 0;
+            return false;
+        }
+        if (heap.mappedData) {
+            resource.mappedData = static_cast<uint8_t*>(heap.mappedData) + placement.offset;
+            if (requests[i].desc.initialData) {
+                std::memcpy(resource.mappedData, requests[i].desc.initialData, requests[i].desc.size);
+            }
+        }
+        if (vulkanBufferUsesDeviceAddress(usage)) {
+            VkBufferDeviceAddressInfo addrInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+            addrInfo.buffer = resource.buffer;
+            resource.deviceAddress = vkGetBufferDeviceAddress(m_device, &addrInfo);
+        }
+        if (requests[i].desc.debugName && requests[i].desc.debugName[0] != '\0') {
+            vulkanSetObjectDebugName(m_device, VK_OBJECT_TYPE_BUFFER, vulkanObjectHandle(resource.buffer),
+                                     requests[i].desc.debugName);
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].buffer = std::make_unique<VulkanPlacedBuffer>(resources[i], heaps[placements[i].heapIndex]);
+        requests[i].heapIndex = placements[i].heapIndex;
+        requests[i].heapOffset = placements[i].offset;
+        requests[i].sizeBytes = allocations[i].sizeBytes;
+    }
+    return true;
+}
+
 // --- VulkanCommandBuffer ---
 
 VulkanCommandBuffer::VulkanCommandBuffer(VkCommandBuffer commandBuffer, VkDevice device,
@@ -1057,7 +1704,7 @@ void VulkanCommandBuffer::transitionTexture(const RhiTexture* texture, VkImageLa
         return;
     }
 
-    m_stateTracker->requireImageState(resource->image, layout, imageAspectMask(resource));
+    m_stateTracker->requireImageState(*resource, layout, imageAspectMask(resource));
     m_stateTracker->flushBarriers(m_commandBuffer);
 }
 
@@ -1066,16 +1713,29 @@ void VulkanCommandBuffer::prepareTextureForSampling(const RhiTexture* texture) {
     auto* resource = getVulkanTextureResource(texture);
     if (!resource || resource->image == VK_NULL_HANDLE) return;
     // Accumulate without flushing — FrameGraph calls flushBarriers() after all reads
-    m_stateTracker->requireImageState(resource->image,
+    m_stateTracker->requireImageState(*resource,
                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                                       imageAspectMask(resource));
 }
 
+void VulkanCommandBuffer::discardTexture(const RhiTexture* texture) {
+    if (!texture || !m_stateTracker) return;
+    auto* resource = getVulkanTextureResource(texture);
+    if (!resource || resource->image == VK_NULL_HANDLE) return;
+    // The next requireImageState transitions from UNDEFINED and waits on all prior
+    // commands, which orders it after the previous occupant of the shared memory.
+    VulkanResourceStateTracker::ImageState state;
+    state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    state.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    state.accessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+    m_stateTracker->setImageState(*resource, state);
+}
+
 void VulkanCommandBuffer::prepareTextureForStorage(const RhiTexture* texture) {
     if (!texture || !m_stateTracker) return;
     auto* resource = getVulkanTextureResource(texture);
     if (!resource || resource->image == VK_NULL_HANDLE) return;
-    m_stateTracker->requireImageState(resource->image,
+    m_stateTracker->requireImageState(*resource,
                                       VK_IMAGE_LAYOUT_GENERAL,
                                       imageAspectMask(resource));
 }
@@ -1084,7 +1744,7 @@ void VulkanCommandBuffer::prepareTextureForTransferSrc(const RhiTexture* texture
     if (!texture || !m_stateTracker) return;
     auto* resource = getVulkanTextureResource(texture);
     if (!resource || resource->image == VK_NULL_HANDLE) return;
-    m_stateTracker->requireImageState(resource->image,
+    m_stateTracker->requireImageState(*resource,
                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                                       imageAspectMask(resource));
 }
@@ -1093,7 +1753,7 @@ void VulkanCommandBuffer::prepareTextureForTransferDst(const RhiTexture* texture
     if (!texture || !m_stateTracker) return;
     auto* resource = getVulkanTextureResource(texture);
     if (!resource || resource->image == VK_NULL_HANDLE) return;
-    m_stateTracker->requireImageState(resource->image,
+    m_stateTracker->requireImageState(*resource,
                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                       imageAspectMask(resource));
 }
@@ -1104,7 +1764,7 @@ void VulkanCommandBuffer::prepareBufferForStorageRead(const RhiBuffer* buffer) {
     }
 
     requireTrackedBufferState(m_stateTracker,
-                              getVulkanBufferHandle(buffer),
+                              getVulkanBufferResource(buffer),
                               0,
                               VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
                               VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
@@ -1116,7 +1776,7 @@ void VulkanCommandBuffer::prepareBufferForStorageWrite(const RhiBuffer* buffer)
     }
 
     requireTrackedBufferState(m_stateTracker,
-                              getVulkanBufferHandle(buffer),
+                              getVulkanBufferResource(buffer),
                               0,
                               VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
                               VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
@@ -1129,7 +1789,7 @@ void VulkanCommandBuffer::prepareBufferForIndirect(const RhiBuffer* buffer) {
     }
 
     requireTrackedBufferState(m_stateTracker,
-                              getVulkanBufferHandle(buffer),
+                              getVulkanBufferResource(buffer),
                               0,
                               VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
                               VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
@@ -1141,7 +1801,7 @@ void VulkanCommandBuffer::prepareBufferForIndexInput(const RhiBuffer* buffer) {
     }
 
     requireTrackedBufferState(m_stateTracker,
-                              getVulkanBufferHandle(buffer),
+                              getVulkanBufferResource(buffer),
                               0,
                               VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT,
                               VK_ACCESS_2_INDEX_READ_BIT);
@@ -1153,7 +1813,7 @@ void VulkanCommandBuffer::prepareBufferForVertexInput(const RhiBuffer* buffer) {
     }
 
     requireTrackedBufferState(m_stateTracker,
-                              getVulkanBufferHandle(buffer),
+                              getVulkanBufferResource(buffer),
                               0,
                               VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
                               VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
@@ -1161,23 +1821,240 @@ void VulkanCommandBuffer::prepareBufferForVertexInput(const RhiBuffer* buffer) {
 
 void VulkanCommandBuffer::flushBarriers() {
     if (m_stateTracker) {
-        m_stateTracker->flushBarriers(m_commandBuffer);
+        // The frame graph flushes a pass's transitions after setting its queue hint.
+        const bool asyncPass = m_nextPassHint == RhiQueueHint::AsyncCompute &&
+                               m_asyncComputeCommandBuffer != VK_NULL_HANDLE;
+        m_stateTracker->flushBarriers(asyncPass ? m_asyncComputeCommandBuffer : m_commandBuffer);
+    }
+}
+
+void VulkanCommandBuffer::enableQueueSegments(RhiContext& context) {
+    if (!vulkanSupportsQueueSegments(context)) {
+        m_asyncComputeCommandBuffer = VK_NULL_HANDLE;
+        return;
+    }
+    m_queueSegmentContext = &context;
+    m_graphicsQueueFamily = getVulkanGraphicsQueueFamily(context);
+    m_computeQueueFamily = getVulkanComputeQueueFamily(context);
+}
+
+void VulkanCommandBuffer::enableParallelRecording(RhiContext& context) {
+    if (!m_descriptorManager || !m_stateTracker) {
+        return;
+    }
+    m_parallelContext = &context;
+    m_lockedDescriptorManager = std::make_unique<VulkanLockedDescriptorBackend>(*m_descriptorManager);
+}
+
+bool VulkanCommandBuffer::beginParallelRecording(uint32_t count) {
+    if (!m_parallelContext || count == 0u) {
+        return false;
+    }
+
+    // Workers start from copies of the tracker, so nothing may be left pending here.
+    m_stateTracker->flushBarriers(m_commandBuffer);
+    if (m_parallelSlots.size() < count) {
+        m_parallelSlots.resize(count);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        // Secondaries begun before a failure are reset with the frame's pools unused.
+        VkCommandBuffer secondary = vulkanBeginParallelCommandBuffer(*m_parallelContext, i);
+        if (secondary == VK_NULL_HANDLE) {
+            return false;
+        }
+        ParallelSlot& slot = m_parallelSlots[i];
+        slot.nativeCommandBuffer = secondary;
+        slot.stateTracker = *m_stateTracker;
+        slot.stateTracker.resetStats();
+        slot.commandBuffer = std::make_unique<VulkanCommandBuffer>(secondary,
+                                                                   m_device,
+                                                                   m_lockedDescriptorManager.get(),
+                                                                   &slot.stateTracker);
+    }
+    m_parallelBaseline = *m_stateTracker;
+    m_parallelCount = count;
+    return true;
+}
+
+RhiCommandBuffer* VulkanCommandBuffer::parallelCommandBuffer(uint32_t index) {
+    return index < m_parallelCount ? m_parallelSlots[index].commandBuffer.get() : nullptr;
+}
+
+void VulkanCommandBuffer::endParallelRecording() {
+    if (m_parallelCount == 0u) {
+        return;
+    }
+
+    std::vector<VkCommandBuffer> secondaries;
+    secondaries.reserve(m_parallelCount);
+    for (uint32_t i = 0; i < m_parallelCount; ++i) {
+        ParallelSlot& slot = m_parallelSlots[i];
+        slot.stateTracker.flushBarriers(slot.nativeCommandBuffer);
+        slot.commandBuffer.reset();
+        if (vkEndCommandBuffer(slot.nativeCommandBuffer) != VK_SUCCESS) {
+            spdlog::error("VulkanCommandBuffer: failed to end parallel recording slot {}", i);
+            continue;
+        }
+        // Later slots win, matching the order the secondaries execute in.
+        m_stateTracker->mergeChangedStates(m_parallelBaseline, slot.stateTracker);
+        secondaries.push_back(slot.nativeCommandBuffer);
+    }
+    if (!secondaries.empty()) {
+        vkCmdExecuteCommands(m_commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+    }
+    m_parallelCount = 0u;
+}
+
+void VulkanCommandBuffer::queueHandoff(const RhiQueueHandoff& handoff) {
+    if (!m_queueSegmentContext || m_asyncComputeCommandBuffer == VK_NULL_HANDLE) {
+        return;
+    }
+
+    const bool fromAsync = handoff.from == RhiQueueHint::AsyncCompute;
+    VkCommandBuffer releaseCommandBuffer = fromAsync ? m_asyncComputeCommandBuffer : m_commandBuffer;
+    const uint32_t srcFamily = fromAsync ? m_computeQueueFamily : m_graphicsQueueFamily;
+    const uint32_t dstFamily = fromAsync ? m_graphicsQueueFamily : m_computeQueueFamily;
+    // Resources are exclusive to one family; a shared family only needs the semaphore.
+    const bool ownershipTransfer = srcFamily != dstFamily;
+
+    std::vector<VkImageMemoryBarrier2> imageReleases;
+    std::vector<VkImageMemoryBarrier2> imageAcquires;
+    std::vector<VkBufferMemoryBarrier2> bufferReleases;
+    std::vector<VkBufferMemoryBarrier2> bufferAcquires;
+    std::vector<const VulkanTextureResource*> images;
+    std::vector<const VulkanBufferResource*> buffers;
+
+    if (m_stateTracker) {
+        m_stateTracker->flushBarriers(releaseCommandBuffer);
+    }
+
+    for (const RhiTexture* texture : handoff.textures) {
+        auto* resource = texture ? getVulkanTextureResource(texture) : nullptr;
+        if (!resource || resource->image == VK_NULL_HANDLE) {
+            continue;
+        }
+        const VulkanResourceStateTracker::ImageState* state =
+            m_stateTracker ? m_stateTracker->getImageState(*resource) : nullptr;
+        // Undefined contents need no transfer; the next use discards them anyway.
+        if (!state || (state->layout == VK_IMAGE_LAYOUT_UNDEFINED &&
+                       m_stateTracker->hasUniformImageState(*resource))) {
+            continue;
+        }
+        images.push_back(resource);
+        if (!ownershipTransfer) {
+            continue;
+        }
+
+        m_stateTracker->forEachImageRange(
+            *resource, imageAspectMask(resource),
+            [&](const VulkanResourceStateTracker::ImageState& rangeState, const VkImageSubresourceRange& range) {
+                if (rangeState.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+                    return;
+                }
+                VkImageMemoryBarrier2 release{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+                release.srcStageMask = rangeState.stageMask;
+                release.srcAccessMask = rangeState.accessMask;
+                release.oldLayout = rangeState.layout;
+                release.newLayout = rangeState.layout;
+                release.srcQueueFamilyIndex = srcFamily;
+                release.dstQueueFamilyIndex = dstFamily;
+                release.image = resource->image;
+                release.subresourceRange = range;
+                imageReleases.push_back(release);
+
+                VkImageMemoryBarrier2 acquire = release;
+                acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                acquire.srcAccessMask = VK_ACCESS_2_NONE;
+                acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+                imageAcquires.push_back(acquire);
+            });
+    }
+
+    for (const RhiBuffer* rhiBuffer : handoff.buffers) {
+        const VulkanBufferResource* resource = rhiBuffer ? getVulkanBufferResource(rhiBuffer) : nullptr;
+        if (!resource || resource->buffer == VK_NULL_HANDLE) {
+            continue;
+        }
+        const VkBuffer buffer = resource->buffer;
+        buffers.push_back(resource);
+        if (!ownershipTransfer) {
+            continue;
+        }
+
+        const VulkanResourceStateTracker::BufferState* state =
+            m_stateTracker ? m_stateTracker->getBufferState(*resource) : nullptr;
+        VkBufferMemoryBarrier2 release{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2};
+        release.srcStageMask = state ? state->stageMask : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        release.srcAccessMask = state ? state->accessMask : VK_ACCESS_2_MEMORY_WRITE_BIT;
+        release.srcQueueFamilyIndex = srcFamily;
+        release.dstQueueFamilyIndex = dstFamily;
+        release.buffer = buffer;
+        release.size = VK_WHOLE_SIZE;
+        bufferReleases.push_back(release);
+
+        VkBufferMemoryBarrier2 acquire = release;
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        bufferAcquires.push_back(acquire);
+    }
+
+    auto recordBarriers = [](VkCommandBuffer commandBuffer,
+                             const std::vector<VkImageMemoryBarrier2>& imageBarriers,
+                             const std::vector<VkBufferMemoryBarrier2>& bufferBarriers) {
+        if (imageBarriers.empty() && bufferBarriers.empty()) {
+            return;
+        }
+        VkDependencyInfo dependencyInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    };
+
+    recordBarriers(releaseCommandBuffer, imageReleases, bufferReleases);
+    if (!vulkanSplitQueueSegments(*m_queueSegmentContext, fromAsync)) {
+        spdlog::error("Failed to split queue segments; async compute disabled for this frame");
+        m_asyncComputeCommandBuffer = VK_NULL_HANDLE;
+        m_queueSegmentContext = nullptr;
+        return;
+    }
+    m_commandBuffer = getVulkanCurrentCommandBuffer(*m_queueSegmentContext);
+    m_asyncComputeCommandBuffer = getVulkanCurrentComputeCommandBuffer(*m_queueSegmentContext);
+    m_hadAsyncComputeWork = true;
+    recordBarriers(fromAsync ? m_commandBuffer : m_asyncComputeCommandBuffer, imageAcquires, bufferAcquires);
+
+    // The semaphore wait plus the acquire make all prior writes visible on the new queue.
+    for (const VulkanTextureResource* resource : images) {
+        m_stateTracker->setImageAccess(*resource, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_NONE);
+    }
+    if (m_stateTracker) {
+        for (const VulkanBufferResource* buffer : buffers) {
+            m_stateTracker->setBufferState(*buffer,
+                                           {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                            VK_ACCESS_2_NONE,
+                                            VK_QUEUE_FAMILY_IGNORED});
+        }
     }
 }
 
-std::unique_ptr<RhiRenderCommandEncoder> VulkanCommandBuffer::beginRenderPass(const RhiRenderPassDesc& desc) {
+RhiEncoderPtr<RhiRenderCommandEncoder> VulkanCommandBuffer::beginRenderPass(const RhiRenderPassDesc& desc) {
     // Accumulate layout transitions for all attachments, then batch-flush
     if (m_stateTracker) {
         for (uint32_t i = 0; i < desc.colorAttachmentCount; ++i) {
-            if (desc.colorAttachments[i].texture) {
-                VkImage image = getVulkanImage(desc.colorAttachments[i].texture);
-                m_stateTracker->requireImageState(image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            if (const VulkanTextureResource* resource =
+                    getVulkanTextureResource(desc.colorAttachments[i].texture)) {
+                m_stateTracker->requireImageState(*resource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
             }
         }
-        if (desc.depthAttachment.bound && desc.depthAttachment.texture) {
-            VkImage image = getVulkanImage(desc.depthAttachment.texture);
-            m_stateTracker->requireImageState(image, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
-                                              VK_IMAGE_ASPECT_DEPTH_BIT);
+        if (desc.depthAttachment.bound) {
+            if (const VulkanTextureResource* resource = getVulkanTextureResource(desc.depthAttachment.texture)) {
+                m_stateTracker->requireImageState(*resource, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                                                  VK_IMAGE_ASPECT_DEPTH_BIT);
+            }
         }
         m_stateTracker->flushBarriers(m_commandBuffer);
     }
@@ -1232,20 +2109,19 @@ std::unique_ptr<RhiRenderCommandEncoder> VulkanCommandBuffer::beginRenderPass(co
         renderingInfo.pDepthAttachment = &depthAttachment;
     }
 
-    return std::make_unique<VulkanRenderCommandEncoder>(m_commandBuffer,
-                                                        m_device,
-                                                        m_descriptorManager,
-                                                        m_stateTracker,
-                                                        m_gpuProfiler,
-                                                        desc.label,
-                                                        renderingInfo,
-                                                        colorAttachments,
-                                                        desc.depthAttachment.bound && desc.depthAttachment.texture
-                                                            ? &depthAttachment
-                                                            : nullptr);
+    return rhiThreadEncoderPool<VulkanRenderCommandEncoder>().acquire<RhiRenderCommandEncoder>(
+        m_commandBuffer,
+        m_device,
+        m_descriptorManager,
+        m_stateTracker,
+        m_gpuProfiler,
+        desc.label,
+        renderingInfo,
+        colorAttachments,
+        desc.depthAttachment.bound && desc.depthAttachment.texture ? &depthAttachment : nullptr);
 }
 
-std::unique_ptr<RhiComputeCommandEncoder> VulkanCommandBuffer::beginComputePass(const RhiComputePassDesc& desc) {
+RhiEncoderPtr<RhiComputeCommandEncoder> VulkanCommandBuffer::beginComputePass(const RhiComputePassDesc& desc) {
     // Route to dedicated async compute queue if hint requests it and we have one
     const bool wantAsync = (m_nextPassHint == RhiQueueHint::AsyncCompute);
     VkCommandBuffer targetCmdBuf = m_commandBuffer;
@@ -1258,24 +2134,17 @@ std::unique_ptr<RhiComputeCommandEncoder> VulkanCommandBuffer::beginComputePass(
         profiler = nullptr;
     }
     m_nextPassHint = RhiQueueHint::Auto; // consume hint
-    return std::make_unique<VulkanComputeCommandEncoder>(targetCmdBuf,
-                                                         m_device,
-                                                         m_descriptorManager,
-                                                         m_stateTracker,
-                                                         profiler,
-                                                         desc.label);
+    return rhiThreadEncoderPool<VulkanComputeCommandEncoder>().acquire<RhiComputeCommandEncoder>(
+        targetCmdBuf, m_device, m_descriptorManager, m_stateTracker, profiler, desc.label);
 }
 
 void VulkanCommandBuffer::setNextPassQueueHint(RhiQueueHint hint) {
     m_nextPassHint = hint;
 }
 
-std::unique_ptr<RhiBlitCommandEncoder> VulkanCommandBuffer::beginBlitPass(const RhiBlitPassDesc& desc) {
-    return std::make_unique<VulkanBlitCommandEncoder>(m_commandBuffer,
-                                                      m_device,
-                                                      m_stateTracker,
-                                                      m_gpuProfiler,
-                                                      desc.label);
+RhiEncoderPtr<RhiBlitCommandEncoder> VulkanCommandBuffer::beginBlitPass(const RhiBlitPassDesc& desc) {
+    return rhiThreadEncoderPool<VulkanBlitCommandEncoder>().acquire<RhiBlitCommandEncoder>(
+        m_commandBuffer, m_device, m_stateTracker, m_gpuProfiler, desc.label);
 }
 
 #endif // _WIN32
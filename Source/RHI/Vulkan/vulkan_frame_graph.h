@@ -22,6 +22,7 @@ public:
     {
         set(image, imageView, w, h);
     }
+    ~VulkanImportedTexture() override { vulkanReleaseResourceStateSlot(m_resource.header); }
 
     void set(VkImage image,
              VkImageView imageView,
@@ -61,12 +62,20 @@ public:
 
     std::unique_ptr<RhiTexture> createTexture(const RhiTextureDesc& desc) override;
     std::unique_ptr<RhiBuffer> createBuffer(const RhiBufferDesc& desc) override;
+    bool createPlacedTextures(std::vector<RhiTransientTextureRequest>& requests,
+                              uint64_t& outHeapBytes) override;
+    bool createSubAllocatedBuffers(std::vector<RhiTransientBufferRequest>& requests,
+                                   uint64_t& outHeapBytes) override;
+    bool supportsMemorylessTextures() const override { return m_lazilyAllocatedMemory; }
+    void recycleTexture(std::unique_ptr<RhiTexture> texture, const RhiTextureDesc& desc) override;
+    void recycleBuffer(std::unique_ptr<RhiBuffer> buffer, const RhiBufferDesc& desc) override;
 
 private:
     VkDevice m_device = VK_NULL_HANDLE;
     VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
     VmaAllocator m_allocator = nullptr;
     VulkanTransientPool* m_transientPool = nullptr;
+    bool m_lazilyAllocatedMemory = false;
 };
 
 // Command buffer abstraction
@@ -78,9 +87,9 @@ public:
                         VulkanGpuProfiler* gpuProfiler = nullptr,
                         VkCommandBuffer asyncComputeCommandBuffer = VK_NULL_HANDLE);
 
-    std::unique_ptr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) override;
-    std::unique_ptr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) override;
-    std::unique_ptr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) override;
+    RhiEncoderPtr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) override;
+    RhiEncoderPtr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) override;
+    RhiEncoderPtr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) override;
     void prepareTextureForSampling(const RhiTexture* texture) override;
     void prepareTextureForStorage(const RhiTexture* texture) override;
     void prepareTextureForTransferSrc(const RhiTexture* texture) override;
@@ -92,8 +101,22 @@ public:
     void prepareBufferForVertexInput(const RhiBuffer* buffer) override;
     void flushBarriers() override;
     void setNextPassQueueHint(RhiQueueHint hint) override;
+    void discardTexture(const RhiTexture* texture) override;
+    void queueHandoff(const RhiQueueHandoff& handoff) override;
     void transitionTexture(const RhiTexture* texture, VkImageLayout layout);
 
+    // Lets queueHandoff() split the frame into queue segments on 'context'. Async compute
+    // routing is disabled when the context cannot order work across queues.
+    void enableQueueSegments(RhiContext& context);
+
+    // Lets the frame graph record independent passes into secondary command buffers on
+    // worker threads. Those passes share the descriptor backend behind a lock and are
+    // not GPU-profiled individually.
+    void enableParallelRecording(RhiContext& context);
+    bool beginParallelRecording(uint32_t count) override;
+    RhiCommandBuffer* parallelCommandBuffer(uint32_t index) override;
+    void endParallelRecording() override;
+
     // Returns true if any work was submitted to the async compute command buffer this frame.
     bool hadAsyncComputeWork() const { return m_hadAsyncComputeWork; }
 
@@ -106,6 +129,22 @@ private:
     VulkanGpuProfiler* m_gpuProfiler = nullptr;
     RhiQueueHint m_nextPassHint = RhiQueueHint::Auto;
     bool m_hadAsyncComputeWork = false;
+    RhiContext* m_queueSegmentContext = nullptr;
+    uint32_t m_graphicsQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t m_computeQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+
+    // One per worker pass: a secondary command buffer recording against a copy of the
+    // frame's state tracker, merged back in slot order by endParallelRecording().
+    struct ParallelSlot {
+        VkCommandBuffer nativeCommandBuffer = VK_NULL_HANDLE;
+        VulkanResourceStateTracker stateTracker;
+        std::unique_ptr<VulkanCommandBuffer> commandBuffer;
+    };
+    RhiContext* m_parallelContext = nullptr;
+    std::unique_ptr<VulkanLockedDescriptorBackend> m_lockedDescriptorManager;
+    VulkanResourceStateTracker m_parallelBaseline;
+    std::vector<ParallelSlot> m_parallelSlots;
+    uint32_t m_parallelCount = 0;
 };
 
 // Load mesh shader extension functions (call once after device creation)
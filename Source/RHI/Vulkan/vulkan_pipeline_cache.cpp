@@ -4,8 +4,10 @@
 
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -27,6 +29,53 @@ std::string uuidToHex(const uint8_t uuid[VK_UUID_SIZE]) {
     return oss.str();
 }
 
+constexpr uint32_t kEntryMagic   = 0x4543504du; // "MPCE"
+constexpr uint32_t kEntryVersion = 1u;
+
+struct EntryFileHeader {
+    uint32_t magic    = kEntryMagic;
+    uint32_t version  = kEntryVersion;
+    uint64_t key      = 0;
+    uint64_t dataSize = 0;
+    uint64_t checksum = 0;
+};
+
+bool writeFileAtomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+    const std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    if (!out) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::copy_file(tempPath, path,
+                                   std::filesystem::copy_options::overwrite_existing, ec);
+        std::filesystem::remove(tempPath, ec);
+    }
+    return !ec;
+}
+
+bool readCacheData(VkDevice device, VkPipelineCache cache, std::vector<uint8_t>& outData) {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        return false;
+    }
+    outData.resize(dataSize);
+    if (vkGetPipelineCacheData(device, cache, &dataSize, outData.data()) != VK_SUCCESS) {
+        return false;
+    }
+    outData.resize(dataSize);
+    return true;
+}
+
 } // namespace
 
 // --- VulkanPipelineCacheManager ---
@@ -39,6 +88,9 @@ bool VulkanPipelineCacheManager::load(VkDevice device,
     // Build a device-unique filename: <vendor>_<device>_<uuid>.bin
     VkPhysicalDeviceProperties props{};
     vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    m_vendorID = props.vendorID;
+    m_deviceID = props.deviceID;
+    std::memcpy(m_pipelineCacheUUID.data(), props.pipelineCacheUUID, VK_UUID_SIZE);
 
     std::ostringstream name;
     name << std::hex << std::setfill('0')
@@ -50,10 +102,11 @@ bool VulkanPipelineCacheManager::load(VkDevice device,
     const std::filesystem::path dir(cacheDir);
     const std::filesystem::path filePath = dir / name.str();
     m_cachePath = filePath.string();
+    m_entryDir = (dir / filePath.stem()).string();
 
-    // Ensure the cache directory exists.
+    // Ensure the cache directories exist.
     std::error_code ec;
-    std::filesystem::create_directories(dir, ec);
+    std::filesystem::create_directories(m_entryDir, ec);
     if (ec) {
         spdlog::warn("VulkanPipelineCache: could not create cache dir '{}': {}",
                      cacheDir, ec.message());
@@ -96,6 +149,8 @@ bool VulkanPipelineCacheManager::load(VkDevice device,
         return false;
     }
 
+    m_stopWriter = false;
+    m_writer = std::thread([this]() { writerLoop(); });
     return true;
 }
 
@@ -146,6 +201,16 @@ bool VulkanPipelineCacheManager::save() {
 }
 
 void VulkanPipelineCacheManager::destroy() {
+    // The writer drains its queue before exiting, so every queued entry reaches disk.
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        m_stopWriter = true;
+    }
+    m_writeCondition.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+
     if (m_cache != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
         vkDestroyPipelineCache(m_device, m_cache, nullptr);
         m_cache = VK_NULL_HANDLE;
@@ -153,6 +218,7 @@ void VulkanPipelineCacheManager::destroy() {
 }
 
 void VulkanPipelineCacheManager::recordCompile(double ms, bool isGraphics) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
     if (isGraphics) {
         ++m_graphicsCount;
     } else {
@@ -162,9 +228,209 @@ void VulkanPipelineCacheManager::recordCompile(double ms, bool isGraphics) {
 }
 
 void VulkanPipelineCacheManager::resetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
     m_graphicsCount  = 0;
     m_computeCount   = 0;
     m_totalCompileMs = 0.0;
+    m_entryHits       = 0;
+    m_entryMisses     = 0;
+    m_entryStale      = 0;
+    m_entriesRejected = 0;
+    m_entriesWritten  = 0;
+}
+
+// --- Per-pipeline entries ---
+
+uint64_t VulkanPipelineCacheManager::hashKey(const void* data, size_t size, uint64_t seed) {
+    // FNV-1a
+    uint64_t hash = seed;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string VulkanPipelineCacheManager::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_entryDir) / name).string();
+}
+
+bool VulkanPipelineCacheManager::validateVulkanHeader(const std::vector<uint8_t>& data) const {
+    // VkPipelineCacheHeaderVersionOne: size, version, vendorID, deviceID, UUID.
+    constexpr size_t kHeaderSize = 16 + VK_UUID_SIZE;
+    if (data.size() < kHeaderSize) {
+        return false;
+    }
+    uint32_t fields[4];
+    std::memcpy(fields, data.data(), sizeof(fields));
+    return fields[0] >= kHeaderSize &&
+           fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           fields[2] == m_vendorID &&
+           fields[3] == m_deviceID &&
+           std::memcmp(data.data() + 16, m_pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+bool VulkanPipelineCacheManager::readEntry(uint64_t key, std::vector<uint8_t>& outData) {
+    const std::string path = entryPath(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const std::streamsize fileSize = file.tellg();
+    EntryFileHeader header;
+    bool valid = fileSize >= static_cast<std::streamsize>(sizeof(header));
+    if (valid) {
+        file.seekg(0, std::ios::beg);
+        valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header)));
+    }
+    valid = valid &&
+            header.magic == kEntryMagic &&
+            header.version == kEntryVersion &&
+            header.key == key &&
+            header.dataSize == static_cast<uint64_t>(fileSize) - sizeof(header);
+    if (valid) {
+        outData.resize(static_cast<size_t>(header.dataSize));
+        valid = static_cast<bool>(file.read(reinterpret_cast<char*>(outData.data()),
+                                            static_cast<std::streamsize>(outData.size()))) &&
+                hashKey(outData.data(), outData.size()) == header.checksum &&
+                validateVulkanHeader(outData);
+    }
+    if (!valid) {
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        m_entriesRejected.fetch_add(1u, std::memory_order_relaxed);
+        spdlog::warn("VulkanPipelineCache: discarded invalid entry '{}'", path);
+        outData.clear();
+    }
+    return valid;
+}
+
+VulkanPipelineCacheEntry VulkanPipelineCacheManager::beginEntry(uint64_t key) {
+    VulkanPipelineCacheEntry entry;
+    entry.key = key;
+    if (m_device == VK_NULL_HANDLE || m_entryDir.empty()) {
+        return entry;
+    }
+
+    std::vector<uint8_t> data;
+    entry.loaded = readEntry(key, data);
+
+    VkPipelineCacheCreateInfo createInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+    if (entry.loaded) {
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData    = data.data();
+    }
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &entry.cache) != VK_SUCCESS) {
+        entry.cache = VK_NULL_HANDLE;
+        entry.loaded = false;
+    }
+    return entry;
+}
+
+void VulkanPipelineCacheManager::endEntry(VulkanPipelineCacheEntry& entry, bool compiled) {
+    if (entry.cache == VK_NULL_HANDLE) {
+        return;
+    }
+    if (!entry.loaded) {
+        m_entryMisses.fetch_add(1u, std::memory_order_relaxed);
+    } else if (compiled) {
+        m_entryStale.fetch_add(1u, std::memory_order_relaxed);
+    } else {
+        m_entryHits.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    std::vector<uint8_t> data;
+    if (compiled && readCacheData(m_device, entry.cache, data)) {
+        EntryFileHeader header;
+        header.key = entry.key;
+        header.dataSize = data.size();
+        header.checksum = hashKey(data.data(), data.size());
+
+        std::vector<uint8_t> bytes(sizeof(header) + data.size());
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::memcpy(bytes.data() + sizeof(header), data.data(), data.size());
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_writeQueue.emplace_back(entryPath(entry.key), std::move(bytes));
+        }
+        m_writeCondition.notify_one();
+    }
+
+    vkDestroyPipelineCache(m_device, entry.cache, nullptr);
+    entry.cache = VK_NULL_HANDLE;
+}
+
+template <typename CreateInfo, typename CreateFn>
+static VkResult createWithEntry(VulkanPipelineCacheManager& manager,
+                                uint64_t key,
+                                const CreateInfo& info,
+                                VkPipeline& outPipeline,
+                                CreateFn&& create) {
+    VulkanPipelineCacheEntry entry = manager.beginEntry(key);
+    const VkPipelineCache cache = entry.cache != VK_NULL_HANDLE ? entry.cache : manager.handle();
+
+    // Without cache control a loaded entry is trusted; with it, the probe proves the
+    // driver can build the pipeline from the entry alone.
+    bool compiled = !entry.loaded;
+    if (entry.loaded && manager.creationCacheControl()) {
+        CreateInfo probe = info;
+        probe.flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
+        if (create(cache, probe, outPipeline) == VK_SUCCESS) {
+            manager.endEntry(entry, false);
+            return VK_SUCCESS;
+        }
+        outPipeline = VK_NULL_HANDLE;
+        compiled = true;
+    }
+
+    const VkResult result = create(cache, info, outPipeline);
+    manager.endEntry(entry, compiled && result == VK_SUCCESS);
+    return result;
+}
+
+VkResult VulkanPipelineCacheManager::createGraphicsPipeline(uint64_t key,
+                                                            const VkGraphicsPipelineCreateInfo& info,
+                                                            VkPipeline& outPipeline) {
+    return createWithEntry(*this, key, info, outPipeline,
+                           [&](VkPipelineCache cache, const VkGraphicsPipelineCreateInfo& createInfo,
+                               VkPipeline& pipeline) {
+                               return vkCreateGraphicsPipelines(m_device, cache, 1, &createInfo, nullptr, &pipeline);
+                           });
+}
+
+VkResult VulkanPipelineCacheManager::createComputePipeline(uint64_t key,
+                                                           const VkComputePipelineCreateInfo& info,
+                                                           VkPipeline& outPipeline) {
+    return createWithEntry(*this, key, info, outPipeline,
+                           [&](VkPipelineCache cache, const VkComputePipelineCreateInfo& createInfo,
+                               VkPipeline& pipeline) {
+                               return vkCreateComputePipelines(m_device, cache, 1, &createInfo, nullptr, &pipeline);
+                           });
+}
+
+void VulkanPipelineCacheManager::writerLoop() {
+    for (;;) {
+        std::pair<std::string, std::vector<uint8_t>> write;
+        {
+            std::unique_lock<std::mutex> lock(m_writeMutex);
+            m_writeCondition.wait(lock, [this]() { return m_stopWriter || !m_writeQueue.empty(); });
+            if (m_writeQueue.empty()) {
+                return;
+            }
+            write = std::move(m_writeQueue.front());
+            m_writeQueue.pop_front();
+        }
+        if (writeFileAtomically(write.first, write.second)) {
+            m_entriesWritten.fetch_add(1u, std::memory_order_relaxed);
+        } else {
+            spdlog::warn("VulkanPipelineCache: could not write entry '{}'", write.first);
+        }
+    }
 }
 
 #endif // _WIN32
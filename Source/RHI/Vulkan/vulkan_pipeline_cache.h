@@ -2,8 +2,16 @@
 
 #ifdef _WIN32
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <vulkan/vulkan.h>
 
@@ -17,6 +25,20 @@
 //   2. Pass cache.handle() to every vkCreateGraphicsPipelines /
 //      vkCreateComputePipelines call.
 //   3. Before vkDestroyDevice:  cache.save();  cache.destroy();
+//
+// Backend-created pipelines also get a cache entry of their own, keyed by a hash of
+// their SPIR-V and state and stored next to the blob as <device>/<key>.bin. Entries
+// are written by a background thread as soon as a pipeline misses, so a crash only
+// loses the pipelines compiled after the last write. Entries that fail validation
+// (truncated, wrong checksum, different device/driver) are deleted and recompiled.
+
+// One pipeline creation against its own cache entry; see beginEntry/endEntry.
+struct VulkanPipelineCacheEntry {
+    uint64_t key = 0;
+    VkPipelineCache cache = VK_NULL_HANDLE; // seeded from disk, or empty
+    bool loaded = false;                    // a validated entry was found on disk
+};
+
 class VulkanPipelineCacheManager {
 public:
     VulkanPipelineCacheManager() = default;
@@ -42,24 +64,72 @@ public:
     VkPipelineCache handle() const { return m_cache; }
     bool isValid()          const { return m_cache != VK_NULL_HANDLE; }
 
+    // --- Per-pipeline entries (thread-safe) ---
+
+    static uint64_t hashKey(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
+
+    // VK_EXT_pipeline_creation_cache_control lets loaded entries be probed with
+    // FAIL_ON_PIPELINE_COMPILE_REQUIRED, so stale entries are told apart from hits.
+    void setCreationCacheControl(bool enabled) { m_creationCacheControl = enabled; }
+    bool creationCacheControl() const { return m_creationCacheControl; }
+
+    VulkanPipelineCacheEntry beginEntry(uint64_t key);
+    // compiled: the driver had to compile (miss or stale entry). Queues the entry's
+    // data for writing in that case, updates hit/miss counts, and destroys the cache.
+    void endEntry(VulkanPipelineCacheEntry& entry, bool compiled);
+
+    // Probe-then-compile against the entry; counts hits, stale entries and misses.
+    VkResult createGraphicsPipeline(uint64_t key, const VkGraphicsPipelineCreateInfo& info, VkPipeline& outPipeline);
+    VkResult createComputePipeline(uint64_t key, const VkComputePipelineCreateInfo& info, VkPipeline& outPipeline);
+
     // --- Compile telemetry ---
 
     // Called by pipeline-creation wrappers after each successful compile.
-    // ms: wall-clock milliseconds for the compile call.
+    // ms: wall-clock milliseconds for the compile call. Safe to call from the
+    // worker threads that build pipelines in parallel.
     void recordCompile(double ms, bool isGraphics);
 
     uint32_t graphicsPipelinesCompiled() const { return m_graphicsCount; }
     uint32_t computePipelinesCompiled()  const { return m_computeCount; }
     double   totalCompileMs()            const { return m_totalCompileMs; }
 
+    uint32_t entryHits()       const { return m_entryHits.load(std::memory_order_relaxed); }
+    uint32_t entryMisses()     const { return m_entryMisses.load(std::memory_order_relaxed); }
+    uint32_t entryStale()      const { return m_entryStale.load(std::memory_order_relaxed); }
+    uint32_t entriesRejected() const { return m_entriesRejected.load(std::memory_order_relaxed); }
+    uint32_t entriesWritten()  const { return m_entriesWritten.load(std::memory_order_relaxed); }
+
     // Reset counters (e.g. between reloads).
     void resetStats();
 
 private:
+    bool readEntry(uint64_t key, std::vector<uint8_t>& outData);
+    bool validateVulkanHeader(const std::vector<uint8_t>& data) const;
+    std::string entryPath(uint64_t key) const;
+    void writerLoop();
+
     VkDevice        m_device          = VK_NULL_HANDLE;
     VkPipelineCache m_cache           = VK_NULL_HANDLE;
     std::string     m_cachePath;       // full path to the .bin file
-
+    std::string     m_entryDir;        // per-pipeline entries for this device
+    uint32_t        m_vendorID        = 0;
+    uint32_t        m_deviceID        = 0;
+    std::array<uint8_t, VK_UUID_SIZE> m_pipelineCacheUUID{};
+    bool            m_creationCacheControl = false;
+
+    std::mutex m_writeMutex;
+    std::condition_variable m_writeCondition;
+    std::deque<std::pair<std::string, std::vector<uint8_t>>> m_writeQueue;
+    std::thread m_writer;
+    bool m_stopWriter = false;
+
+    std::atomic<uint32_t> m_entryHits{0};
+    std::atomic<uint32_t> m_entryMisses{0};
+    std::atomic<uint32_t> m_entryStale{0};
+    std::atomic<uint32_t> m_entriesRejected{0};
+    std::atomic<uint32_t> m_entriesWritten{0};
+
+    std::mutex m_statsMutex;
     uint32_t m_graphicsCount  = 0;
     uint32_t m_computeCount   = 0;
     double   m_totalCompileMs = 0.0;
@@ -0,0 +1,378 @@
+#include "vulkan_pipeline_library.h"
+
+#ifdef _WIN32
+
+#include "vulkan_resource_handles.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+template <typename T>
+void appendKeyBytes(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool isPreRasterizationStage(VkShaderStageFlagBits stage) {
+    return stage == VK_SHADER_STAGE_VERTEX_BIT ||
+           stage == VK_SHADER_STAGE_MESH_BIT_EXT ||
+           stage == VK_SHADER_STAGE_TASK_BIT_EXT;
+}
+
+// Interface libraries depend only on this state, so pipelines that agree on it share one.
+std::string vertexInputKey(const VkGraphicsPipelineCreateInfo& info) {
+    std::string key = "vi";
+    const VkPipelineVertexInputStateCreateInfo& vertexInput = *info.pVertexInputState;
+    for (uint32_t i = 0; i < vertexInput.vertexBindingDescriptionCount; ++i) {
+        appendKeyBytes(key, vertexInput.pVertexBindingDescriptions[i]);
+    }
+    key += '|';
+    for (uint32_t i = 0; i < vertexInput.vertexAttributeDescriptionCount; ++i) {
+        appendKeyBytes(key, vertexInput.pVertexAttributeDescriptions[i]);
+    }
+    if (info.pInputAssemblyState) {
+        appendKeyBytes(key, info.pInputAssemblyState->topology);
+        appendKeyBytes(key, info.pInputAssemblyState->primitiveRestartEnable);
+    }
+    return key;
+}
+
+std::string fragmentOutputKey(const VkGraphicsPipelineCreateInfo& info) {
+    std::string key = "fo";
+    const auto* rendering = static_cast<const VkPipelineRenderingCreateInfo*>(info.pNext);
+    if (rendering && rendering->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO) {
+        appendKeyBytes(key, rendering->viewMask);
+        for (uint32_t i = 0; i < rendering->colorAttachmentCount; ++i) {
+            appendKeyBytes(key, rendering->pColorAttachmentFormats[i]);
+        }
+        appendKeyBytes(key, rendering->depthAttachmentFormat);
+        appendKeyBytes(key, rendering->stencilAttachmentFormat);
+    }
+    key += '|';
+    if (info.pColorBlendState) {
+        appendKeyBytes(key, info.pColorBlendState->logicOpEnable);
+        appendKeyBytes(key, info.pColorBlendState->logicOp);
+        for (uint32_t i = 0; i < info.pColorBlendState->attachmentCount; ++i) {
+            appendKeyBytes(key, info.pColorBlendState->pAttachments[i]);
+        }
+    }
+    if (info.pMultisampleState) {
+        appendKeyBytes(key, info.pMultisampleState->rasterizationSamples);
+        appendKeyBytes(key, info.pMultisampleState->alphaToCoverageEnable);
+    }
+    return key;
+}
+
+VkPipeline linkLibraries(VkDevice device,
+                         VkPipelineCache pipelineCache,
+                         VkPipelineCreateFlags flags,
+                         VkPipelineLayout layout,
+                         const std::vector<VkPipeline>& libraries,
+                         VkResult& result) {
+    VkPipelineLibraryCreateInfoKHR libraryInfo{VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR};
+    libraryInfo.libraryCount = static_cast<uint32_t>(libraries.size());
+    libraryInfo.pLibraries = libraries.data();
+
+    VkGraphicsPipelineCreateInfo linkInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    linkInfo.pNext = &libraryInfo;
+    linkInfo.flags = flags;
+    linkInfo.layout = layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateGraphicsPipelines(device, pipelineCache, 1, &linkInfo, nullptr, &pipeline);
+    return result == VK_SUCCESS ? pipeline : VK_NULL_HANDLE;
+}
+
+} // namespace
+
+void VulkanPipelineLibraryLinker::init(VkDevice device,
+                                       VkPipelineCache pipelineCache,
+                                       VkPipelineCreateFlags baseFlags) {
+    m_device = device;
+    m_pipelineCache = pipelineCache;
+    m_baseFlags = baseFlags;
+    m_stopWorker = false;
+    m_worker = std::thread([this]() { workerLoop(); });
+    spdlog::info("VulkanPipelineLibrary: fast-link path enabled");
+}
+
+void VulkanPipelineLibraryLinker::destroy() {
+    if (m_device == VK_NULL_HANDLE) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopWorker = true;
+        m_queue.clear();
+    }
+    m_queueCondition.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+
+    for (const auto& [pipeline, serial] : m_retired) {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+    m_retired.clear();
+    m_pending.clear();
+    for (const auto& [key, library] : m_interfaceLibraries) {
+        vkDestroyPipeline(m_device, library, nullptr);
+    }
+    m_interfaceLibraries.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+VkPipeline VulkanPipelineLibraryLinker::createLibrary(VkGraphicsPipelineLibraryFlagsEXT libraryFlags,
+                                                      VkPipelineCache cache,
+                                                      const VkGraphicsPipelineCreateInfo& info,
+                                                      const VkPipelineShaderStageCreateInfo* stages,
+                                                      uint32_t stageCount) const {
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{
+        VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT};
+    libraryInfo.pNext = info.pNext;
+    libraryInfo.flags = libraryFlags;
+
+    // Each library only reads the state of the subsets it was created with.
+    VkGraphicsPipelineCreateInfo libraryCreateInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    libraryCreateInfo.pNext = &libraryInfo;
+    libraryCreateInfo.flags = m_baseFlags |
+                              VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                              VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    libraryCreateInfo.stageCount = stageCount;
+    libraryCreateInfo.pStages = stageCount > 0 ? stages : nullptr;
+    libraryCreateInfo.pDynamicState = info.pDynamicState;
+    if (libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) {
+        libraryCreateInfo.pVertexInputState = info.pVertexInputState;
+        libraryCreateInfo.pInputAssemblyState = info.pInputAssemblyState;
+    }
+    if (libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT) {
+        libraryCreateInfo.pViewportState = info.pViewportState;
+        libraryCreateInfo.pRasterizationState = info.pRasterizationState;
+        libraryCreateInfo.layout = info.layout;
+    }
+    if (libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) {
+        libraryCreateInfo.pDepthStencilState = info.pDepthStencilState;
+        libraryCreateInfo.pMultisampleState = info.pMultisampleState;
+        libraryCreateInfo.layout = info.layout;
+    }
+    if (libraryFlags & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT) {
+        libraryCreateInfo.pColorBlendState = info.pColorBlendState;
+        libraryCreateInfo.pMultisampleState = info.pMultisampleState;
+    }
+
+    VkPipeline library = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(m_device, cache, 1, &libraryCreateInfo, nullptr, &library) !=
+        VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    return library;
+}
+
+VkPipeline VulkanPipelineLibraryLinker::interfaceLibrary(const std::string& key,
+                                                         VkGraphicsPipelineLibraryFlagsEXT libraryFlags,
+                                                         const VkGraphicsPipelineCreateInfo& info) {
+    std::lock_guard<std::mutex> lock(m_interfaceMutex);
+    auto it = m_interfaceLibraries.find(key);
+    if (it != m_interfaceLibraries.end()) {
+        return it->second;
+    }
+    VkPipeline library = createLibrary(libraryFlags, m_pipelineCache, info, nullptr, 0u);
+    if (library != VK_NULL_HANDLE) {
+        m_interfaceLibraries.emplace(key, library);
+    }
+    return library;
+}
+
+VkPipeline VulkanPipelineLibraryLinker::createLinkedPipeline(const VkGraphicsPipelineCreateInfo& info,
+                                                             VkPipelineCache shaderCache,
+                                                             std::shared_ptr<VulkanPipelineLinkState>& outState,
+                                                             std::string& errorMessage) {
+    std::vector<VkPipelineShaderStageCreateInfo> preRasterStages;
+    std::vector<VkPipelineShaderStageCreateInfo> fragmentStages;
+    for (uint32_t i = 0; i < info.stageCount; ++i) {
+        if (isPreRasterizationStage(info.pStages[i].stage)) {
+            preRasterStages.push_back(info.pStages[i]);
+        } else {
+            fragmentStages.push_back(info.pStages[i]);
+        }
+    }
+
+    auto state = std::make_shared<VulkanPipelineLinkState>();
+    state->device = m_device;
+    state->layout = info.layout;
+    state->flags = m_baseFlags;
+
+    // Mesh pipelines have no vertex input interface.
+    if (info.pVertexInputState) {
+        VkPipeline vertexInput =
+            interfaceLibrary(vertexInputKey(info), VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, info);
+        if (vertexInput == VK_NULL_HANDLE) {
+            errorMessage = "Failed to create vertex input pipeline library";
+            return VK_NULL_HANDLE;
+        }
+        state->linkLibraries.push_back(vertexInput);
+    }
+    VkPipeline fragmentOutput =
+        interfaceLibrary(fragmentOutputKey(info), VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, info);
+    if (fragmentOutput == VK_NULL_HANDLE) {
+        errorMessage = "Failed to create fragment output pipeline library";
+        return VK_NULL_HANDLE;
+    }
+    state->linkLibraries.push_back(fragmentOutput);
+
+    const VkPipeline preRaster = createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+                                               shaderCache,
+                                               info,
+                                               preRasterStages.data(),
+                                               static_cast<uint32_t>(preRasterStages.size()));
+    const VkPipeline fragment = createLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+                                              shaderCache,
+                                              info,
+                                              fragmentStages.data(),
+                                              static_cast<uint32_t>(fragmentStages.size()));
+    if (preRaster == VK_NULL_HANDLE || fragment == VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, preRaster, nullptr);
+        vkDestroyPipeline(m_device, fragment, nullptr);
+        errorMessage = "Failed to create shader pipeline libraries";
+        return VK_NULL_HANDLE;
+    }
+    state->shaderLibraries = {preRaster, fragment};
+    state->linkLibraries.push_back(preRaster);
+    state->linkLibraries.push_back(fragment);
+
+    VkResult result = VK_SUCCESS;
+    VkPipeline pipeline =
+        linkLibraries(m_device, shaderCache, m_baseFlags, info.layout, state->linkLibraries, result);
+    if (pipeline == VK_NULL_HANDLE) {
+        vulkanReleasePipelineLinkState(*state);
+        errorMessage = "Failed to fast-link graphics pipeline libraries (VkResult: " +
+                       std::to_string(result) + ")";
+        return VK_NULL_HANDLE;
+    }
+    m_fastLinkedCount.fetch_add(1u, std::memory_order_relaxed);
+    outState = std::move(state);
+    return pipeline;
+}
+
+void VulkanPipelineLibraryLinker::queueOptimizedLink(VulkanPipelineResource* resource,
+                                                     std::shared_ptr<VulkanPipelineLinkState> state) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.push_back(state);
+        m_pending.push_back({resource, std::move(state)});
+    }
+    m_queueCondition.notify_one();
+}
+
+void VulkanPipelineLibraryLinker::workerLoop() {
+    for (;;) {
+        std::shared_ptr<VulkanPipelineLinkState> state;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this]() { return m_stopWorker || !m_queue.empty(); });
+            if (m_stopWorker) {
+                return;
+            }
+            state = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->released) {
+                continue;
+            }
+            state->linking = true;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        VkResult result = VK_SUCCESS;
+        const VkPipeline optimized =
+            linkLibraries(state->device,
+                          m_pipelineCache,
+                          state->flags | VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT,
+                          state->layout,
+                          state->linkLibraries,
+                          result);
+        if (optimized == VK_NULL_HANDLE) {
+            spdlog::warn("VulkanPipelineLibrary: optimized link failed (VkResult: {}); keeping fast-linked pipeline",
+                         static_cast<int>(result));
+        } else {
+            spdlog::debug("VulkanPipelineLibrary: optimized link in {:.1f} ms",
+                          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->optimized = optimized;
+            state->linking = false;
+            state->finished = true;
+        }
+        state->idle.notify_all();
+    }
+}
+
+void VulkanPipelineLibraryLinker::publishOptimized(uint64_t submittedSerial, uint64_t completedSerial) {
+    if (m_device == VK_NULL_HANDLE) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> queueLock(m_queueMutex);
+    m_retired.erase(std::remove_if(m_retired.begin(),
+                                   m_retired.end(),
+                                   [&](const std::pair<VkPipeline, uint64_t>& retired) {
+                                       if (retired.second > completedSerial) {
+                                           return false;
+                                       }
+                                       vkDestroyPipeline(m_device, retired.first, nullptr);
+                                       return true;
+                                   }),
+                    m_retired.end());
+
+    // Recording for the next frame has not started, so swapping the handle is safe;
+    // frames already submitted may still reference the fast-linked pipeline.
+    m_pending.erase(std::remove_if(m_pending.begin(),
+                                   m_pending.end(),
+                                   [&](PendingLink& pending) {
+                                       std::lock_guard<std::mutex> lock(pending.state->mutex);
+                                       if (pending.state->released) {
+                                           return true;
+                                       }
+                                       if (!pending.state->finished) {
+                                           return false;
+                                       }
+                                       if (pending.state->optimized != VK_NULL_HANDLE) {
+                                           m_retired.emplace_back(pending.resource->pipeline, submittedSerial);
+                                           pending.resource->pipeline = pending.state->optimized;
+                                           pending.state->optimized = VK_NULL_HANDLE;
+                                           m_optimizedCount.fetch_add(1u, std::memory_order_relaxed);
+                                       }
+                                       return true;
+                                   }),
+                    m_pending.end());
+}
+
+uint32_t VulkanPipelineLibraryLinker::pendingOptimizedCount() const {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return static_cast<uint32_t>(m_pending.size());
+}
+
+void vulkanReleasePipelineLinkState(VulkanPipelineLinkState& state) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.released = true;
+    state.idle.wait(lock, [&]() { return !state.linking; });
+    if (state.optimized != VK_NULL_HANDLE) {
+        vkDestroyPipeline(state.device, state.optimized, nullptr);
+        state.optimized = VK_NULL_HANDLE;
+    }
+    for (VkPipeline library : state.shaderLibraries) {
+        vkDestroyPipeline(state.device, library, nullptr);
+    }
+    state.shaderLibraries.clear();
+    state.linkLibraries.clear();
+}
+
+#endif // _WIN32
@@ -0,0 +1,122 @@
+#pragma once
+
+#ifdef _WIN32
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+struct VulkanPipelineResource;
+
+// Per-pipeline state shared between a pipeline resource and the background
+// optimizer. The resource owns the shader libraries; the optimizer only reads them.
+struct VulkanPipelineLinkState {
+    std::mutex mutex;
+    std::condition_variable idle;
+    VkDevice device = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPipelineCreateFlags flags = 0;
+    std::vector<VkPipeline> shaderLibraries; // owned
+    std::vector<VkPipeline> linkLibraries;   // shader libraries + shared interface libraries
+    VkPipeline optimized = VK_NULL_HANDLE;   // finished optimized link awaiting publish
+    bool linking = false;
+    bool finished = false;
+    bool released = false; // owning resource is gone
+};
+
+// Builds graphics pipelines from VK_EXT_graphics_pipeline_library parts.
+//
+// Vertex-input and fragment-output interface libraries are cached by their state,
+// so only the pre-rasterization and fragment shader libraries are compiled per
+// pipeline. Those are fast-linked into a usable pipeline right away; a worker then
+// builds the link-time-optimized pipeline, which publishOptimized() swaps in at the
+// start of a frame. The fast-linked pipeline is destroyed once the GPU is done
+// with it.
+//
+// Typical lifecycle:
+//   1. After vkCreateDevice:  linker.init(device, pipelineCache, flags)
+//   2. createLinkedPipeline() in place of vkCreateGraphicsPipelines, then
+//      queueOptimizedLink() once the pipeline resource owns the link state.
+//   3. Every beginFrame:  linker.publishOptimized(submittedSerial, completedSerial)
+//   4. Before vkDestroyDevice (device idle):  linker.destroy()
+class VulkanPipelineLibraryLinker {
+public:
+    VulkanPipelineLibraryLinker() = default;
+    ~VulkanPipelineLibraryLinker() = default;
+
+    VulkanPipelineLibraryLinker(const VulkanPipelineLibraryLinker&) = delete;
+    VulkanPipelineLibraryLinker& operator=(const VulkanPipelineLibraryLinker&) = delete;
+
+    // baseFlags are applied to every library and link (e.g. descriptor buffer).
+    void init(VkDevice device, VkPipelineCache pipelineCache, VkPipelineCreateFlags baseFlags);
+    void destroy();
+    bool isEnabled() const { return m_device != VK_NULL_HANDLE; }
+
+    // Takes the monolithic create info the backend would have used and returns a
+    // fast-linked pipeline, or VK_NULL_HANDLE so the caller can fall back. The
+    // shader libraries compile against shaderCache (e.g. a per-pipeline entry).
+    // Thread-safe; the shader manager creates pipelines from worker threads.
+    VkPipeline createLinkedPipeline(const VkGraphicsPipelineCreateInfo& info,
+                                    VkPipelineCache shaderCache,
+                                    std::shared_ptr<VulkanPipelineLinkState>& outState,
+                                    std::string& errorMessage);
+    void queueOptimizedLink(VulkanPipelineResource* resource,
+                            std::shared_ptr<VulkanPipelineLinkState> state);
+
+    // Main thread, before any command recording for the new frame.
+    void publishOptimized(uint64_t submittedSerial, uint64_t completedSerial);
+
+    uint32_t fastLinkedCount() const { return m_fastLinkedCount.load(std::memory_order_relaxed); }
+    uint32_t optimizedCount() const { return m_optimizedCount.load(std::memory_order_relaxed); }
+    uint32_t pendingOptimizedCount() const;
+
+private:
+    struct PendingLink {
+        VulkanPipelineResource* resource = nullptr;
+        std::shared_ptr<VulkanPipelineLinkState> state;
+    };
+
+    VkPipeline interfaceLibrary(const std::string& key,
+                                VkGraphicsPipelineLibraryFlagsEXT libraryFlags,
+                                const VkGraphicsPipelineCreateInfo& info);
+    VkPipeline createLibrary(VkGraphicsPipelineLibraryFlagsEXT libraryFlags,
+                             VkPipelineCache cache,
+                             const VkGraphicsPipelineCreateInfo& info,
+                             const VkPipelineShaderStageCreateInfo* stages,
+                             uint32_t stageCount) const;
+    void workerLoop();
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    VkPipelineCreateFlags m_baseFlags = 0;
+
+    std::mutex m_interfaceMutex;
+    std::unordered_map<std::string, VkPipeline> m_interfaceLibraries;
+
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<std::shared_ptr<VulkanPipelineLinkState>> m_queue;
+    std::vector<PendingLink> m_pending;
+    std::vector<std::pair<VkPipeline, uint64_t>> m_retired; // {pipeline, last serial that may use it}
+    std::thread m_worker;
+    bool m_stopWorker = false;
+
+    std::atomic<uint32_t> m_fastLinkedCount{0};
+    std::atomic<uint32_t> m_optimizedCount{0};
+};
+
+// Called when the owning pipeline resource is released. Waits for an in-flight
+// optimized link, then destroys the shader libraries and any unpublished result.
+void vulkanReleasePipelineLinkState(VulkanPipelineLinkState& state);
+
+#endif // _WIN32
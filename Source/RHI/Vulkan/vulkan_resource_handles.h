@@ -6,10 +6,12 @@
 #include "rhi_backend.h"
 #include "bindless_scene_constants.h"
 #include "vulkan_descriptor_manager.h"
+#include "vulkan_memory_accounting.h"
 
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -17,6 +19,9 @@
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 
+struct VulkanPipelineLinkState;
+class VulkanRayTracingPipeline;
+
 enum class VulkanResourceType : uint32_t {
     Texture,
     Buffer,
@@ -28,8 +33,15 @@ enum class VulkanResourceType : uint32_t {
 
 struct VulkanResourceHeader {
     VulkanResourceType type = VulkanResourceType::Texture;
+    // Dense index into VulkanResourceStateTracker slot arrays; assigned on first use.
+    mutable uint32_t stateSlot = UINT32_MAX;
 };
 
+// Returns the header's state slot, assigning one if needed. Thread-safe.
+uint32_t vulkanResourceStateSlot(const VulkanResourceHeader& header);
+// Recycles the slot; call when the resource's image or buffer is destroyed.
+void vulkanReleaseResourceStateSlot(const VulkanResourceHeader& header);
+
 struct VulkanTextureResource {
     VulkanResourceHeader header{VulkanResourceType::Texture};
     VkDevice device = VK_NULL_HANDLE;
@@ -41,11 +53,13 @@ struct VulkanTextureResource {
     uint32_t height = 0;
     uint32_t depth = 1;
     uint32_t mipLevels = 1;
+    uint32_t arrayLayers = 1;
     VkFormat format = VK_FORMAT_UNDEFINED;
     RhiTextureUsage usage = RhiTextureUsage::None;
     uint32_t refCount = 1;
     bool ownsImage = true;
     bool ownsImageView = true;
+    std::vector<VkImageView> mipViews; // one per mip; only for mipped storage textures
 };
 
 struct VulkanBufferResource {
@@ -88,10 +102,16 @@ struct VulkanPipelineResource {
     std::vector<VkDescriptorSetLayout> setLayouts;
     std::vector<uint8_t> setLayoutOwnership;
     uint32_t bindlessSetIndex = UINT32_MAX;
+    uint32_t pushDescriptorSetIndex = UINT32_MAX; // written with vkCmdPushDescriptorSetKHR
     std::array<VulkanDescriptorBindingLocation, kMaxBufferBindings> bufferBindings{};
     std::array<VulkanDescriptorBindingLocation, kMaxTextureBindings> textureBindings{};
     std::array<VulkanDescriptorBindingLocation, kMaxSamplerBindings> samplerBindings{};
     std::array<VulkanDescriptorBindingLocation, kMaxAccelerationStructureBindings> accelerationStructureBindings{};
+    // Set when the pipeline was fast-linked from graphics pipeline libraries.
+    std::shared_ptr<VulkanPipelineLinkState> linkState;
+    // Set for ray tracing pipelines, which own their VkPipeline and shader binding
+    // table here; pipeline stays null and layout is the reflected layout.
+    std::shared_ptr<VulkanRayTracingPipeline> rayTracing;
 };
 
 struct VulkanAccelerationStructureResource {
@@ -151,6 +171,17 @@ inline VkImageView getVulkanImageView(const RhiTexture* texture) {
     return resource ? resource->imageView : VK_NULL_HANDLE;
 }
 
+inline VkImageView getVulkanImageMipView(const RhiTexture* texture, uint32_t mipLevel) {
+    const VulkanTextureResource* resource = getVulkanTextureResource(texture);
+    if (!resource) {
+        return VK_NULL_HANDLE;
+    }
+    if (mipLevel < resource->mipViews.size()) {
+        return resource->mipViews[mipLevel];
+    }
+    return mipLevel == 0 ? resource->imageView : VK_NULL_HANDLE;
+}
+
 inline VulkanBufferResource* getVulkanBufferResource(const RhiBuffer* buffer) {
     return buffer ? static_cast<VulkanBufferResource*>(buffer->nativeHandle()) : nullptr;
 }
@@ -301,13 +332,25 @@ struct VmaBufferCreateInfo {
     VkDeviceSize size = 0;
     VkBufferUsageFlags usage = 0;
     bool hostVisible = false;
+    bool hostReadback = false;      // cached memory for CPU reads; needs hostVisible
+    bool preferDeviceLocal = false; // host-visible VRAM; only requested with resizable BAR
     bool sharedWithTransferQueue = false;
     uint32_t graphicsQueueFamily = 0;
     uint32_t transferQueueFamily = UINT32_MAX;
     VkExternalMemoryHandleTypeFlags externalMemoryHandleTypes = 0;
+    RhiMemoryTag memoryTag = RhiMemoryTag::Untagged; // Untagged: the thread's RhiMemoryTagScope
     const char* debugName = nullptr;
 };
 
+inline void vulkanApplyBufferMemory(VmaBufferCreateInfo& info, RhiBufferMemory memory) {
+    info.hostVisible = rhiBufferMemoryIsHostVisible(memory);
+    info.hostReadback = memory == RhiBufferMemory::Readback;
+    // Without resizable BAR the mappable VRAM is a small window shared with the driver,
+    // so DynamicDeviceLocal degrades to Upload rather than competing for it.
+    info.preferDeviceLocal = memory == RhiBufferMemory::DynamicDeviceLocal &&
+                             vulkanGetResourceContext().resizableBarEnabled;
+}
+
 inline std::optional<VulkanBufferResource> vmaCreateBufferResource(const VmaBufferCreateInfo& info,
                                                                      const char** outErrorMessage = nullptr) {
     VkBufferCreateInfo bufferInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
@@ -334,9 +377,11 @@ inline std::optional<VulkanBufferResource> vmaCreateBufferResource(const VmaBuff
     }
 
     VmaAllocationCreateInfo allocCreateInfo{};
-    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocCreateInfo.usage = info.preferDeviceLocal ? VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+                                                   : VMA_MEMORY_USAGE_AUTO;
     if (info.hostVisible) {
-        allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        allocCreateInfo.flags = (info.hostReadback ? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+                                                   : VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT) |
                                 VMA_ALLOCATION_CREATE_MAPPED_BIT;
     }
 
@@ -372,6 +417,7 @@ inline std::optional<VulkanBufferResource> vmaCreateBufferResource(const VmaBuff
                                  vulkanObjectHandle(res.buffer),
                                  info.debugName);
     }
+    vulkanTrackAllocation(info.allocator, res.allocation, info.memoryTag, info.debugName);
 
     return res;
 }
@@ -382,13 +428,41 @@ struct VmaImageCreateInfo {
     VkImageCreateInfo imageInfo{};
     bool depth = false;
     bool dedicated = true;
+    bool lazilyAllocated = false; // transient attachment backed by tile memory
+    RhiMemoryTag memoryTag = RhiMemoryTag::Untagged; // Untagged: the thread's RhiMemoryTagScope
     const char* debugName = nullptr;
 };
 
+inline void vulkanDestroyMipViews(VulkanTextureResource& res) {
+    for (VkImageView view : res.mipViews) {
+        if (view != VK_NULL_HANDLE) {
+            vkDestroyImageView(res.device, view, nullptr);
+        }
+    }
+    res.mipViews.clear();
+}
+
+// Single-mip 2D views, so a pass can write one level while sampling the previous one.
+inline bool vulkanCreateMipViews(VulkanTextureResource& res, VkImageAspectFlags aspectMask) {
+    res.mipViews.assign(res.mipLevels, VK_NULL_HANDLE);
+    for (uint32_t mip = 0; mip < res.mipLevels; ++mip) {
+        VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+        viewInfo.image = res.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = res.format;
+        viewInfo.subresourceRange = {aspectMask, mip, 1, 0, 1};
+        if (vkCreateImageView(res.device, &viewInfo, nullptr, &res.mipViews[mip]) != VK_SUCCESS) {
+            vulkanDestroyMipViews(res);
+            return false;
+        }
+    }
+    return true;
+}
+
 inline std::optional<VulkanTextureResource> vmaCreateImageResource(const VmaImageCreateInfo& info,
                                                                      const char** outErrorMessage = nullptr) {
     VmaAllocationCreateInfo allocCreateInfo{};
-    allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocCreateInfo.usage = info.lazilyAllocated ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED : VMA_MEMORY_USAGE_AUTO;
     if (info.dedicated) {
         allocCreateInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
     }
@@ -400,6 +474,7 @@ inline std::optional<VulkanTextureResource> vmaCreateImageResource(const VmaImag
     res.height = info.imageInfo.extent.height;
     res.depth = info.imageInfo.extent.depth;
     res.mipLevels = info.imageInfo.mipLevels;
+    res.arrayLayers = info.imageInfo.arrayLayers;
     res.format = info.imageInfo.format;
 
     VkResult result = vmaCreateImage(info.allocator, &info.imageInfo, &allocCreateInfo,
@@ -434,6 +509,18 @@ inline std::optional<VulkanTextureResource> vmaCreateImageResource(const VmaImag
         return std::nullopt;
     }
 
+    if (res.mipLevels > 1 && info.imageInfo.imageType == VK_IMAGE_TYPE_2D &&
+        (info.imageInfo.usage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 &&
+        !vulkanCreateMipViews(res, viewInfo.subresourceRange.aspectMask)) {
+        vkDestroyImageView(info.device, res.imageView, nullptr);
+        vmaDestroyImage(info.allocator, res.image, res.allocation);
+        if (outErrorMessage) {
+            static constexpr const char* kMsg = "vmaCreateImageResource: mip view creation failed";
+            *outErrorMessage = kMsg;
+        }
+        return std::nullopt;
+    }
+
     if (info.debugName && info.debugName[0] != '\0') {
         vmaSetAllocationName(info.allocator, res.allocation, info.debugName);
         vulkanSetObjectDebugName(info.device,
@@ -446,12 +533,15 @@ inline std::optional<VulkanTextureResource> vmaCreateImageResource(const VmaImag
                                  vulkanObjectHandle(res.imageView),
                                  imageViewName.c_str());
     }
+    vulkanTrackAllocation(info.allocator, res.allocation, info.memoryTag, info.debugName);
 
     return res;
 }
 
 inline void vmaDestroyBufferResource(VulkanBufferResource& res) {
+    vulkanReleaseResourceStateSlot(res.header);
     if (res.buffer != VK_NULL_HANDLE && res.allocator != nullptr) {
+        vulkanUntrackAllocation(res.allocation);
         vmaDestroyBuffer(res.allocator, res.buffer, res.allocation);
         res.buffer = VK_NULL_HANDLE;
         res.allocation = nullptr;
@@ -459,11 +549,14 @@ inline void vmaDestroyBufferResource(VulkanBufferResource& res) {
 }
 
 inline void vmaDestroyImageResource(VulkanTextureResource& res) {
+    vulkanReleaseResourceStateSlot(res.header);
+    vulkanDestroyMipViews(res);
     if (res.imageView != VK_NULL_HANDLE && res.device != VK_NULL_HANDLE) {
         vkDestroyImageView(res.device, res.imageView, nullptr);
         res.imageView = VK_NULL_HANDLE;
     }
     if (res.image != VK_NULL_HANDLE && res.allocator != nullptr) {
+        vulkanUntrackAllocation(res.allocation);
         vmaDestroyImage(res.allocator, res.image, res.allocation);
         res.image = VK_NULL_HANDLE;
         res.allocation = nullptr;
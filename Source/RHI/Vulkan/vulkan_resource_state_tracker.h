@@ -2,19 +2,26 @@
 
 #ifdef _WIN32
 
+#include "vulkan_resource_handles.h"
+
 #include <vulkan/vulkan.h>
+#include <algorithm>
+#include <atomic>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <cstdint>
 
 // ---------------------------------------------------------------------------
 // VulkanResourceStateTracker
 //
-// Replaces VulkanImageLayoutTracker with a precise hazard-aware barrier system.
+// Precise hazard-aware barrier system.
 //
-// Improvements over the old tracker:
+// Features:
 //   - Tracks precise stage + access masks per resource (not just VkImageLayout)
-//   - Tracks per-buffer state (no buffer tracking existed before)
+//   - Tracks per-buffer state
+//   - Per-mip/layer image state once a caller touches part of an image
+//   - State lives in dense slot arrays indexed by VulkanResourceHeader::stateSlot
 //   - Accumulates barriers and batch-submits via a single vkCmdPipelineBarrier2
 //   - Read-after-read optimization: no barrier emitted when layout is unchanged
 //     and the new access is read-only (WAR/RAR-safe)
@@ -22,12 +29,12 @@
 //   - Debug statistics: barriers emitted, redundant skips, flush calls per frame
 //
 // Usage pattern:
-//   requireImageState(image, newLayout, dstStage, dstAccess, aspect);  // accumulate
+//   requireImageState(texture, newLayout, dstStage, dstAccess, aspect); // accumulate
 //   requireBufferState(buffer, offset, size, dstStage, dstAccess);      // accumulate
 //   flushBarriers(cmd);  // single vkCmdPipelineBarrier2 for all accumulated barriers
 //
 // Backward-compatible convenience:
-//   transition(cmd, image, newLayout, aspect);  // immediate (requires+flush in one call)
+//   transition(cmd, texture, newLayout, aspect);  // immediate (requires+flush in one call)
 // ---------------------------------------------------------------------------
 
 // Returns true if accessMask contains only read bits (no write bits).
@@ -106,12 +113,16 @@ public:
         VkPipelineStageFlags2 stageMask  = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
         VkAccessFlags2        accessMask = VK_ACCESS_2_NONE;
         uint32_t queueFamilyIndex        = VK_QUEUE_FAMILY_IGNORED;
+
+        bool operator==(const ImageState&) const = default;
     };
 
     struct BufferState {
         VkPipelineStageFlags2 stageMask  = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
         VkAccessFlags2        accessMask = VK_ACCESS_2_NONE;
         uint32_t queueFamilyIndex        = VK_QUEUE_FAMILY_IGNORED;
+
+        bool operator==(const BufferState&) const = default;
     };
 
     // -----------------------------------------------------------------------
@@ -131,165 +142,287 @@ public:
     // State management
     // -----------------------------------------------------------------------
 
-    void setImageState(VkImage image, const ImageState& state) {
-        m_imageStates[image] = state;
+    // Sets the state of every subresource of 'texture'.
+    void setImageState(const VulkanTextureResource& texture, const ImageState& state) {
+        if (texture.image == VK_NULL_HANDLE) return;
+        ImageSlot& slot = acquireImageSlot(texture);
+        slot.whole = state;
+        slot.subresources.clear();
     }
 
     // Backward-compat: set only layout (stage/access inferred from layout)
+    void setLayout(const VulkanTextureResource& texture, VkImageLayout layout) {
+        setImageState(texture, stateForLayout(layout));
+    }
+
+    // Images without a resource header (e.g. swapchain images). A resource that
+    // wraps the same image later adopts this state on its first use.
     void setLayout(VkImage image, VkImageLayout layout) {
-        ImageState state;
-        state.layout = layout;
-        deriveImageBarrierParams(layout, state.stageMask, state.accessMask);
-        m_imageStates[image] = state;
+        if (image == VK_NULL_HANDLE) return;
+        if (ImageSlot* slot = findLiveImageSlot(image)) {
+            slot->whole = stateForLayout(layout);
+            slot->subresources.clear();
+            return;
+        }
+        m_externalImages[image] = stateForLayout(layout);
     }
 
-    void setBufferState(VkBuffer buffer, const BufferState& state) {
-        m_bufferStates[buffer] = state;
+    void setBufferState(const VulkanBufferResource& buffer, const BufferState& state) {
+        if (buffer.buffer == VK_NULL_HANDLE) return;
+        acquireBufferSlot(buffer).state = state;
     }
 
-    void removeImage(VkImage image) { m_imageStates.erase(image); }
-    void removeBuffer(VkBuffer buffer) { m_bufferStates.erase(buffer); }
+    // Replaces stage/access/queue of every subresource and keeps the layouts, e.g.
+    // after a queue handoff made all prior writes visible.
+    void setImageAccess(const VulkanTextureResource& texture,
+                        VkPipelineStageFlags2 stageMask,
+                        VkAccessFlags2 accessMask,
+                        uint32_t queueFamilyIndex = VK_QUEUE_FAMILY_IGNORED) {
+        if (texture.image == VK_NULL_HANDLE) return;
+        ImageSlot& slot = acquireImageSlot(texture);
+        auto apply = [&](ImageState& state) {
+            state.stageMask = stageMask;
+            state.accessMask = accessMask;
+            state.queueFamilyIndex = queueFamilyIndex;
+        };
+        apply(slot.whole);
+        for (ImageState& state : slot.subresources) {
+            apply(state);
+        }
+    }
 
+    // Adopts every state 'recorded' changed relative to 'baseline' and adds its stats.
+    // Folds a tracker copy used by a worker thread back into this one.
+    void mergeChangedStates(const VulkanResourceStateTracker& baseline,
+                            const VulkanResourceStateTracker& recorded) {
+        for (uint32_t slotIndex : recorded.m_touchedImages) {
+            const ImageSlot& state = recorded.m_images[slotIndex];
+            const ImageSlot* before = baseline.liveImageSlot(slotIndex, state.image);
+            if (!before || before->whole != state.whole || before->subresources != state.subresources) {
+                ImageSlot& slot = imageSlotAt(slotIndex, state.image, state.mipLevels, state.arrayLayers);
+                slot.whole = state.whole;
+                slot.subresources = state.subresources;
+            }
+        }
+        for (const auto& [image, state] : recorded.m_externalImages) {
+            auto before = baseline.m_externalImages.find(image);
+            if (before == baseline.m_externalImages.end() || before->second != state) {
+                m_externalImages[image] = state;
+            }
+        }
+        for (uint32_t slotIndex : recorded.m_touchedBuffers) {
+            const BufferSlot& state = recorded.m_buffers[slotIndex];
+            const BufferSlot* before = baseline.liveBufferSlot(slotIndex, state.buffer);
+            if (!before || before->state != state.state) {
+                bufferSlotAt(slotIndex, state.buffer).state = state.state;
+            }
+        }
+        m_stats.imageBarriers += recorded.m_stats.imageBarriers;
+        m_stats.bufferBarriers += recorded.m_stats.bufferBarriers;
+        m_stats.memoryBarriers += recorded.m_stats.memoryBarriers;
+        m_stats.redundantSkips += recorded.m_stats.redundantSkips;
+        m_stats.flushCalls += recorded.m_stats.flushCalls;
+        m_stats.emptyFlushCalls += recorded.m_stats.emptyFlushCalls;
+    }
+
+    // Forgets all states in O(1) by advancing the epoch; slot storage is reused.
     void clear() {
-        m_imageStates.clear();
-        m_bufferStates.clear();
+        ++m_epoch;
+        m_touchedImages.clear();
+        m_touchedBuffers.clear();
+        m_externalImages.clear();
         m_pendingImageBarriers.clear();
         m_pendingBufferBarriers.clear();
         m_pendingMemoryBarriers.clear();
         resetStats();
     }
 
+    // Layout of the first subresource; UNDEFINED when untracked.
+    VkImageLayout getLayout(const VulkanTextureResource& texture) const {
+        const ImageState* state = getImageState(texture);
+        return state ? state->layout : VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
     VkImageLayout getLayout(VkImage image) const {
-        auto it = m_imageStates.find(image);
-        return (it != m_imageStates.end()) ? it->second.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        if (const ImageSlot* slot = findLiveImageSlot(image)) {
+            return slot->subresources.empty() ? slot->whole.layout : slot->subresources.front().layout;
+        }
+        auto it = m_externalImages.find(image);
+        return (it != m_externalImages.end()) ? it->second.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    // State of the whole image, or of mip 0 / layer 0 when subresources diverge
+    // (see hasUniformImageState and forEachImageRange).
+    const ImageState* getImageState(const VulkanTextureResource& texture) const {
+        const ImageSlot* slot = liveImageSlot(texture);
+        if (!slot) return nullptr;
+        return slot->subresources.empty() ? &slot->whole : &slot->subresources.front();
     }
 
-    const ImageState* getImageState(VkImage image) const {
-        auto it = m_imageStates.find(image);
-        return (it != m_imageStates.end()) ? &it->second : nullptr;
+    bool hasUniformImageState(const VulkanTextureResource& texture) const {
+        const ImageSlot* slot = liveImageSlot(texture);
+        return !slot || slot->subresources.empty();
     }
 
-    const BufferState* getBufferState(VkBuffer buffer) const {
-        auto it = m_bufferStates.find(buffer);
-        return (it != m_bufferStates.end()) ? &it->second : nullptr;
+    // Calls fn(state, range) for each run of mips with identical state, one layer at a
+    // time, or once for the whole image when it is uniform. Untracked images are skipped.
+    template <typename Fn>
+    void forEachImageRange(const VulkanTextureResource& texture, VkImageAspectFlags aspectMask, Fn&& fn) const {
+        const ImageSlot* slot = liveImageSlot(texture);
+        if (!slot) return;
+        if (slot->subresources.empty()) {
+            fn(slot->whole, VkImageSubresourceRange{aspectMask, 0, VK_REMAINING_MIP_LEVELS,
+                                                    0, VK_REMAINING_ARRAY_LAYERS});
+            return;
+        }
+        for (uint32_t layer = 0; layer < slot->arrayLayers; ++layer) {
+            const ImageState* states = &slot->subresources[size_t(layer) * slot->mipLevels];
+            uint32_t runBase = 0;
+            for (uint32_t mip = 1; mip <= slot->mipLevels; ++mip) {
+                if (mip == slot->mipLevels || states[mip] != states[runBase]) {
+                    fn(states[runBase], VkImageSubresourceRange{aspectMask, runBase, mip - runBase, layer, 1});
+                    runBase = mip;
+                }
+            }
+        }
+    }
+
+    const BufferState* getBufferState(const VulkanBufferResource& buffer) const {
+        const BufferSlot* slot = liveBufferSlot(buffer);
+        return slot ? &slot->state : nullptr;
     }
 
     // -----------------------------------------------------------------------
     // Barrier accumulation
     // -----------------------------------------------------------------------
 
-    // Declare that 'image' needs to be in 'newLayout' accessed via dstStage/dstAccess.
-    // If the current state already satisfies the requirement (RAR optimization), no
-    // barrier is accumulated. Otherwise a VkImageMemoryBarrier2 is pushed to the
-    // pending list and the stored state is updated.
+    // Declare that the given subresources of 'texture' need to be in 'newLayout'
+    // accessed via dstStage/dstAccess. Subresources whose current state already
+    // satisfies the requirement (RAR optimization) get no barrier; the rest get one
+    // VkImageMemoryBarrier2 per run of consecutive mips that share a prior state.
+    // State is kept per image until a call touches only part of it, then per
+    // mip/layer until the subresources converge again.
     //
     // Queue ownership transfer: set dstQueueFamily != VK_QUEUE_FAMILY_IGNORED and
     // different from current queueFamily to insert a release/acquire pair.
-    void requireImageState(VkImage                image,
-                           VkImageLayout          newLayout,
-                           VkPipelineStageFlags2  dstStage,
-                           VkAccessFlags2         dstAccess,
-                           VkImageAspectFlags     aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                           uint32_t               dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
-        if (image == VK_NULL_HANDLE) return;
+    void requireImageSubresourceState(const VulkanTextureResource& texture,
+                                      VkImageSubresourceRange range,
+                                      VkImageLayout         newLayout,
+                                      VkPipelineStageFlags2 dstStage,
+                                      VkAccessFlags2        dstAccess,
+                                      uint32_t              dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
+        if (texture.image == VK_NULL_HANDLE) return;
+
+        ImageSlot& slot = acquireImageSlot(texture);
+        range.baseMipLevel   = std::min(range.baseMipLevel, slot.mipLevels - 1);
+        range.baseArrayLayer = std::min(range.baseArrayLayer, slot.arrayLayers - 1);
+        const uint32_t mipCount = std::min(range.levelCount, slot.mipLevels - range.baseMipLevel);
+        const uint32_t layerCount = std::min(range.layerCount, slot.arrayLayers - range.baseArrayLayer);
+        const bool wholeImage = range.baseMipLevel == 0 && mipCount == slot.mipLevels &&
+                                range.baseArrayLayer == 0 && layerCount == slot.arrayLayers;
 
-        ImageState current;
-        auto it = m_imageStates.find(image);
-        if (it != m_imageStates.end()) {
-            current = it->second;
+        VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        if (slot.subresources.empty()) {
+            if (wholeImage) {
+                if (transitionImageState(slot.whole, newLayout, dstStage, dstAccess, dstQueueFamily, barrier)) {
+                    pushImageBarrier(barrier, texture.image,
+                                     {range.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+                } else {
+                    ++m_stats.redundantSkips;
+                }
+                return;
+            }
+            slot.subresources.assign(size_t(slot.mipLevels) * slot.arrayLayers, slot.whole);
         }
 
-        // Determine effective queue family comparison
-        const bool queueOwnershipTransfer =
-            (dstQueueFamily != VK_QUEUE_FAMILY_IGNORED) &&
-            (current.queueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) &&
-            (current.queueFamilyIndex != dstQueueFamily);
-
-        // Read-after-read optimization: if layout is unchanged, the new access is
-        // purely read-only, and no queue transfer is needed — only accumulate stage
-        // bits without emitting a barrier.
-        if (current.layout == newLayout &&
-            !queueOwnershipTransfer &&
-            isReadOnlyAccess(dstAccess)) {
-            // Accumulate stage/access into current state (multiple readers)
-            if (it != m_imageStates.end()) {
-                it->second.stageMask  |= dstStage;
-                it->second.accessMask |= dstAccess;
-            } else {
-                ImageState s;
-                s.layout      = newLayout;
-                s.stageMask   = dstStage;
-                s.accessMask  = dstAccess;
-                s.queueFamilyIndex = dstQueueFamily;
-                m_imageStates[image] = s;
+        const uint32_t barriersBefore = m_stats.imageBarriers;
+        for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + layerCount; ++layer) {
+            ImageState* states = &slot.subresources[size_t(layer) * slot.mipLevels];
+            VkImageMemoryBarrier2 run{};
+            uint32_t runBase = UINT32_MAX;
+            for (uint32_t mip = range.baseMipLevel; mip < range.baseMipLevel + mipCount; ++mip) {
+                const bool needsBarrier =
+                    transitionImageState(states[mip], newLayout, dstStage, dstAccess, dstQueueFamily, barrier);
+                if (runBase != UINT32_MAX && (!needsBarrier || !sameBarrierSource(run, barrier))) {
+                    pushImageBarrier(run, texture.image, {range.aspectMask, runBase, mip - runBase, layer, 1});
+                    runBase = UINT32_MAX;
+                }
+                if (needsBarrier && runBase == UINT32_MAX) {
+                    run = barrier;
+                    runBase = mip;
+                }
+            }
+            if (runBase != UINT32_MAX) {
+                pushImageBarrier(run, texture.image,
+                                 {range.aspectMask, runBase, range.baseMipLevel + mipCount - runBase, layer, 1});
             }
+        }
+        if (m_stats.imageBarriers == barriersBefore) {
             ++m_stats.redundantSkips;
-            return;
         }
 
-        // Emit barrier
-        VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-        barrier.srcStageMask  = current.stageMask;
-        barrier.srcAccessMask = current.accessMask;
-        barrier.dstStageMask  = dstStage;
-        barrier.dstAccessMask = dstAccess;
-        barrier.oldLayout     = current.layout;
-        barrier.newLayout     = newLayout;
-        barrier.srcQueueFamilyIndex = queueOwnershipTransfer ? current.queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = queueOwnershipTransfer ? dstQueueFamily           : VK_QUEUE_FAMILY_IGNORED;
-        barrier.image         = image;
-        barrier.subresourceRange.aspectMask     = aspectMask;
-        barrier.subresourceRange.baseMipLevel   = 0;
-        barrier.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
-
-        m_pendingImageBarriers.push_back(barrier);
-        ++m_stats.imageBarriers;
+        // Collapse back to whole-image tracking once the subresources agree again.
+        const ImageState& first = slot.subresources.front();
+        if (std::all_of(slot.subresources.begin(), slot.subresources.end(),
+                        [&](const ImageState& state) { return state == first; })) {
+            slot.whole = first;
+            slot.subresources.clear();
+        }
+    }
 
-        // Update stored state
-        ImageState newState;
-        newState.layout           = newLayout;
-        newState.stageMask        = dstStage;
-        newState.accessMask       = dstAccess;
-        newState.queueFamilyIndex = queueOwnershipTransfer ? dstQueueFamily : current.queueFamilyIndex;
-        m_imageStates[image] = newState;
+    // Whole-image variant.
+    void requireImageState(const VulkanTextureResource& texture,
+                           VkImageLayout         newLayout,
+                           VkPipelineStageFlags2 dstStage,
+                           VkAccessFlags2        dstAccess,
+                           VkImageAspectFlags    aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                           uint32_t              dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
+        requireImageSubresourceState(texture,
+                                     {aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS},
+                                     newLayout, dstStage, dstAccess, dstQueueFamily);
     }
 
     // Convenience: derive dstStage/dstAccess from target layout (backward-compat).
-    void requireImageState(VkImage            image,
+    void requireImageState(const VulkanTextureResource& texture,
                            VkImageLayout      newLayout,
                            VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                            uint32_t           dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
         VkPipelineStageFlags2 dstStage;
         VkAccessFlags2        dstAccess;
         deriveImageBarrierParams(newLayout, dstStage, dstAccess);
-        requireImageState(image, newLayout, dstStage, dstAccess, aspectMask, dstQueueFamily);
+        requireImageState(texture, newLayout, dstStage, dstAccess, aspectMask, dstQueueFamily);
+    }
+
+    // Subresource variant of the above.
+    void requireImageSubresourceState(const VulkanTextureResource& texture,
+                                      const VkImageSubresourceRange& range,
+                                      VkImageLayout newLayout) {
+        VkPipelineStageFlags2 dstStage;
+        VkAccessFlags2        dstAccess;
+        deriveImageBarrierParams(newLayout, dstStage, dstAccess);
+        requireImageSubresourceState(texture, range, newLayout, dstStage, dstAccess);
     }
 
     // Declare that 'buffer' (range [offset, offset+size)) needs to be in the given
     // access state. Whole-buffer variant: use offset=0, size=VK_WHOLE_SIZE.
-    void requireBufferState(VkBuffer               buffer,
+    void requireBufferState(const VulkanBufferResource& buffer,
                             VkDeviceSize           offset,
                             VkDeviceSize           size,
                             VkPipelineStageFlags2  dstStage,
                             VkAccessFlags2         dstAccess,
                             uint32_t               dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
-        if (buffer == VK_NULL_HANDLE) return;
-
-        BufferState current;
-        auto it = m_bufferStates.find(buffer);
-        const bool hasTrackedState = it != m_bufferStates.end();
-        if (hasTrackedState) {
-            current = it->second;
-        } else {
+        if (buffer.buffer == VK_NULL_HANDLE) return;
+
+        BufferSlot* slot = liveBufferSlot(buffer);
+        if (!slot) {
             // The tracker is cleared at frame start. Treat the first observed use of an
             // externally managed buffer as already synchronized and just seed its state.
-            m_bufferStates[buffer] = {dstStage, dstAccess, dstQueueFamily};
+            acquireBufferSlot(buffer).state = {dstStage, dstAccess, dstQueueFamily};
             ++m_stats.redundantSkips;
             return;
         }
 
+        BufferState& current = slot->state;
         const bool queueOwnershipTransfer =
             (dstQueueFamily != VK_QUEUE_FAMILY_IGNORED) &&
             (current.queueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) &&
@@ -297,12 +430,8 @@ public:
 
         // RAR: read-after-read never needs a barrier
         if (!queueOwnershipTransfer && isReadOnlyAccess(dstAccess) && isReadOnlyAccess(current.accessMask)) {
-            if (it != m_bufferStates.end()) {
-                it->second.stageMask  |= dstStage;
-                it->second.accessMask |= dstAccess;
-            } else {
-                m_bufferStates[buffer] = {dstStage, dstAccess, dstQueueFamily};
-            }
+            current.stageMask  |= dstStage;
+            current.accessMask |= dstAccess;
             ++m_stats.redundantSkips;
             return;
         }
@@ -314,19 +443,18 @@ public:
         barrier.dstAccessMask       = dstAccess;
         barrier.srcQueueFamilyIndex = queueOwnershipTransfer ? current.queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
         barrier.dstQueueFamilyIndex = queueOwnershipTransfer ? dstQueueFamily           : VK_QUEUE_FAMILY_IGNORED;
-        barrier.buffer              = buffer;
+        barrier.buffer              = buffer.buffer;
         barrier.offset              = offset;
         barrier.size                = size;
 
         m_pendingBufferBarriers.push_back(barrier);
         ++m_stats.bufferBarriers;
 
-        m_bufferStates[buffer] = {dstStage, dstAccess,
-                                  queueOwnershipTransfer ? dstQueueFamily : current.queueFamilyIndex};
+        current = {dstStage, dstAccess, queueOwnershipTransfer ? dstQueueFamily : current.queueFamilyIndex};
     }
 
     // Whole-buffer convenience overload.
-    void requireBufferState(VkBuffer              buffer,
+    void requireBufferState(const VulkanBufferResource& buffer,
                             VkPipelineStageFlags2 dstStage,
                             VkAccessFlags2        dstAccess,
                             uint32_t              dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) {
@@ -460,11 +588,11 @@ public:
     // Backward-compatible immediate transition (requireImageState + flushBarriers)
     // -----------------------------------------------------------------------
 
-    void transition(VkCommandBuffer    cmd,
-                    VkImage            image,
-                    VkImageLayout      newLayout,
-                    VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT) {
-        requireImageState(image, newLayout, aspectMask);
+    void transition(VkCommandBuffer              cmd,
+                    const VulkanTextureResource& texture,
+                    VkImageLayout                newLayout,
+                    VkImageAspectFlags           aspectMask = VK_IMAGE_ASPECT_COLOR_BIT) {
+        requireImageState(texture, newLayout, aspectMask);
         flushBarriers(cmd);
     }
 
@@ -485,8 +613,181 @@ public:
     }
 
 private:
-    std::unordered_map<VkImage,  ImageState>  m_imageStates;
-    std::unordered_map<VkBuffer, BufferState> m_bufferStates;
+    // Image and buffer states live in dense arrays indexed by the resource's
+    // VulkanResourceHeader::stateSlot. A slot is live for the current epoch only and
+    // only for the handle it was filled for, so recycled slots start out untracked.
+    struct ImageSlot {
+        VkImage  image       = VK_NULL_HANDLE;
+        uint64_t epoch       = 0;
+        uint32_t mipLevels   = 1;
+        uint32_t arrayLayers = 1;
+        ImageState whole;                     // used while subresources is empty
+        std::vector<ImageState> subresources; // layer-major, mipLevels per layer
+    };
+
+    struct BufferSlot {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        uint64_t epoch  = 0;
+        BufferState state;
+    };
+
+    static uint32_t assignedSlot(const VulkanResourceHeader& header) {
+        return std::atomic_ref<uint32_t>(header.stateSlot).load(std::memory_order_acquire);
+    }
+
+    static ImageState stateForLayout(VkImageLayout layout) {
+        ImageState state;
+        state.layout = layout;
+        deriveImageBarrierParams(layout, state.stageMask, state.accessMask);
+        return state;
+    }
+
+    // Applies one access to 'state'. Returns false for read-after-read, which only
+    // widens the masks; otherwise fills 'barrier' (minus image and range).
+    static bool transitionImageState(ImageState&            state,
+                                     VkImageLayout          newLayout,
+                                     VkPipelineStageFlags2  dstStage,
+                                     VkAccessFlags2         dstAccess,
+                                     uint32_t               dstQueueFamily,
+                                     VkImageMemoryBarrier2& barrier) {
+        const bool queueOwnershipTransfer =
+            (dstQueueFamily != VK_QUEUE_FAMILY_IGNORED) &&
+            (state.queueFamilyIndex != VK_QUEUE_FAMILY_IGNORED) &&
+            (state.queueFamilyIndex != dstQueueFamily);
+
+        if (state.layout == newLayout && !queueOwnershipTransfer && isReadOnlyAccess(dstAccess)) {
+            state.stageMask  |= dstStage;
+            state.accessMask |= dstAccess;
+            return false;
+        }
+
+        barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        barrier.srcStageMask  = state.stageMask;
+        barrier.srcAccessMask = state.accessMask;
+        barrier.dstStageMask  = dstStage;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout     = state.layout;
+        barrier.newLayout     = newLayout;
+        barrier.srcQueueFamilyIndex = queueOwnershipTransfer ? state.queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = queueOwnershipTransfer ? dstQueueFamily         : VK_QUEUE_FAMILY_IGNORED;
+
+        state.layout           = newLayout;
+        state.stageMask        = dstStage;
+        state.accessMask       = dstAccess;
+        state.queueFamilyIndex = queueOwnershipTransfer ? dstQueueFamily : state.queueFamilyIndex;
+        return true;
+    }
+
+    static bool sameBarrierSource(const VkImageMemoryBarrier2& lhs, const VkImageMemoryBarrier2& rhs) {
+        return lhs.srcStageMask == rhs.srcStageMask && lhs.srcAccessMask == rhs.srcAccessMask &&
+               lhs.oldLayout == rhs.oldLayout && lhs.srcQueueFamilyIndex == rhs.srcQueueFamilyIndex &&
+               lhs.dstQueueFamilyIndex == rhs.dstQueueFamilyIndex;
+    }
+
+    void pushImageBarrier(VkImageMemoryBarrier2 barrier, VkImage image, const VkImageSubresourceRange& range) {
+        barrier.image = image;
+        barrier.subresourceRange = range;
+        m_pendingImageBarriers.push_back(barrier);
+        ++m_stats.imageBarriers;
+    }
+
+    const ImageSlot* liveImageSlot(uint32_t slotIndex, VkImage image) const {
+        if (slotIndex >= m_images.size()) return nullptr;
+        const ImageSlot& slot = m_images[slotIndex];
+        return slot.epoch == m_epoch && slot.image == image ? &slot : nullptr;
+    }
+
+    const ImageSlot* liveImageSlot(const VulkanTextureResource& texture) const {
+        const uint32_t slotIndex = assignedSlot(texture.header);
+        return slotIndex == UINT32_MAX ? nullptr : liveImageSlot(slotIndex, texture.image);
+    }
+
+    // Raw-handle lookups are rare (swapchain, interop) and only scan this frame's images.
+    const ImageSlot* findLiveImageSlot(VkImage image) const {
+        for (uint32_t slotIndex : m_touchedImages) {
+            if (m_images[slotIndex].image == image) return &m_images[slotIndex];
+        }
+        return nullptr;
+    }
+
+    ImageSlot* findLiveImageSlot(VkImage image) {
+        return const_cast<ImageSlot*>(std::as_const(*this).findLiveImageSlot(image));
+    }
+
+    ImageSlot& imageSlotAt(uint32_t slotIndex, VkImage image, uint32_t mipLevels, uint32_t arrayLayers) {
+        if (slotIndex >= m_images.size()) {
+            m_images.resize(size_t(slotIndex) + 1);
+        }
+        ImageSlot& slot = m_images[slotIndex];
+        if (slot.epoch == m_epoch && slot.image == image) {
+            return slot;
+        }
+        if (slot.epoch != m_epoch) {
+            m_touchedImages.push_back(slotIndex);
+        }
+        slot.image = image;
+        slot.epoch = m_epoch;
+        slot.mipLevels = std::max(mipLevels, 1u);
+        slot.arrayLayers = std::max(arrayLayers, 1u);
+        slot.whole = {};
+        slot.subresources.clear();
+        if (!m_externalImages.empty()) {
+            auto it = m_externalImages.find(image);
+            if (it != m_externalImages.end()) {
+                slot.whole = it->second;
+                m_externalImages.erase(it);
+            }
+        }
+        return slot;
+    }
+
+    ImageSlot& acquireImageSlot(const VulkanTextureResource& texture) {
+        return imageSlotAt(vulkanResourceStateSlot(texture.header), texture.image,
+                           texture.mipLevels, texture.arrayLayers);
+    }
+
+    const BufferSlot* liveBufferSlot(uint32_t slotIndex, VkBuffer buffer) const {
+        if (slotIndex >= m_buffers.size()) return nullptr;
+        const BufferSlot& slot = m_buffers[slotIndex];
+        return slot.epoch == m_epoch && slot.buffer == buffer ? &slot : nullptr;
+    }
+
+    const BufferSlot* liveBufferSlot(const VulkanBufferResource& buffer) const {
+        const uint32_t slotIndex = assignedSlot(buffer.header);
+        return slotIndex == UINT32_MAX ? nullptr : liveBufferSlot(slotIndex, buffer.buffer);
+    }
+
+    BufferSlot* liveBufferSlot(const VulkanBufferResource& buffer) {
+        return const_cast<BufferSlot*>(std::as_const(*this).liveBufferSlot(buffer));
+    }
+
+    BufferSlot& bufferSlotAt(uint32_t slotIndex, VkBuffer buffer) {
+        if (slotIndex >= m_buffers.size()) {
+            m_buffers.resize(size_t(slotIndex) + 1);
+        }
+        BufferSlot& slot = m_buffers[slotIndex];
+        if (slot.epoch == m_epoch && slot.buffer == buffer) {
+            return slot;
+        }
+        if (slot.epoch != m_epoch) {
+            m_touchedBuffers.push_back(slotIndex);
+        }
+        slot.buffer = buffer;
+        slot.epoch = m_epoch;
+        slot.state = {};
+        return slot;
+    }
+
+    BufferSlot& acquireBufferSlot(const VulkanBufferResource& buffer) {
+        return bufferSlotAt(vulkanResourceStateSlot(buffer.header), buffer.buffer);
+    }
+
+    std::vector<ImageSlot>  m_images;
+    std::vector<BufferSlot> m_buffers;
+    std::vector<uint32_t>   m_touchedImages;  // slots live in the current epoch
+    std::vector<uint32_t>   m_touchedBuffers;
+    uint64_t m_epoch = 1;
+    std::unordered_map<VkImage, ImageState> m_externalImages; // images without a resource header
 
     std::vector<VkImageMemoryBarrier2>  m_pendingImageBarriers;
     std::vector<VkBufferMemoryBarrier2> m_pendingBufferBarriers;
@@ -83,7 +83,7 @@ VulkanRayTracingPipeline::~VulkanRayTracingPipeline() {
     if (m_pipeline != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
         vkDestroyPipeline(m_device, m_pipeline, nullptr);
     }
-    if (m_layout != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
+    if (m_ownsLayout && m_layout != VK_NULL_HANDLE && m_device != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(m_device, m_layout, nullptr);
     }
 }
@@ -92,6 +92,7 @@ VulkanRayTracingPipeline::VulkanRayTracingPipeline(VulkanRayTracingPipeline&& ot
     : m_device(other.m_device)
     , m_pipeline(other.m_pipeline)
     , m_layout(other.m_layout)
+    , m_ownsLayout(other.m_ownsLayout)
     , m_sbtBuffer(other.m_sbtBuffer)
     , m_sbtAllocation(other.m_sbtAllocation)
     , m_allocator(other.m_allocator)
@@ -133,7 +134,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
                                    uint32_t handleAlignment,
                                    uint32_t baseAlignment,
                                    std::string& errorMessage,
-                                   bool useDescriptorBuffer = false) {
+                                   bool useDescriptorBuffer) {
     const auto& rtFn = ensureRTFunctions(device);
     if (!rtFn.valid()) {
         errorMessage = "Failed to load RT pipeline function pointers";
@@ -145,31 +146,47 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
         return nullptr;
     }
 
+    for (uint32_t group : desc.hitRecordGroups) {
+        if (group >= desc.hitGroups.size()) {
+            errorMessage = "RT hit record references hit group " + std::to_string(group) +
+                           " of " + std::to_string(desc.hitGroups.size());
+            return nullptr;
+        }
+    }
+
     // --- 0. Build pipeline layout (bindless set + push constants) ---
 
-    VkDescriptorSetLayout bindlessLayout = VK_NULL_HANDLE;
-    if (!vulkanRetainBindlessSetLayout(device, bindlessLayout, &errorMessage, useDescriptorBuffer)) {
-        return nullptr;
-    }
+    const bool ownsLayout = desc.layout == VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = desc.layout;
+    if (ownsLayout) {
+        VkDescriptorSetLayout bindlessLayout = VK_NULL_HANDLE;
+        if (!vulkanRetainBindlessSetLayout(device, bindlessLayout, &errorMessage, useDescriptorBuffer)) {
+            return nullptr;
+        }
 
-    constexpr uint32_t kPushConstantSize = 256;
-    VkPushConstantRange pushRange{};
-    pushRange.stageFlags = VK_SHADER_STAGE_ALL;
-    pushRange.offset = 0;
-    pushRange.size = kPushConstantSize;
-
-    VkPipelineLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
-    layoutInfo.setLayoutCount = 1;
-    layoutInfo.pSetLayouts = &bindlessLayout;
-    layoutInfo.pushConstantRangeCount = 1;
-    layoutInfo.pPushConstantRanges = &pushRange;
-
-    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-        vulkanReleaseBindlessSetLayout(device);
-        errorMessage = "Failed to create RT pipeline layout";
-        return nullptr;
+        constexpr uint32_t kPushConstantSize = 256;
+        VkPushConstantRange pushRange{};
+        pushRange.stageFlags = VK_SHADER_STAGE_ALL;
+        pushRange.offset = 0;
+        pushRange.size = kPushConstantSize;
+
+        VkPipelineLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &bindlessLayout;
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pushRange;
+
+        if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            vulkanReleaseBindlessSetLayout(device);
+            errorMessage = "Failed to create RT pipeline layout";
+            return nullptr;
+        }
     }
+    auto destroyOwnedLayout = [&]() {
+        if (ownsLayout) {
+            vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        }
+    };
 
     // --- 1. Create shader module ---
 
@@ -180,6 +197,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
     VkShaderModule shaderModule = VK_NULL_HANDLE;
     if (vkCreateShaderModule(device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS) {
         errorMessage = "Failed to create VkShaderModule for RT pipeline";
+        destroyOwnedLayout();
         return nullptr;
     }
 
@@ -304,7 +322,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
     if (result != VK_SUCCESS) {
         errorMessage = "vkCreateRayTracingPipelinesKHR failed (VkResult: " +
                        std::to_string(result) + ")";
-        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        destroyOwnedLayout();
         return nullptr;
     }
 
@@ -329,7 +347,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
                                     handleData.size(), handleData.data()) != VK_SUCCESS) {
         errorMessage = "vkGetRayTracingShaderGroupHandlesKHR failed";
         vkDestroyPipeline(device, pipeline, nullptr);
-        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        destroyOwnedLayout();
         return nullptr;
     }
 
@@ -338,7 +356,9 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
     // Region sizes (rounded up to shaderGroupBaseAlignment)
     const uint32_t raygenCount    = 1;
     const uint32_t missCount      = static_cast<uint32_t>(desc.missEntries.size());
-    const uint32_t hitCount       = static_cast<uint32_t>(desc.hitGroups.size());
+    const uint32_t hitCount       = static_cast<uint32_t>(desc.hitRecordGroups.empty()
+                                                             ? desc.hitGroups.size()
+                                                             : desc.hitRecordGroups.size());
     const uint32_t callableCount  = static_cast<uint32_t>(desc.callableEntries.size());
 
     const uint32_t raygenRegionSize   = alignUp(handleSizeAligned * raygenCount, baseAlignment);
@@ -365,7 +385,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
                         &sbtBuffer, &sbtAllocation, &sbtAllocInfo) != VK_SUCCESS) {
         errorMessage = "Failed to allocate SBT buffer";
         vkDestroyPipeline(device, pipeline, nullptr);
-        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        destroyOwnedLayout();
         return nullptr;
     }
     vulkanSetObjectDebugName(device,
@@ -395,8 +415,12 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
     }
     offset += missRegionSize;
 
-    if (hitCount > 0) {
+    if (desc.hitRecordGroups.empty()) {
         copyHandles(hitGroupOffset, hitCount, offset);
+    } else {
+        for (uint32_t record = 0; record < hitCount; ++record) {
+            copyHandles(hitGroupOffset + desc.hitRecordGroups[record], 1, offset + record * handleSizeAligned);
+        }
     }
     offset += hitRegionSize;
 
@@ -416,6 +440,7 @@ createVulkanRayTracingPipelineImpl(VkDevice device,
     result_pipeline->m_device = device;
     result_pipeline->m_pipeline = pipeline;
     result_pipeline->m_layout = pipelineLayout;
+    result_pipeline->m_ownsLayout = ownsLayout;
     result_pipeline->m_sbtBuffer = sbtBuffer;
     result_pipeline->m_sbtAllocation = sbtAllocation;
     result_pipeline->m_allocator = allocator;
@@ -505,4 +530,24 @@ void vulkanTraceRays(RhiContext& context,
                       width, height, depth);
 }
 
+void vulkanCmdTraceRays(VkCommandBuffer commandBuffer,
+                        const VulkanRayTracingPipeline& pipeline,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t depth) {
+    if (!pipeline.isValid() || commandBuffer == VK_NULL_HANDLE) {
+        return;
+    }
+    const auto& rtFn = ensureRTFunctions(pipeline.device());
+    if (!rtFn.cmdTraceRays) {
+        return;
+    }
+    rtFn.cmdTraceRays(commandBuffer,
+                      &pipeline.raygenRegion(),
+                      &pipeline.missRegion(),
+                      &pipeline.hitRegion(),
+                      &pipeline.callableRegion(),
+                      width, height, depth);
+}
+
 #endif // _WIN32
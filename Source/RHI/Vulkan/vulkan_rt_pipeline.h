@@ -56,7 +56,15 @@ struct RtPipelineDesc {
     // Callable shader entries (optional, rarely used).
     std::vector<std::string> callableEntries;
 
+    // Hit group of each hit-region record (e.g. one record per material); empty
+    // writes one record per entry of hitGroups.
+    std::vector<uint32_t> hitRecordGroups;
+
     uint32_t maxRecursionDepth = 1;
+
+    // Layout to create the pipeline with, owned by the caller. Null builds a
+    // bindless-set + push-constant layout that the pipeline owns.
+    VkPipelineLayout layout = VK_NULL_HANDLE;
 };
 
 // -------------------------------------------------------------------------
@@ -74,6 +82,7 @@ public:
     VulkanRayTracingPipeline(VulkanRayTracingPipeline&& other) noexcept;
     VulkanRayTracingPipeline& operator=(VulkanRayTracingPipeline&& other) noexcept;
 
+    VkDevice device() const { return m_device; }
     VkPipeline pipeline() const { return m_pipeline; }
     VkPipelineLayout layout() const { return m_layout; }
 
@@ -99,7 +108,8 @@ private:
 
     VkDevice     m_device    = VK_NULL_HANDLE;
     VkPipeline   m_pipeline  = VK_NULL_HANDLE;
-    VkPipelineLayout m_layout = VK_NULL_HANDLE; // owned by this object, destroyed in destructor
+    VkPipelineLayout m_layout = VK_NULL_HANDLE; // destroyed with the pipeline when m_ownsLayout
+    bool         m_ownsLayout = true;
     VkBuffer     m_sbtBuffer = VK_NULL_HANDLE;
     VmaAllocation m_sbtAllocation = nullptr;
     VmaAllocator  m_allocator = nullptr;
@@ -114,6 +124,20 @@ private:
 // Public API — called from renderer code via vulkan_backend.h declarations.
 // -------------------------------------------------------------------------
 
+// Builds the pipeline and SBT from explicit device objects; the RhiContext
+// overload below and VulkanContext::createRayTracingPipelineFromSource use it.
+std::unique_ptr<VulkanRayTracingPipeline>
+createVulkanRayTracingPipelineImpl(VkDevice device,
+                                   VkPhysicalDevice physicalDevice,
+                                   VmaAllocator allocator,
+                                   VkPipelineCache pipelineCache,
+                                   const RtPipelineDesc& desc,
+                                   uint32_t shaderGroupHandleSize,
+                                   uint32_t shaderGroupHandleAlignment,
+                                   uint32_t shaderGroupBaseAlignment,
+                                   std::string& errorMessage,
+                                   bool useDescriptorBuffer = false);
+
 // Create a ray tracing pipeline + SBT from the given descriptor.
 // Returns nullptr on failure (errorMessage populated).
 std::unique_ptr<VulkanRayTracingPipeline> createVulkanRayTracingPipeline(
@@ -128,4 +152,12 @@ void vulkanTraceRays(RhiContext& context,
                      uint32_t height,
                      uint32_t depth = 1);
 
+// Records vkCmdTraceRaysKHR into commandBuffer with the pipeline already bound at
+// VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR along with its descriptors.
+void vulkanCmdTraceRays(VkCommandBuffer commandBuffer,
+                        const VulkanRayTracingPipeline& pipeline,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t depth = 1);
+
 #endif // _WIN32
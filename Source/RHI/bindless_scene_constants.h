@@ -8,10 +8,13 @@
 #define METALLIC_BINDLESS_STORAGE_BUFFER_BINDING 3
 #define METALLIC_BINDLESS_ACCELERATION_STRUCTURE_BINDING 4
 
-#define METALLIC_BINDLESS_MAX_SAMPLED_IMAGES 512
+#define METALLIC_BINDLESS_MAX_SAMPLED_IMAGES 4096
 #define METALLIC_BINDLESS_MAX_SAMPLERS 16
 #define METALLIC_BINDLESS_MAX_STORAGE_IMAGES 64
 #define METALLIC_BINDLESS_MAX_STORAGE_BUFFERS 128
 #define METALLIC_BINDLESS_MAX_ACCELERATION_STRUCTURES 32
 
 #define METALLIC_BINDLESS_SCENE_SAMPLER_INDEX 0
+
+// Metal binds the scene table as a Tier-2 argument buffer in the last buffer slot.
+#define METALLIC_METAL_BINDLESS_BUFFER_INDEX 30
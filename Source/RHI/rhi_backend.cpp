@@ -1,5 +1,7 @@
 #include "rhi_backend.h"
 
+#include <algorithm>
+
 #ifdef _WIN32
 #include "Vulkan/vulkan_backend.h"
 #endif
@@ -22,3 +24,71 @@ std::unique_ptr<RhiContext> createRhiContext(RhiBackendType backend,
     }
 }
 
+std::vector<std::pair<std::string, std::string>> rhiCapabilityShaderDefines(const RhiContext& context) {
+    std::vector<std::pair<std::string, std::string>> defines;
+    if (rhiSubgroupSupports(context.subgroupProperties(),
+                            RhiSubgroupStage::Compute,
+                            RhiSubgroupOperation::Basic | RhiSubgroupOperation::Ballot)) {
+        defines.emplace_back("METALLIC_WAVE_OPS", "1");
+    }
+    if (rhiSubgroupSupports(context.subgroupProperties(),
+                            RhiSubgroupStage::Compute,
+                            RhiSubgroupOperation::Basic | RhiSubgroupOperation::Ballot |
+                                RhiSubgroupOperation::Shuffle)) {
+        defines.emplace_back("METALLIC_WAVE_SHUFFLE", "1");
+    }
+    if (context.features().shaderBufferInt64Atomics) {
+        defines.emplace_back("METALLIC_INT64_ATOMICS", "1");
+    }
+    if (context.features().shaderFloat16) {
+        defines.emplace_back("METALLIC_FP16", "1");
+    }
+    if (context.features().rayTracing) {
+        defines.emplace_back("METALLIC_INLINE_RAY_QUERY", "1");
+    }
+    if (context.features().bufferDeviceAddress) {
+        defines.emplace_back("METALLIC_BUFFER_DEVICE_ADDRESS", "1");
+    }
+    if (context.features().rayTracingPipeline && context.features().rayTracingInvocationReorder) {
+        defines.emplace_back("METALLIC_RAY_REORDER", "1");
+    }
+    const RhiMeshletSizeLimits meshletLimits = rhiPreferredMeshletSizeLimits(context);
+    defines.emplace_back("METALLIC_MESHLET_MAX_VERTICES", std::to_string(meshletLimits.maxVertices) + "u");
+    defines.emplace_back("METALLIC_MESHLET_MAX_TRIANGLES", std::to_string(meshletLimits.maxTriangles) + "u");
+    return defines;
+}
+
+RhiMeshletSizeLimits rhiPreferredMeshletSizeLimits(const RhiContext& context) {
+    constexpr uint32_t kVendorNvidia = 0x10DEu;
+    constexpr uint32_t kVendorAmd = 0x1002u;
+    // Mesh shaders run one 128-thread group per meshlet with one thread per
+    // vertex and per triangle, and the visibility buffer stores 7 triangle bits.
+    constexpr uint32_t kMaxMeshletElements = 128u;
+
+    RhiMeshletSizeLimits limits{};
+    switch (context.deviceInfo().vendorID) {
+    case kVendorNvidia:
+        limits = {64u, 124u};
+        break;
+    case kVendorAmd:
+        limits = {128u, 128u};
+        break;
+    default:
+        break;
+    }
+
+    const RhiLimits& deviceLimits = context.limits();
+    limits.maxVertices = std::min(limits.maxVertices, kMaxMeshletElements);
+    limits.maxTriangles = std::min(limits.maxTriangles, kMaxMeshletElements);
+    if (deviceLimits.maxMeshOutputVertices != 0) {
+        limits.maxVertices = std::min(limits.maxVertices, deviceLimits.maxMeshOutputVertices);
+    }
+    if (deviceLimits.maxMeshOutputPrimitives != 0) {
+        limits.maxTriangles = std::min(limits.maxTriangles, deviceLimits.maxMeshOutputPrimitives);
+    }
+    // meshoptimizer requires the triangle cap to be a multiple of 4.
+    limits.maxVertices = std::max(limits.maxVertices, 3u);
+    limits.maxTriangles = std::max(limits.maxTriangles & ~3u, 4u);
+    return limits;
+}
+
@@ -3,8 +3,10 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "rhi_interop.h"
@@ -46,6 +48,8 @@ enum class RhiFormat {
     D32Float = 12,
     D16Unorm = 13,
     RGBA8Srgb = 14,
+    BC7RGBAUnorm = 15,
+    RG32Uint = 16,
 };
 
 enum class RhiVertexFormat {
@@ -64,7 +68,27 @@ enum class RhiTextureUsage : uint32_t {
 enum class RhiTextureStorageMode {
     Private,
     Shared,
-};
+    // Render-pass-only attachment kept in tile memory (Metal memoryless, Vulkan lazily
+    // allocated). Cannot be sampled, loaded, or stored.
+    Memoryless,
+};
+
+// Where a buffer lives and how the CPU reaches it.
+enum class RhiBufferMemory {
+    // GPU-only; initial data is staged in. For static, read-heavy data.
+    DeviceLocal,
+    // Mapped, write-combined host memory for data the CPU rewrites.
+    Upload,
+    // Mapped, cached host memory for data the CPU reads back.
+    Readback,
+    // Mapped device memory (resizable BAR) where available, Upload otherwise.
+    // For small per-frame tables the GPU reads many times.
+    DynamicDeviceLocal,
+};
+
+inline bool rhiBufferMemoryIsHostVisible(RhiBufferMemory memory) {
+    return memory != RhiBufferMemory::DeviceLocal;
+}
 
 enum class RhiSamplerFilterMode {
     Nearest,
@@ -107,6 +131,13 @@ enum class RhiPrimitiveType {
     Triangle,
 };
 
+// Blending of a render pipeline's color attachment, on all four channels.
+enum class RhiBlendMode {
+    Opaque,          // no blending
+    Additive,        // dst + src
+    InverseModulate, // dst * (1 - src), the revealage of weighted-blended OIT
+};
+
 enum class RhiIndexType {
     UInt16,
     UInt32,
@@ -233,6 +264,7 @@ struct RhiTextureDesc {
     RhiFormat format = RhiFormat::BGRA8Unorm;
     RhiTextureUsage usage = RhiTextureUsage::RenderTarget;
     RhiTextureStorageMode storageMode = RhiTextureStorageMode::Private;
+    uint32_t mipLevels = 1;
 
     static RhiTextureDesc renderTarget(uint32_t w, uint32_t h, RhiFormat fmt) {
         return {w, h, fmt, RhiTextureUsage::RenderTarget | RhiTextureUsage::ShaderRead, RhiTextureStorageMode::Private};
@@ -253,6 +285,7 @@ public:
     virtual void* nativeHandle() const = 0;
     virtual uint32_t width() const = 0;
     virtual uint32_t height() const = 0;
+    virtual uint32_t mipLevelCount() const { return 1; }
 };
 
 class RhiSampler {
@@ -473,6 +506,35 @@ struct RhiBlitPassDesc {
     const char* label = nullptr;
 };
 
+// One buffer for the batched binding calls: setBuffers, setMeshBuffers, setFragmentBuffers.
+struct RhiBufferBinding {
+    const RhiBuffer* buffer = nullptr;
+    uint64_t offset = 0;
+    uint32_t index = 0;
+};
+
+// Ends a pass encoder. Backends construct encoders in pooled storage (see
+// rhi_encoder_pool.h), so ending a pass runs the destructor and hands the slot back
+// instead of freeing it. Without a pool the encoder is deleted.
+struct RhiEncoderRelease {
+    void (*recycle)(void* pool, void* slot) = nullptr;
+    void* pool = nullptr;
+    void* slot = nullptr;
+
+    template <typename Encoder>
+    void operator()(Encoder* encoder) const {
+        if (!recycle) {
+            delete encoder;
+            return;
+        }
+        encoder->~Encoder();
+        recycle(pool, slot);
+    }
+};
+
+template <typename Encoder>
+using RhiEncoderPtr = std::unique_ptr<Encoder, RhiEncoderRelease>;
+
 class RhiRenderCommandEncoder {
 public:
     virtual ~RhiRenderCommandEncoder() = default;
@@ -494,12 +556,36 @@ public:
     virtual void setMeshTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) = 0;
     virtual void setFragmentSampler(const RhiSampler* sampler, uint32_t index) = 0;
     virtual void setMeshSampler(const RhiSampler* sampler, uint32_t index) = 0;
+    // Batched forms of setMeshBuffer / setFragmentBuffer: one call for a pass's bindings.
+    virtual void setMeshBuffers(const RhiBufferBinding* bindings, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            setMeshBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
+    virtual void setFragmentBuffers(const RhiBufferBinding* bindings, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            setFragmentBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
     virtual void drawPrimitives(RhiPrimitiveType primitiveType, uint32_t vertexStart, uint32_t vertexCount) = 0;
     virtual void drawIndexedPrimitives(RhiPrimitiveType primitiveType,
                                        uint32_t indexCount,
                                        RhiIndexType indexType,
                                        const RhiBuffer& indexBuffer,
                                        uint64_t indexBufferOffset) = 0;
+    // Up to maxDrawCount indexed draws from argumentBuffer, each laid out like
+    // IndexedDrawCommand (20 bytes); the draw count is the uint32 at countOffset.
+    // Backends without a GPU draw count issue all maxDrawCount commands, so the
+    // commands past the count must have indexCount or instanceCount 0.
+    virtual void drawIndexedPrimitivesIndirectCount(RhiPrimitiveType primitiveType,
+                                                    RhiIndexType indexType,
+                                                    const RhiBuffer& indexBuffer,
+                                                    uint64_t indexBufferOffset,
+                                                    const RhiBuffer& argumentBuffer,
+                                                    uint64_t argumentOffset,
+                                                    const RhiBuffer& countBuffer,
+                                                    uint64_t countOffset,
+                                                    uint32_t maxDrawCount) = 0;
     virtual void drawMeshThreadgroups(RhiSize3D threadgroupsPerGrid,
                                       RhiSize3D threadsPerObjectThreadgroup,
                                       RhiSize3D threadsPerMeshThreadgroup) = 0;
@@ -516,11 +602,20 @@ public:
     virtual void* nativeHandle() const = 0;
     virtual void setComputePipeline(const RhiComputePipeline& pipeline) = 0;
     virtual void setBuffer(const RhiBuffer* buffer, uint64_t offset, uint32_t index) = 0;
+    // Batched form of setBuffer: one call for a pass's bindings.
+    virtual void setBuffers(const RhiBufferBinding* bindings, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            setBuffer(bindings[i].buffer, bindings[i].offset, bindings[i].index);
+        }
+    }
     virtual void setBytes(const void* data, size_t size, uint32_t index) = 0;
     virtual void setPushConstants(const void* data, size_t size) = 0;
     virtual void setTexture(const RhiTexture* texture, uint32_t index) = 0;
     virtual void setStorageTexture(const RhiTexture* texture, uint32_t index) = 0;
     virtual void setTextures(const RhiTexture* const* textures, uint32_t startIndex, uint32_t count) = 0;
+    // Bind a single mip of a mipped texture, e.g. to read one level while writing the next.
+    virtual void setTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) = 0;
+    virtual void setStorageTextureMip(const RhiTexture* texture, uint32_t mipLevel, uint32_t index) = 0;
     virtual void setSampler(const RhiSampler* sampler, uint32_t index) = 0;
     virtual void setAccelerationStructure(const RhiAccelerationStructure* accelerationStructure, uint32_t index) = 0;
     virtual void useResource(const RhiBuffer& resource, RhiResourceUsage usage) = 0;
@@ -530,6 +625,10 @@ public:
     virtual void dispatchThreadgroupsIndirect(const RhiBuffer& indirectBuffer,
                                               uint64_t indirectBufferOffset,
                                               RhiSize3D threadsPerThreadgroup) = 0;
+    // Launches one ray generation invocation per element of rays with the pipeline
+    // from createRayTracingPipelineFromSource bound through setComputePipeline.
+    // Backends without ray tracing pipelines ignore it.
+    virtual void traceRays(RhiSize3D /*rays*/) {}
 };
 
 class RhiBlitCommandEncoder {
@@ -547,12 +646,21 @@ public:
                              RhiOrigin3D destinationOrigin) = 0;
 };
 
+// Resources whose next use is on the other queue; from is Graphics or AsyncCompute.
+struct RhiQueueHandoff {
+    RhiQueueHint from = RhiQueueHint::Graphics;
+    std::vector<const RhiTexture*> textures;
+    std::vector<const RhiBuffer*> buffers;
+};
+
 class RhiCommandBuffer {
 public:
     virtual ~RhiCommandBuffer() = default;
-    virtual std::unique_ptr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) = 0;
-    virtual std::unique_ptr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) = 0;
-    virtual std::unique_ptr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) = 0;
+    // The pass ends when the returned encoder goes out of scope, on the thread that
+    // began it.
+    virtual RhiEncoderPtr<RhiRenderCommandEncoder> beginRenderPass(const RhiRenderPassDesc& desc) = 0;
+    virtual RhiEncoderPtr<RhiComputeCommandEncoder> beginComputePass(const RhiComputePassDesc& desc) = 0;
+    virtual RhiEncoderPtr<RhiBlitCommandEncoder> beginBlitPass(const RhiBlitPassDesc& desc) = 0;
 
     // Prepare a texture for sampling in the next pass.
     // Backend implementations handle any necessary state transitions (e.g. Vulkan layout transitions).
@@ -589,13 +697,74 @@ public:
     // Hint to the backend which queue subsequent work should target.
     // Called by FrameGraph before each pass. No-op on Metal.
     virtual void setNextPassQueueHint(RhiQueueHint /*hint*/) {}
+
+    // Orders subsequent passes after a transfer returned by rhiSubmitAsyncBufferCopies.
+    // Must be called outside any pass. No-op on Vulkan, which waits on the transfer
+    // timeline semaphore at queue submit.
+    virtual void waitForTransfer(uint64_t /*value*/) {}
+
+    // Order work already recorded for handoff.from before work recorded next on the other
+    // queue, and transfer ownership of the listed resources across queue families.
+    // No-op on backends without a separate async compute queue.
+    virtual void queueHandoff(const RhiQueueHandoff& /*handoff*/) {}
+
+    // Mark a texture that shares memory with other transients as undefined before its
+    // first use this frame. The next prepare call transitions it from an undefined
+    // layout after all earlier work, which covers the previous occupant of the memory.
+    virtual void discardTexture(const RhiTexture* /*texture*/) {}
+
+    // Record count independent passes on worker threads. Returns false when the backend
+    // records serially. Otherwise each parallelCommandBuffer(i) may be used by one thread
+    // at a time, and endParallelRecording() appends them to this buffer in index order.
+    virtual bool beginParallelRecording(uint32_t /*count*/) { return false; }
+    virtual RhiCommandBuffer* parallelCommandBuffer(uint32_t /*index*/) { return nullptr; }
+    virtual void endParallelRecording() {}
 };
 
+// Frame graph transient texture that may share heap memory with other requests whose
+// pass intervals do not overlap. The backend fills texture and the placement fields.
+struct RhiTransientTextureRequest {
+    RhiTextureDesc desc;
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+    std::unique_ptr<RhiTexture> texture;
+    uint32_t heapIndex = UINT32_MAX;
+    uint64_t heapOffset = 0;
+    uint64_t sizeBytes = 0;
+    bool aliased = false;
+};
+
+struct RhiTransientBufferRequest;
+
 class RhiFrameGraphBackend {
 public:
     virtual ~RhiFrameGraphBackend() = default;
     virtual std::unique_ptr<RhiTexture> createTexture(const RhiTextureDesc& desc) = 0;
     virtual std::unique_ptr<RhiBuffer> createBuffer(const RhiBufferDesc& desc) = 0;
+
+    // Creates all requests as placed resources in shared heaps. Returns false without
+    // creating anything when unsupported; the frame graph then calls createTexture.
+    virtual bool createPlacedTextures(std::vector<RhiTransientTextureRequest>& /*requests*/,
+                                      uint64_t& /*outHeapBytes*/) {
+        return false;
+    }
+
+    // Creates all requests as buffers sub-allocated from one heap per memory kind.
+    // Returns false without creating anything when unsupported; the frame graph then
+    // calls createBuffer.
+    virtual bool createSubAllocatedBuffers(std::vector<RhiTransientBufferRequest>& /*requests*/,
+                                           uint64_t& /*outHeapBytes*/) {
+        return false;
+    }
+
+    // True when createTexture() honours RhiTextureStorageMode::Memoryless.
+    virtual bool supportsMemorylessTextures() const { return false; }
+
+    // Takes back a resource from createTexture()/createBuffer() that the frame graph
+    // no longer needs. Backends with a transient pool keep it for a later create
+    // call with a matching desc; the default destroys it.
+    virtual void recycleTexture(std::unique_ptr<RhiTexture> /*texture*/, const RhiTextureDesc& /*desc*/) {}
+    virtual void recycleBuffer(std::unique_ptr<RhiBuffer> /*buffer*/, const RhiBufferDesc& /*desc*/) {}
 };
 
 struct RhiFeatures {
@@ -604,6 +773,7 @@ struct RhiFeatures {
     bool meshShaders = false;
     bool rayTracing = false;          // ray query + acceleration structure
     bool rayTracingPipeline = false;  // VK_KHR_ray_tracing_pipeline (raygen/miss/hit shaders + SBT)
+    bool rayTracingInvocationReorder = false; // VK_NV_ray_tracing_invocation_reorder (shader execution reordering)
     bool validation = false;
     bool synchronization2 = false;
     bool shaderDrawParameters = false;
@@ -613,6 +783,13 @@ struct RhiFeatures {
     bool externalHostMemory = false;
     bool descriptorBuffer = false;   // VK_EXT_descriptor_buffer
     bool shaderBufferInt64Atomics = false; // VK_KHR_shader_atomic_int64 storage-buffer atomics
+    bool shaderFloat16 = false;            // 16-bit float arithmetic in shaders (Vulkan 1.2 shaderFloat16)
+    bool graphicsPipelineLibrary = false;  // VK_EXT_graphics_pipeline_library with fast linking
+    bool pushDescriptors = false;          // VK_KHR_push_descriptor for per-pass sets (pool path)
+    bool presentWait = false;              // VK_KHR_present_id + VK_KHR_present_wait
+    bool resizableBar = false;             // host-visible device-local memory spans VRAM, not a 256 MiB window
+    bool asyncComputeQueue = false;        // dedicated compute queue family (no graphics bit)
+    bool transferQueue = false;            // dedicated transfer queue family (DMA engine)
 };
 
 struct RhiSubgroupProperties {
@@ -629,6 +806,15 @@ struct RhiSubgroupProperties {
     RhiSubgroupStage requiredSubgroupSizeStages = RhiSubgroupStage::None;
 };
 
+// True when every operation in `operations` is available to subgroups in `stage`.
+inline bool rhiSubgroupSupports(const RhiSubgroupProperties& properties,
+                                RhiSubgroupStage stage,
+                                RhiSubgroupOperation operations) {
+    return properties.supported &&
+           (properties.supportedStages & stage) == stage &&
+           (properties.supportedOperations & operations) == operations;
+}
+
 // Properties of the ray tracing pipeline implementation (populated when rayTracingPipeline == true).
 struct RhiRayTracingPipelineProperties {
     uint32_t shaderGroupHandleSize      = 0;
@@ -663,6 +849,9 @@ struct RhiLimits {
     uint32_t maxMeshOutputPrimitives = 0;
     uint32_t maxMeshWorkGroupInvocations = 0;
     uint32_t maxTaskWorkGroupInvocations = 0;
+    uint32_t maxPreferredMeshWorkGroupInvocations = 0;
+    uint32_t maxTaskPayloadSize = 0;
+    uint32_t maxMeshSharedMemorySize = 0;
 
     // Descriptors
     uint32_t maxBoundDescriptorSets = 4;
@@ -676,6 +865,7 @@ struct RhiLimits {
     uint32_t maxDescriptorSetStorageBuffers = 0;
     uint32_t maxDescriptorSetSampledImages = 0;
     uint32_t maxDescriptorSetStorageImages = 0;
+    uint32_t maxPushDescriptors = 0;
 
     // Memory
     uint64_t nonCoherentAtomSize = 256;
@@ -703,8 +893,21 @@ struct RhiDeviceInfo {
     std::string adapterName;
     std::string driverName;
     uint32_t apiVersion = 0;
+    uint32_t vendorID = 0;  // PCI vendor ID; 0 when the backend does not report one
+};
+
+// Meshlet vertex/triangle caps that geometry is built to and mesh shaders are
+// compiled against. The defaults mirror meshlet_constants.h.
+struct RhiMeshletSizeLimits {
+    uint32_t maxVertices = 64;
+    uint32_t maxTriangles = 124;
+
+    bool operator==(const RhiMeshletSizeLimits&) const = default;
 };
 
+// Upper bound for RhiCreateInfo::framesInFlight; per-frame rings are sized for it.
+constexpr uint32_t kRhiMaxFramesInFlight = 4;
+
 struct RhiCreateInfo {
     GLFWwindow* window = nullptr;
     uint32_t width = 1280;
@@ -717,6 +920,16 @@ struct RhiCreateInfo {
     std::vector<const char*> extraInstanceExtensions;
     std::vector<const char*> extraDeviceExtensions;
     bool enableTimelineSemaphore = false;
+    // Build graphics pipelines from fast-linked libraries when the device supports it.
+    bool enablePipelineLibraries = true;
+    // Have the driver keep per-pipeline register, spill and occupancy statistics
+    // (VK_KHR_pipeline_executable_properties) for RhiContext::pipelineExecutableStats.
+    bool capturePipelineStatistics = true;
+    // Frames the CPU may record ahead of the GPU, clamped to [2, kRhiMaxFramesInFlight].
+    // More frames favour throughput, fewer favour input latency.
+    uint32_t framesInFlight = 2;
+    // Start with beginFrame() pacing itself on present completion (see setLowLatencyPresentWait).
+    bool lowLatencyPresentWait = false;
 
     // Optional Vulkan proxy lookup used by integrations such as Streamline manual hooking.
     void* vkGetDeviceProcAddrProxy = nullptr;
@@ -726,14 +939,66 @@ struct RhiCreateInfo {
     std::string shaderCacheDir   = "cache/shaders";
 };
 
+// Subsystem a GPU allocation is accounted to. Allocations made while an
+// RhiMemoryTagScope is alive on the creating thread carry its tag; the Vulkan
+// backend sums them per tag for the VRAM dashboard. Metal ignores tags.
+enum class RhiMemoryTag : uint8_t {
+    Untagged,
+    Geometry,
+    StreamingPool,
+    Textures,
+    Transients,
+    History,
+    AccelerationStructures,
+    Staging,
+    Count
+};
+
+inline const char* rhiMemoryTagName(RhiMemoryTag tag) {
+    static constexpr const char* kNames[] = {
+        "Other", "Geometry", "Streaming Pool", "Textures", "FG Transients", "History", "RT AS", "Staging"};
+    const size_t index = static_cast<size_t>(tag);
+    return index < static_cast<size_t>(RhiMemoryTag::Count) ? kNames[index] : "";
+}
+
+class RhiMemoryTagScope {
+public:
+    explicit RhiMemoryTagScope(RhiMemoryTag tag) : m_previous(s_current) { s_current = tag; }
+    ~RhiMemoryTagScope() { s_current = m_previous; }
+
+    RhiMemoryTagScope(const RhiMemoryTagScope&) = delete;
+    RhiMemoryTagScope& operator=(const RhiMemoryTagScope&) = delete;
+
+    static RhiMemoryTag current() { return s_current; }
+
+private:
+    static inline thread_local RhiMemoryTag s_current = RhiMemoryTag::Untagged;
+    RhiMemoryTag m_previous;
+};
+
 struct RhiBufferDesc {
     size_t size = 0;
     const void* initialData = nullptr;
-    bool hostVisible = true;
+    RhiBufferMemory memory = RhiBufferMemory::Upload;
     bool sharedWithTransferQueue = false;
+    // Frame graph transients only: lets the backend place the buffer at an offset in a
+    // heap shared with the graph's other transient buffers. Clear it for buffers that
+    // need an allocation of their own.
+    bool subAllocate = true;
     const char* debugName = nullptr;
 };
 
+// Frame graph transient buffer packed linearly, without aliasing, into a heap shared
+// with the other requests of the same RhiBufferMemory. The backend fills buffer and
+// the placement fields.
+struct RhiTransientBufferRequest {
+    RhiBufferDesc desc;
+    std::unique_ptr<RhiBuffer> buffer;
+    uint32_t heapIndex = UINT32_MAX;
+    uint64_t heapOffset = 0;
+    uint64_t sizeBytes = 0;
+};
+
 struct RhiShaderModuleDesc {
     std::vector<uint32_t> spirv;
     const char* debugName = nullptr;
@@ -771,6 +1036,9 @@ public:
     virtual size_t size() const = 0;
     virtual void* nativeHandle() const = 0;
     virtual void* mappedData() { return nullptr; }
+    // 64-bit address shaders can dereference (Vulkan buffer device address, Metal
+    // gpuAddress); 0 when the buffer was created without one.
+    virtual uint64_t gpuAddress() const { return 0; }
 };
 
 class RhiBufferHandle final : public RhiBuffer {
@@ -845,12 +1113,45 @@ struct RhiRenderPipelineSourceDesc {
     RhiFormat colorFormat = RhiFormat::BGRA8Unorm;
     RhiFormat depthFormat = RhiFormat::Undefined;
     const RhiVertexDescriptor* vertexDescriptor = nullptr;
+    RhiBlendMode blendMode = RhiBlendMode::Opaque;
+    // Vulkan bakes depth writes into the pipeline; Metal takes them from the
+    // RhiDepthStencilState the encoder binds.
+    bool depthWrite = true;
+};
+
+// Ray tracing pipeline compiled from one SPIR-V module. Hit groups are triangle
+// groups with only a closest-hit shader. The hit region holds one record per
+// entry of hitRecordGroups naming the hit group it runs, so a TLAS instance's
+// hit group offset plus the geometry index selects a record; an empty list gives
+// one record per hit group.
+struct RhiRayTracingPipelineSourceDesc {
+    const char* rayGenEntry = nullptr;
+    std::vector<const char*> missEntries;
+    std::vector<const char*> closestHitEntries;
+    std::vector<uint32_t> hitRecordGroups;
+    uint32_t maxRecursionDepth = 1;
 };
 
 struct RhiShaderLibrarySourceDesc {
     uint32_t languageVersion = 0;
 };
 
+// One number a driver reports about a compiled shader, such as its register count,
+// spilled bytes or occupancy. Boolean statistics report 0 or 1.
+struct RhiShaderStatistic {
+    std::string name;
+    std::string description;
+    double value = 0.0;
+};
+
+// Statistics for one executable a pipeline compiled into; drivers usually produce
+// one per shader stage.
+struct RhiPipelineExecutableStats {
+    std::string name;
+    uint32_t subgroupSize = 0;
+    std::vector<RhiShaderStatistic> statistics;
+};
+
 struct RhiNativeHandles {
     void* instance = nullptr;
     void* physicalDevice = nullptr;
@@ -915,6 +1216,15 @@ public:
     virtual void waitIdle() = 0;
     virtual uint64_t completedGraphicsSubmissionSerial() { return 0u; }
     virtual uint64_t nextGraphicsSubmissionSerial() const { return 0u; }
+    // Runs release once every graphics submission recorded so far, including the
+    // frame currently being recorded, has completed on the GPU. Backends whose
+    // command buffers retain their resources may run it immediately.
+    virtual void deferRelease(std::function<void()> release) { release(); }
+    virtual uint32_t framesInFlight() const { return 2u; }
+    // Blocks beginFrame() until the previous present has reached the display, so the
+    // CPU samples input at most one frame ahead. Requires RhiFeatures::presentWait.
+    virtual void setLowLatencyPresentWait(bool /*enabled*/) {}
+    virtual bool lowLatencyPresentWait() const { return false; }
     virtual RhiCommandContext& commandContext() = 0;
     virtual uint32_t drawableWidth() const = 0;
     virtual uint32_t drawableHeight() const = 0;
@@ -950,6 +1260,22 @@ public:
     virtual RhiComputePipelineHandle createComputePipelineFromSource(const std::string& source,
                                                                      const char* entryPoint,
                                                                      std::string& errorMessage) = 0;
+    // Requires RhiFeatures::rayTracingPipeline. The returned pipeline binds with
+    // setComputePipeline and runs with RhiComputeCommandEncoder::traceRays.
+    virtual RhiComputePipelineHandle createRayTracingPipelineFromSource(const std::string& /*source*/,
+                                                                        const RhiRayTracingPipelineSourceDesc& /*desc*/,
+                                                                        std::string& errorMessage) {
+        errorMessage = "Ray tracing pipelines are not supported by this backend";
+        return {};
+    }
+    // Driver statistics for a pipeline this context created, one entry per executable.
+    // Empty when the backend or driver does not report them.
+    virtual std::vector<RhiPipelineExecutableStats> pipelineExecutableStats(const RhiGraphicsPipeline& /*pipeline*/) {
+        return {};
+    }
+    virtual std::vector<RhiPipelineExecutableStats> pipelineExecutableStats(const RhiComputePipeline& /*pipeline*/) {
+        return {};
+    }
     virtual std::unique_ptr<RhiShaderModule> createShaderModule(const RhiShaderModuleDesc& desc) = 0;
     virtual std::unique_ptr<RhiBuffer> createVertexBuffer(const RhiBufferDesc& desc) = 0;
     virtual std::unique_ptr<RhiGraphicsPipeline> createGraphicsPipeline(const RhiGraphicsPipelineDesc& desc) = 0;
@@ -958,3 +1284,22 @@ public:
 std::unique_ptr<RhiContext> createRhiContext(RhiBackendType backend,
                                              const RhiCreateInfo& createInfo,
                                              std::string& errorMessage);
+
+// Shader defines that select capability-specific kernels, derived from the
+// context's features and subgroup properties. Shaders test them with #ifdef and
+// keep the portable path as the fallback:
+//   METALLIC_WAVE_OPS       compute subgroups support basic + ballot operations
+//   METALLIC_WAVE_SHUFFLE   METALLIC_WAVE_OPS plus shuffles by lane index
+//   METALLIC_INT64_ATOMICS  64-bit storage-buffer atomics
+//   METALLIC_INLINE_RAY_QUERY  ray queries against a bound acceleration structure
+//   METALLIC_FP16           half arithmetic; Shaders/Shared/precision.slang maps mfloat to half
+//   METALLIC_RAY_REORDER    ray tracing pipelines can reorder threads by hit (HitObject)
+//   METALLIC_BUFFER_DEVICE_ADDRESS  shaders may load through RhiBuffer::gpuAddress() pointers
+//   METALLIC_MESHLET_MAX_VERTICES / METALLIC_MESHLET_MAX_TRIANGLES
+//                           rhiPreferredMeshletSizeLimits(context)
+std::vector<std::pair<std::string, std::string>> rhiCapabilityShaderDefines(const RhiContext& context);
+
+// Per-vendor meshlet size preference, clamped to the device's mesh output limits.
+// NVIDIA favours 64 vertices / 124 triangles, AMD fills a 128-thread group with
+// 128 / 128; everything else uses the RhiMeshletSizeLimits defaults.
+RhiMeshletSizeLimits rhiPreferredMeshletSizeLimits(const RhiContext& context);
@@ -29,6 +29,14 @@ public:
     virtual std::unique_ptr<RhiCommandBuffer> createCommandBuffer() const = 0;
     virtual const IRhiInteropProvider* interopProvider() const { return nullptr; }
 
+    // Publishes scene material textures to the backend's bindless scene table.
+    // Returns false when passes must bind material textures themselves.
+    virtual bool updateBindlessSceneTextures(const RhiTexture* const* /*textures*/,
+                                             uint32_t /*count*/,
+                                             const RhiSampler& /*sampler*/) {
+        return false;
+    }
+
     virtual void initImGui() = 0;
     virtual void beginImGuiFrame(const RhiTexture* depthTexture) = 0;
     virtual void shutdownImGui() = 0;
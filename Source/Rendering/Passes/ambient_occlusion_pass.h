@@ -0,0 +1,176 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+// Ray-traced ambient occlusion at half width and half height (ambient_occlusion.slang).
+// Short inline ray queries against shadowResources.tlas, one 2x2 pixel per texel per
+// frame, accumulated over frames by depth-checked reprojection. The output holds the
+// occlusion and its view depth so DeferredLightingPass can upsample it bilaterally
+// into the sky ambient term. Without inline ray queries or a TLAS the pass records
+// nothing and the lighting pass ignores its output.
+class AmbientOcclusionPass : public RenderPass {
+public:
+    AmbientOcclusionPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(AmbientOcclusionPass, "Ambient Occlusion", "Lighting",
+        (std::vector<PassSlotInfo>{makeInputSlot("depth", "Depth")}),
+        (std::vector<PassSlotInfo>{makeOutputSlot("ambientOcclusion", "Ambient Occlusion")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.contains("radius")) {
+            m_radius = config.config["radius"].get<float>();
+        }
+        if (config.config.contains("rayCount")) {
+            m_rayCount = std::max(config.config["rayCount"].get<uint32_t>(), 1u);
+        }
+        if (config.config.contains("normalBias")) {
+            m_normalBias = config.config["normalBias"].get<float>();
+        }
+        if (config.config.contains("maxHistoryLength")) {
+            m_maxHistoryLength = config.config["maxHistoryLength"].get<float>();
+        }
+    }
+
+    FGResource ambientOcclusion;
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "ambientOcclusion") return ambientOcclusion;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        FGResource depthInput = getInput("depth");
+        if (depthInput.isValid()) {
+            m_depthRead = builder.read(depthInput);
+        }
+        ambientOcclusion = builder.create("ambientOcclusion",
+            FGTextureDesc::storageTexture(aoWidth(), aoHeight(), RhiFormat::RG16Float));
+        const FGTextureDesc historyDesc =
+            FGTextureDesc::storageTexture(aoWidth(), aoHeight(), RhiFormat::RGBA16Float);
+        m_prevHistory = builder.readHistory(kHistoryName, historyDesc);
+        m_history = builder.writeHistory(kHistoryName, historyDesc);
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("AmbientOcclusionPass");
+        MICROPROFILE_SCOPEI("RenderPass", "AmbientOcclusionPass", 0xffff8800);
+        const RhiComputePipeline* pipeline = activePipeline();
+        if (!pipeline || !m_frameContext || !m_depthRead.isValid()) return;
+
+        struct {
+            float4x4 invViewProj;
+            float4x4 viewProj;
+            float4x4 prevViewProj;
+            float4 cameraPosition;
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t aoWidth;
+            uint32_t aoHeight;
+            uint32_t frameIndex;
+            uint32_t reversedZ;
+            uint32_t historyValid;
+            uint32_t rayCount;
+            float radius;
+            float normalBias;
+            float maxHistoryLength;
+            float depthTolerance;
+        } uniforms{};
+        const float4x4 viewProj = m_frameContext->proj * m_frameContext->view;
+        float4x4 invViewProj = viewProj;
+        invViewProj.Invert();
+        uniforms.invViewProj = transpose(invViewProj);
+        uniforms.viewProj = transpose(viewProj);
+        uniforms.prevViewProj = transpose(m_frameContext->prevProj * m_frameContext->prevView);
+        uniforms.cameraPosition = m_frameContext->cameraWorldPos;
+        uniforms.screenWidth = static_cast<uint32_t>(m_width);
+        uniforms.screenHeight = static_cast<uint32_t>(m_height);
+        uniforms.aoWidth = aoWidth();
+        uniforms.aoHeight = aoHeight();
+        uniforms.frameIndex = m_frameContext->frameIndex;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+        uniforms.historyValid = !m_frameContext->historyReset &&
+                                m_frameGraph->isHistoryValid(m_prevHistory) ? 1u : 0u;
+        uniforms.rayCount = std::max(m_rayCount, 1u);
+        uniforms.radius = m_radius;
+        uniforms.normalBias = m_normalBias;
+        uniforms.maxHistoryLength = std::max(m_maxHistoryLength, 1.0f);
+        uniforms.depthTolerance = m_depthTolerance;
+
+        const RaytracedShadowResources& rt = m_ctx.shadowResources;
+        RhiTexture* prevHistoryTex = uniforms.historyValid ? m_frameGraph->getTexture(m_prevHistory) : nullptr;
+        encoder.setComputePipeline(*pipeline);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setAccelerationStructure(&rt.tlas, 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
+        // Without history the shader never reads slot 1.
+        encoder.setTexture(prevHistoryTex ? prevHistoryTex : &m_ctx.skyFallbackTex, 1);
+        encoder.setStorageTexture(m_frameGraph->getTexture(ambientOcclusion), 2);
+        encoder.setStorageTexture(m_frameGraph->getTexture(m_history), 3);
+        if (!rt.residentOnQueue()) {
+            encoder.useResource(rt.tlas, RhiResourceUsage::Read);
+            for (auto& blas : rt.blasArray) {
+                if (blas.nativeHandle()) {
+                    encoder.useResource(blas, RhiResourceUsage::Read);
+                }
+            }
+        }
+        encoder.dispatchThreadgroups({(aoWidth() + 7) / 8, (aoHeight() + 7) / 8, 1}, {8, 8, 1});
+        m_frameGraph->commitHistory(m_history);
+    }
+
+    void renderUI() override {
+        ImGui::Text("Resolution: %u x %u (1/4 of %d x %d)", aoWidth(), aoHeight(), m_width, m_height);
+        ImGui::Text("Ray Queries: %s", activePipeline() ? "Ready" : "Unavailable");
+        ImGui::SliderFloat("Radius", &m_radius, 0.05f, 10.0f, "%.2f");
+        int rayCount = static_cast<int>(m_rayCount);
+        if (ImGui::SliderInt("Rays Per Texel", &rayCount, 1, 8)) {
+            m_rayCount = static_cast<uint32_t>(rayCount);
+        }
+        ImGui::SliderFloat("Normal Bias", &m_normalBias, 0.0f, 0.5f, "%.3f");
+        ImGui::SliderFloat("Max History Length", &m_maxHistoryLength, 1.0f, 64.0f, "%.0f");
+    }
+
+private:
+    static constexpr const char* kHistoryName = "AmbientOcclusionHistory";
+
+    // DeferredLightingPass applies the same conditions before reading the output.
+    const RhiComputePipeline* activePipeline() const {
+        if (!m_runtimeContext || !m_runtimeContext->inlineRayQuery || !m_ctx.shadowResources.tlas.nativeHandle()) {
+            return nullptr;
+        }
+        auto it = m_runtimeContext->computePipelinesRhi.find("AmbientOcclusionPass");
+        if (it == m_runtimeContext->computePipelinesRhi.end() || !it->second.nativeHandle()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    uint32_t aoWidth() const { return (static_cast<uint32_t>(m_width) + 1) / 2; }
+    uint32_t aoHeight() const { return (static_cast<uint32_t>(m_height) + 1) / 2; }
+
+    const RenderContext& m_ctx;
+    FGResource m_depthRead;
+    FGResource m_prevHistory;
+    FGResource m_history;
+    int m_width, m_height;
+    std::string m_name = "Ambient Occlusion";
+    float m_radius = 1.0f;
+    uint32_t m_rayCount = 1;
+    float m_normalBias = 0.02f;
+    float m_maxHistoryLength = 16.0f;
+    float m_depthTolerance = 0.05f;
+};
+
+METALLIC_REGISTER_PASS(AmbientOcclusionPass);
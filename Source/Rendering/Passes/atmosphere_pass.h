@@ -0,0 +1,414 @@
+#pragma once
+
+#include "render_pass.h"
+#include "render_uniforms.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "rhi_resource_utils.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+// Builds SkyPass's precomputed atmosphere tables on the GPU
+// (atmosphere_precompute.slang) in RGBA16F, again whenever the density settings
+// change, and bakes the low-resolution sky-view LUT and the sky irradiance probe
+// (ambient light for DeferredLightingPass) for the current camera and sun every
+// frame. The scattering orders need four scratch tables that are released
+// once the tables are built. Backends without an RhiContext cannot create the 3D
+// table; there the pass publishes the runtime-imported tables instead and only
+// bakes the sky view and probe.
+class AtmospherePass : public RenderPass {
+public:
+    AtmospherePass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    ~AtmospherePass() override {
+        releaseScratch();
+        rhiReleaseHandle(m_transmittanceLut);
+        rhiReleaseHandle(m_scatteringLut);
+        rhiReleaseHandle(m_irradianceLut);
+    }
+
+    METALLIC_PASS_TYPE_INFO(AtmospherePass, "Atmosphere", "Environment",
+        (std::vector<PassSlotInfo>{}),
+        (std::vector<PassSlotInfo>{
+            makeOutputSlot("transmittance", "Transmittance"),
+            makeOutputSlot("scattering", "Scattering"),
+            makeOutputSlot("irradiance", "Irradiance"),
+            makeOutputSlot("skyView", "Sky View"),
+            makeOutputSlot("skyIrradiance", "Sky Irradiance")
+        }),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.contains("rayleighScaleHeight"))
+            m_settings.rayleighScaleHeight = config.config["rayleighScaleHeight"].get<float>();
+        if (config.config.contains("mieScaleHeight"))
+            m_settings.mieScaleHeight = config.config["mieScaleHeight"].get<float>();
+        if (config.config.contains("ozoneDensity"))
+            m_settings.ozoneDensity = config.config["ozoneDensity"].get<float>();
+        if (config.config.contains("groundAlbedo"))
+            m_settings.groundAlbedo = config.config["groundAlbedo"].get<float>();
+        if (config.config.contains("scatteringOrders"))
+            m_settings.scatteringOrders = std::clamp(config.config["scatteringOrders"].get<int>(), 1, 8);
+    }
+
+    FGResource getOutput(const std::string& outputName) const override {
+        if (outputName == "transmittance") return m_transmittance;
+        if (outputName == "scattering") return m_scattering;
+        if (outputName == "irradiance") return m_irradiance;
+        if (outputName == "skyView") return m_skyView;
+        if (outputName == "skyIrradiance") return m_skyIrradiance;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_transmittance = FGResource{};
+        m_scattering = FGResource{};
+        m_irradiance = FGResource{};
+
+        if (createLuts()) {
+            // Written only when the settings change, but declared every frame so
+            // SkyPass always orders after this pass.
+            m_transmittance = builder.write(m_frameGraph->import("atmosphereTransmittance", &m_transmittanceLut));
+            m_scattering = builder.write(m_frameGraph->import("atmosphereScattering", &m_scatteringLut));
+            m_irradiance = builder.write(m_frameGraph->import("atmosphereIrradiance", &m_irradianceLut));
+        } else if (m_runtimeContext) {
+            auto importTable = [&](const char* key, const char* name) {
+                auto it = m_runtimeContext->importedTexturesRhi.find(key);
+                if (it == m_runtimeContext->importedTexturesRhi.end() || !it->second.nativeHandle())
+                    return FGResource{};
+                return m_frameGraph->import(name, const_cast<RhiTextureHandle*>(&it->second));
+            };
+            m_transmittance = importTable("transmittance", "atmosphereTransmittance");
+            m_scattering = importTable("scattering", "atmosphereScattering");
+            m_irradiance = importTable("irradiance", "atmosphereIrradiance");
+            // Read for the sky view; passed through to SkyPass as they are.
+            if (m_transmittance.isValid()) builder.read(m_transmittance);
+            if (m_scattering.isValid()) builder.read(m_scattering);
+        }
+
+        m_skyView = builder.create("atmosphereSkyView",
+            FGTextureDesc::storageTexture(kSkyViewWidth, kSkyViewHeight, RhiFormat::RGBA16Float));
+        m_skyIrradiance = builder.create("atmosphereSkyIrradiance",
+            FGTextureDesc::storageTexture(kSkyIrradianceWidth, kSkyIrradianceHeight, RhiFormat::RGBA16Float));
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("AtmospherePass");
+        MICROPROFILE_SCOPEI("RenderPass", "AtmospherePass", 0xffff8800);
+        if (!m_frameContext || !m_runtimeContext || !m_frameContext->enableAtmosphereSky) return;
+
+        auto samplerIt = m_runtimeContext->samplersRhi.find("atmosphere");
+        if (samplerIt == m_runtimeContext->samplersRhi.end() || !samplerIt->second.nativeHandle()) return;
+        encoder.setSampler(&samplerIt->second, 0);
+
+        if (m_ownsLuts && (!m_lutsBuilt || m_builtSettings != m_settings)) {
+            if (precompute(encoder)) {
+                m_lutsBuilt = true;
+                m_builtSettings = m_settings;
+                ++m_buildCount;
+            }
+        }
+
+        bakeSkyView(encoder);
+    }
+
+    void renderUI() override {
+        if (!m_ownsLuts) {
+            ImGui::TextDisabled("Tables: imported (no GPU precompute on this backend)");
+        } else {
+            ImGui::Text("Tables: %s, built %u time%s", m_lutsBuilt ? "ready" : "pending",
+                        m_buildCount, m_buildCount == 1 ? "" : "s");
+            ImGui::SliderFloat("Rayleigh Scale Height (km)", &m_settings.rayleighScaleHeight, 1.0f, 20.0f, "%.2f");
+            ImGui::SliderFloat("Mie Scale Height (km)", &m_settings.mieScaleHeight, 0.2f, 5.0f, "%.2f");
+            ImGui::SliderFloat("Ozone Density", &m_settings.ozoneDensity, 0.0f, 2.0f, "%.2f");
+            ImGui::SliderFloat("Ground Albedo", &m_settings.groundAlbedo, 0.0f, 1.0f, "%.2f");
+            ImGui::SliderInt("Scattering Orders", &m_settings.scatteringOrders, 1, 8);
+        }
+        ImGui::Text("Sky View: %u x %u, Irradiance Probe: %u x %u", kSkyViewWidth, kSkyViewHeight,
+                    kSkyIrradianceWidth, kSkyIrradianceHeight);
+    }
+
+private:
+    struct Settings {
+        float rayleighScaleHeight = 8.0f;
+        float mieScaleHeight = 1.2f;
+        float ozoneDensity = 1.0f;
+        float groundAlbedo = 0.1f;
+        int scatteringOrders = 4;
+
+        bool operator==(const Settings&) const = default;
+    };
+
+    // Texture slots of atmosphere_precompute.slang, in declaration order.
+    enum Slot : uint32_t {
+        kTransmittanceTexture,
+        kDeltaRayleighTexture,
+        kDeltaMieTexture,
+        kDeltaIrradianceTexture,
+        kScatteringDensityTexture,
+        kScatteringTexture,
+        kTransmittanceOut,
+        kIrradianceOut,
+        kDeltaIrradianceOut,
+        kDeltaRayleighOut,
+        kDeltaMieOut,
+        kScatteringOut,
+        kScatteringDensityOut,
+        kSkyViewOut,
+        kSkyIrradianceOut,
+        kSlotCount
+    };
+
+    // Table sizes fixed by atmosphere_common.slang.
+    static constexpr uint32_t kTransmittanceWidth = 256;
+    static constexpr uint32_t kTransmittanceHeight = 64;
+    static constexpr uint32_t kScatteringWidth = 256;
+    static constexpr uint32_t kScatteringHeight = 128;
+    static constexpr uint32_t kScatteringDepth = 32;
+    static constexpr uint32_t kIrradianceWidth = 64;
+    static constexpr uint32_t kIrradianceHeight = 16;
+    static constexpr uint32_t kSkyViewWidth = 192;
+    static constexpr uint32_t kSkyViewHeight = 108;
+    static constexpr uint32_t kSkyIrradianceWidth = 16;
+    static constexpr uint32_t kSkyIrradianceHeight = 8;
+
+    static constexpr float kBottomRadiusKm = 6360.0f;
+    static constexpr float kOzoneCenterAltitudeKm = 25.0f;
+    static constexpr float kOzoneWidthKm = 30.0f;
+
+    static constexpr RhiTextureUsage kLutUsage = RhiTextureUsage::ShaderRead | RhiTextureUsage::ShaderWrite;
+
+    RhiTextureHandle createTable2D(uint32_t w, uint32_t h) const {
+        return m_runtimeContext->rhi->createTexture2D(w, h, RhiFormat::RGBA16Float, false, 1,
+                                                      RhiTextureStorageMode::Private, kLutUsage);
+    }
+
+    RhiTextureHandle createTable3D() const {
+        return m_runtimeContext->rhi->createTexture3D(kScatteringWidth, kScatteringHeight, kScatteringDepth,
+                                                      RhiFormat::RGBA16Float, RhiTextureStorageMode::Private,
+                                                      kLutUsage);
+    }
+
+    bool createLuts() {
+        if (m_ownsLuts) return true;
+        if (!m_runtimeContext || !m_runtimeContext->rhi) return false;
+        m_transmittanceLut = createTable2D(kTransmittanceWidth, kTransmittanceHeight);
+        m_scatteringLut = createTable3D();
+        m_irradianceLut = createTable2D(kIrradianceWidth, kIrradianceHeight);
+        if (!m_transmittanceLut.nativeHandle() || !m_scatteringLut.nativeHandle() ||
+            !m_irradianceLut.nativeHandle()) {
+            rhiReleaseHandle(m_transmittanceLut);
+            rhiReleaseHandle(m_scatteringLut);
+            rhiReleaseHandle(m_irradianceLut);
+            return false;
+        }
+        m_ownsLuts = true;
+        m_lutsBuilt = false;
+        return true;
+    }
+
+    bool createScratch() {
+        m_deltaIrradiance = createTable2D(kIrradianceWidth, kIrradianceHeight);
+        m_deltaRayleigh = createTable3D();
+        m_deltaMie = createTable3D();
+        m_scatteringDensity = createTable3D();
+        if (!m_deltaIrradiance.nativeHandle() || !m_deltaRayleigh.nativeHandle() ||
+            !m_deltaMie.nativeHandle() || !m_scatteringDensity.nativeHandle()) {
+            releaseScratch();
+            return false;
+        }
+        return true;
+    }
+
+    // The dispatches that use the scratch tables are still in flight.
+    void releaseScratch() {
+        for (RhiTextureHandle* scratch : {&m_deltaIrradiance, &m_deltaRayleigh, &m_deltaMie, &m_scatteringDensity}) {
+            void* nativeHandle = scratch->nativeHandle();
+            scratch->setNativeHandle(nullptr);
+            if (!nativeHandle) continue;
+            if (m_runtimeContext && m_runtimeContext->rhi) {
+                m_runtimeContext->rhi->deferRelease([nativeHandle]() { rhiReleaseNativeHandle(nativeHandle); });
+            } else {
+                rhiReleaseNativeHandle(nativeHandle);
+            }
+        }
+    }
+
+    const RhiComputePipelineHandle* findPipeline(const char* key) const {
+        auto it = m_runtimeContext->computePipelinesRhi.find(key);
+        return it != m_runtimeContext->computePipelinesRhi.end() && it->second.nativeHandle() ? &it->second
+                                                                                               : nullptr;
+    }
+
+    // Slots keep their binding across dispatches; drop them so a table bound for
+    // reading is not also transitioned for the next kernel's write.
+    static void clearSlots(RhiComputeCommandEncoder& encoder) {
+        for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+            encoder.setTexture(nullptr, slot);
+        }
+    }
+
+    static void dispatch2D(RhiComputeCommandEncoder& encoder, uint32_t w, uint32_t h) {
+        encoder.dispatchThreadgroups({(w + 7) / 8, (h + 7) / 8, 1}, {8, 8, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Textures);
+    }
+
+    static void dispatchScattering(RhiComputeCommandEncoder& encoder) {
+        encoder.dispatchThreadgroups({kScatteringWidth / 8, kScatteringHeight / 8, kScatteringDepth}, {8, 8, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Textures);
+    }
+
+    AtmosphereLutUniforms makeUniforms() const {
+        AtmosphereLutUniforms uniforms{};
+        uniforms.groundAlbedo = float4(m_settings.groundAlbedo, m_settings.groundAlbedo, m_settings.groundAlbedo, 0.0f);
+        uniforms.rayleighScaleHeight = m_settings.rayleighScaleHeight;
+        uniforms.mieScaleHeight = m_settings.mieScaleHeight;
+        uniforms.ozoneCenterAltitude = kOzoneCenterAltitudeKm;
+        uniforms.ozoneWidth = kOzoneWidthKm;
+        uniforms.ozoneDensity = m_settings.ozoneDensity;
+        uniforms.skyViewWidth = kSkyViewWidth;
+        uniforms.skyViewHeight = kSkyViewHeight;
+        if (m_frameContext) {
+            const float4& cameraWorld = m_frameContext->cameraWorldPos;
+            uniforms.camera = float4(cameraWorld.x / 1000.0f,
+                                     cameraWorld.y / 1000.0f + kBottomRadiusKm,
+                                     cameraWorld.z / 1000.0f,
+                                     0.0f);
+            uniforms.sunDirection = m_frameContext->worldLightDir;
+        }
+        return uniforms;
+    }
+
+    bool precompute(RhiComputeCommandEncoder& encoder) {
+        const RhiComputePipelineHandle* transmittancePipe = findPipeline("AtmosphereTransmittancePass");
+        const RhiComputePipelineHandle* directIrradiancePipe = findPipeline("AtmosphereDirectIrradiancePass");
+        const RhiComputePipelineHandle* singleScatteringPipe = findPipeline("AtmosphereSingleScatteringPass");
+        const RhiComputePipelineHandle* densityPipe = findPipeline("AtmosphereScatteringDensityPass");
+        const RhiComputePipelineHandle* indirectIrradiancePipe = findPipeline("AtmosphereIndirectIrradiancePass");
+        const RhiComputePipelineHandle* multipleScatteringPipe = findPipeline("AtmosphereMultipleScatteringPass");
+        if (!transmittancePipe || !directIrradiancePipe || !singleScatteringPipe || !densityPipe ||
+            !indirectIrradiancePipe || !multipleScatteringPipe) {
+            return false;
+        }
+        if (!createScratch()) return false;
+
+        AtmosphereLutUniforms uniforms = makeUniforms();
+
+        clearSlots(encoder);
+        encoder.setComputePipeline(*transmittancePipe);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setStorageTexture(&m_transmittanceLut, kTransmittanceOut);
+        dispatch2D(encoder, kTransmittanceWidth, kTransmittanceHeight);
+
+        clearSlots(encoder);
+        encoder.setComputePipeline(*directIrradiancePipe);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(&m_transmittanceLut, kTransmittanceTexture);
+        encoder.setStorageTexture(&m_irradianceLut, kIrradianceOut);
+        encoder.setStorageTexture(&m_deltaIrradiance, kDeltaIrradianceOut);
+        dispatch2D(encoder, kIrradianceWidth, kIrradianceHeight);
+
+        clearSlots(encoder);
+        encoder.setComputePipeline(*singleScatteringPipe);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(&m_transmittanceLut, kTransmittanceTexture);
+        encoder.setStorageTexture(&m_deltaRayleigh, kDeltaRayleighOut);
+        encoder.setStorageTexture(&m_deltaMie, kDeltaMieOut);
+        encoder.setStorageTexture(&m_scatteringLut, kScatteringOut);
+        dispatchScattering(encoder);
+
+        // deltaRayleigh holds single Rayleigh until the first multiple scattering
+        // pass overwrites it with order 2, which is all the next order reads.
+        for (int order = 2; order <= m_settings.scatteringOrders; ++order) {
+            uniforms.scatteringOrder = static_cast<uint32_t>(order);
+
+            clearSlots(encoder);
+            encoder.setComputePipeline(*densityPipe);
+            encoder.setPushConstants(&uniforms, sizeof(uniforms));
+            encoder.setTexture(&m_transmittanceLut, kTransmittanceTexture);
+            encoder.setTexture(&m_deltaRayleigh, kDeltaRayleighTexture);
+            encoder.setTexture(&m_deltaMie, kDeltaMieTexture);
+            encoder.setTexture(&m_deltaIrradiance, kDeltaIrradianceTexture);
+            encoder.setStorageTexture(&m_scatteringDensity, kScatteringDensityOut);
+            dispatchScattering(encoder);
+
+            clearSlots(encoder);
+            encoder.setComputePipeline(*indirectIrradiancePipe);
+            encoder.setPushConstants(&uniforms, sizeof(uniforms));
+            encoder.setTexture(&m_deltaRayleigh, kDeltaRayleighTexture);
+            encoder.setTexture(&m_deltaMie, kDeltaMieTexture);
+            encoder.setStorageTexture(&m_irradianceLut, kIrradianceOut);
+            encoder.setStorageTexture(&m_deltaIrradiance, kDeltaIrradianceOut);
+            dispatch2D(encoder, kIrradianceWidth, kIrradianceHeight);
+
+            clearSlots(encoder);
+            encoder.setComputePipeline(*multipleScatteringPipe);
+            encoder.setPushConstants(&uniforms, sizeof(uniforms));
+            encoder.setTexture(&m_transmittanceLut, kTransmittanceTexture);
+            encoder.setTexture(&m_scatteringDensity, kScatteringDensityTexture);
+            encoder.setStorageTexture(&m_deltaRayleigh, kDeltaRayleighOut);
+            encoder.setStorageTexture(&m_scatteringLut, kScatteringOut);
+            dispatchScattering(encoder);
+        }
+
+        clearSlots(encoder);
+        releaseScratch();
+        return true;
+    }
+
+    // The sky view and the irradiance probe only read the tables, so both stay
+    // bound for the two dispatches and need no barrier between them.
+    void bakeSkyView(RhiComputeCommandEncoder& encoder) {
+        const RhiComputePipelineHandle* skyViewPipe = findPipeline("AtmosphereSkyViewPass");
+        const RhiComputePipelineHandle* skyIrradiancePipe = findPipeline("AtmosphereSkyIrradiancePass");
+        if (!skyViewPipe || !skyIrradiancePipe || !m_transmittance.isValid() || !m_scattering.isValid()) return;
+        if (m_ownsLuts && !m_lutsBuilt) return;
+
+        RhiTexture* transmittanceTex = m_frameGraph->getTexture(m_transmittance);
+        RhiTexture* scatteringTex = m_frameGraph->getTexture(m_scattering);
+        RhiTexture* skyViewTex = m_frameGraph->getTexture(m_skyView);
+        RhiTexture* skyIrradianceTex = m_frameGraph->getTexture(m_skyIrradiance);
+        if (!transmittanceTex || !scatteringTex || !skyViewTex || !skyIrradianceTex) return;
+
+        AtmosphereLutUniforms uniforms = makeUniforms();
+        encoder.setComputePipeline(*skyViewPipe);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(transmittanceTex, kTransmittanceTexture);
+        encoder.setTexture(scatteringTex, kScatteringTexture);
+        encoder.setStorageTexture(skyViewTex, kSkyViewOut);
+        encoder.setStorageTexture(skyIrradianceTex, kSkyIrradianceOut);
+        encoder.dispatchThreadgroups({(kSkyViewWidth + 7) / 8, (kSkyViewHeight + 7) / 8, 1}, {8, 8, 1});
+
+        encoder.setComputePipeline(*skyIrradiancePipe);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.dispatchThreadgroups({(kSkyIrradianceWidth + 7) / 8, (kSkyIrradianceHeight + 7) / 8, 1}, {8, 8, 1});
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Atmosphere";
+
+    Settings m_settings;
+    Settings m_builtSettings;
+    bool m_ownsLuts = false;
+    bool m_lutsBuilt = false;
+    uint32_t m_buildCount = 0;
+
+    RhiTextureHandle m_transmittanceLut;
+    RhiTextureHandle m_scatteringLut;
+    RhiTextureHandle m_irradianceLut;
+    RhiTextureHandle m_deltaIrradiance;
+    RhiTextureHandle m_deltaRayleigh;
+    RhiTextureHandle m_deltaMie;
+    RhiTextureHandle m_scatteringDensity;
+
+    FGResource m_transmittance, m_scattering, m_irradiance, m_skyView, m_skyIrradiance;
+};
+
+METALLIC_REGISTER_PASS(AtmospherePass);
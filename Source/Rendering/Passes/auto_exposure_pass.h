@@ -6,6 +6,8 @@
 #include "pass_registry.h"
 #include "imgui.h"
 
+#include <algorithm>
+
 class AutoExposurePass : public RenderPass {
 public:
     AutoExposurePass(const RenderContext& ctx, int w, int h)
@@ -28,6 +30,7 @@ public:
         if (config.config.contains("adaptationSpeed")) m_adaptationSpeed = config.config["adaptationSpeed"].get<float>();
         if (config.config.contains("lowPercentile")) m_lowPercentile = config.config["lowPercentile"].get<float>();
         if (config.config.contains("highPercentile")) m_highPercentile = config.config["highPercentile"].get<float>();
+        if (config.config.contains("sampleGrid")) m_sampleGridSize = config.config["sampleGrid"].get<int>();
     }
 
     FGResource getOutput(const std::string& outputName) const override {
@@ -38,6 +41,9 @@ public:
     void setup(FGBuilder& builder) override {
         m_sourceRead = FGResource{};
         m_exposureLut = FGResource{};
+        // The histogram buffer is private to this pass, so the frame graph sees every
+        // resource it shares with other passes.
+        builder.setQueueHint(RhiQueueHint::AsyncCompute);
 
         FGResource sourceInput = getSourceInput();
         if (sourceInput.isValid()) {
@@ -53,22 +59,18 @@ public:
         MICROPROFILE_SCOPEI("RenderPass", "AutoExposurePass", 0xffff8800);
         if (!m_runtimeContext || !m_sourceRead.isValid()) return;
 
-        // Lazy-create histogram buffer
+        // Lazy-create histogram buffer: 256 bins plus the completion counter
         if (!m_histogramBuffer && m_runtimeContext->resourceFactory) {
             RhiBufferDesc desc;
-            desc.size = 256 * sizeof(uint32_t);
-            desc.hostVisible = false;
+            desc.size = (256 + 1) * sizeof(uint32_t);
+            desc.memory = RhiBufferMemory::DeviceLocal;
             desc.debugName = "AutoExposureHistogram";
             m_histogramBuffer = m_runtimeContext->resourceFactory->createBuffer(desc);
         }
         if (!m_histogramBuffer) return;
 
-        auto histIt = m_runtimeContext->computePipelinesRhi.find("HistogramPass");
         auto expIt = m_runtimeContext->computePipelinesRhi.find("AutoExposurePass");
-        if (histIt == m_runtimeContext->computePipelinesRhi.end() ||
-            expIt == m_runtimeContext->computePipelinesRhi.end() ||
-            !histIt->second.nativeHandle() ||
-            !expIt->second.nativeHandle()) return;
+        if (expIt == m_runtimeContext->computePipelinesRhi.end() || !expIt->second.nativeHandle()) return;
 
         AutoExposureUniforms uniforms{};
         uniforms.evMinValue = m_evMin;
@@ -87,30 +89,28 @@ public:
         uniforms.screenWidth = sourceWidth > 0 ? sourceWidth : static_cast<uint32_t>(m_width);
         uniforms.screenHeight = sourceHeight > 0 ? sourceHeight : static_cast<uint32_t>(m_height);
 
-        // Slang wraps all globals into KernelContext — both kernels expect all bindings:
+        // The histogram samples a fixed grid whose long side is m_sampleGridSize,
+        // so the cost stays flat as the source resolution grows.
+        const uint32_t longSide = std::max(uniforms.screenWidth, uniforms.screenHeight);
+        const uint32_t gridLongSide = std::min(longSide, static_cast<uint32_t>(std::max(m_sampleGridSize, 16)));
+        uniforms.sampleWidth = std::max(1u, uniforms.screenWidth * gridLongSide / longSide);
+        uniforms.sampleHeight = std::max(1u, uniforms.screenHeight * gridLongSide / longSide);
+        const uint32_t groupsX = (uniforms.sampleWidth + 15) / 16;
+        const uint32_t groupsY = (uniforms.sampleHeight + 15) / 16;
+        uniforms.groupCount = groupsX * groupsY;
+        m_lastSampleWidth = uniforms.sampleWidth;
+        m_lastSampleHeight = uniforms.sampleHeight;
+
+        // Slang wraps all globals into KernelContext — the kernel expects all bindings:
         // push_constant = uniforms, texture(0) = hdrInput, buffer(1) = histogramBuffer, texture(1) = exposureLut
 
-        // Dispatch 1: Histogram
-        encoder.setComputePipeline(histIt->second);
-        encoder.setPushConstants(&uniforms, sizeof(uniforms));
-        encoder.setTexture(hdrTex, 0);
-        encoder.setStorageTexture(lutTex, 1);
-        encoder.setBuffer(m_histogramBuffer.get(), 0, 1);
-        encoder.dispatchThreadgroups({static_cast<uint32_t>((uniforms.screenWidth + 15) / 16),
-                                      static_cast<uint32_t>((uniforms.screenHeight + 15) / 16),
-                                      1},
-                                     {16, 16, 1});
-
-        // Memory barrier between dispatches
-        encoder.memoryBarrier(RhiBarrierScope::Buffers);
-
-        // Dispatch 2: Exposure
+        // Histogram, then percentile resolve in the last group to finish
         encoder.setComputePipeline(expIt->second);
         encoder.setPushConstants(&uniforms, sizeof(uniforms));
         encoder.setTexture(hdrTex, 0);
         encoder.setStorageTexture(lutTex, 1);
         encoder.setBuffer(m_histogramBuffer.get(), 0, 1);
-        encoder.dispatchThreadgroups({1, 1, 1}, {256, 1, 1});
+        encoder.dispatchThreadgroups({groupsX, groupsY, 1}, {16, 16, 1});
     }
 
     void renderUI() override {
@@ -120,6 +120,8 @@ public:
         ImGui::SliderFloat("Adaptation Speed", &m_adaptationSpeed, 0.1f, 10.0f, "%.1f");
         ImGui::SliderFloat("Low Percentile", &m_lowPercentile, 0.0f, 0.5f, "%.2f");
         ImGui::SliderFloat("High Percentile", &m_highPercentile, 0.5f, 1.0f, "%.2f");
+        ImGui::SliderInt("Sample Grid", &m_sampleGridSize, 16, 1024);
+        ImGui::Text("Samples: %u x %u", m_lastSampleWidth, m_lastSampleHeight);
     }
 
 private:
@@ -140,6 +142,9 @@ private:
     float m_adaptationSpeed = 1.1f;
     float m_lowPercentile = 0.1f;
     float m_highPercentile = 0.9f;
+    int m_sampleGridSize = 256;
+    uint32_t m_lastSampleWidth = 0;
+    uint32_t m_lastSampleHeight = 0;
 };
 
 METALLIC_REGISTER_PASS(AutoExposurePass);
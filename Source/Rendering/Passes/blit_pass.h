@@ -25,6 +25,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         m_sourceRead = builder.read(m_source, FGResourceUsage::TransferSrc);
         m_destWrite = builder.write(m_dest, FGResourceUsage::TransferDst);
     }
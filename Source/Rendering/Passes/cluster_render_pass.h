@@ -5,17 +5,23 @@
 #include "cluster_lod_builder.h"
 #include "cluster_types.h"
 #include "gpu_driven_constants.h"
+#include "gpu_driven_helpers.h"
 #include "pass_registry.h"
 #include "imgui.h"
 #include <spdlog/spdlog.h>
 
+// Debug view of the cluster LOD cut. Draws what MeshletCullPass found visible with
+// one indirect mesh dispatch, so visualizing a scene costs what rendering it does.
 class ClusterRenderPass : public RenderPass {
 public:
     ClusterRenderPass(const RenderContext& ctx, int w, int h)
         : m_ctx(ctx), m_width(w), m_height(h) {}
 
     METALLIC_PASS_TYPE_INFO(ClusterRenderPass, "Cluster Render", "Geometry",
-        (std::vector<PassSlotInfo>{}),
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("visibleMeshlets", "Visible Meshlets"),
+            makeInputSlot("cullCounter", "Cull Counter")
+        }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("color", "Color"),
             makeOutputSlot("depth", "Depth")
@@ -39,6 +45,15 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        m_visibleMeshletsRead = m_cullCounterRead = FGResource{};
+        FGResource visibleMeshletsInput = getInput("visibleMeshlets");
+        if (visibleMeshletsInput.isValid()) {
+            m_visibleMeshletsRead = builder.read(visibleMeshletsInput, FGResourceUsage::StorageRead);
+        }
+        FGResource cullCounterInput = getInput("cullCounter");
+        if (cullCounterInput.isValid()) {
+            m_cullCounterRead = builder.read(cullCounterInput, FGResourceUsage::Indirect);
+        }
         color = builder.create("clusterVisColor",
             FGTextureDesc::renderTarget(m_width, m_height, RhiFormat::RGBA8Unorm));
         depth = builder.create("clusterVisDepth",
@@ -64,11 +79,18 @@ public:
             return;
         }
 
-        if (!m_ctx.clusterLodData.packedClusterBuffer.nativeHandle() ||
+        const RhiBuffer* visibleMeshletBuffer =
+            m_visibleMeshletsRead.isValid() ? m_frameGraph->getBuffer(m_visibleMeshletsRead) : nullptr;
+        const RhiBuffer* cullCounterBuffer =
+            m_cullCounterRead.isValid() ? m_frameGraph->getBuffer(m_cullCounterRead) : nullptr;
+        m_lastVisibleClusters =
+            GpuDriven::readPublishedWorkItemCount<GpuDriven::MeshDispatchCommandLayout>(cullCounterBuffer);
+        if (!m_frameContext->gpuDrivenCulling ||
+            !visibleMeshletBuffer ||
+            !cullCounterBuffer ||
+            !m_ctx.clusterLodData.packedClusterBuffer.nativeHandle() ||
             !m_ctx.clusterLodData.clusterVertexDataBuffer.nativeHandle() ||
-            !m_ctx.clusterLodData.clusterIndexDataBuffer.nativeHandle() ||
-            !m_ctx.gpuScene.clusterVisWorklistBuffer.nativeHandle() ||
-            m_ctx.gpuScene.clusterVisWorklistCount == 0) {
+            !m_ctx.clusterLodData.clusterIndexDataBuffer.nativeHandle()) {
             return;
         }
 
@@ -93,8 +115,8 @@ public:
 
         encoder.setPushConstants(&pushData, sizeof(pushData));
 
-        encoder.setMeshBuffer(&m_ctx.gpuScene.clusterVisWorklistBuffer, 0,
-                              GpuDriven::ClusterRenderBindings::kClusterInfos);
+        encoder.setMeshBuffer(visibleMeshletBuffer, 0,
+                              GpuDriven::ClusterRenderBindings::kVisibleMeshlets);
         encoder.setMeshBuffer(&m_ctx.clusterLodData.packedClusterBuffer, 0,
                               GpuDriven::ClusterRenderBindings::kClusters);
         encoder.setMeshBuffer(&m_ctx.clusterLodData.clusterVertexDataBuffer, 0,
@@ -109,8 +131,10 @@ public:
         encoder.setFragmentBuffer(&m_ctx.gpuScene.instanceBuffer, 0,
                                   GpuDriven::ClusterRenderBindings::kInstances);
 
-        uint32_t clusterCount = m_ctx.gpuScene.clusterVisWorklistCount;
-        encoder.drawMeshThreadgroups({clusterCount, 1, 1}, {1, 1, 1}, {32, 1, 1});
+        encoder.drawMeshThreadgroupsIndirect(*cullCounterBuffer,
+                                             GpuDriven::MeshDispatchCommandLayout::kIndirectArgsOffset,
+                                             {1, 1, 1},
+                                             {128, 1, 1});
     }
 
     void renderUI() override {
@@ -120,15 +144,18 @@ public:
             if (ImGui::Combo("Color Mode", &mode, modes, 4)) {
                 m_colorMode = static_cast<uint32_t>(mode);
             }
-            ImGui::Text("Clusters: %u", m_ctx.gpuScene.clusterVisWorklistCount);
+            ImGui::Text("Visible clusters: %u", m_lastVisibleClusters);
             ImGui::Text("Packed data: %.1f KB vtx, %.1f KB idx",
-                        m_ctx.clusterLodData.clusterVertexData.size() / 1024.0,
-                        m_ctx.clusterLodData.clusterIndexData.size() / 1024.0);
+                        m_ctx.clusterLodData.clusterVertexDataBuffer.size() / 1024.0,
+                        m_ctx.clusterLodData.clusterIndexDataBuffer.size() / 1024.0);
         }
     }
 
 private:
     const RenderContext& m_ctx;
+    FGResource m_visibleMeshletsRead;
+    FGResource m_cullCounterRead;
+    uint32_t m_lastVisibleClusters = 0;
     int m_width, m_height;
     std::string m_name = "ClusterRenderPass";
     uint32_t m_colorMode = 0;
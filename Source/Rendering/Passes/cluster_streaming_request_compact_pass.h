@@ -0,0 +1,105 @@
+#pragma once
+
+#include "cluster_streaming_service.h"
+#include "gpu_cull_resources.h"
+#include "pass_registry.h"
+#include "render_pass.h"
+
+#include <algorithm>
+
+class ClusterStreamingRequestCompactPass : public RenderPass {
+public:
+    ClusterStreamingRequestCompactPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    ~ClusterStreamingRequestCompactPass() override = default;
+
+    METALLIC_PASS_TYPE_INFO(ClusterStreamingRequestCompactPass,
+        "Cluster Streaming Request Compact", "Geometry",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("cullResult", "Cull Result", true)
+        }),
+        (std::vector<PassSlotInfo>{}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    void setup(FGBuilder& builder) override {
+        FGResource cullInput = getInput("cullResult");
+        if (cullInput.isValid()) {
+            m_cullResultRead = builder.read(cullInput);
+        }
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        if (!m_runtimeContext || !m_frameContext) {
+            return;
+        }
+
+        auto pipelineIt =
+            m_runtimeContext->computePipelinesRhi.find("ClusterStreamingRequestCompactPass");
+        if (pipelineIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !pipelineIt->second.nativeHandle()) {
+            return;
+        }
+
+        ClusterStreamingService* streamingService = m_runtimeContext->clusterStreamingService;
+        if (!streamingService ||
+            !streamingService->ready() ||
+            !streamingService->streamingEnabled() ||
+            !streamingService->compactRequestReadbackEnabled() ||
+            m_ctx.clusterLodData.totalGroupCount == 0u) {
+            return;
+        }
+
+        const RhiBuffer* residencyRequestBuffer = streamingService->residencyRequestBuffer();
+        const RhiBuffer* residencyRequestStateBuffer =
+            streamingService->residencyRequestStateBuffer();
+        const RhiBuffer* compactRequestBuffer = streamingService->compactResidencyRequestBuffer();
+        if (!residencyRequestBuffer || !residencyRequestStateBuffer || !compactRequestBuffer) {
+            return;
+        }
+
+        StreamingRequestCompactUniforms uniforms{};
+        uniforms.requestFrameIndex = m_frameContext->frameIndex;
+        uniforms.requestCapacity = static_cast<uint32_t>(
+            residencyRequestBuffer->size() / sizeof(ClusterResidencyRequest));
+        uniforms.outputCapacity = std::min(
+            streamingService->compactResidencyRequestOutputCapacity(),
+            static_cast<uint32_t>((compactRequestBuffer->size() -
+                                   sizeof(ClusterResidencyRequestListHeader)) /
+                                  sizeof(ClusterResidencyRequest)));
+
+        encoder.setComputePipeline(pipelineIt->second);
+        encoder.setBytes(&uniforms,
+                         sizeof(uniforms),
+                         GpuDriven::StreamingRequestCompactBindings::kUniforms);
+        encoder.setBuffer(residencyRequestBuffer,
+                          0,
+                          GpuDriven::StreamingRequestCompactBindings::kResidencyRequests);
+        encoder.setBuffer(residencyRequestStateBuffer,
+                          0,
+                          GpuDriven::StreamingRequestCompactBindings::kResidencyRequestState);
+        encoder.setBuffer(compactRequestBuffer,
+                          0,
+                          GpuDriven::StreamingRequestCompactBindings::kOutput);
+
+        // One threadgroup sorts the whole list; see stream_compact_requests.slang.
+        encoder.dispatchThreadgroups({1, 1, 1}, {256, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+    }
+
+private:
+    const RenderContext& m_ctx;
+    int m_width = 0;
+    int m_height = 0;
+    std::string m_name = "Cluster Streaming Request Compact";
+    FGResource m_cullResultRead;
+};
+
+METALLIC_REGISTER_PASS(ClusterStreamingRequestCompactPass);
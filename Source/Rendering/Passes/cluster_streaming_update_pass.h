@@ -7,11 +7,11 @@
 #include "rhi_resource_utils.h"
 
 #include <cstring>
+#include <vector>
 
 #ifdef _WIN32
 #include "vulkan_upload_service.h"
 #include "vulkan_resource_handles.h"
-#include <vector>
 #endif
 
 class ClusterStreamingUpdatePass : public RenderPass {
@@ -46,7 +46,7 @@ public:
         m_streamingSync = builder.createToken("ClusterStreamingSync");
     }
 
-    void prepareResources(RhiCommandBuffer&) override {
+    void prepareResources(RhiCommandBuffer& commandBuffer) override {
         if (!m_runtimeContext || !m_runtimeContext->clusterStreamingService) {
             return;
         }
@@ -54,6 +54,14 @@ public:
         m_runtimeContext->clusterStreamingService->runUpdateStage(m_ctx.clusterLodData,
                                                                   *m_runtimeContext,
                                                                   m_frameContext);
+#ifdef __APPLE__
+        // The update task's copies ran on the transfer queue in an earlier frame.
+        m_updateTransferWaitValue =
+            m_runtimeContext->clusterStreamingService->consumePendingTransferWaitValue();
+        commandBuffer.waitForTransfer(m_updateTransferWaitValue);
+#else
+        (void)commandBuffer;
+#endif
     }
 
     void executeCompute(RhiComputeCommandEncoder& encoder) override {
@@ -152,13 +160,24 @@ public:
                 return;
             }
         }
+#else
+        const std::vector<StreamingStorage::CopyRegion>& copyRegions =
+            streamingService->streamingUploadCopyRegions();
+        if (!copyRegions.empty()) {
+            // A zero wait value means there is no transfer queue; the update shader then
+            // copies straight from the source buffer instead.
+            streamingService->completeTransferTask(
+                submitStreamingDataCopiesAsync(streamingService->streamingUploadStagingBuffer(),
+                                               residentGroupMeshletIndicesBuffer,
+                                               copyRegions));
+        }
 #endif
 
         StreamingUpdateUniforms uniforms{};
 #ifdef _WIN32
         uniforms.copySourceData = 0u;
 #else
-        uniforms.copySourceData = 1u;
+        uniforms.copySourceData = m_updateTransferWaitValue == 0u ? 1u : 0u;
 #endif
         uniforms.sourceGroupMeshletIndexCount =
             sourceGroupMeshletIndicesBuffer
@@ -174,6 +193,8 @@ public:
                 : 0u;
         uniforms.activeResidentGroupCapacity = static_cast<uint32_t>(
             activeResidentGroupsBuffer->size() / sizeof(uint32_t));
+        uniforms.residentHeapAddress = streamingService->residentHeapAddress();
+        uniforms.residentHeapAddressing = uniforms.residentHeapAddress != 0u ? 1u : 0u;
 
         encoder.setComputePipeline(pipelineIt->second);
         if (sourceGroupMeshletIndicesBuffer) {
@@ -217,6 +238,18 @@ public:
             encoder.setBytes(&uniforms, sizeof(uniforms), GpuDriven::StreamingUpdateBindings::kUniforms);
             const uint32_t dispatchX = (patchCount + kThreadCount - 1u) / kThreadCount;
             encoder.dispatchThreadgroups({dispatchX, 1, 1}, {kThreadCount, 1, 1});
+
+            // Cluster copies run one thread per cluster rather than one loop per patch,
+            // so a few large groups no longer serialize on a handful of lanes. They
+            // write only the resident index heap, so no barrier against the page table.
+            const uint32_t copyClusterCount = streamingService->streamingPatchClusterCount();
+            if (uniforms.copySourceData != 0u && copyClusterCount != 0u) {
+                uniforms.patchMode = 2u;
+                uniforms.copyClusterCount = copyClusterCount;
+                encoder.setBytes(&uniforms, sizeof(uniforms), GpuDriven::StreamingUpdateBindings::kUniforms);
+                const uint32_t copyDispatchX = (copyClusterCount + kThreadCount - 1u) / kThreadCount;
+                encoder.dispatchThreadgroups({copyDispatchX, 1, 1}, {kThreadCount, 1, 1});
+            }
         }
         if (activeResidentPatchCount != 0u) {
             if (patchCount != 0u) {
@@ -242,6 +275,7 @@ private:
     int m_height = 0;
     std::string m_name = "Cluster Streaming Update";
     FGResource m_streamingSync;
+    uint64_t m_updateTransferWaitValue = 0u;
 
     static ClusterStreamingGpuStats makeInitialStreamingGpuStats(uint32_t frameIndex,
                                                                  uint64_t copiedBytes) {
@@ -470,6 +504,32 @@ private:
                                             uint32_t patchCount) {
         return uploadStructuredPatches(encoder, patchBuffer, patchData, patchCount);
     }
+#else
+    static uint64_t submitStreamingDataCopiesAsync(
+        const RhiBuffer* stagingBuffer,
+        const RhiBuffer* residentBuffer,
+        const std::vector<StreamingStorage::CopyRegion>& copyRegions) {
+        if (copyRegions.empty() || !stagingBuffer || !residentBuffer) {
+            return 0u;
+        }
+
+        std::vector<RhiBufferCopyRegion> bufferCopies;
+        bufferCopies.reserve(copyRegions.size());
+        for (const StreamingStorage::CopyRegion& copyRegion : copyRegions) {
+            if (copyRegion.sizeBytes != 0u) {
+                bufferCopies.push_back(
+                    {copyRegion.srcOffsetBytes, copyRegion.dstOffsetBytes, copyRegion.sizeBytes});
+            }
+        }
+        if (bufferCopies.empty()) {
+            return 0u;
+        }
+
+        return rhiSubmitAsyncBufferCopies(*stagingBuffer,
+                                          *residentBuffer,
+                                          bufferCopies.data(),
+                                          bufferCopies.size());
+    }
 #endif
 };
 
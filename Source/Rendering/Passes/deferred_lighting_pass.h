@@ -4,9 +4,14 @@
 #include "render_uniforms.h"
 #include "frame_context.h"
 #include "gpu_driven_constants.h"
+#include "gpu_driven_helpers.h"
+#include "light_cluster_constants.h"
 #include "cluster_lod_builder.h"
 #include "pass_registry.h"
+#include "texture_streaming_pool.h"
 #include "imgui.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 class DeferredLightingPass : public RenderPass {
@@ -23,7 +28,11 @@ public:
             makeInputSlot("visibilityWorklist", "Visibility Worklist", true),
             makeInputSlot("visibilityWorklistState", "Visibility Worklist State", true),
             makeInputSlot("shadowMap", "Shadow Map", true),
-            makeInputSlot("skyOutput", "Sky", true)
+            makeInputSlot("skyOutput", "Sky", true),
+            makeInputSlot("indirectDiffuse", "Indirect Diffuse", true),
+            makeInputSlot("reflections", "Reflections", true),
+            makeInputSlot("skyIrradiance", "Sky Irradiance", true),
+            makeInputSlot("ambientOcclusion", "Ambient Occlusion", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("lightingOutput", "Lighting"),
@@ -40,7 +49,11 @@ public:
             makeHiddenInputSlot("visibilityWorklist", "Visibility Worklist", true),
             makeHiddenInputSlot("visibilityWorklistState", "Visibility Worklist State", true),
             makeInputSlot("shadowMap", "Shadow Map", true),
-            makeInputSlot("skyOutput", "Sky", true)
+            makeInputSlot("skyOutput", "Sky", true),
+            makeInputSlot("indirectDiffuse", "Indirect Diffuse", true),
+            makeInputSlot("reflections", "Reflections", true),
+            makeInputSlot("skyIrradiance", "Sky Irradiance", true),
+            makeInputSlot("ambientOcclusion", "Ambient Occlusion", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("lightingOutput", "Lighting"),
@@ -56,6 +69,33 @@ public:
         if (config.config.contains("motionVectorIntensity")) {
             m_motionVectorIntensity = config.config["motionVectorIntensity"].get<float>();
         }
+        if (config.config.contains("tileClassification")) {
+            m_tileClassification = config.config["tileClassification"].get<bool>();
+        }
+        if (config.config.contains("lightClustering")) {
+            m_lightClustering = config.config["lightClustering"].get<bool>();
+        }
+        if (config.config.contains("coarseShading")) {
+            m_coarseShading = config.config["coarseShading"].get<bool>();
+        }
+        if (config.config.contains("coarseLumaThreshold")) {
+            m_coarseLumaThreshold = config.config["coarseLumaThreshold"].get<float>();
+        }
+        if (config.config.contains("coarseMotionThreshold")) {
+            m_coarseMotionThreshold = config.config["coarseMotionThreshold"].get<float>();
+        }
+        if (config.config.contains("inlineShadowRays")) {
+            m_inlineShadowRays = config.config["inlineShadowRays"].get<bool>();
+        }
+        if (config.config.contains("shadowNormalBias")) {
+            m_shadowNormalBias = config.config["shadowNormalBias"].get<float>();
+        }
+        if (config.config.contains("shadowMaxRayDistance")) {
+            m_shadowMaxRayDistance = config.config["shadowMaxRayDistance"].get<float>();
+        }
+        if (config.config.contains("skyAmbientIntensity")) {
+            m_skyAmbientIntensity = config.config["skyAmbientIntensity"].get<float>();
+        }
     }
 
     FGResource output;
@@ -73,6 +113,10 @@ public:
         FGResource depthInput = getInput("depth");
         FGResource shadowInput = getInput("shadowMap");
         FGResource skyInput = getInput("skyOutput");
+        FGResource indirectDiffuseInput = getInput("indirectDiffuse");
+        FGResource reflectionsInput = getInput("reflections");
+        FGResource skyIrradianceInput = getInput("skyIrradiance");
+        FGResource ambientOcclusionInput = getInput("ambientOcclusion");
         FGResource visibleMeshletsInput = getInput("visibleMeshlets");
         if (!visibleMeshletsInput.isValid()) {
             visibleMeshletsInput = getInput("visibilityWorklist");
@@ -86,6 +130,10 @@ public:
         if (depthInput.isValid()) m_depthRead = builder.read(depthInput);
         if (shadowInput.isValid()) m_shadowRead = builder.read(shadowInput);
         if (skyInput.isValid()) m_skyRead = builder.read(skyInput);
+        if (indirectDiffuseInput.isValid()) m_indirectDiffuseRead = builder.read(indirectDiffuseInput);
+        if (reflectionsInput.isValid()) m_reflectionsRead = builder.read(reflectionsInput);
+        if (skyIrradianceInput.isValid()) m_skyIrradianceRead = builder.read(skyIrradianceInput);
+        if (ambientOcclusionInput.isValid()) m_ambientOcclusionRead = builder.read(ambientOcclusionInput);
         if (visibleMeshletsInput.isValid()) {
             m_visibleMeshletsRead = builder.read(visibleMeshletsInput, FGResourceUsage::StorageRead);
         }
@@ -97,6 +145,56 @@ public:
             FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA16Float));
         motionVectorsOutput = builder.create("motionVectors",
             FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RG16Float));
+
+        // One bin per tile kind; each can hold every tile on screen.
+        const uint32_t tileCapacity = std::max(1u, tileCountX() * tileCountY());
+        const char* const kBinNames[kTileBinCount][4] = {
+            {"skyTiles", "DeferredLightingSkyTiles", "skyTileState", "DeferredLightingSkyTileState"},
+            {"untexturedTiles", "DeferredLightingUntexturedTiles", "untexturedTileState",
+             "DeferredLightingUntexturedTileState"},
+            {"texturedTiles", "DeferredLightingTexturedTiles", "texturedTileState",
+             "DeferredLightingTexturedTileState"},
+            {"coarseTiles", "DeferredLightingCoarseTiles", "coarseTileState", "DeferredLightingCoarseTileState"},
+        };
+        for (uint32_t bin = 0; bin < kTileBinCount; ++bin) {
+            m_tileBins[bin] = {};
+            if (!m_tileClassification) {
+                continue;
+            }
+            m_tileBins[bin] =
+                GpuDriven::createTypedIndirectWorklist<uint32_t, GpuDriven::ComputeDispatchCommandLayout>(
+                    builder,
+                    kBinNames[bin][0],
+                    kBinNames[bin][1],
+                    tileCapacity,
+                    kBinNames[bin][2],
+                    kBinNames[bin][3],
+                    false);
+        }
+
+        // Rates are built from this frame's output and classify next frame's tiles.
+        m_prevShadingRate = m_shadingRate = FGResource{};
+        if (m_tileClassification && m_coarseShading) {
+            const FGBufferDesc rateDesc =
+                GpuDriven::makeStructuredBufferDesc<uint32_t>(tileCapacity, "DeferredLightingShadingRate");
+            m_prevShadingRate = builder.readHistory(kShadingRateHistoryName, rateDesc);
+            m_shadingRate = builder.writeHistory(kShadingRateHistoryName, rateDesc);
+        }
+
+        // Froxel light lists; every cluster draws its indices from one shared pool.
+        m_lightClusterGrid = m_lightClusterIndices = m_lightClusterIndexState = FGResource{};
+        if (m_lightClustering) {
+            const size_t clusterCount = static_cast<size_t>(lightClusterCountX()) * lightClusterCountY() *
+                                        kLightClusterSliceCount;
+            m_lightClusterGrid = builder.create("lightClusterGrid",
+                GpuDriven::makeStructuredBufferDesc<uint32_t>(clusterCount * 2, "DeferredLightingClusterGrid"));
+            m_lightClusterIndices = builder.create("lightClusterIndices",
+                GpuDriven::makeStructuredBufferDesc<uint32_t>(clusterCount * kLightClusterAverageLights,
+                                                              "DeferredLightingClusterLightIndices"));
+            m_lightClusterIndexState = builder.create("lightClusterIndexState",
+                GpuDriven::makeWorklistStateBufferDesc<GpuDriven::ComputeDispatchCommandLayout>(
+                    "DeferredLightingClusterIndexState", false));
+        }
     }
 
     void executeCompute(RhiComputeCommandEncoder& encoder) override {
@@ -126,15 +224,65 @@ public:
         lightUniforms.materialCount = m_frameContext->materialCount;
         lightUniforms.textureCount = m_frameContext->textureCount;
         lightUniforms.instanceCount = m_ctx.gpuScene.instanceCount;
-        lightUniforms.shadowEnabled = m_frameContext->enableRTShadows ? 1 : 0;
+        lightUniforms.shadowEnabled =
+            (m_frameContext->enableRTShadows || m_frameContext->shadowCascades.count > 0) ? 1 : 0;
+        // The 64-bit visibility layout stores meshlet IDs directly.
         lightUniforms.visibilityUsesWorklistIds =
-            (m_frameContext->gpuDrivenCulling &&
+            (!m_runtimeContext->visibility64 &&
+             m_frameContext->gpuDrivenCulling &&
              m_visibleMeshletsRead.isValid() &&
              m_visibleMeshletStateRead.isValid())
                 ? 1u
                 : 0u;
         lightUniforms.motionVectorIntensity = m_motionVectorIntensity;
-        lightUniforms.pad2 = 0;
+        const RhiBuffer* textureFeedbackBuffer =
+            m_runtimeContext->textureStreamingPool
+                ? m_runtimeContext->textureStreamingPool->feedbackBuffer()
+                : nullptr;
+        lightUniforms.textureFeedbackEnabled = textureFeedbackBuffer ? 1u : 0u;
+
+        // Slices split [near, far] view depth logarithmically.
+        const float clusterNear = std::max(m_frameContext->cameraNearZ, 1e-4f);
+        const float clusterFar = std::max(m_frameContext->cameraFarZ, clusterNear * 2.0f);
+        lightUniforms.lightClusterCountX = lightClusterCountX();
+        lightUniforms.lightClusterCountY = lightClusterCountY();
+        lightUniforms.lightClusterSliceScale =
+            static_cast<float>(kLightClusterSliceCount) / std::log2(clusterFar / clusterNear);
+        lightUniforms.lightClusterSliceBias = -std::log2(clusterNear) * lightUniforms.lightClusterSliceScale;
+        lightUniforms.shadingRateMode = 0;
+        lightUniforms.coarseLumaThreshold = m_coarseLumaThreshold;
+        lightUniforms.coarseMotionThreshold = m_coarseMotionThreshold;
+        // Inline sun rays need kernels built with METALLIC_INLINE_RAY_QUERY and a TLAS.
+        const bool tlasBindable =
+            m_runtimeContext->inlineRayQuery && m_ctx.shadowResources.tlas.nativeHandle();
+        m_inlineShadowRaysActive = m_inlineShadowRays && tlasBindable && m_frameContext->enableRTShadows;
+        lightUniforms.inlineShadowRays = m_inlineShadowRaysActive ? 1u : 0u;
+        lightUniforms.shadowNormalBias = m_shadowNormalBias;
+        lightUniforms.worldLightDirMaxDistance = m_frameContext->worldLightDir;
+        lightUniforms.worldLightDirMaxDistance.w =
+            m_shadowMaxRayDistance > 0.0f ? m_shadowMaxRayDistance : m_frameContext->cameraFarZ;
+        // RaytracedGiPass leaves its outputs unwritten when it has no pipeline.
+        const bool indirectLightingActive = m_indirectDiffuseRead.isValid() &&
+                                            m_reflectionsRead.isValid() &&
+                                            m_ctx.shadowResources.giPipeline.nativeHandle() &&
+                                            m_ctx.shadowResources.tlas.nativeHandle();
+        lightUniforms.indirectLightingEnabled = indirectLightingActive ? 1u : 0u;
+        // AtmospherePass leaves the probe unwritten while the atmosphere is off.
+        const bool skyAmbientActive = !indirectLightingActive && m_skyIrradianceRead.isValid() &&
+                                      m_frameContext->enableAtmosphereSky && m_skyAmbientIntensity > 0.0f;
+        lightUniforms.skyAmbientEnabled = skyAmbientActive ? 1u : 0u;
+        lightUniforms.skyAmbientIntensity = m_skyAmbientIntensity;
+        // AmbientOcclusionPass records nothing without inline ray queries, a TLAS and its pipeline.
+        m_ambientOcclusionActive = skyAmbientActive && m_ambientOcclusionRead.isValid() && tlasBindable &&
+                                   m_runtimeContext->computePipelinesRhi.count("AmbientOcclusionPass") != 0;
+        lightUniforms.ambientOcclusionEnabled = m_ambientOcclusionActive ? 1u : 0u;
+        m_lightClusteringActive = m_lightClustering && m_ctx.gpuScene.lightCount > 0 &&
+                                  dispatchLightCull(encoder, invProj, lightUniforms);
+        lightUniforms.punctualLightCount = m_lightClusteringActive ? m_ctx.gpuScene.lightCount : 0u;
+        const RhiBuffer* lightClusterGridBuffer =
+            m_lightClusteringActive ? m_frameGraph->getBuffer(m_lightClusterGrid) : nullptr;
+        const RhiBuffer* lightClusterIndicesBuffer =
+            m_lightClusteringActive ? m_frameGraph->getBuffer(m_lightClusterIndices) : nullptr;
 
         const RhiBuffer* visibleMeshletsBuffer =
             (m_frameGraph && m_visibleMeshletsRead.isValid())
@@ -161,49 +309,109 @@ public:
                 ? &m_ctx.clusterLodData.materialIDsBuffer
                 : &m_ctx.meshletData.materialIDs;
 
-        encoder.setComputePipeline(pipeIt->second);
-        encoder.setBytes(&lightUniforms, sizeof(lightUniforms), 0);
-        encoder.setBuffer(&m_ctx.sceneMesh.positionBuffer, 0, GpuDriven::DeferredLightingBindings::kPositions);
-        encoder.setBuffer(&m_ctx.sceneMesh.normalBuffer, 0, GpuDriven::DeferredLightingBindings::kNormals);
-        encoder.setBuffer(&m_ctx.meshletData.meshletBuffer, 0, GpuDriven::DeferredLightingBindings::kMeshlets);
-        encoder.setBuffer(&m_ctx.meshletData.meshletVertices, 0, GpuDriven::DeferredLightingBindings::kMeshletVertices);
-        encoder.setBuffer(&m_ctx.meshletData.meshletTriangles, 0, GpuDriven::DeferredLightingBindings::kMeshletTriangles);
-        encoder.setBuffer(&m_ctx.sceneMesh.uvBuffer, 0, GpuDriven::DeferredLightingBindings::kUvs);
-        encoder.setBuffer(&m_ctx.meshletData.materialIDs, 0, GpuDriven::DeferredLightingBindings::kMaterialIds);
-        encoder.setBuffer(&m_ctx.materials.materialBuffer, 0, GpuDriven::DeferredLightingBindings::kMaterials);
-        if (visibleMeshletsBuffer) {
-            encoder.setBuffer(visibleMeshletsBuffer, 0, GpuDriven::DeferredLightingBindings::kVisibleMeshlets);
-        }
-        if (visibleMeshletStateBuffer) {
-            encoder.setBuffer(visibleMeshletStateBuffer, 0, GpuDriven::DeferredLightingBindings::kVisibleMeshletState);
-        }
-        encoder.setBuffer(lodMeshletBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshlets);
-        encoder.setBuffer(lodMeshletVerticesBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshletVertices);
-        encoder.setBuffer(lodMeshletTrianglesBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshletTriangles);
-        encoder.setBuffer(lodMaterialIdsBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMaterialIds);
-        if (m_ctx.gpuScene.instanceBuffer.nativeHandle()) {
-            encoder.setBuffer(&m_ctx.gpuScene.instanceBuffer,
+        const auto bindLightingResources = [&]() {
+            encoder.setBytes(&lightUniforms, sizeof(lightUniforms), 0);
+            encoder.setBuffer(&m_ctx.sceneMesh.positionBuffer, 0, GpuDriven::DeferredLightingBindings::kPositions);
+            encoder.setBuffer(&m_ctx.sceneMesh.normalBuffer, 0, GpuDriven::DeferredLightingBindings::kNormals);
+            encoder.setBuffer(&m_ctx.meshletData.meshletBuffer, 0, GpuDriven::DeferredLightingBindings::kMeshlets);
+            encoder.setBuffer(&m_ctx.meshletData.meshletVertices, 0, GpuDriven::DeferredLightingBindings::kMeshletVertices);
+            encoder.setBuffer(&m_ctx.meshletData.meshletTriangles, 0, GpuDriven::DeferredLightingBindings::kMeshletTriangles);
+            encoder.setBuffer(&m_ctx.sceneMesh.uvBuffer, 0, GpuDriven::DeferredLightingBindings::kUvs);
+            encoder.setBuffer(&m_ctx.meshletData.materialIDs, 0, GpuDriven::DeferredLightingBindings::kMaterialIds);
+            encoder.setBuffer(&m_ctx.materials.materialBuffer, 0, GpuDriven::DeferredLightingBindings::kMaterials);
+            if (visibleMeshletsBuffer) {
+                encoder.setBuffer(visibleMeshletsBuffer, 0, GpuDriven::DeferredLightingBindings::kVisibleMeshlets);
+            }
+            if (visibleMeshletStateBuffer) {
+                encoder.setBuffer(visibleMeshletStateBuffer, 0, GpuDriven::DeferredLightingBindings::kVisibleMeshletState);
+            }
+            encoder.setBuffer(lodMeshletBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshlets);
+            encoder.setBuffer(lodMeshletVerticesBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshletVertices);
+            encoder.setBuffer(lodMeshletTrianglesBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMeshletTriangles);
+            encoder.setBuffer(lodMaterialIdsBuffer, 0, GpuDriven::DeferredLightingBindings::kLodMaterialIds);
+            if (m_ctx.gpuScene.instanceBuffer.nativeHandle()) {
+                encoder.setBuffer(&m_ctx.gpuScene.instanceBuffer,
+                                  0,
+                                  GpuDriven::DeferredLightingBindings::kInstanceData);
+            }
+            if (m_ctx.gpuScene.instancePrevTransformBuffer.nativeHandle()) {
+                encoder.setBuffer(&m_ctx.gpuScene.instancePrevTransformBuffer,
+                                  0,
+                                  GpuDriven::DeferredLightingBindings::kPrevTransforms);
+            }
+            // The material buffer stands in when streaming is off; the shader skips
+            // feedback writes while textureFeedbackEnabled is zero.
+            encoder.setBuffer(textureFeedbackBuffer ? textureFeedbackBuffer : &m_ctx.materials.materialBuffer,
+                              0,
+                              GpuDriven::DeferredLightingBindings::kTextureFeedback);
+            // Same stand-in while punctualLightCount is zero.
+            encoder.setBuffer(m_lightClusteringActive ? &m_ctx.gpuScene.lightBuffer : &m_ctx.materials.materialBuffer,
+                              0,
+                              GpuDriven::DeferredLightingBindings::kPunctualLights);
+            encoder.setBuffer(lightClusterGridBuffer ? lightClusterGridBuffer : &m_ctx.materials.materialBuffer,
+                              0,
+                              GpuDriven::DeferredLightingBindings::kLightClusterGrid);
+            encoder.setBuffer(lightClusterIndicesBuffer ? lightClusterIndicesBuffer : &m_ctx.materials.materialBuffer,
                               0,
-                              GpuDriven::DeferredLightingBindings::kInstanceData);
-        }
-        encoder.setTexture(m_frameGraph->getTexture(m_visRead), 0);
-        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 1);
-        encoder.setStorageTexture(m_frameGraph->getTexture(output), 2);
-        // Vulkan reflection compacts resource bindings into dense logical slots.
-        // Keep CPU-side binding indices aligned with shader declaration order.
-        constexpr uint32_t kShadowTextureBinding = 3;
-        constexpr uint32_t kSkyTextureBinding = 4;
-        constexpr uint32_t kMotionVectorsBinding = 5;
-        const RhiTexture* shadowTex = m_shadowRead.isValid()
-            ? m_frameGraph->getTexture(m_shadowRead)
-            : &m_ctx.shadowDummyTex;
-        encoder.setTexture(shadowTex, kShadowTextureBinding);
-        const RhiTexture* skyTex = m_skyRead.isValid()
-            ? m_frameGraph->getTexture(m_skyRead)
-            : &m_ctx.skyFallbackTex;
-        encoder.setTexture(skyTex, kSkyTextureBinding);
-        encoder.setStorageTexture(m_frameGraph->getTexture(motionVectorsOutput),
-                                  kMotionVectorsBinding);
+                              GpuDriven::DeferredLightingBindings::kLightClusterIndices);
+            encoder.setTexture(m_frameGraph->getTexture(m_visRead), 0);
+            encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 1);
+            encoder.setStorageTexture(m_frameGraph->getTexture(output), 2);
+            // Vulkan reflection compacts resource bindings into dense logical slots.
+            // Keep CPU-side binding indices aligned with shader declaration order.
+            constexpr uint32_t kShadowTextureBinding = 3;
+            constexpr uint32_t kSkyTextureBinding = 4;
+            constexpr uint32_t kMotionVectorsBinding = 5;
+            const RhiTexture* shadowTex = m_shadowRead.isValid()
+                ? m_frameGraph->getTexture(m_shadowRead)
+                : &m_ctx.shadowDummyTex;
+            encoder.setTexture(shadowTex, kShadowTextureBinding);
+            const RhiTexture* skyTex = m_skyRead.isValid()
+                ? m_frameGraph->getTexture(m_skyRead)
+                : &m_ctx.skyFallbackTex;
+            encoder.setTexture(skyTex, kSkyTextureBinding);
+            encoder.setStorageTexture(m_frameGraph->getTexture(motionVectorsOutput),
+                                      kMotionVectorsBinding);
+            constexpr uint32_t kIndirectDiffuseBinding = 6;
+            constexpr uint32_t kReflectionsBinding = 7;
+            encoder.setTexture(indirectLightingActive ? m_frameGraph->getTexture(m_indirectDiffuseRead)
+                                                      : &m_ctx.skyFallbackTex,
+                               kIndirectDiffuseBinding);
+            encoder.setTexture(indirectLightingActive ? m_frameGraph->getTexture(m_reflectionsRead)
+                                                      : &m_ctx.skyFallbackTex,
+                               kReflectionsBinding);
+            constexpr uint32_t kSkyIrradianceBinding = 8;
+            encoder.setTexture(skyAmbientActive ? m_frameGraph->getTexture(m_skyIrradianceRead)
+                                                : &m_ctx.skyFallbackTex,
+                               kSkyIrradianceBinding);
+            constexpr uint32_t kAmbientOcclusionBinding = 9;
+            encoder.setTexture(m_ambientOcclusionActive ? m_frameGraph->getTexture(m_ambientOcclusionRead)
+                                                        : &m_ctx.skyFallbackTex,
+                               kAmbientOcclusionBinding);
+            // The kernels declare the TLAS whenever the define is set, so it stays
+            // bound while inline rays are switched off.
+            if (tlasBindable) {
+                encoder.setAccelerationStructure(&m_ctx.shadowResources.tlas, 0);
+            }
+            if (m_inlineShadowRaysActive && !m_ctx.shadowResources.residentOnQueue()) {
+                encoder.useResource(m_ctx.shadowResources.tlas, RhiResourceUsage::Read);
+                for (auto& blas : m_ctx.shadowResources.blasArray) {
+                    if (blas.nativeHandle()) {
+                        encoder.useResource(blas, RhiResourceUsage::Read);
+                    }
+                }
+            }
+        };
+
+        m_coarseShadingActive = false;
+        m_tileClassificationActive =
+            m_tileClassification && dispatchClassifiedTiles(encoder, lightUniforms, bindLightingResources);
+        if (m_tileClassificationActive) {
+            return;
+        }
+
+        encoder.setComputePipeline(pipeIt->second);
+        bindLightingResources();
         encoder.dispatchThreadgroups({static_cast<uint32_t>((m_width + 7) / 8), static_cast<uint32_t>((m_height + 7) / 8), 1},
                                      {8, 8, 1});
     }
@@ -211,22 +419,285 @@ public:
     void renderUI() override {
         ImGui::Text("Resolution: %d x %d", m_width, m_height);
         ImGui::SliderFloat("Motion Vector Intensity", &m_motionVectorIntensity, 0.0f, 2.0f, "%.2f");
+        ImGui::Text("Tile Classification: %s",
+                    m_tileClassificationActive ? "Active"
+                    : m_tileClassification     ? "Unavailable"
+                                               : "Off");
+        ImGui::Text("Coarse Shading: %s",
+                    m_coarseShadingActive ? "Active"
+                    : m_coarseShading     ? "Unavailable"
+                                          : "Off");
+        if (m_coarseShading) {
+            ImGui::SliderFloat("Coarse Luma Threshold", &m_coarseLumaThreshold, 0.0f, 0.2f, "%.3f");
+            ImGui::SliderFloat("Coarse Motion Threshold (px)", &m_coarseMotionThreshold, 0.0f, 64.0f, "%.1f");
+        }
+        ImGui::Text("Punctual Lights: %u (%s)",
+                    m_ctx.gpuScene.lightCount,
+                    m_lightClusteringActive ? "Clustered"
+                    : m_lightClustering     ? "Unavailable"
+                                            : "Off");
         if (m_frameContext) {
             ImGui::Text("Scene Instances: %u", m_ctx.gpuScene.instanceCount);
             ImGui::Text("Meshlets: %u", m_frameContext->meshletCount);
             ImGui::Text("Materials: %u", m_frameContext->materialCount);
-            ImGui::Text("Shadows: %s", m_frameContext->enableRTShadows ? "Enabled" : "Disabled");
+            ImGui::Text("Shadows: %s",
+                        m_inlineShadowRaysActive                  ? "Ray Traced (Inline)"
+                        : m_frameContext->enableRTShadows         ? "Ray Traced"
+                        : m_frameContext->shadowCascades.count > 0 ? "Cascaded"
+                                                                   : "Disabled");
+        }
+        if (m_skyIrradianceRead.isValid()) {
+            ImGui::SliderFloat("Sky Ambient Intensity", &m_skyAmbientIntensity, 0.0f, 20.0f, "%.2f");
+        }
+        if (m_ambientOcclusionRead.isValid()) {
+            ImGui::Text("Ambient Occlusion: %s", m_ambientOcclusionActive ? "Active" : "Unavailable");
+        }
+        if (m_inlineShadowRays) {
+            ImGui::SliderFloat("Shadow Normal Bias", &m_shadowNormalBias, 0.0f, 0.5f, "%.3f");
+            ImGui::SliderFloat("Shadow Max Ray Distance", &m_shadowMaxRayDistance, 0.0f, 2000.0f, "%.1f");
+        }
+        if (m_runtimeContext && m_runtimeContext->textureStreamingPool) {
+            const TextureStreamingPool::Stats stats = m_runtimeContext->textureStreamingPool->stats();
+            if (stats.streamingEnabled) {
+                constexpr double kMiB = 1024.0 * 1024.0;
+                ImGui::Text("Texture Residency: %.1f / %.1f MB (target %.1f MB)",
+                            static_cast<double>(stats.residentBytes) / kMiB,
+                            static_cast<double>(stats.budgetBytes) / kMiB,
+                            static_cast<double>(stats.targetBytes) / kMiB);
+                ImGui::Text("Textures: %u (%u full, %u promoting, %u demoting)",
+                            stats.textureCount,
+                            stats.fullyResidentCount,
+                            stats.pendingPromotions,
+                            stats.pendingDemotions);
+            }
         }
     }
 
 private:
+    enum TileBin : uint32_t {
+        kSkyTileBin = 0,
+        kUntexturedTileBin,
+        kTexturedTileBin,
+        kCoarseTileBin,
+        kTileBinCount
+    };
+    static constexpr uint32_t kTileSize = 8;
+    static constexpr const char* kShadingRateHistoryName = "DeferredLightingShadingRate";
+
+    uint32_t tileCountX() const { return (static_cast<uint32_t>(m_width) + kTileSize - 1u) / kTileSize; }
+    uint32_t tileCountY() const { return (static_cast<uint32_t>(m_height) + kTileSize - 1u) / kTileSize; }
+    uint32_t lightClusterCountX() const {
+        return (static_cast<uint32_t>(m_width) + kLightClusterTileSize - 1u) / kLightClusterTileSize;
+    }
+    uint32_t lightClusterCountY() const {
+        return (static_cast<uint32_t>(m_height) + kLightClusterTileSize - 1u) / kLightClusterTileSize;
+    }
+
+    // Resets the index pool and builds the froxel light lists the shading kernels
+    // read. Returns false, having recorded nothing, when a pipeline or buffer is missing.
+    bool dispatchLightCull(RhiComputeCommandEncoder& encoder,
+                           const float4x4& invProj,
+                           const LightingUniforms& lightUniforms) {
+        const auto& pipelines = m_runtimeContext->computePipelinesRhi;
+        auto resetIt = pipelines.find("WorklistResetPass");
+        auto cullIt = pipelines.find("LightCullPass");
+        if (resetIt == pipelines.end() || !resetIt->second.nativeHandle() ||
+            cullIt == pipelines.end() || !cullIt->second.nativeHandle() ||
+            !m_ctx.gpuScene.lightBuffer.nativeHandle() || !m_lightClusterGrid.isValid() ||
+            !m_lightClusterIndices.isValid() || !m_lightClusterIndexState.isValid() || !m_depthRead.isValid()) {
+            return false;
+        }
+        RhiBuffer* gridBuffer = m_frameGraph->getBuffer(m_lightClusterGrid);
+        RhiBuffer* indicesBuffer = m_frameGraph->getBuffer(m_lightClusterIndices);
+        RhiBuffer* indexStateBuffer = m_frameGraph->getBuffer(m_lightClusterIndexState);
+        if (!gridBuffer || !indicesBuffer || !indexStateBuffer) {
+            return false;
+        }
+
+        struct {
+            float4x4 viewMatrix;
+            float4x4 invProj;
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t clusterCountX;
+            uint32_t clusterCountY;
+            uint32_t lightCount;
+            uint32_t indexCapacity;
+            float sliceScale;
+            float sliceBias;
+            uint32_t reversedZ;
+            uint32_t pad[3];
+        } uniforms{};
+        uniforms.viewMatrix = lightUniforms.viewMatrix;
+        uniforms.invProj = transpose(invProj);
+        uniforms.screenWidth = lightUniforms.screenWidth;
+        uniforms.screenHeight = lightUniforms.screenHeight;
+        uniforms.clusterCountX = lightClusterCountX();
+        uniforms.clusterCountY = lightClusterCountY();
+        uniforms.lightCount = m_ctx.gpuScene.lightCount;
+        uniforms.indexCapacity = lightClusterCountX() * lightClusterCountY() * kLightClusterSliceCount *
+                                 kLightClusterAverageLights;
+        uniforms.sliceScale = lightUniforms.lightClusterSliceScale;
+        uniforms.sliceBias = lightUniforms.lightClusterSliceBias;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+
+        encoder.setComputePipeline(resetIt->second);
+        encoder.setBuffer(indexStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+        encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        encoder.setComputePipeline(cullIt->second);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setBuffer(&m_ctx.gpuScene.lightBuffer, 0, GpuDriven::LightCullBindings::kLights);
+        encoder.setBuffer(gridBuffer, 0, GpuDriven::LightCullBindings::kClusterGrid);
+        encoder.setBuffer(indicesBuffer, 0, GpuDriven::LightCullBindings::kClusterIndices);
+        encoder.setBuffer(indexStateBuffer, 0, GpuDriven::LightCullBindings::kIndexState);
+        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
+        encoder.dispatchThreadgroups({lightClusterCountX(), lightClusterCountY(), 1},
+                                     {kLightClusterTileSize, kLightClusterTileSize, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        return true;
+    }
+
+    // Bins 8x8 tiles into sky, untextured, textured and coarse lists, then shades
+    // each list with its own kernel through indirect dispatch. With coarse shading
+    // on, rates every tile from the result for next frame. Returns false, having
+    // recorded nothing, when a pipeline or bin buffer is missing.
+    template <typename BindFn>
+    bool dispatchClassifiedTiles(RhiComputeCommandEncoder& encoder,
+                                 LightingUniforms& lightUniforms,
+                                 const BindFn& bindLightingResources) {
+        const auto& pipelines = m_runtimeContext->computePipelinesRhi;
+        const auto findPipeline = [&](const char* key) -> const RhiComputePipeline* {
+            auto it = pipelines.find(key);
+            return it != pipelines.end() && it->second.nativeHandle() ? &it->second : nullptr;
+        };
+        const RhiComputePipeline* resetPipeline = findPipeline("WorklistResetPass");
+        const RhiComputePipeline* buildPipeline = findPipeline("BuildIndirectPass");
+        const RhiComputePipeline* classifyPipeline = findPipeline("DeferredLightingClassifyPass");
+        const RhiComputePipeline* shadePipelines[kTileBinCount] = {
+            findPipeline("DeferredLightingSkyTilesPass"),
+            findPipeline("DeferredLightingUntexturedTilesPass"),
+            findPipeline("DeferredLightingTexturedTilesPass"),
+            findPipeline("DeferredLightingCoarseTilesPass"),
+        };
+        const RhiComputePipeline* ratePipeline = findPipeline("DeferredLightingShadingRatePass");
+        if (!resetPipeline || !buildPipeline || !classifyPipeline) {
+            return false;
+        }
+
+        RhiBuffer* tileBuffers[kTileBinCount] = {};
+        RhiBuffer* tileStateBuffers[kTileBinCount] = {};
+        for (uint32_t bin = 0; bin < kTileBinCount; ++bin) {
+            if (!shadePipelines[bin] || !m_tileBins[bin].payload.isValid() || !m_tileBins[bin].state.isValid()) {
+                return false;
+            }
+            tileBuffers[bin] = m_frameGraph->getBuffer(m_tileBins[bin].payload);
+            tileStateBuffers[bin] = m_frameGraph->getBuffer(m_tileBins[bin].state);
+            if (!tileBuffers[bin] || !tileStateBuffers[bin]) {
+                return false;
+            }
+        }
+        RhiBuffer* prevShadingRateBuffer =
+            m_prevShadingRate.isValid() ? m_frameGraph->getBuffer(m_prevShadingRate) : nullptr;
+        RhiBuffer* shadingRateBuffer = m_shadingRate.isValid() ? m_frameGraph->getBuffer(m_shadingRate) : nullptr;
+        m_coarseShadingActive = ratePipeline && prevShadingRateBuffer && shadingRateBuffer;
+        if (m_coarseShadingActive) {
+            lightUniforms.shadingRateMode = m_frameGraph->isHistoryValid(m_prevShadingRate) ? 2u : 1u;
+        }
+        const auto bindTileBins = [&]() {
+            encoder.setBuffer(tileBuffers[kSkyTileBin], 0, GpuDriven::DeferredLightingBindings::kSkyTiles);
+            encoder.setBuffer(tileBuffers[kUntexturedTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kUntexturedTiles);
+            encoder.setBuffer(tileBuffers[kTexturedTileBin], 0, GpuDriven::DeferredLightingBindings::kTexturedTiles);
+            encoder.setBuffer(tileStateBuffers[kSkyTileBin], 0, GpuDriven::DeferredLightingBindings::kSkyTileState);
+            encoder.setBuffer(tileStateBuffers[kUntexturedTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kUntexturedTileState);
+            encoder.setBuffer(tileStateBuffers[kTexturedTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kTexturedTileState);
+            encoder.setBuffer(tileBuffers[kCoarseTileBin], 0, GpuDriven::DeferredLightingBindings::kCoarseTiles);
+            encoder.setBuffer(tileStateBuffers[kCoarseTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kCoarseTileState);
+            // Without coarse shading the coarse bin stands in; shadingRateMode zero
+            // keeps the shaders from touching it.
+            encoder.setBuffer(m_coarseShadingActive ? prevShadingRateBuffer : tileBuffers[kCoarseTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kPrevShadingRate);
+            encoder.setBuffer(m_coarseShadingActive ? shadingRateBuffer : tileBuffers[kCoarseTileBin], 0,
+                              GpuDriven::DeferredLightingBindings::kShadingRate);
+        };
+
+        encoder.setComputePipeline(*resetPipeline);
+        for (RhiBuffer* stateBuffer : tileStateBuffers) {
+            encoder.setBuffer(stateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+        }
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        encoder.setComputePipeline(*classifyPipeline);
+        bindLightingResources();
+        bindTileBins();
+        encoder.dispatchThreadgroups({tileCountX(), tileCountY(), 1}, {kTileSize, kTileSize, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        // Publish each bin's tile count as its group count.
+        encoder.setComputePipeline(*buildPipeline);
+        for (RhiBuffer* stateBuffer : tileStateBuffers) {
+            encoder.setBuffer(stateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+        }
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        // Bins cover disjoint tiles, so the kernels need no barrier between them.
+        // Coarse kernels run one thread per 2x2 quad.
+        for (uint32_t bin = 0; bin < kTileBinCount; ++bin) {
+            const uint32_t groupSize = bin == kCoarseTileBin ? kTileSize / 2u : kTileSize;
+            encoder.setComputePipeline(*shadePipelines[bin]);
+            bindLightingResources();
+            bindTileBins();
+            encoder.dispatchThreadgroupsIndirect(*tileStateBuffers[bin],
+                                                 GpuDriven::ComputeDispatchCommandLayout::kIndirectArgsOffset,
+                                                 {groupSize, groupSize, 1});
+        }
+
+        if (m_coarseShadingActive) {
+            encoder.memoryBarrier(RhiBarrierScope::Textures);
+            encoder.setComputePipeline(*ratePipeline);
+            bindLightingResources();
+            bindTileBins();
+            encoder.dispatchThreadgroups({tileCountX(), tileCountY(), 1}, {kTileSize, kTileSize, 1});
+            m_frameGraph->commitHistory(m_shadingRate);
+        }
+        return true;
+    }
+
     const RenderContext& m_ctx;
     FGResource m_visRead, m_depthRead, m_shadowRead, m_skyRead;
+    FGResource m_indirectDiffuseRead, m_reflectionsRead, m_skyIrradianceRead, m_ambientOcclusionRead;
     FGResource m_visibleMeshletsRead;
     FGResource m_visibleMeshletStateRead;
     int m_width, m_height;
     std::string m_name = "Deferred Lighting";
     float m_motionVectorIntensity = 1.0f;
+    bool m_tileClassification = true;
+    bool m_tileClassificationActive = false;
+    bool m_lightClustering = true;
+    bool m_lightClusteringActive = false;
+    bool m_coarseShading = false;
+    bool m_coarseShadingActive = false;
+    float m_coarseLumaThreshold = 0.02f;
+    float m_coarseMotionThreshold = 6.0f;
+    bool m_inlineShadowRays = false;
+    bool m_inlineShadowRaysActive = false;
+    float m_shadowNormalBias = 0.05f;
+    float m_shadowMaxRayDistance = 1000.0f;
+    // The probe is in the atmosphere's radiance units; SkyPass scales the sky by
+    // its exposure (10 by default) for display.
+    float m_skyAmbientIntensity = 1.0f;
+    bool m_ambientOcclusionActive = false;
+    FGResource m_prevShadingRate, m_shadingRate;
+    FGResource m_lightClusterGrid, m_lightClusterIndices, m_lightClusterIndexState;
+    GpuDriven::TypedIndirectWorklistResources<uint32_t, GpuDriven::ComputeDispatchCommandLayout>
+        m_tileBins[kTileBinCount];
 };
 
 METALLIC_REGISTER_PASS(DeferredLightingPass);
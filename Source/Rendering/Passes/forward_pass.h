@@ -3,6 +3,8 @@
 #include "render_pass.h"
 #include "render_uniforms.h"
 #include "frame_context.h"
+#include "gpu_cull_resources.h"
+#include "gpu_driven_constants.h"
 #include "pass_registry.h"
 #include "imgui.h"
 #include <vector>
@@ -13,7 +15,12 @@ public:
         : m_ctx(ctx), m_width(w), m_height(h) {}
 
     METALLIC_PASS_TYPE_INFO(ForwardPass, "Forward Pass", "Geometry",
-        (std::vector<PassSlotInfo>{makeInputSlot("skyOutput", "Sky", true)}),
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("skyOutput", "Sky", true),
+            makeInputSlot("indexedDraws", "Indexed Draws", true),
+            makeInputSlot("indexedDrawState", "Indexed Draw State", true),
+            makeInputSlot("visibleInstances", "Visible Instances", true)
+        }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("forwardColor", "Forward Color"),
             makeOutputSlot("depth", "Depth")
@@ -37,6 +44,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         FGResource skyInput = getInput("skyOutput");
         if (skyInput.isValid()) {
             output = builder.read(skyInput);
@@ -56,6 +64,19 @@ public:
                                            RhiLoadAction::Clear,
                                            RhiStoreAction::Store,
                                            m_ctx.depthClearValue);
+
+        // GPU-built draws from IndexedDrawCullPass replace the per-node vertex loop.
+        m_indexedDrawsRead = FGResource{};
+        m_indexedDrawStateRead = FGResource{};
+        m_visibleInstancesRead = FGResource{};
+        FGResource indexedDrawsInput = getInput("indexedDraws");
+        FGResource indexedDrawStateInput = getInput("indexedDrawState");
+        FGResource visibleInstancesInput = getInput("visibleInstances");
+        if (indexedDrawsInput.isValid() && indexedDrawStateInput.isValid() && visibleInstancesInput.isValid()) {
+            m_indexedDrawsRead = builder.read(indexedDrawsInput, FGResourceUsage::Indirect);
+            m_indexedDrawStateRead = builder.read(indexedDrawStateInput, FGResourceUsage::Indirect);
+            m_visibleInstancesRead = builder.read(visibleInstancesInput, FGResourceUsage::StorageRead);
+        }
     }
 
     void executeRender(RhiRenderCommandEncoder& encoder) override {
@@ -68,7 +89,7 @@ public:
         if (!m_frameContext || !m_runtimeContext) return;
 
         const bool useBindlessSceneTextures = m_runtimeContext->useBindlessSceneTextures;
-        std::vector<const RhiTexture*> materialTextures;
+        std::pmr::vector<const RhiTexture*> materialTextures(m_frameContext->frameMemory);
         if (!useBindlessSceneTextures) {
             materialTextures.reserve(m_ctx.materials.textureViews.size());
             for (auto* texture : m_ctx.materials.textureViews) {
@@ -91,24 +112,19 @@ public:
             if (pipeIt == m_runtimeContext->renderPipelinesRhi.end() || !pipeIt->second.nativeHandle()) return;
             encoder.setRenderPipeline(pipeIt->second);
 
-            encoder.setMeshBuffer(&m_ctx.sceneMesh.positionBuffer, 0, 1);
-            encoder.setMeshBuffer(&m_ctx.sceneMesh.normalBuffer, 0, 2);
-            encoder.setMeshBuffer(&m_ctx.meshletData.meshletBuffer, 0, 3);
-            encoder.setMeshBuffer(&m_ctx.meshletData.meshletVertices, 0, 4);
-            encoder.setMeshBuffer(&m_ctx.meshletData.meshletTriangles, 0, 5);
-            encoder.setMeshBuffer(&m_ctx.meshletData.boundsBuffer, 0, 6);
-            encoder.setMeshBuffer(&m_ctx.sceneMesh.uvBuffer, 0, 7);
-            encoder.setMeshBuffer(&m_ctx.meshletData.materialIDs, 0, 8);
-            encoder.setMeshBuffer(&m_ctx.materials.materialBuffer, 0, 9);
-            encoder.setFragmentBuffer(&m_ctx.sceneMesh.positionBuffer, 0, 1);
-            encoder.setFragmentBuffer(&m_ctx.sceneMesh.normalBuffer, 0, 2);
-            encoder.setFragmentBuffer(&m_ctx.meshletData.meshletBuffer, 0, 3);
-            encoder.setFragmentBuffer(&m_ctx.meshletData.meshletVertices, 0, 4);
-            encoder.setFragmentBuffer(&m_ctx.meshletData.meshletTriangles, 0, 5);
-            encoder.setFragmentBuffer(&m_ctx.meshletData.boundsBuffer, 0, 6);
-            encoder.setFragmentBuffer(&m_ctx.sceneMesh.uvBuffer, 0, 7);
-            encoder.setFragmentBuffer(&m_ctx.meshletData.materialIDs, 0, 8);
-            encoder.setFragmentBuffer(&m_ctx.materials.materialBuffer, 0, 9);
+            const RhiBufferBinding meshletBindings[] = {
+                {&m_ctx.sceneMesh.positionBuffer, 0, 1},
+                {&m_ctx.sceneMesh.normalBuffer, 0, 2},
+                {&m_ctx.meshletData.meshletBuffer, 0, 3},
+                {&m_ctx.meshletData.meshletVertices, 0, 4},
+                {&m_ctx.meshletData.meshletTriangles, 0, 5},
+                {&m_ctx.meshletData.boundsBuffer, 0, 6},
+                {&m_ctx.sceneMesh.uvBuffer, 0, 7},
+                {&m_ctx.meshletData.materialIDs, 0, 8},
+                {&m_ctx.materials.materialBuffer, 0, 9},
+            };
+            encoder.setMeshBuffers(meshletBindings, static_cast<uint32_t>(std::size(meshletBindings)));
+            encoder.setFragmentBuffers(meshletBindings, static_cast<uint32_t>(std::size(meshletBindings)));
             // PLACEHOLDER_FORWARD_PASS_REST
             if (!useBindlessSceneTextures && !materialTextures.empty()) {
                 encoder.setFragmentTextures(materialTextures.data(), 0, static_cast<uint32_t>(materialTextures.size()));
@@ -136,8 +152,11 @@ public:
                                              {1, 1, 1},
                                              {128, 1, 1});
             }
+        } else if (drawIndirect(encoder)) {
+            m_lastDrawIndirect = true;
         } else {
             // Vertex shader path
+            m_lastDrawIndirect = false;
             auto pipeIt = m_runtimeContext->renderPipelinesRhi.find("ForwardPass");
             if (pipeIt == m_runtimeContext->renderPipelinesRhi.end() || !pipeIt->second.nativeHandle()) return;
             encoder.setRenderPipeline(pipeIt->second);
@@ -175,15 +194,78 @@ public:
                 ImGui::Text("Frustum Cull: %s", m_frameContext->enableFrustumCull ? "On" : "Off");
                 ImGui::Text("Cone Cull: %s", m_frameContext->enableConeCull ? "On" : "Off");
             } else {
-                ImGui::Text("Visible Index Nodes: %zu", m_frameContext->visibleIndexNodes.size());
+                if (m_lastDrawIndirect) {
+                    ImGui::Text("Draws: GPU indirect (%u max)", m_ctx.gpuScene.instanceCount);
+                } else {
+                    ImGui::Text("Visible Index Nodes: %zu", m_frameContext->visibleIndexNodes.size());
+                }
             }
         }
     }
 
 private:
+    // One indirect-count draw over the commands IndexedDrawCullPass built; false
+    // when that pass or the pulling pipeline is missing.
+    bool drawIndirect(RhiRenderCommandEncoder& encoder) {
+        if (!m_indexedDrawsRead.isValid() || !m_frameGraph || m_ctx.gpuScene.instanceCount == 0 ||
+            !m_ctx.gpuScene.instanceBuffer.nativeHandle()) {
+            return false;
+        }
+        auto pipeIt = m_runtimeContext->renderPipelinesRhi.find("ForwardIndirectPass");
+        const RhiBuffer* drawBuffer = m_frameGraph->getBuffer(m_indexedDrawsRead);
+        const RhiBuffer* drawStateBuffer = m_frameGraph->getBuffer(m_indexedDrawStateRead);
+        const RhiBuffer* visibleInstanceBuffer = m_frameGraph->getBuffer(m_visibleInstancesRead);
+        if (pipeIt == m_runtimeContext->renderPipelinesRhi.end() || !pipeIt->second.nativeHandle() ||
+            !drawBuffer || !drawStateBuffer || !visibleInstanceBuffer) {
+            return false;
+        }
+
+        struct {
+            float4x4 viewProj;
+            float4x4 view;
+            float4 lightDir;
+            float4 lightColorIntensity;
+        } uniforms{};
+        uniforms.viewProj = transpose(m_frameContext->proj * m_frameContext->view);
+        uniforms.view = transpose(m_frameContext->view);
+        uniforms.lightDir = m_frameContext->viewLightDir;
+        uniforms.lightColorIntensity = m_frameContext->lightColorIntensity;
+
+        // The vertex shader pulls these as storage buffers: Metal needs them on the
+        // vertex stage, Vulkan takes them through the shared descriptor set.
+        using Slot = GpuDriven::ForwardIndirectBindings;
+        const RhiBufferBinding bindings[] = {
+            {&m_ctx.sceneMesh.positionBuffer, 0, Slot::kPositions},
+            {&m_ctx.sceneMesh.normalBuffer, 0, Slot::kNormals},
+            {&m_ctx.gpuScene.instanceBuffer, 0, Slot::kSceneInstances},
+            {visibleInstanceBuffer, 0, Slot::kVisibleInstances},
+        };
+        encoder.setRenderPipeline(pipeIt->second);
+        for (const RhiBufferBinding& binding : bindings) {
+            encoder.setVertexBuffer(binding.buffer, binding.offset, binding.index);
+        }
+        encoder.setFragmentBuffers(bindings, static_cast<uint32_t>(std::size(bindings)));
+        encoder.setVertexBytes(&uniforms, sizeof(uniforms), Slot::kUniforms);
+        encoder.setFragmentBytes(&uniforms, sizeof(uniforms), Slot::kUniforms);
+        encoder.drawIndexedPrimitivesIndirectCount(RhiPrimitiveType::Triangle,
+                                                   RhiIndexType::UInt32,
+                                                   m_ctx.sceneMesh.indexBuffer,
+                                                   0,
+                                                   *drawBuffer,
+                                                   0,
+                                                   *drawStateBuffer,
+                                                   GpuDriven::WorklistStateHeaderLayout::kWriteCursorOffset,
+                                                   m_ctx.gpuScene.instanceCount);
+        return true;
+    }
+
     const RenderContext& m_ctx;
     int m_width, m_height;
     std::string m_name = "Forward Pass";
+    FGResource m_indexedDrawsRead;
+    FGResource m_indexedDrawStateRead;
+    FGResource m_visibleInstancesRead;
+    bool m_lastDrawIndirect = false;
 };
 
 METALLIC_REGISTER_PASS(ForwardPass);
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "render_pass.h"
+#include "render_uniforms.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "post_lens.h"
+#include "imgui.h"
+
+// Stands in for the TAA -> Tonemap chain with one compute dispatch
+// (fused_post.slang): resolves TAA, adds bloom and depth of field from an optional
+// PostPyramidPass pyramid, applies the exposure from AutoExposurePass's LUT,
+// tonemaps and writes display-ready color. The resolved HDR color is never
+// stored except as the frame graph TAA history. Wire output into OutputPass;
+// the swapchain is not a storage image, so that final blit stays.
+class FusedPostPass : public RenderPass {
+public:
+    FusedPostPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(FusedPostPass, "Fused Post", "Post-Process",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("source", "Source"),
+            makeInputSlot("motionVectors", "Motion Vectors", true),
+            makeInputSlot("exposureLut", "Exposure LUT", true),
+            makeInputSlot("postPyramid", "Post Pyramid", true),
+            makeInputSlot("depth", "Depth", true)
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("output", "Output")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        m_hasExposureLutInput = config.findInputBinding("exposureLut") != nullptr;
+        m_hasPyramidInput = config.findInputBinding("postPyramid") != nullptr;
+        m_hasDepthInput = config.findInputBinding("depth") != nullptr;
+        m_lens.configure(config.config);
+        if (config.config.contains("method")) {
+            std::string method = config.config["method"].get<std::string>();
+            if (method == "Filmic") m_method = 0;
+            else if (method == "Uncharted2") m_method = 1;
+            else if (method == "Clip") m_method = 2;
+            else if (method == "ACES") m_method = 3;
+            else if (method == "AgX") m_method = 4;
+            else if (method == "KhronosPBR") m_method = 5;
+        }
+        if (config.config.contains("exposure")) m_exposure = config.config["exposure"].get<float>();
+        if (config.config.contains("contrast")) m_contrast = config.config["contrast"].get<float>();
+        if (config.config.contains("brightness")) m_brightness = config.config["brightness"].get<float>();
+        if (config.config.contains("saturation")) m_saturation = config.config["saturation"].get<float>();
+        if (config.config.contains("vignette")) m_vignette = config.config["vignette"].get<float>();
+        if (config.config.contains("dither")) m_dither = config.config["dither"].get<bool>();
+        if (config.config.contains("autoExposure")) m_autoExposure = config.config["autoExposure"].get<bool>();
+        if (config.config.contains("blendMin")) m_blendMin = config.config["blendMin"].get<float>();
+        if (config.config.contains("blendMax")) m_blendMax = config.config["blendMax"].get<float>();
+        if (config.config.contains("varianceClipGamma"))
+            m_varianceClipGamma = config.config["varianceClipGamma"].get<float>();
+        if (config.config.contains("motionWeightScale"))
+            m_motionWeightScale = config.config["motionWeightScale"].get<float>();
+    }
+
+    FGResource getOutput(const std::string& outputName) const override {
+        if (outputName == "output") return m_output;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        m_sourceRead = FGResource{};
+        m_motionRead = FGResource{};
+        m_exposureLutRead = FGResource{};
+        m_pyramidRead = FGResource{};
+        m_depthRead = FGResource{};
+
+        FGResource sourceInput = getInput("source");
+        if (sourceInput.isValid())
+            m_sourceRead = builder.read(sourceInput);
+
+        FGResource motionInput = getInput("motionVectors");
+        if (motionInput.isValid())
+            m_motionRead = builder.read(motionInput);
+
+        if (m_hasExposureLutInput) {
+            FGResource lutInput = getInput("exposureLut");
+            if (lutInput.isValid())
+                m_exposureLutRead = builder.read(lutInput);
+        }
+
+        if (m_hasPyramidInput) {
+            FGResource pyramidInput = getInput("postPyramid");
+            if (pyramidInput.isValid())
+                m_pyramidRead = builder.read(pyramidInput);
+        }
+        if (m_hasDepthInput) {
+            FGResource depthInput = getInput("depth");
+            if (depthInput.isValid())
+                m_depthRead = builder.read(depthInput);
+        }
+
+        // Storage images cannot be sRGB; the shader already writes display-encoded
+        // values, which is what TonemapPass -> OutputPass ends up presenting.
+        m_output = builder.create("fusedPostOutput",
+            FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA8Unorm));
+        const FGTextureDesc historyDesc = FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA16Float);
+        m_prevHistory = builder.readHistory(kHistoryName, historyDesc);
+        m_history = builder.writeHistory(kHistoryName, historyDesc);
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("FusedPostPass");
+        MICROPROFILE_SCOPEI("RenderPass", "FusedPostPass", 0xffff8800);
+        if (!m_frameContext || !m_runtimeContext || !m_sourceRead.isValid()) return;
+
+        auto pipeIt = m_runtimeContext->computePipelinesRhi.find("FusedPostPass");
+        if (pipeIt == m_runtimeContext->computePipelinesRhi.end() || !pipeIt->second.nativeHandle()) return;
+
+        auto samplerIt = m_runtimeContext->samplersRhi.find("tonemap");
+        if (samplerIt == m_runtimeContext->samplersRhi.end() || !samplerIt->second.nativeHandle()) return;
+
+        RhiTexture* currentTex = m_frameGraph->getTexture(m_sourceRead);
+        RhiTexture* motionTex = m_motionRead.isValid() ? m_frameGraph->getTexture(m_motionRead) : nullptr;
+        RhiTexture* lutTex = m_exposureLutRead.isValid() ? m_frameGraph->getTexture(m_exposureLutRead) : nullptr;
+        RhiTexture* pyramidTex = m_pyramidRead.isValid() ? m_frameGraph->getTexture(m_pyramidRead) : nullptr;
+        RhiTexture* depthTex = m_depthRead.isValid() ? m_frameGraph->getTexture(m_depthRead) : nullptr;
+        RhiTexture* outputTex = m_frameGraph->getTexture(m_output);
+        RhiTexture* historyWriteTex = m_frameGraph->getTexture(m_history);
+        if (!currentTex || !outputTex || !historyWriteTex) return;
+
+        const bool historyValid = !m_frameContext->historyReset && m_frameGraph->isHistoryValid(m_prevHistory);
+
+        FusedPostUniforms uniforms{};
+        TAAUniforms& taa = uniforms.taa;
+        taa.jitterOffset = m_frameContext->jitterOffset;
+        taa.invResolution = float2(1.0f / m_width, 1.0f / m_height);
+        taa.screenWidth = static_cast<uint32_t>(m_width);
+        taa.screenHeight = static_cast<uint32_t>(m_height);
+        taa.blendMin = m_blendMin;
+        taa.blendMax = m_blendMax;
+        taa.varianceClipGamma = m_varianceClipGamma;
+        taa.frameIndex = historyValid ? m_frameContext->frameIndex : 0;
+        taa.motionWeightScale = m_motionWeightScale;
+        // Without motion vectors there is nothing to reproject with; resolve as a copy.
+        taa.copyOnly = (m_frameContext->enableTAA && motionTex) ? 0u : 1u;
+
+        TonemapUniforms& tonemap = uniforms.tonemap;
+        tonemap.isActive = m_enabled ? 1u : 0u;
+        tonemap.method = static_cast<uint32_t>(m_method);
+        tonemap.exposure = m_exposure;
+        tonemap.contrast = m_contrast;
+        tonemap.brightness = m_brightness;
+        tonemap.saturation = m_saturation;
+        tonemap.vignette = m_vignette;
+        tonemap.dither = m_dither ? 1u : 0u;
+        tonemap.invResolution = taa.invResolution;
+        tonemap.autoExposure = (m_autoExposure && lutTex) ? 1u : 0u;
+
+        auto pyramidSamplerIt = m_runtimeContext->samplersRhi.find("postPyramid");
+        const bool hasPyramidSampler = pyramidSamplerIt != m_runtimeContext->samplersRhi.end() &&
+                                       pyramidSamplerIt->second.nativeHandle();
+        if (hasPyramidSampler) {
+            uniforms.lens = m_lens.uniforms(*m_frameContext, pyramidTex,
+                                            currentTex->width(), currentTex->height(), depthTex != nullptr);
+        }
+
+        // Unused slots (copy-only history, missing LUT) still need a bound texture.
+        RhiTexture* historyReadTex = historyValid ? m_frameGraph->getTexture(m_prevHistory) : currentTex;
+        encoder.setComputePipeline(pipeIt->second);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(currentTex, 0);
+        encoder.setTexture(motionTex ? motionTex : currentTex, 1);
+        encoder.setTexture(historyReadTex ? historyReadTex : currentTex, 2);
+        encoder.setTexture(lutTex ? lutTex : currentTex, 3);
+        encoder.setStorageTexture(outputTex, 4);
+        encoder.setStorageTexture(historyWriteTex, 5);
+        encoder.setTexture(pyramidTex ? pyramidTex : currentTex, 6);
+        encoder.setTexture(depthTex ? depthTex : currentTex, 7);
+        encoder.setSampler(&samplerIt->second, 0);
+        encoder.setSampler(hasPyramidSampler ? &pyramidSamplerIt->second : &samplerIt->second, 1);
+
+        encoder.dispatchThreadgroups({static_cast<uint32_t>((m_width + 7) / 8), static_cast<uint32_t>((m_height + 7) / 8), 1},
+                                     {8, 8, 1});
+        m_frameGraph->commitHistory(m_history);
+    }
+
+    void renderUI() override {
+        ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        ImGui::SliderFloat("Blend Min", &m_blendMin, 0.01f, 0.5f, "%.3f");
+        ImGui::SliderFloat("Blend Max", &m_blendMax, 0.5f, 1.0f, "%.2f");
+        ImGui::SliderFloat("Variance Clip Gamma", &m_varianceClipGamma, 0.5f, 2.0f, "%.2f");
+        ImGui::SliderFloat("Motion Weight Scale", &m_motionWeightScale, 0.1f, 100.0f, "%.1f");
+        ImGui::Separator();
+        ImGui::Checkbox("Tonemap", &m_enabled);
+        const char* methods[] = {"Filmic", "Uncharted2", "Clip", "ACES", "AgX", "Khronos PBR"};
+        ImGui::Combo("Method", &m_method, methods, IM_ARRAYSIZE(methods));
+        if (m_hasExposureLutInput) {
+            ImGui::Checkbox("Auto Exposure", &m_autoExposure);
+        }
+        ImGui::BeginDisabled(m_autoExposure && m_hasExposureLutInput);
+        ImGui::SliderFloat("Exposure", &m_exposure, 0.1f, 4.0f, "%.2f");
+        ImGui::EndDisabled();
+        ImGui::SliderFloat("Contrast", &m_contrast, 0.5f, 2.0f, "%.2f");
+        ImGui::SliderFloat("Brightness", &m_brightness, 0.5f, 2.0f, "%.2f");
+        ImGui::SliderFloat("Saturation", &m_saturation, 0.0f, 2.0f, "%.2f");
+        ImGui::SliderFloat("Vignette", &m_vignette, 0.0f, 1.0f, "%.2f");
+        ImGui::Checkbox("Dither", &m_dither);
+        ImGui::Separator();
+        m_lens.renderUI(m_hasPyramidInput, m_hasDepthInput);
+    }
+
+private:
+    static constexpr const char* kHistoryName = "FusedPostTAAHistory";
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Fused Post";
+
+    FGResource m_sourceRead, m_motionRead, m_exposureLutRead, m_pyramidRead, m_depthRead, m_output;
+    FGResource m_prevHistory, m_history;
+
+    float m_blendMin = 0.05f;
+    float m_blendMax = 1.0f;
+    float m_varianceClipGamma = 1.0f;
+    float m_motionWeightScale = 20.0f;
+
+    bool m_enabled = true;
+    int m_method = 3; // ACES
+    float m_exposure = 1.0f;
+    float m_contrast = 1.0f;
+    float m_brightness = 1.0f;
+    float m_saturation = 1.0f;
+    float m_vignette = 0.0f;
+    bool m_dither = true;
+    bool m_autoExposure = false;
+    bool m_hasExposureLutInput = false;
+    bool m_hasPyramidInput = false;
+    bool m_hasDepthInput = false;
+    PostLensSettings m_lens;
+};
+
+METALLIC_REGISTER_PASS(FusedPostPass);
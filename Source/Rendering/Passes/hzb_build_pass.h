@@ -7,6 +7,8 @@
 
 #include "imgui.h"
 
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 class HZBBuildPass : public RenderPass {
@@ -16,34 +18,12 @@ public:
 
     METALLIC_PASS_TYPE_INFO(HZBBuildPass, "HZB Build", "Geometry",
         (std::vector<PassSlotInfo>{makeInputSlot("depth", "Depth")}),
-        (std::vector<PassSlotInfo>{
-            makeOutputSlot("hzb0", "HZB 0", true),
-            makeOutputSlot("hzb1", "HZB 1", true),
-            makeOutputSlot("hzb2", "HZB 2", true),
-            makeOutputSlot("hzb3", "HZB 3", true),
-            makeOutputSlot("hzb4", "HZB 4", true),
-            makeOutputSlot("hzb5", "HZB 5", true),
-            makeOutputSlot("hzb6", "HZB 6", true),
-            makeOutputSlot("hzb7", "HZB 7", true),
-            makeOutputSlot("hzb8", "HZB 8", true),
-            makeOutputSlot("hzb9", "HZB 9", true)
-        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("hzb", "HZB", true)}),
         PassTypeInfo::PassType::Compute);
 
     METALLIC_PASS_EDITOR_TYPE_INFO(HZBBuildPass, "HZB Build", "Geometry",
         (std::vector<PassSlotInfo>{makeInputSlot("depth", "Depth")}),
-        (std::vector<PassSlotInfo>{
-            makeHiddenOutputSlot("hzb0", "HZB 0", true),
-            makeHiddenOutputSlot("hzb1", "HZB 1", true),
-            makeHiddenOutputSlot("hzb2", "HZB 2", true),
-            makeHiddenOutputSlot("hzb3", "HZB 3", true),
-            makeHiddenOutputSlot("hzb4", "HZB 4", true),
-            makeHiddenOutputSlot("hzb5", "HZB 5", true),
-            makeHiddenOutputSlot("hzb6", "HZB 6", true),
-            makeHiddenOutputSlot("hzb7", "HZB 7", true),
-            makeHiddenOutputSlot("hzb8", "HZB 8", true),
-            makeHiddenOutputSlot("hzb9", "HZB 9", true)
-        }),
+        (std::vector<PassSlotInfo>{makeHiddenOutputSlot("hzb", "HZB", true)}),
         PassTypeInfo::PassType::Compute);
 
     FGPassType passType() const override { return FGPassType::Compute; }
@@ -58,22 +38,21 @@ public:
             if (config.config.contains("publishOutputs")) {
                 m_publishOutputs = config.config["publishOutputs"].get<bool>();
             }
+            if (config.config.contains("singlePass")) {
+                m_singlePass = config.config["singlePass"].get<bool>();
+            }
         }
     }
 
     FGResource getOutput(const std::string& name) const override {
-        for (uint32_t level = 0; level < m_outputWrites.size(); ++level) {
-            if (name == hzbOutputSlotName(level)) {
-                return m_outputWrites[level];
-            }
-        }
-        return FGResource{};
+        return name == "hzb" ? m_outputWrite : FGResource{};
     }
 
     void setup(FGBuilder& builder) override {
         m_depthRead = FGResource{};
-        m_historyWrites.clear();
-        m_outputWrites.clear();
+        m_historyWrite = FGResource{};
+        m_outputWrite = FGResource{};
+        builder.setQueueHint(RhiQueueHint::AsyncCompute);
 
         FGResource depthInput = getInput("depth");
         if (depthInput.isValid()) {
@@ -83,30 +62,14 @@ public:
             return;
         }
 
-        m_levelCount = kHzbMaxLevels;
+        const RhiTextureDesc desc =
+            makeHzbTextureDesc(static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height),
+                               m_runtimeContext && m_runtimeContext->hzb16);
+        m_levelCount = desc.mipLevels;
         if (m_publishOutputs) {
-            m_outputWrites.reserve(m_levelCount);
-            for (uint32_t level = 0; level < m_levelCount; ++level) {
-                m_outputWrites.push_back(
-                    builder.create(hzbOutputResourceName(level).c_str(),
-                                   makeHzbTextureDesc(static_cast<uint32_t>(m_width),
-                                                      static_cast<uint32_t>(m_height),
-                                                      level)));
-            }
-        }
-
-        if (!m_writeHistory) {
-            return;
-        }
-
-        m_historyWrites.reserve(m_levelCount);
-        for (uint32_t level = 0; level < m_levelCount; ++level) {
-            const std::string resourceName = hzbHistoryResourceName(level);
-            m_historyWrites.push_back(
-                builder.writeHistory(resourceName.c_str(),
-                                     makeHzbTextureDesc(static_cast<uint32_t>(m_width),
-                                                        static_cast<uint32_t>(m_height),
-                                                        level)));
+            m_outputWrite = builder.create("Current HZB", desc);
+        } else if (m_writeHistory) {
+            m_historyWrite = builder.writeHistory(kHzbHistoryResourceName, desc);
         }
     }
 
@@ -138,68 +101,126 @@ public:
             uint32_t _pad[3] = {};
         };
 
-        encoder.setComputePipeline(pipelineIt->second);
+        const FGResource destinationResource = m_publishOutputs ? m_outputWrite : m_historyWrite;
+        RhiTexture* destinationTexture =
+            destinationResource.isValid() ? m_frameGraph->getTexture(destinationResource) : nullptr;
+        if (!destinationTexture) {
+            return;
+        }
 
-        for (uint32_t level = 0; level < m_levelCount; ++level) {
-            if (m_publishOutputs) {
-                if (level >= m_outputWrites.size()) {
-                    return;
-                }
-            } else if (level >= m_historyWrites.size()) {
-                return;
-            }
-            FGResource destinationResource =
-                m_publishOutputs ? m_outputWrites[level] : m_historyWrites[level];
-            if (!destinationResource.isValid()) {
-                return;
-            }
-            RhiTexture* destinationTexture = m_frameGraph->getTexture(destinationResource);
-            if (!destinationTexture) {
-                return;
+        const uint32_t levelCount = std::min(m_levelCount, destinationTexture->mipLevelCount());
+        m_usedSinglePass = false;
+        if (m_singlePass && levelCount > 0u &&
+            executeSinglePass(encoder, *sourceTexture, *destinationTexture, levelCount)) {
+            m_usedSinglePass = true;
+            if (m_historyWrite.isValid()) {
+                m_frameGraph->commitHistory(m_historyWrite);
             }
+            return;
+        }
+
+        encoder.setComputePipeline(pipelineIt->second);
 
+        // Each level samples only the previous mip and writes only its own, so the
+        // mip bindings transition just those two subresources between dispatches.
+        for (uint32_t level = 0; level < levelCount; ++level) {
             HZBBuildUniforms uniforms{};
-            uniforms.srcWidth = sourceTexture->width();
-            uniforms.srcHeight = sourceTexture->height();
-            uniforms.dstWidth = destinationTexture->width();
-            uniforms.dstHeight = destinationTexture->height();
-            uniforms.sourceScale = (level == 0u) ? 1u : 2u;
+            if (level == 0u) {
+                uniforms.srcWidth = sourceTexture->width();
+                uniforms.srcHeight = sourceTexture->height();
+                encoder.setTexture(sourceTexture, 0);
+            } else {
+                uniforms.srcWidth = hzbLevelDimension(destinationTexture->width(), level - 1u);
+                uniforms.srcHeight = hzbLevelDimension(destinationTexture->height(), level - 1u);
+                encoder.setTextureMip(destinationTexture, level - 1u, 0);
+            }
+            uniforms.dstWidth = hzbLevelDimension(destinationTexture->width(), level);
+            uniforms.dstHeight = hzbLevelDimension(destinationTexture->height(), level);
+            // Mip 0 already reduces 2x2 depth quads (HZB_BASE_LEVEL).
+            uniforms.sourceScale = 2u;
 
             encoder.setPushConstants(&uniforms, sizeof(uniforms));
-            encoder.setTexture(sourceTexture, 0);
-            encoder.setStorageTexture(destinationTexture, 1);
+            encoder.setStorageTextureMip(destinationTexture, level, 1);
             encoder.dispatchThreadgroups({(uniforms.dstWidth + 7u) / 8u,
                                           (uniforms.dstHeight + 7u) / 8u,
                                           1u},
                                          {8u, 8u, 1u});
-            if (m_writeHistory && !m_publishOutputs) {
-                m_frameGraph->commitHistory(m_historyWrites[level]);
-            }
+        }
 
-            sourceTexture = destinationTexture;
-            if (level + 1u < m_levelCount) {
-                encoder.memoryBarrier(RhiBarrierScope::Textures);
-            }
+        if (m_historyWrite.isValid()) {
+            m_frameGraph->commitHistory(m_historyWrite);
         }
     }
 
     void renderUI() override {
         ImGui::Text("Resolution: %d x %d", m_width, m_height);
-        ImGui::Text("Levels: %u", m_levelCount);
+        ImGui::Text("Levels: %u (from 1/2 resolution)", m_levelCount);
+        ImGui::Text("Format: %s", m_runtimeContext && m_runtimeContext->hzb16 ? "R16 Float" : "R32 Float");
+        ImGui::Text("Build: %s", m_usedSinglePass ? "Single dispatch" : "Per-mip dispatches");
         ImGui::Text("Publish Outputs: %s", m_publishOutputs ? "Yes" : "No");
         ImGui::Text("Write History: %s", m_writeHistory ? "Yes" : "No");
         const bool historyValid =
-            m_frameGraph && !m_historyWrites.empty() && m_frameGraph->isHistoryValid(m_historyWrites[0]);
+            m_frameGraph && m_historyWrite.isValid() && m_frameGraph->isHistoryValid(m_historyWrite);
         ImGui::Text("History Ready: %s", historyValid ? "Yes" : "No");
     }
 
 private:
-    static std::string hzbOutputSlotName(uint32_t level) {
-        return "hzb" + std::to_string(level);
-    }
+    // One dispatch builds every mip: 64x64 tiles reduce mips 0..6 in groupshared
+    // memory and the last tile to finish (global atomic counter) builds the rest.
+    bool executeSinglePass(RhiComputeCommandEncoder& encoder,
+                           const RhiTexture& sourceTexture,
+                           const RhiTexture& destinationTexture,
+                           uint32_t levelCount) {
+        auto pipelineIt = m_runtimeContext->computePipelinesRhi.find("HZBDownsamplePass");
+        if (pipelineIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !pipelineIt->second.nativeHandle()) {
+            return false;
+        }
+
+        // The shader resets the counter when it finishes, so it is zeroed only once.
+        if (!m_groupCounterBuffer && m_runtimeContext->resourceFactory) {
+            const uint32_t zero = 0u;
+            RhiBufferDesc desc;
+            desc.size = sizeof(zero);
+            desc.initialData = &zero;
+            desc.debugName = "HZBDownsampleGroupCounter";
+            m_groupCounterBuffer = m_runtimeContext->resourceFactory->createBuffer(desc);
+        }
+        if (!m_groupCounterBuffer) {
+            return false;
+        }
+
+        struct HZBDownsampleUniforms {
+            uint32_t srcWidth = 0;
+            uint32_t srcHeight = 0;
+            uint32_t hzbWidth = 0;
+            uint32_t hzbHeight = 0;
+            uint32_t levelCount = 0;
+            uint32_t groupCount = 0;
+            uint32_t _pad[2] = {};
+        };
 
-    static std::string hzbOutputResourceName(uint32_t level) {
-        return "Current HZB Mip " + std::to_string(level);
+        constexpr uint32_t kTileSize = 64u;
+        const uint32_t groupsX = (destinationTexture.width() + kTileSize - 1u) / kTileSize;
+        const uint32_t groupsY = (destinationTexture.height() + kTileSize - 1u) / kTileSize;
+
+        HZBDownsampleUniforms uniforms{};
+        uniforms.srcWidth = sourceTexture.width();
+        uniforms.srcHeight = sourceTexture.height();
+        uniforms.hzbWidth = destinationTexture.width();
+        uniforms.hzbHeight = destinationTexture.height();
+        uniforms.levelCount = levelCount;
+        uniforms.groupCount = groupsX * groupsY;
+
+        encoder.setComputePipeline(pipelineIt->second);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(&sourceTexture, 0);
+        for (uint32_t slot = 0; slot < kHzbMaxLevels; ++slot) {
+            encoder.setStorageTextureMip(&destinationTexture, std::min(slot, levelCount - 1u), 1u + slot);
+        }
+        encoder.setBuffer(m_groupCounterBuffer.get(), 0, 1);
+        encoder.dispatchThreadgroups({groupsX, groupsY, 1u}, {256u, 1u, 1u});
+        return true;
     }
 
     int m_width = 0;
@@ -207,10 +228,13 @@ private:
     uint32_t m_levelCount = 0;
     bool m_publishOutputs = false;
     bool m_writeHistory = true;
+    bool m_singlePass = true;
+    bool m_usedSinglePass = false;
+    std::unique_ptr<RhiBuffer> m_groupCounterBuffer;
     std::string m_name = "HZB Build";
     FGResource m_depthRead;
-    std::vector<FGResource> m_historyWrites;
-    std::vector<FGResource> m_outputWrites;
+    FGResource m_historyWrite;
+    FGResource m_outputWrite;
 };
 
 METALLIC_REGISTER_PASS(HZBBuildPass);
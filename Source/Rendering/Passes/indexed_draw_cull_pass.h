@@ -0,0 +1,188 @@
+#pragma once
+
+#include "frame_context.h"
+#include "gpu_cull_resources.h"
+#include "gpu_driven_helpers.h"
+#include "pass_registry.h"
+#include "render_pass.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// GPU culling for the forward vertex pipeline. Classifies scene instances against the
+// frustum (instance_classify.slang) and turns the visible ones into indexed draw
+// commands (indexed_draw_build.slang), so ForwardPass draws every visible instance
+// with one indirect-count call instead of a CPU loop over visibleIndexNodes. Only
+// instances in the GPU scene tables are covered; without the pipelines it publishes
+// nothing and ForwardPass keeps the CPU path.
+class IndexedDrawCullPass : public RenderPass {
+public:
+    IndexedDrawCullPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(IndexedDrawCullPass, "Indexed Draw Cull", "Geometry",
+        (std::vector<PassSlotInfo>{makeInputSlot("transformSync", "Transform Sync", true)}),
+        (std::vector<PassSlotInfo>{
+            makeOutputSlot("indexedDraws", "Indexed Draws", true),
+            makeOutputSlot("indexedDrawState", "Indexed Draw State", true),
+            makeOutputSlot("visibleInstances", "Visible Instances", true)
+        }),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.is_object() && config.config.contains("enabled")) {
+            m_enabled = config.config["enabled"].get<bool>();
+        }
+    }
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "indexedDraws") return m_drawCommands;
+        if (name == "indexedDrawState") return m_visibleInstanceState;
+        if (name == "visibleInstances") return m_visibleInstances;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_drawCommands = FGResource{};
+        m_visibleInstanceState = FGResource{};
+        m_visibleInstances = FGResource{};
+        m_active = false;
+
+        FGResource transformSyncInput = getInput("transformSync");
+        if (transformSyncInput.isValid()) {
+            builder.read(transformSyncInput);
+        }
+        if (!m_enabled || !pipelinesAvailable() || m_ctx.gpuScene.instanceCount == 0 ||
+            !m_ctx.gpuScene.instanceCullBuffer.nativeHandle() ||
+            !m_ctx.gpuScene.geometryBuffer.nativeHandle()) {
+            return;
+        }
+
+        m_drawCapacity = m_ctx.gpuScene.instanceCount;
+        const auto visibleInstanceWorklist =
+            GpuDriven::createTypedIndirectWorklist<VisibleInstanceInfo,
+                                                   GpuDriven::ComputeDispatchCommandLayout>(
+                builder,
+                "visibleInstances",
+                "IndexedDrawVisibleInstanceBuffer",
+                m_drawCapacity,
+                "indexedDrawState",
+                "IndexedDrawStateBuffer",
+                false);
+        m_visibleInstances = visibleInstanceWorklist.payload;
+        m_visibleInstanceState = visibleInstanceWorklist.state;
+        m_drawCommands = builder.create(
+            "indexedDraws",
+            GpuDriven::makeStructuredBufferDesc<IndexedDrawCommand>(m_drawCapacity, "IndexedDrawCommandBuffer"));
+        m_active = true;
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("IndexedDrawCullPass");
+        MICROPROFILE_SCOPEI("RenderPass", "IndexedDrawCullPass", 0xffff8800);
+        if (!m_active || !m_frameContext || !m_runtimeContext || !m_frameGraph) {
+            return;
+        }
+
+        auto resetIt = m_runtimeContext->computePipelinesRhi.find("WorklistResetPass");
+        auto classifyIt = m_runtimeContext->computePipelinesRhi.find("InstanceClassifyPass");
+        auto buildIt = m_runtimeContext->computePipelinesRhi.find("IndexedDrawBuildPass");
+        const RhiBuffer* visibleInstanceBuffer = m_frameGraph->getBuffer(m_visibleInstances);
+        const RhiBuffer* visibleInstanceStateBuffer = m_frameGraph->getBuffer(m_visibleInstanceState);
+        const RhiBuffer* drawCommandBuffer = m_frameGraph->getBuffer(m_drawCommands);
+        if (resetIt == m_runtimeContext->computePipelinesRhi.end() ||
+            classifyIt == m_runtimeContext->computePipelinesRhi.end() ||
+            buildIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !visibleInstanceBuffer || !visibleInstanceStateBuffer || !drawCommandBuffer) {
+            return;
+        }
+
+        const GpuSceneTables& gpuScene = m_ctx.gpuScene;
+
+        encoder.setComputePipeline(resetIt->second);
+        encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+        encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        // Frustum only: the forward path has no HZB, and nothing consumes the
+        // visible-instance dispatch args, so classification publishes none.
+        InstanceClassifyUniforms classifyUni{};
+        classifyUni.viewProj = transpose(m_frameContext->unjitteredProj * m_frameContext->view);
+        classifyUni.prevViewProj = classifyUni.viewProj;
+        classifyUni.prevView = transpose(m_frameContext->view);
+        classifyUni.cameraWorldPos = m_frameContext->cameraWorldPos;
+        classifyUni.prevCameraWorldPos = m_frameContext->cameraWorldPos;
+        classifyUni.prevProjScale = float2(std::abs(m_frameContext->unjitteredProj[0].x),
+                                           std::abs(m_frameContext->unjitteredProj[1].y));
+        classifyUni.instanceCount = gpuScene.instanceCount;
+        classifyUni.enableFrustumCull = m_frameContext->enableFrustumCull ? 1u : 0u;
+        classifyUni.enableOcclusionCull = 0u;
+        classifyUni.hzbLevelCount = 0u;
+        classifyUni.publishGroupCount = 0u;
+
+        constexpr uint32_t kThreadgroupSize = 64u;
+        encoder.setComputePipeline(classifyIt->second);
+        encoder.setBytes(&classifyUni, sizeof(classifyUni), GpuDriven::InstanceClassifyBindings::kUniforms);
+        encoder.setBuffer(&gpuScene.instanceCullBuffer, 0, GpuDriven::InstanceClassifyBindings::kInstanceCull);
+        encoder.setBuffer(visibleInstanceBuffer, 0, GpuDriven::InstanceClassifyBindings::kOutput);
+        encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::InstanceClassifyBindings::kState);
+        encoder.dispatchThreadgroups({(gpuScene.instanceCount + kThreadgroupSize - 1u) / kThreadgroupSize, 1, 1},
+                                     {kThreadgroupSize, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        struct {
+            uint32_t drawCapacity;
+            uint32_t pad[3];
+        } buildUni{};
+        buildUni.drawCapacity = m_drawCapacity;
+
+        encoder.setComputePipeline(buildIt->second);
+        encoder.setBytes(&buildUni, sizeof(buildUni), GpuDriven::IndexedDrawBuildBindings::kUniforms);
+        encoder.setBuffer(visibleInstanceBuffer, 0, GpuDriven::IndexedDrawBuildBindings::kVisibleInstances);
+        encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::IndexedDrawBuildBindings::kVisibleInstanceState);
+        encoder.setBuffer(&gpuScene.geometryBuffer, 0, GpuDriven::IndexedDrawBuildBindings::kGeometries);
+        encoder.setBuffer(drawCommandBuffer, 0, GpuDriven::IndexedDrawBuildBindings::kCommands);
+        encoder.dispatchThreadgroups({(m_drawCapacity + kThreadgroupSize - 1u) / kThreadgroupSize, 1, 1},
+                                     {kThreadgroupSize, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+    }
+
+    void renderUI() override {
+        ImGui::Checkbox("Enabled", &m_enabled);
+        ImGui::Text("Draw Capacity: %u", m_drawCapacity);
+        if (!pipelinesAvailable()) {
+            ImGui::TextDisabled("Pipelines unavailable; ForwardPass draws on the CPU path");
+        }
+    }
+
+private:
+    bool pipelinesAvailable() const {
+        if (!m_runtimeContext) {
+            return false;
+        }
+        const auto& pipelines = m_runtimeContext->computePipelinesRhi;
+        return pipelines.count("WorklistResetPass") != 0 &&
+               pipelines.count("InstanceClassifyPass") != 0 &&
+               pipelines.count("IndexedDrawBuildPass") != 0;
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Indexed Draw Cull";
+    bool m_enabled = true;
+    bool m_active = false;
+    uint32_t m_drawCapacity = 0;
+    FGResource m_drawCommands;
+    FGResource m_visibleInstanceState;
+    FGResource m_visibleInstances;
+};
+
+METALLIC_REGISTER_PASS(IndexedDrawCullPass);
@@ -6,11 +6,21 @@
 #include "frame_context.h"
 #include "gpu_driven_helpers.h"
 #include "gpu_cull_resources.h"
+#include "gpu_driven_telemetry.h"
+#include "lod_budget_controller.h"
 #include "cluster_lod_builder.h"
 #include "hzb_constants.h"
+#include "gpu_debug_messages.h"
 #include "pass_registry.h"
 #include "imgui.h"
 #include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include "rhi_resource_utils.h"
+#include "vulkan_upload_service.h"
+#include "vulkan_resource_handles.h"
+#endif
+
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -24,25 +34,25 @@ public:
     MeshletCullPass(const RenderContext& ctx, int w, int h)
         : m_ctx(ctx), m_width(w), m_height(h) {}
 
-    ~MeshletCullPass() override = default;
+    ~MeshletCullPass() override {
+#ifdef _WIN32
+        if (m_runtimeContext && m_runtimeContext->readbackService) {
+            m_runtimeContext->readbackService->cancelReadbacks(this);
+        }
+#endif
+    }
 
     METALLIC_PASS_TYPE_INFO(MeshletCullPass, "Meshlet Cull", "Geometry",
         (std::vector<PassSlotInfo>{
             makeInputSlot("streamingSync", "Streaming Sync", true),
+            makeInputSlot("transformSync", "Transform Sync", true),
+            makeInputSlot("skinningSync", "Skinning Sync", true),
             makeInputSlot("visibleMeshletsInput", "Visible Meshlets Input", true),
             makeInputSlot("visibilityWorklistInput", "Visibility Worklist Input", true),
             makeInputSlot("visibilityWorklistStateInput", "Visibility Worklist State Input", true),
             makeInputSlot("cullCounterInput", "Cull Counter Input", true),
-            makeInputSlot("currentHzb0", "Current HZB 0", true),
-            makeInputSlot("currentHzb1", "Current HZB 1", true),
-            makeInputSlot("currentHzb2", "Current HZB 2", true),
-            makeInputSlot("currentHzb3", "Current HZB 3", true),
-            makeInputSlot("currentHzb4", "Current HZB 4", true),
-            makeInputSlot("currentHzb5", "Current HZB 5", true),
-            makeInputSlot("currentHzb6", "Current HZB 6", true),
-            makeInputSlot("currentHzb7", "Current HZB 7", true),
-            makeInputSlot("currentHzb8", "Current HZB 8", true),
-            makeInputSlot("currentHzb9", "Current HZB 9", true)
+            makeInputSlot("currentHzb", "Current HZB", true),
+            makeInputSlot("visibleHistoryTableInput", "Visible History Table Input", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("cullResult", "Cull Result", true),
@@ -52,27 +62,22 @@ public:
             makeOutputSlot("visibilityWorklist", "Visibility Worklist", true),
             makeOutputSlot("visibilityWorklistState", "Visibility Worklist State", true),
             makeOutputSlot("visibilityIndirectArgs", "Visibility Indirect Args", true),
-            makeOutputSlot("visibilityInstances", "Visibility Instances", true)
+            makeOutputSlot("visibilityInstances", "Visibility Instances", true),
+            makeOutputSlot("visibleHistoryTable", "Visible History Table", true)
         }),
         PassTypeInfo::PassType::Compute);
 
     METALLIC_PASS_EDITOR_TYPE_INFO(MeshletCullPass, "Meshlet Cull", "Geometry",
         (std::vector<PassSlotInfo>{
             makeHiddenInputSlot("streamingSync", "Streaming Sync", true),
+            makeInputSlot("transformSync", "Transform Sync", true),
+            makeInputSlot("skinningSync", "Skinning Sync", true),
             makeHiddenInputSlot("visibleMeshletsInput", "Visible Meshlets Input", true),
             makeHiddenInputSlot("visibilityWorklistInput", "Visibility Worklist Input", true),
             makeHiddenInputSlot("visibilityWorklistStateInput", "Visibility Worklist State Input", true),
             makeHiddenInputSlot("cullCounterInput", "Cull Counter Input", true),
-            makeHiddenInputSlot("currentHzb0", "Current HZB 0", true),
-            makeHiddenInputSlot("currentHzb1", "Current HZB 1", true),
-            makeHiddenInputSlot("currentHzb2", "Current HZB 2", true),
-            makeHiddenInputSlot("currentHzb3", "Current HZB 3", true),
-            makeHiddenInputSlot("currentHzb4", "Current HZB 4", true),
-            makeHiddenInputSlot("currentHzb5", "Current HZB 5", true),
-            makeHiddenInputSlot("currentHzb6", "Current HZB 6", true),
-            makeHiddenInputSlot("currentHzb7", "Current HZB 7", true),
-            makeHiddenInputSlot("currentHzb8", "Current HZB 8", true),
-            makeHiddenInputSlot("currentHzb9", "Current HZB 9", true)
+            makeHiddenInputSlot("currentHzb", "Current HZB", true),
+            makeHiddenInputSlot("visibleHistoryTableInput", "Visible History Table Input", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("cullResult", "Cull Result"),
@@ -82,7 +87,8 @@ public:
             makeHiddenOutputSlot("visibilityWorklist", "Visibility Worklist", true),
             makeHiddenOutputSlot("visibilityWorklistState", "Visibility Worklist State", true),
             makeHiddenOutputSlot("visibilityIndirectArgs", "Visibility Indirect Args", true),
-            makeHiddenOutputSlot("visibilityInstances", "Visibility Instances", true)
+            makeHiddenOutputSlot("visibilityInstances", "Visibility Instances", true),
+            makeHiddenOutputSlot("visibleHistoryTable", "Visible History Table", true)
         }),
         PassTypeInfo::PassType::Compute);
 
@@ -103,6 +109,29 @@ public:
                 const std::string phase = config.config["phase"].get<std::string>();
                 m_cullPassIndex = (phase == "second" || phase == "late") ? 1u : 0u;
             }
+            if (config.config.contains("visibleHistory")) {
+                m_enableVisibleHistory = config.config["visibleHistory"].get<bool>();
+            }
+            if (config.config.contains("softwareRasterTriangleSize")) {
+                m_softwareRasterTriangleSize =
+                    config.config["softwareRasterTriangleSize"].get<float>();
+            }
+            if (config.config.contains("instanceBvh")) {
+                m_enableInstanceBvh = config.config["instanceBvh"].get<bool>();
+            }
+            if (config.config.contains("shadowCascade")) {
+                m_shadowCascade = config.config["shadowCascade"].get<int>();
+            }
+        }
+        // A light view culls at the cascade resolution with only the frustum test: it
+        // has no HZB or visible-meshlet history, and its VisibilityPass has no
+        // software raster resolve.
+        if (m_shadowCascade >= 0) {
+            m_width = static_cast<int>(kShadowCascadeResolution);
+            m_height = static_cast<int>(kShadowCascadeResolution);
+            m_enableVisibleHistory = false;
+            m_enableOcclusionCull = false;
+            m_softwareRasterTriangleSize = 0.0f;
         }
     }
 
@@ -120,6 +149,7 @@ public:
         if (name == "visibilityWorklistState") return cullCounter;
         if (name == "visibilityIndirectArgs") return cullCounter;
         if (name == "visibilityInstances") return instanceData;
+        if (name == "visibleHistoryTable") return m_cullPassIndex == 0u ? m_visibleHistoryTable : FGResource{};
         return FGResource{};
     }
 
@@ -128,6 +158,14 @@ public:
         if (streamingSyncInput.isValid()) {
             builder.read(streamingSyncInput);
         }
+        FGResource transformSyncInput = getInput("transformSync");
+        if (transformSyncInput.isValid()) {
+            builder.read(transformSyncInput);
+        }
+        FGResource skinningSyncInput = getInput("skinningSync");
+        if (skinningSyncInput.isValid()) {
+            builder.read(skinningSyncInput);
+        }
 
         cullResult = builder.createToken("cullResult");
 
@@ -180,6 +218,23 @@ public:
 
         m_clusterTraversalStats = builder.create("ClusterTraversalStats",
                                                  makeTraversalStatsBufferDesc());
+        m_debugMessages = FGResource{};
+        if (m_runtimeContext && m_runtimeContext->gpuDebugMessages) {
+            m_debugMessages = builder.create("MeshletCullDebugMessages",
+                                             makeGpuDebugMessageBufferDesc("MeshletCullDebugMessages"));
+        }
+        const auto traversalContinuationWorklist =
+            GpuDriven::createTypedIndirectWorklist<ClusterTraversalContinuation,
+                                                   GpuDriven::ComputeDispatchCommandLayout>(
+                builder,
+                "ClusterTraversalContinuations",
+                "ClusterTraversalContinuationBuffer",
+                GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_CAPACITY,
+                "ClusterTraversalContinuationState",
+                "ClusterTraversalContinuationStateBuffer",
+                true);
+        m_traversalContinuations = traversalContinuationWorklist.payload;
+        m_traversalContinuationState = traversalContinuationWorklist.state;
         m_dummyLodNodes = builder.create("DummyClusterLodNodes",
                                          makeSingleElementBufferDesc<GPULodNode>("DummyClusterLodNodes"));
         m_dummyLodGroups = builder.create("DummyClusterLodGroups",
@@ -209,26 +264,56 @@ public:
             builder.create("DummyClusterLodGroupAge",
                            makeSingleElementBufferDesc<uint32_t>("DummyClusterLodGroupAge"));
 
-        m_hzbHistoryRead.clear();
-        m_currentHzbRead.clear();
-        m_hzbLevelCount = kHzbMaxLevels;
-        m_hzbHistoryRead.reserve(m_hzbLevelCount);
-        for (uint32_t level = 0; level < m_hzbLevelCount; ++level) {
-            const std::string resourceName = hzbHistoryResourceName(level);
-            m_hzbHistoryRead.push_back(
-                builder.readHistory(resourceName.c_str(),
-                                    makeHzbTextureDesc(static_cast<uint32_t>(m_width),
-                                                       static_cast<uint32_t>(m_height),
-                                                       level)));
-        }
-
-        m_currentHzbRead.reserve(kHzbMaxLevels);
-        for (uint32_t level = 0; level < kHzbMaxLevels; ++level) {
-            FGResource currentHzbInput = getInput(currentHzbInputSlotName(level));
-            if (!currentHzbInput.isValid()) {
-                break;
+        m_hzbLevelCount = 0;
+        m_hzbHistoryRead = FGResource{};
+        if (m_shadowCascade < 0) {
+            const RhiTextureDesc hzbDesc =
+                makeHzbTextureDesc(static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height),
+                                   m_runtimeContext && m_runtimeContext->hzb16);
+            m_hzbLevelCount = hzbDesc.mipLevels;
+            m_hzbHistoryRead = builder.readHistory(kHzbHistoryResourceName, hzbDesc);
+        }
+
+        m_currentHzbRead = FGResource{};
+        FGResource currentHzbInput = getInput("currentHzb");
+        if (currentHzbInput.isValid()) {
+            m_currentHzbRead = builder.read(currentHzbInput, FGResourceUsage::Sampled);
+        }
+
+        // The first pass replays last frame's visible list and publishes a lookup table
+        // of what it drew; the pass that consumes the table records the next list.
+        m_visibleHistory = FGResource{};
+        m_visibleHistoryState = FGResource{};
+        m_visibleHistoryTable = FGResource{};
+        m_visibleHistoryTableSize = visibleHistoryTableSize();
+        m_dummyVisibleHistory =
+            builder.create("DummyVisibleMeshletHistory",
+                           makeSingleElementBufferDesc<MeshletDrawInfo>("DummyVisibleMeshletHistory"));
+        if (m_enableVisibleHistory) {
+            const FGBufferDesc historyDesc =
+                GpuDriven::makeStructuredBufferDesc<MeshletDrawInfo>(m_maxMeshlets, "VisibleMeshletHistory");
+            const FGBufferDesc historyStateDesc =
+                GpuDriven::makeWorklistStateBufferDesc<GpuDriven::ComputeDispatchCommandLayout>(
+                    "VisibleMeshletHistoryState");
+            FGResource visibleHistoryTableInput = getInput("visibleHistoryTableInput");
+            if (m_cullPassIndex == 0u) {
+                m_visibleHistory = builder.readHistory(kVisibleMeshletHistoryResourceName, historyDesc);
+                m_visibleHistoryState = builder.readHistory(kVisibleMeshletHistoryStateResourceName,
+                                                            historyStateDesc,
+                                                            FGResourceUsage::StorageRead |
+                                                                FGResourceUsage::Indirect);
+                m_visibleHistoryTable = builder.create(
+                    "visibleHistoryTable",
+                    GpuDriven::makeStructuredBufferDesc<uint32_t>(m_visibleHistoryTableSize,
+                                                                  "VisibleHistoryTable"));
+            } else if (visibleHistoryTableInput.isValid()) {
+                m_visibleHistoryTable = builder.read(visibleHistoryTableInput, FGResourceUsage::StorageRead);
+                m_visibleHistory = builder.writeHistory(kVisibleMeshletHistoryResourceName, historyDesc);
+                m_visibleHistoryState = builder.writeHistory(kVisibleMeshletHistoryStateResourceName,
+                                                             historyStateDesc,
+                                                             FGResourceUsage::StorageRead |
+                                                                 FGResourceUsage::StorageWrite);
             }
-            m_currentHzbRead.push_back(builder.read(currentHzbInput, FGResourceUsage::Sampled));
         }
     }
 
@@ -238,9 +323,30 @@ public:
         if (!m_frameContext || !m_runtimeContext) return;
         if (!m_frameContext->gpuDrivenCulling) return;
 
+        // Cached cascades keep last frame's depth, so their worklist is not needed.
+        const ShadowCascadeView* shadowCascade =
+            findShadowCascade(m_frameContext->shadowCascades, m_shadowCascade);
+        if (m_shadowCascade >= 0) {
+            m_shadowCascadeCached = shadowCascade && shadowCascade->cached;
+            if (!shadowCascade || shadowCascade->cached) return;
+        }
+
         auto classifyIt = m_runtimeContext->computePipelinesRhi.find("InstanceClassifyPass");
+        auto bvhCullIt = m_runtimeContext->computePipelinesRhi.find("InstanceBvhCullPass");
         auto cullIt = m_runtimeContext->computePipelinesRhi.find("MeshletCullPass");
         auto buildIt = m_runtimeContext->computePipelinesRhi.find("BuildIndirectPass");
+        auto resetIt = m_runtimeContext->computePipelinesRhi.find("WorklistResetPass");
+        auto continuationIt = m_runtimeContext->computePipelinesRhi.find("MeshletCullContinuationPass");
+        auto continuationPublishIt =
+            m_runtimeContext->computePipelinesRhi.find("MeshletCullContinuationPublishPass");
+        auto historyReplayIt =
+            m_runtimeContext->computePipelinesRhi.find("MeshletCullVisibleHistoryReplayPass");
+        auto historyClearIt =
+            m_runtimeContext->computePipelinesRhi.find("MeshletCullVisibleHistoryClearPass");
+        auto historyPublishIt =
+            m_runtimeContext->computePipelinesRhi.find("MeshletCullVisibleHistoryPublishPass");
+        const bool gpuWorklistReset =
+            resetIt != m_runtimeContext->computePipelinesRhi.end() && resetIt->second.nativeHandle();
         if (classifyIt == m_runtimeContext->computePipelinesRhi.end() ||
             !classifyIt->second.nativeHandle()) {
             return;
@@ -250,6 +356,7 @@ public:
 
         const GpuSceneTables& gpuScene = m_ctx.gpuScene;
         if (!gpuScene.instanceBuffer.nativeHandle() ||
+            !gpuScene.instanceCullBuffer.nativeHandle() ||
             !gpuScene.geometryBuffer.nativeHandle() ||
             gpuScene.instanceCount == 0 ||
             gpuScene.totalMeshletDispatchCount == 0) {
@@ -264,28 +371,72 @@ public:
         RhiBuffer* visibleMeshletBuffer = m_frameGraph->getBuffer(visibleMeshlets);
         RhiBuffer* worklistStateBuffer = m_frameGraph->getBuffer(cullCounter);
         RhiBuffer* clusterTraversalStatsBuffer = m_frameGraph->getBuffer(m_clusterTraversalStats);
+        RhiBuffer* debugMessageBuffer =
+            m_debugMessages.isValid() ? m_frameGraph->getBuffer(m_debugMessages) : nullptr;
+        RhiBuffer* traversalContinuationBuffer = m_frameGraph->getBuffer(m_traversalContinuations);
+        RhiBuffer* traversalContinuationStateBuffer =
+            m_frameGraph->getBuffer(m_traversalContinuationState);
         if (!visibleInstanceBuffer || !visibleInstanceStateBuffer ||
-            !visibleMeshletBuffer || !worklistStateBuffer || !clusterTraversalStatsBuffer) {
+            !visibleMeshletBuffer || !worklistStateBuffer || !clusterTraversalStatsBuffer ||
+            !traversalContinuationBuffer || !traversalContinuationStateBuffer) {
             return;
         }
 
-        m_lastTraversalStats = readTraversalStats(clusterTraversalStatsBuffer);
-        if (clusterTraversalStatsBuffer->mappedData()) {
-            std::memset(clusterTraversalStatsBuffer->mappedData(), 0, sizeof(ClusterTraversalStats));
-        }
+        // Both passes check the same pipelines, so they always agree on the scheme.
+        const auto pipelineReady = [this](const auto& it) {
+            return it != m_runtimeContext->computePipelinesRhi.end() && it->second.nativeHandle();
+        };
+        const bool visibleHistoryPipelinesReady =
+            pipelineReady(historyReplayIt) && pipelineReady(historyClearIt) &&
+            pipelineReady(historyPublishIt);
+        RhiBuffer* visibleHistoryBuffer =
+            m_visibleHistory.isValid() ? m_frameGraph->getBuffer(m_visibleHistory) : nullptr;
+        RhiBuffer* visibleHistoryStateBuffer =
+            m_visibleHistoryState.isValid() ? m_frameGraph->getBuffer(m_visibleHistoryState) : nullptr;
+        RhiBuffer* visibleHistoryTableBuffer =
+            m_visibleHistoryTable.isValid() ? m_frameGraph->getBuffer(m_visibleHistoryTable) : nullptr;
+        const bool visibleHistoryActive =
+            visibleHistoryPipelinesReady && visibleHistoryBuffer && visibleHistoryStateBuffer &&
+            visibleHistoryTableBuffer;
+        const bool replayVisibleHistory = visibleHistoryActive && m_cullPassIndex == 0u;
+        const bool recordVisibleHistory = visibleHistoryActive && m_cullPassIndex > 0u;
+        // A write is valid exactly when the first pass's age-1 read is, so the second
+        // pass knows whether the first one replayed or culled the scene itself.
+        const bool visibleHistoryValid =
+            visibleHistoryActive && !m_frameContext->historyReset &&
+            m_frameGraph->isHistoryValid(m_visibleHistoryState);
+        const bool traversesFirst = m_cullPassIndex == 0u ? !(replayVisibleHistory && visibleHistoryValid)
+                                                          : (recordVisibleHistory && visibleHistoryValid);
+        m_visibleHistoryMode = replayVisibleHistory ? (visibleHistoryValid ? "Replay" : "Cull + Index")
+                               : recordVisibleHistory ? "Record"
+                                                      : "Off";
 
+#ifndef _WIN32
+        m_lastTraversalStats = readTraversalStats(clusterTraversalStatsBuffer);
         m_lastVisibleInstanceCount =
             GpuDriven::readPublishedWorkItemCount<GpuDriven::ComputeDispatchCommandLayout>(
                 visibleInstanceStateBuffer);
         m_lastVisibleCount =
             GpuDriven::readPublishedWorkItemCount<GpuDriven::MeshDispatchCommandLayout>(
                 worklistStateBuffer);
+#endif
+        if (clusterTraversalStatsBuffer->mappedData()) {
+            std::memset(clusterTraversalStatsBuffer->mappedData(), 0, sizeof(ClusterTraversalStats));
+        }
 
-        GpuDriven::seedWorklistStateBuffer<GpuDriven::ComputeDispatchCommandLayout>(
-            visibleInstanceStateBuffer);
-        if (!m_appendToExistingWorklist) {
-            GpuDriven::seedWorklistStateBuffer<GpuDriven::MeshDispatchCommandLayout>(
-                worklistStateBuffer);
+        if (!gpuWorklistReset) {
+            GpuDriven::seedWorklistStateBuffer<GpuDriven::ComputeDispatchCommandLayout>(
+                visibleInstanceStateBuffer);
+            GpuDriven::seedWorklistStateBuffer<GpuDriven::ComputeDispatchCommandLayout>(
+                traversalContinuationStateBuffer);
+            if (!m_appendToExistingWorklist) {
+                GpuDriven::seedWorklistStateBuffer<GpuDriven::MeshDispatchCommandLayout>(
+                    worklistStateBuffer);
+            }
+            if (recordVisibleHistory) {
+                GpuDriven::seedWorklistStateBuffer<GpuDriven::ComputeDispatchCommandLayout>(
+                    visibleHistoryStateBuffer);
+            }
         }
 
         const ClusterLODData& clusterLodData = m_ctx.clusterLodData;
@@ -296,6 +447,12 @@ public:
             clusterLodData.groupBuffer.nativeHandle() &&
             clusterLodData.groupMeshletIndicesBuffer.nativeHandle() &&
             clusterLodData.boundsBuffer.nativeHandle();
+        const bool traversalContinuationAvailable =
+            clusterLodAvailable &&
+            continuationIt != m_runtimeContext->computePipelinesRhi.end() &&
+            continuationIt->second.nativeHandle() &&
+            continuationPublishIt != m_runtimeContext->computePipelinesRhi.end() &&
+            continuationPublishIt->second.nativeHandle();
         RhiBuffer* dummyLodNodesBuffer = m_frameGraph->getBuffer(m_dummyLodNodes);
         RhiBuffer* dummyLodGroupsBuffer = m_frameGraph->getBuffer(m_dummyLodGroups);
         RhiBuffer* dummyLodGroupMeshletIndicesBuffer =
@@ -307,6 +464,7 @@ public:
         RhiBuffer* dummyResidencyRequestStateBuffer =
             m_frameGraph->getBuffer(m_dummyResidencyRequestState);
         RhiBuffer* dummyGroupAgeBuffer = m_frameGraph->getBuffer(m_dummyGroupAge);
+        RhiBuffer* dummyVisibleHistoryBuffer = m_frameGraph->getBuffer(m_dummyVisibleHistory);
         const RhiBuffer* lodNodeBuffer =
             clusterLodAvailable ? &clusterLodData.nodeBuffer : dummyLodNodesBuffer;
         const RhiBuffer* lodGroupBuffer =
@@ -316,6 +474,10 @@ public:
         const RhiBuffer* sourceLodGroupMeshletIndicesBuffer =
             clusterLodAvailable ? &clusterLodData.groupMeshletIndicesBuffer
                                 : dummyLodGroupMeshletIndicesBuffer;
+        // Same fallback as VisibilityPass: the cull bins alpha-tested clusters by material.
+        const RhiBuffer* lodMaterialIdsBuffer =
+            clusterLodData.materialIDsBuffer.nativeHandle() ? &clusterLodData.materialIDsBuffer
+                                                            : &m_ctx.meshletData.materialIDs;
         const bool residencyStreamingResourcesReady =
             clusterLodAvailable &&
             streamingService &&
@@ -346,57 +508,43 @@ public:
             residencyStreamingResourcesReady ? streamingService->groupAgeBuffer()
                                              : dummyGroupAgeBuffer;
 
-        std::array<const RhiTexture*, kHzbMaxLevels> hzbTextures{};
-        uint32_t hzbTextureCount = 0;
+        const RhiTexture* hzbTexture = nullptr;
         const bool historyValid =
             m_enableOcclusionCull &&
             m_frameContext &&
             !m_frameContext->historyReset &&
-            !m_hzbHistoryRead.empty() &&
+            m_hzbHistoryRead.isValid() &&
             m_frameGraph &&
-            m_frameGraph->isHistoryValid(m_hzbHistoryRead[0]);
+            m_frameGraph->isHistoryValid(m_hzbHistoryRead);
         if (historyValid) {
-            const uint32_t maxLevels =
-                std::min<uint32_t>(static_cast<uint32_t>(m_hzbHistoryRead.size()), kHzbMaxLevels);
-            for (uint32_t level = 0; level < maxLevels; ++level) {
-                const RhiTexture* historyTexture = m_frameGraph->getTexture(m_hzbHistoryRead[level]);
-                if (!historyTexture) {
-                    break;
-                }
-                hzbTextures[hzbTextureCount++] = historyTexture;
-            }
+            hzbTexture = m_frameGraph->getTexture(m_hzbHistoryRead);
         }
+        const uint32_t hzbLevelCount =
+            hzbTexture ? std::min(hzbTexture->mipLevelCount(), kHzbMaxLevels) : 0u;
 
-        std::array<const RhiTexture*, kHzbMaxLevels> currentHzbTextures{};
-        uint32_t currentHzbTextureCount = 0;
-        if (m_cullPassIndex > 0u && !m_currentHzbRead.empty()) {
-            const uint32_t maxLevels =
-                std::min<uint32_t>(static_cast<uint32_t>(m_currentHzbRead.size()), kHzbMaxLevels);
-            for (uint32_t level = 0; level < maxLevels; ++level) {
-                const RhiTexture* currentTexture = m_frameGraph->getTexture(m_currentHzbRead[level]);
-                if (!currentTexture) {
-                    break;
-                }
-                currentHzbTextures[currentHzbTextureCount++] = currentTexture;
-            }
+        const RhiTexture* currentHzbTexture = nullptr;
+        if (m_cullPassIndex > 0u && m_currentHzbRead.isValid() && m_frameGraph) {
+            currentHzbTexture = m_frameGraph->getTexture(m_currentHzbRead);
         }
-        m_currentHzbLevelCount = currentHzbTextureCount;
+        const uint32_t currentHzbLevelCount =
+            currentHzbTexture ? std::min(currentHzbTexture->mipLevelCount(), kHzbMaxLevels) : 0u;
+        m_currentHzbLevelCount = currentHzbLevelCount;
 
-        const float4x4 currentCullProj = m_frameContext->unjitteredProj;
+        const float4x4 cullView = shadowCascade ? shadowCascade->view : m_frameContext->view;
+        const float4x4 currentCullProj = shadowCascade ? shadowCascade->proj : m_frameContext->unjitteredProj;
         const bool classifyWithCurrentHzb =
-            m_cullPassIndex > 0u && currentHzbTextureCount > 0u;
-        const RhiTexture* const* classifyHzbTextures =
-            classifyWithCurrentHzb ? currentHzbTextures.data() : hzbTextures.data();
-        const uint32_t classifyHzbTextureCount =
-            classifyWithCurrentHzb ? currentHzbTextureCount : hzbTextureCount;
+            m_cullPassIndex > 0u && currentHzbLevelCount > 0u;
+        const RhiTexture* classifyHzbTexture = classifyWithCurrentHzb ? currentHzbTexture : hzbTexture;
+        const uint32_t classifyHzbLevelCount =
+            classifyWithCurrentHzb ? currentHzbLevelCount : hzbLevelCount;
 
         InstanceClassifyUniforms classifyUni{};
-        classifyUni.viewProj = transpose(currentCullProj * m_frameContext->view);
+        classifyUni.viewProj = transpose(currentCullProj * cullView);
         classifyUni.prevViewProj = classifyWithCurrentHzb
             ? classifyUni.viewProj
             : transpose(m_frameContext->prevCullProj * m_frameContext->prevCullView);
         classifyUni.prevView = classifyWithCurrentHzb
-            ? transpose(m_frameContext->view)
+            ? transpose(cullView)
             : transpose(m_frameContext->prevCullView);
         classifyUni.cameraWorldPos = m_frameContext->cameraWorldPos;
         classifyUni.prevCameraWorldPos = classifyWithCurrentHzb
@@ -407,20 +555,29 @@ public:
             : float2(std::abs(m_frameContext->prevCullProj[0].x),
                      std::abs(m_frameContext->prevCullProj[1].y));
         classifyUni.instanceCount = gpuScene.instanceCount;
-        classifyUni.enableFrustumCull = m_frameContext->enableFrustumCull ? 1u : 0u;
-        classifyUni.enableOcclusionCull = classifyHzbTextureCount > 0 ? 1u : 0u;
-        classifyUni.hzbLevelCount = classifyHzbTextureCount;
-        if (classifyHzbTextureCount > 0) {
-            classifyUni.hzbTextureSize =
-                float2(static_cast<float>(classifyHzbTextures[0]->width()),
-                       static_cast<float>(classifyHzbTextures[0]->height()));
+        classifyUni.enableFrustumCull = (shadowCascade || m_frameContext->enableFrustumCull) ? 1u : 0u;
+        classifyUni.enableOcclusionCull = classifyHzbLevelCount > 0 ? 1u : 0u;
+        classifyUni.hzbLevelCount = classifyHzbLevelCount;
+        // The cull tests address the pyramid in depth pixels (HZB_BASE_LEVEL).
+        if (classifyHzbLevelCount > 0) {
+            classifyUni.hzbTextureSize = float2(static_cast<float>(m_width), static_cast<float>(m_height));
         }
         classifyUni.occlusionDepthBias = m_occlusionDepthBias;
         classifyUni.occlusionBoundsScale = m_occlusionBoundsScale;
+        // Orthographic cascades have no distance falloff to route on.
+        classifyUni.pixelsPerWorldUnitAtUnitDepth =
+            shadowCascade ? 0.0f : std::abs(currentCullProj[1].y) * 0.5f * static_cast<float>(m_height);
+        classifyUni.coarsestLodPixelRadius = m_coarsestLodPixelRadius;
+        if (!shadowCascade && m_frameContext->viewCount > 1u) {
+            classifyUni.viewCount = 2u;
+            classifyUni.secondaryViewProj =
+                transpose(m_frameContext->secondaryProj * m_frameContext->secondaryView);
+            classifyUni.secondaryCameraWorldPos = m_frameContext->secondaryCameraWorldPos;
+        }
 
         CullUniforms cullUni{};
         cullUni.viewProj = classifyUni.viewProj;
-        cullUni.view = transpose(m_frameContext->view);
+        cullUni.view = transpose(cullView);
         cullUni.prevViewProj = classifyUni.prevViewProj;
         cullUni.prevView = classifyUni.prevView;
         cullUni.cameraWorldPos = classifyUni.cameraWorldPos;
@@ -430,96 +587,265 @@ public:
         cullUni.renderTargetSize = float2(static_cast<float>(m_width), static_cast<float>(m_height));
         cullUni.prevProjScale = classifyUni.prevProjScale;
         cullUni.hzbTextureSize = classifyUni.hzbTextureSize;
-        if (currentHzbTextureCount > 0) {
-            cullUni.currentHzbTextureSize =
-                float2(static_cast<float>(currentHzbTextures[0]->width()),
-                       static_cast<float>(currentHzbTextures[0]->height()));
+        if (currentHzbLevelCount > 0) {
+            cullUni.currentHzbTextureSize = float2(static_cast<float>(m_width), static_cast<float>(m_height));
         }
-        cullUni.enableFrustumCull = m_frameContext->enableFrustumCull ? 1u : 0u;
-        cullUni.enableConeCull = m_frameContext->enableConeCull ? 1u : 0u;
+        cullUni.enableFrustumCull = classifyUni.enableFrustumCull;
+        // Cone culling tests against the camera position, which an orthographic light view lacks.
+        cullUni.enableConeCull = (!shadowCascade && m_frameContext->enableConeCull) ? 1u : 0u;
         cullUni.enableOcclusionCull =
-            (hzbTextureCount > 0u || currentHzbTextureCount > 0u) ? 1u : 0u;
-        cullUni.hzbLevelCount = hzbTextureCount;
+            (hzbLevelCount > 0u || currentHzbLevelCount > 0u) ? 1u : 0u;
+        cullUni.hzbLevelCount = hzbLevelCount;
         cullUni.lodReferencePixels = m_lodReferencePixels;
+        // Light views keep the manual reference; the budget measures the main view.
+        if (!shadowCascade && m_runtimeContext->lodBudget) {
+            cullUni.lodReferencePixels = m_runtimeContext->lodBudget->referencePixels();
+        }
         cullUni.occlusionDepthBias = m_occlusionDepthBias;
         cullUni.occlusionBoundsScale = m_occlusionBoundsScale;
         cullUni.clusterLodEnabled = clusterLodAvailable ? 1u : 0u;
         cullUni.enableResidencyStreaming = residencyStreamingEnabled ? 1u : 0u;
+        cullUni.residentHeapAddressing =
+            residencyStreamingEnabled && streamingService->residentHeapAddress() != 0u ? 1u : 0u;
         cullUni.residencyRequestFrameIndex = m_frameContext ? m_frameContext->frameIndex : 0u;
         cullUni.cullPassIndex = m_cullPassIndex;
-        cullUni.currentHzbLevelCount = currentHzbTextureCount;
+        cullUni.currentHzbLevelCount = currentHzbLevelCount;
+        cullUni.enableResidencyPrefetch =
+            !shadowCascade && residencyStreamingEnabled && streamingService->residencyPrefetchEnabled() &&
+                    traversesFirst
+                ? 1u
+                : 0u;
+        cullUni.allowTraversalSpill = traversalContinuationAvailable ? 1u : 0u;
+        cullUni.prefetchCameraWorldPos = m_frameContext->cameraWorldPos;
+        cullUni.visibleHistoryMode =
+            recordVisibleHistory   ? GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_RECORD
+            : replayVisibleHistory ? GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_INDEX
+                                   : GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_OFF;
+        cullUni.visibleHistoryTableMask = m_visibleHistoryTableSize - 1u;
+        cullUni.visibleHistoryCapacity = m_maxMeshlets;
+        cullUni.softwareRasterTriangleSize = m_softwareRasterTriangleSize;
+        cullUni.orthographicView = shadowCascade ? 1u : 0u;
+        cullUni.viewCount = classifyUni.viewCount;
+        cullUni.secondaryViewProj = classifyUni.secondaryViewProj;
+        cullUni.secondaryCameraWorldPos = classifyUni.secondaryCameraWorldPos;
+        const RhiBuffer* lodCutHistoryBuffer = nullptr;
+        if (clusterLodAvailable && m_enableLodCutHistory) {
+            const bool historyRecreated = ensureLodCutHistory(gpuScene.instanceCount);
+            lodCutHistoryBuffer = m_lodCutHistoryBuffer.get();
+            if (lodCutHistoryBuffer) {
+                // A camera cut or a new table starts over from a plain selection.
+                cullUni.lodCutHistoryMode = historyRecreated || m_frameContext->historyReset
+                                                ? GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_RECORD
+                                                : GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_UPDATE;
+                cullUni.lodHysteresisOctaves = m_lodHysteresisOctaves;
+            }
+        }
+        if (cullUni.enableResidencyPrefetch != 0u && !m_frameContext->historyReset &&
+            m_frameContext->deltaTime > 0.0f) {
+            const float lookaheadScale =
+                streamingService->prefetchLookaheadSeconds() / m_frameContext->deltaTime;
+            const float4 frameDelta =
+                m_frameContext->cameraWorldPos - m_frameContext->prevCameraWorldPos;
+            cullUni.prefetchCameraWorldPos.x += frameDelta.x * lookaheadScale;
+            cullUni.prefetchCameraWorldPos.y += frameDelta.y * lookaheadScale;
+            cullUni.prefetchCameraWorldPos.z += frameDelta.z * lookaheadScale;
+        }
+
+        // Dispatch 0: seed this frame's worklists on the GPU.
+        if (gpuWorklistReset) {
+            encoder.setComputePipeline(resetIt->second);
+            encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            encoder.setBuffer(traversalContinuationStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            if (!m_appendToExistingWorklist) {
+                encoder.setBuffer(worklistStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+                encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            }
+            if (recordVisibleHistory) {
+                encoder.setBuffer(visibleHistoryStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+                encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            }
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        }
+
+        const auto bindCullResources = [&]() {
+            encoder.setBytes(&cullUni, sizeof(cullUni), GpuDriven::MeshletCullBindings::kUniforms);
+            using Slot = GpuDriven::MeshletCullBindings;
+            const RhiBufferBinding cullBindings[] = {
+                {&gpuScene.instanceBuffer, 0, Slot::kInstances},
+                {&gpuScene.geometryBuffer, 0, Slot::kGeometries},
+                {&m_ctx.meshletData.boundsBuffer, 0, Slot::kBounds},
+                {visibleInstanceBuffer, 0, Slot::kVisibleInstances},
+                {visibleMeshletBuffer, 0, Slot::kCompactionOutput},
+                {worklistStateBuffer, 0, Slot::kCounter},
+                {lodNodeBuffer, 0, Slot::kLodNodes},
+                {lodGroupBuffer, 0, Slot::kLodGroups},
+                {lodGroupMeshletIndicesBuffer, 0, Slot::kLodGroupMeshletIndices},
+                {lodBoundsBuffer, 0, Slot::kLodBounds},
+                {clusterTraversalStatsBuffer, 0, Slot::kTraversalStats},
+                {groupResidencyBuffer, 0, Slot::kGroupResidency},
+                {lodGroupPageTableBuffer, 0, Slot::kLodGroupPageTable},
+                {residencyRequestBuffer, 0, Slot::kResidencyRequests},
+                {residencyRequestStateBuffer, 0, Slot::kResidencyRequestState},
+                {sourceLodGroupMeshletIndicesBuffer, 0, Slot::kLodGroupMeshletIndicesSource},
+                {groupAgeBuffer, 0, Slot::kGroupAge},
+                {traversalContinuationBuffer, 0, Slot::kTraversalContinuations},
+                {traversalContinuationStateBuffer, 0, Slot::kTraversalContinuationState},
+                {visibleHistoryActive ? visibleHistoryBuffer : dummyVisibleHistoryBuffer, 0, Slot::kVisibleHistory},
+                {visibleHistoryActive ? visibleHistoryStateBuffer : dummyResidencyRequestStateBuffer,
+                 0,
+                 Slot::kVisibleHistoryState},
+                {visibleHistoryActive ? visibleHistoryTableBuffer : dummyGroupAgeBuffer, 0, Slot::kVisibleHistoryTable},
+                {&m_ctx.meshletData.materialIDs, 0, Slot::kMeshletMaterialIds},
+                {lodMaterialIdsBuffer, 0, Slot::kLodMaterialIds},
+                {&m_ctx.materials.materialBuffer, 0, Slot::kMaterials},
+                {lodCutHistoryBuffer ? lodCutHistoryBuffer : dummyGroupAgeBuffer, 0, Slot::kLodCutHistory},
+            };
+            encoder.setBuffers(cullBindings, static_cast<uint32_t>(std::size(cullBindings)));
+            if (debugMessageBuffer) {
+                encoder.setBuffer(debugMessageBuffer, 0, Slot::kDebugMessages);
+            }
+            if (hzbLevelCount > 0) {
+                encoder.setTexture(hzbTexture, GpuDriven::MeshletCullBindings::kHzbTexture);
+            }
+            if (currentHzbLevelCount > 0) {
+                encoder.setTexture(currentHzbTexture, GpuDriven::MeshletCullBindings::kCurrentHzbTexture);
+            } else if (hzbLevelCount > 0) {
+                encoder.setTexture(hzbTexture, GpuDriven::MeshletCullBindings::kCurrentHzbTexture);
+            }
+        };
+
+        // First pass with a visible-meshlet history: clear the lookup table, then redraw
+        // last frame's list in place of classification and traversal. Without a valid
+        // history it culls as usual and indexes what it emits into the table instead.
+        if (replayVisibleHistory) {
+            encoder.setComputePipeline(historyClearIt->second);
+            bindCullResources();
+            encoder.dispatchThreadgroups({(m_visibleHistoryTableSize + 63u) / 64u, 1, 1}, {64, 1, 1});
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        }
+        if (replayVisibleHistory && visibleHistoryValid) {
+            encoder.setComputePipeline(historyReplayIt->second);
+            encoder.dispatchThreadgroupsIndirect(*visibleHistoryStateBuffer,
+                                                 GpuDriven::ComputeDispatchCommandLayout::kIndirectArgsOffset,
+                                                 {64, 1, 1});
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+            encoder.setComputePipeline(buildIt->second);
+            encoder.setBuffer(worklistStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+            return;
+        }
 
-        // Dispatch 1: coarse instance classification from scene tables.
-        encoder.setComputePipeline(classifyIt->second);
+        // Dispatch 1: coarse instance classification from scene tables, either through
+        // the instance BVH (one group per subtree) or one thread per instance.
+        const bool useInstanceBvh =
+            m_enableInstanceBvh &&
+            bvhCullIt != m_runtimeContext->computePipelinesRhi.end() && bvhCullIt->second.nativeHandle() &&
+            gpuScene.instanceBvhNodeBuffer.nativeHandle() &&
+            gpuScene.instanceBvhInstanceBuffer.nativeHandle() &&
+            gpuScene.instanceBvhSubtreeRootBuffer.nativeHandle() &&
+            !gpuScene.instanceBvhSubtreeRoots.empty();
+        constexpr uint32_t kClassifyThreadgroupSize = 64u;
+        const uint32_t classifyThreadgroups =
+            useInstanceBvh ? static_cast<uint32_t>(gpuScene.instanceBvhSubtreeRoots.size())
+                           : (gpuScene.instanceCount + kClassifyThreadgroupSize - 1u) / kClassifyThreadgroupSize;
+        // The last classify group publishes the cull's dispatch args; an empty dispatch
+        // has no last group, so it keeps the separate publish.
+        classifyUni.publishGroupCount = classifyThreadgroups;
+        encoder.setComputePipeline(useInstanceBvh ? bvhCullIt->second : classifyIt->second);
         encoder.setBytes(&classifyUni, sizeof(classifyUni), GpuDriven::InstanceClassifyBindings::kUniforms);
-        encoder.setBuffer(&gpuScene.instanceBuffer, 0, GpuDriven::InstanceClassifyBindings::kInstances);
-        encoder.setBuffer(&gpuScene.geometryBuffer, 0, GpuDriven::InstanceClassifyBindings::kGeometries);
+        encoder.setBuffer(&gpuScene.instanceCullBuffer, 0, GpuDriven::InstanceClassifyBindings::kInstanceCull);
         encoder.setBuffer(visibleInstanceBuffer, 0, GpuDriven::InstanceClassifyBindings::kOutput);
         encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::InstanceClassifyBindings::kState);
-        if (classifyHzbTextureCount > 0) {
-            encoder.setTextures(classifyHzbTextures,
-                                GpuDriven::InstanceClassifyBindings::kHzbTextureBase,
-                                classifyHzbTextureCount);
+        if (classifyHzbLevelCount > 0) {
+            encoder.setTexture(classifyHzbTexture, GpuDriven::InstanceClassifyBindings::kHzbTexture);
         }
-        constexpr uint32_t kClassifyThreadgroupSize = 64u;
-        const uint32_t classifyThreadgroups =
-            (gpuScene.instanceCount + kClassifyThreadgroupSize - 1u) / kClassifyThreadgroupSize;
+        if (useInstanceBvh) {
+            encoder.setBuffer(&gpuScene.instanceBvhNodeBuffer, 0, GpuDriven::InstanceClassifyBindings::kBvhNodes);
+            encoder.setBuffer(&gpuScene.instanceBvhInstanceBuffer, 0,
+                              GpuDriven::InstanceClassifyBindings::kBvhInstances);
+            encoder.setBuffer(&gpuScene.instanceBvhSubtreeRootBuffer, 0,
+                              GpuDriven::InstanceClassifyBindings::kBvhSubtreeRoots);
+        }
+        m_instanceBvhActive = useInstanceBvh;
         encoder.dispatchThreadgroups({classifyThreadgroups, 1, 1}, {kClassifyThreadgroupSize, 1, 1});
         encoder.memoryBarrier(RhiBarrierScope::Buffers);
 
-        // Dispatch 2: publish indirect compute args from visible-instance count.
-        encoder.setComputePipeline(buildIt->second);
-        encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
-        encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
-        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        // Dispatch 2: publish indirect compute args from visible-instance count, only
+        // when classification had no group to do it.
+        if (classifyThreadgroups == 0u) {
+            encoder.setComputePipeline(buildIt->second);
+            encoder.setBuffer(visibleInstanceStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        }
 
-        // Dispatch 3: expand visible instances into visible meshlets.
-        encoder.setComputePipeline(cullIt->second);
-        encoder.setBytes(&cullUni, sizeof(cullUni), GpuDriven::MeshletCullBindings::kUniforms);
-        encoder.setBuffer(&gpuScene.instanceBuffer, 0, GpuDriven::MeshletCullBindings::kInstances);
-        encoder.setBuffer(&gpuScene.geometryBuffer, 0, GpuDriven::MeshletCullBindings::kGeometries);
-        encoder.setBuffer(&m_ctx.meshletData.boundsBuffer, 0, GpuDriven::MeshletCullBindings::kBounds);
-        encoder.setBuffer(visibleInstanceBuffer, 0, GpuDriven::MeshletCullBindings::kVisibleInstances);
-        encoder.setBuffer(visibleMeshletBuffer, 0, GpuDriven::MeshletCullBindings::kCompactionOutput);
-        encoder.setBuffer(worklistStateBuffer, 0, GpuDriven::MeshletCullBindings::kCounter);
-        encoder.setBuffer(lodNodeBuffer, 0, GpuDriven::MeshletCullBindings::kLodNodes);
-        encoder.setBuffer(lodGroupBuffer, 0, GpuDriven::MeshletCullBindings::kLodGroups);
-        encoder.setBuffer(lodGroupMeshletIndicesBuffer, 0, GpuDriven::MeshletCullBindings::kLodGroupMeshletIndices);
-        encoder.setBuffer(lodBoundsBuffer, 0, GpuDriven::MeshletCullBindings::kLodBounds);
-        encoder.setBuffer(clusterTraversalStatsBuffer, 0, GpuDriven::MeshletCullBindings::kTraversalStats);
-        encoder.setBuffer(groupResidencyBuffer, 0, GpuDriven::MeshletCullBindings::kGroupResidency);
-        encoder.setBuffer(lodGroupPageTableBuffer, 0, GpuDriven::MeshletCullBindings::kLodGroupPageTable);
-        encoder.setBuffer(residencyRequestBuffer, 0, GpuDriven::MeshletCullBindings::kResidencyRequests);
-        encoder.setBuffer(residencyRequestStateBuffer, 0, GpuDriven::MeshletCullBindings::kResidencyRequestState);
-        encoder.setBuffer(sourceLodGroupMeshletIndicesBuffer,
-                          0,
-                          GpuDriven::MeshletCullBindings::kLodGroupMeshletIndicesSource);
-        encoder.setBuffer(groupAgeBuffer, 0, GpuDriven::MeshletCullBindings::kGroupAge);
-        if (hzbTextureCount > 0) {
-            encoder.setTextures(hzbTextures.data(),
-                                GpuDriven::MeshletCullBindings::kHzbTextureBase,
-                                hzbTextureCount);
-        }
-        if (currentHzbTextureCount > 0) {
-            encoder.setTextures(currentHzbTextures.data(),
-                                GpuDriven::MeshletCullBindings::kCurrentHzbTextureBase,
-                                currentHzbTextureCount);
-        } else if (hzbTextureCount > 0) {
-            encoder.setTextures(hzbTextures.data(),
-                                GpuDriven::MeshletCullBindings::kCurrentHzbTextureBase,
-                                hzbTextureCount);
+        // Dispatch 3: expand visible instances into visible meshlets. The specialized
+        // kernel bakes this frame's switches in; until it is built the generic one runs.
+        const RhiComputePipelineHandle* cullPipeline = &cullIt->second;
+        if (m_useCullPermutations) {
+            const uint32_t permutationMask =
+                (cullUni.enableFrustumCull != 0u ? 1u << 0 : 0u) |
+                (cullUni.enableConeCull != 0u ? 1u << 1 : 0u) |
+                (cullUni.enableOcclusionCull != 0u ? 1u << 2 : 0u) |
+                (cullUni.clusterLodEnabled != 0u ? 1u << 3 : 0u) |
+                (cullUni.enableResidencyStreaming != 0u ? 1u << 4 : 0u);
+            cullPipeline = m_runtimeContext->findComputePermutation(
+                "MeshletCullPass", meshletCullPermutationDefines(permutationMask));
+            m_cullPermutationActive = cullPipeline != &cullIt->second;
         }
+        encoder.setComputePipeline(*cullPipeline);
+        bindCullResources();
         encoder.dispatchThreadgroupsIndirect(*visibleInstanceStateBuffer,
                                              GpuDriven::ComputeDispatchCommandLayout::kIndirectArgsOffset,
                                              {64, 1, 1});
         encoder.memoryBarrier(RhiBarrierScope::Buffers);
 
+        // Dispatch 3b: finish subtrees that overflowed a threadgroup's traversal queue.
+        // Each round opens the nodes spilled by the previous one; the last round counts
+        // further overflow as dropped instead of spilling again.
+        if (traversalContinuationAvailable) {
+            for (uint32_t round = 0; round < GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_ROUNDS; ++round) {
+                encoder.setComputePipeline(continuationPublishIt->second);
+                encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+                encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+                cullUni.allowTraversalSpill =
+                    round + 1u < GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_ROUNDS ? 1u : 0u;
+                encoder.setComputePipeline(continuationIt->second);
+                encoder.setBytes(&cullUni, sizeof(cullUni), GpuDriven::MeshletCullBindings::kUniforms);
+                encoder.dispatchThreadgroupsIndirect(
+                    *traversalContinuationStateBuffer,
+                    GpuDriven::ComputeDispatchCommandLayout::kIndirectArgsOffset,
+                    {64, 1, 1});
+                encoder.memoryBarrier(RhiBarrierScope::Buffers);
+            }
+        }
+
+        // Dispatch 3c: hand everything found visible this frame to the next frame's replay.
+        if (recordVisibleHistory) {
+            encoder.setComputePipeline(historyPublishIt->second);
+            encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+            encoder.memoryBarrier(RhiBarrierScope::Buffers);
+            m_frameGraph->commitHistory(m_visibleHistory);
+            m_frameGraph->commitHistory(m_visibleHistoryState);
+        }
+
         // Dispatch 4: publish mesh-dispatch args from the visible meshlet cursor.
         encoder.setComputePipeline(buildIt->second);
         encoder.setBuffer(worklistStateBuffer, 0, GpuDriven::BuildWorklistBindings::kState);
         encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
         encoder.memoryBarrier(RhiBarrierScope::Buffers);
 
+#ifdef _WIN32
+        scheduleTraversalStatsReadback(encoder, clusterTraversalStatsBuffer);
+        scheduleWorklistCountReadback(encoder, visibleInstanceStateBuffer, worklistStateBuffer);
+        scheduleDebugMessageReadback(encoder, debugMessageBuffer);
+#endif
+
         static bool sLoggedGpuPublish = false;
         if (!sLoggedGpuPublish) {
             spdlog::info(
@@ -536,11 +862,19 @@ public:
     }
 
     void renderUI() override {
+        if (m_shadowCascade >= 0) {
+            ImGui::Text("View: Shadow Cascade %d (%s)", m_shadowCascade,
+                        m_shadowCascadeCached ? "cached" : "redrawn");
+        }
         ImGui::Text("Classified Instances: %u", m_lastVisibleInstanceCount);
         ImGui::Text("Total Meshlets: %u", m_totalMeshlets);
         ImGui::Text("Visible Meshlets: %u", m_lastVisibleCount);
+#ifdef _WIN32
+        ImGui::Text("Indirect Mesh Groups: %u", m_lastIndirectMeshGroupCount);
+#endif
         ImGui::Text("Cull Pass: %u", m_cullPassIndex);
         ImGui::Text("Append Worklist: %s", m_appendToExistingWorklist ? "Yes" : "No");
+        ImGui::Text("Visible History: %s", m_visibleHistoryMode);
         ImGui::Text("LOD Traversal Instances: %u", m_lastTraversalStats.lodTraversalInstanceCount);
         ImGui::Text("Fallback Instances: %u", m_lastTraversalStats.fallbackInstanceCount);
         ImGui::Text("Traversed Nodes: %u", m_lastTraversalStats.traversedNodeCount);
@@ -553,6 +887,9 @@ public:
         ImGui::Text("Candidate Fallback Meshlets: %u", m_lastTraversalStats.candidateFallbackMeshletCount);
         ImGui::Text("Fallback Meshlets: %u", m_lastTraversalStats.emittedFallbackMeshletCount);
         ImGui::Text("Max Selected LOD: %u", m_lastTraversalStats.maxSelectedLodLevel);
+        ImGui::Text("Spilled / Dropped Nodes: %u / %u",
+                    m_lastTraversalStats.spilledNodeCount,
+                    m_lastTraversalStats.droppedNodeCount);
         if (m_ctx.gpuScene.instanceCount > 0) {
             float coarseCullRate =
                 1.0f - float(m_lastVisibleInstanceCount) / float(m_ctx.gpuScene.instanceCount);
@@ -593,9 +930,27 @@ public:
             syncFrameContextFlags();
         }
         ImGui::Checkbox("HZB Occlusion Cull", &m_enableOcclusionCull);
+        ImGui::Checkbox("Instance BVH Cull", &m_enableInstanceBvh);
+        ImGui::Checkbox("Specialized Cull Kernel", &m_useCullPermutations);
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%s)", m_useCullPermutations && m_cullPermutationActive ? "active" : "generic");
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%s, %zu subtrees)",
+                            m_instanceBvhActive ? "active" : "inactive",
+                            m_ctx.gpuScene.instanceBvhSubtreeRoots.size());
         ImGui::SliderFloat("HZB Depth Bias", &m_occlusionDepthBias, 0.0f, 0.05f, "%.4f");
         ImGui::SliderFloat("HZB Bounds Scale", &m_occlusionBoundsScale, 1.0f, 1.5f, "%.2f");
-        ImGui::SliderFloat("LOD Reference Pixels", &m_lodReferencePixels, 8.0f, 256.0f, "%.1f");
+        if (m_runtimeContext && m_runtimeContext->lodBudget && m_shadowCascade < 0) {
+            ImGui::Text("LOD Reference Pixels: %.1f (budget)", m_runtimeContext->lodBudget->referencePixels());
+        } else {
+            ImGui::SliderFloat("LOD Reference Pixels", &m_lodReferencePixels, 8.0f, 256.0f, "%.1f");
+        }
+        ImGui::Checkbox("LOD Cut History", &m_enableLodCutHistory);
+        if (m_enableLodCutHistory) {
+            ImGui::SliderFloat("LOD Hysteresis", &m_lodHysteresisOctaves, 0.0f, 0.5f, "%.2f octaves");
+        }
+        ImGui::SliderFloat("Coarsest LOD Pixel Radius", &m_coarsestLodPixelRadius, 0.0f, 16.0f, "%.1f px");
+        ImGui::SliderFloat("Software Raster Triangle Size", &m_softwareRasterTriangleSize, 0.0f, 4.0f, "%.2f px");
         ClusterStreamingService* streamingService =
             m_runtimeContext ? m_runtimeContext->clusterStreamingService : nullptr;
         const ClusterStreamingService::DebugStats* streamingStats =
@@ -635,7 +990,7 @@ public:
         const uint32_t alwaysResidentGroupCount =
             streamingStats ? streamingStats->lastAlwaysResidentGroupCount : 0u;
         const uint64_t sceneStorageBytes =
-            uint64_t(std::max<size_t>(1u, m_ctx.clusterLodData.groupMeshletIndices.size())) *
+            uint64_t(std::max<uint32_t>(1u, m_ctx.clusterLodData.groupMeshletIndexCount)) *
             sizeof(uint32_t);
         const uint64_t sceneStorageKb =
             std::max<uint64_t>(1ull, (sceneStorageBytes + 1023ull) / 1024ull);
@@ -741,6 +1096,27 @@ public:
             streamingService) {
             streamingService->setCompactAgeFilterDispatchEnabled(compactAgeFilterDispatch);
         }
+        bool compactRequestReadback =
+            streamingService ? streamingService->compactRequestReadbackEnabled() : true;
+        if (ImGui::Checkbox("Compact GPU Request Readback", &compactRequestReadback) &&
+            streamingService) {
+            streamingService->setCompactRequestReadbackEnabled(compactRequestReadback);
+        }
+        bool residencyPrefetch =
+            streamingService ? streamingService->residencyPrefetchEnabled() : true;
+        if (ImGui::Checkbox("Residency Prefetch", &residencyPrefetch) && streamingService) {
+            streamingService->setResidencyPrefetchEnabled(residencyPrefetch);
+        }
+        float prefetchLookaheadSeconds =
+            streamingService ? streamingService->prefetchLookaheadSeconds() : 0.25f;
+        if (ImGui::SliderFloat("Prefetch Lookahead (s)",
+                               &prefetchLookaheadSeconds,
+                               0.0f,
+                               2.0f,
+                               "%.2f") &&
+            streamingService) {
+            streamingService->setPrefetchLookaheadSeconds(prefetchLookaheadSeconds);
+        }
         if (ImGui::Button("Reset Residency State") && streamingService) {
             streamingService->markStateDirty();
             requestVisibilityHistoryReset();
@@ -774,6 +1150,16 @@ public:
                     streamingStats ? streamingStats->pendingResidencyGroupCount : 0u);
         ImGui::Text("GPU Residency Requests (last frame): %u",
                     streamingStats ? streamingStats->lastResidencyRequestCount : 0u);
+        ImGui::Text("Compact Requests Read (last frame): %u%s",
+                    streamingStats ? streamingStats->lastCompactRequestReadCount : 0u,
+                    streamingStats && streamingStats->compactRequestReadbackActive
+                        ? ""
+                        : " (full readback)");
+        ImGui::Text("Prefetch Requested / Promoted (last frame): %u / %u",
+                    streamingStats ? streamingStats->lastPrefetchRequestCount : 0u,
+                    streamingStats ? streamingStats->lastPrefetchPromotedCount : 0u);
+        ImGui::Text("Expired Pending Requests (last frame): %u",
+                    streamingStats ? streamingStats->lastExpiredPendingCount : 0u);
         ImGui::Text("GPU Unload Requests (last frame): %u",
                     streamingStats ? streamingStats->lastUnloadRequestCount : 0u);
         ImGui::Text("Promoted / Evicted (last frame): %u / %u",
@@ -788,7 +1174,7 @@ public:
         ImGui::Text("Unload Age Threshold: %u",
                     streamingStats ? streamingStats->ageThreshold : 0u);
         const bool historyValid =
-            m_frameGraph && !m_hzbHistoryRead.empty() && m_frameGraph->isHistoryValid(m_hzbHistoryRead[0]);
+            m_frameGraph && m_hzbHistoryRead.isValid() && m_frameGraph->isHistoryValid(m_hzbHistoryRead);
         ImGui::Text("HZB History: %s (%u levels)", historyValid ? "Ready" : "Warming Up", m_hzbLevelCount);
         ImGui::Text("Current HZB Inputs: %u levels", m_currentHzbLevelCount);
         for (uint32_t level = 0; level < kClusterTraversalStatsHistogramSize; ++level) {
@@ -798,7 +1184,8 @@ public:
 
 private:
     void syncFrameContextFlags() {
-        if (!m_frameContext) {
+        // The camera passes own the UI cull flags; shadow views always frustum cull.
+        if (!m_frameContext || m_shadowCascade >= 0) {
             return;
         }
         auto* frameContext = const_cast<FrameContext*>(m_frameContext);
@@ -823,19 +1210,39 @@ private:
     uint32_t m_totalMeshlets = 0;
     uint32_t m_lastVisibleInstanceCount = 0;
     uint32_t m_lastVisibleCount = 0;
+    uint32_t m_lastIndirectMeshGroupCount = 0;
     ClusterTraversalStats m_lastTraversalStats{};
     uint32_t m_hzbLevelCount = 0;
     uint32_t m_currentHzbLevelCount = 0;
     uint32_t m_cullPassIndex = 0;
     bool m_appendToExistingWorklist = false;
+    bool m_enableVisibleHistory = true;
+    uint32_t m_visibleHistoryTableSize = 1;
+    const char* m_visibleHistoryMode = "Off";
     bool m_enableFrustumCull = false;
     bool m_enableConeCull = false;
     bool m_enableOcclusionCull = true;
+    bool m_enableInstanceBvh = true;
+    bool m_instanceBvhActive = false;
+    bool m_useCullPermutations = true;
+    bool m_cullPermutationActive = false;
+    int m_shadowCascade = -1;
+    bool m_shadowCascadeCached = false;
     float m_lodReferencePixels = 96.0f;
+    float m_coarsestLodPixelRadius = 4.0f;
+    bool m_enableLodCutHistory = true;
+    float m_lodHysteresisOctaves = 0.2f;
+    // Last selected LOD level plus one per scene instance; 0 means none yet.
+    std::unique_ptr<RhiBuffer> m_lodCutHistoryBuffer;
+    uint32_t m_lodCutHistoryCapacity = 0;
     float m_occlusionDepthBias = 0.0015f;
     float m_occlusionBoundsScale = 1.1f;
+    float m_softwareRasterTriangleSize = 1.0f;
     FGResource m_visibleInstanceState;
     FGResource m_clusterTraversalStats;
+    FGResource m_debugMessages;
+    FGResource m_traversalContinuations;
+    FGResource m_traversalContinuationState;
     FGResource m_dummyLodNodes;
     FGResource m_dummyLodGroups;
     FGResource m_dummyLodGroupMeshletIndices;
@@ -845,20 +1252,33 @@ private:
     FGResource m_dummyResidencyRequests;
     FGResource m_dummyResidencyRequestState;
     FGResource m_dummyGroupAge;
-    std::vector<FGResource> m_hzbHistoryRead;
-    std::vector<FGResource> m_currentHzbRead;
+    FGResource m_hzbHistoryRead;
+    FGResource m_currentHzbRead;
+    FGResource m_visibleHistory;
+    FGResource m_visibleHistoryState;
+    FGResource m_visibleHistoryTable;
+    FGResource m_dummyVisibleHistory;
 
     uint32_t computeMaxMeshletCapacity() const {
         return std::max(1u, m_ctx.gpuScene.totalMeshletDispatchCount);
     }
 
+    // Power of two at least twice the replay capacity, keeping linear probes short.
+    uint32_t visibleHistoryTableSize() const {
+        uint32_t size = 64u;
+        while (size < 2u * m_maxMeshlets && size < (1u << 31)) {
+            size <<= 1u;
+        }
+        return size;
+    }
+
     template <typename T>
     FGBufferDesc makeSingleElementBufferDesc(const char* debugName) const {
         static const T kZero{};
         FGBufferDesc desc;
         desc.size = sizeof(T);
         desc.initialData = &kZero;
-        desc.hostVisible = false;
+        desc.memory = RhiBufferMemory::DeviceLocal;
         desc.debugName = debugName;
         return desc;
     }
@@ -869,7 +1289,7 @@ private:
         FGBufferDesc desc;
         desc.size = sizeof(T);
         desc.initialData = &kValue;
-        desc.hostVisible = false;
+        desc.memory = RhiBufferMemory::DeviceLocal;
         desc.debugName = debugName;
         return desc;
     }
@@ -879,11 +1299,125 @@ private:
         FGBufferDesc desc;
         desc.size = sizeof(ClusterTraversalStats);
         desc.initialData = &kZeroStats;
-        desc.hostVisible = true;
+        desc.memory = RhiBufferMemory::Upload;
         desc.debugName = "ClusterTraversalStats";
         return desc;
     }
 
+    // Sizes the LOD cut history to the scene; returns true when the table is new and
+    // holds no selections yet.
+    bool ensureLodCutHistory(uint32_t instanceCount) {
+        const uint32_t capacity = std::max(1u, instanceCount);
+        if (m_lodCutHistoryBuffer && m_lodCutHistoryCapacity == capacity) {
+            return false;
+        }
+        RhiFrameGraphBackend* factory = m_runtimeContext->resourceFactory;
+        if (!factory) {
+            return false;
+        }
+        RhiBufferDesc desc;
+        desc.size = uint64_t(capacity) * sizeof(uint32_t);
+        desc.memory = RhiBufferMemory::DeviceLocal;
+        desc.debugName = "LodCutHistory";
+        if (m_lodCutHistoryBuffer) {
+            RhiBufferDesc oldDesc = desc;
+            oldDesc.size = uint64_t(m_lodCutHistoryCapacity) * sizeof(uint32_t);
+            factory->recycleBuffer(std::move(m_lodCutHistoryBuffer), oldDesc);
+        }
+        m_lodCutHistoryBuffer = factory->createBuffer(desc);
+        m_lodCutHistoryCapacity = m_lodCutHistoryBuffer ? capacity : 0u;
+        return true;
+    }
+
+#ifdef _WIN32
+    // Traversal counters for the UI and, for the main view, GpuDrivenTelemetry: copied
+    // after the last dispatch and resolved once the frame's fence has signaled, so the
+    // CPU never reads the stats buffer while a frame in flight may still write it.
+    void scheduleTraversalStatsReadback(RhiComputeCommandEncoder& encoder, const RhiBuffer* statsBuffer) {
+        if (!m_runtimeContext || !m_runtimeContext->readbackService) {
+            return;
+        }
+        const bool telemetry = m_shadowCascade < 0;
+        scheduleComputeReadback(encoder, statsBuffer, sizeof(ClusterTraversalStats),
+            [this, telemetry](const void* data, VkDeviceSize) {
+                std::memcpy(&m_lastTraversalStats, data, sizeof(m_lastTraversalStats));
+                if (telemetry && m_runtimeContext->gpuDrivenTelemetry) {
+                    m_runtimeContext->gpuDrivenTelemetry->recordCullPass(
+                        m_cullPassIndex, m_ctx.gpuScene.instanceCount, m_lastTraversalStats);
+                }
+            });
+    }
+
+    // Classified instances, visible meshlets and the mesh-dispatch groups built for
+    // the raster. The state buffers are reseeded every frame, so the host only sees
+    // them through a copy taken after Dispatch 4.
+    void scheduleWorklistCountReadback(RhiComputeCommandEncoder& encoder,
+                                       const RhiBuffer* visibleInstanceStateBuffer,
+                                       const RhiBuffer* worklistStateBuffer) {
+        if (!m_runtimeContext || !m_runtimeContext->readbackService) {
+            return;
+        }
+        scheduleComputeReadback(encoder, visibleInstanceStateBuffer,
+                                GpuDriven::ComputeDispatchCommandLayout::kBufferSize,
+            [this](const void* data, VkDeviceSize) {
+                const auto* words = static_cast<const uint32_t*>(data);
+                m_lastVisibleInstanceCount =
+                    words[GpuDriven::ComputeDispatchCommandLayout::kProducedCountWord];
+            });
+        scheduleComputeReadback(encoder, worklistStateBuffer,
+                                GpuDriven::MeshDispatchCommandLayout::kBufferSize,
+            [this](const void* data, VkDeviceSize) {
+                const auto* words = static_cast<const uint32_t*>(data);
+                m_lastVisibleCount = words[GpuDriven::MeshDispatchCommandLayout::kProducedCountWord];
+                m_lastIndirectMeshGroupCount = words[GpuDriven::MeshDispatchCommandLayout::kDispatchXWord];
+            });
+    }
+
+    // Every view drains its own ring, cascades included, since a cascade cull hits
+    // the same traversal and streaming paths.
+    void scheduleDebugMessageReadback(RhiComputeCommandEncoder& encoder, const RhiBuffer* messageBuffer) {
+        if (!messageBuffer || !m_runtimeContext || !m_runtimeContext->readbackService) {
+            return;
+        }
+        scheduleComputeReadback(encoder, messageBuffer, kGpuDebugMessageWordCount * sizeof(uint32_t),
+            [this](const void* data, VkDeviceSize) {
+                logGpuDebugMessages(m_name.c_str(), static_cast<const uint32_t*>(data));
+            });
+    }
+
+    // Copies size bytes of a buffer the cull dispatches wrote into the readback heap
+    // and hands them to onReady from VulkanReadbackService::beginFrame().
+    void scheduleComputeReadback(RhiComputeCommandEncoder& encoder,
+                                 const RhiBuffer* buffer,
+                                 VkDeviceSize size,
+                                 VulkanReadbackService::ReadbackCallback onReady) {
+        const VkBuffer vkBuffer = getVulkanBufferHandle(buffer);
+        const VkCommandBuffer commandBuffer = static_cast<VkCommandBuffer>(encoder.nativeHandle());
+        if (vkBuffer == VK_NULL_HANDLE || commandBuffer == VK_NULL_HANDLE) {
+            return;
+        }
+
+        VkBufferMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2};
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = vkBuffer;
+        barrier.offset = 0u;
+        barrier.size = size;
+
+        VkDependencyInfo dependencyInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dependencyInfo.bufferMemoryBarrierCount = 1;
+        dependencyInfo.pBufferMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+        VulkanReadbackService* readbackService = m_runtimeContext->readbackService;
+        readbackService->requestBufferReadback(vkBuffer, 0u, size, this, std::move(onReady));
+        readbackService->recordPendingReadbacks(commandBuffer);
+    }
+#else
     ClusterTraversalStats readTraversalStats(RhiBuffer* buffer) const {
         ClusterTraversalStats stats{};
         if (!buffer || !buffer->mappedData() || buffer->size() < sizeof(ClusterTraversalStats)) {
@@ -893,10 +1427,7 @@ private:
         std::memcpy(&stats, buffer->mappedData(), sizeof(stats));
         return stats;
     }
-
-    static std::string currentHzbInputSlotName(uint32_t level) {
-        return "currentHzb" + std::to_string(level);
-    }
+#endif
 };
 
 METALLIC_REGISTER_PASS(MeshletCullPass);
@@ -36,6 +36,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         FGResource visInput = getInput("visibility");
         if (visInput.isValid()) m_visRead = builder.read(visInput);
 
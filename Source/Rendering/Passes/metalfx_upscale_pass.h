@@ -0,0 +1,211 @@
+#pragma once
+
+#ifdef __APPLE__
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "metalfx_context.h"
+#include "imgui.h"
+
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
+
+// Metal-only MetalFX temporal upscaling pass, the macOS counterpart of StreamlineDlssPass.
+// When MetalFX is active, it reads render-resolution inputs and writes a display-resolution
+// "upscaledOutput". When MetalFX is unavailable or off, it aliases its source input so the
+// graph can keep running without a topology rewrite.
+//
+class MetalFXUpscalePass : public RenderPass {
+public:
+    MetalFXUpscalePass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_renderWidth(w), m_renderHeight(h),
+          m_displayWidth(w), m_displayHeight(h) {}
+
+    ~MetalFXUpscalePass() override = default;
+
+    METALLIC_PASS_TYPE_INFO(MetalFXUpscalePass, "MetalFX Upscale", "Post-Process",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("source", "Source"),
+            makeInputSlot("depth", "Depth", true),
+            makeInputSlot("motionVectors", "Motion Vectors", true)
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("upscaledOutput", "Upscaled Output")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    FGResource getOutput(const std::string& outputName) const override {
+        if (outputName == "upscaledOutput") return m_upscaledOutput;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_sourceRead = FGResource{};
+        m_depthRead = FGResource{};
+        m_motionRead = FGResource{};
+        m_upscaledOutput = FGResource{};
+        m_passthrough = false;
+
+        FGResource sourceInput = getInput("source");
+        FGResource depthInput = getInput("depth");
+        FGResource motionInput = getInput("motionVectors");
+        if ((!shouldEvaluate() || !depthInput.isValid() || !motionInput.isValid()) &&
+            sourceInput.isValid()) {
+            m_sourceRead = sourceInput;
+            m_upscaledOutput = sourceInput;
+            m_passthrough = true;
+            return;
+        }
+        if (sourceInput.isValid()) {
+            m_sourceRead = builder.read(sourceInput);
+        }
+        if (depthInput.isValid()) {
+            m_depthRead = builder.read(depthInput);
+        }
+        if (motionInput.isValid()) {
+            m_motionRead = builder.read(motionInput);
+        }
+
+        // MetalFX writes its output as a render target on some GPUs.
+        FGTextureDesc outputDesc = FGTextureDesc::storageTexture(currentDisplayWidth(),
+                                                                 currentDisplayHeight(),
+                                                                 RhiFormat::RGBA16Float);
+        outputDesc.usage |= RhiTextureUsage::RenderTarget;
+        m_upscaledOutput = builder.create("upscaledOutput", outputDesc);
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("MetalFXUpscalePass");
+        MICROPROFILE_SCOPEI("RenderPass", "MetalFXUpscalePass", 0xff00ff00);
+        if (!m_frameContext || m_passthrough) return;
+
+        IUpscalerIntegration* upscaler = currentUpscaler();
+        RhiTexture* colorTex = m_sourceRead.isValid() ? m_frameGraph->getTexture(m_sourceRead) : nullptr;
+        RhiTexture* depthTex = m_depthRead.isValid() ? m_frameGraph->getTexture(m_depthRead) : nullptr;
+        RhiTexture* motionTex = m_motionRead.isValid() ? m_frameGraph->getTexture(m_motionRead) : nullptr;
+        RhiTexture* outputTex = m_frameGraph->getTexture(m_upscaledOutput);
+        if (!upscaler || !colorTex || !depthTex || !motionTex || !outputTex) {
+            spdlog::warn("MetalFXUpscalePass: missing input textures");
+            return;
+        }
+
+        UpscalerEvaluateInputs inputs{};
+        inputs.colorInput = colorTex;
+        inputs.depth = depthTex;
+        inputs.motionVectors = motionTex;
+        inputs.colorOutput = outputTex;
+        inputs.renderWidth = static_cast<uint32_t>(currentRenderWidth());
+        inputs.renderHeight = static_cast<uint32_t>(currentRenderHeight());
+        inputs.displayWidth = static_cast<uint32_t>(currentDisplayWidth());
+        inputs.displayHeight = static_cast<uint32_t>(currentDisplayHeight());
+        inputs.jitterOffsetX = m_frameContext->jitterOffset.x;
+        inputs.jitterOffsetY = m_frameContext->jitterOffset.y;
+        inputs.mvecScaleX = static_cast<float>(currentRenderWidth());
+        inputs.mvecScaleY = static_cast<float>(currentRenderHeight());
+        inputs.depthInverted = (m_frameContext->depthClearValue == 0.0);
+        inputs.reset = m_frameContext->historyReset;
+        inputs.cameraNear = m_frameContext->cameraNearZ;
+        inputs.cameraFar = m_frameContext->cameraFarZ;
+        inputs.cameraFov = m_frameContext->cameraFovY;
+        inputs.cameraAspectRatio =
+            static_cast<float>(currentDisplayWidth()) / static_cast<float>(std::max(currentDisplayHeight(), 1));
+        inputs.frameIndex = m_frameContext->frameIndex;
+
+        if (!upscaler->evaluate(inputs, encoder)) {
+            spdlog::warn("MetalFXUpscalePass: evaluate failed");
+        }
+    }
+
+    void renderUI() override {
+        ImGui::Text("MetalFX Pass %d x %d -> %d x %d",
+                    currentRenderWidth(), currentRenderHeight(),
+                    currentDisplayWidth(), currentDisplayHeight());
+
+        if (auto* upscaler = currentUpscaler()) {
+            ImGui::Text("Status: %s", upscaler->statusString().c_str());
+        } else {
+            ImGui::TextUnformatted("Status: Unavailable (pass-through)");
+        }
+        ImGui::TextUnformatted(m_passthrough ? "Mode: Pass-through" : "Mode: MetalFX");
+
+        const PipelineUiControls* uiControls = m_runtimeContext ? m_runtimeContext->uiControls : nullptr;
+        if (uiControls && uiControls->onMetalFXPresetChanged) {
+            const char* presetNames[] = {
+                "Off", "Native (AA only)", "Quality", "Balanced", "Performance"
+            };
+            int presetIdx = static_cast<int>(uiControls->metalFXPreset);
+            if (ImGui::Combo("MetalFX Preset", &presetIdx, presetNames, IM_ARRAYSIZE(presetNames))) {
+                uiControls->onMetalFXPresetChanged(static_cast<MetalFXPreset>(presetIdx));
+            }
+        }
+    }
+
+private:
+    IUpscalerIntegration* currentUpscaler() const {
+        return m_runtimeContext ? m_runtimeContext->upscaler : nullptr;
+    }
+
+    bool shouldEvaluate() const {
+        IUpscalerIntegration* upscaler = currentUpscaler();
+        return upscaler && upscaler->isAvailable() && upscaler->isEnabled();
+    }
+
+    int currentRenderWidth() const {
+        if (m_frameContext && m_frameContext->renderWidth > 0) {
+            return m_frameContext->renderWidth;
+        }
+        if (m_runtimeContext && m_runtimeContext->renderWidth > 0) {
+            return m_runtimeContext->renderWidth;
+        }
+        return m_renderWidth;
+    }
+
+    int currentRenderHeight() const {
+        if (m_frameContext && m_frameContext->renderHeight > 0) {
+            return m_frameContext->renderHeight;
+        }
+        if (m_runtimeContext && m_runtimeContext->renderHeight > 0) {
+            return m_runtimeContext->renderHeight;
+        }
+        return m_renderHeight;
+    }
+
+    int currentDisplayWidth() const {
+        if (m_frameContext && m_frameContext->displayWidth > 0) {
+            return m_frameContext->displayWidth;
+        }
+        if (m_runtimeContext && m_runtimeContext->displayWidth > 0) {
+            return m_runtimeContext->displayWidth;
+        }
+        return m_displayWidth;
+    }
+
+    int currentDisplayHeight() const {
+        if (m_frameContext && m_frameContext->displayHeight > 0) {
+            return m_frameContext->displayHeight;
+        }
+        if (m_runtimeContext && m_runtimeContext->displayHeight > 0) {
+            return m_runtimeContext->displayHeight;
+        }
+        return m_displayHeight;
+    }
+
+    const RenderContext& m_ctx;
+    int m_renderWidth, m_renderHeight;
+    int m_displayWidth, m_displayHeight;
+    std::string m_name = "MetalFX Upscale";
+    bool m_passthrough = false;
+
+    FGResource m_sourceRead, m_depthRead, m_motionRead, m_upscaledOutput;
+};
+
+METALLIC_REGISTER_PASS(MetalFXUpscalePass);
+
+#endif // __APPLE__
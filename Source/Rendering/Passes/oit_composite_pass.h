@@ -0,0 +1,107 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+// Resolves TransparencyPass's accumulation and revealage targets over the lit image
+// (oit_composite.slang) into "composited". Without the pipeline or either target it
+// aliases its source input, so the pipeline falls back to the opaque image.
+class OitCompositePass : public RenderPass {
+public:
+    OitCompositePass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(OitCompositePass, "OIT Composite", "Lighting",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("source", "Source"),
+            makeInputSlot("accumulation", "Accumulation", true),
+            makeInputSlot("revealage", "Revealage", true)
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("composited", "Composited")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "composited") return m_composited;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        m_sourceRead = FGResource{};
+        m_accumulationRead = FGResource{};
+        m_revealageRead = FGResource{};
+        m_composited = FGResource{};
+        m_passthrough = false;
+
+        FGResource sourceInput = getInput("source");
+        FGResource accumulationInput = getInput("accumulation");
+        FGResource revealageInput = getInput("revealage");
+        if (!activePipeline() || !accumulationInput.isValid() || !revealageInput.isValid()) {
+            m_composited = sourceInput;
+            m_passthrough = true;
+            return;
+        }
+        if (sourceInput.isValid()) {
+            m_sourceRead = builder.read(sourceInput);
+        }
+        m_accumulationRead = builder.read(accumulationInput);
+        m_revealageRead = builder.read(revealageInput);
+        m_composited = builder.create("composited",
+            FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA16Float));
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("OitCompositePass");
+        MICROPROFILE_SCOPEI("RenderPass", "OitCompositePass", 0xffff8800);
+        const RhiComputePipeline* pipeline = activePipeline();
+        if (!pipeline || m_passthrough || !m_sourceRead.isValid()) return;
+
+        struct {
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t pad[2];
+        } uniforms{};
+        uniforms.screenWidth = static_cast<uint32_t>(m_width);
+        uniforms.screenHeight = static_cast<uint32_t>(m_height);
+
+        encoder.setComputePipeline(*pipeline);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_sourceRead), 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_accumulationRead), 1);
+        encoder.setTexture(m_frameGraph->getTexture(m_revealageRead), 2);
+        encoder.setStorageTexture(m_frameGraph->getTexture(m_composited), 3);
+        encoder.dispatchThreadgroups({(uniforms.screenWidth + 7) / 8, (uniforms.screenHeight + 7) / 8, 1},
+                                     {8, 8, 1});
+    }
+
+    void renderUI() override {
+        ImGui::TextUnformatted(m_passthrough ? "Mode: Pass-through" : "Mode: Compositing");
+    }
+
+private:
+    const RhiComputePipeline* activePipeline() const {
+        if (!m_runtimeContext) return nullptr;
+        auto it = m_runtimeContext->computePipelinesRhi.find("OitCompositePass");
+        if (it == m_runtimeContext->computePipelinesRhi.end() || !it->second.nativeHandle()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "OIT Composite";
+    bool m_passthrough = false;
+    FGResource m_sourceRead, m_accumulationRead, m_revealageRead, m_composited;
+};
+
+METALLIC_REGISTER_PASS(OitCompositePass);
@@ -5,6 +5,9 @@
 #include "pass_registry.h"
 #include "imgui.h"
 
+// Final blit to the display target. With "overlay" set it also draws the ImGui
+// draw data in the same render pass, so the UI always lands at target resolution
+// after any upscaler and never needs its own attachment load or copy.
 class OutputPass : public RenderPass {
 public:
     OutputPass(const RenderContext& ctx, int w, int h)
@@ -20,6 +23,10 @@ public:
 
     void configure(const PassConfig& config) override {
         m_name = config.name;
+        m_drawOverlay = false;
+        if (config.config.contains("overlay")) {
+            m_drawOverlay = config.config["overlay"].get<bool>();
+        }
     }
 
     FGResource getOutput(const std::string& name) const override {
@@ -28,6 +35,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         m_sourceRead = FGResource{};
         m_dest = FGResource{};
 
@@ -75,10 +83,17 @@ public:
         encoder.setFragmentTexture(sourceTex, 0);
         encoder.setFragmentSampler(&samplerIt->second, 0);
         encoder.drawPrimitives(RhiPrimitiveType::Triangle, 0, 3);
+
+        if (m_drawOverlay) {
+            encoder.renderImGuiDrawData();
+        }
+        m_lastOutputWidth = outputWidth;
+        m_lastOutputHeight = outputHeight;
     }
 
     void renderUI() override {
-        ImGui::Text("Passthrough %d x %d", m_width, m_height);
+        ImGui::Text("Passthrough %u x %u", m_lastOutputWidth, m_lastOutputHeight);
+        ImGui::TextUnformatted(m_drawOverlay ? "UI overlay: composited here" : "UI overlay: off");
     }
 
 private:
@@ -87,6 +102,9 @@ private:
     FGResource m_dest;
     int m_width, m_height;
     std::string m_name = "Output";
+    bool m_drawOverlay = false;
+    uint32_t m_lastOutputWidth = 0;
+    uint32_t m_lastOutputHeight = 0;
 };
 
 METALLIC_REGISTER_PASS(OutputPass);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "render_pass.h"
+#include "render_uniforms.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "post_lens.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+// Builds the half-resolution HDR pyramid that bloom and depth of field read, in one
+// dispatch (post_pyramid.slang, on hzb_downsample.slang's tile scheme). There is
+// no upsample pass: TonemapPass and FusedPostPass combine the levels while they
+// tonemap. Wire "pyramid" into their "postPyramid" input.
+class PostPyramidPass : public RenderPass {
+public:
+    PostPyramidPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(PostPyramidPass, "Post Pyramid", "Post-Process",
+        (std::vector<PassSlotInfo>{makeInputSlot("source", "Source")}),
+        (std::vector<PassSlotInfo>{makeOutputSlot("pyramid", "Pyramid")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        m_sourceProducerType.clear();
+        if (const auto* sourceBinding = config.findInputBinding("source")) {
+            m_sourceProducerType = sourceBinding->producerPassType;
+        }
+    }
+
+    FGResource getOutput(const std::string& outputName) const override {
+        if (outputName == "pyramid") return m_pyramid;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        m_sourceRead = FGResource{};
+
+        FGResource sourceInput = getInput("source");
+        if (sourceInput.isValid())
+            m_sourceRead = builder.read(sourceInput);
+
+        m_pyramid = builder.create("postPyramid",
+            makePostPyramidTextureDesc(static_cast<uint32_t>(currentSourceWidth()),
+                                       static_cast<uint32_t>(currentSourceHeight())));
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("PostPyramidPass");
+        MICROPROFILE_SCOPEI("RenderPass", "PostPyramidPass", 0xffff8800);
+        if (!m_runtimeContext || !m_sourceRead.isValid()) return;
+
+        auto pipeIt = m_runtimeContext->computePipelinesRhi.find("PostPyramidPass");
+        if (pipeIt == m_runtimeContext->computePipelinesRhi.end() || !pipeIt->second.nativeHandle()) return;
+
+        RhiTexture* sourceTex = m_frameGraph->getTexture(m_sourceRead);
+        RhiTexture* pyramidTex = m_frameGraph->getTexture(m_pyramid);
+        if (!sourceTex || !pyramidTex) return;
+
+        struct PostPyramidUniforms {
+            uint32_t srcWidth = 0;
+            uint32_t srcHeight = 0;
+            uint32_t levelCount = 0;
+            uint32_t _pad = 0;
+        };
+
+        const uint32_t levelCount = std::min(pyramidTex->mipLevelCount(), kPostPyramidLevels);
+        PostPyramidUniforms uniforms{};
+        // Never read past what the pyramid covers, should the source outgrow it.
+        uniforms.srcWidth = std::min(sourceTex->width(), pyramidTex->width() * 2u);
+        uniforms.srcHeight = std::min(sourceTex->height(), pyramidTex->height() * 2u);
+        uniforms.levelCount = levelCount;
+
+        encoder.setComputePipeline(pipeIt->second);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(sourceTex, 0);
+        for (uint32_t slot = 0; slot < kPostPyramidLevels; ++slot) {
+            encoder.setStorageTextureMip(pyramidTex, std::min(slot, levelCount - 1u), 1u + slot);
+        }
+        encoder.dispatchThreadgroups({pyramidTex->width() / kPostPyramidTileSize,
+                                      pyramidTex->height() / kPostPyramidTileSize,
+                                      1u},
+                                     {256u, 1u, 1u});
+        m_lastSourceWidth = uniforms.srcWidth;
+        m_lastSourceHeight = uniforms.srcHeight;
+        m_lastLevelCount = levelCount;
+    }
+
+    void renderUI() override {
+        ImGui::Text("Source: %u x %u", m_lastSourceWidth, m_lastSourceHeight);
+        ImGui::Text("Levels: %u (half to 1/%u resolution)", m_lastLevelCount,
+                    m_lastLevelCount > 0 ? 2u << (m_lastLevelCount - 1u) : 0u);
+    }
+
+private:
+    int currentSourceWidth() const {
+        const bool upscaled = m_sourceProducerType == "StreamlineDlssPass" ||
+                              m_sourceProducerType == "MetalFXUpscalePass" ||
+                              m_sourceProducerType == "TemporalUpscalePass";
+        if (m_frameContext) {
+            const int width = upscaled ? m_frameContext->displayWidth : m_frameContext->renderWidth;
+            if (width > 0) return width;
+        }
+        if (m_runtimeContext) {
+            const int width = upscaled ? m_runtimeContext->displayWidth : m_runtimeContext->renderWidth;
+            if (width > 0) return width;
+        }
+        return m_width;
+    }
+
+    int currentSourceHeight() const {
+        const bool upscaled = m_sourceProducerType == "StreamlineDlssPass" ||
+                              m_sourceProducerType == "MetalFXUpscalePass" ||
+                              m_sourceProducerType == "TemporalUpscalePass";
+        if (m_frameContext) {
+            const int height = upscaled ? m_frameContext->displayHeight : m_frameContext->renderHeight;
+            if (height > 0) return height;
+        }
+        if (m_runtimeContext) {
+            const int height = upscaled ? m_runtimeContext->displayHeight : m_runtimeContext->renderHeight;
+            if (height > 0) return height;
+        }
+        return m_height;
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Post Pyramid";
+    std::string m_sourceProducerType;
+
+    FGResource m_sourceRead, m_pyramid;
+    uint32_t m_lastSourceWidth = 0;
+    uint32_t m_lastSourceHeight = 0;
+    uint32_t m_lastLevelCount = 0;
+};
+
+METALLIC_REGISTER_PASS(PostPyramidPass);
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+// One-bounce diffuse GI and reflections traced with shadowResources.giPipeline, a
+// ray tracing pipeline whose shader binding table picks each primitive group's hit
+// shader from its material (raytraced_gi.slang). Both outputs are accumulated over
+// frames and feed DeferredLightingPass's indirect lighting inputs. Without a GI
+// pipeline (Metal, or Vulkan without VK_KHR_ray_tracing_pipeline) the pass records
+// nothing and the lighting pass ignores its outputs.
+class RaytracedGiPass : public RenderPass {
+public:
+    RaytracedGiPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(RaytracedGiPass, "Ray Traced GI", "Lighting",
+        (std::vector<PassSlotInfo>{makeInputSlot("depth", "Depth")}),
+        (std::vector<PassSlotInfo>{
+            makeOutputSlot("indirectDiffuse", "Indirect Diffuse"),
+            makeOutputSlot("reflections", "Reflections")
+        }),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.contains("normalBias")) {
+            m_normalBias = config.config["normalBias"].get<float>();
+        }
+        if (config.config.contains("maxRayDistance")) {
+            m_maxRayDistance = config.config["maxRayDistance"].get<float>();
+        }
+        if (config.config.contains("skyIntensity")) {
+            m_skyIntensity = config.config["skyIntensity"].get<float>();
+        }
+        if (config.config.contains("hitTextureLod")) {
+            m_hitTextureLod = config.config["hitTextureLod"].get<float>();
+        }
+        if (config.config.contains("maxHistoryLength")) {
+            m_maxHistoryLength = config.config["maxHistoryLength"].get<float>();
+        }
+    }
+
+    FGResource indirectDiffuse;
+    FGResource reflections;
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "indirectDiffuse") return indirectDiffuse;
+        if (name == "reflections") return reflections;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        FGResource depthInput = getInput("depth");
+        if (depthInput.isValid()) {
+            m_depthRead = builder.read(depthInput);
+        }
+        const FGTextureDesc desc = FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA16Float);
+        indirectDiffuse = builder.create("indirectDiffuse", desc);
+        reflections = builder.create("reflections", desc);
+        m_prevDiffuseHistory = builder.readHistory(kDiffuseHistoryName, desc);
+        m_diffuseHistory = builder.writeHistory(kDiffuseHistoryName, desc);
+        m_prevReflectionHistory = builder.readHistory(kReflectionHistoryName, desc);
+        m_reflectionHistory = builder.writeHistory(kReflectionHistoryName, desc);
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("RaytracedGiPass");
+        MICROPROFILE_SCOPEI("RenderPass", "RaytracedGiPass", 0xffff8800);
+        if (!m_frameContext) return;
+
+        const RaytracedShadowResources& rt = m_ctx.shadowResources;
+        if (!rt.giPipeline.nativeHandle() || !rt.giGeometryBuffer.nativeHandle() || !rt.tlas.nativeHandle()) {
+            return;
+        }
+
+        struct {
+            float4x4 invViewProj;
+            float4x4 viewProj;
+            float4x4 prevViewProj;
+            float4 cameraPosition;
+            float4 lightDir;
+            float4 lightColor;
+            float4 skyColor;
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t frameIndex;
+            uint32_t reversedZ;
+            float normalBias;
+            float maxRayDistance;
+            float hitTextureLod;
+            uint32_t materialCount;
+            uint32_t textureCount;
+            uint32_t historyValid;
+            float maxHistoryLength;
+            float depthTolerance;
+        } uniforms{};
+        const float4x4 viewProj = m_frameContext->proj * m_frameContext->view;
+        float4x4 invViewProj = viewProj;
+        invViewProj.Invert();
+        uniforms.invViewProj = transpose(invViewProj);
+        uniforms.viewProj = transpose(viewProj);
+        uniforms.prevViewProj = transpose(m_frameContext->prevProj * m_frameContext->prevView);
+        uniforms.cameraPosition = m_frameContext->cameraWorldPos;
+        uniforms.lightDir = m_frameContext->worldLightDir;
+        const float4& light = m_frameContext->lightColorIntensity;
+        uniforms.lightColor = float4(light.x * light.w, light.y * light.w, light.z * light.w, 0.0f);
+        uniforms.skyColor = float4(kSkyTint[0] * m_skyIntensity,
+                                   kSkyTint[1] * m_skyIntensity,
+                                   kSkyTint[2] * m_skyIntensity,
+                                   0.0f);
+        uniforms.screenWidth = static_cast<uint32_t>(m_width);
+        uniforms.screenHeight = static_cast<uint32_t>(m_height);
+        uniforms.frameIndex = m_frameContext->frameIndex;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+        uniforms.normalBias = m_normalBias;
+        uniforms.maxRayDistance = m_maxRayDistance > 0 ? m_maxRayDistance : m_frameContext->cameraFarZ;
+        uniforms.hitTextureLod = m_hitTextureLod;
+        uniforms.materialCount = m_ctx.materials.materialCount;
+        uniforms.textureCount = static_cast<uint32_t>(m_ctx.materials.textureViews.size());
+        uniforms.historyValid = !m_frameContext->historyReset &&
+                                m_frameGraph->isHistoryValid(m_prevDiffuseHistory) &&
+                                m_frameGraph->isHistoryValid(m_prevReflectionHistory) ? 1u : 0u;
+        uniforms.maxHistoryLength = std::max(m_maxHistoryLength, 1.0f);
+        uniforms.depthTolerance = m_depthTolerance;
+
+        encoder.setComputePipeline(rt.giPipeline);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setBuffer(&m_ctx.sceneMesh.normalBuffer, 0, 1);
+        encoder.setBuffer(&m_ctx.sceneMesh.uvBuffer, 0, 2);
+        encoder.setBuffer(&m_ctx.sceneMesh.indexBuffer, 0, 3);
+        encoder.setBuffer(&m_ctx.materials.materialBuffer, 0, 4);
+        encoder.setBuffer(&rt.giGeometryBuffer, 0, 5);
+        encoder.setAccelerationStructure(&rt.tlas, 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
+        // Without history the shader never reads slots 1 and 2.
+        encoder.setTexture(uniforms.historyValid ? m_frameGraph->getTexture(m_prevDiffuseHistory)
+                                                 : &m_ctx.skyFallbackTex, 1);
+        encoder.setTexture(uniforms.historyValid ? m_frameGraph->getTexture(m_prevReflectionHistory)
+                                                 : &m_ctx.skyFallbackTex, 2);
+        encoder.setStorageTexture(m_frameGraph->getTexture(indirectDiffuse), 3);
+        encoder.setStorageTexture(m_frameGraph->getTexture(reflections), 4);
+        encoder.setStorageTexture(m_frameGraph->getTexture(m_diffuseHistory), 5);
+        encoder.setStorageTexture(m_frameGraph->getTexture(m_reflectionHistory), 6);
+        encoder.traceRays({static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height), 1});
+        m_frameGraph->commitHistory(m_diffuseHistory);
+        m_frameGraph->commitHistory(m_reflectionHistory);
+    }
+
+    void renderUI() override {
+        ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        ImGui::Text("Pipeline: %s", m_ctx.shadowResources.giPipeline.nativeHandle() ? "Ready" : "Unavailable");
+        ImGui::SliderFloat("Normal Bias", &m_normalBias, 0.0f, 0.5f, "%.3f");
+        ImGui::SliderFloat("Max Ray Distance", &m_maxRayDistance, 0.0f, 2000.0f, "%.1f");
+        ImGui::SliderFloat("Sky Intensity", &m_skyIntensity, 0.0f, 4.0f, "%.2f");
+        ImGui::SliderFloat("Hit Texture LOD", &m_hitTextureLod, 0.0f, 8.0f, "%.1f");
+        ImGui::SliderFloat("Max History Length", &m_maxHistoryLength, 1.0f, 64.0f, "%.0f");
+    }
+
+private:
+    static constexpr const char* kDiffuseHistoryName = "RaytracedGiDiffuseHistory";
+    static constexpr const char* kReflectionHistoryName = "RaytracedGiReflectionHistory";
+    static constexpr float kSkyTint[3] = {0.55f, 0.65f, 0.85f};
+
+    const RenderContext& m_ctx;
+    FGResource m_depthRead;
+    FGResource m_prevDiffuseHistory;
+    FGResource m_diffuseHistory;
+    FGResource m_prevReflectionHistory;
+    FGResource m_reflectionHistory;
+    int m_width, m_height;
+    std::string m_name = "Ray Traced GI";
+    float m_normalBias = 0.05f;
+    float m_maxRayDistance = 200.0f;
+    float m_skyIntensity = 1.0f;
+    float m_hitTextureLod = 2.0f;
+    float m_maxHistoryLength = 32.0f;
+    float m_depthTolerance = 0.05f;
+};
+
+METALLIC_REGISTER_PASS(RaytracedGiPass);
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+#include <string>
+#include <vector>
+
+// Shadow mask for GPUs without ray tracing. Samples the cascade depths the cluster
+// pipeline drew (VisibilityPass "depth" outputs of the "shadowCascade" passes) at
+// each screen pixel and writes the same R8 "shadowMap" ShadowRayPass produces.
+class ShadowCascadeResolvePass : public RenderPass {
+public:
+    ShadowCascadeResolvePass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(ShadowCascadeResolvePass, "Shadow Cascade Resolve", "Lighting",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("depth", "Depth"),
+            makeInputSlot("cascadeDepth0", "Cascade Depth 0"),
+            makeInputSlot("cascadeDepth1", "Cascade Depth 1"),
+            makeInputSlot("cascadeDepth2", "Cascade Depth 2"),
+            makeInputSlot("cascadeDepth3", "Cascade Depth 3")
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("shadowMap", "Shadow Map")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.contains("depthBiasTexels")) {
+            m_depthBiasTexels = config.config["depthBiasTexels"].get<float>();
+        }
+        if (config.config.contains("normalBiasTexels")) {
+            m_normalBiasTexels = config.config["normalBiasTexels"].get<float>();
+        }
+    }
+
+    FGResource shadowMap;
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "shadowMap") return shadowMap;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        m_depthRead = FGResource{};
+        FGResource depthInput = getInput("depth");
+        if (depthInput.isValid()) {
+            m_depthRead = builder.read(depthInput);
+        }
+        static constexpr const char* kCascadeInputs[kShadowCascadeCount] = {
+            "cascadeDepth0", "cascadeDepth1", "cascadeDepth2", "cascadeDepth3"};
+        for (uint32_t i = 0; i < kShadowCascadeCount; ++i) {
+            m_cascadeDepthRead[i] = FGResource{};
+            FGResource cascadeInput = getInput(kCascadeInputs[i]);
+            if (cascadeInput.isValid()) {
+                m_cascadeDepthRead[i] = builder.read(cascadeInput);
+            }
+        }
+        shadowMap = builder.create("shadowMap",
+            FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::R8Unorm));
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("ShadowCascadeResolvePass");
+        MICROPROFILE_SCOPEI("RenderPass", "ShadowCascadeResolvePass", 0xffff8800);
+        if (!m_frameContext || !m_runtimeContext || !m_frameGraph) return;
+
+        const ShadowCascadeSet& cascades = m_frameContext->shadowCascades;
+        auto pipelineIt = m_runtimeContext->computePipelinesRhi.find("ShadowCascadeResolvePass");
+        if (cascades.count == 0 || !m_depthRead.isValid() ||
+            pipelineIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !pipelineIt->second.nativeHandle()) {
+            return;
+        }
+        const RhiTexture* cascadeTextures[kShadowCascadeCount] = {};
+        for (uint32_t i = 0; i < kShadowCascadeCount; ++i) {
+            cascadeTextures[i] =
+                m_cascadeDepthRead[i].isValid() ? m_frameGraph->getTexture(m_cascadeDepthRead[i]) : nullptr;
+            if (i < cascades.count && !cascadeTextures[i]) {
+                return;
+            }
+        }
+
+        struct {
+            float4x4 invViewProj;
+            float4x4 cascadeViewProj[kShadowCascadeCount];
+            float4 cascadeSplitFar;
+            float4 cascadeTexelWorldSize;
+            float4 cameraWorldPos;
+            float4 cameraForward;
+            float4 lightDir;
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t cascadeResolution;
+            uint32_t cascadeCount;
+            float depthBiasTexels;
+            float normalBiasTexels;
+            uint32_t reversedZ;
+            uint32_t pad;
+        } uniforms{};
+        float4x4 invViewProj = m_frameContext->proj * m_frameContext->view;
+        invViewProj.Invert();
+        uniforms.invViewProj = transpose(invViewProj);
+        float splitFar[kShadowCascadeCount] = {};
+        float texelWorldSize[kShadowCascadeCount] = {};
+        for (uint32_t i = 0; i < cascades.count; ++i) {
+            const ShadowCascadeView& cascade = cascades.cascades[i];
+            uniforms.cascadeViewProj[i] = transpose(cascade.proj * cascade.view);
+            splitFar[i] = cascade.splitFar;
+            texelWorldSize[i] = cascade.texelWorldSize;
+        }
+        uniforms.cascadeSplitFar = float4(splitFar[0], splitFar[1], splitFar[2], splitFar[3]);
+        uniforms.cascadeTexelWorldSize =
+            float4(texelWorldSize[0], texelWorldSize[1], texelWorldSize[2], texelWorldSize[3]);
+        uniforms.cameraWorldPos = m_frameContext->cameraWorldPos;
+        uniforms.cameraForward = m_frameContext->cameraForward;
+        uniforms.lightDir = m_frameContext->worldLightDir;
+        uniforms.screenWidth = static_cast<uint32_t>(m_width);
+        uniforms.screenHeight = static_cast<uint32_t>(m_height);
+        uniforms.cascadeResolution = kShadowCascadeResolution;
+        uniforms.cascadeCount = cascades.count;
+        uniforms.depthBiasTexels = m_depthBiasTexels;
+        uniforms.normalBiasTexels = m_normalBiasTexels;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+
+        encoder.setComputePipeline(pipelineIt->second);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
+        for (uint32_t i = 0; i < kShadowCascadeCount; ++i) {
+            // Unused slots alias the first cascade; the shader never reads them.
+            encoder.setTexture(cascadeTextures[i] ? cascadeTextures[i] : cascadeTextures[0], 1 + i);
+        }
+        encoder.setStorageTexture(m_frameGraph->getTexture(shadowMap), 1 + kShadowCascadeCount);
+        encoder.dispatchThreadgroups({static_cast<uint32_t>((m_width + 7) / 8), static_cast<uint32_t>((m_height + 7) / 8), 1},
+                                     {8, 8, 1});
+    }
+
+    void renderUI() override {
+        ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        if (m_frameContext) {
+            const ShadowCascadeSet& cascades = m_frameContext->shadowCascades;
+            ImGui::Text("Cascades: %u x %u^2", cascades.count, kShadowCascadeResolution);
+            for (uint32_t i = 0; i < cascades.count; ++i) {
+                const ShadowCascadeView& cascade = cascades.cascades[i];
+                ImGui::Text("  %u: to %.1f, texel %.3f, %s", i, cascade.splitFar, cascade.texelWorldSize,
+                            cascade.cached ? "cached" : "redrawn");
+            }
+        }
+        ImGui::SliderFloat("Depth Bias (texels)", &m_depthBiasTexels, 0.0f, 8.0f, "%.2f");
+        ImGui::SliderFloat("Normal Bias (texels)", &m_normalBiasTexels, 0.0f, 8.0f, "%.2f");
+    }
+
+private:
+    const RenderContext& m_ctx;
+    FGResource m_depthRead;
+    FGResource m_cascadeDepthRead[kShadowCascadeCount];
+    int m_width, m_height;
+    std::string m_name = "Shadow Cascade Resolve";
+    float m_depthBiasTexels = 1.5f;
+    float m_normalBiasTexels = 1.0f;
+};
+
+METALLIC_REGISTER_PASS(ShadowCascadeResolvePass);
@@ -6,6 +6,13 @@
 #include "pass_registry.h"
 #include "imgui.h"
 
+#include <algorithm>
+#include <cmath>
+
+// Traces the sun shadow mask against the scene TLAS. With "traceDownsample" 2 one
+// ray covers each 2x2 block and a non-zero "lightAngularDiameter" jitters rays over
+// the sun's disc; either way shadow_denoise.slang then filters the sparse, noisy
+// trace spatially and accumulates it over frames into the full-resolution mask.
 class ShadowRayPass : public RenderPass {
 public:
     ShadowRayPass(const RenderContext& ctx, int w, int h)
@@ -27,6 +34,15 @@ public:
         if (config.config.contains("maxRayDistance")) {
             m_maxRayDistance = config.config["maxRayDistance"].get<float>();
         }
+        if (config.config.contains("traceDownsample")) {
+            m_traceDownsample = std::clamp(config.config["traceDownsample"].get<uint32_t>(), 1u, 2u);
+        }
+        if (config.config.contains("lightAngularDiameter")) {
+            m_lightAngularDiameter = config.config["lightAngularDiameter"].get<float>();
+        }
+        if (config.config.contains("maxHistoryLength")) {
+            m_maxHistoryLength = config.config["maxHistoryLength"].get<float>();
+        }
     }
 
     FGResource shadowMap;
@@ -37,6 +53,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         // Read depth from input
         FGResource depthInput = getInput("depth");
         if (depthInput.isValid()) {
@@ -44,6 +61,17 @@ public:
         }
         shadowMap = builder.create("shadowMap",
             FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::R8Unorm));
+
+        m_denoise = m_traceDownsample > 1 || m_lightAngularDiameter > 0.0f;
+        m_rawShadow = m_prevHistory = m_history = FGResource{};
+        if (m_denoise) {
+            m_rawShadow = builder.create("rawShadow",
+                FGTextureDesc::storageTexture(traceWidth(), traceHeight(), RhiFormat::R8Unorm));
+            const FGTextureDesc historyDesc =
+                FGTextureDesc::storageTexture(m_width, m_height, RhiFormat::RGBA16Float);
+            m_prevHistory = builder.readHistory(kHistoryName, historyDesc);
+            m_history = builder.writeHistory(kHistoryName, historyDesc);
+        }
     }
 
     void executeCompute(RhiComputeCommandEncoder& encoder) override {
@@ -54,6 +82,16 @@ public:
 
         if (!m_ctx.shadowResources.pipeline.nativeHandle()) return;
 
+        // Without the denoiser the trace falls back to one ray per pixel.
+        const RhiComputePipeline* denoisePipeline = nullptr;
+        if (m_denoise && m_runtimeContext) {
+            auto denoiseIt = m_runtimeContext->computePipelinesRhi.find("ShadowDenoisePass");
+            if (denoiseIt != m_runtimeContext->computePipelinesRhi.end() && denoiseIt->second.nativeHandle()) {
+                denoisePipeline = &denoiseIt->second;
+            }
+        }
+        const uint32_t traceDownsample = denoisePipeline ? m_traceDownsample : 1u;
+
         encoder.setComputePipeline(m_ctx.shadowResources.pipeline);
         ShadowUniforms shadowUni;
         float4x4 viewProj = m_frameContext->proj * m_frameContext->view;
@@ -70,20 +108,31 @@ public:
         shadowUni.normalBias = m_normalBias;
         shadowUni.maxRayDistance = m_maxRayDistance > 0 ? m_maxRayDistance : m_frameContext->cameraFarZ;
         shadowUni.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+        shadowUni.traceDownsample = traceDownsample;
+        shadowUni.frameIndex = m_frameContext->frameIndex;
+        shadowUni.lightConeTan = std::tan(0.5f * m_lightAngularDiameter * (3.14159265358979323846f / 180.0f));
         encoder.setPushConstants(&shadowUni, sizeof(shadowUni));
         encoder.setAccelerationStructure(&m_ctx.shadowResources.tlas, 1);
         encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
-        encoder.setStorageTexture(m_frameGraph->getTexture(shadowMap), 1);
-        encoder.useResource(m_ctx.shadowResources.tlas, RhiResourceUsage::Read);
-        for (auto& blas : m_ctx.shadowResources.blasArray) {
-            if (blas.nativeHandle()) {
-                encoder.useResource(blas, RhiResourceUsage::Read);
+        encoder.setStorageTexture(m_frameGraph->getTexture(denoisePipeline ? m_rawShadow : shadowMap), 1);
+        if (!m_ctx.shadowResources.residentOnQueue()) {
+            encoder.useResource(m_ctx.shadowResources.tlas, RhiResourceUsage::Read);
+            for (auto& blas : m_ctx.shadowResources.blasArray) {
+                if (blas.nativeHandle()) {
+                    encoder.useResource(blas, RhiResourceUsage::Read);
+                }
             }
+            encoder.useResource(m_ctx.sceneMesh.positionBuffer, RhiResourceUsage::Read);
+            encoder.useResource(m_ctx.sceneMesh.indexBuffer, RhiResourceUsage::Read);
+        }
+        const uint32_t traceW = (static_cast<uint32_t>(m_width) + traceDownsample - 1) / traceDownsample;
+        const uint32_t traceH = (static_cast<uint32_t>(m_height) + traceDownsample - 1) / traceDownsample;
+        encoder.dispatchThreadgroups({(traceW + 7) / 8, (traceH + 7) / 8, 1}, {8, 8, 1});
+
+        if (denoisePipeline) {
+            encoder.memoryBarrier(RhiBarrierScope::Textures);
+            dispatchDenoise(encoder, *denoisePipeline);
         }
-        encoder.useResource(m_ctx.sceneMesh.positionBuffer, RhiResourceUsage::Read);
-        encoder.useResource(m_ctx.sceneMesh.indexBuffer, RhiResourceUsage::Read);
-        encoder.dispatchThreadgroups({static_cast<uint32_t>((m_width + 7) / 8), static_cast<uint32_t>((m_height + 7) / 8), 1},
-                                     {8, 8, 1});
     }
 
     void renderUI() override {
@@ -99,15 +148,84 @@ public:
         }
         ImGui::SliderFloat("Normal Bias", &m_normalBias, 0.0f, 0.5f, "%.3f");
         ImGui::SliderFloat("Max Ray Distance", &m_maxRayDistance, 0.0f, 2000.0f, "%.1f");
+        if (m_denoise) {
+            ImGui::Text("Rays: %u x %u (1 per %u px), denoised", traceWidth(), traceHeight(),
+                        m_traceDownsample * m_traceDownsample);
+            ImGui::SliderFloat("Light Angular Diameter", &m_lightAngularDiameter, 0.0f, 5.0f, "%.2f deg");
+            ImGui::SliderFloat("Max History Length", &m_maxHistoryLength, 1.0f, 64.0f, "%.0f");
+        } else {
+            ImGui::Text("Rays: 1 per pixel");
+        }
     }
 
 private:
+    static constexpr const char* kHistoryName = "ShadowDenoiseHistory";
+
+    uint32_t traceWidth() const {
+        return (static_cast<uint32_t>(m_width) + m_traceDownsample - 1) / m_traceDownsample;
+    }
+    uint32_t traceHeight() const {
+        return (static_cast<uint32_t>(m_height) + m_traceDownsample - 1) / m_traceDownsample;
+    }
+
+    void dispatchDenoise(RhiComputeCommandEncoder& encoder, const RhiComputePipeline& pipeline) {
+        struct {
+            float4x4 invViewProj;
+            float4x4 viewProj;
+            float4x4 prevViewProj;
+            uint32_t screenWidth;
+            uint32_t screenHeight;
+            uint32_t traceDownsample;
+            uint32_t frameIndex;
+            uint32_t reversedZ;
+            uint32_t historyValid;
+            float maxHistoryLength;
+            float depthTolerance;
+        } uniforms{};
+        const float4x4 viewProj = m_frameContext->proj * m_frameContext->view;
+        float4x4 invViewProj = viewProj;
+        invViewProj.Invert();
+        uniforms.invViewProj = transpose(invViewProj);
+        uniforms.viewProj = transpose(viewProj);
+        uniforms.prevViewProj = transpose(m_frameContext->prevProj * m_frameContext->prevView);
+        uniforms.screenWidth = static_cast<uint32_t>(m_width);
+        uniforms.screenHeight = static_cast<uint32_t>(m_height);
+        uniforms.traceDownsample = m_traceDownsample;
+        uniforms.frameIndex = m_frameContext->frameIndex;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1 : 0;
+        uniforms.historyValid = m_frameGraph->isHistoryValid(m_prevHistory) ? 1u : 0u;
+        uniforms.maxHistoryLength = std::max(m_maxHistoryLength, 1.0f);
+        uniforms.depthTolerance = m_depthTolerance;
+
+        RhiTexture* historyTex = m_frameGraph->getTexture(m_history);
+        RhiTexture* prevHistoryTex = uniforms.historyValid ? m_frameGraph->getTexture(m_prevHistory) : nullptr;
+        encoder.setComputePipeline(pipeline);
+        encoder.setBytes(&uniforms, sizeof(uniforms), 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_depthRead), 0);
+        encoder.setTexture(m_frameGraph->getTexture(m_rawShadow), 1);
+        // Without history the shader never reads slot 2; bind the raw trace there.
+        encoder.setTexture(prevHistoryTex ? prevHistoryTex : m_frameGraph->getTexture(m_rawShadow), 2);
+        encoder.setStorageTexture(m_frameGraph->getTexture(shadowMap), 3);
+        encoder.setStorageTexture(historyTex, 4);
+        encoder.dispatchThreadgroups({static_cast<uint32_t>((m_width + 7) / 8), static_cast<uint32_t>((m_height + 7) / 8), 1},
+                                     {8, 8, 1});
+        m_frameGraph->commitHistory(m_history);
+    }
+
     const RenderContext& m_ctx;
     FGResource m_depthRead;
     int m_width, m_height;
     std::string m_name = "Shadow Ray Pass";
     float m_normalBias = 0.05f;
     float m_maxRayDistance = 1000.0f;
+    uint32_t m_traceDownsample = 1;
+    float m_lightAngularDiameter = 0.0f;
+    float m_maxHistoryLength = 16.0f;
+    float m_depthTolerance = 0.05f;
+    bool m_denoise = false;
+    FGResource m_rawShadow;
+    FGResource m_prevHistory;
+    FGResource m_history;
 };
 
 METALLIC_REGISTER_PASS(ShadowRayPass);
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "gpu_driven_constants.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+// Deforms GpuSkinningTables' skinned and morphed primitive groups in place in
+// the scene position and normal buffers, then refits their meshlet bounds so
+// culling sees the posed geometry. Wire skinningSync into every MeshletCullPass.
+// Without deformed geometry or the pipelines it records nothing and meshes keep
+// their last pose.
+class SkinningPass : public RenderPass {
+public:
+    SkinningPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    ~SkinningPass() override = default;
+
+    METALLIC_PASS_TYPE_INFO(SkinningPass, "Skinning", "Geometry",
+        (std::vector<PassSlotInfo>{}),
+        (std::vector<PassSlotInfo>{
+            makeOutputSlot("skinningSync", "Skinning Sync")
+        }),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "skinningSync") {
+            return m_skinningSync;
+        }
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_skinningSync = builder.createToken("SkinningSync");
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("SkinningPass");
+        MICROPROFILE_SCOPEI("RenderPass", "SkinningPass", 0xffff8800);
+        m_lastRangeCount = 0;
+        if (!m_runtimeContext) return;
+
+        const GpuSkinningTables& skinning = m_ctx.skinning;
+        if (skinning.ranges.empty() ||
+            !skinning.restPositionBuffer.nativeHandle() ||
+            !m_ctx.sceneMesh.positionBuffer.nativeHandle() ||
+            !m_ctx.sceneMesh.normalBuffer.nativeHandle()) {
+            return;
+        }
+
+        auto skinIt = m_runtimeContext->computePipelinesRhi.find("SkinningPass");
+        auto refitIt = m_runtimeContext->computePipelinesRhi.find("SkinningRefitPass");
+        if (skinIt == m_runtimeContext->computePipelinesRhi.end() || !skinIt->second.nativeHandle() ||
+            refitIt == m_runtimeContext->computePipelinesRhi.end() || !refitIt->second.nativeHandle()) {
+            return;
+        }
+
+        using Bindings = GpuDriven::SkinningBindings;
+        const MeshletData& meshlets = m_ctx.meshletData;
+        auto bindBuffers = [&]() {
+            encoder.setBuffer(&skinning.restPositionBuffer, 0, Bindings::kRestPositions);
+            encoder.setBuffer(&skinning.restNormalBuffer, 0, Bindings::kRestNormals);
+            encoder.setBuffer(&skinning.jointBuffer, 0, Bindings::kJoints);
+            encoder.setBuffer(&skinning.weightBuffer, 0, Bindings::kWeights);
+            encoder.setBuffer(&skinning.morphDeltaBuffer, 0, Bindings::kMorphDeltas);
+            encoder.setBuffer(&skinning.paletteBuffer, 0, Bindings::kPalette);
+            encoder.setBuffer(&skinning.morphWeightBuffer, 0, Bindings::kMorphWeights);
+            encoder.setBuffer(&m_ctx.sceneMesh.positionBuffer, 0, Bindings::kPositions);
+            encoder.setBuffer(&m_ctx.sceneMesh.normalBuffer, 0, Bindings::kNormals);
+            encoder.setBuffer(&meshlets.meshletBuffer, 0, Bindings::kMeshlets);
+            encoder.setBuffer(&meshlets.meshletVertices, 0, Bindings::kMeshletVertices);
+            encoder.setBuffer(&meshlets.boundsBuffer, 0, Bindings::kMeshletBounds);
+        };
+
+        encoder.setComputePipeline(skinIt->second);
+        bindBuffers();
+        for (const GPUSkinningRange& range : skinning.ranges) {
+            encoder.setPushConstants(&range, sizeof(range));
+            encoder.dispatchThreadgroups(
+                {(range.vertexCount + Bindings::kThreadgroupSize - 1) / Bindings::kThreadgroupSize, 1, 1},
+                {Bindings::kThreadgroupSize, 1, 1});
+        }
+
+        // Refit reads the positions every range above wrote.
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+        encoder.setComputePipeline(refitIt->second);
+        bindBuffers();
+        for (const GPUSkinningRange& range : skinning.ranges) {
+            if (range.meshletCount == 0) {
+                continue;
+            }
+            encoder.setPushConstants(&range, sizeof(range));
+            encoder.dispatchThreadgroups(
+                {(range.meshletCount + Bindings::kThreadgroupSize - 1) / Bindings::kThreadgroupSize, 1, 1},
+                {Bindings::kThreadgroupSize, 1, 1});
+        }
+        m_lastRangeCount = static_cast<uint32_t>(skinning.ranges.size());
+    }
+
+    void renderUI() override {
+        const GpuSkinningTables& skinning = m_ctx.skinning;
+        ImGui::Text("Deformed meshes: %zu", skinning.deformers.size());
+        ImGui::Text("Ranges dispatched: %u", m_lastRangeCount);
+        ImGui::Text("Vertices: %u", skinning.deformedVertexCount);
+    }
+
+private:
+    const RenderContext& m_ctx;
+    FGResource m_skinningSync;
+    int m_width, m_height;
+    std::string m_name = "Skinning";
+    uint32_t m_lastRangeCount = 0;
+};
+
+METALLIC_REGISTER_PASS(SkinningPass);
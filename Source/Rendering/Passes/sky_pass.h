@@ -6,13 +6,24 @@
 #include "pass_registry.h"
 #include "imgui.h"
 
+// Draws the atmosphere from the tables on its inputs (AtmospherePass), or from
+// the runtime-imported ones when they are not wired. With a sky-view LUT bound,
+// each pixel takes one fetch from it instead of the 4D scattering lookup. With
+// the scene depth wired, pixels covered by geometry stay black after one depth
+// fetch; DeferredLightingPass only reads the sky where nothing was drawn.
 class SkyPass : public RenderPass {
 public:
     SkyPass(const RenderContext& ctx, int w, int h)
         : m_ctx(ctx), m_width(w), m_height(h) {}
 
     METALLIC_PASS_TYPE_INFO(SkyPass, "Sky Pass", "Environment",
-        (std::vector<PassSlotInfo>{}),
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("transmittance", "Transmittance", true),
+            makeInputSlot("scattering", "Scattering", true),
+            makeInputSlot("irradiance", "Irradiance", true),
+            makeInputSlot("skyView", "Sky View", true),
+            makeInputSlot("depth", "Depth", true)
+        }),
         (std::vector<PassSlotInfo>{makeOutputSlot("skyOutput", "Sky Output")}),
         PassTypeInfo::PassType::Render);
 
@@ -24,6 +35,12 @@ public:
         if (config.config.contains("exposure")) {
             m_exposure = config.config["exposure"].get<float>();
         }
+        if (config.config.contains("useSkyView")) {
+            m_useSkyView = config.config["useSkyView"].get<bool>();
+        }
+        if (config.config.contains("skipGeometry")) {
+            m_skipGeometry = config.config["skipGeometry"].get<bool>();
+        }
     }
 
     FGResource output;
@@ -34,6 +51,17 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        auto readInput = [&](const char* slot) {
+            FGResource input = getInput(slot);
+            return input.isValid() ? builder.read(input) : FGResource{};
+        };
+        m_transmittanceRead = readInput("transmittance");
+        m_scatteringRead = readInput("scattering");
+        m_irradianceRead = readInput("irradiance");
+        m_skyViewRead = readInput("skyView");
+        m_depthRead = readInput("depth");
+
         output = builder.create("skyColor",
             FGTextureDesc::renderTarget(m_width, m_height, RhiFormat::RGBA16Float));
         output = builder.setColorAttachment(0,
@@ -53,21 +81,18 @@ public:
         auto pipeIt = m_runtimeContext->renderPipelinesRhi.find("SkyPass");
         if (pipeIt == m_runtimeContext->renderPipelinesRhi.end() || !pipeIt->second.nativeHandle()) return;
 
-        auto transmittanceIt = m_runtimeContext->importedTexturesRhi.find("transmittance");
-        auto scatteringIt = m_runtimeContext->importedTexturesRhi.find("scattering");
-        auto irradianceIt = m_runtimeContext->importedTexturesRhi.find("irradiance");
+        RhiTexture* transmittanceTex = findTable(m_transmittanceRead, "transmittance");
+        RhiTexture* scatteringTex = findTable(m_scatteringRead, "scattering");
+        RhiTexture* irradianceTex = findTable(m_irradianceRead, "irradiance");
+        RhiTexture* skyViewTex = m_skyViewRead.isValid() ? m_frameGraph->getTexture(m_skyViewRead) : nullptr;
+        RhiTexture* depthTex = m_depthRead.isValid() ? m_frameGraph->getTexture(m_depthRead) : nullptr;
         auto samplerIt = m_runtimeContext->samplersRhi.find("atmosphere");
-
-        if (transmittanceIt == m_runtimeContext->importedTexturesRhi.end() ||
-            scatteringIt == m_runtimeContext->importedTexturesRhi.end() ||
-            irradianceIt == m_runtimeContext->importedTexturesRhi.end() ||
-            samplerIt == m_runtimeContext->samplersRhi.end() ||
-            !transmittanceIt->second.nativeHandle() ||
-            !scatteringIt->second.nativeHandle() ||
-            !irradianceIt->second.nativeHandle() ||
-            !samplerIt->second.nativeHandle()) {
+        if (!transmittanceTex || !scatteringTex || !irradianceTex ||
+            samplerIt == m_runtimeContext->samplersRhi.end() || !samplerIt->second.nativeHandle()) {
             return;
         }
+        const bool useSkyView = m_useSkyView && skyViewTex;
+        const bool depthTested = m_skipGeometry && depthTex;
 
         // Build AtmosphereUniforms from FrameContext raw data
         float4x4 viewProj = m_frameContext->proj * m_frameContext->view;
@@ -78,18 +103,21 @@ public:
         uniforms.invViewProj = transpose(invViewProj);
         uniforms.cameraWorldPos = m_frameContext->cameraWorldPos;
         uniforms.sunDirection = m_frameContext->worldLightDir;
-        uniforms.params = float4(m_exposure, 0.0f, 0.0f, 0.0f);
+        uniforms.params = float4(m_exposure, static_cast<float>(m_ctx.depthClearValue), 0.0f, 0.0f);
         uniforms.screenWidth = static_cast<uint32_t>(m_frameContext->width);
         uniforms.screenHeight = static_cast<uint32_t>(m_frameContext->height);
-        uniforms.pad0 = 0;
-        uniforms.pad1 = 0;
+        uniforms.useSkyView = useSkyView ? 1u : 0u;
+        uniforms.depthTested = depthTested ? 1u : 0u;
 
         encoder.setRenderPipeline(pipeIt->second);
         encoder.setCullMode(RhiCullMode::None);
         encoder.setPushConstants(&uniforms, sizeof(uniforms));
-        encoder.setFragmentTexture(&transmittanceIt->second, 0);
-        encoder.setFragmentTexture(&scatteringIt->second, 1);
-        encoder.setFragmentTexture(&irradianceIt->second, 2);
+        encoder.setFragmentTexture(transmittanceTex, 0);
+        encoder.setFragmentTexture(scatteringTex, 1);
+        encoder.setFragmentTexture(irradianceTex, 2);
+        // Unused without the sky view, but the slot still needs a texture.
+        encoder.setFragmentTexture(useSkyView ? skyViewTex : transmittanceTex, 3);
+        encoder.setFragmentTexture(depthTested ? depthTex : transmittanceTex, 4);
         encoder.setFragmentSampler(&samplerIt->second, 0);
         encoder.drawPrimitives(RhiPrimitiveType::Triangle, 0, 3);
     }
@@ -97,13 +125,30 @@ public:
     void renderUI() override {
         ImGui::Text("Resolution: %d x %d", m_width, m_height);
         ImGui::SliderFloat("Exposure", &m_exposure, 0.1f, 20.0f, "%.2f");
+        if (m_skyViewRead.isValid()) {
+            ImGui::Checkbox("Sky View LUT", &m_useSkyView);
+        }
+        if (m_depthRead.isValid()) {
+            ImGui::Checkbox("Skip Geometry Pixels", &m_skipGeometry);
+        }
     }
 
 private:
+    RhiTexture* findTable(FGResource read, const char* importKey) const {
+        if (read.isValid()) return m_frameGraph->getTexture(read);
+        auto it = m_runtimeContext->importedTexturesRhi.find(importKey);
+        if (it == m_runtimeContext->importedTexturesRhi.end() || !it->second.nativeHandle()) return nullptr;
+        return const_cast<RhiTextureHandle*>(&it->second);
+    }
+
+
     const RenderContext& m_ctx;
     int m_width, m_height;
     std::string m_name = "Atmosphere Sky";
     float m_exposure = 10.0f;
+    bool m_useSkyView = true;
+    bool m_skipGeometry = true;
+    FGResource m_transmittanceRead, m_scatteringRead, m_irradianceRead, m_skyViewRead, m_depthRead;
 };
 
 METALLIC_REGISTER_PASS(SkyPass);
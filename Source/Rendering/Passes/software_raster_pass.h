@@ -0,0 +1,187 @@
+#pragma once
+
+#include "frame_context.h"
+#include "gpu_cull_resources.h"
+#include "gpu_driven_helpers.h"
+#include "pass_registry.h"
+#include "render_pass.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Compute rasterizer for the clusters MeshletCullPass bins to software raster
+// (kMeshletDrawSoftwareRasterBit). Reads the same visible-meshlet worklist as the
+// VisibilityPass it feeds and writes one packed 64-bit depth|visibility sample per
+// pixel to "softwareRaster"; VisibilityPass depth-tests those into its targets and
+// skips the binned clusters in the mesh shader. Without the pipelines (no 64-bit
+// buffer atomics, or Metal) it publishes nothing and every cluster stays on hardware.
+class SoftwareRasterPass : public RenderPass {
+public:
+    SoftwareRasterPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(SoftwareRasterPass, "Software Raster", "Geometry",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("visibleMeshlets", "Visible Meshlets", true),
+            makeInputSlot("visibilityWorklist", "Visibility Worklist", true),
+            makeInputSlot("visibilityWorklistState", "Visibility Worklist State", true)
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("softwareRaster", "Software Raster", true)}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.is_object() && config.config.contains("enabled")) {
+            m_enabled = config.config["enabled"].get<bool>();
+        }
+    }
+
+    FGResource getOutput(const std::string& name) const override {
+        return name == "softwareRaster" ? m_softwareRaster : FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_visibleMeshletsRead = FGResource{};
+        m_worklistStateRead = FGResource{};
+        m_softwareRaster = FGResource{};
+        m_active = false;
+
+        FGResource visibleMeshletsInput = getInput("visibleMeshlets");
+        if (!visibleMeshletsInput.isValid()) {
+            visibleMeshletsInput = getInput("visibilityWorklist");
+        }
+        FGResource worklistStateInput = getInput("visibilityWorklistState");
+        if (!m_enabled || !pipelinesAvailable() ||
+            !visibleMeshletsInput.isValid() || !worklistStateInput.isValid()) {
+            return;
+        }
+
+        m_visibleMeshletsRead = builder.read(visibleMeshletsInput, FGResourceUsage::StorageRead);
+        m_worklistStateRead = builder.read(worklistStateInput, FGResourceUsage::Indirect);
+        m_softwareRaster = builder.create(
+            "softwareRaster",
+            makeStructuredBufferDesc<uint64_t>(pixelCount(), "SoftwareRasterBuffer", false));
+        m_active = true;
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("SoftwareRasterPass");
+        MICROPROFILE_SCOPEI("RenderPass", "SoftwareRasterPass", 0xffff8844);
+        if (!m_active || !m_frameContext || !m_runtimeContext || !m_frameGraph) {
+            return;
+        }
+
+        auto clearIt = m_runtimeContext->computePipelinesRhi.find("SoftwareRasterClearPass");
+        auto rasterIt = m_runtimeContext->computePipelinesRhi.find("SoftwareRasterPass");
+        const RhiBuffer* visibleMeshletBuffer = m_frameGraph->getBuffer(m_visibleMeshletsRead);
+        const RhiBuffer* worklistStateBuffer = m_frameGraph->getBuffer(m_worklistStateRead);
+        const RhiBuffer* softwareRasterBuffer = m_frameGraph->getBuffer(m_softwareRaster);
+        const RhiBuffer* sceneInstanceBuffer =
+            m_ctx.gpuScene.instanceBuffer.nativeHandle() ? &m_ctx.gpuScene.instanceBuffer : nullptr;
+        if (clearIt == m_runtimeContext->computePipelinesRhi.end() ||
+            rasterIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !visibleMeshletBuffer || !worklistStateBuffer || !softwareRasterBuffer ||
+            !sceneInstanceBuffer) {
+            return;
+        }
+
+        struct {
+            float4x4 viewProj;
+            uint32_t targetSize[2];
+            uint32_t pixelCount;
+            uint32_t pad;
+        } uniforms{};
+        uniforms.viewProj = transpose(m_frameContext->proj * m_frameContext->view);
+        uniforms.targetSize[0] = static_cast<uint32_t>(m_width);
+        uniforms.targetSize[1] = static_cast<uint32_t>(m_height);
+        uniforms.pixelCount = pixelCount();
+
+        encoder.setComputePipeline(clearIt->second);
+        encoder.setBytes(&uniforms, sizeof(uniforms), GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+        encoder.setBuffer(softwareRasterBuffer, 0, GpuDriven::MeshletVisibilityBindings::kSoftwareRaster);
+        encoder.dispatchThreadgroups({(uniforms.pixelCount + 255u) / 256u, 1, 1}, {256, 1, 1});
+        encoder.memoryBarrier(RhiBarrierScope::Buffers);
+
+        const RhiBuffer* lodMeshletBuffer =
+            m_ctx.clusterLodData.meshletBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletBuffer
+                : &m_ctx.meshletData.meshletBuffer;
+        const RhiBuffer* lodMeshletVerticesBuffer =
+            m_ctx.clusterLodData.meshletVerticesBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletVerticesBuffer
+                : &m_ctx.meshletData.meshletVertices;
+        const RhiBuffer* lodMeshletTrianglesBuffer =
+            m_ctx.clusterLodData.meshletTrianglesBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletTrianglesBuffer
+                : &m_ctx.meshletData.meshletTriangles;
+        const RhiBuffer* lodMaterialIdsBuffer =
+            m_ctx.clusterLodData.materialIDsBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.materialIDsBuffer
+                : &m_ctx.meshletData.materialIDs;
+
+        encoder.setComputePipeline(rasterIt->second);
+        encoder.setBytes(&uniforms, sizeof(uniforms), GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+        encoder.setBuffer(&m_ctx.sceneMesh.positionBuffer, 0, GpuDriven::MeshletVisibilityBindings::kPositions);
+        encoder.setBuffer(&m_ctx.sceneMesh.normalBuffer, 0, GpuDriven::MeshletVisibilityBindings::kNormals);
+        encoder.setBuffer(&m_ctx.meshletData.meshletBuffer, 0, GpuDriven::MeshletVisibilityBindings::kMeshlets);
+        encoder.setBuffer(&m_ctx.meshletData.meshletVertices, 0, GpuDriven::MeshletVisibilityBindings::kMeshletVertices);
+        encoder.setBuffer(&m_ctx.meshletData.meshletTriangles, 0, GpuDriven::MeshletVisibilityBindings::kMeshletTriangles);
+        encoder.setBuffer(&m_ctx.meshletData.boundsBuffer, 0, GpuDriven::MeshletVisibilityBindings::kBounds);
+        encoder.setBuffer(&m_ctx.sceneMesh.uvBuffer, 0, GpuDriven::MeshletVisibilityBindings::kUvs);
+        encoder.setBuffer(&m_ctx.meshletData.materialIDs, 0, GpuDriven::MeshletVisibilityBindings::kMaterialIds);
+        encoder.setBuffer(&m_ctx.materials.materialBuffer, 0, GpuDriven::MeshletVisibilityBindings::kMaterials);
+        encoder.setBuffer(visibleMeshletBuffer, 0, GpuDriven::MeshletVisibilityBindings::kVisibleMeshlets);
+        encoder.setBuffer(sceneInstanceBuffer, 0, GpuDriven::MeshletVisibilityBindings::kSceneInstances);
+        encoder.setBuffer(lodMeshletBuffer, 0, GpuDriven::MeshletVisibilityBindings::kLodMeshlets);
+        encoder.setBuffer(lodMeshletVerticesBuffer, 0, GpuDriven::MeshletVisibilityBindings::kLodMeshletVertices);
+        encoder.setBuffer(lodMeshletTrianglesBuffer, 0, GpuDriven::MeshletVisibilityBindings::kLodMeshletTriangles);
+        encoder.setBuffer(lodMaterialIdsBuffer, 0, GpuDriven::MeshletVisibilityBindings::kLodMaterialIds);
+        encoder.setBuffer(softwareRasterBuffer, 0, GpuDriven::MeshletVisibilityBindings::kSoftwareRaster);
+
+        // The mesh-dispatch args are a 1D group count, one group per worklist entry.
+        encoder.dispatchThreadgroupsIndirect(*worklistStateBuffer,
+                                             GpuDriven::MeshDispatchCommandLayout::kIndirectArgsOffset,
+                                             {128, 1, 1});
+    }
+
+    void renderUI() override {
+        ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        ImGui::Checkbox("Enabled", &m_enabled);
+        ImGui::Text("Status: %s",
+                    m_active ? "Active"
+                             : (pipelinesAvailable() ? "Disabled" : "Unavailable (needs 64-bit atomics)"));
+    }
+
+private:
+    bool pipelinesAvailable() const {
+        if (!m_runtimeContext) {
+            return false;
+        }
+        const auto& pipelines = m_runtimeContext->computePipelinesRhi;
+        auto clearIt = pipelines.find("SoftwareRasterClearPass");
+        auto rasterIt = pipelines.find("SoftwareRasterPass");
+        return clearIt != pipelines.end() && clearIt->second.nativeHandle() &&
+               rasterIt != pipelines.end() && rasterIt->second.nativeHandle();
+    }
+
+    uint32_t pixelCount() const {
+        return static_cast<uint32_t>(std::max(m_width, 1)) * static_cast<uint32_t>(std::max(m_height, 1));
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Software Raster";
+    bool m_enabled = true;
+    bool m_active = false;
+    FGResource m_visibleMeshletsRead;
+    FGResource m_worklistStateRead;
+    FGResource m_softwareRaster;
+};
+
+METALLIC_REGISTER_PASS(SoftwareRasterPass);
@@ -131,6 +131,44 @@ public:
             if (!uiControls->dlssIsActiveUpscaler) {
                 ImGui::EndDisabled();
             }
+
+            const bool frameGenerationUsable =
+                uiControls->frameGenerationAvailable && uiControls->dlssIsActiveUpscaler;
+            if (!frameGenerationUsable) {
+                ImGui::BeginDisabled();
+            }
+            bool frameGeneration = uiControls->frameGenerationEnabled;
+            if (ImGui::Checkbox("Frame Generation", &frameGeneration) &&
+                uiControls->onFrameGenerationChanged) {
+                uiControls->onFrameGenerationChanged(frameGeneration);
+            }
+            if (!frameGenerationUsable) {
+                ImGui::EndDisabled();
+            }
+
+            if (!uiControls->reflexAvailable) {
+                ImGui::BeginDisabled();
+            }
+            bool reflex = uiControls->reflexEnabled;
+            if (ImGui::Checkbox("Reflex Low Latency", &reflex) && uiControls->onReflexChanged) {
+                uiControls->onReflexChanged(reflex);
+            }
+            if (!uiControls->reflexAvailable) {
+                ImGui::EndDisabled();
+            }
+
+            const LatencyTelemetry& latency = uiControls->latency;
+            if (latency.available) {
+                ImGui::Text("PC Latency: %.2f ms", latency.pcLatencyMs);
+                ImGui::Text("Sim %.2f  Submit %.2f  Present %.2f  GPU %.2f ms",
+                            latency.simulationMs, latency.renderSubmitMs,
+                            latency.presentMs, latency.gpuFrameMs);
+                if (uiControls->frameGenerationEnabled) {
+                    ImGui::Text("Frames presented per render: %u", latency.framesPresented);
+                }
+            } else if (uiControls->reflexAvailable) {
+                ImGui::TextUnformatted("PC Latency: waiting for Reflex reports");
+            }
         }
     }
 
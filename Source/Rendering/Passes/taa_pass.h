@@ -29,6 +29,7 @@ public:
 
     void configure(const PassConfig& config) override {
         m_name = config.name;
+        if (config.config.contains("tiled")) m_tiled = config.config["tiled"].get<bool>();
     }
 
     FGResource getOutput(const std::string& outputName) const override {
@@ -37,6 +38,7 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         m_sourceRead = FGResource{};
         m_depthRead = FGResource{};
         m_motionRead = FGResource{};
@@ -81,6 +83,11 @@ public:
             copyCurrentToOutput(encoder);
             return;
         }
+        // taaTiledMain shares the 3x3 neighborhood through groupshared; same bindings.
+        auto tiledIt = m_runtimeContext->computePipelinesRhi.find("TAATiledPass");
+        m_usingTiled = m_tiled && tiledIt != m_runtimeContext->computePipelinesRhi.end() &&
+                       tiledIt->second.nativeHandle();
+        const RhiComputePipelineHandle& pipeline = m_usingTiled ? tiledIt->second : pipeIt->second;
 
         ensureHistory();
         if (m_frameContext->historyReset) {
@@ -112,7 +119,7 @@ public:
         RhiTexture* historyReadTex = m_historyTextures[1 - m_historyIndex].get();
         RhiTexture* historyWriteTex = m_historyTextures[m_historyIndex].get();
 
-        encoder.setComputePipeline(pipeIt->second);
+        encoder.setComputePipeline(pipeline);
         encoder.setPushConstants(&uniforms, sizeof(uniforms));
         encoder.setTexture(currentTex, 0);
         encoder.setTexture(depthTex, 1);
@@ -132,6 +139,9 @@ public:
 
     void renderUI() override {
         ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        ImGui::Checkbox("Groupshared Neighborhood", &m_tiled);
+        ImGui::SameLine();
+        ImGui::TextDisabled(m_usingTiled ? "(active)" : "(inactive)");
         ImGui::SliderFloat("Blend Min", &m_blendMin, 0.01f, 0.5f, "%.3f");
         ImGui::SliderFloat("Blend Max", &m_blendMax, 0.5f, 1.0f, "%.2f");
         ImGui::SliderFloat("Variance Clip Gamma", &m_varianceClipGamma, 0.5f, 2.0f, "%.2f");
@@ -169,6 +179,7 @@ private:
 
         releaseHistory();
         RhiTextureDesc desc = RhiTextureDesc::storageTexture(w, h, RhiFormat::RGBA16Float);
+        RhiMemoryTagScope historyTag(RhiMemoryTag::History);
         m_historyTextures[0] = m_runtimeContext->resourceFactory->createTexture(desc);
         m_historyTextures[1] = m_runtimeContext->resourceFactory->createTexture(desc);
         m_historyValid = false;
@@ -242,6 +253,8 @@ private:
     float m_blendMax = 1.0f;
     float m_varianceClipGamma = 1.0f;
     float m_motionWeightScale = 20.0f;
+    bool m_tiled = true;
+    bool m_usingTiled = false;
 };
 
 METALLIC_REGISTER_PASS(TAAPass);
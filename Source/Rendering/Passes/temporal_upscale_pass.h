@@ -0,0 +1,219 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+// Vendor-neutral temporal upscaler (temporal_upscale.slang), for GPUs without DLSS.
+// Takes the same inputs as StreamlineDlssPass and writes a display-resolution
+// "upscaledOutput", so it can replace TAAPass when the render scale drops below
+// the display size. Exposure is not an input: like DLSS it sits before
+// AutoExposurePass and weights its samples with the Karis tonemap instead. Without
+// the pipeline, depth or motion vectors it aliases its source input.
+class TemporalUpscalePass : public RenderPass {
+public:
+    TemporalUpscalePass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_renderWidth(w), m_renderHeight(h),
+          m_displayWidth(w), m_displayHeight(h) {}
+
+    METALLIC_PASS_TYPE_INFO(TemporalUpscalePass, "Temporal Upscale", "Post-Process",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("source", "Source"),
+            makeInputSlot("depth", "Depth", true),
+            makeInputSlot("motionVectors", "Motion Vectors", true)
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("upscaledOutput", "Upscaled Output")}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.contains("maxHistoryWeight")) {
+            m_maxHistoryWeight = config.config["maxHistoryWeight"].get<float>();
+        }
+        if (config.config.contains("varianceClipGamma")) {
+            m_varianceClipGamma = config.config["varianceClipGamma"].get<float>();
+        }
+    }
+
+    FGResource getOutput(const std::string& outputName) const override {
+        if (outputName == "upscaledOutput") return m_upscaledOutput;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
+        m_sourceRead = FGResource{};
+        m_depthRead = FGResource{};
+        m_motionRead = FGResource{};
+        m_upscaledOutput = FGResource{};
+        m_prevHistory = FGResource{};
+        m_history = FGResource{};
+        m_passthrough = false;
+
+        FGResource sourceInput = getInput("source");
+        FGResource depthInput = getInput("depth");
+        FGResource motionInput = getInput("motionVectors");
+        if (!activePipeline() || !depthInput.isValid() || !motionInput.isValid()) {
+            m_sourceRead = sourceInput;
+            m_upscaledOutput = sourceInput;
+            m_passthrough = true;
+            return;
+        }
+        if (sourceInput.isValid()) {
+            m_sourceRead = builder.read(sourceInput);
+        }
+        m_depthRead = builder.read(depthInput);
+        m_motionRead = builder.read(motionInput);
+
+        const FGTextureDesc displayDesc = FGTextureDesc::storageTexture(
+            currentDisplayWidth(), currentDisplayHeight(), RhiFormat::RGBA16Float);
+        m_upscaledOutput = builder.create("upscaledOutput", displayDesc);
+        m_prevHistory = builder.readHistory(kHistoryName, displayDesc);
+        m_history = builder.writeHistory(kHistoryName, displayDesc);
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("TemporalUpscalePass");
+        MICROPROFILE_SCOPEI("RenderPass", "TemporalUpscalePass", 0xffff8800);
+        const RhiComputePipeline* pipeline = activePipeline();
+        if (!pipeline || !m_frameContext || m_passthrough || !m_sourceRead.isValid()) return;
+
+        RhiTexture* currentTex = m_frameGraph->getTexture(m_sourceRead);
+        RhiTexture* depthTex = m_frameGraph->getTexture(m_depthRead);
+        RhiTexture* motionTex = m_frameGraph->getTexture(m_motionRead);
+        RhiTexture* outputTex = m_frameGraph->getTexture(m_upscaledOutput);
+        RhiTexture* historyWriteTex = m_frameGraph->getTexture(m_history);
+        if (!currentTex || !depthTex || !motionTex || !outputTex || !historyWriteTex) return;
+
+        struct {
+            float2 jitterOffset;
+            float2 invRenderSize;
+            float2 invDisplaySize;
+            uint32_t renderWidth;
+            uint32_t renderHeight;
+            uint32_t displayWidth;
+            uint32_t displayHeight;
+            uint32_t historyValid;
+            uint32_t reversedZ;
+            float maxHistoryWeight;
+            float varianceClipGamma;
+            float2 pad;
+        } uniforms{};
+        // The source texture is authoritative; the frame sizes can lag a resize by a frame.
+        uniforms.renderWidth = currentTex->width();
+        uniforms.renderHeight = currentTex->height();
+        uniforms.displayWidth = outputTex->width();
+        uniforms.displayHeight = outputTex->height();
+        uniforms.jitterOffset = m_frameContext->jitterOffset;
+        uniforms.invRenderSize = float2(1.0f / uniforms.renderWidth, 1.0f / uniforms.renderHeight);
+        uniforms.invDisplaySize = float2(1.0f / uniforms.displayWidth, 1.0f / uniforms.displayHeight);
+        uniforms.historyValid = !m_frameContext->historyReset &&
+                                m_frameGraph->isHistoryValid(m_prevHistory) ? 1u : 0u;
+        uniforms.reversedZ = ML_DEPTH_REVERSED ? 1u : 0u;
+        uniforms.maxHistoryWeight = std::max(m_maxHistoryWeight, 1.0f);
+        uniforms.varianceClipGamma = m_varianceClipGamma;
+
+        RhiTexture* historyReadTex = uniforms.historyValid ? m_frameGraph->getTexture(m_prevHistory) : nullptr;
+        encoder.setComputePipeline(*pipeline);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.setTexture(currentTex, 0);
+        encoder.setTexture(depthTex, 1);
+        encoder.setTexture(motionTex, 2);
+        // Without history the shader never reads slot 3.
+        encoder.setTexture(historyReadTex ? historyReadTex : currentTex, 3);
+        encoder.setStorageTexture(outputTex, 4);
+        encoder.setStorageTexture(historyWriteTex, 5);
+        bindTonemapSampler(encoder);
+
+        encoder.dispatchThreadgroups({(uniforms.displayWidth + 7) / 8, (uniforms.displayHeight + 7) / 8, 1},
+                                     {8, 8, 1});
+        m_frameGraph->commitHistory(m_history);
+    }
+
+    void renderUI() override {
+        ImGui::Text("Temporal Upscale %d x %d -> %d x %d",
+                    currentRenderWidth(), currentRenderHeight(),
+                    currentDisplayWidth(), currentDisplayHeight());
+        ImGui::TextUnformatted(m_passthrough ? "Mode: Pass-through" : "Mode: Upscaling");
+        ImGui::SliderFloat("Max History Weight", &m_maxHistoryWeight, 1.0f, 32.0f, "%.1f");
+        ImGui::SliderFloat("Variance Clip Gamma", &m_varianceClipGamma, 0.5f, 2.0f, "%.2f");
+    }
+
+private:
+    static constexpr const char* kHistoryName = "TemporalUpscaleHistory";
+
+    const RhiComputePipeline* activePipeline() const {
+        if (!m_runtimeContext) return nullptr;
+        auto it = m_runtimeContext->computePipelinesRhi.find("TemporalUpscalePass");
+        if (it == m_runtimeContext->computePipelinesRhi.end() || !it->second.nativeHandle()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    void bindTonemapSampler(RhiComputeCommandEncoder& encoder) const {
+        auto samplerIt = m_runtimeContext->samplersRhi.find("tonemap");
+        if (samplerIt != m_runtimeContext->samplersRhi.end() && samplerIt->second.nativeHandle()) {
+            encoder.setSampler(&samplerIt->second, 0);
+        }
+    }
+
+    int currentRenderWidth() const {
+        if (m_frameContext && m_frameContext->renderWidth > 0) {
+            return m_frameContext->renderWidth;
+        }
+        if (m_runtimeContext && m_runtimeContext->renderWidth > 0) {
+            return m_runtimeContext->renderWidth;
+        }
+        return m_renderWidth;
+    }
+
+    int currentRenderHeight() const {
+        if (m_frameContext && m_frameContext->renderHeight > 0) {
+            return m_frameContext->renderHeight;
+        }
+        if (m_runtimeContext && m_runtimeContext->renderHeight > 0) {
+            return m_runtimeContext->renderHeight;
+        }
+        return m_renderHeight;
+    }
+
+    int currentDisplayWidth() const {
+        if (m_frameContext && m_frameContext->displayWidth > 0) {
+            return m_frameContext->displayWidth;
+        }
+        if (m_runtimeContext && m_runtimeContext->displayWidth > 0) {
+            return m_runtimeContext->displayWidth;
+        }
+        return m_displayWidth;
+    }
+
+    int currentDisplayHeight() const {
+        if (m_frameContext && m_frameContext->displayHeight > 0) {
+            return m_frameContext->displayHeight;
+        }
+        if (m_runtimeContext && m_runtimeContext->displayHeight > 0) {
+            return m_runtimeContext->displayHeight;
+        }
+        return m_displayHeight;
+    }
+
+    const RenderContext& m_ctx;
+    int m_renderWidth, m_renderHeight;
+    int m_displayWidth, m_displayHeight;
+    std::string m_name = "Temporal Upscale";
+    bool m_passthrough = false;
+    float m_maxHistoryWeight = 12.0f;
+    float m_varianceClipGamma = 1.0f;
+
+    FGResource m_sourceRead, m_depthRead, m_motionRead, m_upscaledOutput;
+    FGResource m_prevHistory, m_history;
+};
+
+METALLIC_REGISTER_PASS(TemporalUpscalePass);
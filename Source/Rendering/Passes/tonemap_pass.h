@@ -4,6 +4,7 @@
 #include "render_uniforms.h"
 #include "frame_context.h"
 #include "pass_registry.h"
+#include "post_lens.h"
 #include "imgui.h"
 
 class TonemapPass : public RenderPass {
@@ -14,7 +15,9 @@ public:
     METALLIC_PASS_TYPE_INFO(TonemapPass, "Tonemap", "Post-Process",
         (std::vector<PassSlotInfo>{
             makeInputSlot("source", "Source"),
-            makeInputSlot("exposureLut", "Exposure LUT", true)
+            makeInputSlot("exposureLut", "Exposure LUT", true),
+            makeInputSlot("postPyramid", "Post Pyramid", true),
+            makeInputSlot("depth", "Depth", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("output", "Output", false, {"transient", "imported", "backbuffer"})
@@ -31,6 +34,9 @@ public:
             m_sourceProducerType = sourceBinding->producerPassType;
         }
         m_hasExposureLutInput = config.findInputBinding("exposureLut") != nullptr;
+        m_hasPyramidInput = config.findInputBinding("postPyramid") != nullptr;
+        m_hasDepthInput = config.findInputBinding("depth") != nullptr;
+        m_lens.configure(config.config);
         if (config.config.contains("method")) {
             std::string method = config.config["method"].get<std::string>();
             if (method == "Filmic") m_method = 0;
@@ -55,8 +61,11 @@ public:
     }
 
     void setup(FGBuilder& builder) override {
+        builder.allowParallelRecording();
         m_sourceRead = FGResource{};
         m_exposureLutRead = FGResource{};
+        m_pyramidRead = FGResource{};
+        m_depthRead = FGResource{};
         m_dest = FGResource{};
 
         FGResource sourceInput = getInput("source");
@@ -71,6 +80,19 @@ public:
             }
         }
 
+        if (m_hasPyramidInput) {
+            FGResource pyramidInput = getInput("postPyramid");
+            if (pyramidInput.isValid()) {
+                m_pyramidRead = builder.read(pyramidInput);
+            }
+        }
+        if (m_hasDepthInput) {
+            FGResource depthInput = getInput("depth");
+            if (depthInput.isValid()) {
+                m_depthRead = builder.read(depthInput);
+            }
+        }
+
         m_dest = getOutputTarget("output");
         if (!m_dest.isValid()) {
             m_dest = builder.create("tonemapOutput",
@@ -107,7 +129,8 @@ public:
             outputHeight = static_cast<uint32_t>(m_frameContext->displayHeight);
         }
 
-        TonemapUniforms uniforms{};
+        TonemapPassUniforms passUniforms{};
+        TonemapUniforms& uniforms = passUniforms.tonemap;
         uniforms.isActive = m_enabled ? 1u : 0u;
         uniforms.method = static_cast<uint32_t>(m_method);
         uniforms.exposure = m_exposure;
@@ -123,15 +146,30 @@ public:
         uniforms.pad = 0.0f;
         uniforms.autoExposure = (m_autoExposure && m_exposureLutRead.isValid()) ? 1u : 0u;
 
+        RhiTexture* sourceTex = m_frameGraph->getTexture(m_sourceRead);
+        RhiTexture* pyramidTex = m_pyramidRead.isValid() ? m_frameGraph->getTexture(m_pyramidRead) : nullptr;
+        RhiTexture* depthTex = m_depthRead.isValid() ? m_frameGraph->getTexture(m_depthRead) : nullptr;
+        auto pyramidSamplerIt = m_runtimeContext->samplersRhi.find("postPyramid");
+        const bool hasPyramidSampler = pyramidSamplerIt != m_runtimeContext->samplersRhi.end() &&
+                                       pyramidSamplerIt->second.nativeHandle();
+        if (m_frameContext && sourceTex && hasPyramidSampler) {
+            passUniforms.lens = m_lens.uniforms(*m_frameContext, pyramidTex,
+                                                sourceTex->width(), sourceTex->height(), depthTex != nullptr);
+        }
+
         encoder.setRenderPipeline(pipeIt->second);
         encoder.setViewport(static_cast<float>(outputWidth), static_cast<float>(outputHeight), false);
         encoder.setCullMode(RhiCullMode::None);
-        encoder.setFragmentTexture(m_frameGraph->getTexture(m_sourceRead), 0);
+        encoder.setFragmentTexture(sourceTex, 0);
         encoder.setFragmentSampler(&samplerIt->second, 0);
         if (m_exposureLutRead.isValid()) {
             encoder.setFragmentTexture(m_frameGraph->getTexture(m_exposureLutRead), 1);
         }
-        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        // Unused lens slots still need a bound texture.
+        encoder.setFragmentTexture(pyramidTex ? pyramidTex : sourceTex, 2);
+        encoder.setFragmentTexture(depthTex ? depthTex : sourceTex, 3);
+        encoder.setFragmentSampler(hasPyramidSampler ? &pyramidSamplerIt->second : &samplerIt->second, 1);
+        encoder.setPushConstants(&passUniforms, sizeof(passUniforms));
         encoder.drawPrimitives(RhiPrimitiveType::Triangle, 0, 3);
     }
 
@@ -155,12 +193,16 @@ public:
         ImGui::SliderFloat("Saturation", &m_saturation, 0.0f, 2.0f, "%.2f");
         ImGui::SliderFloat("Vignette", &m_vignette, 0.0f, 1.0f, "%.2f");
         ImGui::Checkbox("Dither", &m_dither);
+        ImGui::Separator();
+        m_lens.renderUI(m_hasPyramidInput, m_hasDepthInput);
     }
 
 private:
     const RenderContext& m_ctx;
     FGResource m_sourceRead;
     FGResource m_exposureLutRead;
+    FGResource m_pyramidRead;
+    FGResource m_depthRead;
     FGResource m_dest;
     int m_width, m_height;
     std::string m_name = "Tonemap";
@@ -174,6 +216,9 @@ private:
     bool m_dither = true;
     bool m_autoExposure = false;
     bool m_hasExposureLutInput = false;
+    bool m_hasPyramidInput = false;
+    bool m_hasDepthInput = false;
+    PostLensSettings m_lens;
     std::string m_sourceProducerType;
 
     int currentRenderWidth() const {
@@ -216,12 +261,17 @@ private:
         return m_height;
     }
 
+    bool sourceIsUpscaled() const {
+        return m_sourceProducerType == "StreamlineDlssPass" ||
+               m_sourceProducerType == "TemporalUpscalePass";
+    }
+
     int currentOutputWidth() const {
-        return m_sourceProducerType == "StreamlineDlssPass" ? currentDisplayWidth() : currentRenderWidth();
+        return sourceIsUpscaled() ? currentDisplayWidth() : currentRenderWidth();
     }
 
     int currentOutputHeight() const {
-        return m_sourceProducerType == "StreamlineDlssPass" ? currentDisplayHeight() : currentRenderHeight();
+        return sourceIsUpscaled() ? currentDisplayHeight() : currentRenderHeight();
     }
 };
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "gpu_driven_constants.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+// Propagates GpuSceneTables' transform hierarchy on the GPU and writes every
+// instance's world transform, previous transform and cull sphere in place, so
+// the CPU only uploads edited local matrices. Wire transformSync into
+// MeshletCullPass so culling sees this frame's matrices. Without hierarchy
+// buffers or the pipeline it records nothing and the CPU keeps uploading
+// instance matrices.
+class TransformHierarchyPass : public RenderPass {
+public:
+    TransformHierarchyPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    ~TransformHierarchyPass() override = default;
+
+    METALLIC_PASS_TYPE_INFO(TransformHierarchyPass, "Transform Hierarchy", "Geometry",
+        (std::vector<PassSlotInfo>{}),
+        (std::vector<PassSlotInfo>{
+            makeOutputSlot("transformSync", "Transform Sync")
+        }),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "transformSync") {
+            return m_transformSync;
+        }
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_transformSync = builder.createToken("TransformHierarchySync");
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("TransformHierarchyPass");
+        MICROPROFILE_SCOPEI("RenderPass", "TransformHierarchyPass", 0xffff8800);
+        m_lastLevelCount = 0;
+        if (!m_runtimeContext) return;
+
+        const GpuSceneTables& gpuScene = m_ctx.gpuScene;
+        if (!gpuScene.gpuTransformPropagation ||
+            !gpuScene.instanceBuffer.nativeHandle() ||
+            !gpuScene.instancePrevTransformBuffer.nativeHandle() ||
+            !gpuScene.instanceCullBuffer.nativeHandle() ||
+            !gpuScene.hierarchyWorldBuffer.nativeHandle() ||
+            gpuScene.hierarchyLevelStart.size() < 2) {
+            return;
+        }
+
+        auto pipelineIt = m_runtimeContext->computePipelinesRhi.find("TransformHierarchyPass");
+        if (pipelineIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !pipelineIt->second.nativeHandle()) {
+            return;
+        }
+
+        using Bindings = GpuDriven::TransformHierarchyBindings;
+        encoder.setComputePipeline(pipelineIt->second);
+        encoder.setBuffer(&gpuScene.hierarchySlotBuffer, 0, Bindings::kSlots);
+        encoder.setBuffer(&gpuScene.hierarchyLocalBuffer, 0, Bindings::kLocals);
+        encoder.setBuffer(&gpuScene.hierarchyWorldBuffer, 0, Bindings::kWorlds);
+        encoder.setBuffer(&gpuScene.instanceBuffer, 0, Bindings::kInstances);
+        encoder.setBuffer(&gpuScene.instancePrevTransformBuffer, 0, Bindings::kPrevTransforms);
+        encoder.setBuffer(&gpuScene.instanceCullBuffer, 0, Bindings::kInstanceCull);
+        encoder.setBuffer(&gpuScene.geometryBuffer, 0, Bindings::kGeometries);
+
+        const std::vector<uint32_t>& levelStart = gpuScene.hierarchyLevelStart;
+        for (size_t level = 0; level + 1 < levelStart.size(); ++level) {
+            struct {
+                uint32_t levelBegin;
+                uint32_t levelCount;
+            } uniforms{levelStart[level], levelStart[level + 1] - levelStart[level]};
+            if (level > 0) {
+                encoder.memoryBarrier(RhiBarrierScope::Buffers);
+            }
+            encoder.setPushConstants(&uniforms, sizeof(uniforms));
+            encoder.dispatchThreadgroups(
+                {(uniforms.levelCount + Bindings::kThreadgroupSize - 1) / Bindings::kThreadgroupSize, 1, 1},
+                {Bindings::kThreadgroupSize, 1, 1});
+        }
+        m_lastLevelCount = static_cast<uint32_t>(levelStart.size() - 1);
+    }
+
+    void renderUI() override {
+        const GpuSceneTables& gpuScene = m_ctx.gpuScene;
+        ImGui::Text("GPU propagation: %s", gpuScene.gpuTransformPropagation ? "Active" : "Inactive");
+        ImGui::Text("Nodes: %zu", gpuScene.hierarchyNodeSlot.size());
+        ImGui::Text("Levels dispatched: %u", m_lastLevelCount);
+    }
+
+private:
+    const RenderContext& m_ctx;
+    FGResource m_transformSync;
+    int m_width, m_height;
+    std::string m_name = "Transform Hierarchy";
+    uint32_t m_lastLevelCount = 0;
+};
+
+METALLIC_REGISTER_PASS(TransformHierarchyPass);
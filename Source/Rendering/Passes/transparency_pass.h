@@ -0,0 +1,225 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "gpu_driven_helpers.h"
+#include "gpu_cull_resources.h"
+#include "cluster_lod_builder.h"
+#include "pass_registry.h"
+#include "imgui.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Weighted-blended transparency for the clusters the cull bins as
+// kMeshletDrawTransparentBit (glTF BLEND materials), which VisibilityPass skips.
+// Render pipelines here have one color attachment, so the two OIT targets are two
+// instances of this pass over the same final worklist: "target": "accumulation"
+// (RGBA16F, additive, cleared to 0) and "target": "revealage" (R16F, multiplied by
+// 1 - alpha, cleared to 1). Both depth test against the opaque depth without
+// writing it, and OitCompositePass resolves them over the lit image. Transparent
+// clusters are forward shaded with the sun and a flat ambient only, and cast no
+// cascade shadows.
+class TransparencyPass : public RenderPass {
+public:
+    TransparencyPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    METALLIC_PASS_TYPE_INFO(TransparencyPass, "Transparency", "Geometry",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("visibilityWorklist", "Visibility Worklist"),
+            makeInputSlot("visibilityWorklistState", "Visibility Worklist State"),
+            makeInputSlot("depth", "Depth")
+        }),
+        (std::vector<PassSlotInfo>{makeOutputSlot("oit", "OIT Target")}),
+        PassTypeInfo::PassType::Render);
+
+    FGPassType passType() const override { return FGPassType::Render; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+        if (config.config.is_object() && config.config.contains("target")) {
+            m_revealage = config.config["target"].get<std::string>() == "revealage";
+        }
+        if (config.config.is_object() && config.config.contains("depthScale")) {
+            m_depthScale = config.config["depthScale"].get<float>();
+        }
+        if (config.config.is_object() && config.config.contains("ambientScale")) {
+            m_ambientScale = config.config["ambientScale"].get<float>();
+        }
+    }
+
+    FGResource oit;
+
+    FGResource getOutput(const std::string& name) const override {
+        if (name == "oit") return oit;
+        return FGResource{};
+    }
+
+    void setup(FGBuilder& builder) override {
+        m_visibleMeshletsRead = FGResource{};
+        m_worklistStateRead = FGResource{};
+        FGResource visibleMeshletsInput = getInput("visibilityWorklist");
+        if (visibleMeshletsInput.isValid()) {
+            m_visibleMeshletsRead = builder.read(visibleMeshletsInput, FGResourceUsage::StorageRead);
+        }
+        FGResource worklistStateInput = getInput("visibilityWorklistState");
+        if (worklistStateInput.isValid()) {
+            m_worklistStateRead = builder.read(worklistStateInput, FGResourceUsage::Indirect);
+        }
+
+        oit = builder.create(m_revealage ? "revealage" : "accumulation",
+                             FGTextureDesc::renderTarget(m_width, m_height,
+                                                         m_revealage ? RhiFormat::R16Float
+                                                                     : RhiFormat::RGBA16Float));
+        oit = builder.setColorAttachment(0, oit, RhiLoadAction::Clear, RhiStoreAction::Store,
+                                         m_revealage ? RhiClearColor(1.0, 1.0, 1.0, 1.0)
+                                                     : RhiClearColor(0.0, 0.0, 0.0, 0.0));
+        FGResource depthInput = getInput("depth");
+        if (depthInput.isValid()) {
+            builder.setDepthAttachment(depthInput, RhiLoadAction::Load, RhiStoreAction::Store);
+        }
+    }
+
+    void executeRender(RhiRenderCommandEncoder& encoder) override {
+        ZoneScopedN("TransparencyPass");
+        MICROPROFILE_SCOPEI("RenderPass", "TransparencyPass", 0xffff8800);
+        m_drewLastFrame = false;
+        if (!m_frameContext || !m_runtimeContext || !m_frameContext->gpuDrivenCulling) return;
+
+        const RhiBuffer* visibleMeshletBuffer =
+            m_visibleMeshletsRead.isValid() ? m_frameGraph->getBuffer(m_visibleMeshletsRead) : nullptr;
+        const RhiBuffer* worklistStateBuffer =
+            m_worklistStateRead.isValid() ? m_frameGraph->getBuffer(m_worklistStateRead) : nullptr;
+        const RhiBuffer* sceneInstanceBuffer =
+            m_ctx.gpuScene.instanceBuffer.nativeHandle() ? &m_ctx.gpuScene.instanceBuffer : nullptr;
+        const RhiGraphicsPipeline* pipeline = activePipeline();
+        // The targets are already cleared; an empty bin composites to the source.
+        if (!pipeline || !visibleMeshletBuffer || !worklistStateBuffer || !sceneInstanceBuffer ||
+            !hasTransparentMaterials()) {
+            return;
+        }
+
+        encoder.setRenderPipeline(*pipeline);
+        encoder.setDepthStencilState(&m_ctx.depthReadState);
+        encoder.setFrontFacingWinding(RhiWinding::CounterClockwise);
+        // Glass and foliage cards are often single sided; both faces count.
+        encoder.setCullMode(RhiCullMode::None);
+
+        const RhiBuffer* lodMeshletBuffer =
+            m_ctx.clusterLodData.meshletBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletBuffer
+                : &m_ctx.meshletData.meshletBuffer;
+        const RhiBuffer* lodMeshletVerticesBuffer =
+            m_ctx.clusterLodData.meshletVerticesBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletVerticesBuffer
+                : &m_ctx.meshletData.meshletVertices;
+        const RhiBuffer* lodMeshletTrianglesBuffer =
+            m_ctx.clusterLodData.meshletTrianglesBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.meshletTrianglesBuffer
+                : &m_ctx.meshletData.meshletTriangles;
+        const RhiBuffer* lodMaterialIdsBuffer =
+            m_ctx.clusterLodData.materialIDsBuffer.nativeHandle()
+                ? &m_ctx.clusterLodData.materialIDsBuffer
+                : &m_ctx.meshletData.materialIDs;
+
+        // Same indices as VisibilityPass's GPU path (visibility_indirect.slang).
+        const struct {
+            const RhiBuffer* buffer;
+            uint32_t index;
+        } bindings[] = {
+            {&m_ctx.sceneMesh.positionBuffer, GpuDriven::MeshletVisibilityBindings::kPositions},
+            {&m_ctx.sceneMesh.normalBuffer, GpuDriven::MeshletVisibilityBindings::kNormals},
+            {&m_ctx.meshletData.meshletBuffer, GpuDriven::MeshletVisibilityBindings::kMeshlets},
+            {&m_ctx.meshletData.meshletVertices, GpuDriven::MeshletVisibilityBindings::kMeshletVertices},
+            {&m_ctx.meshletData.meshletTriangles, GpuDriven::MeshletVisibilityBindings::kMeshletTriangles},
+            {&m_ctx.meshletData.boundsBuffer, GpuDriven::MeshletVisibilityBindings::kBounds},
+            {&m_ctx.sceneMesh.uvBuffer, GpuDriven::MeshletVisibilityBindings::kUvs},
+            {&m_ctx.meshletData.materialIDs, GpuDriven::MeshletVisibilityBindings::kMaterialIds},
+            {&m_ctx.materials.materialBuffer, GpuDriven::MeshletVisibilityBindings::kMaterials},
+            {visibleMeshletBuffer, GpuDriven::MeshletVisibilityBindings::kVisibleMeshlets},
+            {sceneInstanceBuffer, GpuDriven::MeshletVisibilityBindings::kSceneInstances},
+            {lodMeshletBuffer, GpuDriven::MeshletVisibilityBindings::kLodMeshlets},
+            {lodMeshletVerticesBuffer, GpuDriven::MeshletVisibilityBindings::kLodMeshletVertices},
+            {lodMeshletTrianglesBuffer, GpuDriven::MeshletVisibilityBindings::kLodMeshletTriangles},
+            {lodMaterialIdsBuffer, GpuDriven::MeshletVisibilityBindings::kLodMaterialIds},
+        };
+        for (const auto& binding : bindings) {
+            encoder.setMeshBuffer(binding.buffer, 0, binding.index);
+            encoder.setFragmentBuffer(binding.buffer, 0, binding.index);
+        }
+
+        if (!m_runtimeContext->useBindlessSceneTextures && !m_ctx.materials.textureViews.empty()) {
+            std::pmr::vector<const RhiTexture*> materialTextures(m_ctx.materials.textureViews.begin(),
+                                                                 m_ctx.materials.textureViews.end(),
+                                                                 m_frameContext->frameMemory);
+            encoder.setFragmentTextures(materialTextures.data(), 0, static_cast<uint32_t>(materialTextures.size()));
+            encoder.setFragmentSampler(&m_ctx.materials.sampler, 0);
+        }
+
+        struct {
+            float4x4 viewProj;
+            float4x4 view;
+            float4 lightDir;
+            float4 lightColorIntensity;
+            float4 ambientColor;
+            float depthScale;
+            float pad[3];
+        } uniforms{};
+        uniforms.viewProj = transpose(m_frameContext->proj * m_frameContext->view);
+        uniforms.view = transpose(m_frameContext->view);
+        uniforms.lightDir = m_frameContext->viewLightDir;
+        uniforms.lightColorIntensity = m_frameContext->lightColorIntensity;
+        const float ambient = m_frameContext->lightColorIntensity.w * m_ambientScale;
+        uniforms.ambientColor = float4(m_frameContext->lightColorIntensity.x * ambient,
+                                       m_frameContext->lightColorIntensity.y * ambient,
+                                       m_frameContext->lightColorIntensity.z * ambient, 0.0f);
+        uniforms.depthScale = std::max(m_depthScale, 1e-3f);
+        encoder.setMeshBytes(&uniforms, sizeof(uniforms), GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+        encoder.setFragmentBytes(&uniforms, sizeof(uniforms), GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+
+        encoder.drawMeshThreadgroupsIndirect(*worklistStateBuffer,
+                                             GpuDriven::MeshDispatchCommandLayout::kIndirectArgsOffset,
+                                             {1, 1, 1},
+                                             {128, 1, 1});
+        m_drewLastFrame = true;
+    }
+
+    void renderUI() override {
+        ImGui::Text("Target: %s", m_revealage ? "Revealage" : "Accumulation");
+        ImGui::Text("Drew Last Frame: %s", m_drewLastFrame ? "Yes" : "No");
+        ImGui::SliderFloat("Weight Depth Scale", &m_depthScale, 1.0f, 1000.0f, "%.0f");
+        ImGui::SliderFloat("Ambient Scale", &m_ambientScale, 0.0f, 0.5f, "%.3f");
+    }
+
+private:
+    const RhiGraphicsPipeline* activePipeline() const {
+        auto it = m_runtimeContext->renderPipelinesRhi.find(m_revealage ? "TransparencyRevealagePass"
+                                                                        : "TransparencyAccumulatePass");
+        if (it == m_runtimeContext->renderPipelinesRhi.end() || !it->second.nativeHandle()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    bool hasTransparentMaterials() const {
+        return std::any_of(m_ctx.materials.cpuMaterials.begin(), m_ctx.materials.cpuMaterials.end(),
+                           [](const GPUMaterial& material) { return material.alphaMode == 2u; });
+    }
+
+    const RenderContext& m_ctx;
+    int m_width, m_height;
+    std::string m_name = "Transparency";
+    bool m_revealage = false;
+    bool m_drewLastFrame = false;
+    // View depth at which the OIT weight starts to fall off; the paper's 200 units.
+    float m_depthScale = 200.0f;
+    // Flat ambient as a fraction of the sun, in place of the deferred path's sky term.
+    float m_ambientScale = 0.05f;
+    FGResource m_visibleMeshletsRead;
+    FGResource m_worklistStateRead;
+};
+
+METALLIC_REGISTER_PASS(TransparencyPass);
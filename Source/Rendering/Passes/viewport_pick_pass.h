@@ -0,0 +1,205 @@
+#pragma once
+
+#include "render_pass.h"
+#include "frame_context.h"
+#include "gpu_driven_constants.h"
+#include "gpu_driven_helpers.h"
+#include "pass_registry.h"
+#include "viewport_pick.h"
+#include "imgui.h"
+
+#ifdef _WIN32
+#include "rhi_resource_utils.h"
+#include "vulkan_upload_service.h"
+#include "vulkan_resource_handles.h"
+#endif
+
+#include <algorithm>
+
+// Serves PipelineRuntimeContext::viewportPick: when the editor requested a
+// pick, decodes that texel of the visibility buffer into a scene node on the
+// GPU and reads the 16-byte result back through VulkanReadbackService. Cost
+// does not depend on scene size. Records nothing without a pending request,
+// and on backends without a readback service.
+class ViewportPickPass : public RenderPass {
+public:
+    ViewportPickPass(const RenderContext& ctx, int w, int h)
+        : m_ctx(ctx), m_width(w), m_height(h) {}
+
+    ~ViewportPickPass() override = default;
+
+    METALLIC_PASS_TYPE_INFO(ViewportPickPass, "Viewport Pick", "Utility",
+        (std::vector<PassSlotInfo>{
+            makeInputSlot("visibility", "Visibility"),
+            makeInputSlot("visibilityWorklist", "Visibility Worklist", true),
+            makeInputSlot("visibilityWorklistState", "Visibility Worklist State", true)
+        }),
+        (std::vector<PassSlotInfo>{}),
+        PassTypeInfo::PassType::Compute);
+
+    FGPassType passType() const override { return FGPassType::Compute; }
+    const char* name() const override { return m_name.c_str(); }
+
+    void configure(const PassConfig& config) override {
+        m_name = config.name;
+    }
+
+    void setup(FGBuilder& builder) override {
+        FGResource visInput = getInput("visibility");
+        FGResource visibleMeshletsInput = getInput("visibilityWorklist");
+        FGResource visibleMeshletStateInput = getInput("visibilityWorklistState");
+        m_visRead = visInput.isValid() ? builder.read(visInput) : FGResource{};
+        m_visibleMeshletsRead = visibleMeshletsInput.isValid()
+            ? builder.read(visibleMeshletsInput, FGResourceUsage::StorageRead)
+            : FGResource{};
+        m_visibleMeshletStateRead = visibleMeshletStateInput.isValid()
+            ? builder.read(visibleMeshletStateInput, FGResourceUsage::StorageRead)
+            : FGResource{};
+        m_result = builder.create("pickResult",
+            GpuDriven::makeStructuredBufferDesc<GPUPickResult>(1, "ViewportPickResult"));
+    }
+
+    void prepareResources(RhiCommandBuffer&) override {
+#ifdef _WIN32
+        consumeReadback();
+#endif
+    }
+
+    void executeCompute(RhiComputeCommandEncoder& encoder) override {
+        ZoneScopedN("ViewportPickPass");
+        MICROPROFILE_SCOPEI("RenderPass", "ViewportPickPass", 0xffff8800);
+#ifdef _WIN32
+        if (!m_runtimeContext || !m_frameContext || !m_runtimeContext->viewportPick ||
+            !m_runtimeContext->readbackService || !m_visRead.isValid()) {
+            return;
+        }
+        ViewportPickState& pick = *m_runtimeContext->viewportPick;
+        // One pick in flight at a time; a newer request waits for the slot.
+        if (!pick.requested || m_readback.valid()) {
+            return;
+        }
+        if (!m_ctx.gpuScene.instanceBuffer.nativeHandle()) {
+            return;
+        }
+
+        auto pipelineIt = m_runtimeContext->computePipelinesRhi.find("ViewportPickPass");
+        if (pipelineIt == m_runtimeContext->computePipelinesRhi.end() ||
+            !pipelineIt->second.nativeHandle()) {
+            return;
+        }
+
+        const RhiBuffer* resultBuffer = m_frameGraph->getBuffer(m_result);
+        const VkBuffer vkResultBuffer = getVulkanBufferHandle(resultBuffer);
+        const VkCommandBuffer commandBuffer = static_cast<VkCommandBuffer>(encoder.nativeHandle());
+        if (vkResultBuffer == VK_NULL_HANDLE || commandBuffer == VK_NULL_HANDLE) {
+            return;
+        }
+
+        const RhiBuffer* visibleMeshletsBuffer =
+            m_visibleMeshletsRead.isValid() ? m_frameGraph->getBuffer(m_visibleMeshletsRead) : nullptr;
+        const RhiBuffer* visibleMeshletStateBuffer =
+            m_visibleMeshletStateRead.isValid() ? m_frameGraph->getBuffer(m_visibleMeshletStateRead) : nullptr;
+
+        struct {
+            uint32_t pixel[2];
+            uint32_t worklistIds;
+            uint32_t instanceCount;
+        } uniforms{};
+        uniforms.pixel[0] = std::min(pick.x, static_cast<uint32_t>(std::max(m_width - 1, 0)));
+        uniforms.pixel[1] = std::min(pick.y, static_cast<uint32_t>(std::max(m_height - 1, 0)));
+        // Same rule as DeferredLightingPass: only 32-bit GPU-driven values hold worklist indices.
+        uniforms.worklistIds = (!m_runtimeContext->visibility64 &&
+                                m_frameContext->gpuDrivenCulling &&
+                                visibleMeshletsBuffer && visibleMeshletStateBuffer) ? 1u : 0u;
+        uniforms.instanceCount = m_ctx.gpuScene.instanceCount;
+
+        using Bindings = GpuDriven::ViewportPickBindings;
+        encoder.setComputePipeline(pipelineIt->second);
+        // The instance table stands in for the worklist buffers the shader skips.
+        encoder.setBuffer(visibleMeshletsBuffer ? visibleMeshletsBuffer : &m_ctx.gpuScene.instanceBuffer,
+                          0, Bindings::kVisibleMeshlets);
+        encoder.setBuffer(visibleMeshletStateBuffer ? visibleMeshletStateBuffer : &m_ctx.gpuScene.instanceBuffer,
+                          0, Bindings::kVisibleMeshletState);
+        encoder.setBuffer(&m_ctx.gpuScene.instanceBuffer, 0, Bindings::kInstances);
+        encoder.setBuffer(resultBuffer, 0, Bindings::kResult);
+        encoder.setTexture(m_frameGraph->getTexture(m_visRead), Bindings::kVisibilityTexture);
+        encoder.setPushConstants(&uniforms, sizeof(uniforms));
+        encoder.dispatchThreadgroups({1, 1, 1}, {1, 1, 1});
+
+        VkBufferMemoryBarrier2 resultBarrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2};
+        resultBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        resultBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        resultBarrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        resultBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        resultBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        resultBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        resultBarrier.buffer = vkResultBuffer;
+        resultBarrier.offset = 0u;
+        resultBarrier.size = sizeof(GPUPickResult);
+
+        VkDependencyInfo dependencyInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dependencyInfo.bufferMemoryBarrierCount = 1;
+        dependencyInfo.pBufferMemoryBarriers = &resultBarrier;
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+        VulkanReadbackService* readbackService = m_runtimeContext->readbackService;
+        m_readback = readbackService->scheduleBufferReadback(vkResultBuffer, 0u, sizeof(GPUPickResult));
+        readbackService->recordPendingReadbacks(commandBuffer);
+        if (m_readback.valid()) {
+            pick.requested = false;
+        }
+#else
+        (void)encoder;
+#endif
+    }
+
+    void renderUI() override {
+        const ViewportPickState* pick = m_runtimeContext ? m_runtimeContext->viewportPick : nullptr;
+        if (!pick) {
+            ImGui::TextDisabled("No pick state bound");
+            return;
+        }
+        ImGui::Text("Pending: %s", pick->requested ? "Yes" : "No");
+        if (m_lastResult.sceneNode != UINT32_MAX) {
+            ImGui::Text("Last node: %u", m_lastResult.sceneNode);
+            ImGui::Text("Instance: %u  Meshlet: %u  Triangle: %u",
+                        m_lastResult.instance, m_lastResult.meshlet, m_lastResult.triangle);
+        } else {
+            ImGui::TextDisabled("Last pick hit nothing");
+        }
+    }
+
+private:
+#ifdef _WIN32
+    void consumeReadback() {
+        if (!m_readback.valid() || !m_runtimeContext || !m_frameContext ||
+            !m_runtimeContext->readbackService || !m_runtimeContext->viewportPick) {
+            return;
+        }
+        VulkanReadbackService* readbackService = m_runtimeContext->readbackService;
+        if (!readbackService->isReady(m_readback, m_frameContext->frameIndex)) {
+            return;
+        }
+        GPUPickResult result;
+        if (readbackService->readData(m_readback, &result, sizeof(result))) {
+            m_lastResult = result;
+            m_runtimeContext->viewportPick->result = result;
+            m_runtimeContext->viewportPick->resultReady = true;
+        }
+        m_readback = {};
+    }
+
+    VulkanReadbackService::ReadbackRequest m_readback;
+#endif
+
+    const RenderContext& m_ctx;
+    FGResource m_visRead;
+    FGResource m_visibleMeshletsRead;
+    FGResource m_visibleMeshletStateRead;
+    FGResource m_result;
+    GPUPickResult m_lastResult;
+    int m_width, m_height;
+    std::string m_name = "Viewport Pick";
+};
+
+METALLIC_REGISTER_PASS(ViewportPickPass);
@@ -5,6 +5,7 @@
 #include "frame_context.h"
 #include "gpu_driven_helpers.h"
 #include "gpu_cull_resources.h"
+#include "gpu_driven_telemetry.h"
 #include "cluster_lod_builder.h"
 #include "pass_registry.h"
 #include "imgui.h"
@@ -29,7 +30,8 @@ public:
             makeInputSlot("visibilityIndirectArgs", "Visibility Indirect Args", true),
             makeInputSlot("visibilityInstances", "Visibility Instances", true),
             makeInputSlot("visibilityInput", "Visibility Input", true),
-            makeInputSlot("depthInput", "Depth Input", true)
+            makeInputSlot("depthInput", "Depth Input", true),
+            makeInputSlot("softwareRaster", "Software Raster", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("visibility", "Visibility"),
@@ -49,7 +51,8 @@ public:
             makeHiddenInputSlot("visibilityIndirectArgs", "Visibility Indirect Args", true),
             makeHiddenInputSlot("visibilityInstances", "Visibility Instances", true),
             makeHiddenInputSlot("visibilityInput", "Visibility Input", true),
-            makeHiddenInputSlot("depthInput", "Depth Input", true)
+            makeHiddenInputSlot("depthInput", "Depth Input", true),
+            makeHiddenInputSlot("softwareRaster", "Software Raster", true)
         }),
         (std::vector<PassSlotInfo>{
             makeOutputSlot("visibility", "Visibility"),
@@ -82,6 +85,14 @@ public:
         if (config.config.is_object() && config.config.contains("loadExisting")) {
             m_loadExisting = config.config["loadExisting"].get<bool>();
         }
+        if (config.config.is_object() && config.config.contains("triangleCull")) {
+            m_triangleCull = config.config["triangleCull"].get<bool>();
+        }
+        if (config.config.is_object() && config.config.contains("shadowCascade")) {
+            m_shadowCascade = config.config["shadowCascade"].get<int>();
+            m_width = static_cast<int>(kShadowCascadeResolution);
+            m_height = static_cast<int>(kShadowCascadeResolution);
+        }
     }
 
     // Output resources
@@ -124,15 +135,34 @@ public:
         if (instanceDataInput.isValid()) {
             m_instanceDataRead = builder.read(instanceDataInput, FGResourceUsage::StorageRead);
         }
+        m_softwareRasterRead = FGResource{};
+        FGResource softwareRasterInput = getInput("softwareRaster");
+        if (softwareRasterInput.isValid()) {
+            m_softwareRasterRead = builder.read(softwareRasterInput, FGResourceUsage::StorageRead);
+        }
         FGResource visibilityInput = getInput("visibilityInput");
         FGResource depthInput = getInput("depthInput");
         const bool loadVisibility = m_loadExisting && visibilityInput.isValid();
         const bool loadDepth = m_loadExisting && depthInput.isValid();
+        const bool visibility64 = m_runtimeContext && m_runtimeContext->visibility64;
+        RhiClearColor clearColor = m_clearColor;
+        if (visibility64) {
+            // Both words of an empty pixel carry the invalid ID.
+            clearColor.green = clearColor.red;
+        }
+
+        if (m_shadowCascade >= 0) {
+            setupShadowCascadeTargets(builder, clearColor, visibility64);
+            return;
+        }
 
         visibility = loadVisibility
             ? visibilityInput
             : builder.create("visibility",
-                             FGTextureDesc::renderTarget(m_width, m_height, RhiFormat::R32Uint));
+                             FGTextureDesc::renderTarget(m_width,
+                                                         m_height,
+                                                         visibility64 ? RhiFormat::RG32Uint
+                                                                      : RhiFormat::R32Uint));
         depth = loadDepth
             ? depthInput
             : builder.create("depth",
@@ -142,7 +172,7 @@ public:
                                                  loadVisibility ? RhiLoadAction::Load
                                                                 : RhiLoadAction::Clear,
                                                  RhiStoreAction::Store,
-                                                 m_clearColor);
+                                                 clearColor);
         depth = builder.setDepthAttachment(depth,
                                            loadDepth ? RhiLoadAction::Load
                                                      : RhiLoadAction::Clear,
@@ -155,9 +185,16 @@ public:
         MICROPROFILE_SCOPEI("RenderPass", "VisibilityPass", 0xffff8800);
         if (!m_frameContext || !m_runtimeContext) return;
 
+        // A cached cascade loaded last frame's depth and has no worklist to draw.
+        const ShadowCascadeView* shadowCascade =
+            findShadowCascade(m_frameContext->shadowCascades, m_shadowCascade);
+        if (m_shadowCascade >= 0 && (!shadowCascade || shadowCascade->cached)) return;
+        reportTelemetry();
+
         encoder.setDepthStencilState(&m_ctx.depthState);
         encoder.setFrontFacingWinding(RhiWinding::CounterClockwise);
-        encoder.setCullMode(RhiCullMode::Back);
+        // Shadow casters keep their back faces so open or single-sided meshes still occlude.
+        encoder.setCullMode(shadowCascade ? RhiCullMode::None : RhiCullMode::Back);
 
         // GPU-driven indirect path
         const RhiBuffer* visibleMeshletBuffer =
@@ -174,28 +211,47 @@ public:
         m_gpuPathRequiredLastFrame = m_frameContext->gpuDrivenCulling;
         m_gpuPathReadyLastFrame = false;
         m_lastLegacyVisibleNodeCount = 0;
-        m_lastVisibleMeshletWorkItems =
-            GpuDriven::readPublishedWorkItemCount<GpuDriven::MeshDispatchCommandLayout>(
-                worklistStateBuffer);
-        m_lastIndirectMeshGroupCount =
-            GpuDriven::readBuiltIndirectGroupCount<GpuDriven::MeshDispatchCommandLayout>(
-                worklistStateBuffer);
 
         bool useGPUPath = m_gpuPathRequiredLastFrame &&
             visibleMeshletBuffer &&
             worklistStateBuffer &&
             sceneInstanceBuffer;
 
+        // Alpha-tested clusters (binned by the cull) get a second draw with the only
+        // pipeline that can discard; without it they fall back to the opaque one.
+        const RhiGraphicsPipeline* alphaMaskedPipeline = nullptr;
         if (useGPUPath) {
             auto pipeIt = m_runtimeContext->renderPipelinesRhi.find("VisibilityIndirectPass");
             if (pipeIt == m_runtimeContext->renderPipelinesRhi.end() || !pipeIt->second.nativeHandle())
                 useGPUPath = false;
             else
                 encoder.setRenderPipeline(pipeIt->second);
+            auto maskedIt = m_runtimeContext->renderPipelinesRhi.find("VisibilityIndirectAlphaMaskedPass");
+            if (maskedIt != m_runtimeContext->renderPipelinesRhi.end() && maskedIt->second.nativeHandle())
+                alphaMaskedPipeline = &maskedIt->second;
         }
+        const bool hasAlphaMaskedMaterials =
+            std::any_of(m_ctx.materials.cpuMaterials.begin(), m_ctx.materials.cpuMaterials.end(),
+                        [](const GPUMaterial& material) { return material.alphaMode == 1u; });
 
         m_gpuPathReadyLastFrame = useGPUPath;
 
+        // Clusters binned to software raster are skipped by the mesh shader only when
+        // SoftwareRasterPass produced samples and the resolve pipeline can merge them.
+        const RhiBuffer* softwareRasterBuffer =
+            (m_frameGraph && m_softwareRasterRead.isValid())
+                ? m_frameGraph->getBuffer(m_softwareRasterRead)
+                : nullptr;
+        const RhiGraphicsPipeline* softwareResolvePipeline = nullptr;
+        if (useGPUPath && softwareRasterBuffer && !shadowCascade) {
+            auto resolveIt = m_runtimeContext->renderPipelinesRhi.find("VisibilitySoftwareResolvePass");
+            if (resolveIt != m_runtimeContext->renderPipelinesRhi.end() &&
+                resolveIt->second.nativeHandle()) {
+                softwareResolvePipeline = &resolveIt->second;
+            }
+        }
+        m_softwareRasterResolvedLastFrame = softwareResolvePipeline != nullptr;
+
         static bool sLoggedPath = false;
         if (!sLoggedPath) {
             auto visIt = m_runtimeContext->renderPipelinesRhi.find("VisibilityPass");
@@ -214,7 +270,7 @@ public:
         }
 
         const bool useBindlessSceneTextures = m_runtimeContext->useBindlessSceneTextures;
-        std::vector<const RhiTexture*> materialTextures;
+        std::pmr::vector<const RhiTexture*> materialTextures(m_frameContext->frameMemory);
         if (!useBindlessSceneTextures) {
             materialTextures.reserve(m_ctx.materials.textureViews.size());
             for (auto* texture : m_ctx.materials.textureViews) {
@@ -286,10 +342,24 @@ public:
                 float4x4 viewProj;
                 float4 lightDir;
                 float4 lightColorIntensity;
-            } globalUni;
-            globalUni.viewProj = transpose(m_frameContext->proj * m_frameContext->view);
+                uint32_t softwareRasterEnabled;
+                uint32_t triangleCullMask;
+                float2 viewportSize;
+                uint32_t alphaMaskedBin;
+                uint32_t pad[3];
+            } globalUni{};
+            globalUni.viewProj = shadowCascade
+                ? transpose(shadowCascade->proj * shadowCascade->view)
+                : transpose(m_frameContext->proj * m_frameContext->view);
             globalUni.lightDir = m_frameContext->viewLightDir;
             globalUni.lightColorIntensity = m_frameContext->lightColorIntensity;
+            globalUni.softwareRasterEnabled = softwareResolvePipeline ? 1u : 0u;
+            if (m_triangleCull) {
+                // Light views rasterize both faces (see setCullMode above).
+                globalUni.triangleCullMask = GPU_DRIVEN_TRIANGLE_CULL_FRUSTUM | GPU_DRIVEN_TRIANGLE_CULL_SMALL |
+                                             (shadowCascade ? 0u : GPU_DRIVEN_TRIANGLE_CULL_BACKFACE);
+            }
+            globalUni.viewportSize = float2(static_cast<float>(m_width), static_cast<float>(m_height));
             encoder.setMeshBytes(&globalUni,
                                  sizeof(globalUni),
                                  GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
@@ -297,16 +367,54 @@ public:
                                      sizeof(globalUni),
                                      GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
 
-            // Single indirect draw call
+            // Opaque clusters first, so the alpha-tested ones depth test against them.
             encoder.drawMeshThreadgroupsIndirect(*worklistStateBuffer,
                                                  GpuDriven::MeshDispatchCommandLayout::kIndirectArgsOffset,
                                                  {1, 1, 1},
                                                  {128, 1, 1});
+            if (hasAlphaMaskedMaterials) {
+                globalUni.alphaMaskedBin = 1u;
+                if (alphaMaskedPipeline) {
+                    encoder.setRenderPipeline(*alphaMaskedPipeline);
+                }
+                encoder.setMeshBytes(&globalUni,
+                                     sizeof(globalUni),
+                                     GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+                encoder.setFragmentBytes(&globalUni,
+                                         sizeof(globalUni),
+                                         GpuDriven::MeshletVisibilityBindings::kGlobalUniforms);
+                encoder.drawMeshThreadgroupsIndirect(*worklistStateBuffer,
+                                                     GpuDriven::MeshDispatchCommandLayout::kIndirectArgsOffset,
+                                                     {1, 1, 1},
+                                                     {128, 1, 1});
+            }
+
+            if (softwareResolvePipeline) {
+                struct {
+                    uint32_t targetWidth;
+                    uint32_t pad[3];
+                } resolveUni{};
+                resolveUni.targetWidth = static_cast<uint32_t>(m_width);
+                encoder.setRenderPipeline(*softwareResolvePipeline);
+                encoder.setCullMode(RhiCullMode::None);
+                encoder.setFragmentBytes(&resolveUni,
+                                         sizeof(resolveUni),
+                                         GpuDriven::SoftwareRasterResolveBindings::kUniforms);
+                encoder.setFragmentBuffer(softwareRasterBuffer,
+                                          0,
+                                          GpuDriven::SoftwareRasterResolveBindings::kSoftwareRaster);
+                if (m_runtimeContext->visibility64) {
+                    encoder.setFragmentBuffer(visibleMeshletBuffer,
+                                              0,
+                                              GpuDriven::SoftwareRasterResolveBindings::kVisibleMeshlets);
+                }
+                encoder.drawPrimitives(RhiPrimitiveType::Triangle, 0, 3);
+            }
             m_missingGpuPathWarningLogged = false;
             return;
         }
 
-        if (m_gpuPathRequiredLastFrame) {
+        if (m_gpuPathRequiredLastFrame || shadowCascade) {
             if (!m_missingGpuPathWarningLogged) {
                 spdlog::warn(
                     "VisibilityPass requires the GPU indirect raster path, but it is unavailable; skipping legacy CPU per-node fallback for this frame");
@@ -393,9 +501,13 @@ public:
 
     void renderUI() override {
         ImGui::Text("Resolution: %d x %d", m_width, m_height);
+        if (m_shadowCascade >= 0) {
+            ImGui::Text("View: Shadow Cascade %d", m_shadowCascade);
+        }
         if (m_frameContext) {
             ImGui::Text("Frustum Cull: %s", m_frameContext->enableFrustumCull ? "On" : "Off");
             ImGui::Text("Cone Cull: %s", m_frameContext->enableConeCull ? "On" : "Off");
+            ImGui::Checkbox("Triangle Cull", &m_triangleCull);
             ImGui::Text("GPU Raster Requested: %s", m_frameContext->gpuDrivenCulling ? "Yes" : "No");
             ImGui::Text("Load Existing Targets: %s", m_loadExisting ? "Yes" : "No");
             ImGui::Text("Last Raster Path: %s",
@@ -405,8 +517,7 @@ public:
                                    : "GPU Indirect Unavailable")
                             : "CPU Per-Node (Legacy)");
             if (m_gpuPathRequiredLastFrame || m_frameContext->gpuDrivenCulling) {
-                ImGui::Text("Last Meshlet Work Items: %u", m_lastVisibleMeshletWorkItems);
-                ImGui::Text("Last Indirect Mesh Groups: %u", m_lastIndirectMeshGroupCount);
+                ImGui::Text("Software Raster Resolve: %s", m_softwareRasterResolvedLastFrame ? "On" : "Off");
             } else {
                 ImGui::Text("Visible Nodes (Legacy): %u", m_lastLegacyVisibleNodeCount);
             }
@@ -414,20 +525,60 @@ public:
     }
 
 private:
+    // Main-view raster cost for GpuDrivenTelemetry, from this pass's newest GPU scope.
+    void reportTelemetry() const {
+        if (m_shadowCascade >= 0 || !m_frameGraph || !m_runtimeContext->gpuDrivenTelemetry) return;
+        const FGGpuPassTiming* timing = m_frameGraph->gpuPassTiming(m_name);
+        if (!timing || timing->sampleCount == 0) return;
+        m_runtimeContext->gpuDrivenTelemetry->recordRasterPass(
+            m_name, timing->latest.durationMs, timing->latest.primitives, timing->latest.fragmentInvocations);
+    }
+
+    // Light views draw depth into a per-cascade history texture, which persists, so a
+    // cached cascade loads it instead of clearing. The visibility target is scratch:
+    // the mesh pipeline writes it but nothing reads it.
+    void setupShadowCascadeTargets(FGBuilder& builder, RhiClearColor clearColor, bool visibility64) {
+        visibility = builder.create("visibility",
+                                    FGTextureDesc::renderTarget(m_width,
+                                                                m_height,
+                                                                visibility64 ? RhiFormat::RG32Uint
+                                                                             : RhiFormat::R32Uint));
+        visibility = builder.setColorAttachment(0,
+                                                visibility,
+                                                RhiLoadAction::Clear,
+                                                RhiStoreAction::DontCare,
+                                                clearColor);
+        depth = builder.writeHistory(shadowCascadeDepthHistoryName(static_cast<uint32_t>(m_shadowCascade)),
+                                     FGTextureDesc::depthTarget(m_width, m_height),
+                                     FGResourceUsage::DepthAttachment);
+        depth = builder.setDepthAttachment(depth,
+                                           RhiLoadAction::Clear,
+                                           RhiStoreAction::Store,
+                                           m_ctx.depthClearValue);
+        builder.keepDepthAttachmentWhen([this]() {
+            const ShadowCascadeView* cascade =
+                m_frameContext ? findShadowCascade(m_frameContext->shadowCascades, m_shadowCascade) : nullptr;
+            return cascade && cascade->cached;
+        });
+    }
+
     const RenderContext& m_ctx;
     int m_width, m_height;
     std::string m_name = "Visibility Pass";
     RhiClearColor m_clearColor = RhiClearColor(0xFFFFFFFF, 0, 0, 0);
     bool m_loadExisting = false;
+    // Frustum, backface and no-sample triangle tests in the GPU-driven mesh shader.
+    bool m_triangleCull = false;
+    int m_shadowCascade = -1;
     bool m_gpuPathRequiredLastFrame = false;
     bool m_gpuPathReadyLastFrame = false;
     bool m_missingGpuPathWarningLogged = false;
-    uint32_t m_lastVisibleMeshletWorkItems = 0;
-    uint32_t m_lastIndirectMeshGroupCount = 0;
+    bool m_softwareRasterResolvedLastFrame = false;
     uint32_t m_lastLegacyVisibleNodeCount = 0;
     FGResource m_visibleMeshletsRead;
     FGResource m_cullCounterRead;
     FGResource m_instanceDataRead;
+    FGResource m_softwareRasterRead;
 };
 
 METALLIC_REGISTER_PASS(VisibilityPass);
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "cluster_lod_builder.h"
+#include "mesh_loader.h"
+#include "meshlet_builder.h"
+#include "parallel_for.h"
+#include "scene.h"
+#include "scene_snapshot.h"
+#include "startup_profile.h"
+#include "texture_transcoder.h"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Offline asset cooking, run headless with --cook <glTF> (MetallicCook target).
+// Writes the caches SceneGpu::create would otherwise build on a cold start: the
+// meshlet and ClusterLOD caches with their per-primitive-group entries, the BC7
+// texture chains and the scene snapshot. No window or device is created, so it
+// runs on build machines. Several inputs cook in parallel, one file per core;
+// a single input uses the cores inside the meshlet, LOD and texture builds.
+// The meshlet limits must match the device the runtime picks
+// (rhiPreferredMeshletSizeLimits), since both caches are keyed by them. The scene
+// snapshot is keyed by the glTF path, so cook the path the runtime opens.
+class AssetCook {
+public:
+    struct Settings {
+        std::vector<std::string> inputs;
+        // Empty uses the runtime's Asset/MeshletCache.
+        std::string cacheDirectory;
+        RhiMeshletSizeLimits sizeLimits;
+        bool bc7Textures = true;
+        // Startup-profile style JSON with per-phase times and cache hits.
+        std::string reportPath;
+    };
+
+    // Returns false on a malformed cook argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* input = takeValue("--cook")) {
+                settings.inputs.emplace_back(input);
+            } else if (const char* directory = takeValue("--cook-cache-dir")) {
+                settings.cacheDirectory = directory;
+            } else if (const char* limits = takeValue("--cook-meshlet-limits")) {
+                char* end = nullptr;
+                const unsigned long vertices = std::strtoul(limits, &end, 10);
+                const unsigned long triangles = *end == 'x' ? std::strtoul(end + 1, &end, 10) : 0ul;
+                if (vertices == 0ul || triangles == 0ul || *end != '\0') {
+                    spdlog::error("--cook-meshlet-limits expects <vertices>x<triangles>, got {}", limits);
+                    return false;
+                }
+                settings.sizeLimits.maxVertices = static_cast<uint32_t>(vertices);
+                settings.sizeLimits.maxTriangles = static_cast<uint32_t>(triangles);
+            } else if (const char* path = takeValue("--cook-report")) {
+                settings.reportPath = path;
+            } else if (std::strcmp(arg, "--cook-no-bc7") == 0) {
+                settings.bc7Textures = false;
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--cook-", 7) == 0) {
+                spdlog::error("Unknown cook argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int run(const Settings& settings) {
+        std::error_code error;
+        std::filesystem::create_directories(settings.cacheDirectory, error);
+        if (error) {
+            spdlog::error("Cook: cannot create cache directory {}: {}", settings.cacheDirectory, error.message());
+            return 1;
+        }
+        spdlog::info("Cook: {} inputs into {}, meshlets {}x{}, {} textures",
+                     settings.inputs.size(),
+                     settings.cacheDirectory,
+                     settings.sizeLimits.maxVertices,
+                     settings.sizeLimits.maxTriangles,
+                     settings.bc7Textures ? "BC7" : "no");
+
+        StartupProfile::begin();
+        const auto start = std::chrono::steady_clock::now();
+        std::atomic<uint32_t> failed{0};
+        Parallel::parallelFor(settings.inputs.size(), [&](size_t index) {
+            if (!cookFile(settings, settings.inputs[index])) {
+                failed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        StartupProfile::finish(settings.reportPath);
+
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        spdlog::info("Cook: {} of {} inputs cooked in {:.2f} s",
+                     settings.inputs.size() - failed.load(),
+                     settings.inputs.size(),
+                     seconds);
+        return failed.load() == 0 ? 0 : 1;
+    }
+
+private:
+    // Mirrors SceneGpu::createMeshBuffers with CPU attribute copies in place of
+    // the shared GPU buffers, so the LOD simplifier sees the same normals and UVs.
+    static void makeLoadedMesh(const Scene& scene, LoadedMesh& mesh) {
+        mesh.cpuPositions = scene.positions;
+        mesh.cpuIndices = scene.indices;
+        mesh.cpuNormals = scene.normals;
+        mesh.cpuUVs = scene.uvs;
+        mesh.vertexCount = static_cast<uint32_t>(scene.positions.size() / 3);
+        mesh.indexCount = static_cast<uint32_t>(scene.indices.size());
+        std::memcpy(mesh.bboxMin, scene.bboxMin, sizeof(mesh.bboxMin));
+        std::memcpy(mesh.bboxMax, scene.bboxMax, sizeof(mesh.bboxMax));
+        mesh.hasBakedRootScale = scene.hasBakedRootScale;
+        mesh.bakedRootScale = scene.bakedRootScale;
+
+        mesh.primitiveGroups.reserve(scene.primitives.size());
+        for (const auto& primitive : scene.primitives) {
+            mesh.primitiveGroups.push_back(LoadedMesh::PrimitiveGroup{primitive.indexOffset,
+                                                                      primitive.indexCount,
+                                                                      primitive.vertexOffset,
+                                                                      primitive.vertexCount,
+                                                                      primitive.materialIndex});
+        }
+        mesh.meshRanges.reserve(scene.meshInfos.size());
+        for (const auto& meshInfo : scene.meshInfos) {
+            mesh.meshRanges.push_back(LoadedMesh::MeshPrimitiveRange{meshInfo.firstPrimitive, meshInfo.primitiveCount});
+        }
+    }
+
+    static bool cookFile(const Settings& settings, const std::string& gltfPath) {
+        Scene scene;
+        if (!scene.load(gltfPath)) {
+            spdlog::error("Cook: failed to load {}", gltfPath);
+            return false;
+        }
+
+        LoadedMesh mesh;
+        makeLoadedMesh(scene, mesh);
+        const std::string& sourcePath = scene.filePath();
+
+        MeshletData meshlets;
+        {
+            StartupProfile::Phase phase("Meshlets");
+            const bool cached = readMeshletsFromCache(mesh, settings.sizeLimits, sourcePath,
+                                                      settings.cacheDirectory, meshlets);
+            phase.setCacheHit(cached);
+            StartupProfile::recordCache("meshlets", cached);
+            if (!cached) {
+                if (!buildMeshletsCpu(mesh, settings.sizeLimits, meshlets, settings.cacheDirectory)) {
+                    spdlog::error("Cook: meshlet build failed for {}", gltfPath);
+                    return false;
+                }
+                saveMeshletsToCache(mesh, sourcePath, settings.cacheDirectory, meshlets);
+            }
+        }
+
+        {
+            StartupProfile::Phase phase("Cluster LOD");
+            ClusterLODData clusterLod;
+            if (!buildClusterLODCpu(mesh, meshlets, clusterLod, nullptr, settings.cacheDirectory) ||
+                !saveClusterLODToCache(mesh, sourcePath, settings.cacheDirectory, clusterLod)) {
+                spdlog::warn("Cook: no ClusterLOD cache for {}; the runtime continues without LOD", gltfPath);
+            }
+        }
+
+        std::vector<TranscodedTexture> textures(scene.images.size());
+        if (settings.bc7Textures) {
+            StartupProfile::Phase phase("BC7 textures");
+            Parallel::parallelFor(scene.images.size(), [&](size_t imageIndex) {
+                const SceneImage& image = scene.images[imageIndex];
+                if (image.pixels.empty() || image.width <= 0 || image.height <= 0) {
+                    return;
+                }
+                if (!loadOrTranscodeTexture(image.pixels.data(),
+                                            static_cast<uint32_t>(image.width),
+                                            static_cast<uint32_t>(image.height),
+                                            settings.cacheDirectory,
+                                            textures[imageIndex])) {
+                    textures[imageIndex] = TranscodedTexture{};
+                }
+            });
+        } else {
+            for (size_t imageIndex = 0; imageIndex < scene.images.size(); ++imageIndex) {
+                const SceneImage& image = scene.images[imageIndex];
+                if (!image.pixels.empty() && image.width > 0 && image.height > 0 &&
+                    !buildTextureMipChainRGBA8(image.pixels.data(),
+                                               static_cast<uint32_t>(image.width),
+                                               static_cast<uint32_t>(image.height),
+                                               textures[imageIndex])) {
+                    textures[imageIndex] = TranscodedTexture{};
+                }
+            }
+        }
+
+        std::vector<const TranscodedTexture*> snapshotTextures(textures.size(), nullptr);
+        for (size_t imageIndex = 0; imageIndex < textures.size(); ++imageIndex) {
+            if (!textures[imageIndex].mips.empty()) {
+                snapshotTextures[imageIndex] = &textures[imageIndex];
+            }
+        }
+        if (!saveSceneSnapshot(scene, settings.cacheDirectory, settings.bc7Textures, snapshotTextures)) {
+            spdlog::warn("Cook: failed to write the scene snapshot for {}", gltfPath);
+        }
+        spdlog::info("Cook: {} done ({} meshlets, {} images)", gltfPath, meshlets.cpuMeshlets.size(), scene.images.size());
+        return true;
+    }
+};
@@ -0,0 +1,422 @@
+#pragma once
+
+#include "allocation_counter.h"
+#include "cluster_lod_builder.h"
+#include "gpu_scene.h"
+#include "mesh_loader.h"
+#include "mesh_signature.h"
+#include "meshlet_builder.h"
+#include "parallel_for.h"
+#include "scene_graph.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// CPU microbenchmarks for the asset pipeline and per-frame scene kernels, run
+// headless with --microbench <json> (MetallicMicroBench target). Every kernel runs
+// on synthetic grid meshes of increasing size. Each case is repeated until it
+// has run for --microbench-min-time seconds. The JSON report follows Google
+// Benchmark's layout, so its compare tooling reads it.
+// Allocation counts come from AllocationCounter and include worker threads.
+class AssetMicrobenchmark {
+public:
+    struct Settings {
+        std::string reportPath;
+        std::string filter;
+        double minTimeSeconds = 0.5;
+        // Grid resolutions; a size-N mesh has about N * N vertices and 2 * N * N
+        // triangles, and the scene benchmarks use N * N / 4 nodes.
+        std::vector<uint32_t> sizes = {64u, 256u, 512u};
+    };
+
+    // Returns false on a malformed microbenchmark argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* path = takeValue("--microbench")) {
+                settings.reportPath = path;
+            } else if (const char* filter = takeValue("--microbench-filter")) {
+                settings.filter = filter;
+            } else if (const char* seconds = takeValue("--microbench-min-time")) {
+                settings.minTimeSeconds = std::max(0.0, std::strtod(seconds, nullptr));
+            } else if (const char* sizes = takeValue("--microbench-sizes")) {
+                settings.sizes.clear();
+                for (const char* cursor = sizes; *cursor != '\0';) {
+                    char* end = nullptr;
+                    const unsigned long size = std::strtoul(cursor, &end, 10);
+                    if (end == cursor || size < 2u) {
+                        spdlog::error("--microbench-sizes expects a comma-separated list of grid sizes >= 2, got {}",
+                                      sizes);
+                        return false;
+                    }
+                    settings.sizes.push_back(static_cast<uint32_t>(size));
+                    cursor = *end == ',' ? end + 1 : end;
+                }
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--microbench-", 13) == 0) {
+                spdlog::error("Unknown microbenchmark argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int run(const Settings& settings) {
+        AssetMicrobenchmark bench(settings);
+        return bench.runAll() ? 0 : 1;
+    }
+
+private:
+    struct Case {
+        std::string name;
+        uint64_t itemsPerIteration = 0;
+        std::function<void()> setup;  // untimed, before every iteration
+        std::function<void()> body;   // timed
+        std::function<void()> reset;  // after the warm-up iteration
+        std::function<void(nlohmann::json&, uint64_t iterations)> counters;
+    };
+
+    explicit AssetMicrobenchmark(const Settings& settings)
+        : m_settings(settings),
+          m_cacheDirectory((std::filesystem::temp_directory_path() / "metallic_microbench").string()) {}
+
+    bool runAll() {
+        spdlog::info("Asset microbenchmarks: sizes {}, {:.2f} s per case, writing {}",
+                     nlohmann::json(m_settings.sizes).dump(), m_settings.minTimeSeconds, m_settings.reportPath);
+        bool ok = true;
+        for (uint32_t size : m_settings.sizes) {
+            ok = runMeshKernels(size) && ok;
+            runSceneKernels(size);
+        }
+
+        std::error_code removeError;
+        std::filesystem::remove_all(m_cacheDirectory, removeError);
+        return writeReport() && ok;
+    }
+
+    // size x size grid split into four primitive groups, each its own patch with
+    // its own vertex range, over a smooth height field so simplification has
+    // real error to trade.
+    static LoadedMesh makeGridMesh(uint32_t size) {
+        constexpr uint32_t kPatchesPerSide = 2u;
+        const uint32_t patchSize = std::max(2u, size / kPatchesPerSide);
+        LoadedMesh mesh;
+        for (uint32_t patch = 0; patch < kPatchesPerSide * kPatchesPerSide; ++patch) {
+            LoadedMesh::PrimitiveGroup group{};
+            group.vertexOffset = mesh.vertexCount;
+            group.vertexCount = patchSize * patchSize;
+            group.indexOffset = static_cast<uint32_t>(mesh.cpuIndices.size());
+            group.materialIndex = patch;
+            const float originX = float(patch % kPatchesPerSide);
+            const float originY = float(patch / kPatchesPerSide);
+            for (uint32_t y = 0; y < patchSize; ++y) {
+                for (uint32_t x = 0; x < patchSize; ++x) {
+                    const float u = originX + float(x) / float(patchSize - 1u);
+                    const float v = originY + float(y) / float(patchSize - 1u);
+                    mesh.cpuPositions.push_back(u);
+                    mesh.cpuPositions.push_back(0.1f * std::sin(u * 7.0f) * std::cos(v * 5.0f));
+                    mesh.cpuPositions.push_back(v);
+                }
+            }
+            for (uint32_t y = 0; y + 1u < patchSize; ++y) {
+                for (uint32_t x = 0; x + 1u < patchSize; ++x) {
+                    const uint32_t i0 = group.vertexOffset + y * patchSize + x;
+                    const uint32_t i1 = i0 + 1u;
+                    const uint32_t i2 = i0 + patchSize;
+                    const uint32_t i3 = i2 + 1u;
+                    mesh.cpuIndices.insert(mesh.cpuIndices.end(), {i0, i2, i1, i1, i2, i3});
+                }
+            }
+            group.indexCount = static_cast<uint32_t>(mesh.cpuIndices.size()) - group.indexOffset;
+            mesh.vertexCount += group.vertexCount;
+            mesh.primitiveGroups.push_back(group);
+        }
+        mesh.indexCount = static_cast<uint32_t>(mesh.cpuIndices.size());
+        mesh.bboxMin[0] = 0.0f;
+        mesh.bboxMin[1] = -0.1f;
+        mesh.bboxMin[2] = 0.0f;
+        mesh.bboxMax[0] = float(kPatchesPerSide);
+        mesh.bboxMax[1] = 0.1f;
+        mesh.bboxMax[2] = float(kPatchesPerSide);
+        return mesh;
+    }
+
+    // Forest of nodeCount nodes: one root per 64 nodes, fan-out 8 below.
+    static void makeSceneGraph(uint32_t nodeCount, SceneGraph& sceneGraph) {
+        const uint32_t rootCount = std::max(1u, nodeCount / 64u);
+        sceneGraph.nodes.resize(nodeCount);
+        for (uint32_t nodeId = 0; nodeId < nodeCount; ++nodeId) {
+            SceneNode& node = sceneGraph.nodes[nodeId];
+            node.id = nodeId;
+            node.meshIndex = 0;
+            node.transform.translation = float3(float(nodeId % 8u), 0.0f, float(nodeId / 8u % 8u)) * 0.25f;
+            if (nodeId < rootCount) {
+                sceneGraph.rootNodes.push_back(nodeId);
+            } else {
+                node.parent = static_cast<int32_t>((nodeId - rootCount) / 8u);
+                sceneGraph.nodes[node.parent].children.push_back(nodeId);
+            }
+        }
+        sceneGraph.updateTransforms();
+        sceneGraph.transformChangedNodes.clear();
+        sceneGraph.localChangedNodes.clear();
+    }
+
+    // One instance per node of a single geometry, as buildGpuSceneTables would lay
+    // it out, without GPU buffers; updateGpuSceneTables skips the uploads.
+    static void makeGpuSceneTables(const SceneGraph& sceneGraph, GpuSceneTables& tables) {
+        GPUSceneGeometry geometry{};
+        geometry.meshletCount = 1u;
+        geometry.boundsCenterRadius[3] = 0.5f;
+        tables.geometries.push_back(geometry);
+        tables.nodeToInstance.resize(sceneGraph.nodes.size());
+        tables.nodeInstanceCount.assign(sceneGraph.nodes.size(), 1u);
+        for (const SceneNode& node : sceneGraph.nodes) {
+            tables.nodeToInstance[node.id] = static_cast<uint32_t>(tables.instances.size());
+            GPUSceneInstance instance{};
+            instance.geometryIndex = 0u;
+            instance.sceneNodeIndex = node.id;
+            instance.visibilityFlags = kGpuSceneInstanceVisible;
+            tables.instances.push_back(instance);
+        }
+        tables.instancePrevTransforms.resize(tables.instances.size());
+        tables.instanceCull.resize(tables.instances.size());
+        tables.instanceCount = static_cast<uint32_t>(tables.instances.size());
+        tables.visibleInstanceCount = tables.instanceCount;
+        tables.sceneVisibilityRevision = sceneGraph.visibilityRevision;
+    }
+
+    bool runMeshKernels(uint32_t size) {
+        const std::string suffix = "/" + std::to_string(size);
+        const LoadedMesh mesh = makeGridMesh(size);
+        const uint64_t triangles = mesh.indexCount / 3u;
+        const RhiMeshletSizeLimits sizeLimits{};
+
+        measure(Case{"MeshSignature" + suffix,
+                     mesh.cpuPositions.size() * sizeof(float) + mesh.cpuIndices.size() * sizeof(uint32_t),
+                     nullptr,
+                     [&] { doNotOptimize(computeMeshSignature(mesh)); }});
+
+        MeshletData meshlets;
+        measure(Case{"BuildMeshlets" + suffix, triangles, nullptr, [&] {
+                         if (!buildMeshletsCpu(mesh, sizeLimits, meshlets)) {
+                             spdlog::error("BuildMeshlets{} failed", suffix);
+                         }
+                     }});
+        if (meshlets.cpuMeshlets.empty()) {
+            return false;
+        }
+
+        ClusterLODData clusterLod;
+        ClusterLODStageTimings timings;
+        Case clusterLodCase{"BuildClusterLOD" + suffix, triangles, nullptr, [&] {
+                                if (!buildClusterLODCpu(mesh, meshlets, clusterLod, &timings)) {
+                                    spdlog::error("BuildClusterLOD{} failed", suffix);
+                                }
+                            }};
+        clusterLodCase.reset = [&] {
+            timings.partitionNs = 0u;
+            timings.simplifyNs = 0u;
+            timings.meshletizeNs = 0u;
+            timings.hierarchyNs = 0u;
+            timings.packNs = 0u;
+        };
+        clusterLodCase.counters = [&](nlohmann::json& result, uint64_t iterations) {
+            const auto perIteration = [&](const std::atomic<uint64_t>& ns) {
+                return double(ns.load()) / double(iterations);
+            };
+            result["partition_ns"] = perIteration(timings.partitionNs);
+            result["simplify_ns"] = perIteration(timings.simplifyNs);
+            result["meshletize_ns"] = perIteration(timings.meshletizeNs);
+            result["hierarchy_ns"] = perIteration(timings.hierarchyNs);
+            result["pack_ns"] = perIteration(timings.packNs);
+            result["meshlets"] = clusterLod.allMeshlets.size();
+        };
+        measure(clusterLodCase);
+        if (clusterLod.allMeshlets.empty()) {
+            return false;
+        }
+
+        measure(Case{"BuildPackedClusterData" + suffix,
+                     clusterLod.allMeshlets.size(),
+                     nullptr,
+                     [&] { buildPackedClusterData(mesh, clusterLod); }});
+
+        const std::string cacheSource = "microbench_grid" + suffix.substr(1);
+        if (!saveMeshletsToCache(mesh, cacheSource, m_cacheDirectory, meshlets)) {
+            spdlog::error("Could not write the meshlet cache for ReadMeshletCache{}", suffix);
+            return false;
+        }
+        const uint64_t cacheBytes = meshlets.cpuMeshlets.size() * sizeof(GPUMeshlet) +
+                                    meshlets.cpuMeshletVertices.size() * sizeof(uint32_t) +
+                                    meshlets.cpuMeshletTriangles.size() +
+                                    meshlets.cpuBounds.size() * sizeof(GPUMeshletBounds) +
+                                    meshlets.cpuMaterialIDs.size() * sizeof(uint32_t);
+        MeshletData cached;
+        measure(Case{"ReadMeshletCache" + suffix, cacheBytes, nullptr, [&] {
+                         if (!readMeshletsFromCache(mesh, sizeLimits, cacheSource, m_cacheDirectory, cached)) {
+                             spdlog::error("ReadMeshletCache{} failed", suffix);
+                         }
+                     }});
+        return true;
+    }
+
+    void runSceneKernels(uint32_t size) {
+        const std::string suffix = "/" + std::to_string(size);
+        const uint32_t nodeCount = std::max(64u, size * size / 4u);
+
+        // Every root moves, so the whole forest is recomputed.
+        SceneGraph sceneGraph;
+        makeSceneGraph(nodeCount, sceneGraph);
+        float offset = 0.0f;
+        const auto moveRoots = [&] {
+            offset += 0.001f;
+            for (uint32_t root : sceneGraph.rootNodes) {
+                sceneGraph.nodes[root].transform.translation.y = offset;
+                sceneGraph.markDirty(root);
+            }
+        };
+        measure(Case{"UpdateTransforms" + suffix, nodeCount, [&] {
+                         sceneGraph.transformChangedNodes.clear();
+                         sceneGraph.localChangedNodes.clear();
+                         moveRoots();
+                     },
+                     [&] { sceneGraph.updateTransforms(); }});
+
+        GpuSceneTables tables;
+        makeGpuSceneTables(sceneGraph, tables);
+        measure(Case{"UpdateGpuSceneTables" + suffix, nodeCount, [&] {
+                         moveRoots();
+                         sceneGraph.updateTransforms();
+                     },
+                     [&] { updateGpuSceneTables(sceneGraph, tables); }});
+    }
+
+    void measure(Case benchCase) {
+        if (!m_settings.filter.empty() && benchCase.name.find(m_settings.filter) == std::string::npos) {
+            return;
+        }
+        using Clock = std::chrono::steady_clock;
+        // The kernels log their own progress at info level.
+        const spdlog::level::level_enum logLevel = spdlog::get_level();
+        spdlog::set_level(spdlog::level::warn);
+        const auto runOnce = [&] {
+            if (benchCase.setup) {
+                benchCase.setup();
+            }
+            const Clock::time_point start = Clock::now();
+            benchCase.body();
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        runOnce();
+        if (benchCase.reset) {
+            benchCase.reset();
+        }
+
+        constexpr uint64_t kMaxIterations = 1000000u;
+        std::vector<double> samples;
+        AllocationCounter::Counts allocations;
+        double totalNs = 0.0;
+        while (samples.empty() ||
+               (totalNs < m_settings.minTimeSeconds * 1e9 && samples.size() < kMaxIterations)) {
+            if (benchCase.setup) {
+                benchCase.setup();
+            }
+            const AllocationCounter::Scope counting;
+            const Clock::time_point start = Clock::now();
+            benchCase.body();
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            const AllocationCounter::Counts counted = counting.elapsed();
+            allocations.allocations += counted.allocations;
+            allocations.bytes += counted.bytes;
+            samples.push_back(ns);
+            totalNs += ns;
+        }
+        spdlog::set_level(logLevel);
+
+        const uint64_t iterations = samples.size();
+        const double meanNs = totalNs / double(iterations);
+        std::sort(samples.begin(), samples.end());
+        nlohmann::json result{
+            {"name", benchCase.name},
+            {"run_name", benchCase.name},
+            {"run_type", "iteration"},
+            {"iterations", iterations},
+            {"real_time", meanNs},
+            {"cpu_time", meanNs},
+            {"time_unit", "ns"},
+            {"median_ns", samples[samples.size() / 2u]},
+            {"min_ns", samples.front()},
+            {"allocations_per_iteration", double(allocations.allocations) / double(iterations)},
+            {"allocated_bytes_per_iteration", double(allocations.bytes) / double(iterations)},
+        };
+        if (benchCase.itemsPerIteration > 0u) {
+            result["items_per_second"] = double(benchCase.itemsPerIteration) * 1e9 / meanNs;
+        }
+        if (benchCase.counters) {
+            benchCase.counters(result, iterations);
+        }
+        spdlog::info("{:<28} {:>12.3f} ms {:>10} it {:>12.1f} allocs/it",
+                     benchCase.name, meanNs * 1e-6, iterations,
+                     double(allocations.allocations) / double(iterations));
+        m_results.push_back(std::move(result));
+    }
+
+    template <typename T>
+    static void doNotOptimize(const T& value) {
+        static volatile T sink;
+        sink = value;
+    }
+
+    bool writeReport() const {
+        const nlohmann::json report{
+            {"context", {{"executable", "Metallic --microbench"},
+                         {"num_cpus", Parallel::hardwareWorkerCount()},
+                         {"min_time_seconds", m_settings.minTimeSeconds},
+                         {"sizes", m_settings.sizes}}},
+            {"benchmarks", m_results},
+        };
+        std::ofstream reportFile(m_settings.reportPath, std::ios::trunc);
+        if (!reportFile) {
+            spdlog::error("Failed to open microbenchmark report {}", m_settings.reportPath);
+            return false;
+        }
+        reportFile << report.dump(2);
+        spdlog::info("Wrote {} microbenchmark results to {}", m_results.size(), m_settings.reportPath);
+        return true;
+    }
+
+    Settings m_settings;
+    std::string m_cacheDirectory;
+    std::vector<nlohmann::json> m_results;
+};
@@ -95,9 +95,9 @@ struct OrbitCamera {
     }
 
     // Returns jitter in [-0.5, 0.5] pixel range using Halton bases 2,3
-    static float2 haltonJitter(uint32_t frameIndex) {
+    static float2 haltonJitter(uint32_t frameIndex, uint32_t phaseCount = 16) {
         // Use 1-based index (Halton(0) = 0)
-        int idx = static_cast<int>((frameIndex % 16) + 1);
+        int idx = static_cast<int>((frameIndex % phaseCount) + 1);
         return float2(halton(idx, 2) - 0.5f, halton(idx, 3) - 0.5f);
     }
 
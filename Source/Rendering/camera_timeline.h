@@ -0,0 +1,306 @@
+#pragma once
+
+#include "camera.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Frame-locked recording of the orbit camera, the render toggles that change what
+// a frame costs, and history resets. Only the frames where something changed are
+// stored, so a timeline stays a few KB per minute; replay applies frame N's state
+// on the Nth rendered frame without interpolation.
+//
+// File layout:
+//   {"version":1, "timestep":s, "frames":N,
+//    "camera":[[frame, tx, ty, tz, distance, azimuth, elevation, fovY], ...],
+//    "toggles":[[frame, "name", value], ...],
+//    "resets":[[frame, flags], ...]}
+struct CameraTimelinePose {
+    float3 target = float3(0.0f);
+    float distance = 1.0f;
+    float azimuth = 0.0f;
+    float elevation = 0.2f;
+    float fovY = 45.0f * (OrbitCamera::kPi / 180.0f);
+
+    static CameraTimelinePose fromCamera(const OrbitCamera& camera) {
+        CameraTimelinePose pose;
+        pose.target = camera.target;
+        pose.distance = camera.distance;
+        pose.azimuth = camera.azimuth;
+        pose.elevation = camera.elevation;
+        pose.fovY = camera.fovY;
+        return pose;
+    }
+
+    void apply(OrbitCamera& camera) const {
+        camera.target = target;
+        camera.distance = distance;
+        camera.azimuth = azimuth;
+        camera.elevation = elevation;
+        camera.fovY = fovY;
+    }
+
+    bool operator==(const CameraTimelinePose& other) const {
+        return target.x == other.target.x && target.y == other.target.y && target.z == other.target.z &&
+               distance == other.distance && azimuth == other.azimuth &&
+               elevation == other.elevation && fovY == other.fovY;
+    }
+};
+
+struct CameraTimeline {
+    // Reset flags of one frame.
+    static constexpr uint32_t kResetHistory = 1u << 0;      // temporal history discarded
+    static constexpr uint32_t kResetPrevMatrices = 1u << 1; // motion vectors restart
+
+    struct CameraKey {
+        uint32_t frame = 0u;
+        CameraTimelinePose pose;
+    };
+    struct ToggleKey {
+        uint32_t frame = 0u;
+        std::string name;
+        double value = 0.0;
+    };
+    struct ResetKey {
+        uint32_t frame = 0u;
+        uint32_t flags = 0u;
+    };
+
+    double timestep = 1.0 / 60.0;
+    uint32_t frameCount = 0u;
+    std::vector<CameraKey> camera;
+    std::vector<ToggleKey> toggles;
+    std::vector<ResetKey> resets;
+
+    bool save(const std::string& path) const {
+        nlohmann::json cameraJson = nlohmann::json::array();
+        for (const CameraKey& key : camera) {
+            const CameraTimelinePose& pose = key.pose;
+            cameraJson.push_back({key.frame, pose.target.x, pose.target.y, pose.target.z,
+                                  pose.distance, pose.azimuth, pose.elevation, pose.fovY});
+        }
+        nlohmann::json togglesJson = nlohmann::json::array();
+        for (const ToggleKey& key : toggles) {
+            togglesJson.push_back({key.frame, key.name, key.value});
+        }
+        nlohmann::json resetsJson = nlohmann::json::array();
+        for (const ResetKey& key : resets) {
+            resetsJson.push_back({key.frame, key.flags});
+        }
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            spdlog::error("Failed to write camera timeline {}", path);
+            return false;
+        }
+        file << nlohmann::json{{"version", 1},
+                               {"timestep", timestep},
+                               {"frames", frameCount},
+                               {"camera", cameraJson},
+                               {"toggles", togglesJson},
+                               {"resets", resetsJson}}.dump();
+        return true;
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            spdlog::error("Failed to open camera timeline {}", path);
+            return false;
+        }
+        const nlohmann::json json = nlohmann::json::parse(file, nullptr, false);
+        if (!json.is_object() || json.value("version", 0) != 1) {
+            spdlog::error("Camera timeline {} is not a version 1 timeline", path);
+            return false;
+        }
+        timestep = std::max(1e-4, json.value("timestep", 1.0 / 60.0));
+        frameCount = json.value("frames", 0u);
+        camera.clear();
+        toggles.clear();
+        resets.clear();
+        for (const nlohmann::json& entry : json.value("camera", nlohmann::json::array())) {
+            if (!entry.is_array() || entry.size() != 8) {
+                continue;
+            }
+            CameraKey& key = camera.emplace_back();
+            key.frame = entry[0].get<uint32_t>();
+            key.pose.target = float3(entry[1].get<float>(), entry[2].get<float>(), entry[3].get<float>());
+            key.pose.distance = entry[4].get<float>();
+            key.pose.azimuth = entry[5].get<float>();
+            key.pose.elevation = entry[6].get<float>();
+            key.pose.fovY = entry[7].get<float>();
+        }
+        for (const nlohmann::json& entry : json.value("toggles", nlohmann::json::array())) {
+            if (entry.is_array() && entry.size() == 3) {
+                toggles.push_back({entry[0].get<uint32_t>(), entry[1].get<std::string>(), entry[2].get<double>()});
+            }
+        }
+        for (const nlohmann::json& entry : json.value("resets", nlohmann::json::array())) {
+            if (entry.is_array() && entry.size() == 2) {
+                resets.push_back({entry[0].get<uint32_t>(), entry[1].get<uint32_t>()});
+            }
+        }
+        // Keys are written in frame order; keep them sorted for hand-edited files.
+        std::stable_sort(camera.begin(), camera.end(),
+                         [](const CameraKey& a, const CameraKey& b) { return a.frame < b.frame; });
+        std::stable_sort(toggles.begin(), toggles.end(),
+                         [](const ToggleKey& a, const ToggleKey& b) { return a.frame < b.frame; });
+        std::stable_sort(resets.begin(), resets.end(),
+                         [](const ResetKey& a, const ResetKey& b) { return a.frame < b.frame; });
+        if (camera.empty()) {
+            spdlog::error("Camera timeline {} has no camera keys", path);
+            return false;
+        }
+        return true;
+    }
+};
+
+// --record-timeline <json>. Feed it the frame's final state once per frame, after
+// the UI has run and before the frame graph consumes the reset requests.
+class CameraTimelineRecorder {
+public:
+    bool begin(const std::string& path, double startSeconds) {
+        m_path = path;
+        m_timeline = CameraTimeline{};
+        m_startSeconds = startSeconds;
+        m_lastToggles.clear();
+        m_active = !path.empty();
+        if (m_active) {
+            spdlog::info("Recording camera timeline to {}", path);
+        }
+        return m_active;
+    }
+
+    bool active() const { return m_active; }
+
+    // Stored only on the frames the value changes.
+    void recordToggle(const char* name, double value) {
+        if (!m_active) {
+            return;
+        }
+        auto last = std::find_if(m_lastToggles.begin(), m_lastToggles.end(),
+                                 [name](const CameraTimeline::ToggleKey& key) { return key.name == name; });
+        if (last != m_lastToggles.end()) {
+            if (last->value == value) {
+                return;
+            }
+            last->value = value;
+        } else {
+            m_lastToggles.push_back({0u, name, value});
+        }
+        m_timeline.toggles.push_back({m_timeline.frameCount, name, value});
+    }
+
+    void recordFrame(const OrbitCamera& camera, uint32_t resetFlags) {
+        if (!m_active) {
+            return;
+        }
+        const CameraTimelinePose pose = CameraTimelinePose::fromCamera(camera);
+        if (m_timeline.camera.empty() || !(m_timeline.camera.back().pose == pose)) {
+            m_timeline.camera.push_back({m_timeline.frameCount, pose});
+        }
+        if (resetFlags != 0u) {
+            m_timeline.resets.push_back({m_timeline.frameCount, resetFlags});
+        }
+        ++m_timeline.frameCount;
+    }
+
+    void finish(double endSeconds) {
+        if (!m_active) {
+            return;
+        }
+        if (m_timeline.frameCount > 0u) {
+            m_timeline.timestep = std::max(1e-4, (endSeconds - m_startSeconds) / m_timeline.frameCount);
+        }
+        if (m_timeline.save(m_path)) {
+            spdlog::info("Recorded {} frames ({} camera keys, {} toggles) to {}",
+                         m_timeline.frameCount, m_timeline.camera.size(), m_timeline.toggles.size(), m_path);
+        }
+        m_active = false;
+    }
+
+private:
+    std::string m_path;
+    CameraTimeline m_timeline;
+    std::vector<CameraTimeline::ToggleKey> m_lastToggles;
+    double m_startSeconds = 0.0;
+    bool m_active = false;
+};
+
+// --replay-timeline <json> (and --bench-timeline). Query the current frame's state
+// before the view is built, then advance() once per rendered frame. Past the end
+// the last recorded state holds.
+class CameraTimelinePlayer {
+public:
+    bool begin(const std::string& path) {
+        m_frame = 0u;
+        m_active = false;
+        if (path.empty() || !m_timeline.load(path)) {
+            return false;
+        }
+        m_active = true;
+        spdlog::info("Replaying camera timeline {} ({} frames)", path, m_timeline.frameCount);
+        return true;
+    }
+
+    bool active() const { return m_active; }
+    bool finished() const { return m_active && m_frame >= m_timeline.frameCount; }
+    uint32_t frame() const { return m_frame; }
+    float timestep() const { return static_cast<float>(m_timeline.timestep); }
+
+    void applyCamera(OrbitCamera& camera) const {
+        if (!m_active) {
+            return;
+        }
+        auto next = std::upper_bound(m_timeline.camera.begin(), m_timeline.camera.end(), m_frame,
+                                     [](uint32_t frame, const CameraTimeline::CameraKey& key) {
+                                         return frame < key.frame;
+                                     });
+        if (next != m_timeline.camera.begin()) {
+            --next;
+        }
+        next->pose.apply(camera);
+    }
+
+    // Latest recorded value at or before this frame; fallback if never recorded.
+    double toggle(const char* name, double fallback) const {
+        double value = fallback;
+        for (const CameraTimeline::ToggleKey& key : m_timeline.toggles) {
+            if (key.frame > m_frame) {
+                break;
+            }
+            if (key.name == name) {
+                value = key.value;
+            }
+        }
+        return value;
+    }
+
+    uint32_t resetFlags() const {
+        uint32_t flags = 0u;
+        for (const CameraTimeline::ResetKey& key : m_timeline.resets) {
+            if (key.frame == m_frame) {
+                flags |= key.flags;
+            } else if (key.frame > m_frame) {
+                break;
+            }
+        }
+        return flags;
+    }
+
+    void advance() {
+        if (m_active) {
+            ++m_frame;
+        }
+    }
+
+private:
+    CameraTimeline m_timeline;
+    uint32_t m_frame = 0u;
+    bool m_active = false;
+};
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "async_file_reader.h"
 #include "cluster_lod_builder.h"
+#include "cpu_profile_zones.h"
 #include "frame_context.h"
 #include "gpu_cull_resources.h"
 #include "gpu_driven_helpers.h"
+#include "job_system.h"
 #include "rhi_backend.h"
 #include "rhi_resource_utils.h"
 #include "streaming_storage.h"
@@ -12,9 +15,11 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -40,6 +45,7 @@ public:
         uint32_t dynamicResidentGroupCount = 0;
 
         uint64_t storagePoolCapacityBytes = 0u;
+        uint64_t storagePoolReservedBytes = 0u;
         uint64_t storagePoolUsedBytes = 0u;
         uint32_t residentHeapCapacity = 0;
         uint32_t residentHeapUsed = 0;
@@ -54,6 +60,20 @@ public:
         float transferUtilization = 0.0f;
 
         uint32_t failedAllocations = 0;
+        uint32_t storageFreeRangeCount = 0;
+        uint32_t storageLargestFreeRange = 0;
+        float storageFragmentation = 0.0f;
+
+        // Frames from a group's first load request to its promotion, for the
+        // groups promoted this frame.
+        uint32_t popLatencySampleCount = 0;
+        float popLatencyAverageFrames = 0.0f;
+        uint32_t popLatencyMaxFrames = 0;
+        float requestReadbackCpuMs = 0.0f;
+        uint32_t defragMovesThisFrame = 0;
+        uint32_t groupPageReadsThisFrame = 0;
+        uint64_t groupPageReadFailures = 0u;
+        bool groupPagesOnDisk = false;
         bool adaptiveBudgetEnabled = false;
         uint32_t configuredAgeThreshold = 0;
         uint32_t effectiveAgeThreshold = 0;
@@ -88,6 +108,10 @@ public:
         uint32_t activeResidencyNodeCount = 0;
         uint32_t activeResidencyGroupCount = 0;
         uint32_t lastResidencyRequestCount = 0;
+        uint32_t lastCompactRequestReadCount = 0;
+        uint32_t lastPrefetchRequestCount = 0;
+        uint32_t lastPrefetchPromotedCount = 0;
+        uint32_t lastExpiredPendingCount = 0;
         uint32_t lastUnloadRequestCount = 0;
         uint32_t lastResidencyPromotedCount = 0;
         uint32_t lastResidencyEvictedCount = 0;
@@ -103,6 +127,12 @@ public:
         uint32_t maxUnloadsPerFrame = 0;
         uint32_t ageThreshold = 0;
         uint32_t streamingTaskCapacity = 0;
+        uint32_t streamingTaskStallCount = 0;
+        uint64_t streamingTaskTransferBudgetBytes = 0u;
+        float taskPrepareLatencyMs = 0.0f;
+        float taskTransferLatencyMs = 0.0f;
+        float taskRetireLatencyMs = 0.0f;
+        float transferThroughputBytesPerSecond = 0.0f;
         uint32_t freeStreamingTaskCount = 0;
         uint32_t preparedStreamingTaskCount = 0;
         uint32_t transferSubmittedTaskCount = 0;
@@ -112,6 +142,7 @@ public:
         uint32_t selectedUpdatePatchCount = 0;
         uint64_t selectedTransferBytes = 0u;
         uint64_t selectedUpdateTransferWaitValue = 0u;
+        bool compactRequestReadbackActive = false;
         bool resourcesReady = false;
     };
 
@@ -140,6 +171,9 @@ public:
 
     bool streamingEnabled() const { return m_enableStreaming; }
 
+    // CPU residency the cull pass draws from; ray tracing follows it to pick BLAS LODs.
+    bool groupResident(uint32_t groupIndex) const { return isGroupResident(groupIndex); }
+
     void setGpuStatsReadbackEnabled(bool enabled) {
         if (m_enableGpuStatsReadback == enabled) {
             return;
@@ -151,6 +185,9 @@ public:
 
     bool gpuStatsReadbackEnabled() const { return m_enableGpuStatsReadback; }
 
+    void setDefragmentationEnabled(bool enabled) { m_enableDefragmentation = enabled; }
+    bool defragmentationEnabled() const { return m_enableDefragmentation; }
+
     void setStreamingBudgetGroups(uint32_t budgetGroups) {
         setStreamingBudgetGroupsInternal(budgetGroups, true);
     }
@@ -192,6 +229,15 @@ public:
 
     uint32_t maxLoadsPerFrame() const { return m_maxLoadsPerFrame; }
 
+    void setResidencyPrefetchEnabled(bool enabled) { m_enableResidencyPrefetch = enabled; }
+    bool residencyPrefetchEnabled() const { return m_enableResidencyPrefetch; }
+
+    // How far ahead the cull pass extrapolates camera motion when prefetching finer LODs.
+    void setPrefetchLookaheadSeconds(float seconds) {
+        m_prefetchLookaheadSeconds = std::clamp(seconds, 0.0f, kMaxPrefetchLookaheadSeconds);
+    }
+    float prefetchLookaheadSeconds() const { return m_prefetchLookaheadSeconds; }
+
     void setMaxUnloadsPerFrame(uint32_t maxUnloadsPerFrame) {
         m_maxUnloadsPerFrame = std::max(1u, maxUnloadsPerFrame);
     }
@@ -215,6 +261,39 @@ public:
 
     bool compactAgeFilterDispatchEnabled() const { return m_useCompactAgeFilterDispatch; }
 
+    void setCompactRequestReadbackEnabled(bool enabled) {
+        m_useCompactRequestReadback = enabled;
+    }
+
+    bool compactRequestReadbackEnabled() const { return m_useCompactRequestReadback; }
+
+    // Sizes the streaming task ring and the per-task staging budget from measured
+    // transfer throughput. When disabled the ring stays at its minimum depth and
+    // each task may fill its whole staging buffer.
+    void setAdaptiveTaskPipelineEnabled(bool enabled) { m_adaptiveTaskPipelineEnabled = enabled; }
+    bool adaptiveTaskPipelineEnabled() const { return m_adaptiveTaskPipelineEnabled; }
+    uint32_t streamingTaskCount() const { return m_streamingTaskCount; }
+
+    // All primitive groups of the scene share one storage pool and one load queue.
+    // The weight scales the priority of a group's load requests, so weighted assets
+    // win contended loads while unweighted ones still stream whatever is on screen.
+    // A weight of 0 keeps the group at its always-resident LOD.
+    void setPrimitiveGroupImportance(uint32_t primitiveGroupIndex, float weight) {
+        if (primitiveGroupIndex >= m_primitiveGroupImportance.size()) {
+            m_primitiveGroupImportance.resize(size_t(primitiveGroupIndex) + 1u, 1.0f);
+        }
+        m_primitiveGroupImportance[primitiveGroupIndex] =
+            std::clamp(weight, 0.0f, kMaxPrimitiveGroupImportance);
+    }
+    float primitiveGroupImportance(uint32_t primitiveGroupIndex) const {
+        return primitiveGroupIndex < m_primitiveGroupImportance.size()
+                   ? m_primitiveGroupImportance[primitiveGroupIndex]
+                   : 1.0f;
+    }
+    uint32_t primitiveGroupCount() const { return m_primitiveGroupCount; }
+    void resetPrimitiveGroupImportance() { m_primitiveGroupImportance.clear(); }
+    uint64_t streamingTaskTransferBudgetBytes() const { return m_streamingStorage.uploadBudgetBytes(); }
+
     void setAdaptiveBudgetEnabled(bool enabled) {
         if (m_adaptiveBudgetEnabled == enabled) {
             return;
@@ -267,11 +346,15 @@ public:
     void markStateDirty() { m_stateDirty = true; }
 
     void resetForPipelineReload() {
+        waitForPrepareJob();
         resetStreamingTasks();
         std::fill(m_groupPendingUnloadState.begin(), m_groupPendingUnloadState.end(), 0u);
         std::fill(m_pendingResidencyRequestFrames.begin(),
                   m_pendingResidencyRequestFrames.end(),
                   kInvalidFrameIndex);
+        std::fill(m_pendingResidencyFirstRequestFrames.begin(),
+                  m_pendingResidencyFirstRequestFrames.end(),
+                  kInvalidFrameIndex);
         std::fill(m_residentTouchSeenScratch.begin(), m_residentTouchSeenScratch.end(), 0u);
         std::fill(m_unloadRequestSeenScratch.begin(), m_unloadRequestSeenScratch.end(), 0u);
         std::fill(m_patchLastWriteIndexScratch.begin(), m_patchLastWriteIndexScratch.end(), UINT32_MAX);
@@ -280,10 +363,7 @@ public:
         m_requestReadbackScratch.clear();
         m_unloadRequestReadbackScratch.clear();
         m_confirmedUnloadGroups.clear();
-        m_loadRequestsThisFrame = 0u;
-        m_unloadRequestsThisFrame = 0u;
-        m_failedAllocationsThisFrame = 0u;
-        m_lastProcessedRequestFrameIndex = kInvalidFrameIndex;
+        resetPrepareTelemetry();
         m_residencySourceNodeBufferHandle = nullptr;
         m_residencySourceGroupBufferHandle = nullptr;
         m_residencySourceGroupMeshletIndicesHandle = nullptr;
@@ -315,7 +395,8 @@ public:
     }
 
     bool ready() const {
-        for (const FrameBuffers& frameBuffers : m_frameBuffers) {
+        for (uint32_t frameSlot = 0u; frameSlot < m_bufferedFrameCount; ++frameSlot) {
+            const FrameBuffers& frameBuffers = m_frameBuffers[frameSlot];
             if (!frameBuffers.groupResidencyBuffer ||
                 !frameBuffers.groupAgeBuffer ||
                 !frameBuffers.activeResidentGroupsBuffer ||
@@ -372,6 +453,11 @@ public:
     const RhiBuffer* residentGroupMeshletIndicesBuffer() const {
         return m_streamingStorage.buffer();
     }
+    // Base address page table entries are built from, or 0 to keep element offsets.
+    // Fixed for the life of the page table: both are recreated together.
+    uint64_t residentHeapAddress() const {
+        return m_streamingStorage.ready() ? m_streamingStorage.buffer()->gpuAddress() : 0u;
+    }
     const RhiBuffer* streamingUploadStagingBuffer() const {
         return validTaskIndex(m_transferTaskIndex) ? m_streamingStorage.uploadBuffer(m_transferTaskIndex)
                                                    : nullptr;
@@ -395,6 +481,13 @@ public:
     const RhiBuffer* residencyRequestStateBuffer() const {
         return activeFrameBuffers().residencyRequestStateBuffer.get();
     }
+    const RhiBuffer* compactResidencyRequestBuffer() const {
+        return activeFrameBuffers().compactResidencyRequestBuffer.get();
+    }
+    // Only as many requests as the CPU can promote in one frame are worth compacting.
+    uint32_t compactResidencyRequestOutputCapacity() const {
+        return std::min(m_maxLoadsPerFrame, kCompactResidencyRequestCapacity);
+    }
     const RhiBuffer* unloadRequestBuffer() const {
         return activeFrameBuffers().unloadRequestBuffer.get();
     }
@@ -407,6 +500,11 @@ public:
     uint32_t streamingPatchCount() const {
         return m_activeUpdatePatchCount;
     }
+    // Clusters covered by the first streamingPatchCount() patches; sizes the
+    // one-thread-per-cluster copy dispatch.
+    uint32_t streamingPatchClusterCount() const {
+        return m_activeUpdatePatchClusterCount;
+    }
     uint32_t activeResidentPatchCount() const {
         return m_activeActiveResidentPatchCount;
     }
@@ -436,6 +534,8 @@ public:
         task.state = StreamingTaskState::TransferSubmitted;
         task.transferWaitValue = waitValue;
         task.transferSubmitFrame = m_frameIndex;
+        task.transferBytes = m_streamingStorage.uploadBytesUsed(m_transferTaskIndex);
+        task.transferSubmitTime = std::chrono::steady_clock::now();
         m_transferTaskIndex = kInvalidTaskIndex;
     }
     void markUpdateTaskQueued() {
@@ -447,6 +547,7 @@ public:
         StreamingTask& task = m_streamingTasks[m_updateTaskIndex];
         task.state = StreamingTaskState::UpdateQueued;
         task.updateQueuedFrame = m_frameIndex;
+        task.updateQueuedTime = std::chrono::steady_clock::now();
         if (m_pendingUpdateGraphicsCompletionSerial != 0u) {
             task.graphicsCompletionSerial = m_pendingUpdateGraphicsCompletionSerial;
             m_pendingUpdateGraphicsCompletionSerial = 0u;
@@ -465,21 +566,21 @@ public:
     void runUpdateStage(const ClusterLODData& clusterLodData,
                         const PipelineRuntimeContext& runtimeContext,
                         const FrameContext* frameContext) {
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::Update", METALLIC_CPU_ZONE_STREAMING);
+        RhiMemoryTagScope streamingTag(RhiMemoryTag::StreamingPool);
+        waitForPrepareJob();
         m_debugStats.activeResidencyNodeCount = clusterLodData.totalNodeCount;
         m_debugStats.activeResidencyGroupCount = clusterLodData.totalGroupCount;
-        m_activeFrameSlot = frameContext ? (frameContext->frameIndex % kBufferedFrameCount) : 0u;
+        m_activeFrameSlot = frameContext ? (frameContext->frameIndex % m_bufferedFrameCount) : 0u;
         m_frameIndex = frameContext ? frameContext->frameIndex : 0u;
         m_prepareTaskIndex = kInvalidTaskIndex;
         m_transferTaskIndex = kInvalidTaskIndex;
         m_updateTaskIndex = kInvalidTaskIndex;
         m_activeUpdatePatchCount = 0u;
+        m_activeUpdatePatchClusterCount = 0u;
         m_activeActiveResidentPatchCount = 0u;
         m_activeUpdateTransferWaitValue = 0u;
         m_activeFrameResidentGroupCount = 0u;
-        m_loadRequestsThisFrame = 0u;
-        m_unloadRequestsThisFrame = 0u;
-        m_failedAllocationsThisFrame = 0u;
-        m_lastProcessedRequestFrameIndex = kInvalidFrameIndex;
         resetDegradationTelemetryForFrame();
         switchSceneBudgetState(clusterLodData);
 
@@ -497,10 +598,14 @@ public:
         ensureStreamingResources(clusterLodData, runtimeContext);
         if (!ready()) {
             resetAdaptiveBudgetState(true);
+            resetPrepareTelemetry();
             updateDebugStats(&clusterLodData);
             return;
         }
         recycleCompletedTasks(runtimeContext);
+        adaptStreamingTaskPipeline(runtimeContext, frameContext);
+        ensureGroupPageReader(clusterLodData);
+        reportGroupPageReadFailures();
 
         const bool sourceBufferChanged =
             m_residencySourceNodeBufferHandle != clusterLodData.nodeBuffer.nativeHandle() ||
@@ -511,6 +616,9 @@ public:
         if (m_stateDirty || sourceBufferChanged) {
             requestHistoryReset(frameContext);
             resetStreamingTasks();
+            resetPrepareTelemetry();
+            // The rebuild stages every always-resident group at once.
+            m_streamingStorage.setUploadBudgetBytes(0u);
             if (beginPrepareTask()) {
                 // The page table is device-local. Clear it immediately on rebuild so the
                 // cull shader never dereferences stale resident heap offsets for one frame.
@@ -519,16 +627,17 @@ public:
             }
             if (beginPrepareTask()) {
                 rebuildStreamingState(clusterLodData);
+                // Always-resident groups must land with the cleared page table, so
+                // their page reads are not allowed to slip to a later frame.
+                m_groupPageReader.waitIdle();
                 finalizePrepareTask();
             } else {
                 rebuildStreamingState(clusterLodData);
             }
         } else {
-            runRequestReadbackStage(clusterLodData);
-            if (beginPrepareTask()) {
-                runResidencyUpdateStage(clusterLodData);
-                finalizePrepareTask();
-            }
+            // The upload below re-seeds this slot's request queues, so the readback
+            // has to leave the mapped buffers before the job starts.
+            captureRequestReadback();
         }
 
         selectTransferTask();
@@ -538,14 +647,48 @@ public:
         uploadCanonicalStateToActiveFrame(forceCanonicalUpload);
         updateAdaptiveBudget();
         updateDebugStats(&clusterLodData);
+        if (!forceCanonicalUpload) {
+            launchPrepareJob(clusterLodData);
+        }
     }
 
+    // Joins the prepare job launched by the last runUpdateStage. Between the two, only
+    // the pass accessors of the transfer and update tasks may be used; everything else
+    // (setters, stats, residency queries, CPU mirrors of the scene) waits here first.
+    void waitForPrepareJob() {
+        if (m_prepareJobLaunched) {
+            Jobs::JobSystem::instance().wait(m_prepareJob);
+            m_prepareJobLaunched = false;
+        }
+    }
+
+    ~ClusterStreamingService() { waitForPrepareJob(); }
+
 private:
     static constexpr uint32_t kInvalidResidentHeapOffset = UINT32_MAX;
     static constexpr uint32_t kInvalidTaskIndex = UINT32_MAX;
     static constexpr uint32_t kInvalidFrameIndex = UINT32_MAX;
-    static constexpr uint32_t kBufferedFrameCount = 2u;
-    static constexpr uint32_t kStreamingTaskCount = 3u;
+    static constexpr uint8_t kInvalidLodDepth = UINT8_MAX;
+    // Per-frame buffer sets follow the RHI's frames in flight.
+    static constexpr uint32_t kMaxBufferedFrameCount = kRhiMaxFramesInFlight;
+    static constexpr uint32_t kMinStreamingTaskCount = 3u;
+    static constexpr uint32_t kMaxStreamingTaskCount = 8u;
+    static constexpr uint32_t kTaskPipelineEvaluationIntervalFrames = 16u;
+    static constexpr float kTaskTelemetrySmoothing = 0.1f;
+    // Each task may stage this many frames' worth of measured transfer throughput.
+    static constexpr double kTaskTransferBudgetHeadroom = 2.0;
+    static constexpr uint64_t kMinTaskTransferBudgetBytes = 1ull * 1024ull * 1024ull;
+    // Extra task slots are only added while their staging buffers fit in this pool.
+    static constexpr uint64_t kMaxStreamingStagingPoolBytes = 128ull * 1024ull * 1024ull;
+    static constexpr uint32_t kMaxDefragMovesPerFrame = 16u;
+    static constexpr uint32_t kCompactResidencyRequestCapacity = 1024u;
+    // Pending loads the GPU has not repeated for this many frames are dropped from the queue.
+    static constexpr uint32_t kPendingRequestExpiryFrames = 30u;
+    // Prefetch loads get at most 1 / kPrefetchLoadShareDivisor of each frame's load cap.
+    static constexpr uint32_t kPrefetchLoadShareDivisor = 4u;
+    static constexpr float kMaxPrefetchLookaheadSeconds = 2.0f;
+    static constexpr float kMaxPrimitiveGroupImportance = 16.0f;
+    static constexpr float kDefragFragmentationThreshold = 0.5f;
     static constexpr uint64_t kDefaultStreamingStorageCapacityBytes = 512ull * 1024ull * 1024ull;
     static constexpr uint64_t kDefaultMaxStreamingTransferBytes = 32ull * 1024ull * 1024ull;
     static constexpr uint64_t kAutoStreamingStorageAlignmentBytes = 16ull * 1024ull * 1024ull;
@@ -567,6 +710,7 @@ private:
         BudgetPreset preset = BudgetPreset::Auto;
         uint32_t streamingBudgetGroups = kMediumPresetStreamingBudgetGroups;
         uint64_t streamingStorageCapacityBytes = kDefaultStreamingStorageCapacityBytes;
+        std::vector<float> primitiveGroupImportance;
     };
 
     enum class StreamingTaskState : uint8_t {
@@ -583,6 +727,11 @@ private:
         uint64_t transferWaitValue = 0u;
         uint64_t serial = 0u;
         uint64_t graphicsCompletionSerial = 0u;
+        uint64_t pageReadTicket = 0u;
+        uint64_t transferBytes = 0u;
+        std::chrono::steady_clock::time_point prepareTime{};
+        std::chrono::steady_clock::time_point transferSubmitTime{};
+        std::chrono::steady_clock::time_point updateQueuedTime{};
         uint32_t activeResidentGroupCountAfter = 0u;
         std::vector<StreamingPatch> patches;
         std::vector<ActiveResidentGroupPatch> activeResidentPatches;
@@ -594,12 +743,26 @@ private:
         uint32_t heapCount = 0;
     };
 
+    // What captureRequestReadback took from a frame slot; the lists themselves are in
+    // m_requestReadbackScratch and m_unloadRequestReadbackScratch.
+    struct RequestReadback {
+        uint32_t frameIndex = kInvalidFrameIndex;
+        uint32_t gpuAgeFilterDispatchFrameIndex = kInvalidFrameIndex;
+        uint32_t compactLoadRequestCount = 0u;
+        bool compact = false;
+        bool requestListRead = false;
+        bool requestsValid = true;
+        bool unloadListRead = false;
+        bool unloadsValid = true;
+    };
+
     struct FrameBuffers {
         std::unique_ptr<RhiBuffer> groupResidencyBuffer;
         std::unique_ptr<RhiBuffer> groupAgeBuffer;
         std::unique_ptr<RhiBuffer> activeResidentGroupsBuffer;
         std::unique_ptr<RhiBuffer> activeResidentPatchBuffer;
         std::unique_ptr<RhiBuffer> residencyRequestBuffer;
+        std::unique_ptr<RhiBuffer> compactResidencyRequestBuffer;
         std::unique_ptr<RhiBuffer> residencyRequestStateBuffer;
         std::unique_ptr<RhiBuffer> unloadRequestBuffer;
         std::unique_ptr<RhiBuffer> unloadRequestStateBuffer;
@@ -607,7 +770,12 @@ private:
         std::unique_ptr<RhiBuffer> streamingPatchBuffer;
         uint32_t submittedFrameIndex = kInvalidFrameIndex;
         uint32_t submittedActiveResidentGroupCount = 0u;
+        uint32_t writtenActiveResidentGroupCount = UINT32_MAX;
         uint32_t gpuAgeFilterDispatchFrameIndex = kInvalidFrameIndex;
+        // Groups whose residency changed on the CPU since this slot's buffers were last
+        // written. Steady-state frames forward only these words to the GPU copy.
+        std::vector<uint32_t> pendingStateDeltas;
+        bool fullStateUploadRequired = true;
     };
 
     static void resetFrameBuffers(FrameBuffers& frameBuffers) {
@@ -616,6 +784,7 @@ private:
         frameBuffers.activeResidentGroupsBuffer.reset();
         frameBuffers.activeResidentPatchBuffer.reset();
         frameBuffers.residencyRequestBuffer.reset();
+        frameBuffers.compactResidencyRequestBuffer.reset();
         frameBuffers.residencyRequestStateBuffer.reset();
         frameBuffers.unloadRequestBuffer.reset();
         frameBuffers.unloadRequestStateBuffer.reset();
@@ -623,19 +792,22 @@ private:
         frameBuffers.streamingPatchBuffer.reset();
         frameBuffers.submittedFrameIndex = kInvalidFrameIndex;
         frameBuffers.submittedActiveResidentGroupCount = 0u;
+        frameBuffers.writtenActiveResidentGroupCount = UINT32_MAX;
         frameBuffers.gpuAgeFilterDispatchFrameIndex = kInvalidFrameIndex;
+        frameBuffers.pendingStateDeltas.clear();
+        frameBuffers.fullStateUploadRequired = true;
     }
 
     FrameBuffers& activeFrameBuffers() {
-        return m_frameBuffers[m_activeFrameSlot % kBufferedFrameCount];
+        return m_frameBuffers[m_activeFrameSlot % m_bufferedFrameCount];
     }
 
     const FrameBuffers& activeFrameBuffers() const {
-        return m_frameBuffers[m_activeFrameSlot % kBufferedFrameCount];
+        return m_frameBuffers[m_activeFrameSlot % m_bufferedFrameCount];
     }
 
-    static bool validTaskIndex(uint32_t taskIndex) {
-        return taskIndex < kStreamingTaskCount;
+    bool validTaskIndex(uint32_t taskIndex) const {
+        return taskIndex < m_streamingTaskCount;
     }
 
     bool taskHasTransferWork(uint32_t taskIndex) const {
@@ -648,14 +820,17 @@ private:
             return;
         }
 
-        m_streamingStorage.resetUploadFrame(taskIndex);
         StreamingTask& task = m_streamingTasks[taskIndex];
+        m_groupPageReader.wait(task.pageReadTicket);
+        m_streamingStorage.resetUploadFrame(taskIndex);
         task.state = StreamingTaskState::Free;
         task.transferSubmitFrame = UINT32_MAX;
         task.updateQueuedFrame = UINT32_MAX;
         task.transferWaitValue = 0u;
         task.serial = 0u;
         task.graphicsCompletionSerial = 0u;
+        task.pageReadTicket = 0u;
+        task.transferBytes = 0u;
         task.activeResidentGroupCountAfter = 0u;
         task.patches.clear();
         task.activeResidentPatches.clear();
@@ -673,13 +848,14 @@ private:
     }
 
     void resetStreamingTasks() {
-        for (uint32_t taskIndex = 0u; taskIndex < kStreamingTaskCount; ++taskIndex) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
             releaseTask(taskIndex);
         }
         m_prepareTaskIndex = kInvalidTaskIndex;
         m_transferTaskIndex = kInvalidTaskIndex;
         m_updateTaskIndex = kInvalidTaskIndex;
         m_activeUpdatePatchCount = 0u;
+        m_activeUpdatePatchClusterCount = 0u;
         m_activeActiveResidentPatchCount = 0u;
         m_activeUpdateTransferWaitValue = 0u;
         m_activeFrameResidentGroupCount = 0u;
@@ -693,7 +869,7 @@ private:
     void recycleCompletedTasks(const PipelineRuntimeContext& runtimeContext) {
         const uint64_t completedGraphicsSerial =
             runtimeContext.rhi ? runtimeContext.rhi->completedGraphicsSubmissionSerial() : 0u;
-        for (uint32_t taskIndex = 0u; taskIndex < kStreamingTaskCount; ++taskIndex) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
             const StreamingTask& task = m_streamingTasks[taskIndex];
             if (task.state != StreamingTaskState::UpdateQueued) {
                 continue;
@@ -704,17 +880,129 @@ private:
                 completedGraphicsSerial >= task.graphicsCompletionSerial;
             const bool completedByFrameDelay =
                 task.updateQueuedFrame != UINT32_MAX &&
-                m_frameIndex >= task.updateQueuedFrame + kBufferedFrameCount;
+                m_frameIndex >= task.updateQueuedFrame + m_bufferedFrameCount;
             if (!completedBySerial && !completedByFrameDelay) {
                 continue;
             }
 
+            recordRetiredTaskTelemetry(task);
             releaseTask(taskIndex);
         }
     }
 
+    static float smoothTaskTelemetry(float smoothed, float sample) {
+        return smoothed == 0.0f ? sample
+                                : smoothed + (sample - smoothed) * kTaskTelemetrySmoothing;
+    }
+
+    // Retirement is only observed once per frame, so the retire latency and the
+    // throughput derived from it are quantised to the frame time.
+    void recordRetiredTaskTelemetry(const StreamingTask& task) {
+        using Milliseconds = std::chrono::duration<float, std::milli>;
+        const auto now = std::chrono::steady_clock::now();
+        m_smoothedTaskPrepareLatencyMs =
+            smoothTaskTelemetry(m_smoothedTaskPrepareLatencyMs,
+                                Milliseconds(task.transferSubmitTime - task.prepareTime).count());
+        m_smoothedTaskTransferLatencyMs =
+            smoothTaskTelemetry(m_smoothedTaskTransferLatencyMs,
+                                Milliseconds(task.updateQueuedTime - task.transferSubmitTime).count());
+        m_smoothedTaskRetireLatencyMs =
+            smoothTaskTelemetry(m_smoothedTaskRetireLatencyMs,
+                                Milliseconds(now - task.updateQueuedTime).count());
+
+        const float transferMs = Milliseconds(now - task.transferSubmitTime).count();
+        if (task.transferBytes != 0u && transferMs > 0.0f) {
+            m_smoothedTransferBytesPerSecond =
+                smoothTaskTelemetry(m_smoothedTransferBytesPerSecond,
+                                    float(double(task.transferBytes) * 1000.0 / double(transferMs)));
+        }
+    }
+
+    uint32_t maxStreamingTaskCountForStaging() const {
+        const uint64_t stagingBytesPerTask =
+            std::max<uint64_t>(m_streamingStorage.maxUploadBytesPerFrame(), 1u);
+        return static_cast<uint32_t>(
+            std::clamp<uint64_t>(kMaxStreamingStagingPoolBytes / stagingBytesPerTask,
+                                 kMinStreamingTaskCount,
+                                 kMaxStreamingTaskCount));
+    }
+
+    uint64_t computeTaskTransferBudgetBytes() const {
+        if (!m_adaptiveTaskPipelineEnabled || m_smoothedTransferBytesPerSecond <= 0.0f ||
+            m_smoothedFrameSeconds <= 0.0f) {
+            return 0u;
+        }
+
+        const double budgetBytes = double(m_smoothedTransferBytesPerSecond) *
+                                   double(m_smoothedFrameSeconds) * kTaskTransferBudgetHeadroom;
+        return std::clamp<uint64_t>(static_cast<uint64_t>(budgetBytes),
+                                    kMinTaskTransferBudgetBytes,
+                                    std::max(m_streamingStorage.maxUploadBytesPerFrame(),
+                                             kMinTaskTransferBudgetBytes));
+    }
+
+    // Grows the ring by one slot after a window in which prepare found no free task,
+    // and drops trailing free slots once the window's peak occupancy leaves them idle.
+    void adaptStreamingTaskPipeline(const PipelineRuntimeContext& runtimeContext,
+                                    const FrameContext* frameContext) {
+        if (frameContext && frameContext->deltaTime > 0.0f) {
+            m_smoothedFrameSeconds =
+                smoothTaskTelemetry(m_smoothedFrameSeconds, frameContext->deltaTime);
+        }
+
+        uint32_t busyTaskCount = 0u;
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
+            busyTaskCount += m_streamingTasks[taskIndex].state != StreamingTaskState::Free ? 1u : 0u;
+        }
+        m_taskPipelinePeakBusyCount = std::max(m_taskPipelinePeakBusyCount, busyTaskCount);
+        m_streamingStorage.setUploadBudgetBytes(computeTaskTransferBudgetBytes());
+
+        if (++m_taskPipelineEvaluationFrameCount < kTaskPipelineEvaluationIntervalFrames) {
+            return;
+        }
+
+        uint32_t targetTaskCount = m_streamingTaskCount;
+        if (!m_adaptiveTaskPipelineEnabled) {
+            targetTaskCount = kMinStreamingTaskCount;
+        } else if (m_taskPipelineStallCount != 0u) {
+            targetTaskCount = m_streamingTaskCount + 1u;
+        } else if (m_taskPipelinePeakBusyCount + 1u < m_streamingTaskCount) {
+            targetTaskCount = m_streamingTaskCount - 1u;
+        }
+        targetTaskCount =
+            std::clamp(targetTaskCount, kMinStreamingTaskCount, maxStreamingTaskCountForStaging());
+        resizeStreamingTaskRing(targetTaskCount, runtimeContext);
+
+        m_lastTaskPipelineStallCount = m_taskPipelineStallCount;
+        m_taskPipelineEvaluationFrameCount = 0u;
+        m_taskPipelineStallCount = 0u;
+        m_taskPipelinePeakBusyCount = 0u;
+    }
+
+    void resizeStreamingTaskRing(uint32_t targetTaskCount,
+                                 const PipelineRuntimeContext& runtimeContext) {
+        uint32_t taskCount = m_streamingTaskCount;
+        // Only trailing free slots can go; a busy slot keeps the ring at its size.
+        while (taskCount > targetTaskCount &&
+               m_streamingTasks[taskCount - 1u].state == StreamingTaskState::Free) {
+            --taskCount;
+        }
+        taskCount = std::max(taskCount, targetTaskCount);
+        if (taskCount == m_streamingTaskCount || !runtimeContext.resourceFactory) {
+            return;
+        }
+
+        if (!m_streamingStorage.resizeUploadBuffers(*runtimeContext.resourceFactory,
+                                                    taskCount,
+                                                    "ClusterLodStreamingUpload")) {
+            spdlog::warn("Failed to resize ClusterLOD streaming task ring to {} slots", taskCount);
+            return;
+        }
+        m_streamingTaskCount = taskCount;
+    }
+
     bool beginPrepareTask() {
-        for (uint32_t taskIndex = 0u; taskIndex < kStreamingTaskCount; ++taskIndex) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
             if (m_streamingTasks[taskIndex].state != StreamingTaskState::Free) {
                 continue;
             }
@@ -728,6 +1016,9 @@ private:
             task.transferWaitValue = 0u;
             task.serial = 0u;
             task.graphicsCompletionSerial = 0u;
+            task.pageReadTicket = 0u;
+            task.transferBytes = 0u;
+            task.prepareTime = std::chrono::steady_clock::now();
             assignCurrentActiveResidentGroups(task.activeResidentGroupsBefore);
             task.activeResidentGroupCountAfter =
                 static_cast<uint32_t>(std::min<size_t>(task.activeResidentGroupsBefore.size(),
@@ -741,6 +1032,7 @@ private:
         }
 
         m_prepareTaskIndex = kInvalidTaskIndex;
+        ++m_taskPipelineStallCount;
         return false;
     }
 
@@ -758,6 +1050,13 @@ private:
         return static_cast<ClusterResidencyRequest*>(rhiBufferContents(*buffer));
     }
 
+    static ClusterResidencyRequestListHeader* mappedCompactRequestHeader(RhiBuffer* buffer) {
+        if (!buffer) {
+            return nullptr;
+        }
+        return static_cast<ClusterResidencyRequestListHeader*>(rhiBufferContents(*buffer));
+    }
+
     static ClusterUnloadRequest* mappedUnloadRequests(RhiBuffer* buffer) {
         if (!buffer) {
             return nullptr;
@@ -836,11 +1135,16 @@ private:
             return;
         }
 
-        std::memset(activeResidentWords,
-                    0xFF,
-                    size_t(m_residencyGroupCapacity) * sizeof(uint32_t));
         const uint32_t activeResidentGroupCount = static_cast<uint32_t>(std::min<size_t>(
             activeResidentGroups.size(), size_t(m_residencyGroupCapacity)));
+        const uint32_t staleEnd = std::min(frameBuffers.writtenActiveResidentGroupCount,
+                                           m_residencyGroupCapacity);
+        if (staleEnd > activeResidentGroupCount) {
+            std::memset(activeResidentWords + activeResidentGroupCount,
+                        0xFF,
+                        size_t(staleEnd - activeResidentGroupCount) * sizeof(uint32_t));
+        }
+        frameBuffers.writtenActiveResidentGroupCount = activeResidentGroupCount;
         if (activeResidentGroupCount == 0u) {
             return;
         }
@@ -852,9 +1156,14 @@ private:
 
     void resetDebugStats() {
         m_debugStats.lastResidencyRequestCount = 0;
+        m_debugStats.lastCompactRequestReadCount = 0;
+        m_debugStats.lastPrefetchRequestCount = 0;
+        m_debugStats.lastPrefetchPromotedCount = 0;
+        m_debugStats.lastExpiredPendingCount = 0;
         m_debugStats.lastUnloadRequestCount = 0;
         m_debugStats.lastResidencyPromotedCount = 0;
         m_debugStats.lastResidencyEvictedCount = 0;
+        m_debugStats.compactRequestReadbackActive = false;
         m_debugStats.lastResidentGroupCount = 0;
         m_debugStats.lastAlwaysResidentGroupCount = 0;
         m_debugStats.residentHeapCapacity = 0;
@@ -866,8 +1175,8 @@ private:
         m_debugStats.maxLoadsPerFrame = m_maxLoadsPerFrame;
         m_debugStats.maxUnloadsPerFrame = m_maxUnloadsPerFrame;
         m_debugStats.ageThreshold = m_ageThreshold;
-        m_debugStats.streamingTaskCapacity = kStreamingTaskCount;
-        m_debugStats.freeStreamingTaskCount = kStreamingTaskCount;
+        m_debugStats.streamingTaskCapacity = m_streamingTaskCount;
+        m_debugStats.freeStreamingTaskCount = m_streamingTaskCount;
         m_debugStats.preparedStreamingTaskCount = 0;
         m_debugStats.transferSubmittedTaskCount = 0;
         m_debugStats.updateQueuedTaskCount = 0;
@@ -879,12 +1188,9 @@ private:
         m_debugStats.resourcesReady = false;
         m_streamingStats = {};
         resetDegradationTelemetryForFrame();
+        resetPrepareTelemetry();
         m_cpuUnloadFallbackWasActive = false;
         applyAdaptiveBudgetTelemetry();
-        m_loadRequestsThisFrame = 0u;
-        m_unloadRequestsThisFrame = 0u;
-        m_failedAllocationsThisFrame = 0u;
-        m_lastProcessedRequestFrameIndex = kInvalidFrameIndex;
         clearGpuStreamingStats();
     }
 
@@ -903,21 +1209,21 @@ private:
                               uint32_t groupCapacity) {
         RhiBufferDesc residencyDesc{};
         residencyDesc.size = size_t(groupCapacity) * sizeof(uint32_t);
-        residencyDesc.hostVisible = true;
+        residencyDesc.memory = RhiBufferMemory::Upload;
         const std::string residencyName = "ClusterLodGroupResidency[" + std::to_string(frameSlot) + "]";
         residencyDesc.debugName = residencyName.c_str();
         frameBuffers.groupResidencyBuffer = runtimeContext.resourceFactory->createBuffer(residencyDesc);
 
         RhiBufferDesc ageDesc{};
         ageDesc.size = size_t(groupCapacity) * sizeof(uint32_t);
-        ageDesc.hostVisible = true;
+        ageDesc.memory = RhiBufferMemory::Upload;
         const std::string ageName = "ClusterLodGroupAge[" + std::to_string(frameSlot) + "]";
         ageDesc.debugName = ageName.c_str();
         frameBuffers.groupAgeBuffer = runtimeContext.resourceFactory->createBuffer(ageDesc);
 
         RhiBufferDesc activeResidentGroupsDesc{};
         activeResidentGroupsDesc.size = size_t(groupCapacity) * sizeof(uint32_t);
-        activeResidentGroupsDesc.hostVisible = true;
+        activeResidentGroupsDesc.memory = RhiBufferMemory::Upload;
         const std::string activeResidentGroupsName =
             "ClusterLodActiveResidentGroups[" + std::to_string(frameSlot) + "]";
         activeResidentGroupsDesc.debugName = activeResidentGroupsName.c_str();
@@ -926,7 +1232,7 @@ private:
 
         RhiBufferDesc activeResidentPatchDesc{};
         activeResidentPatchDesc.size = size_t(groupCapacity) * sizeof(ActiveResidentGroupPatch);
-        activeResidentPatchDesc.hostVisible = true;
+        activeResidentPatchDesc.memory = RhiBufferMemory::Upload;
         const std::string activeResidentPatchName =
             "ClusterLodActiveResidentPatches[" + std::to_string(frameSlot) + "]";
         activeResidentPatchDesc.debugName = activeResidentPatchName.c_str();
@@ -935,30 +1241,45 @@ private:
 
         RhiBufferDesc requestDesc{};
         requestDesc.size = size_t(groupCapacity) * sizeof(ClusterResidencyRequest);
-        requestDesc.hostVisible = true;
+        requestDesc.memory = RhiBufferMemory::Readback;
         const std::string requestName = "ClusterLodResidencyRequests[" + std::to_string(frameSlot) + "]";
         requestDesc.debugName = requestName.c_str();
         frameBuffers.residencyRequestBuffer = runtimeContext.resourceFactory->createBuffer(requestDesc);
 
         RhiBufferDesc requestStateDesc{};
         requestStateDesc.size = GpuDriven::ComputeDispatchCommandLayout::kBufferSize;
-        requestStateDesc.hostVisible = true;
+        requestStateDesc.memory = RhiBufferMemory::Readback;
         const std::string requestStateName =
             "ClusterLodResidencyRequestState[" + std::to_string(frameSlot) + "]";
         requestStateDesc.debugName = requestStateName.c_str();
         frameBuffers.residencyRequestStateBuffer =
             runtimeContext.resourceFactory->createBuffer(requestStateDesc);
 
+        RhiBufferDesc compactRequestDesc{};
+        compactRequestDesc.size = sizeof(ClusterResidencyRequestListHeader) +
+                                  size_t(kCompactResidencyRequestCapacity) *
+                                      sizeof(ClusterResidencyRequest);
+        compactRequestDesc.memory = RhiBufferMemory::Readback;
+        const std::string compactRequestName =
+            "ClusterLodCompactResidencyRequests[" + std::to_string(frameSlot) + "]";
+        compactRequestDesc.debugName = compactRequestName.c_str();
+        frameBuffers.compactResidencyRequestBuffer =
+            runtimeContext.resourceFactory->createBuffer(compactRequestDesc);
+        if (ClusterResidencyRequestListHeader* header =
+                mappedCompactRequestHeader(frameBuffers.compactResidencyRequestBuffer.get())) {
+            *header = {};
+        }
+
         RhiBufferDesc unloadDesc{};
         unloadDesc.size = size_t(groupCapacity) * sizeof(ClusterUnloadRequest);
-        unloadDesc.hostVisible = true;
+        unloadDesc.memory = RhiBufferMemory::Readback;
         const std::string unloadName = "ClusterLodUnloadRequests[" + std::to_string(frameSlot) + "]";
         unloadDesc.debugName = unloadName.c_str();
         frameBuffers.unloadRequestBuffer = runtimeContext.resourceFactory->createBuffer(unloadDesc);
 
         RhiBufferDesc unloadStateDesc{};
         unloadStateDesc.size = GpuDriven::ComputeDispatchCommandLayout::kBufferSize;
-        unloadStateDesc.hostVisible = true;
+        unloadStateDesc.memory = RhiBufferMemory::Readback;
         const std::string unloadStateName =
             "ClusterLodUnloadRequestState[" + std::to_string(frameSlot) + "]";
         unloadStateDesc.debugName = unloadStateName.c_str();
@@ -968,9 +1289,9 @@ private:
         RhiBufferDesc patchDesc{};
         patchDesc.size = size_t(groupCapacity) * sizeof(StreamingPatch);
 #ifdef _WIN32
-        patchDesc.hostVisible = false;
+        patchDesc.memory = RhiBufferMemory::DeviceLocal;
 #else
-        patchDesc.hostVisible = true;
+        patchDesc.memory = RhiBufferMemory::Upload;
 #endif
         const std::string patchName = "ClusterLodStreamingPatches[" + std::to_string(frameSlot) + "]";
         patchDesc.debugName = patchName.c_str();
@@ -979,9 +1300,9 @@ private:
         RhiBufferDesc statsDesc{};
         statsDesc.size = sizeof(ClusterStreamingGpuStats);
 #ifdef _WIN32
-        statsDesc.hostVisible = false;
+        statsDesc.memory = RhiBufferMemory::DeviceLocal;
 #else
-        statsDesc.hostVisible = true;
+        statsDesc.memory = RhiBufferMemory::Readback;
 #endif
         const std::string statsName = "ClusterLodStreamingStats[" + std::to_string(frameSlot) + "]";
         statsDesc.debugName = statsName.c_str();
@@ -996,25 +1317,39 @@ private:
 
         const uint32_t groupCapacity = std::max(1u, clusterLodData.totalGroupCount);
         const uint32_t storageCapacity = computeStreamingStorageCapacity(clusterLodData);
+        const uint32_t storageReservation =
+            computeStreamingStorageReservation(clusterLodData, storageCapacity);
         const uint64_t transferCapacityBytes = computeStreamingTransferCapacityBytes(clusterLodData);
+        const uint32_t bufferedFrameCount =
+            runtimeContext.rhi
+                ? std::clamp(runtimeContext.rhi->framesInFlight(), 2u, kMaxBufferedFrameCount)
+                : 2u;
         const bool hasExistingResources =
             m_residencyGroupCapacity != 0u || m_lodGroupPageTableBuffer || m_streamingStorage.ready() ||
             m_streamingStorage.uploadReady();
         const bool needsRecreate =
             !ready() ||
+            m_bufferedFrameCount != bufferedFrameCount ||
             m_residencyGroupCapacity != groupCapacity ||
-            m_streamingStorage.capacityElements() != storageCapacity ||
+            m_streamingStorage.reservedElements() != storageReservation ||
             m_streamingStorage.maxUploadBytesPerFrame() != transferCapacityBytes;
         if (!needsRecreate) {
+            // Inside the reservation a budget change only moves the allocator's limit;
+            // runCapacityDrainStage clears whatever a lower limit leaves above it.
+            m_streamingStorage.setCapacityElements(storageCapacity);
             return;
         }
 
         if (hasExistingResources && runtimeContext.rhi) {
             runtimeContext.rhi->waitIdle();
         }
+        m_groupPageReader.waitIdle();
 
-        for (uint32_t frameSlot = 0; frameSlot < kBufferedFrameCount; ++frameSlot) {
-            resetFrameBuffers(m_frameBuffers[frameSlot]);
+        for (FrameBuffers& frameBuffers : m_frameBuffers) {
+            resetFrameBuffers(frameBuffers);
+        }
+        m_bufferedFrameCount = bufferedFrameCount;
+        for (uint32_t frameSlot = 0; frameSlot < m_bufferedFrameCount; ++frameSlot) {
             createFrameBufferSet(m_frameBuffers[frameSlot],
                                  runtimeContext,
                                  frameSlot,
@@ -1023,15 +1358,16 @@ private:
 
         RhiBufferDesc groupPageTableDesc{};
         groupPageTableDesc.size = size_t(groupCapacity) * sizeof(uint64_t);
-        groupPageTableDesc.hostVisible = false;
+        groupPageTableDesc.memory = RhiBufferMemory::DeviceLocal;
         groupPageTableDesc.debugName = "ClusterLodGroupPageTable";
         m_lodGroupPageTableBuffer = runtimeContext.resourceFactory->createBuffer(groupPageTableDesc);
 
         m_streamingStorage.ensureBuffer(*runtimeContext.resourceFactory,
                                         storageCapacity,
+                                        storageReservation,
                                         "ClusterLodResidentGroupMeshletStorage");
         m_streamingStorage.ensureUploadBuffers(*runtimeContext.resourceFactory,
-                                              kStreamingTaskCount,
+                                              m_streamingTaskCount,
                                               transferCapacityBytes,
                                               "ClusterLodStreamingUpload");
 
@@ -1041,8 +1377,12 @@ private:
         m_groupResidentSinceFrame.assign(groupCapacity, kInvalidFrameIndex);
         m_groupPendingUnloadState.assign(groupCapacity, 0u);
         m_pendingResidencyRequestFrames.assign(groupCapacity, kInvalidFrameIndex);
+        m_pendingResidencyFirstRequestFrames.assign(groupCapacity, kInvalidFrameIndex);
+        m_pendingResidencyPriority.assign(groupCapacity, 0.0f);
+        m_pendingResidencyPrefetch.assign(groupCapacity, 0u);
         m_residentTouchSeenScratch.assign(groupCapacity, 0u);
         m_unloadRequestSeenScratch.assign(groupCapacity, 0u);
+        m_groupPendingDeltaSlots.assign(groupCapacity, 0u);
         m_patchLastWriteIndexScratch.assign(groupCapacity, UINT32_MAX);
         m_patchTouchedGroupsScratch.clear();
         m_stateDirty = true;
@@ -1087,24 +1427,56 @@ private:
                frameBuffers.gpuAgeFilterDispatchFrameIndex == expectedFrameIndex;
     }
 
-    void ingestMappedGpuSteadyState(const FrameBuffers& frameBuffers) {
-        if (m_groupResidencyState.size() != size_t(m_residencyGroupCapacity) ||
-            m_groupAgeState.size() != size_t(m_residencyGroupCapacity)) {
+    void markGroupResidencyChanged(uint32_t groupIndex) {
+        if (groupIndex >= m_groupPendingDeltaSlots.size()) {
             return;
         }
 
-        const uint32_t* residencyWords = mappedUint32(frameBuffers.groupResidencyBuffer.get());
-        const uint32_t* ageWords = mappedUint32(frameBuffers.groupAgeBuffer.get());
-        if (!residencyWords || !ageWords) {
-            return;
+        for (uint32_t frameSlot = 0u; frameSlot < m_bufferedFrameCount; ++frameSlot) {
+            const uint8_t slotBit = uint8_t(1u << frameSlot);
+            if ((m_groupPendingDeltaSlots[groupIndex] & slotBit) != 0u ||
+                m_frameBuffers[frameSlot].fullStateUploadRequired) {
+                continue;
+            }
+            m_groupPendingDeltaSlots[groupIndex] |= slotBit;
+            m_frameBuffers[frameSlot].pendingStateDeltas.push_back(groupIndex);
         }
+    }
+
+    void requireFullStateUploadForAllFrames() {
+        for (FrameBuffers& frameBuffers : m_frameBuffers) {
+            frameBuffers.pendingStateDeltas.clear();
+            frameBuffers.fullStateUploadRequired = true;
+        }
+        std::fill(m_groupPendingDeltaSlots.begin(), m_groupPendingDeltaSlots.end(), 0u);
+    }
+
+    uint32_t frameSlotOf(const FrameBuffers& frameBuffers) const {
+        return static_cast<uint32_t>(&frameBuffers - m_frameBuffers.data());
+    }
+
+    void discardPendingStateDeltas(FrameBuffers& frameBuffers) {
+        const uint8_t slotBit = uint8_t(1u << frameSlotOf(frameBuffers));
+        for (uint32_t groupIndex : frameBuffers.pendingStateDeltas) {
+            if (groupIndex < m_groupPendingDeltaSlots.size()) {
+                m_groupPendingDeltaSlots[groupIndex] &= uint8_t(~slotBit);
+            }
+        }
+        frameBuffers.pendingStateDeltas.clear();
+    }
 
-        std::memcpy(m_groupResidencyState.data(),
-                    residencyWords,
-                    size_t(m_residencyGroupCapacity) * sizeof(uint32_t));
-        std::memcpy(m_groupAgeState.data(),
-                    ageWords,
-                    size_t(m_residencyGroupCapacity) * sizeof(uint32_t));
+    void applyPendingStateDeltas(FrameBuffers& frameBuffers) {
+        uint32_t* words = mappedUint32(frameBuffers.groupResidencyBuffer.get());
+        uint32_t* ages = mappedUint32(frameBuffers.groupAgeBuffer.get());
+        if (words && ages) {
+            for (uint32_t groupIndex : frameBuffers.pendingStateDeltas) {
+                if (groupIndex < m_residencyGroupCapacity) {
+                    words[groupIndex] = m_groupResidencyState[groupIndex];
+                    ages[groupIndex] = m_groupAgeState[groupIndex];
+                }
+            }
+        }
+        discardPendingStateDeltas(frameBuffers);
     }
 
     void uploadCanonicalStateToFrame(FrameBuffers& frameBuffers,
@@ -1113,6 +1485,13 @@ private:
                                      bool uploadActiveResidentGroups,
                                      bool markSubmittedFrame,
                                      const std::vector<uint32_t>* activeResidentGroupsOverride = nullptr) {
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::UploadCanonicalState", METALLIC_CPU_ZONE_STREAMING);
+        if (uploadResidencyState && uploadAgeState) {
+            frameBuffers.fullStateUploadRequired = false;
+            discardPendingStateDeltas(frameBuffers);
+        } else if (!uploadResidencyState && !uploadAgeState) {
+            applyPendingStateDeltas(frameBuffers);
+        }
         if (uploadResidencyState) {
             if (uint32_t* words = mappedUint32(frameBuffers.groupResidencyBuffer.get())) {
                 std::memcpy(words,
@@ -1144,6 +1523,7 @@ private:
 
     void uploadSelectedUpdateTaskToActiveFrame() {
         m_activeUpdatePatchCount = 0u;
+        m_activeUpdatePatchClusterCount = 0u;
         m_activeActiveResidentPatchCount = 0u;
         m_activeUpdateTransferWaitValue = 0u;
 
@@ -1157,6 +1537,12 @@ private:
         const uint32_t activeResidentPatchCount = std::min<uint32_t>(
             static_cast<uint32_t>(task.activeResidentPatches.size()), m_residencyGroupCapacity);
         m_activeUpdatePatchCount = patchCount;
+        if (patchCount != 0u) {
+            const StreamingPatch& lastPatch = task.patches[patchCount - 1u];
+            m_activeUpdatePatchClusterCount =
+                lastPatch.clusterPrefix +
+                (isClusterLodGroupPageAddressValid(lastPatch.residentHeapOffset) ? lastPatch.clusterCount : 0u);
+        }
         m_activeActiveResidentPatchCount = activeResidentPatchCount;
         m_activeUpdateTransferWaitValue = task.transferWaitValue;
         if (patchCount == 0u && activeResidentPatchCount == 0u) {
@@ -1198,6 +1584,7 @@ private:
         FrameBuffers& frameBuffers = activeFrameBuffers();
         const bool reuseGpuSteadyState =
             !forceCanonicalUpload &&
+            !frameBuffers.fullStateUploadRequired &&
             canReuseGpuSteadyState(frameBuffers, frameBuffers.submittedFrameIndex);
         const std::vector<uint32_t>* activeResidentGroupsOverride = nullptr;
         bool uploadActiveResidentGroups = !reuseGpuSteadyState;
@@ -1231,6 +1618,9 @@ private:
                                     true,
                                     activeResidentGroupsOverride);
         frameBuffers.submittedActiveResidentGroupCount = m_activeFrameResidentGroupCount;
+        // Active-resident patches may append past the uploaded list on the GPU.
+        frameBuffers.writtenActiveResidentGroupCount =
+            std::max(frameBuffers.writtenActiveResidentGroupCount, m_activeFrameResidentGroupCount);
         uploadSelectedUpdateTaskToActiveFrame();
     }
 
@@ -1333,6 +1723,13 @@ private:
             [](const StreamingPatch& patch) {
                 return !isClusterLodGroupPageAddressValid(patch.residentHeapOffset);
             });
+        uint32_t clusterPrefix = 0u;
+        for (StreamingPatch& patch : task.patches) {
+            patch.clusterPrefix = clusterPrefix;
+            if (isClusterLodGroupPageAddressValid(patch.residentHeapOffset)) {
+                clusterPrefix += patch.clusterCount;
+            }
+        }
         task.activeResidentPatches.clear();
         task.activeResidentGroupCountAfter = static_cast<uint32_t>(std::min<size_t>(
             m_prepareTaskActiveResidentGroupsScratch.size(), size_t(m_residencyGroupCapacity)));
@@ -1380,6 +1777,7 @@ private:
             task.state = StreamingTaskState::TransferSubmitted;
             task.transferWaitValue = 0u;
             task.transferSubmitFrame = m_frameIndex;
+            task.transferSubmitTime = std::chrono::steady_clock::now();
         }
 
         m_prepareTaskIndex = kInvalidTaskIndex;
@@ -1394,7 +1792,7 @@ private:
     uint32_t findOldestTask(StreamingTaskState state, bool requirePriorFrame = false) const {
         uint32_t bestTaskIndex = kInvalidTaskIndex;
         uint64_t bestSerial = UINT64_MAX;
-        for (uint32_t taskIndex = 0u; taskIndex < kStreamingTaskCount; ++taskIndex) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
             const StreamingTask& task = m_streamingTasks[taskIndex];
             if (task.state != state) {
                 continue;
@@ -1413,6 +1811,12 @@ private:
 
     void selectTransferTask() {
         m_transferTaskIndex = findOldestTask(StreamingTaskState::Prepared);
+        // Tasks are submitted in prepare order, so an unfinished page read holds back
+        // every newer task until the next frame.
+        if (validTaskIndex(m_transferTaskIndex) &&
+            !m_groupPageReader.isComplete(m_streamingTasks[m_transferTaskIndex].pageReadTicket)) {
+            m_transferTaskIndex = kInvalidTaskIndex;
+        }
     }
 
     bool taskReadyForUpdate(const StreamingTask& task) const {
@@ -1431,7 +1835,7 @@ private:
     void selectUpdateTask() {
         m_updateTaskIndex = kInvalidTaskIndex;
         uint64_t bestSerial = UINT64_MAX;
-        for (uint32_t taskIndex = 0u; taskIndex < kStreamingTaskCount; ++taskIndex) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
             const StreamingTask& task = m_streamingTasks[taskIndex];
             if (!taskReadyForUpdate(task) || task.serial >= bestSerial) {
                 continue;
@@ -1503,12 +1907,12 @@ private:
         }
 
         const GPUClusterGroup& group = clusterLodData.groups[groupIndex];
-        if (size_t(group.clusterStart) + group.clusterCount > clusterLodData.groupMeshletIndices.size()) {
+        if (size_t(group.clusterStart) + group.clusterCount > clusterLodData.groupMeshletIndexCount) {
             return false;
         }
 
         uint32_t heapOffset = 0u;
-        if (!m_streamingStorage.allocate(group.clusterCount, heapOffset)) {
+        if (!m_streamingStorage.allocate(group.clusterCount, heapOffset, groupIndex)) {
             ++m_failedAllocationsThisFrame;
             return false;
         }
@@ -1536,7 +1940,7 @@ private:
         }
 
         const GPUClusterGroup& group = clusterLodData.groups[groupIndex];
-        if (size_t(group.clusterStart) + group.clusterCount > clusterLodData.groupMeshletIndices.size()) {
+        if (size_t(group.clusterStart) + group.clusterCount > clusterLodData.groupMeshletIndexCount) {
             if (!hadAllocation) {
                 invalidateResidentGroup(groupIndex);
             }
@@ -1546,12 +1950,8 @@ private:
         const uint64_t dstOffsetBytes =
             uint64_t(m_groupResidentAllocations[groupIndex].heapOffset) * sizeof(uint32_t);
         const uint64_t uploadSizeBytes = uint64_t(group.clusterCount) * sizeof(uint32_t);
-        const uint32_t* srcData = clusterLodData.groupMeshletIndices.data() + group.clusterStart;
         if (!validTaskIndex(m_prepareTaskIndex) ||
-            !m_streamingStorage.stageUpload(m_prepareTaskIndex,
-                                            srcData,
-                                            uploadSizeBytes,
-                                            dstOffsetBytes)) {
+            !stageGroupPayload(group, clusterLodData, uploadSizeBytes, dstOffsetBytes)) {
             if (!hadAllocation) {
                 invalidateResidentGroup(groupIndex);
             }
@@ -1565,6 +1965,155 @@ private:
         return true;
     }
 
+    bool stageGroupPayload(const GPUClusterGroup& group,
+                           const ClusterLODData& clusterLodData,
+                           uint64_t uploadSizeBytes,
+                           uint64_t dstOffsetBytes) {
+        // Payloads are staged back to back (uint32 alignment) so groups laid out
+        // next to each other by the LOD builder's pages merge into one copy region
+        // and one file read when their heap slices are adjacent too.
+        if (!clusterLodData.groupMeshletIndices.empty()) {
+            return m_streamingStorage.stageUpload(m_prepareTaskIndex,
+                                                  clusterLodData.groupMeshletIndices.data() +
+                                                      group.clusterStart,
+                                                  uploadSizeBytes,
+                                                  dstOffsetBytes,
+                                                  sizeof(uint32_t));
+        }
+        if (uploadSizeBytes == 0u) {
+            return true;
+        }
+        if (!m_groupPageReader.isOpen()) {
+            return false;
+        }
+
+        // The group page is read from the cache file straight into staging memory;
+        // the task is held back from transfer until the read lands.
+        uint8_t* staging = m_streamingStorage.reserveUpload(m_prepareTaskIndex,
+                                                            uploadSizeBytes,
+                                                            dstOffsetBytes,
+                                                            sizeof(uint32_t));
+        if (!staging) {
+            return false;
+        }
+
+        const uint64_t fileOffset =
+            clusterLodData.groupPageFileOffset + uint64_t(group.clusterStart) * sizeof(uint32_t);
+        const uint64_t ticket = m_groupPageReader.read(staging, fileOffset, uploadSizeBytes);
+        uint64_t& taskTicket = m_streamingTasks[m_prepareTaskIndex].pageReadTicket;
+        if (ticket != taskTicket) {
+            ++m_groupPageReadsThisFrame;
+        }
+        taskTicket = ticket;
+        return ticket != 0u;
+    }
+
+    void ensureGroupPageReader(const ClusterLODData& clusterLodData) {
+        if (clusterLodData.groupPageFilePath.empty()) {
+            if (m_groupPageReader.isOpen()) {
+                resetStreamingTasks();
+                m_groupPageReader.close();
+            }
+            return;
+        }
+        if (m_groupPageReader.isOpen() &&
+            m_groupPageReader.path() == std::filesystem::path(clusterLodData.groupPageFilePath)) {
+            return;
+        }
+
+        resetStreamingTasks();
+        if (!m_groupPageReader.open(clusterLodData.groupPageFilePath)) {
+            spdlog::error("Failed to open ClusterLOD group page file {}", clusterLodData.groupPageFilePath);
+        }
+        m_reportedGroupPageReadFailures = 0u;
+    }
+
+    void reportGroupPageReadFailures() {
+        const uint64_t failedReads = m_groupPageReader.failedReadCount();
+        if (failedReads == m_reportedGroupPageReadFailures) {
+            return;
+        }
+
+        spdlog::error("ClusterLOD streaming failed {} group page read(s) from {}",
+                      failedReads - m_reportedGroupPageReadFailures,
+                      m_groupPageReader.path().string());
+        m_reportedGroupPageReadFailures = failedReads;
+    }
+
+    // Relocates the highest resident slices into lower free ranges while the free
+    // space is splintered.
+    void runDefragmentationStage(const ClusterLODData& clusterLodData) {
+        if (!m_enableDefragmentation ||
+            m_streamingStorage.fragmentation() < kDefragFragmentationThreshold) {
+            return;
+        }
+
+        for (uint32_t moveIndex = 0u; moveIndex < kMaxDefragMovesPerFrame; ++moveIndex) {
+            StreamingStorage::Allocation highest{};
+            if (!m_streamingStorage.highestAllocation(highest) ||
+                !relocateResidentSlice(highest, clusterLodData)) {
+                return;
+            }
+        }
+    }
+
+    // After the storage budget drops, the slices above the new capacity move into
+    // free ranges below it, or are evicted when none is large enough. Either way the
+    // rest of the residency set is untouched, where recreating the pool reloaded it all.
+    void runCapacityDrainStage(const ClusterLODData& clusterLodData) {
+        for (uint32_t moveIndex = 0u; moveIndex < kMaxDefragMovesPerFrame; ++moveIndex) {
+            StreamingStorage::Allocation highest{};
+            if (!m_streamingStorage.overCommitted() || !m_streamingStorage.highestAllocation(highest)) {
+                return;
+            }
+            if (m_streamingStorage.largestFreeRange() >= highest.count) {
+                // A failed move is out of staging space; retry next frame.
+                if (!relocateResidentSlice(highest, clusterLodData)) {
+                    return;
+                }
+            } else if (!evictResidentGroup(highest.tag)) {
+                return;
+            }
+        }
+    }
+
+    // Moves a resident slice to a lower free range. The move is a regular load patch
+    // at the new offset, so the update shader rewrites the page table in the same
+    // pass that publishes the moved data.
+    bool relocateResidentSlice(const StreamingStorage::Allocation& slice,
+                               const ClusterLODData& clusterLodData) {
+        if (slice.tag >= m_groupResidentAllocations.size() ||
+            slice.tag >= clusterLodData.groups.size() ||
+            m_groupResidentAllocations[slice.tag].heapOffset != slice.offset) {
+            return false;
+        }
+
+        const uint32_t groupIndex = slice.tag;
+        uint32_t newOffset = 0u;
+        if (!m_streamingStorage.allocate(slice.count, newOffset, groupIndex)) {
+            return false;
+        }
+        if (newOffset >= slice.offset) {
+            m_streamingStorage.release(newOffset, slice.count);
+            return false;
+        }
+
+        const GPUClusterGroup& group = clusterLodData.groups[groupIndex];
+        if (!stageGroupPayload(group,
+                               clusterLodData,
+                               uint64_t(group.clusterCount) * sizeof(uint32_t),
+                               uint64_t(newOffset) * sizeof(uint32_t))) {
+            m_streamingStorage.release(newOffset, slice.count);
+            return false;
+        }
+
+        m_streamingStorage.release(slice.offset, slice.count);
+        m_groupResidentAllocations[groupIndex].heapOffset = newOffset;
+        queueLoadPatch(groupIndex, newOffset, group.clusterStart, group.clusterCount);
+        ++m_defragMovesThisFrame;
+        return true;
+    }
+
     void invalidateResidentGroup(uint32_t groupIndex) {
         if (groupIndex >= m_groupResidentAllocations.size()) {
             return;
@@ -1589,13 +2138,16 @@ private:
     void clearPendingResidencyRequestFrame(uint32_t groupIndex) {
         if (groupIndex < m_pendingResidencyRequestFrames.size()) {
             m_pendingResidencyRequestFrames[groupIndex] = kInvalidFrameIndex;
+            m_pendingResidencyFirstRequestFrames[groupIndex] = kInvalidFrameIndex;
         }
     }
 
+    // Only dynamic resident groups can age; every other group is reset to zero where
+    // its residency changes.
     void advanceResidentGroupAges(uint32_t sourceFrameIndex) {
-        for (uint32_t groupIndex = 0u; groupIndex < m_residencyGroupCapacity; ++groupIndex) {
-            if (!isGroupResident(groupIndex) || isGroupAlwaysResident(groupIndex)) {
-                m_groupAgeState[groupIndex] = 0u;
+        for (uint32_t groupIndex : m_dynamicResidentGroups) {
+            if (groupIndex >= m_residencyGroupCapacity ||
+                !isGroupResident(groupIndex) || isGroupAlwaysResident(groupIndex)) {
                 continue;
             }
             if (m_groupResidentSinceFrame[groupIndex] == kInvalidFrameIndex ||
@@ -1620,13 +2172,40 @@ private:
         m_dynamicResidentGroups.push_back(groupIndex);
     }
 
-    void enqueuePendingResidencyGroup(uint32_t groupIndex, uint32_t requestFrameIndex) {
+    float groupImportance(uint32_t groupIndex) const {
+        return groupIndex < m_groupPrimitiveGroup.size()
+                   ? primitiveGroupImportance(m_groupPrimitiveGroup[groupIndex])
+                   : 1.0f;
+    }
+
+    void enqueuePendingResidencyGroup(const ClusterResidencyRequest& request) {
+        const uint32_t groupIndex = request.targetGroupIndex;
+        const float importance = groupImportance(groupIndex);
+        if (importance <= 0.0f) {
+            return;
+        }
+        const float priority = request.priority * importance;
+        const bool prefetch = (request.lodLevel & kClusterResidencyRequestPrefetchBit) != 0u;
+        if (prefetch) {
+            ++m_debugStats.lastPrefetchRequestCount;
+        }
         clearPendingUnloadCandidate(groupIndex);
         if (groupIndex < m_groupResidencyState.size()) {
             m_groupResidencyState[groupIndex] |= kClusterLodGroupResidencyRequested;
         }
         if (groupIndex < m_pendingResidencyRequestFrames.size()) {
-            m_pendingResidencyRequestFrames[groupIndex] = requestFrameIndex;
+            // Several instances may request the same group in one frame; keep the most
+            // urgent priority, and let any demand request override a prefetch.
+            const bool sameFrame =
+                m_pendingResidencyRequestFrames[groupIndex] == request.requestFrameIndex;
+            if (m_pendingResidencyFirstRequestFrames[groupIndex] == kInvalidFrameIndex) {
+                m_pendingResidencyFirstRequestFrames[groupIndex] = request.requestFrameIndex;
+            }
+            m_pendingResidencyRequestFrames[groupIndex] = request.requestFrameIndex;
+            m_pendingResidencyPriority[groupIndex] =
+                sameFrame ? std::max(m_pendingResidencyPriority[groupIndex], priority) : priority;
+            m_pendingResidencyPrefetch[groupIndex] =
+                (sameFrame && m_pendingResidencyPrefetch[groupIndex] == 0u) ? 0u : uint8_t(prefetch);
         }
         if (std::find(m_pendingResidencyGroups.begin(), m_pendingResidencyGroups.end(), groupIndex) ==
             m_pendingResidencyGroups.end()) {
@@ -1648,6 +2227,7 @@ private:
                                                    kClusterLodGroupResidencyRequested);
             m_groupAgeState[groupIndex] = 0u;
             m_groupResidentSinceFrame[groupIndex] = kInvalidFrameIndex;
+            markGroupResidencyChanged(groupIndex);
         }
         if (groupIndex < m_groupPendingUnloadState.size()) {
             m_groupPendingUnloadState[groupIndex] = 0u;
@@ -1658,12 +2238,60 @@ private:
         return true;
     }
 
+    // Drops requests the GPU stopped repeating, then orders the queue so demand loads
+    // come before prefetches and larger projected error before smaller.
+    void schedulePendingResidencyGroups() {
+        size_t writeIndex = 0;
+        for (uint32_t groupIndex : m_pendingResidencyGroups) {
+            const uint32_t requestFrameIndex =
+                groupIndex < m_pendingResidencyRequestFrames.size()
+                    ? m_pendingResidencyRequestFrames[groupIndex]
+                    : kInvalidFrameIndex;
+            if (requestFrameIndex == kInvalidFrameIndex ||
+                m_frameIndex - requestFrameIndex > kPendingRequestExpiryFrames) {
+                if (groupIndex < m_residencyGroupCapacity) {
+                    m_groupResidencyState[groupIndex] &= ~kClusterLodGroupResidencyRequested;
+                }
+                clearPendingResidencyRequestFrame(groupIndex);
+                ++m_debugStats.lastExpiredPendingCount;
+                continue;
+            }
+            m_pendingResidencyGroups[writeIndex++] = groupIndex;
+        }
+        m_pendingResidencyGroups.resize(writeIndex);
+
+        std::stable_sort(m_pendingResidencyGroups.begin(),
+                         m_pendingResidencyGroups.end(),
+                         [&](uint32_t lhs, uint32_t rhs) {
+                             if (m_pendingResidencyPrefetch[lhs] != m_pendingResidencyPrefetch[rhs]) {
+                                 return m_pendingResidencyPrefetch[lhs] < m_pendingResidencyPrefetch[rhs];
+                             }
+                             return m_pendingResidencyPriority[lhs] > m_pendingResidencyPriority[rhs];
+                         });
+    }
+
+    void recordPopLatency(uint32_t groupIndex) {
+        const uint32_t firstRequestFrame = m_pendingResidencyFirstRequestFrames[groupIndex];
+        if (firstRequestFrame == kInvalidFrameIndex || firstRequestFrame > m_frameIndex) {
+            return;
+        }
+
+        const uint32_t latencyFrames = m_frameIndex - firstRequestFrame;
+        ++m_popLatencySampleCount;
+        m_popLatencyFrameSum += latencyFrames;
+        m_popLatencyMaxFrames = std::max(m_popLatencyMaxFrames, latencyFrames);
+    }
+
     void promotePendingResidencyGroups(const ClusterLODData& clusterLodData,
                                        uint32_t& remainingLoads) {
         if (remainingLoads == 0u) {
             return;
         }
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::PromotePending", METALLIC_CPU_ZONE_STREAMING);
 
+        schedulePendingResidencyGroups();
+        uint32_t remainingPrefetchLoads =
+            std::max(1u, remainingLoads / kPrefetchLoadShareDivisor);
         size_t pendingIndex = 0;
         while (pendingIndex < m_pendingResidencyGroups.size() && remainingLoads > 0u) {
             const uint32_t groupIndex = m_pendingResidencyGroups[pendingIndex];
@@ -1697,6 +2325,12 @@ private:
                 break;
             }
 
+            // Prefetches sort last, so once their share is spent nothing else can load.
+            const bool prefetch = m_pendingResidencyPrefetch[groupIndex] != 0u;
+            if (prefetch && remainingPrefetchLoads == 0u) {
+                break;
+            }
+
             m_groupResidencyState[groupIndex] |= kClusterLodGroupResidencyResident;
             m_groupResidencyState[groupIndex] &= ~kClusterLodGroupResidencyRequested;
             m_groupAgeState[groupIndex] = 0u;
@@ -1706,9 +2340,15 @@ private:
                 m_groupResidentSinceFrame[groupIndex] = kInvalidFrameIndex;
                 break;
             }
+            markGroupResidencyChanged(groupIndex);
             touchDynamicResidentGroup(groupIndex);
             ++m_debugStats.lastResidencyPromotedCount;
             --remainingLoads;
+            recordPopLatency(groupIndex);
+            if (prefetch) {
+                ++m_debugStats.lastPrefetchPromotedCount;
+                --remainingPrefetchLoads;
+            }
             clearPendingResidencyRequestFrame(groupIndex);
             m_pendingResidencyGroups.erase(
                 m_pendingResidencyGroups.begin() +
@@ -1716,7 +2356,46 @@ private:
         }
     }
 
+    // Per-group LOD depth, owning primitive group and per-LOD group totals only change
+    // with the scene, so telemetry and scheduling never walk every group each frame.
+    void rebuildGroupSceneTables(const ClusterLODData& clusterLodData) {
+        m_groupLodDepth.assign(m_residencyGroupCapacity, kInvalidLodDepth);
+        m_groupPrimitiveGroup.assign(m_residencyGroupCapacity, UINT32_MAX);
+        m_primitiveGroupCount = static_cast<uint32_t>(clusterLodData.primitiveGroupLodRoots.size());
+        m_totalGroupsPerLod.clear();
+        for (const ClusterLODLevel& level : clusterLodData.levels) {
+            const uint32_t levelGroupBegin = std::min(level.groupStart, m_residencyGroupCapacity);
+            const uint32_t levelGroupEnd = static_cast<uint32_t>(
+                std::min<uint64_t>(uint64_t(level.groupStart) + uint64_t(level.groupCount),
+                                   uint64_t(m_residencyGroupCapacity)));
+            std::fill(m_groupPrimitiveGroup.begin() + levelGroupBegin,
+                      m_groupPrimitiveGroup.begin() + levelGroupEnd,
+                      level.primitiveGroupIndex);
+            if (level.depth >= kInvalidLodDepth) {
+                continue;
+            }
+            if (level.depth >= m_totalGroupsPerLod.size()) {
+                m_totalGroupsPerLod.resize(size_t(level.depth) + 1u, 0u);
+            }
+            for (uint32_t groupIndex = levelGroupBegin; groupIndex < levelGroupEnd; ++groupIndex) {
+                m_groupLodDepth[groupIndex] = static_cast<uint8_t>(level.depth);
+            }
+            m_totalGroupsPerLod[level.depth] += levelGroupEnd - levelGroupBegin;
+        }
+    }
+
+    template <typename Fn>
+    void forEachResidentGroup(Fn&& fn) const {
+        for (uint32_t groupIndex : m_alwaysResidentGroups) {
+            fn(groupIndex);
+        }
+        for (uint32_t groupIndex : m_dynamicResidentGroups) {
+            fn(groupIndex);
+        }
+    }
+
     void rebuildStreamingState(const ClusterLODData& clusterLodData) {
+        requireFullStateUploadForAllFrames();
         std::fill(m_groupResidencyState.begin(), m_groupResidencyState.end(), 0u);
         std::fill(m_groupAgeState.begin(), m_groupAgeState.end(), 0u);
         std::fill(m_groupResidentSinceFrame.begin(), m_groupResidentSinceFrame.end(), kInvalidFrameIndex);
@@ -1724,6 +2403,9 @@ private:
         std::fill(m_pendingResidencyRequestFrames.begin(),
                   m_pendingResidencyRequestFrames.end(),
                   kInvalidFrameIndex);
+        std::fill(m_pendingResidencyFirstRequestFrames.begin(),
+                  m_pendingResidencyFirstRequestFrames.end(),
+                  kInvalidFrameIndex);
         std::fill(m_residentTouchSeenScratch.begin(), m_residentTouchSeenScratch.end(), 0u);
         std::fill(m_unloadRequestSeenScratch.begin(), m_unloadRequestSeenScratch.end(), 0u);
         std::fill(m_patchLastWriteIndexScratch.begin(), m_patchLastWriteIndexScratch.end(), UINT32_MAX);
@@ -1736,6 +2418,7 @@ private:
         m_unloadRequestReadbackScratch.clear();
         m_confirmedUnloadGroups.clear();
         resetDebugStats();
+        rebuildGroupSceneTables(clusterLodData);
 
         std::vector<uint32_t> alwaysResidentGroups;
         for (uint32_t lodRootNode : clusterLodData.primitiveGroupLodRoots) {
@@ -1819,11 +2502,11 @@ private:
         }
     }
 
-    bool shouldUseCpuFifoUnloadFallback(const FrameBuffers& frameBuffers,
+    bool shouldUseCpuFifoUnloadFallback(uint32_t gpuAgeFilterDispatchFrameIndex,
                                         uint32_t expectedFrameIndex) const {
         if (!m_enableStreaming ||
             expectedFrameIndex == kInvalidFrameIndex ||
-            frameBuffers.gpuAgeFilterDispatchFrameIndex == expectedFrameIndex ||
+            gpuAgeFilterDispatchFrameIndex == expectedFrameIndex ||
             m_dynamicResidentGroups.empty()) {
             return false;
         }
@@ -1846,10 +2529,9 @@ private:
         return overBudget || pendingLoadPressure || storagePressure || recentAllocationPressure;
     }
 
-    uint32_t collectCpuFifoUnloadFallbackCandidates(const FrameBuffers& frameBuffers,
+    uint32_t collectCpuFifoUnloadFallbackCandidates(uint32_t gpuAgeFilterDispatchFrameIndex,
                                                    uint32_t expectedFrameIndex) {
-        m_gpuAgeFilterDispatchMissing =
-            frameBuffers.gpuAgeFilterDispatchFrameIndex != expectedFrameIndex;
+        m_gpuAgeFilterDispatchMissing = gpuAgeFilterDispatchFrameIndex != expectedFrameIndex;
         m_gpuAgeFilterDispatchMissingFrameIndex =
             m_gpuAgeFilterDispatchMissing ? expectedFrameIndex : kInvalidFrameIndex;
         if (!m_gpuAgeFilterDispatchMissing) {
@@ -1857,7 +2539,7 @@ private:
             return 0u;
         }
 
-        if (!shouldUseCpuFifoUnloadFallback(frameBuffers, expectedFrameIndex)) {
+        if (!shouldUseCpuFifoUnloadFallback(gpuAgeFilterDispatchFrameIndex, expectedFrameIndex)) {
             return 0u;
         }
 
@@ -1918,31 +2600,41 @@ private:
         return queuedUnloadCount;
     }
 
-    void runRequestReadbackStage(const ClusterLODData& clusterLodData) {
-        m_debugStats.lastResidencyRequestCount = 0;
-        m_debugStats.lastUnloadRequestCount = 0;
-        m_debugStats.lastResidencyPromotedCount = 0;
-        m_debugStats.lastResidencyEvictedCount = 0;
+    // Copies the readback of the active frame slot into m_requestReadback and the
+    // readback scratch lists for the prepare job. From ClusterStreamingRequestCompactPass
+    // only the top entries that fit this frame's load budget are taken; resident touches
+    // never leave the GPU, whose age filter already consumed them. When the compact list
+    // was not written for the submitted frame, the full request list is copied instead.
+    void captureRequestReadback() {
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::CaptureReadback", METALLIC_CPU_ZONE_STREAMING);
+        m_requestReadback = {};
         m_requestReadbackScratch.clear();
         m_unloadRequestReadbackScratch.clear();
-        std::fill(m_residentTouchSeenScratch.begin(), m_residentTouchSeenScratch.end(), 0u);
-        std::fill(m_unloadRequestSeenScratch.begin(), m_unloadRequestSeenScratch.end(), 0u);
 
         FrameBuffers& frameBuffers = activeFrameBuffers();
         const uint32_t expectedFrameIndex = frameBuffers.submittedFrameIndex;
         if (expectedFrameIndex == kInvalidFrameIndex) {
             return;
         }
-
-        const bool gpuSteadyStateValid = canReuseGpuSteadyState(frameBuffers, expectedFrameIndex);
-        if (gpuSteadyStateValid) {
-            ingestMappedGpuSteadyState(frameBuffers);
-        }
+        m_requestReadback.frameIndex = expectedFrameIndex;
+        m_requestReadback.gpuAgeFilterDispatchFrameIndex = frameBuffers.gpuAgeFilterDispatchFrameIndex;
 
         ingestMappedGpuStreamingStats(frameBuffers, expectedFrameIndex);
 
-        bool requestReadbackValid = true;
-        if (frameBuffers.residencyRequestBuffer && frameBuffers.residencyRequestStateBuffer) {
+        const ClusterResidencyRequestListHeader* header =
+            m_useCompactRequestReadback
+                ? mappedCompactRequestHeader(frameBuffers.compactResidencyRequestBuffer.get())
+                : nullptr;
+        if (header && header->requestFrameIndex == expectedFrameIndex) {
+            const uint32_t readCount = std::min({header->writtenRequestCount,
+                                                 m_maxLoadsPerFrame,
+                                                 kCompactResidencyRequestCapacity});
+            const ClusterResidencyRequest* requests =
+                reinterpret_cast<const ClusterResidencyRequest*>(header + 1);
+            m_requestReadbackScratch.assign(requests, requests + readCount);
+            m_requestReadback.compact = true;
+            m_requestReadback.compactLoadRequestCount = header->loadRequestCount;
+        } else if (frameBuffers.residencyRequestBuffer && frameBuffers.residencyRequestStateBuffer) {
             const uint32_t requestCapacity = static_cast<uint32_t>(
                 frameBuffers.residencyRequestBuffer->size() / sizeof(ClusterResidencyRequest));
             const uint32_t requestCount = std::min<uint32_t>(
@@ -1951,20 +2643,86 @@ private:
                 requestCapacity);
 
             ClusterResidencyRequest* requests = mappedRequests(frameBuffers.residencyRequestBuffer.get());
+            m_requestReadback.requestListRead = true;
             if (requestCount > 0u && !requests) {
-                requestReadbackValid = false;
+                m_requestReadback.requestsValid = false;
             } else if (requests && requestCount > 0u) {
                 m_requestReadbackScratch.assign(requests, requests + requestCount);
-                for (const ClusterResidencyRequest& request : m_requestReadbackScratch) {
-                    if (request.requestFrameIndex != expectedFrameIndex) {
-                        requestReadbackValid = false;
-                        break;
-                    }
-                }
-                if (!requestReadbackValid) {
-                    m_requestReadbackScratch.clear();
+            }
+        }
+
+        if (m_requestReadback.gpuAgeFilterDispatchFrameIndex != expectedFrameIndex ||
+            !frameBuffers.unloadRequestBuffer || !frameBuffers.unloadRequestStateBuffer) {
+            return;
+        }
+        const uint32_t unloadCapacity = static_cast<uint32_t>(
+            frameBuffers.unloadRequestBuffer->size() / sizeof(ClusterUnloadRequest));
+        const uint32_t unloadCount = std::min<uint32_t>(
+            GpuDriven::readWorklistWriteCursor<GpuDriven::ComputeDispatchCommandLayout>(
+                frameBuffers.unloadRequestStateBuffer.get()),
+            unloadCapacity);
+
+        ClusterUnloadRequest* unloadRequests = mappedUnloadRequests(frameBuffers.unloadRequestBuffer.get());
+        m_requestReadback.unloadListRead = true;
+        if (unloadCount > 0u && !unloadRequests) {
+            m_requestReadback.unloadsValid = false;
+        } else if (unloadRequests && unloadCount > 0u) {
+            m_unloadRequestReadbackScratch.assign(unloadRequests, unloadRequests + unloadCount);
+        }
+    }
+
+    // Queues the compact list captured from ClusterStreamingRequestCompactPass, already
+    // priority-sorted and cut to this frame's load budget.
+    void consumeCompactResidencyRequests(uint32_t expectedFrameIndex, const ClusterLODData& clusterLodData) {
+        m_debugStats.lastResidencyRequestCount = m_requestReadback.compactLoadRequestCount;
+        m_debugStats.lastCompactRequestReadCount = static_cast<uint32_t>(m_requestReadbackScratch.size());
+        m_lastProcessedRequestFrameIndex = expectedFrameIndex;
+        for (const ClusterResidencyRequest& request : m_requestReadbackScratch) {
+            if (request.targetGroupIndex >= clusterLodData.totalGroupCount ||
+                isGroupAlwaysResident(request.targetGroupIndex) ||
+                isGroupResident(request.targetGroupIndex)) {
+                continue;
+            }
+            ++m_loadRequestsThisFrame;
+            enqueuePendingResidencyGroup(request);
+        }
+    }
+
+    // Parses what captureRequestReadback copied out; runs on the prepare job.
+    void runRequestReadbackStage(const ClusterLODData& clusterLodData) {
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::RequestReadback", METALLIC_CPU_ZONE_STREAMING);
+        m_debugStats.lastResidencyRequestCount = 0;
+        m_debugStats.lastCompactRequestReadCount = 0;
+        m_debugStats.lastPrefetchRequestCount = 0;
+        m_debugStats.lastPrefetchPromotedCount = 0;
+        m_debugStats.lastExpiredPendingCount = 0;
+        m_debugStats.compactRequestReadbackActive = false;
+        m_debugStats.lastUnloadRequestCount = 0;
+        m_debugStats.lastResidencyPromotedCount = 0;
+        m_debugStats.lastResidencyEvictedCount = 0;
+        std::fill(m_residentTouchSeenScratch.begin(), m_residentTouchSeenScratch.end(), 0u);
+        std::fill(m_unloadRequestSeenScratch.begin(), m_unloadRequestSeenScratch.end(), 0u);
+
+        const RequestReadback& readback = m_requestReadback;
+        const uint32_t expectedFrameIndex = readback.frameIndex;
+        if (expectedFrameIndex == kInvalidFrameIndex) {
+            return;
+        }
+
+        bool requestReadbackValid = readback.requestsValid;
+        m_debugStats.compactRequestReadbackActive = readback.compact;
+        if (readback.compact) {
+            consumeCompactResidencyRequests(expectedFrameIndex, clusterLodData);
+        } else if (readback.requestListRead) {
+            for (const ClusterResidencyRequest& request : m_requestReadbackScratch) {
+                if (request.requestFrameIndex != expectedFrameIndex) {
+                    requestReadbackValid = false;
+                    break;
                 }
             }
+            if (!requestReadbackValid) {
+                m_requestReadbackScratch.clear();
+            }
 
             m_debugStats.lastResidencyRequestCount =
                 static_cast<uint32_t>(m_requestReadbackScratch.size());
@@ -1981,7 +2739,7 @@ private:
                     continue;
                 }
                 ++m_loadRequestsThisFrame;
-                enqueuePendingResidencyGroup(request.targetGroupIndex, request.requestFrameIndex);
+                enqueuePendingResidencyGroup(request);
             }
         }
 
@@ -1991,7 +2749,11 @@ private:
             return;
         }
 
-        if (!gpuSteadyStateValid) {
+        // The GPU age filter owns the authoritative ages; this keeps the CPU estimate
+        // used for telemetry and the FIFO fallback without reading the GPU copy back.
+        // The compact list carries no touches, so the estimate holds until the next
+        // full readback rather than aging groups that are still in view.
+        if (!readback.compact) {
             advanceResidentGroupAges(expectedFrameIndex);
         }
         for (uint32_t groupIndex = 0u; groupIndex < m_residencyGroupCapacity; ++groupIndex) {
@@ -2004,38 +2766,25 @@ private:
             touchDynamicResidentGroup(groupIndex);
         }
 
-        if (collectCpuFifoUnloadFallbackCandidates(frameBuffers, expectedFrameIndex) != 0u) {
+        if (collectCpuFifoUnloadFallbackCandidates(readback.gpuAgeFilterDispatchFrameIndex,
+                                                   expectedFrameIndex) != 0u) {
             return;
         }
-        if (frameBuffers.gpuAgeFilterDispatchFrameIndex != expectedFrameIndex) {
+        if (readback.gpuAgeFilterDispatchFrameIndex != expectedFrameIndex) {
             return;
         }
 
-        bool unloadReadbackValid = true;
-        if (frameBuffers.unloadRequestBuffer && frameBuffers.unloadRequestStateBuffer) {
-            const uint32_t unloadCapacity = static_cast<uint32_t>(
-                frameBuffers.unloadRequestBuffer->size() / sizeof(ClusterUnloadRequest));
-            const uint32_t unloadCount = std::min<uint32_t>(
-                GpuDriven::readWorklistWriteCursor<GpuDriven::ComputeDispatchCommandLayout>(
-                    frameBuffers.unloadRequestStateBuffer.get()),
-                unloadCapacity);
-
-            ClusterUnloadRequest* unloadRequests =
-                mappedUnloadRequests(frameBuffers.unloadRequestBuffer.get());
-            if (unloadCount > 0u && !unloadRequests) {
-                unloadReadbackValid = false;
-            } else if (unloadRequests && unloadCount > 0u) {
-                m_unloadRequestReadbackScratch.assign(unloadRequests, unloadRequests + unloadCount);
-                for (const ClusterUnloadRequest& request : m_unloadRequestReadbackScratch) {
-                    if (request.requestFrameIndex != expectedFrameIndex) {
-                        unloadReadbackValid = false;
-                        break;
-                    }
-                }
-                if (!unloadReadbackValid) {
-                    m_unloadRequestReadbackScratch.clear();
+        bool unloadReadbackValid = readback.unloadsValid;
+        if (readback.unloadListRead) {
+            for (const ClusterUnloadRequest& request : m_unloadRequestReadbackScratch) {
+                if (request.requestFrameIndex != expectedFrameIndex) {
+                    unloadReadbackValid = false;
+                    break;
                 }
             }
+            if (!unloadReadbackValid) {
+                m_unloadRequestReadbackScratch.clear();
+            }
 
             m_debugStats.lastUnloadRequestCount =
                 static_cast<uint32_t>(m_unloadRequestReadbackScratch.size());
@@ -2058,10 +2807,34 @@ private:
         collectUnloadRequestCandidates();
     }
 
+    // Request parsing, residency promotion and patch building for the next transfer
+    // task, off the render thread. The task it prepares is picked up by
+    // selectTransferTask in the next runUpdateStage, which joins the job first.
+    void launchPrepareJob(const ClusterLODData& clusterLodData) {
+        m_prepareJobLaunched = true;
+        Jobs::JobSystem::instance().run(m_prepareJob, [this, &clusterLodData]() {
+            METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::Prepare", METALLIC_CPU_ZONE_STREAMING);
+            RhiMemoryTagScope streamingTag(RhiMemoryTag::StreamingPool);
+            resetPrepareTelemetry();
+            const auto readbackStart = std::chrono::steady_clock::now();
+            runRequestReadbackStage(clusterLodData);
+            m_requestReadbackCpuMs = std::chrono::duration<float, std::milli>(
+                                         std::chrono::steady_clock::now() - readbackStart)
+                                         .count();
+            if (beginPrepareTask()) {
+                runResidencyUpdateStage(clusterLodData);
+                runCapacityDrainStage(clusterLodData);
+                runDefragmentationStage(clusterLodData);
+                finalizePrepareTask();
+            }
+        });
+    }
+
     void runResidencyUpdateStage(const ClusterLODData& clusterLodData) {
         if (!m_enableStreaming) {
             return;
         }
+        METALLIC_CPU_ZONE("Streaming", "ClusterStreaming::ResidencyUpdate", METALLIC_CPU_ZONE_STREAMING);
 
         uint32_t remainingLoads = m_maxLoadsPerFrame;
         uint32_t remainingUnloads = m_maxUnloadsPerFrame;
@@ -2105,6 +2878,7 @@ private:
         settings.preset = m_budgetPreset;
         settings.streamingBudgetGroups = m_streamingBudgetGroups;
         settings.streamingStorageCapacityBytes = m_streamingStorageCapacityBytes;
+        settings.primitiveGroupImportance = m_primitiveGroupImportance;
         return settings;
     }
 
@@ -2113,6 +2887,7 @@ private:
     }
 
     void applySceneBudgetSettings(const SceneBudgetSettings& settings) {
+        m_primitiveGroupImportance = settings.primitiveGroupImportance;
         if (settings.preset == BudgetPreset::Custom) {
             const bool wasApplyingBudgetPreset = m_applyingBudgetPreset;
             m_applyingBudgetPreset = true;
@@ -2169,12 +2944,13 @@ private:
             return;
         }
 
+        // No state reset: ensureStreamingResources moves the storage capacity inside
+        // its reservation, and only a larger reservation rebuilds residency.
         m_streamingStorageCapacityBytes = capacityBytes;
         if (markCustomPreset && !m_applyingBudgetPreset) {
             m_budgetPreset = BudgetPreset::Custom;
         }
         resetAdaptiveBudgetState(false);
-        m_stateDirty = true;
     }
 
     static uint32_t computeAutoStreamingBudgetGroups(uint64_t targetStorageBytes) {
@@ -2237,7 +3013,7 @@ private:
 
     uint64_t computeStreamingTransferCapacityBytes(const ClusterLODData& clusterLodData) const {
         const uint64_t sceneBytes =
-            uint64_t(std::max<size_t>(1u, clusterLodData.groupMeshletIndices.size())) * sizeof(uint32_t);
+            uint64_t(std::max<uint32_t>(1u, clusterLodData.groupMeshletIndexCount)) * sizeof(uint32_t);
         const uint64_t alwaysResidentBytes =
             uint64_t(computeAlwaysResidentClusterCapacity(clusterLodData)) * sizeof(uint32_t);
         return std::max(alwaysResidentBytes, std::min(sceneBytes, m_maxStreamingTransferBytes));
@@ -2284,12 +3060,24 @@ private:
 
     uint32_t computeStreamingStorageCapacity(const ClusterLODData& clusterLodData) const {
         const uint32_t sceneClusterCapacity =
-            std::max<uint32_t>(1u, static_cast<uint32_t>(clusterLodData.groupMeshletIndices.size()));
+            std::max<uint32_t>(1u, clusterLodData.groupMeshletIndexCount);
         const uint32_t configuredCapacity = configuredStreamingStorageCapacityElements();
         const uint32_t alwaysResidentCapacity = computeAlwaysResidentClusterCapacity(clusterLodData);
         return std::max(alwaysResidentCapacity, std::min(sceneClusterCapacity, configuredCapacity));
     }
 
+    // Storage buffer size: the largest capacity requested for this scene, which the
+    // capacity then moves under. Without sparse binding in the RHI the reserved
+    // memory stays allocated when the budget drops, and growing past it recreates
+    // the pool; shrinking to a smaller scene trims it.
+    uint32_t computeStreamingStorageReservation(const ClusterLODData& clusterLodData,
+                                                uint32_t storageCapacity) const {
+        const uint32_t sceneClusterCapacity =
+            std::max<uint32_t>(1u, clusterLodData.groupMeshletIndexCount);
+        return std::max(storageCapacity,
+                        std::min(m_streamingStorage.reservedElements(), sceneClusterCapacity));
+    }
+
     void applyGpuStreamingStatsToTelemetry() {
         m_streamingStats.gpuStatsValid = m_hasGpuStreamingStats;
         m_streamingStats.gpuStatsFrameIndex =
@@ -2317,13 +3105,28 @@ private:
     }
 
     void resetDegradationTelemetryForFrame() {
+        m_graphicsTransferFallbackActive = false;
+        m_graphicsTransferFallbackFrameIndex = kInvalidFrameIndex;
+    }
+
+    // Counters the prepare job produces. They are cleared when the next job starts, not
+    // when the frame does, so updateDebugStats reports each job's results a frame later.
+    void resetPrepareTelemetry() {
+        m_loadRequestsThisFrame = 0u;
+        m_unloadRequestsThisFrame = 0u;
+        m_failedAllocationsThisFrame = 0u;
+        m_groupPageReadsThisFrame = 0u;
+        m_defragMovesThisFrame = 0u;
+        m_popLatencySampleCount = 0u;
+        m_popLatencyFrameSum = 0u;
+        m_popLatencyMaxFrames = 0u;
+        m_requestReadbackCpuMs = 0.0f;
+        m_lastProcessedRequestFrameIndex = kInvalidFrameIndex;
         m_gpuAgeFilterDispatchMissing = false;
         m_gpuAgeFilterDispatchMissingFrameIndex = kInvalidFrameIndex;
         m_cpuUnloadFallbackActive = false;
         m_cpuUnloadFallbackGroupCount = 0u;
         m_cpuUnloadFallbackFrameIndex = kInvalidFrameIndex;
-        m_graphicsTransferFallbackActive = false;
-        m_graphicsTransferFallbackFrameIndex = kInvalidFrameIndex;
     }
 
     void clearGpuStreamingStats() {
@@ -2489,7 +3292,13 @@ private:
         m_debugStats.maxLoadsPerFrame = m_maxLoadsPerFrame;
         m_debugStats.maxUnloadsPerFrame = m_maxUnloadsPerFrame;
         m_debugStats.ageThreshold = m_ageThreshold;
-        m_debugStats.streamingTaskCapacity = kStreamingTaskCount;
+        m_debugStats.streamingTaskCapacity = m_streamingTaskCount;
+        m_debugStats.streamingTaskStallCount = m_lastTaskPipelineStallCount;
+        m_debugStats.streamingTaskTransferBudgetBytes = m_streamingStorage.uploadBudgetBytes();
+        m_debugStats.taskPrepareLatencyMs = m_smoothedTaskPrepareLatencyMs;
+        m_debugStats.taskTransferLatencyMs = m_smoothedTaskTransferLatencyMs;
+        m_debugStats.taskRetireLatencyMs = m_smoothedTaskRetireLatencyMs;
+        m_debugStats.transferThroughputBytesPerSecond = m_smoothedTransferBytesPerSecond;
         m_debugStats.freeStreamingTaskCount = 0;
         m_debugStats.preparedStreamingTaskCount = 0;
         m_debugStats.transferSubmittedTaskCount = 0;
@@ -2501,8 +3310,8 @@ private:
         m_debugStats.selectedUpdateTransferWaitValue = m_activeUpdateTransferWaitValue;
         m_debugStats.resourcesReady = ready();
 
-        for (const StreamingTask& task : m_streamingTasks) {
-            switch (task.state) {
+        for (uint32_t taskIndex = 0u; taskIndex < m_streamingTaskCount; ++taskIndex) {
+            switch (m_streamingTasks[taskIndex].state) {
             case StreamingTaskState::Free:
                 ++m_debugStats.freeStreamingTaskCount;
                 break;
@@ -2518,34 +3327,33 @@ private:
             }
         }
 
-        const uint32_t groupCount =
-            std::min(m_debugStats.activeResidencyGroupCount, m_residencyGroupCapacity);
+        // Every resident group is in exactly one of the resident lists, so the
+        // telemetry below scales with resident groups rather than scene groups.
         uint32_t maxResidentAge = 0u;
-        for (uint32_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
-            const uint32_t state = m_groupResidencyState[groupIndex];
-            if ((state & kClusterLodGroupResidencyResident) != 0u) {
-                ++m_debugStats.lastResidentGroupCount;
-                if (groupIndex < m_groupAgeState.size()) {
-                    maxResidentAge = std::max(maxResidentAge, m_groupAgeState[groupIndex]);
-                }
+        forEachResidentGroup([&](uint32_t groupIndex) {
+            if (groupIndex < m_groupAgeState.size()) {
+                maxResidentAge = std::max(maxResidentAge, m_groupAgeState[groupIndex]);
             }
-            if ((state & kClusterLodGroupResidencyAlwaysResident) != 0u) {
-                ++m_debugStats.lastAlwaysResidentGroupCount;
-            }
-        }
+        });
+        m_debugStats.lastAlwaysResidentGroupCount =
+            static_cast<uint32_t>(m_alwaysResidentGroups.size());
+        m_debugStats.lastResidentGroupCount = static_cast<uint32_t>(
+            m_alwaysResidentGroups.size() + m_dynamicResidentGroups.size());
 
         const uint32_t residentClusterCount = m_streamingStorage.usedElements();
         const uint64_t storagePoolCapacityBytes =
             uint64_t(m_streamingStorage.capacityElements()) * sizeof(uint32_t);
         const uint64_t storagePoolUsedBytes =
             uint64_t(residentClusterCount) * sizeof(uint32_t);
-        const uint64_t transferCapacityBytes = effectiveStreamingTransferCapacityBytes();
+        const uint64_t transferCapacityBytes = m_streamingStorage.uploadBudgetBytes();
 
         m_streamingStats.residentGroupCount = m_debugStats.lastResidentGroupCount;
         m_streamingStats.residentClusterCount = residentClusterCount;
         m_streamingStats.alwaysResidentGroupCount = m_debugStats.lastAlwaysResidentGroupCount;
         m_streamingStats.dynamicResidentGroupCount = m_debugStats.dynamicResidentGroupCount;
         m_streamingStats.storagePoolCapacityBytes = storagePoolCapacityBytes;
+        m_streamingStats.storagePoolReservedBytes =
+            uint64_t(m_streamingStorage.reservedElements()) * sizeof(uint32_t);
         m_streamingStats.storagePoolUsedBytes = storagePoolUsedBytes;
         m_streamingStats.residentHeapCapacity = m_debugStats.residentHeapCapacity;
         m_streamingStats.residentHeapUsed = residentClusterCount;
@@ -2569,6 +3377,20 @@ private:
                         double(transferCapacityBytes))
                 : 0.0f;
         m_streamingStats.failedAllocations = m_failedAllocationsThisFrame;
+        m_streamingStats.storageFreeRangeCount = m_streamingStorage.freeRangeCount();
+        m_streamingStats.storageLargestFreeRange = m_streamingStorage.largestFreeRange();
+        m_streamingStats.storageFragmentation = m_streamingStorage.fragmentation();
+        m_streamingStats.defragMovesThisFrame = m_defragMovesThisFrame;
+        m_streamingStats.popLatencySampleCount = m_popLatencySampleCount;
+        m_streamingStats.popLatencyAverageFrames =
+            m_popLatencySampleCount != 0u
+                ? float(double(m_popLatencyFrameSum) / double(m_popLatencySampleCount))
+                : 0.0f;
+        m_streamingStats.popLatencyMaxFrames = m_popLatencyMaxFrames;
+        m_streamingStats.requestReadbackCpuMs = m_requestReadbackCpuMs;
+        m_streamingStats.groupPageReadsThisFrame = m_groupPageReadsThisFrame;
+        m_streamingStats.groupPageReadFailures = m_groupPageReader.failedReadCount();
+        m_streamingStats.groupPagesOnDisk = m_groupPageReader.isOpen();
         m_streamingStats.gpuAgeFilterDispatchMissing = m_gpuAgeFilterDispatchMissing;
         m_streamingStats.gpuAgeFilterDispatchMissingFrameIndex =
             m_gpuAgeFilterDispatchMissingFrameIndex;
@@ -2585,44 +3407,26 @@ private:
             std::max(1u,
                      (maxResidentAge + kStreamingAgeHistogramBucketCount) /
                          kStreamingAgeHistogramBucketCount);
-        for (uint32_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
-            if (!isGroupResident(groupIndex) || groupIndex >= m_groupAgeState.size()) {
-                continue;
-            }
-
-            const uint32_t bucketIndex = std::min<uint32_t>(
-                m_groupAgeState[groupIndex] / m_streamingStats.ageHistogramBucketWidth,
-                kStreamingAgeHistogramBucketCount - 1u);
-            ++m_streamingStats.ageHistogram[bucketIndex];
-        }
-
-        m_streamingStats.residentGroupsPerLod.clear();
         m_streamingStats.totalGroupsPerLod.clear();
+        m_streamingStats.residentGroupsPerLod.clear();
         if (clusterLodData && !clusterLodData->levels.empty()) {
-            uint32_t maxLodDepth = 0u;
-            for (const ClusterLODLevel& level : clusterLodData->levels) {
-                maxLodDepth = std::max(maxLodDepth, level.depth);
+            m_streamingStats.totalGroupsPerLod = m_totalGroupsPerLod;
+            m_streamingStats.residentGroupsPerLod.assign(m_totalGroupsPerLod.size(), 0u);
+        }
+        forEachResidentGroup([&](uint32_t groupIndex) {
+            if (groupIndex < m_groupAgeState.size()) {
+                const uint32_t bucketIndex = std::min<uint32_t>(
+                    m_groupAgeState[groupIndex] / m_streamingStats.ageHistogramBucketWidth,
+                    kStreamingAgeHistogramBucketCount - 1u);
+                ++m_streamingStats.ageHistogram[bucketIndex];
             }
 
-            m_streamingStats.residentGroupsPerLod.assign(size_t(maxLodDepth) + 1u, 0u);
-            m_streamingStats.totalGroupsPerLod.assign(size_t(maxLodDepth) + 1u, 0u);
-            for (const ClusterLODLevel& level : clusterLodData->levels) {
-                if (level.depth >= m_streamingStats.totalGroupsPerLod.size()) {
-                    continue;
-                }
-
-                const uint32_t levelGroupBegin = std::min(level.groupStart, groupCount);
-                const uint32_t levelGroupEnd = static_cast<uint32_t>(
-                    std::min<uint64_t>(uint64_t(level.groupStart) + uint64_t(level.groupCount),
-                                       uint64_t(groupCount)));
-                for (uint32_t groupIndex = levelGroupBegin; groupIndex < levelGroupEnd; ++groupIndex) {
-                    ++m_streamingStats.totalGroupsPerLod[level.depth];
-                    if (isGroupResident(groupIndex)) {
-                        ++m_streamingStats.residentGroupsPerLod[level.depth];
-                    }
-                }
+            const uint8_t lodDepth =
+                groupIndex < m_groupLodDepth.size() ? m_groupLodDepth[groupIndex] : kInvalidLodDepth;
+            if (lodDepth < m_streamingStats.residentGroupsPerLod.size()) {
+                ++m_streamingStats.residentGroupsPerLod[lodDepth];
             }
-        }
+        });
     }
 
     bool m_enableStreaming = false;
@@ -2631,18 +3435,23 @@ private:
     uint32_t m_streamingBudgetGroups = 256u;
     uint32_t m_residencyGroupCapacity = 0;
     uint32_t m_maxLoadsPerFrame = 128u;
+    bool m_enableResidencyPrefetch = true;
+    float m_prefetchLookaheadSeconds = 0.25f;
     uint32_t m_maxUnloadsPerFrame = 256u;
     BudgetPreset m_budgetPreset = BudgetPreset::Auto;
     uint32_t m_configuredAgeThreshold = 16u;
     uint32_t m_ageThreshold = 16u;
     bool m_useCompactAgeFilterDispatch = true;
+    bool m_useCompactRequestReadback = true;
     bool m_adaptiveBudgetEnabled = true;
     bool m_enableGpuStatsReadback = true;
+    bool m_enableDefragmentation = false;
     uint32_t m_frameIndex = 0u;
     uint32_t m_prepareTaskIndex = kInvalidTaskIndex;
     uint32_t m_transferTaskIndex = kInvalidTaskIndex;
     uint32_t m_updateTaskIndex = kInvalidTaskIndex;
     uint32_t m_activeUpdatePatchCount = 0u;
+    uint32_t m_activeUpdatePatchClusterCount = 0u;
     uint32_t m_activeActiveResidentPatchCount = 0u;
     uint32_t m_activeFrameResidentGroupCount = 0u;
     uint64_t m_streamingStorageCapacityBytes = kDefaultStreamingStorageCapacityBytes;
@@ -2654,16 +3463,39 @@ private:
     const void* m_residencySourceNodeBufferHandle = nullptr;
     const void* m_residencySourceGroupBufferHandle = nullptr;
     const void* m_residencySourceGroupMeshletIndicesHandle = nullptr;
-    std::array<FrameBuffers, kBufferedFrameCount> m_frameBuffers;
+    std::array<FrameBuffers, kMaxBufferedFrameCount> m_frameBuffers;
+    uint32_t m_bufferedFrameCount = 2u;
     std::unique_ptr<RhiBuffer> m_lodGroupPageTableBuffer;
     StreamingStorage m_streamingStorage;
-    std::array<StreamingTask, kStreamingTaskCount> m_streamingTasks;
+    AsyncFileReader m_groupPageReader;
+    uint64_t m_reportedGroupPageReadFailures = 0u;
+    std::array<StreamingTask, kMaxStreamingTaskCount> m_streamingTasks;
+    uint32_t m_streamingTaskCount = kMinStreamingTaskCount;
+    bool m_adaptiveTaskPipelineEnabled = true;
+    uint32_t m_taskPipelineEvaluationFrameCount = 0u;
+    uint32_t m_taskPipelineStallCount = 0u;
+    uint32_t m_lastTaskPipelineStallCount = 0u;
+    uint32_t m_taskPipelinePeakBusyCount = 0u;
+    float m_smoothedFrameSeconds = 0.0f;
+    float m_smoothedTaskPrepareLatencyMs = 0.0f;
+    float m_smoothedTaskTransferLatencyMs = 0.0f;
+    float m_smoothedTaskRetireLatencyMs = 0.0f;
+    float m_smoothedTransferBytesPerSecond = 0.0f;
     std::vector<uint32_t> m_alwaysResidentGroups;
     std::vector<uint32_t> m_groupResidencyState;
     std::vector<uint32_t> m_groupAgeState;
+    std::vector<uint8_t> m_groupPendingDeltaSlots;
     std::vector<uint32_t> m_groupResidentSinceFrame;
+    std::vector<uint8_t> m_groupLodDepth;
+    std::vector<uint32_t> m_groupPrimitiveGroup;
+    std::vector<float> m_primitiveGroupImportance;
+    uint32_t m_primitiveGroupCount = 0u;
+    std::vector<uint32_t> m_totalGroupsPerLod;
     std::vector<uint8_t> m_groupPendingUnloadState;
     std::vector<uint32_t> m_pendingResidencyRequestFrames;
+    std::vector<uint32_t> m_pendingResidencyFirstRequestFrames;
+    std::vector<float> m_pendingResidencyPriority;
+    std::vector<uint8_t> m_pendingResidencyPrefetch;
     std::vector<uint8_t> m_residentTouchSeenScratch;
     std::vector<uint8_t> m_unloadRequestSeenScratch;
     std::vector<uint32_t> m_dynamicResidentGroups;
@@ -2674,6 +3506,9 @@ private:
     std::vector<uint32_t> m_prepareTaskActiveResidentGroupIndexScratch;
     std::vector<ClusterResidencyRequest> m_requestReadbackScratch;
     std::vector<ClusterUnloadRequest> m_unloadRequestReadbackScratch;
+    RequestReadback m_requestReadback;
+    Jobs::JobCounter m_prepareJob;
+    bool m_prepareJobLaunched = false;
     std::vector<uint32_t> m_confirmedUnloadGroups;
     std::vector<GroupResidentAllocation> m_groupResidentAllocations;
     ClusterStreamingGpuStats m_lastGpuStreamingStats{};
@@ -2692,6 +3527,12 @@ private:
     uint32_t m_loadRequestsThisFrame = 0u;
     uint32_t m_unloadRequestsThisFrame = 0u;
     uint32_t m_failedAllocationsThisFrame = 0u;
+    uint32_t m_groupPageReadsThisFrame = 0u;
+    uint32_t m_defragMovesThisFrame = 0u;
+    uint32_t m_popLatencySampleCount = 0u;
+    uint64_t m_popLatencyFrameSum = 0u;
+    uint32_t m_popLatencyMaxFrames = 0u;
+    float m_requestReadbackCpuMs = 0.0f;
     uint32_t m_lastProcessedRequestFrameIndex = kInvalidFrameIndex;
     bool m_gpuAgeFilterDispatchMissing = false;
     uint32_t m_gpuAgeFilterDispatchMissingFrameIndex = kInvalidFrameIndex;
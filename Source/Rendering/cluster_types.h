@@ -19,6 +19,26 @@ struct PackedCluster {
 };
 static_assert(sizeof(PackedCluster) == 16, "PackedCluster must be 16 bytes");
 
+// Cluster vertex data layout. The buffer starts with float3 gridMin + float
+// gridStep; every position is an integer point of that mesh-wide grid, decoded as
+// gridMin + float(gridPos) * gridStep. Vertices shared across group borders map
+// to the same grid point, so every cluster decodes them bit-exactly.
+// A quantized cluster (attributeBits & kClusterVertexQuantized16) starts with a
+// uint3 grid origin + uint pad, followed by uint16x3 offsets from it; clusters
+// spanning more than 16 bits of the grid store absolute uint32x3 grid points.
+// Each cluster's data is padded to 4 bytes.
+constexpr uint8_t kClusterVertexQuantized16 = 1u << 0;
+constexpr uint32_t kClusterVertexGridHeaderBytes = 16;
+constexpr uint32_t kClusterVertexHeaderBytes = 16;
+constexpr uint32_t kClusterVertexGridBits = 20;
+
+inline uint32_t clusterVertexDataBytes(const PackedCluster& cluster, uint32_t vertexCount) {
+    if ((cluster.attributeBits & kClusterVertexQuantized16) != 0) {
+        return kClusterVertexHeaderBytes + ((vertexCount * 6u + 3u) & ~3u);
+    }
+    return vertexCount * 12u;
+}
+
 struct TraversalMetric {
     float sphereX, sphereY, sphereZ, sphereRadius;
     float maxQuadricError;
@@ -51,8 +71,3 @@ namespace PackedNodeBits {
     }
 }
 
-struct ClusterInfo {
-    uint32_t instanceID;
-    uint32_t clusterID;
-};
-static_assert(sizeof(ClusterInfo) == 8, "ClusterInfo must be 8 bytes");
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <ml.h>
+
+#include "gpu_scene.h"
+#include "parallel_for.h"
+#include "scene_graph.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+// Frustum culling of scene nodes for the CPU draw paths (ForwardPass and the per-node
+// VisibilityPass fallback), which used to draw every visible node. update() packs the
+// world bounding spheres of the drawable nodes from GpuSceneTables::instanceCull into
+// SoA arrays whenever the tables' contentRevision moves; cull() tests them four at a
+// time against the six frustum planes, eight with AVX, split into chunks over the job
+// system, and appends the survivors to per-frame lists in node order. Nodes drawn
+// through a MeshInstanceSet, or without a GPU scene instance, get an infinite radius:
+// the CPU paths draw them once at the node, which their instance bounds do not describe.
+class CpuNodeCuller {
+public:
+    enum : uint8_t {
+        kMeshletNode = 1u << 0,
+        kIndexNode = 1u << 1,
+    };
+
+    uint32_t candidateCount() const { return m_count; }
+
+    // Drops the packed bounds, for a scene swap that may keep the revision.
+    void invalidate() { m_tables = nullptr; }
+
+    void update(const SceneGraph& graph, const GpuSceneTables& tables) {
+        if (m_tables == &tables && m_revision == tables.contentRevision &&
+            m_nodeCount == graph.nodes.size() && m_instanceCount == tables.instances.size()) {
+            return;
+        }
+        m_tables = &tables;
+        m_revision = tables.contentRevision;
+        m_nodeCount = graph.nodes.size();
+        m_instanceCount = tables.instances.size();
+
+        m_centerX.clear();
+        m_centerY.clear();
+        m_centerZ.clear();
+        m_radius.clear();
+        m_nodeIds.clear();
+        m_kinds.clear();
+        for (const SceneNode& node : graph.nodes) {
+            const uint8_t kind = (node.meshletCount > 0 ? kMeshletNode : 0u) |
+                                 (node.indexCount > 0 ? kIndexNode : 0u);
+            if (kind == 0 || !graph.isNodeVisible(node.id)) {
+                continue;
+            }
+            float sphere[4] = {0.0f, 0.0f, 0.0f, std::numeric_limits<float>::infinity()};
+            if (node.id < tables.nodeToInstance.size() && node.id < tables.nodeInstanceCount.size() &&
+                tables.nodeInstanceCount[node.id] == 1u &&
+                tables.nodeToInstance[node.id] < tables.instanceCull.size()) {
+                const GPUSceneInstanceCull& cull = tables.instanceCull[tables.nodeToInstance[node.id]];
+                std::copy(cull.worldBoundsSphere, cull.worldBoundsSphere + 4, sphere);
+            }
+            m_centerX.push_back(sphere[0]);
+            m_centerY.push_back(sphere[1]);
+            m_centerZ.push_back(sphere[2]);
+            m_radius.push_back(sphere[3]);
+            m_nodeIds.push_back(node.id);
+            m_kinds.push_back(kind);
+        }
+        m_count = static_cast<uint32_t>(m_nodeIds.size());
+
+        // Pad to whole SIMD groups with spheres no plane can accept.
+        const size_t padded = (m_count + kLanes - 1u) / kLanes * kLanes;
+        m_centerX.resize(padded, 0.0f);
+        m_centerY.resize(padded, 0.0f);
+        m_centerZ.resize(padded, 0.0f);
+        m_radius.resize(padded, -std::numeric_limits<float>::infinity());
+    }
+
+    // Appends the nodes whose sphere meets the frustum of viewProj (proj * view), in
+    // node order. Either list may be null. Both are resized to every candidate first,
+    // so a chunk writes its survivors into its own range without synchronization.
+    void cull(const float4x4& viewProj,
+              std::pmr::vector<uint32_t>* meshletNodes,
+              std::pmr::vector<uint32_t>* indexNodes) const {
+        if (m_count == 0 || (!meshletNodes && !indexNodes)) {
+            return;
+        }
+        float4 planes[PLANES_NUM];
+        MvpToPlanes(ML_OGL ? STYLE_OGL : STYLE_D3D, viewProj, planes);
+
+        const size_t meshletBase = meshletNodes ? meshletNodes->size() : 0;
+        const size_t indexBase = indexNodes ? indexNodes->size() : 0;
+        if (meshletNodes) meshletNodes->resize(meshletBase + m_count);
+        if (indexNodes) indexNodes->resize(indexBase + m_count);
+
+        const uint32_t chunkCount = (m_count + kChunkSize - 1u) / kChunkSize;
+        std::pmr::memory_resource* scratch = meshletNodes ? meshletNodes->get_allocator().resource()
+                                                          : indexNodes->get_allocator().resource();
+        std::pmr::vector<uint32_t> meshletCounts(chunkCount, 0u, scratch);
+        std::pmr::vector<uint32_t> indexCounts(chunkCount, 0u, scratch);
+        Parallel::parallelFor(chunkCount, [&](size_t chunk) {
+            const uint32_t begin = static_cast<uint32_t>(chunk) * kChunkSize;
+            const uint32_t end = std::min(begin + kChunkSize, m_count);
+            uint32_t* meshletOut = meshletNodes ? meshletNodes->data() + meshletBase + begin : nullptr;
+            uint32_t* indexOut = indexNodes ? indexNodes->data() + indexBase + begin : nullptr;
+            uint32_t meshletCount = 0;
+            uint32_t indexCount = 0;
+            for (uint32_t group = begin; group < end; group += kLanes) {
+                uint32_t mask = insideMask(planes, group);
+                while (mask != 0u) {
+                    const uint32_t i = group + static_cast<uint32_t>(std::countr_zero(mask));
+                    mask &= mask - 1u;
+                    if (i >= end) {
+                        break;
+                    }
+                    if (meshletOut && (m_kinds[i] & kMeshletNode)) meshletOut[meshletCount++] = m_nodeIds[i];
+                    if (indexOut && (m_kinds[i] & kIndexNode)) indexOut[indexCount++] = m_nodeIds[i];
+                }
+            }
+            meshletCounts[chunk] = meshletCount;
+            indexCounts[chunk] = indexCount;
+        });
+
+        if (meshletNodes) compact(*meshletNodes, meshletBase, meshletCounts);
+        if (indexNodes) compact(*indexNodes, indexBase, indexCounts);
+    }
+
+private:
+#if ML_INTRINSIC_LEVEL >= ML_INTRINSIC_AVX1
+    static constexpr uint32_t kLanes = 8;
+#else
+    static constexpr uint32_t kLanes = 4;
+#endif
+    // Multiple of kLanes; big enough that a chunk outweighs claiming it.
+    static constexpr uint32_t kChunkSize = 1024;
+
+    // Bit i set when sphere first + i is not entirely behind any plane.
+    uint32_t insideMask(const float4* planes, uint32_t first) const {
+#if ML_INTRINSIC_LEVEL >= ML_INTRINSIC_AVX1
+        const __m256 x = _mm256_loadu_ps(m_centerX.data() + first);
+        const __m256 y = _mm256_loadu_ps(m_centerY.data() + first);
+        const __m256 z = _mm256_loadu_ps(m_centerZ.data() + first);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(m_radius.data() + first));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (uint32_t p = 0; p < PLANES_NUM; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(planes[p].x)), _mm256_set1_ps(planes[p].w));
+            d = _mm256_add_ps(d, _mm256_mul_ps(y, _mm256_set1_ps(planes[p].y)));
+            d = _mm256_add_ps(d, _mm256_mul_ps(z, _mm256_set1_ps(planes[p].z)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+        }
+        return static_cast<uint32_t>(_mm256_movemask_ps(inside));
+#else
+        const __m128 x = _mm_loadu_ps(m_centerX.data() + first);
+        const __m128 y = _mm_loadu_ps(m_centerY.data() + first);
+        const __m128 z = _mm_loadu_ps(m_centerZ.data() + first);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(m_radius.data() + first));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (uint32_t p = 0; p < PLANES_NUM; ++p) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].x)), _mm_set1_ps(planes[p].w));
+            d = _mm_add_ps(d, _mm_mul_ps(y, _mm_set1_ps(planes[p].y)));
+            d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(planes[p].z)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+        return static_cast<uint32_t>(_mm_movemask_ps(inside));
+#endif
+    }
+
+    // Slides every chunk's survivors down behind the previous chunk's.
+    static void compact(std::pmr::vector<uint32_t>& nodes, size_t base,
+                        const std::pmr::vector<uint32_t>& chunkCounts) {
+        size_t write = base;
+        for (size_t chunk = 0; chunk < chunkCounts.size(); ++chunk) {
+            const size_t read = base + chunk * kChunkSize;
+            if (read != write) {
+                std::copy(nodes.begin() + read, nodes.begin() + read + chunkCounts[chunk], nodes.begin() + write);
+            }
+            write += chunkCounts[chunk];
+        }
+        nodes.resize(write);
+    }
+
+    std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+    std::vector<uint32_t> m_nodeIds;
+    std::vector<uint8_t> m_kinds;
+    uint32_t m_count = 0;
+
+    const GpuSceneTables* m_tables = nullptr;
+    uint32_t m_revision = 0;
+    size_t m_nodeCount = 0;
+    size_t m_instanceCount = 0;
+};
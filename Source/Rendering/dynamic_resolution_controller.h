@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Picks the internal render scale each frame from the measured GPU frame time. Cost is
+// treated as proportional to pixel count, so the ideal scale is scale * sqrt(target / gpu).
+// Over-budget frames scale down right away; scaling up waits for a settled, filtered
+// measurement with headroom. Scales are quantized to scaleStep so the render graph is
+// only rebuilt when the level actually changes.
+class DynamicResolutionController {
+public:
+    struct Settings {
+        float targetFrameMs = 16.6f;
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+        float scaleStep = 0.05f;
+        float upscaleHeadroom = 0.85f; // scale up only below target * headroom
+        float smoothing = 0.1f;        // EMA weight of the newest sample
+        // Frames a new scale takes to show up in completed GPU timings (frames in flight
+        // plus one); decisions wait this long after every change.
+        uint32_t responseFrames = 3u;
+        uint32_t upscaleCooldownFrames = 60u;
+    };
+
+    Settings& settings() { return m_settings; }
+    const Settings& settings() const { return m_settings; }
+    float filteredGpuMs() const { return m_filteredGpuMs; }
+
+    void reset() {
+        m_filteredGpuMs = 0.0f;
+        m_lastGpuFrameIndex = UINT64_MAX;
+        m_framesSinceChange = 0u;
+    }
+
+    // Feeds one completed GPU frame. Returns true and updates renderScale when the
+    // quantized scale changed; repeated calls for the same GPU frame are ignored.
+    bool update(uint64_t gpuFrameIndex, double gpuFrameMs, float& renderScale) {
+        if (gpuFrameIndex == m_lastGpuFrameIndex || gpuFrameMs <= 0.0) {
+            return false;
+        }
+        m_lastGpuFrameIndex = gpuFrameIndex;
+        ++m_framesSinceChange;
+
+        const float sampleMs = static_cast<float>(gpuFrameMs);
+        m_filteredGpuMs = m_filteredGpuMs > 0.0f
+                              ? m_filteredGpuMs + (sampleMs - m_filteredGpuMs) * m_settings.smoothing
+                              : sampleMs;
+        if (m_framesSinceChange < m_settings.responseFrames) {
+            return false;
+        }
+
+        const float target = std::max(m_settings.targetFrameMs, 0.1f);
+        float desiredScale = renderScale;
+        if (sampleMs > target) {
+            desiredScale = renderScale * std::sqrt(target / sampleMs);
+        } else if (m_filteredGpuMs < target * m_settings.upscaleHeadroom &&
+                   m_framesSinceChange >= m_settings.upscaleCooldownFrames) {
+            // Aim for the headroom line rather than the target so the next frame is not
+            // immediately over budget again.
+            desiredScale = renderScale * std::sqrt(target * m_settings.upscaleHeadroom / m_filteredGpuMs);
+        }
+
+        const float newScale = quantize(desiredScale);
+        if (std::abs(newScale - renderScale) < 0.0001f) {
+            return false;
+        }
+        renderScale = newScale;
+        m_filteredGpuMs = 0.0f;
+        m_framesSinceChange = 0u;
+        return true;
+    }
+
+    // Halton phases needed to cover every output pixel once the image is upscaled:
+    // 8 * (output / render)^2 as recommended for temporal upscalers, never fewer than
+    // the 16 used at native resolution.
+    static uint32_t jitterPhaseCount(int renderWidth, int outputWidth) {
+        if (renderWidth <= 0 || outputWidth <= renderWidth) {
+            return 16u;
+        }
+        const float ratio = static_cast<float>(outputWidth) / static_cast<float>(renderWidth);
+        return std::clamp(static_cast<uint32_t>(std::ceil(8.0f * ratio * ratio)), 16u, 64u);
+    }
+
+private:
+    // Rounds down so a step never lands above the measured budget.
+    float quantize(float scale) const {
+        const float step = std::max(m_settings.scaleStep, 0.01f);
+        const float clamped = std::clamp(scale, m_settings.minScale, m_settings.maxScale);
+        return std::clamp(std::floor(clamped / step + 0.001f) * step, m_settings.minScale, m_settings.maxScale);
+    }
+
+    Settings m_settings;
+    float m_filteredGpuMs = 0.0f;
+    uint64_t m_lastGpuFrameIndex = UINT64_MAX;
+    uint32_t m_framesSinceChange = 0u;
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "camera.h"
+#include "frame_graph.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Deterministic frame benchmark behind the MetallicBench target. Runs a recorded
+// camera timeline (camera_timeline.h, replayed by the caller) or a scripted orbit
+// with a fixed timestep, restarts the TAA jitter sequence at frame 0, and writes
+// per-frame CPU and per-pass GPU times plus p50/p95/p99 summaries. Enabled with
+// --bench <json>.
+class FrameBenchmark {
+public:
+    struct Settings {
+        std::string reportPath;
+        std::string csvPath;
+        std::string timelinePath;
+        std::string scenePath;
+        std::string pipelinePath;
+        uint32_t warmupFrames = 60u;
+        uint32_t frames = 600u;
+        double timestep = 1.0 / 60.0;
+        int width = 1920;
+        int height = 1080;
+    };
+
+    // Returns false on a malformed benchmark argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* path = takeValue("--bench")) {
+                settings.reportPath = path;
+            } else if (const char* path = takeValue("--bench-csv")) {
+                settings.csvPath = path;
+            } else if (const char* path = takeValue("--bench-timeline")) {
+                settings.timelinePath = path;
+            } else if (const char* path = takeValue("--bench-scene")) {
+                settings.scenePath = path;
+            } else if (const char* path = takeValue("--bench-pipeline")) {
+                settings.pipelinePath = path;
+            } else if (const char* frames = takeValue("--bench-warmup")) {
+                settings.warmupFrames = static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+            } else if (const char* frames = takeValue("--bench-frames")) {
+                settings.frames = std::max(1u, static_cast<uint32_t>(std::strtoul(frames, nullptr, 10)));
+            } else if (const char* seconds = takeValue("--bench-timestep")) {
+                settings.timestep = std::max(1e-4, std::strtod(seconds, nullptr));
+            } else if (const char* size = takeValue("--bench-size")) {
+                int width = 0;
+                int height = 0;
+                if (std::sscanf(size, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                    spdlog::error("--bench-size expects WIDTHxHEIGHT, got {}", size);
+                    return false;
+                }
+                settings.width = width;
+                settings.height = height;
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--bench-", 8) == 0) {
+                spdlog::error("Unknown benchmark argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool begin(const Settings& settings, const OrbitCamera& camera) {
+        m_settings = settings;
+        m_baseCamera = camera;
+        m_frame = 0u;
+        m_lastGpuFrameIndex = UINT64_MAX;
+        m_cpuFrameMs.clear();
+        m_gpuFrameMs.clear();
+        m_passMs.clear();
+        m_frameRows.clear();
+        m_active = true;
+        spdlog::info("Frame benchmark: {} warm-up + {} frames at {}x{}, writing {}",
+                     settings.warmupFrames, settings.frames, settings.width, settings.height,
+                     settings.reportPath);
+        return true;
+    }
+
+    bool active() const { return m_active; }
+    bool finished() const { return m_active && m_frame >= m_settings.warmupFrames + m_settings.frames; }
+    bool measuring() const { return m_active && m_frame >= m_settings.warmupFrames; }
+
+    // Fixed simulation step; animation and motion vectors see the same deltas every run.
+    float timestep() const { return static_cast<float>(m_settings.timestep); }
+    // Jitter phase index: restarts at 0 with every run.
+    uint32_t jitterIndex() const { return m_frame; }
+
+    // Call once per frame before the view is built. Only drives the camera when no
+    // timeline is replayed.
+    void update(OrbitCamera& camera) const {
+        if (!m_active || !m_settings.timelinePath.empty()) {
+            return;
+        }
+        const double t = double(m_frame) * m_settings.timestep;
+        camera = m_baseCamera;
+        camera.azimuth = m_baseCamera.azimuth + static_cast<float>(t) * 0.35f;
+    }
+
+    // Call once per frame after submission. GPU timings trail the CPU by the frames
+    // in flight, so a GPU sample is kept once per new gpuFrameIndex while measuring.
+    void recordFrame(double cpuFrameMs,
+                     uint64_t gpuFrameIndex,
+                     double gpuFrameMs,
+                     const std::vector<FGGpuScopeSample>& gpuScopes) {
+        if (!m_active) {
+            return;
+        }
+        if (measuring()) {
+            FrameRow& row = m_frameRows.emplace_back();
+            row.frame = m_frame - m_settings.warmupFrames;
+            row.cpuMs = cpuFrameMs;
+            m_cpuFrameMs.push_back(cpuFrameMs);
+            if (gpuFrameIndex != m_lastGpuFrameIndex && gpuFrameMs > 0.0) {
+                row.hasGpu = true;
+                row.gpuMs = gpuFrameMs;
+                m_gpuFrameMs.push_back(gpuFrameMs);
+                for (const FGGpuScopeSample& scope : gpuScopes) {
+                    row.passMs[scope.label] += scope.durationMs;
+                }
+                for (const auto& [label, ms] : row.passMs) {
+                    m_passMs[label].push_back(ms);
+                }
+            }
+        }
+        m_lastGpuFrameIndex = gpuFrameIndex;
+        ++m_frame;
+        if (finished()) {
+            writeReport();
+        }
+    }
+
+private:
+    struct FrameRow {
+        uint32_t frame = 0u;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        bool hasGpu = false;
+        std::map<std::string, double> passMs;
+    };
+
+    // Nearest-rank percentiles over the measured frames.
+    static nlohmann::json summarize(std::vector<double> samples) {
+        if (samples.empty()) {
+            return nlohmann::json{{"count", 0}};
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * double(samples.size())));
+            return samples[std::clamp<size_t>(rank, 1u, samples.size()) - 1u];
+        };
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        return nlohmann::json{{"count", samples.size()},
+                              {"mean", sum / double(samples.size())},
+                              {"min", samples.front()},
+                              {"p50", percentile(0.50)},
+                              {"p95", percentile(0.95)},
+                              {"p99", percentile(0.99)},
+                              {"max", samples.back()}};
+    }
+
+    void writeReport() {
+        nlohmann::json passes = nlohmann::json::object();
+        for (const auto& [label, samples] : m_passMs) {
+            passes[label] = summarize(samples);
+        }
+        nlohmann::json frames = nlohmann::json::array();
+        for (const FrameRow& row : m_frameRows) {
+            nlohmann::json frame{{"frame", row.frame}, {"cpuMs", row.cpuMs}};
+            if (row.hasGpu) {
+                frame["gpuMs"] = row.gpuMs;
+                frame["passes"] = row.passMs;
+            }
+            frames.push_back(std::move(frame));
+        }
+        const nlohmann::json report{
+            {"scene", m_settings.scenePath},
+            {"pipeline", m_settings.pipelinePath},
+            {"timeline", m_settings.timelinePath},
+            {"width", m_settings.width},
+            {"height", m_settings.height},
+            {"warmupFrames", m_settings.warmupFrames},
+            {"frames", m_settings.frames},
+            {"timestep", m_settings.timestep},
+            {"summary", {{"cpuFrameMs", summarize(m_cpuFrameMs)},
+                         {"gpuFrameMs", summarize(m_gpuFrameMs)},
+                         {"passes", passes}}},
+            {"perFrame", frames},
+        };
+        std::ofstream reportFile(m_settings.reportPath, std::ios::trunc);
+        if (!reportFile) {
+            spdlog::error("Failed to open benchmark report {}", m_settings.reportPath);
+        } else {
+            reportFile << report.dump(2);
+        }
+
+        if (!m_settings.csvPath.empty()) {
+            std::ofstream csv(m_settings.csvPath, std::ios::trunc);
+            csv << "frame,cpu_ms,gpu_ms";
+            for (const auto& [label, samples] : m_passMs) {
+                csv << ',' << label;
+            }
+            csv << '\n';
+            for (const FrameRow& row : m_frameRows) {
+                csv << row.frame << ',' << row.cpuMs << ',';
+                if (row.hasGpu) {
+                    csv << row.gpuMs;
+                }
+                for (const auto& [label, samples] : m_passMs) {
+                    csv << ',';
+                    if (auto it = row.passMs.find(label); it != row.passMs.end()) {
+                        csv << it->second;
+                    }
+                }
+                csv << '\n';
+            }
+        }
+
+        const nlohmann::json& cpu = report["summary"]["cpuFrameMs"];
+        const nlohmann::json& gpu = report["summary"]["gpuFrameMs"];
+        spdlog::info("Frame benchmark finished: CPU p50 {:.3f} / p99 {:.3f} ms, GPU p50 {:.3f} / p99 {:.3f} ms",
+                     cpu.value("p50", 0.0), cpu.value("p99", 0.0),
+                     gpu.value("p50", 0.0), gpu.value("p99", 0.0));
+    }
+
+    Settings m_settings;
+    OrbitCamera m_baseCamera;
+    uint32_t m_frame = 0u;
+    uint64_t m_lastGpuFrameIndex = UINT64_MAX;
+    std::vector<double> m_cpuFrameMs;
+    std::vector<double> m_gpuFrameMs;
+    std::map<std::string, std::vector<double>> m_passMs;
+    std::vector<FrameRow> m_frameRows;
+    bool m_active = false;
+};
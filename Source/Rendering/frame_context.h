@@ -3,8 +3,12 @@
 #include <ml.h>
 #include "rhi_backend.h"
 #include "rhi_interop.h"
+#include "pipeline_permutation.h"
+#include "shadow_cascades.h"
 
 #include <functional>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -13,11 +17,28 @@ class RhiTexture;
 class RhiBuffer;
 class RhiFrameGraphBackend;
 class ClusterStreamingService;
+class TextureStreamingPool;
+struct ViewportPickState;
+class GpuDrivenTelemetry;
+class LodBudgetController;
 enum class DlssPreset : uint32_t;
+enum class MetalFXPreset : uint32_t;
 #ifdef _WIN32
 class VulkanReadbackService;
 #endif
 
+// Reflex PC latency averaged over the frames of the driver's latency report.
+// Times are in milliseconds.
+struct LatencyTelemetry {
+    bool available = false;
+    float pcLatencyMs = 0.0f;        // simulation start to the end of GPU rendering
+    float simulationMs = 0.0f;
+    float renderSubmitMs = 0.0f;
+    float presentMs = 0.0f;
+    float gpuFrameMs = 0.0f;
+    uint32_t framesPresented = 0;    // per rendered frame, above 1 with Frame Generation
+};
+
 struct PipelineUiControls {
     bool* enableRTShadows = nullptr;
     bool rtShadowsAvailable = false;
@@ -36,6 +57,17 @@ struct PipelineUiControls {
 
     std::function<void(DlssPreset)> onDlssPresetChanged;
     std::function<void()> onResetDlssHistory;
+
+    bool frameGenerationAvailable = false;
+    bool frameGenerationEnabled = false;
+    std::function<void(bool)> onFrameGenerationChanged;
+    bool reflexAvailable = false;
+    bool reflexEnabled = false;
+    std::function<void(bool)> onReflexChanged;
+    LatencyTelemetry latency;
+
+    MetalFXPreset metalFXPreset = static_cast<MetalFXPreset>(0);
+    std::function<void(MetalFXPreset)> onMetalFXPresetChanged;
 };
 
 // Per-frame runtime context for data-driven pipeline execution
@@ -56,6 +88,15 @@ struct FrameContext {
     float cameraNearZ = 0.001f;
     float cameraFovY = 45.0f * (3.14159265358979323846f / 180.0f);
 
+    // A second view culled together with the main one (stereo eye, split viewport).
+    // With viewCount 2, GPU culling keeps what either view sees and ClusterLOD picks
+    // the finer level of the two, so both views can draw from one visible list.
+    // The projection is assumed to match the main view's in scale.
+    uint32_t viewCount = 1;
+    float4x4 secondaryView;
+    float4x4 secondaryProj;
+    float4 secondaryCameraWorldPos;
+
     // Previous frame camera matrices (for TAA motion vectors)
     float4x4 prevView;
     float4x4 prevProj;
@@ -85,9 +126,9 @@ struct FrameContext {
     uint32_t materialCount = 0;
     uint32_t textureCount = 0;
 
-    // Visible nodes for rendering
-    std::vector<uint32_t> visibleMeshletNodes;
-    std::vector<uint32_t> visibleIndexNodes;
+    // Visible nodes for rendering. Views into lists the main loop owns for the frame.
+    std::span<const uint32_t> visibleMeshletNodes;
+    std::span<const uint32_t> visibleIndexNodes;
     uint32_t visibilityInstanceCount = 0;
 
     // Depth clear value
@@ -96,6 +137,9 @@ struct FrameContext {
     // Camera far plane (for shadow rays)
     float cameraFarZ = 1000.0f;
 
+    // Light views for cascaded shadows; count is 0 unless they replace RT shadows.
+    ShadowCascadeSet shadowCascades;
+
     // Frame timing
     float deltaTime = 0.016f;
 
@@ -107,6 +151,9 @@ struct FrameContext {
     bool gpuDrivenCulling = false;
     int renderMode = 2; // 0=Vertex, 1=Mesh, 2=Visibility, 3=Meshlet Debug
 
+    // Scratch for this frame's recording (pmr containers in the passes). The main loop
+    // points it at its FrameArena; the default keeps standalone users on the heap.
+    std::pmr::memory_resource* frameMemory = std::pmr::get_default_resource();
 };
 
 // Runtime context for pipeline building (pipelines, textures, samplers)
@@ -114,6 +161,24 @@ struct PipelineRuntimeContext {
     // Pipeline states (keyed by pass type)
     std::unordered_map<std::string, RhiGraphicsPipelineHandle> renderPipelinesRhi;
     std::unordered_map<std::string, RhiComputePipelineHandle> computePipelinesRhi;
+    // Permutations asked for through findComputePermutation and not built yet;
+    // mutable because passes only see the runtime context as const.
+    mutable ComputePermutationRequests computePermutationRequests;
+
+    // The baseKey pipeline compiled with `defines`. Until ShaderManager has built
+    // it, queues the permutation and returns the generic baseKey pipeline; nullptr
+    // when neither exists. Failed permutations keep returning the generic one.
+    const RhiComputePipelineHandle* findComputePermutation(const std::string& baseKey,
+                                                           const PipelineDefines& defines) const {
+        const std::string key = computePermutationKey(baseKey, defines);
+        auto it = computePipelinesRhi.find(key);
+        if (it != computePipelinesRhi.end() && it->second.nativeHandle()) {
+            return &it->second;
+        }
+        computePermutationRequests.request(key, baseKey, defines);
+        it = computePipelinesRhi.find(baseKey);
+        return it != computePipelinesRhi.end() && it->second.nativeHandle() ? &it->second : nullptr;
+    }
 
     // Samplers
     std::unordered_map<std::string, RhiSamplerHandle> samplersRhi;
@@ -134,17 +199,42 @@ struct PipelineRuntimeContext {
     IUpscalerIntegration* upscaler = nullptr;
     PipelineUiControls* uiControls = nullptr;
 
+    // Flags named by PassDecl::condition, read by the frame graph at every execute.
+    // A pass whose condition is not registered always runs.
+    std::unordered_map<std::string, const bool*> passConditions;
+
     // Resource creation for pass-owned persistent resources
     RhiFrameGraphBackend* resourceFactory = nullptr;
     RhiContext* rhi = nullptr;
 
     // Shared streaming state used by authored update/request/render passes.
     ClusterStreamingService* clusterStreamingService = nullptr;
+    TextureStreamingPool* textureStreamingPool = nullptr;
 
 #ifdef _WIN32
     VulkanReadbackService* readbackService = nullptr;
 #endif
 
+    // Editor click-to-select request and result; ViewportPickPass serves it.
+    ViewportPickState* viewportPick = nullptr;
+
+    // GPU-driven work funnel; main-view MeshletCullPass and VisibilityPass report into it.
+    GpuDrivenTelemetry* gpuDrivenTelemetry = nullptr;
+    // Set while the LOD budget drives the main-view lodReferencePixels.
+    const LodBudgetController* lodBudget = nullptr;
+
     // Vulkan bindless/material indexing rollout toggle.
     bool useBindlessSceneTextures = false;
+
+    // Shaders were built with METALLIC_VISIBILITY_64: the visibility target is
+    // RG32Uint with full-width IDs (see visibility_constants.h).
+    bool visibility64 = false;
+    // Shaders were built with METALLIC_HZB_16: the HZB is R16Float (hzb_constants.h).
+    bool hzb16 = false;
+    // Shaders were built with METALLIC_GPU_DEBUG_MESSAGES: kernels that use
+    // gpu_debug.slang declare the message ring and passes bind and drain it.
+    bool gpuDebugMessages = false;
+    // Shaders were built with METALLIC_INLINE_RAY_QUERY: lighting kernels declare
+    // a TLAS binding and can trace shadow rays themselves.
+    bool inlineRayQuery = false;
 };
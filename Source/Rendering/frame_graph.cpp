@@ -1,8 +1,12 @@
 #include "frame_graph.h"
+#include "cpu_profile_zones.h"
 #include "nsight_markers.h"
+#include "parallel_for.h"
 #include "render_pass.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 
 #include "imgui.h"
 #include <spdlog/spdlog.h>
@@ -41,7 +45,8 @@ bool textureDescMatches(const FGTextureDesc& lhs, const FGTextureDesc& rhs) {
            lhs.height == rhs.height &&
            lhs.format == rhs.format &&
            lhs.usage == rhs.usage &&
-           lhs.storageMode == rhs.storageMode;
+           lhs.storageMode == rhs.storageMode &&
+           lhs.mipLevels == rhs.mipLevels;
 }
 
 uint32_t nsightPassColor(FGPassType type) {
@@ -166,35 +171,59 @@ FGResource FGBuilder::write(FGResource resource, FGResourceUsage usage) {
 }
 
 FGResource FGBuilder::readHistory(const char* name, const FGTextureDesc& desc,
-                                  FGResourceUsage usage) {
-    const uint32_t slotIndex = m_fg.findOrCreateHistorySlot(name, desc);
+                                  FGResourceUsage usage, uint32_t age) {
+    return readHistorySlot(m_fg.findOrCreateHistorySlot(name, desc), usage, age);
+}
+
+FGResource FGBuilder::writeHistory(const char* name, const FGTextureDesc& desc,
+                                   FGResourceUsage usage) {
+    return writeHistorySlot(m_fg.findOrCreateHistorySlot(name, desc), usage);
+}
+
+FGResource FGBuilder::readHistory(const char* name, const FGBufferDesc& desc,
+                                  FGResourceUsage usage, uint32_t age) {
+    return readHistorySlot(m_fg.findOrCreateHistorySlot(name, desc), usage, age);
+}
+
+FGResource FGBuilder::writeHistory(const char* name, const FGBufferDesc& desc,
+                                   FGResourceUsage usage) {
+    return writeHistorySlot(m_fg.findOrCreateHistorySlot(name, desc), usage);
+}
+
+FGResource FGBuilder::readHistorySlot(uint32_t slotIndex, FGResourceUsage usage, uint32_t age) {
+    assert(age >= 1 && "History reads start one frame back");
+    age = std::max(age, 1u);
     auto& slot = m_fg.m_historySlots[slotIndex];
+    slot.depth = std::max(slot.depth, age + 1u);
+    if (slot.readResources.size() < age) {
+        slot.readResources.resize(age, UINT32_MAX);
+    }
 
-    if (slot.readResource == UINT32_MAX) {
+    if (slot.readResources[age - 1u] == UINT32_MAX) {
         FGResource resource;
         resource.id = static_cast<uint32_t>(m_fg.m_resources.size());
 
         FGResourceNode node;
-        node.name = name;
-        node.kind = FGResourceKind::Texture;
-        node.desc = desc;
+        node.name = age == 1u ? slot.name : slot.name + " [-" + std::to_string(age) + "]";
+        node.kind = slot.kind;
+        node.desc = slot.desc;
+        node.bufferDesc = slot.bufferDesc;
         node.imported = true;
         node.historySlot = slotIndex;
+        node.historyAge = age;
         node.historyRead = true;
         node.physicalResource = resource.id;
         m_fg.m_resources.push_back(std::move(node));
-        slot.readResource = resource.id;
+        slot.readResources[age - 1u] = resource.id;
     }
 
     FGResource resource;
-    resource.id = slot.readResource;
+    resource.id = slot.readResources[age - 1u];
     appendUniqueResource(m_fg.m_passes[m_passIndex].reads, resource, usage);
     return resource;
 }
 
-FGResource FGBuilder::writeHistory(const char* name, const FGTextureDesc& desc,
-                                   FGResourceUsage usage) {
-    const uint32_t slotIndex = m_fg.findOrCreateHistorySlot(name, desc);
+FGResource FGBuilder::writeHistorySlot(uint32_t slotIndex, FGResourceUsage usage) {
     auto& slot = m_fg.m_historySlots[slotIndex];
 
     if (slot.writeResource != UINT32_MAX) {
@@ -204,7 +233,7 @@ FGResource FGBuilder::writeHistory(const char* name, const FGTextureDesc& desc,
             const auto& currentPass = m_fg.m_passes[m_passIndex];
             spdlog::warn(
                 "FrameGraph: history slot '{}' already uses writer '{}'; pass '{}' will alias the existing history output",
-                name,
+                slot.name,
                 existingPass.name,
                 currentPass.name);
         }
@@ -218,9 +247,10 @@ FGResource FGBuilder::writeHistory(const char* name, const FGTextureDesc& desc,
     resource.id = static_cast<uint32_t>(m_fg.m_resources.size());
 
     FGResourceNode node;
-    node.name = name;
-    node.kind = FGResourceKind::Texture;
-    node.desc = desc;
+    node.name = slot.name;
+    node.kind = slot.kind;
+    node.desc = slot.desc;
+    node.bufferDesc = slot.bufferDesc;
     node.producer = m_passIndex;
     node.historySlot = slotIndex;
     node.historyWrite = true;
@@ -261,10 +291,20 @@ FGResource FGBuilder::setDepthAttachment(FGResource resource,
     return writeResource;
 }
 
+void FGBuilder::keepDepthAttachmentWhen(std::function<bool()> predicate) {
+    auto& pass = m_fg.m_passes[m_passIndex];
+    assert(pass.depthAttachment.bound);
+    pass.depthAttachment.keepContents = std::move(predicate);
+}
+
 void FGBuilder::setQueueHint(RhiQueueHint hint) {
     m_fg.m_passes[m_passIndex].queueHint = hint;
 }
 
+void FGBuilder::allowParallelRecording() {
+    m_fg.m_passes[m_passIndex].parallelRecording = true;
+}
+
 // --- FrameGraph ---
 
 FGResource FrameGraph::import(const char* name, RhiTexture* texture) {
@@ -320,21 +360,35 @@ void FrameGraph::updateImport(FGResource res, RhiBuffer* buffer) {
     }
 }
 
-void FrameGraph::resetTransients() {
+void FrameGraph::resetTransients(RhiFrameGraphBackend* recycleTo) {
     for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
         auto& res = m_resources[ri];
         if (res.historySlot != UINT32_MAX || res.imported || res.physicalResource != ri) {
             continue;
         }
 
+        // Placed textures and sub-allocated buffers live in this graph's heaps and go
+        // down with them.
         if (res.kind == FGResourceKind::Texture) {
+            if (recycleTo && res.ownedTexture && res.memoryHeap == UINT32_MAX) {
+                recycleTo->recycleTexture(std::move(res.ownedTexture), res.desc);
+            }
             res.ownedTexture.reset();
             res.texture = nullptr;
         } else if (res.kind == FGResourceKind::Buffer) {
+            if (recycleTo && res.ownedBuffer && res.memoryHeap == UINT32_MAX) {
+                recycleTo->recycleBuffer(std::move(res.ownedBuffer), res.bufferDesc);
+            }
             res.ownedBuffer.reset();
             res.buffer = nullptr;
         }
+        res.memoryHeap = UINT32_MAX;
+        res.memoryOffset = 0;
+        res.memorySizeBytes = 0;
+        res.memoryAliased = false;
     }
+    m_transientMemoryStats = {};
+    m_transientsPending = true;
 }
 
 uint32_t FrameGraph::findOrCreateHistorySlot(const char* name, const FGTextureDesc& desc) {
@@ -343,42 +397,389 @@ uint32_t FrameGraph::findOrCreateHistorySlot(const char* name, const FGTextureDe
     const auto existingIt = m_historySlotLookup.find(name);
     if (existingIt != m_historySlotLookup.end()) {
         auto& slot = m_historySlots[existingIt->second];
-        assert(textureDescMatches(slot.desc, desc) && "History resource description mismatch");
+        assert(slot.kind == FGResourceKind::Texture && textureDescMatches(slot.desc, desc) &&
+               "History resource description mismatch");
         return existingIt->second;
     }
 
     const uint32_t slotIndex = static_cast<uint32_t>(m_historySlots.size());
     FGHistorySlot slot;
     slot.name = name;
+    slot.kind = FGResourceKind::Texture;
     slot.desc = desc;
     m_historySlots.push_back(std::move(slot));
     m_historySlotLookup.emplace(name, slotIndex);
     return slotIndex;
 }
 
+uint32_t FrameGraph::findOrCreateHistorySlot(const char* name, const FGBufferDesc& desc) {
+    assert(name != nullptr);
+
+    const auto existingIt = m_historySlotLookup.find(name);
+    if (existingIt != m_historySlotLookup.end()) {
+        auto& slot = m_historySlots[existingIt->second];
+        assert(slot.kind == FGResourceKind::Buffer && slot.bufferDesc.size == desc.size &&
+               slot.bufferDesc.memory == desc.memory &&
+               "History resource description mismatch");
+        return existingIt->second;
+    }
+
+    const uint32_t slotIndex = static_cast<uint32_t>(m_historySlots.size());
+    FGHistorySlot slot;
+    slot.name = name;
+    slot.kind = FGResourceKind::Buffer;
+    slot.bufferDesc = desc;
+    slot.bufferDesc.initialData = nullptr;
+    m_historySlots.push_back(std::move(slot));
+    m_historySlotLookup.emplace(name, slotIndex);
+    return slotIndex;
+}
+
+// Write entry this frame, or the entry written 'historyAge' frames ago.
+uint32_t FrameGraph::historyRingIndex(const FGResourceNode& resource) const {
+    const auto& slot = m_historySlots[resource.historySlot];
+    return resource.historyWrite ? slot.writeIndex
+                                 : (slot.writeIndex + slot.depth - resource.historyAge) % slot.depth;
+}
+
 void FrameGraph::ensureHistoryResources(RhiFrameGraphBackend& backend) {
+    RhiMemoryTagScope historyTag(RhiMemoryTag::History);
     for (auto& slot : m_historySlots) {
         bool reallocated = false;
-        for (auto& texture : slot.textures) {
-            const bool needsCreate =
-                !texture ||
-                texture->width() != slot.desc.width ||
-                texture->height() != slot.desc.height;
-            if (needsCreate) {
-                texture = backend.createTexture(slot.desc);
-                reallocated = true;
+        if (slot.kind == FGResourceKind::Texture) {
+            // A deeper ring changes which entry holds which age, so start over.
+            if (slot.textures.size() != slot.depth) {
+                slot.textures.clear();
+                slot.textures.resize(slot.depth);
+            }
+            for (auto& texture : slot.textures) {
+                const bool needsCreate =
+                    !texture ||
+                    texture->width() != slot.desc.width ||
+                    texture->height() != slot.desc.height;
+                if (needsCreate) {
+                    texture = backend.createTexture(slot.desc);
+                    reallocated = true;
+                }
+            }
+        } else {
+            if (slot.buffers.size() != slot.depth) {
+                slot.buffers.clear();
+                slot.buffers.resize(slot.depth);
+            }
+            for (auto& buffer : slot.buffers) {
+                if (!buffer || buffer->size() != slot.bufferDesc.size) {
+                    buffer = backend.createBuffer(slot.bufferDesc);
+                    reallocated = true;
+                }
             }
         }
 
         if (reallocated) {
-            slot.readIndex = 0;
-            slot.valid = false;
+            slot.writeIndex = 0;
+            slot.committedFrames = 0;
         }
 
         slot.writtenThisFrame = false;
     }
 }
 
+void FrameGraph::computeTransientLifetimes(std::vector<uint32_t>& firstPass,
+                                           std::vector<uint32_t>& lastPass,
+                                           std::vector<uint8_t>& aliasable) const {
+    firstPass.assign(m_resources.size(), UINT32_MAX);
+    lastPass.assign(m_resources.size(), 0u);
+    aliasable.assign(m_resources.size(), 0u);
+
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        aliasable[ri] = res.kind == FGResourceKind::Texture &&
+                        res.desc.storageMode == RhiTextureStorageMode::Private &&
+                        !res.imported &&
+                        res.historySlot == UINT32_MAX &&
+                        res.physicalResource == ri &&
+                        res.producer != UINT32_MAX &&
+                        m_passMayRun[res.producer] != 0u;
+    }
+    // Versions share their root's memory, so the root lives until the last user of any version.
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        const uint32_t root = res.physicalResource != UINT32_MAX ? res.physicalResource : ri;
+        if (res.exported || res.imported) {
+            aliasable[root] = 0u;
+        }
+    }
+    // A bypass source is also read wherever its output is, in states placement never saw.
+    for (const auto& pass : m_passes) {
+        for (const auto& bypass : pass.bypasses) {
+            const auto& source = m_resources[bypass.source];
+            aliasable[source.physicalResource != UINT32_MAX ? source.physicalResource : bypass.source] = 0u;
+        }
+    }
+
+    // Placement has to hold in every condition state, so lifetimes cover every pass
+    // that may run, and a render pass may merge with any neighbouring render pass.
+    std::vector<uint32_t> renderRunFirst;
+    std::vector<uint32_t> renderRunLast;
+    if (m_hasConditionalPasses) {
+        renderRunFirst.assign(m_passes.size(), UINT32_MAX);
+        renderRunLast.assign(m_passes.size(), UINT32_MAX);
+        uint32_t runFirst = UINT32_MAX;
+        uint32_t previous = UINT32_MAX;
+        auto closeRun = [&](uint32_t last) {
+            for (uint32_t pi = runFirst; pi != UINT32_MAX && pi <= last; ++pi) {
+                renderRunFirst[pi] = runFirst;
+                renderRunLast[pi] = last;
+            }
+            runFirst = UINT32_MAX;
+        };
+        for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+            if (m_passMayRun[pi] == 0u) {
+                continue;
+            }
+            if (m_passes[pi].type != FGPassType::Render) {
+                closeRun(previous);
+            } else if (runFirst == UINT32_MAX) {
+                runFirst = pi;
+            }
+            previous = pi;
+        }
+        closeRun(previous);
+    }
+
+    // Passes of a merged render pass prepare before any of them draws, so each one
+    // keeps its resources alive across the whole merged span.
+    auto touch = [&](uint32_t resourceId, uint32_t passIndex, bool asyncQueue) {
+        const auto& res = m_resources[resourceId];
+        const uint32_t root = res.physicalResource != UINT32_MAX ? res.physicalResource : resourceId;
+        uint32_t spanFirst = passIndex;
+        uint32_t spanLast = passIndex;
+        if (m_hasConditionalPasses) {
+            if (renderRunFirst[passIndex] != UINT32_MAX) {
+                spanFirst = renderRunFirst[passIndex];
+                spanLast = renderRunLast[passIndex];
+            }
+        } else if (m_passMergedRenderPass[passIndex] != UINT32_MAX) {
+            const FGMergedRenderPass& merged = m_mergedRenderPasses[m_passMergedRenderPass[passIndex]];
+            spanFirst = m_compiledPasses[merged.first];
+            spanLast = m_compiledPasses[merged.first + merged.count - 1u];
+        }
+        firstPass[root] = std::min(firstPass[root], spanFirst);
+        lastPass[root] = std::max(lastPass[root], spanLast);
+        // Pass order says nothing about overlap with work on another queue.
+        if (asyncQueue) {
+            aliasable[root] = 0u;
+        }
+    };
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        const auto& pass = m_passes[pi];
+        if (m_passMayRun[pi] == 0u) continue;
+        const bool asyncQueue = pass.queueHint == RhiQueueHint::AsyncCompute ||
+                                pass.queueHint == RhiQueueHint::Transfer;
+        for (const auto& read : pass.reads) {
+            touch(read.resource.id, pi, asyncQueue);
+        }
+        for (const auto& write : pass.writes) {
+            touch(write.resource.id, pi, asyncQueue);
+        }
+    }
+}
+
+// A transient render target that only ever serves as an attachment of one render pass,
+// without loading earlier contents, never needs to leave tile memory. recordPass() drops
+// its store so the backend can keep it memoryless. The passes of a merged render pass
+// count as one, and only the first of them may not load.
+void FrameGraph::selectMemorylessTransients(RhiFrameGraphBackend& backend) {
+    m_transientMemoryStats.memorylessTextureCount = 0;
+    // Which render pass an attachment belongs to changes with the condition state.
+    if (!backend.supportsMemorylessTextures() || m_hasConditionalPasses) {
+        return;
+    }
+
+    constexpr uint32_t kNoPass = UINT32_MAX;
+    std::vector<uint8_t> candidate(m_resources.size(), 0u);
+    std::vector<uint32_t> onlyPass(m_resources.size(), kNoPass);
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        candidate[ri] = res.kind == FGResourceKind::Texture &&
+                        (res.desc.storageMode == RhiTextureStorageMode::Private || res.memoryless) &&
+                        (res.texture == nullptr || res.memoryless) &&
+                        !res.imported &&
+                        res.historySlot == UINT32_MAX &&
+                        res.physicalResource == ri &&
+                        res.producer != UINT32_MAX;
+    }
+    auto rootOf = [&](uint32_t id) {
+        return m_resources[id].physicalResource != UINT32_MAX ? m_resources[id].physicalResource : id;
+    };
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        if (m_resources[ri].exported || m_resources[ri].imported) {
+            candidate[rootOf(ri)] = 0u;
+        }
+    }
+
+    const FGResourceUsage attachmentUsage = FGResourceUsage::ColorAttachment | FGResourceUsage::DepthAttachment;
+    for (uint32_t pi : m_compiledPasses) {
+        const auto& pass = m_passes[pi];
+        uint32_t renderPass = pi;
+        if (m_passMergedRenderPass[pi] != UINT32_MAX) {
+            renderPass = m_compiledPasses[m_mergedRenderPasses[m_passMergedRenderPass[pi]].first];
+        }
+        auto visit = [&](const FGAccessEntry& access) {
+            const uint32_t root = rootOf(access.resource.id);
+            if (!candidate[root]) {
+                return;
+            }
+            const bool attachmentOnly =
+                static_cast<uint32_t>(access.usage & attachmentUsage) == static_cast<uint32_t>(access.usage);
+            if (pass.type != FGPassType::Render || !attachmentOnly ||
+                (onlyPass[root] != kNoPass && onlyPass[root] != renderPass)) {
+                candidate[root] = 0u;
+            }
+            onlyPass[root] = renderPass;
+        };
+        for (const auto& read : pass.reads) {
+            visit(read);
+        }
+        for (const auto& write : pass.writes) {
+            visit(write);
+        }
+        if (renderPass != pi) {
+            continue;
+        }
+        for (uint32_t ci = 0; ci < pass.colorAttachmentCount; ++ci) {
+            if (pass.colorAttachments[ci].loadAction == RhiLoadAction::Load) {
+                candidate[rootOf(pass.colorAttachments[ci].resource.id)] = 0u;
+            }
+        }
+        if (pass.depthAttachment.bound && pass.depthAttachment.loadAction == RhiLoadAction::Load) {
+            candidate[rootOf(pass.depthAttachment.resource.id)] = 0u;
+        }
+    }
+
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        auto& res = m_resources[ri];
+        if (!candidate[ri] || onlyPass[ri] == kNoPass) {
+            continue;
+        }
+        res.memoryless = true;
+        res.desc.storageMode = RhiTextureStorageMode::Memoryless;
+        res.desc.usage = RhiTextureUsage::RenderTarget;
+        ++m_transientMemoryStats.memorylessTextureCount;
+    }
+    if (m_transientMemoryStats.memorylessTextureCount > 0) {
+        spdlog::info("FrameGraph: {} transient attachments kept in tile memory",
+                     m_transientMemoryStats.memorylessTextureCount);
+    }
+}
+
+// Placement uses the lifetimes from the compile that preceded the first execute; the
+// graph is rebuilt (and its transients released) whenever the pass list changes.
+void FrameGraph::allocatePlacedTransients(RhiFrameGraphBackend& backend) {
+    if (!m_transientAliasingEnabled) {
+        return;
+    }
+
+    std::vector<uint32_t> firstPass;
+    std::vector<uint32_t> lastPass;
+    std::vector<uint8_t> aliasable;
+    computeTransientLifetimes(firstPass, lastPass, aliasable);
+
+    std::vector<uint32_t> resourceIds;
+    std::vector<RhiTransientTextureRequest> requests;
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        if (!aliasable[ri] || res.texture != nullptr || firstPass[ri] == UINT32_MAX) {
+            continue;
+        }
+        RhiTransientTextureRequest request;
+        request.desc = res.desc;
+        request.firstPass = firstPass[ri];
+        request.lastPass = lastPass[ri];
+        requests.push_back(std::move(request));
+        resourceIds.push_back(ri);
+    }
+    if (requests.size() < 2) {
+        return;
+    }
+
+    uint64_t heapBytes = 0;
+    if (!backend.createPlacedTextures(requests, heapBytes)) {
+        return;
+    }
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto& res = m_resources[resourceIds[i]];
+        auto& request = requests[i];
+        res.ownedTexture = std::move(request.texture);
+        res.texture = res.ownedTexture.get();
+        res.memoryHeap = request.heapIndex;
+        res.memoryOffset = request.heapOffset;
+        res.memorySizeBytes = request.sizeBytes;
+        res.memoryAliased = request.aliased;
+
+        ++m_transientMemoryStats.placedTextureCount;
+        m_transientMemoryStats.aliasedTextureCount += request.aliased ? 1u : 0u;
+        m_transientMemoryStats.requestedBytes += request.sizeBytes;
+    }
+    m_transientMemoryStats.heapBytes += heapBytes;
+    spdlog::info("FrameGraph: placed {} transient textures ({} aliased) in {:.1f} MB instead of {:.1f} MB",
+                 requests.size(),
+                 m_transientMemoryStats.aliasedTextureCount,
+                 double(heapBytes) / (1024.0 * 1024.0),
+                 double(m_transientMemoryStats.requestedBytes) / (1024.0 * 1024.0));
+}
+
+// Buffers are not aliased: several passes keep counters and worklists across the frame,
+// so packing them back to back already removes the per-buffer allocations.
+void FrameGraph::allocateSubAllocatedBuffers(RhiFrameGraphBackend& backend) {
+    if (!m_transientBufferHeapEnabled) {
+        return;
+    }
+
+    std::vector<uint32_t> resourceIds;
+    std::vector<RhiTransientBufferRequest> requests;
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        if (res.kind != FGResourceKind::Buffer || res.imported || res.historySlot != UINT32_MAX ||
+            res.physicalResource != ri || res.buffer != nullptr || res.producer == UINT32_MAX ||
+            m_passes[res.producer].refCount == 0 || !res.bufferDesc.subAllocate || res.bufferDesc.sharedWithTransferQueue ||
+            res.bufferDesc.size == 0) {
+            continue;
+        }
+        RhiTransientBufferRequest request;
+        request.desc = res.bufferDesc;
+        requests.push_back(std::move(request));
+        resourceIds.push_back(ri);
+    }
+    if (requests.size() < 2) {
+        return;
+    }
+
+    uint64_t heapBytes = 0;
+    if (!backend.createSubAllocatedBuffers(requests, heapBytes)) {
+        return;
+    }
+
+    uint64_t requestedBytes = 0;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto& res = m_resources[resourceIds[i]];
+        auto& request = requests[i];
+        res.ownedBuffer = std::move(request.buffer);
+        res.buffer = res.ownedBuffer.get();
+        res.memoryHeap = request.heapIndex;
+        res.memoryOffset = request.heapOffset;
+        res.memorySizeBytes = request.sizeBytes;
+        requestedBytes += request.sizeBytes;
+    }
+    m_transientMemoryStats.subAllocatedBufferCount = static_cast<uint32_t>(requests.size());
+    m_transientMemoryStats.bufferHeapBytes = heapBytes;
+    spdlog::info("FrameGraph: sub-allocated {} transient buffers from {:.1f} MB of heaps ({:.1f} MB requested)",
+                 requests.size(),
+                 double(heapBytes) / (1024.0 * 1024.0),
+                 double(requestedBytes) / (1024.0 * 1024.0));
+}
+
 void FrameGraph::addPass(std::unique_ptr<RenderPass> pass) {
     RenderPass* passPtr = pass.get();
     m_ownedPasses.push_back(std::move(pass));
@@ -410,7 +811,57 @@ void FrameGraph::addPass(std::unique_ptr<RenderPass> pass) {
     };
 }
 
-void FrameGraph::compile() {
+void FrameGraph::setPassCondition(uint32_t passIndex, std::function<bool()> condition) {
+    assert(passIndex < m_passes.size());
+    m_passes[passIndex].condition = std::move(condition);
+    m_hasConditionalPasses = m_hasConditionalPasses || m_passes[passIndex].condition != nullptr;
+}
+
+void FrameGraph::setPassBypass(uint32_t passIndex, FGResource output, FGResource source) {
+    assert(passIndex < m_passes.size());
+    assert(output.isValid() && output.id < m_resources.size());
+    assert(source.isValid() && source.id < m_resources.size());
+    const auto& outputNode = m_resources[output.id];
+    const uint32_t root = outputNode.physicalResource != UINT32_MAX ? outputNode.physicalResource : output.id;
+    // Redirecting a version written in place would redirect the resource it extends.
+    if (m_resources[root].producer != passIndex || m_resources[root].kind != m_resources[source.id].kind) {
+        spdlog::warn("FrameGraph: pass '{}' cannot bypass '{}' with '{}'; it keeps the previous version",
+                     m_passes[passIndex].name,
+                     outputNode.name,
+                     m_resources[source.id].name);
+        return;
+    }
+    m_passes[passIndex].bypasses.push_back({root, source.id});
+}
+
+bool FrameGraph::passConditionsChanged() const {
+    if (!m_hasConditionalPasses) {
+        return false;
+    }
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        const auto& condition = m_passes[pi].condition;
+        if (condition && (condition() ? 1u : 0u) != m_passConditionOpen[pi]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t FrameGraph::physicalRoot(uint32_t resourceId) const {
+    uint32_t root = m_resources[resourceId].physicalResource != UINT32_MAX
+                        ? m_resources[resourceId].physicalResource
+                        : resourceId;
+    while (m_resources[root].bypassSource != UINT32_MAX) {
+        const uint32_t source = m_resources[root].bypassSource;
+        root = m_resources[source].physicalResource != UINT32_MAX ? m_resources[source].physicalResource : source;
+    }
+    return root;
+}
+
+// Reference-counts from side effects, exports and history writes back through the
+// passes. With conditions applied, a culled pass's outputs forward to their bypass
+// source, or to the version they overwrote.
+void FrameGraph::markLivePasses(bool applyConditions) {
     for (auto& pass : m_passes) {
         pass.refCount = 0;
     }
@@ -422,6 +873,10 @@ void FrameGraph::compile() {
     std::vector<uint32_t> livePasses;
     livePasses.reserve(m_passes.size());
 
+    auto passCulled = [&](uint32_t passIndex) {
+        return applyConditions && m_passConditionOpen[passIndex] == 0u;
+    };
+
     auto addPassRef = [&](uint32_t passIndex) {
         assert(passIndex < m_passes.size());
         auto& pass = m_passes[passIndex];
@@ -433,16 +888,26 @@ void FrameGraph::compile() {
     };
 
     auto addResourceRef = [&](uint32_t resourceIndex) {
-        assert(resourceIndex < m_resources.size());
-        auto& resource = m_resources[resourceIndex];
-        ++resource.refCount;
-        if (resource.producer != UINT32_MAX) {
-            addPassRef(resource.producer);
+        while (resourceIndex != UINT32_MAX) {
+            assert(resourceIndex < m_resources.size());
+            auto& resource = m_resources[resourceIndex];
+            ++resource.refCount;
+            if (resource.producer == UINT32_MAX) {
+                return;
+            }
+            if (!passCulled(resource.producer)) {
+                addPassRef(resource.producer);
+                return;
+            }
+            const uint32_t root =
+                resource.physicalResource != UINT32_MAX ? resource.physicalResource : resourceIndex;
+            resourceIndex = m_resources[root].bypassSource != UINT32_MAX ? m_resources[root].bypassSource
+                                                                          : resource.previousVersion;
         }
     };
 
     for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
-        if (m_passes[pi].hasSideEffect) {
+        if (m_passes[pi].hasSideEffect && !passCulled(pi)) {
             addPassRef(pi);
         }
     }
@@ -465,6 +930,12 @@ void FrameGraph::compile() {
         for (const auto& read : pass.reads) {
             addResourceRef(read.resource.id);
         }
+        // Without conditions this is the set of passes any condition state can run.
+        if (!applyConditions) {
+            for (const auto& bypass : pass.bypasses) {
+                addResourceRef(bypass.source);
+            }
+        }
     }
 
     for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
@@ -479,6 +950,412 @@ void FrameGraph::compile() {
     }
 }
 
+void FrameGraph::compile() {
+    for (auto& res : m_resources) {
+        res.bypassSource = UINT32_MAX;
+    }
+    markLivePasses(false);
+    m_passMayRun.assign(m_passes.size(), 0u);
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        m_passMayRun[pi] = m_passes[pi].refCount > 0 ? 1u : 0u;
+    }
+
+    m_passConditionOpen.assign(m_passes.size(), 1u);
+    if (m_hasConditionalPasses) {
+        for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+            const auto& pass = m_passes[pi];
+            if (!pass.condition || pass.condition()) {
+                continue;
+            }
+            m_passConditionOpen[pi] = 0u;
+            for (const auto& bypass : pass.bypasses) {
+                m_resources[bypass.output].bypassSource = bypass.source;
+            }
+        }
+        markLivePasses(true);
+    }
+
+    // The graph only changes through a rebuild or a condition flip, so execute() walks
+    // these lists every frame instead of rescanning all resources per pass.
+    m_compiledPasses.clear();
+    m_passTransients.assign(m_passes.size(), {});
+    m_passCpuRecordMs.assign(m_passes.size(), 0.0f);
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        if (m_passes[pi].refCount > 0) {
+            m_compiledPasses.push_back(pi);
+        }
+    }
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        const auto& res = m_resources[ri];
+        if (res.historySlot != UINT32_MAX ||
+            res.imported ||
+            res.producer == UINT32_MAX ||
+            res.physicalResource != ri ||
+            res.kind == FGResourceKind::Token) {
+            continue;
+        }
+        m_passTransients[res.producer].push_back(ri);
+    }
+    m_transientsPending = true;
+
+    m_passPrepareSteps.assign(m_passes.size(), {});
+    for (uint32_t pi : m_compiledPasses) {
+        buildPrepareSteps(pi);
+    }
+    scheduleQueues();
+    mergeRenderPasses();
+}
+
+// Compute passes hinted AsyncCompute run on the async queue. Every physical resource
+// starts and ends the frame on the graphics queue; a pass that touches a resource last
+// used on the other queue gets a handoff, which the backend turns into a semaphore wait
+// and an ownership transfer. Resources a pass binds without declaring them are not seen
+// here, so only passes that declare everything they touch should request async compute.
+void FrameGraph::scheduleQueues() {
+    m_passAsyncCompute.assign(m_passes.size(), 0u);
+    m_passQueueHandoffs.assign(m_passes.size(), {});
+    m_finalQueueHandoff = {};
+    m_finalQueueHandoff.fromAsyncCompute = true;
+
+    std::vector<uint8_t> onAsyncQueue(m_resources.size(), 0u);
+    for (uint32_t pi : m_compiledPasses) {
+        const auto& pass = m_passes[pi];
+        bool asyncCompute = pass.queueHint == RhiQueueHint::AsyncCompute;
+        if (asyncCompute && pass.type != FGPassType::Compute) {
+            spdlog::warn("FrameGraph: pass '{}' requests async compute but is not a compute pass; "
+                         "keeping it on the graphics queue",
+                         pass.name);
+            asyncCompute = false;
+        }
+        m_passAsyncCompute[pi] = asyncCompute ? 1u : 0u;
+
+        FGQueueHandoff& handoff = m_passQueueHandoffs[pi];
+        handoff.fromAsyncCompute = !asyncCompute;
+        auto visit = [&](const FGAccessEntry& access) {
+            const uint32_t root = physicalRoot(access.resource.id);
+            if (m_resources[root].kind == FGResourceKind::Token ||
+                onAsyncQueue[root] == m_passAsyncCompute[pi]) {
+                return;
+            }
+            onAsyncQueue[root] = m_passAsyncCompute[pi];
+            handoff.resources.push_back(root);
+        };
+        for (const auto& read : pass.reads) {
+            visit(read);
+        }
+        for (const auto& write : pass.writes) {
+            visit(write);
+        }
+    }
+
+    for (uint32_t ri = 0; ri < m_resources.size(); ++ri) {
+        if (onAsyncQueue[ri] != 0u) {
+            m_finalQueueHandoff.resources.push_back(ri);
+        }
+    }
+}
+
+// A render pass joins the one before it when it binds the same attachments and loads all
+// of them, so the earlier store and this load can both go. It may not read anything the
+// merged passes wrote other than through those attachments, nor write anything they
+// touched: either would need a barrier or a tile-local read inside the render pass.
+// Passes behind a queue handoff start a new render pass.
+void FrameGraph::mergeRenderPasses() {
+    m_mergedRenderPasses.clear();
+    m_passMergedRenderPass.assign(m_passes.size(), UINT32_MAX);
+    if (!m_renderPassMergingEnabled) {
+        return;
+    }
+
+    constexpr uint8_t kRead = 1u;
+    constexpr uint8_t kWritten = 2u;
+    std::vector<uint8_t> runAccess(m_resources.size(), 0u);
+    std::vector<uint32_t> runResources;
+    const FGResourceUsage attachmentUsage = FGResourceUsage::ColorAttachment | FGResourceUsage::DepthAttachment;
+
+    auto rootOf = [&](uint32_t id) {
+        return physicalRoot(id);
+    };
+    auto attachmentOnly = [&](const FGAccessEntry& access) {
+        return static_cast<uint32_t>(access.usage & attachmentUsage) == static_cast<uint32_t>(access.usage);
+    };
+    auto continuesAttachments = [&](const FGPassNode& previous, const FGPassNode& pass) {
+        if (previous.colorAttachmentCount != pass.colorAttachmentCount ||
+            previous.depthAttachment.bound != pass.depthAttachment.bound ||
+            (pass.colorAttachmentCount == 0 && !pass.depthAttachment.bound)) {
+            return false;
+        }
+        for (uint32_t ci = 0; ci < pass.colorAttachmentCount; ++ci) {
+            if (rootOf(previous.colorAttachments[ci].resource.id) != rootOf(pass.colorAttachments[ci].resource.id) ||
+                pass.colorAttachments[ci].loadAction != RhiLoadAction::Load) {
+                return false;
+            }
+        }
+        return !pass.depthAttachment.bound ||
+               (rootOf(previous.depthAttachment.resource.id) == rootOf(pass.depthAttachment.resource.id) &&
+                pass.depthAttachment.loadAction == RhiLoadAction::Load);
+    };
+    auto conflictsWithRun = [&](const FGPassNode& pass) {
+        for (const auto& read : pass.reads) {
+            if (!attachmentOnly(read) && (runAccess[rootOf(read.resource.id)] & kWritten) != 0u) {
+                return true;
+            }
+        }
+        for (const auto& write : pass.writes) {
+            if (!attachmentOnly(write) && runAccess[rootOf(write.resource.id)] != 0u) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto addToRun = [&](const FGPassNode& pass) {
+        auto mark = [&](uint32_t id, uint8_t access) {
+            const uint32_t root = rootOf(id);
+            if (runAccess[root] == 0u) {
+                runResources.push_back(root);
+            }
+            runAccess[root] |= access;
+        };
+        for (const auto& read : pass.reads) {
+            mark(read.resource.id, kRead);
+        }
+        for (const auto& write : pass.writes) {
+            mark(write.resource.id, kWritten);
+        }
+    };
+    uint32_t runFirst = 0;
+    auto closeRun = [&](uint32_t end) {
+        for (uint32_t ri : runResources) {
+            runAccess[ri] = 0u;
+        }
+        runResources.clear();
+        if (end - runFirst < 2u) {
+            return;
+        }
+        FGMergedRenderPass merged;
+        merged.first = runFirst;
+        merged.count = end - runFirst;
+        for (uint32_t position = runFirst; position < end; ++position) {
+            const uint32_t pi = m_compiledPasses[position];
+            if (!merged.label.empty()) {
+                merged.label += " + ";
+            }
+            merged.label += m_passes[pi].name;
+            m_passMergedRenderPass[pi] = static_cast<uint32_t>(m_mergedRenderPasses.size());
+        }
+        m_mergedRenderPasses.push_back(std::move(merged));
+    };
+
+    for (uint32_t position = 0; position < m_compiledPasses.size(); ++position) {
+        const uint32_t pi = m_compiledPasses[position];
+        const auto& pass = m_passes[pi];
+        bool joins = false;
+        if (position > runFirst && pass.type == FGPassType::Render) {
+            const uint32_t previousIndex = m_compiledPasses[position - 1u];
+            const auto& previous = m_passes[previousIndex];
+            // Transient placement assumes merges never reach across a culled pass.
+            const bool adjacent =
+                !m_hasConditionalPasses ||
+                std::none_of(m_passMayRun.begin() + previousIndex + 1, m_passMayRun.begin() + pi,
+                             [](uint8_t mayRun) { return mayRun != 0u; });
+            joins = adjacent &&
+                    previous.type == FGPassType::Render &&
+                    m_passQueueHandoffs[pi].resources.empty() &&
+                    continuesAttachments(previous, pass) &&
+                    !conflictsWithRun(pass);
+        }
+        if (!joins) {
+            closeRun(position);
+            runFirst = position;
+        }
+        addToRun(pass);
+    }
+    closeRun(static_cast<uint32_t>(m_compiledPasses.size()));
+}
+
+// Groups consecutive passes that allow parallel recording into batches whose passes share
+// no physical resource that one of them writes; tokens count, since they stand for
+// undeclared dependencies. Passes with queue handoffs or on async compute record alone,
+// and a pass producing an aliased transient may only start a batch because its discard
+// must follow all earlier work. A merged render pass is always a batch of its own.
+void FrameGraph::buildRecordingBatches() {
+    m_recordingBatches.clear();
+    constexpr uint8_t kRead = 1u;
+    constexpr uint8_t kWritten = 2u;
+    std::vector<uint8_t> batchAccess(m_resources.size(), 0u);
+    std::vector<uint32_t> batchResources;
+
+    auto rootOf = [&](uint32_t id) {
+        return physicalRoot(id);
+    };
+    auto producesAliasedTransient = [&](uint32_t pi) {
+        return std::any_of(m_passTransients[pi].begin(), m_passTransients[pi].end(), [&](uint32_t ri) {
+            return m_resources[ri].memoryAliased;
+        });
+    };
+    auto conflictsWithBatch = [&](const FGPassNode& pass) {
+        for (const auto& read : pass.reads) {
+            if ((batchAccess[rootOf(read.resource.id)] & kWritten) != 0u) {
+                return true;
+            }
+        }
+        for (const auto& write : pass.writes) {
+            if (batchAccess[rootOf(write.resource.id)] != 0u) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto addToBatch = [&](const FGPassNode& pass) {
+        auto mark = [&](uint32_t id, uint8_t access) {
+            const uint32_t root = rootOf(id);
+            if (batchAccess[root] == 0u) {
+                batchResources.push_back(root);
+            }
+            batchAccess[root] |= access;
+        };
+        for (const auto& read : pass.reads) {
+            mark(read.resource.id, kRead);
+        }
+        for (const auto& write : pass.writes) {
+            mark(write.resource.id, kWritten);
+        }
+    };
+
+    bool batchOpen = false;
+    for (uint32_t position = 0; position < m_compiledPasses.size(); ++position) {
+        const uint32_t pi = m_compiledPasses[position];
+        const auto& pass = m_passes[pi];
+        if (m_passMergedRenderPass[pi] != UINT32_MAX) {
+            const FGMergedRenderPass& merged = m_mergedRenderPasses[m_passMergedRenderPass[pi]];
+            for (uint32_t ri : batchResources) {
+                batchAccess[ri] = 0u;
+            }
+            batchResources.clear();
+            m_recordingBatches.push_back({position, merged.count, true});
+            position += merged.count - 1u;
+            batchOpen = false;
+            continue;
+        }
+        const bool parallel = pass.parallelRecording &&
+                              m_passAsyncCompute[pi] == 0u &&
+                              m_passQueueHandoffs[pi].resources.empty();
+        if (batchOpen && parallel && !producesAliasedTransient(pi) && !conflictsWithBatch(pass)) {
+            ++m_recordingBatches.back().count;
+        } else {
+            for (uint32_t ri : batchResources) {
+                batchAccess[ri] = 0u;
+            }
+            batchResources.clear();
+            m_recordingBatches.push_back({position, 1u});
+            batchOpen = parallel;
+        }
+        if (batchOpen) {
+            addToBatch(pass);
+        }
+    }
+}
+
+// Translates declared usage into the transitions the backend needs before the pass.
+// Attachment usage is left to beginRenderPass. A texture written as storage in the
+// same pass only needs the GENERAL transition, and a buffer written as storage does
+// not also need a read transition.
+void FrameGraph::buildPrepareSteps(uint32_t passIndex) {
+    const auto& pass = m_passes[passIndex];
+    auto& steps = m_passPrepareSteps[passIndex];
+
+    auto addStep = [&](uint32_t resourceId, FGPrepareOp op) {
+        const auto it = std::find_if(steps.begin(), steps.end(), [&](const FGPrepareStep& step) {
+            return step.resource == resourceId && step.op == op;
+        });
+        if (it == steps.end()) {
+            steps.push_back({resourceId, op});
+        }
+    };
+
+    for (const auto& read : pass.reads) {
+        const uint32_t id = read.resource.id;
+        const auto kind = m_resources[id].kind;
+        if (kind == FGResourceKind::Texture) {
+            if (hasUsage(read.usage, FGResourceUsage::Sampled)) {
+                addStep(id, FGPrepareOp::SampleTexture);
+            }
+            if (hasUsage(read.usage, FGResourceUsage::StorageRead)) {
+                addStep(id, FGPrepareOp::StorageTexture);
+            }
+            if (hasUsage(read.usage, FGResourceUsage::TransferSrc)) {
+                addStep(id, FGPrepareOp::TransferSrcTexture);
+            }
+        } else if (kind == FGResourceKind::Buffer) {
+            if (hasUsage(read.usage, FGResourceUsage::StorageWrite)) {
+                addStep(id, FGPrepareOp::StorageWriteBuffer);
+            } else if (hasUsage(read.usage, FGResourceUsage::StorageRead)) {
+                addStep(id, FGPrepareOp::StorageReadBuffer);
+            }
+            if (hasUsage(read.usage, FGResourceUsage::Indirect)) {
+                addStep(id, FGPrepareOp::IndirectBuffer);
+            }
+            if (hasUsage(read.usage, FGResourceUsage::VertexInput)) {
+                addStep(id, FGPrepareOp::VertexBuffer);
+            }
+            if (hasUsage(read.usage, FGResourceUsage::IndexInput)) {
+                addStep(id, FGPrepareOp::IndexBuffer);
+            }
+        }
+    }
+
+    for (const auto& write : pass.writes) {
+        const uint32_t id = write.resource.id;
+        const auto kind = m_resources[id].kind;
+        const bool storage = hasUsage(write.usage, FGResourceUsage::StorageWrite) ||
+                             hasUsage(write.usage, FGResourceUsage::StorageRead);
+        if (kind == FGResourceKind::Texture) {
+            if (storage) {
+                addStep(id, FGPrepareOp::StorageTexture);
+            }
+            if (hasUsage(write.usage, FGResourceUsage::TransferDst)) {
+                addStep(id, FGPrepareOp::TransferDstTexture);
+            }
+        } else if (kind == FGResourceKind::Buffer && storage) {
+            addStep(id, FGPrepareOp::StorageWriteBuffer);
+        }
+    }
+
+    // Versions of one texture resolve to the same image; compare physical roots.
+    auto rootOf = [&](uint32_t resourceId) {
+        return physicalRoot(resourceId);
+    };
+    std::vector<uint32_t> storageTextureRoots;
+    std::vector<uint32_t> storageWriteBuffers;
+    for (const FGPrepareStep& step : steps) {
+        if (step.op == FGPrepareOp::StorageTexture) {
+            storageTextureRoots.push_back(rootOf(step.resource));
+        } else if (step.op == FGPrepareOp::StorageWriteBuffer) {
+            storageWriteBuffers.push_back(rootOf(step.resource));
+        }
+    }
+    steps.erase(std::remove_if(steps.begin(), steps.end(), [&](const FGPrepareStep& step) {
+        const uint32_t root = rootOf(step.resource);
+        if (step.op == FGPrepareOp::SampleTexture) {
+            return std::find(storageTextureRoots.begin(), storageTextureRoots.end(), root) !=
+                   storageTextureRoots.end();
+        }
+        if (step.op == FGPrepareOp::StorageReadBuffer) {
+            return std::find(storageWriteBuffers.begin(), storageWriteBuffers.end(), root) !=
+                   storageWriteBuffers.end();
+        }
+        return false;
+    }), steps.end());
+    // The same image reached through two versions still only needs one transition.
+    for (size_t i = 0; i < steps.size(); ++i) {
+        for (size_t j = steps.size(); j-- > i + 1;) {
+            if (steps[j].op == steps[i].op && rootOf(steps[j].resource) == rootOf(steps[i].resource)) {
+                steps.erase(steps.begin() + static_cast<std::ptrdiff_t>(j));
+            }
+        }
+    }
+}
+
 RhiTexture* FrameGraph::getTexture(FGResource res) const {
     assert(res.isValid() && res.id < m_resources.size());
     return resolveTexture(res.id);
@@ -499,7 +1376,9 @@ bool FrameGraph::isHistoryValid(FGResource res) const {
         return false;
     }
 
-    return m_historySlots[resource.historySlot].valid;
+    // A write is valid when the previous frame's result exists, like an age-1 read.
+    const uint32_t age = resource.historyWrite ? 1u : resource.historyAge;
+    return m_historySlots[resource.historySlot].committedFrames >= age;
 }
 
 void FrameGraph::commitHistory(FGResource res) {
@@ -522,13 +1401,16 @@ RhiTexture* FrameGraph::resolveTexture(uint32_t resourceId) const {
 
     if (resource.historySlot != UINT32_MAX) {
         const auto& slot = m_historySlots[resource.historySlot];
-        const uint32_t textureIndex = resource.historyWrite ? (1u - slot.readIndex) : slot.readIndex;
-        return slot.textures[textureIndex].get();
+        const uint32_t ringIndex = historyRingIndex(resource);
+        return ringIndex < slot.textures.size() ? slot.textures[ringIndex].get() : nullptr;
     }
 
     const uint32_t physicalResource =
         resource.physicalResource != UINT32_MAX ? resource.physicalResource : resourceId;
     assert(physicalResource < m_resources.size());
+    if (m_resources[physicalResource].bypassSource != UINT32_MAX) {
+        return resolveTexture(m_resources[physicalResource].bypassSource);
+    }
     assert(m_resources[physicalResource].kind == FGResourceKind::Texture);
     return m_resources[physicalResource].texture;
 }
@@ -538,172 +1420,285 @@ RhiBuffer* FrameGraph::resolveBuffer(uint32_t resourceId) const {
     const auto& resource = m_resources[resourceId];
     assert(resource.kind == FGResourceKind::Buffer);
 
+    if (resource.historySlot != UINT32_MAX) {
+        const auto& slot = m_historySlots[resource.historySlot];
+        const uint32_t ringIndex = historyRingIndex(resource);
+        return ringIndex < slot.buffers.size() ? slot.buffers[ringIndex].get() : nullptr;
+    }
+
     const uint32_t physicalResource =
         resource.physicalResource != UINT32_MAX ? resource.physicalResource : resourceId;
     assert(physicalResource < m_resources.size());
+    if (m_resources[physicalResource].bypassSource != UINT32_MAX) {
+        return resolveBuffer(m_resources[physicalResource].bypassSource);
+    }
     assert(m_resources[physicalResource].kind == FGResourceKind::Buffer);
     return m_resources[physicalResource].buffer;
 }
 
 void FrameGraph::execute(RhiCommandBuffer& commandBuffer, RhiFrameGraphBackend& backend) {
-    MICROPROFILE_SCOPEI("FrameGraph", "Execute", 0xff00ff00);
+    METALLIC_CPU_ZONE("FrameGraph", "FrameGraph::Execute", 0xff00ff00);
     metallic::ScopedNsightRange nsightFrameGraphRange("FrameGraph::Execute", 0xFF4AA66Eu);
 
+    if (passConditionsChanged()) {
+        compile();
+    }
     ensureHistoryResources(backend);
+    if (m_transientsPending) {
+        selectMemorylessTransients(backend);
+        allocatePlacedTransients(backend);
+        allocateSubAllocatedBuffers(backend);
+        buildRecordingBatches();
+        m_transientsPending = false;
+    }
+
+    for (const FGRecordingBatch& batch : m_recordingBatches) {
+        const uint32_t* batchPasses = m_compiledPasses.data() + batch.first;
+        if (batch.mergedRenderPass) {
+            // All transitions land before the render pass begins; compile() made sure the
+            // merged passes need none in between.
+            commandBuffer.setNextPassQueueHint(RhiQueueHint::Graphics);
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                preparePass(commandBuffer, backend, batchPasses[i]);
+            }
+            commandBuffer.flushBarriers();
+            recordMergedRenderPass(commandBuffer, m_mergedRenderPasses[m_passMergedRenderPass[batchPasses[0]]]);
+            continue;
+        }
+        if (batch.count > 1u) {
+            METALLIC_CPU_ZONE("FrameGraph", "FrameGraph::ParallelBatch", 0xff0088ff);
+            // Every setup and transition of the batch lands in the primary buffer before
+            // the passes record; batched passes touch disjoint resources.
+            commandBuffer.setNextPassQueueHint(RhiQueueHint::Graphics);
+            for (uint32_t i = 0; i < batch.count; ++i) {
+                preparePass(commandBuffer, backend, batchPasses[i]);
+            }
+            commandBuffer.flushBarriers();
 
-    for (uint32_t pi = 0; pi < m_passes.size(); pi++) {
-        auto& pass = m_passes[pi];
-        if (pass.refCount == 0) continue;
+            if (commandBuffer.beginParallelRecording(batch.count)) {
+                Parallel::parallelFor(batch.count, [&](size_t i) {
+                    recordPass(*commandBuffer.parallelCommandBuffer(static_cast<uint32_t>(i)), batchPasses[i]);
+                });
+                commandBuffer.endParallelRecording();
+            } else {
+                for (uint32_t i = 0; i < batch.count; ++i) {
+                    recordPass(commandBuffer, batchPasses[i]);
+                }
+            }
+            continue;
+        }
 
-        MICROPROFILE_SCOPEI("FrameGraph", pass.name.c_str(), 0xff0088ff);
-        metallic::ScopedNsightRange nsightPassRange(pass.name.c_str(), nsightPassColor(pass.type));
+        const uint32_t pi = batchPasses[0];
+        // compile() already decided the queue; demoted passes run on graphics.
+        commandBuffer.setNextPassQueueHint(m_passAsyncCompute[pi] != 0u ? RhiQueueHint::AsyncCompute
+                                                                         : RhiQueueHint::Graphics);
+        preparePass(commandBuffer, backend, pi);
+        commandBuffer.flushBarriers();
+        recordPass(commandBuffer, pi);
+    }
 
-        // Inform the backend which queue this pass prefers.
-        commandBuffer.setNextPassQueueHint(pass.queueHint);
+    recordQueueHandoff(commandBuffer, m_finalQueueHandoff);
 
-        // Create transient resources at their producer pass
-        for (uint32_t ri = 0; ri < m_resources.size(); ri++) {
-            auto& res = m_resources[ri];
-            if (res.historySlot != UINT32_MAX ||
-                res.imported ||
-                res.producer != pi ||
-                res.physicalResource != ri) {
-                continue;
-            }
+    for (auto& slot : m_historySlots) {
+        if (!slot.writtenThisFrame) {
+            continue;
+        }
+        slot.writeIndex = (slot.writeIndex + 1u) % slot.depth;
+        slot.committedFrames = std::min(slot.committedFrames + 1u, slot.depth - 1u);
+    }
+}
 
-            if (res.kind == FGResourceKind::Texture && res.texture == nullptr) {
-                res.ownedTexture = backend.createTexture(res.desc);
-                res.texture = res.ownedTexture.get();
-            } else if (res.kind == FGResourceKind::Buffer && res.buffer == nullptr) {
-                res.ownedBuffer = backend.createBuffer(res.bufferDesc);
-                res.buffer = res.ownedBuffer.get();
-            }
+void FrameGraph::reset() {
+    m_resources.clear();
+    m_passes.clear();
+    m_passData.clear();
+    m_ownedPasses.clear();
+    m_historySlots.clear();
+    m_historySlotLookup.clear();
+    m_transientMemoryStats = {};
+    m_compiledPasses.clear();
+    m_passConditionOpen.clear();
+    m_passMayRun.clear();
+    m_hasConditionalPasses = false;
+    m_passTransients.clear();
+    m_passPrepareSteps.clear();
+    m_passAsyncCompute.clear();
+    m_passCpuRecordMs.clear();
+    m_passQueueHandoffs.clear();
+    m_finalQueueHandoff = {};
+    m_mergedRenderPasses.clear();
+    m_passMergedRenderPass.clear();
+    m_recordingBatches.clear();
+    m_transientsPending = true;
+}
+
+void FrameGraph::preparePass(RhiCommandBuffer& commandBuffer, RhiFrameGraphBackend& backend, uint32_t passIndex) {
+    auto& pass = m_passes[passIndex];
+
+    // Create transient resources at their producer pass
+    for (uint32_t ri : m_passTransients[passIndex]) {
+        auto& res = m_resources[ri];
+        if (res.kind == FGResourceKind::Texture && res.texture == nullptr) {
+            res.ownedTexture = backend.createTexture(res.desc);
+            res.texture = res.ownedTexture.get();
+        } else if (res.kind == FGResourceKind::Buffer && res.buffer == nullptr) {
+            res.ownedBuffer = backend.createBuffer(res.bufferDesc);
+            res.buffer = res.ownedBuffer.get();
         }
 
-        // Derive pre-pass resource transitions from declared usage.
-        // Accumulate all transitions, then flush once before the pass begins.
-        for (const auto& read : pass.reads) {
-            const auto& resource = m_resources[read.resource.id];
-            if (resource.kind == FGResourceKind::Texture) {
-                RhiTexture* texture = resolveTexture(read.resource.id);
-                if (!texture) continue;
+        // Another transient used this memory earlier in the frame (or last frame).
+        if (res.memoryAliased) {
+            commandBuffer.discardTexture(res.texture);
+        }
+    }
 
-                if (hasUsage(read.usage, FGResourceUsage::Sampled)) {
+    recordQueueHandoff(commandBuffer, m_passQueueHandoffs[passIndex]);
+
+    // Apply the pass's precomputed transitions; the caller flushes once before recording.
+    for (const FGPrepareStep& step : m_passPrepareSteps[passIndex]) {
+        switch (step.op) {
+            case FGPrepareOp::SampleTexture:
+            case FGPrepareOp::StorageTexture:
+            case FGPrepareOp::TransferSrcTexture:
+            case FGPrepareOp::TransferDstTexture: {
+                RhiTexture* texture = resolveTexture(step.resource);
+                if (!texture) break;
+                if (step.op == FGPrepareOp::SampleTexture) {
                     commandBuffer.prepareTextureForSampling(texture);
-                }
-                if (hasUsage(read.usage, FGResourceUsage::StorageRead)) {
+                } else if (step.op == FGPrepareOp::StorageTexture) {
                     commandBuffer.prepareTextureForStorage(texture);
-                }
-                if (hasUsage(read.usage, FGResourceUsage::TransferSrc)) {
+                } else if (step.op == FGPrepareOp::TransferSrcTexture) {
                     commandBuffer.prepareTextureForTransferSrc(texture);
+                } else {
+                    commandBuffer.prepareTextureForTransferDst(texture);
                 }
-                // ColorAttachment/DepthAttachment reads are handled by beginRenderPass below
-            } else if (resource.kind == FGResourceKind::Buffer) {
-                RhiBuffer* buffer = resolveBuffer(read.resource.id);
-                if (!buffer) continue;
-
-                if (hasUsage(read.usage, FGResourceUsage::StorageWrite)) {
-                    commandBuffer.prepareBufferForStorageWrite(buffer);
-                } else if (hasUsage(read.usage, FGResourceUsage::StorageRead)) {
+                break;
+            }
+            default: {
+                RhiBuffer* buffer = resolveBuffer(step.resource);
+                if (!buffer) break;
+                if (step.op == FGPrepareOp::StorageReadBuffer) {
                     commandBuffer.prepareBufferForStorageRead(buffer);
-                }
-                if (hasUsage(read.usage, FGResourceUsage::Indirect)) {
+                } else if (step.op == FGPrepareOp::StorageWriteBuffer) {
+                    commandBuffer.prepareBufferForStorageWrite(buffer);
+                } else if (step.op == FGPrepareOp::IndirectBuffer) {
                     commandBuffer.prepareBufferForIndirect(buffer);
-                }
-                if (hasUsage(read.usage, FGResourceUsage::VertexInput)) {
+                } else if (step.op == FGPrepareOp::VertexBuffer) {
                     commandBuffer.prepareBufferForVertexInput(buffer);
-                }
-                if (hasUsage(read.usage, FGResourceUsage::IndexInput)) {
+                } else {
                     commandBuffer.prepareBufferForIndexInput(buffer);
                 }
+                break;
             }
         }
+    }
 
-        for (const auto& write : pass.writes) {
-            const auto& resource = m_resources[write.resource.id];
-            if (resource.kind == FGResourceKind::Texture) {
-                RhiTexture* texture = resolveTexture(write.resource.id);
-                if (!texture) continue;
+    if (pass.prepareResources) {
+        pass.prepareResources(commandBuffer);
+    }
+}
 
-                if (hasUsage(write.usage, FGResourceUsage::StorageWrite) ||
-                    hasUsage(write.usage, FGResourceUsage::StorageRead)) {
-                    commandBuffer.prepareTextureForStorage(texture);
-                }
-                if (hasUsage(write.usage, FGResourceUsage::TransferDst)) {
-                    commandBuffer.prepareTextureForTransferDst(texture);
-                }
-                // ColorAttachment/DepthAttachment writes are handled by beginRenderPass below
-            } else if (resource.kind == FGResourceKind::Buffer) {
-                RhiBuffer* buffer = resolveBuffer(write.resource.id);
-                if (!buffer) continue;
+void FrameGraph::recordPass(RhiCommandBuffer& commandBuffer, uint32_t passIndex) const {
+    const auto& pass = m_passes[passIndex];
+
+    ZoneScopedN("FrameGraph::RecordPass");
+    ZoneName(pass.name.c_str(), pass.name.size());
+    MICROPROFILE_SCOPEI("FrameGraph", pass.name.c_str(), 0xff0088ff);
+    metallic::ScopedNsightRange nsightPassRange(pass.name.c_str(), nsightPassColor(pass.type));
+    const auto recordStart = std::chrono::steady_clock::now();
+
+    if (pass.type == FGPassType::Render) {
+        auto encoder = commandBuffer.beginRenderPass(renderPassDesc(passIndex, passIndex, pass.name.c_str()));
+        pass.executeRender(*encoder);
+    } else if (pass.type == FGPassType::Compute) {
+        RhiComputePassDesc computePassDesc;
+        computePassDesc.label = pass.name.c_str();
+        auto encoder = commandBuffer.beginComputePass(computePassDesc);
+        pass.executeCompute(*encoder);
+    } else if (pass.type == FGPassType::Blit) {
+        RhiBlitPassDesc blitPassDesc;
+        blitPassDesc.label = pass.name.c_str();
+        auto encoder = commandBuffer.beginBlitPass(blitPassDesc);
+        pass.executeBlit(*encoder);
+    }
+    m_passCpuRecordMs[passIndex] = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - recordStart).count();
+}
 
-                if (hasUsage(write.usage, FGResourceUsage::StorageWrite) ||
-                    hasUsage(write.usage, FGResourceUsage::StorageRead)) {
-                    commandBuffer.prepareBufferForStorageWrite(buffer);
-                }
-            }
-        }
+void FrameGraph::recordMergedRenderPass(RhiCommandBuffer& commandBuffer, const FGMergedRenderPass& merged) const {
+    const uint32_t* passes = m_compiledPasses.data() + merged.first;
 
-        if (pass.prepareResources) {
-            pass.prepareResources(commandBuffer);
-        }
+    ZoneScopedN("FrameGraph::RecordMergedPass");
+    ZoneName(merged.label.c_str(), merged.label.size());
+    MICROPROFILE_SCOPEI("FrameGraph", merged.label.c_str(), 0xff0088ff);
+    metallic::ScopedNsightRange nsightMergedRange(merged.label.c_str(), nsightPassColor(FGPassType::Render));
 
-        commandBuffer.flushBarriers();
+    auto encoder = commandBuffer.beginRenderPass(
+        renderPassDesc(passes[0], passes[merged.count - 1u], merged.label.c_str()));
+    for (uint32_t i = 0; i < merged.count; ++i) {
+        const auto& pass = m_passes[passes[i]];
+        metallic::ScopedNsightRange nsightPassRange(pass.name.c_str(), nsightPassColor(pass.type));
+        const auto recordStart = std::chrono::steady_clock::now();
+        pass.executeRender(*encoder);
+        m_passCpuRecordMs[passes[i]] = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - recordStart).count();
+    }
+}
 
-        if (pass.type == FGPassType::Render) {
-            RhiRenderPassDesc renderPassDesc;
-            renderPassDesc.label = pass.name.c_str();
-            for (uint32_t ci = 0; ci < pass.colorAttachmentCount; ci++) {
-                auto& ca = pass.colorAttachments[ci];
-                renderPassDesc.colorAttachments[ci] = {
-                    resolveTexture(ca.resource.id),
-                    ca.loadAction,
-                    ca.storeAction,
-                    ca.clearColor,
-                };
-            }
-            renderPassDesc.colorAttachmentCount = pass.colorAttachmentCount;
-            if (pass.depthAttachment.bound) {
-                renderPassDesc.depthAttachment = {
-                    resolveTexture(pass.depthAttachment.resource.id),
-                    pass.depthAttachment.loadAction,
-                    pass.depthAttachment.storeAction,
-                    pass.depthAttachment.clearDepth,
-                    true,
-                };
-            }
-
-            auto encoder = commandBuffer.beginRenderPass(renderPassDesc);
-            pass.executeRender(*encoder);
-        } else if (pass.type == FGPassType::Compute) {
-            RhiComputePassDesc computePassDesc;
-            computePassDesc.label = pass.name.c_str();
-            auto encoder = commandBuffer.beginComputePass(computePassDesc);
-            pass.executeCompute(*encoder);
-        } else if (pass.type == FGPassType::Blit) {
-            RhiBlitPassDesc blitPassDesc;
-            blitPassDesc.label = pass.name.c_str();
-            auto encoder = commandBuffer.beginBlitPass(blitPassDesc);
-            pass.executeBlit(*encoder);
-        }
+// Load actions and clear values come from the first pass, store actions from the last.
+RhiRenderPassDesc FrameGraph::renderPassDesc(uint32_t firstPass, uint32_t lastPass, const char* label) const {
+    const auto& first = m_passes[firstPass];
+    const auto& last = m_passes[lastPass];
+    // Nothing reads a memoryless attachment after the pass, so its store is dropped.
+    auto storeAction = [this](FGResource resource, RhiStoreAction action) {
+        const auto& res = m_resources[resource.id];
+        const uint32_t root = res.physicalResource != UINT32_MAX ? res.physicalResource : resource.id;
+        return m_resources[root].memoryless ? RhiStoreAction::DontCare : action;
+    };
+
+    RhiRenderPassDesc desc;
+    desc.label = label;
+    for (uint32_t ci = 0; ci < first.colorAttachmentCount; ci++) {
+        const auto& ca = first.colorAttachments[ci];
+        const auto& lastCa = last.colorAttachments[ci];
+        desc.colorAttachments[ci] = {
+            resolveTexture(lastCa.resource.id),
+            ca.loadAction,
+            storeAction(lastCa.resource, lastCa.storeAction),
+            ca.clearColor,
+        };
+    }
+    desc.colorAttachmentCount = first.colorAttachmentCount;
+    if (first.depthAttachment.bound) {
+        const bool keepDepth = first.depthAttachment.keepContents && first.depthAttachment.keepContents();
+        desc.depthAttachment = {
+            resolveTexture(last.depthAttachment.resource.id),
+            keepDepth ? RhiLoadAction::Load : first.depthAttachment.loadAction,
+            storeAction(last.depthAttachment.resource, last.depthAttachment.storeAction),
+            first.depthAttachment.clearDepth,
+            true,
+        };
+    }
+    return desc;
+}
+
+void FrameGraph::recordQueueHandoff(RhiCommandBuffer& commandBuffer, const FGQueueHandoff& handoff) const {
+    if (handoff.resources.empty()) {
+        return;
     }
 
-    for (auto& slot : m_historySlots) {
-        if (!slot.writtenThisFrame) {
-            continue;
+    RhiQueueHandoff rhiHandoff;
+    rhiHandoff.from = handoff.fromAsyncCompute ? RhiQueueHint::AsyncCompute : RhiQueueHint::Graphics;
+    for (uint32_t ri : handoff.resources) {
+        if (m_resources[ri].kind == FGResourceKind::Texture) {
+            if (const RhiTexture* texture = resolveTexture(ri)) {
+                rhiHandoff.textures.push_back(texture);
+            }
+        } else if (const RhiBuffer* buffer = resolveBuffer(ri)) {
+            rhiHandoff.buffers.push_back(buffer);
         }
-        slot.readIndex = 1u - slot.readIndex;
-        slot.valid = true;
     }
-}
-
-void FrameGraph::reset() {
-    m_resources.clear();
-    m_passes.clear();
-    m_passData.clear();
-    m_ownedPasses.clear();
-    m_historySlots.clear();
-    m_historySlotLookup.clear();
+    commandBuffer.queueHandoff(rhiHandoff);
 }
 
 // --- Visualization helpers ---
@@ -749,6 +1744,7 @@ const char* pixelFormatName(RhiFormat fmt) {
         case RhiFormat::RG8Unorm:           return "RG8Unorm";
         case RhiFormat::RG16Float:          return "RG16Float";
         case RhiFormat::RG32Float:          return "RG32Float";
+        case RhiFormat::RG32Uint:           return "RG32Uint";
         case RhiFormat::RGBA8Unorm:         return "RGBA8";
         case RhiFormat::RGBA8Srgb:          return "RGBA8Srgb";
         case RhiFormat::BGRA8Unorm:         return "BGRA8";
@@ -756,10 +1752,26 @@ const char* pixelFormatName(RhiFormat fmt) {
         case RhiFormat::RGBA32Float:        return "RGBA32Float";
         case RhiFormat::D32Float:           return "Depth32F";
         case RhiFormat::D16Unorm:           return "Depth16";
+        case RhiFormat::BC7RGBAUnorm:       return "BC7";
         default:                            return "Unknown";
     }
 }
 
+uint32_t pixelFormatBytes(RhiFormat fmt) {
+    switch (fmt) {
+        case RhiFormat::R8Unorm:            return 1u;
+        case RhiFormat::R16Float:
+        case RhiFormat::RG8Unorm:
+        case RhiFormat::D16Unorm:           return 2u;
+        case RhiFormat::RG32Float:
+        case RhiFormat::RG32Uint:
+        case RhiFormat::RGBA16Float:        return 8u;
+        case RhiFormat::RGBA32Float:        return 16u;
+        case RhiFormat::BC7RGBAUnorm:       return 1u; // 16 bytes per 4x4 block
+        default:                            return 4u;
+    }
+}
+
 const char* passTypeName(FGPassType type) {
     switch (type) {
         case FGPassType::Render:  return "Render";
@@ -782,6 +1794,7 @@ const char* storageModeName(RhiTextureStorageMode storageMode) {
     switch (storageMode) {
         case RhiTextureStorageMode::Private: return "Private";
         case RhiTextureStorageMode::Shared:  return "Shared";
+        case RhiTextureStorageMode::Memoryless: return "Memoryless";
     }
     return "Unknown";
 }
@@ -955,8 +1968,26 @@ std::string resourceMetaLabel(const FGResourceNode& resource, uint32_t aliasGrou
     return label;
 }
 
+void drawGpuTimingTooltip(const FGGpuPassTiming& timing) {
+    ImGui::Text("GPU: %.3f ms avg (%.3f min / %.3f max, %u frames)",
+                timing.avgMs,
+                timing.minMs,
+                timing.maxMs,
+                timing.sampleCount);
+    if (timing.latest.hasPipelineStats) {
+        ImGui::Text("Primitives: %llu", static_cast<unsigned long long>(timing.latest.primitives));
+        ImGui::Text("VS %llu / FS %llu / CS %llu / MS %llu",
+                    static_cast<unsigned long long>(timing.latest.vertexInvocations),
+                    static_cast<unsigned long long>(timing.latest.fragmentInvocations),
+                    static_cast<unsigned long long>(timing.latest.computeInvocations),
+                    static_cast<unsigned long long>(timing.latest.meshInvocations));
+    }
+}
+
+// passTimings is indexed by pass; merged render passes share one timing.
 void drawResourceTimelineImGui(const std::vector<FGResourceNode>& resources,
-                               const std::vector<FGPassNode>& passes) {
+                               const std::vector<FGPassNode>& passes,
+                               const std::vector<const FGGpuPassTiming*>& passTimings) {
     if (resources.empty()) {
         ImGui::TextDisabled("No frame graph resources recorded.");
         return;
@@ -1064,7 +2095,7 @@ void drawResourceTimelineImGui(const std::vector<FGResourceNode>& resources,
         });
     }
 
-    const float headerHeight = 42.0f;
+    const float headerHeight = 54.0f;
     const float rowHeight = 36.0f;
     const float labelWidth = 320.0f;
     const float passWidth = passCount > 10 ? 96.0f : 116.0f;
@@ -1130,6 +2161,14 @@ void drawResourceTimelineImGui(const std::vector<FGResourceNode>& resources,
         drawList->AddText(ImVec2(x0 + 8.0f, canvasMin.y + 20.0f),
                           IM_COL32(232, 236, 242, 255),
                           passLabel.c_str());
+        const FGGpuPassTiming* timing = passTimings[passIndex];
+        if (timing && pass.refCount > 0) {
+            char timingLabel[32];
+            std::snprintf(timingLabel, sizeof(timingLabel), "%.3f ms", timing->avgMs);
+            drawList->AddText(ImVec2(x0 + 8.0f, canvasMin.y + 34.0f),
+                              IM_COL32(255, 214, 120, 255),
+                              timingLabel);
+        }
 
         if (pointInRect(mousePos, ImVec2(x0, canvasMin.y), ImVec2(x1, headerBottomY))) {
             ImGui::BeginTooltip();
@@ -1141,6 +2180,13 @@ void drawResourceTimelineImGui(const std::vector<FGResourceNode>& resources,
             ImGui::Text("Reads: %zu", pass.reads.size());
             ImGui::Text("Writes: %zu", pass.writes.size());
             ImGui::Text("Side Effect: %s", pass.hasSideEffect ? "Yes" : "No");
+            if (timing) {
+                ImGui::Separator();
+                if (timing->latest.label != pass.name) {
+                    ImGui::Text("Merged: %s", timing->latest.label.c_str());
+                }
+                drawGpuTimingTooltip(*timing);
+            }
             ImGui::EndTooltip();
         }
     }
@@ -1242,6 +2288,16 @@ void drawResourceTimelineImGui(const std::vector<FGResourceNode>& resources,
             ImGui::Text("Status: %s", live ? "Live" : "Culled");
             ImGui::Text("Refs: %u", resource.refCount);
             ImGui::Text("Alias Group: %u", row.aliasGroup + 1);
+            const auto& physical = resource.physicalResource != UINT32_MAX
+                                       ? resources[resource.physicalResource]
+                                       : resource;
+            if (physical.memoryHeap != UINT32_MAX) {
+                ImGui::Text("Memory: heap %u @ %.2f MB (%.2f MB%s)",
+                            physical.memoryHeap,
+                            double(physical.memoryOffset) / (1024.0 * 1024.0),
+                            double(physical.memorySizeBytes) / (1024.0 * 1024.0),
+                            physical.memoryAliased ? ", aliased" : "");
+            }
             if (resource.previousVersion != UINT32_MAX) {
                 ImGui::Text("Previous Version: #%u", resource.previousVersion);
             }
@@ -1416,6 +2472,93 @@ void FrameGraph::exportGraphviz(std::ostream& os) const {
 
 // --- ImGui debug window ---
 
+void FrameGraph::recordGpuTimings(uint64_t frameIndex, const std::vector<FGGpuScopeSample>& scopes) {
+    if (scopes.empty() || frameIndex == m_lastGpuTimingFrame) {
+        return;
+    }
+    m_lastGpuTimingFrame = frameIndex;
+
+    // A label can appear more than once per frame (e.g. a pass split across encoders).
+    std::unordered_map<std::string, FGGpuScopeSample> frameScopes;
+    for (const FGGpuScopeSample& scope : scopes) {
+        auto [it, inserted] = frameScopes.try_emplace(scope.label, scope);
+        if (!inserted) {
+            FGGpuScopeSample& merged = it->second;
+            merged.durationMs += scope.durationMs;
+            merged.hasPipelineStats = merged.hasPipelineStats || scope.hasPipelineStats;
+            merged.primitives += scope.primitives;
+            merged.vertexInvocations += scope.vertexInvocations;
+            merged.fragmentInvocations += scope.fragmentInvocations;
+            merged.computeInvocations += scope.computeInvocations;
+            merged.meshInvocations += scope.meshInvocations;
+        }
+    }
+
+    for (auto& [label, scope] : frameScopes) {
+        FGGpuPassTiming& timing = m_gpuPassTimings[label];
+        timing.durationsMs[timing.nextSample] = static_cast<float>(scope.durationMs);
+        timing.nextSample = (timing.nextSample + 1) % FGGpuPassTiming::kSampleCount;
+        timing.sampleCount = std::min(timing.sampleCount + 1, FGGpuPassTiming::kSampleCount);
+        timing.latest = std::move(scope);
+
+        float minMs = timing.durationsMs[0];
+        float maxMs = timing.durationsMs[0];
+        double totalMs = 0.0;
+        for (uint32_t i = 0; i < timing.sampleCount; ++i) {
+            minMs = std::min(minMs, timing.durationsMs[i]);
+            maxMs = std::max(maxMs, timing.durationsMs[i]);
+            totalMs += timing.durationsMs[i];
+        }
+        timing.minMs = minMs;
+        timing.maxMs = maxMs;
+        timing.avgMs = static_cast<float>(totalMs / timing.sampleCount);
+    }
+}
+
+const FGGpuPassTiming* FrameGraph::gpuPassTiming(const std::string& label) const {
+    auto it = m_gpuPassTimings.find(label);
+    return it != m_gpuPassTimings.end() ? &it->second : nullptr;
+}
+
+void FrameGraph::collectPassCosts(std::vector<FGPassCost>& costs) const {
+    costs.clear();
+    costs.reserve(m_passes.size());
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        const FGPassNode& pass = m_passes[pi];
+        FGPassCost cost;
+        cost.name = pass.name;
+        cost.live = pass.refCount > 0;
+        if (cost.live && pi < m_passMergedRenderPass.size()) {
+            const uint32_t merged = m_passMergedRenderPass[pi];
+            cost.gpuMerged = merged != UINT32_MAX;
+            cost.gpuTiming = gpuPassTiming(cost.gpuMerged ? m_mergedRenderPasses[merged].label : pass.name);
+        }
+        if (cost.live && pi < m_passCpuRecordMs.size()) {
+            cost.cpuRecordMs = m_passCpuRecordMs[pi];
+        }
+        if (cost.live && pi < m_passTransients.size()) {
+            for (uint32_t ri : m_passTransients[pi]) {
+                const FGResourceNode& res = m_resources[ri];
+                if (res.kind == FGResourceKind::Buffer) {
+                    cost.transientBytes += res.bufferDesc.size;
+                } else if (res.memorySizeBytes > 0) {
+                    cost.transientBytes += res.memorySizeBytes;
+                } else if (!res.memoryless) {
+                    // Committed texture: the driver's padding and mip tails are not visible here.
+                    uint64_t width = res.desc.width;
+                    uint64_t height = res.desc.height;
+                    for (uint32_t mip = 0; mip < std::max(res.desc.mipLevels, 1u); ++mip) {
+                        cost.transientBytes += width * height * pixelFormatBytes(res.desc.format);
+                        width = std::max<uint64_t>(width / 2u, 1u);
+                        height = std::max<uint64_t>(height / 2u, 1u);
+                    }
+                }
+            }
+        }
+        costs.push_back(std::move(cost));
+    }
+}
+
 void FrameGraph::debugImGui() const {
     if (!ImGui::Begin("FrameGraph Debug")) {
         ImGui::End();
@@ -1438,20 +2581,77 @@ void FrameGraph::debugImGui() const {
         ImGui::SameLine();
         ImGui::Text("History Slots: %zu", m_historySlots.size());
     }
+    if (m_transientMemoryStats.placedTextureCount > 0) {
+        ImGui::Text("Placed Transients: %u (%u aliased), %.1f MB heaps for %.1f MB of textures",
+                    m_transientMemoryStats.placedTextureCount,
+                    m_transientMemoryStats.aliasedTextureCount,
+                    double(m_transientMemoryStats.heapBytes) / (1024.0 * 1024.0),
+                    double(m_transientMemoryStats.requestedBytes) / (1024.0 * 1024.0));
+    }
+    if (m_transientMemoryStats.memorylessTextureCount > 0) {
+        ImGui::Text("Memoryless Transients: %u", m_transientMemoryStats.memorylessTextureCount);
+    }
+    if (m_transientMemoryStats.subAllocatedBufferCount > 0) {
+        ImGui::Text("Sub-allocated Buffers: %u in %.1f MB heaps",
+                    m_transientMemoryStats.subAllocatedBufferCount,
+                    double(m_transientMemoryStats.bufferHeapBytes) / (1024.0 * 1024.0));
+    }
+    const auto asyncPassCount = static_cast<uint32_t>(
+        std::count(m_passAsyncCompute.begin(), m_passAsyncCompute.end(), uint8_t(1u)));
+    if (asyncPassCount > 0) {
+        const auto handoffCount = static_cast<uint32_t>(std::count_if(
+            m_passQueueHandoffs.begin(),
+            m_passQueueHandoffs.end(),
+            [](const FGQueueHandoff& handoff) { return !handoff.resources.empty(); }));
+        ImGui::Text("Async Compute Passes: %u, queue handoffs: %u", asyncPassCount, handoffCount);
+    }
+    uint32_t parallelBatchCount = 0;
+    uint32_t parallelPassCount = 0;
+    for (const FGRecordingBatch& batch : m_recordingBatches) {
+        if (batch.count > 1u && !batch.mergedRenderPass) {
+            ++parallelBatchCount;
+            parallelPassCount += batch.count;
+        }
+    }
+    if (parallelBatchCount > 0) {
+        ImGui::Text("Parallel Recording: %u passes in %u batches", parallelPassCount, parallelBatchCount);
+    }
+    if (!m_mergedRenderPasses.empty()) {
+        ImGui::Text("Merged Render Passes: %zu", m_mergedRenderPasses.size());
+        for (const FGMergedRenderPass& merged : m_mergedRenderPasses) {
+            ImGui::BulletText("%s", merged.label.c_str());
+        }
+    }
+
+    std::vector<const FGGpuPassTiming*> passTimings(m_passes.size(), nullptr);
+    double passGpuMs = 0.0;
+    for (uint32_t pi = 0; pi < m_passes.size(); ++pi) {
+        const bool merged = pi < m_passMergedRenderPass.size() && m_passMergedRenderPass[pi] != UINT32_MAX;
+        passTimings[pi] = gpuPassTiming(merged ? m_mergedRenderPasses[m_passMergedRenderPass[pi]].label
+                                               : m_passes[pi].name);
+        const bool firstOfScope = !merged || m_compiledPasses[m_mergedRenderPasses[m_passMergedRenderPass[pi]].first] == pi;
+        if (passTimings[pi] && m_passes[pi].refCount > 0 && firstOfScope) {
+            passGpuMs += passTimings[pi]->avgMs;
+        }
+    }
+    if (!m_gpuPassTimings.empty()) {
+        ImGui::Text("Pass GPU Time: %.3f ms avg", passGpuMs);
+    }
 
     if (ImGui::CollapsingHeader("Resource Timeline", ImGuiTreeNodeFlags_DefaultOpen)) {
-        drawResourceTimelineImGui(m_resources, m_passes);
+        drawResourceTimelineImGui(m_resources, m_passes, passTimings);
     }
 
     // Passes table
     if (ImGui::CollapsingHeader("Passes", ImGuiTreeNodeFlags_DefaultOpen)) {
-        if (ImGui::BeginTable("passes", 7,
+        if (ImGui::BeginTable("passes", 8,
                 ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
             ImGui::TableSetupColumn("#", ImGuiTableColumnFlags_WidthFixed, 24.0f);
             ImGui::TableSetupColumn("Name");
             ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed, 60.0f);
             ImGui::TableSetupColumn("Refs", ImGuiTableColumnFlags_WidthFixed, 36.0f);
             ImGui::TableSetupColumn("Side Effect", ImGuiTableColumnFlags_WidthFixed, 72.0f);
+            ImGui::TableSetupColumn("GPU ms (min/avg/max)", ImGuiTableColumnFlags_WidthFixed, 150.0f);
             ImGui::TableSetupColumn("Reads");
             ImGui::TableSetupColumn("Writes");
             ImGui::TableHeadersRow();
@@ -1473,9 +2673,20 @@ void FrameGraph::debugImGui() const {
                 ImGui::Text("%u", pass.refCount);
                 ImGui::TableSetColumnIndex(4);
                 ImGui::TextUnformatted(pass.hasSideEffect ? "Yes" : "-");
+                ImGui::TableSetColumnIndex(5);
+                if (const FGGpuPassTiming* timing = passTimings[pi]; timing && !culled) {
+                    ImGui::Text("%.3f / %.3f / %.3f", timing->minMs, timing->avgMs, timing->maxMs);
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::BeginTooltip();
+                        drawGpuTimingTooltip(*timing);
+                        ImGui::EndTooltip();
+                    }
+                } else {
+                    ImGui::TextUnformatted("-");
+                }
 
                 // Reads column
-                ImGui::TableSetColumnIndex(5);
+                ImGui::TableSetColumnIndex(6);
                 for (size_t i = 0; i < pass.reads.size(); i++) {
                     if (i > 0) ImGui::SameLine(0, 0); ImGui::Text("%s%s",
                         m_resources[pass.reads[i].resource.id].name.c_str(),
@@ -1483,7 +2694,7 @@ void FrameGraph::debugImGui() const {
                 }
 
                 // Writes column
-                ImGui::TableSetColumnIndex(6);
+                ImGui::TableSetColumnIndex(7);
                 for (size_t i = 0; i < pass.writes.size(); i++) {
                     if (i > 0) ImGui::SameLine(0, 0); ImGui::Text("%s%s",
                         m_resources[pass.writes[i].resource.id].name.c_str(),
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -69,14 +70,102 @@ struct FGResourceNode {
     uint32_t physicalResource = UINT32_MAX;
     uint32_t previousVersion = UINT32_MAX;
     uint32_t historySlot = UINT32_MAX;
+    uint32_t historyAge = 0; // frames back for history reads; 0 for the history write
     bool exported = false;
     bool historyRead = false;
     bool historyWrite = false;
-
+    // Placed transient memory, set when the backend packed this texture or buffer into a
+    // shared heap.
+    uint32_t memoryHeap = UINT32_MAX;
+    uint64_t memoryOffset = 0;
+    uint64_t memorySizeBytes = 0;
+    bool memoryAliased = false;
+    bool memoryless = false; // attachment of one render pass only; lives in tile memory
+    // Set by compile() on the root of a bypassed output while its producer is culled by
+    // its condition; the resource then resolves to this one.
+    uint32_t bypassSource = UINT32_MAX;
 };
 
 enum class FGPassType { Render, Compute, Blit };
 
+// Backend transition a pass needs before it runs, derived from declared usage at compile().
+enum class FGPrepareOp : uint8_t {
+    SampleTexture,
+    StorageTexture,
+    TransferSrcTexture,
+    TransferDstTexture,
+    StorageReadBuffer,
+    StorageWriteBuffer,
+    IndirectBuffer,
+    VertexBuffer,
+    IndexBuffer,
+};
+
+struct FGPrepareStep {
+    uint32_t resource = UINT32_MAX;
+    FGPrepareOp op = FGPrepareOp::SampleTexture;
+};
+
+// Physical resources that move between the graphics and async compute queues before a
+// pass. Built by compile(); empty when the pass stays on the queue that last used them.
+struct FGQueueHandoff {
+    bool fromAsyncCompute = false;
+    std::vector<uint32_t> resources;
+};
+
+// A run of consecutive compiled passes, as positions in the compiled pass list. A run
+// longer than one pass is either recorded on worker threads or, for a merged render
+// pass, recorded serially into a single render pass.
+struct FGRecordingBatch {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    bool mergedRenderPass = false;
+};
+
+// Consecutive render passes that draw into the same attachments and share one
+// beginRenderPass. Built by compile().
+struct FGMergedRenderPass {
+    uint32_t first = 0; // position in the compiled pass list
+    uint32_t count = 0;
+    std::string label;
+};
+
+// One completed GPU scope from the backend profiler. Scopes are labelled with the pass
+// (or merged render pass) name, which is how recordGpuTimings() matches them.
+struct FGGpuScopeSample {
+    std::string label;
+    double durationMs = 0.0;
+    bool hasPipelineStats = false;
+    uint64_t primitives = 0;
+    uint64_t vertexInvocations = 0;
+    uint64_t fragmentInvocations = 0;
+    uint64_t computeInvocations = 0;
+    uint64_t meshInvocations = 0;
+};
+
+// Rolling GPU cost of one scope over the last kSampleCount completed frames.
+struct FGGpuPassTiming {
+    static constexpr uint32_t kSampleCount = 120;
+
+    std::array<float, kSampleCount> durationsMs = {};
+    uint32_t sampleCount = 0;
+    uint32_t nextSample = 0;
+    float minMs = 0.0f;
+    float avgMs = 0.0f;
+    float maxMs = 0.0f;
+    FGGpuScopeSample latest; // pipeline statistics come from the newest frame only
+};
+
+// Cost of one pass as reported to external tools. Culled passes are listed with no cost.
+struct FGPassCost {
+    std::string name;
+    bool live = false;
+    const FGGpuPassTiming* gpuTiming = nullptr;
+    bool gpuMerged = false; // gpuTiming covers the whole merged render pass
+    float cpuRecordMs = 0.0f;
+    uint64_t transientBytes = 0; // transients the pass creates, placed size when known
+};
+
 struct FGColorAttachment {
     FGResource resource;
     RhiLoadAction loadAction = RhiLoadAction::Clear;
@@ -90,6 +179,9 @@ struct FGDepthAttachment {
     RhiStoreAction storeAction = RhiStoreAction::DontCare;
     double clearDepth = 1.0;
     bool bound = false;
+    // Checked at execute time; returning true turns a Clear into a Load (history
+    // attachments whose contents are still valid this frame).
+    std::function<bool()> keepContents;
 };
 
 struct FGPassNode {
@@ -98,6 +190,7 @@ struct FGPassNode {
     RhiQueueHint queueHint = RhiQueueHint::Auto;
     uint32_t refCount = 0;
     bool hasSideEffect = false;
+    bool parallelRecording = false;
 
     std::vector<FGAccessEntry> reads;
     std::vector<FGAccessEntry> writes;
@@ -110,6 +203,14 @@ struct FGPassNode {
     std::function<void(RhiComputeCommandEncoder&)> executeCompute;
     std::function<void(RhiBlitCommandEncoder&)> executeBlit;
     std::function<void(RhiCommandBuffer&)> prepareResources;
+
+    // Checked at every execute(); false culls the pass until it turns true again.
+    std::function<bool()> condition;
+    struct Bypass {
+        uint32_t output = UINT32_MAX;
+        uint32_t source = UINT32_MAX;
+    };
+    std::vector<Bypass> bypasses;
 };
 
 class FrameGraph;
@@ -124,10 +225,17 @@ public:
     FGResource createToken(const char* name);
     FGResource read(FGResource resource, FGResourceUsage usage = FGResourceUsage::Sampled);
     FGResource write(FGResource resource, FGResourceUsage usage = FGResourceUsage::StorageWrite);
+    // History persists across frames in a ring deep enough for the oldest age any pass
+    // reads: age 1 is what was written last frame. The write reuses the entry whose
+    // data just aged out, so depth is the oldest age plus one.
     FGResource readHistory(const char* name, const FGTextureDesc& desc,
-                           FGResourceUsage usage = FGResourceUsage::Sampled);
+                           FGResourceUsage usage = FGResourceUsage::Sampled, uint32_t age = 1);
     FGResource writeHistory(const char* name, const FGTextureDesc& desc,
                             FGResourceUsage usage = FGResourceUsage::StorageWrite);
+    FGResource readHistory(const char* name, const FGBufferDesc& desc,
+                           FGResourceUsage usage = FGResourceUsage::StorageRead, uint32_t age = 1);
+    FGResource writeHistory(const char* name, const FGBufferDesc& desc,
+                            FGResourceUsage usage = FGResourceUsage::StorageWrite);
 
     FGResource setColorAttachment(uint32_t index, FGResource resource,
                                   RhiLoadAction load, RhiStoreAction store,
@@ -135,12 +243,23 @@ public:
     FGResource setDepthAttachment(FGResource resource,
                                   RhiLoadAction load, RhiStoreAction store,
                                   double clearDepth = 1.0);
+    // Only for history depth attachments: the graph is built once, so a pass that
+    // sometimes reuses last frame's depth clears it unless the predicate says otherwise.
+    void keepDepthAttachmentWhen(std::function<bool()> predicate);
 
     // Declare preferred execution queue for this pass. Backends with a dedicated
     // compute/transfer queue will route accordingly; others silently ignore.
     void setQueueHint(RhiQueueHint hint);
 
+    // Declare that the pass's execute callback only touches its own state, declared
+    // resources, and read-only shared data, so it may record on a worker thread next
+    // to other independent passes.
+    void allowParallelRecording();
+
 private:
+    FGResource readHistorySlot(uint32_t slotIndex, FGResourceUsage usage, uint32_t age);
+    FGResource writeHistorySlot(uint32_t slotIndex, FGResourceUsage usage);
+
     FrameGraph& m_fg;
     uint32_t m_passIndex;
 };
@@ -153,9 +272,21 @@ public:
     void exportResource(FGResource resource);
     void updateImport(FGResource res, RhiTexture* texture);
     void updateImport(FGResource res, RhiBuffer* buffer);
-    void resetTransients();
+    // Drops transient resources so they are recreated on the next execute(). With a
+    // backend, unplaced ones are handed back to it for reuse.
+    void resetTransients(RhiFrameGraphBackend* recycleTo = nullptr);
 
     void addPass(std::unique_ptr<RenderPass> pass);
+    uint32_t passCount() const { return static_cast<uint32_t>(m_passes.size()); }
+
+    // Gates a pass on a predicate evaluated at the start of every execute(). While it
+    // returns false the pass is culled like an unreferenced one, together with what only
+    // it needed, and the graph recompiles without rebuilding any pass. Reads of an output
+    // it created then resolve to the bypass source, and an output it wrote in place
+    // reads as the version before it. Transient placement already accounts for every
+    // gated pass running, so toggling never reallocates.
+    void setPassCondition(uint32_t passIndex, std::function<bool()> condition);
+    void setPassBypass(uint32_t passIndex, FGResource output, FGResource source);
 
     template<typename Data, typename Setup, typename Exec>
     Data& addRenderPass(const char* name, Setup&& setup, Exec&& exec);
@@ -179,20 +310,78 @@ public:
     bool isHistoryValid(FGResource res) const;
     void commitHistory(FGResource res);
 
+    struct TransientMemoryStats {
+        uint32_t placedTextureCount = 0;
+        uint32_t aliasedTextureCount = 0;
+        uint32_t memorylessTextureCount = 0;
+        uint64_t requestedBytes = 0;
+        uint64_t heapBytes = 0;
+        uint32_t subAllocatedBufferCount = 0;
+        uint64_t bufferHeapBytes = 0;
+    };
+
+    // Packs transient textures with disjoint pass lifetimes into shared heaps when
+    // the backend supports placed resources. Takes effect on the next allocation.
+    void setTransientAliasingEnabled(bool enabled) { m_transientAliasingEnabled = enabled; }
+    bool transientAliasingEnabled() const { return m_transientAliasingEnabled; }
+    // Sub-allocates transient buffers (FGBufferDesc::subAllocate) from one linear heap
+    // per memory kind instead of one allocation each. Takes effect on the next allocation.
+    void setTransientBufferHeapEnabled(bool enabled) { m_transientBufferHeapEnabled = enabled; }
+    bool transientBufferHeapEnabled() const { return m_transientBufferHeapEnabled; }
+    const TransientMemoryStats& transientMemoryStats() const { return m_transientMemoryStats; }
+
+    // Feeds one completed frame of backend GPU scopes into the per-pass rolling timings
+    // shown by debugImGui(). Repeated calls for the same frame are ignored. Timings are
+    // keyed by name, so they survive reset() and pipeline rebuilds.
+    void recordGpuTimings(uint64_t frameIndex, const std::vector<FGGpuScopeSample>& scopes);
+    const FGGpuPassTiming* gpuPassTiming(const std::string& label) const;
+    // One entry per declared pass, in declaration order.
+    void collectPassCosts(std::vector<FGPassCost>& costs) const;
+
+    // Fuses consecutive render passes that continue drawing into the same attachments,
+    // dropping the store and load between them. Takes effect on the next compile.
+    void setRenderPassMergingEnabled(bool enabled) { m_renderPassMergingEnabled = enabled; }
+    bool renderPassMergingEnabled() const { return m_renderPassMergingEnabled; }
+
 private:
     struct FGHistorySlot {
         std::string name;
+        FGResourceKind kind = FGResourceKind::Texture;
         FGTextureDesc desc;
-        std::unique_ptr<RhiTexture> textures[2];
-        uint32_t readResource = UINT32_MAX;
+        FGBufferDesc bufferDesc;
+        uint32_t depth = 2;
+        std::vector<std::unique_ptr<RhiTexture>> textures;
+        std::vector<std::unique_ptr<RhiBuffer>> buffers;
+        std::vector<uint32_t> readResources; // indexed by age - 1
         uint32_t writeResource = UINT32_MAX;
-        uint32_t readIndex = 0;
-        bool valid = false;
+        uint32_t writeIndex = 0;
+        uint32_t committedFrames = 0; // consecutive writes since allocation, capped at depth - 1
         bool writtenThisFrame = false;
     };
 
     uint32_t findOrCreateHistorySlot(const char* name, const FGTextureDesc& desc);
+    uint32_t findOrCreateHistorySlot(const char* name, const FGBufferDesc& desc);
+    uint32_t historyRingIndex(const FGResourceNode& resource) const;
+    void markLivePasses(bool applyConditions);
+    bool passConditionsChanged() const;
+    // The physical root a resource resolves to this frame, following bypasses.
+    uint32_t physicalRoot(uint32_t resourceId) const;
     void ensureHistoryResources(RhiFrameGraphBackend& backend);
+    void computeTransientLifetimes(std::vector<uint32_t>& firstPass,
+                                   std::vector<uint32_t>& lastPass,
+                                   std::vector<uint8_t>& aliasable) const;
+    void selectMemorylessTransients(RhiFrameGraphBackend& backend);
+    void allocatePlacedTransients(RhiFrameGraphBackend& backend);
+    void allocateSubAllocatedBuffers(RhiFrameGraphBackend& backend);
+    void buildPrepareSteps(uint32_t passIndex);
+    void scheduleQueues();
+    void mergeRenderPasses();
+    void recordQueueHandoff(RhiCommandBuffer& commandBuffer, const FGQueueHandoff& handoff) const;
+    void buildRecordingBatches();
+    void preparePass(RhiCommandBuffer& commandBuffer, RhiFrameGraphBackend& backend, uint32_t passIndex);
+    void recordPass(RhiCommandBuffer& commandBuffer, uint32_t passIndex) const;
+    void recordMergedRenderPass(RhiCommandBuffer& commandBuffer, const FGMergedRenderPass& merged) const;
+    RhiRenderPassDesc renderPassDesc(uint32_t firstPass, uint32_t lastPass, const char* label) const;
     RhiTexture* resolveTexture(uint32_t resourceId) const;
     RhiBuffer* resolveBuffer(uint32_t resourceId) const;
 
@@ -201,6 +390,31 @@ private:
     std::vector<std::unique_ptr<RenderPass>> m_ownedPasses;
     std::vector<FGHistorySlot> m_historySlots;
     std::unordered_map<std::string, uint32_t> m_historySlotLookup;
+    TransientMemoryStats m_transientMemoryStats;
+    std::unordered_map<std::string, FGGpuPassTiming> m_gpuPassTimings;
+    uint64_t m_lastGpuTimingFrame = UINT64_MAX;
+    bool m_transientAliasingEnabled = true;
+    bool m_transientBufferHeapEnabled = true;
+    bool m_renderPassMergingEnabled = true;
+    // Built by compile(): live passes in order and the transients each one produces.
+    std::vector<uint32_t> m_compiledPasses;
+    // Per pass: condition state at the last compile, and whether it is live when every
+    // condition holds. Lifetimes for transient placement use the latter.
+    std::vector<uint8_t> m_passConditionOpen;
+    std::vector<uint8_t> m_passMayRun;
+    bool m_hasConditionalPasses = false;
+    std::vector<std::vector<uint32_t>> m_passTransients;
+    std::vector<std::vector<FGPrepareStep>> m_passPrepareSteps;
+    std::vector<uint8_t> m_passAsyncCompute;
+    // CPU time of the last recording per pass. Written from recordPass(), which runs on
+    // worker threads for parallel batches; each pass only touches its own slot.
+    mutable std::vector<float> m_passCpuRecordMs;
+    std::vector<FGQueueHandoff> m_passQueueHandoffs;
+    FGQueueHandoff m_finalQueueHandoff; // returns async-owned resources to graphics
+    std::vector<FGMergedRenderPass> m_mergedRenderPasses;
+    std::vector<uint32_t> m_passMergedRenderPass; // index into m_mergedRenderPasses, or UINT32_MAX
+    std::vector<FGRecordingBatch> m_recordingBatches; // rebuilt with the transients
+    bool m_transientsPending = true;
 
     struct PassDataHolder {
         void* data = nullptr;
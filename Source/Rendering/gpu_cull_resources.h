@@ -10,6 +10,9 @@ enum : uint32_t {
     kVisibleInstanceClassificationHasLod = 1u << 1,
     kMeshletDrawSourceScene = 0u,
     kMeshletDrawSourceClusterLod = 1u,
+    kMeshletDrawSoftwareRasterBit = 1u << 31,
+    kMeshletDrawAlphaMaskedBit = 1u << 30,
+    kMeshletDrawTransparentBit = 1u << 29,
     kClusterLodGroupResidencyResident = 1u << 0,
     kClusterLodGroupResidencyRequested = 1u << 1,
     kClusterLodGroupResidencyAlwaysResident = 1u << 2,
@@ -48,12 +51,33 @@ struct MeshletDrawInfo {
     uint32_t instanceID = UINT32_MAX;
     uint32_t globalMeshletID = UINT32_MAX;
     uint32_t meshletSource = kMeshletDrawSourceScene;
-    uint32_t lodLevel = 0;
+    uint32_t lodLevel = 0; // | kMeshletDrawSoftwareRasterBit / AlphaMaskedBit / TransparentBit bins
 };
 static_assert(sizeof(MeshletDrawInfo) == 16, "MeshletDrawInfo must match shader layout");
 
+// One indexed draw per visible instance, in VkDrawIndexedIndirectCommand /
+// MTLDrawIndexedPrimitivesIndirectArguments order. firstInstance is the visible-instance
+// slot the vertex shader looks its transform up with.
+struct IndexedDrawCommand {
+    uint32_t indexCount = 0;
+    uint32_t instanceCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+    uint32_t firstInstance = 0;
+};
+static_assert(sizeof(IndexedDrawCommand) == 20, "IndexedDrawCommand must match shader layout");
+
+// Meshlets the final cull pass found visible, replayed by the next frame's first pass.
+static constexpr const char* kVisibleMeshletHistoryResourceName = "history.visibleMeshlets";
+static constexpr const char* kVisibleMeshletHistoryStateResourceName = "history.visibleMeshletState";
+
+// priority is 0 for resident-group touches and positive for load requests.
+// Requests emitted for the extrapolated camera set kClusterResidencyRequestPrefetchBit
+// in lodLevel.
+static constexpr uint32_t kClusterResidencyRequestPrefetchBit = 1u << 31;
+
 struct ClusterResidencyRequest {
-    uint32_t lodRootNode = UINT32_MAX;
+    float priority = 0.0f;
     uint32_t targetGroupIndex = UINT32_MAX;
     uint32_t lodLevel = 0;
     uint32_t requestFrameIndex = UINT32_MAX;
@@ -61,6 +85,28 @@ struct ClusterResidencyRequest {
 static_assert(sizeof(ClusterResidencyRequest) == 16,
               "ClusterResidencyRequest must match shader layout");
 
+// A LOD node whose traversal continues in a follow-up dispatch. lodLevel carries
+// kClusterResidencyRequestPrefetchBit for prefetch walks.
+struct ClusterTraversalContinuation {
+    uint32_t visibleInstanceIndex = UINT32_MAX;
+    uint32_t nodeIndex = UINT32_MAX;
+    uint32_t lodLevel = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(ClusterTraversalContinuation) == 16,
+              "ClusterTraversalContinuation must match shader layout");
+
+// Header of the compacted request list; writtenRequestCount requests sorted by
+// descending priority follow it.
+struct ClusterResidencyRequestListHeader {
+    uint32_t requestFrameIndex = UINT32_MAX;
+    uint32_t loadRequestCount = 0;
+    uint32_t writtenRequestCount = 0;
+    uint32_t touchRequestCount = 0;
+};
+static_assert(sizeof(ClusterResidencyRequestListHeader) == sizeof(ClusterResidencyRequest),
+              "ClusterResidencyRequestListHeader must match shader layout");
+
 struct ClusterUnloadRequest {
     uint32_t targetGroupIndex = UINT32_MAX;
     uint32_t requestFrameIndex = UINT32_MAX;
@@ -110,9 +156,13 @@ struct ClusterTraversalStats {
     uint32_t emittedFallbackMeshletCount = 0;
     uint32_t maxSelectedLodLevel = 0;
     uint32_t selectedLodLevelHistogram[kClusterTraversalStatsHistogramSize] = {};
+    // Nodes that overflowed a workgroup's traversal queue and went to the continuation
+    // worklist, and nodes lost because that worklist or its last round overflowed too.
+    uint32_t spilledNodeCount = 0;
+    uint32_t droppedNodeCount = 0;
 };
 static_assert(sizeof(ClusterTraversalStats) ==
-                  sizeof(uint32_t) * (12u + kClusterTraversalStatsHistogramSize),
+                  sizeof(uint32_t) * (14u + kClusterTraversalStatsHistogramSize),
               "ClusterTraversalStats must remain tightly packed");
 
 struct InstanceClassifyUniforms {
@@ -129,6 +179,13 @@ struct InstanceClassifyUniforms {
     uint32_t hzbLevelCount;
     float    occlusionDepthBias;
     float    occlusionBoundsScale;
+    float    pixelsPerWorldUnitAtUnitDepth; // projScale.y * half render height; 0 disables coarsest-LOD routing
+    float    coarsestLodPixelRadius;        // instances projecting to this radius or less take their coarsest level
+    uint32_t viewCount = 1;                 // 2 also keeps what the secondary view sees
+    uint32_t publishGroupCount = 0;         // groups dispatched; the last one publishes the cull args
+    uint32_t pad0[2] = {};
+    float4x4 secondaryViewProj;             // transposed for Slang
+    float4   secondaryCameraWorldPos;
 };
 
 struct CullUniforms {
@@ -155,8 +212,21 @@ struct CullUniforms {
     uint32_t residencyRequestFrameIndex = 0;
     uint32_t cullPassIndex = 0;
     uint32_t currentHzbLevelCount = 0;
-    uint32_t reserved0 = 0;
-    uint32_t reserved1 = 0;
+    uint32_t enableResidencyPrefetch = 0;
+    uint32_t allowTraversalSpill = 0;  // 0 on the last continuation round
+    float4   prefetchCameraWorldPos;   // camera extrapolated along its velocity
+    uint32_t visibleHistoryMode = 0;   // 1 in the pass that records next frame's history
+    uint32_t visibleHistoryTableMask = 0;
+    uint32_t visibleHistoryCapacity = 0;
+    float    softwareRasterTriangleSize = 0.0f; // pixels; 0 keeps every cluster on hardware raster
+    uint32_t orthographicView = 0;     // shadow cascades: projected size does not fall off with distance
+    uint32_t viewCount = 1;            // 2 also keeps what the secondary view sees
+    uint32_t lodCutHistoryMode = 0;    // GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_*
+    float    lodHysteresisOctaves = 0.0f; // a level changes once the ideal one is this far past it
+    uint32_t residentHeapAddressing = 0; // page table holds resident heap addresses, not offsets
+    uint32_t pad2[3] = {};
+    float4x4 secondaryViewProj;        // transposed for Slang
+    float4   secondaryCameraWorldPos;
 };
 
 struct StreamingAgeFilterUniforms {
@@ -172,6 +242,9 @@ struct StreamingAgeFilterUniforms {
 
 struct StreamingPatch {
     uint32_t groupIndex = UINT32_MAX;
+    // Exclusive prefix sum of clusterCount over the task's load patches; the copy
+    // kernel maps each cluster thread back to its patch with it.
+    uint32_t clusterPrefix = 0;
     uint64_t residentHeapOffset = makeClusterLodGroupPageInvalidAddress();
     uint32_t clusterStart = 0;
     uint32_t clusterCount = 0;
@@ -186,6 +259,13 @@ struct ActiveResidentGroupPatch {
 static_assert(sizeof(ActiveResidentGroupPatch) == sizeof(uint32_t) * 2u,
               "ActiveResidentGroupPatch must match shader layout");
 
+struct StreamingRequestCompactUniforms {
+    uint32_t requestFrameIndex = 0;
+    uint32_t requestCapacity = 0;
+    uint32_t outputCapacity = 0;
+    uint32_t reserved0 = 0;
+};
+
 struct StreamingUpdateUniforms {
     uint32_t patchCount = 0;
     uint32_t copySourceData = 0;
@@ -194,5 +274,10 @@ struct StreamingUpdateUniforms {
     uint32_t groupPageTableCount = 0;
     uint32_t activeResidentGroupCapacity = 0;
     uint32_t patchMode = 0;
+    // With residentHeapAddress set, page table entries become residentHeapAddress plus
+    // the byte offset of the group's meshlet indices instead of the element offset.
+    uint32_t residentHeapAddressing = 0;
+    uint64_t residentHeapAddress = 0;
+    uint32_t copyClusterCount = 0; // clusters the copy dispatch (patchMode 2) covers
     uint32_t reserved1 = 0;
 };
@@ -0,0 +1,87 @@
+#ifndef GPU_DEBUG_MESSAGES_H
+#define GPU_DEBUG_MESSAGES_H
+
+// GPU assert/printf ring shared by C++ and Slang. Kernels call gpuDebugPrint() and
+// gpuAssert() from Shaders/Shared/gpu_debug.slang; those only exist in the
+// METALLIC_GPU_DEBUG_MESSAGES permutation (--gpu-debug-messages) and compile to
+// nothing otherwise, along with the conditions that feed them.
+//
+// Word 0 is the append cursor. It keeps counting past the capacity so the host can
+// report how many messages were lost. Each message is four words: id and three
+// arguments, starting at GPU_DEBUG_MESSAGE_HEADER_WORDS.
+#define GPU_DEBUG_MESSAGE_CAPACITY 256u
+#define GPU_DEBUG_MESSAGE_HEADER_WORDS 4u
+#define GPU_DEBUG_MESSAGE_WORDS 4u
+
+// Message ids. Add the host-side text to gpuDebugMessageInfo() with each new id.
+#define GPU_DEBUG_MSG_CULL_DROPPED_TRAVERSAL_NODE 1u
+#define GPU_DEBUG_MSG_CULL_RESIDENT_GROUP_UNMAPPED 2u
+
+#ifdef __cplusplus
+
+#include <algorithm>
+#include <cstdint>
+
+#include "rhi_backend.h"
+#include <spdlog/spdlog.h>
+
+static constexpr uint32_t kGpuDebugMessageCapacity = GPU_DEBUG_MESSAGE_CAPACITY;
+static constexpr uint32_t kGpuDebugMessageWordCount =
+    GPU_DEBUG_MESSAGE_HEADER_WORDS + GPU_DEBUG_MESSAGE_CAPACITY * GPU_DEBUG_MESSAGE_WORDS;
+
+struct GpuDebugMessageInfo {
+    const char* text;
+    const char* argNames[3];
+};
+
+inline GpuDebugMessageInfo gpuDebugMessageInfo(uint32_t id) {
+    switch (id) {
+    case GPU_DEBUG_MSG_CULL_DROPPED_TRAVERSAL_NODE:
+        return {"cluster traversal dropped a node", {"visibleInstance", "node", "lod"}};
+    case GPU_DEBUG_MSG_CULL_RESIDENT_GROUP_UNMAPPED:
+        return {"resident LOD group has no page table entry", {"group", "residencyState", "lod"}};
+    default:
+        return {"unknown message", {"a", "b", "c"}};
+    }
+}
+
+// Host-visible like the traversal stats: the frame graph copies initialData into a
+// pooled buffer on every reuse, so the cursor starts at zero each frame without a
+// clear dispatch.
+inline RhiBufferDesc makeGpuDebugMessageBufferDesc(const char* debugName) {
+    static const uint32_t kZeroWords[kGpuDebugMessageWordCount] = {};
+    RhiBufferDesc desc;
+    desc.size = sizeof(kZeroWords);
+    desc.initialData = kZeroWords;
+    desc.memory = RhiBufferMemory::Upload;
+    desc.debugName = debugName;
+    return desc;
+}
+
+// Logs one readback of the ring. A kernel that fires every thread would flood the
+// log, so only the first maxLogged messages are printed and the rest are counted.
+inline void logGpuDebugMessages(const char* source, const uint32_t* words, uint32_t maxLogged = 16u) {
+    const uint32_t written = words[0];
+    if (written == 0u) {
+        return;
+    }
+    const uint32_t stored = std::min(written, kGpuDebugMessageCapacity);
+    const uint32_t logged = std::min(stored, maxLogged);
+    for (uint32_t i = 0; i < logged; ++i) {
+        const uint32_t* message = words + GPU_DEBUG_MESSAGE_HEADER_WORDS + i * GPU_DEBUG_MESSAGE_WORDS;
+        const GpuDebugMessageInfo info = gpuDebugMessageInfo(message[0]);
+        spdlog::warn("[GPU] {}: {} (id={} {}={} {}={} {}={})",
+                     source, info.text, message[0],
+                     info.argNames[0], message[1],
+                     info.argNames[1], message[2],
+                     info.argNames[2], message[3]);
+    }
+    if (written > logged) {
+        spdlog::warn("[GPU] {}: {} more messages not shown ({} past the ring capacity)",
+                     source, written - logged, written - stored);
+    }
+}
+
+#endif
+
+#endif
@@ -18,8 +18,10 @@
 #define GPU_DRIVEN_WORKLIST_DISPATCH_X_OFFSET_BYTES 12u
 #define GPU_DRIVEN_WORKLIST_DISPATCH_Y_OFFSET_BYTES 16u
 #define GPU_DRIVEN_WORKLIST_DISPATCH_Z_OFFSET_BYTES 20u
-#define GPU_DRIVEN_WORKLIST_STATE_WORD_COUNT 6u
-#define GPU_DRIVEN_WORKLIST_STATE_BUFFER_SIZE 24u
+// Producer groups done so far; the last one publishes the indirect args itself.
+#define GPU_DRIVEN_WORKLIST_FINISHED_GROUPS_OFFSET_BYTES 24u
+#define GPU_DRIVEN_WORKLIST_STATE_WORD_COUNT 7u
+#define GPU_DRIVEN_WORKLIST_STATE_BUFFER_SIZE 28u
 
 // Compatibility aliases for the original counter/indirect helpers.
 #define GPU_DRIVEN_COUNT_OFFSET_BYTES GPU_DRIVEN_WORKLIST_WRITE_CURSOR_OFFSET_BYTES
@@ -32,11 +34,13 @@
 
 // Shared bindings for the instance classification front-end.
 #define GPU_DRIVEN_INSTANCE_CLASSIFY_UNIFORMS_BINDING 0u
-#define GPU_DRIVEN_INSTANCE_CLASSIFY_INSTANCE_DATA_BINDING 1u
-#define GPU_DRIVEN_INSTANCE_CLASSIFY_GEOMETRY_DATA_BINDING 2u
-#define GPU_DRIVEN_INSTANCE_CLASSIFY_OUTPUT_BINDING 3u
-#define GPU_DRIVEN_INSTANCE_CLASSIFY_STATE_BINDING 4u
-#define GPU_DRIVEN_INSTANCE_CLASSIFY_HZB_TEXTURE_BINDING_BASE 5u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_CULL_DATA_BINDING 1u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_OUTPUT_BINDING 2u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_STATE_BINDING 3u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_HZB_TEXTURE_BINDING 4u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_NODE_BINDING 5u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_INSTANCE_BINDING 6u
+#define GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_SUBTREE_ROOT_BINDING 7u
 
 // Shared bindings for the meshlet cull compaction pipeline.
 #define GPU_DRIVEN_CULL_UNIFORMS_BINDING 0u
@@ -58,10 +62,36 @@
 #define GPU_DRIVEN_CULL_RESIDENCY_REQUEST_STATE_BINDING 15u
 #define GPU_DRIVEN_CULL_LOD_GROUP_MESHLET_INDICES_SOURCE_BINDING 16u
 #define GPU_DRIVEN_CULL_GROUP_AGE_BINDING 17u
-#define GPU_DRIVEN_CULL_HZB_TEXTURE_BINDING_BASE 18u
-#define GPU_DRIVEN_HZB_TEXTURE_BINDING_COUNT 10u
-#define GPU_DRIVEN_CULL_CURRENT_HZB_TEXTURE_BINDING_BASE \
-    (GPU_DRIVEN_CULL_HZB_TEXTURE_BINDING_BASE + GPU_DRIVEN_HZB_TEXTURE_BINDING_COUNT)
+#define GPU_DRIVEN_CULL_HZB_TEXTURE_BINDING 18u
+#define GPU_DRIVEN_CULL_CURRENT_HZB_TEXTURE_BINDING 19u
+#define GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_BINDING 20u
+#define GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_STATE_BINDING 21u
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_BINDING 22u
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_STATE_BINDING 23u
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_TABLE_BINDING 24u
+#define GPU_DRIVEN_CULL_MESHLET_MATERIAL_IDS_BINDING 25u
+#define GPU_DRIVEN_CULL_LOD_MATERIAL_IDS_BINDING 26u
+#define GPU_DRIVEN_CULL_MATERIALS_BINDING 27u
+#define GPU_DRIVEN_CULL_LOD_CUT_HISTORY_BINDING 28u
+// Only declared by the METALLIC_GPU_DEBUG_MESSAGES permutation (gpu_debug.slang).
+#define GPU_DRIVEN_CULL_DEBUG_MESSAGES_BINDING 29u
+
+// Nodes the per-workgroup traversal queue cannot hold spill into this many
+// continuation slots; they are finished by follow-up indirect rounds.
+#define GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_CAPACITY 65536u
+#define GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_ROUNDS 2u
+
+// CullUniforms::visibleHistoryMode. The first pass indexes what it draws into the
+// visible-history table; the second records next frame's list and skips those entries.
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_OFF 0u
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_RECORD 1u
+#define GPU_DRIVEN_CULL_VISIBLE_HISTORY_MODE_INDEX 2u
+
+// CullUniforms::lodCutHistoryMode. Each instance's selected LOD level persists per
+// cull pass; after a camera cut the pass only records it.
+#define GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_OFF 0u
+#define GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_RECORD 1u
+#define GPU_DRIVEN_CULL_LOD_CUT_HISTORY_MODE_UPDATE 2u
 
 // Shared bindings for the streaming age filter pipeline.
 #define GPU_DRIVEN_STREAMING_AGE_UNIFORMS_BINDING 0u
@@ -84,6 +114,26 @@
 #define GPU_DRIVEN_STREAMING_UPDATE_GROUP_RESIDENCY_BINDING 8u
 #define GPU_DRIVEN_STREAMING_UPDATE_GROUP_AGE_BINDING 9u
 
+// Shared bindings for the streaming request compaction pipeline.
+#define GPU_DRIVEN_STREAMING_COMPACT_UNIFORMS_BINDING 0u
+#define GPU_DRIVEN_STREAMING_COMPACT_RESIDENCY_REQUESTS_BINDING 1u
+#define GPU_DRIVEN_STREAMING_COMPACT_RESIDENCY_REQUEST_STATE_BINDING 2u
+#define GPU_DRIVEN_STREAMING_COMPACT_OUTPUT_BINDING 3u
+
+// Shared bindings for the indexed-draw command build (forward vertex path).
+#define GPU_DRIVEN_INDEXED_DRAW_BUILD_UNIFORMS_BINDING 0u
+#define GPU_DRIVEN_INDEXED_DRAW_BUILD_VISIBLE_INSTANCES_BINDING 1u
+#define GPU_DRIVEN_INDEXED_DRAW_BUILD_VISIBLE_INSTANCE_STATE_BINDING 2u
+#define GPU_DRIVEN_INDEXED_DRAW_BUILD_GEOMETRY_DATA_BINDING 3u
+#define GPU_DRIVEN_INDEXED_DRAW_BUILD_COMMANDS_BINDING 4u
+
+// Shared bindings for the forward vertex pipeline drawn from those commands.
+#define GPU_DRIVEN_FORWARD_INDIRECT_UNIFORMS_BINDING 0u
+#define GPU_DRIVEN_FORWARD_INDIRECT_POSITION_BINDING 1u
+#define GPU_DRIVEN_FORWARD_INDIRECT_NORMAL_BINDING 2u
+#define GPU_DRIVEN_FORWARD_INDIRECT_INSTANCE_DATA_BINDING 3u
+#define GPU_DRIVEN_FORWARD_INDIRECT_VISIBLE_INSTANCES_BINDING 4u
+
 // Shared bindings for meshlet visibility pipelines.
 #define GPU_DRIVEN_VISIBILITY_GLOBAL_UNIFORMS_BINDING 0u
 #define GPU_DRIVEN_VISIBILITY_POSITION_BINDING 1u
@@ -101,6 +151,18 @@
 #define GPU_DRIVEN_VISIBILITY_LOD_MESHLET_VERTICES_BINDING 13u
 #define GPU_DRIVEN_VISIBILITY_LOD_MESHLET_TRIANGLES_BINDING 14u
 #define GPU_DRIVEN_VISIBILITY_LOD_MATERIAL_IDS_BINDING 15u
+// visibility_swraster.slang binds the buffers above plus its 64-bit depth|visibility target.
+#define GPU_DRIVEN_VISIBILITY_SOFTWARE_RASTER_BINDING 16u
+// Per-triangle tests in the visibility mesh shader (GlobalUniforms::triangleCullMask).
+#define GPU_DRIVEN_TRIANGLE_CULL_FRUSTUM 1u
+#define GPU_DRIVEN_TRIANGLE_CULL_BACKFACE 2u
+#define GPU_DRIVEN_TRIANGLE_CULL_SMALL 4u
+
+// Shared bindings for the fullscreen software raster resolve.
+#define GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_UNIFORMS_BINDING 0u
+#define GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_TARGET_BINDING 1u
+// 64-bit visibility only: expands software-raster payloads to full IDs.
+#define GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_VISIBLE_MESHLETS_BINDING 2u
 
 // Shared bindings for deferred lighting when visibility encodes visible-worklist IDs.
 #define GPU_DRIVEN_DEFERRED_VISIBLE_MESHLETS_BINDING 9u
@@ -110,18 +172,70 @@
 #define GPU_DRIVEN_DEFERRED_LOD_MESHLET_TRIANGLES_BINDING 13u
 #define GPU_DRIVEN_DEFERRED_LOD_MATERIAL_IDS_BINDING 14u
 #define GPU_DRIVEN_DEFERRED_INSTANCE_DATA_BINDING 15u
+#define GPU_DRIVEN_DEFERRED_TEXTURE_FEEDBACK_BINDING 16u
+#define GPU_DRIVEN_DEFERRED_SKY_TILES_BINDING 17u
+#define GPU_DRIVEN_DEFERRED_UNTEXTURED_TILES_BINDING 18u
+#define GPU_DRIVEN_DEFERRED_TEXTURED_TILES_BINDING 19u
+#define GPU_DRIVEN_DEFERRED_SKY_TILE_STATE_BINDING 20u
+#define GPU_DRIVEN_DEFERRED_UNTEXTURED_TILE_STATE_BINDING 21u
+#define GPU_DRIVEN_DEFERRED_TEXTURED_TILE_STATE_BINDING 22u
+#define GPU_DRIVEN_DEFERRED_PUNCTUAL_LIGHTS_BINDING 23u
+#define GPU_DRIVEN_DEFERRED_LIGHT_CLUSTER_GRID_BINDING 24u
+#define GPU_DRIVEN_DEFERRED_LIGHT_CLUSTER_INDICES_BINDING 25u
+#define GPU_DRIVEN_DEFERRED_COARSE_TILES_BINDING 26u
+#define GPU_DRIVEN_DEFERRED_COARSE_TILE_STATE_BINDING 27u
+#define GPU_DRIVEN_DEFERRED_PREV_SHADING_RATE_BINDING 28u
+#define GPU_DRIVEN_DEFERRED_SHADING_RATE_BINDING 29u
+#define GPU_DRIVEN_DEFERRED_PREV_TRANSFORMS_BINDING 30u
+#define GPU_DRIVEN_LIGHT_CULL_LIGHTS_BINDING 1u
+#define GPU_DRIVEN_LIGHT_CULL_CLUSTER_GRID_BINDING 2u
+#define GPU_DRIVEN_LIGHT_CULL_CLUSTER_INDICES_BINDING 3u
+#define GPU_DRIVEN_LIGHT_CULL_INDEX_STATE_BINDING 4u
 
 // Shared bindings for helper passes that convert counters into indirect args.
 #define GPU_DRIVEN_BUILD_DISPATCH_COUNTER_BINDING 0u
 
 // Shared bindings for the cluster visualization render pass.
 #define GPU_DRIVEN_CLUSTER_VIS_UNIFORMS_BINDING 0u
-#define GPU_DRIVEN_CLUSTER_VIS_CLUSTER_INFOS_BINDING 1u
+#define GPU_DRIVEN_CLUSTER_VIS_VISIBLE_MESHLETS_BINDING 1u
 #define GPU_DRIVEN_CLUSTER_VIS_PACKED_CLUSTERS_BINDING 2u
 #define GPU_DRIVEN_CLUSTER_VIS_VERTEX_DATA_BINDING 3u
 #define GPU_DRIVEN_CLUSTER_VIS_INDEX_DATA_BINDING 4u
 #define GPU_DRIVEN_CLUSTER_VIS_INSTANCE_DATA_BINDING 5u
 
+// Shared bindings for the GPU transform hierarchy pass; one dispatch per depth level.
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_SLOTS_BINDING 0u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_LOCALS_BINDING 1u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_WORLDS_BINDING 2u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_INSTANCE_DATA_BINDING 3u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_PREV_TRANSFORMS_BINDING 4u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_CULL_DATA_BINDING 5u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_GEOMETRY_DATA_BINDING 6u
+#define GPU_DRIVEN_TRANSFORM_HIERARCHY_THREADGROUP_SIZE 64u
+
+// Shared bindings for the skinning pass: skinMain deforms one primitive group's
+// vertices in place, refitMain rebuilds that group's meshlet bounds.
+#define GPU_DRIVEN_SKINNING_REST_POSITIONS_BINDING 0u
+#define GPU_DRIVEN_SKINNING_REST_NORMALS_BINDING 1u
+#define GPU_DRIVEN_SKINNING_JOINTS_BINDING 2u
+#define GPU_DRIVEN_SKINNING_WEIGHTS_BINDING 3u
+#define GPU_DRIVEN_SKINNING_MORPH_DELTAS_BINDING 4u
+#define GPU_DRIVEN_SKINNING_PALETTE_BINDING 5u
+#define GPU_DRIVEN_SKINNING_MORPH_WEIGHTS_BINDING 6u
+#define GPU_DRIVEN_SKINNING_POSITIONS_BINDING 7u
+#define GPU_DRIVEN_SKINNING_NORMALS_BINDING 8u
+#define GPU_DRIVEN_SKINNING_MESHLETS_BINDING 9u
+#define GPU_DRIVEN_SKINNING_MESHLET_VERTICES_BINDING 10u
+#define GPU_DRIVEN_SKINNING_MESHLET_BOUNDS_BINDING 11u
+#define GPU_DRIVEN_SKINNING_THREADGROUP_SIZE 64u
+
+// Shared bindings for the viewport pick pass; one thread decodes one texel.
+#define GPU_DRIVEN_PICK_VISIBLE_MESHLETS_BINDING 0u
+#define GPU_DRIVEN_PICK_VISIBLE_MESHLET_STATE_BINDING 1u
+#define GPU_DRIVEN_PICK_INSTANCE_DATA_BINDING 2u
+#define GPU_DRIVEN_PICK_RESULT_BINDING 3u
+#define GPU_DRIVEN_PICK_VISIBILITY_TEXTURE_BINDING 0u
+
 #ifdef __cplusplus
 
 #include <cstdint>
@@ -137,6 +251,8 @@ struct WorklistStateHeaderLayout {
     static constexpr uint32_t kWriteCursorWord = kWriteCursorOffset / sizeof(uint32_t);
     static constexpr uint32_t kProducedCountWord = kProducedCountOffset / sizeof(uint32_t);
     static constexpr uint32_t kConsumedCountWord = kConsumedCountOffset / sizeof(uint32_t);
+    static constexpr uint32_t kFinishedGroupsOffset = GPU_DRIVEN_WORKLIST_FINISHED_GROUPS_OFFSET_BYTES;
+    static constexpr uint32_t kFinishedGroupsWord = kFinishedGroupsOffset / sizeof(uint32_t);
 };
 
 struct ComputeDispatchCommandLayout : WorklistStateHeaderLayout {
@@ -180,11 +296,13 @@ using DispatchCounterLayout = ComputeDispatchCommandLayout;
 
 struct InstanceClassifyBindings {
     static constexpr uint32_t kUniforms = GPU_DRIVEN_INSTANCE_CLASSIFY_UNIFORMS_BINDING;
-    static constexpr uint32_t kInstances = GPU_DRIVEN_INSTANCE_CLASSIFY_INSTANCE_DATA_BINDING;
-    static constexpr uint32_t kGeometries = GPU_DRIVEN_INSTANCE_CLASSIFY_GEOMETRY_DATA_BINDING;
+    static constexpr uint32_t kInstanceCull = GPU_DRIVEN_INSTANCE_CLASSIFY_CULL_DATA_BINDING;
     static constexpr uint32_t kOutput = GPU_DRIVEN_INSTANCE_CLASSIFY_OUTPUT_BINDING;
     static constexpr uint32_t kState = GPU_DRIVEN_INSTANCE_CLASSIFY_STATE_BINDING;
-    static constexpr uint32_t kHzbTextureBase = GPU_DRIVEN_INSTANCE_CLASSIFY_HZB_TEXTURE_BINDING_BASE;
+    static constexpr uint32_t kHzbTexture = GPU_DRIVEN_INSTANCE_CLASSIFY_HZB_TEXTURE_BINDING;
+    static constexpr uint32_t kBvhNodes = GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_NODE_BINDING;
+    static constexpr uint32_t kBvhInstances = GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_INSTANCE_BINDING;
+    static constexpr uint32_t kBvhSubtreeRoots = GPU_DRIVEN_INSTANCE_CLASSIFY_BVH_SUBTREE_ROOT_BINDING;
 };
 
 struct MeshletCullBindings {
@@ -208,9 +326,19 @@ struct MeshletCullBindings {
     static constexpr uint32_t kLodGroupMeshletIndicesSource =
         GPU_DRIVEN_CULL_LOD_GROUP_MESHLET_INDICES_SOURCE_BINDING;
     static constexpr uint32_t kGroupAge = GPU_DRIVEN_CULL_GROUP_AGE_BINDING;
-    static constexpr uint32_t kHzbTextureBase = GPU_DRIVEN_CULL_HZB_TEXTURE_BINDING_BASE;
-    static constexpr uint32_t kCurrentHzbTextureBase =
-        GPU_DRIVEN_CULL_CURRENT_HZB_TEXTURE_BINDING_BASE;
+    static constexpr uint32_t kHzbTexture = GPU_DRIVEN_CULL_HZB_TEXTURE_BINDING;
+    static constexpr uint32_t kCurrentHzbTexture = GPU_DRIVEN_CULL_CURRENT_HZB_TEXTURE_BINDING;
+    static constexpr uint32_t kTraversalContinuations = GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_BINDING;
+    static constexpr uint32_t kTraversalContinuationState =
+        GPU_DRIVEN_CULL_TRAVERSAL_CONTINUATION_STATE_BINDING;
+    static constexpr uint32_t kVisibleHistory = GPU_DRIVEN_CULL_VISIBLE_HISTORY_BINDING;
+    static constexpr uint32_t kVisibleHistoryState = GPU_DRIVEN_CULL_VISIBLE_HISTORY_STATE_BINDING;
+    static constexpr uint32_t kVisibleHistoryTable = GPU_DRIVEN_CULL_VISIBLE_HISTORY_TABLE_BINDING;
+    static constexpr uint32_t kMeshletMaterialIds = GPU_DRIVEN_CULL_MESHLET_MATERIAL_IDS_BINDING;
+    static constexpr uint32_t kLodMaterialIds = GPU_DRIVEN_CULL_LOD_MATERIAL_IDS_BINDING;
+    static constexpr uint32_t kMaterials = GPU_DRIVEN_CULL_MATERIALS_BINDING;
+    static constexpr uint32_t kLodCutHistory = GPU_DRIVEN_CULL_LOD_CUT_HISTORY_BINDING;
+    static constexpr uint32_t kDebugMessages = GPU_DRIVEN_CULL_DEBUG_MESSAGES_BINDING;
     static constexpr uint32_t kInstanceData = kInstances;
 };
 
@@ -227,6 +355,15 @@ struct StreamingAgeFilterBindings {
         GPU_DRIVEN_STREAMING_AGE_ACTIVE_RESIDENT_GROUPS_BINDING;
 };
 
+struct StreamingRequestCompactBindings {
+    static constexpr uint32_t kUniforms = GPU_DRIVEN_STREAMING_COMPACT_UNIFORMS_BINDING;
+    static constexpr uint32_t kResidencyRequests =
+        GPU_DRIVEN_STREAMING_COMPACT_RESIDENCY_REQUESTS_BINDING;
+    static constexpr uint32_t kResidencyRequestState =
+        GPU_DRIVEN_STREAMING_COMPACT_RESIDENCY_REQUEST_STATE_BINDING;
+    static constexpr uint32_t kOutput = GPU_DRIVEN_STREAMING_COMPACT_OUTPUT_BINDING;
+};
+
 struct StreamingUpdateBindings {
     static constexpr uint32_t kUniforms = GPU_DRIVEN_STREAMING_UPDATE_UNIFORMS_BINDING;
     static constexpr uint32_t kSourceGroupMeshletIndices =
@@ -246,6 +383,23 @@ struct StreamingUpdateBindings {
     static constexpr uint32_t kGroupAge = GPU_DRIVEN_STREAMING_UPDATE_GROUP_AGE_BINDING;
 };
 
+struct IndexedDrawBuildBindings {
+    static constexpr uint32_t kUniforms = GPU_DRIVEN_INDEXED_DRAW_BUILD_UNIFORMS_BINDING;
+    static constexpr uint32_t kVisibleInstances = GPU_DRIVEN_INDEXED_DRAW_BUILD_VISIBLE_INSTANCES_BINDING;
+    static constexpr uint32_t kVisibleInstanceState =
+        GPU_DRIVEN_INDEXED_DRAW_BUILD_VISIBLE_INSTANCE_STATE_BINDING;
+    static constexpr uint32_t kGeometries = GPU_DRIVEN_INDEXED_DRAW_BUILD_GEOMETRY_DATA_BINDING;
+    static constexpr uint32_t kCommands = GPU_DRIVEN_INDEXED_DRAW_BUILD_COMMANDS_BINDING;
+};
+
+struct ForwardIndirectBindings {
+    static constexpr uint32_t kUniforms = GPU_DRIVEN_FORWARD_INDIRECT_UNIFORMS_BINDING;
+    static constexpr uint32_t kPositions = GPU_DRIVEN_FORWARD_INDIRECT_POSITION_BINDING;
+    static constexpr uint32_t kNormals = GPU_DRIVEN_FORWARD_INDIRECT_NORMAL_BINDING;
+    static constexpr uint32_t kSceneInstances = GPU_DRIVEN_FORWARD_INDIRECT_INSTANCE_DATA_BINDING;
+    static constexpr uint32_t kVisibleInstances = GPU_DRIVEN_FORWARD_INDIRECT_VISIBLE_INSTANCES_BINDING;
+};
+
 struct MeshletVisibilityBindings {
     static constexpr uint32_t kGlobalUniforms = GPU_DRIVEN_VISIBILITY_GLOBAL_UNIFORMS_BINDING;
     static constexpr uint32_t kPositions = GPU_DRIVEN_VISIBILITY_POSITION_BINDING;
@@ -264,6 +418,13 @@ struct MeshletVisibilityBindings {
     static constexpr uint32_t kLodMeshletTriangles = GPU_DRIVEN_VISIBILITY_LOD_MESHLET_TRIANGLES_BINDING;
     static constexpr uint32_t kLodMaterialIds = GPU_DRIVEN_VISIBILITY_LOD_MATERIAL_IDS_BINDING;
     static constexpr uint32_t kInstanceData = kSceneInstances;
+    static constexpr uint32_t kSoftwareRaster = GPU_DRIVEN_VISIBILITY_SOFTWARE_RASTER_BINDING;
+};
+
+struct SoftwareRasterResolveBindings {
+    static constexpr uint32_t kUniforms = GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_UNIFORMS_BINDING;
+    static constexpr uint32_t kSoftwareRaster = GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_TARGET_BINDING;
+    static constexpr uint32_t kVisibleMeshlets = GPU_DRIVEN_SOFTWARE_RASTER_RESOLVE_VISIBLE_MESHLETS_BINDING;
 };
 
 struct DeferredLightingBindings {
@@ -282,6 +443,28 @@ struct DeferredLightingBindings {
     static constexpr uint32_t kLodMeshletTriangles = GPU_DRIVEN_DEFERRED_LOD_MESHLET_TRIANGLES_BINDING;
     static constexpr uint32_t kLodMaterialIds = GPU_DRIVEN_DEFERRED_LOD_MATERIAL_IDS_BINDING;
     static constexpr uint32_t kInstanceData = GPU_DRIVEN_DEFERRED_INSTANCE_DATA_BINDING;
+    static constexpr uint32_t kTextureFeedback = GPU_DRIVEN_DEFERRED_TEXTURE_FEEDBACK_BINDING;
+    static constexpr uint32_t kSkyTiles = GPU_DRIVEN_DEFERRED_SKY_TILES_BINDING;
+    static constexpr uint32_t kUntexturedTiles = GPU_DRIVEN_DEFERRED_UNTEXTURED_TILES_BINDING;
+    static constexpr uint32_t kTexturedTiles = GPU_DRIVEN_DEFERRED_TEXTURED_TILES_BINDING;
+    static constexpr uint32_t kSkyTileState = GPU_DRIVEN_DEFERRED_SKY_TILE_STATE_BINDING;
+    static constexpr uint32_t kUntexturedTileState = GPU_DRIVEN_DEFERRED_UNTEXTURED_TILE_STATE_BINDING;
+    static constexpr uint32_t kTexturedTileState = GPU_DRIVEN_DEFERRED_TEXTURED_TILE_STATE_BINDING;
+    static constexpr uint32_t kPunctualLights = GPU_DRIVEN_DEFERRED_PUNCTUAL_LIGHTS_BINDING;
+    static constexpr uint32_t kLightClusterGrid = GPU_DRIVEN_DEFERRED_LIGHT_CLUSTER_GRID_BINDING;
+    static constexpr uint32_t kLightClusterIndices = GPU_DRIVEN_DEFERRED_LIGHT_CLUSTER_INDICES_BINDING;
+    static constexpr uint32_t kCoarseTiles = GPU_DRIVEN_DEFERRED_COARSE_TILES_BINDING;
+    static constexpr uint32_t kCoarseTileState = GPU_DRIVEN_DEFERRED_COARSE_TILE_STATE_BINDING;
+    static constexpr uint32_t kPrevShadingRate = GPU_DRIVEN_DEFERRED_PREV_SHADING_RATE_BINDING;
+    static constexpr uint32_t kShadingRate = GPU_DRIVEN_DEFERRED_SHADING_RATE_BINDING;
+    static constexpr uint32_t kPrevTransforms = GPU_DRIVEN_DEFERRED_PREV_TRANSFORMS_BINDING;
+};
+
+struct LightCullBindings {
+    static constexpr uint32_t kLights = GPU_DRIVEN_LIGHT_CULL_LIGHTS_BINDING;
+    static constexpr uint32_t kClusterGrid = GPU_DRIVEN_LIGHT_CULL_CLUSTER_GRID_BINDING;
+    static constexpr uint32_t kClusterIndices = GPU_DRIVEN_LIGHT_CULL_CLUSTER_INDICES_BINDING;
+    static constexpr uint32_t kIndexState = GPU_DRIVEN_LIGHT_CULL_INDEX_STATE_BINDING;
 };
 
 struct BuildWorklistBindings {
@@ -292,13 +475,48 @@ using BuildDispatchBindings = BuildWorklistBindings;
 
 struct ClusterRenderBindings {
     static constexpr uint32_t kUniforms = GPU_DRIVEN_CLUSTER_VIS_UNIFORMS_BINDING;
-    static constexpr uint32_t kClusterInfos = GPU_DRIVEN_CLUSTER_VIS_CLUSTER_INFOS_BINDING;
+    static constexpr uint32_t kVisibleMeshlets = GPU_DRIVEN_CLUSTER_VIS_VISIBLE_MESHLETS_BINDING;
     static constexpr uint32_t kClusters = GPU_DRIVEN_CLUSTER_VIS_PACKED_CLUSTERS_BINDING;
     static constexpr uint32_t kVertexData = GPU_DRIVEN_CLUSTER_VIS_VERTEX_DATA_BINDING;
     static constexpr uint32_t kIndexData = GPU_DRIVEN_CLUSTER_VIS_INDEX_DATA_BINDING;
     static constexpr uint32_t kInstances = GPU_DRIVEN_CLUSTER_VIS_INSTANCE_DATA_BINDING;
 };
 
+struct TransformHierarchyBindings {
+    static constexpr uint32_t kSlots = GPU_DRIVEN_TRANSFORM_HIERARCHY_SLOTS_BINDING;
+    static constexpr uint32_t kLocals = GPU_DRIVEN_TRANSFORM_HIERARCHY_LOCALS_BINDING;
+    static constexpr uint32_t kWorlds = GPU_DRIVEN_TRANSFORM_HIERARCHY_WORLDS_BINDING;
+    static constexpr uint32_t kInstances = GPU_DRIVEN_TRANSFORM_HIERARCHY_INSTANCE_DATA_BINDING;
+    static constexpr uint32_t kPrevTransforms = GPU_DRIVEN_TRANSFORM_HIERARCHY_PREV_TRANSFORMS_BINDING;
+    static constexpr uint32_t kInstanceCull = GPU_DRIVEN_TRANSFORM_HIERARCHY_CULL_DATA_BINDING;
+    static constexpr uint32_t kGeometries = GPU_DRIVEN_TRANSFORM_HIERARCHY_GEOMETRY_DATA_BINDING;
+    static constexpr uint32_t kThreadgroupSize = GPU_DRIVEN_TRANSFORM_HIERARCHY_THREADGROUP_SIZE;
+};
+
+struct SkinningBindings {
+    static constexpr uint32_t kRestPositions = GPU_DRIVEN_SKINNING_REST_POSITIONS_BINDING;
+    static constexpr uint32_t kRestNormals = GPU_DRIVEN_SKINNING_REST_NORMALS_BINDING;
+    static constexpr uint32_t kJoints = GPU_DRIVEN_SKINNING_JOINTS_BINDING;
+    static constexpr uint32_t kWeights = GPU_DRIVEN_SKINNING_WEIGHTS_BINDING;
+    static constexpr uint32_t kMorphDeltas = GPU_DRIVEN_SKINNING_MORPH_DELTAS_BINDING;
+    static constexpr uint32_t kPalette = GPU_DRIVEN_SKINNING_PALETTE_BINDING;
+    static constexpr uint32_t kMorphWeights = GPU_DRIVEN_SKINNING_MORPH_WEIGHTS_BINDING;
+    static constexpr uint32_t kPositions = GPU_DRIVEN_SKINNING_POSITIONS_BINDING;
+    static constexpr uint32_t kNormals = GPU_DRIVEN_SKINNING_NORMALS_BINDING;
+    static constexpr uint32_t kMeshlets = GPU_DRIVEN_SKINNING_MESHLETS_BINDING;
+    static constexpr uint32_t kMeshletVertices = GPU_DRIVEN_SKINNING_MESHLET_VERTICES_BINDING;
+    static constexpr uint32_t kMeshletBounds = GPU_DRIVEN_SKINNING_MESHLET_BOUNDS_BINDING;
+    static constexpr uint32_t kThreadgroupSize = GPU_DRIVEN_SKINNING_THREADGROUP_SIZE;
+};
+
+struct ViewportPickBindings {
+    static constexpr uint32_t kVisibleMeshlets = GPU_DRIVEN_PICK_VISIBLE_MESHLETS_BINDING;
+    static constexpr uint32_t kVisibleMeshletState = GPU_DRIVEN_PICK_VISIBLE_MESHLET_STATE_BINDING;
+    static constexpr uint32_t kInstances = GPU_DRIVEN_PICK_INSTANCE_DATA_BINDING;
+    static constexpr uint32_t kResult = GPU_DRIVEN_PICK_RESULT_BINDING;
+    static constexpr uint32_t kVisibilityTexture = GPU_DRIVEN_PICK_VISIBILITY_TEXTURE_BINDING;
+};
+
 static_assert(ComputeDispatchCommandLayout::kBufferSize ==
               ComputeDispatchCommandLayout::kWordCount * sizeof(uint32_t));
 static_assert(TaskDispatchCommandLayout::kBufferSize ==
@@ -15,7 +15,7 @@ inline FGBufferDesc makeStructuredBufferDesc(size_t elementCapacity,
                                              bool hostVisible = false) {
     FGBufferDesc desc;
     desc.size = elementCapacity * sizeof(T);
-    desc.hostVisible = hostVisible;
+    desc.memory = hostVisible ? RhiBufferMemory::Upload : RhiBufferMemory::DeviceLocal;
     desc.debugName = debugName;
     return desc;
 }
@@ -25,7 +25,7 @@ inline FGBufferDesc makeWorklistStateBufferDesc(const char* debugName,
                                                 bool hostVisible = true) {
     FGBufferDesc desc;
     desc.size = IndirectLayout::kBufferSize;
-    desc.hostVisible = hostVisible;
+    desc.memory = hostVisible ? RhiBufferMemory::Upload : RhiBufferMemory::DeviceLocal;
     desc.debugName = debugName;
     return desc;
 }
@@ -128,6 +128,7 @@ inline void seedWorklistStateBuffer(RhiBuffer* buffer) {
     words[IndirectLayout::kDispatchXWord] = 0u;
     words[IndirectLayout::kDispatchYWord] = 1u;
     words[IndirectLayout::kDispatchZWord] = 1u;
+    words[IndirectLayout::kFinishedGroupsWord] = 0u;
 }
 
 inline void seedIndirectGridCommandBuffer(RhiBuffer* buffer) {
@@ -196,16 +197,6 @@ inline uint32_t readConsumedWorkItemCount(const RhiBuffer* buffer) {
     return words[IndirectLayout::kConsumedCountWord];
 }
 
-template <typename IndirectLayout>
-inline uint32_t readBuiltIndirectGroupCount(const RhiBuffer* buffer) {
-    const uint32_t* words = worklistStateWords<IndirectLayout>(buffer);
-    if (!words) {
-        return 0u;
-    }
-
-    return words[IndirectLayout::kDispatchXWord];
-}
-
 inline uint32_t readBuiltIndirectGridCount(const RhiBuffer* buffer) {
     return readPublishedWorkItemCount<ComputeDispatchCommandLayout>(buffer);
 }
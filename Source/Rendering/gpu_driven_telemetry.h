@@ -0,0 +1,263 @@
+#pragma once
+
+#include "gpu_cull_resources.h"
+
+#include "imgui.h"
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+// Per-frame work funnel of the GPU-driven cluster pipeline, from scene instances
+// down to shaded pixels, so lodReferencePixels and the cull heuristics can be tuned
+// against what each stage actually hands to the next. MeshletCullPass reports its
+// ClusterTraversalStats through an asynchronous readback; main-view VisibilityPasses
+// report their GPU time and pipeline statistics. Each source lands a few frames late, and
+// commitFrame() snapshots the newest value of every source once per frame.
+struct GpuDrivenFunnelSample {
+    uint64_t frame = 0;
+    uint64_t instances = 0;
+    uint64_t visibleInstances = 0;
+    uint64_t traversedNodes = 0;
+    uint64_t occludedNodes = 0;
+    uint64_t candidateGroups = 0;
+    uint64_t selectedGroups = 0;
+    uint64_t candidateClusters = 0;
+    uint64_t clusters = 0;
+    uint64_t triangles = 0; // primitives reaching the clipper in hardware raster
+    uint64_t pixels = 0;    // fragment shader invocations
+    double rasterMs = 0.0;  // GPU time of the main-view VisibilityPasses
+};
+
+class GpuDrivenTelemetry {
+public:
+    static constexpr int kSampleCount = 240;
+    static constexpr uint32_t kMaxCullPasses = 2;
+
+    enum Stage : uint32_t {
+        Instances,
+        VisibleInstances,
+        Nodes,
+        Groups,
+        Clusters,
+        Triangles,
+        Pixels,
+        StageCount
+    };
+
+    // Called by MeshletCullPass when a traversal readback completes. The two
+    // occlusion phases are summed.
+    void recordCullPass(uint32_t cullPassIndex, uint32_t sceneInstances, const ClusterTraversalStats& stats) {
+        if (cullPassIndex >= kMaxCullPasses) {
+            return;
+        }
+        CullSource& source = m_cull[cullPassIndex];
+        source.valid = true;
+        source.sceneInstances = sceneInstances;
+        source.stats = stats;
+    }
+
+    // Called by main-view VisibilityPasses with their latest GPU scope. The counts are
+    // zero without pipeline statistics.
+    void recordRasterPass(const std::string& passName,
+                          double durationMs,
+                          uint64_t primitives,
+                          uint64_t fragmentInvocations) {
+        RasterSource& source = m_raster[passName];
+        source.durationMs = durationMs;
+        source.primitives = primitives;
+        source.fragmentInvocations = fragmentInvocations;
+    }
+
+    // Appends every committed sample to a CSV until closeCsv().
+    bool openCsv(const std::string& path) {
+        m_csv.close();
+        m_csv.open(path, std::ios::trunc);
+        if (!m_csv) {
+            spdlog::error("Failed to open GPU-driven telemetry log {}", path);
+            return false;
+        }
+        m_csv << "frame,instances,visible_instances,traversed_nodes,occluded_nodes,candidate_groups,"
+                 "selected_groups,candidate_clusters,clusters,triangles,pixels,raster_ms\n";
+        m_csvPath = path;
+        spdlog::info("Logging GPU-driven telemetry to {}", path);
+        return true;
+    }
+
+    void closeCsv() {
+        m_csv.close();
+        m_csvPath.clear();
+    }
+
+    bool logging() const { return m_csv.is_open(); }
+
+    void commitFrame(uint64_t frameIndex) {
+        if (m_history.sampleCount > 0 && m_latest.frame == frameIndex) {
+            return;
+        }
+        GpuDrivenFunnelSample sample;
+        sample.frame = frameIndex;
+        bool anyCull = false;
+        for (const CullSource& source : m_cull) {
+            if (!source.valid) {
+                continue;
+            }
+            anyCull = true;
+            const ClusterTraversalStats& stats = source.stats;
+            sample.instances = std::max<uint64_t>(sample.instances, source.sceneInstances);
+            sample.visibleInstances += uint64_t(stats.lodTraversalInstanceCount) + stats.fallbackInstanceCount;
+            sample.traversedNodes += stats.traversedNodeCount;
+            sample.occludedNodes += stats.occludedNodeCount;
+            sample.candidateGroups += stats.candidateGroupCount;
+            sample.selectedGroups += stats.selectedGroupCount;
+            sample.candidateClusters +=
+                uint64_t(stats.candidateClusterMeshletCount) + stats.candidateFallbackMeshletCount;
+            sample.clusters += uint64_t(stats.emittedClusterMeshletCount) + stats.emittedFallbackMeshletCount;
+        }
+        for (const auto& [name, source] : m_raster) {
+            sample.triangles += source.primitives;
+            sample.pixels += source.fragmentInvocations;
+            sample.rasterMs += source.durationMs;
+        }
+        if (!anyCull && m_raster.empty()) {
+            return;
+        }
+
+        m_latest = sample;
+        m_history.push(sample);
+        if (m_csv.is_open()) {
+            m_csv << sample.frame << ',' << sample.instances << ',' << sample.visibleInstances << ','
+                  << sample.traversedNodes << ',' << sample.occludedNodes << ',' << sample.candidateGroups << ','
+                  << sample.selectedGroups << ',' << sample.candidateClusters << ',' << sample.clusters << ','
+                  << sample.triangles << ',' << sample.pixels << ',' << sample.rasterMs << '\n';
+        }
+    }
+
+    const GpuDrivenFunnelSample& latest() const { return m_latest; }
+
+    void renderUI() {
+        if (m_history.sampleCount == 0) {
+            ImGui::TextDisabled("No GPU-driven telemetry yet (needs a cluster pipeline and Vulkan readback)");
+            return;
+        }
+        const GpuDrivenFunnelSample& s = m_latest;
+        if (s.pixels == 0) {
+            ImGui::TextDisabled("Triangles / pixels need Pipeline Statistics Queries");
+        }
+        if (ImGui::BeginTable("GpuDrivenFunnel", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Stage");
+            ImGui::TableSetupColumn("Count");
+            ImGui::TableSetupColumn("Culled");
+            ImGui::TableSetupColumn("x Previous");
+            ImGui::TableHeadersRow();
+            // Culled compares a stage with its own candidates; x Previous is the
+            // amplification from the stage above, whose unit differs.
+            const uint64_t counts[StageCount] = {
+                s.instances, s.visibleInstances, s.traversedNodes, s.selectedGroups,
+                s.clusters, s.triangles, s.pixels};
+            const uint64_t candidates[StageCount] = {
+                0, s.instances, s.traversedNodes, s.candidateGroups, s.candidateClusters, 0, 0};
+            const uint64_t culled[StageCount] = {
+                0, s.instances - std::min(s.instances, s.visibleInstances), s.occludedNodes,
+                s.candidateGroups - std::min(s.candidateGroups, s.selectedGroups),
+                s.candidateClusters - std::min(s.candidateClusters, s.clusters), 0, 0};
+            for (uint32_t stage = 0; stage < StageCount; ++stage) {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted(stageName(stage));
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%llu", static_cast<unsigned long long>(counts[stage]));
+                ImGui::TableSetColumnIndex(2);
+                if (candidates[stage] > 0) {
+                    ImGui::Text("%.1f%%", 100.0 * double(culled[stage]) / double(candidates[stage]));
+                } else {
+                    ImGui::TextDisabled("-");
+                }
+                ImGui::TableSetColumnIndex(3);
+                if (stage > 0 && counts[stage - 1] > 0) {
+                    ImGui::Text("%.2f", double(counts[stage]) / double(counts[stage - 1]));
+                } else {
+                    ImGui::TextDisabled("-");
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        for (uint32_t stage = VisibleInstances; stage < StageCount; ++stage) {
+            const std::array<float, kSampleCount>& values = m_history.values[stage];
+            float maxValue = 1.0f;
+            for (int i = 0; i < m_history.sampleCount; ++i) {
+                maxValue = std::max(maxValue, values[i]);
+            }
+            ImGui::PlotLines(stageName(stage),
+                             values.data(),
+                             m_history.sampleCount,
+                             m_history.plotOffset(),
+                             nullptr,
+                             0.0f,
+                             maxValue,
+                             ImVec2(0.0f, 40.0f));
+        }
+
+        if (m_csv.is_open()) {
+            ImGui::Text("Logging to %s", m_csvPath.c_str());
+            if (ImGui::Button("Stop Logging")) {
+                closeCsv();
+            }
+        } else if (ImGui::Button("Log CSV")) {
+            openCsv("cache/gpu_driven_telemetry.csv");
+        }
+    }
+
+private:
+    struct CullSource {
+        bool valid = false;
+        uint32_t sceneInstances = 0;
+        ClusterTraversalStats stats{};
+    };
+
+    struct RasterSource {
+        double durationMs = 0.0;
+        uint64_t primitives = 0;
+        uint64_t fragmentInvocations = 0;
+    };
+
+    struct History {
+        std::array<std::array<float, kSampleCount>, StageCount> values = {};
+        int sampleCount = 0;
+        int nextSample = 0;
+
+        void push(const GpuDrivenFunnelSample& sample) {
+            const uint64_t counts[StageCount] = {
+                sample.instances, sample.visibleInstances, sample.traversedNodes, sample.selectedGroups,
+                sample.clusters, sample.triangles, sample.pixels};
+            for (uint32_t stage = 0; stage < StageCount; ++stage) {
+                values[stage][nextSample] = static_cast<float>(counts[stage]);
+            }
+            nextSample = (nextSample + 1) % kSampleCount;
+            sampleCount = std::min(sampleCount + 1, kSampleCount);
+        }
+
+        int plotOffset() const {
+            return sampleCount < kSampleCount ? 0 : nextSample;
+        }
+    };
+
+    static const char* stageName(uint32_t stage) {
+        static constexpr const char* kNames[StageCount] = {
+            "Instances", "Visible Instances", "Traversed Nodes", "Selected Groups",
+            "Clusters", "Triangles Rasterized", "Pixels Shaded"};
+        return stage < StageCount ? kNames[stage] : "";
+    }
+
+    std::array<CullSource, kMaxCullPasses> m_cull{};
+    std::unordered_map<std::string, RasterSource> m_raster;
+    GpuDrivenFunnelSample m_latest;
+    History m_history;
+    std::ofstream m_csv;
+    std::string m_csvPath;
+};
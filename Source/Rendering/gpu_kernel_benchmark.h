@@ -0,0 +1,387 @@
+#pragma once
+
+#include "frame_graph.h"
+#include "mesh_loader.h"
+#include "scene_graph.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// GPU kernel benchmark behind the MetallicKernelBench target. Replicates the
+// loaded scene's mesh nodes on a grid until the GPU scene reaches each requested
+// cluster count, then times the culling, streaming, HZB and lighting passes with
+// their frame-graph GPU timestamps. Reports per-pass milliseconds plus clusters/ms
+// for cluster-bound passes and pixels/ns for screen-bound ones. Enabled with
+// --kernel-bench <json>; scene, pipeline and window size come from --bench-*.
+class GpuKernelBenchmark {
+public:
+    enum class Throughput { Clusters, Pixels };
+
+    struct Kernel {
+        // Matched against the start of the GPU scope label, so "Meshlet Cull"
+        // covers "Meshlet Cull 1" and "Meshlet Cull 2".
+        std::string labelPrefix;
+        Throughput throughput = Throughput::Clusters;
+    };
+
+    struct Settings {
+        std::string reportPath;
+        std::string filter;
+        std::vector<uint64_t> clusterScales = {1000u, 10000u, 100000u, 1000000u, 10000000u};
+        uint32_t warmupFrames = 30u;
+        uint32_t frames = 120u;
+        // Instance classification runs inside the Meshlet Cull compute pass and
+        // is timed with it.
+        std::vector<Kernel> kernels = {
+            {"Meshlet Cull", Throughput::Clusters},
+            {"Shadow Cascade Cull", Throughput::Clusters},
+            {"Cluster Streaming", Throughput::Clusters},
+            {"HZB Build", Throughput::Pixels},
+            {"Deferred Lighting", Throughput::Pixels},
+        };
+    };
+
+    // Returns false on a malformed benchmark argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* path = takeValue("--kernel-bench")) {
+                settings.reportPath = path;
+            } else if (const char* filter = takeValue("--kernel-bench-filter")) {
+                settings.filter = filter;
+            } else if (const char* frames = takeValue("--kernel-bench-warmup")) {
+                settings.warmupFrames = static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+            } else if (const char* frames = takeValue("--kernel-bench-frames")) {
+                settings.frames = std::max(1u, static_cast<uint32_t>(std::strtoul(frames, nullptr, 10)));
+            } else if (const char* scales = takeValue("--kernel-bench-scales")) {
+                settings.clusterScales.clear();
+                for (const char* cursor = scales; *cursor != '\0';) {
+                    char* end = nullptr;
+                    const unsigned long long scale = std::strtoull(cursor, &end, 10);
+                    if (end == cursor || scale == 0u || (*end != ',' && *end != '\0')) {
+                        spdlog::error("--kernel-bench-scales expects comma-separated cluster counts, got {}",
+                                      scales);
+                        return false;
+                    }
+                    settings.clusterScales.push_back(scale);
+                    cursor = *end == ',' ? end + 1 : end;
+                }
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--kernel-bench-", 15) == 0) {
+                spdlog::error("Unknown kernel benchmark argument {}", arg);
+                return false;
+            }
+        }
+        std::sort(settings.clusterScales.begin(), settings.clusterScales.end());
+        settings.clusterScales.erase(std::unique(settings.clusterScales.begin(), settings.clusterScales.end()),
+                                     settings.clusterScales.end());
+        return true;
+    }
+
+    bool begin(const Settings& settings, const std::string& scenePath, const std::string& pipelinePath) {
+        if (settings.clusterScales.empty()) {
+            spdlog::error("Kernel benchmark has no cluster scales");
+            return false;
+        }
+        m_settings = settings;
+        m_scenePath = scenePath;
+        m_pipelinePath = pipelinePath;
+        m_scaleIndex = 0u;
+        m_frame = 0u;
+        m_copies = 1u;
+        m_baseClusters = 0u;
+        m_lastGpuFrameIndex = UINT64_MAX;
+        m_results = nlohmann::json::array();
+        m_samples.clear();
+        m_active = true;
+        m_finished = false;
+        spdlog::info("Kernel benchmark: {} cluster scales, {} warm-up + {} frames each, writing {}",
+                     settings.clusterScales.size(), settings.warmupFrames, settings.frames,
+                     settings.reportPath);
+        return true;
+    }
+
+    bool active() const { return m_active; }
+    bool finished() const { return m_finished; }
+
+    // Call once per frame before the graph is built. Returns the instances to add
+    // when the next scale needs more copies of the scene; the caller waits for the
+    // device, passes them to SceneContext::addMeshInstances and rebuilds the graph.
+    std::vector<MeshInstanceSet> update(const SceneGraph& sceneGraph,
+                                        const LoadedMesh& mesh,
+                                        uint32_t sceneClusters) {
+        std::vector<MeshInstanceSet> sets;
+        if (!m_active || m_finished || m_frame != 0u) {
+            return sets;
+        }
+        if (m_baseClusters == 0u) {
+            if (sceneClusters == 0u) {
+                spdlog::error("Kernel benchmark: the loaded scene has no GPU clusters");
+                finish();
+                return sets;
+            }
+            m_baseClusters = sceneClusters;
+            captureBaseInstances(sceneGraph, mesh);
+        }
+
+        // Scales below the scene's own cluster count cannot be reached by adding copies.
+        while (m_scaleIndex < m_settings.clusterScales.size() &&
+               m_settings.clusterScales[m_scaleIndex] < m_baseClusters) {
+            spdlog::warn("Kernel benchmark: skipping {} clusters, the scene alone has {}",
+                         m_settings.clusterScales[m_scaleIndex], m_baseClusters);
+            m_results.push_back({{"targetClusters", m_settings.clusterScales[m_scaleIndex]},
+                                 {"skipped", true}});
+            ++m_scaleIndex;
+        }
+        if (m_scaleIndex >= m_settings.clusterScales.size()) {
+            finish();
+            return sets;
+        }
+
+        const uint64_t target = m_settings.clusterScales[m_scaleIndex];
+        const uint32_t copies = static_cast<uint32_t>((target + m_baseClusters - 1u) / m_baseClusters);
+        if (copies > m_copies) {
+            sets = instanceSetsForCopies(m_copies, copies);
+            m_copies = copies;
+        }
+        return sets;
+    }
+
+    // Call once per frame after submission, with the GPU scene's current cluster
+    // count and the render resolution the screen-bound passes ran at.
+    void recordFrame(uint64_t gpuFrameIndex,
+                     const std::vector<FGGpuScopeSample>& gpuScopes,
+                     uint32_t sceneClusters,
+                     uint32_t renderWidth,
+                     uint32_t renderHeight) {
+        if (!m_active || m_finished || m_baseClusters == 0u) {
+            return;
+        }
+        if (sceneClusters == 0u) {
+            spdlog::error("Kernel benchmark: GPU scene is empty at {} copies, stopping",
+                          m_copies);
+            finish();
+            return;
+        }
+        if (m_frame >= m_settings.warmupFrames && gpuFrameIndex != m_lastGpuFrameIndex) {
+            std::map<std::string, double> frameMs;
+            for (const FGGpuScopeSample& scope : gpuScopes) {
+                if (kernelFor(scope.label)) {
+                    frameMs[scope.label] += scope.durationMs;
+                }
+            }
+            const double pixels = double(renderWidth) * double(renderHeight);
+            for (const auto& [label, ms] : frameMs) {
+                if (ms <= 0.0) {
+                    continue;
+                }
+                KernelSamples& samples = m_samples[label];
+                samples.ms.push_back(ms);
+                samples.throughput.push_back(kernelFor(label)->throughput == Throughput::Pixels
+                                                 ? pixels / (ms * 1.0e6)
+                                                 : double(sceneClusters) / ms);
+            }
+        }
+        m_lastGpuFrameIndex = gpuFrameIndex;
+        m_clusters = sceneClusters;
+        m_renderWidth = renderWidth;
+        m_renderHeight = renderHeight;
+        if (++m_frame >= m_settings.warmupFrames + m_settings.frames) {
+            finishScale();
+        }
+    }
+
+private:
+    struct KernelSamples {
+        std::vector<double> ms;
+        std::vector<double> throughput;
+    };
+
+    const Kernel* kernelFor(const std::string& label) const {
+        if (!m_settings.filter.empty() && label.find(m_settings.filter) == std::string::npos) {
+            return nullptr;
+        }
+        for (const Kernel& kernel : m_settings.kernels) {
+            if (label.compare(0, kernel.labelPrefix.size(), kernel.labelPrefix) == 0) {
+                return &kernel;
+            }
+        }
+        return nullptr;
+    }
+
+    // Every drawn mesh node is copied with the matrices it already draws with
+    // (identity for a node drawn once), shifted by whole scene extents in world space.
+    void captureBaseInstances(const SceneGraph& sceneGraph, const LoadedMesh& mesh) {
+        m_baseSets.clear();
+        for (const SceneNode& node : sceneGraph.nodes) {
+            if (node.meshIndex < 0 || node.generatedPrimitive) {
+                continue;
+            }
+            BaseInstanceSet& base = m_baseSets.emplace_back();
+            base.node = node.id;
+            base.world = node.transform.worldMatrix;
+            base.worldInverse = node.transform.worldMatrix;
+            base.worldInverse.Invert();
+            if (const MeshInstanceSet* existing = sceneGraph.meshInstancesFor(node.id)) {
+                base.localMatrices = existing->localMatrices;
+            } else {
+                base.localMatrices.push_back(float4x4::Identity());
+                base.drawnOnce = true;
+            }
+        }
+        const float extentX = mesh.bboxMax[0] - mesh.bboxMin[0];
+        const float extentZ = mesh.bboxMax[2] - mesh.bboxMin[2];
+        m_spacing = std::max(1.0f, std::max(extentX, extentZ) * 1.1f);
+        const uint64_t maxCopies =
+            (m_settings.clusterScales.back() + m_baseClusters - 1u) / m_baseClusters;
+        m_gridSide = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(double(maxCopies)))));
+    }
+
+    // Copy 0 is the scene as loaded. A node drawn once gets its identity matrix
+    // back alongside the first batch, since an instance set replaces the node's
+    // own draw.
+    std::vector<MeshInstanceSet> instanceSetsForCopies(uint32_t firstCopy, uint32_t endCopy) const {
+        std::vector<MeshInstanceSet> sets;
+        sets.reserve(m_baseSets.size());
+        for (const BaseInstanceSet& base : m_baseSets) {
+            MeshInstanceSet& set = sets.emplace_back();
+            set.node = base.node;
+            set.localMatrices.reserve(size_t(endCopy - firstCopy + 1u) * base.localMatrices.size());
+            if (firstCopy == 1u && base.drawnOnce) {
+                set.localMatrices.push_back(float4x4::Identity());
+            }
+            for (uint32_t copy = firstCopy; copy < endCopy; ++copy) {
+                float4x4 offset = float4x4::Identity();
+                offset.SetupByTranslation(float3(float(copy % m_gridSide) * m_spacing,
+                                                 0.0f,
+                                                 float(copy / m_gridSide) * m_spacing));
+                const float4x4 shift = base.worldInverse * offset * base.world;
+                for (const float4x4& local : base.localMatrices) {
+                    set.localMatrices.push_back(shift * local);
+                }
+            }
+        }
+        return sets;
+    }
+
+    // Nearest-rank percentiles, as in FrameBenchmark.
+    static nlohmann::json summarize(std::vector<double> samples) {
+        if (samples.empty()) {
+            return nlohmann::json{{"count", 0}};
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&](double p) {
+            const size_t rank = static_cast<size_t>(std::ceil(p * double(samples.size())));
+            return samples[std::clamp<size_t>(rank, 1u, samples.size()) - 1u];
+        };
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        return nlohmann::json{{"count", samples.size()},
+                              {"mean", sum / double(samples.size())},
+                              {"min", samples.front()},
+                              {"p50", percentile(0.50)},
+                              {"p95", percentile(0.95)},
+                              {"max", samples.back()}};
+    }
+
+    void finishScale() {
+        nlohmann::json kernels = nlohmann::json::object();
+        for (const auto& [label, samples] : m_samples) {
+            const bool pixels = kernelFor(label)->throughput == Throughput::Pixels;
+            kernels[label] = {{"gpuMs", summarize(samples.ms)},
+                              {pixels ? "pixelsPerNs" : "clustersPerMs", summarize(samples.throughput)}};
+            spdlog::info("Kernel benchmark: {} at {} clusters: {:.3f} ms, {:.2f} {}",
+                         label, m_clusters, summarize(samples.ms).value("p50", 0.0),
+                         summarize(samples.throughput).value("p50", 0.0),
+                         pixels ? "pixels/ns" : "clusters/ms");
+        }
+        m_results.push_back({{"targetClusters", m_settings.clusterScales[m_scaleIndex]},
+                             {"clusters", m_clusters},
+                             {"sceneCopies", m_copies},
+                             {"renderWidth", m_renderWidth},
+                             {"renderHeight", m_renderHeight},
+                             {"kernels", kernels}});
+        m_samples.clear();
+        m_frame = 0u;
+        m_lastGpuFrameIndex = UINT64_MAX;
+        if (++m_scaleIndex >= m_settings.clusterScales.size()) {
+            finish();
+        }
+    }
+
+    void finish() {
+        m_finished = true;
+        const nlohmann::json report{
+            {"scene", m_scenePath},
+            {"pipeline", m_pipelinePath},
+            {"filter", m_settings.filter},
+            {"warmupFrames", m_settings.warmupFrames},
+            {"frames", m_settings.frames},
+            {"sceneClusters", m_baseClusters},
+            {"scales", m_results},
+        };
+        std::ofstream reportFile(m_settings.reportPath, std::ios::trunc);
+        if (!reportFile) {
+            spdlog::error("Failed to open kernel benchmark report {}", m_settings.reportPath);
+            return;
+        }
+        reportFile << report.dump(2);
+        spdlog::info("Kernel benchmark finished: {} scales written to {}", m_results.size(),
+                     m_settings.reportPath);
+    }
+
+    struct BaseInstanceSet {
+        uint32_t node = 0u;
+        float4x4 world = float4x4::Identity();
+        float4x4 worldInverse = float4x4::Identity();
+        std::vector<float4x4> localMatrices;
+        bool drawnOnce = false;
+    };
+
+    Settings m_settings;
+    std::string m_scenePath;
+    std::string m_pipelinePath;
+    size_t m_scaleIndex = 0u;
+    uint32_t m_frame = 0u;
+    uint32_t m_copies = 1u;
+    uint32_t m_baseClusters = 0u;
+    uint32_t m_clusters = 0u;
+    uint32_t m_renderWidth = 0u;
+    uint32_t m_renderHeight = 0u;
+    uint32_t m_gridSide = 1u;
+    float m_spacing = 1.0f;
+    uint64_t m_lastGpuFrameIndex = UINT64_MAX;
+    std::vector<BaseInstanceSet> m_baseSets;
+    std::map<std::string, KernelSamples> m_samples;
+    nlohmann::json m_results = nlohmann::json::array();
+    bool m_active = false;
+    bool m_finished = false;
+};
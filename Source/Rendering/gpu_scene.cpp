@@ -1,6 +1,7 @@
 #include "gpu_scene.h"
 
 #include "cluster_lod_builder.h"
+#include "cpu_profile_zones.h"
 #include "mesh_loader.h"
 #include "meshlet_builder.h"
 #include "rhi_resource_utils.h"
@@ -25,6 +26,8 @@ struct GeometryKey {
     uint32_t indexStart = 0;
     uint32_t indexCount = 0;
     uint32_t lodRootNode = UINT32_MAX;
+    // Deformed nodes keep their own geometry so its bounds can follow the pose.
+    uint32_t deformedNode = UINT32_MAX;
 
     bool operator==(const GeometryKey& rhs) const {
         return meshIndex == rhs.meshIndex &&
@@ -34,7 +37,8 @@ struct GeometryKey {
                meshletCount == rhs.meshletCount &&
                indexStart == rhs.indexStart &&
                indexCount == rhs.indexCount &&
-               lodRootNode == rhs.lodRootNode;
+               lodRootNode == rhs.lodRootNode &&
+               deformedNode == rhs.deformedNode;
     }
 };
 
@@ -53,6 +57,7 @@ struct GeometryKeyHash {
         hashCombine(key.indexStart);
         hashCombine(key.indexCount);
         hashCombine(key.lodRootNode);
+        hashCombine(key.deformedNode);
         return hash;
     }
 };
@@ -127,23 +132,402 @@ uint32_t computeVisibilityFlags(const SceneGraph& sceneGraph, const SceneNode& n
     return flags;
 }
 
-void storeMatrix(float dst[16], const float4x4& src) {
-    std::memcpy(dst, &src, sizeof(float) * 16);
+// The scene graph's world matrix transposed to the row-major layout the shaders
+// multiply with; the last row of an affine transform is dropped.
+GPUInstanceTransform makeInstanceTransform(const float4x4& worldMatrix) {
+    const float4x4 rowMajor = transpose(worldMatrix);
+    GPUInstanceTransform transform;
+    std::memcpy(transform.rows, &rowMajor, sizeof(transform.rows));
+    return transform;
 }
 
-void uploadInstanceTable(GpuSceneTables& tables) {
-    if (!tables.instanceBuffer.nativeHandle() || tables.instances.empty()) {
+// World matrix of one copy of a node's mesh: the node itself, or one entry of
+// its MeshInstanceSet placed relative to it.
+float4x4 instanceWorldMatrix(const SceneNode& node, const MeshInstanceSet* instanceSet, size_t copy) {
+    return instanceSet ? node.transform.worldMatrix * instanceSet->localMatrices[copy] : node.transform.worldMatrix;
+}
+
+// Instance bounding sphere in world space, scaled by the largest row of the
+// world transform.
+GPUSceneInstanceCull makeInstanceCull(const GPUSceneInstance& instance, const GPUSceneGeometry& geometry) {
+    GPUSceneInstanceCull cull;
+    cull.geometryIndex = instance.geometryIndex;
+    cull.lodRootNode = geometry.lodRootNode;
+    cull.visibilityFlags = instance.visibilityFlags;
+
+    const float* centerRadius = geometry.boundsCenterRadius;
+    const float* m = instance.world.rows;
+    for (uint32_t row = 0; row < 3; ++row) {
+        const float* r = m + row * 4;
+        cull.maxScale = std::max(cull.maxScale, std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]));
+        cull.worldBoundsSphere[row] = r[0] * centerRadius[0] + r[1] * centerRadius[1] +
+                                      r[2] * centerRadius[2] + r[3];
+    }
+    cull.worldBoundsSphere[3] = centerRadius[3] * cull.maxScale;
+    return cull;
+}
+
+// Writes the given elements (sorted, unique) of one table to its mapped buffer,
+// one copy per contiguous run.
+template <typename T>
+void uploadRanges(const RhiBufferHandle& buffer, const std::vector<T>& elements, const std::vector<uint32_t>& dirty) {
+    if (!buffer.nativeHandle() || dirty.empty()) {
+        return;
+    }
+
+    void* mappedData = rhiBufferContents(buffer);
+    if (!mappedData) {
+        return;
+    }
+
+    auto* dst = static_cast<T*>(mappedData);
+    size_t runStart = 0;
+    for (size_t i = 1; i <= dirty.size(); ++i) {
+        if (i < dirty.size() && dirty[i] == dirty[i - 1] + 1) {
+            continue;
+        }
+        const uint32_t first = dirty[runStart];
+        const size_t count = i - runStart;
+        rhiWriteCombinedCopy(dst + first, elements.data() + first, count * sizeof(T));
+        runStart = i;
+    }
+}
+
+void uploadInstanceRanges(GpuSceneTables& tables, const std::vector<uint32_t>& dirtyInstances) {
+    uploadRanges(tables.instanceBuffer, tables.instances, dirtyInstances);
+    uploadRanges(tables.instancePrevTransformBuffer, tables.instancePrevTransforms, dirtyInstances);
+    uploadRanges(tables.instanceCullBuffer, tables.instanceCull, dirtyInstances);
+}
+
+// Unbounded glTF lights are cut off where they fall below this illuminance.
+constexpr float kPunctualLightCutoffIlluminance = 0.01f;
+
+GPUPunctualLight makeGpuPunctualLight(const SceneNode& node) {
+    const PunctualLight& source = node.light.punctual;
+    const float4x4 world = transpose(node.transform.worldMatrix);
+    const float* m = reinterpret_cast<const float*>(&world);
+    const float3 position(m[3], m[7], m[11]);
+    float3 axis(-m[2], -m[6], -m[10]);
+    const float axisLength = length(axis);
+    axis = axisLength > 1e-6f ? axis / axisLength : float3(0.f, 0.f, -1.f);
+
+    const float3 radiance = source.color * std::max(source.intensity, 0.0f);
+    float range = source.range;
+    if (!(range > 0.0f)) {
+        const float peak = std::max(radiance.x, std::max(radiance.y, radiance.z));
+        range = std::sqrt(peak / kPunctualLightCutoffIlluminance);
+    } else {
+        float maxScale = 0.0f;
+        for (uint32_t row = 0; row < 3; ++row) {
+            const float* r = m + row * 4;
+            maxScale = std::max(maxScale, std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]));
+        }
+        range *= maxScale;
+    }
+    range = std::max(range, 1e-4f);
+
+    float spotScale = 0.0f;
+    float spotOffset = 1.0f;
+    float3 cullCenter = position;
+    float cullRadius = range;
+    if (node.light.type == LightType::Spot) {
+        const float outer = std::clamp(source.outerConeAngle, 1e-4f, 1.5707963f);
+        const float inner = std::clamp(source.innerConeAngle, 0.0f, outer);
+        const float cosOuter = std::cos(outer);
+        spotScale = 1.0f / std::max(std::cos(inner) - cosOuter, 1e-3f);
+        spotOffset = -cosOuter * spotScale;
+        // Smallest sphere around the cone's spherical sector.
+        if (cosOuter >= 0.70710678f) {
+            cullRadius = range / (2.0f * cosOuter);
+            cullCenter = position + axis * cullRadius;
+        } else {
+            cullRadius = range * std::sin(outer);
+            cullCenter = position + axis * (range * cosOuter);
+        }
+    }
+
+    GPUPunctualLight light{};
+    light.positionRange[0] = position.x;
+    light.positionRange[1] = position.y;
+    light.positionRange[2] = position.z;
+    light.positionRange[3] = range;
+    light.directionSpotScale[0] = axis.x;
+    light.directionSpotScale[1] = axis.y;
+    light.directionSpotScale[2] = axis.z;
+    light.directionSpotScale[3] = spotScale;
+    light.colorSpotOffset[0] = radiance.x;
+    light.colorSpotOffset[1] = radiance.y;
+    light.colorSpotOffset[2] = radiance.z;
+    light.colorSpotOffset[3] = spotOffset;
+    light.cullSphere[0] = cullCenter.x;
+    light.cullSphere[1] = cullCenter.y;
+    light.cullSphere[2] = cullCenter.z;
+    light.cullSphere[3] = cullRadius;
+    return light;
+}
+
+void updatePunctualLights(const SceneGraph& sceneGraph, GpuSceneTables& tables) {
+    tables.lights.clear();
+    for (uint32_t nodeIndex : tables.lightNodes) {
+        if (nodeIndex >= sceneGraph.nodes.size() || !sceneGraph.isNodeVisible(nodeIndex)) {
+            continue;
+        }
+        const SceneNode& node = sceneGraph.nodes[nodeIndex];
+        if (!node.hasLight || node.light.type == LightType::Directional) {
+            continue;
+        }
+        tables.lights.push_back(makeGpuPunctualLight(node));
+    }
+    tables.lightCount = static_cast<uint32_t>(tables.lights.size());
+
+    void* mappedData = tables.lightBuffer.nativeHandle() ? rhiBufferContents(tables.lightBuffer) : nullptr;
+    if (!mappedData) {
+        tables.lightCount = 0;
+        return;
+    }
+    if (!tables.lights.empty()) {
+        rhiWriteCombinedCopy(mappedData, tables.lights.data(), tables.lights.size() * sizeof(GPUPunctualLight));
+    }
+}
+
+// World-space AABB of the bounding sphere instance_classify.slang tests.
+void computeInstanceWorldBounds(const GPUSceneInstanceCull& cull, float boundsMin[3], float boundsMax[3]) {
+    const float* sphere = cull.worldBoundsSphere;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        boundsMin[axis] = sphere[axis] - sphere[3];
+        boundsMax[axis] = sphere[axis] + sphere[3];
+    }
+}
+
+uint32_t buildInstanceBvhNode(GpuSceneTables& tables,
+                              const std::vector<float>& centroids,
+                              uint32_t rangeStart,
+                              uint32_t rangeCount) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(tables.instanceBvhNodes.size());
+    tables.instanceBvhNodes.emplace_back();
+    tables.instanceBvhNodes[nodeIndex].rangeStart = rangeStart;
+    tables.instanceBvhNodes[nodeIndex].rangeCount = rangeCount;
+    if (rangeCount <= kInstanceBvhLeafSize) {
+        return nodeIndex;
+    }
+
+    // Median split along the longest axis of the centroid bounds.
+    float centroidMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float centroidMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    auto first = tables.instanceBvhInstances.begin() + rangeStart;
+    auto last = first + rangeCount;
+    for (auto it = first; it != last; ++it) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            centroidMin[axis] = std::min(centroidMin[axis], centroids[*it * 3 + axis]);
+            centroidMax[axis] = std::max(centroidMax[axis], centroids[*it * 3 + axis]);
+        }
+    }
+    uint32_t splitAxis = 0;
+    for (uint32_t axis = 1; axis < 3; ++axis) {
+        if (centroidMax[axis] - centroidMin[axis] > centroidMax[splitAxis] - centroidMin[splitAxis]) {
+            splitAxis = axis;
+        }
+    }
+
+    const uint32_t leftCount = rangeCount / 2;
+    std::nth_element(first, first + leftCount, last, [&](uint32_t a, uint32_t b) {
+        return centroids[a * 3 + splitAxis] < centroids[b * 3 + splitAxis];
+    });
+
+    buildInstanceBvhNode(tables, centroids, rangeStart, leftCount);
+    const uint32_t rightChild =
+        buildInstanceBvhNode(tables, centroids, rangeStart + leftCount, rangeCount - leftCount);
+    tables.instanceBvhNodes[nodeIndex].rightChild = rightChild;
+    return nodeIndex;
+}
+
+// Children always follow their parent, so a reverse sweep sees them first.
+void refitInstanceBvh(GpuSceneTables& tables) {
+    for (size_t nodeIndex = tables.instanceBvhNodes.size(); nodeIndex-- > 0;) {
+        GPUInstanceBvhNode& node = tables.instanceBvhNodes[nodeIndex];
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            node.boundsMin[axis] = FLT_MAX;
+            node.boundsMax[axis] = -FLT_MAX;
+        }
+
+        auto grow = [&node](const float childMin[3], const float childMax[3]) {
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                node.boundsMin[axis] = std::min(node.boundsMin[axis], childMin[axis]);
+                node.boundsMax[axis] = std::max(node.boundsMax[axis], childMax[axis]);
+            }
+        };
+
+        if (node.rightChild != 0) {
+            const GPUInstanceBvhNode& left = tables.instanceBvhNodes[nodeIndex + 1];
+            const GPUInstanceBvhNode& right = tables.instanceBvhNodes[node.rightChild];
+            grow(left.boundsMin, left.boundsMax);
+            grow(right.boundsMin, right.boundsMax);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < node.rangeCount; ++i) {
+            const uint32_t instanceIndex = tables.instanceBvhInstances[node.rangeStart + i];
+            float instanceMin[3];
+            float instanceMax[3];
+            computeInstanceWorldBounds(tables.instanceCull[instanceIndex], instanceMin, instanceMax);
+            grow(instanceMin, instanceMax);
+        }
+    }
+}
+
+void collectInstanceBvhSubtreeRoots(GpuSceneTables& tables, uint32_t nodeIndex) {
+    const GPUInstanceBvhNode& node = tables.instanceBvhNodes[nodeIndex];
+    if (node.rightChild == 0 || node.rangeCount <= kInstanceBvhSubtreeInstances) {
+        tables.instanceBvhSubtreeRoots.push_back(nodeIndex);
+        return;
+    }
+    const uint32_t rightChild = node.rightChild;
+    collectInstanceBvhSubtreeRoots(tables, nodeIndex + 1);
+    collectInstanceBvhSubtreeRoots(tables, rightChild);
+}
+
+void buildInstanceBvh(GpuSceneTables& tables) {
+    tables.instanceBvhNodes.clear();
+    tables.instanceBvhSubtreeRoots.clear();
+    tables.instanceBvhInstances.resize(tables.instances.size());
+    if (tables.instances.empty()) {
+        return;
+    }
+
+    std::vector<float> centroids(tables.instances.size() * 3);
+    for (uint32_t instanceIndex = 0; instanceIndex < tables.instances.size(); ++instanceIndex) {
+        tables.instanceBvhInstances[instanceIndex] = instanceIndex;
+        float instanceMin[3];
+        float instanceMax[3];
+        computeInstanceWorldBounds(tables.instanceCull[instanceIndex], instanceMin, instanceMax);
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            centroids[instanceIndex * 3 + axis] = 0.5f * (instanceMin[axis] + instanceMax[axis]);
+        }
+    }
+
+    tables.instanceBvhNodes.reserve(tables.instances.size() / kInstanceBvhLeafSize * 2 + 1);
+    buildInstanceBvhNode(tables, centroids, 0, static_cast<uint32_t>(tables.instances.size()));
+    refitInstanceBvh(tables);
+    collectInstanceBvhSubtreeRoots(tables, 0);
+}
+
+void uploadInstanceBvhNodes(GpuSceneTables& tables) {
+    if (!tables.instanceBvhNodeBuffer.nativeHandle() || tables.instanceBvhNodes.empty()) {
         return;
     }
 
-    void* mappedData = rhiBufferContents(tables.instanceBuffer);
+    void* mappedData = rhiBufferContents(tables.instanceBvhNodeBuffer);
     if (!mappedData) {
         return;
     }
 
-    std::memcpy(mappedData,
-                tables.instances.data(),
-                tables.instances.size() * sizeof(GPUSceneInstance));
+    rhiWriteCombinedCopy(mappedData,
+                         tables.instanceBvhNodes.data(),
+                         tables.instanceBvhNodes.size() * sizeof(GPUInstanceBvhNode));
+}
+
+void buildTransformHierarchy(const RhiDevice& device, const SceneGraph& sceneGraph, GpuSceneTables& out) {
+    // A slot writes one instance; instanced nodes own many.
+    if (!sceneGraph.instanceSets.empty()) {
+        spdlog::info("GpuScene: scene uses mesh instancing; transforms stay on the CPU");
+        return;
+    }
+    // The pass reads rest bounds from the geometry table, which deformed nodes outgrow.
+    if (std::any_of(sceneGraph.nodes.begin(), sceneGraph.nodes.end(),
+                    [](const SceneNode& node) { return node.deformed; })) {
+        spdlog::info("GpuScene: scene has deformed meshes; transforms stay on the CPU");
+        return;
+    }
+
+    std::vector<uint32_t> slotNode;
+    std::vector<int32_t> slotParent;
+    sceneGraph.buildDepthOrder(slotNode, slotParent, out.hierarchyLevelStart);
+    if (slotNode.empty()) {
+        out.hierarchyLevelStart.clear();
+        return;
+    }
+
+    std::vector<GPUTransformSlot> slots(slotNode.size());
+    std::vector<float4x4> locals(slotNode.size());
+    out.hierarchyNodeSlot.assign(sceneGraph.nodes.size(), UINT32_MAX);
+    for (uint32_t slot = 0; slot < slotNode.size(); ++slot) {
+        const uint32_t nodeId = slotNode[slot];
+        out.hierarchyNodeSlot[nodeId] = slot;
+        slots[slot].parentSlot = slotParent[slot];
+        slots[slot].instanceIndex = out.nodeToInstance[nodeId];
+        locals[slot] = transpose(sceneGraph.nodes[nodeId].transform.localMatrix);
+    }
+
+    out.hierarchySlotBuffer = rhiCreateDeviceBuffer(device,
+                                                    slots.data(),
+                                                    slots.size() * sizeof(GPUTransformSlot),
+                                                    "GPU Scene Transform Slots");
+    RhiBufferDesc localDesc;
+    localDesc.size = locals.size() * sizeof(float4x4);
+    localDesc.initialData = locals.data();
+    localDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    localDesc.debugName = "GPU Scene Local Transforms";
+    out.hierarchyLocalBuffer = rhiCreateBuffer(device, localDesc);
+    RhiBufferDesc worldDesc;
+    worldDesc.size = locals.size() * sizeof(float4x4);
+    worldDesc.memory = RhiBufferMemory::DeviceLocal;
+    worldDesc.debugName = "GPU Scene World Transforms";
+    out.hierarchyWorldBuffer = rhiCreateBuffer(device, worldDesc);
+    if (!out.hierarchySlotBuffer.nativeHandle() ||
+        !out.hierarchyLocalBuffer.nativeHandle() ||
+        !out.hierarchyWorldBuffer.nativeHandle()) {
+        spdlog::warn("GpuScene: failed to create transform hierarchy buffers; transforms stay on the CPU");
+        rhiReleaseHandle(out.hierarchySlotBuffer);
+        rhiReleaseHandle(out.hierarchyLocalBuffer);
+        rhiReleaseHandle(out.hierarchyWorldBuffer);
+        out.hierarchyNodeSlot.clear();
+        out.hierarchyLevelStart.clear();
+    }
+}
+
+void uploadHierarchyLocals(const SceneGraph& sceneGraph, GpuSceneTables& tables) {
+    if (!tables.hierarchyLocalBuffer.nativeHandle() || sceneGraph.localChangedNodes.empty()) {
+        return;
+    }
+
+    void* mappedData = rhiBufferContents(tables.hierarchyLocalBuffer);
+    if (!mappedData) {
+        return;
+    }
+
+    auto* dst = static_cast<float4x4*>(mappedData);
+    for (uint32_t nodeId : sceneGraph.localChangedNodes) {
+        if (nodeId >= tables.hierarchyNodeSlot.size() || tables.hierarchyNodeSlot[nodeId] == UINT32_MAX) {
+            continue;
+        }
+        const float4x4 local = transpose(sceneGraph.nodes[nodeId].transform.localMatrix);
+        rhiWriteCombinedCopy(dst + tables.hierarchyNodeSlot[nodeId], &local, sizeof(local));
+    }
+}
+
+// With GPU transform propagation the pass owns the transforms and cull spheres,
+// so only the flags words are written.
+void uploadInstanceVisibilityFlags(GpuSceneTables& tables, const std::vector<uint32_t>& instances) {
+    if (!tables.instanceBuffer.nativeHandle() || !tables.instanceCullBuffer.nativeHandle() || instances.empty()) {
+        return;
+    }
+
+    void* instanceData = rhiBufferContents(tables.instanceBuffer);
+    void* cullData = rhiBufferContents(tables.instanceCullBuffer);
+    if (!instanceData || !cullData) {
+        return;
+    }
+
+    auto* instanceDst = static_cast<GPUSceneInstance*>(instanceData);
+    auto* cullDst = static_cast<GPUSceneInstanceCull*>(cullData);
+    for (uint32_t instanceIndex : instances) {
+        rhiWriteCombinedCopy(&instanceDst[instanceIndex].visibilityFlags,
+                             &tables.instances[instanceIndex].visibilityFlags,
+                             sizeof(uint32_t));
+        rhiWriteCombinedCopy(&cullDst[instanceIndex].visibilityFlags,
+                             &tables.instanceCull[instanceIndex].visibilityFlags,
+                             sizeof(uint32_t));
+    }
 }
 
 } // namespace
@@ -157,6 +541,14 @@ bool buildGpuSceneTables(const RhiDevice& device,
     releaseGpuSceneTables(out);
     out = GpuSceneTables{};
     out.nodeToInstance.assign(sceneGraph.nodes.size(), UINT32_MAX);
+    out.nodeInstanceCount.assign(sceneGraph.nodes.size(), 0);
+    size_t instanceCapacity = sceneGraph.nodes.size();
+    for (const MeshInstanceSet& instanceSet : sceneGraph.instanceSets) {
+        instanceCapacity += instanceSet.localMatrices.size();
+    }
+    out.instances.reserve(instanceCapacity);
+    out.instancePrevTransforms.reserve(instanceCapacity);
+    out.instanceCull.reserve(instanceCapacity);
 
     std::unordered_map<GeometryKey, uint32_t, GeometryKeyHash> geometryMap;
     geometryMap.reserve(sceneGraph.nodes.size());
@@ -176,6 +568,7 @@ bool buildGpuSceneTables(const RhiDevice& device,
         key.indexStart = node.indexStart;
         key.indexCount = node.indexCount;
         key.lodRootNode = node.lodRootNode;
+        key.deformedNode = node.deformed ? node.id : UINT32_MAX;
 
         uint32_t geometryIndex = UINT32_MAX;
         const auto geometryIt = geometryMap.find(key);
@@ -190,71 +583,75 @@ bool buildGpuSceneTables(const RhiDevice& device,
             geometry.indexCount = node.indexCount;
             geometry.materialIndex = firstMaterialIndex(mesh, node);
             geometry.lodRootNode = node.lodRootNode;
-            computeGeometryBounds(meshletData, node, geometry.boundsCenterRadius);
+            if (node.deformed) {
+                std::memcpy(geometry.boundsCenterRadius, node.deformedBounds, sizeof(geometry.boundsCenterRadius));
+            } else {
+                computeGeometryBounds(meshletData, node, geometry.boundsCenterRadius);
+            }
             out.geometries.push_back(geometry);
             geometryMap.emplace(key, geometryIndex);
         } else {
             geometryIndex = geometryIt->second;
         }
 
-        GPUSceneInstance instance{};
-        const float4x4 worldMatrix = transpose(node.transform.worldMatrix);
-        storeMatrix(instance.worldMatrix, worldMatrix);
-        storeMatrix(instance.prevWorldMatrix, worldMatrix);
-        instance.geometryIndex = geometryIndex;
-        instance.dispatchStart = dispatchStart;
-        instance.sceneNodeIndex = node.id;
-        instance.visibilityFlags = computeVisibilityFlags(sceneGraph, node);
-        out.instances.push_back(instance);
-
+        // Copies of an instanced node are contiguous, starting at nodeToInstance.
+        const MeshInstanceSet* instanceSet = sceneGraph.meshInstancesFor(node.id);
+        const size_t copyCount = instanceSet ? instanceSet->localMatrices.size() : 1;
+        const uint32_t visibilityFlags = computeVisibilityFlags(sceneGraph, node);
         if (node.id < out.nodeToInstance.size()) {
-            out.nodeToInstance[node.id] = static_cast<uint32_t>(out.instances.size() - 1);
+            out.nodeToInstance[node.id] = static_cast<uint32_t>(out.instances.size());
+            out.nodeInstanceCount[node.id] = static_cast<uint32_t>(copyCount);
         }
-
-        if ((instance.visibilityFlags & kGpuSceneInstanceVisible) != 0) {
-            ++out.visibleInstanceCount;
+        for (size_t copy = 0; copy < copyCount; ++copy) {
+            GPUSceneInstance instance{};
+            instance.world = makeInstanceTransform(instanceWorldMatrix(node, instanceSet, copy));
+            instance.geometryIndex = geometryIndex;
+            instance.dispatchStart = dispatchStart;
+            instance.sceneNodeIndex = node.id;
+            instance.visibilityFlags = visibilityFlags;
+            out.instances.push_back(instance);
+            out.instancePrevTransforms.push_back(instance.world);
+            out.instanceCull.push_back(makeInstanceCull(instance, out.geometries[geometryIndex]));
+            dispatchStart += out.geometries[geometryIndex].meshletCount;
         }
 
-        dispatchStart += out.geometries[geometryIndex].meshletCount;
+        if ((visibilityFlags & kGpuSceneInstanceVisible) != 0) {
+            out.visibleInstanceCount += static_cast<uint32_t>(copyCount);
+        }
     }
 
     out.geometryCount = static_cast<uint32_t>(out.geometries.size());
     out.instanceCount = static_cast<uint32_t>(out.instances.size());
     out.totalMeshletDispatchCount = dispatchStart;
+    out.sceneVisibilityRevision = sceneGraph.visibilityRevision;
 
-    // Fill packedClusterStart/Count from ClusterLODData
-    if (clusterLodData && !clusterLodData->packedClusters.empty()) {
-        // Build a map from primitiveGroupIndex to the LOD 0 level entry.
+    // Fill packedClusterStart/Count from ClusterLODData. The host copy of the packed
+    // clusters may be gone (cache loads, SceneGpu::releaseCpuMirrors); only the
+    // levels are read here.
+    if (clusterLodData && clusterLodData->packedClusterBuffer.nativeHandle() && !clusterLodData->levels.empty()) {
+        // Build a map from a primitive group's LOD root to its LOD 0 level entry.
         // clusterLodData->allMeshlets interleaves all LOD levels for all groups,
         // so geom.meshletStart (which indexes the original LOD-0-only meshlet array)
-        // cannot be used directly as packedClusterStart.
+        // cannot be used directly as packedClusterStart. Keying by root lets
+        // geometries of primitive groups that share an identical group's hierarchy
+        // resolve to the same packed clusters.
+        const auto& lodRoots = clusterLodData->primitiveGroupLodRoots;
         std::unordered_map<uint32_t, const ClusterLODLevel*> lod0Map;
         for (const auto& level : clusterLodData->levels) {
-            if (level.depth == 0) {
-                lod0Map[level.primitiveGroupIndex] = &level;
+            if (level.depth == 0 && level.primitiveGroupIndex < lodRoots.size()) {
+                lod0Map[lodRoots[level.primitiveGroupIndex]] = &level;
             }
         }
         for (auto& geom : out.geometries) {
-            auto it = lod0Map.find(geom.primitiveGroupStart);
+            if (geom.primitiveGroupStart >= lodRoots.size()) {
+                continue;
+            }
+            auto it = lod0Map.find(lodRoots[geom.primitiveGroupStart]);
             if (it != lod0Map.end()) {
                 geom.packedClusterStart = it->second->meshletStart;
                 geom.packedClusterCount = it->second->meshletCount;
             }
         }
-
-        // Build CPU worklist: all LOD 0 clusters for all instances
-        out.clusterVisWorklist.clear();
-        out.clusterVisWorklist.reserve(out.totalMeshletDispatchCount);
-        for (uint32_t instIdx = 0; instIdx < out.instanceCount; instIdx++) {
-            const auto& inst = out.instances[instIdx];
-            if (inst.geometryIndex >= out.geometryCount) continue;
-            const auto& geom = out.geometries[inst.geometryIndex];
-            for (uint32_t c = 0; c < geom.packedClusterCount; c++) {
-                out.clusterVisWorklist.push_back(
-                    ClusterInfo{instIdx, geom.packedClusterStart + c});
-            }
-        }
-        out.clusterVisWorklistCount = static_cast<uint32_t>(out.clusterVisWorklist.size());
     }
 
     if (out.instances.empty() || out.geometries.empty()) {
@@ -263,71 +660,232 @@ bool buildGpuSceneTables(const RhiDevice& device,
         return false;
     }
 
-    out.geometryBuffer = rhiCreateSharedBuffer(device,
+    out.geometryBuffer = rhiCreateDeviceBuffer(device,
                                                out.geometries.data(),
                                                out.geometries.size() * sizeof(GPUSceneGeometry),
                                                "GPU Scene Geometries");
-    out.instanceBuffer = rhiCreateSharedBuffer(device,
-                                               out.instances.data(),
-                                               out.instances.size() * sizeof(GPUSceneInstance),
-                                               "GPU Scene Instances");
-    if (!out.geometryBuffer.nativeHandle() || !out.instanceBuffer.nativeHandle()) {
+    // updateGpuSceneTables() rewrites only the instances that moved or changed visibility.
+    RhiBufferDesc instanceDesc;
+    instanceDesc.size = out.instances.size() * sizeof(GPUSceneInstance);
+    instanceDesc.initialData = out.instances.data();
+    instanceDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    instanceDesc.debugName = "GPU Scene Instances";
+    out.instanceBuffer = rhiCreateBuffer(device, instanceDesc);
+    RhiBufferDesc prevTransformDesc;
+    prevTransformDesc.size = out.instancePrevTransforms.size() * sizeof(GPUInstanceTransform);
+    prevTransformDesc.initialData = out.instancePrevTransforms.data();
+    prevTransformDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    prevTransformDesc.debugName = "GPU Scene Previous Instance Transforms";
+    out.instancePrevTransformBuffer = rhiCreateBuffer(device, prevTransformDesc);
+    RhiBufferDesc cullDesc;
+    cullDesc.size = out.instanceCull.size() * sizeof(GPUSceneInstanceCull);
+    cullDesc.initialData = out.instanceCull.data();
+    cullDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    cullDesc.debugName = "GPU Scene Instance Cull Data";
+    out.instanceCullBuffer = rhiCreateBuffer(device, cullDesc);
+    if (!out.geometryBuffer.nativeHandle() ||
+        !out.instanceBuffer.nativeHandle() ||
+        !out.instancePrevTransformBuffer.nativeHandle() ||
+        !out.instanceCullBuffer.nativeHandle()) {
         spdlog::error("GpuScene: failed to create scene table buffers");
         releaseGpuSceneTables(out);
         return false;
     }
 
-    // Upload cluster vis worklist
-    if (!out.clusterVisWorklist.empty()) {
-        out.clusterVisWorklistBuffer = rhiCreateSharedBuffer(
-            device,
-            out.clusterVisWorklist.data(),
-            out.clusterVisWorklist.size() * sizeof(ClusterInfo),
-            "Cluster Vis Worklist");
+    // Lights keep their node list so edits and animation reach the GPU each frame.
+    for (const SceneNode& node : sceneGraph.nodes) {
+        if (node.hasLight && node.light.type != LightType::Directional) {
+            out.lightNodes.push_back(node.id);
+        }
     }
+    if (!out.lightNodes.empty()) {
+        RhiBufferDesc lightDesc;
+        lightDesc.size = out.lightNodes.size() * sizeof(GPUPunctualLight);
+        lightDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+        lightDesc.debugName = "GPU Scene Punctual Lights";
+        out.lightBuffer = rhiCreateBuffer(device, lightDesc);
+        if (!out.lightBuffer.nativeHandle()) {
+            spdlog::warn("GpuScene: failed to create the light buffer; point and spot lights are skipped");
+        }
+        updatePunctualLights(sceneGraph, out);
+    }
+
+    // The instance BVH is optional: without it MeshletCullPass classifies every instance.
+    buildInstanceBvh(out);
+    RhiBufferDesc bvhNodeDesc;
+    bvhNodeDesc.size = out.instanceBvhNodes.size() * sizeof(GPUInstanceBvhNode);
+    bvhNodeDesc.initialData = out.instanceBvhNodes.data();
+    bvhNodeDesc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    bvhNodeDesc.debugName = "GPU Scene Instance BVH Nodes";
+    out.instanceBvhNodeBuffer = rhiCreateBuffer(device, bvhNodeDesc);
+    out.instanceBvhInstanceBuffer = rhiCreateDeviceBuffer(device,
+                                                          out.instanceBvhInstances.data(),
+                                                          out.instanceBvhInstances.size() * sizeof(uint32_t),
+                                                          "GPU Scene Instance BVH Instances");
+    out.instanceBvhSubtreeRootBuffer = rhiCreateDeviceBuffer(device,
+                                                             out.instanceBvhSubtreeRoots.data(),
+                                                             out.instanceBvhSubtreeRoots.size() * sizeof(uint32_t),
+                                                             "GPU Scene Instance BVH Subtree Roots");
+    if (!out.instanceBvhNodeBuffer.nativeHandle() ||
+        !out.instanceBvhInstanceBuffer.nativeHandle() ||
+        !out.instanceBvhSubtreeRootBuffer.nativeHandle()) {
+        spdlog::warn("GpuScene: failed to create instance BVH buffers; instances are classified linearly");
+        rhiReleaseHandle(out.instanceBvhNodeBuffer);
+        rhiReleaseHandle(out.instanceBvhInstanceBuffer);
+        rhiReleaseHandle(out.instanceBvhSubtreeRootBuffer);
+    }
+
+    // Optional as well: TransformHierarchyPass records nothing without it.
+    buildTransformHierarchy(device, sceneGraph, out);
 
-    spdlog::info("GpuScene: built {} instances, {} geometries, {} meshlet dispatches",
+    spdlog::info("GpuScene: built {} instances, {} geometries, {} meshlet dispatches, "
+                 "{} instance BVH nodes in {} subtrees, {} punctual lights",
                  out.instanceCount,
                  out.geometryCount,
-                 out.totalMeshletDispatchCount);
+                 out.totalMeshletDispatchCount,
+                 out.instanceBvhNodes.size(),
+                 out.instanceBvhSubtreeRoots.size(),
+                 out.lightNodes.size());
+    ++out.contentRevision;
     return true;
 }
 
-void updateGpuSceneTables(const SceneGraph& sceneGraph, GpuSceneTables& tables) {
+void updateGpuSceneTables(SceneGraph& sceneGraph, GpuSceneTables& tables) {
+    METALLIC_CPU_ZONE("Scene", "UpdateGpuSceneTables", METALLIC_CPU_ZONE_SCENE);
+    if (!tables.lightNodes.empty()) {
+        updatePunctualLights(sceneGraph, tables);
+    }
+    uploadHierarchyLocals(sceneGraph, tables);
+    sceneGraph.localChangedNodes.clear();
     if (tables.instances.empty()) {
+        sceneGraph.transformChangedNodes.clear();
         tables.visibleInstanceCount = 0;
         return;
     }
 
-    uint32_t visibleInstanceCount = 0;
-    for (GPUSceneInstance& instance : tables.instances) {
-        std::memcpy(instance.prevWorldMatrix, instance.worldMatrix, sizeof(instance.worldMatrix));
+    std::vector<uint32_t> dirtyInstances;
+    dirtyInstances.reserve(tables.movedInstances.size() + sceneGraph.transformChangedNodes.size());
+
+    // Last frame's movers now hold still until shown otherwise.
+    for (uint32_t instanceIndex : tables.movedInstances) {
+        tables.instancePrevTransforms[instanceIndex] = tables.instances[instanceIndex].world;
+        dirtyInstances.push_back(instanceIndex);
+    }
+    tables.movedInstances.clear();
 
-        if (instance.sceneNodeIndex >= sceneGraph.nodes.size()) {
-            instance.visibilityFlags = 0;
+    for (uint32_t nodeId : sceneGraph.transformChangedNodes) {
+        if (nodeId >= tables.nodeToInstance.size() || nodeId >= sceneGraph.nodes.size()) {
             continue;
         }
-
-        const SceneNode& node = sceneGraph.nodes[instance.sceneNodeIndex];
-        const float4x4 worldMatrix = transpose(node.transform.worldMatrix);
-        storeMatrix(instance.worldMatrix, worldMatrix);
-        instance.visibilityFlags = computeVisibilityFlags(sceneGraph, node);
-        if ((instance.visibilityFlags & kGpuSceneInstanceVisible) != 0) {
-            ++visibleInstanceCount;
+        const uint32_t firstInstance = tables.nodeToInstance[nodeId];
+        if (firstInstance >= tables.instances.size()) {
+            continue;
+        }
+        const SceneNode& node = sceneGraph.nodes[nodeId];
+        const MeshInstanceSet* instanceSet = sceneGraph.meshInstancesFor(nodeId);
+        // updateGpuSkinning() lists deformed nodes when their pose changes, even in place.
+        if (node.deformed) {
+            GPUSceneGeometry& geometry = tables.geometries[tables.instances[firstInstance].geometryIndex];
+            std::memcpy(geometry.boundsCenterRadius, node.deformedBounds, sizeof(geometry.boundsCenterRadius));
+        }
+        for (uint32_t copy = 0; copy < tables.nodeInstanceCount[nodeId]; ++copy) {
+            const uint32_t instanceIndex = firstInstance + copy;
+            GPUSceneInstance& instance = tables.instances[instanceIndex];
+            const GPUInstanceTransform world = makeInstanceTransform(instanceWorldMatrix(node, instanceSet, copy));
+            // Also drops nodes listed twice because updateTransforms() ran twice.
+            if (!node.deformed && std::memcmp(world.rows, instance.world.rows, sizeof(world.rows)) == 0) {
+                continue;
+            }
+            tables.instancePrevTransforms[instanceIndex] = instance.world;
+            instance.world = world;
+            tables.instanceCull[instanceIndex] =
+                makeInstanceCull(instance, tables.geometries[instance.geometryIndex]);
+            tables.movedInstances.push_back(instanceIndex);
+            dirtyInstances.push_back(instanceIndex);
+        }
+    }
+    sceneGraph.transformChangedNodes.clear();
+    const bool transformsChanged = !tables.movedInstances.empty();
+
+    // Hiding a node hides its whole subtree, so an edit re-evaluates every instance.
+    std::vector<uint32_t> flagInstances;
+    bool visibilityChanged = false;
+    if (tables.sceneVisibilityRevision != sceneGraph.visibilityRevision) {
+        tables.sceneVisibilityRevision = sceneGraph.visibilityRevision;
+        uint32_t visibleInstanceCount = 0;
+        uint32_t flagsNode = UINT32_MAX;
+        uint32_t visibilityFlags = 0;
+        for (uint32_t instanceIndex = 0; instanceIndex < tables.instances.size(); ++instanceIndex) {
+            GPUSceneInstance& instance = tables.instances[instanceIndex];
+            // Copies of an instanced node sit next to each other and share its flags.
+            if (instance.sceneNodeIndex != flagsNode) {
+                flagsNode = instance.sceneNodeIndex;
+                visibilityFlags = flagsNode < sceneGraph.nodes.size()
+                    ? computeVisibilityFlags(sceneGraph, sceneGraph.nodes[flagsNode])
+                    : 0u;
+            }
+            if (visibilityFlags != instance.visibilityFlags) {
+                instance.visibilityFlags = visibilityFlags;
+                tables.instanceCull[instanceIndex].visibilityFlags = visibilityFlags;
+                flagInstances.push_back(instanceIndex);
+                visibilityChanged = true;
+            }
+            if ((visibilityFlags & kGpuSceneInstanceVisible) != 0) {
+                ++visibleInstanceCount;
+            }
         }
+        tables.visibleInstanceCount = visibleInstanceCount;
     }
 
-    tables.visibleInstanceCount = visibleInstanceCount;
-    uploadInstanceTable(tables);
+    if (transformsChanged || visibilityChanged) {
+        ++tables.contentRevision;
+    }
+    if (tables.gpuTransformPropagation) {
+        uploadInstanceVisibilityFlags(tables, flagInstances);
+        dirtyInstances.clear();
+    } else {
+        dirtyInstances.insert(dirtyInstances.end(), flagInstances.begin(), flagInstances.end());
+    }
+    if (!dirtyInstances.empty()) {
+        std::sort(dirtyInstances.begin(), dirtyInstances.end());
+        dirtyInstances.erase(std::unique(dirtyInstances.begin(), dirtyInstances.end()), dirtyInstances.end());
+        uploadInstanceRanges(tables, dirtyInstances);
+    }
+
+    // Visibility flags are tested per instance, so only moved bounds need a refit.
+    if (transformsChanged && !tables.instanceBvhNodes.empty()) {
+        refitInstanceBvh(tables);
+        uploadInstanceBvhNodes(tables);
+    }
 }
 
 void releaseGpuSceneTables(GpuSceneTables& tables) {
     rhiReleaseHandle(tables.geometryBuffer);
     rhiReleaseHandle(tables.instanceBuffer);
-    rhiReleaseHandle(tables.clusterVisWorklistBuffer);
+    rhiReleaseHandle(tables.instancePrevTransformBuffer);
+    rhiReleaseHandle(tables.instanceCullBuffer);
+    rhiReleaseHandle(tables.instanceBvhNodeBuffer);
+    rhiReleaseHandle(tables.instanceBvhInstanceBuffer);
+    rhiReleaseHandle(tables.instanceBvhSubtreeRootBuffer);
+    rhiReleaseHandle(tables.lightBuffer);
+    rhiReleaseHandle(tables.hierarchySlotBuffer);
+    rhiReleaseHandle(tables.hierarchyLocalBuffer);
+    rhiReleaseHandle(tables.hierarchyWorldBuffer);
+    tables.hierarchyNodeSlot.clear();
+    tables.hierarchyLevelStart.clear();
     tables.geometries.clear();
     tables.instances.clear();
+    tables.instancePrevTransforms.clear();
+    tables.instanceCull.clear();
+    tables.movedInstances.clear();
+    tables.instanceBvhNodes.clear();
+    tables.instanceBvhInstances.clear();
+    tables.instanceBvhSubtreeRoots.clear();
     tables.nodeToInstance.clear();
+    tables.nodeInstanceCount.clear();
+    tables.lightNodes.clear();
+    tables.lights.clear();
+    tables.lightCount = 0;
     tables.geometryCount = 0;
     tables.instanceCount = 0;
     tables.totalMeshletDispatchCount = 0;
@@ -31,33 +31,123 @@ struct GPUSceneGeometry {
 };
 static_assert(sizeof(GPUSceneGeometry) == 56, "GPUSceneGeometry must match shader layout");
 
+// Top three rows of an affine world matrix (row-major, translation in the last
+// column); the fourth row is always 0 0 0 1.
+struct GPUInstanceTransform {
+    float rows[12] = {};
+};
+static_assert(sizeof(GPUInstanceTransform) == 48, "GPUInstanceTransform must match shader layout");
+
+// Hot per-instance record read by culling, rasterization and the lighting
+// resolve. Last frame's transform lives in GpuSceneTables::instancePrevTransforms.
 struct GPUSceneInstance {
-    float worldMatrix[16] = {};
-    float prevWorldMatrix[16] = {};
+    GPUInstanceTransform world;
     uint32_t geometryIndex = UINT32_MAX;
     uint32_t dispatchStart = 0;
     uint32_t sceneNodeIndex = UINT32_MAX;
     uint32_t visibilityFlags = 0;
 };
-static_assert(sizeof(GPUSceneInstance) == 144, "GPUSceneInstance must match shader layout");
+static_assert(sizeof(GPUSceneInstance) == 64, "GPUSceneInstance must match shader layout");
+
+// What instance classification reads: the world bounding sphere, the largest axis
+// scale of the world transform and the fields copied into VisibleInstanceInfo.
+struct GPUSceneInstanceCull {
+    float worldBoundsSphere[4] = {};
+    float maxScale = 0.0f;
+    uint32_t geometryIndex = UINT32_MAX;
+    uint32_t lodRootNode = UINT32_MAX;
+    uint32_t visibilityFlags = 0;
+};
+static_assert(sizeof(GPUSceneInstanceCull) == 32, "GPUSceneInstanceCull must match shader layout");
+
+// Point or spot light in world space (light_cluster_constants.h,
+// Shaders/Shared/punctual_lights.slang). Point lights carry a cone scale of 0 and
+// offset of 1, so the spot term is always 1 for them.
+struct GPUPunctualLight {
+    float positionRange[4] = {};      // xyz = position, w = distance the light reaches zero
+    float directionSpotScale[4] = {}; // xyz = spot axis, w = cone attenuation scale
+    float colorSpotOffset[4] = {};    // xyz = color * intensity, w = cone attenuation offset
+    float cullSphere[4] = {};         // bounds of the lit volume for cluster culling
+};
+static_assert(sizeof(GPUPunctualLight) == 64, "GPUPunctualLight must match shader layout");
+
+// One scene node of the GPU transform hierarchy, in depth order (SceneGraph::buildDepthOrder).
+struct GPUTransformSlot {
+    int32_t parentSlot = -1;
+    uint32_t instanceIndex = UINT32_MAX;
+};
+static_assert(sizeof(GPUTransformSlot) == 8, "GPUTransformSlot must match shader layout");
+
+// Binary BVH over the instance world bounds, stored depth-first: a node's left child
+// is the next node and rightChild is 0 for leaves. Every node covers the contiguous
+// range [rangeStart, rangeStart + rangeCount) of GpuSceneTables::instanceBvhInstances.
+struct GPUInstanceBvhNode {
+    float boundsMin[3] = {};
+    uint32_t rangeStart = 0;
+    float boundsMax[3] = {};
+    uint32_t rangeCount = 0;
+    uint32_t rightChild = 0;
+    uint32_t pad[3] = {};
+};
+static_assert(sizeof(GPUInstanceBvhNode) == 48, "GPUInstanceBvhNode must match shader layout");
+
+// Leaves hold at most kInstanceBvhLeafSize instances. The culler runs one threadgroup
+// per subtree root; roots cover at most kInstanceBvhSubtreeInstances instances.
+static constexpr uint32_t kInstanceBvhLeafSize = 4;
+static constexpr uint32_t kInstanceBvhSubtreeInstances = 256;
 
 struct GpuSceneTables {
     std::vector<GPUSceneGeometry> geometries;
     std::vector<GPUSceneInstance> instances;
+    std::vector<GPUInstanceTransform> instancePrevTransforms;
+    std::vector<GPUSceneInstanceCull> instanceCull;
+    // First instance of each scene node and how many follow it; more than one
+    // for nodes drawn through a MeshInstanceSet.
     std::vector<uint32_t> nodeToInstance;
+    std::vector<uint32_t> nodeInstanceCount;
 
     RhiBufferHandle geometryBuffer;
     RhiBufferHandle instanceBuffer;
+    RhiBufferHandle instancePrevTransformBuffer;
+    RhiBufferHandle instanceCullBuffer;
+    // Instances whose world transform changed in the last update. The next update
+    // copies it into instancePrevTransforms and re-uploads them so motion settles.
+    std::vector<uint32_t> movedInstances;
+    uint32_t sceneVisibilityRevision = 0;
+
+    // Instance BVH, refit on the CPU whenever a transform changes.
+    std::vector<GPUInstanceBvhNode> instanceBvhNodes;
+    std::vector<uint32_t> instanceBvhInstances;
+    std::vector<uint32_t> instanceBvhSubtreeRoots;
+    RhiBufferHandle instanceBvhNodeBuffer;
+    RhiBufferHandle instanceBvhInstanceBuffer;
+    RhiBufferHandle instanceBvhSubtreeRootBuffer;
+
+    // Scene nodes in depth order for TransformHierarchyPass. Local matrices live in
+    // mapped memory and only edited ones are rewritten; the pass rebuilds world
+    // matrices level by level and writes them into the instance and cull tables.
+    std::vector<uint32_t> hierarchyNodeSlot;
+    std::vector<uint32_t> hierarchyLevelStart;
+    RhiBufferHandle hierarchySlotBuffer;
+    RhiBufferHandle hierarchyLocalBuffer;
+    RhiBufferHandle hierarchyWorldBuffer;
+    // Set while the active pipeline runs TransformHierarchyPass; the CPU then
+    // leaves instance transforms and cull spheres in the GPU tables alone.
+    bool gpuTransformPropagation = false;
+
+    // Visible point and spot lights, rewritten every frame from lightNodes.
+    std::vector<uint32_t> lightNodes;
+    std::vector<GPUPunctualLight> lights;
+    RhiBufferHandle lightBuffer;
+    uint32_t lightCount = 0;
 
     uint32_t geometryCount = 0;
     uint32_t instanceCount = 0;
     uint32_t totalMeshletDispatchCount = 0;
     uint32_t visibleInstanceCount = 0;
-
-    // Cluster visualization CPU worklist (Phase 1)
-    std::vector<ClusterInfo> clusterVisWorklist;
-    RhiBufferHandle clusterVisWorklistBuffer;
-    uint32_t clusterVisWorklistCount = 0;
+    // Bumped when the scene is built and whenever an instance moves or changes
+    // visibility; cached shadow cascades are redrawn when it changes.
+    uint32_t contentRevision = 0;
 };
 
 bool buildGpuSceneTables(const RhiDevice& device,
@@ -66,5 +156,7 @@ bool buildGpuSceneTables(const RhiDevice& device,
                          const ClusterLODData* clusterLodData,
                          const SceneGraph& sceneGraph,
                          GpuSceneTables& out);
-void updateGpuSceneTables(const SceneGraph& sceneGraph, GpuSceneTables& tables);
+// Uploads only the instances whose transform or visibility changed and consumes
+// sceneGraph.transformChangedNodes.
+void updateGpuSceneTables(SceneGraph& sceneGraph, GpuSceneTables& tables);
 void releaseGpuSceneTables(GpuSceneTables& tables);
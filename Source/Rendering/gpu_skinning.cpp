@@ -0,0 +1,359 @@
+#include "gpu_skinning.h"
+
+#include "mesh_loader.h"
+#include "meshlet_builder.h"
+#include "parallel_for.h"
+#include "rhi_resource_utils.h"
+#include "scene.h"
+#include "scene_graph.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+// Renderable node drawing primitive primitiveInMesh of the mesh on nodeId: the
+// node itself, or the generated child createSceneGraph() split off for it.
+int32_t renderNodeForPrimitive(const SceneGraph& sceneGraph, uint32_t nodeId, uint32_t primitiveInMesh) {
+    const SceneNode& node = sceneGraph.nodes[nodeId];
+    if (node.meshletCount > 0 && node.primitiveIndexInMesh == primitiveInMesh) {
+        return static_cast<int32_t>(nodeId);
+    }
+    for (uint32_t childId : node.children) {
+        const SceneNode& child = sceneGraph.nodes[childId];
+        if (child.generatedPrimitive && child.primitiveIndexInMesh == primitiveInMesh && child.meshletCount > 0) {
+            return static_cast<int32_t>(childId);
+        }
+    }
+    return -1;
+}
+
+float maxColumnScale(const float4x4& m) {
+    float maxScale = 0.0f;
+    for (uint32_t column = 0; column < 3; ++column) {
+        const float4& c = m.Col(column);
+        maxScale = std::max(maxScale, std::sqrt(c.x * c.x + c.y * c.y + c.z * c.z));
+    }
+    return maxScale;
+}
+
+RhiBufferHandle createStream(const RhiDevice& device, const void* data, size_t size, const char* name) {
+    // Unused streams still get bound, so keep them non-empty.
+    static const uint32_t kZero[4] = {};
+    return size > 0 ? rhiCreateDeviceBuffer(device, data, size, name)
+                    : rhiCreateDeviceBuffer(device, kZero, sizeof(kZero), name);
+}
+
+RhiBufferHandle createDynamicStream(const RhiDevice& device, const std::vector<float>& data, const char* name) {
+    static const float kZero[4] = {};
+    RhiBufferDesc desc;
+    desc.size = data.empty() ? sizeof(kZero) : data.size() * sizeof(float);
+    desc.initialData = data.empty() ? kZero : data.data();
+    desc.memory = RhiBufferMemory::DynamicDeviceLocal;
+    desc.debugName = name;
+    return rhiCreateBuffer(device, desc);
+}
+
+void uploadStream(const RhiBufferHandle& buffer, const std::vector<float>& data) {
+    void* mappedData = buffer.nativeHandle() && !data.empty() ? rhiBufferContents(buffer) : nullptr;
+    if (mappedData) {
+        rhiWriteCombinedCopy(mappedData, data.data(), data.size() * sizeof(float));
+    }
+}
+
+// Rewrites the palettes and morph weights of deformers whose pose changed (all
+// of them when forceAll is set) and refreshes their render nodes' bounds.
+void refreshDeformers(SceneGraph& sceneGraph, GpuSkinningTables& tables, bool forceAll) {
+    std::vector<uint8_t> changed(tables.deformers.size(), forceAll ? 1 : 0);
+    Parallel::parallelFor(tables.deformers.size(), [&](size_t deformerIndex) {
+        const GpuSkinningDeformer& deformer = tables.deformers[deformerIndex];
+        const SceneNode& owner = sceneGraph.nodes[deformer.ownerNode];
+
+        float morphPadding = 0.0f;
+        for (uint32_t t = 0; t < deformer.morphWeightCount; ++t) {
+            const float weight = t < owner.morphWeights.size() ? owner.morphWeights[t] : 0.0f;
+            float& uploaded = tables.morphWeights[deformer.morphWeightStart + t];
+            if (uploaded != weight) {
+                uploaded = weight;
+                changed[deformerIndex] = 1;
+            }
+            morphPadding += std::fabs(weight) * deformer.maxMorphDelta[t];
+        }
+
+        // Joint matrices are relative to the owner, whose world matrix places the instance.
+        float4x4 ownerInverse = owner.transform.worldMatrix;
+        ownerInverse.Invert();
+        const SkinComponent* skin = deformer.skin >= 0 ? &sceneGraph.skins[deformer.skin] : nullptr;
+        float3 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        float3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (size_t sphereIndex = 0; sphereIndex < deformer.jointSpheres.size(); ++sphereIndex) {
+            float4x4 jointMatrix = float4x4::Identity();
+            if (skin && sphereIndex < skin->joints.size()) {
+                const uint32_t jointNode = skin->joints[sphereIndex];
+                jointMatrix = ownerInverse * sceneGraph.nodes[jointNode].transform.worldMatrix *
+                              skin->inverseBindMatrices[sphereIndex];
+                const float4x4 rowMajor = transpose(jointMatrix);
+                float* rows = tables.palette.data() + (deformer.paletteStart + sphereIndex) * 12;
+                if (std::memcmp(rows, &rowMajor, sizeof(float) * 12) != 0) {
+                    std::memcpy(rows, &rowMajor, sizeof(float) * 12);
+                    changed[deformerIndex] = 1;
+                }
+            }
+
+            const float4& sphere = deformer.jointSpheres[sphereIndex];
+            if (sphere.w < 0.0f) {
+                continue;
+            }
+            const float3 center = jointMatrix * float3(sphere.x, sphere.y, sphere.z);
+            const float radius = (sphere.w + morphPadding) * maxColumnScale(jointMatrix);
+            boundsMin = min(boundsMin, center - radius);
+            boundsMax = max(boundsMax, center + radius);
+        }
+        if (!changed[deformerIndex] || boundsMin.x > boundsMax.x) {
+            return;
+        }
+
+        const float3 center = (boundsMin + boundsMax) * 0.5f;
+        const float bounds[4] = {center.x, center.y, center.z, length(boundsMax - center)};
+        for (uint32_t nodeId : deformer.renderNodes) {
+            std::memcpy(sceneGraph.nodes[nodeId].deformedBounds, bounds, sizeof(bounds));
+        }
+    });
+
+    bool anyChanged = false;
+    for (size_t deformerIndex = 0; deformerIndex < tables.deformers.size(); ++deformerIndex) {
+        if (!changed[deformerIndex]) {
+            continue;
+        }
+        anyChanged = true;
+        const std::vector<uint32_t>& renderNodes = tables.deformers[deformerIndex].renderNodes;
+        sceneGraph.transformChangedNodes.insert(sceneGraph.transformChangedNodes.end(),
+                                                renderNodes.begin(), renderNodes.end());
+    }
+    if (anyChanged) {
+        uploadStream(tables.paletteBuffer, tables.palette);
+        uploadStream(tables.morphWeightBuffer, tables.morphWeights);
+    }
+}
+
+} // namespace
+
+bool buildGpuSkinning(const RhiDevice& device,
+                      const Scene& scene,
+                      const LoadedMesh& mesh,
+                      const MeshletData& meshletData,
+                      SceneGraph& sceneGraph,
+                      GpuSkinningTables& out) {
+    releaseGpuSkinning(out);
+    out = GpuSkinningTables{};
+    if (scene.skins.empty() && scene.morphDeltas.empty()) {
+        return false;
+    }
+
+    std::vector<uint32_t> meshletGroupPrefix(mesh.primitiveGroups.size() + 1, 0);
+    for (size_t i = 0; i < mesh.primitiveGroups.size(); ++i) {
+        const uint32_t count = i < meshletData.meshletsPerGroup.size() ? meshletData.meshletsPerGroup[i] : 0;
+        meshletGroupPrefix[i + 1] = meshletGroupPrefix[i] + count;
+    }
+
+    std::vector<float> restPositions;
+    std::vector<float> restNormals;
+    std::vector<uint16_t> joints;
+    std::vector<float> weights;
+    std::vector<int32_t> meshDeformer(scene.meshInfos.size(), -1);
+    const uint32_t nodeCount = static_cast<uint32_t>(std::min(scene.nodes.size(), sceneGraph.nodes.size()));
+    for (uint32_t nodeId = 0; nodeId < nodeCount; ++nodeId) {
+        const SceneNodeData& sn = scene.nodes[nodeId];
+        if (sn.mesh < 0 || sn.mesh >= static_cast<int>(scene.meshInfos.size())) {
+            continue;
+        }
+        const SceneMeshInfo& meshInfo = scene.meshInfos[sn.mesh];
+        const uint32_t jointCount = sn.skin >= 0 ? static_cast<uint32_t>(scene.skins[sn.skin].joints.size()) : 0;
+        uint32_t morphTargetCount = 0;
+        bool hasSkinnedPrimitive = false;
+        for (uint32_t p = 0; p < meshInfo.primitiveCount; ++p) {
+            const ScenePrimitive& primitive = scene.primitives[meshInfo.firstPrimitive + p];
+            morphTargetCount = std::max(morphTargetCount, primitive.morphTargetCount);
+            hasSkinnedPrimitive |= primitive.skinned;
+        }
+        const bool skinned = jointCount > 0 && hasSkinnedPrimitive;
+        if (!skinned && morphTargetCount == 0) {
+            continue;
+        }
+
+        const bool sharedMesh = meshDeformer[sn.mesh] >= 0;
+        if (sharedMesh) {
+            // The vertices are deformed in place, so every node drawing the mesh
+            // shows the pose of the first one.
+            spdlog::warn("GpuSkinning: node '{}' shares a deformed mesh and follows node {}'s pose",
+                         sn.name, out.deformers[meshDeformer[sn.mesh]].ownerNode);
+        } else {
+            meshDeformer[sn.mesh] = static_cast<int32_t>(out.deformers.size());
+            GpuSkinningDeformer& deformer = out.deformers.emplace_back();
+            deformer.ownerNode = nodeId;
+            deformer.skin = skinned ? sn.skin : -1;
+            deformer.paletteStart = static_cast<uint32_t>(out.palette.size() / 12);
+            deformer.morphWeightStart = static_cast<uint32_t>(out.morphWeights.size());
+            deformer.morphWeightCount = morphTargetCount;
+            out.palette.resize(out.palette.size() + (skinned ? jointCount : 0) * 12, 0.0f);
+            out.morphWeights.resize(out.morphWeights.size() + morphTargetCount, 0.0f);
+            // One sphere per joint plus one for vertices no joint moves.
+            deformer.jointSpheres.assign((skinned ? jointCount : 0) + 1, float4(0.f, 0.f, 0.f, -1.f));
+            deformer.maxMorphDelta.assign(morphTargetCount, 0.0f);
+        }
+        GpuSkinningDeformer& deformer = out.deformers[meshDeformer[sn.mesh]];
+        const bool ownsRanges = !sharedMesh;
+        const uint32_t restJoint = static_cast<uint32_t>(deformer.jointSpheres.size() - 1);
+        std::vector<float3> sphereMin(deformer.jointSpheres.size(), float3(FLT_MAX, FLT_MAX, FLT_MAX));
+        std::vector<float3> sphereMax(deformer.jointSpheres.size(), float3(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+
+        for (uint32_t p = 0; p < meshInfo.primitiveCount; ++p) {
+            const uint32_t groupIndex = meshInfo.firstPrimitive + p;
+            const ScenePrimitive& primitive = scene.primitives[groupIndex];
+            const bool skinnedRange = deformer.skin >= 0 && primitive.skinned;
+            if (!skinnedRange && primitive.morphTargetCount == 0) {
+                continue;
+            }
+            const int32_t renderNode = renderNodeForPrimitive(sceneGraph, nodeId, p);
+            if (renderNode >= 0) {
+                SceneNode& node = sceneGraph.nodes[renderNode];
+                node.deformed = true;
+                // Cluster LOD was simplified from the rest pose.
+                node.lodRootNode = UINT32_MAX;
+                deformer.renderNodes.push_back(static_cast<uint32_t>(renderNode));
+            }
+            if (!ownsRanges || groupIndex >= mesh.primitiveGroups.size()) {
+                continue;
+            }
+
+            GPUSkinningRange range;
+            range.vertexStart = primitive.vertexOffset;
+            range.vertexCount = primitive.vertexCount;
+            range.restStart = static_cast<uint32_t>(restPositions.size() / 3);
+            range.paletteStart = skinnedRange ? deformer.paletteStart : UINT32_MAX;
+            range.morphDeltaStart = primitive.morphDeltaOffset;
+            range.morphTargetCount = primitive.morphTargetCount;
+            range.morphWeightStart = deformer.morphWeightStart;
+            range.meshletStart = meshletGroupPrefix[groupIndex];
+            range.meshletCount = meshletGroupPrefix[groupIndex + 1] - range.meshletStart;
+            out.ranges.push_back(range);
+            out.deformedVertexCount += range.vertexCount;
+
+            const size_t first = primitive.vertexOffset;
+            const size_t count = primitive.vertexCount;
+            restPositions.insert(restPositions.end(),
+                                 scene.positions.begin() + first * 3,
+                                 scene.positions.begin() + (first + count) * 3);
+            restNormals.insert(restNormals.end(),
+                               scene.normals.begin() + first * 3,
+                               scene.normals.begin() + (first + count) * 3);
+            if (skinnedRange) {
+                joints.insert(joints.end(),
+                              scene.skinJoints.begin() + first * 4,
+                              scene.skinJoints.begin() + (first + count) * 4);
+                weights.insert(weights.end(),
+                               scene.skinWeights.begin() + first * 4,
+                               scene.skinWeights.begin() + (first + count) * 4);
+            } else {
+                joints.resize(joints.size() + count * 4, 0);
+                weights.resize(weights.size() + count * 4, 0.0f);
+            }
+
+            for (size_t v = 0; v < count; ++v) {
+                const float* p3 = scene.positions.data() + (first + v) * 3;
+                const float3 position(p3[0], p3[1], p3[2]);
+                auto grow = [&](uint32_t sphere) {
+                    sphereMin[sphere] = min(sphereMin[sphere], position);
+                    sphereMax[sphere] = max(sphereMax[sphere], position);
+                };
+                if (!skinnedRange) {
+                    grow(restJoint);
+                    continue;
+                }
+                for (uint32_t k = 0; k < 4; ++k) {
+                    const uint32_t joint = scene.skinJoints[(first + v) * 4 + k];
+                    if (scene.skinWeights[(first + v) * 4 + k] > 0.0f && joint < restJoint) {
+                        grow(joint);
+                    }
+                }
+            }
+            for (uint32_t t = 0; t < primitive.morphTargetCount; ++t) {
+                const float* deltas = scene.morphDeltas.data() + primitive.morphDeltaOffset + t * count * 6;
+                float maxDelta = 0.0f;
+                for (size_t v = 0; v < count; ++v) {
+                    const float* d = deltas + v * 3;
+                    maxDelta = std::max(maxDelta, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+                }
+                deformer.maxMorphDelta[t] = std::max(deformer.maxMorphDelta[t], std::sqrt(maxDelta));
+            }
+        }
+
+        if (!ownsRanges) {
+            continue;
+        }
+        for (size_t sphere = 0; sphere < deformer.jointSpheres.size(); ++sphere) {
+            if (sphereMin[sphere].x > sphereMax[sphere].x) {
+                continue;
+            }
+            const float3 center = (sphereMin[sphere] + sphereMax[sphere]) * 0.5f;
+            deformer.jointSpheres[sphere] = float4(center.x, center.y, center.z,
+                                                   length(sphereMax[sphere] - center));
+        }
+        sceneGraph.nodes[nodeId].morphWeights.resize(morphTargetCount, 0.0f);
+    }
+
+    if (out.ranges.empty()) {
+        out = GpuSkinningTables{};
+        return false;
+    }
+
+    out.restPositionBuffer = createStream(device, restPositions.data(), restPositions.size() * sizeof(float),
+                                          "Skinning Rest Positions");
+    out.restNormalBuffer = createStream(device, restNormals.data(), restNormals.size() * sizeof(float),
+                                        "Skinning Rest Normals");
+    out.jointBuffer = createStream(device, joints.data(), joints.size() * sizeof(uint16_t), "Skinning Joints");
+    out.weightBuffer = createStream(device, weights.data(), weights.size() * sizeof(float), "Skinning Weights");
+    out.morphDeltaBuffer = createStream(device, scene.morphDeltas.data(), scene.morphDeltas.size() * sizeof(float),
+                                        "Morph Target Deltas");
+    out.paletteBuffer = createDynamicStream(device, out.palette, "Skinning Joint Palette");
+    out.morphWeightBuffer = createDynamicStream(device, out.morphWeights, "Morph Target Weights");
+    if (!out.restPositionBuffer.nativeHandle() || !out.restNormalBuffer.nativeHandle() ||
+        !out.jointBuffer.nativeHandle() || !out.weightBuffer.nativeHandle() ||
+        !out.morphDeltaBuffer.nativeHandle() || !out.paletteBuffer.nativeHandle() ||
+        !out.morphWeightBuffer.nativeHandle()) {
+        spdlog::error("GpuSkinning: failed to create skinning buffers");
+        releaseGpuSkinning(out);
+        return false;
+    }
+
+    refreshDeformers(sceneGraph, out, true);
+    spdlog::info("GpuSkinning: {} deformed meshes, {} ranges, {} vertices, {} joint matrices, {} morph weights",
+                 out.deformers.size(), out.ranges.size(), out.deformedVertexCount,
+                 out.palette.size() / 12, out.morphWeights.size());
+    return true;
+}
+
+void updateGpuSkinning(SceneGraph& sceneGraph, GpuSkinningTables& tables) {
+    if (!tables.deformers.empty()) {
+        refreshDeformers(sceneGraph, tables, false);
+    }
+}
+
+void releaseGpuSkinning(GpuSkinningTables& tables) {
+    rhiReleaseHandle(tables.restPositionBuffer);
+    rhiReleaseHandle(tables.restNormalBuffer);
+    rhiReleaseHandle(tables.jointBuffer);
+    rhiReleaseHandle(tables.weightBuffer);
+    rhiReleaseHandle(tables.morphDeltaBuffer);
+    rhiReleaseHandle(tables.paletteBuffer);
+    rhiReleaseHandle(tables.morphWeightBuffer);
+    tables.ranges.clear();
+    tables.deformers.clear();
+    tables.palette.clear();
+    tables.morphWeights.clear();
+    tables.deformedVertexCount = 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <ml.h>
+
+#include "rhi_backend.h"
+
+struct LoadedMesh;
+struct MeshletData;
+class Scene;
+class SceneGraph;
+
+// One primitive group SkinningPass deforms, passed as push constants
+// (skinning.slang). Rest, joint and weight streams are indexed from restStart;
+// the deformed result overwrites the mesh position and normal buffers.
+struct GPUSkinningRange {
+    uint32_t vertexStart = 0;
+    uint32_t vertexCount = 0;
+    uint32_t restStart = 0;
+    uint32_t paletteStart = UINT32_MAX;   // UINT32_MAX: morph targets only
+    uint32_t morphDeltaStart = 0;          // float offset into the morph delta buffer
+    uint32_t morphTargetCount = 0;
+    uint32_t morphWeightStart = 0;
+    uint32_t meshletStart = 0;
+    uint32_t meshletCount = 0;
+};
+static_assert(sizeof(GPUSkinningRange) == 36, "GPUSkinningRange must match shader layout");
+
+// A node whose skin or morph weights drive the vertices of its mesh, and the
+// renderable nodes (the node or its generated primitives) that draw them.
+struct GpuSkinningDeformer {
+    uint32_t ownerNode = 0;
+    int32_t skin = -1;
+    uint32_t paletteStart = 0;
+    uint32_t morphWeightStart = 0;
+    uint32_t morphWeightCount = 0;
+    std::vector<uint32_t> renderNodes;
+    // Bind-pose sphere around the vertices each joint influences; a single rest
+    // sphere for meshes with morph targets only. Radius < 0 marks unused joints.
+    std::vector<float4> jointSpheres;
+    // Longest position delta of each morph target.
+    std::vector<float> maxMorphDelta;
+};
+
+struct GpuSkinningTables {
+    std::vector<GPUSkinningRange> ranges;
+    std::vector<GpuSkinningDeformer> deformers;
+    // Three rows (row-major, like GPUInstanceTransform) per joint matrix, mapping
+    // bind-pose vertices into the owner node's space.
+    std::vector<float> palette;
+    std::vector<float> morphWeights;
+
+    RhiBufferHandle restPositionBuffer;
+    RhiBufferHandle restNormalBuffer;
+    RhiBufferHandle jointBuffer;
+    RhiBufferHandle weightBuffer;
+    RhiBufferHandle morphDeltaBuffer;
+    RhiBufferHandle paletteBuffer;
+    RhiBufferHandle morphWeightBuffer;
+
+    uint32_t deformedVertexCount = 0;
+};
+
+// Collects the skinned and morphed meshes, marks their renderable nodes as
+// deformed (which also drops them from cluster LOD) and uploads the rest-pose
+// streams. Run before buildGpuSceneTables(). Returns false when nothing deforms.
+bool buildGpuSkinning(const RhiDevice& device,
+                      const Scene& scene,
+                      const LoadedMesh& mesh,
+                      const MeshletData& meshletData,
+                      SceneGraph& sceneGraph,
+                      GpuSkinningTables& out);
+// Rebuilds joint palettes and morph weights from the current world matrices and
+// refreshes the deformed nodes' bounds, listing the nodes whose pose changed in
+// sceneGraph.transformChangedNodes. Run between updateTransforms() and
+// updateGpuSceneTables().
+void updateGpuSkinning(SceneGraph& sceneGraph, GpuSkinningTables& tables);
+void releaseGpuSkinning(GpuSkinningTables& tables);
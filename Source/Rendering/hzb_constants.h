@@ -3,50 +3,72 @@
 
 #define HZB_MAX_LEVELS 10u
 
+// The pyramid starts at half the depth resolution: HZB mip m holds depth level m + 1,
+// the farthest depth over a (2 << m)-pixel square. A full-resolution mip 0 would only
+// copy the depth buffer, and no cull test reads that fine a level.
+#define HZB_BASE_LEVEL 1u
+
 #ifdef __cplusplus
 
 #include <algorithm>
 #include <cstdint>
-#include <string>
 
 #include "rhi_backend.h"
 
 static constexpr uint32_t kHzbMaxLevels = HZB_MAX_LEVELS;
 
+// The pyramid is one mipped texture, so level sizes follow the GPU mip chain (round
+// down). The build folds the odd row/column of each level into the last texel.
 inline uint32_t hzbLevelDimension(uint32_t baseDimension, uint32_t level) {
-    uint32_t dimension = std::max(baseDimension, 1u);
-    for (uint32_t currentLevel = 0; currentLevel < level; ++currentLevel) {
-        dimension = std::max(1u, (dimension + 1u) / 2u);
-    }
-    return dimension;
+    return std::max(std::max(baseDimension, 1u) >> std::min(level, 31u), 1u);
 }
 
 inline uint32_t computeHzbLevelCount(uint32_t width, uint32_t height) {
-    uint32_t levels = 0;
-    uint32_t currentWidth = std::max(width, 1u);
-    uint32_t currentHeight = std::max(height, 1u);
-
-    while (levels < kHzbMaxLevels) {
+    uint32_t levels = 1;
+    uint32_t largest = std::max(std::max(width, height), 1u);
+    while (levels < kHzbMaxLevels && largest > 1u) {
+        largest >>= 1u;
         ++levels;
-        if (currentWidth == 1u && currentHeight == 1u) {
-            break;
-        }
-        currentWidth = std::max(1u, (currentWidth + 1u) / 2u);
-        currentHeight = std::max(1u, (currentHeight + 1u) / 2u);
     }
-
     return levels;
 }
 
-inline RhiTextureDesc makeHzbTextureDesc(uint32_t width, uint32_t height, uint32_t level) {
-    return RhiTextureDesc::storageTexture(
-        hzbLevelDimension(width, level),
-        hzbLevelDimension(height, level),
-        RhiFormat::R32Float);
+// width and height are the depth buffer's. halfPrecision matches shaders built with
+// METALLIC_HZB_16 (PipelineRuntimeContext::hzb16).
+inline RhiTextureDesc makeHzbTextureDesc(uint32_t width, uint32_t height, bool halfPrecision) {
+    const uint32_t hzbWidth = hzbLevelDimension(width, HZB_BASE_LEVEL);
+    const uint32_t hzbHeight = hzbLevelDimension(height, HZB_BASE_LEVEL);
+    RhiTextureDesc desc = RhiTextureDesc::storageTexture(
+        hzbWidth, hzbHeight, halfPrecision ? RhiFormat::R16Float : RhiFormat::R32Float);
+    desc.mipLevels = computeHzbLevelCount(hzbWidth, hzbHeight);
+    return desc;
 }
 
-inline std::string hzbHistoryResourceName(uint32_t level) {
-    return "history.hzb.mip" + std::to_string(level);
+static constexpr const char* kHzbHistoryResourceName = "history.hzb";
+
+#else
+
+// METALLIC_HZB_16 stores the pyramid as R16Float. Half keeps reversed-Z depth well,
+// since its precision follows the small far values, but a round-to-nearest store
+// could land nearer than the depth it summarizes and cull something visible.
+// hzbStoreValue() rounds toward far (0) instead, so the pyramid stays conservative.
+#ifdef METALLIC_HZB_16
+#define HZB_IMAGE_FORMAT [[vk::image_format("r16f")]]
+#else
+#define HZB_IMAGE_FORMAT
+#endif
+
+float hzbStoreValue(float depth) {
+#ifdef METALLIC_HZB_16
+    uint bits = f32tof16(depth);
+    // Depth is non-negative, so the previous half is one bit pattern down.
+    if (bits != 0u && f16tof32(bits) > depth) {
+        bits -= 1u;
+    }
+    return f16tof32(bits);
+#else
+    return depth;
+#endif
 }
 
 #endif
@@ -0,0 +1,370 @@
+#pragma once
+
+#include "camera.h"
+#include "job_system.h"
+
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include "vulkan_upload_service.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Offline image-sequence mode (--sequence <dir>): renders warm-up plus N frames
+// back to back with a fixed timestep and writes the display image of each one
+// to <dir>/frame_NNNNN.png. Turntables orbit the camera once over the sequence
+// unless a camera timeline is replayed (--replay-timeline).
+//
+// Nothing waits on the GPU. A captured frame copies the viewport texture into
+// the VulkanReadbackHeap slice of its frame in flight. The copy is read once that
+// slice's fence has signaled, framesInFlight frames later (--frames-in-flight sets
+// the depth). The pixels are then PNG-encoded on the job system while the
+// following frames render. Frames must fit one heap slice (16 MiB, about 4 MP).
+class ImageSequenceCapture {
+public:
+    struct Settings {
+        std::string outputDirectory;
+        uint32_t warmupFrames = 30u;
+        uint32_t frames = 120u;
+        double timestep = 1.0 / 30.0;
+        int width = 1920;
+        int height = 1080;
+    };
+
+    // Returns false on a malformed sequence argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* path = takeValue("--sequence")) {
+                settings.outputDirectory = path;
+            } else if (const char* frames = takeValue("--sequence-warmup")) {
+                settings.warmupFrames = static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+            } else if (const char* frames = takeValue("--sequence-frames")) {
+                settings.frames = std::max(1u, static_cast<uint32_t>(std::strtoul(frames, nullptr, 10)));
+            } else if (const char* seconds = takeValue("--sequence-timestep")) {
+                settings.timestep = std::max(1e-4, std::strtod(seconds, nullptr));
+            } else if (const char* size = takeValue("--sequence-size")) {
+                int width = 0;
+                int height = 0;
+                if (std::sscanf(size, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0) {
+                    spdlog::error("--sequence-size expects WIDTHxHEIGHT, got {}", size);
+                    return false;
+                }
+                settings.width = width;
+                settings.height = height;
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--sequence-", 11) == 0) {
+                spdlog::error("Unknown sequence argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ~ImageSequenceCapture() {
+        Jobs::JobSystem::instance().wait(m_encodeJobs);
+    }
+
+    bool begin(const Settings& settings, const OrbitCamera& camera, bool drivesCamera) {
+        std::error_code error;
+        std::filesystem::create_directories(settings.outputDirectory, error);
+        if (error) {
+            spdlog::error("Failed to create sequence directory {}: {}", settings.outputDirectory, error.message());
+            return false;
+        }
+        m_settings = settings;
+        m_baseCamera = camera;
+        m_drivesCamera = drivesCamera;
+        m_frame = 0u;
+        m_framesWritten = 0u;
+        m_active = true;
+        m_startTime = std::chrono::steady_clock::now();
+        spdlog::info("Image sequence: {} warm-up + {} frames at {}x{} into {}",
+                     settings.warmupFrames, settings.frames, settings.width, settings.height,
+                     settings.outputDirectory);
+        return true;
+    }
+
+    bool active() const { return m_active; }
+    // Every frame was rendered and its readback consumed; encodes may still run.
+    bool finished() const {
+        return m_active && m_frame >= m_settings.warmupFrames + m_settings.frames && m_pending.empty();
+    }
+
+    float timestep() const { return static_cast<float>(m_settings.timestep); }
+    uint32_t jitterIndex() const { return m_frame; }
+
+    // Call once per frame before the view is built.
+    void update(OrbitCamera& camera) const {
+        if (!m_active || !m_drivesCamera) {
+            return;
+        }
+        const float turn = float(std::min(m_frame, m_settings.warmupFrames + m_settings.frames)) -
+                           float(m_settings.warmupFrames);
+        camera = m_baseCamera;
+        camera.azimuth = m_baseCamera.azimuth +
+                         2.0f * OrbitCamera::kPi * turn / float(m_settings.frames);
+    }
+
+    // Sequence index of the frame being built, or -1 for warm-up and drain frames.
+    // Advances the sequence; call once per frame after update().
+    int32_t beginFrame() {
+        if (!m_active) {
+            return -1;
+        }
+        const uint32_t frame = m_frame;
+        m_frame = std::min(m_frame + 1u, m_settings.warmupFrames + m_settings.frames);
+        if (frame < m_settings.warmupFrames || frame >= m_settings.warmupFrames + m_settings.frames) {
+            return -1;
+        }
+        return static_cast<int32_t>(frame - m_settings.warmupFrames);
+    }
+
+    // Waits for the outstanding encodes and logs the throughput.
+    void finish() {
+        if (!m_active) {
+            return;
+        }
+        Jobs::JobSystem::instance().wait(m_encodeJobs);
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+        spdlog::info("Image sequence finished: {} of {} frames written in {:.2f} s ({:.1f} frames/s)",
+                     m_framesWritten.load(), m_settings.frames, seconds,
+                     seconds > 0.0 ? double(m_settings.frames + m_settings.warmupFrames) / seconds : 0.0);
+        m_active = false;
+    }
+
+#ifdef _WIN32
+    // Records the copy of a BGRA8 image in currentLayout into this frame's readback
+    // slice and leaves the image in TRANSFER_SRC_OPTIMAL. Call from the frame's
+    // recording after the last write to the image.
+    VkImageLayout recordReadback(VulkanReadbackService& readbackService,
+                                 VkCommandBuffer cmd,
+                                 VkImage image,
+                                 VkImageLayout currentLayout,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 int32_t sequenceIndex) {
+        VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT |
+                               VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        barrier.oldLayout = currentLayout;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+        VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+        dep.imageMemoryBarrierCount = 1;
+        dep.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        PendingFrame pending;
+        pending.sequenceIndex = sequenceIndex;
+        pending.width = width;
+        pending.height = height;
+        pending.readback = readbackService.scheduleImageReadback(image, width, height, 4u);
+        readbackService.recordPendingReadbacks(cmd);
+        if (pending.readback.valid()) {
+            m_pending.push_back(pending);
+        } else {
+            spdlog::error("Image sequence: frame {} ({}x{}) does not fit the readback heap; skipped",
+                          sequenceIndex, width, height);
+        }
+        return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    }
+
+    // Call once per frame after readbackService.beginFrame(frameIndex). Hands every
+    // copy whose frame has retired to an encode job.
+    void consumeReadbacks(const VulkanReadbackService& readbackService, uint32_t frameIndex) {
+        while (!m_pending.empty() && readbackService.isReady(m_pending.front().readback, frameIndex)) {
+            const PendingFrame frame = m_pending.front();
+            m_pending.pop_front();
+            auto pixels = std::make_shared<std::vector<uint8_t>>(size_t(frame.width) * frame.height * 4u);
+            if (!readbackService.readData(frame.readback, pixels->data(), pixels->size())) {
+                spdlog::error("Image sequence: readback of frame {} failed", frame.sequenceIndex);
+                continue;
+            }
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%05d.png", frame.sequenceIndex);
+            const std::filesystem::path path = std::filesystem::path(m_settings.outputDirectory) / name;
+            Jobs::JobSystem::instance().run(m_encodeJobs, [this, path, pixels, frame]() {
+                if (writePngBgra8(path, frame.width, frame.height, pixels->data())) {
+                    m_framesWritten.fetch_add(1u, std::memory_order_relaxed);
+                } else {
+                    spdlog::error("Image sequence: failed to write {}", path.string());
+                }
+            });
+        }
+    }
+#endif
+
+    // 8-bit RGB PNG from tightly packed BGRA8 rows. The image data goes out as stored
+    // deflate blocks: larger files than zlib would produce, but encoding costs a copy and
+    // two checksums, which keeps the workers ahead of the GPU.
+    static bool writePngBgra8(const std::filesystem::path& path, uint32_t width, uint32_t height,
+                              const uint8_t* bgra) {
+        const size_t rowBytes = size_t(width) * 3u + 1u;
+        std::vector<uint8_t> raw(rowBytes * height);
+        for (uint32_t y = 0; y < height; ++y) {
+            uint8_t* row = raw.data() + rowBytes * y;
+            const uint8_t* src = bgra + size_t(width) * 4u * y;
+            row[0] = 0u; // filter: none
+            for (uint32_t x = 0; x < width; ++x) {
+                row[1u + x * 3u + 0u] = src[x * 4u + 2u];
+                row[1u + x * 3u + 1u] = src[x * 4u + 1u];
+                row[1u + x * 3u + 2u] = src[x * 4u + 0u];
+            }
+        }
+
+        constexpr size_t kMaxStoredBlock = 65535u;
+        std::vector<uint8_t> zlib;
+        zlib.reserve(raw.size() + raw.size() / kMaxStoredBlock * 5u + 16u);
+        zlib.push_back(0x78u);
+        zlib.push_back(0x01u);
+        for (size_t offset = 0;; offset += kMaxStoredBlock) {
+            const size_t blockSize = std::min(kMaxStoredBlock, raw.size() - offset);
+            const bool last = offset + blockSize >= raw.size();
+            zlib.push_back(last ? 1u : 0u);
+            zlib.push_back(uint8_t(blockSize & 0xFFu));
+            zlib.push_back(uint8_t(blockSize >> 8u));
+            zlib.push_back(uint8_t(~blockSize & 0xFFu));
+            zlib.push_back(uint8_t((~blockSize >> 8u) & 0xFFu));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+            if (last) {
+                break;
+            }
+        }
+        appendBigEndian(zlib, adler32(raw.data(), raw.size()));
+
+        std::array<uint8_t, 13> header{};
+        const auto store32 = [](uint8_t* dst, uint32_t value) {
+            dst[0] = uint8_t(value >> 24u);
+            dst[1] = uint8_t(value >> 16u);
+            dst[2] = uint8_t(value >> 8u);
+            dst[3] = uint8_t(value);
+        };
+        store32(header.data(), width);
+        store32(header.data() + 4, height);
+        header[8] = 8u;  // bit depth
+        header[9] = 2u;  // color type: RGB
+
+        std::vector<uint8_t> png = {0x89u, 'P', 'N', 'G', '\r', '\n', 0x1Au, '\n'};
+        png.reserve(zlib.size() + 64u);
+        appendChunk(png, "IHDR", header.data(), header.size());
+        appendChunk(png, "IDAT", zlib.data(), zlib.size());
+        appendChunk(png, "IEND", nullptr, 0u);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+        return static_cast<bool>(file);
+    }
+
+private:
+    static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(uint8_t(value >> 24u));
+        out.push_back(uint8_t(value >> 16u));
+        out.push_back(uint8_t(value >> 8u));
+        out.push_back(uint8_t(value));
+    }
+
+    static uint32_t adler32(const uint8_t* data, size_t size) {
+        uint32_t a = 1u;
+        uint32_t b = 0u;
+        while (size > 0u) {
+            // 5552 bytes is the most that cannot overflow b before the modulo.
+            const size_t chunk = std::min<size_t>(size, 5552u);
+            for (size_t i = 0; i < chunk; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521u;
+            b %= 65521u;
+            data += chunk;
+            size -= chunk;
+        }
+        return (b << 16u) | a;
+    }
+
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> kTable = [] {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t n = 0; n < 256u; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1u) ? 0xEDB88320u ^ (c >> 1u) : c >> 1u;
+                }
+                table[n] = c;
+            }
+            return table;
+        }();
+        for (size_t i = 0; i < size; ++i) {
+            crc = kTable[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8u);
+        }
+        return crc;
+    }
+
+    static void appendChunk(std::vector<uint8_t>& png, const char type[4], const uint8_t* data, size_t size) {
+        appendBigEndian(png, static_cast<uint32_t>(size));
+        const size_t typeOffset = png.size();
+        png.insert(png.end(), type, type + 4);
+        if (size > 0u) {
+            png.insert(png.end(), data, data + size);
+        }
+        const uint32_t crc = crc32(0xFFFFFFFFu, png.data() + typeOffset, size + 4u) ^ 0xFFFFFFFFu;
+        appendBigEndian(png, crc);
+    }
+
+#ifdef _WIN32
+    struct PendingFrame {
+        int32_t sequenceIndex = 0;
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        VulkanReadbackService::ReadbackRequest readback;
+    };
+    std::deque<PendingFrame> m_pending;
+#else
+    std::deque<int32_t> m_pending;
+#endif
+
+    Settings m_settings;
+    OrbitCamera m_baseCamera;
+    bool m_drivesCamera = true;
+    uint32_t m_frame = 0u;
+    std::atomic<uint32_t> m_framesWritten{0u};
+    bool m_active = false;
+    std::chrono::steady_clock::time_point m_startTime;
+    Jobs::JobCounter m_encodeJobs;
+};
@@ -5,9 +5,10 @@
 extern bool s_viewportHovered;
 
 static void mouseButtonCallback(GLFWwindow* window, int button, int action, int /*mods*/) {
+    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
+    ++state->eventSerial;
     if (ImGui::GetIO().WantCaptureMouse && !s_viewportHovered)
         return;
-    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
         state->mouseDown = (action == GLFW_PRESS) && s_viewportHovered;
         if (state->mouseDown) {
@@ -16,8 +17,7 @@ static void mouseButtonCallback(GLFWwindow* window, int button, int action, int
     }
 }
 
-static void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
-    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
+static void orbitTo(InputState* state, double xpos, double ypos) {
     if (state->mouseDown && state->camera) {
         double dx = xpos - state->lastMouseX;
         double dy = ypos - state->lastMouseY;
@@ -27,18 +27,46 @@ static void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
     }
 }
 
+static void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
+    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
+    ++state->eventSerial;
+    orbitTo(state, xpos, ypos);
+}
+
 static void scrollCallback(GLFWwindow* window, double /*xoffset*/, double yoffset) {
+    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
+    ++state->eventSerial;
     if (!s_viewportHovered)
         return;
-    auto* state = static_cast<InputState*>(glfwGetWindowUserPointer(window));
     if (state->camera) {
         state->camera->zoom((float)yoffset);
     }
 }
 
+// Keys only drive ImGui, which chains to these after its own handling.
+static void keyCallback(GLFWwindow* window, int /*key*/, int /*scancode*/, int /*action*/, int /*mods*/) {
+    ++static_cast<InputState*>(glfwGetWindowUserPointer(window))->eventSerial;
+}
+
+static void charCallback(GLFWwindow* window, unsigned int /*codepoint*/) {
+    ++static_cast<InputState*>(glfwGetWindowUserPointer(window))->eventSerial;
+}
+
 void setupInputCallbacks(GLFWwindow* window, InputState* state) {
     glfwSetWindowUserPointer(window, state);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetScrollCallback(window, scrollCallback);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetCharCallback(window, charCallback);
+}
+
+void latchCameraInput(GLFWwindow* window, InputState* state) {
+    if (!state->mouseDown) {
+        return;
+    }
+    double xpos = 0.0;
+    double ypos = 0.0;
+    glfwGetCursorPos(window, &xpos, &ypos);
+    orbitTo(state, xpos, ypos);
 }
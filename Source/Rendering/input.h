@@ -3,6 +3,8 @@
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
+
 struct OrbitCamera;
 
 struct InputState {
@@ -10,6 +12,14 @@ struct InputState {
     bool mouseDown = false;
     double lastMouseX = 0.0;
     double lastMouseY = 0.0;
+    // Bumped by every input callback, so idle detection can tell whether anything
+    // happened since it last looked.
+    uint64_t eventSerial = 0;
 };
 
 void setupInputCallbacks(GLFWwindow* window, InputState* state);
+
+// Applies the cursor movement since the last poll to an orbit drag in progress. Call it
+// right before the camera matrices are built, so the frame sees the newest cursor
+// position instead of the one polled at the top of the frame.
+void latchCameraInput(GLFWwindow* window, InputState* state);
@@ -0,0 +1,23 @@
+#ifndef LIGHT_CLUSTER_CONSTANTS_H
+#define LIGHT_CLUSTER_CONSTANTS_H
+
+// Froxel grid shared by light_cull.slang, deferred_lighting.slang and
+// DeferredLightingPass. Clusters are screen tiles of LIGHT_CLUSTER_TILE_SIZE
+// pixels split into LIGHT_CLUSTER_SLICE_COUNT logarithmic view-depth slices.
+#define LIGHT_CLUSTER_TILE_SIZE 16u
+#define LIGHT_CLUSTER_SLICE_COUNT 24u
+// Lights a single cluster keeps; any beyond this are dropped.
+#define LIGHT_CLUSTER_MAX_LIGHTS 256u
+// Index list capacity per cluster on average; clusters allocate from one pool.
+#define LIGHT_CLUSTER_AVERAGE_LIGHTS 32u
+// Lights one screen tile can carry into its depth slices.
+#define LIGHT_CLUSTER_MAX_TILE_LIGHTS 1024u
+
+#ifdef __cplusplus
+#include <cstdint>
+static constexpr uint32_t kLightClusterTileSize = LIGHT_CLUSTER_TILE_SIZE;
+static constexpr uint32_t kLightClusterSliceCount = LIGHT_CLUSTER_SLICE_COUNT;
+static constexpr uint32_t kLightClusterAverageLights = LIGHT_CLUSTER_AVERAGE_LIGHTS;
+#endif
+
+#endif
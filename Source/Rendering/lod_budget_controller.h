@@ -0,0 +1,127 @@
+#pragma once
+
+#include "gpu_driven_telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Steers the cluster LOD threshold (CullUniforms::lodReferencePixels) toward a raster
+// budget, fed once per frame with the newest GpuDrivenTelemetry sample. Each LOD level
+// roughly halves a cluster's triangles and the level is log2(reference / pixelRadius),
+// so raster cost goes about as 1 / reference: the ideal reference is
+// reference * (measured / budget). The budget is either triangles per million render
+// pixels, so it follows dynamic resolution and the DLSS render size, or the main-view
+// VisibilityPass GPU time. Inside a dead band around the budget nothing changes, and
+// references are quantized to fractions of an octave, so a settled view never toggles
+// between two LOD levels.
+class LodBudgetController {
+public:
+    enum class Budget : int {
+        Triangles,
+        VisibilityTime,
+    };
+
+    struct Settings {
+        Budget budget = Budget::Triangles;
+        float trianglesPerMegapixel = 4.0e6f;
+        float targetVisibilityMs = 4.0f;
+        float minReferencePixels = 8.0f;
+        float maxReferencePixels = 512.0f;
+        float deadBand = 0.15f;        // no change within budget * (1 +- deadBand)
+        float stepsPerOctave = 8.0f;   // quantization of the reference
+        float maxOctavesPerStep = 0.5f;
+        float smoothing = 0.2f;        // EMA weight of the newest sample
+        // Frames a new reference takes to show up in completed readbacks and GPU
+        // timings; decisions wait this long after every change.
+        uint32_t responseFrames = 4u;
+    };
+
+    explicit LodBudgetController(float referencePixels = 96.0f) : m_referencePixels(referencePixels) {}
+
+    Settings& settings() { return m_settings; }
+    const Settings& settings() const { return m_settings; }
+    float referencePixels() const { return m_referencePixels; }
+    float filteredLoad() const { return m_filteredLoad; }
+    float budgetLoad() const { return m_budgetLoad; }
+
+    void reset(float referencePixels) {
+        m_referencePixels = referencePixels;
+        m_filteredLoad = 0.0f;
+        m_lastSampleFrame = UINT64_MAX;
+        m_framesSinceChange = 0u;
+    }
+
+    // Feeds the newest committed telemetry sample and the current render size. Returns
+    // true when the reference moved; a sample already seen is ignored.
+    bool update(const GpuDrivenFunnelSample& sample, int renderWidth, int renderHeight) {
+        if (sample.frame == m_lastSampleFrame) {
+            return false;
+        }
+        m_lastSampleFrame = sample.frame;
+
+        const uint64_t renderPixels =
+            uint64_t(std::max(renderWidth, 0)) * uint64_t(std::max(renderHeight, 0));
+        if (renderPixels != m_renderPixels) {
+            // The same reference selects different levels at another resolution, and
+            // samples from before the change describe the old one.
+            m_renderPixels = renderPixels;
+            m_filteredLoad = 0.0f;
+            m_framesSinceChange = 0u;
+        }
+
+        float load = 0.0f;
+        if (m_settings.budget == Budget::Triangles) {
+            load = static_cast<float>(sample.triangles);
+            m_budgetLoad = m_settings.trianglesPerMegapixel * static_cast<float>(renderPixels) * 1.0e-6f;
+        } else {
+            load = static_cast<float>(sample.rasterMs);
+            m_budgetLoad = m_settings.targetVisibilityMs;
+        }
+        if (load <= 0.0f || m_budgetLoad <= 0.0f) {
+            return false;
+        }
+
+        ++m_framesSinceChange;
+        m_filteredLoad = m_filteredLoad > 0.0f
+                             ? m_filteredLoad + (load - m_filteredLoad) * m_settings.smoothing
+                             : load;
+        if (m_framesSinceChange < m_settings.responseFrames) {
+            return false;
+        }
+
+        const float ratio = m_filteredLoad / m_budgetLoad;
+        const float deadBand = std::clamp(m_settings.deadBand, 0.0f, 0.9f);
+        if (ratio <= 1.0f + deadBand && ratio >= 1.0f - deadBand) {
+            return false;
+        }
+
+        const float maxOctaves = std::max(m_settings.maxOctavesPerStep, 0.01f);
+        const float octaves = std::clamp(std::log2(ratio), -maxOctaves, maxOctaves);
+        const float newReference = quantize(m_referencePixels * std::exp2(octaves));
+        if (std::abs(newReference - m_referencePixels) < 0.0001f) {
+            return false;
+        }
+        m_referencePixels = newReference;
+        m_filteredLoad = 0.0f;
+        m_framesSinceChange = 0u;
+        return true;
+    }
+
+private:
+    float quantize(float referencePixels) const {
+        const float steps = std::max(m_settings.stepsPerOctave, 1.0f);
+        const float clamped =
+            std::clamp(referencePixels, m_settings.minReferencePixels, m_settings.maxReferencePixels);
+        const float quantized = std::exp2(std::round(std::log2(clamped) * steps) / steps);
+        return std::clamp(quantized, m_settings.minReferencePixels, m_settings.maxReferencePixels);
+    }
+
+    Settings m_settings;
+    float m_referencePixels = 96.0f;
+    float m_filteredLoad = 0.0f;
+    float m_budgetLoad = 0.0f;
+    uint64_t m_lastSampleFrame = UINT64_MAX;
+    uint64_t m_renderPixels = 0;
+    uint32_t m_framesSinceChange = 0u;
+};
@@ -0,0 +1,20 @@
+#ifndef MESHLET_CONSTANTS_H
+#define MESHLET_CONSTANTS_H
+
+// Meshlet size caps shared by the meshlet builders and the mesh shaders.
+// rhiCapabilityShaderDefines() overrides both per device; the fallbacks here
+// must match the RhiMeshletSizeLimits defaults.
+#ifndef METALLIC_MESHLET_MAX_VERTICES
+#define METALLIC_MESHLET_MAX_VERTICES 64u
+#endif
+#ifndef METALLIC_MESHLET_MAX_TRIANGLES
+#define METALLIC_MESHLET_MAX_TRIANGLES 124u
+#endif
+
+#ifdef __cplusplus
+#include <cstdint>
+static constexpr uint32_t kMeshletDefaultMaxVertices = METALLIC_MESHLET_MAX_VERTICES;
+static constexpr uint32_t kMeshletDefaultMaxTriangles = METALLIC_MESHLET_MAX_TRIANGLES;
+#endif
+
+#endif
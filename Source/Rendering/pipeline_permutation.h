@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Preprocessor defines that bake a pass's uniform switches into a compute kernel.
+using PipelineDefines = std::vector<std::pair<std::string, std::string>>;
+
+// Name a permutation is published under in PipelineRuntimeContext::computePipelinesRhi:
+// "<baseKey>#NAME=value,NAME=value". Defines are taken in the order given, so a
+// pass must always list them the same way.
+inline std::string computePermutationKey(const std::string& baseKey, const PipelineDefines& defines) {
+    std::string key = baseKey;
+    key += '#';
+    for (const auto& [name, value] : defines) {
+        key += name;
+        key += '=';
+        key += value;
+        key += ',';
+    }
+    return key;
+}
+
+// MeshletCullPass's specializable switches (meshlet_cull.slang), in the order its
+// permutation keys list them.
+inline constexpr const char* kMeshletCullPermutationDefines[] = {
+    "METALLIC_CULL_FRUSTUM",
+    "METALLIC_CULL_CONE",
+    "METALLIC_CULL_OCCLUSION",
+    "METALLIC_CULL_CLUSTER_LOD",
+    "METALLIC_CULL_RESIDENCY_STREAMING",
+};
+inline constexpr uint32_t kMeshletCullPermutationCount = 1u << std::size(kMeshletCullPermutationDefines);
+
+// Defines for one cull permutation: bit i of enabledMask turns
+// kMeshletCullPermutationDefines[i] on.
+inline PipelineDefines meshletCullPermutationDefines(uint32_t enabledMask) {
+    PipelineDefines defines;
+    defines.reserve(std::size(kMeshletCullPermutationDefines));
+    for (uint32_t i = 0; i < std::size(kMeshletCullPermutationDefines); ++i) {
+        defines.emplace_back(kMeshletCullPermutationDefines[i], (enabledMask >> i) & 1u ? "1" : "0");
+    }
+    return defines;
+}
+
+// Permutations passes asked for that ShaderManager has not built yet. Passes may
+// record on several threads, so requests go through a lock; ShaderManager drains
+// them between frames.
+class ComputePermutationRequests {
+public:
+    struct Request {
+        std::string key;
+        std::string baseKey;
+        PipelineDefines defines;
+    };
+
+    void request(const std::string& key, const std::string& baseKey, const PipelineDefines& defines) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending.count(key) == 0) {
+            m_pending.emplace(key, Request{key, baseKey, defines});
+        }
+    }
+
+    std::vector<Request> take() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<Request> requests;
+        requests.reserve(m_pending.size());
+        for (auto& [key, request] : m_pending) {
+            requests.push_back(std::move(request));
+        }
+        m_pending.clear();
+        return requests;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Request> m_pending;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "frame_context.h"
+#include "pass_registry.h"
+#include "render_uniforms.h"
+#include "rhi_backend.h"
+
+#include "imgui.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// PostPyramidPass builds this many levels; post_pyramid.slang binds one image per level.
+static constexpr uint32_t kPostPyramidLevels = 7;
+static constexpr uint32_t kPostPyramidTileSize = 64;
+
+// Mip 0 is half the source, rounded up to whole 64x64 tiles so every level halves
+// exactly and the single dispatch never crosses tiles.
+inline uint32_t postPyramidDimension(uint32_t sourceDimension) {
+    const uint32_t half = (std::max(sourceDimension, 1u) + 1u) / 2u;
+    return (half + kPostPyramidTileSize - 1u) / kPostPyramidTileSize * kPostPyramidTileSize;
+}
+
+inline RhiTextureDesc makePostPyramidTextureDesc(uint32_t sourceWidth, uint32_t sourceHeight) {
+    RhiTextureDesc desc = RhiTextureDesc::storageTexture(
+        postPyramidDimension(sourceWidth), postPyramidDimension(sourceHeight), RhiFormat::RGBA16Float);
+    desc.mipLevels = kPostPyramidLevels;
+    return desc;
+}
+
+// Bloom and depth-of-field settings of a pass that combines the pyramid into its
+// tonemap (TonemapPass, FusedPostPass).
+struct PostLensSettings {
+    float bloomIntensity = 0.04f;
+    bool depthOfField = false;
+    float focusDistance = 10.0f;
+    float focusRange = 20.0f;
+    float maxCocPixels = 16.0f;
+
+    void configure(const nlohmann::json& config) {
+        if (config.contains("bloomIntensity")) bloomIntensity = config["bloomIntensity"].get<float>();
+        if (config.contains("depthOfField")) depthOfField = config["depthOfField"].get<bool>();
+        if (config.contains("focusDistance")) focusDistance = config["focusDistance"].get<float>();
+        if (config.contains("focusRange")) focusRange = config["focusRange"].get<float>();
+        if (config.contains("maxCocPixels")) maxCocPixels = config["maxCocPixels"].get<float>();
+    }
+
+    // Leaves the uniforms disabled (zeroed) without a pyramid; depth of field also
+    // needs the depth texture.
+    PostLensUniforms uniforms(const FrameContext& frame,
+                              const RhiTexture* pyramid,
+                              uint32_t sourceWidth,
+                              uint32_t sourceHeight,
+                              bool hasDepth) const {
+        PostLensUniforms lens{};
+        if (!pyramid || pyramid->width() == 0 || pyramid->height() == 0) {
+            return lens;
+        }
+        const float pyramidWidth = static_cast<float>(pyramid->width());
+        const float pyramidHeight = static_cast<float>(pyramid->height());
+        lens.pyramidUvScale = float2(static_cast<float>(sourceWidth) * 0.5f / pyramidWidth,
+                                     static_cast<float>(sourceHeight) * 0.5f / pyramidHeight);
+        lens.pyramidInvSize = float2(1.0f / pyramidWidth, 1.0f / pyramidHeight);
+        lens.pyramidLevels = std::min(pyramid->mipLevelCount(), kPostPyramidLevels);
+        lens.bloomIntensity = std::clamp(bloomIntensity, 0.0f, 1.0f);
+        if (depthOfField && hasDepth && maxCocPixels > 0.0f) {
+            const eStyle style = ML_OGL ? STYLE_OGL : STYLE_D3D;
+            float unproject[2] = {};
+            DecomposeProjection(style, style, frame.unjitteredProj, nullptr, nullptr, unproject, nullptr,
+                                nullptr, nullptr);
+            lens.depthUnproject = float2(unproject[0], unproject[1]);
+            lens.focusDistance = focusDistance;
+            lens.focusRange = focusRange;
+            lens.maxCocPixels = maxCocPixels;
+        }
+        return lens;
+    }
+
+    void renderUI(bool hasPyramid, bool hasDepth) {
+        if (!hasPyramid) {
+            ImGui::TextDisabled("Bloom / DoF: no post pyramid wired");
+            return;
+        }
+        ImGui::SliderFloat("Bloom Intensity", &bloomIntensity, 0.0f, 0.3f, "%.3f");
+        ImGui::BeginDisabled(!hasDepth);
+        ImGui::Checkbox("Depth of Field", &depthOfField);
+        ImGui::BeginDisabled(!depthOfField);
+        ImGui::DragFloat("Focus Distance", &focusDistance, 0.1f, 0.01f, 10000.0f, "%.2f");
+        ImGui::DragFloat("Focus Range", &focusRange, 0.1f, 0.01f, 10000.0f, "%.2f");
+        ImGui::SliderFloat("Max CoC (px)", &maxCocPixels, 1.0f, 64.0f, "%.1f");
+        ImGui::EndDisabled();
+        ImGui::EndDisabled();
+    }
+};
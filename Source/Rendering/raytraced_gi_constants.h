@@ -0,0 +1,24 @@
+#ifndef RAYTRACED_GI_CONSTANTS_H
+#define RAYTRACED_GI_CONSTANTS_H
+
+// Shared by raytraced_shadows.cpp, RaytracedGiPass and raytraced_gi.slang.
+// A TLAS instance's ID is its mesh's first primitive group. The top bit marks
+// instances whose BLAS is the full-resolution mesh, the only cut whose
+// PrimitiveIndex() addresses the mesh index buffer.
+#define RT_INSTANCE_FULL_DETAIL_BIT 0x800000u
+#define RT_INSTANCE_FIRST_GROUP_MASK 0x7FFFFFu
+// Hit groups and miss shaders in the order the pipeline lists their entries.
+#define RT_GI_HIT_GROUP_UNTEXTURED 0u
+#define RT_GI_HIT_GROUP_TEXTURED 1u
+#define RT_GI_MISS_SKY 0u
+#define RT_GI_MISS_SHADOW 1u
+
+#ifdef __cplusplus
+#include <cstdint>
+static constexpr uint32_t kRtInstanceFullDetailBit = RT_INSTANCE_FULL_DETAIL_BIT;
+static constexpr uint32_t kRtInstanceFirstGroupMask = RT_INSTANCE_FIRST_GROUP_MASK;
+static constexpr uint32_t kRtGiHitGroupUntextured = RT_GI_HIT_GROUP_UNTEXTURED;
+static constexpr uint32_t kRtGiHitGroupTextured = RT_GI_HIT_GROUP_TEXTURED;
+#endif
+
+#endif
@@ -1,5 +1,9 @@
 #include "raytraced_shadows.h"
+#include "cluster_lod_builder.h"
+#include "cluster_streaming_service.h"
+#include "material_loader.h"
 #include "mesh_loader.h"
+#include "raytraced_gi_constants.h"
 #include "rhi_raytracing_utils.h"
 #include "rhi_resource_utils.h"
 #include "rhi_shader_utils.h"
@@ -8,14 +12,28 @@
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <spdlog/spdlog.h>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace {
 
-RhiRayTracingInstanceDesc makeInstanceDesc(const float4x4& transform, uint32_t blasIndex) {
+// Triangles of missing LOD cuts built per frame; at least one cut always builds.
+constexpr uint64_t kLodBuildTriangleBudgetPerFrame = 1u << 18;
+// Inactive cuts are kept this many frames so an LOD flip does not rebuild them.
+constexpr uint32_t kLodRetainFrames = 240u;
+
+// Geometry g of a mesh's BLAS is its primitive group firstGroup + g (LOD cuts keep
+// one geometry per group), so the first group indexes both the hit records and
+// the geometry table raytraced_gi.slang reads.
+RhiRayTracingInstanceDesc makeInstanceDesc(const float4x4& transform,
+                                           uint32_t blasIndex,
+                                           uint32_t firstPrimitiveGroup,
+                                           bool fullDetail,
+                                           bool visible) {
     RhiRayTracingInstanceDesc instance{};
     instance.transform[0] = transform[0].x;
     instance.transform[1] = transform[0].y;
@@ -30,11 +48,31 @@ RhiRayTracingInstanceDesc makeInstanceDesc(const float4x4& transform, uint32_t b
     instance.transform[10] = transform[3].y;
     instance.transform[11] = transform[3].z;
     instance.accelerationStructureIndex = blasIndex;
-    instance.mask = 0xFF;
+    instance.mask = visible ? 0xFFu : 0u;
     instance.opaque = true;
+    instance.instanceId = (firstPrimitiveGroup & kRtInstanceFirstGroupMask) |
+                          (fullDetail ? kRtInstanceFullDetailBit : 0u);
+    instance.hitGroupOffset = firstPrimitiveGroup;
     return instance;
 }
 
+bool sameInstanceDesc(const RhiRayTracingInstanceDesc& a, const RhiRayTracingInstanceDesc& b) {
+    return std::equal(std::begin(a.transform), std::end(a.transform), std::begin(b.transform)) &&
+           a.accelerationStructureIndex == b.accelerationStructureIndex &&
+           a.mask == b.mask &&
+           a.opaque == b.opaque &&
+           a.instanceId == b.instanceId &&
+           a.hitGroupOffset == b.hitGroupOffset;
+}
+
+// Whether the mesh's BLAS is currently the full-resolution mesh.
+bool meshBlasFullDetail(const RaytracedShadowResources& res, int meshIndex) {
+    return !res.lod.enabled() ||
+           meshIndex < 0 ||
+           static_cast<size_t>(meshIndex) >= res.lod.meshes.size() ||
+           res.lod.meshes[meshIndex].activeDepth == 0;
+}
+
 std::string loadTextFile(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -55,68 +93,559 @@ std::string loadBinaryBlob(const std::vector<uint32_t>& words) {
                        words.size() * sizeof(uint32_t));
 }
 
+void trackQueueResidency(RaytracedShadowResources& res, const void* handle, bool resident) {
+    if (!res.residentOnQueue() || !handle) {
+        return;
+    }
+    if (resident) {
+        if (rhiAddQueueResidency(res.residencyQueue, &handle, 1)) {
+            res.residentHandles.push_back(handle);
+        }
+        return;
+    }
+    auto it = std::find(res.residentHandles.begin(), res.residentHandles.end(), handle);
+    if (it != res.residentHandles.end()) {
+        rhiRemoveQueueResidency(res.residencyQueue, &handle, 1);
+        res.residentHandles.erase(it);
+    }
+}
+
+// Group meshlet indices may live only in the cluster LOD cache file.
+bool loadGroupMeshletIndices(const ClusterLODData& clusterLod, std::vector<uint32_t>& out) {
+    if (!clusterLod.groupMeshletIndices.empty()) {
+        out = clusterLod.groupMeshletIndices;
+        return true;
+    }
+    if (clusterLod.groupPageFilePath.empty()) {
+        return false;
+    }
+    std::ifstream file(clusterLod.groupPageFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    out.resize(clusterLod.groupMeshletIndexCount);
+    file.seekg(static_cast<std::streamoff>(clusterLod.groupPageFileOffset));
+    file.read(reinterpret_cast<char*>(out.data()),
+              static_cast<std::streamsize>(out.size() * sizeof(uint32_t)));
+    return file.good();
+}
+
+bool initLodCache(const LoadedMesh& mesh, const ClusterLODData& clusterLod, RaytracedLodCache& cache) {
+    cache = RaytracedLodCache{};
+    std::vector<uint32_t> groupMeshletIndices;
+    if (clusterLod.levels.empty() || clusterLod.allMeshlets.empty() ||
+        !loadGroupMeshletIndices(clusterLod, groupMeshletIndices)) {
+        return false;
+    }
+    cache.geometry = loadClusterLODGeometry(clusterLod);
+    if (!cache.geometry) {
+        return false;
+    }
+
+    cache.primitiveGroupLevels.resize(mesh.primitiveGroups.size());
+    for (uint32_t levelIndex = 0; levelIndex < clusterLod.levels.size(); ++levelIndex) {
+        const ClusterLODLevel& level = clusterLod.levels[levelIndex];
+        if (level.primitiveGroupIndex >= cache.primitiveGroupLevels.size()) {
+            continue;
+        }
+        auto& levels = cache.primitiveGroupLevels[level.primitiveGroupIndex];
+        if (levels.size() <= level.depth) {
+            levels.resize(level.depth + 1u, UINT32_MAX);
+        }
+        levels[level.depth] = levelIndex;
+    }
+    // Groups sharing an identical group's hierarchy have no levels of their own.
+    std::unordered_map<uint32_t, uint32_t> groupByRoot;
+    for (uint32_t groupIndex = 0; groupIndex < cache.primitiveGroupLevels.size(); ++groupIndex) {
+        if (!cache.primitiveGroupLevels[groupIndex].empty() && groupIndex < clusterLod.primitiveGroupLodRoots.size()) {
+            groupByRoot.emplace(clusterLod.primitiveGroupLodRoots[groupIndex], groupIndex);
+        }
+    }
+    for (uint32_t groupIndex = 0; groupIndex < cache.primitiveGroupLevels.size(); ++groupIndex) {
+        if (!cache.primitiveGroupLevels[groupIndex].empty() || groupIndex >= clusterLod.primitiveGroupLodRoots.size()) {
+            continue;
+        }
+        const auto source = groupByRoot.find(clusterLod.primitiveGroupLodRoots[groupIndex]);
+        if (source != groupByRoot.end()) {
+            cache.primitiveGroupLevels[groupIndex] = cache.primitiveGroupLevels[source->second];
+        }
+    }
+    for (const auto& levels : cache.primitiveGroupLevels) {
+        if (std::find(levels.begin(), levels.end(), UINT32_MAX) != levels.end()) {
+            return false;
+        }
+    }
+
+    cache.meshletTerminal.assign(clusterLod.allMeshlets.size(), 0u);
+    for (const GPUClusterGroup& group : clusterLod.groups) {
+        if (group.parentError != FLT_MAX) {
+            continue;
+        }
+        for (uint32_t i = 0; i < group.clusterCount; ++i) {
+            const uint32_t slot = group.clusterStart + i;
+            if (slot < groupMeshletIndices.size() && groupMeshletIndices[slot] < cache.meshletTerminal.size()) {
+                cache.meshletTerminal[groupMeshletIndices[slot]] = 1u;
+            }
+        }
+    }
+
+    cache.meshes.resize(mesh.meshRanges.size());
+    for (size_t meshIndex = 0; meshIndex < mesh.meshRanges.size(); ++meshIndex) {
+        const auto& range = mesh.meshRanges[meshIndex];
+        size_t depthCount = 1;
+        for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
+            depthCount = std::max(depthCount, cache.primitiveGroupLevels[range.firstGroup + groupIndex].size());
+        }
+        cache.meshes[meshIndex].blas.resize(depthCount);
+        cache.meshes[meshIndex].lastUsedFrame.resize(depthCount, 0u);
+        cache.meshes[meshIndex].activeDepth = static_cast<uint32_t>(depthCount - 1u);
+    }
+    return true;
+}
+
+uint64_t meshCutTriangleCount(const LoadedMesh& mesh,
+                              const ClusterLODData& clusterLod,
+                              const RaytracedLodCache& cache,
+                              size_t meshIndex,
+                              uint32_t depth) {
+    const auto& range = mesh.meshRanges[meshIndex];
+    uint64_t triangles = 0;
+    for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
+        const uint32_t primitiveGroup = range.firstGroup + groupIndex;
+        const auto& levels = cache.primitiveGroupLevels[primitiveGroup];
+        if (depth == 0 || levels.empty()) {
+            triangles += mesh.primitiveGroups[primitiveGroup].indexCount / 3u;
+            continue;
+        }
+        const uint32_t cutDepth = std::min<uint32_t>(depth, static_cast<uint32_t>(levels.size() - 1u));
+        for (uint32_t d = 0; d <= cutDepth; ++d) {
+            const ClusterLODLevel& level = clusterLod.levels[levels[d]];
+            for (uint32_t m = level.meshletStart; m < level.meshletStart + level.meshletCount; ++m) {
+                if (d == cutDepth || cache.meshletTerminal[m]) {
+                    triangles += clusterLod.allMeshlets[m].triangle_count;
+                }
+            }
+        }
+    }
+    return triangles;
+}
+
+// Geometry of one mesh's BLAS at a cut depth. Depth 0 reuses the mesh index
+// buffer and needs no cluster LOD data; deeper cuts expand their clusters into
+// out.cutIndexBuffer, which has to outlive the build. No ranges means nothing to build.
+bool prepareMeshCut(const RhiDevice& device,
+                    const LoadedMesh& mesh,
+                    const ClusterLODData* clusterLodData,
+                    const RaytracedLodCache& cache,
+                    size_t meshIndex,
+                    uint32_t depth,
+                    RaytracedBlasBuild& out) {
+    const auto& range = mesh.meshRanges[meshIndex];
+    std::vector<RhiRayTracingGeometryRange>& geometryRanges = out.geometryRanges;
+    out.meshIndex = static_cast<uint32_t>(meshIndex);
+    geometryRanges.clear();
+    geometryRanges.reserve(range.groupCount);
+    if (depth == 0) {
+        for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
+            const auto& group = mesh.primitiveGroups[range.firstGroup + groupIndex];
+            geometryRanges.push_back({group.indexOffset, group.indexCount});
+        }
+        return true;
+    }
+    if (!clusterLodData || !cache.geometry) {
+        return false;
+    }
+
+    const ClusterLODData& clusterLod = *clusterLodData;
+    const ClusterLODGeometry& geometry = *cache.geometry;
+    std::vector<uint32_t> indices;
+    for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
+        const uint32_t primitiveGroup = range.firstGroup + groupIndex;
+        const auto& group = mesh.primitiveGroups[primitiveGroup];
+        const auto& levels = cache.primitiveGroupLevels[primitiveGroup];
+
+        const uint32_t indexOffset = static_cast<uint32_t>(indices.size());
+        if (levels.empty()) {
+            if (group.indexOffset + group.indexCount > mesh.cpuIndices.size()) {
+                continue;
+            }
+            indices.insert(indices.end(),
+                           mesh.cpuIndices.begin() + group.indexOffset,
+                           mesh.cpuIndices.begin() + group.indexOffset + group.indexCount);
+        } else {
+            const uint32_t cutDepth = std::min<uint32_t>(depth, static_cast<uint32_t>(levels.size() - 1u));
+            for (uint32_t d = 0; d <= cutDepth; ++d) {
+                const ClusterLODLevel& level = clusterLod.levels[levels[d]];
+                for (uint32_t m = level.meshletStart; m < level.meshletStart + level.meshletCount; ++m) {
+                    if (d != cutDepth && !cache.meshletTerminal[m]) {
+                        continue;
+                    }
+                    const GPUMeshlet& meshlet = clusterLod.allMeshlets[m];
+                    for (uint32_t t = 0; t < meshlet.triangle_count; ++t) {
+                        const uint32_t packed = geometry.packedTriangles[meshlet.triangle_offset + t];
+                        for (uint32_t corner = 0; corner < 3; ++corner) {
+                            const uint32_t localVertex = (packed >> (corner * 8u)) & 0xFFu;
+                            indices.push_back(geometry.meshletVertices[meshlet.vertex_offset + localVertex]);
+                        }
+                    }
+                }
+            }
+        }
+        const uint32_t indexCount = static_cast<uint32_t>(indices.size()) - indexOffset;
+        if (indexCount > 0) {
+            geometryRanges.push_back({indexOffset, indexCount});
+        }
+    }
+    if (geometryRanges.empty()) {
+        return true;
+    }
+
+    out.cutIndexBuffer = rhiCreateSharedBuffer(device,
+                                               indices.data(),
+                                               indices.size() * sizeof(uint32_t),
+                                               "RaytracedLodIndices");
+    if (!out.cutIndexBuffer.nativeHandle()) {
+        spdlog::error("Failed to allocate LOD {} indices for mesh {}", depth, meshIndex);
+        return false;
+    }
+    return true;
+}
+
+RhiBottomLevelBuildInput makeBuildInput(const LoadedMesh& mesh, const RaytracedBlasBuild& build) {
+    RhiBottomLevelBuildInput input;
+    input.positionBuffer = &mesh.positionBuffer;
+    input.positionStride = static_cast<uint32_t>(sizeof(float) * 3);
+    input.indexBuffer = build.cutIndexBuffer.nativeHandle() ? &build.cutIndexBuffer : &mesh.indexBuffer;
+    input.geometryRanges = build.geometryRanges.data();
+    input.geometryCount = static_cast<uint32_t>(build.geometryRanges.size());
+    return input;
+}
+
+// Builds one cut right away, waiting for the queue.
+bool buildMeshCut(const RhiDevice& device,
+                  const RhiCommandQueue& commandQueue,
+                  const LoadedMesh& mesh,
+                  const ClusterLODData& clusterLod,
+                  const RaytracedLodCache& cache,
+                  size_t meshIndex,
+                  uint32_t depth,
+                  RhiAccelerationStructureHandle& outBlas) {
+    RaytracedBlasBuild build;
+    if (!prepareMeshCut(device, mesh, &clusterLod, cache, meshIndex, depth, build)) {
+        return false;
+    }
+    if (build.geometryRanges.empty()) {
+        return true;
+    }
+    const RhiBottomLevelBuildInput input = makeBuildInput(mesh, build);
+    std::string errorMessage;
+    const bool built = rhiBuildBottomLevelAccelerationStructure(device,
+                                                                commandQueue,
+                                                                *input.positionBuffer,
+                                                                input.positionStride,
+                                                                *input.indexBuffer,
+                                                                input.geometryRanges,
+                                                                input.geometryCount,
+                                                                outBlas,
+                                                                errorMessage);
+    rhiReleaseHandle(build.cutIndexBuffer);
+    if (!built) {
+        spdlog::error("Failed to build LOD {} BLAS for mesh {}: {}", depth, meshIndex, errorMessage);
+    }
+    return built;
+}
+
+// Finest depth whose cluster groups are all resident for one primitive group.
+uint32_t finestResidentDepth(const ClusterLODData& clusterLod,
+                             const std::vector<uint32_t>& levels,
+                             const ClusterStreamingService& streamingService) {
+    for (uint32_t depth = 0; depth < levels.size(); ++depth) {
+        const ClusterLODLevel& level = clusterLod.levels[levels[depth]];
+        bool resident = true;
+        for (uint32_t group = level.groupStart; group < level.groupStart + level.groupCount && resident; ++group) {
+            resident = streamingService.groupResident(group);
+        }
+        if (resident) {
+            return depth;
+        }
+    }
+    return levels.empty() ? 0u : static_cast<uint32_t>(levels.size() - 1u);
+}
+
+bool buildTopLevel(const RhiDevice& device,
+                   const RhiCommandQueue& commandQueue,
+                   const LoadedMesh& mesh,
+                   const SceneGraph& sceneGraph,
+                   RaytracedShadowResources& out);
+
 } // namespace
 
 void RaytracedShadowResources::release() {
-    for (auto& blas : blasArray) {
-        rhiReleaseHandle(blas);
+    rhiCancelAccelerationStructureBuilds(pendingBuilds);
+    for (RaytracedBlasBuild& build : pendingBuildInputs) {
+        rhiReleaseHandle(build.cutIndexBuffer);
+    }
+    pendingBuildInputs.clear();
+
+    if (residentOnQueue()) {
+        rhiRemoveQueueResidency(residencyQueue, residentHandles.data(), residentHandles.size());
+    }
+    residencyQueue = RhiCommandQueueHandle();
+    residentHandles.clear();
+
+    if (lod.enabled()) {
+        for (RaytracedMeshLod& meshLod : lod.meshes) {
+            for (auto& blas : meshLod.blas) {
+                rhiReleaseHandle(blas);
+            }
+        }
+    } else {
+        for (auto& blas : blasArray) {
+            rhiReleaseHandle(blas);
+        }
     }
+    lod = RaytracedLodCache{};
     blasArray.clear();
     referencedBlas.clear();
+    instances.clear();
+    instanceNodes.clear();
+    instanceCopies.clear();
+    referencedBlasChanged = false;
 
     rhiReleaseHandle(tlas);
     rhiReleaseHandle(instanceDescriptorBuffer);
     rhiReleaseHandle(scratchBuffer);
     rhiReleaseHandle(pipeline);
     rhiReleaseHandle(library);
+    rhiReleaseHandle(giPipeline);
+    rhiReleaseHandle(giGeometryBuffer);
     instanceCount = 0;
 }
 
+bool beginAccelerationStructureBuilds(const RhiDevice& device,
+                                      const RhiCommandQueue& commandQueue,
+                                      const LoadedMesh& mesh,
+                                      const ClusterLODData* clusterLod,
+                                      RaytracedShadowResources& out) {
+    out.release();
+    if (clusterLod && !initLodCache(mesh, *clusterLod, out.lod)) {
+        spdlog::warn("Cluster LOD data unusable for ray tracing; building full-resolution BLASes");
+    }
+
+    out.blasArray.resize(mesh.meshRanges.size());
+    for (size_t meshIndex = 0; meshIndex < mesh.meshRanges.size(); ++meshIndex) {
+        if (mesh.meshRanges[meshIndex].groupCount == 0) {
+            continue;
+        }
+        const uint32_t depth = out.lod.enabled() ? out.lod.meshes[meshIndex].activeDepth : 0u;
+        RaytracedBlasBuild build;
+        if (!prepareMeshCut(device, mesh, clusterLod, out.lod, meshIndex, depth, build)) {
+            out.release();
+            return false;
+        }
+        if (build.geometryRanges.empty()) {
+            continue;
+        }
+        if (out.lod.enabled()) {
+            out.lod.activeTriangleCount += meshCutTriangleCount(mesh, *clusterLod, out.lod, meshIndex, depth);
+        }
+        out.pendingBuildInputs.push_back(std::move(build));
+    }
+    if (out.pendingBuildInputs.empty()) {
+        spdlog::error("No mesh geometry to build BLASes from");
+        out.release();
+        return false;
+    }
+
+    std::vector<RhiBottomLevelBuildInput> inputs;
+    inputs.reserve(out.pendingBuildInputs.size());
+    for (const RaytracedBlasBuild& build : out.pendingBuildInputs) {
+        inputs.push_back(makeBuildInput(mesh, build));
+    }
+    std::string errorMessage;
+    if (!rhiSubmitBottomLevelAccelerationStructureBuilds(device,
+                                                         commandQueue,
+                                                         inputs.data(),
+                                                         static_cast<uint32_t>(inputs.size()),
+                                                         out.pendingBuilds,
+                                                         errorMessage)) {
+        spdlog::error("Failed to submit BLAS builds: {}", errorMessage);
+        out.release();
+        return false;
+    }
+    return true;
+}
+
+AccelerationStructureBuildState finishAccelerationStructureBuilds(const RhiDevice& device,
+                                                                  const RhiCommandQueue& commandQueue,
+                                                                  const LoadedMesh& mesh,
+                                                                  const SceneGraph& sceneGraph,
+                                                                  RaytracedShadowResources& out,
+                                                                  bool wait) {
+    if (!out.buildsPending()) {
+        return out.tlas.nativeHandle() ? AccelerationStructureBuildState::Ready
+                                       : AccelerationStructureBuildState::Failed;
+    }
+
+    std::vector<RhiAccelerationStructureHandle> built;
+    std::string errorMessage;
+    const RhiAccelerationStructureBuildStatus status =
+        rhiPollAccelerationStructureBuilds(out.pendingBuilds, wait, built, errorMessage);
+    if (status == RhiAccelerationStructureBuildStatus::Pending) {
+        return AccelerationStructureBuildState::Pending;
+    }
+    if (status == RhiAccelerationStructureBuildStatus::Failed || built.size() != out.pendingBuildInputs.size()) {
+        spdlog::error("Failed to build BLASes: {}", errorMessage);
+        for (auto& blas : built) {
+            rhiReleaseHandle(blas);
+        }
+        out.release();
+        return AccelerationStructureBuildState::Failed;
+    }
+
+    for (size_t index = 0; index < built.size(); ++index) {
+        RaytracedBlasBuild& build = out.pendingBuildInputs[index];
+        rhiReleaseHandle(build.cutIndexBuffer);
+        out.blasArray[build.meshIndex] = built[index];
+        if (out.lod.enabled()) {
+            RaytracedMeshLod& meshLod = out.lod.meshes[build.meshIndex];
+            meshLod.blas[meshLod.activeDepth] = built[index];
+        }
+    }
+    out.pendingBuildInputs.clear();
+
+    return buildTopLevel(device, commandQueue, mesh, sceneGraph, out)
+               ? AccelerationStructureBuildState::Ready
+               : AccelerationStructureBuildState::Failed;
+}
+
 bool buildAccelerationStructures(const RhiDevice& device,
                                  const RhiCommandQueue& commandQueue,
                                  const LoadedMesh& mesh,
                                  const SceneGraph& sceneGraph,
                                  RaytracedShadowResources& out) {
-    out.release();
-    out.blasArray.resize(mesh.meshRanges.size());
+    return beginAccelerationStructureBuilds(device, commandQueue, mesh, nullptr, out) &&
+           finishAccelerationStructureBuilds(device, commandQueue, mesh, sceneGraph, out, true) ==
+               AccelerationStructureBuildState::Ready;
+}
 
-    for (size_t meshIndex = 0; meshIndex < mesh.meshRanges.size(); ++meshIndex) {
+bool buildAccelerationStructures(const RhiDevice& device,
+                                 const RhiCommandQueue& commandQueue,
+                                 const LoadedMesh& mesh,
+                                 const ClusterLODData& clusterLod,
+                                 const SceneGraph& sceneGraph,
+                                 RaytracedShadowResources& out) {
+    return beginAccelerationStructureBuilds(device, commandQueue, mesh, &clusterLod, out) &&
+           finishAccelerationStructureBuilds(device, commandQueue, mesh, sceneGraph, out, true) ==
+               AccelerationStructureBuildState::Ready;
+}
+
+void updateRaytracingLod(const RhiDevice& device,
+                         const RhiCommandQueue& commandQueue,
+                         const LoadedMesh& mesh,
+                         const ClusterLODData& clusterLod,
+                         const ClusterStreamingService* streamingService,
+                         RaytracedShadowResources& res) {
+    RaytracedLodCache& cache = res.lod;
+    if (!cache.enabled() || !res.tlas.nativeHandle() || cache.meshes.size() != mesh.meshRanges.size()) {
+        return;
+    }
+    ++cache.frameIndex;
+    // Without streaming every group is available, so the full mesh is traced.
+    const bool followResidency =
+        streamingService && streamingService->streamingEnabled() && streamingService->ready();
+
+    uint64_t builtTriangles = 0;
+    bool built = false;
+    for (size_t meshIndex = 0; meshIndex < cache.meshes.size(); ++meshIndex) {
+        RaytracedMeshLod& meshLod = cache.meshes[meshIndex];
         const auto& range = mesh.meshRanges[meshIndex];
         if (range.groupCount == 0) {
             continue;
         }
 
-        std::vector<RhiRayTracingGeometryRange> geometryRanges;
-        geometryRanges.reserve(range.groupCount);
-        for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
-            const auto& group = mesh.primitiveGroups[range.firstGroup + groupIndex];
-            geometryRanges.push_back({group.indexOffset, group.indexCount});
+        uint32_t desiredDepth = 0;
+        if (followResidency) {
+            for (uint32_t groupIndex = 0; groupIndex < range.groupCount; ++groupIndex) {
+                desiredDepth = std::max(desiredDepth,
+                                        finestResidentDepth(clusterLod,
+                                                            cache.primitiveGroupLevels[range.firstGroup + groupIndex],
+                                                            *streamingService));
+            }
+        }
+        desiredDepth = std::min(desiredDepth, static_cast<uint32_t>(meshLod.blas.size() - 1u));
+        meshLod.lastUsedFrame[meshLod.activeDepth] = cache.frameIndex;
+        if (desiredDepth == meshLod.activeDepth) {
+            continue;
         }
 
-        std::string errorMessage;
-        RhiAccelerationStructureHandle blas;
-        if (!rhiBuildBottomLevelAccelerationStructure(device,
-                                                      commandQueue,
-                                                      mesh.positionBuffer,
-                                                      static_cast<uint32_t>(sizeof(float) * 3),
-                                                      mesh.indexBuffer,
-                                                      geometryRanges.data(),
-                                                      static_cast<uint32_t>(geometryRanges.size()),
-                                                      blas,
-                                                      errorMessage)) {
-            spdlog::error("Failed to build BLAS for mesh {}: {}", meshIndex, errorMessage);
-            out.release();
-            return false;
+        RhiAccelerationStructureHandle& desired = meshLod.blas[desiredDepth];
+        if (!desired.nativeHandle()) {
+            const uint64_t triangles = meshCutTriangleCount(mesh, clusterLod, cache, meshIndex, desiredDepth);
+            if (built && builtTriangles + triangles > kLodBuildTriangleBudgetPerFrame) {
+                continue;
+            }
+            if (!buildMeshCut(device, commandQueue, mesh, clusterLod, cache, meshIndex, desiredDepth, desired) ||
+                !desired.nativeHandle()) {
+                continue;
+            }
+            trackQueueResidency(res, desired.nativeHandle(), true);
+            builtTriangles += triangles;
+            built = true;
         }
 
-        out.blasArray[meshIndex] = blas;
+        // Instances find their BLAS through referencedBlas, so swap it in place.
+        const void* previous = meshLod.blas[meshLod.activeDepth].nativeHandle();
+        for (auto& referenced : res.referencedBlas) {
+            if (referenced.nativeHandle() == previous) {
+                referenced = desired;
+                res.referencedBlasChanged = true;
+            }
+        }
+        cache.activeTriangleCount -= meshCutTriangleCount(mesh, clusterLod, cache, meshIndex, meshLod.activeDepth);
+        cache.activeTriangleCount += meshCutTriangleCount(mesh, clusterLod, cache, meshIndex, desiredDepth);
+        res.blasArray[meshIndex] = desired;
+        meshLod.activeDepth = desiredDepth;
+        meshLod.lastUsedFrame[desiredDepth] = cache.frameIndex;
     }
 
-    std::vector<RhiRayTracingInstanceDesc> instances;
+    // A build left the queue idle, so no submitted frame still traces a stale cut.
+    if (!built) {
+        return;
+    }
+    for (RaytracedMeshLod& meshLod : cache.meshes) {
+        for (uint32_t depth = 0; depth < meshLod.blas.size(); ++depth) {
+            if (depth == meshLod.activeDepth || !meshLod.blas[depth].nativeHandle() ||
+                cache.frameIndex - meshLod.lastUsedFrame[depth] < kLodRetainFrames) {
+                continue;
+            }
+            trackQueueResidency(res, meshLod.blas[depth].nativeHandle(), false);
+            rhiReleaseHandle(meshLod.blas[depth]);
+        }
+    }
+}
+
+namespace {
+
+bool buildTopLevel(const RhiDevice& device,
+                   const RhiCommandQueue& commandQueue,
+                   const LoadedMesh& mesh,
+                   const SceneGraph& sceneGraph,
+                   RaytracedShadowResources& out) {
+    std::vector<RhiRayTracingInstanceDesc>& instances = out.instances;
+    instances.clear();
+    out.instanceNodes.clear();
+    out.instanceCopies.clear();
     out.referencedBlas.clear();
 
+    // Hidden nodes get an instance too, masked off until they are shown.
     for (const auto& node : sceneGraph.nodes) {
-        if (node.meshIndex < 0 || !sceneGraph.isNodeVisible(node.id)) {
+        if (node.meshIndex < 0) {
+            continue;
+        }
+        // An instanced node's BLAS covers its whole mesh, so its primitive
+        // children add nothing.
+        if (node.generatedPrimitive && sceneGraph.meshInstancesFor(node.id)) {
             continue;
         }
 
@@ -138,7 +667,20 @@ bool buildAccelerationStructures(const RhiDevice& device,
             out.referencedBlas.push_back(out.blasArray[meshIndex]);
         }
 
-        instances.push_back(makeInstanceDesc(node.transform.worldMatrix, blasIndex));
+        const MeshInstanceSet* instanceSet =
+            node.instanceSet >= 0 ? &sceneGraph.instanceSets[node.instanceSet] : nullptr;
+        const uint32_t copyCount = instanceSet ? static_cast<uint32_t>(instanceSet->localMatrices.size()) : 1u;
+        for (uint32_t copy = 0; copy < copyCount; ++copy) {
+            instances.push_back(makeInstanceDesc(instanceSet
+                                                     ? node.transform.worldMatrix * instanceSet->localMatrices[copy]
+                                                     : node.transform.worldMatrix,
+                                                 blasIndex,
+                                                 mesh.meshRanges[meshIndex].firstGroup,
+                                                 meshBlasFullDetail(out, node.meshIndex),
+                                                 sceneGraph.isNodeVisible(node.id)));
+            out.instanceNodes.push_back(node.id);
+            out.instanceCopies.push_back(instanceSet ? copy : UINT32_MAX);
+        }
     }
 
     if (instances.empty()) {
@@ -169,54 +711,88 @@ bool buildAccelerationStructures(const RhiDevice& device,
         return false;
     }
 
-    spdlog::info("Built TLAS with {} instances, {} unique BLAS",
-                 instances.size(),
-                 out.referencedBlas.size());
+    out.residentHandles.push_back(out.tlas.nativeHandle());
+    if (out.lod.enabled()) {
+        for (const RaytracedMeshLod& meshLod : out.lod.meshes) {
+            for (const auto& blas : meshLod.blas) {
+                if (blas.nativeHandle()) {
+                    out.residentHandles.push_back(blas.nativeHandle());
+                }
+            }
+        }
+    } else {
+        for (const auto& blas : out.referencedBlas) {
+            out.residentHandles.push_back(blas.nativeHandle());
+        }
+    }
+    out.residentHandles.push_back(mesh.positionBuffer.nativeHandle());
+    out.residentHandles.push_back(mesh.indexBuffer.nativeHandle());
+    if (rhiAddQueueResidency(commandQueue, out.residentHandles.data(), out.residentHandles.size())) {
+        out.residencyQueue = RhiCommandQueueHandle(commandQueue.nativeHandle());
+    } else {
+        out.residentHandles.clear();
+    }
+
+    if (out.lod.enabled()) {
+        spdlog::info("Built TLAS with {} instances, {} unique LOD BLAS ({} triangles)",
+                     instances.size(),
+                     out.referencedBlas.size(),
+                     out.lod.activeTriangleCount);
+    } else {
+        spdlog::info("Built TLAS with {} instances, {} unique BLAS",
+                     instances.size(),
+                     out.referencedBlas.size());
+    }
     return true;
 }
 
+} // namespace
+
 void updateTLAS(const RhiNativeCommandBuffer& commandBuffer,
                 const SceneGraph& sceneGraph,
                 RaytracedShadowResources& res) {
     if (!res.tlas.nativeHandle() ||
         !res.instanceDescriptorBuffer.nativeHandle() ||
         !res.scratchBuffer.nativeHandle() ||
-        res.instanceCount == 0) {
+        res.instanceCount == 0 ||
+        res.instances.size() != res.instanceCount) {
         return;
     }
 
-    std::vector<RhiRayTracingInstanceDesc> instances;
-    instances.reserve(res.instanceCount);
-
-    for (const auto& node : sceneGraph.nodes) {
-        if (node.meshIndex < 0 || !sceneGraph.isNodeVisible(node.id)) {
+    uint32_t firstDirty = UINT32_MAX;
+    uint32_t lastDirty = 0;
+    for (uint32_t index = 0; index < res.instanceCount; ++index) {
+        const uint32_t nodeId = res.instanceNodes[index];
+        if (nodeId >= sceneGraph.nodes.size()) {
             continue;
         }
-
-        const uint32_t meshIndex = static_cast<uint32_t>(node.meshIndex);
-        if (meshIndex >= res.blasArray.size() || !res.blasArray[meshIndex].nativeHandle()) {
+        RhiRayTracingInstanceDesc& instance = res.instances[index];
+        const auto& node = sceneGraph.nodes[nodeId];
+        const uint32_t copy = res.instanceCopies[index];
+        const float4x4 worldMatrix = copy != UINT32_MAX
+            ? node.transform.worldMatrix * sceneGraph.instanceSets[node.instanceSet].localMatrices[copy]
+            : node.transform.worldMatrix;
+        const RhiRayTracingInstanceDesc current =
+            makeInstanceDesc(worldMatrix,
+                             instance.accelerationStructureIndex,
+                             instance.hitGroupOffset,
+                             meshBlasFullDetail(res, node.meshIndex),
+                             sceneGraph.isNodeVisible(nodeId));
+        if (sameInstanceDesc(current, instance)) {
             continue;
         }
-
-        uint32_t blasIndex = UINT32_MAX;
-        for (uint32_t index = 0; index < res.referencedBlas.size(); ++index) {
-            if (res.referencedBlas[index].nativeHandle() == res.blasArray[meshIndex].nativeHandle()) {
-                blasIndex = index;
-                break;
-            }
-        }
-
-        if (blasIndex == UINT32_MAX) {
-            continue;
-        }
-
-        instances.push_back(makeInstanceDesc(node.transform.worldMatrix, blasIndex));
-        if (instances.size() >= res.instanceCount) {
-            break;
-        }
+        instance = current;
+        firstDirty = std::min(firstDirty, index);
+        lastDirty = index;
     }
 
-    if (instances.empty()) {
+    // Replaced BLASes change the address every instance of them holds, so
+    // everything is rewritten and the TLAS rebuilt around the new bounds.
+    const bool rebuild = res.referencedBlasChanged;
+    if (rebuild) {
+        firstDirty = 0;
+        lastDirty = res.instanceCount - 1;
+    } else if (firstDirty == UINT32_MAX) {
         return;
     }
 
@@ -229,16 +805,19 @@ void updateTLAS(const RhiNativeCommandBuffer& commandBuffer,
     if (!rhiUpdateTopLevelAccelerationStructure(commandBuffer,
                                                 referencedBlasViews.data(),
                                                 static_cast<uint32_t>(referencedBlasViews.size()),
-                                                instances.data(),
-                                                static_cast<uint32_t>(instances.size()),
+                                                res.instances.data(),
+                                                res.instanceCount,
+                                                firstDirty,
+                                                lastDirty - firstDirty + 1,
+                                                rebuild,
                                                 res.tlas,
                                                 res.instanceDescriptorBuffer,
                                                 res.scratchBuffer,
                                                 errorMessage)) {
         spdlog::error("Failed to update TLAS: {}", errorMessage);
-    } else if (instances.size() < res.instanceCount) {
-        spdlog::debug("TLAS updated with {} / {} instances", instances.size(), res.instanceCount);
+        return;
     }
+    res.referencedBlasChanged = false;
 }
 
 bool createShadowPipeline(const RhiDevice& device,
@@ -398,3 +977,82 @@ bool reloadShadowPipeline(const RhiDevice& device,
     return true;
 #endif
 }
+
+bool createGiPipeline(const RhiDevice& device,
+                      const LoadedMesh& mesh,
+                      const LoadedMaterials& materials,
+                      RaytracedShadowResources& out,
+                      const char* shaderBasePath) {
+#ifdef _WIN32
+    if (mesh.primitiveGroups.empty()) {
+        return false;
+    }
+
+    RhiRayTracingPipelineSourceDesc pipelineDesc;
+    pipelineDesc.rayGenEntry = "rayGenMain";
+    pipelineDesc.missEntries = {"skyMissMain", "shadowMissMain"};
+    pipelineDesc.closestHitEntries = {"untexturedHitMain", "texturedHitMain"};
+    // The hit shaders trace the sun's shadow ray.
+    pipelineDesc.maxRecursionDepth = 2;
+    pipelineDesc.hitRecordGroups.reserve(mesh.primitiveGroups.size());
+    std::vector<uint32_t> geometryTable;
+    geometryTable.reserve(mesh.primitiveGroups.size() * 4);
+    for (const LoadedMesh::PrimitiveGroup& group : mesh.primitiveGroups) {
+        const bool textured = group.materialIndex < materials.cpuMaterials.size() &&
+                              materials.cpuMaterials[group.materialIndex].baseColorTexIndex != INVALID_TEXTURE_INDEX;
+        pipelineDesc.hitRecordGroups.push_back(textured ? kRtGiHitGroupTextured : kRtGiHitGroupUntextured);
+        geometryTable.insert(geometryTable.end(), {group.indexOffset, group.materialIndex, 0u, 0u});
+    }
+
+    constexpr const char* shaderPath = "Shaders/Raytracing/raytraced_gi.slang";
+    if (shaderBasePath) {
+        spdlog::info("Compiling Vulkan RT GI shader: {}/{}", shaderBasePath, shaderPath);
+    } else {
+        spdlog::info("Compiling Vulkan RT GI shader: {}", shaderPath);
+    }
+    SlangCompileOptions options;
+    if (const RhiContext* context = device.ownerContext()) {
+        options.defines = rhiCapabilityShaderDefines(*context);
+    }
+    const std::vector<uint32_t> spirv = compileSlangRayTracingBinary(
+        RhiBackendType::Vulkan,
+        shaderPath,
+        shaderBasePath,
+        {"rayGenMain", "skyMissMain", "shadowMissMain", "untexturedHitMain", "texturedHitMain"},
+        &options);
+    if (spirv.empty()) {
+        spdlog::error("Failed to compile {}", shaderPath);
+        return false;
+    }
+
+    std::string errorMessage;
+    RhiComputePipelineHandle newPipeline = rhiCreateRayTracingPipelineFromSource(device,
+                                                                                 loadBinaryBlob(spirv),
+                                                                                 pipelineDesc,
+                                                                                 errorMessage);
+    if (!newPipeline.nativeHandle()) {
+        spdlog::error("Failed to create Vulkan RT GI pipeline: {}", errorMessage);
+        return false;
+    }
+
+    if (!out.giGeometryBuffer.nativeHandle()) {
+        out.giGeometryBuffer = rhiCreateDeviceBuffer(device,
+                                                     geometryTable.data(),
+                                                     geometryTable.size() * sizeof(uint32_t),
+                                                     "RT GI Geometry");
+    }
+    rhiReleaseHandle(out.giPipeline);
+    out.giPipeline = newPipeline;
+
+    spdlog::info("Vulkan RT GI pipeline created ({} hit records)", pipelineDesc.hitRecordGroups.size());
+    return true;
+#else
+    (void)device;
+    (void)mesh;
+    (void)materials;
+    (void)out;
+    (void)shaderBasePath;
+    spdlog::info("Ray-traced GI needs Vulkan ray tracing pipelines; RaytracedGiPass stays disabled");
+    return false;
+#endif
+}
@@ -1,33 +1,144 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "rhi_backend.h"
+#include "rhi_raytracing_utils.h"
 
 struct LoadedMesh;
+struct LoadedMaterials;
+struct ClusterLODData;
+struct ClusterLODGeometry;
+class ClusterStreamingService;
 class SceneGraph;
 
+// BLASes for one mesh at uniform cuts through its cluster LOD DAG. Depth 0 is the
+// full-resolution mesh; depth d takes every primitive group's level-d clusters
+// plus the clusters of groups that stopped simplifying above it.
+struct RaytracedMeshLod {
+    std::vector<RhiAccelerationStructureHandle> blas; // per depth, empty until built
+    std::vector<uint32_t> lastUsedFrame;              // per depth
+    uint32_t activeDepth = 0;
+};
+
+struct RaytracedLodCache {
+    std::vector<RaytracedMeshLod> meshes;
+    std::vector<std::vector<uint32_t>> primitiveGroupLevels; // ClusterLODData::levels indices by depth
+    std::vector<uint8_t> meshletTerminal; // cluster of a group that simplifies no further
+    // Cluster vertices and triangles for cuts below depth 0, read from the cluster
+    // LOD cache so SceneGpu::releaseCpuMirrors can drop the in-memory arrays.
+    std::shared_ptr<const ClusterLODGeometry> geometry;
+    uint32_t frameIndex = 0;
+    uint64_t activeTriangleCount = 0;
+    bool enabled() const { return !meshes.empty(); }
+};
+
+// One BLAS of a submitted batch: the mesh it belongs to and the inputs the GPU
+// still reads.
+struct RaytracedBlasBuild {
+    uint32_t meshIndex = 0;
+    std::vector<RhiRayTracingGeometryRange> geometryRanges;
+    RhiBufferHandle cutIndexBuffer; // LOD cuts below depth 0 only
+};
+
 struct RaytracedShadowResources {
+    // One BLAS per mesh. With the LOD cache enabled these alias the active LOD of
+    // each mesh and the cache owns them.
     std::vector<RhiAccelerationStructureHandle> blasArray;
     RhiAccelerationStructureHandle tlas;
     RhiBufferHandle instanceDescriptorBuffer;
     RhiBufferHandle scratchBuffer;
     RhiComputePipelineHandle pipeline;
     RhiShaderLibraryHandle library;
+    RaytracedLodCache lod;
+
+    // RaytracedGiPass's ray tracing pipeline, with one hit record per primitive
+    // group, and the per-group table its hit shaders read: uint4(first index,
+    // material, 0, 0). Both stay empty without ray tracing pipeline support.
+    RhiComputePipelineHandle giPipeline;
+    RhiBufferHandle giGeometryBuffer;
 
     std::vector<RhiAccelerationStructureHandle> referencedBlas;
     uint32_t instanceCount = 0;
 
+    // TLAS instances as last written and the scene node each one follows. Hidden
+    // nodes keep their slot with a zero mask so the instance count never changes
+    // and updateTLAS can always refit. Only instances that differ are rewritten.
+    std::vector<RhiRayTracingInstanceDesc> instances;
+    std::vector<uint32_t> instanceNodes;
+    // Entry of the node's MeshInstanceSet each instance places, UINT32_MAX for the node itself.
+    std::vector<uint32_t> instanceCopies;
+    // Set when a referenced BLAS was replaced; the next update rebuilds the TLAS.
+    bool referencedBlasChanged = false;
+
+    // Set when the TLAS, BLASes and geometry are in the queue's residency set;
+    // the shadow pass then skips its useResource calls.
+    RhiCommandQueueHandle residencyQueue;
+    std::vector<const void*> residentHandles;
+    bool residentOnQueue() const { return residencyQueue.nativeHandle() != nullptr; }
+
+    // BLAS builds from beginAccelerationStructureBuilds still on the GPU. The TLAS
+    // is built, and tracing may start, once finishAccelerationStructureBuilds sees
+    // them land.
+    RhiAccelerationStructureBuildBatch pendingBuilds;
+    std::vector<RaytracedBlasBuild> pendingBuildInputs;
+    bool buildsPending() const { return pendingBuilds.pending(); }
+
     void release();
 };
 
+// Submits every mesh's BLAS as one batch without waiting for it (see
+// rhiSubmitBottomLevelAccelerationStructureBuilds). With clusterLod each BLAS is
+// the coarsest cut through it, refined later by updateRaytracingLod.
+bool beginAccelerationStructureBuilds(const RhiDevice& device,
+                                      const RhiCommandQueue& commandQueue,
+                                      const LoadedMesh& mesh,
+                                      const ClusterLODData* clusterLod,
+                                      RaytracedShadowResources& out);
+
+enum class AccelerationStructureBuildState {
+    Pending,
+    Ready,
+    Failed,
+};
+
+// Collects the batch begun above and builds the TLAS over it. Without wait this
+// returns Pending while the GPU is still building; Failed leaves out released.
+AccelerationStructureBuildState finishAccelerationStructureBuilds(const RhiDevice& device,
+                                                                  const RhiCommandQueue& commandQueue,
+                                                                  const LoadedMesh& mesh,
+                                                                  const SceneGraph& sceneGraph,
+                                                                  RaytracedShadowResources& out,
+                                                                  bool wait = false);
+
+// Begin and finish in one call, waiting for the builds.
 bool buildAccelerationStructures(const RhiDevice& device,
                                  const RhiCommandQueue& commandQueue,
                                  const LoadedMesh& mesh,
                                  const SceneGraph& sceneGraph,
                                  RaytracedShadowResources& out);
 
+// Same, but each mesh's BLAS is a cut through clusterLod, starting at the coarsest
+// and refined by updateRaytracingLod, so BLAS memory follows cluster streaming.
+bool buildAccelerationStructures(const RhiDevice& device,
+                                 const RhiCommandQueue& commandQueue,
+                                 const LoadedMesh& mesh,
+                                 const ClusterLODData& clusterLod,
+                                 const SceneGraph& sceneGraph,
+                                 RaytracedShadowResources& out);
+
+// Once per frame before updateTLAS: moves each mesh to the finest cut whose cluster
+// groups are all resident, building missing cuts within a per-frame triangle budget.
+// Builds wait for the queue to idle, so cuts unused for a while are released then.
+void updateRaytracingLod(const RhiDevice& device,
+                         const RhiCommandQueue& commandQueue,
+                         const LoadedMesh& mesh,
+                         const ClusterLODData& clusterLod,
+                         const ClusterStreamingService* streamingService,
+                         RaytracedShadowResources& res);
+
 void updateTLAS(const RhiNativeCommandBuffer& commandBuffer,
                 const SceneGraph& sceneGraph,
                 RaytracedShadowResources& res);
@@ -39,3 +150,12 @@ bool createShadowPipeline(const RhiDevice& device,
 bool reloadShadowPipeline(const RhiDevice& device,
                           RaytracedShadowResources& res,
                           const char* shaderBasePath = nullptr);
+
+// Builds giPipeline for the scene in mesh. Each primitive group's hit record runs
+// the textured or untextured hit group its material needs, so the records follow
+// the materials and have to be rebuilt with the scene. Vulkan only.
+bool createGiPipeline(const RhiDevice& device,
+                      const LoadedMesh& mesh,
+                      const LoadedMaterials& materials,
+                      RaytracedShadowResources& out,
+                      const char* shaderBasePath = nullptr);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Idle mode for the editor loop. The loop reports anything that can change the image
+// (input events, playing animations, streaming traffic, reloads); once nothing has
+// changed for settleFrames rendered frames, which lets TAA and the streaming readbacks
+// converge, it stops rendering and presenting. The swapchain keeps showing the last
+// frame, and the loop sleeps in glfwWaitEventsTimeout until an event arrives or the
+// idle refresh is due, which renders one frame so the UI statistics keep moving.
+class RenderOnDemand {
+public:
+    struct Settings {
+        bool enabled = false;
+        uint32_t settleFrames = 32u;      // frames rendered after the last change
+        float idleRefreshSeconds = 1.0f;  // one frame this often while idle; 0 waits for events only
+    };
+
+    Settings& settings() { return m_settings; }
+    const Settings& settings() const { return m_settings; }
+    bool idle() const { return m_settings.enabled && m_framesSinceChange >= m_settings.settleFrames; }
+    uint64_t skippedFrames() const { return m_skippedFrames; }
+
+    void noteChange() { m_framesSinceChange = 0u; }
+
+    // Returns true when the loop should render this iteration, and counts it as
+    // rendered; false means wait for waitSeconds() and try again.
+    bool beginFrame(double nowSeconds) {
+        if (!m_settings.enabled || m_framesSinceChange < m_settings.settleFrames ||
+            (m_settings.idleRefreshSeconds > 0.0f &&
+             nowSeconds - m_lastFrameSeconds >= static_cast<double>(m_settings.idleRefreshSeconds))) {
+            m_framesSinceChange = std::min(m_framesSinceChange + 1u, m_settings.settleFrames);
+            m_lastFrameSeconds = nowSeconds;
+            return true;
+        }
+        ++m_skippedFrames;
+        return false;
+    }
+
+    // Longest sleep before the idle refresh is due; negative waits for events only.
+    double waitSeconds(double nowSeconds) const {
+        if (m_settings.idleRefreshSeconds <= 0.0f) {
+            return -1.0;
+        }
+        return std::max(0.0, m_lastFrameSeconds + m_settings.idleRefreshSeconds - nowSeconds);
+    }
+
+private:
+    Settings m_settings;
+    uint32_t m_framesSinceChange = 0u;
+    double m_lastFrameSeconds = 0.0;
+    uint64_t m_skippedFrames = 0u;
+};
@@ -2,6 +2,7 @@
 
 #include "frame_graph.h"
 #include "gpu_scene.h"
+#include "gpu_skinning.h"
 #include "mesh_loader.h"
 #include "meshlet_builder.h"
 #include "material_loader.h"
@@ -24,8 +25,10 @@ struct RenderContext {
     const SceneGraph& sceneGraph;
     const GpuSceneTables& gpuScene;
     const ClusterLODData& clusterLodData;
+    const GpuSkinningTables& skinning;
     const RaytracedShadowResources& shadowResources;
     RhiDepthStencilStateHandle depthState;
+    RhiDepthStencilStateHandle depthReadState; // depth test without writes
     RhiTextureHandle shadowDummyTex;
     RhiTextureHandle skyFallbackTex;
     double depthClearValue;
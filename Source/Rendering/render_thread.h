@@ -0,0 +1,97 @@
+#pragma once
+
+#include "cpu_profile_zones.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Records and submits one frame while the main thread simulates the next. The main
+// thread kicks the tail of frame N (graph execution, UI draw recording, submit and
+// present) and goes on with frame N+1's input and animation; it waits for frame N
+// before it touches anything the tail reads, so at most one frame is in flight here.
+// Without a thread (--serial-render) kick() runs the frame inline, like the old loop.
+class RenderThread {
+public:
+    explicit RenderThread(bool threaded) {
+        if (threaded) {
+            m_thread = std::thread([this]() { threadLoop(); });
+        }
+    }
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    ~RenderThread() {
+        if (!m_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    bool threaded() const { return m_thread.joinable(); }
+
+    // Call wait() first; a frame is never queued behind another.
+    void kick(std::function<void()> frame) {
+        if (!threaded()) {
+            frame();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frame = std::move(frame);
+            m_busy = true;
+        }
+        m_wake.notify_all();
+    }
+
+    // Returns once the last kicked frame has been submitted.
+    void wait() {
+        if (!threaded()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return !m_busy; });
+    }
+
+private:
+    void threadLoop() {
+#ifdef TRACY_ENABLE
+        tracy::SetThreadName("Render Thread");
+#endif
+        MICROPROFILE_ONTHREADCREATE("Render Thread");
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_stopping || m_busy; });
+            if (m_stopping) {
+                break;
+            }
+            std::function<void()> frame = std::move(m_frame);
+            m_frame = nullptr;
+            lock.unlock();
+            {
+                METALLIC_CPU_ZONE("Frame", "Frame::Render", METALLIC_CPU_ZONE_RECORDING);
+                frame();
+            }
+            lock.lock();
+            m_busy = false;
+            m_idle.notify_all();
+        }
+        MICROPROFILE_ONTHREADEXIT();
+    }
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::function<void()> m_frame;
+    bool m_busy = false;
+    bool m_stopping = false;
+};
@@ -24,6 +24,9 @@ struct ShadowUniforms {
     float    normalBias;
     float    maxRayDistance;
     uint32_t reversedZ;
+    uint32_t traceDownsample; // one ray per traceDownsample^2 pixels
+    uint32_t frameIndex;      // rotates the traced pixel and the cone sample
+    float    lightConeTan;    // tan of the light's angular radius; 0 traces hard shadows
 };
 
 struct LightingUniforms {
@@ -42,18 +45,48 @@ struct LightingUniforms {
     uint32_t shadowEnabled;
     uint32_t visibilityUsesWorklistIds;
     float    motionVectorIntensity;
-    uint32_t pad2;
+    uint32_t textureFeedbackEnabled;
+    uint32_t punctualLightCount;     // 0 when light clustering is off
+    uint32_t lightClusterCountX;
+    uint32_t lightClusterCountY;
+    float    lightClusterSliceScale;
+    float    lightClusterSliceBias;
+    uint32_t shadingRateMode;        // 0 full rate, 1 build rates, 2 also read last frame's
+    float    coarseLumaThreshold;    // tile luma deviation below which it shades at 2x2
+    float    coarseMotionThreshold;  // mean tile motion in pixels above which it shades at 2x2
+    uint32_t inlineShadowRays;       // 1 traces the sun ray in the lighting kernel
+    float    shadowNormalBias;
+    float4   worldLightDirMaxDistance; // xyz world direction toward the light, w ray length
+    uint32_t indirectLightingEnabled;  // 1 adds RaytracedGiPass's indirect diffuse and reflections
+    uint32_t skyAmbientEnabled;        // 1 adds AtmospherePass's sky irradiance probe instead
+    float    skyAmbientIntensity;
+    uint32_t ambientOcclusionEnabled;  // 1 darkens the sky ambient by AmbientOcclusionPass's output
 };
 
 struct AtmosphereUniforms {
     float4x4 invViewProj;
     float4   cameraWorldPos;
     float4   sunDirection;
-    float4   params; // x = exposure
+    float4   params; // x = exposure, y = depth clear value (far plane)
     uint32_t screenWidth;
     uint32_t screenHeight;
-    uint32_t pad0;
-    uint32_t pad1;
+    uint32_t useSkyView;
+    uint32_t depthTested; // 1 leaves pixels with geometry in front black
+};
+
+// AtmospherePass's push constants for every atmosphere_precompute.slang kernel.
+struct AtmosphereLutUniforms {
+    float4   groundAlbedo;        // xyz
+    float4   camera;              // sky view: xyz = km from the planet center
+    float4   sunDirection;        // sky view
+    float    rayleighScaleHeight; // km
+    float    mieScaleHeight;      // km
+    float    ozoneCenterAltitude; // km
+    float    ozoneWidth;          // km
+    float    ozoneDensity;
+    uint32_t scatteringOrder;
+    uint32_t skyViewWidth;
+    uint32_t skyViewHeight;
 };
 
 struct TonemapUniforms {
@@ -70,6 +103,25 @@ struct TonemapUniforms {
     float pad;
 };
 
+// Bloom and depth of field from PostPyramidPass, combined in post_lens.slang.
+struct PostLensUniforms {
+    float2 pyramidUvScale;      // source extent within the tile-aligned pyramid
+    float2 pyramidInvSize;      // 1 / mip 0 size
+    uint32_t pyramidLevels;     // 0 = no pyramid bound
+    float bloomIntensity;       // 0 = off
+    float2 depthUnproject;      // viewZ = x / (depth + y)
+    float focusDistance;
+    float focusRange;           // distance from the focus plane to the full blur
+    float maxCocPixels;         // 0 = depth of field off
+    float pad;
+};
+
+// Push constants of tonemap.slang.
+struct TonemapPassUniforms {
+    TonemapUniforms tonemap;
+    PostLensUniforms lens;
+};
+
 struct AutoExposureUniforms {
     float evMinValue;
     float evMaxValue;
@@ -79,6 +131,10 @@ struct AutoExposureUniforms {
     uint32_t screenHeight;
     float lowPercentile;
     float highPercentile;
+    uint32_t sampleWidth;       // histogram sample grid
+    uint32_t sampleHeight;
+    uint32_t groupCount;        // dispatched groups, for the completion counter
+    uint32_t pad;
 };
 
 struct TAAUniforms {
@@ -95,6 +151,13 @@ struct TAAUniforms {
     float2 pad;
 };
 
+// Push constants of fused_post.slang: the TAA, tonemap and lens blocks back to back.
+struct FusedPostUniforms {
+    TAAUniforms taa;
+    TonemapUniforms tonemap;
+    PostLensUniforms lens;
+};
+
 struct SceneInstanceTransform {
     float4x4 mvp;
     float4x4 modelView;
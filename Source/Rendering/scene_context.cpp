@@ -1,6 +1,8 @@
 #include "scene_context.h"
 
 #include "rhi_resource_utils.h"
+#include "scene_snapshot.h"
+#include "startup_profile.h"
 
 #include <spdlog/spdlog.h>
 #include <tracy/Tracy.hpp>
@@ -116,9 +118,13 @@ SceneContext::SceneContext(RhiDeviceHandle device, RhiCommandQueueHandle queue,
     : m_device(device), m_queue(queue), m_projectRoot(projectRoot) {}
 
 SceneContext::~SceneContext() {
+    if (m_pendingLoad.valid()) {
+        m_pendingLoad.get();
+    }
     unloadScene();
     m_atmosphereTextures.release();
     rhiReleaseHandle(m_depthState);
+    rhiReleaseHandle(m_depthReadState);
     rhiReleaseHandle(m_shadowDummyTex);
     rhiReleaseHandle(m_skyFallbackTex);
     rhiReleaseHandle(m_imguiDepthDummy);
@@ -130,6 +136,7 @@ bool SceneContext::initFallbackResources() {
     const RhiDevice& dev = m_device;
 
     m_depthState = rhiCreateDepthStencilState(dev, true, ML_DEPTH_REVERSED);
+    m_depthReadState = rhiCreateDepthStencilState(dev, false, ML_DEPTH_REVERSED);
     m_depthClearValue = ML_DEPTH_REVERSED ? 0.0 : 1.0;
 
     m_imguiDepthDummy = rhiCreateTexture2D(dev, 1, 1, RhiFormat::D32Float, false, 1,
@@ -155,30 +162,125 @@ bool SceneContext::initFallbackResources() {
     return true;
 }
 
+// Restores the parsed scene and its texture chains from the snapshot matching the
+// source files, falling back to a glTF parse. restored tells the caller whether a
+// snapshot should be written once SceneGpu has built the chains.
+static bool loadSceneSource(const RhiDevice& device, const std::string& gltfPath, const std::string& cacheDir,
+                            Scene& scene, SceneGpu& sceneGpu, bool& restored) {
+    StartupProfile::Phase phase("Scene source");
+    std::vector<TranscodedTexture> textures;
+    restored = loadSceneSnapshot(gltfPath, cacheDir, SceneGpu::usesBC7Textures(device, cacheDir), scene, textures);
+    phase.setCacheHit(restored);
+    StartupProfile::recordCache("scene snapshot", restored);
+    if (restored) {
+        sceneGpu.setPrebuiltTextures(std::move(textures));
+        return true;
+    }
+    return scene.load(gltfPath);
+}
+
+static void writeSceneSnapshot(const RhiDevice& device, const std::string& cacheDir,
+                               const Scene& scene, SceneGpu& sceneGpu) {
+    ZoneScopedN("WriteSceneSnapshot");
+    const TextureStreamingPool& pool = sceneGpu.texturePool();
+    std::vector<const TranscodedTexture*> textures(pool.textureCount());
+    for (uint32_t i = 0; i < pool.textureCount(); ++i)
+        textures[i] = &pool.source(i);
+    saveSceneSnapshot(scene, cacheDir, SceneGpu::usesBC7Textures(device, cacheDir), textures);
+}
+
 bool SceneContext::loadScene(const std::string& gltfPath) {
     ZoneScoped;
+    StartupProfile::Phase phase("SceneContext::loadScene");
 
     unloadScene();
     initFallbackResources();
 
-    if (!m_scene.load(gltfPath)) {
+    std::string cacheDir = sceneCacheDirectory();
+    m_sceneGpu = std::make_unique<SceneGpu>(m_device, m_queue);
+    m_sceneGpu->setTextureStreamingEnabled(m_textureStreamingEnabled);
+    bool restored = false;
+    if (!loadSceneSource(m_device, gltfPath, cacheDir, m_scene, *m_sceneGpu, restored)) {
         spdlog::error("Failed to load scene: {}", gltfPath);
+        m_sceneGpu.reset();
         return false;
     }
 
-    std::string cacheDir = m_projectRoot + "/Asset/MeshletCache";
-    m_sceneGpu = std::make_unique<SceneGpu>(m_device, m_queue);
     if (!m_sceneGpu->create(m_scene, cacheDir)) {
         spdlog::error("Failed to create GPU resources for scene: {}", gltfPath);
         m_sceneGpu.reset();
         m_scene.clear();
         return false;
     }
+    if (!restored)
+        writeSceneSnapshot(m_device, cacheDir, m_scene, *m_sceneGpu);
 
     spdlog::info("Scene loaded successfully: {}", gltfPath);
     return true;
 }
 
+bool SceneContext::beginLoadSceneAsync(const std::string& gltfPath) {
+    if (m_pendingLoad.valid()) {
+        spdlog::warn("Scene load already in progress: {}", m_pendingLoadPath);
+        return false;
+    }
+
+    // Fallback textures are uploaded through the device queue, so they are
+    // created here rather than on the worker.
+    initFallbackResources();
+
+    m_pendingLoadPath = gltfPath;
+    RhiDeviceHandle device = m_device;
+    RhiCommandQueueHandle queue = m_queue;
+    std::string cacheDir = sceneCacheDirectory();
+    bool textureStreaming = m_textureStreamingEnabled;
+    m_pendingLoad = std::async(std::launch::async,
+        [device, queue, gltfPath, cacheDir, textureStreaming]() -> std::unique_ptr<PendingSceneLoad> {
+            ZoneScopedN("SceneLoadWorker");
+            auto pending = std::make_unique<PendingSceneLoad>();
+            pending->sceneGpu = std::make_unique<SceneGpu>(device, queue);
+            pending->sceneGpu->setTextureStreamingEnabled(textureStreaming);
+            pending->sceneGpu->setDeferTextureUploads(true);
+            bool restored = false;
+            if (!loadSceneSource(device, gltfPath, cacheDir, pending->scene, *pending->sceneGpu, restored)) {
+                spdlog::error("Failed to load scene: {}", gltfPath);
+                return nullptr;
+            }
+
+            if (!pending->sceneGpu->create(pending->scene, cacheDir)) {
+                spdlog::error("Failed to create GPU resources for scene: {}", gltfPath);
+                return nullptr;
+            }
+            if (!restored)
+                writeSceneSnapshot(device, cacheDir, pending->scene, *pending->sceneGpu);
+            return pending;
+        });
+    spdlog::info("Loading scene in background: {}", gltfPath);
+    return true;
+}
+
+bool SceneContext::isPendingLoadReady() const {
+    return m_pendingLoad.valid() &&
+           m_pendingLoad.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool SceneContext::completePendingLoad() {
+    ZoneScoped;
+    if (!m_pendingLoad.valid()) return false;
+
+    std::unique_ptr<PendingSceneLoad> pending = m_pendingLoad.get();
+    if (!pending || !pending->sceneGpu->uploadDeferredTextures()) {
+        spdlog::error("Background scene load failed, keeping current scene: {}", m_pendingLoadPath);
+        return false;
+    }
+
+    unloadScene();
+    m_scene = std::move(pending->scene);
+    m_sceneGpu = std::move(pending->sceneGpu);
+    spdlog::info("Scene loaded successfully: {}", m_pendingLoadPath);
+    return true;
+}
+
 void SceneContext::unloadScene() {
     m_sceneGpu.reset();
     m_scene.clear();
@@ -192,9 +294,25 @@ bool SceneContext::loadAll(const char* gltfPath) {
     return loadScene(gltfPath);
 }
 
+void SceneContext::advanceAnimations(float deltaTime) {
+    if (m_sceneGpu) {
+        m_sceneGpu->advanceAnimations(deltaTime);
+    }
+}
+
+void SceneContext::releaseCpuMirrors() {
+    if (!m_sceneGpu) {
+        return;
+    }
+    const size_t freedBytes = m_sceneGpu->releaseCpuMirrors() + m_scene.releaseBulkData();
+    spdlog::info("Released {:.1f} MB of CPU-side scene data", freedBytes / (1024.0 * 1024.0));
+}
+
 void SceneContext::updateGpuScene() {
-    if (m_sceneGpu)
+    if (m_sceneGpu) {
+        m_sceneGpu->setGpuTransformPropagation(m_gpuTransformPropagation);
         m_sceneGpu->updatePerFrame();
+    }
 }
 
 RenderContext SceneContext::renderContext() const {
@@ -205,8 +323,10 @@ RenderContext SceneContext::renderContext() const {
         m_sceneGpu->sceneGraph(),
         m_sceneGpu->gpuScene(),
         m_sceneGpu->clusterLod(),
+        m_sceneGpu->skinning(),
         m_shadowResources,
         m_depthState,
+        m_depthReadState,
         m_shadowDummyTex,
         m_skyFallbackTex,
         m_depthClearValue
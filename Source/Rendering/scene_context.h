@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <memory>
 #include <string>
 
@@ -28,6 +29,18 @@ public:
     void unloadScene();
     bool isSceneLoaded() const;
 
+    // Parses the glTF and builds SceneGpu on a worker thread while the current
+    // scene keeps rendering. Returns false if another load is still running.
+    bool beginLoadSceneAsync(const std::string& gltfPath);
+    bool isSceneLoading() const { return m_pendingLoad.valid(); }
+    bool isPendingLoadReady() const;
+    const std::string& pendingLoadPath() const { return m_pendingLoadPath; }
+    // Swaps in the finished scene; the GPU must be idle. On failure the current
+    // scene stays loaded and false is returned.
+    bool completePendingLoad();
+    // Applies to the next loadScene; see SceneGpu::setTextureStreamingEnabled.
+    void setTextureStreamingEnabled(bool enabled) { m_textureStreamingEnabled = enabled; }
+
     // Legacy compat: loadAll delegates to loadScene with hardcoded Sponza path
     bool loadAll(const char* gltfPath);
 
@@ -35,9 +48,11 @@ public:
     const MeshletData& meshlets() const { return m_sceneGpu->meshlets(); }
     const ClusterLODData& clusterLod() const { return m_sceneGpu->clusterLod(); }
     const GpuSceneTables& gpuScene() const { return m_sceneGpu->gpuScene(); }
+    const GpuSkinningTables& skinning() const { return m_sceneGpu->skinning(); }
     const LoadedMaterials& materials() const { return m_sceneGpu->materials(); }
     SceneGraph& sceneGraph() { return m_sceneGpu->sceneGraph(); }
     const SceneGraph& sceneGraph() const { return m_sceneGpu->sceneGraph(); }
+    TextureStreamingPool* texturePool() { return m_sceneGpu ? &m_sceneGpu->texturePool() : nullptr; }
     const Scene& scene() const { return m_scene; }
 
     RaytracedShadowResources& shadowResources() { return m_shadowResources; }
@@ -53,11 +68,28 @@ public:
     bool atmosphereLoaded() const { return m_atmosphereLoaded; }
     const AtmosphereTextureSet& atmosphereTextures() const { return m_atmosphereTextures; }
 
+    // Kept across scene loads; see SceneGpu::setGpuTransformPropagation.
+    void setGpuTransformPropagation(bool enabled) { m_gpuTransformPropagation = enabled; }
+    void advanceAnimations(float deltaTime);
     void updateGpuScene();
+    // See SceneGpu::addMeshInstances; the GPU must be idle.
+    bool addMeshInstances(const std::vector<MeshInstanceSet>& instanceSets) {
+        return m_sceneGpu && m_sceneGpu->addMeshInstances(instanceSets);
+    }
+    // Drops the host copies of geometry and image pixels the GPU already holds
+    // (SceneGpu::releaseCpuMirrors, Scene::releaseBulkData). Call once the scene's
+    // BLAS builds have landed or will not run.
+    void releaseCpuMirrors();
     RenderContext renderContext() const;
 
 private:
+    struct PendingSceneLoad {
+        Scene scene;
+        std::unique_ptr<SceneGpu> sceneGpu;
+    };
+
     bool initFallbackResources();
+    std::string sceneCacheDirectory() const { return m_projectRoot + "/Asset/MeshletCache"; }
 
     RhiDeviceHandle m_device;
     RhiCommandQueueHandle m_queue;
@@ -73,8 +105,14 @@ private:
     bool m_atmosphereLoaded = false;
 
     RhiDepthStencilStateHandle m_depthState;
+    RhiDepthStencilStateHandle m_depthReadState;
     RhiTextureHandle m_shadowDummyTex;
     RhiTextureHandle m_skyFallbackTex;
     RhiTextureHandle m_imguiDepthDummy;
     double m_depthClearValue = 1.0;
+    bool m_textureStreamingEnabled = false;
+    bool m_gpuTransformPropagation = false;
+
+    std::future<std::unique_ptr<PendingSceneLoad>> m_pendingLoad;
+    std::string m_pendingLoadPath;
 };
@@ -1,14 +1,15 @@
 #include "scene_gpu.h"
 #include "scene.h"
 #include "rhi_resource_utils.h"
+#include "texture_transcoder.h"
+#include "parallel_for.h"
+#include "startup_profile.h"
 
 #include <spdlog/spdlog.h>
 #include <cstring>
 #include <algorithm>
 #include <filesystem>
 
-static constexpr uint32_t MAX_SCENE_TEXTURES_GPU = 96;
-
 static void releaseMeshBuffers(LoadedMesh& mesh) {
     rhiReleaseHandle(mesh.positionBuffer);
     rhiReleaseHandle(mesh.normalBuffer);
@@ -24,6 +25,14 @@ static void releaseMeshletBuffers(MeshletData& m) {
     rhiReleaseHandle(m.materialIDs);
 }
 
+template <typename T>
+static size_t releaseCpuArray(std::vector<T>& values) {
+    const size_t bytes = values.capacity() * sizeof(T);
+    values.clear();
+    values.shrink_to_fit();
+    return bytes;
+}
+
 static void releaseMaterialResources(LoadedMaterials& mat) {
     for (auto& tex : mat.textures)
         rhiReleaseHandle(tex);
@@ -32,6 +41,7 @@ static void releaseMaterialResources(LoadedMaterials& mat) {
     rhiReleaseHandle(mat.materialBuffer);
     rhiReleaseHandle(mat.sampler);
     mat.materialCount = 0;
+    mat.cpuMaterials.clear();
 }
 
 SceneGpu::SceneGpu(RhiDeviceHandle device, RhiCommandQueueHandle queue)
@@ -43,8 +53,10 @@ SceneGpu::~SceneGpu() {
 
 void SceneGpu::destroy() {
     releaseGpuSceneTables(m_gpuScene);
+    releaseGpuSkinning(m_skinning);
     releaseClusterLOD(m_clusterLod);
     releaseMeshletBuffers(m_meshlets);
+    m_texturePool.release();
     releaseMaterialResources(m_materials);
     releaseMeshBuffers(m_mesh);
 
@@ -54,17 +66,31 @@ void SceneGpu::destroy() {
     m_materials = LoadedMaterials{};
     m_sceneGraph = SceneGraph{};
     m_gpuScene = GpuSceneTables{};
+    m_skinning = GpuSkinningTables{};
     m_valid = false;
 }
 
 bool SceneGpu::create(const Scene& scene, const std::string& cacheDir) {
+    StartupProfile::Phase phase("SceneGpu::create");
     destroy();
+    RhiMemoryTagScope geometryTag(RhiMemoryTag::Geometry);
 
-    if (!createMeshBuffers(scene)) return false;
+    {
+        StartupProfile::Phase meshPhase("Mesh upload");
+        if (!createMeshBuffers(scene)) return false;
+    }
     if (!createMeshlets(scene, cacheDir)) { destroy(); return false; }
     createClusterLod(scene, cacheDir);
-    if (!createMaterials(scene)) { destroy(); return false; }
+    {
+        StartupProfile::Phase materialPhase("Materials and textures");
+        if (!createMaterials(scene, cacheDir)) { destroy(); return false; }
+    }
     if (!createSceneGraph(scene)) { destroy(); return false; }
+    {
+        StartupProfile::Phase skinningPhase("GPU skinning");
+        buildGpuSkinning(m_device, scene, m_mesh, m_meshlets, m_sceneGraph, m_skinning);
+    }
+    StartupProfile::Phase tablesPhase("GPU scene tables");
     if (!createGpuSceneTables()) {
         spdlog::warn("GPU scene tables failed, continuing without");
         releaseGpuSceneTables(m_gpuScene);
@@ -75,6 +101,16 @@ bool SceneGpu::create(const Scene& scene, const std::string& cacheDir) {
     return true;
 }
 
+bool SceneGpu::usesBC7Textures(const RhiDevice& device, const std::string& cacheDir) {
+    return !cacheDir.empty() && rhiSupportsTextureFormat(device, RhiFormat::BC7RGBAUnorm);
+}
+
+bool SceneGpu::uploadDeferredTextures() {
+    if (!m_deferTextureUploads) return true;
+    m_deferTextureUploads = false;
+    return m_texturePool.createTextures(m_device);
+}
+
 bool SceneGpu::createMeshBuffers(const Scene& scene) {
     m_mesh = LoadedMesh{};
     m_mesh.cpuPositions = scene.positions;
@@ -130,12 +166,17 @@ bool SceneGpu::createMeshBuffers(const Scene& scene) {
 
 bool SceneGpu::createMeshlets(const Scene& scene, const std::string& cacheDir) {
     const RhiDevice& dev = m_device;
+    // Build to the same caps the mesh shaders were compiled with
+    // (rhiCapabilityShaderDefines); without a context both use the defaults.
+    const RhiContext* context = dev.ownerContext();
+    const RhiMeshletSizeLimits sizeLimits = context ? rhiPreferredMeshletSizeLimits(*context)
+                                                    : RhiMeshletSizeLimits{};
     if (!cacheDir.empty()) {
         std::filesystem::create_directories(cacheDir);
-        if (loadOrBuildMeshlets(dev, m_mesh, scene.filePath(), cacheDir, m_meshlets))
+        if (loadOrBuildMeshlets(dev, m_mesh, sizeLimits, scene.filePath(), cacheDir, m_meshlets))
             return true;
     }
-    return buildMeshlets(dev, m_mesh, m_meshlets);
+    return buildMeshlets(dev, m_mesh, sizeLimits, m_meshlets);
 }
 
 bool SceneGpu::createClusterLod(const Scene& scene, const std::string& cacheDir) {
@@ -153,36 +194,44 @@ bool SceneGpu::createClusterLod(const Scene& scene, const std::string& cacheDir)
     return true;
 }
 
-bool SceneGpu::createMaterials(const Scene& scene) {
+bool SceneGpu::createMaterials(const Scene& scene, const std::string& cacheDir) {
     const RhiDevice& dev = m_device;
-    const RhiCommandQueue& queue = m_queue;
 
-    uint32_t imageCount = std::min(static_cast<uint32_t>(scene.images.size()), MAX_SCENE_TEXTURES_GPU);
+    uint32_t imageCount = std::min(static_cast<uint32_t>(scene.images.size()),
+                                   rhiMaxSceneTextureCount(dev));
     if (scene.images.size() > imageCount)
         spdlog::warn("Scene has {} images, clamping to {}", scene.images.size(), imageCount);
 
-    m_materials.textures.resize(imageCount);
-    for (uint32_t i = 0; i < imageCount; ++i) {
-        const auto& img = scene.images[i];
-        if (img.pixels.empty() || img.width <= 0 || img.height <= 0) continue;
-
-        uint32_t mipLevels = 1;
-        { int dim = std::max(img.width, img.height); while (dim > 1) { dim >>= 1; mipLevels++; } }
-
-        m_materials.textures[i] = rhiCreateTexture2D(
-            dev, static_cast<uint32_t>(img.width), static_cast<uint32_t>(img.height),
-            RhiFormat::RGBA8Unorm, true, mipLevels,
-            RhiTextureStorageMode::Shared, RhiTextureUsage::ShaderRead);
-
-        if (m_materials.textures[i].nativeHandle()) {
-            rhiUploadTexture2D(m_materials.textures[i],
-                               static_cast<uint32_t>(img.width),
-                               static_cast<uint32_t>(img.height),
-                               img.pixels.data(),
-                               static_cast<size_t>(img.width) * 4u);
-            rhiGenerateMipmaps(queue, m_materials.textures[i]);
-        }
+    // BC7 chains are transcoded once and cached beside the meshlet cache; devices
+    // without BC support get a CPU-filtered RGBA8 chain. Either way the full chain
+    // stays in memory so the streaming pool can promote mips on demand.
+    const bool useBC7 = usesBC7Textures(dev, cacheDir);
+    if (useBC7) {
+        std::error_code createError;
+        std::filesystem::create_directories(cacheDir, createError);
     }
+    // Chains restored from a snapshot are used as is; the rest come from pixels.
+    std::vector<TranscodedTexture> sources = std::move(m_prebuiltTextures);
+    m_prebuiltTextures.clear();
+    sources.resize(imageCount);
+    Parallel::parallelFor(imageCount, [&](size_t i) {
+        if (!sources[i].mips.empty()) return;
+        const auto& img = scene.images[i];
+        if (img.pixels.empty() || img.width <= 0 || img.height <= 0) return;
+        const uint32_t width = static_cast<uint32_t>(img.width);
+        const uint32_t height = static_cast<uint32_t>(img.height);
+        if (useBC7 && loadOrTranscodeTexture(img.pixels.data(), width, height, cacheDir, sources[i]))
+            return;
+        if (!buildTextureMipChainRGBA8(img.pixels.data(), width, height, sources[i]))
+            sources[i] = TranscodedTexture{};
+    });
+
+    uint32_t compressedCount = 0;
+    for (const TranscodedTexture& source : sources)
+        if (source.format == RhiFormat::BC7RGBAUnorm) compressedCount++;
+
+    m_texturePool.initialize(dev, std::move(sources), m_materials,
+                             m_textureStreamingEnabled, m_deferTextureUploads);
 
     std::vector<GPUMaterial> gpuMats(scene.materials.size());
     for (size_t i = 0; i < scene.materials.size(); ++i) {
@@ -203,10 +252,11 @@ bool SceneGpu::createMaterials(const Scene& scene) {
     }
 
     if (!gpuMats.empty()) {
-        m_materials.materialBuffer = rhiCreateSharedBuffer(
+        m_materials.materialBuffer = rhiCreateDeviceBuffer(
             dev, gpuMats.data(), gpuMats.size() * sizeof(GPUMaterial), "Materials");
     }
     m_materials.materialCount = static_cast<uint32_t>(gpuMats.size());
+    m_materials.cpuMaterials = std::move(gpuMats);
 
     RhiSamplerDesc samplerDesc;
     samplerDesc.minFilter = RhiSamplerFilterMode::Linear;
@@ -221,7 +271,11 @@ bool SceneGpu::createMaterials(const Scene& scene) {
     for (const auto& tex : m_materials.textures)
         m_materials.textureViews.push_back(&tex);
 
-    spdlog::info("SceneGpu: {} materials, {} textures", m_materials.materialCount, imageCount);
+    const TextureStreamingPool::Stats poolStats = m_texturePool.stats();
+    spdlog::info("SceneGpu: {} materials, {} textures ({} BC7, {:.1f} MB resident{})",
+                 m_materials.materialCount, imageCount, compressedCount,
+                 static_cast<double>(poolStats.residentBytes) / (1024.0 * 1024.0),
+                 poolStats.streamingEnabled ? ", streamed" : "");
     return true;
 }
 
@@ -278,6 +332,8 @@ bool SceneGpu::createSceneGraph(const Scene& scene) {
         gn.parent = sn.parent;
         gn.children.assign(sn.children.begin(), sn.children.end());
         gn.visible = true;
+        gn.skin = sn.skin;
+        gn.morphWeights = sn.morphWeights;
 
         if (sn.hasMatrix) {
             std::memcpy(&gn.transform.localMatrix, sn.localMatrix, sizeof(float) * 16);
@@ -293,11 +349,21 @@ bool SceneGpu::createSceneGraph(const Scene& scene) {
         if (sn.light >= 0 && sn.light < static_cast<int>(scene.lights.size())) {
             gn.lightIndex = sn.light;
             gn.hasLight = true;
-            gn.light.type = LightType::Directional;
             const auto& sl = scene.lights[sn.light];
-            gn.light.directional.color = float3(sl.color[0], sl.color[1], sl.color[2]);
-            gn.light.directional.intensity = sl.intensity;
-            gn.light.directional.direction = normalize(float3(0.5f, 1.0f, 0.8f));
+            const float3 lightColor(sl.color[0], sl.color[1], sl.color[2]);
+            if (sl.type == SceneLight::Directional) {
+                gn.light.type = LightType::Directional;
+                gn.light.directional.color = lightColor;
+                gn.light.directional.intensity = sl.intensity;
+                gn.light.directional.direction = normalize(float3(0.5f, 1.0f, 0.8f));
+            } else {
+                gn.light.type = sl.type == SceneLight::Spot ? LightType::Spot : LightType::Point;
+                gn.light.punctual.color = lightColor;
+                gn.light.punctual.intensity = sl.intensity;
+                gn.light.punctual.range = sl.range;
+                gn.light.punctual.innerConeAngle = sl.innerConeAngle;
+                gn.light.punctual.outerConeAngle = sl.outerConeAngle;
+            }
             if (m_sceneGraph.sunLightNode < 0 && sl.type == SceneLight::Directional)
                 m_sceneGraph.sunLightNode = static_cast<int32_t>(i);
         }
@@ -354,6 +420,53 @@ bool SceneGpu::createSceneGraph(const Scene& scene) {
         }
     }
 
+    // EXT_mesh_gpu_instancing: the mesh is drawn once per instance matrix.
+    std::vector<float4x4> instanceMatrices;
+    for (size_t i = 0; i < scene.nodes.size(); ++i) {
+        const std::vector<float>& matrices = scene.nodes[i].instanceMatrices;
+        if (matrices.empty())
+            continue;
+        instanceMatrices.resize(matrices.size() / 16);
+        for (size_t k = 0; k < instanceMatrices.size(); ++k)
+            std::memcpy(&instanceMatrices[k], matrices.data() + k * 16, sizeof(float) * 16);
+        m_sceneGraph.addMeshInstances(static_cast<uint32_t>(i), instanceMatrices.data(), instanceMatrices.size());
+    }
+
+    m_sceneGraph.skins.resize(scene.skins.size());
+    for (size_t si = 0; si < scene.skins.size(); ++si) {
+        const SceneSkin& source = scene.skins[si];
+        SkinComponent& skin = m_sceneGraph.skins[si];
+        skin.joints.assign(source.joints.begin(), source.joints.end());
+        skin.inverseBindMatrices.resize(source.joints.size());
+        std::memcpy(skin.inverseBindMatrices.data(), source.inverseBindMatrices.data(),
+                    source.inverseBindMatrices.size() * sizeof(float));
+    }
+
+    // Only the first clip starts playing; clips usually animate the same joints.
+    m_sceneGraph.animations.resize(scene.animations.size());
+    for (size_t ai = 0; ai < scene.animations.size(); ++ai) {
+        const SceneAnimation& source = scene.animations[ai];
+        AnimationClip& clip = m_sceneGraph.animations[ai];
+        clip.name = source.name.empty() ? "Animation " + std::to_string(ai) : source.name;
+        clip.duration = source.duration;
+        clip.playing = ai == 0;
+        clip.samplers.resize(source.samplers.size());
+        for (size_t si = 0; si < source.samplers.size(); ++si) {
+            const SceneAnimationSampler& ss = source.samplers[si];
+            AnimationSampler& sampler = clip.samplers[si];
+            sampler.interpolation = static_cast<AnimationInterpolation>(ss.interpolation);
+            sampler.components = ss.components;
+            sampler.times = ss.times;
+            sampler.values = ss.values;
+        }
+        for (const SceneAnimationChannel& sc : source.channels) {
+            AnimationChannel& channel = clip.channels.emplace_back();
+            channel.sampler = sc.sampler;
+            channel.node = static_cast<uint32_t>(sc.node);
+            channel.path = static_cast<AnimationPath>(sc.path);
+        }
+    }
+
     for (int ri : scene.rootNodes)
         m_sceneGraph.rootNodes.push_back(static_cast<uint32_t>(ri));
 
@@ -376,7 +489,64 @@ bool SceneGpu::createGpuSceneTables() {
     return buildGpuSceneTables(m_device, m_mesh, m_meshlets, lodPtr, m_sceneGraph, m_gpuScene);
 }
 
+bool SceneGpu::addMeshInstances(uint32_t nodeId, const float4x4* localMatrices, size_t count) {
+    RhiMemoryTagScope geometryTag(RhiMemoryTag::Geometry);
+    if (!m_sceneGraph.addMeshInstances(nodeId, localMatrices, count))
+        return false;
+    m_sceneGraph.updateTransforms();
+    if (!createGpuSceneTables()) {
+        spdlog::warn("GPU scene tables failed after adding instances, continuing without");
+        releaseGpuSceneTables(m_gpuScene);
+        m_gpuScene = GpuSceneTables{};
+    }
+    return true;
+}
+
+bool SceneGpu::addMeshInstances(const std::vector<MeshInstanceSet>& instanceSets) {
+    RhiMemoryTagScope geometryTag(RhiMemoryTag::Geometry);
+    bool added = false;
+    for (const MeshInstanceSet& set : instanceSets)
+        added |= m_sceneGraph.addMeshInstances(set.node, set.localMatrices.data(), set.localMatrices.size());
+    if (!added)
+        return false;
+    m_sceneGraph.updateTransforms();
+    if (!createGpuSceneTables()) {
+        spdlog::warn("GPU scene tables failed after adding instances, continuing without");
+        releaseGpuSceneTables(m_gpuScene);
+        m_gpuScene = GpuSceneTables{};
+    }
+    return true;
+}
+
+size_t SceneGpu::releaseCpuMirrors() {
+    // Only buildClusterLOD reads the LOD 0 meshlets on the CPU.
+    size_t freedBytes = releaseCpuArray(m_meshlets.cpuMeshlets);
+    freedBytes += releaseCpuArray(m_meshlets.cpuMeshletVertices);
+    freedBytes += releaseCpuArray(m_meshlets.cpuMeshletTriangles);
+    freedBytes += releaseCpuArray(m_meshlets.cpuBounds);
+    freedBytes += releaseCpuArray(m_meshlets.cpuMaterialIDs);
+    freedBytes += releaseCpuArray(m_mesh.cpuPositions);
+
+    // Ray-traced LOD cuts below depth 0 copy the indices of primitive groups
+    // that have no cluster hierarchy of their own.
+    const auto& lodRoots = m_clusterLod.primitiveGroupLodRoots;
+    const bool unclusteredGroups = !m_clusterLod.levels.empty() &&
+        (lodRoots.size() < m_mesh.primitiveGroups.size() ||
+         std::find(lodRoots.begin(), lodRoots.end(), UINT32_MAX) != lodRoots.end());
+    if (!unclusteredGroups) {
+        freedBytes += releaseCpuArray(m_mesh.cpuIndices);
+    }
+    freedBytes += releaseClusterLODCpuArrays(m_clusterLod);
+    return freedBytes;
+}
+
+void SceneGpu::advanceAnimations(float deltaTime) {
+    m_sceneGraph.advanceAnimations(deltaTime);
+}
+
 void SceneGpu::updatePerFrame() {
+    RhiMemoryTagScope geometryTag(RhiMemoryTag::Geometry);
     m_sceneGraph.updateTransforms();
+    updateGpuSkinning(m_sceneGraph, m_skinning);
     updateGpuSceneTables(m_sceneGraph, m_gpuScene);
 }
@@ -7,6 +7,8 @@
 #include "material_loader.h"
 #include "scene_graph.h"
 #include "gpu_scene.h"
+#include "gpu_skinning.h"
+#include "texture_streaming_pool.h"
 
 #include <string>
 
@@ -19,7 +21,40 @@ public:
 
     bool create(const Scene& scene, const std::string& cacheDir);
     void destroy();
+    // Steps the scene graph's playing animation clips; updatePerFrame() then
+    // poses the skinned and morphed meshes.
+    void advanceAnimations(float deltaTime);
     void updatePerFrame();
+    // Must be set before create(); streaming keeps only mip tails resident up front.
+    void setTextureStreamingEnabled(bool enabled) { m_textureStreamingEnabled = enabled; }
+    // Lets create() run off the render thread: material textures are only
+    // allocated once uploadDeferredTextures() is called on the render thread.
+    void setDeferTextureUploads(bool defer) { m_deferTextureUploads = defer; }
+    bool uploadDeferredTextures();
+    // Must be set before create(); the chains (from loadSceneSnapshot) stand in
+    // for decoding scene.images, whose pixels a restored scene does not carry.
+    void setPrebuiltTextures(std::vector<TranscodedTexture>&& textures) { m_prebuiltTextures = std::move(textures); }
+    // Whether create() built BC7 chains for the given cache directory.
+    static bool usesBC7Textures(const RhiDevice& device, const std::string& cacheDir);
+    // Hands instance matrices to TransformHierarchyPass; ignored when the scene
+    // has no transform hierarchy buffers.
+    void setGpuTransformPropagation(bool enabled) {
+        m_gpuScene.gpuTransformPropagation = enabled && m_gpuScene.hierarchyWorldBuffer.nativeHandle();
+    }
+
+    // Programmatic instancing (SceneGraph::addMeshInstances) followed by a rebuild
+    // of the GPU scene tables. The old tables are released immediately, so call it
+    // while no submitted frame still reads them, e.g. right after create().
+    bool addMeshInstances(uint32_t nodeId, const float4x4* localMatrices, size_t count);
+    // Same for several nodes with a single table rebuild. Sets naming a node
+    // without a mesh are skipped; returns false when none was added.
+    bool addMeshInstances(const std::vector<MeshInstanceSet>& instanceSets);
+
+    // Drops the host copies create() kept of data the GPU now holds: the LOD 0
+    // meshlets, mesh positions and the cluster LOD arrays the cache file can give
+    // back (releaseClusterLODCpuArrays). Mesh indices stay while ray-traced LOD cuts
+    // may still copy them. Call once the BLAS builds have landed; returns the bytes freed.
+    size_t releaseCpuMirrors();
 
     bool isValid() const { return m_valid; }
 
@@ -30,12 +65,14 @@ public:
     SceneGraph& sceneGraph() { return m_sceneGraph; }
     const SceneGraph& sceneGraph() const { return m_sceneGraph; }
     const GpuSceneTables& gpuScene() const { return m_gpuScene; }
+    const GpuSkinningTables& skinning() const { return m_skinning; }
+    TextureStreamingPool& texturePool() { return m_texturePool; }
 
 private:
     bool createMeshBuffers(const Scene& scene);
     bool createMeshlets(const Scene& scene, const std::string& cacheDir);
     bool createClusterLod(const Scene& scene, const std::string& cacheDir);
-    bool createMaterials(const Scene& scene);
+    bool createMaterials(const Scene& scene, const std::string& cacheDir);
     bool createSceneGraph(const Scene& scene);
     bool createGpuSceneTables();
 
@@ -49,4 +86,9 @@ private:
     LoadedMaterials m_materials;
     SceneGraph m_sceneGraph;
     GpuSceneTables m_gpuScene;
+    GpuSkinningTables m_skinning;
+    TextureStreamingPool m_texturePool;
+    bool m_textureStreamingEnabled = false;
+    bool m_deferTextureUploads = false;
+    std::vector<TranscodedTexture> m_prebuiltTextures;
 };
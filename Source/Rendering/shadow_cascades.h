@@ -0,0 +1,163 @@
+#pragma once
+
+#include <ml.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Directional-light cascades for GPUs without ray-traced shadows. Each cascade is
+// drawn by a MeshletCullPass/VisibilityPass pair configured with "shadowCascade"
+// and sampled by ShadowCascadeResolvePass into the "shadowMap" mask that
+// ShadowRayPass writes on ray-tracing hardware.
+static constexpr uint32_t kShadowCascadeCount = 4;
+static constexpr uint32_t kShadowCascadeResolution = 2048;
+
+inline const char* shadowCascadeDepthHistoryName(uint32_t cascade) {
+    static constexpr const char* kNames[kShadowCascadeCount] = {
+        "ShadowCascadeDepth0", "ShadowCascadeDepth1", "ShadowCascadeDepth2", "ShadowCascadeDepth3"};
+    return kNames[std::min(cascade, kShadowCascadeCount - 1u)];
+}
+
+struct ShadowCascadeView {
+    float4x4 view;
+    float4x4 proj;              // orthographic, reversed-Z like the camera
+    float splitFar = 0.0f;      // camera view depth the cascade covers up to
+    float texelWorldSize = 0.0f;
+    bool cached = false;        // last frame's depth is still exact; cull and raster skip it
+};
+
+struct ShadowCascadeSet {
+    ShadowCascadeView cascades[kShadowCascadeCount];
+    uint32_t count = 0;         // 0 when cascaded shadows are off
+};
+
+// The cascade a pass configured with "shadowCascade" draws, or null when cascades
+// are off this frame.
+inline const ShadowCascadeView* findShadowCascade(const ShadowCascadeSet& set, int cascade) {
+    return cascade >= 0 && static_cast<uint32_t>(cascade) < set.count ? &set.cascades[cascade] : nullptr;
+}
+
+// Fits the cascades to splits of the camera frustum and tracks which of them can
+// keep last frame's depth. Each cascade bounds its split with a sphere whose center
+// is snapped to whole shadow texels, so its matrices stay bit-identical while the
+// light is fixed and the camera moves less than a texel. A cascade is cached when
+// its matrices and the scene content revision both match the previous frame.
+class ShadowCascadeController {
+public:
+    struct Settings {
+        float maxDistance = 200.0f; // shadows end here, or at the scene diagonal if shorter
+        float splitLambda = 0.75f;  // 0 = uniform splits, 1 = logarithmic
+        float minNear = 0.05f;      // keeps tiny camera near planes from collapsing the log splits
+    };
+
+    struct Inputs {
+        float3 cameraPos;
+        float3 cameraRight;
+        float3 cameraUp;
+        float3 cameraForward;
+        float fovY = 0.0f;
+        float aspect = 1.0f;
+        float nearZ = 0.0f;
+        float farZ = 0.0f;
+        float3 toLight;             // world direction toward the light
+        float3 sceneMin;
+        float3 sceneMax;
+        uint32_t sceneRevision = 0;
+        bool historyReset = false;
+    };
+
+    Settings& settings() { return m_settings; }
+    const Settings& settings() const { return m_settings; }
+
+    void reset() { m_previousValid = false; }
+
+    void update(const Inputs& in, ShadowCascadeSet& out) {
+        const float3 lightForward = normalize(-in.toLight);
+        const float3 worldUp = std::fabs(lightForward.y) > 0.99f ? float3(0.f, 0.f, 1.f) : float3(0.f, 1.f, 0.f);
+        const float3 lightRight = normalize(cross(lightForward, worldUp));
+        const float3 lightUp = cross(lightRight, lightForward);
+        const float4x4 lightView(
+            float4(lightRight.x, lightUp.x, -lightForward.x, 0.f),
+            float4(lightRight.y, lightUp.y, -lightForward.y, 0.f),
+            float4(lightRight.z, lightUp.z, -lightForward.z, 0.f),
+            float4(0.f, 0.f, 0.f, 1.f));
+
+        // Depth range along the light: the whole scene, so off-screen casters between
+        // the light and a cascade still land in it, and camera motion never changes it.
+        float sceneDepthMin = 0.0f;
+        float sceneDepthMax = 0.0f;
+        for (uint32_t corner = 0; corner < 8; ++corner) {
+            const float3 p((corner & 1u) ? in.sceneMax.x : in.sceneMin.x,
+                           (corner & 2u) ? in.sceneMax.y : in.sceneMin.y,
+                           (corner & 4u) ? in.sceneMax.z : in.sceneMin.z);
+            const float d = dot(lightForward, p);
+            sceneDepthMin = corner == 0 ? d : std::min(sceneDepthMin, d);
+            sceneDepthMax = corner == 0 ? d : std::max(sceneDepthMax, d);
+        }
+        const float depthMargin = std::max((sceneDepthMax - sceneDepthMin) * 0.01f, 1e-3f);
+
+        const float sceneDiagonal = length(in.sceneMax - in.sceneMin);
+        const float nearZ = std::max(in.nearZ, m_settings.minNear);
+        const float farZ = std::max(std::min({in.farZ, m_settings.maxDistance, sceneDiagonal}), nearZ * 2.0f);
+        const float tanHalfY = std::tan(in.fovY * 0.5f);
+        const float tanHalfX = tanHalfY * in.aspect;
+
+        uint32_t projFlags = 0;
+#if ML_DEPTH_REVERSED
+        projFlags |= PROJ_REVERSED_Z;
+#endif
+
+        out.count = kShadowCascadeCount;
+        float splitNear = in.nearZ;
+        for (uint32_t i = 0; i < kShadowCascadeCount; ++i) {
+            const float t = float(i + 1) / float(kShadowCascadeCount);
+            const float logSplit = nearZ * std::pow(farZ / nearZ, t);
+            const float uniformSplit = nearZ + (farZ - nearZ) * t;
+            const float splitFar = m_settings.splitLambda * logSplit + (1.0f - m_settings.splitLambda) * uniformSplit;
+
+            // The slice is symmetric about the view axis, so its corner centroid lies on
+            // the axis and the bounding radius does not change as the camera turns.
+            const float centerDepth = 0.5f * (splitNear + splitFar);
+            const float farHalfDiagonal = splitFar * std::sqrt(tanHalfX * tanHalfX + tanHalfY * tanHalfY);
+            const float nearHalfDiagonal = splitNear * std::sqrt(tanHalfX * tanHalfX + tanHalfY * tanHalfY);
+            const float halfDepth = 0.5f * (splitFar - splitNear);
+            float radius = std::sqrt(std::max(halfDepth * halfDepth + farHalfDiagonal * farHalfDiagonal,
+                                              halfDepth * halfDepth + nearHalfDiagonal * nearHalfDiagonal));
+            // Round up so float noise in the split math cannot change the texel size.
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+
+            const float3 center = in.cameraPos + in.cameraForward * centerDepth;
+            const float texel = 2.0f * radius / float(kShadowCascadeResolution);
+            const float centerX = std::floor(dot(lightRight, center) / texel) * texel;
+            const float centerY = std::floor(dot(lightUp, center) / texel) * texel;
+
+            ShadowCascadeView& cascade = out.cascades[i];
+            cascade.view = lightView;
+            cascade.proj.SetupByOrthoProjection(centerX - radius, centerX + radius,
+                                                centerY - radius, centerY + radius,
+                                                sceneDepthMin - depthMargin, sceneDepthMax + depthMargin,
+                                                projFlags);
+            cascade.splitFar = splitFar;
+            cascade.texelWorldSize = texel;
+            cascade.cached = m_previousValid && !in.historyReset &&
+                             in.sceneRevision == m_previousSceneRevision &&
+                             std::memcmp(&cascade.view, &m_previousView[i], sizeof(float4x4)) == 0 &&
+                             std::memcmp(&cascade.proj, &m_previousProj[i], sizeof(float4x4)) == 0;
+
+            m_previousView[i] = cascade.view;
+            m_previousProj[i] = cascade.proj;
+            splitNear = splitFar;
+        }
+        m_previousSceneRevision = in.sceneRevision;
+        m_previousValid = true;
+    }
+
+private:
+    Settings m_settings;
+    float4x4 m_previousView[kShadowCascadeCount];
+    float4x4 m_previousProj[kShadowCascadeCount];
+    uint32_t m_previousSceneRevision = 0;
+    bool m_previousValid = false;
+};
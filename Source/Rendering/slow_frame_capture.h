@@ -0,0 +1,287 @@
+#pragma once
+
+#include "frame_graph.h"
+#include "graphics_capture.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Keeps the CPU and GPU timings of the last frames in a ring buffer and dumps
+// them when a frame takes longer than thresholdFactor x the median of that ring.
+// The dump is a JSON file with the ring, the trigger and caller-supplied context
+// (streaming stats), plus the frame graph as Graphviz. With captureOnSpike the
+// next frame is also captured by RenderDoc when it is attached. The same dump
+// can be requested by hand with requestDump().
+class SlowFrameCapture {
+public:
+    struct Settings {
+        // 0 disables spike detection; requestDump() still works.
+        double thresholdFactor = 2.0;
+        // Spikes shorter than this are ignored, so tiny medians do not trigger.
+        double minSpikeMs = 4.0;
+        uint32_t historyFrames = 240u;
+        // Frames between two automatic dumps.
+        uint32_t cooldownFrames = 300u;
+        uint32_t maxDumps = 16u;
+        bool captureOnSpike = false;
+        std::string dumpDirectory = "cache/slow_frames";
+    };
+
+    // Per-frame streaming counters kept in the ring next to the timings.
+    struct StreamingSample {
+        uint32_t loadsExecuted = 0u;
+        uint32_t unloadsExecuted = 0u;
+        uint32_t loadRequests = 0u;
+        uint32_t groupPageReads = 0u;
+        uint32_t failedAllocations = 0u;
+        uint64_t transferBytes = 0u;
+        float requestReadbackCpuMs = 0.0f;
+    };
+
+    // Returns false on a malformed argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* factor = takeValue("--slow-frame-threshold")) {
+                settings.thresholdFactor = std::max(0.0, std::strtod(factor, nullptr));
+            } else if (const char* ms = takeValue("--slow-frame-min-ms")) {
+                settings.minSpikeMs = std::max(0.0, std::strtod(ms, nullptr));
+            } else if (const char* frames = takeValue("--slow-frame-history")) {
+                settings.historyFrames = std::max(8u, static_cast<uint32_t>(std::strtoul(frames, nullptr, 10)));
+            } else if (const char* path = takeValue("--slow-frame-dir")) {
+                settings.dumpDirectory = path;
+            } else if (std::strcmp(arg, "--slow-frame-capture") == 0) {
+                settings.captureOnSpike = true;
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--slow-frame-", 13) == 0) {
+                spdlog::error("Unknown slow frame argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    explicit SlowFrameCapture(const Settings& settings) : m_settings(settings) {
+        m_frames.resize(m_settings.historyFrames);
+        m_scratch.reserve(m_settings.historyFrames);
+    }
+
+    // The next recordFrame() dumps regardless of the threshold and captures the
+    // following frame.
+    void requestDump() { m_dumpRequested = true; }
+
+    // Call once per frame after submission. GPU timings trail the CPU by the
+    // frames in flight; a GPU sample is only kept for a new gpuFrameIndex.
+    // expectedHitch marks frames that rebuild pipelines or swap scenes: they are
+    // kept in the ring but neither they nor the frames in flight behind them trigger.
+    // Returns true when this frame should be dumped with writeDump().
+    bool recordFrame(uint32_t frameIndex,
+                     double cpuFrameMs,
+                     uint64_t gpuFrameIndex,
+                     double gpuFrameMs,
+                     const std::vector<FGGpuScopeSample>& gpuScopes,
+                     const StreamingSample& streaming,
+                     bool expectedHitch) {
+        FrameRecord& record = m_frames[m_next];
+        record.frame = frameIndex;
+        record.cpuMs = cpuFrameMs;
+        record.streaming = streaming;
+        record.gpuMs = 0.0;
+        record.passes.clear();
+        const bool newGpuSample = gpuFrameIndex != m_lastGpuFrameIndex && gpuFrameMs > 0.0;
+        if (newGpuSample) {
+            record.gpuMs = gpuFrameMs;
+            for (const FGGpuScopeSample& scope : gpuScopes) {
+                record.passes.emplace_back(scope.label, scope.durationMs);
+            }
+        }
+        m_lastGpuFrameIndex = gpuFrameIndex;
+        m_next = (m_next + 1u) % m_frames.size();
+        m_count = std::min<size_t>(m_count + 1u, m_frames.size());
+        if (expectedHitch) {
+            m_settleFrames = kSettleFrames;
+        }
+
+        m_trigger = {};
+        if (m_dumpRequested) {
+            m_dumpRequested = false;
+            m_trigger.reason = "manual";
+            m_trigger.capture = true;
+        } else if (m_settleFrames > 0u) {
+            --m_settleFrames;
+            return false;
+        } else if (m_settings.thresholdFactor > 0.0 && m_count >= kMinHistory &&
+                   m_dumpCount < m_settings.maxDumps && frameIndex >= m_nextDumpFrame) {
+            const double cpuMedian = median([](const FrameRecord& frame) { return frame.cpuMs; });
+            const double gpuMedian = median([](const FrameRecord& frame) { return frame.gpuMs; });
+            if (isSpike(cpuFrameMs, cpuMedian)) {
+                m_trigger.reason = "cpu";
+            } else if (newGpuSample && isSpike(gpuFrameMs, gpuMedian)) {
+                m_trigger.reason = "gpu";
+            }
+            m_trigger.cpuMedianMs = cpuMedian;
+            m_trigger.gpuMedianMs = gpuMedian;
+            m_trigger.capture = m_settings.captureOnSpike;
+        }
+        if (m_trigger.reason.empty()) {
+            return false;
+        }
+        m_trigger.frame = frameIndex;
+        m_trigger.cpuMs = cpuFrameMs;
+        m_trigger.gpuMs = newGpuSample ? gpuFrameMs : 0.0;
+        return true;
+    }
+
+    // Writes slow_frame_<frame>.json and .dot for the frame recordFrame() flagged
+    // and triggers the capture of the next frame when asked to.
+    void writeDump(const FrameGraph& frameGraph, const nlohmann::json& context) {
+        if (m_trigger.reason.empty()) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(m_settings.dumpDirectory, error);
+        const std::string basePath =
+            m_settings.dumpDirectory + "/slow_frame_" + std::to_string(m_trigger.frame);
+
+        nlohmann::json history = nlohmann::json::array();
+        for (size_t i = 0; i < m_count; ++i) {
+            const FrameRecord& frame = m_frames[(m_next + m_frames.size() - m_count + i) % m_frames.size()];
+            nlohmann::json row{
+                {"frame", frame.frame},
+                {"cpuMs", frame.cpuMs},
+                {"streaming", {{"loadsExecuted", frame.streaming.loadsExecuted},
+                               {"unloadsExecuted", frame.streaming.unloadsExecuted},
+                               {"loadRequests", frame.streaming.loadRequests},
+                               {"groupPageReads", frame.streaming.groupPageReads},
+                               {"failedAllocations", frame.streaming.failedAllocations},
+                               {"transferBytes", frame.streaming.transferBytes},
+                               {"requestReadbackCpuMs", frame.streaming.requestReadbackCpuMs}}},
+            };
+            if (frame.gpuMs > 0.0) {
+                row["gpuMs"] = frame.gpuMs;
+                nlohmann::json passes = nlohmann::json::object();
+                for (const auto& [label, ms] : frame.passes) {
+                    passes[label] = passes.value(label, 0.0) + ms;
+                }
+                row["passes"] = std::move(passes);
+            }
+            history.push_back(std::move(row));
+        }
+        const bool capture = m_trigger.capture && GraphicsCapture::triggerNextFrame();
+        const nlohmann::json dump{
+            {"trigger", {{"reason", m_trigger.reason},
+                         {"frame", m_trigger.frame},
+                         {"cpuMs", m_trigger.cpuMs},
+                         {"gpuMs", m_trigger.gpuMs},
+                         {"cpuMedianMs", m_trigger.cpuMedianMs},
+                         {"gpuMedianMs", m_trigger.gpuMedianMs},
+                         {"thresholdFactor", m_settings.thresholdFactor},
+                         {"nextFrameCaptured", capture}}},
+            {"context", context},
+            {"history", std::move(history)},
+        };
+        std::ofstream json(basePath + ".json", std::ios::trunc);
+        if (!json) {
+            spdlog::error("Failed to write slow frame dump {}.json", basePath);
+        } else {
+            json << dump.dump(2);
+        }
+        std::ofstream dot(basePath + ".dot", std::ios::trunc);
+        if (dot) {
+            frameGraph.exportGraphviz(dot);
+        }
+
+        if (m_trigger.reason != "manual") {
+            ++m_dumpCount;
+            m_nextDumpFrame = m_trigger.frame + m_settings.cooldownFrames;
+        }
+        spdlog::warn("Slow frame {} ({}): CPU {:.2f} ms, GPU {:.2f} ms, medians {:.2f} / {:.2f} ms; dumped to {}.json{}",
+                     m_trigger.frame, m_trigger.reason, m_trigger.cpuMs, m_trigger.gpuMs,
+                     m_trigger.cpuMedianMs, m_trigger.gpuMedianMs, basePath,
+                     capture ? ", capturing next frame" : "");
+        m_trigger = {};
+    }
+
+private:
+    // Frames in flight behind an expected hitch, whose GPU samples still carry it.
+    static constexpr uint32_t kSettleFrames = 4u;
+    static constexpr size_t kMinHistory = 30u;
+
+    struct FrameRecord {
+        uint32_t frame = 0u;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        StreamingSample streaming;
+        std::vector<std::pair<std::string, double>> passes;
+    };
+
+    struct Trigger {
+        std::string reason;
+        uint32_t frame = 0u;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        double cpuMedianMs = 0.0;
+        double gpuMedianMs = 0.0;
+        bool capture = false;
+    };
+
+    bool isSpike(double ms, double medianMs) const {
+        return medianMs > 0.0 && ms >= m_settings.minSpikeMs && ms > m_settings.thresholdFactor * medianMs;
+    }
+
+    // Median over the ring's non-zero samples.
+    template <typename Field>
+    double median(Field field) {
+        m_scratch.clear();
+        for (size_t i = 0; i < m_count; ++i) {
+            const double value = field(m_frames[i]);
+            if (value > 0.0) {
+                m_scratch.push_back(value);
+            }
+        }
+        if (m_scratch.empty()) {
+            return 0.0;
+        }
+        auto middle = m_scratch.begin() + m_scratch.size() / 2u;
+        std::nth_element(m_scratch.begin(), middle, m_scratch.end());
+        return *middle;
+    }
+
+    Settings m_settings;
+    std::vector<FrameRecord> m_frames;
+    std::vector<double> m_scratch;
+    size_t m_next = 0u;
+    size_t m_count = 0u;
+    uint64_t m_lastGpuFrameIndex = UINT64_MAX;
+    uint32_t m_settleFrames = 0u;
+    uint32_t m_dumpCount = 0u;
+    uint32_t m_nextDumpFrame = 0u;
+    bool m_dumpRequested = false;
+    Trigger m_trigger;
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "camera.h"
+#include "cluster_streaming_service.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+
+// Unattended streaming soak run: flies the orbit camera along a scripted in/out
+// path, randomizes the streaming budgets, forces pipeline reloads, and writes one
+// CSV row of streaming telemetry per frame. Enabled with --streaming-soak <csv>.
+class StreamingSoakBenchmark {
+public:
+    struct Settings {
+        std::string csvPath;
+        float durationSeconds = 120.0f;
+        float pathSpeed = 0.35f; // radians of orbit per second
+        uint32_t budgetChangeIntervalFrames = 240u;
+        uint32_t pipelineReloadIntervalFrames = 1800u;
+        uint32_t seed = 1u;
+    };
+
+    struct FrameActions {
+        bool pipelineReload = false;
+        bool storageResized = false;
+    };
+
+    // Returns false on a malformed soak argument; unrelated arguments are ignored.
+    static bool parseArguments(int argc, char** argv, Settings& settings) {
+        for (int argIndex = 1; argIndex < argc; ++argIndex) {
+            const char* arg = argv[argIndex];
+            const char* value = argIndex + 1 < argc ? argv[argIndex + 1] : nullptr;
+            bool missingValue = false;
+            const auto takeValue = [&](const char* name) -> const char* {
+                if (std::strcmp(arg, name) != 0) {
+                    return nullptr;
+                }
+                if (!value) {
+                    spdlog::error("Missing value for {}", name);
+                    missingValue = true;
+                    return nullptr;
+                }
+                ++argIndex;
+                return value;
+            };
+
+            if (const char* path = takeValue("--streaming-soak")) {
+                settings.csvPath = path;
+            } else if (const char* seconds = takeValue("--soak-seconds")) {
+                settings.durationSeconds = std::max(1.0f, std::strtof(seconds, nullptr));
+            } else if (const char* speed = takeValue("--soak-speed")) {
+                settings.pathSpeed = std::strtof(speed, nullptr);
+            } else if (const char* frames = takeValue("--soak-budget-interval")) {
+                settings.budgetChangeIntervalFrames =
+                    static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+            } else if (const char* frames = takeValue("--soak-reload-interval")) {
+                settings.pipelineReloadIntervalFrames =
+                    static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+            } else if (const char* seed = takeValue("--soak-seed")) {
+                settings.seed = static_cast<uint32_t>(std::strtoul(seed, nullptr, 10));
+            } else if (missingValue) {
+                return false;
+            } else if (std::strncmp(arg, "--soak-", 7) == 0) {
+                spdlog::error("Unknown streaming soak argument {}", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool begin(const Settings& settings, const OrbitCamera& camera, double startSeconds) {
+        m_settings = settings;
+        m_csv.open(settings.csvPath, std::ios::trunc);
+        if (!m_csv) {
+            spdlog::error("Failed to open streaming soak CSV {}", settings.csvPath);
+            return false;
+        }
+
+        m_csv << "frame,time_s,event,budget_groups,max_loads,resident_groups,load_requests,"
+                 "loads_executed,loads_deferred,unload_requests,unloads_executed,transfer_bytes,"
+                 "transfer_utilization,failed_allocations,pop_latency_samples,"
+                 "pop_latency_avg_frames,pop_latency_max_frames,request_readback_ms\n";
+        m_baseCamera = camera;
+        m_startSeconds = startSeconds;
+        m_elapsedSeconds = 0.0;
+        m_frameCount = 0u;
+        m_random.seed(settings.seed);
+        m_active = true;
+        spdlog::info("Streaming soak benchmark: {:.0f} s, writing {}",
+                     settings.durationSeconds,
+                     settings.csvPath);
+        return true;
+    }
+
+    bool active() const { return m_active; }
+    bool finished() const {
+        return m_active && m_elapsedSeconds >= double(m_settings.durationSeconds);
+    }
+
+    // Call once per frame before the view is built.
+    FrameActions update(double nowSeconds,
+                        OrbitCamera& camera,
+                        ClusterStreamingService& streamingService) {
+        FrameActions actions;
+        if (!m_active) {
+            return actions;
+        }
+
+        m_elapsedSeconds = nowSeconds - m_startSeconds;
+        driveCamera(camera);
+        m_event.clear();
+
+        if (m_frameCount != 0u && m_settings.budgetChangeIntervalFrames != 0u &&
+            m_frameCount % m_settings.budgetChangeIntervalFrames == 0u) {
+            actions.storageResized = randomizeBudgets(streamingService);
+        }
+        if (m_frameCount != 0u && m_settings.pipelineReloadIntervalFrames != 0u &&
+            m_frameCount % m_settings.pipelineReloadIntervalFrames == 0u) {
+            actions.pipelineReload = true;
+            appendEvent("reload");
+        }
+        return actions;
+    }
+
+    // Call once per frame after the streaming service has run.
+    void recordFrame(uint32_t frameIndex, const ClusterStreamingService& streamingService) {
+        if (!m_active) {
+            return;
+        }
+
+        const ClusterStreamingService::StreamingStats& stats = streamingService.streamingStats();
+        m_csv << frameIndex << ',' << m_elapsedSeconds << ',' << m_event << ','
+              << streamingService.streamingBudgetGroups() << ','
+              << streamingService.maxLoadsPerFrame() << ',' << stats.residentGroupCount << ','
+              << stats.loadRequestsThisFrame << ',' << stats.loadsExecutedThisFrame << ','
+              << stats.loadsDeferredThisFrame << ',' << stats.unloadRequestsThisFrame << ','
+              << stats.unloadsExecutedThisFrame << ',' << stats.transferBytesThisFrame << ','
+              << stats.transferUtilization << ',' << stats.failedAllocations << ','
+              << stats.popLatencySampleCount << ',' << stats.popLatencyAverageFrames << ','
+              << stats.popLatencyMaxFrames << ',' << stats.requestReadbackCpuMs << '\n';
+        ++m_frameCount;
+        if (finished()) {
+            m_csv.flush();
+            spdlog::info("Streaming soak benchmark finished after {} frames", m_frameCount);
+        }
+    }
+
+private:
+    void driveCamera(OrbitCamera& camera) const {
+        // The distance sweep drives LOD refinement and coarsening; the orbit keeps
+        // bringing new geometry on screen.
+        const float t = static_cast<float>(m_elapsedSeconds) * m_settings.pathSpeed;
+        const float zoom = 0.5f + 0.5f * std::cos(t * 0.37f);
+        camera.azimuth = m_baseCamera.azimuth + t;
+        camera.distance = m_baseCamera.distance * (0.08f + 0.92f * zoom);
+        camera.elevation = m_baseCamera.elevation + 0.25f * std::sin(t * 0.53f);
+        camera.target = m_baseCamera.target;
+    }
+
+    // Returns true when the storage capacity changed.
+    bool randomizeBudgets(ClusterStreamingService& streamingService) {
+        static constexpr std::array<uint32_t, 6> kBudgetGroups = {32u, 64u, 128u, 256u, 512u, 1024u};
+        static constexpr std::array<uint32_t, 4> kMaxLoads = {8u, 32u, 128u, 512u};
+        static constexpr std::array<uint64_t, 4> kStorageMiB = {64u, 128u, 256u, 512u};
+
+        streamingService.setStreamingBudgetGroups(kBudgetGroups[pick(kBudgetGroups.size())]);
+        streamingService.setMaxLoadsPerFrame(kMaxLoads[pick(kMaxLoads.size())]);
+        appendEvent("budget");
+        // Storage resizes rebuild the whole residency state, so they are rarer.
+        if (pick(4u) == 0u) {
+            streamingService.setStreamingStorageCapacityBytes(
+                kStorageMiB[pick(kStorageMiB.size())] * 1024ull * 1024ull);
+            appendEvent("storage");
+            return true;
+        }
+        return false;
+    }
+
+    size_t pick(size_t count) {
+        return std::uniform_int_distribution<size_t>(0u, count - 1u)(m_random);
+    }
+
+    void appendEvent(const char* event) {
+        if (!m_event.empty()) {
+            m_event += '+';
+        }
+        m_event += event;
+    }
+
+    Settings m_settings;
+    std::ofstream m_csv;
+    OrbitCamera m_baseCamera;
+    std::mt19937 m_random;
+    std::string m_event;
+    double m_startSeconds = 0.0;
+    double m_elapsedSeconds = 0.0;
+    uint32_t m_frameCount = 0u;
+    bool m_active = false;
+};
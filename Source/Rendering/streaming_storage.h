@@ -5,13 +5,21 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+// Device-local pool for streamed cluster data with a TLSF allocator over it. The
+// buffer is a reservation; the allocator only hands out its first capacityElements,
+// which can move inside the reservation without recreating the buffer, so page
+// table entries and resident data survive budget changes. Lowering the capacity
+// keeps the allocations above it until their owner releases or relocates them
+// (overCommitted()); free space above it is parked rather than listed.
 class StreamingStorage {
 public:
     struct CopyRegion {
@@ -20,9 +28,10 @@ public:
         uint64_t sizeBytes = 0u;
     };
 
-    struct Range {
+    struct Allocation {
         uint32_t offset = 0u;
         uint32_t count = 0u;
+        uint32_t tag = UINT32_MAX;
     };
 
     bool ready() const {
@@ -33,38 +42,72 @@ public:
     RhiBuffer* buffer() { return m_buffer.get(); }
 
     uint32_t capacityElements() const { return m_capacityElements; }
+    uint32_t reservedElements() const { return m_reservedElements; }
+    // True while allocations remain above a capacity that was lowered.
+    bool overCommitted() const { return m_managedElements > m_capacityElements; }
     uint64_t maxUploadBytesPerFrame() const { return m_maxUploadBytesPerFrame; }
+    uint32_t uploadFrameCount() const { return static_cast<uint32_t>(m_uploadFrames.size()); }
 
-    uint32_t usedElements() const {
-        if (m_capacityElements == 0u) {
+    // Soft per-frame staging limit below the buffer size; 0 uses the whole buffer.
+    void setUploadBudgetBytes(uint64_t budgetBytes) { m_uploadBudgetBytes = budgetBytes; }
+    uint64_t uploadBudgetBytes() const {
+        return m_uploadBudgetBytes != 0u ? std::min(m_uploadBudgetBytes, m_maxUploadBytesPerFrame)
+                                         : m_maxUploadBytesPerFrame;
+    }
+
+    uint32_t usedElements() const { return m_usedElements; }
+    uint32_t freeElements() const {
+        return m_usedElements < m_capacityElements ? m_capacityElements - m_usedElements : 0u;
+    }
+    uint32_t freeRangeCount() const { return m_freeBlockCount; }
+
+    uint32_t largestFreeRange() const {
+        if (m_firstLevelBitmap == 0u) {
             return 0u;
         }
 
-        uint32_t freeCount = 0u;
-        for (const Range& range : m_freeRanges) {
-            freeCount += range.count;
+        const uint32_t firstLevel = 31u - uint32_t(std::countl_zero(m_firstLevelBitmap));
+        const uint32_t secondLevel =
+            31u - uint32_t(std::countl_zero(m_secondLevelBitmaps[firstLevel]));
+        uint32_t largest = 0u;
+        for (uint32_t blockIndex = m_freeHeads[firstLevel][secondLevel];
+             blockIndex != kInvalidBlock;
+             blockIndex = m_blocks[blockIndex].nextFree) {
+            largest = std::max(largest, m_blocks[blockIndex].count);
         }
-        return m_capacityElements - std::min(m_capacityElements, freeCount);
+        return largest;
+    }
+
+    // 0 when all free space is one contiguous range, approaching 1 as it splinters.
+    float fragmentation() const {
+        const uint32_t freeCount = freeElements();
+        return freeCount != 0u ? 1.0f - float(double(largestFreeRange()) / double(freeCount)) : 0.0f;
     }
 
     void clear() {
         m_buffer.reset();
+        m_reservedElements = 0u;
         m_capacityElements = 0u;
-        m_freeRanges.clear();
+        resetAllocator();
         clearUploadState();
     }
 
+    // Recreates the buffer, and resets the allocator, only when the reservation
+    // changes; otherwise just moves the capacity inside it.
     bool ensureBuffer(RhiFrameGraphBackend& resourceFactory,
                       uint32_t capacityElements,
+                      uint32_t reservedElements,
                       const char* debugName) {
         capacityElements = std::max(1u, capacityElements);
-        if (m_buffer && m_capacityElements == capacityElements) {
+        reservedElements = std::max(capacityElements, reservedElements);
+        if (m_buffer && m_reservedElements == reservedElements) {
+            setCapacityElements(capacityElements);
             return true;
         }
 
         RhiBufferDesc desc{};
-        desc.size = size_t(capacityElements) * sizeof(uint32_t);
-        desc.hostVisible = false;
+        desc.size = size_t(reservedElements) * sizeof(uint32_t);
+        desc.memory = RhiBufferMemory::DeviceLocal;
         desc.sharedWithTransferQueue = true;
         desc.debugName = debugName;
 
@@ -75,11 +118,52 @@ public:
         }
 
         m_buffer = std::move(buffer);
+        m_reservedElements = reservedElements;
         m_capacityElements = capacityElements;
         resetAllocator();
         return true;
     }
 
+    // Moves the end of the allocatable range inside the reservation. Live
+    // allocations stay where they are; free space is listed or parked again on
+    // the new side of the boundary.
+    void setCapacityElements(uint32_t capacityElements) {
+        if (!m_buffer) {
+            return;
+        }
+        capacityElements = std::clamp(capacityElements, 1u, m_reservedElements);
+        if (capacityElements == m_capacityElements) {
+            return;
+        }
+
+        const uint32_t boundary = std::min(capacityElements, m_capacityElements);
+        m_capacityElements = capacityElements;
+        if (m_managedElements < capacityElements) {
+            const uint32_t tailIndex = createBlock(m_managedElements, capacityElements - m_managedElements);
+            m_blocks[tailIndex].prevPhysical = m_lastPhysicalBlock;
+            if (m_lastPhysicalBlock != kInvalidBlock) {
+                m_blocks[m_lastPhysicalBlock].nextPhysical = tailIndex;
+            }
+            m_lastPhysicalBlock = tailIndex;
+            m_managedElements = capacityElements;
+            parkFreeBlock(tailIndex);
+        }
+
+        // Free blocks ending past the old boundary are refiled; the walk revisits a
+        // block a refile merged into, which is harmless.
+        uint32_t blockIndex = m_lastPhysicalBlock;
+        while (blockIndex != kInvalidBlock &&
+               m_blocks[blockIndex].offset + m_blocks[blockIndex].count > boundary) {
+            const uint32_t prevIndex = m_blocks[blockIndex].prevPhysical;
+            if (m_blocks[blockIndex].free) {
+                removeFreeBlock(blockIndex);
+                fileFreeBlock(coalesceFreeBlock(blockIndex));
+            }
+            blockIndex = prevIndex;
+        }
+        trimParkedTail();
+    }
+
     bool ensureUploadBuffers(RhiFrameGraphBackend& resourceFactory,
                              uint32_t framesInFlight,
                              uint64_t maxUploadBytesPerFrame,
@@ -102,20 +186,7 @@ public:
         m_maxUploadBytesPerFrame = maxUploadBytesPerFrame;
 
         for (uint32_t frameIndex = 0u; frameIndex < framesInFlight; ++frameIndex) {
-            UploadFrame& uploadFrame = m_uploadFrames[frameIndex];
-
-            RhiBufferDesc desc{};
-            desc.size = static_cast<size_t>(maxUploadBytesPerFrame);
-            desc.hostVisible = true;
-            desc.sharedWithTransferQueue = true;
-            const std::string debugName =
-                std::string(debugNamePrefix ? debugNamePrefix : "StreamingUpload") +
-                "[" + std::to_string(frameIndex) + "]";
-            desc.debugName = debugName.c_str();
-            uploadFrame.stagingBuffer = resourceFactory.createBuffer(desc);
-            uploadFrame.usedBytes = 0u;
-            uploadFrame.copyRegions.clear();
-            if (!uploadFrame.stagingBuffer || rhiBufferContents(*uploadFrame.stagingBuffer) == nullptr) {
+            if (!createUploadFrame(resourceFactory, frameIndex, debugNamePrefix)) {
                 clearUploadState();
                 return false;
             }
@@ -124,10 +195,43 @@ public:
         return true;
     }
 
+    // Grows or shrinks the upload frame list without touching the frames that stay,
+    // so in-flight frames keep their staging memory. Frames past framesInFlight must
+    // no longer be referenced by the GPU.
+    bool resizeUploadBuffers(RhiFrameGraphBackend& resourceFactory,
+                             uint32_t framesInFlight,
+                             const char* debugNamePrefix) {
+        if (m_uploadFrames.empty() || framesInFlight == 0u) {
+            return false;
+        }
+
+        const uint32_t previousCount = uploadFrameCount();
+        m_uploadFrames.resize(framesInFlight);
+        for (uint32_t frameIndex = previousCount; frameIndex < framesInFlight; ++frameIndex) {
+            if (!createUploadFrame(resourceFactory, frameIndex, debugNamePrefix)) {
+                m_uploadFrames.resize(previousCount);
+                return false;
+            }
+        }
+        return true;
+    }
+
     void resetAllocator() {
-        m_freeRanges.clear();
+        m_blocks.clear();
+        m_unusedBlocks.clear();
+        m_allocatedBlocks.clear();
+        for (auto& heads : m_freeHeads) {
+            heads.fill(kInvalidBlock);
+        }
+        m_secondLevelBitmaps.fill(0u);
+        m_firstLevelBitmap = 0u;
+        m_freeBlockCount = 0u;
+        m_usedElements = 0u;
+        m_lastPhysicalBlock = kInvalidBlock;
+        m_managedElements = m_capacityElements;
         if (m_capacityElements > 0u) {
-            m_freeRanges.push_back({0u, m_capacityElements});
+            m_lastPhysicalBlock = createBlock(0u, m_capacityElements);
+            insertFreeBlock(m_lastPhysicalBlock);
         }
     }
 
@@ -159,34 +263,57 @@ public:
                      uint64_t sizeBytes,
                      uint64_t dstOffsetBytes,
                      uint64_t alignmentBytes = 16u) {
-        if (frameSlot >= m_uploadFrames.size()) {
-            return false;
-        }
         if (sizeBytes == 0u) {
-            return true;
+            return frameSlot < m_uploadFrames.size();
         }
         if (!data) {
             return false;
         }
 
+        uint8_t* staging = reserveUpload(frameSlot, sizeBytes, dstOffsetBytes, alignmentBytes);
+        if (!staging) {
+            return false;
+        }
+
+        std::memcpy(staging, data, static_cast<size_t>(sizeBytes));
+        return true;
+    }
+
+    // Records a copy region and returns its staging memory for the caller to fill,
+    // e.g. as the destination of a file read. A region that continues the previous
+    // one in both staging and destination extends it. Returns nullptr when the
+    // frame's staging buffer is full.
+    uint8_t* reserveUpload(uint32_t frameSlot,
+                           uint64_t sizeBytes,
+                           uint64_t dstOffsetBytes,
+                           uint64_t alignmentBytes = 16u) {
+        if (frameSlot >= m_uploadFrames.size() || sizeBytes == 0u) {
+            return nullptr;
+        }
+
         UploadFrame& uploadFrame = m_uploadFrames[frameSlot];
         uint8_t* mappedBytes =
             uploadFrame.stagingBuffer
                 ? static_cast<uint8_t*>(rhiBufferContents(*uploadFrame.stagingBuffer))
                 : nullptr;
         if (!mappedBytes) {
-            return false;
+            return nullptr;
         }
 
         const uint64_t alignedOffset = alignUp(uploadFrame.usedBytes, alignmentBytes);
-        if (alignedOffset + sizeBytes > m_maxUploadBytesPerFrame) {
-            return false;
+        if (alignedOffset + sizeBytes > uploadBudgetBytes()) {
+            return nullptr;
         }
 
-        std::memcpy(mappedBytes + alignedOffset, data, static_cast<size_t>(sizeBytes));
-        uploadFrame.copyRegions.push_back({alignedOffset, dstOffsetBytes, sizeBytes});
+        CopyRegion* last = uploadFrame.copyRegions.empty() ? nullptr : &uploadFrame.copyRegions.back();
+        if (last && last->srcOffsetBytes + last->sizeBytes == alignedOffset &&
+            last->dstOffsetBytes + last->sizeBytes == dstOffsetBytes) {
+            last->sizeBytes += sizeBytes;
+        } else {
+            uploadFrame.copyRegions.push_back({alignedOffset, dstOffsetBytes, sizeBytes});
+        }
         uploadFrame.usedBytes = alignedOffset + sizeBytes;
-        return true;
+        return mappedBytes + alignedOffset;
     }
 
     const RhiBuffer* uploadBuffer(uint32_t frameSlot) const {
@@ -203,29 +330,46 @@ public:
         return frameSlot < m_uploadFrames.size() ? m_uploadFrames[frameSlot].usedBytes : 0u;
     }
 
-    bool allocate(uint32_t elementCount, uint32_t& outOffset) {
+    // Good-fit TLSF allocation: constant time regardless of how many ranges are live.
+    bool allocate(uint32_t elementCount, uint32_t& outOffset, uint32_t tag = UINT32_MAX) {
         if (elementCount == 0u) {
             outOffset = 0u;
             return true;
         }
 
-        for (size_t rangeIndex = 0; rangeIndex < m_freeRanges.size(); ++rangeIndex) {
-            Range& range = m_freeRanges[rangeIndex];
-            if (range.count < elementCount) {
-                continue;
-            }
+        uint32_t firstLevel = 0u;
+        uint32_t secondLevel = 0u;
+        if (!mapSearch(elementCount, firstLevel, secondLevel) ||
+            !findFreeBucket(firstLevel, secondLevel)) {
+            return false;
+        }
 
-            outOffset = range.offset;
-            range.offset += elementCount;
-            range.count -= elementCount;
-            if (range.count == 0u) {
-                m_freeRanges.erase(m_freeRanges.begin() +
-                                   static_cast<std::vector<Range>::difference_type>(rangeIndex));
+        const uint32_t blockIndex = m_freeHeads[firstLevel][secondLevel];
+        removeFreeBlock(blockIndex);
+
+        if (m_blocks[blockIndex].count > elementCount) {
+            const uint32_t remainderIndex = createBlock(m_blocks[blockIndex].offset + elementCount,
+                                                        m_blocks[blockIndex].count - elementCount);
+            Block& block = m_blocks[blockIndex];
+            Block& remainder = m_blocks[remainderIndex];
+            block.count = elementCount;
+            remainder.prevPhysical = blockIndex;
+            remainder.nextPhysical = block.nextPhysical;
+            if (block.nextPhysical != kInvalidBlock) {
+                m_blocks[block.nextPhysical].prevPhysical = remainderIndex;
+            } else {
+                m_lastPhysicalBlock = remainderIndex;
             }
-            return true;
+            block.nextPhysical = remainderIndex;
+            insertFreeBlock(remainderIndex);
         }
 
-        return false;
+        Block& block = m_blocks[blockIndex];
+        block.tag = tag;
+        m_allocatedBlocks[block.offset] = blockIndex;
+        m_usedElements += block.count;
+        outOffset = block.offset;
+        return true;
     }
 
     void release(uint32_t offset, uint32_t elementCount) {
@@ -233,32 +377,31 @@ public:
             return;
         }
 
-        Range releasedRange{offset, elementCount};
-        auto insertIt = std::lower_bound(
-            m_freeRanges.begin(),
-            m_freeRanges.end(),
-            releasedRange.offset,
-            [](const Range& range, uint32_t value) { return range.offset < value; });
-        m_freeRanges.insert(insertIt, releasedRange);
-
-        if (m_freeRanges.empty()) {
+        const auto allocatedIt = m_allocatedBlocks.find(offset);
+        if (allocatedIt == m_allocatedBlocks.end()) {
             return;
         }
 
-        std::vector<Range> mergedRanges;
-        mergedRanges.reserve(m_freeRanges.size());
-        for (const Range& range : m_freeRanges) {
-            if (!mergedRanges.empty()) {
-                Range& previous = mergedRanges.back();
-                if (previous.offset + previous.count == range.offset) {
-                    previous.count += range.count;
-                    continue;
-                }
-            }
-            mergedRanges.push_back(range);
+        const uint32_t blockIndex = allocatedIt->second;
+        m_allocatedBlocks.erase(allocatedIt);
+        m_usedElements -= m_blocks[blockIndex].count;
+        fileFreeBlock(coalesceFreeBlock(blockIndex));
+        trimParkedTail();
+    }
+
+    // Live allocation with the highest offset; defragmentation relocates these first.
+    bool highestAllocation(Allocation& out) const {
+        uint32_t blockIndex = m_lastPhysicalBlock;
+        if (blockIndex != kInvalidBlock && m_blocks[blockIndex].free) {
+            blockIndex = m_blocks[blockIndex].prevPhysical;
+        }
+        if (blockIndex == kInvalidBlock || m_blocks[blockIndex].free) {
+            return false;
         }
 
-        m_freeRanges = std::move(mergedRanges);
+        const Block& block = m_blocks[blockIndex];
+        out = {block.offset, block.count, block.tag};
+        return true;
     }
 
 private:
@@ -268,6 +411,221 @@ private:
         std::vector<CopyRegion> copyRegions;
     };
 
+    static constexpr uint32_t kInvalidBlock = UINT32_MAX;
+    static constexpr uint32_t kSecondLevelLog2 = 4u;
+    static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+    static constexpr uint32_t kFirstLevelCount = 32u - kSecondLevelLog2 + 1u;
+
+    struct Block {
+        uint32_t offset = 0u;
+        uint32_t count = 0u;
+        uint32_t prevPhysical = kInvalidBlock;
+        uint32_t nextPhysical = kInvalidBlock;
+        uint32_t prevFree = kInvalidBlock;
+        uint32_t nextFree = kInvalidBlock;
+        uint32_t tag = UINT32_MAX;
+        bool free = false;
+        // Free but past the capacity, so kept out of the free lists.
+        bool parked = false;
+    };
+
+    static void mapInsert(uint32_t count, uint32_t& firstLevel, uint32_t& secondLevel) {
+        if (count < kSecondLevelCount) {
+            firstLevel = 0u;
+            secondLevel = count;
+            return;
+        }
+
+        const uint32_t log2 = 31u - uint32_t(std::countl_zero(count));
+        firstLevel = log2 - kSecondLevelLog2 + 1u;
+        secondLevel = (count >> (log2 - kSecondLevelLog2)) ^ kSecondLevelCount;
+    }
+
+    // Rounds the request up to the next bucket so any block found there fits.
+    static bool mapSearch(uint32_t count, uint32_t& firstLevel, uint32_t& secondLevel) {
+        uint64_t rounded = count;
+        if (count >= kSecondLevelCount) {
+            const uint32_t log2 = 31u - uint32_t(std::countl_zero(count));
+            rounded += (1ull << (log2 - kSecondLevelLog2)) - 1u;
+        }
+        if (rounded > UINT32_MAX) {
+            return false;
+        }
+
+        mapInsert(static_cast<uint32_t>(rounded), firstLevel, secondLevel);
+        return true;
+    }
+
+    bool findFreeBucket(uint32_t& firstLevel, uint32_t& secondLevel) const {
+        uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0u) {
+            const uint32_t firstLevelMap =
+                firstLevel + 1u < 32u ? m_firstLevelBitmap & (~0u << (firstLevel + 1u)) : 0u;
+            if (firstLevelMap == 0u) {
+                return false;
+            }
+            firstLevel = uint32_t(std::countr_zero(firstLevelMap));
+            secondLevelMap = m_secondLevelBitmaps[firstLevel];
+        }
+
+        secondLevel = uint32_t(std::countr_zero(secondLevelMap));
+        return true;
+    }
+
+    uint32_t createBlock(uint32_t offset, uint32_t count) {
+        uint32_t blockIndex = 0u;
+        if (!m_unusedBlocks.empty()) {
+            blockIndex = m_unusedBlocks.back();
+            m_unusedBlocks.pop_back();
+        } else {
+            blockIndex = static_cast<uint32_t>(m_blocks.size());
+            m_blocks.emplace_back();
+        }
+
+        m_blocks[blockIndex] = Block{};
+        m_blocks[blockIndex].offset = offset;
+        m_blocks[blockIndex].count = count;
+        return blockIndex;
+    }
+
+    void insertFreeBlock(uint32_t blockIndex) {
+        Block& block = m_blocks[blockIndex];
+        uint32_t firstLevel = 0u;
+        uint32_t secondLevel = 0u;
+        mapInsert(block.count, firstLevel, secondLevel);
+
+        uint32_t& head = m_freeHeads[firstLevel][secondLevel];
+        block.free = true;
+        block.tag = UINT32_MAX;
+        block.prevFree = kInvalidBlock;
+        block.nextFree = head;
+        if (head != kInvalidBlock) {
+            m_blocks[head].prevFree = blockIndex;
+        }
+        head = blockIndex;
+        m_firstLevelBitmap |= 1u << firstLevel;
+        m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+        ++m_freeBlockCount;
+    }
+
+    void removeFreeBlock(uint32_t blockIndex) {
+        Block& block = m_blocks[blockIndex];
+        if (block.parked) {
+            block.free = false;
+            block.parked = false;
+            return;
+        }
+
+        uint32_t firstLevel = 0u;
+        uint32_t secondLevel = 0u;
+        mapInsert(block.count, firstLevel, secondLevel);
+
+        if (block.prevFree != kInvalidBlock) {
+            m_blocks[block.prevFree].nextFree = block.nextFree;
+        } else {
+            m_freeHeads[firstLevel][secondLevel] = block.nextFree;
+        }
+        if (block.nextFree != kInvalidBlock) {
+            m_blocks[block.nextFree].prevFree = block.prevFree;
+        }
+        if (m_freeHeads[firstLevel][secondLevel] == kInvalidBlock) {
+            m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (m_secondLevelBitmaps[firstLevel] == 0u) {
+                m_firstLevelBitmap &= ~(1u << firstLevel);
+            }
+        }
+
+        block.free = false;
+        block.prevFree = kInvalidBlock;
+        block.nextFree = kInvalidBlock;
+        --m_freeBlockCount;
+    }
+
+    void parkFreeBlock(uint32_t blockIndex) {
+        Block& block = m_blocks[blockIndex];
+        block.free = true;
+        block.parked = true;
+        block.tag = UINT32_MAX;
+        block.prevFree = kInvalidBlock;
+        block.nextFree = kInvalidBlock;
+    }
+
+    // Merges a block that is in no free list with its free physical neighbours and
+    // returns the merged block, itself in no free list.
+    uint32_t coalesceFreeBlock(uint32_t blockIndex) {
+        const uint32_t prevIndex = m_blocks[blockIndex].prevPhysical;
+        if (prevIndex != kInvalidBlock && m_blocks[prevIndex].free) {
+            removeFreeBlock(prevIndex);
+            mergeIntoPrevious(prevIndex, blockIndex);
+            blockIndex = prevIndex;
+        }
+
+        const uint32_t nextIndex = m_blocks[blockIndex].nextPhysical;
+        if (nextIndex != kInvalidBlock && m_blocks[nextIndex].free) {
+            removeFreeBlock(nextIndex);
+            mergeIntoPrevious(blockIndex, nextIndex);
+        }
+        return blockIndex;
+    }
+
+    // Lists the part of a free block below the capacity and parks the rest.
+    void fileFreeBlock(uint32_t blockIndex) {
+        const Block& block = m_blocks[blockIndex];
+        if (block.offset >= m_capacityElements) {
+            parkFreeBlock(blockIndex);
+            return;
+        }
+        if (block.offset + block.count > m_capacityElements) {
+            const uint32_t parkedIndex = createBlock(m_capacityElements,
+                                                     block.offset + block.count - m_capacityElements);
+            Block& listed = m_blocks[blockIndex];
+            Block& parked = m_blocks[parkedIndex];
+            listed.count = m_capacityElements - listed.offset;
+            parked.prevPhysical = blockIndex;
+            parked.nextPhysical = listed.nextPhysical;
+            if (listed.nextPhysical != kInvalidBlock) {
+                m_blocks[listed.nextPhysical].prevPhysical = parkedIndex;
+            } else {
+                m_lastPhysicalBlock = parkedIndex;
+            }
+            listed.nextPhysical = parkedIndex;
+            parkFreeBlock(parkedIndex);
+        }
+        insertFreeBlock(blockIndex);
+    }
+
+    // Hands a parked block at the end back to the reservation. Parked blocks are
+    // merged, so there is at most one.
+    void trimParkedTail() {
+        const uint32_t tailIndex = m_lastPhysicalBlock;
+        if (tailIndex == kInvalidBlock || !m_blocks[tailIndex].parked) {
+            return;
+        }
+
+        const Block& tail = m_blocks[tailIndex];
+        m_managedElements = tail.offset;
+        m_lastPhysicalBlock = tail.prevPhysical;
+        if (tail.prevPhysical != kInvalidBlock) {
+            m_blocks[tail.prevPhysical].nextPhysical = kInvalidBlock;
+        }
+        m_blocks[tailIndex] = Block{};
+        m_unusedBlocks.push_back(tailIndex);
+    }
+
+    // Absorbs the physically following block into blockIndex and recycles it.
+    void mergeIntoPrevious(uint32_t blockIndex, uint32_t nextIndex) {
+        Block& block = m_blocks[blockIndex];
+        const Block& next = m_blocks[nextIndex];
+        block.count += next.count;
+        block.nextPhysical = next.nextPhysical;
+        if (next.nextPhysical != kInvalidBlock) {
+            m_blocks[next.nextPhysical].prevPhysical = blockIndex;
+        } else {
+            m_lastPhysicalBlock = blockIndex;
+        }
+        m_unusedBlocks.push_back(nextIndex);
+    }
+
     static uint64_t alignUp(uint64_t value, uint64_t alignment) {
         if (alignment == 0u) {
             return value;
@@ -275,14 +633,46 @@ private:
         return (value + alignment - 1u) & ~(alignment - 1u);
     }
 
+    bool createUploadFrame(RhiFrameGraphBackend& resourceFactory,
+                           uint32_t frameIndex,
+                           const char* debugNamePrefix) {
+        UploadFrame& uploadFrame = m_uploadFrames[frameIndex];
+
+        RhiBufferDesc desc{};
+        desc.size = static_cast<size_t>(m_maxUploadBytesPerFrame);
+        desc.memory = RhiBufferMemory::Upload;
+        desc.sharedWithTransferQueue = true;
+        const std::string debugName =
+            std::string(debugNamePrefix ? debugNamePrefix : "StreamingUpload") +
+            "[" + std::to_string(frameIndex) + "]";
+        desc.debugName = debugName.c_str();
+        RhiMemoryTagScope stagingTag(RhiMemoryTag::Staging);
+        uploadFrame.stagingBuffer = resourceFactory.createBuffer(desc);
+        uploadFrame.usedBytes = 0u;
+        uploadFrame.copyRegions.clear();
+        return uploadFrame.stagingBuffer && rhiBufferContents(*uploadFrame.stagingBuffer) != nullptr;
+    }
+
     void clearUploadState() {
         m_uploadFrames.clear();
         m_maxUploadBytesPerFrame = 0u;
     }
 
     std::unique_ptr<RhiBuffer> m_buffer;
+    uint32_t m_reservedElements = 0u;
     uint32_t m_capacityElements = 0u;
-    std::vector<Range> m_freeRanges;
+    // End of the range the blocks cover; above the capacity while overCommitted().
+    uint32_t m_managedElements = 0u;
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks;
+    std::unordered_map<uint32_t, uint32_t> m_allocatedBlocks;
+    std::array<std::array<uint32_t, kSecondLevelCount>, kFirstLevelCount> m_freeHeads{};
+    std::array<uint32_t, kFirstLevelCount> m_secondLevelBitmaps{};
+    uint32_t m_firstLevelBitmap = 0u;
+    uint32_t m_freeBlockCount = 0u;
+    uint32_t m_usedElements = 0u;
+    uint32_t m_lastPhysicalBlock = kInvalidBlock;
     std::vector<UploadFrame> m_uploadFrames;
     uint64_t m_maxUploadBytesPerFrame = 0u;
+    uint64_t m_uploadBudgetBytes = 0u;
 };
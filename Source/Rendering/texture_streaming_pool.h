@@ -0,0 +1,413 @@
+#pragma once
+
+#include "material_loader.h"
+#include "rhi_backend.h"
+#include "rhi_resource_utils.h"
+#include "texture_transcoder.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Keeps every scene texture resident at a small mip tail and promotes finer mips
+// from the CPU-side chain when deferred lighting reports that it samples them.
+// Each bindless slot maps to one texture whose top mip moves with residency. Swaps
+// recreate the texture; the replaced one is retired once in-flight frames finish.
+class TextureStreamingPool {
+public:
+    // Covers the deepest frame pipeline; feedback is applied every kApplyIntervalFrames,
+    // so reading it a few frames later is harmless. Replaced textures wait as long.
+    static constexpr uint32_t kBufferedFrameCount = kRhiMaxFramesInFlight;
+    static constexpr uint32_t kResidentTailDimension = 128u;
+    // Feedback stores log2(texels per UV) in 1/kFeedbackDensityScale steps.
+    static constexpr uint32_t kFeedbackDensityScale = 8u;
+    static constexpr uint32_t kRequestTimeoutFrames = 240u;
+    static constexpr uint32_t kApplyIntervalFrames = 15u;
+    static constexpr uint64_t kDefaultBudgetBytes = 512ull * 1024ull * 1024ull;
+    static constexpr uint64_t kMaxApplyBytes = 64ull * 1024ull * 1024ull;
+
+    struct Stats {
+        uint32_t textureCount = 0;
+        uint32_t fullyResidentCount = 0;
+        uint32_t pendingPromotions = 0;
+        uint32_t pendingDemotions = 0;
+        uint64_t residentBytes = 0;
+        uint64_t targetBytes = 0;
+        uint64_t budgetBytes = 0;
+        uint64_t uploadedBytesLastApply = 0;
+        bool streamingEnabled = false;
+    };
+
+    TextureStreamingPool() = default;
+    ~TextureStreamingPool() { release(); }
+
+    TextureStreamingPool(const TextureStreamingPool&) = delete;
+    TextureStreamingPool& operator=(const TextureStreamingPool&) = delete;
+
+    // sources[i] backs materials.textures[i]; empty chains leave the slot unbound.
+    // With deferTextureCreation the GPU textures are created by createTextures().
+    bool initialize(const RhiDevice& device,
+                    std::vector<TranscodedTexture>&& sources,
+                    LoadedMaterials& materials,
+                    bool streamingEnabled,
+                    bool deferTextureCreation = false) {
+        release();
+
+        m_materials = &materials;
+        m_streamingEnabled = streamingEnabled && !sources.empty();
+        m_entries.resize(sources.size());
+        materials.textures.resize(sources.size());
+
+        if (m_streamingEnabled) {
+            const size_t feedbackSize = m_entries.size() * sizeof(uint32_t);
+            std::vector<uint32_t> zeros(m_entries.size(), 0u);
+            for (uint32_t slot = 0; slot < kBufferedFrameCount; ++slot) {
+                m_feedbackBuffers[slot] =
+                    rhiCreateSharedBuffer(device, zeros.data(), feedbackSize, "TextureStreamingFeedback");
+                if (!m_feedbackBuffers[slot].nativeHandle()) {
+                    spdlog::warn("TextureStreamingPool: feedback buffer allocation failed, "
+                                 "keeping textures fully resident");
+                    m_streamingEnabled = false;
+                    break;
+                }
+            }
+            if (!m_streamingEnabled) {
+                for (RhiBufferHandle& buffer : m_feedbackBuffers) {
+                    rhiReleaseHandle(buffer);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < sources.size(); ++i) {
+            Entry& entry = m_entries[i];
+            entry.source = std::move(sources[i]);
+            if (entry.source.mips.empty()) {
+                continue;
+            }
+
+            const uint32_t mipCount = static_cast<uint32_t>(entry.source.mips.size());
+            entry.suffixBytes.assign(mipCount + 1u, 0u);
+            for (uint32_t mip = mipCount; mip-- > 0;) {
+                entry.suffixBytes[mip] = entry.suffixBytes[mip + 1u] + entry.source.mips[mip].size;
+            }
+
+            entry.tailMip = 0;
+            while (entry.tailMip + 1u < mipCount &&
+                   std::max(entry.source.mips[entry.tailMip].width,
+                            entry.source.mips[entry.tailMip].height) > kResidentTailDimension) {
+                ++entry.tailMip;
+            }
+
+            const uint32_t initialMip = m_streamingEnabled ? entry.tailMip : 0u;
+            entry.residentMip = initialMip;
+            entry.requestedMip = initialMip;
+            entry.targetMip = initialMip;
+        }
+
+        return deferTextureCreation || createTextures(device);
+    }
+
+    // Creates every texture at its initial mip. Uploads go through the device
+    // queue, so this runs on the render thread.
+    bool createTextures(const RhiDevice& device) {
+        bool ok = true;
+        for (uint32_t i = 0; i < m_entries.size(); ++i) {
+            if (m_entries[i].source.mips.empty()) {
+                continue;
+            }
+            if (!createResidentTexture(device, i, m_entries[i].targetMip)) {
+                spdlog::warn("TextureStreamingPool: failed to create texture {}", i);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void release() {
+        for (RhiBufferHandle& buffer : m_feedbackBuffers) {
+            rhiReleaseHandle(buffer);
+        }
+        for (RetiredTexture& retired : m_retiredTextures) {
+            rhiReleaseHandle(retired.texture);
+        }
+        m_retiredTextures.clear();
+        m_entries.clear();
+        m_materials = nullptr;
+        m_streamingEnabled = false;
+        m_activeSlot = 0;
+        m_frameIndex = 0;
+        m_lastTargetFrame = 0;
+        m_uploadedBytesLastApply = 0;
+    }
+
+    // Consumes the feedback written the last time this frame slot was in flight and
+    // releases textures no frame can still sample. Call after the slot's fence wait.
+    void beginFrame(uint32_t frameIndex) {
+        m_frameIndex = frameIndex;
+        m_activeSlot = frameIndex % kBufferedFrameCount;
+        releaseRetiredTextures(frameIndex);
+        if (!m_streamingEnabled || !m_feedbackBuffers[m_activeSlot].nativeHandle()) {
+            return;
+        }
+
+        auto* feedback = static_cast<uint32_t*>(rhiBufferContents(m_feedbackBuffers[m_activeSlot]));
+        if (!feedback) {
+            return;
+        }
+        for (uint32_t i = 0; i < m_entries.size(); ++i) {
+            const uint32_t value = feedback[i];
+            if (value == 0 || m_entries[i].source.mips.empty()) {
+                continue;
+            }
+            Entry& entry = m_entries[i];
+            entry.windowMip = std::min(entry.windowMip, mipForDensity(entry, value - 1u));
+            entry.lastRequestFrame = frameIndex;
+            entry.everRequested = true;
+        }
+        std::memset(feedback, 0, m_entries.size() * sizeof(uint32_t));
+    }
+
+    const RhiBuffer* feedbackBuffer() const {
+        if (!m_streamingEnabled) {
+            return nullptr;
+        }
+        const RhiBuffer& buffer = m_feedbackBuffers[m_activeSlot];
+        return buffer.nativeHandle() ? &buffer : nullptr;
+    }
+
+    // Refreshes residency targets every kApplyIntervalFrames and reports whether
+    // applyResidencyChanges has work to do.
+    bool prepareResidencyChanges(uint32_t frameIndex) {
+        if (!m_streamingEnabled || m_entries.empty() ||
+            frameIndex - m_lastTargetFrame < kApplyIntervalFrames) {
+            return false;
+        }
+        m_lastTargetFrame = frameIndex;
+        updateTargets(frameIndex);
+
+        for (const Entry& entry : m_entries) {
+            if (!entry.source.mips.empty() && entry.targetMip != entry.residentMip) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Recreates textures whose target mip changed and returns their indices so the
+    // caller can rewrite the matching bindless descriptors. Uploads are recorded into
+    // the current frame, so call before its first pass.
+    std::vector<uint32_t> applyResidencyChanges(const RhiDevice& device) {
+        std::vector<uint32_t> changed;
+        m_uploadedBytesLastApply = 0;
+        if (!m_streamingEnabled || !m_materials) {
+            return changed;
+        }
+
+        // Demote first so promotions never push residency past the budget.
+        for (uint32_t i = 0; i < m_entries.size(); ++i) {
+            Entry& entry = m_entries[i];
+            if (!entry.source.mips.empty() && entry.targetMip > entry.residentMip) {
+                if (createResidentTexture(device, i, entry.targetMip, true)) {
+                    changed.push_back(i);
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < m_entries.size(); ++i) {
+            Entry& entry = m_entries[i];
+            if (entry.source.mips.empty() || entry.targetMip >= entry.residentMip) {
+                continue;
+            }
+            const uint64_t uploadBytes = entry.suffixBytes[entry.targetMip];
+            if (m_uploadedBytesLastApply > 0 &&
+                m_uploadedBytesLastApply + uploadBytes > kMaxApplyBytes) {
+                continue;
+            }
+            if (createResidentTexture(device, i, entry.targetMip, true)) {
+                m_uploadedBytesLastApply += uploadBytes;
+                changed.push_back(i);
+            }
+        }
+        return changed;
+    }
+
+    void setBudgetBytes(uint64_t budgetBytes) { m_budgetBytes = budgetBytes; }
+    bool streamingEnabled() const { return m_streamingEnabled; }
+    uint32_t textureCount() const { return static_cast<uint32_t>(m_entries.size()); }
+    // Full chain backing materials.textures[index], whatever its residency.
+    const TranscodedTexture& source(uint32_t index) const { return m_entries[index].source; }
+
+    Stats stats() const {
+        Stats stats;
+        stats.budgetBytes = m_budgetBytes;
+        stats.uploadedBytesLastApply = m_uploadedBytesLastApply;
+        stats.streamingEnabled = m_streamingEnabled;
+        for (const Entry& entry : m_entries) {
+            if (entry.source.mips.empty()) {
+                continue;
+            }
+            stats.textureCount++;
+            stats.residentBytes += entry.suffixBytes[entry.residentMip];
+            stats.targetBytes += entry.suffixBytes[entry.targetMip];
+            if (entry.residentMip == 0) {
+                stats.fullyResidentCount++;
+            }
+            if (entry.targetMip < entry.residentMip) {
+                stats.pendingPromotions++;
+            } else if (entry.targetMip > entry.residentMip) {
+                stats.pendingDemotions++;
+            }
+        }
+        return stats;
+    }
+
+private:
+    struct Entry {
+        TranscodedTexture source;
+        std::vector<uint64_t> suffixBytes; // bytes of mips [i, end)
+        uint32_t tailMip = 0;
+        uint32_t residentMip = 0;
+        uint32_t requestedMip = 0;
+        uint32_t targetMip = 0;
+        uint32_t windowMip = UINT32_MAX;
+        uint32_t lastRequestFrame = 0;
+        bool everRequested = false;
+    };
+
+    static uint32_t mipForDensity(const Entry& entry, uint32_t density) {
+        const uint32_t topDimension = std::max(entry.source.width, entry.source.height);
+        const float topLog2 = std::log2(static_cast<float>(std::max(topDimension, 1u)));
+        const float wantedLog2 = static_cast<float>(density) / static_cast<float>(kFeedbackDensityScale);
+        const float mip = std::floor(std::max(topLog2 - wantedLog2, 0.0f));
+        return std::min(static_cast<uint32_t>(mip), entry.tailMip);
+    }
+
+    void updateTargets(uint32_t frameIndex) {
+        uint64_t usedBytes = 0;
+        std::vector<uint32_t> candidates;
+        candidates.reserve(m_entries.size());
+        for (uint32_t i = 0; i < m_entries.size(); ++i) {
+            Entry& entry = m_entries[i];
+            if (entry.source.mips.empty()) {
+                continue;
+            }
+            if (entry.windowMip != UINT32_MAX) {
+                // Hold the current level when feedback only wants one mip less,
+                // which keeps textures near a transition from thrashing.
+                entry.requestedMip = entry.windowMip == entry.residentMip + 1u
+                    ? entry.residentMip
+                    : entry.windowMip;
+            } else if (!entry.everRequested ||
+                       frameIndex - entry.lastRequestFrame > kRequestTimeoutFrames) {
+                entry.requestedMip = entry.tailMip;
+            }
+            entry.windowMip = UINT32_MAX;
+            entry.targetMip = entry.tailMip;
+            usedBytes += entry.suffixBytes[entry.tailMip];
+            if (entry.requestedMip < entry.tailMip) {
+                candidates.push_back(i);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+            const Entry& lhs = m_entries[a];
+            const Entry& rhs = m_entries[b];
+            if (lhs.lastRequestFrame != rhs.lastRequestFrame) {
+                return lhs.lastRequestFrame > rhs.lastRequestFrame;
+            }
+            return a < b;
+        });
+
+        for (uint32_t index : candidates) {
+            Entry& entry = m_entries[index];
+            const uint64_t tailBytes = entry.suffixBytes[entry.tailMip];
+            for (uint32_t mip = entry.requestedMip; mip < entry.tailMip; ++mip) {
+                const uint64_t extraBytes = entry.suffixBytes[mip] - tailBytes;
+                if (usedBytes + extraBytes <= m_budgetBytes) {
+                    entry.targetMip = mip;
+                    usedBytes += extraBytes;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Texture replaced by a residency swap; frames recorded before it may still sample it.
+    struct RetiredTexture {
+        RhiTextureHandle texture;
+        uint32_t retiredFrame = 0;
+    };
+
+    void releaseRetiredTextures(uint32_t frameIndex) {
+        auto expired = std::remove_if(m_retiredTextures.begin(),
+                                      m_retiredTextures.end(),
+                                      [frameIndex](RetiredTexture& retired) {
+                                          if (frameIndex - retired.retiredFrame < kBufferedFrameCount) {
+                                              return false;
+                                          }
+                                          rhiReleaseHandle(retired.texture);
+                                          return true;
+                                      });
+        m_retiredTextures.erase(expired, m_retiredTextures.end());
+    }
+
+    // stageUpload records the mip copies into the current frame instead of waiting
+    // on the queue; initial creation keeps the blocking path.
+    bool createResidentTexture(const RhiDevice& device,
+                               uint32_t index,
+                               uint32_t topMip,
+                               bool stageUpload = false) {
+        RhiMemoryTagScope textureTag(RhiMemoryTag::Textures);
+        Entry& entry = m_entries[index];
+        const TranscodedTexture& source = entry.source;
+        const uint32_t levelCount = static_cast<uint32_t>(source.mips.size()) - topMip;
+        const TranscodedMipLevel& top = source.mips[topMip];
+
+        RhiTextureHandle texture = rhiCreateTexture2D(device,
+                                                      top.width,
+                                                      top.height,
+                                                      source.format,
+                                                      levelCount > 1u,
+                                                      levelCount,
+                                                      RhiTextureStorageMode::Shared,
+                                                      RhiTextureUsage::ShaderRead);
+        if (!texture.nativeHandle()) {
+            return false;
+        }
+        for (uint32_t level = 0; level < levelCount; ++level) {
+            const TranscodedMipLevel& mip = source.mips[topMip + level];
+            const void* data = source.data.data() + mip.offset;
+            const size_t bytesPerRow = static_cast<size_t>(mip.bytesPerRow);
+            if (stageUpload) {
+                rhiStageTexture2D(texture, mip.width, mip.height, data, bytesPerRow, level);
+            } else {
+                rhiUploadTexture2D(texture, mip.width, mip.height, data, bytesPerRow, level);
+            }
+        }
+
+        // Replace in place so LoadedMaterials::textureViews pointers stay valid.
+        RhiTextureHandle& slot = m_materials->textures[index];
+        if (slot.nativeHandle()) {
+            m_retiredTextures.push_back({slot, m_frameIndex});
+        }
+        slot = texture;
+        entry.residentMip = topMip;
+        return true;
+    }
+
+    LoadedMaterials* m_materials = nullptr;
+    std::vector<Entry> m_entries;
+    std::array<RhiBufferHandle, kBufferedFrameCount> m_feedbackBuffers{};
+    std::vector<RetiredTexture> m_retiredTextures;
+    uint64_t m_budgetBytes = kDefaultBudgetBytes;
+    uint64_t m_uploadedBytesLastApply = 0;
+    uint32_t m_activeSlot = 0;
+    uint32_t m_frameIndex = 0;
+    uint32_t m_lastTargetFrame = 0;
+    bool m_streamingEnabled = false;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// What ViewportPickPass reads back for one pixel (viewport_pick.slang).
+// sceneNode is UINT32_MAX for sky and for samples that no longer resolve.
+struct GPUPickResult {
+    uint32_t sceneNode = UINT32_MAX;
+    uint32_t instance = UINT32_MAX;
+    uint32_t meshlet = UINT32_MAX;
+    uint32_t triangle = UINT32_MAX;
+};
+static_assert(sizeof(GPUPickResult) == 16, "GPUPickResult must match shader layout");
+
+// Click-to-select handshake between the editor and ViewportPickPass. The editor
+// sets a request in render-resolution pixels; the pass decodes that texel of the
+// visibility buffer and reads it back, and the result lands framesInFlight
+// frames later. A newer request replaces one that has not been recorded yet.
+struct ViewportPickState {
+    bool requested = false;
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    bool resultReady = false;
+    GPUPickResult result;
+};
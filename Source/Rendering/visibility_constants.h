@@ -9,6 +9,15 @@
 #define VISIBILITY_MESHLET_SHIFT (VISIBILITY_TRIANGLE_BITS + VISIBILITY_INSTANCE_BITS)
 #define VISIBILITY_MESHLET_MASK ((1u << (32u - VISIBILITY_MESHLET_SHIFT)) - 1u)
 
+// 64-bit encoding (METALLIC_VISIBILITY_64, RG32Uint target). x holds the full
+// instance ID; y holds the meshlet source bit, the scene or cluster-LOD meshlet
+// ID and the triangle, so decoding needs no visible-meshlet worklist lookup.
+#define VISIBILITY64_TRIANGLE_BITS 7u
+#define VISIBILITY64_TRIANGLE_MASK ((1u << VISIBILITY64_TRIANGLE_BITS) - 1u)
+#define VISIBILITY64_MESHLET_SHIFT VISIBILITY64_TRIANGLE_BITS
+#define VISIBILITY64_MESHLET_MASK ((1u << (31u - VISIBILITY64_MESHLET_SHIFT)) - 1u)
+#define VISIBILITY64_LOD_SOURCE_BIT (1u << 31u)
+
 #ifdef __cplusplus
 #include <cstdint>
 static constexpr uint32_t kVisibilityInstanceBits = VISIBILITY_INSTANCE_BITS;
@@ -17,6 +26,7 @@ static constexpr uint32_t kVisibilityTriangleBits = VISIBILITY_TRIANGLE_BITS;
 static constexpr uint32_t kVisibilityTriangleMask = VISIBILITY_TRIANGLE_MASK;
 static constexpr uint32_t kVisibilityMeshletShift = VISIBILITY_MESHLET_SHIFT;
 static constexpr uint32_t kVisibilityMeshletMask = VISIBILITY_MESHLET_MASK;
+static constexpr uint32_t kVisibility64MeshletMask = VISIBILITY64_MESHLET_MASK;
 #endif
 
 #endif
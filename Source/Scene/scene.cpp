@@ -1,160 +1,466 @@
 #include "scene.h"
 
-#include <json.hpp>
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include "startup_profile.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#define TINYGLTF_IMPLEMENTATION
-#include <tiny_gltf.h>
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
 
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <future>
+#include <memory>
+#include <type_traits>
 
 namespace {
 
+// cgltf file callbacks that map the .gltf/.glb/.bin files instead of reading
+// them into heap buffers, so accessor copies read straight from the page cache.
+struct MappedGltfFiles {
+    std::vector<std::unique_ptr<MappedFile>> files;
+};
+
+cgltf_result mapGltfFile(const cgltf_memory_options* /*memoryOptions*/,
+                         const cgltf_file_options* fileOptions,
+                         const char* path,
+                         cgltf_size* size,
+                         void** data) {
+    auto* mapped = static_cast<MappedGltfFiles*>(fileOptions->user_data);
+    auto file = std::make_unique<MappedFile>();
+    if (!file->open(std::filesystem::path(reinterpret_cast<const char8_t*>(path)))) {
+        return cgltf_result_file_not_found;
+    }
+    *size = file->size();
+    *data = const_cast<uint8_t*>(file->data());
+    mapped->files.push_back(std::move(file));
+    return cgltf_result_success;
+}
+
+void unmapGltfFile(const cgltf_memory_options* /*memoryOptions*/,
+                   const cgltf_file_options* fileOptions,
+                   void* data,
+                   cgltf_size /*size*/) {
+    auto* mapped = static_cast<MappedGltfFiles*>(fileOptions->user_data);
+    auto it = std::find_if(mapped->files.begin(), mapped->files.end(),
+                           [data](const std::unique_ptr<MappedFile>& file) {
+                               return file->data() == data;
+                           });
+    if (it != mapped->files.end()) {
+        mapped->files.erase(it);
+    }
+}
+
+class GltfDocument {
+public:
+    GltfDocument() = default;
+    ~GltfDocument() {
+        if (m_data) cgltf_free(m_data);
+    }
+
+    GltfDocument(const GltfDocument&) = delete;
+    GltfDocument& operator=(const GltfDocument&) = delete;
+
+    bool load(const std::string& path) {
+        cgltf_options options{};
+        options.file.read = &mapGltfFile;
+        options.file.release = &unmapGltfFile;
+        options.file.user_data = &m_files;
+
+        cgltf_result result = cgltf_parse_file(&options, path.c_str(), &m_data);
+        if (result != cgltf_result_success) {
+            spdlog::error("glTF parse error {}: {}", static_cast<int>(result), path);
+            return false;
+        }
+        result = cgltf_load_buffers(&options, m_data, path.c_str());
+        if (result != cgltf_result_success) {
+            spdlog::error("glTF buffer load error {}: {}", static_cast<int>(result), path);
+            return false;
+        }
+        // Accessor copies below read raw buffer ranges, so bounds must be checked.
+        result = cgltf_validate(m_data);
+        if (result != cgltf_result_success) {
+            spdlog::error("glTF validation error {}: {}", static_cast<int>(result), path);
+            return false;
+        }
+        return true;
+    }
+
+    const cgltf_data& data() const { return *m_data; }
+
+private:
+    MappedGltfFiles m_files;
+    cgltf_data* m_data = nullptr;
+};
+
 bool nearlyZero(double v, double eps = 1e-5) { return std::fabs(v) <= eps; }
 bool nearlyOne(double v, double eps = 1e-5) { return std::fabs(v - 1.0) <= eps; }
 
-bool isIdentityRotation(const tinygltf::Node& node, double eps = 1e-5) {
-    if (node.rotation.empty()) return true;
+bool isIdentityRotation(const cgltf_node& node, double eps = 1e-5) {
+    if (!node.has_rotation) return true;
     return nearlyZero(node.rotation[0], eps) &&
            nearlyZero(node.rotation[1], eps) &&
            nearlyZero(node.rotation[2], eps) &&
            nearlyOne(std::fabs(node.rotation[3]), eps);
 }
 
-bool hasIdentityTransform(const tinygltf::Node& node, double eps = 1e-5) {
-    if (!node.matrix.empty()) return false;
-    bool identityT = node.translation.empty() ||
+bool hasIdentityTransform(const cgltf_node& node, double eps = 1e-5) {
+    if (node.has_matrix) return false;
+    bool identityT = !node.has_translation ||
         (nearlyZero(node.translation[0], eps) &&
          nearlyZero(node.translation[1], eps) &&
          nearlyZero(node.translation[2], eps));
-    bool identityS = node.scale.empty() ||
+    bool identityS = !node.has_scale ||
         (nearlyOne(node.scale[0], eps) &&
          nearlyOne(node.scale[1], eps) &&
          nearlyOne(node.scale[2], eps));
     return identityT && isIdentityRotation(node, eps) && identityS;
 }
 
-bool descendantsHaveIdentityTransforms(const tinygltf::Model& model, int nodeIndex) {
-    const auto& node = model.nodes[nodeIndex];
-    for (int child : node.children) {
-        if (!hasIdentityTransform(model.nodes[child]) ||
-            !descendantsHaveIdentityTransforms(model, child))
+bool descendantsHaveIdentityTransforms(const cgltf_node& node) {
+    for (cgltf_size ci = 0; ci < node.children_count; ++ci) {
+        const cgltf_node& child = *node.children[ci];
+        if (!hasIdentityTransform(child) || !descendantsHaveIdentityTransforms(child))
             return false;
     }
     return true;
 }
 
-bool tryGetSingleRootBakeScale(const tinygltf::Model& model, float& outScale) {
-    outScale = 1.0f;
-    if (model.scenes.empty()) return false;
+// Reads EXT_mesh_gpu_instancing's TRANSLATION/ROTATION/SCALE accessors into one
+// column-major T * R * S matrix per instance. Missing attributes stay identity.
+void readGpuInstancing(const cgltf_mesh_gpu_instancing& instancing, std::vector<float>& outMatrices) {
+    const cgltf_accessor* translation = nullptr;
+    const cgltf_accessor* rotation = nullptr;
+    const cgltf_accessor* scale = nullptr;
+    cgltf_size count = 0;
+    for (cgltf_size ai = 0; ai < instancing.attributes_count; ++ai) {
+        const cgltf_attribute& attribute = instancing.attributes[ai];
+        if (!attribute.name || !attribute.data) continue;
+        if (std::strcmp(attribute.name, "TRANSLATION") == 0) translation = attribute.data;
+        else if (std::strcmp(attribute.name, "ROTATION") == 0) rotation = attribute.data;
+        else if (std::strcmp(attribute.name, "SCALE") == 0) scale = attribute.data;
+        else continue;
+        count = attribute.data->count;
+    }
 
-    int sceneIndex = model.defaultScene >= 0 ? model.defaultScene : 0;
-    const auto& scene = model.scenes[sceneIndex];
-    if (scene.nodes.size() != 1) return false;
+    outMatrices.resize(count * 16);
+    for (cgltf_size i = 0; i < count; ++i) {
+        float t[3] = {0, 0, 0};
+        float q[4] = {0, 0, 0, 1};
+        float s[3] = {1, 1, 1};
+        if (translation) cgltf_accessor_read_float(translation, i, t, 3);
+        if (rotation) cgltf_accessor_read_float(rotation, i, q, 4);
+        if (scale) cgltf_accessor_read_float(scale, i, s, 3);
+
+        const float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+        const float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+        const float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+        float* m = outMatrices.data() + i * 16;
+        m[0] = (1.0f - 2.0f * (yy + zz)) * s[0];
+        m[1] = 2.0f * (xy + wz) * s[0];
+        m[2] = 2.0f * (xz - wy) * s[0];
+        m[3] = 0.0f;
+        m[4] = 2.0f * (xy - wz) * s[1];
+        m[5] = (1.0f - 2.0f * (xx + zz)) * s[1];
+        m[6] = 2.0f * (yz + wx) * s[1];
+        m[7] = 0.0f;
+        m[8] = 2.0f * (xz + wy) * s[2];
+        m[9] = 2.0f * (yz - wx) * s[2];
+        m[10] = (1.0f - 2.0f * (xx + yy)) * s[2];
+        m[11] = 0.0f;
+        m[12] = t[0];
+        m[13] = t[1];
+        m[14] = t[2];
+        m[15] = 1.0f;
+    }
+}
 
-    const auto& root = model.nodes[scene.nodes[0]];
-    if (!root.matrix.empty()) return false;
+const cgltf_scene* defaultScene(const cgltf_data& data) {
+    if (data.scene) return data.scene;
+    return data.scenes_count > 0 ? &data.scenes[0] : nullptr;
+}
 
-    bool hasNonUniformScale = false;
-    if (!root.scale.empty()) {
+bool tryGetSingleRootBakeScale(const cgltf_data& data, float& outScale) {
+    outScale = 1.0f;
+    const cgltf_scene* scene = defaultScene(data);
+    if (!scene || scene->nodes_count != 1) return false;
+
+    const cgltf_node& root = *scene->nodes[0];
+    if (root.has_matrix) return false;
+
+    if (root.has_scale) {
         double sx = root.scale[0], sy = root.scale[1], sz = root.scale[2];
         if (!nearlyOne(sx) || !nearlyOne(sy) || !nearlyOne(sz)) {
-            if (nearlyZero(sx - sy) && nearlyZero(sy - sz)) {
-                hasNonUniformScale = false;
-            } else {
+            if (!(nearlyZero(sx - sy) && nearlyZero(sy - sz)))
                 return false;
-            }
         }
     }
 
-    bool hasTranslation = !root.translation.empty() &&
+    bool hasTranslation = root.has_translation &&
         !(nearlyZero(root.translation[0]) && nearlyZero(root.translation[1]) && nearlyZero(root.translation[2]));
     bool hasRotation = !isIdentityRotation(root);
 
     if (hasTranslation || hasRotation) return false;
 
-    if (root.scale.empty() || (nearlyOne(root.scale[0]) && nearlyOne(root.scale[1]) && nearlyOne(root.scale[2])))
+    if (!root.has_scale || (nearlyOne(root.scale[0]) && nearlyOne(root.scale[1]) && nearlyOne(root.scale[2])))
         return false;
 
-    if (!descendantsHaveIdentityTransforms(model, scene.nodes[0]))
+    if (!descendantsHaveIdentityTransforms(root))
         return false;
 
-    outScale = static_cast<float>(root.scale[0]);
+    outScale = root.scale[0];
     return true;
 }
 
-template <typename T>
-const T* accessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
-    const auto& bv = model.bufferViews[accessor.bufferView];
-    const auto& buf = model.buffers[bv.buffer];
-    return reinterpret_cast<const T*>(buf.data.data() + bv.byteOffset + accessor.byteOffset);
+const cgltf_accessor* findAttribute(const cgltf_primitive& prim, cgltf_attribute_type type) {
+    for (cgltf_size ai = 0; ai < prim.attributes_count; ++ai) {
+        const cgltf_attribute& attr = prim.attributes[ai];
+        if (attr.type == type && attr.index == 0) return attr.data;
+    }
+    return nullptr;
 }
 
-int accessorStride(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
-    const auto& bv = model.bufferViews[accessor.bufferView];
-    if (bv.byteStride > 0) return static_cast<int>(bv.byteStride);
-    int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
-    int numComponents = tinygltf::GetNumComponentsInType(accessor.type);
-    return componentSize * numComponents;
+const uint8_t* accessorBase(const cgltf_accessor& accessor) {
+    if (accessor.is_sparse || !accessor.buffer_view) return nullptr;
+    const uint8_t* view = cgltf_buffer_view_data(accessor.buffer_view);
+    return view ? view + accessor.offset : nullptr;
 }
 
-void readFloatAccessor(const tinygltf::Model& model, int accessorIndex,
-                       std::vector<float>& out, int expectedComponents) {
-    if (accessorIndex < 0) return;
-    const auto& acc = model.accessors[accessorIndex];
-    const auto& bv = model.bufferViews[acc.bufferView];
-    const auto& buf = model.buffers[bv.buffer];
-    const uint8_t* base = buf.data.data() + bv.byteOffset + acc.byteOffset;
-    int stride = accessorStride(model, acc);
-    int numComp = tinygltf::GetNumComponentsInType(acc.type);
-    int readComp = std::min(numComp, expectedComponents);
-
-    size_t startOut = out.size();
-    out.resize(startOut + acc.count * expectedComponents);
-
-    for (size_t i = 0; i < acc.count; ++i) {
-        const float* src = reinterpret_cast<const float*>(base + i * stride);
-        for (int c = 0; c < readComp; ++c)
-            out[startOut + i * expectedComponents + c] = src[c];
-        for (int c = readComp; c < expectedComponents; ++c)
-            out[startOut + i * expectedComponents + c] = 0.0f;
+// Writes count elements of outComponents floats into dst, zero-filling missing
+// components. Tightly packed float streams are a single memcpy.
+void copyFloatAccessor(const cgltf_accessor& accessor, size_t count,
+                       float* dst, size_t outComponents) {
+    const size_t numComp = cgltf_num_components(accessor.type);
+    const size_t readComp = std::min(numComp, outComponents);
+    const uint8_t* base = accessorBase(accessor);
+
+    if (base && accessor.component_type == cgltf_component_type_r_32f && !accessor.normalized) {
+        const size_t stride = accessor.stride;
+        if (numComp == outComponents && stride == outComponents * sizeof(float)) {
+            std::memcpy(dst, base, count * stride);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            float* out = dst + i * outComponents;
+            std::memcpy(out, base + i * stride, readComp * sizeof(float));
+            std::fill(out + readComp, out + outComponents, 0.0f);
+        }
+        return;
     }
+
+    // Quantized, normalized and sparse accessors go through cgltf's converters.
+    if (accessor.is_sparse) {
+        std::vector<float> unpacked(accessor.count * numComp);
+        cgltf_accessor_unpack_floats(&accessor, unpacked.data(), unpacked.size());
+        for (size_t i = 0; i < count; ++i) {
+            float* out = dst + i * outComponents;
+            std::memcpy(out, unpacked.data() + i * numComp, readComp * sizeof(float));
+            std::fill(out + readComp, out + outComponents, 0.0f);
+        }
+        return;
+    }
+
+    float element[16];
+    for (size_t i = 0; i < count; ++i) {
+        float* out = dst + i * outComponents;
+        cgltf_accessor_read_float(&accessor, i, element, numComp);
+        std::memcpy(out, element, readComp * sizeof(float));
+        std::fill(out + readComp, out + outComponents, 0.0f);
+    }
+}
+
+template <typename T>
+void copyIndices(const uint8_t* base, size_t stride, size_t count,
+                 uint32_t* dst, uint32_t vertexOffset) {
+    for (size_t i = 0; i < count; ++i) {
+        T index;
+        std::memcpy(&index, base + i * stride, sizeof(T));
+        dst[i] = static_cast<uint32_t>(index) + vertexOffset;
+    }
+}
+
+void copyIndexAccessor(const cgltf_accessor& accessor, uint32_t* dst, uint32_t vertexOffset) {
+    const uint8_t* base = accessorBase(accessor);
+    if (base) {
+        switch (accessor.component_type) {
+            case cgltf_component_type_r_8u:
+                copyIndices<uint8_t>(base, accessor.stride, accessor.count, dst, vertexOffset);
+                return;
+            case cgltf_component_type_r_16u:
+                copyIndices<uint16_t>(base, accessor.stride, accessor.count, dst, vertexOffset);
+                return;
+            case cgltf_component_type_r_32u:
+                copyIndices<uint32_t>(base, accessor.stride, accessor.count, dst, vertexOffset);
+                return;
+            default:
+                break;
+        }
+    }
+    for (size_t i = 0; i < accessor.count; ++i)
+        dst[i] = static_cast<uint32_t>(cgltf_accessor_read_index(&accessor, i)) + vertexOffset;
+}
+
+int textureImageIndex(const cgltf_data& data, const cgltf_texture_view& view) {
+    if (!view.texture || !view.texture->image) return -1;
+    return static_cast<int>(cgltf_image_index(&data, view.texture->image));
+}
+
+bool decodeImagePixels(const uint8_t* encoded, size_t size, SceneImage& si) {
+    int w, h, ch;
+    uint8_t* px = stbi_load_from_memory(encoded, static_cast<int>(size), &w, &h, &ch, 4);
+    if (!px) return false;
+    si.width = w;
+    si.height = h;
+    si.channels = 4;
+    si.pixels.assign(px, px + static_cast<size_t>(w) * static_cast<size_t>(h) * 4);
+    stbi_image_free(px);
+    return true;
 }
 
-void readIndexAccessor(const tinygltf::Model& model, int accessorIndex,
-                       std::vector<uint32_t>& out, uint32_t vertexOffset) {
-    if (accessorIndex < 0) return;
-    const auto& acc = model.accessors[accessorIndex];
-    const auto& bv = model.bufferViews[acc.bufferView];
-    const auto& buf = model.buffers[bv.buffer];
-    const uint8_t* base = buf.data.data() + bv.byteOffset + acc.byteOffset;
-    int stride = accessorStride(model, acc);
-
-    size_t startOut = out.size();
-    out.resize(startOut + acc.count);
-
-    for (size_t i = 0; i < acc.count; ++i) {
-        const uint8_t* ptr = base + i * stride;
-        uint32_t idx = 0;
-        switch (acc.componentType) {
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  idx = *ptr; break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: idx = *reinterpret_cast<const uint16_t*>(ptr); break;
-            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   idx = *reinterpret_cast<const uint32_t*>(ptr); break;
-            default: break;
+bool decodeDataUriImage(const char* uri, SceneImage& si) {
+    const char* payload = std::strstr(uri, ";base64,");
+    if (!payload) return false;
+    payload += 8;
+
+    size_t length = std::strlen(payload);
+    size_t padding = 0;
+    while (padding < 2 && length > padding && payload[length - 1 - padding] == '=') ++padding;
+    const size_t size = length / 4 * 3 - padding;
+
+    cgltf_options options{};
+    void* decoded = nullptr;
+    if (cgltf_load_buffer_base64(&options, size, payload, &decoded) != cgltf_result_success)
+        return false;
+    bool ok = decodeImagePixels(static_cast<const uint8_t*>(decoded), size, si);
+    std::free(decoded);
+    return ok;
+}
+
+std::vector<SceneImage> decodeImages(const cgltf_data& data,
+                                     const std::filesystem::path& baseDir) {
+    std::vector<SceneImage> images(data.images_count);
+    Parallel::parallelFor(data.images_count, [&](size_t ii) {
+        const cgltf_image& gltfImage = data.images[ii];
+        auto& si = images[ii];
+
+        if (gltfImage.buffer_view) {
+            const uint8_t* encoded = cgltf_buffer_view_data(gltfImage.buffer_view);
+            if (!encoded || !decodeImagePixels(encoded, gltfImage.buffer_view->size, si))
+                spdlog::warn("Failed to decode embedded image {}", ii);
+        } else if (gltfImage.uri && std::strncmp(gltfImage.uri, "data:", 5) == 0) {
+            if (!decodeDataUriImage(gltfImage.uri, si))
+                spdlog::warn("Failed to decode data URI image {}", ii);
+        } else if (gltfImage.uri) {
+            std::string relative = gltfImage.uri;
+            relative.resize(cgltf_decode_uri(relative.data()));
+            si.uri = (baseDir / relative).string();
+            int w, h, ch;
+            uint8_t* px = stbi_load(si.uri.c_str(), &w, &h, &ch, 4);
+            if (px) {
+                si.width = w;
+                si.height = h;
+                si.channels = 4;
+                si.pixels.assign(px, px + static_cast<size_t>(w) * static_cast<size_t>(h) * 4);
+                stbi_image_free(px);
+            } else {
+                spdlog::warn("Failed to load image: {}", si.uri);
+            }
         }
-        out[startOut + i] = idx + vertexOffset;
+    });
+    return images;
+}
+
+// Where one primitive's vertices and indices land in the flattened scene arrays.
+struct PrimitiveCopyJob {
+    const cgltf_primitive* primitive = nullptr;
+    const cgltf_accessor* positions = nullptr;
+    const cgltf_accessor* normals = nullptr;
+    const cgltf_accessor* uvs = nullptr;
+    const cgltf_accessor* joints = nullptr;
+    const cgltf_accessor* weights = nullptr;
+    uint32_t vertexOffset = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexOffset = 0;
+    uint32_t indexCount = 0;
+    uint32_t morphDeltaOffset = 0;
+};
+
+void copyJointAccessor(const cgltf_accessor& accessor, size_t count, uint16_t* dst) {
+    cgltf_uint joints[4];
+    for (size_t i = 0; i < count; ++i) {
+        std::fill(joints, joints + 4, 0u);
+        cgltf_accessor_read_uint(&accessor, i, joints, 4);
+        for (int j = 0; j < 4; ++j)
+            dst[i * 4 + j] = static_cast<uint16_t>(joints[j]);
     }
 }
 
-int findAccessorIndex(const tinygltf::Primitive& prim, const std::string& attr) {
-    auto it = prim.attributes.find(attr);
-    return (it != prim.attributes.end()) ? it->second : -1;
+void readSkin(const cgltf_data& data, const cgltf_skin& gltfSkin, SceneSkin& skin) {
+    skin.name = gltfSkin.name ? gltfSkin.name : "";
+    skin.joints.resize(gltfSkin.joints_count);
+    for (cgltf_size ji = 0; ji < gltfSkin.joints_count; ++ji)
+        skin.joints[ji] = static_cast<int>(cgltf_node_index(&data, gltfSkin.joints[ji]));
+
+    skin.inverseBindMatrices.assign(gltfSkin.joints_count * 16, 0.0f);
+    for (cgltf_size ji = 0; ji < gltfSkin.joints_count; ++ji) {
+        float* m = skin.inverseBindMatrices.data() + ji * 16;
+        m[0] = m[5] = m[10] = m[15] = 1.0f;
+    }
+    if (gltfSkin.inverse_bind_matrices) {
+        copyFloatAccessor(*gltfSkin.inverse_bind_matrices,
+                          std::min(gltfSkin.inverse_bind_matrices->count, gltfSkin.joints_count),
+                          skin.inverseBindMatrices.data(), 16);
+    }
+}
+
+void readAnimation(const cgltf_data& data, const cgltf_animation& gltfAnimation, SceneAnimation& animation) {
+    animation.name = gltfAnimation.name ? gltfAnimation.name : "";
+    animation.samplers.resize(gltfAnimation.samplers_count);
+    for (cgltf_size si = 0; si < gltfAnimation.samplers_count; ++si) {
+        const cgltf_animation_sampler& gs = gltfAnimation.samplers[si];
+        SceneAnimationSampler& sampler = animation.samplers[si];
+        switch (gs.interpolation) {
+            case cgltf_interpolation_type_step:         sampler.interpolation = SceneAnimationSampler::Step; break;
+            case cgltf_interpolation_type_cubic_spline: sampler.interpolation = SceneAnimationSampler::CubicSpline; break;
+            default:                                    sampler.interpolation = SceneAnimationSampler::Linear; break;
+        }
+        if (!gs.input || !gs.output || gs.input->count == 0) continue;
+
+        sampler.times.resize(gs.input->count);
+        copyFloatAccessor(*gs.input, gs.input->count, sampler.times.data(), 1);
+        const size_t numComp = cgltf_num_components(gs.output->type);
+        sampler.values.resize(gs.output->count * numComp);
+        copyFloatAccessor(*gs.output, gs.output->count, sampler.values.data(), numComp);
+
+        const size_t valuesPerKey = sampler.interpolation == SceneAnimationSampler::CubicSpline ? 3 : 1;
+        sampler.components = static_cast<uint32_t>(sampler.values.size() / (sampler.times.size() * valuesPerKey));
+        animation.duration = std::max(animation.duration, sampler.times.back());
+    }
+
+    for (cgltf_size ci = 0; ci < gltfAnimation.channels_count; ++ci) {
+        const cgltf_animation_channel& gc = gltfAnimation.channels[ci];
+        if (!gc.target_node || !gc.sampler) continue;
+        SceneAnimationChannel channel;
+        switch (gc.target_path) {
+            case cgltf_animation_path_type_translation: channel.path = SceneAnimationChannel::Translation; break;
+            case cgltf_animation_path_type_rotation:    channel.path = SceneAnimationChannel::Rotation; break;
+            case cgltf_animation_path_type_scale:       channel.path = SceneAnimationChannel::Scale; break;
+            case cgltf_animation_path_type_weights:     channel.path = SceneAnimationChannel::Weights; break;
+            default: continue;
+        }
+        channel.sampler = static_cast<uint32_t>(cgltf_animation_sampler_index(&gltfAnimation, gc.sampler));
+        channel.node = static_cast<int>(cgltf_node_index(&data, gc.target_node));
+        if (animation.samplers[channel.sampler].components == 0) continue;
+        animation.channels.push_back(channel);
+    }
 }
 
 } // namespace
@@ -164,6 +470,9 @@ void Scene::clear() {
     normals.clear();
     uvs.clear();
     indices.clear();
+    skinJoints.clear();
+    skinWeights.clear();
+    morphDeltas.clear();
     primitives.clear();
     meshInfos.clear();
     materials.clear();
@@ -172,6 +481,8 @@ void Scene::clear() {
     rootNodes.clear();
     cameras.clear();
     lights.clear();
+    skins.clear();
+    animations.clear();
     std::memset(bboxMin, 0, sizeof(bboxMin));
     std::memset(bboxMax, 0, sizeof(bboxMax));
     hasBakedRootScale = false;
@@ -180,104 +491,178 @@ void Scene::clear() {
     m_filePath.clear();
 }
 
+size_t Scene::releaseBulkData() {
+    size_t freedBytes = 0;
+    auto release = [&freedBytes](auto& values) {
+        using Element = typename std::remove_reference_t<decltype(values)>::value_type;
+        freedBytes += values.capacity() * sizeof(Element);
+        values.clear();
+        values.shrink_to_fit();
+    };
+    release(positions);
+    release(normals);
+    release(uvs);
+    release(indices);
+    release(skinJoints);
+    release(skinWeights);
+    release(morphDeltas);
+    for (SceneImage& image : images) {
+        release(image.pixels);
+    }
+    return freedBytes;
+}
+
 bool Scene::load(const std::string& gltfPath) {
+    StartupProfile::Phase phase("Scene::load");
     clear();
 
-    tinygltf::Model model;
-    tinygltf::TinyGLTF loader;
-    std::string err, warn;
-
-    loader.SetImageLoader(nullptr, nullptr);
-
-    bool ok = false;
-    if (gltfPath.size() >= 4 && gltfPath.substr(gltfPath.size() - 4) == ".glb") {
-        ok = loader.LoadBinaryFromFile(&model, &err, &warn, gltfPath);
-    } else {
-        ok = loader.LoadASCIIFromFile(&model, &err, &warn, gltfPath);
-    }
-
-    if (!warn.empty()) spdlog::warn("glTF warning: {}", warn);
-    if (!err.empty()) spdlog::error("glTF error: {}", err);
-    if (!ok) {
+    GltfDocument document;
+    if (!document.load(gltfPath)) {
         spdlog::error("Failed to load glTF: {}", gltfPath);
         return false;
     }
+    const cgltf_data& data = document.data();
 
     m_filePath = gltfPath;
     std::filesystem::path baseDir = std::filesystem::path(gltfPath).parent_path();
 
-    // --- Parse meshes (geometry) ---
+    // Image decode is independent of geometry and materials, so it runs on a
+    // separate thread (fanned out per image) while the rest of the model parses.
+    std::future<std::vector<SceneImage>> imageDecode = std::async(
+        std::launch::async, [&data, baseDir]() { return decodeImages(data, baseDir); });
+
+    // --- Lay out meshes (geometry) ---
+    // Offsets are assigned up front so the destination arrays are sized once and
+    // every primitive copies straight from the mapped buffers into its own range.
     float bMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
     float bMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
-    uint32_t totalPrimitives = 0;
-
-    meshInfos.resize(model.meshes.size());
-    for (int mi = 0; mi < static_cast<int>(model.meshes.size()); ++mi) {
-        const auto& mesh = model.meshes[mi];
+    std::vector<PrimitiveCopyJob> jobs;
+    uint32_t totalVertices = 0;
+    uint32_t totalIndices = 0;
+    size_t totalMorphDeltas = 0;
+    bool anySkinned = false;
+
+    meshInfos.resize(data.meshes_count);
+    for (cgltf_size mi = 0; mi < data.meshes_count; ++mi) {
+        const cgltf_mesh& mesh = data.meshes[mi];
         meshInfos[mi].firstPrimitive = static_cast<uint32_t>(primitives.size());
 
-        for (const auto& prim : mesh.primitives) {
-            if (prim.mode != TINYGLTF_MODE_TRIANGLES && prim.mode != -1)
+        for (cgltf_size pi = 0; pi < mesh.primitives_count; ++pi) {
+            const cgltf_primitive& prim = mesh.primitives[pi];
+            if (prim.type != cgltf_primitive_type_triangles)
                 continue;
 
-            int posAccessor = findAccessorIndex(prim, "POSITION");
-            if (posAccessor < 0) continue;
-
-            uint32_t vertexOffset = static_cast<uint32_t>(positions.size() / 3);
-            uint32_t vertexCountBefore = vertexOffset;
-
-            readFloatAccessor(model, posAccessor, positions, 3);
-            uint32_t vertexCount = static_cast<uint32_t>(positions.size() / 3) - vertexCountBefore;
-
-            readFloatAccessor(model, findAccessorIndex(prim, "NORMAL"), normals, 3);
-            if (normals.size() / 3 < positions.size() / 3) {
-                normals.resize(positions.size(), 0.0f);
-            }
-
-            readFloatAccessor(model, findAccessorIndex(prim, "TEXCOORD_0"), uvs, 2);
-            if (uvs.size() / 2 < positions.size() / 3) {
-                uvs.resize((positions.size() / 3) * 2, 0.0f);
-            }
-
-            uint32_t indexOffset = static_cast<uint32_t>(indices.size());
-            uint32_t indexCount = 0;
-            if (prim.indices >= 0) {
-                readIndexAccessor(model, prim.indices, indices, vertexOffset);
-                indexCount = static_cast<uint32_t>(indices.size()) - indexOffset;
-            } else {
-                indexCount = vertexCount;
-                indices.reserve(indices.size() + vertexCount);
-                for (uint32_t vi = 0; vi < vertexCount; ++vi)
-                    indices.push_back(vertexOffset + vi);
+            const cgltf_accessor* posAccessor = findAttribute(prim, cgltf_attribute_type_position);
+            if (!posAccessor) continue;
+
+            PrimitiveCopyJob job;
+            job.primitive = &prim;
+            job.positions = posAccessor;
+            job.normals = findAttribute(prim, cgltf_attribute_type_normal);
+            job.uvs = findAttribute(prim, cgltf_attribute_type_texcoord);
+            job.joints = findAttribute(prim, cgltf_attribute_type_joints);
+            job.weights = findAttribute(prim, cgltf_attribute_type_weights);
+            if (!job.joints || !job.weights) {
+                job.joints = nullptr;
+                job.weights = nullptr;
             }
+            job.vertexOffset = totalVertices;
+            job.vertexCount = static_cast<uint32_t>(posAccessor->count);
+            job.indexOffset = totalIndices;
+            job.indexCount = prim.indices ? static_cast<uint32_t>(prim.indices->count) : job.vertexCount;
+            totalVertices += job.vertexCount;
+            totalIndices += job.indexCount;
 
             // Update bounds
-            const auto& posAcc = model.accessors[posAccessor];
-            if (posAcc.minValues.size() >= 3 && posAcc.maxValues.size() >= 3) {
+            if (posAccessor->has_min && posAccessor->has_max) {
                 for (int a = 0; a < 3; ++a) {
-                    bMin[a] = std::min(bMin[a], static_cast<float>(posAcc.minValues[a]));
-                    bMax[a] = std::max(bMax[a], static_cast<float>(posAcc.maxValues[a]));
+                    bMin[a] = std::min(bMin[a], posAccessor->min[a]);
+                    bMax[a] = std::max(bMax[a], posAccessor->max[a]);
                 }
             }
 
             ScenePrimitive sp;
-            sp.vertexOffset = vertexOffset;
-            sp.vertexCount = vertexCount;
-            sp.indexOffset = indexOffset;
-            sp.indexCount = indexCount;
-            sp.materialIndex = (prim.material >= 0) ? static_cast<uint32_t>(prim.material) : 0;
-            sp.meshID = mi;
+            sp.vertexOffset = job.vertexOffset;
+            sp.vertexCount = job.vertexCount;
+            sp.indexOffset = job.indexOffset;
+            sp.indexCount = job.indexCount;
+            sp.materialIndex = prim.material
+                ? static_cast<uint32_t>(cgltf_material_index(&data, prim.material)) : 0;
+            sp.meshID = static_cast<int>(mi);
+            sp.skinned = job.joints != nullptr;
+            anySkinned |= sp.skinned;
+            if (prim.targets_count > 0) {
+                job.morphDeltaOffset = static_cast<uint32_t>(totalMorphDeltas);
+                sp.morphDeltaOffset = job.morphDeltaOffset;
+                sp.morphTargetCount = static_cast<uint32_t>(prim.targets_count);
+                totalMorphDeltas += prim.targets_count * static_cast<size_t>(job.vertexCount) * 6;
+            }
             primitives.push_back(sp);
-            ++totalPrimitives;
+            jobs.push_back(job);
         }
 
         meshInfos[mi].primitiveCount =
             static_cast<uint32_t>(primitives.size()) - meshInfos[mi].firstPrimitive;
     }
 
-    // Bake single-root scale
+    positions.resize(static_cast<size_t>(totalVertices) * 3);
+    normals.assign(static_cast<size_t>(totalVertices) * 3, 0.0f);
+    uvs.assign(static_cast<size_t>(totalVertices) * 2, 0.0f);
+    indices.resize(totalIndices);
+    if (anySkinned) {
+        skinJoints.assign(static_cast<size_t>(totalVertices) * 4, 0);
+        skinWeights.assign(static_cast<size_t>(totalVertices) * 4, 0.0f);
+    }
+    morphDeltas.assign(totalMorphDeltas, 0.0f);
+
+    Parallel::parallelFor(jobs.size(), [&](size_t ji) {
+        const PrimitiveCopyJob& job = jobs[ji];
+        copyFloatAccessor(*job.positions, job.vertexCount,
+                          positions.data() + static_cast<size_t>(job.vertexOffset) * 3, 3);
+        if (job.normals) {
+            copyFloatAccessor(*job.normals, std::min<size_t>(job.normals->count, job.vertexCount),
+                              normals.data() + static_cast<size_t>(job.vertexOffset) * 3, 3);
+        }
+        if (job.uvs) {
+            copyFloatAccessor(*job.uvs, std::min<size_t>(job.uvs->count, job.vertexCount),
+                              uvs.data() + static_cast<size_t>(job.vertexOffset) * 2, 2);
+        }
+        if (job.joints) {
+            const size_t count = std::min<size_t>({job.joints->count, job.weights->count, job.vertexCount});
+            copyJointAccessor(*job.joints, count,
+                              skinJoints.data() + static_cast<size_t>(job.vertexOffset) * 4);
+            copyFloatAccessor(*job.weights, count,
+                              skinWeights.data() + static_cast<size_t>(job.vertexOffset) * 4, 4);
+        }
+        for (cgltf_size ti = 0; ti < job.primitive->targets_count; ++ti) {
+            const cgltf_morph_target& target = job.primitive->targets[ti];
+            float* dst = morphDeltas.data() + job.morphDeltaOffset + ti * static_cast<size_t>(job.vertexCount) * 6;
+            for (cgltf_size ai = 0; ai < target.attributes_count; ++ai) {
+                const cgltf_attribute& attr = target.attributes[ai];
+                if (attr.index != 0 || !attr.data) continue;
+                const size_t count = std::min<size_t>(attr.data->count, job.vertexCount);
+                if (attr.type == cgltf_attribute_type_position)
+                    copyFloatAccessor(*attr.data, count, dst, 3);
+                else if (attr.type == cgltf_attribute_type_normal)
+                    copyFloatAccessor(*attr.data, count, dst + static_cast<size_t>(job.vertexCount) * 3, 3);
+            }
+        }
+
+        uint32_t* dstIndices = indices.data() + job.indexOffset;
+        if (job.primitive->indices) {
+            copyIndexAccessor(*job.primitive->indices, dstIndices, job.vertexOffset);
+        } else {
+            for (uint32_t vi = 0; vi < job.vertexCount; ++vi)
+                dstIndices[vi] = job.vertexOffset + vi;
+        }
+    });
+    const uint32_t totalPrimitives = static_cast<uint32_t>(primitives.size());
+
+    // Bake single-root scale. Skins, morph deltas and animated roots are authored
+    // against the unscaled geometry, so files that use them keep the root scale.
     float bakeScale = 1.0f;
-    if (tryGetSingleRootBakeScale(model, bakeScale)) {
+    const bool deformable = data.skins_count > 0 || totalMorphDeltas > 0 || data.animations_count > 0;
+    if (!deformable && tryGetSingleRootBakeScale(data, bakeScale)) {
         for (float& p : positions) p *= bakeScale;
         for (int a = 0; a < 3; ++a) {
             bMin[a] *= bakeScale;
@@ -294,152 +679,126 @@ bool Scene::load(const std::string& gltfPath) {
     }
 
     // --- Parse materials ---
-    materials.resize(std::max<size_t>(model.materials.size(), 1));
-    for (int mi = 0; mi < static_cast<int>(model.materials.size()); ++mi) {
-        const auto& mat = model.materials[mi];
+    materials.resize(std::max<size_t>(data.materials_count, 1));
+    for (cgltf_size mi = 0; mi < data.materials_count; ++mi) {
+        const cgltf_material& mat = data.materials[mi];
         auto& sm = materials[mi];
 
-        const auto& pbr = mat.pbrMetallicRoughness;
+        const auto& pbr = mat.pbr_metallic_roughness;
         for (int c = 0; c < 4; ++c)
-            sm.baseColorFactor[c] = static_cast<float>(pbr.baseColorFactor[c]);
-        sm.metallicFactor = static_cast<float>(pbr.metallicFactor);
-        sm.roughnessFactor = static_cast<float>(pbr.roughnessFactor);
-
-        if (pbr.baseColorTexture.index >= 0)
-            sm.baseColorTexture = model.textures[pbr.baseColorTexture.index].source;
-        if (pbr.metallicRoughnessTexture.index >= 0)
-            sm.metallicRoughnessTexture = model.textures[pbr.metallicRoughnessTexture.index].source;
-        if (mat.normalTexture.index >= 0)
-            sm.normalTexture = model.textures[mat.normalTexture.index].source;
-
-        sm.alphaMode = (mat.alphaMode == "MASK") ? 1 : 0;
-        sm.alphaCutoff = static_cast<float>(mat.alphaCutoff);
+            sm.baseColorFactor[c] = pbr.base_color_factor[c];
+        sm.metallicFactor = pbr.metallic_factor;
+        sm.roughnessFactor = pbr.roughness_factor;
+
+        sm.baseColorTexture = textureImageIndex(data, pbr.base_color_texture);
+        sm.metallicRoughnessTexture = textureImageIndex(data, pbr.metallic_roughness_texture);
+        sm.normalTexture = textureImageIndex(data, mat.normal_texture);
+
+        sm.alphaMode = mat.alpha_mode == cgltf_alpha_mode_mask    ? 1
+                     : mat.alpha_mode == cgltf_alpha_mode_blend ? 2
+                                                                : 0;
+        sm.alphaCutoff = mat.alpha_cutoff;
     }
 
-    // --- Parse images ---
-    images.resize(model.images.size());
-    for (int ii = 0; ii < static_cast<int>(model.images.size()); ++ii) {
-        const auto& gltfImage = model.images[ii];
-        auto& si = images[ii];
-
-        if (!gltfImage.image.empty()) {
-            si.width = gltfImage.width;
-            si.height = gltfImage.height;
-            si.channels = gltfImage.component;
-            si.pixels.assign(gltfImage.image.begin(), gltfImage.image.end());
-        } else if (!gltfImage.uri.empty()) {
-            si.uri = (baseDir / gltfImage.uri).string();
-            int w, h, ch;
-            uint8_t* px = stbi_load(si.uri.c_str(), &w, &h, &ch, 4);
-            if (px) {
-                si.width = w;
-                si.height = h;
-                si.channels = 4;
-                si.pixels.assign(px, px + w * h * 4);
-                stbi_image_free(px);
-            } else {
-                spdlog::warn("Failed to load image: {}", si.uri);
-            }
-        }
-    }
+    // --- Decode images (started before geometry parsing) ---
+    images = imageDecode.get();
 
     // --- Parse nodes ---
-    nodes.resize(model.nodes.size());
-    for (int ni = 0; ni < static_cast<int>(model.nodes.size()); ++ni) {
-        const auto& gn = model.nodes[ni];
+    nodes.resize(data.nodes_count);
+    size_t instancedMeshCount = 0;
+    for (cgltf_size ni = 0; ni < data.nodes_count; ++ni) {
+        const cgltf_node& gn = data.nodes[ni];
         auto& sn = nodes[ni];
-        sn.name = gn.name;
-        sn.mesh = gn.mesh;
-        sn.camera = gn.camera;
-
-        if (gn.extensions.count("KHR_lights_punctual")) {
-            const auto& ext = gn.extensions.at("KHR_lights_punctual");
-            if (ext.Has("light"))
-                sn.light = ext.Get("light").GetNumberAsInt();
-        }
+        sn.name = gn.name ? gn.name : "";
+        sn.mesh = gn.mesh ? static_cast<int>(cgltf_mesh_index(&data, gn.mesh)) : -1;
+        sn.camera = gn.camera ? static_cast<int>(cgltf_camera_index(&data, gn.camera)) : -1;
+        sn.light = gn.light ? static_cast<int>(cgltf_light_index(&data, gn.light)) : -1;
 
-        if (!gn.matrix.empty()) {
+        if (gn.has_matrix) {
             sn.hasMatrix = true;
-            for (int i = 0; i < 16; ++i)
-                sn.localMatrix[i] = static_cast<float>(gn.matrix[i]);
+            std::memcpy(sn.localMatrix, gn.matrix, sizeof(sn.localMatrix));
         } else {
-            if (!gn.translation.empty()) {
-                sn.translation[0] = static_cast<float>(gn.translation[0]);
-                sn.translation[1] = static_cast<float>(gn.translation[1]);
-                sn.translation[2] = static_cast<float>(gn.translation[2]);
-            }
-            if (!gn.rotation.empty()) {
-                sn.rotation[0] = static_cast<float>(gn.rotation[0]);
-                sn.rotation[1] = static_cast<float>(gn.rotation[1]);
-                sn.rotation[2] = static_cast<float>(gn.rotation[2]);
-                sn.rotation[3] = static_cast<float>(gn.rotation[3]);
-            }
-            if (!gn.scale.empty()) {
-                sn.scale[0] = static_cast<float>(gn.scale[0]);
-                sn.scale[1] = static_cast<float>(gn.scale[1]);
-                sn.scale[2] = static_cast<float>(gn.scale[2]);
-            }
+            if (gn.has_translation)
+                std::memcpy(sn.translation, gn.translation, sizeof(sn.translation));
+            if (gn.has_rotation)
+                std::memcpy(sn.rotation, gn.rotation, sizeof(sn.rotation));
+            if (gn.has_scale)
+                std::memcpy(sn.scale, gn.scale, sizeof(sn.scale));
         }
 
-        for (int child : gn.children) {
+        sn.skin = gn.skin ? static_cast<int>(cgltf_skin_index(&data, gn.skin)) : -1;
+        if (gn.weights_count > 0)
+            sn.morphWeights.assign(gn.weights, gn.weights + gn.weights_count);
+        else if (gn.mesh && gn.mesh->weights_count > 0)
+            sn.morphWeights.assign(gn.mesh->weights, gn.mesh->weights + gn.mesh->weights_count);
+
+        if (gn.has_mesh_gpu_instancing && gn.mesh) {
+            readGpuInstancing(gn.mesh_gpu_instancing, sn.instanceMatrices);
+            instancedMeshCount += sn.instanceMatrices.size() / 16;
+        }
+
+        for (cgltf_size ci = 0; ci < gn.children_count; ++ci) {
+            int child = static_cast<int>(cgltf_node_index(&data, gn.children[ci]));
             sn.children.push_back(child);
-            nodes[child].parent = ni;
+            nodes[child].parent = static_cast<int>(ni);
         }
     }
 
     // Root nodes
-    int sceneIndex = model.defaultScene >= 0 ? model.defaultScene : 0;
-    if (sceneIndex < static_cast<int>(model.scenes.size())) {
-        for (int n : model.scenes[sceneIndex].nodes)
-            rootNodes.push_back(n);
+    if (const cgltf_scene* scene = defaultScene(data)) {
+        for (cgltf_size ri = 0; ri < scene->nodes_count; ++ri)
+            rootNodes.push_back(static_cast<int>(cgltf_node_index(&data, scene->nodes[ri])));
     }
 
+    // --- Parse skins and animations ---
+    skins.resize(data.skins_count);
+    for (cgltf_size si = 0; si < data.skins_count; ++si)
+        readSkin(data, data.skins[si], skins[si]);
+    animations.resize(data.animations_count);
+    for (cgltf_size ai = 0; ai < data.animations_count; ++ai)
+        readAnimation(data, data.animations[ai], animations[ai]);
+
     // --- Parse cameras ---
-    cameras.resize(model.cameras.size());
-    for (int ci = 0; ci < static_cast<int>(model.cameras.size()); ++ci) {
-        const auto& gc = model.cameras[ci];
+    cameras.resize(data.cameras_count);
+    for (cgltf_size ci = 0; ci < data.cameras_count; ++ci) {
+        const cgltf_camera& gc = data.cameras[ci];
         auto& sc = cameras[ci];
-        if (gc.type == "perspective") {
+        if (gc.type == cgltf_camera_type_perspective) {
             sc.type = SceneCamera::Perspective;
-            sc.yfov = static_cast<float>(gc.perspective.yfov);
-            sc.znear = static_cast<float>(gc.perspective.znear);
-            sc.zfar = static_cast<float>(gc.perspective.zfar);
-            sc.aspectRatio = static_cast<float>(gc.perspective.aspectRatio);
+            sc.yfov = gc.data.perspective.yfov;
+            sc.znear = gc.data.perspective.znear;
+            sc.zfar = gc.data.perspective.has_zfar ? gc.data.perspective.zfar : 0.0f;
+            sc.aspectRatio = gc.data.perspective.has_aspect_ratio ? gc.data.perspective.aspect_ratio : 0.0f;
         } else {
             sc.type = SceneCamera::Orthographic;
-            sc.znear = static_cast<float>(gc.orthographic.znear);
-            sc.zfar = static_cast<float>(gc.orthographic.zfar);
+            sc.znear = gc.data.orthographic.znear;
+            sc.zfar = gc.data.orthographic.zfar;
         }
     }
 
     // --- Parse lights (KHR_lights_punctual) ---
-    if (model.extensions.count("KHR_lights_punctual")) {
-        const auto& ext = model.extensions.at("KHR_lights_punctual");
-        if (ext.Has("lights")) {
-            const auto& lightsArr = ext.Get("lights");
-            lights.resize(lightsArr.ArrayLen());
-            for (int li = 0; li < static_cast<int>(lightsArr.ArrayLen()); ++li) {
-                const auto& gl = lightsArr.Get(li);
-                auto& sl = lights[li];
-                if (gl.Has("type")) {
-                    std::string t = gl.Get("type").Get<std::string>();
-                    if (t == "directional") sl.type = SceneLight::Directional;
-                    else if (t == "point") sl.type = SceneLight::Point;
-                    else if (t == "spot") sl.type = SceneLight::Spot;
-                }
-                if (gl.Has("color")) {
-                    const auto& c = gl.Get("color");
-                    for (int ci2 = 0; ci2 < 3 && ci2 < static_cast<int>(c.ArrayLen()); ++ci2)
-                        sl.color[ci2] = static_cast<float>(c.Get(ci2).GetNumberAsDouble());
-                }
-                if (gl.Has("intensity"))
-                    sl.intensity = static_cast<float>(gl.Get("intensity").GetNumberAsDouble());
-            }
+    lights.resize(data.lights_count);
+    for (cgltf_size li = 0; li < data.lights_count; ++li) {
+        const cgltf_light& gl = data.lights[li];
+        auto& sl = lights[li];
+        switch (gl.type) {
+            case cgltf_light_type_point: sl.type = SceneLight::Point; break;
+            case cgltf_light_type_spot:  sl.type = SceneLight::Spot; break;
+            default:                     sl.type = SceneLight::Directional; break;
+        }
+        std::memcpy(sl.color, gl.color, sizeof(sl.color));
+        sl.intensity = gl.intensity;
+        sl.range = gl.range;
+        if (sl.type == SceneLight::Spot) {
+            sl.innerConeAngle = gl.spot_inner_cone_angle;
+            sl.outerConeAngle = gl.spot_outer_cone_angle;
         }
     }
 
-    spdlog::info("Scene loaded: {} primitives, {} materials, {} images, {} nodes ({})",
-                 totalPrimitives, materials.size(), images.size(), nodes.size(), gltfPath);
+    spdlog::info("Scene loaded: {} primitives, {} materials, {} images, {} nodes, {} GPU instances, "
+                 "{} skins, {} animations ({})",
+                 totalPrimitives, materials.size(), images.size(), nodes.size(), instancedMeshCount,
+                 skins.size(), animations.size(), gltfPath);
 
     m_loaded = true;
     return true;
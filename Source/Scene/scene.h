@@ -4,6 +4,8 @@
 #include <vector>
 #include <cstdint>
 
+struct TranscodedTexture;
+
 struct ScenePrimitive {
     uint32_t vertexOffset = 0;
     uint32_t vertexCount = 0;
@@ -11,6 +13,12 @@ struct ScenePrimitive {
     uint32_t indexCount = 0;
     uint32_t materialIndex = 0;
     int meshID = 0;
+    // Scene::skinJoints/skinWeights hold this primitive's vertices.
+    bool skinned = false;
+    // Morph targets in Scene::morphDeltas from morphDeltaOffset: per target,
+    // vertexCount position deltas then vertexCount normal deltas (xyz each).
+    uint32_t morphDeltaOffset = 0;
+    uint32_t morphTargetCount = 0;
 };
 
 struct SceneMeshInfo {
@@ -49,6 +57,42 @@ struct SceneNodeData {
     int mesh = -1;
     int light = -1;
     int camera = -1;
+    // EXT_mesh_gpu_instancing: 16 floats (column-major, relative to the node) per
+    // instance. When present the mesh is drawn once per instance, never at the node.
+    std::vector<float> instanceMatrices;
+    int skin = -1;
+    // Initial morph target weights: the node's, else the mesh's defaults.
+    std::vector<float> morphWeights;
+};
+
+struct SceneSkin {
+    std::string name;
+    std::vector<int> joints;
+    // 16 floats (column-major) per joint; identity when the file has none.
+    std::vector<float> inverseBindMatrices;
+};
+
+struct SceneAnimationSampler {
+    enum Interpolation { Linear, Step, CubicSpline };
+    Interpolation interpolation = Linear;
+    uint32_t components = 0;   // floats per value: 3, 4 or the morph target count
+    std::vector<float> times;
+    // One value per key; CubicSpline stores in-tangent, value, out-tangent.
+    std::vector<float> values;
+};
+
+struct SceneAnimationChannel {
+    enum Path { Translation, Rotation, Scale, Weights };
+    uint32_t sampler = 0;
+    int node = -1;
+    Path path = Translation;
+};
+
+struct SceneAnimation {
+    std::string name;
+    float duration = 0.0f;
+    std::vector<SceneAnimationSampler> samplers;
+    std::vector<SceneAnimationChannel> channels;
 };
 
 struct SceneCamera {
@@ -65,12 +109,19 @@ struct SceneLight {
     Type type = Directional;
     float color[3] = {1, 1, 1};
     float intensity = 1.0f;
+    float range = 0.0f;             // 0 = unbounded (glTF default)
+    float innerConeAngle = 0.0f;    // spot only, radians
+    float outerConeAngle = 0.7853982f;
 };
 
 class Scene {
 public:
     bool load(const std::string& gltfPath);
     void clear();
+    // Drops the vertex streams, indices and image pixels once SceneGpu has uploaded
+    // them; only a fresh load (snapshot or glTF) brings them back. Returns the
+    // bytes freed.
+    size_t releaseBulkData();
     bool isLoaded() const { return m_loaded; }
     const std::string& filePath() const { return m_filePath; }
 
@@ -78,6 +129,10 @@ public:
     std::vector<float> normals;
     std::vector<float> uvs;
     std::vector<uint32_t> indices;
+    // Four joints and weights per vertex; empty when no primitive is skinned.
+    std::vector<uint16_t> skinJoints;
+    std::vector<float> skinWeights;
+    std::vector<float> morphDeltas;
 
     std::vector<ScenePrimitive> primitives;
     std::vector<SceneMeshInfo> meshInfos;
@@ -87,6 +142,8 @@ public:
     std::vector<int> rootNodes;
     std::vector<SceneCamera> cameras;
     std::vector<SceneLight> lights;
+    std::vector<SceneSkin> skins;
+    std::vector<SceneAnimation> animations;
 
     float bboxMin[3] = {};
     float bboxMax[3] = {};
@@ -95,6 +152,12 @@ public:
     float bakedRootScale = 1.0f;
 
 private:
+    friend bool loadSceneSnapshot(const std::string& gltfPath,
+                                  const std::string& cacheDirectory,
+                                  bool bc7Textures,
+                                  Scene& scene,
+                                  std::vector<TranscodedTexture>& textures);
+
     bool m_loaded = false;
     std::string m_filePath;
 };
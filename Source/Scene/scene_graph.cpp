@@ -4,9 +4,12 @@
 #include "cluster_lod_builder.h"
 #include "mesh_loader.h"
 #include "meshlet_builder.h"
+#include "parallel_for.h"
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <cmath>
+#include <cstring>
 
 static float4x4 computeTRS(const float3& t, const float4& q, const float3& s) {
     float4x4 T, R, S;
@@ -194,27 +197,153 @@ bool SceneGraph::applyBakedSingleRootScale(const LoadedMesh& mesh) {
     return true;
 }
 
-void SceneGraph::updateTransforms() {
-    for (auto& node : nodes) {
-        if (!node.transform.dirty) continue;
-
-        if (!node.transform.useLocalMatrix) {
-            node.transform.localMatrix = computeTRS(
-                node.transform.translation,
-                node.transform.rotation,
-                node.transform.scale);
+namespace {
+
+// Slots per parallelFor task; a level smaller than this runs on the calling thread.
+constexpr size_t kTransformChunkSize = 4096;
+
+template <typename Fn>
+void forEachChunk(size_t begin, size_t end, Fn&& fn) {
+    const size_t chunkCount = (end - begin + kTransformChunkSize - 1) / kTransformChunkSize;
+    Parallel::parallelFor(chunkCount, [&](size_t chunk) {
+        const size_t chunkBegin = begin + chunk * kTransformChunkSize;
+        fn(chunkBegin, std::min(chunkBegin + kTransformChunkSize, end));
+    });
+}
+
+} // namespace
+
+void SceneGraph::buildDepthOrder(std::vector<uint32_t>& slotNode,
+                                 std::vector<int32_t>& slotParent,
+                                 std::vector<uint32_t>& levelStart) const {
+    const size_t nodeCount = nodes.size();
+    std::vector<uint8_t> placed(nodeCount, 0);
+    slotNode.clear();
+    slotParent.clear();
+    levelStart.clear();
+    slotNode.reserve(nodeCount);
+    slotParent.reserve(nodeCount);
+
+    for (uint32_t nodeId = 0; nodeId < nodeCount; ++nodeId) {
+        if (nodes[nodeId].parent < 0) {
+            placed[nodeId] = 1;
+            slotNode.push_back(nodeId);
+            slotParent.push_back(-1);
+        }
+    }
+    size_t levelBegin = 0;
+    while (levelBegin < slotNode.size()) {
+        levelStart.push_back(static_cast<uint32_t>(levelBegin));
+        const size_t levelEnd = slotNode.size();
+        for (size_t slot = levelBegin; slot < levelEnd; ++slot) {
+            for (uint32_t childId : nodes[slotNode[slot]].children) {
+                if (childId >= nodeCount || placed[childId]) continue;
+                placed[childId] = 1;
+                slotNode.push_back(childId);
+                slotParent.push_back(static_cast<int32_t>(slot));
+            }
         }
+        levelBegin = levelEnd;
+    }
+    levelStart.push_back(static_cast<uint32_t>(slotNode.size()));
+}
 
-        if (node.parent >= 0)
-            node.transform.worldMatrix =
-                nodes[node.parent].transform.worldMatrix * node.transform.localMatrix;
-        else
-            node.transform.worldMatrix = node.transform.localMatrix;
+void SceneGraph::rebuildTransformStore() {
+    TransformStore& store = m_transformStore;
+    buildDepthOrder(store.slotNode, store.slotParent, store.levelStart);
+    store.nodeSlot.assign(nodes.size(), UINT32_MAX);
+    for (uint32_t slot = 0; slot < store.slotNode.size(); ++slot) {
+        store.nodeSlot[store.slotNode[slot]] = slot;
+    }
 
-        node.transform.dirty = false;
+    const size_t slotCount = store.slotNode.size();
+    store.local.assign(slotCount, float4x4::Identity());
+    store.world.assign(slotCount, float4x4::Identity());
+    store.dirty.assign(slotCount, 0);
+    for (SceneNode& node : nodes) {
+        node.transform.dirty = true;
+    }
+}
 
-        for (uint32_t childId : node.children) {
-            nodes[childId].transform.dirty = true;
+void SceneGraph::updateTransforms() {
+    TransformStore& store = m_transformStore;
+    // Gather edited local transforms into their slots. Levels above the
+    // shallowest edit are clean and skipped below.
+    std::atomic<uint32_t> firstDirtySlot{UINT32_MAX};
+    auto gatherNode = [&](uint32_t nodeId) {
+        TransformComponent& transform = nodes[nodeId].transform;
+        const uint32_t slot = store.nodeSlot[nodeId];
+        if (!transform.dirty || slot == UINT32_MAX) return;
+        if (!transform.useLocalMatrix) {
+            transform.localMatrix = computeTRS(transform.translation, transform.rotation, transform.scale);
+        }
+        store.local[slot] = transform.localMatrix;
+        store.dirty[slot] = 1;
+        transform.dirty = false;
+        uint32_t first = firstDirtySlot.load(std::memory_order_relaxed);
+        while (slot < first && !firstDirtySlot.compare_exchange_weak(first, slot, std::memory_order_relaxed)) {
+        }
+    };
+    if (store.nodeSlot.size() != nodes.size()) {
+        rebuildTransformStore();
+        forEachChunk(0, nodes.size(), [&](size_t begin, size_t end) {
+            for (size_t nodeId = begin; nodeId < end; ++nodeId) {
+                gatherNode(static_cast<uint32_t>(nodeId));
+            }
+        });
+        for (uint32_t nodeId = 0; nodeId < nodes.size(); ++nodeId) {
+            localChangedNodes.push_back(nodeId);
+        }
+    } else {
+        for (uint32_t nodeId : m_dirtyNodes) {
+            if (nodeId < nodes.size() && nodes[nodeId].transform.dirty) {
+                gatherNode(nodeId);
+                localChangedNodes.push_back(nodeId);
+            }
+        }
+    }
+    m_dirtyNodes.clear();
+    if (firstDirtySlot.load() == UINT32_MAX) {
+        return;
+    }
+    const size_t firstLevel = static_cast<size_t>(
+        std::upper_bound(store.levelStart.begin(), store.levelStart.end(), firstDirtySlot.load()) -
+        store.levelStart.begin()) - 1;
+    const size_t firstSlot = store.levelStart[firstLevel];
+
+    // Levels run in order; slots within a level are independent.
+    for (size_t level = firstLevel; level + 1 < store.levelStart.size(); ++level) {
+        forEachChunk(store.levelStart[level], store.levelStart[level + 1], [&](size_t begin, size_t end) {
+            for (size_t slot = begin; slot < end; ++slot) {
+                const int32_t parentSlot = store.slotParent[slot];
+                if (parentSlot < 0) {
+                    if (store.dirty[slot]) {
+                        store.world[slot] = store.local[slot];
+                    }
+                    continue;
+                }
+                if (store.dirty[parentSlot]) {
+                    store.dirty[slot] = 1;
+                }
+                if (store.dirty[slot]) {
+                    store.world[slot] = store.world[parentSlot] * store.local[slot];
+                }
+            }
+        });
+    }
+
+    // Publish to the nodes, then list them for updateGpuSceneTables().
+    forEachChunk(firstSlot, store.slotNode.size(), [&](size_t begin, size_t end) {
+        for (size_t slot = begin; slot < end; ++slot) {
+            if (store.dirty[slot]) {
+                nodes[store.slotNode[slot]].transform.worldMatrix = store.world[slot];
+            }
+        }
+    });
+    for (size_t slot = firstSlot; slot < store.slotNode.size(); ++slot) {
+        if (store.dirty[slot]) {
+            transformChangedNodes.push_back(store.slotNode[slot]);
+            store.dirty[slot] = 0;
         }
     }
 }
@@ -222,8 +351,167 @@ void SceneGraph::updateTransforms() {
 void SceneGraph::markDirty(uint32_t nodeId) {
     if (nodeId >= nodes.size()) return;
     nodes[nodeId].transform.dirty = true;
-    for (uint32_t childId : nodes[nodeId].children)
-        markDirty(childId);
+    m_dirtyNodes.push_back(nodeId);
+}
+
+namespace {
+
+// Channels per parallelFor task.
+constexpr size_t kAnimationChunkSize = 64;
+
+float4 slerpQuaternion(const float4& a, float4 b, float t) {
+    float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    if (cosTheta < 0.0f) {
+        b = -b;
+        cosTheta = -cosTheta;
+    }
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cosTheta < 0.9995f) {
+        const float theta = std::acos(cosTheta);
+        const float sinTheta = std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+    return a * wa + b * wb;
+}
+
+// Writes sampler.components floats for time into out. Rotations come back normalized.
+void sampleAnimation(const AnimationSampler& sampler, AnimationPath path, float time, float* out) {
+    const uint32_t n = sampler.components;
+    const size_t keyCount = sampler.times.size();
+    const bool cubic = sampler.interpolation == AnimationInterpolation::CubicSpline;
+    // CubicSpline keys hold three values; the middle one is the key's value.
+    auto value = [&](size_t key, uint32_t part) {
+        return sampler.values.data() + (cubic ? (key * 3 + part) : key) * n;
+    };
+
+    const auto upper = std::upper_bound(sampler.times.begin(), sampler.times.end(), time);
+    if (upper == sampler.times.begin() || upper == sampler.times.end()) {
+        const size_t key = upper == sampler.times.begin() ? 0 : keyCount - 1;
+        std::copy(value(key, 1), value(key, 1) + n, out);
+        return;
+    }
+    const size_t k1 = static_cast<size_t>(upper - sampler.times.begin());
+    const size_t k0 = k1 - 1;
+    const float dt = sampler.times[k1] - sampler.times[k0];
+    const float t = dt > 0.0f ? (time - sampler.times[k0]) / dt : 0.0f;
+
+    if (sampler.interpolation == AnimationInterpolation::Step) {
+        std::copy(value(k0, 1), value(k0, 1) + n, out);
+    } else if (cubic) {
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+        const float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+        const float h10 = (t3 - 2.0f * t2 + t) * dt;
+        const float h01 = -2.0f * t3 + 3.0f * t2;
+        const float h11 = (t3 - t2) * dt;
+        const float* p0 = value(k0, 1);
+        const float* m0 = value(k0, 2);
+        const float* p1 = value(k1, 1);
+        const float* m1 = value(k1, 0);
+        for (uint32_t c = 0; c < n; ++c) {
+            out[c] = h00 * p0[c] + h10 * m0[c] + h01 * p1[c] + h11 * m1[c];
+        }
+    } else if (path == AnimationPath::Rotation && n == 4) {
+        const float* q0 = value(k0, 1);
+        const float* q1 = value(k1, 1);
+        const float4 q = slerpQuaternion(float4(q0[0], q0[1], q0[2], q0[3]),
+                                         float4(q1[0], q1[1], q1[2], q1[3]), t);
+        std::memcpy(out, &q, sizeof(float) * 4);
+    } else {
+        const float* v0 = value(k0, 1);
+        const float* v1 = value(k1, 1);
+        for (uint32_t c = 0; c < n; ++c) {
+            out[c] = v0[c] + (v1[c] - v0[c]) * t;
+        }
+    }
+
+    if (path == AnimationPath::Rotation && n == 4) {
+        const float norm = std::sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2] + out[3] * out[3]);
+        for (uint32_t c = 0; c < 4; ++c) {
+            out[c] = norm > 1e-6f ? out[c] / norm : (c == 3 ? 1.0f : 0.0f);
+        }
+    }
+}
+
+} // namespace
+
+bool SceneGraph::hasPendingUpdates() const {
+    if (!m_dirtyNodes.empty()) return true;
+    for (const AnimationClip& clip : animations) {
+        if (clip.playing) return true;
+    }
+    return false;
+}
+
+void SceneGraph::advanceAnimations(float deltaTime) {
+    m_animationTasks.clear();
+    uint32_t valueCount = 0;
+    for (uint32_t clipIndex = 0; clipIndex < animations.size(); ++clipIndex) {
+        AnimationClip& clip = animations[clipIndex];
+        if (!clip.playing) continue;
+        clip.time += deltaTime * animationSpeed;
+        if (clip.duration > 0.0f) {
+            clip.time = std::fmod(clip.time, clip.duration);
+            if (clip.time < 0.0f) clip.time += clip.duration;
+        } else {
+            clip.time = 0.0f;
+        }
+        for (uint32_t channelIndex = 0; channelIndex < clip.channels.size(); ++channelIndex) {
+            const AnimationChannel& channel = clip.channels[channelIndex];
+            if (channel.node >= nodes.size()) continue;
+            m_animationTasks.push_back({clipIndex, channelIndex, valueCount});
+            valueCount += clip.samplers[channel.sampler].components;
+        }
+    }
+    if (m_animationTasks.empty()) return;
+
+    m_animationValues.resize(valueCount);
+    const size_t chunkCount = (m_animationTasks.size() + kAnimationChunkSize - 1) / kAnimationChunkSize;
+    Parallel::parallelFor(chunkCount, [&](size_t chunk) {
+        const size_t end = std::min((chunk + 1) * kAnimationChunkSize, m_animationTasks.size());
+        for (size_t taskIndex = chunk * kAnimationChunkSize; taskIndex < end; ++taskIndex) {
+            const AnimationTask& task = m_animationTasks[taskIndex];
+            const AnimationClip& clip = animations[task.clip];
+            const AnimationChannel& channel = clip.channels[task.channel];
+            sampleAnimation(clip.samplers[channel.sampler], channel.path, clip.time,
+                            m_animationValues.data() + task.valueOffset);
+        }
+    });
+
+    // Clips that drive the same property apply in clip order, so the last one wins.
+    for (const AnimationTask& task : m_animationTasks) {
+        const AnimationClip& clip = animations[task.clip];
+        const AnimationChannel& channel = clip.channels[task.channel];
+        const float* v = m_animationValues.data() + task.valueOffset;
+        SceneNode& node = nodes[channel.node];
+        TransformComponent& transform = node.transform;
+        switch (channel.path) {
+            case AnimationPath::Translation:
+                transform.translation = float3(v[0], v[1], v[2]);
+                break;
+            case AnimationPath::Rotation:
+                transform.rotation = float4(v[0], v[1], v[2], v[3]);
+                break;
+            case AnimationPath::Scale:
+                transform.scale = float3(v[0], v[1], v[2]);
+                break;
+            case AnimationPath::Weights:
+                node.morphWeights.assign(v, v + clip.samplers[channel.sampler].components);
+                continue;
+        }
+        transform.useLocalMatrix = false;
+        if (!transform.dirty) {
+            markDirty(channel.node);
+        }
+    }
+}
+
+void SceneGraph::setNodeVisible(uint32_t nodeId, bool visible) {
+    if (nodeId >= nodes.size() || nodes[nodeId].visible == visible) return;
+    nodes[nodeId].visible = visible;
+    ++visibilityRevision;
 }
 
 bool SceneGraph::isNodeVisible(uint32_t nodeId) const {
@@ -236,6 +524,28 @@ bool SceneGraph::isNodeVisible(uint32_t nodeId) const {
     return true;
 }
 
+bool SceneGraph::addMeshInstances(uint32_t nodeId, const float4x4* localMatrices, size_t count) {
+    if (nodeId >= nodes.size() || nodes[nodeId].meshIndex < 0 || nodes[nodeId].generatedPrimitive) return false;
+    SceneNode& node = nodes[nodeId];
+    if (node.instanceSet < 0) {
+        node.instanceSet = static_cast<int32_t>(instanceSets.size());
+        instanceSets.emplace_back().node = nodeId;
+    }
+    std::vector<float4x4>& matrices = instanceSets[node.instanceSet].localMatrices;
+    matrices.insert(matrices.end(), localMatrices, localMatrices + count);
+    ++instanceRevision;
+    return true;
+}
+
+const MeshInstanceSet* SceneGraph::meshInstancesFor(uint32_t nodeId) const {
+    if (nodeId >= nodes.size()) return nullptr;
+    const SceneNode* node = &nodes[nodeId];
+    if (node->generatedPrimitive && node->parent >= 0) {
+        node = &nodes[node->parent];
+    }
+    return node->instanceSet >= 0 ? &instanceSets[node->instanceSet] : nullptr;
+}
+
 uint32_t SceneGraph::addDirectionalLightNode(const std::string& name,
                                              const float3& direction,
                                              bool setAsSunSource) {
@@ -11,7 +11,9 @@ struct MeshletData;
 struct ClusterLODData;
 
 enum class LightType : uint8_t {
-    Directional = 0
+    Directional = 0,
+    Point,
+    Spot
 };
 
 enum class CameraType : uint8_t {
@@ -33,9 +35,20 @@ struct DirectionalLight {
     float intensity = 1.0f;
 };
 
+// KHR_lights_punctual point or spot light. Position and the spot axis (local -Z)
+// come from the node's world transform.
+struct PunctualLight {
+    float3 color = float3(1.f, 1.f, 1.f);
+    float intensity = 1.0f;             // candela
+    float range = 0.0f;                 // 0 = unbounded
+    float innerConeAngle = 0.0f;        // spot only, radians
+    float outerConeAngle = 0.7853982f;
+};
+
 struct LightComponent {
     LightType type = LightType::Directional;
     DirectionalLight directional;
+    PunctualLight punctual;
 };
 
 struct TransformComponent {
@@ -83,6 +96,69 @@ struct SceneNode {
 
     bool generatedPrimitive = false;
     bool visible = true;
+
+    // Index into SceneGraph::instanceSets, -1 when the mesh is drawn once at the node.
+    int32_t instanceSet = -1;
+
+    // Index into SceneGraph::skins, -1 for rigid meshes.
+    int32_t skin = -1;
+    // Morph target weights of the node's mesh; animation channels rewrite them.
+    std::vector<float> morphWeights;
+    // Set on renderable nodes whose vertices SkinningPass rewrites every frame.
+    // deformedBounds (center, radius in node space) replaces the rest-pose
+    // meshlet bounds when the GPU scene computes the instance's cull sphere.
+    bool deformed = false;
+    float deformedBounds[4] = {};
+};
+
+struct SkinComponent {
+    std::vector<uint32_t> joints;
+    std::vector<float4x4> inverseBindMatrices;
+};
+
+enum class AnimationInterpolation : uint8_t {
+    Linear = 0,
+    Step,
+    CubicSpline
+};
+
+enum class AnimationPath : uint8_t {
+    Translation = 0,
+    Rotation,
+    Scale,
+    Weights
+};
+
+struct AnimationSampler {
+    AnimationInterpolation interpolation = AnimationInterpolation::Linear;
+    uint32_t components = 0;
+    std::vector<float> times;
+    // CubicSpline keys store in-tangent, value and out-tangent.
+    std::vector<float> values;
+};
+
+struct AnimationChannel {
+    uint32_t sampler = 0;
+    uint32_t node = 0;
+    AnimationPath path = AnimationPath::Translation;
+};
+
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f;
+    float time = 0.0f;
+    bool playing = false;
+    std::vector<AnimationSampler> samplers;
+    std::vector<AnimationChannel> channels;
+};
+
+// Lightweight copies of a mesh node from EXT_mesh_gpu_instancing or
+// SceneGraph::addMeshInstances(). An instance is only a matrix relative to its
+// node: it follows the node's world matrix and visibility, shares its geometry
+// and LOD root, and never becomes a SceneNode.
+struct MeshInstanceSet {
+    uint32_t node = 0;
+    std::vector<float4x4> localMatrices;
 };
 
 class SceneGraph {
@@ -91,14 +167,80 @@ public:
     std::vector<uint32_t> rootNodes;
     int32_t selectedNode = -1;
     int32_t sunLightNode = -1;
+    // Nodes whose world matrix updateTransforms() recomputed since the GPU scene
+    // last consumed them; only their instances are re-uploaded.
+    std::vector<uint32_t> transformChangedNodes;
+    // Nodes whose local matrix changed, the only data the GPU transform
+    // hierarchy needs to receive.
+    std::vector<uint32_t> localChangedNodes;
+    // Bumped by setNodeVisible() so visibility flags are only rebuilt on edits.
+    uint32_t visibilityRevision = 0;
+    std::vector<MeshInstanceSet> instanceSets;
+    // Bumped by addMeshInstances(); GPU scene tables built before it are stale.
+    uint32_t instanceRevision = 0;
+    std::vector<SkinComponent> skins;
+    std::vector<AnimationClip> animations;
+    float animationSpeed = 1.0f;
 
     bool applyBakedSingleRootScale(const LoadedMesh& mesh);
+    // Recomputes world matrices for nodes passed to markDirty() and their
+    // descendants, one depth level at a time.
     void updateTransforms();
     void markDirty(uint32_t nodeId);
+    // Advances the playing clips and samples all of their channels as one
+    // parallel batch before writing TRS and morph weights to the nodes. Call
+    // before updateTransforms().
+    void advanceAnimations(float deltaTime);
+    // True while a clip plays or markDirty() nodes wait for updateTransforms().
+    bool hasPendingUpdates() const;
+    void setNodeVisible(uint32_t nodeId, bool visible);
+    // Breadth-first slot order: roots, then each level's children. levelStart
+    // holds one slot offset per level plus the end.
+    void buildDepthOrder(std::vector<uint32_t>& slotNode,
+                         std::vector<int32_t>& slotParent,
+                         std::vector<uint32_t>& levelStart) const;
     bool isNodeVisible(uint32_t nodeId) const;
+    // Draws nodeId's mesh (and its generated primitive children) once per matrix,
+    // relative to the node, instead of once at the node. Appends to the node's
+    // existing set; returns false when the node has no mesh.
+    bool addMeshInstances(uint32_t nodeId, const float4x4* localMatrices, size_t count);
+    // The instance set a renderable node draws with: its own, or for a generated
+    // primitive its owner's. Null when the node draws once.
+    const MeshInstanceSet* meshInstancesFor(uint32_t nodeId) const;
     uint32_t addDirectionalLightNode(const std::string& name,
                                      const float3& direction,
                                      bool setAsSunSource);
     float3 getSunLightDirection() const;
     DirectionalLight getSunDirectionalLight() const;
+
+private:
+    // Structure-of-arrays copy of the hierarchy, ordered by depth so every level
+    // only reads the finished level above it. Slots index the arrays; nodes
+    // publish their results back into TransformComponent.
+    struct TransformStore {
+        std::vector<uint32_t> slotNode;
+        std::vector<int32_t> slotParent;   // -1 for roots
+        std::vector<uint32_t> levelStart;  // slot ranges, one entry per level plus the end
+        std::vector<float4x4> local;
+        std::vector<float4x4> world;
+        std::vector<uint8_t> dirty;
+        std::vector<uint32_t> nodeSlot;
+    };
+
+    void rebuildTransformStore();
+
+    // One sampled channel of a playing clip and where its values land in
+    // m_animationValues.
+    struct AnimationTask {
+        uint32_t clip = 0;
+        uint32_t channel = 0;
+        uint32_t valueOffset = 0;
+    };
+
+    TransformStore m_transformStore;
+    std::vector<AnimationTask> m_animationTasks;
+    std::vector<float> m_animationValues;
+    // Nodes passed to markDirty() since the last update; descendants follow
+    // through the level walk.
+    std::vector<uint32_t> m_dirtyNodes;
 };
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cctype>
+#include <cfloat>
 #include <cmath>
 #include <cstdint>
 #include <string>
@@ -127,51 +129,6 @@ bool hasVisibleTreeChildren(const SceneGraph& scene, uint32_t nodeIdx) {
     return false;
 }
 
-size_t countPrimitiveRows(const SceneGraph& scene) {
-    size_t count = 0;
-    for (const SceneNode& node : scene.nodes) {
-        if (node.generatedPrimitive || node.primitiveGroupCount > 0)
-            ++count;
-    }
-    return count;
-}
-
-size_t countDisplayNodes(const SceneGraph& scene) {
-    size_t count = 0;
-    for (const SceneNode& node : scene.nodes) {
-        if (!node.generatedPrimitive)
-            ++count;
-    }
-    return count;
-}
-
-size_t countMeshNodes(const SceneGraph& scene) {
-    size_t count = 0;
-    for (const SceneNode& node : scene.nodes) {
-        if (!node.generatedPrimitive && node.meshIndex >= 0)
-            ++count;
-    }
-    return count;
-}
-
-size_t countLights(const SceneGraph& scene) {
-    size_t count = 0;
-    for (const SceneNode& node : scene.nodes) {
-        if (node.hasLight)
-            ++count;
-    }
-    return count;
-}
-
-size_t countCameras(const SceneGraph& scene) {
-    size_t count = 0;
-    for (const SceneNode& node : scene.nodes) {
-        if (node.cameraIndex >= 0)
-            ++count;
-    }
-    return count;
-}
-
 void statRow(const char* label, size_t value) {
     ImGui::TableNextRow();
     ImGui::TableNextColumn();
@@ -180,190 +137,357 @@ void statRow(const char* label, size_t value) {
     ImGui::Text("%zu", value);
 }
 
-void renderAssetInfoTab(const SceneGraph& scene) {
-    if (ImGui::BeginTable("SceneAssetInfoTable", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
-        ImGui::TableSetupColumn("Property", ImGuiTableColumnFlags_WidthFixed, 150.0f);
-        ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
-        statRow("Root Nodes", scene.rootNodes.size());
-        statRow("Nodes", countDisplayNodes(scene));
-        statRow("Mesh Nodes", countMeshNodes(scene));
-        statRow("Primitive Rows", countPrimitiveRows(scene));
-        statRow("Lights", countLights(scene));
-        statRow("Cameras", countCameras(scene));
-        ImGui::EndTable();
-    }
-}
 
-void renderPrimitiveInHierarchy(SceneGraph& scene, uint32_t primitiveNodeIdx) {
-    if (!isValidNode(scene, primitiveNodeIdx))
+// The browser draws flattened rows cached per scene graph instead of walking the
+// hierarchy every frame; only rows inside the scroll region are submitted.
+// Expand state lives here, so the rows only rebuild on a toggle, a reveal or a
+// change to the graph's node storage.
+enum class TreeRowKind : uint8_t {
+    Scene,
+    Node,
+    Camera,
+    Light,
+    Mesh,
+    Primitive
+};
+
+struct TreeRow {
+    uint32_t node = 0;
+    uint16_t depth = 0;
+    TreeRowKind kind = TreeRowKind::Scene;
+    bool leaf = true;
+};
+
+struct SceneBrowserCache {
+    const SceneGraph* scene = nullptr;
+    const SceneNode* nodeData = nullptr;
+    size_t nodeCount = 0;
+    size_t rootCount = 0;
+
+    std::vector<uint8_t> nodeOpen;
+    std::vector<uint8_t> meshOpen;
+    bool sceneOpen = true;
+    bool rowsDirty = true;
+    std::vector<TreeRow> rows;
+    // Row to scroll into view after the next rebuild, e.g. a picked search result.
+    int32_t revealNode = -1;
+
+    // Lower-case "[id] name" per node for the name search.
+    std::vector<std::string> searchKeys;
+    char searchText[128] = {};
+    std::string activeSearch;
+    std::vector<uint32_t> searchResults;
+
+    std::vector<uint32_t> displayNodes;
+    std::vector<uint32_t> meshNodes;
+    std::vector<uint32_t> primitiveNodes;
+    std::vector<uint32_t> cameraNodes;
+    std::vector<uint32_t> lightNodes;
+};
+
+SceneBrowserCache& browserCache() {
+    static SceneBrowserCache cache;
+    return cache;
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+void rebuildSearchResults(SceneBrowserCache& cache) {
+    cache.activeSearch = toLower(cache.searchText);
+    cache.searchResults.clear();
+    if (cache.activeSearch.empty())
         return;
-
-    const SceneNode& node = scene.nodes[primitiveNodeIdx];
-    const bool selected = scene.selectedNode == static_cast<int32_t>(primitiveNodeIdx);
-    const std::string label = "[P] Primitive " + std::to_string(node.primitiveIndexInMesh);
-
-    ImGui::TableNextRow();
-    ImGui::TableNextColumn();
-    if (ImGui::Selectable(label.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns))
-        scene.selectedNode = static_cast<int32_t>(primitiveNodeIdx);
-
-    ImGui::TableNextColumn();
-    if (node.materialIndex != UINT32_MAX) {
-        ImGui::Text("M%u", node.materialIndex);
-        if (ImGui::IsItemHovered())
-            ImGui::SetTooltip("Material %u", node.materialIndex);
+    for (uint32_t nodeIdx : cache.displayNodes) {
+        if (cache.searchKeys[nodeIdx].find(cache.activeSearch) != std::string::npos)
+            cache.searchResults.push_back(nodeIdx);
     }
 }
 
-void renderMeshInHierarchy(SceneGraph& scene, uint32_t nodeIdx) {
-    if (!isValidNode(scene, nodeIdx))
+// Resets expand state and the per-category indices when the graph's nodes were
+// replaced or grew; roots and meshes start open, like the old DefaultOpen flags.
+void syncBrowserCache(SceneBrowserCache& cache, const SceneGraph& scene) {
+    if (cache.scene == &scene &&
+        cache.nodeData == scene.nodes.data() &&
+        cache.nodeCount == scene.nodes.size() &&
+        cache.rootCount == scene.rootNodes.size()) {
         return;
+    }
 
-    SceneNode& node = scene.nodes[nodeIdx];
-    std::vector<uint32_t> primitives = collectPrimitiveRows(scene, nodeIdx);
-
-    ImGui::TableNextRow();
-    ImGui::TableNextColumn();
-
-    ImGuiTreeNodeFlags flags = kTreeNodeFlags | ImGuiTreeNodeFlags_DefaultOpen;
-    if (primitives.empty())
-        flags |= ImGuiTreeNodeFlags_Leaf;
-
-    const std::string label = "[M] " + meshDisplayName(node);
-    const bool open = ImGui::TreeNodeEx(
-        reinterpret_cast<void*>(kMeshTreeIdBase + nodeIdx),
-        flags,
-        "%s",
-        label.c_str());
-
-    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-        scene.selectedNode = static_cast<int32_t>(nodeIdx);
-
-    ImGui::TableNextColumn();
+    cache.scene = &scene;
+    cache.nodeData = scene.nodes.data();
+    cache.nodeCount = scene.nodes.size();
+    cache.rootCount = scene.rootNodes.size();
+    cache.nodeOpen.assign(scene.nodes.size(), 0);
+    cache.meshOpen.assign(scene.nodes.size(), 1);
+    cache.rowsDirty = true;
+    cache.revealNode = -1;
+    for (size_t i = 0; i < scene.nodes.size(); ++i) {
+        if (scene.nodes[i].parent < 0)
+            cache.nodeOpen[i] = 1;
+    }
 
-    if (open) {
-        for (uint32_t primitiveNodeIdx : primitives)
-            renderPrimitiveInHierarchy(scene, primitiveNodeIdx);
-        ImGui::TreePop();
+    cache.searchKeys.assign(scene.nodes.size(), std::string());
+    cache.displayNodes.clear();
+    cache.meshNodes.clear();
+    cache.primitiveNodes.clear();
+    cache.cameraNodes.clear();
+    cache.lightNodes.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(scene.nodes.size()); ++i) {
+        const SceneNode& node = scene.nodes[i];
+        if (!node.generatedPrimitive) {
+            cache.displayNodes.push_back(i);
+            cache.searchKeys[i] = toLower("[" + std::to_string(node.id) + "] " + nodeDisplayName(node));
+            if (node.meshIndex >= 0)
+                cache.meshNodes.push_back(i);
+        }
+        if (node.generatedPrimitive || node.primitiveGroupCount > 0)
+            cache.primitiveNodes.push_back(i);
+        if (node.cameraIndex >= 0)
+            cache.cameraNodes.push_back(i);
+        if (node.hasLight)
+            cache.lightNodes.push_back(i);
     }
+    rebuildSearchResults(cache);
 }
 
-void renderCameraInHierarchy(SceneGraph& scene, uint32_t nodeIdx) {
-    if (!isValidNode(scene, nodeIdx))
+void rebuildTreeRows(SceneBrowserCache& cache, const SceneGraph& scene) {
+    cache.rows.clear();
+    cache.rows.push_back({0, 0, TreeRowKind::Scene, scene.rootNodes.empty()});
+    if (!cache.sceneOpen)
         return;
 
-    const SceneNode& node = scene.nodes[nodeIdx];
-    const bool selected = scene.selectedNode == static_cast<int32_t>(nodeIdx);
-    const std::string label = "[C] " + cameraDisplayName(node);
+    // Explicit stack instead of recursion: production hierarchies can be deep.
+    std::vector<std::pair<uint32_t, uint16_t>> stack;
+    for (auto it = scene.rootNodes.rbegin(); it != scene.rootNodes.rend(); ++it) {
+        if (isValidNode(scene, *it) && !scene.nodes[*it].generatedPrimitive)
+            stack.emplace_back(*it, uint16_t(1));
+    }
+    while (!stack.empty()) {
+        const auto [nodeIdx, depth] = stack.back();
+        stack.pop_back();
+        const SceneNode& node = scene.nodes[nodeIdx];
+        cache.rows.push_back({nodeIdx, depth, TreeRowKind::Node, !hasVisibleTreeChildren(scene, nodeIdx)});
+        if (!cache.nodeOpen[nodeIdx])
+            continue;
 
-    ImGui::TableNextRow();
-    ImGui::TableNextColumn();
-    if (ImGui::Selectable(label.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns))
-        scene.selectedNode = static_cast<int32_t>(nodeIdx);
-    ImGui::TableNextColumn();
+        const uint16_t childDepth = static_cast<uint16_t>(depth + 1);
+        if (node.cameraIndex >= 0)
+            cache.rows.push_back({nodeIdx, childDepth, TreeRowKind::Camera, true});
+        if (node.hasLight)
+            cache.rows.push_back({nodeIdx, childDepth, TreeRowKind::Light, true});
+        if (node.meshIndex >= 0) {
+            const std::vector<uint32_t> primitives = collectPrimitiveRows(scene, nodeIdx);
+            cache.rows.push_back({nodeIdx, childDepth, TreeRowKind::Mesh, primitives.empty()});
+            if (cache.meshOpen[nodeIdx]) {
+                for (uint32_t primitiveNodeIdx : primitives)
+                    cache.rows.push_back({primitiveNodeIdx, static_cast<uint16_t>(depth + 2),
+                                          TreeRowKind::Primitive, true});
+            }
+        }
+        for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+            if (isValidNode(scene, *it) && !scene.nodes[*it].generatedPrimitive)
+                stack.emplace_back(*it, childDepth);
+        }
+    }
 }
 
-void renderLightInHierarchy(SceneGraph& scene, uint32_t nodeIdx) {
-    if (!isValidNode(scene, nodeIdx))
-        return;
+// Opens every ancestor of nodeIdx and scrolls its row into view next frame.
+void revealNode(SceneBrowserCache& cache, const SceneGraph& scene, uint32_t nodeIdx) {
+    cache.sceneOpen = true;
+    int32_t parent = scene.nodes[nodeIdx].parent;
+    while (parent >= 0 && parent < static_cast<int32_t>(scene.nodes.size())) {
+        cache.nodeOpen[parent] = 1;
+        parent = scene.nodes[parent].parent;
+    }
+    cache.revealNode = static_cast<int32_t>(nodeIdx);
+    cache.rowsDirty = true;
+}
 
-    const SceneNode& node = scene.nodes[nodeIdx];
+void selectableRow(SceneGraph& scene, uint32_t nodeIdx, const std::string& label) {
     const bool selected = scene.selectedNode == static_cast<int32_t>(nodeIdx);
-    const std::string label = "[L] " + lightDisplayName(node);
-
-    ImGui::TableNextRow();
-    ImGui::TableNextColumn();
     if (ImGui::Selectable(label.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns))
         scene.selectedNode = static_cast<int32_t>(nodeIdx);
-    ImGui::TableNextColumn();
 }
 
-void renderNodeHierarchy(SceneGraph& scene, uint32_t nodeIdx) {
-    if (!isValidNode(scene, nodeIdx))
-        return;
-
-    SceneNode& node = scene.nodes[nodeIdx];
-    if (node.generatedPrimitive)
-        return;
+// Tree rows push nothing onto ImGui's tree stack; indentation comes from the row
+// depth and the open state from the cache.
+bool treeRow(const void* id, ImGuiTreeNodeFlags flags, bool open, const std::string& label) {
+    ImGui::SetNextItemOpen(open);
+    ImGui::TreeNodeEx(id, flags | ImGuiTreeNodeFlags_NoTreePushOnOpen, "%s", label.c_str());
+    return ImGui::IsItemToggledOpen();
+}
 
+void renderTreeRow(SceneGraph& scene, SceneBrowserCache& cache, const TreeRow& row) {
     ImGui::TableNextRow();
     ImGui::TableNextColumn();
+    if (row.kind == TreeRowKind::Scene) {
+        ImGuiTreeNodeFlags flags = kTreeNodeFlags & ~ImGuiTreeNodeFlags_OpenOnDoubleClick;
+        if (row.leaf)
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        if (treeRow(reinterpret_cast<void*>(kSceneTreeId), flags, cache.sceneOpen, "Scene-0")) {
+            cache.sceneOpen = !cache.sceneOpen;
+            cache.rowsDirty = true;
+        }
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("T");
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Scene root");
+        return;
+    }
 
-    ImGuiTreeNodeFlags flags = kTreeNodeFlags;
-    if (!hasVisibleTreeChildren(scene, nodeIdx))
-        flags |= ImGuiTreeNodeFlags_Leaf;
-    if (node.parent < 0)
-        flags |= ImGuiTreeNodeFlags_DefaultOpen;
-    if (scene.selectedNode == static_cast<int32_t>(nodeIdx))
-        flags |= ImGuiTreeNodeFlags_Selected;
-
-    if (!node.visible)
-        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+    // Moves the name cell's cursor; the other column starts at its own edge.
+    const float indent = row.depth * ImGui::GetStyle().IndentSpacing;
+    ImGui::Indent(indent);
+
+    const SceneNode& node = scene.nodes[row.node];
+    switch (row.kind) {
+    case TreeRowKind::Scene:
+        break;
+    case TreeRowKind::Node: {
+        ImGuiTreeNodeFlags flags = kTreeNodeFlags;
+        if (row.leaf)
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        if (scene.selectedNode == static_cast<int32_t>(row.node))
+            flags |= ImGuiTreeNodeFlags_Selected;
+
+        if (!node.visible)
+            ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+        const std::string label = "[N] [" + std::to_string(node.id) + "] " + nodeDisplayName(node);
+        if (treeRow(reinterpret_cast<void*>(static_cast<uintptr_t>(row.node + 1)), flags,
+                    cache.nodeOpen[row.node] != 0, label)) {
+            cache.nodeOpen[row.node] ^= 1;
+            cache.rowsDirty = true;
+        }
+        if (!node.visible)
+            ImGui::PopStyleColor();
 
-    const std::string label = "[N] [" + std::to_string(node.id) + "] " + nodeDisplayName(node);
-    const bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<uintptr_t>(nodeIdx + 1)), flags, "%s", label.c_str());
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+            scene.selectedNode = static_cast<int32_t>(row.node);
 
-    if (!node.visible)
-        ImGui::PopStyleColor();
+        ImGui::TableNextColumn();
+        ImGui::PushID(static_cast<int>(row.node));
+        if (ImGui::SmallButton(node.visible ? "V" : "H"))
+            scene.setNodeVisible(row.node, !node.visible);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip(node.visible ? "Visible" : "Hidden");
+        ImGui::PopID();
+        break;
+    }
+    case TreeRowKind::Camera:
+        selectableRow(scene, row.node, "[C] " + cameraDisplayName(node));
+        ImGui::TableNextColumn();
+        break;
+    case TreeRowKind::Light:
+        selectableRow(scene, row.node, "[L] " + lightDisplayName(node));
+        ImGui::TableNextColumn();
+        break;
+    case TreeRowKind::Mesh: {
+        ImGuiTreeNodeFlags flags = kTreeNodeFlags;
+        if (row.leaf)
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        if (treeRow(reinterpret_cast<void*>(kMeshTreeIdBase + row.node), flags,
+                    cache.meshOpen[row.node] != 0, "[M] " + meshDisplayName(node))) {
+            cache.meshOpen[row.node] ^= 1;
+            cache.rowsDirty = true;
+        }
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+            scene.selectedNode = static_cast<int32_t>(row.node);
+        ImGui::TableNextColumn();
+        break;
+    }
+    case TreeRowKind::Primitive:
+        selectableRow(scene, row.node, "[P] Primitive " + std::to_string(node.primitiveIndexInMesh));
+        ImGui::TableNextColumn();
+        if (node.materialIndex != UINT32_MAX) {
+            ImGui::Text("M%u", node.materialIndex);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Material %u", node.materialIndex);
+        }
+        break;
+    }
 
-    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
-        scene.selectedNode = static_cast<int32_t>(nodeIdx);
+    ImGui::Unindent(indent);
+}
 
-    ImGui::TableNextColumn();
-    ImGui::PushID(static_cast<int>(nodeIdx));
-    if (ImGui::SmallButton(node.visible ? "V" : "H"))
-        node.visible = !node.visible;
-    if (ImGui::IsItemHovered())
-        ImGui::SetTooltip(node.visible ? "Visible" : "Hidden");
-    ImGui::PopID();
-
-    if (open) {
-        if (node.cameraIndex >= 0)
-            renderCameraInHierarchy(scene, nodeIdx);
-        if (node.hasLight)
-            renderLightInHierarchy(scene, nodeIdx);
-        if (node.meshIndex >= 0)
-            renderMeshInHierarchy(scene, nodeIdx);
+void renderSearchResults(SceneGraph& scene, SceneBrowserCache& cache) {
+    ImGui::TextDisabled("%zu matches", cache.searchResults.size());
+    if (!ImGui::BeginTable("SceneSearchTable", 1, kBrowserTableFlags))
+        return;
 
-        for (uint32_t childIdx : node.children) {
-            if (isValidNode(scene, childIdx) && !scene.nodes[childIdx].generatedPrimitive)
-                renderNodeHierarchy(scene, childIdx);
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(cache.searchResults.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            const uint32_t nodeIdx = cache.searchResults[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::PushID(static_cast<int>(nodeIdx));
+            const bool selected = scene.selectedNode == static_cast<int32_t>(nodeIdx);
+            const SceneNode& node = scene.nodes[nodeIdx];
+            const std::string label = "[" + std::to_string(node.id) + "] " + nodeDisplayName(node);
+            if (ImGui::Selectable(label.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns)) {
+                scene.selectedNode = static_cast<int32_t>(nodeIdx);
+                revealNode(cache, scene, nodeIdx);
+            }
+            ImGui::PopID();
         }
-
-        ImGui::TreePop();
     }
+    ImGui::EndTable();
 }
 
 void renderSceneGraphTab(SceneGraph& scene) {
+    SceneBrowserCache& cache = browserCache();
+
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::InputTextWithHint("##SceneSearch", "Search nodes", cache.searchText, sizeof(cache.searchText)))
+        rebuildSearchResults(cache);
+    if (!cache.activeSearch.empty()) {
+        // Picking a result clears the search and shows the node in the tree.
+        renderSearchResults(scene, cache);
+        if (cache.revealNode >= 0) {
+            cache.searchText[0] = '\0';
+            rebuildSearchResults(cache);
+        }
+        return;
+    }
+
+    if (cache.rowsDirty) {
+        rebuildTreeRows(cache, scene);
+        cache.rowsDirty = false;
+    }
+
     if (ImGui::BeginTable("SceneGraphTable", 2, kBrowserTableFlags)) {
         ImGui::TableSetupScrollFreeze(0, 1);
         ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_NoHide | ImGuiTableColumnFlags_WidthStretch);
         ImGui::TableSetupColumn(" ", ImGuiTableColumnFlags_NoHide | ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("VH").x + 16.0f);
         ImGui::TableHeadersRow();
 
-        ImGui::TableNextRow();
-        ImGui::TableNextColumn();
-
-        ImGuiTreeNodeFlags sceneFlags =
-            ImGuiTreeNodeFlags_SpanAllColumns |
-            ImGuiTreeNodeFlags_SpanFullWidth |
-            ImGuiTreeNodeFlags_SpanTextWidth |
-            ImGuiTreeNodeFlags_OpenOnArrow |
-            ImGuiTreeNodeFlags_DefaultOpen;
-
-        const bool open = ImGui::TreeNodeEx(reinterpret_cast<void*>(kSceneTreeId), sceneFlags, "Scene-0");
-
-        ImGui::TableNextColumn();
-        ImGui::TextDisabled("T");
-        if (ImGui::IsItemHovered())
-            ImGui::SetTooltip("Scene root");
+        int revealRow = -1;
+        if (cache.revealNode >= 0) {
+            for (size_t i = 0; i < cache.rows.size(); ++i) {
+                if (cache.rows[i].kind == TreeRowKind::Node &&
+                    cache.rows[i].node == static_cast<uint32_t>(cache.revealNode)) {
+                    revealRow = static_cast<int>(i);
+                    break;
+                }
+            }
+            cache.revealNode = -1;
+        }
 
-        if (open) {
-            for (uint32_t rootIdx : scene.rootNodes) {
-                if (isValidNode(scene, rootIdx))
-                    renderNodeHierarchy(scene, rootIdx);
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(cache.rows.size()));
+        if (revealRow >= 0)
+            clipper.IncludeItemByIndex(revealRow);
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                renderTreeRow(scene, cache, cache.rows[i]);
+                if (i == revealRow)
+                    ImGui::SetScrollHereY();
             }
-            ImGui::TreePop();
         }
 
         ImGui::EndTable();
@@ -375,114 +499,71 @@ float listChildHeight(size_t rowCount) {
     return std::clamp(rowCount * line + ImGui::GetStyle().FramePadding.y * 2.0f, 60.0f, 220.0f);
 }
 
-void renderNodesGroup(SceneGraph& scene) {
-    const size_t nodeCount = countDisplayNodes(scene);
-    const std::string header = "[N] Nodes (" + std::to_string(nodeCount) + ")";
-    if (!ImGui::CollapsingHeader(header.c_str()))
-        return;
-
-    ImGui::BeginChild("NodesScrollRegion", ImVec2(0.0f, listChildHeight(nodeCount)), false, ImGuiWindowFlags_HorizontalScrollbar);
-    for (size_t i = 0; i < scene.nodes.size(); ++i) {
-        const SceneNode& node = scene.nodes[i];
-        if (node.generatedPrimitive)
-            continue;
-        const bool selected = scene.selectedNode == static_cast<int32_t>(i);
-        const std::string label = "[" + std::to_string(node.id) + "] " + nodeDisplayName(node);
-        if (ImGui::Selectable(label.c_str(), selected))
-            scene.selectedNode = static_cast<int32_t>(i);
-    }
-    ImGui::EndChild();
-}
-
-void renderMeshesGroup(SceneGraph& scene) {
-    const size_t meshCount = countMeshNodes(scene);
-    const std::string header = "[M] Meshes (" + std::to_string(meshCount) + ")";
+// One Scene List group: a collapsing header over a clipped list of nodes.
+template <typename LabelFn>
+void renderListGroup(SceneGraph& scene,
+                     const char* title,
+                     const char* childId,
+                     const std::vector<uint32_t>& nodeIndices,
+                     LabelFn&& makeLabel) {
+    const std::string header = std::string(title) + " (" + std::to_string(nodeIndices.size()) + ")";
     if (!ImGui::CollapsingHeader(header.c_str()))
         return;
 
-    ImGui::BeginChild("MeshesScrollRegion", ImVec2(0.0f, listChildHeight(meshCount)), false, ImGuiWindowFlags_HorizontalScrollbar);
-    for (size_t i = 0; i < scene.nodes.size(); ++i) {
-        const SceneNode& node = scene.nodes[i];
-        if (node.generatedPrimitive || node.meshIndex < 0)
-            continue;
-        const bool selected = scene.selectedNode == static_cast<int32_t>(i);
-        const std::string label = meshDisplayName(node);
-        if (ImGui::Selectable(label.c_str(), selected))
-            scene.selectedNode = static_cast<int32_t>(i);
+    ImGui::BeginChild(childId, ImVec2(0.0f, listChildHeight(nodeIndices.size())), false, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(nodeIndices.size()));
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const uint32_t i = nodeIndices[row];
+            const bool selected = scene.selectedNode == static_cast<int32_t>(i);
+            ImGui::PushID(static_cast<int>(i));
+            if (ImGui::Selectable(makeLabel(scene.nodes[i]).c_str(), selected))
+                scene.selectedNode = static_cast<int32_t>(i);
+            ImGui::PopID();
+        }
     }
     ImGui::EndChild();
 }
 
-void renderPrimitivesGroup(SceneGraph& scene) {
-    const size_t primitiveCount = countPrimitiveRows(scene);
-    const std::string header = "[P] Primitives (" + std::to_string(primitiveCount) + ")";
-    if (!ImGui::CollapsingHeader(header.c_str()))
-        return;
-
-    ImGui::BeginChild("PrimitivesScrollRegion", ImVec2(0.0f, listChildHeight(primitiveCount)), false, ImGuiWindowFlags_HorizontalScrollbar);
-    for (size_t i = 0; i < scene.nodes.size(); ++i) {
-        const SceneNode& node = scene.nodes[i];
-        if (!node.generatedPrimitive && node.primitiveGroupCount == 0)
-            continue;
-
-        const bool selected = scene.selectedNode == static_cast<int32_t>(i);
+void renderSceneListTab(SceneGraph& scene) {
+    const SceneBrowserCache& cache = browserCache();
+    renderListGroup(scene, "[N] Nodes", "NodesScrollRegion", cache.displayNodes, [](const SceneNode& node) {
+        return "[" + std::to_string(node.id) + "] " + nodeDisplayName(node);
+    });
+    renderListGroup(scene, "[M] Meshes", "MeshesScrollRegion", cache.meshNodes, [](const SceneNode& node) {
+        return meshDisplayName(node);
+    });
+    renderListGroup(scene, "[P] Primitives", "PrimitivesScrollRegion", cache.primitiveNodes, [&](const SceneNode& node) {
         std::string label = "[" + std::to_string(node.primitiveGroupStart) + "] Primitive " +
             std::to_string(node.primitiveIndexInMesh);
         if (node.parent >= 0 && node.parent < static_cast<int32_t>(scene.nodes.size()))
             label += "  (" + nodeDisplayName(scene.nodes[node.parent]) + ")";
         else if (!node.name.empty())
             label += "  (" + node.name + ")";
-
-        if (ImGui::Selectable(label.c_str(), selected))
-            scene.selectedNode = static_cast<int32_t>(i);
-    }
-    ImGui::EndChild();
+        return label;
+    });
+    renderListGroup(scene, "[C] Cameras", "CamerasScrollRegion", cache.cameraNodes, [](const SceneNode& node) {
+        return "[" + std::to_string(node.cameraIndex) + "] " + cameraDisplayName(node);
+    });
+    renderListGroup(scene, "[L] Lights", "LightsScrollRegion", cache.lightNodes, [](const SceneNode& node) {
+        return "[" + std::to_string(node.lightIndex) + "] " + lightDisplayName(node);
+    });
 }
 
-void renderCamerasGroup(SceneGraph& scene) {
-    const size_t cameraCount = countCameras(scene);
-    const std::string header = "[C] Cameras (" + std::to_string(cameraCount) + ")";
-    if (!ImGui::CollapsingHeader(header.c_str()))
-        return;
-
-    ImGui::BeginChild("CamerasScrollRegion", ImVec2(0.0f, listChildHeight(cameraCount)), false, ImGuiWindowFlags_HorizontalScrollbar);
-    for (size_t i = 0; i < scene.nodes.size(); ++i) {
-        const SceneNode& node = scene.nodes[i];
-        if (node.cameraIndex < 0)
-            continue;
-        const bool selected = scene.selectedNode == static_cast<int32_t>(i);
-        const std::string label = "[" + std::to_string(node.cameraIndex) + "] " + cameraDisplayName(node);
-        if (ImGui::Selectable(label.c_str(), selected))
-            scene.selectedNode = static_cast<int32_t>(i);
-    }
-    ImGui::EndChild();
-}
-
-void renderLightsGroup(SceneGraph& scene) {
-    const size_t lightCount = countLights(scene);
-    const std::string header = "[L] Lights (" + std::to_string(lightCount) + ")";
-    if (!ImGui::CollapsingHeader(header.c_str()))
-        return;
-
-    ImGui::BeginChild("LightsScrollRegion", ImVec2(0.0f, listChildHeight(lightCount)), false, ImGuiWindowFlags_HorizontalScrollbar);
-    for (size_t i = 0; i < scene.nodes.size(); ++i) {
-        const SceneNode& node = scene.nodes[i];
-        if (!node.hasLight)
-            continue;
-        const bool selected = scene.selectedNode == static_cast<int32_t>(i);
-        const std::string label = "[" + std::to_string(node.lightIndex) + "] " + lightDisplayName(node);
-        if (ImGui::Selectable(label.c_str(), selected))
-            scene.selectedNode = static_cast<int32_t>(i);
+void renderAssetInfoTab(const SceneGraph& scene) {
+    const SceneBrowserCache& cache = browserCache();
+    if (ImGui::BeginTable("SceneAssetInfoTable", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Property", ImGuiTableColumnFlags_WidthFixed, 150.0f);
+        ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+        statRow("Root Nodes", scene.rootNodes.size());
+        statRow("Nodes", cache.displayNodes.size());
+        statRow("Mesh Nodes", cache.meshNodes.size());
+        statRow("Primitive Rows", cache.primitiveNodes.size());
+        statRow("Lights", cache.lightNodes.size());
+        statRow("Cameras", cache.cameraNodes.size());
+        ImGui::EndTable();
     }
-    ImGui::EndChild();
-}
-
-void renderSceneListTab(SceneGraph& scene) {
-    renderNodesGroup(scene);
-    renderMeshesGroup(scene);
-    renderPrimitivesGroup(scene);
-    renderCamerasGroup(scene);
-    renderLightsGroup(scene);
 }
 
 void renderTransformSection(SceneGraph& scene, uint32_t nodeIdx) {
@@ -555,6 +636,25 @@ void renderLightSection(SceneGraph& scene, uint32_t nodeIdx) {
     if (!ImGui::CollapsingHeader("LIGHT", ImGuiTreeNodeFlags_DefaultOpen))
         return;
 
+    if (node.light.type != LightType::Directional) {
+        ImGui::Text("Type: %s", node.light.type == LightType::Spot ? "Spot" : "Point");
+        if (node.lightIndex >= 0)
+            ImGui::Text("Light Index: %d", node.lightIndex);
+
+        PunctualLight& punctual = node.light.punctual;
+        float color[3] = {punctual.color.x, punctual.color.y, punctual.color.z};
+        if (ImGui::ColorEdit3("Color", color))
+            punctual.color = float3(color[0], color[1], color[2]);
+        ImGui::DragFloat("Intensity (cd)", &punctual.intensity, 0.1f, 0.0f, 100000.0f);
+        ImGui::DragFloat("Range", &punctual.range, 0.05f, 0.0f, 10000.0f, punctual.range > 0.0f ? "%.2f" : "auto");
+        if (node.light.type == LightType::Spot) {
+            ImGui::SliderAngle("Inner Cone", &punctual.innerConeAngle, 0.0f, 90.0f);
+            ImGui::SliderAngle("Outer Cone", &punctual.outerConeAngle, 0.0f, 90.0f);
+            punctual.innerConeAngle = std::min(punctual.innerConeAngle, punctual.outerConeAngle);
+        }
+        return;
+    }
+
     ImGui::Text("Type: Directional");
     if (node.lightIndex >= 0)
         ImGui::Text("Light Index: %d", node.lightIndex);
@@ -639,7 +739,9 @@ void renderInspector(SceneGraph& scene) {
         ImGui::TextDisabled("Parent Node: %d", node.parent);
     ImGui::Separator();
 
-    ImGui::Checkbox("Visible", &node.visible);
+    bool visible = node.visible;
+    if (ImGui::Checkbox("Visible", &visible))
+        scene.setNodeVisible(nodeIdx, visible);
 
     renderTransformSection(scene, nodeIdx);
     renderCameraSection(node);
@@ -652,6 +754,7 @@ void renderInspector(SceneGraph& scene) {
 void drawSceneGraphUI(SceneGraph& scene) {
     ImGui::SetNextWindowSize(ImVec2(500.0f, 520.0f), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Scene Browser")) {
+        syncBrowserCache(browserCache(), scene);
         if (ImGui::CollapsingHeader("Asset Info"))
             renderAssetInfoTab(scene);
 
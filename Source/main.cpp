@@ -26,6 +26,8 @@
 #include "render_uniforms.h"
 #include "render_pass.h"
 #include "shader_manager.h"
+#include "slang_compiler.h"
+#include "startup_profile.h"
 #include "blit_pass.h"
 #include "tonemap_pass.h"
 #include "imgui_overlay_pass.h"
@@ -37,7 +39,11 @@
 #include "pipeline_asset.h"
 #include "pipeline_builder.h"
 #include "frame_context.h"
+#include "frame_arena.h"
+#include "cpu_node_culler.h"
 #include "rhi_window_runtime.h"
+#include "metalfx_context.h"
+#include "dynamic_resolution_controller.h"
 
 
 static bool loadPipelineAssetChecked(const std::string& path,
@@ -61,9 +67,16 @@ static bool loadPipelineAssetChecked(const std::string& path,
     return true;
 }
 
+static bool hasEnabledPassOfType(const PipelineAsset& asset, const char* passType) {
+    return std::any_of(asset.passes.begin(), asset.passes.end(), [&](const PassDecl& pass) {
+        return pass.enabled && pass.type == passType;
+    });
+}
+
 
 
 int main() {
+    StartupProfile::begin();
     if (!glfwInit()) {
         spdlog::error("Failed to initialize GLFW");
         return 1;
@@ -89,6 +102,9 @@ int main() {
     const RhiDevice& device = runtime->device();
     const RhiCommandQueue& commandQueue = runtime->commandQueue();
 
+    MetalFXContext metalFX;
+    metalFX.init(device.nativeHandle());
+
     const char* projectRoot = PROJECT_SOURCE_DIR;
 
     // Load all scene data
@@ -112,11 +128,17 @@ int main() {
     ImGui_ImplGlfw_InitForOther(window, true);
     runtime->initImGui();
 
-    // Build all shader pipelines
+    // Build all shader pipelines. Slang's MSL output is cached like Vulkan's SPIR-V;
+    // the window runtime keeps compiled PSOs in a binary archive.
+    setSlangShaderCacheDir("cache/shaders");
     ShaderManager shaderManager(device, projectRoot);
     if (!shaderManager.buildAll()) return 1;
 
     PipelineRuntimeContext& rtCtx = shaderManager.runtimeContext();
+    rtCtx.useBindlessSceneTextures = runtime->updateBindlessSceneTextures(
+        scene.materials().textureViews.data(),
+        static_cast<uint32_t>(scene.materials().textureViews.size()),
+        scene.materials().sampler);
 
     auto importRuntimeTexture = [&](const std::string& name, const RhiTexture& texture) {
         shaderManager.importTexture(name, texture);
@@ -139,6 +161,8 @@ int main() {
     bool enableAtmosphereSky = skyAvailable;
     bool enableTAA = true;
     uint32_t frameIndex = 0;
+    FrameArenaRing frameArenas(2);
+    CpuNodeCuller nodeCuller;
     float skyExposure = 10.0f;
     bool showGraphDebug = false;
     bool showSceneGraphWindow = true;
@@ -147,6 +171,14 @@ int main() {
     bool exportGraphKeyDown = false;
     bool reloadKeyDown = false;
     bool pipelineReloadKeyDown = false;
+    bool upscalerHistoryReset = true;
+
+    PipelineUiControls pipelineUiControls;
+    pipelineUiControls.onMetalFXPresetChanged = [&](MetalFXPreset preset) {
+        metalFX.setPreset(preset);
+        pipelineUiControls.metalFXPreset = metalFX.preset();
+    };
+    rtCtx.uiControls = &pipelineUiControls;
 
     // Load pipeline assets
     PipelineAsset visPipelineAsset;
@@ -170,10 +202,16 @@ int main() {
     bool pipelineNeedsRebuild = true;
     int lastRenderMode = -1;
     double lastFrameTime = glfwGetTime();
+    double lastAnimationTime = lastFrameTime;
     float4x4 prevView, prevProj;
     float4x4 prevCullView, prevCullProj;
     float4 prevCameraWorldPos = float4(0.f, 0.f, 0.f, 1.f);
     bool hasPrevMatrices = false;
+    bool lastMetalFXActive = false;
+
+    const SlangCompileStats startupShaderStats = getSlangCompileStats();
+    StartupProfile::addCacheCounts("shaders", startupShaderStats.cacheHits, startupShaderStats.cacheMisses);
+    StartupProfile::finish("cache/startup_profile.json");
 
     while (!glfwWindowShouldClose(window)) {
         ZoneScopedN("Frame");
@@ -189,6 +227,38 @@ int main() {
             continue;
         }
 
+        // MetalFX renders the visibility graph below display resolution when the graph
+        // contains an enabled MetalFXUpscalePass; everything else stays at display size.
+        int renderWidth = width;
+        int renderHeight = height;
+        bool metalFXActive = false;
+        if (renderMode == 2 && hasEnabledPassOfType(visPipelineAsset, "MetalFXUpscalePass")) {
+            uint32_t optimalWidth = 0;
+            uint32_t optimalHeight = 0;
+            if (metalFX.getOptimalRenderSize(static_cast<uint32_t>(width),
+                                             static_cast<uint32_t>(height),
+                                             optimalWidth,
+                                             optimalHeight)) {
+                renderWidth = static_cast<int>(optimalWidth);
+                renderHeight = static_cast<int>(optimalHeight);
+                metalFXActive = true;
+            }
+        }
+        if (metalFXActive != lastMetalFXActive) {
+            // The upscale pass decides between evaluating and aliasing its source at setup.
+            pipelineNeedsRebuild = true;
+            upscalerHistoryReset = true;
+            lastMetalFXActive = metalFXActive;
+        }
+        rtCtx.upscaler = metalFX.isAvailable() ? &metalFX : nullptr;
+        rtCtx.displayWidth = width;
+        rtCtx.displayHeight = height;
+        rtCtx.renderWidth = renderWidth;
+        rtCtx.renderHeight = renderHeight;
+        pipelineUiControls.metalFXPreset = metalFX.preset();
+        pipelineUiControls.displayWidth = width;
+        pipelineUiControls.displayHeight = height;
+
         // Compute matrices
         float aspect;
         float4x4 view, proj;
@@ -198,16 +268,19 @@ int main() {
         {
             ZoneScopedN("Matrix Computation");
             aspect = (float)width / (float)height;
+            // Late latch: beginFrame may have waited for a drawable since the poll.
+            latchCameraInput(window, &inputState);
             view = camera.viewMatrix();
             proj = camera.projectionMatrix(aspect);
 
-            // Apply jitter to projection for TAA
-            if (enableTAA) {
-                jitterOffset = OrbitCamera::haltonJitter(frameIndex);
+            // Apply jitter to projection for TAA / MetalFX
+            if (enableTAA || metalFXActive) {
+                jitterOffset = OrbitCamera::haltonJitter(
+                    frameIndex, DynamicResolutionController::jitterPhaseCount(renderWidth, width));
                 proj = OrbitCamera::jitteredProjectionMatrix(
                     camera.fovY, aspect, camera.nearZ, camera.farZ,
                     jitterOffset.x, jitterOffset.y,
-                    static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+                    static_cast<uint32_t>(renderWidth), static_cast<uint32_t>(renderHeight));
             }
 
             // Light data from scene graph sun source.
@@ -229,6 +302,9 @@ int main() {
                 camera.target.z + camera.distance * cosE * cosA,
                 1.0f);
 
+            const double animationTime = glfwGetTime();
+            scene.advanceAnimations(static_cast<float>(animationTime - lastAnimationTime));
+            lastAnimationTime = animationTime;
             scene.sceneGraph().updateTransforms();
             scene.updateGpuScene();
         }
@@ -358,23 +434,17 @@ int main() {
             renderMode == 1 || ((renderMode == 2 || renderMode == 3) && !gpuDrivenVisibilityPath);
         const bool needsCpuIndexVisibility = renderMode == 0;
 
-        std::vector<uint32_t> visibleMeshletNodes;
-        std::vector<uint32_t> visibleIndexNodes;
-        if (needsCpuMeshletVisibility) {
-            visibleMeshletNodes.reserve(scene.sceneGraph().nodes.size());
-        }
-        if (needsCpuIndexVisibility) {
-            visibleIndexNodes.reserve(scene.sceneGraph().nodes.size());
-        }
+        // Frame-scoped: the lists and the passes' scratch come out of one arena that is
+        // rewound here instead of going through the heap every frame.
+        FrameArena& frameArena = frameArenas.beginFrame(frameIndex);
+        std::pmr::vector<uint32_t> visibleMeshletNodes(&frameArena);
+        std::pmr::vector<uint32_t> visibleIndexNodes(&frameArena);
         if (needsCpuMeshletVisibility || needsCpuIndexVisibility) {
-            for (const auto& node : scene.sceneGraph().nodes) {
-                if (!scene.sceneGraph().isNodeVisible(node.id))
-                    continue;
-                if (needsCpuMeshletVisibility && node.meshletCount > 0)
-                    visibleMeshletNodes.push_back(node.id);
-                if (needsCpuIndexVisibility && node.indexCount > 0)
-                    visibleIndexNodes.push_back(node.id);
-            }
+            ZoneScopedN("CPU Node Cull");
+            nodeCuller.update(scene.sceneGraph(), scene.gpuScene());
+            nodeCuller.cull(camera.projectionMatrix(aspect) * view,
+                            needsCpuMeshletVisibility ? &visibleMeshletNodes : nullptr,
+                            needsCpuIndexVisibility ? &visibleIndexNodes : nullptr);
         }
 
         FrameContext frameCtx;
@@ -407,8 +477,12 @@ int main() {
         }
 
         // Populate frame context (shared across all modes)
-        frameCtx.width = width;
-        frameCtx.height = height;
+        frameCtx.width = renderWidth;
+        frameCtx.height = renderHeight;
+        frameCtx.displayWidth = width;
+        frameCtx.displayHeight = height;
+        frameCtx.renderWidth = renderWidth;
+        frameCtx.renderHeight = renderHeight;
         frameCtx.view = view;
         frameCtx.proj = proj;
         frameCtx.unjitteredProj = camera.projectionMatrix(aspect);
@@ -421,8 +495,10 @@ int main() {
         frameCtx.textureCount = static_cast<uint32_t>(scene.materials().textures.size());
         frameCtx.visibleMeshletNodes = visibleMeshletNodes;
         frameCtx.visibleIndexNodes = visibleIndexNodes;
+        frameCtx.frameMemory = &frameArena;
         frameCtx.visibilityInstanceCount = visibilityInstanceCount;
         frameCtx.depthClearValue = scene.depthClearValue();
+        frameCtx.cameraNearZ = camera.nearZ;
         frameCtx.cameraFarZ = camera.farZ;
         {
             double now = glfwGetTime();
@@ -443,6 +519,7 @@ int main() {
         frameCtx.jitterOffset = jitterOffset;
         frameCtx.frameIndex = frameIndex;
         frameCtx.enableTAA = enableTAA;
+        frameCtx.historyReset = upscalerHistoryReset;
 
         // Select active pipeline asset based on render mode
         const PipelineAsset& activePipelineAsset =
@@ -456,9 +533,10 @@ int main() {
         }
 
         // Rebuild pipeline only when needed (first frame, F6 reload, resolution change, mode switch)
-        if (pipelineNeedsRebuild || pipelineBuilder.needsRebuild(width, height)) {
+        if (pipelineNeedsRebuild || pipelineBuilder.needsRebuild(renderWidth, renderHeight)) {
             rtCtx.backbufferRhi = &runtime->currentBackbufferTexture();
-            bool buildSucceeded = pipelineBuilder.build(activePipelineAsset, rtCtx, width, height);
+            bool buildSucceeded = pipelineBuilder.build(activePipelineAsset, rtCtx, renderWidth, renderHeight);
+            frameCtx.historyReset = true;
             if (!buildSucceeded) {
                 spdlog::error("Failed to build pipeline: {}", pipelineBuilder.lastError());
             } else {
@@ -509,6 +587,7 @@ int main() {
         prevCullProj = proj;
         prevCameraWorldPos = cameraWorldPos;
         hasPrevMatrices = true;
+        upscalerHistoryReset = false;
         frameIndex++;
 
         FrameMark;
@@ -18,15 +18,18 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <cmath>
-#include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <vector>
 
 #include "camera.h"
 #include "cluster_streaming_service.h"
+#include "dynamic_resolution_controller.h"
 #include "frame_context.h"
 #include "frame_graph.h"
 #include "nsight_markers.h"
@@ -43,16 +46,36 @@
 #include "bindless_scene_constants.h"
 #include "raytraced_shadows.h"
 #include "rhi_resource_utils.h"
+#include "streaming_soak_benchmark.h"
+#include "frame_benchmark.h"
+#include "image_sequence_capture.h"
+#include "gpu_kernel_benchmark.h"
+#include "job_system.h"
+#include "render_thread.h"
+#include "frame_arena.h"
+#include "cpu_node_culler.h"
+#include "slow_frame_capture.h"
+#include "startup_profile.h"
+#include "asset_cook.h"
+#include "asset_microbenchmark.h"
+#include "camera_timeline.h"
+#include "cpu_profile_zones.h"
+#include "gpu_driven_telemetry.h"
+#include "lod_budget_controller.h"
+#include "render_on_demand.h"
 #include "rhi_shader_utils.h"
 #include "shader_manager.h"
+#include "shadow_cascades.h"
 #include "slang_compiler.h"
 #include "visibility_constants.h"
+#include "viewport_pick.h"
 #include "scene_context.h"
 #include "scene_graph_ui.h"
 #include "cluster_lod_builder.h"
 #include "vulkan_backend.h"
 #include "vulkan_frame_graph.h"
 #include "vulkan_descriptor_buffer.h"
+#include "vulkan_memory_accounting.h"
 #include "vulkan_transient_allocator.h"
 #include "vulkan_upload_service.h"
 #include "streamline_context.h"
@@ -148,6 +171,134 @@ std::string formatByteCountShort(uint64_t byteCount) {
     return buffer;
 }
 
+std::vector<FGGpuScopeSample> frameGraphGpuScopeSamples(const VulkanGpuFrameDiagnostics& diagnostics) {
+    std::vector<FGGpuScopeSample> samples;
+    samples.reserve(diagnostics.scopes.size());
+    for (const VulkanGpuScopeTiming& scope : diagnostics.scopes) {
+        FGGpuScopeSample& sample = samples.emplace_back();
+        sample.label = scope.label;
+        sample.durationMs = scope.durationMs;
+        sample.hasPipelineStats = scope.pipelineStats.valid;
+        sample.primitives = scope.pipelineStats.clippingInvocations;
+        sample.vertexInvocations = scope.pipelineStats.vertexShaderInvocations;
+        sample.fragmentInvocations = scope.pipelineStats.fragmentShaderInvocations;
+        sample.computeInvocations = scope.pipelineStats.computeShaderInvocations;
+        sample.meshInvocations = scope.pipelineStats.meshShaderInvocations;
+    }
+    return samples;
+}
+
+// Streaming state written next to a slow frame dump; the per-frame counters are
+// already in the dump's history.
+nlohmann::json slowFrameStreamingJson(const ClusterStreamingService& service) {
+    const ClusterStreamingService::StreamingStats& stats = service.streamingStats();
+    const ClusterStreamingService::DebugStats& debug = service.debugStats();
+    return nlohmann::json{
+        {"residentGroups", stats.residentGroupCount},
+        {"residentClusters", stats.residentClusterCount},
+        {"storagePoolUsedBytes", stats.storagePoolUsedBytes},
+        {"storagePoolCapacityBytes", stats.storagePoolCapacityBytes},
+        {"storagePoolReservedBytes", stats.storagePoolReservedBytes},
+        {"storageFragmentation", stats.storageFragmentation},
+        {"loadsDeferred", stats.loadsDeferredThisFrame},
+        {"transferUtilization", stats.transferUtilization},
+        {"defragMoves", stats.defragMovesThisFrame},
+        {"popLatencyMaxFrames", stats.popLatencyMaxFrames},
+        {"groupPageReadFailures", stats.groupPageReadFailures},
+        {"effectiveAgeThreshold", stats.effectiveAgeThreshold},
+        {"cpuUnloadFallbackActive", stats.cpuUnloadFallbackActive},
+        {"graphicsTransferFallbackActive", stats.graphicsTransferFallbackActive},
+        {"pendingResidencyGroups", debug.pendingResidencyGroupCount},
+        {"pendingUnloadGroups", debug.pendingUnloadGroupCount},
+        {"streamingTaskStalls", debug.streamingTaskStallCount},
+        {"taskPrepareLatencyMs", debug.taskPrepareLatencyMs},
+        {"taskTransferLatencyMs", debug.taskTransferLatencyMs},
+        {"taskRetireLatencyMs", debug.taskRetireLatencyMs},
+    };
+}
+
+// Per-subsystem VRAM from VulkanMemoryAccounting against the live budget. Usage the
+// accounting does not see (raw VMA allocations, driver internals) shows as Untracked.
+void renderVramAccountingUI(const VulkanMemoryBudgetInfo& budget) {
+    static constexpr size_t kTopAllocationCount = 10;
+    const VulkanMemoryAccountingSnapshot snapshot = vulkanMemoryAccounting().snapshot(kTopAllocationCount);
+    if (budget.available && budget.deviceLocalBudgetBytes > 0u) {
+        const double usage = static_cast<double>(budget.deviceLocalUsageBytes) /
+                             static_cast<double>(budget.deviceLocalBudgetBytes);
+        char overlay[64] = {};
+        std::snprintf(overlay, sizeof(overlay), "%s / %s",
+                      formatByteCountShort(budget.deviceLocalUsageBytes).c_str(),
+                      formatByteCountShort(budget.deviceLocalBudgetBytes).c_str());
+        ImGui::ProgressBar(static_cast<float>(std::min(usage, 1.0)), ImVec2(-1.0f, 0.0f), overlay);
+        if (usage > VulkanMemoryAccounting::kBudgetWarningFraction) {
+            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f),
+                               "VRAM above %.0f%% of budget - trim the largest subsystems below",
+                               VulkanMemoryAccounting::kBudgetWarningFraction * 100.0);
+        }
+    } else {
+        ImGui::TextDisabled("VRAM budget: VK_EXT_memory_budget unavailable");
+    }
+
+    if (ImGui::BeginTable("VramByTag", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Subsystem");
+        ImGui::TableSetupColumn("VRAM");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableSetupColumn("Host");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableHeadersRow();
+        for (size_t tag = 0; tag < snapshot.tags.size(); ++tag) {
+            const VulkanMemoryTagStats& stats = snapshot.tags[tag];
+            if (stats.allocationCount == 0u && stats.peakDeviceLocalBytes == 0u) {
+                continue;
+            }
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(rhiMemoryTagName(static_cast<RhiMemoryTag>(tag)));
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(formatByteCountShort(stats.deviceLocalBytes).c_str());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::TextUnformatted(formatByteCountShort(stats.peakDeviceLocalBytes).c_str());
+            ImGui::TableSetColumnIndex(3);
+            ImGui::TextUnformatted(formatByteCountShort(stats.hostBytes).c_str());
+            ImGui::TableSetColumnIndex(4);
+            ImGui::Text("%u", stats.allocationCount);
+        }
+        if (budget.available) {
+            const uint64_t untracked =
+                budget.deviceLocalUsageBytes > snapshot.trackedDeviceLocalBytes
+                    ? budget.deviceLocalUsageBytes - snapshot.trackedDeviceLocalBytes
+                    : 0u;
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextDisabled("Untracked");
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextDisabled("%s", formatByteCountShort(untracked).c_str());
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::Button("Reset Peaks")) {
+        vulkanMemoryAccounting().resetPeaks();
+    }
+
+    if (!snapshot.topAllocations.empty() &&
+        ImGui::BeginTable("VramTopAllocations", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Largest Allocations");
+        ImGui::TableSetupColumn("Subsystem");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableHeadersRow();
+        for (const VulkanMemoryAllocationRecord& record : snapshot.topAllocations) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(record.name.c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(rhiMemoryTagName(record.tag));
+            ImGui::TableSetColumnIndex(2);
+            ImGui::TextUnformatted(formatByteCountShort(record.bytes).c_str());
+        }
+        ImGui::EndTable();
+    }
+}
+
 struct StreamingDashboardHistory {
     static constexpr int kSampleCount = 120;
 
@@ -205,24 +356,6 @@ std::string formatVulkanVersion(uint32_t version) {
            std::to_string(VK_API_VERSION_PATCH(version));
 }
 
-struct AtmosphereTextures {
-    RhiTextureHandle transmittance;
-    RhiTextureHandle scattering;
-    RhiTextureHandle irradiance;
-
-    bool isValid() const {
-        return transmittance.nativeHandle() &&
-               scattering.nativeHandle() &&
-               irradiance.nativeHandle();
-    }
-
-    void release() {
-        rhiReleaseHandle(transmittance);
-        rhiReleaseHandle(scattering);
-        rhiReleaseHandle(irradiance);
-    }
-};
-
 void eraseResourceById(PipelineAsset& asset, const std::string& resourceId) {
     asset.removeEdgesForResource(resourceId);
     asset.resources.erase(
@@ -499,6 +632,18 @@ void normalizePipelineFinalDisplayOutput(PipelineAsset& asset) {
     }
 }
 
+// The Vulkan editor shows the graph output as an ImGui::Image inside the docked UI,
+// so the graph renders into the viewport texture and the UI is drawn into the
+// swapchain afterwards. An in-graph overlay would land inside the viewport image.
+void removePipelineUiOverlay(PipelineAsset& asset) {
+    erasePassByType(asset, "ImGuiOverlayPass");
+    for (auto& pass : asset.passes) {
+        if (pass.type == "OutputPass" && pass.config.is_object()) {
+            pass.config.erase("overlay");
+        }
+    }
+}
+
 void disablePipelineAutoExposure(PipelineAsset& asset) {
     std::vector<std::string> producedResourceIds;
     for (const auto& pass : asset.passes) {
@@ -552,16 +697,104 @@ void disableVisibilityRayTracing(PipelineAsset& asset) {
     }
 }
 
+bool isShadowCascadePass(const PassDecl& pass) {
+    return pass.type == "ShadowCascadeResolvePass" ||
+           (pass.config.is_object() && pass.config.contains("shadowCascade"));
+}
+
+// Drops the cascade cull/raster passes, the resolve and everything only they touch.
+void disableVisibilityShadowCascades(PipelineAsset& asset) {
+    std::vector<std::string> touchedResourceIds;
+    std::vector<std::string> passIds;
+    for (const auto& pass : asset.passes) {
+        if (!isShadowCascadePass(pass)) {
+            continue;
+        }
+        passIds.push_back(pass.id);
+        for (const auto& edge : asset.edges) {
+            if (edge.passId == pass.id) {
+                touchedResourceIds.push_back(edge.resourceId);
+            }
+        }
+    }
+
+    for (const auto& passId : passIds) {
+        asset.removeEdgesForPass(passId);
+    }
+    asset.passes.erase(
+        std::remove_if(asset.passes.begin(), asset.passes.end(), isShadowCascadePass),
+        asset.passes.end());
+
+    for (const auto& resourceId : touchedResourceIds) {
+        const bool stillBound = std::any_of(asset.edges.begin(),
+                                            asset.edges.end(),
+                                            [&resourceId](const EdgeDecl& edge) {
+                                                return edge.resourceId == resourceId;
+                                            });
+        if (!stillBound) {
+            eraseResourceById(asset, resourceId);
+        }
+    }
+}
+
+// Replaces ShadowRayPass with the cascade resolve as DeferredLightingPass's shadow source.
+void useVisibilityShadowCascades(PipelineAsset& asset) {
+    const PassDecl* resolvePass = findFirstEnabledPassByType(asset, "ShadowCascadeResolvePass");
+    const EdgeDecl* resolveOutput = findPassSlotBinding(asset, resolvePass, "output", "shadowMap");
+    if (!resolveOutput) {
+        disableVisibilityRayTracing(asset);
+        disableVisibilityShadowCascades(asset);
+        return;
+    }
+
+    const std::string cascadeShadowMapId = resolveOutput->resourceId;
+    disableVisibilityRayTracing(asset);
+    for (auto& pass : asset.passes) {
+        if (pass.type == "DeferredLightingPass") {
+            ensurePassSlotBinding(asset, pass, "input", "shadowMap", cascadeShadowMapId);
+        }
+    }
+}
+
+// Swaps TAAPass for TemporalUpscalePass in place. Both read source, depth and motion
+// vectors, so only the type and the output slot change; consumers of the TAA output
+// keep their edges and now receive display-resolution color.
+bool useVisibilityTemporalUpscaler(PipelineAsset& asset) {
+    bool replaced = false;
+    for (auto& pass : asset.passes) {
+        if (!pass.enabled || pass.type != "TAAPass") {
+            continue;
+        }
+        pass.type = "TemporalUpscalePass";
+        pass.name = "Temporal Upscale";
+        if (EdgeDecl* output = asset.findEdge(pass.id, "output", "taaOutput")) {
+            output->slotKey = "upscaledOutput";
+        }
+        replaced = true;
+    }
+    return replaced;
+}
+
+// DeferredLightingPass configured with inlineShadowRays traces the sun rays itself.
+bool visibilityLightingTracesShadows(const PipelineAsset& asset) {
+    return std::any_of(asset.passes.begin(), asset.passes.end(), [](const PassDecl& pass) {
+        return pass.type == "DeferredLightingPass" && pass.config.is_object() &&
+               pass.config.value("inlineShadowRays", false);
+    });
+}
+
 enum class VisibilityUpscalerMode {
     None,
     TAA,
     DLSS,
+    Temporal,
 };
 
 struct VisibilityUpscalerSelection {
     VisibilityUpscalerMode activeMode = VisibilityUpscalerMode::None;
     bool hasTaaPass = false;
     bool hasDlssPass = false;
+    bool hasTemporalUpscalePass = false;
     std::string activePostSource;
     std::string diagnostic;
 };
@@ -598,8 +831,10 @@ VisibilityUpscalerSelection analyzeVisibilityUpscalerSelection(const PipelineAss
     const PassDecl* outputPass = findFirstEnabledPassByType(asset, "OutputPass");
     const PassDecl* autoExposurePass = findFirstEnabledPassByType(asset, "AutoExposurePass");
 
-    selection.hasTaaPass = findFirstEnabledPassByType(asset, "TAAPass") != nullptr;
+    selection.hasTaaPass = findFirstEnabledPassByType(asset, "TAAPass") != nullptr ||
+                           findFirstEnabledPassByType(asset, "FusedPostPass") != nullptr;
     selection.hasDlssPass = findFirstEnabledPassByType(asset, "StreamlineDlssPass") != nullptr;
+    selection.hasTemporalUpscalePass = findFirstEnabledPassByType(asset, "TemporalUpscalePass") != nullptr;
 
     const ResourceDecl* tonemapSource =
         findPassBoundResource(asset, tonemapPass, "input", "source");
@@ -617,10 +852,13 @@ VisibilityUpscalerSelection analyzeVisibilityUpscalerSelection(const PipelineAss
         autoExposureSource ? findEnabledProducerForResource(asset, autoExposureSource->id) : nullptr;
 
     if (activePostProducer) {
-        if (activePostProducer->type == "TAAPass") {
+        // FusedPostPass resolves TAA itself and feeds OutputPass directly.
+        if (activePostProducer->type == "TAAPass" || activePostProducer->type == "FusedPostPass") {
             selection.activeMode = VisibilityUpscalerMode::TAA;
         } else if (activePostProducer->type == "StreamlineDlssPass") {
             selection.activeMode = VisibilityUpscalerMode::DLSS;
+        } else if (activePostProducer->type == "TemporalUpscalePass") {
+            selection.activeMode = VisibilityUpscalerMode::Temporal;
         }
     }
 
@@ -671,6 +909,15 @@ VisibilityUpscalerSelection analyzeVisibilityUpscalerSelection(const PipelineAss
         return selection;
     }
 
+    if (selection.hasTemporalUpscalePass) {
+        selection.diagnostic = !selection.activePostSource.empty()
+            ? "TemporalUpscalePass exists, but the active post chain still uses '" +
+                  selection.activePostSource + "'."
+            : std::string("TemporalUpscalePass is present, but TonemapPass.source/OutputPass.source "
+                          "is not bound to TemporalUpscalePass.upscaledOutput.");
+        return selection;
+    }
+
     if (selection.hasTaaPass) {
         if (autoExposureProducer && autoExposureProducer->type == "TAAPass") {
             selection.diagnostic =
@@ -700,6 +947,8 @@ const char* visibilityUpscalerModeName(VisibilityUpscalerMode mode) {
         return "TAA";
     case VisibilityUpscalerMode::DLSS:
         return "DLSS";
+    case VisibilityUpscalerMode::Temporal:
+        return "Temporal";
     default:
         return "None";
     }
@@ -712,38 +961,6 @@ void framebufferResizeCallback(GLFWwindow* window, int width, int height) {
     }
 }
 
-std::vector<float> loadFloatData(const std::string& path, size_t expectedCount) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        spdlog::warn("Atmosphere: missing texture data {}", path);
-        return {};
-    }
-
-    file.seekg(0, std::ios::end);
-    const size_t size = static_cast<size_t>(file.tellg());
-    file.seekg(0, std::ios::beg);
-    if (size == 0 || size % sizeof(float) != 0) {
-        spdlog::warn("Atmosphere: invalid data size {} ({} bytes)", path, size);
-        return {};
-    }
-
-    std::vector<float> data(size / sizeof(float));
-    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
-    if (!file) {
-        spdlog::warn("Atmosphere: failed to read {}", path);
-        return {};
-    }
-
-    if (expectedCount > 0 && data.size() != expectedCount) {
-        spdlog::warn("Atmosphere: unexpected element count in {} ({} vs {})",
-                     path,
-                     data.size(),
-                     expectedCount);
-    }
-
-    return data;
-}
-
 bool loadPipelineAssetChecked(const std::string& path,
                               const char* label,
                               PipelineAsset& outAsset) {
@@ -768,82 +985,6 @@ bool loadPipelineAssetChecked(const std::string& path,
     return true;
 }
 
-bool loadAtmosphereTextures(const RhiDevice& device,
-                            const char* projectRoot,
-                            AtmosphereTextures& outTextures) {
-    constexpr uint32_t kTransmittanceWidth = 256;
-    constexpr uint32_t kTransmittanceHeight = 64;
-    constexpr uint32_t kScatteringWidth = 256;
-    constexpr uint32_t kScatteringHeight = 128;
-    constexpr uint32_t kScatteringDepth = 32;
-    constexpr uint32_t kIrradianceWidth = 64;
-    constexpr uint32_t kIrradianceHeight = 16;
-
-    const std::string basePath = std::string(projectRoot) + "/Asset/Atmosphere/";
-    const auto transmittance = loadFloatData(basePath + "transmittance.dat",
-                                             static_cast<size_t>(kTransmittanceWidth) *
-                                                 kTransmittanceHeight * 4);
-    const auto scattering = loadFloatData(basePath + "scattering.dat",
-                                          static_cast<size_t>(kScatteringWidth) *
-                                              kScatteringHeight * kScatteringDepth * 4);
-    const auto irradiance = loadFloatData(basePath + "irradiance.dat",
-                                          static_cast<size_t>(kIrradianceWidth) *
-                                              kIrradianceHeight * 4);
-
-    if (transmittance.empty() || scattering.empty() || irradiance.empty()) {
-        return false;
-    }
-
-    outTextures.release();
-    outTextures.transmittance = rhiCreateTexture2D(device,
-                                                   kTransmittanceWidth,
-                                                   kTransmittanceHeight,
-                                                   RhiFormat::RGBA32Float,
-                                                   false,
-                                                   1,
-                                                   RhiTextureStorageMode::Shared,
-                                                   RhiTextureUsage::ShaderRead);
-    outTextures.scattering = rhiCreateTexture3D(device,
-                                                kScatteringWidth,
-                                                kScatteringHeight,
-                                                kScatteringDepth,
-                                                RhiFormat::RGBA32Float,
-                                                RhiTextureStorageMode::Shared,
-                                                RhiTextureUsage::ShaderRead);
-    outTextures.irradiance = rhiCreateTexture2D(device,
-                                                kIrradianceWidth,
-                                                kIrradianceHeight,
-                                                RhiFormat::RGBA32Float,
-                                                false,
-                                                1,
-                                                RhiTextureStorageMode::Shared,
-                                                RhiTextureUsage::ShaderRead);
-
-    if (!outTextures.isValid()) {
-        outTextures.release();
-        return false;
-    }
-
-    rhiUploadTexture2D(outTextures.transmittance,
-                       kTransmittanceWidth,
-                       kTransmittanceHeight,
-                       transmittance.data(),
-                       static_cast<size_t>(kTransmittanceWidth) * 4 * sizeof(float));
-    rhiUploadTexture3D(outTextures.scattering,
-                       kScatteringWidth,
-                       kScatteringHeight,
-                       kScatteringDepth,
-                       scattering.data(),
-                       static_cast<size_t>(kScatteringWidth) * 4 * sizeof(float),
-                       static_cast<size_t>(kScatteringWidth) * kScatteringHeight * 4 * sizeof(float));
-    rhiUploadTexture2D(outTextures.irradiance,
-                       kIrradianceWidth,
-                       kIrradianceHeight,
-                       irradiance.data(),
-                       static_cast<size_t>(kIrradianceWidth) * 4 * sizeof(float));
-    return true;
-}
-
 PipelineAsset makeSceneColorPostPipelineAsset() {
     PipelineAsset asset;
     asset.schemaVersion = kPipelineAssetSchemaVersion;
@@ -903,23 +1044,13 @@ PipelineAsset makeSceneColorPostPipelineAsset() {
     outputPass.sideEffect = false;
     outputPass.config = nlohmann::json::object();
 
-    PassDecl imguiOverlayPass;
-    imguiOverlayPass.id = generatePipelineAssetGuid();
-    imguiOverlayPass.name = "ImGui Overlay";
-    imguiOverlayPass.type = "ImGuiOverlayPass";
-    imguiOverlayPass.enabled = true;
-    imguiOverlayPass.sideEffect = false;
-    imguiOverlayPass.config = nlohmann::json::object();
-
     asset.passes.push_back(tonemapPass);
     asset.passes.push_back(outputPass);
-    asset.passes.push_back(imguiOverlayPass);
 
     asset.edges.push_back({generatePipelineAssetGuid(), tonemapPass.id, "source", "input", sceneColor.id});
     asset.edges.push_back({generatePipelineAssetGuid(), tonemapPass.id, "output", "output", tonemapOutput.id});
     asset.edges.push_back({generatePipelineAssetGuid(), outputPass.id, "source", "input", tonemapOutput.id});
     asset.edges.push_back({generatePipelineAssetGuid(), outputPass.id, "target", "output", backbuffer.id});
-    asset.edges.push_back({generatePipelineAssetGuid(), imguiOverlayPass.id, "target", "output", backbuffer.id});
 
     return asset;
 }
@@ -1062,20 +1193,161 @@ ImGuiID beginDockspace(bool& showSceneGraphWindow,
     return dockspaceId;
 }
 
+// --bake-shaders: compiles the visibility shader set and every MeshletCullPass
+// permutation into outputDir for MetallicShaderBake. Slang only, so no window or
+// device is created; the shipped binary loads the results as its prebuilt cache.
+int runShaderBake(const std::string& outputDir,
+                  const std::vector<std::pair<std::string, std::string>>& defines) {
+    setSlangShaderCacheDir(outputDir);
+    ShaderManager shaderManager(RhiDeviceHandle{},
+                                PROJECT_SOURCE_DIR,
+                                true,
+                                true,
+                                ShaderManagerProfile::vulkanVisibility(),
+                                ShaderCompileMode::Release);
+    shaderManager.setGlobalDefines(defines);
+    for (uint32_t mask = 0; mask < kMeshletCullPermutationCount; ++mask) {
+        shaderManager.addPipelinePermutation("MeshletCullPass", meshletCullPermutationDefines(mask));
+    }
+    const auto [baked, failed] = shaderManager.bakeShaders();
+    spdlog::info("Shader archive '{}': {} baked, {} failed", outputDir, baked, failed);
+    return failed == 0 ? 0 : 1;
+}
+
 } // namespace
 
 bool s_viewportHovered = false;
 
-int main() {
+int main(int argc, char** argv) {
+    StreamingSoakBenchmark::Settings soakSettings;
+    if (!StreamingSoakBenchmark::parseArguments(argc, argv, soakSettings)) {
+        return 1;
+    }
+    FrameBenchmark::Settings benchSettings;
+    if (!FrameBenchmark::parseArguments(argc, argv, benchSettings)) {
+        return 1;
+    }
+    ImageSequenceCapture::Settings sequenceSettings;
+    if (!ImageSequenceCapture::parseArguments(argc, argv, sequenceSettings)) {
+        return 1;
+    }
+    SlowFrameCapture::Settings slowFrameSettings;
+    if (!SlowFrameCapture::parseArguments(argc, argv, slowFrameSettings)) {
+        return 1;
+    }
+    GpuKernelBenchmark::Settings kernelBenchSettings;
+    if (!GpuKernelBenchmark::parseArguments(argc, argv, kernelBenchSettings)) {
+        return 1;
+    }
+    AssetMicrobenchmark::Settings microbenchSettings;
+    if (!AssetMicrobenchmark::parseArguments(argc, argv, microbenchSettings)) {
+        return 1;
+    }
+    if (!microbenchSettings.reportPath.empty()) {
+        return AssetMicrobenchmark::run(microbenchSettings);
+    }
+    AssetCook::Settings cookSettings;
+    if (!AssetCook::parseArguments(argc, argv, cookSettings)) {
+        return 1;
+    }
+    if (!cookSettings.inputs.empty()) {
+        if (cookSettings.cacheDirectory.empty()) {
+            cookSettings.cacheDirectory = std::string(PROJECT_SOURCE_DIR) + "/Asset/MeshletCache";
+        }
+        return AssetCook::run(cookSettings);
+    }
+    StartupProfile::begin();
+    const bool benchmarkMode = !benchSettings.reportPath.empty() || !kernelBenchSettings.reportPath.empty();
+    const bool sequenceMode = !sequenceSettings.outputDirectory.empty();
+    std::string timelineRecordPath;
+    std::string timelineReplayPath = benchSettings.timelinePath;
+    uint32_t framesInFlight = 2u;
+    bool lowLatencyPresentWait = false;
+    bool serialRender = false;
+    bool visibility64 = false;
+    bool hzb16 = false;
+    bool gpuDebugMessages = false;
+    std::string shaderBakeDir;
+    std::vector<std::pair<std::string, std::string>> shaderBakeDefines;
+    std::string shaderStatsReportPath = "cache/shader_stats.json";
+    bool writeShaderStatsOnExit = false;
+    std::string gpuCountersReportPath = "cache/gpu_pass_counters.csv";
+    bool writeGpuCountersOnExit = false;
+    std::string gpuDrivenTelemetryPath;
+    bool keepCpuMirrors = false;
+    bool temporalUpscalerRequested = false;
+    bool fullPrecisionShaders = false;
+    for (int argIndex = 1; argIndex < argc; ++argIndex) {
+        if (std::strcmp(argv[argIndex], "--frames-in-flight") == 0 && argIndex + 1 < argc) {
+            framesInFlight = static_cast<uint32_t>(std::strtoul(argv[++argIndex], nullptr, 10));
+        } else if (std::strcmp(argv[argIndex], "--low-latency") == 0) {
+            lowLatencyPresentWait = true;
+        } else if (std::strcmp(argv[argIndex], "--serial-render") == 0) {
+            serialRender = true;
+        } else if (std::strcmp(argv[argIndex], "--visibility-64") == 0) {
+            visibility64 = true;
+        } else if (std::strcmp(argv[argIndex], "--hzb-16") == 0) {
+            hzb16 = true;
+        } else if (std::strcmp(argv[argIndex], "--gpu-debug-messages") == 0) {
+            gpuDebugMessages = true;
+        } else if (std::strcmp(argv[argIndex], "--bake-shaders") == 0 && argIndex + 1 < argc) {
+            shaderBakeDir = argv[++argIndex];
+        } else if (std::strcmp(argv[argIndex], "--bake-define") == 0 && argIndex + 1 < argc) {
+            const std::string define = argv[++argIndex];
+            const size_t equals = define.find('=');
+            shaderBakeDefines.emplace_back(define.substr(0, equals),
+                                           equals == std::string::npos ? "1" : define.substr(equals + 1));
+        } else if (std::strcmp(argv[argIndex], "--record-timeline") == 0 && argIndex + 1 < argc) {
+            timelineRecordPath = argv[++argIndex];
+        } else if (std::strcmp(argv[argIndex], "--replay-timeline") == 0 && argIndex + 1 < argc) {
+            timelineReplayPath = argv[++argIndex];
+        } else if (std::strcmp(argv[argIndex], "--shader-stats-report") == 0 && argIndex + 1 < argc) {
+            shaderStatsReportPath = argv[++argIndex];
+            writeShaderStatsOnExit = true;
+        } else if (std::strcmp(argv[argIndex], "--gpu-counters-report") == 0 && argIndex + 1 < argc) {
+            gpuCountersReportPath = argv[++argIndex];
+            writeGpuCountersOnExit = true;
+        } else if (std::strcmp(argv[argIndex], "--gpu-driven-telemetry") == 0 && argIndex + 1 < argc) {
+            gpuDrivenTelemetryPath = argv[++argIndex];
+        } else if (std::strcmp(argv[argIndex], "--keep-cpu-mirrors") == 0) {
+            keepCpuMirrors = true;
+        } else if (std::strcmp(argv[argIndex], "--temporal-upscaler") == 0) {
+            temporalUpscalerRequested = true;
+        } else if (std::strcmp(argv[argIndex], "--full-precision") == 0) {
+            fullPrecisionShaders = true;
+        }
+    }
+    if (!shaderBakeDir.empty()) {
+        if (visibility64) {
+            shaderBakeDefines.emplace_back("METALLIC_VISIBILITY_64", "1");
+        }
+        if (hzb16) {
+            shaderBakeDefines.emplace_back("METALLIC_HZB_16", "1");
+        }
+        if (gpuDebugMessages) {
+            shaderBakeDefines.emplace_back("METALLIC_GPU_DEBUG_MESSAGES", "1");
+        }
+        return runShaderBake(shaderBakeDir, shaderBakeDefines);
+    }
+
     if (!glfwInit()) {
         spdlog::error("Failed to initialize GLFW");
         return 1;
     }
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
-
-    GLFWwindow* window = glfwCreateWindow(1280, 720, "Metallic - Vulkan Sponza", nullptr, nullptr);
+    glfwWindowHint(GLFW_RESIZABLE, benchmarkMode || sequenceMode ? GLFW_FALSE : GLFW_TRUE);
+    // The RHI presents to a swapchain, so benchmarks and image sequences keep a hidden
+    // window of the requested size; the graph itself renders offscreen into the
+    // viewport texture.
+    glfwWindowHint(GLFW_VISIBLE, benchmarkMode || sequenceMode ? GLFW_FALSE : GLFW_TRUE);
+
+    GLFWwindow* window = benchmarkMode
+        ? glfwCreateWindow(benchSettings.width, benchSettings.height, "Metallic - Benchmark", nullptr, nullptr)
+        : sequenceMode
+        ? glfwCreateWindow(sequenceSettings.width, sequenceSettings.height, "Metallic - Image Sequence",
+                           nullptr, nullptr)
+        : glfwCreateWindow(1280, 720, "Metallic - Vulkan Sponza", nullptr, nullptr);
     if (!window) {
         spdlog::error("Failed to create GLFW window");
         glfwTerminate();
@@ -1102,10 +1374,14 @@ int main() {
     createInfo.requireVulkan14 = true;
     // Enable timeline semaphores for async compute / transfer queue synchronisation (Vulkan 1.2 core).
     createInfo.enableTimelineSemaphore = true;
+    createInfo.framesInFlight = framesInFlight;
+    createInfo.lowLatencyPresentWait = lowLatencyPresentWait;
     // On-disk caches: PSO binaries and compiled SPIR-V modules.
     createInfo.pipelineCacheDir = "cache/pipelines";
     createInfo.shaderCacheDir   = "cache/shaders";
     setSlangShaderCacheDir(createInfo.shaderCacheDir);
+    // Written by the MetallicShaderBake target; absent in development builds.
+    setSlangPrebuiltShaderCacheDir("shader_archive");
 
     // --- Streamline / DLSS initialization (before RHI so SL can intercept device creation) ---
     StreamlineContext streamlineCtx;
@@ -1114,6 +1390,8 @@ int main() {
     uint32_t dlssRenderWidth = 0;
     uint32_t dlssRenderHeight = 0;
     float visibilityRenderScale = 1.0f;
+    DynamicResolutionController dynamicResolution;
+    bool dynamicResolutionEnabled = false;
     PipelineUiControls pipelineUiControls{};
 
 #ifdef METALLIC_HAS_STREAMLINE
@@ -1137,13 +1415,26 @@ int main() {
 #endif
 
     std::string backendError;
-    auto rhi = createRhiContext(RhiBackendType::Vulkan, createInfo, backendError);
+    std::unique_ptr<RhiContext> rhi;
+    {
+        StartupProfile::Phase devicePhase("Vulkan device");
+        rhi = createRhiContext(RhiBackendType::Vulkan, createInfo, backendError);
+    }
     if (!rhi) {
         spdlog::error("Failed to create Vulkan backend: {}", backendError);
         glfwDestroyWindow(window);
         glfwTerminate();
         return 1;
     }
+    if (VulkanGpuProfiler* gpuProfiler = getVulkanGpuProfiler(*rhi); gpuProfiler && writeGpuCountersOnExit) {
+        gpuProfiler->setPipelineStatisticsEnabled(true);
+        gpuProfiler->setPerformanceCountersEnabled(true);
+    }
+    // The raster end of the funnel comes from pipeline statistics.
+    if (VulkanGpuProfiler* gpuProfiler = getVulkanGpuProfiler(*rhi);
+        gpuProfiler && !gpuDrivenTelemetryPath.empty()) {
+        gpuProfiler->setPipelineStatisticsEnabled(true);
+    }
 
 #if defined(METALLIC_HAS_AFTERMATH) && METALLIC_HAS_AFTERMATH
     setSlangCompileCallback([](const char* /*sourcePath*/, const uint32_t* spirvData, size_t spirvSizeBytes) {
@@ -1225,6 +1516,32 @@ int main() {
                                 features.meshShaders,
                                 shaderProfile,
                                 shaderCompileMode);
+    shaderManager.setPipelineManifestPath("cache/pipelines/pipeline_manifest.txt");
+    // Kernels with a capability-specific fast path pick it through these defines.
+    auto capabilityDefines = rhiCapabilityShaderDefines(*rhi);
+    if (fullPrecisionShaders) {
+        // Float reference for the mfloat kernels; diff captures against the default run.
+        std::erase_if(capabilityDefines, [](const auto& define) { return define.first == "METALLIC_FP16"; });
+    }
+    for (const auto& [name, value] : capabilityDefines) {
+        spdlog::info("Shader capability: {}={}", name, value);
+    }
+    if (visibility64) {
+        // RG32Uint visibility with full-width instance and meshlet IDs.
+        capabilityDefines.emplace_back("METALLIC_VISIBILITY_64", "1");
+        spdlog::info("Visibility buffer: 64-bit encoding");
+    }
+    if (hzb16) {
+        // Half the HZB bandwidth; the build rounds toward far to stay conservative.
+        capabilityDefines.emplace_back("METALLIC_HZB_16", "1");
+        spdlog::info("HZB: R16Float");
+    }
+    if (gpuDebugMessages) {
+        // Debug permutation: gpuDebugPrint/gpuAssert in kernels reach the log.
+        capabilityDefines.emplace_back("METALLIC_GPU_DEBUG_MESSAGES", "1");
+        spdlog::info("GPU debug messages: enabled");
+    }
+    shaderManager.setGlobalDefines(capabilityDefines);
     if (!shaderManager.buildAll()) {
         spdlog::error("Failed to build Vulkan visibility shader set");
         ImGui_ImplVulkan_Shutdown();
@@ -1237,6 +1554,7 @@ int main() {
     }
 
     PipelineRuntimeContext& runtimeContext = shaderManager.runtimeContext();
+    std::vector<ShaderPipelineStats> shaderPipelineStats;
     ClusterStreamingService clusterStreamingService;
     runtimeContext.rhi = rhi.get();
     runtimeContext.clusterStreamingService = &clusterStreamingService;
@@ -1343,17 +1661,11 @@ int main() {
     }
     shaderManager.importSampler("atmosphere", linearSampler);
 
-    AtmosphereTextures atmosphereTextures;
-    if (!loadAtmosphereTextures(deviceHandle, PROJECT_SOURCE_DIR, atmosphereTextures)) {
-        spdlog::warn("Failed to load atmosphere textures; SkyPass will clear to black");
-    } else {
-        importRuntimeTexture("transmittance", atmosphereTextures.transmittance);
-        importRuntimeTexture("scattering", atmosphereTextures.scattering);
-        importRuntimeTexture("irradiance", atmosphereTextures.irradiance);
-    }
-
     SceneContext sceneCtx(deviceHandle, queueHandle, PROJECT_SOURCE_DIR);
-    const std::string defaultGltfPath = std::string(PROJECT_SOURCE_DIR) + "/Asset/Sponza/glTF/Sponza.gltf";
+    sceneCtx.setTextureStreamingEnabled(true);
+    const std::string defaultGltfPath = !benchSettings.scenePath.empty()
+        ? benchSettings.scenePath
+        : std::string(PROJECT_SOURCE_DIR) + "/Asset/Sponza/glTF/Sponza.gltf";
     bool previewSceneReady = sceneCtx.loadScene(defaultGltfPath);
     if (!previewSceneReady) {
         spdlog::warn("Failed to load Vulkan Sponza scene; falling back to triangle path");
@@ -1362,22 +1674,25 @@ int main() {
     RaytracedShadowResources shadowResources;
     bool rtShadowsAvailable = false;
     bool enableRTShadows = true;
+    ShadowCascadeController shadowCascadeController;
+    // Only the BLAS batch is submitted here. Frames render with the fallback shadows
+    // until the frame loop sees it land and finishes the setup.
     if (previewSceneReady && rhi->features().rayTracing) {
-        if (buildAccelerationStructures(deviceHandle,
-                                        queueHandle,
-                                        sceneCtx.mesh(),
-                                        sceneCtx.sceneGraph(),
-                                        shadowResources) &&
-            createShadowPipeline(deviceHandle, shadowResources, PROJECT_SOURCE_DIR)) {
-            rtShadowsAvailable = true;
-            spdlog::info("Vulkan raytraced shadows enabled");
-        } else {
+        StartupProfile::Phase rayTracingPhase("Ray tracing setup");
+        if (!beginAccelerationStructureBuilds(deviceHandle,
+                                              queueHandle,
+                                              sceneCtx.mesh(),
+                                              &sceneCtx.clusterLod(),
+                                              shadowResources)) {
             spdlog::warn("Failed to initialize Vulkan raytraced shadows; continuing with fallback lighting");
             shadowResources.release();
         }
     } else if (!rhi->features().rayTracing) {
         spdlog::info("Vulkan ray tracing not supported on this device; shadow pass stays disabled");
     }
+    // The BLAS builds read the scene's host-side indices and cluster arrays; once
+    // they have landed (or failed) those copies are released.
+    bool cpuMirrorsReleasePending = previewSceneReady && !keepCpuMirrors;
 
     // --- Streamline: set Vulkan device and query DLSS availability ---
 #ifdef METALLIC_HAS_STREAMLINE
@@ -1394,9 +1709,11 @@ int main() {
         }
     }
 #endif
+    bool frameGenerationRequested = false;
 
-    const std::string visibilityPipelinePath =
-        std::string(PROJECT_SOURCE_DIR) + "/Pipelines/visibilitybuffer.json";
+    const std::string visibilityPipelinePath = !benchSettings.pipelinePath.empty()
+        ? benchSettings.pipelinePath
+        : std::string(PROJECT_SOURCE_DIR) + "/Pipelines/visibilitybuffer.json";
     const std::string clusterVisPipelinePath =
         std::string(PROJECT_SOURCE_DIR) + "/Pipelines/cluster_vis.json";
     PipelineAsset visibilityPipelineBaseAsset;
@@ -1406,6 +1723,9 @@ int main() {
         loadPipelineAssetChecked(visibilityPipelinePath, "Vulkan visibility", visibilityPipelineBaseAsset);
     bool clusterVisPipelineLoaded =
         loadPipelineAssetChecked(clusterVisPipelinePath, "Cluster visualization", clusterVisPipelineAsset);
+    if (clusterVisPipelineLoaded) {
+        removePipelineUiOverlay(clusterVisPipelineAsset);
+    }
     bool useClusterVisMode = false;
     bool visibilityPipelineAssetLoaded = false;
     bool visibilityAutoExposureAvailable = false;
@@ -1421,9 +1741,8 @@ int main() {
         visibilityPipelineAssetLoaded = visibilityPipelineBaseLoaded;
         visibilityPipelineAsset =
             visibilityPipelineBaseLoaded ? visibilityPipelineBaseAsset : PipelineAsset{};
-        visibilityAutoExposureAvailable =
-            hasComputePipeline("HistogramPass") && hasComputePipeline("AutoExposurePass");
-        visibilityTaaAvailable = hasComputePipeline("TAAPass");
+        visibilityAutoExposureAvailable = hasComputePipeline("AutoExposurePass");
+        visibilityTaaAvailable = hasComputePipeline("TAAPass") || hasComputePipeline("FusedPostPass");
         visibilityGpuCullingAvailable =
             hasComputePipeline("InstanceClassifyPass") &&
             hasComputePipeline("MeshletCullPass") &&
@@ -1442,7 +1761,7 @@ int main() {
 
         if (visibilityPipelineAssetLoaded) {
             normalizePipelineFinalDisplayOutput(visibilityPipelineAsset);
-            erasePassByType(visibilityPipelineAsset, "ImGuiOverlayPass");
+            removePipelineUiOverlay(visibilityPipelineAsset);
         }
 
         if (visibilityPipelineAssetLoaded && !validateVisibilityAsset("Invalid Vulkan visibility pipeline")) {
@@ -1457,6 +1776,30 @@ int main() {
             }
         }
 
+        if (visibilityPipelineAssetLoaded) {
+            if (rtShadowsAvailable) {
+                disableVisibilityShadowCascades(visibilityPipelineAsset);
+                // Lighting kernels built with METALLIC_INLINE_RAY_QUERY replace the shadow texture.
+                if (features.rayTracing && visibilityLightingTracesShadows(visibilityPipelineAsset)) {
+                    disableVisibilityRayTracing(visibilityPipelineAsset);
+                }
+            } else if (hasComputePipeline("ShadowCascadeResolvePass")) {
+                useVisibilityShadowCascades(visibilityPipelineAsset);
+            } else {
+                disableVisibilityRayTracing(visibilityPipelineAsset);
+                disableVisibilityShadowCascades(visibilityPipelineAsset);
+            }
+            validateVisibilityAsset("Invalid Vulkan visibility pipeline after shadow source selection");
+        }
+
+        if (visibilityPipelineAssetLoaded && temporalUpscalerRequested) {
+            if (!hasComputePipeline("TemporalUpscalePass")) {
+                spdlog::warn("Temporal upscaler requested, but its shader is unavailable; keeping TAAPass");
+            } else if (useVisibilityTemporalUpscaler(visibilityPipelineAsset)) {
+                validateVisibilityAsset("Invalid Vulkan visibility pipeline after temporal upscaler selection");
+            }
+        }
+
         visibilityUpscalerSelection = visibilityPipelineAssetLoaded
             ? analyzeVisibilityUpscalerSelection(visibilityPipelineAsset)
             : VisibilityUpscalerSelection{};
@@ -1488,7 +1831,16 @@ int main() {
             sceneCtx.materials().sampler.nativeHandle() &&
             sceneCtx.shadowDummyTex().nativeHandle() &&
             sceneCtx.skyFallbackTex().nativeHandle();
-        atmosphereSkyAvailable = hasRenderPipeline("SkyPass") && atmosphereTextures.isValid();
+        // AtmospherePass builds the scattering tables on the GPU.
+        atmosphereSkyAvailable = hasRenderPipeline("SkyPass") &&
+            hasComputePipeline("AtmosphereTransmittancePass") &&
+            hasComputePipeline("AtmosphereDirectIrradiancePass") &&
+            hasComputePipeline("AtmosphereSingleScatteringPass") &&
+            hasComputePipeline("AtmosphereScatteringDensityPass") &&
+            hasComputePipeline("AtmosphereIndirectIrradiancePass") &&
+            hasComputePipeline("AtmosphereMultipleScatteringPass") &&
+            hasComputePipeline("AtmosphereSkyViewPass") &&
+            hasComputePipeline("AtmosphereSkyIrradiancePass");
     };
 
     auto logVisibilityMode = [&]() {
@@ -1499,6 +1851,8 @@ int main() {
                 mode += " -> TAAPass";
             } else if (visibilityUpscalerMode == VisibilityUpscalerMode::DLSS) {
                 mode += " -> StreamlineDlssPass";
+            } else if (visibilityUpscalerMode == VisibilityUpscalerMode::Temporal) {
+                mode += " -> TemporalUpscalePass";
             }
             if (findFirstEnabledPassByType(visibilityPipelineAsset, "AutoExposurePass")) {
                 mode += " -> AutoExposurePass";
@@ -1580,6 +1934,8 @@ int main() {
         } else {
             dlssStateDirty = true;
         }
+        // Frame Generation reuses the DLSS tags and constants, so it only runs with SR.
+        streamlineCtx.setFrameGenerationEnabled(frameGenerationRequested && enableDlssEvaluation);
 #endif
 
         runtimeContext.upscaler = streamlineCtx.isInitialized() ? static_cast<IUpscalerIntegration*>(&streamlineCtx) : nullptr;
@@ -1607,14 +1963,16 @@ int main() {
             descriptorBufferManager.init(vkDevice, vkPhysicalDevice, vmaAllocator, dbProps,
                                          limits.minUniformBufferOffsetAlignment,
                                          limits.nonCoherentAtomSize,
-                                         limits.maxUniformBufferRange);
+                                         limits.maxUniformBufferRange,
+                                         rhi->framesInFlight());
             descriptorBackend = &descriptorBufferManager;
             spdlog::info("Vulkan: using VK_EXT_descriptor_buffer path");
         } else {
             legacyDescriptorManager.init(vkDevice, vkPhysicalDevice, vmaAllocator,
                                          limits.minUniformBufferOffsetAlignment,
                                          limits.nonCoherentAtomSize,
-                                         limits.maxUniformBufferRange);
+                                         limits.maxUniformBufferRange,
+                                         rhi->framesInFlight());
             descriptorBackend = &legacyDescriptorManager;
         }
     }
@@ -1628,12 +1986,24 @@ int main() {
         uploadService.init(vkDevice, vmaAllocator,
                            gfxQueue, native.graphicsQueueFamily,
                            xferQueue, xferFamily, xferSemaphore,
-                           &getVulkanUploadRing(*rhi));
+                           &getVulkanUploadRing(*rhi),
+                           rhi->framesInFlight());
         vulkanSetUploadService(&uploadService);
     }
     VulkanReadbackService readbackService;
-    readbackService.init(vkDevice, &getVulkanReadbackHeap(*rhi), 2);
+    readbackService.init(vkDevice, &getVulkanReadbackHeap(*rhi), rhi->framesInFlight());
     runtimeContext.readbackService = &readbackService;
+    ViewportPickState viewportPick;
+    runtimeContext.viewportPick = &viewportPick;
+    GpuDrivenTelemetry gpuDrivenTelemetry;
+    runtimeContext.gpuDrivenTelemetry = &gpuDrivenTelemetry;
+    if (!gpuDrivenTelemetryPath.empty()) {
+        gpuDrivenTelemetry.openCsv(gpuDrivenTelemetryPath);
+    }
+    LodBudgetController lodBudget;
+    bool lodBudgetEnabled = false;
+    RenderOnDemand renderOnDemand;
+    uint64_t lastInputEventSerial = 0;
 
     if (previewSceneReady) {
         if (!sceneCtx.materials().textureViews.empty()) {
@@ -1647,10 +2017,11 @@ int main() {
     }
     VulkanResourceStateTracker imageTracker;
     streamlineCtx.setImageLayoutTracker(&imageTracker);
-    VulkanImportedTexture backbufferTexture;
 
     RhiTextureHandle sceneColorTexture;
+    // The post graph's display target, shown by ImGui::Image in the Viewport window.
     RhiTextureHandle viewportDisplayTexture;
+    VkImageLayout viewportDisplayLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     VkDescriptorSet viewportImguiDescriptor = VK_NULL_HANDLE;
     VkSampler viewportImguiSampler = VK_NULL_HANDLE;
 
@@ -1666,12 +2037,25 @@ int main() {
         vkCreateSampler(vkDevice, &samplerCI, nullptr, &viewportImguiSampler);
     };
 
+    // Frames still in flight may sample the old textures, so they are released by
+    // submission serial rather than after draining the device.
+    auto retireTexture = [&](RhiTextureHandle& texture) {
+        void* nativeHandle = texture.nativeHandle();
+        texture.setNativeHandle(nullptr);
+        if (nativeHandle) {
+            rhi->deferRelease([nativeHandle]() { rhiReleaseNativeHandle(nativeHandle); });
+        }
+    };
+
     auto recreateViewportDisplayTexture = [&](uint32_t w, uint32_t h) {
         if (viewportImguiDescriptor != VK_NULL_HANDLE) {
-            ImGui_ImplVulkan_RemoveTexture(viewportImguiDescriptor);
+            rhi->deferRelease([descriptor = viewportImguiDescriptor]() {
+                ImGui_ImplVulkan_RemoveTexture(descriptor);
+            });
             viewportImguiDescriptor = VK_NULL_HANDLE;
         }
-        rhiReleaseHandle(viewportDisplayTexture);
+        retireTexture(viewportDisplayTexture);
+        viewportDisplayLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         viewportDisplayTexture = rhiCreateTexture2D(deviceHandle, w, h,
             RhiFormat::BGRA8Unorm, false, 1,
             RhiTextureStorageMode::Private,
@@ -1687,8 +2071,7 @@ int main() {
     };
 
     auto recreateSceneColorTexture = [&](uint32_t targetWidth, uint32_t targetHeight) {
-        rhiReleaseHandle(sceneColorTexture);
-        rhiReleaseHandle(viewportDisplayTexture);
+        retireTexture(sceneColorTexture);
         runtimeContext.importedTexturesRhi.erase("sceneColor");
         sceneColorTexture = rhiCreateTexture2D(deviceHandle,
                                                targetWidth,
@@ -1705,6 +2088,8 @@ int main() {
         return true;
     };
 
+    // Stands in for ShadowRayPass's output while the pass is culled.
+    importRuntimeTexture("shadowDummy", sceneCtx.shadowDummyTex());
     if (!recreateSceneColorTexture(createInfo.width, createInfo.height)) {
         spdlog::error("Failed to create offscreen scene color texture");
         rhi->waitIdle();
@@ -1713,7 +2098,6 @@ int main() {
         readbackService.destroy();
         descriptorBufferManager.destroy();
         legacyDescriptorManager.destroy();
-        atmosphereTextures.release();
         shadowResources.release();
         sceneCtx.unloadScene();
         rhiReleaseHandle(linearSampler);
@@ -1760,6 +2144,8 @@ int main() {
     const double depthClearValue = ML_DEPTH_REVERSED ? 0.0 : 1.0;
     RhiDepthStencilStateHandle depthState =
         rhiCreateDepthStencilState(deviceHandle, true, ML_DEPTH_REVERSED);
+    RhiDepthStencilStateHandle depthReadState =
+        rhiCreateDepthStencilState(deviceHandle, false, ML_DEPTH_REVERSED);
     auto makeRenderContext = [&]() -> RenderContext {
         return RenderContext{
             sceneCtx.mesh(),
@@ -1768,8 +2154,10 @@ int main() {
             sceneCtx.sceneGraph(),
             sceneCtx.gpuScene(),
             sceneCtx.clusterLod(),
+            sceneCtx.skinning(),
             shadowResources,
             depthState,
+            depthReadState,
             sceneCtx.shadowDummyTex(),
             sceneCtx.skyFallbackTex(),
             depthClearValue,
@@ -1781,22 +2169,55 @@ int main() {
     };
     RenderContext renderContext = makeRenderContext();
 
-    runtimeContext.backbufferRhi = &backbufferTexture;
+    runtimeContext.backbufferRhi = &viewportDisplayTexture;
     runtimeContext.resourceFactory = &frameGraphBackend;
     runtimeContext.upscaler = streamlineCtx.isInitialized() ? static_cast<IUpscalerIntegration*>(&streamlineCtx) : nullptr;
     runtimeContext.uiControls = &pipelineUiControls;
 
     const PipelineAsset sceneColorPostAsset = makeSceneColorPostPipelineAsset();
-    PipelineBuilder postBuilder(renderContext);
+    // One compiled graph stays resident per post asset, so switching views at a frame
+    // boundary only swaps the active builder. postBuilderNeedsRebuild marks them all
+    // stale; each is rebuilt the next time it becomes active.
+    enum PostPipelineSlot : size_t {
+        kPostPipelineSceneColor,
+        kPostPipelineVisibility,
+        kPostPipelineClusterVis,
+        kPostPipelineSlotCount,
+    };
+    std::array<std::unique_ptr<PipelineBuilder>, kPostPipelineSlotCount> residentPostBuilders;
+    std::array<bool, kPostPipelineSlotCount> residentPostBuilderStale{};
+    for (size_t slot = 0; slot < kPostPipelineSlotCount; ++slot) {
+        residentPostBuilders[slot] = std::make_unique<PipelineBuilder>(renderContext);
+        residentPostBuilderStale[slot] = true;
+    }
+    PipelineBuilder* postBuilder = residentPostBuilders[kPostPipelineSceneColor].get();
     auto rebuildPostBuilder = [&](int targetWidth, int targetHeight) {
+        const size_t slot =
+            (useClusterVisMode && clusterVisPipelineLoaded) ? kPostPipelineClusterVis :
+            useVisibilityRenderGraph ? kPostPipelineVisibility : kPostPipelineSceneColor;
         const PipelineAsset& activePostAsset =
-            (useClusterVisMode && clusterVisPipelineLoaded) ? clusterVisPipelineAsset :
-            useVisibilityRenderGraph ? visibilityPipelineAsset : sceneColorPostAsset;
-        if (!postBuilder.build(activePostAsset, runtimeContext, targetWidth, targetHeight)) {
-            spdlog::error("Failed to build Vulkan post pipeline: {}", postBuilder.lastError());
-            return false;
+            slot == kPostPipelineClusterVis ? clusterVisPipelineAsset :
+            slot == kPostPipelineVisibility ? visibilityPipelineAsset : sceneColorPostAsset;
+        PipelineBuilder& builder = *residentPostBuilders[slot];
+        if (residentPostBuilderStale[slot] || builder.needsRebuild(targetWidth, targetHeight)) {
+            if (!builder.build(activePostAsset, runtimeContext, targetWidth, targetHeight)) {
+                spdlog::error("Failed to build Vulkan post pipeline: {}", builder.lastError());
+                return false;
+            }
+            builder.compile();
+            residentPostBuilderStale[slot] = false;
         }
-        postBuilder.compile();
+        postBuilder = &builder;
+        bool gpuTransformPropagation = false;
+        for (const PassDecl& pass : activePostAsset.passes) {
+            if (pass.enabled) {
+                shaderManager.notePipelineUse(pass.type);
+                gpuTransformPropagation = gpuTransformPropagation || pass.type == "TransformHierarchyPass";
+            }
+        }
+        // Until its pipeline exists the pass records nothing, so the CPU keeps uploading.
+        sceneCtx.setGpuTransformPropagation(gpuTransformPropagation &&
+                                            hasComputePipeline("TransformHierarchyPass"));
         return true;
     };
 
@@ -1817,14 +2238,16 @@ int main() {
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
-        postBuilder.frameGraph().reset();
+        for (auto& builder : residentPostBuilders) {
+            builder->frameGraph().reset();
+        }
         sceneGraph.reset();
         descriptorBufferManager.destroy();
         legacyDescriptorManager.destroy();
-        atmosphereTextures.release();
         shadowResources.release();
         sceneCtx.unloadScene();
         rhiReleaseHandle(depthState);
+        rhiReleaseHandle(depthReadState);
         rhiReleaseHandle(linearSampler);
         rhiReleaseHandle(trianglePipeline);
         rhiReleaseHandle(sceneColorTexture);
@@ -1835,6 +2258,9 @@ int main() {
 
     VkImageLayout sceneColorLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     FrameContext frameContext;
+    // Pass conditions in the pipeline assets; the frame graph culls gated passes on the
+    // frame these flip, without a rebuild.
+    runtimeContext.passConditions["rtShadows"] = &frameContext.enableRTShadows;
     previewCamera.initFromBounds(sceneCtx.mesh().bboxMin, sceneCtx.mesh().bboxMax);
     previewCamera.distance *= 0.8f;
     previewCamera.azimuth = 0.55f;
@@ -1851,8 +2277,8 @@ int main() {
         sunLight.color = float3(1.0f, 0.98f, 0.95f);
         sunLight.intensity = 2.5f;
     }
-    std::vector<uint32_t> previewVisibleMeshletNodes;
-    std::vector<uint32_t> previewVisibleIndexNodes;
+    // Frustum-culled node lists for the CPU draw paths, rebuilt every frame.
+    CpuNodeCuller previewNodeCuller;
     auto refreshPreviewSceneState = [&]() {
         if (!previewSceneReady) {
             return;
@@ -1861,44 +2287,36 @@ int main() {
         sceneCtx.updateGpuScene();
         sunLight = sceneCtx.sceneGraph().getSunDirectionalLight();
 
-        previewVisibleMeshletNodes.clear();
-        previewVisibleIndexNodes.clear();
         const bool gpuDrivenVisibilityPath =
             useVisibilityRenderGraph && visibilityGpuCullingAvailable;
-        if (gpuDrivenVisibilityPath) {
-            return;
-        }
-        for (const auto& node : sceneCtx.sceneGraph().nodes) {
-            if (!sceneCtx.sceneGraph().isNodeVisible(node.id)) {
-                continue;
-            }
-            if (node.meshletCount > 0) {
-                previewVisibleMeshletNodes.push_back(node.id);
-            }
-            if (node.indexCount > 0) {
-                previewVisibleIndexNodes.push_back(node.id);
-            }
+        if (!gpuDrivenVisibilityPath) {
+            previewNodeCuller.update(sceneCtx.sceneGraph(), sceneCtx.gpuScene());
         }
     };
-    if (previewSceneReady) {
-        previewVisibleMeshletNodes.reserve(sceneCtx.sceneGraph().nodes.size());
-        previewVisibleIndexNodes.reserve(sceneCtx.sceneGraph().nodes.size());
-        refreshPreviewSceneState();
-    } else {
-        previewVisibleIndexNodes = {0};
-    }
+    refreshPreviewSceneState();
     bool showSceneGraphWindow = true;
     bool showGraphDebug = true;
     bool showRenderPassUI = true;
     bool showImGuiDemo = false;
+    // Per-pass costs for the Pipeline Editor's live overlay, refreshed a few times a second.
+    bool publishCostProfile = std::getenv("METALLIC_COST_PROFILE") != nullptr;
+    const std::string costProfilePath = PipelineCostProfile::defaultChannelPath();
+    double lastCostProfilePublishTime = 0.0;
     bool reloadKeyDown = false;
     bool pipelineReloadKeyDown = false;
+    bool frameDumpKeyDown = false;
     bool shaderReloadRequested = false;
     bool pipelineReloadRequested = false;
     bool streamingPipelineResetRequested = false;
     bool postBuilderNeedsRebuild = false;
+    // Selects another resident post graph without invalidating the others.
+    bool postPipelineSwitchRequested = false;
     bool visibilityHistoryResetRequested = false;
     double lastFrameTime = glfwGetTime();
+    double lastAnimationTime = lastFrameTime;
+    // Left presses that end where they started select; drags orbit the camera.
+    bool viewportPressed = false;
+    ImVec2 viewportPressPos;
     float4x4 prevView = float4x4::Identity();
     float4x4 prevProj = float4x4::Identity();
     float4x4 prevCullView = float4x4::Identity();
@@ -1906,6 +2324,7 @@ int main() {
     float4 prevCameraWorldPos = float4(0.0f, 0.0f, 0.0f, 1.0f);
     bool hasPrevMatrices = false;
     uint32_t frameIndex = 0;
+    VulkanMemoryBudgetInfo liveMemoryBudget{};
 
     auto applyDlssPresetChange = [&](DlssPreset newPreset) {
         if (newPreset == dlssPreset) {
@@ -1938,11 +2357,23 @@ int main() {
         pipelineUiControls.onResetDlssHistory = [&]() {
             streamlineCtx.resetHistory();
         };
+        pipelineUiControls.frameGenerationAvailable = streamlineCtx.isFrameGenerationAvailable();
+        pipelineUiControls.frameGenerationEnabled = streamlineCtx.isFrameGenerationEnabled();
+        pipelineUiControls.onFrameGenerationChanged = [&](bool enabled) {
+            frameGenerationRequested = enabled;
+            dlssStateDirty = true;
+            postBuilderNeedsRebuild = true;
+        };
+        pipelineUiControls.reflexAvailable = streamlineCtx.isReflexAvailable();
+        pipelineUiControls.reflexEnabled = streamlineCtx.isReflexEnabled();
+        pipelineUiControls.onReflexChanged = [&](bool enabled) {
+            streamlineCtx.setReflexEnabled(enabled);
+        };
+        streamlineCtx.queryLatency(pipelineUiControls.latency);
         runtimeContext.uiControls = &pipelineUiControls;
     };
 
     auto rebuildActivePipeline = [&](int targetWidth, int targetHeight) {
-        rhi->waitIdle();
         syncVisibilityUpscalerState(targetWidth, targetHeight);
         const int buildWidth = useVisibilityRenderGraph ? runtimeContext.renderWidth : targetWidth;
         const int buildHeight = useVisibilityRenderGraph ? runtimeContext.renderHeight : targetHeight;
@@ -1971,10 +2402,197 @@ int main() {
     }
 
     uint32_t uploadFrameCounter = 0;
+    StreamingSoakBenchmark soakBenchmark;
+    if (!soakSettings.csvPath.empty() &&
+        !soakBenchmark.begin(soakSettings, previewCamera, glfwGetTime())) {
+        return 1;
+    }
+    FrameBenchmark frameBenchmark;
+    if (!benchSettings.reportPath.empty() && !frameBenchmark.begin(benchSettings, previewCamera)) {
+        return 1;
+    }
+    // Benchmarks measure every frame as is; dumps would add their own hitches.
+    if (benchmarkMode || sequenceMode) {
+        slowFrameSettings.thresholdFactor = 0.0;
+    }
+    SlowFrameCapture slowFrameCapture(slowFrameSettings);
+    GpuKernelBenchmark kernelBenchmark;
+    if (!kernelBenchSettings.reportPath.empty() &&
+        !kernelBenchmark.begin(kernelBenchSettings, defaultGltfPath, visibilityPipelinePath)) {
+        return 1;
+    }
+    CameraTimelineRecorder timelineRecorder;
+    timelineRecorder.begin(timelineRecordPath, glfwGetTime());
+    CameraTimelinePlayer timelinePlayer;
+    if (!timelineReplayPath.empty() && !timelinePlayer.begin(timelineReplayPath)) {
+        return 1;
+    }
+    ImageSequenceCapture imageSequence;
+    if (sequenceMode && !imageSequence.begin(sequenceSettings, previewCamera, !timelinePlayer.active())) {
+        return 1;
+    }
+
+    const SlangCompileStats startupShaderStats = getSlangCompileStats();
+    StartupProfile::addCacheCounts("shaders", startupShaderStats.cacheHits, startupShaderStats.cacheMisses);
+    StartupProfile::finish("cache/startup_profile.json");
+
+    // Frame N records and presents on the render thread while the main thread polls
+    // input and advances animation for frame N+1. The main thread waits for frame N
+    // before it touches the device, the graphs or anything else the tail reads, so
+    // FrameContext and the ImGui draw data are only rewritten once frame N is submitted.
+    RenderThread renderThread(!serialRender);
+    std::optional<VulkanCommandBuffer> frameCommandBuffer;
+    // Filled by the render thread; read on the main thread after the next wait.
+    struct RenderedFrame {
+        bool pending = false;
+        bool deviceLost = false;
+        uint32_t frameIndex = 0;
+        double startSeconds = 0.0;
+        double presentSeconds = 0.0;
+        bool expectedHitch = false;
+    };
+    RenderedFrame renderedFrame;
+    double lastPresentSeconds = 0.0;
+    FrameArenaRing frameArenas(2);
+
+    // Present-side bookkeeping of the frame the render thread finished. Returns false
+    // once the device is lost.
+    auto retireRenderedFrame = [&]() {
+        if (!renderedFrame.pending) {
+            return true;
+        }
+        renderedFrame.pending = false;
+        if (renderedFrame.deviceLost) {
+            return false;
+        }
+        // Overlapped frames start before the previous one presents; counting from the
+        // later of the two keeps the frame time a present-to-present interval.
+        const double frameMs =
+            (renderedFrame.presentSeconds - std::max(renderedFrame.startSeconds, lastPresentSeconds)) * 1000.0;
+        lastPresentSeconds = renderedFrame.presentSeconds;
+        if (frameBenchmark.active()) {
+            const VulkanGpuFrameDiagnostics& benchDiagnostics = getVulkanLatestFrameDiagnostics(*rhi);
+            frameBenchmark.recordFrame(frameMs,
+                                       benchDiagnostics.frameIndex,
+                                       benchDiagnostics.totalGpuMs,
+                                       frameGraphGpuScopeSamples(benchDiagnostics));
+            if (frameBenchmark.finished()) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+        }
+        if (imageSequence.finished()) {
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+        {
+            const VulkanGpuFrameDiagnostics& latestDiagnostics = getVulkanLatestFrameDiagnostics(*rhi);
+            const ClusterStreamingService::StreamingStats& streamingStats = clusterStreamingService.streamingStats();
+            SlowFrameCapture::StreamingSample streamingSample;
+            streamingSample.loadsExecuted = streamingStats.loadsExecutedThisFrame;
+            streamingSample.unloadsExecuted = streamingStats.unloadsExecutedThisFrame;
+            streamingSample.loadRequests = streamingStats.loadRequestsThisFrame;
+            streamingSample.groupPageReads = streamingStats.groupPageReadsThisFrame;
+            streamingSample.failedAllocations = streamingStats.failedAllocations;
+            streamingSample.transferBytes = streamingStats.transferBytesThisFrame;
+            streamingSample.requestReadbackCpuMs = streamingStats.requestReadbackCpuMs;
+            if (slowFrameCapture.recordFrame(renderedFrame.frameIndex,
+                                             frameMs,
+                                             latestDiagnostics.frameIndex,
+                                             latestDiagnostics.totalGpuMs,
+                                             frameGraphGpuScopeSamples(latestDiagnostics),
+                                             streamingSample,
+                                             renderedFrame.expectedHitch)) {
+                slowFrameCapture.writeDump(postBuilder->frameGraph(),
+                                           {{"renderWidth", runtimeContext.renderWidth},
+                                            {"renderHeight", runtimeContext.renderHeight},
+                                            {"streaming", slowFrameStreamingJson(clusterStreamingService)}});
+            }
+        }
+        if (kernelBenchmark.active()) {
+            const VulkanGpuFrameDiagnostics& benchDiagnostics = getVulkanLatestFrameDiagnostics(*rhi);
+            kernelBenchmark.recordFrame(benchDiagnostics.frameIndex,
+                                        frameGraphGpuScopeSamples(benchDiagnostics),
+                                        previewSceneReady ? sceneCtx.gpuScene().totalMeshletDispatchCount : 0u,
+                                        static_cast<uint32_t>(runtimeContext.renderWidth),
+                                        static_cast<uint32_t>(runtimeContext.renderHeight));
+            if (kernelBenchmark.finished()) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+        }
+        return true;
+    };
+
     while (!glfwWindowShouldClose(window)) {
         ZoneScopedN("VulkanRenderGraphFrame");
-
+        const double frameStartSeconds = glfwGetTime();
+        // Benchmarks and replays step animation and motion with a fixed timestep.
+        const float replayTimestep = frameBenchmark.active() ? frameBenchmark.timestep()
+                                   : kernelBenchmark.active() ? static_cast<float>(benchSettings.timestep)
+                                   : timelinePlayer.active() ? timelinePlayer.timestep()
+                                   : imageSequence.active() ? imageSequence.timestep() : 0.0f;
+
+        // --- Simulation: overlaps the previous frame on the render thread ---
         glfwPollEvents();
+        glfwGetFramebufferSize(window, &width, &height);
+        if (width == 0 || height == 0) {
+            glfwWaitEvents();
+            continue;
+        }
+        {
+            // Idle mode: anything that can change the image restarts the settle count;
+            // once it runs out, frames are skipped and the last one stays on screen.
+            const ClusterStreamingService::StreamingStats& idleStreamingStats =
+                clusterStreamingService.streamingStats();
+            const bool changed =
+                appState.input.eventSerial != lastInputEventSerial || appState.input.mouseDown ||
+                (previewSceneReady && sceneCtx.sceneGraph().hasPendingUpdates()) ||
+                idleStreamingStats.loadRequestsThisFrame != 0u ||
+                idleStreamingStats.loadsExecutedThisFrame != 0u ||
+                idleStreamingStats.unloadsExecutedThisFrame != 0u ||
+                shaderReloadRequested || pipelineReloadRequested || shadowResources.buildsPending() ||
+                frameBenchmark.active() || kernelBenchmark.active() || soakBenchmark.active() ||
+                timelinePlayer.active() || timelineRecorder.active() || imageSequence.active();
+            lastInputEventSerial = appState.input.eventSerial;
+            if (changed) {
+                renderOnDemand.noteChange();
+            }
+            const double now = glfwGetTime();
+            if (!renderOnDemand.beginFrame(now)) {
+                const double waitSeconds = renderOnDemand.waitSeconds(now);
+                if (waitSeconds < 0.0) {
+                    glfwWaitEvents();
+                } else {
+                    glfwWaitEventsTimeout(waitSeconds);
+                }
+                lastAnimationTime = glfwGetTime();
+                continue;
+            }
+        }
+        {
+            // Animation writes local transforms only; the passes in flight read the
+            // world matrices, which updateGpuScene rewrites after the wait below.
+            const double now = glfwGetTime();
+            if (previewSceneReady) {
+                sceneCtx.advanceAnimations(replayTimestep > 0.0f
+                                               ? replayTimestep
+                                               : static_cast<float>(now - lastAnimationTime));
+            }
+            lastAnimationTime = now;
+        }
+
+        {
+            METALLIC_CPU_ZONE("Frame", "Frame::WaitRender", METALLIC_CPU_ZONE_RECORDING);
+            renderThread.wait();
+            clusterStreamingService.waitForPrepareJob();
+        }
+        if (!retireRenderedFrame()) {
+            spdlog::critical("Ending Vulkan main loop after device loss: {}", vulkanDeviceLostMessage(*rhi));
+            break;
+        }
+
+        // Reflex sleeps here when enabled, then marks the simulation start. It stays
+        // behind the wait so the render thread's markers keep their own frame token.
+        streamlineCtx.beginFrame(frameIndex);
+        Jobs::JobSystem::instance().pumpMainThread();
         const bool f5Down = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
         if (f5Down && !reloadKeyDown) {
             shaderReloadRequested = true;
@@ -1985,14 +2603,79 @@ int main() {
             pipelineReloadRequested = true;
         }
         pipelineReloadKeyDown = f6Down;
-        glfwGetFramebufferSize(window, &width, &height);
-        if (width == 0 || height == 0) {
-            glfwWaitEvents();
-            continue;
+        const bool f9Down = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+        if (f9Down && !frameDumpKeyDown) {
+            slowFrameCapture.requestDump();
+        }
+        frameDumpKeyDown = f9Down;
+        if (soakBenchmark.active()) {
+            const StreamingSoakBenchmark::FrameActions soakActions =
+                soakBenchmark.update(glfwGetTime(), previewCamera, clusterStreamingService);
+            pipelineReloadRequested |= soakActions.pipelineReload;
+            visibilityHistoryResetRequested |= soakActions.storageResized;
+        }
+        frameBenchmark.update(previewCamera);
+        imageSequence.update(previewCamera);
+        // Each kernel benchmark scale adds copies of the scene and rebuilds the graph,
+        // whose cull and streaming buffers are sized from the GPU scene.
+        if (kernelBenchmark.active() && previewSceneReady) {
+            const std::vector<MeshInstanceSet> scaleInstances =
+                kernelBenchmark.update(sceneCtx.sceneGraph(), sceneCtx.mesh(),
+                                       sceneCtx.gpuScene().totalMeshletDispatchCount);
+            if (!scaleInstances.empty()) {
+                rhi->waitIdle();
+                sceneCtx.addMeshInstances(scaleInstances);
+                pipelineReloadRequested = true;
+                visibilityHistoryResetRequested = true;
+            }
+            if (kernelBenchmark.finished()) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+        }
+        // Toggles are applied and recorded here, ahead of the rebuilds they trigger,
+        // so a replayed change lands on the same frame as the recorded one.
+        if (timelinePlayer.active()) {
+            // Recorded render scales already include any dynamic resolution steps.
+            dynamicResolutionEnabled = false;
+            const bool replayClusterVis =
+                timelinePlayer.toggle("clusterVis", useClusterVisMode ? 1.0 : 0.0) != 0.0;
+            if (replayClusterVis != useClusterVisMode) {
+                useClusterVisMode = replayClusterVis;
+                postPipelineSwitchRequested = true;
+            }
+            const float replayRenderScale =
+                static_cast<float>(timelinePlayer.toggle("renderScale", visibilityRenderScale));
+            if (std::abs(replayRenderScale - visibilityRenderScale) > 0.0001f) {
+                visibilityRenderScale = replayRenderScale;
+                postBuilderNeedsRebuild = true;
+            }
+            applyDlssPresetChange(static_cast<DlssPreset>(static_cast<int>(
+                timelinePlayer.toggle("dlssPreset", static_cast<double>(static_cast<int>(dlssPreset))))));
+            const bool replayFrameGeneration =
+                timelinePlayer.toggle("frameGeneration", frameGenerationRequested ? 1.0 : 0.0) != 0.0;
+            if (replayFrameGeneration != frameGenerationRequested) {
+                frameGenerationRequested = replayFrameGeneration;
+                dlssStateDirty = true;
+                postBuilderNeedsRebuild = true;
+            }
+            enableRTShadows = timelinePlayer.toggle("rtShadows", enableRTShadows ? 1.0 : 0.0) != 0.0;
+            const uint32_t replayResets = timelinePlayer.resetFlags();
+            visibilityHistoryResetRequested |= (replayResets & CameraTimeline::kResetHistory) != 0u;
+            if ((replayResets & CameraTimeline::kResetPrevMatrices) != 0u) {
+                hasPrevMatrices = false;
+            }
+        }
+        if (timelineRecorder.active()) {
+            timelineRecorder.recordToggle("clusterVis", useClusterVisMode ? 1.0 : 0.0);
+            timelineRecorder.recordToggle("renderScale", visibilityRenderScale);
+            timelineRecorder.recordToggle("dlssPreset", static_cast<double>(static_cast<int>(dlssPreset)));
+            timelineRecorder.recordToggle("frameGeneration", frameGenerationRequested ? 1.0 : 0.0);
+            timelineRecorder.recordToggle("rtShadows", enableRTShadows ? 1.0 : 0.0);
         }
 
+        // The swapchain, viewport texture and rebuilt graph retire the old objects by
+        // submission serial, so neither resizes nor reloads drain the device.
         if (appState.framebufferResized) {
-            rhi->waitIdle();
             rhi->resize(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
             ImGui_ImplVulkan_SetMinImageCount(std::max(2u, rhi->nativeHandles().swapchainImageCount));
             recreateViewportDisplayTexture(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
@@ -2005,9 +2688,15 @@ int main() {
             }
         }
 
+        shaderManager.pollShaderChanges();
+        shaderManager.pollPipelinePermutations();
+        if (shaderManager.pollBackgroundPipelines()) {
+            refreshVisibilityPipelineState();
+            postBuilderNeedsRebuild = true;
+        }
+
         if (shaderReloadRequested) {
             shaderReloadRequested = false;
-            rhi->waitIdle();
             spdlog::info("Reloading Vulkan visibility shaders...");
             const bool previousVisibilityRenderGraph = useVisibilityRenderGraph;
             const bool previousAutoExposure = visibilityAutoExposureAvailable;
@@ -2018,13 +2707,42 @@ int main() {
             refreshVisibilityPipelineState();
 
             if (rtShadowsAvailable) {
+                // Detach the current pipeline so the reload cannot destroy it while in flight.
+                RhiComputePipelineHandle previousShadowPipeline = shadowResources.pipeline;
+                RhiShaderLibraryHandle previousShadowLibrary = shadowResources.library;
+                shadowResources.pipeline = {};
+                shadowResources.library = {};
                 if (reloadShadowPipeline(deviceHandle, shadowResources, PROJECT_SOURCE_DIR)) {
+                    rhi->deferRelease([pipeline = previousShadowPipeline.nativeHandle(),
+                                       library = previousShadowLibrary.nativeHandle()]() {
+                        rhiReleaseNativeHandle(pipeline);
+                        rhiReleaseNativeHandle(library);
+                    });
                     reloaded++;
                     spdlog::info("Reloaded Vulkan RT shadow shader");
                 } else {
+                    shadowResources.pipeline = previousShadowPipeline;
+                    shadowResources.library = previousShadowLibrary;
                     failed++;
                     spdlog::warn("Failed to reload Vulkan RT shadow shader; keeping previous pipeline");
                 }
+
+                if (shadowResources.giPipeline.nativeHandle()) {
+                    RhiComputePipelineHandle previousGiPipeline = shadowResources.giPipeline;
+                    shadowResources.giPipeline = {};
+                    if (createGiPipeline(deviceHandle, sceneCtx.mesh(), sceneCtx.materials(),
+                                         shadowResources, PROJECT_SOURCE_DIR)) {
+                        rhi->deferRelease([pipeline = previousGiPipeline.nativeHandle()]() {
+                            rhiReleaseNativeHandle(pipeline);
+                        });
+                        reloaded++;
+                        spdlog::info("Reloaded Vulkan RT GI shader");
+                    } else {
+                        shadowResources.giPipeline = previousGiPipeline;
+                        failed++;
+                        spdlog::warn("Failed to reload Vulkan RT GI shader; keeping previous pipeline");
+                    }
+                }
             }
 
             if (failed == 0) {
@@ -2053,9 +2771,16 @@ int main() {
             spdlog::info("Reloading Vulkan visibility pipeline asset...");
 
             PipelineAsset reloadedVisibilityAsset;
-            if (loadPipelineAssetChecked(visibilityPipelinePath,
-                                         "Vulkan visibility",
-                                         reloadedVisibilityAsset)) {
+            const bool reloaded = loadPipelineAssetChecked(visibilityPipelinePath,
+                                                           "Vulkan visibility",
+                                                           reloadedVisibilityAsset);
+            const bool unchanged = reloaded && visibilityPipelineBaseLoaded &&
+                                   reloadedVisibilityAsset.sameRuntimeGraph(visibilityPipelineBaseAsset);
+            if (unchanged) {
+                // Nothing the builder reads changed, so the resident graph, its history
+                // and the streaming state stay as they are.
+                spdlog::info("Vulkan visibility pipeline unchanged; keeping the resident graph");
+            } else if (reloaded) {
                 const bool previousVisibilityRenderGraph = useVisibilityRenderGraph;
                 const bool previousAutoExposure = visibilityAutoExposureAvailable;
                 const bool previousTaa = visibilityTaaAvailable;
@@ -2078,27 +2803,112 @@ int main() {
                 spdlog::warn("Keeping previous Vulkan visibility pipeline: {}",
                              visibilityPipelineBaseAsset.name);
             }
-            dlssStateDirty = true;
-            visibilityHistoryResetRequested = true;
-            if (visibilityUpscalerMode == VisibilityUpscalerMode::DLSS) streamlineCtx.resetHistory();
+            if (!unchanged) {
+                dlssStateDirty = true;
+                visibilityHistoryResetRequested = true;
+                if (visibilityUpscalerMode == VisibilityUpscalerMode::DLSS) streamlineCtx.resetHistory();
+            }
+        }
+
+        // Background scene loads are swapped in at the frame boundary. Unlike resizes
+        // and reloads this still drains the device: the old scene's textures are
+        // destroyed at once, so every bindless copy has to stop pointing at them first.
+        if (sceneCtx.isPendingLoadReady()) {
+            rhi->waitIdle();
+            descriptorBackend->flushBindlessCopies();
+            if (sceneCtx.completePendingLoad()) {
+                previewNodeCuller.invalidate();
+                shadowResources.release();
+                rtShadowsAvailable = false;
+                previewSceneReady = true;
+                cpuMirrorsReleasePending = !keepCpuMirrors;
+                rebuildRenderContext(renderContext);
+
+                if (!sceneCtx.materials().textureViews.empty()) {
+                    descriptorBackend->updateBindlessSampledTextures(
+                        sceneCtx.materials().textureViews.data(), 0,
+                        static_cast<uint32_t>(sceneCtx.materials().textureViews.size()));
+                }
+                descriptorBackend->updateBindlessSampler(
+                    METALLIC_BINDLESS_SCENE_SAMPLER_INDEX, &sceneCtx.materials().sampler);
+
+                if (rhi->features().rayTracing && enableRTShadows &&
+                    !beginAccelerationStructureBuilds(deviceHandle, queueHandle, sceneCtx.mesh(),
+                                                      &sceneCtx.clusterLod(), shadowResources)) {
+                    shadowResources.release();
+                }
+
+                previewCamera.initFromBounds(sceneCtx.mesh().bboxMin, sceneCtx.mesh().bboxMax);
+                previewCamera.distance *= 0.8f;
+                sunLight = sceneCtx.sceneGraph().getSunDirectionalLight();
+                refreshVisibilityPipelineState();
+                postBuilderNeedsRebuild = true;
+                visibilityHistoryResetRequested = true;
+                hasPrevMatrices = false;
+            }
+        }
+
+        // BLAS builds from startup or a scene load run behind the frames; once they
+        // land the TLAS and pipelines are built and the visibility graph switches
+        // over to ray-traced shadows.
+        if (shadowResources.buildsPending()) {
+            const AccelerationStructureBuildState rtBuildState =
+                finishAccelerationStructureBuilds(deviceHandle, queueHandle, sceneCtx.mesh(),
+                                                  sceneCtx.sceneGraph(), shadowResources);
+            if (rtBuildState == AccelerationStructureBuildState::Ready &&
+                createShadowPipeline(deviceHandle, shadowResources, PROJECT_SOURCE_DIR)) {
+                rtShadowsAvailable = true;
+                spdlog::info("Vulkan raytraced shadows enabled");
+                // Optional: RaytracedGiPass records nothing without it.
+                if (rhi->features().rayTracingPipeline &&
+                    !createGiPipeline(deviceHandle, sceneCtx.mesh(), sceneCtx.materials(),
+                                      shadowResources, PROJECT_SOURCE_DIR)) {
+                    spdlog::warn("Failed to create Vulkan RT GI pipeline; ray-traced GI stays disabled");
+                }
+                refreshVisibilityPipelineState();
+                postBuilderNeedsRebuild = true;
+                visibilityHistoryResetRequested = true;
+            } else if (rtBuildState != AccelerationStructureBuildState::Pending) {
+                spdlog::warn("Failed to initialize Vulkan raytraced shadows; continuing with fallback lighting");
+                shadowResources.release();
+            }
+        }
+        if (cpuMirrorsReleasePending && !shadowResources.buildsPending()) {
+            sceneCtx.releaseCpuMirrors();
+            cpuMirrorsReleasePending = false;
         }
 
         syncVisibilityUpscalerState(width, height);
         refreshPipelineUiControls();
         const int activeBuildWidth = useVisibilityRenderGraph ? runtimeContext.renderWidth : width;
         const int activeBuildHeight = useVisibilityRenderGraph ? runtimeContext.renderHeight : height;
-        if (postBuilderNeedsRebuild || postBuilder.needsRebuild(activeBuildWidth, activeBuildHeight)) {
+        if (postBuilderNeedsRebuild) {
+            residentPostBuilderStale.fill(true);
+        }
+        if (postBuilderNeedsRebuild || postPipelineSwitchRequested ||
+            postBuilder->needsRebuild(activeBuildWidth, activeBuildHeight)) {
             if (!rebuildActivePipeline(width, height)) {
                 break;
             }
             postBuilderNeedsRebuild = false;
+            if (postPipelineSwitchRequested) {
+                // A resident graph keeps the history it had when it was last shown.
+                visibilityHistoryResetRequested = true;
+                postPipelineSwitchRequested = false;
+            }
             if (streamingPipelineResetRequested) {
                 clusterStreamingService.resetForPipelineReload();
                 streamingPipelineResetRequested = false;
             }
         }
 
-        if (!rhi->beginFrame()) {
+        bool frameBegun = false;
+        {
+            // Waits on the frame-in-flight fence and acquires the swapchain image.
+            METALLIC_CPU_ZONE("Frame", "Frame::BeginFrame", METALLIC_CPU_ZONE_RECORDING);
+            frameBegun = rhi->beginFrame();
+        }
+        if (!frameBegun) {
             if (vulkanIsDeviceLost(*rhi)) {
                 spdlog::critical("Ending Vulkan main loop after device loss: {}",
                                  vulkanDeviceLostMessage(*rhi));
@@ -2110,32 +2920,52 @@ int main() {
         VkImage backbufferImage = getVulkanCurrentBackbufferImage(*rhi);
         VkImageView backbufferImageView = getVulkanCurrentBackbufferImageView(*rhi);
         VkExtent2D backbufferExtent = getVulkanCurrentBackbufferExtent(*rhi);
-        backbufferTexture.set(backbufferImage,
-                              backbufferImageView,
-                              backbufferExtent.width,
-                              backbufferExtent.height,
-                              static_cast<VkFormat>(native.colorFormat),
-                              RhiTextureUsage::RenderTarget);
 
         descriptorBackend->resetFrame();
         uploadService.beginFrame(uploadFrameCounter);
         readbackService.beginFrame(uploadFrameCounter);
+        // Copies from framesInFlight frames ago have landed; encode them off this thread.
+        imageSequence.consumeReadbacks(readbackService, uploadFrameCounter);
         ++uploadFrameCounter;
+        const int32_t sequenceFrame = imageSequence.beginFrame();
+
+        runtimeContext.textureStreamingPool = previewSceneReady ? sceneCtx.texturePool() : nullptr;
+        if (TextureStreamingPool* texturePool = runtimeContext.textureStreamingPool) {
+            texturePool->beginFrame(frameIndex);
+            // Residency swaps rewrite this frame's bindless copy only; earlier frames
+            // keep sampling the old textures, which the pool retires once they finish.
+            if (texturePool->prepareResidencyChanges(frameIndex)) {
+                const std::vector<uint32_t> changed = texturePool->applyResidencyChanges(deviceHandle);
+                const auto& textureViews = sceneCtx.materials().textureViews;
+                for (uint32_t textureIndex : changed) {
+                    descriptorBackend->updateBindlessSampledTextures(&textureViews[textureIndex],
+                                                                    textureIndex,
+                                                                    1);
+                }
+            }
+        }
         const auto barrierStats = imageTracker.stats();  // capture before clear
         imageTracker.clear();
         if (backbufferImage != VK_NULL_HANDLE) {
             imageTracker.setLayout(backbufferImage, getVulkanCurrentBackbufferLayout(*rhi));
         }
-        if (sceneColorTexture.nativeHandle()) {
-            imageTracker.setLayout(getVulkanImage(&sceneColorTexture), sceneColorLayout);
+        if (const VulkanTextureResource* sceneColorResource = getVulkanTextureResource(&sceneColorTexture)) {
+            imageTracker.setLayout(*sceneColorResource, sceneColorLayout);
+        }
+        if (const VulkanTextureResource* viewportResource = getVulkanTextureResource(&viewportDisplayTexture)) {
+            imageTracker.setLayout(*viewportResource, viewportDisplayLayout);
         }
 
-        VulkanCommandBuffer commandBuffer(getVulkanCurrentCommandBuffer(*rhi),
-                                          vkDevice,
-                                          descriptorBackend,
-                                          &imageTracker,
-                                          getVulkanGpuProfiler(*rhi),
-                                          getVulkanCurrentComputeCommandBuffer(*rhi));
+        // Lives outside the loop body: the render thread records through it after the
+        // main thread has moved on to the next frame.
+        VulkanCommandBuffer& commandBuffer = frameCommandBuffer.emplace(getVulkanCurrentCommandBuffer(*rhi),
+                                                                         vkDevice,
+                                                                         descriptorBackend,
+                                                                         &imageTracker,
+                                                                         getVulkanGpuProfiler(*rhi),
+                                                                         getVulkanCurrentComputeCommandBuffer(*rhi));
+        commandBuffer.enableQueueSegments(*rhi);
+        commandBuffer.enableParallelRecording(*rhi);
 
         // Record any deferred uploads staged since last frame
         VkCommandBuffer nativeCmd = getVulkanCurrentCommandBuffer(*rhi);
@@ -2160,10 +2990,36 @@ int main() {
             if (viewportSize.x > 0 && viewportSize.y > 0 &&
                 viewportImguiDescriptor != VK_NULL_HANDLE) {
                 ImGui::Image(reinterpret_cast<ImTextureID>(viewportImguiDescriptor), viewportSize);
+                const ImVec2 imageMin = ImGui::GetItemRectMin();
+                const ImVec2 mousePos = ImGui::GetIO().MousePos;
+                if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
+                    viewportPressed = true;
+                    viewportPressPos = mousePos;
+                }
+                if (viewportPressed && ImGui::IsMouseReleased(ImGuiMouseButton_Left)) {
+                    viewportPressed = false;
+                    const float dx = mousePos.x - viewportPressPos.x;
+                    const float dy = mousePos.y - viewportPressPos.y;
+                    if (ImGui::IsItemHovered() && dx * dx + dy * dy <= 9.0f) {
+                        // The image is stretched over the window; pick in render pixels.
+                        const float u = std::clamp((mousePos.x - imageMin.x) / viewportSize.x, 0.0f, 1.0f);
+                        const float v = std::clamp((mousePos.y - imageMin.y) / viewportSize.y, 0.0f, 1.0f);
+                        viewportPick.x = static_cast<uint32_t>(u * static_cast<float>(runtimeContext.renderWidth - 1));
+                        viewportPick.y = static_cast<uint32_t>(v * static_cast<float>(runtimeContext.renderHeight - 1));
+                        viewportPick.requested = true;
+                    }
+                }
             }
             ImGui::End();
             ImGui::PopStyleVar();
         }
+        if (viewportPick.resultReady) {
+            viewportPick.resultReady = false;
+            SceneGraph& pickedGraph = sceneCtx.sceneGraph();
+            const uint32_t pickedNode = viewportPick.result.sceneNode;
+            pickedGraph.selectedNode =
+                pickedNode < pickedGraph.nodes.size() ? static_cast<int32_t>(pickedNode) : -1;
+        }
 
         ImGui::SetNextWindowDockID(dockspaceId, ImGuiCond_FirstUseEver);
         ImGui::Begin("Vulkan Sponza");
@@ -2171,6 +3027,13 @@ int main() {
         const VulkanToolingInfo& toolingInfo = getVulkanToolingInfo(*rhi);
         const VulkanGpuFrameDiagnostics& gpuFrameDiagnostics = getVulkanLatestFrameDiagnostics(*rhi);
         const VulkanPipelineCacheTelemetry pipelineTelemetry = getVulkanPipelineCacheTelemetry(*rhi);
+        const VulkanMemoryTelemetry memoryTelemetry = getVulkanMemoryTelemetry(*rhi);
+        // The budget query is a driver call; twice a second is enough to warn in time.
+        if (frameIndex % 30u == 0u) {
+            liveMemoryBudget = getVulkanMemoryBudgetInfo(*rhi);
+            vulkanMemoryAccounting().checkBudget(liveMemoryBudget.deviceLocalUsageBytes,
+                                                 liveMemoryBudget.deviceLocalBudgetBytes);
+        }
         const std::vector<SlangDiagnosticRecord> slangDiagnostics = getRecentSlangDiagnostics();
         const bool autoExposureEnabled =
             useVisibilityRenderGraph &&
@@ -2181,7 +3044,7 @@ int main() {
             ImGui::SameLine();
             if (ImGui::Checkbox("Cluster Vis", &useClusterVisMode)) {
                 spdlog::info("Cluster visualization mode: {}", useClusterVisMode ? "ON" : "OFF");
-                postBuilderNeedsRebuild = true;
+                postPipelineSwitchRequested = true;
             }
         }
         ImGui::Text("Upscaler: %s", visibilityUpscalerModeName(visibilityUpscalerMode));
@@ -2204,6 +3067,8 @@ int main() {
                         toolingInfo.diagnosticCheckpoints ? "Enabled" : "Disabled");
             ImGui::Text("Device Fault Extension: %s",
                         toolingInfo.deviceFault ? "Enabled" : "Disabled");
+            ImGui::Text("Pipeline Executable Stats: %s",
+                        toolingInfo.pipelineExecutableStats ? "Enabled" : "Disabled");
             if (vulkanIsDeviceLost(*rhi)) {
                 ImGui::Separator();
                 ImGui::TextColored(ImVec4(1.0f, 0.35f, 0.35f, 1.0f),
@@ -2215,11 +3080,107 @@ int main() {
             ImGui::Text("Graphics PSOs compiled: %u", pipelineTelemetry.graphicsPipelinesCompiled);
             ImGui::Text("Compute PSOs compiled:  %u", pipelineTelemetry.computePipelinesCompiled);
             ImGui::Text("Total compile time:     %.2f ms", pipelineTelemetry.totalCompileMs);
+            ImGui::Text("Cache entries:          %u hit, %u miss, %u stale",
+                        pipelineTelemetry.cacheEntryHits,
+                        pipelineTelemetry.cacheEntryMisses,
+                        pipelineTelemetry.cacheEntryStale);
+            ImGui::Text("Cache entries written:  %u (%u rejected)",
+                        pipelineTelemetry.cacheEntriesWritten,
+                        pipelineTelemetry.cacheEntriesRejected);
+            if (pipelineTelemetry.pipelineLibrariesEnabled) {
+                ImGui::Text("Fast-linked PSOs:       %u (%u optimized, %u pending)",
+                            pipelineTelemetry.pipelinesFastLinked,
+                            pipelineTelemetry.pipelinesOptimized,
+                            pipelineTelemetry.pipelinesAwaitingOptimization);
+            } else {
+                ImGui::TextUnformatted("Pipeline libraries:     unavailable");
+            }
+        }
+        if (ImGui::CollapsingHeader("Shader Stats")) {
+            if (!toolingInfo.pipelineExecutableStats) {
+                ImGui::TextDisabled("Driver statistics unavailable (VK_KHR_pipeline_executable_properties)");
+            }
+            if (ImGui::Button("Refresh")) {
+                shaderPipelineStats = shaderManager.collectPipelineStats();
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Write Report")) {
+                shaderManager.writePipelineStatsReport(shaderStatsReportPath);
+            }
+            for (const ShaderPipelineStats& pipelineStats : shaderPipelineStats) {
+                if (!ImGui::TreeNode(pipelineStats.key.c_str())) {
+                    continue;
+                }
+                for (const RhiPipelineExecutableStats& executable : pipelineStats.executables) {
+                    ImGui::Text("%s (subgroup %u)", executable.name.c_str(), executable.subgroupSize);
+                    ImGui::Indent();
+                    for (const RhiShaderStatistic& statistic : executable.statistics) {
+                        ImGui::Text("%-28s %.0f", statistic.name.c_str(), statistic.value);
+                        if (!statistic.description.empty() && ImGui::IsItemHovered()) {
+                            ImGui::SetTooltip("%s", statistic.description.c_str());
+                        }
+                    }
+                    ImGui::Unindent();
+                }
+                ImGui::TreePop();
+            }
+        }
+        if (ImGui::CollapsingHeader("Memory Telemetry", ImGuiTreeNodeFlags_DefaultOpen)) {
+            ImGui::Text("VRAM blocks:            %u (%s, %u allocations)",
+                        memoryTelemetry.deviceLocalBlockCount,
+                        formatByteCountShort(memoryTelemetry.deviceLocalBlockBytes).c_str(),
+                        memoryTelemetry.deviceLocalAllocationCount);
+            ImGui::Text("Fragmentation:          %.1f%% (%s unused)",
+                        memoryTelemetry.fragmentation() * 100.0,
+                        formatByteCountShort(memoryTelemetry.deviceLocalBlockBytes -
+                                             memoryTelemetry.deviceLocalAllocationBytes).c_str());
+            ImGui::Text("Transient pool:         %s / %s (%s evicted)",
+                        formatByteCountShort(memoryTelemetry.pooledTransientBytes).c_str(),
+                        formatByteCountShort(memoryTelemetry.maxPooledTransientBytes).c_str(),
+                        formatByteCountShort(memoryTelemetry.evictedTransientBytes).c_str());
+            ImGui::Text("Defragmented:           %u buffers (%s)",
+                        memoryTelemetry.defragmentedBuffers,
+                        formatByteCountShort(memoryTelemetry.defragmentedBytes).c_str());
+            ImGui::Text("Upload ring:            %s / %s per frame (peak %s)",
+                        formatByteCountShort(memoryTelemetry.uploadRingUsedBytes).c_str(),
+                        formatByteCountShort(memoryTelemetry.uploadRingCapacityBytes).c_str(),
+                        formatByteCountShort(memoryTelemetry.uploadRingPeakBytes).c_str());
+            ImGui::Text("Upload ring overflow:   %s in %u chunks (%llu allocations)",
+                        formatByteCountShort(memoryTelemetry.uploadRingOverflowBytes).c_str(),
+                        memoryTelemetry.uploadRingOverflowChunks,
+                        static_cast<unsigned long long>(memoryTelemetry.uploadRingOverflowAllocations));
+            if (ImGui::Button("Reset Upload Peak")) {
+                getVulkanUploadRing(*rhi).resetPeak();
+            }
+            if (ImGui::TreeNode("VRAM by Subsystem")) {
+                renderVramAccountingUI(liveMemoryBudget);
+                ImGui::TreePop();
+            }
         }
         if (ImGui::CollapsingHeader("GPU Timings", ImGuiTreeNodeFlags_DefaultOpen)) {
             ImGui::Text("Last completed frame: #%llu",
                         static_cast<unsigned long long>(gpuFrameDiagnostics.frameIndex));
             ImGui::Text("Total GPU time: %.3f ms", gpuFrameDiagnostics.totalGpuMs);
+            VulkanGpuProfiler* gpuProfiler = getVulkanGpuProfiler(*rhi);
+            if (gpuProfiler && gpuProfiler->supportsPipelineStatistics()) {
+                bool pipelineStatistics = gpuProfiler->pipelineStatisticsEnabled();
+                if (ImGui::Checkbox("Pipeline Statistics Queries", &pipelineStatistics)) {
+                    gpuProfiler->setPipelineStatisticsEnabled(pipelineStatistics);
+                }
+                if (gpuProfiler->supportsPerformanceCounters()) {
+                    bool performanceCounters = gpuProfiler->performanceCountersEnabled();
+                    if (ImGui::Checkbox("Bandwidth Counters (VK_KHR_performance_query)", &performanceCounters)) {
+                        gpuProfiler->setPerformanceCountersEnabled(performanceCounters);
+                    }
+                }
+            }
+            ImGui::Text("Frames in flight: %u", rhi->framesInFlight());
+            if (rhi->features().presentWait) {
+                bool lowLatency = rhi->lowLatencyPresentWait();
+                if (ImGui::Checkbox("Low Latency Present Wait", &lowLatency)) {
+                    rhi->setLowLatencyPresentWait(lowLatency);
+                }
+            }
             if (gpuFrameDiagnostics.scopes.empty()) {
                 ImGui::TextDisabled("No pass timings captured yet.");
             } else if (ImGui::BeginTable("GpuTimings", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
@@ -2257,6 +3218,96 @@ int main() {
                 }
                 ImGui::EndTable();
             }
+            if (gpuProfiler && ImGui::TreeNode("Pass Counters")) {
+                int counterWindow = static_cast<int>(gpuProfiler->counterWindow());
+                if (ImGui::SliderInt("Window (frames)", &counterWindow, 1, 1000)) {
+                    gpuProfiler->setCounterWindow(static_cast<uint32_t>(counterWindow));
+                }
+                if (ImGui::Button("Write CSV")) {
+                    gpuProfiler->writePassCountersCsv(gpuCountersReportPath);
+                }
+                const std::vector<VulkanPerformanceCounterInfo>& performanceCounters =
+                    gpuProfiler->performanceCounters();
+                const int columnCount = 5 + static_cast<int>(performanceCounters.size());
+                if (ImGui::BeginTable("GpuPassCounters", columnCount, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                    ImGui::TableSetupColumn("Pass");
+                    ImGui::TableSetupColumn("Mean / Max (ms)");
+                    ImGui::TableSetupColumn("TS / MS");
+                    ImGui::TableSetupColumn("FS");
+                    ImGui::TableSetupColumn("CS");
+                    for (const VulkanPerformanceCounterInfo& counter : performanceCounters) {
+                        ImGui::TableSetupColumn(counter.name.c_str());
+                    }
+                    ImGui::TableHeadersRow();
+                    for (const VulkanGpuPassCounters& pass : gpuProfiler->passCounters()) {
+                        ImGui::TableNextRow();
+                        ImGui::TableSetColumnIndex(0);
+                        ImGui::TextUnformatted(pass.label.c_str());
+                        ImGui::TableSetColumnIndex(1);
+                        ImGui::Text("%.3f / %.3f", pass.meanMs, pass.maxMs);
+                        if (pass.statisticsFrames > 0) {
+                            ImGui::TableSetColumnIndex(2);
+                            ImGui::Text("%.0f / %.0f", pass.taskShaderInvocations, pass.meshShaderInvocations);
+                            ImGui::TableSetColumnIndex(3);
+                            ImGui::Text("%.0f", pass.fragmentShaderInvocations);
+                            ImGui::TableSetColumnIndex(4);
+                            ImGui::Text("%.0f", pass.computeShaderInvocations);
+                        }
+                        for (size_t counter = 0; counter < pass.performanceCounters.size(); ++counter) {
+                            std::string value =
+                                formatByteCountShort(static_cast<uint64_t>(pass.performanceCounters[counter]));
+                            if (counter < performanceCounters.size() && performanceCounters[counter].unit == "bytes/s") {
+                                value += "/s";
+                            }
+                            ImGui::TableSetColumnIndex(5 + static_cast<int>(counter));
+                            ImGui::TextUnformatted(value.c_str());
+                        }
+                    }
+                    ImGui::EndTable();
+                }
+                ImGui::TreePop();
+            }
+        }
+        if (ImGui::CollapsingHeader("GPU-Driven Funnel")) {
+            gpuDrivenTelemetry.renderUI();
+        }
+        if (ImGui::CollapsingHeader("Render On Demand")) {
+            RenderOnDemand::Settings& idleSettings = renderOnDemand.settings();
+            ImGui::Checkbox("Skip Frames When Idle", &idleSettings.enabled);
+            int settleFrames = static_cast<int>(idleSettings.settleFrames);
+            if (ImGui::SliderInt("Settle Frames", &settleFrames, 1, 128)) {
+                idleSettings.settleFrames = static_cast<uint32_t>(settleFrames);
+            }
+            ImGui::SliderFloat("Idle Refresh (s)", &idleSettings.idleRefreshSeconds, 0.0f, 5.0f, "%.2f");
+            ImGui::Text("State: %s", renderOnDemand.idle() ? "Idle" : "Rendering");
+            ImGui::Text("Skipped Frames: %llu", static_cast<unsigned long long>(renderOnDemand.skippedFrames()));
+        }
+        if (ImGui::CollapsingHeader("LOD Budget")) {
+            if (ImGui::Checkbox("Drive LOD From Budget", &lodBudgetEnabled)) {
+                lodBudget.reset(lodBudget.referencePixels());
+                runtimeContext.lodBudget = lodBudgetEnabled ? &lodBudget : nullptr;
+            }
+            LodBudgetController::Settings& lodSettings = lodBudget.settings();
+            int budgetKind = static_cast<int>(lodSettings.budget);
+            if (ImGui::Combo("Budget", &budgetKind, "Triangles\0Visibility GPU Time\0")) {
+                lodSettings.budget = static_cast<LodBudgetController::Budget>(budgetKind);
+                lodBudget.reset(lodBudget.referencePixels());
+            }
+            if (lodSettings.budget == LodBudgetController::Budget::Triangles) {
+                float millions = lodSettings.trianglesPerMegapixel * 1.0e-6f;
+                if (ImGui::SliderFloat("Triangles / Render MPixel (M)", &millions, 0.25f, 16.0f, "%.2f")) {
+                    lodSettings.trianglesPerMegapixel = millions * 1.0e6f;
+                }
+            } else {
+                ImGui::SliderFloat("Target Visibility ms", &lodSettings.targetVisibilityMs, 0.5f, 16.0f, "%.1f");
+            }
+            ImGui::SliderFloat("Dead Band", &lodSettings.deadBand, 0.0f, 0.5f, "%.2f");
+            ImGui::Text("Reference Pixels: %.1f", lodBudget.referencePixels());
+            ImGui::Text("Filtered Load: %.2f / %.2f", lodBudget.filteredLoad(), lodBudget.budgetLoad());
+            if (lodSettings.budget == LodBudgetController::Budget::Triangles &&
+                gpuDrivenTelemetry.latest().pixels == 0) {
+                ImGui::TextDisabled("Triangle counts need Pipeline Statistics Queries");
+            }
         }
         if (ImGui::CollapsingHeader("Shader Diagnostics")) {
             if (slangDiagnostics.empty()) {
@@ -2302,6 +3353,26 @@ int main() {
             if (!allowManualRenderScale) {
                 ImGui::BeginDisabled();
             }
+            // DLSS picks its own render size, so the controller only drives TAA/native.
+            if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolutionEnabled)) {
+                dynamicResolution.reset();
+            }
+            if (dynamicResolutionEnabled) {
+                DynamicResolutionController::Settings& drsSettings = dynamicResolution.settings();
+                ImGui::SliderFloat("Target GPU ms", &drsSettings.targetFrameMs, 4.0f, 50.0f, "%.1f");
+                ImGui::SliderFloat("Min Scale", &drsSettings.minScale, kMinRenderScale, 1.0f, "%.2f");
+                drsSettings.maxScale = std::max(drsSettings.maxScale, drsSettings.minScale);
+                ImGui::SliderFloat("Max Scale", &drsSettings.maxScale, drsSettings.minScale, kMaxRenderScale, "%.2f");
+                ImGui::Text("Filtered GPU time: %.2f ms", dynamicResolution.filteredGpuMs());
+                if (allowManualRenderScale &&
+                    dynamicResolution.update(gpuFrameDiagnostics.frameIndex,
+                                             gpuFrameDiagnostics.totalGpuMs,
+                                             visibilityRenderScale)) {
+                    postBuilderNeedsRebuild = true;
+                    visibilityHistoryResetRequested = true;
+                    hasPrevMatrices = false;
+                }
+            }
             float requestedRenderScale = visibilityRenderScale;
             if (ImGui::SliderFloat("Render Scale",
                                    &requestedRenderScale,
@@ -2320,6 +3391,21 @@ int main() {
                 ImGui::EndDisabled();
                 ImGui::TextUnformatted("Render Scale is disabled while DLSS is the active upscaler.");
             }
+            // Replaces TAAPass, so the render scale can drop below the display size
+            // without the tonemap doing a bilinear upscale.
+            if (!allowManualRenderScale) {
+                ImGui::BeginDisabled();
+            }
+            if (ImGui::Checkbox("Temporal Upscaler", &temporalUpscalerRequested)) {
+                refreshVisibilityPipelineState();
+                logVisibilityMode();
+                postBuilderNeedsRebuild = true;
+                visibilityHistoryResetRequested = true;
+                hasPrevMatrices = false;
+            }
+            if (!allowManualRenderScale) {
+                ImGui::EndDisabled();
+            }
             ImGui::Text("Render Resolution: %d x %d",
                         runtimeContext.renderWidth,
                         runtimeContext.renderHeight);
@@ -2331,10 +3417,18 @@ int main() {
         if (ImGui::Button("Reload Pipeline (F6)")) {
             pipelineReloadRequested = true;
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Dump Frame (F9)")) {
+            slowFrameCapture.requestDump();
+        }
         ImGui::Checkbox("FrameGraph Debug", &showGraphDebug);
         ImGui::Checkbox("Render Pass UI", &showRenderPassUI);
         ImGui::Checkbox("Scene Browser", &showSceneGraphWindow);
         ImGui::Checkbox("ImGui Demo", &showImGuiDemo);
+        ImGui::Checkbox("Publish Pass Costs", &publishCostProfile);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Feeds the Pipeline Editor cost overlay via %s", costProfilePath.c_str());
+        }
 
         const ClusterStreamingService::DebugStats& streamingStats =
             clusterStreamingService.debugStats();
@@ -2420,6 +3514,29 @@ int main() {
             if (ImGui::Button("Refresh VRAM Budget")) {
                 refreshClusterStreamingMemoryBudget();
             }
+            const uint32_t primitiveGroupCount = clusterStreamingService.primitiveGroupCount();
+            if (primitiveGroupCount > 0u &&
+                ImGui::TreeNode("Asset Importance", "Asset Importance (%u primitive groups)",
+                                primitiveGroupCount)) {
+                ImGui::TextDisabled("Scales load priority; 0 keeps an asset at its coarsest LOD.");
+                if (ImGui::Button("Reset Importance")) {
+                    clusterStreamingService.resetPrimitiveGroupImportance();
+                }
+                for (uint32_t primitiveGroupIndex = 0u; primitiveGroupIndex < primitiveGroupCount;
+                     ++primitiveGroupIndex) {
+                    float importance =
+                        clusterStreamingService.primitiveGroupImportance(primitiveGroupIndex);
+                    ImGui::PushID(static_cast<int>(primitiveGroupIndex));
+                    if (ImGui::SliderFloat("##importance", &importance, 0.0f, 16.0f, "%.2f")) {
+                        clusterStreamingService.setPrimitiveGroupImportance(primitiveGroupIndex,
+                                                                            importance);
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("Group %u", primitiveGroupIndex);
+                    ImGui::PopID();
+                }
+                ImGui::TreePop();
+            }
             if (memoryBudgetInfo.available) {
                 const std::string deviceLocalBudgetLabel =
                     formatByteCountShort(memoryBudgetInfo.deviceLocalUsageBytes) + " / " +
@@ -2446,6 +3563,10 @@ int main() {
             if (ImGui::Checkbox("Adaptive Unload Age", &adaptiveBudgetEnabled)) {
                 clusterStreamingService.setAdaptiveBudgetEnabled(adaptiveBudgetEnabled);
             }
+            bool adaptiveTaskPipelineEnabled = clusterStreamingService.adaptiveTaskPipelineEnabled();
+            if (ImGui::Checkbox("Adaptive Task Ring", &adaptiveTaskPipelineEnabled)) {
+                clusterStreamingService.setAdaptiveTaskPipelineEnabled(adaptiveTaskPipelineEnabled);
+            }
             ImGui::Text("Unload age: effective %u, base %u, adjustments %u",
                         streamingTelemetry.effectiveAgeThreshold,
                         streamingTelemetry.configuredAgeThreshold,
@@ -2477,14 +3598,15 @@ int main() {
             const std::string storagePoolLabel =
                 formatByteCountShort(streamingTelemetry.storagePoolUsedBytes) + " / " +
                 formatByteCountShort(streamingTelemetry.storagePoolCapacityBytes);
-            ImGui::Text("Storage pool usage");
+            ImGui::Text("Storage pool usage (%s reserved)",
+                        formatByteCountShort(streamingTelemetry.storagePoolReservedBytes).c_str());
             ImGui::ProgressBar(storagePoolRatio, ImVec2(-1.0f, 0.0f), storagePoolLabel.c_str());
 
             const float transferRatio =
                 std::clamp(streamingTelemetry.transferUtilization, 0.0f, 1.0f);
             const std::string transferLabel =
                 formatByteCountShort(streamingTelemetry.transferBytesThisFrame) + " / " +
-                formatByteCountShort(clusterStreamingService.effectiveStreamingTransferCapacityBytes());
+                formatByteCountShort(clusterStreamingService.streamingTaskTransferBudgetBytes());
             ImGui::Text("Transfer bandwidth");
             ImGui::ProgressBar(transferRatio, ImVec2(-1.0f, 0.0f), transferLabel.c_str());
             ImGui::Text("Transfer utilization: %.1f%%",
@@ -2519,6 +3641,23 @@ int main() {
                         streamingStats.confirmedUnloadGroupCount);
             ImGui::Text("Failed allocations this frame: %u",
                         streamingTelemetry.failedAllocations);
+            ImGui::Text("Heap fragmentation: %.1f%% (%u free ranges, largest %u clusters)",
+                        streamingTelemetry.storageFragmentation * 100.0f,
+                        streamingTelemetry.storageFreeRangeCount,
+                        streamingTelemetry.storageLargestFreeRange);
+            bool defragmentationEnabled = clusterStreamingService.defragmentationEnabled();
+            if (ImGui::Checkbox("Defragment Resident Heap", &defragmentationEnabled)) {
+                clusterStreamingService.setDefragmentationEnabled(defragmentationEnabled);
+            }
+            if (defragmentationEnabled) {
+                ImGui::SameLine();
+                ImGui::Text("%u moves", streamingTelemetry.defragMovesThisFrame);
+            }
+            if (streamingTelemetry.groupPagesOnDisk) {
+                ImGui::Text("Group page reads this frame: %u (%llu failed total)",
+                            streamingTelemetry.groupPageReadsThisFrame,
+                            static_cast<unsigned long long>(streamingTelemetry.groupPageReadFailures));
+            }
             if (!clusterStreamingService.gpuStatsReadbackEnabled()) {
                 ImGui::TextDisabled("GPU stats: disabled");
             } else if (streamingTelemetry.gpuStatsValid) {
@@ -2617,6 +3756,15 @@ int main() {
                         streamingStats.preparedStreamingTaskCount,
                         streamingStats.transferSubmittedTaskCount,
                         streamingStats.updateQueuedTaskCount);
+            ImGui::Text("Task stage latency: prepare %.1f ms, transfer %.1f ms, retire %.1f ms",
+                        streamingStats.taskPrepareLatencyMs,
+                        streamingStats.taskTransferLatencyMs,
+                        streamingStats.taskRetireLatencyMs);
+            ImGui::Text("Task throughput: %s/s, budget %s per task, %u ring stalls",
+                        formatByteCountShort(static_cast<uint64_t>(
+                            streamingStats.transferThroughputBytesPerSecond)).c_str(),
+                        formatByteCountShort(streamingStats.streamingTaskTransferBudgetBytes).c_str(),
+                        streamingStats.streamingTaskStallCount);
             if (streamingStats.selectedTransferTaskIndex != UINT32_MAX) {
                 ImGui::Text("Transfer task: slot %u, %s staged",
                             streamingStats.selectedTransferTaskIndex,
@@ -2661,50 +3809,20 @@ int main() {
                     }
 #endif
                 }
-                if (ImGui::Button("Load Scene") && scenePathBuf[0] != '\0') {
-                    rhi->waitIdle();
-                    shadowResources.release();
-                    rtShadowsAvailable = false;
-
-                    if (sceneCtx.loadScene(scenePathBuf)) {
-                        previewSceneReady = true;
-                        rebuildRenderContext(renderContext);
-
-                        if (!sceneCtx.materials().textureViews.empty()) {
-                            descriptorBackend->updateBindlessSampledTextures(
-                                sceneCtx.materials().textureViews.data(), 0,
-                                static_cast<uint32_t>(sceneCtx.materials().textureViews.size()));
-                        }
-                        descriptorBackend->updateBindlessSampler(
-                            METALLIC_BINDLESS_SCENE_SAMPLER_INDEX, &sceneCtx.materials().sampler);
-
-                        if (rhi->features().rayTracing && enableRTShadows) {
-                            if (buildAccelerationStructures(deviceHandle, queueHandle,
-                                                            sceneCtx.mesh(), sceneCtx.sceneGraph(),
-                                                            shadowResources) &&
-                                createShadowPipeline(deviceHandle, shadowResources, PROJECT_SOURCE_DIR)) {
-                                rtShadowsAvailable = true;
-                            } else {
-                                shadowResources.release();
-                            }
-                        }
-
-                        previewCamera.initFromBounds(sceneCtx.mesh().bboxMin, sceneCtx.mesh().bboxMax);
-                        previewCamera.distance *= 0.8f;
-                        sunLight = sceneCtx.sceneGraph().getSunDirectionalLight();
-                        refreshVisibilityPipelineState();
-                        postBuilderNeedsRebuild = true;
-                        visibilityHistoryResetRequested = true;
-                        hasPrevMatrices = false;
-                    } else {
-                        previewSceneReady = false;
-                    }
+                if (sceneCtx.isSceneLoading()) {
+                    ImGui::Text("Loading: %s", sceneCtx.pendingLoadPath().c_str());
+                } else if (ImGui::Button("Load Scene") && scenePathBuf[0] != '\0') {
+                    sceneCtx.beginLoadSceneAsync(scenePathBuf);
                 }
             }
             ImGui::End();
         }
 
         refreshPreviewSceneState();
+        // Late latch: the events were polled before the render-thread wait and the UI;
+        // culling and raster both read the one snapshot taken below.
+        latchCameraInput(window, &appState.input);
+        timelinePlayer.applyCamera(previewCamera);
 
         const int renderWidth = useVisibilityRenderGraph ? runtimeContext.renderWidth : width;
         const int renderHeight = useVisibilityRenderGraph ? runtimeContext.renderHeight : height;
@@ -2729,9 +3847,17 @@ int main() {
             useVisibilityRenderGraph &&
             visibilityUpscalerMode == VisibilityUpscalerMode::DLSS &&
             runtimeContext.upscaler && runtimeContext.upscaler->isEnabled();
-        const bool needsJitter = enableVisibilityTAA || enableVisibilityDlss;
+        const bool enableVisibilityTemporalUpscale =
+            useVisibilityRenderGraph &&
+            visibilityUpscalerMode == VisibilityUpscalerMode::Temporal &&
+            hasComputePipeline("TemporalUpscalePass");
+        const bool needsJitter = enableVisibilityTAA || enableVisibilityDlss || enableVisibilityTemporalUpscale;
         if (needsJitter) {
-            jitterOffset = OrbitCamera::haltonJitter(frameIndex);
+            jitterOffset = OrbitCamera::haltonJitter(
+                frameBenchmark.active() ? frameBenchmark.jitterIndex()
+                                        : timelinePlayer.active() ? timelinePlayer.frame()
+                                        : imageSequence.active() ? imageSequence.jitterIndex() : frameIndex,
+                DynamicResolutionController::jitterPhaseCount(renderWidth, runtimeContext.displayWidth));
             proj = OrbitCamera::jitteredProjectionMatrix(previewCamera.fovY,
                                                          aspect,
                                                          previewCamera.nearZ,
@@ -2745,10 +3871,23 @@ int main() {
         const bool gpuDrivenVisibilityPath =
             useVisibilityRenderGraph && visibilityGpuCullingAvailable;
 
+        // The frame before this one has been recorded (renderThread.wait above), so its
+        // pass scratch can be rewound. The node lists live in the arena too, which keeps
+        // their memory until this frame's slot comes around again.
+        FrameArena& frameArena = frameArenas.beginFrame(frameIndex);
+        std::pmr::vector<uint32_t> visibleMeshletNodes(&frameArena);
+        std::pmr::vector<uint32_t> visibleIndexNodes(&frameArena);
+        if (!previewSceneReady) {
+            visibleIndexNodes.push_back(0);
+        } else if (!gpuDrivenVisibilityPath) {
+            ZoneScopedN("CPU Node Cull");
+            previewNodeCuller.cull(unjitteredProj * view, &visibleMeshletNodes, &visibleIndexNodes);
+        }
+
         uint32_t visibilityInstanceCount = 0;
         if (useVisibilityRenderGraph) {
             static bool warnedInstanceOverflow = false;
-            if (!warnedInstanceOverflow &&
+            if (!warnedInstanceOverflow && !visibility64 &&
                 sceneCtx.gpuScene().instanceCount > (kVisibilityInstanceMask + 1u)) {
                 spdlog::warn("GPU scene instance limit exceeded for visibility encoding ({} > {}), overflowing instances will be dropped in GPU visibility mode",
                              sceneCtx.gpuScene().instanceCount,
@@ -2758,13 +3897,15 @@ int main() {
 
             if (!gpuDrivenVisibilityPath) {
                 visibilityInstanceCount = static_cast<uint32_t>(
-                    std::min<size_t>(previewVisibleMeshletNodes.size(),
-                                     static_cast<size_t>(kVisibilityInstanceMask + 1u)));
+                    visibility64 ? visibleMeshletNodes.size()
+                                 : std::min<size_t>(visibleMeshletNodes.size(),
+                                                    static_cast<size_t>(kVisibilityInstanceMask + 1u)));
             }
         }
 
         RhiNativeCommandBufferHandle nativeCommandBuffer(getVulkanCurrentCommandBuffer(*rhi));
         frameContext = FrameContext{};
+        frameContext.frameMemory = &frameArena;
         frameContext.width = renderWidth;
         frameContext.height = renderHeight;
         frameContext.view = view;
@@ -2798,30 +3939,68 @@ int main() {
         frameContext.materialCount = sceneCtx.materials().materialCount;
         frameContext.textureCount = static_cast<uint32_t>(sceneCtx.materials().textures.size());
         if (!gpuDrivenVisibilityPath) {
-            frameContext.visibleMeshletNodes = previewVisibleMeshletNodes;
+            frameContext.visibleMeshletNodes = visibleMeshletNodes;
             if (useVisibilityRenderGraph &&
                 frameContext.visibleMeshletNodes.size() > static_cast<size_t>(visibilityInstanceCount)) {
-                frameContext.visibleMeshletNodes.resize(visibilityInstanceCount);
+                frameContext.visibleMeshletNodes = frameContext.visibleMeshletNodes.first(visibilityInstanceCount);
             }
-            frameContext.visibleIndexNodes = previewVisibleIndexNodes;
+            frameContext.visibleIndexNodes = visibleIndexNodes;
         }
         frameContext.visibilityInstanceCount = visibilityInstanceCount;
         frameContext.depthClearValue = depthClearValue;
         frameContext.cameraFarZ = previewCamera.farZ;
         {
             const double now = glfwGetTime();
-            frameContext.deltaTime = static_cast<float>(now - lastFrameTime);
+            frameContext.deltaTime = replayTimestep > 0.0f ? replayTimestep
+                                                           : static_cast<float>(now - lastFrameTime);
             lastFrameTime = now;
         }
         frameContext.enableRTShadows =
             useVisibilityRenderGraph && rtShadowsAvailable && enableRTShadows;
+        if (useVisibilityRenderGraph && gpuDrivenVisibilityPath && !rtShadowsAvailable &&
+            hasComputePipeline("ShadowCascadeResolvePass")) {
+            ShadowCascadeController::Inputs cascadeInputs;
+            cascadeInputs.cameraPos = cameraWorldPos3;
+            cascadeInputs.cameraRight = cameraRight;
+            cascadeInputs.cameraUp = cameraUp;
+            cascadeInputs.cameraForward = cameraForward;
+            cascadeInputs.fovY = previewCamera.fovY;
+            cascadeInputs.aspect = aspect;
+            cascadeInputs.nearZ = previewCamera.nearZ;
+            cascadeInputs.farZ = previewCamera.farZ;
+            cascadeInputs.toLight = sunDirection;
+            const float* sceneMin = sceneCtx.mesh().bboxMin;
+            const float* sceneMax = sceneCtx.mesh().bboxMax;
+            cascadeInputs.sceneMin = float3(sceneMin[0], sceneMin[1], sceneMin[2]);
+            cascadeInputs.sceneMax = float3(sceneMax[0], sceneMax[1], sceneMax[2]);
+            cascadeInputs.sceneRevision = sceneCtx.gpuScene().contentRevision;
+            cascadeInputs.historyReset = visibilityHistoryResetRequested;
+            shadowCascadeController.update(cascadeInputs, frameContext.shadowCascades);
+        } else {
+            shadowCascadeController.reset();
+        }
         frameContext.enableAtmosphereSky = atmosphereSkyAvailable;
         frameContext.gpuDrivenCulling = gpuDrivenVisibilityPath;
         frameContext.renderMode = useVisibilityRenderGraph ? 2 : 0;
 
-        postBuilder.updateFrame(&backbufferTexture, &frameContext);
-
-        FrameGraph& activeFg = postBuilder.frameGraph();
+        timelineRecorder.recordFrame(previewCamera,
+                                     (visibilityHistoryResetRequested ? CameraTimeline::kResetHistory : 0u) |
+                                         (hasPrevMatrices ? 0u : CameraTimeline::kResetPrevMatrices));
+        postBuilder->updateFrame(&viewportDisplayTexture, &frameContext);
+
+        FrameGraph& activeFg = postBuilder->frameGraph();
+        activeFg.recordGpuTimings(gpuFrameDiagnostics.frameIndex,
+                                  frameGraphGpuScopeSamples(gpuFrameDiagnostics));
+        if (publishCostProfile && glfwGetTime() - lastCostProfilePublishTime >= 0.25) {
+            lastCostProfilePublishTime = glfwGetTime();
+            PipelineCostProfile costProfile;
+            postBuilder->collectCostProfile(costProfile);
+            costProfile.frameIndex = frameIndex;
+            if (!costProfile.publish(costProfilePath)) {
+                spdlog::warn("Failed to publish pass costs to {}; publishing disabled", costProfilePath);
+                publishCostProfile = false;
+            }
+        }
         if (showGraphDebug) {
             ImGui::SetNextWindowDockID(dockspaceId, ImGuiCond_FirstUseEver);
             activeFg.debugImGui();
@@ -2835,160 +4014,210 @@ int main() {
             ImGui::ShowDemoWindow(&showImGuiDemo);
         }
         ImGui::Render();
+        streamlineCtx.markLatency(LatencyMarker::SimulationEnd);
 
-        if (!useVisibilityRenderGraph) {
-            sceneGraph.execute(commandBuffer, frameGraphBackend);
-        }
+        // Read by the slow frame capture once the frame has been presented.
+        const bool expectedFrameHitch = visibilityHistoryResetRequested;
+        visibilityHistoryResetRequested = false;
 
-        if (useVisibilityRenderGraph && rtShadowsAvailable) {
-            updateTLAS(nativeCommandBuffer, sceneCtx.sceneGraph(), shadowResources);
-        }
+        // --- Render: graph execution, UI draw recording, submit and present ---
+        // Everything the tail reads is either captured here or left alone by the main
+        // thread until its next renderThread.wait().
+        renderedFrame = RenderedFrame{};
+        renderThread.kick([&,
+                           nativeCommandBuffer,
+                           nativeCmd,
+                           backbufferImage,
+                           backbufferImageView,
+                           backbufferExtent,
+                           renderFrameIndex = frameIndex,
+                           sequenceFrame,
+                           frameStartSeconds,
+                           expectedFrameHitch]() mutable {
+            VulkanCommandBuffer& commandBuffer = *frameCommandBuffer;
+            renderedFrame.pending = true;
+            renderedFrame.frameIndex = renderFrameIndex;
+            renderedFrame.startSeconds = frameStartSeconds;
+            renderedFrame.expectedHitch = expectedFrameHitch;
+            streamlineCtx.markLatency(LatencyMarker::RenderSubmitStart);
+
+            if (!useVisibilityRenderGraph) {
+                sceneGraph.execute(commandBuffer, frameGraphBackend);
+                // Async compute handoffs may have moved recording to a new command buffer.
+                nativeCmd = getVulkanCurrentCommandBuffer(*rhi);
+                nativeCommandBuffer.setNativeHandle(nativeCmd);
+            }
+
+            // The streaming prepare job overlapped graph recording; residency and the
+            // streaming stats are read from here on.
+            clusterStreamingService.waitForPrepareJob();
+            if (useVisibilityRenderGraph && rtShadowsAvailable) {
+                updateRaytracingLod(deviceHandle, queueHandle, sceneCtx.mesh(), sceneCtx.clusterLod(),
+                                    &clusterStreamingService, shadowResources);
+                updateTLAS(nativeCommandBuffer, sceneCtx.sceneGraph(), shadowResources);
+            }
 
-        // Ensure sceneColorTexture is in SHADER_READ_ONLY_OPTIMAL for ImGui::Image sampling
-        // The frame graph doesn't know about the ImGui descriptor reference, so we insert
-        // a manual barrier. On the first frame (UNDEFINED), this transitions to readable state.
-        if (sceneColorTexture.nativeHandle() && !useVisibilityRenderGraph) {
-            VkImage sceneColorImage = getVulkanImage(&sceneColorTexture);
-            if (sceneColorImage != VK_NULL_HANDLE) {
+            // Ensure sceneColorTexture is in SHADER_READ_ONLY_OPTIMAL for ImGui::Image sampling
+            // The frame graph doesn't know about the ImGui descriptor reference, so we insert
+            // a manual barrier. On the first frame (UNDEFINED), this transitions to readable state.
+            if (sceneColorTexture.nativeHandle() && !useVisibilityRenderGraph) {
+                VkImage sceneColorImage = getVulkanImage(&sceneColorTexture);
+                if (sceneColorImage != VK_NULL_HANDLE) {
+                    VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+                    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                           VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+                    barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_2_SHADER_WRITE_BIT;
+                    barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+                    barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+                    barrier.oldLayout = sceneColorLayout;
+                    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                    barrier.image = sceneColorImage;
+                    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+                    VkDependencyInfo depInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+                    depInfo.imageMemoryBarrierCount = 1;
+                    depInfo.pImageMemoryBarriers = &barrier;
+                    vkCmdPipelineBarrier2(nativeCmd, &depInfo);
+
+                    sceneColorLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                    imageTracker.setLayout(*getVulkanTextureResource(&sceneColorTexture), sceneColorLayout);
+                }
+            }
+
+            postBuilder->execute(commandBuffer, frameGraphBackend);
+            nativeCmd = getVulkanCurrentCommandBuffer(*rhi);
+
+            // Image sequences copy the finished frame out before the UI samples it.
+            if (sequenceFrame >= 0) {
+                if (const VulkanTextureResource* viewportResource = getVulkanTextureResource(&viewportDisplayTexture)) {
+                    const VkImageLayout readbackLayout =
+                        imageSequence.recordReadback(readbackService, nativeCmd, viewportResource->image,
+                                                     imageTracker.getLayout(*viewportResource),
+                                                     viewportResource->width, viewportResource->height,
+                                                     sequenceFrame);
+                    imageTracker.setLayout(*viewportResource, readbackLayout);
+                }
+            }
+
+            // The graph drew straight into the viewport texture at window resolution;
+            // hand it to ImGui::Image.
+            if (const VulkanTextureResource* viewportResource = getVulkanTextureResource(&viewportDisplayTexture)) {
                 VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
                 barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT |
-                                       VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
-                barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
-                                        VK_ACCESS_2_SHADER_WRITE_BIT;
+                                       VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
                 barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
                 barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
-                barrier.oldLayout = sceneColorLayout;
+                barrier.oldLayout = imageTracker.getLayout(*viewportResource);
                 barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                barrier.image = sceneColorImage;
+                barrier.image = viewportResource->image;
                 barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
 
-                VkDependencyInfo depInfo{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-                depInfo.imageMemoryBarrierCount = 1;
-                depInfo.pImageMemoryBarriers = &barrier;
-                vkCmdPipelineBarrier2(nativeCmd, &depInfo);
-
-                sceneColorLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                imageTracker.setLayout(sceneColorImage, sceneColorLayout);
-            }
-        }
-
-        postBuilder.execute(commandBuffer, frameGraphBackend);
-
-        // Blit backbuffer to viewport display texture for ImGui::Image
-        if (viewportDisplayTexture.nativeHandle() && backbufferImage != VK_NULL_HANDLE) {
-            VkImage vpImage = getVulkanImage(&viewportDisplayTexture);
-            if (vpImage != VK_NULL_HANDLE) {
-                uint32_t vpW = viewportDisplayTexture.width();
-                uint32_t vpH = viewportDisplayTexture.height();
-
-                VkImageMemoryBarrier2 barriers[2] = {};
-                barriers[0] = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-                barriers[0].srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-                barriers[0].srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
-                barriers[0].dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
-                barriers[0].dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-                barriers[0].oldLayout = imageTracker.getLayout(backbufferImage);
-                barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                barriers[0].image = backbufferImage;
-                barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-                barriers[1] = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-                barriers[1].srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-                barriers[1].srcAccessMask = VK_ACCESS_2_NONE;
-                barriers[1].dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
-                barriers[1].dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-                barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-                barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barriers[1].image = vpImage;
-                barriers[1].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
                 VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-                dep.imageMemoryBarrierCount = 2;
-                dep.pImageMemoryBarriers = barriers;
+                dep.imageMemoryBarrierCount = 1;
+                dep.pImageMemoryBarriers = &barrier;
                 vkCmdPipelineBarrier2(nativeCmd, &dep);
 
-                VkImageBlit2 blitRegion{VK_STRUCTURE_TYPE_IMAGE_BLIT_2};
-                blitRegion.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
-                blitRegion.srcOffsets[1] = {static_cast<int32_t>(width), static_cast<int32_t>(height), 1};
-                blitRegion.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
-                blitRegion.dstOffsets[1] = {static_cast<int32_t>(vpW), static_cast<int32_t>(vpH), 1};
-
-                VkBlitImageInfo2 blitInfo{VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2};
-                blitInfo.srcImage = backbufferImage;
-                blitInfo.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                blitInfo.dstImage = vpImage;
-                blitInfo.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                blitInfo.regionCount = 1;
-                blitInfo.pRegions = &blitRegion;
-                blitInfo.filter = VK_FILTER_LINEAR;
-                vkCmdBlitImage2(nativeCmd, &blitInfo);
-
-                VkImageMemoryBarrier2 postBarriers[2] = {};
-                postBarriers[0] = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-                postBarriers[0].srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
-                postBarriers[0].srcAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
-                postBarriers[0].dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
-                postBarriers[0].dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
-                postBarriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                postBarriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-                postBarriers[0].image = backbufferImage;
-                postBarriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-                postBarriers[1] = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
-                postBarriers[1].srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
-                postBarriers[1].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-                postBarriers[1].dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
-                postBarriers[1].dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
-                postBarriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                postBarriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                postBarriers[1].image = vpImage;
-                postBarriers[1].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-
-                VkDependencyInfo postDep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
-                postDep.imageMemoryBarrierCount = 2;
-                postDep.pImageMemoryBarriers = postBarriers;
-                vkCmdPipelineBarrier2(nativeCmd, &postDep);
+                viewportDisplayLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                imageTracker.setLayout(*viewportResource, viewportDisplayLayout);
+            }
 
+            // Render ImGui straight into the swapchain image. The graph never touches it
+            // and the docked UI covers the whole window, so its contents are discarded
+            // instead of loaded.
+            if (backbufferImage != VK_NULL_HANDLE) {
+                VkImageMemoryBarrier2 barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2};
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                barrier.image = backbufferImage;
+                barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+                VkDependencyInfo dep{VK_STRUCTURE_TYPE_DEPENDENCY_INFO};
+                dep.imageMemoryBarrierCount = 1;
+                dep.pImageMemoryBarriers = &barrier;
+                vkCmdPipelineBarrier2(nativeCmd, &dep);
                 imageTracker.setLayout(backbufferImage, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+                VkRenderingAttachmentInfo colorAttach{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+                colorAttach.imageView = backbufferImageView;
+                colorAttach.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                colorAttach.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                colorAttach.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                colorAttach.clearValue.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+
+                VkRenderingInfo renderInfo{VK_STRUCTURE_TYPE_RENDERING_INFO};
+                renderInfo.renderArea = {{0, 0}, backbufferExtent};
+                renderInfo.layerCount = 1;
+                renderInfo.colorAttachmentCount = 1;
+                renderInfo.pColorAttachments = &colorAttach;
+
+                vkCmdBeginRendering(nativeCmd, &renderInfo);
+                ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), nativeCmd);
+                vkCmdEndRendering(nativeCmd);
             }
-        }
 
-        // Render ImGui directly to backbuffer (ImGuiOverlayPass removed from pipeline)
-        {
-            VkRenderingAttachmentInfo colorAttach{VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
-            colorAttach.imageView = backbufferImageView;
-            colorAttach.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            colorAttach.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-            colorAttach.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            // After pipeline execution, sceneColorTexture is ready for ImGui sampling next frame
+            if (sceneColorTexture.nativeHandle()) {
+                sceneColorLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            }
 
-            VkRenderingInfo renderInfo{VK_STRUCTURE_TYPE_RENDERING_INFO};
-            renderInfo.renderArea = {{0, 0}, backbufferExtent};
-            renderInfo.layerCount = 1;
-            renderInfo.colorAttachmentCount = 1;
-            renderInfo.pColorAttachments = &colorAttach;
+            if (native.transferTimelineSemaphore != nullptr) {
+                // This frame's streaming and upload copies go to the transfer queue in
+                // one submission, ahead of the graphics submit that waits on them.
+                uploadService.flushTransferBatch();
+                const uint64_t transferWaitValue =
+                    clusterStreamingService.consumePendingTransferWaitValue();
+                if (transferWaitValue != 0u) {
+                    vulkanEnqueueGraphicsTimelineWait(
+                        *rhi,
+                        nativeToVkHandle<VkSemaphore>(native.transferTimelineSemaphore),
+                        transferWaitValue,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+                }
+                // Scene geometry streamed in on the transfer queue this frame.
+                const uint64_t streamedWaitValue = uploadService.consumeStreamedWaitValue();
+                if (streamedWaitValue != 0u) {
+                    vulkanEnqueueGraphicsTimelineWait(
+                        *rhi,
+                        nativeToVkHandle<VkSemaphore>(native.transferTimelineSemaphore),
+                        streamedWaitValue,
+                        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+                }
+            }
 
-            vkCmdBeginRendering(nativeCmd, &renderInfo);
-            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), nativeCmd);
-            vkCmdEndRendering(nativeCmd);
-        }
+            soakBenchmark.recordFrame(renderFrameIndex, clusterStreamingService);
+            if (soakBenchmark.finished()) {
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+            gpuDrivenTelemetry.commitFrame(renderFrameIndex);
+            if (lodBudgetEnabled) {
+                lodBudget.update(gpuDrivenTelemetry.latest(), runtimeContext.renderWidth, runtimeContext.renderHeight);
+            }
 
-        // After pipeline execution, sceneColorTexture is ready for ImGui sampling next frame
-        if (sceneColorTexture.nativeHandle()) {
-            sceneColorLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        }
-        visibilityHistoryResetRequested = false;
+            // If any pass routed work to the dedicated async compute queue, submit it now.
+            if (commandBuffer.hadAsyncComputeWork()) {
+                vulkanScheduleAsyncComputeSubmit(*rhi);
+                if (vulkanIsDeviceLost(*rhi)) {
+                    renderedFrame.deviceLost = true;
+                    return;
+                }
+            }
 
-        if (native.transferTimelineSemaphore != nullptr) {
-            const uint64_t transferWaitValue =
-                clusterStreamingService.consumePendingTransferWaitValue();
-            if (transferWaitValue != 0u) {
-                vulkanEnqueueGraphicsTimelineWait(
-                    *rhi,
-                    nativeToVkHandle<VkSemaphore>(native.transferTimelineSemaphore),
-                    transferWaitValue,
-                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+            streamlineCtx.markLatency(LatencyMarker::RenderSubmitEnd);
+            streamlineCtx.markLatency(LatencyMarker::PresentStart);
+            {
+                METALLIC_CPU_ZONE("Frame", "Frame::SubmitPresent", METALLIC_CPU_ZONE_RECORDING);
+                rhi->endFrame();
             }
-        }
+            streamlineCtx.markLatency(LatencyMarker::PresentEnd);
+            renderedFrame.presentSeconds = glfwGetTime();
+            renderedFrame.deviceLost = vulkanIsDeviceLost(*rhi);
+        });
 
         prevView = view;
         prevProj = unjitteredProj;
@@ -2996,27 +4225,23 @@ int main() {
         prevCullProj = proj;
         prevCameraWorldPos = frameContext.cameraWorldPos;
         hasPrevMatrices = true;
+        timelinePlayer.advance();
         frameIndex++;
-
-        // If any pass routed work to the dedicated async compute queue, submit it now.
-        if (commandBuffer.hadAsyncComputeWork()) {
-            vulkanScheduleAsyncComputeSubmit(*rhi);
-            if (vulkanIsDeviceLost(*rhi)) {
-                spdlog::critical("Async compute submit reported device loss: {}",
-                                 vulkanDeviceLostMessage(*rhi));
-                break;
-            }
-        }
-
-        rhi->endFrame();
-        if (vulkanIsDeviceLost(*rhi)) {
-            spdlog::critical("Graphics submit/present reported device loss: {}",
-                             vulkanDeviceLostMessage(*rhi));
-            break;
-        }
         FrameMark;
     }
-
+    renderThread.wait();
+    clusterStreamingService.waitForPrepareJob();
+    retireRenderedFrame();
+    imageSequence.finish();
+
+    timelineRecorder.finish(glfwGetTime());
+    shaderManager.savePipelineManifest();
+    if (writeShaderStatsOnExit) {
+        shaderManager.writePipelineStatsReport(shaderStatsReportPath);
+    }
+    if (VulkanGpuProfiler* gpuProfiler = getVulkanGpuProfiler(*rhi); gpuProfiler && writeGpuCountersOnExit) {
+        gpuProfiler->writePassCountersCsv(gpuCountersReportPath);
+    }
     cleanupRuntimeResources();
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -7,9 +7,11 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <map>
 #include <numeric>
+#include <system_error>
 
 namespace {
 
@@ -331,6 +333,18 @@ bool isTerminalResource(const ResourceDecl& resource) {
     return resource.kind == "imported" || resource.kind == "backbuffer";
 }
 
+// Green for cheap passes through red for the most expensive one in the frame.
+ImU32 costHeatColor(float fraction) {
+    const float t = std::clamp(fraction, 0.0f, 1.0f);
+    const float r = t < 0.5f ? 40.0f + t * 2.0f * 150.0f : 190.0f;
+    const float g = t < 0.5f ? 130.0f : 130.0f - (t - 0.5f) * 2.0f * 95.0f;
+    return IM_COL32(static_cast<int>(r), static_cast<int>(g), 45, 255);
+}
+
+float bytesToMiB(uint64_t bytes) {
+    return static_cast<float>(double(bytes) / (1024.0 * 1024.0));
+}
+
 } // namespace
 
 void PipelineEditor::pushUndo(const PipelineAsset& asset) {
@@ -427,6 +441,8 @@ void PipelineEditor::render(PipelineAsset& asset) {
         return;
     }
 
+    pollCostProfile();
+
     ImGui::SetNextWindowSize(ImVec2(1200, 720), ImGuiCond_FirstUseEver);
     if (ImGui::Begin("Pipeline Editor", &m_visible, ImGuiWindowFlags_MenuBar)) {
         if (ImGui::BeginMenuBar()) {
@@ -543,6 +559,90 @@ void PipelineEditor::renderGraphToolbar(PipelineAsset& asset) {
     ImGui::TextDisabled("|");
     ImGui::SameLine();
     ImGui::TextDisabled("Falcor-style tip: inspect flow in Pass Flow, edit exact resources in Resource Graph.");
+
+    renderCostToolbar(asset);
+}
+
+// The renderer rewrites the profile a few times a second while "Publish Pass Costs" is
+// on; a file that stops changing means no instance is publishing any more.
+void PipelineEditor::pollCostProfile() {
+    const double now = ImGui::GetTime();
+    if (m_lastCostPollTime >= 0.0 && now - m_lastCostPollTime < 0.5) {
+        return;
+    }
+    m_lastCostPollTime = now;
+
+    std::error_code error;
+    const auto writeTime = std::filesystem::last_write_time(m_costProfilePath, error);
+    if (error) {
+        m_costProfileLive = false;
+        return;
+    }
+    const auto age = std::filesystem::file_time_type::clock::now() - writeTime;
+    m_costProfileLive = age < std::chrono::seconds(2);
+    if (writeTime != m_costProfileWriteTime &&
+        PipelineCostProfile::read(m_costProfilePath, m_costProfile)) {
+        m_costProfileWriteTime = writeTime;
+    }
+}
+
+void PipelineEditor::renderCostToolbar(const PipelineAsset& asset) {
+    m_memoryEstimate = estimatePipelineTransientMemory(asset, m_estimateWidth, m_estimateHeight);
+
+    ImGui::Checkbox("Cost Overlay", &m_showCostOverlay);
+    ImGui::SameLine();
+    ImGui::TextDisabled("|");
+    ImGui::SameLine();
+    const bool liveMatches = m_costProfileLive && m_costProfile.pipelineName == asset.name;
+    if (liveMatches) {
+        float gpuTotalMs = 0.0f;
+        float cpuTotalMs = 0.0f;
+        for (const auto& pass : m_costProfile.passes) {
+            gpuTotalMs += pass.gpuMerged ? 0.0f : pass.gpuAvgMs;
+            cpuTotalMs += pass.cpuRecordMs;
+        }
+        ImGui::TextColored(ImVec4(0.4f, 0.9f, 0.5f, 1.0f), "Live");
+        ImGui::SameLine();
+        ImGui::Text("%dx%d  GPU %.2f ms  CPU %.2f ms  transients %.1f MB (heap %.1f MB, %u aliased)",
+                    m_costProfile.renderWidth,
+                    m_costProfile.renderHeight,
+                    gpuTotalMs,
+                    cpuTotalMs,
+                    bytesToMiB(m_costProfile.transientRequestedBytes),
+                    bytesToMiB(m_costProfile.transientHeapBytes),
+                    m_costProfile.aliasedTextureCount);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("GPU total leaves out merged render passes. Frame %llu.",
+                              static_cast<unsigned long long>(m_costProfile.frameIndex));
+        }
+    } else if (m_costProfileLive) {
+        ImGui::TextDisabled("Metallic is running '%s', not this pipeline", m_costProfile.pipelineName.c_str());
+    } else {
+        ImGui::TextDisabled("No live costs: enable Publish Pass Costs in Metallic");
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Reads %s", m_costProfilePath.c_str());
+        }
+    }
+
+    ImGui::SetNextItemWidth(110.0f);
+    ImGui::InputInt("##estimate_width", &m_estimateWidth, 0, 0);
+    ImGui::SameLine();
+    ImGui::TextUnformatted("x");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(110.0f);
+    ImGui::InputInt("##estimate_height", &m_estimateHeight, 0, 0);
+    m_estimateWidth = std::clamp(m_estimateWidth, 1, 16384);
+    m_estimateHeight = std::clamp(m_estimateHeight, 1, 16384);
+    ImGui::SameLine();
+    ImGui::Text("Estimated transients: %u textures, %.1f MB, %.1f MB with aliasing",
+                m_memoryEstimate.textureCount,
+                bytesToMiB(m_memoryEstimate.totalBytes),
+                bytesToMiB(m_memoryEstimate.peakBytes));
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("From the graph alone. The aliased figure is the peak of overlapping lifetimes\n"
+                          "in pass order; real heaps add alignment and padding.%s",
+                          m_memoryEstimate.unknownFormatCount > 0 ? "\nSome formats are unknown and count as BGRA8." : "");
+    }
 }
 
 void PipelineEditor::renderNodeGraph(PipelineAsset& asset) {
@@ -569,6 +669,14 @@ void PipelineEditor::renderNodeGraph(PipelineAsset& asset) {
         }
     }
 
+    const bool liveCosts = m_showCostOverlay && m_costProfileLive && m_costProfile.pipelineName == asset.name;
+    float maxPassGpuMs = 0.0f;
+    if (liveCosts) {
+        for (const auto& cost : m_costProfile.passes) {
+            maxPassGpuMs = std::max(maxPassGpuMs, cost.gpuAvgMs);
+        }
+    }
+
     ImNodes::BeginNodeEditor();
 
     const float resourceX = 40.0f;
@@ -616,6 +724,12 @@ void PipelineEditor::renderNodeGraph(PipelineAsset& asset) {
         if (resource.kind == "imported" && !resource.importKey.empty()) {
             ImGui::TextDisabled("key: %s", resource.importKey.c_str());
         }
+        if (m_showCostOverlay) {
+            auto bytesIt = m_memoryEstimate.resourceBytes.find(resource.id);
+            if (bytesIt != m_memoryEstimate.resourceBytes.end()) {
+                ImGui::TextDisabled("~%.1f MB at %dx%d", bytesToMiB(bytesIt->second), m_estimateWidth, m_estimateHeight);
+            }
+        }
 
         auto flowIt = flowMap.find(resource.id);
         if (flowIt != flowMap.end()) {
@@ -655,7 +769,11 @@ void PipelineEditor::renderNodeGraph(PipelineAsset& asset) {
                   fallbackPos,
                   m_graphViewMode == GraphViewMode::ResourceGraph);
 
-        const ImU32 titleColor = passCategoryTitleColor(passTypeInfo);
+        const PipelinePassCost* cost = liveCosts ? m_costProfile.findPass(pass.name) : nullptr;
+        ImU32 titleColor = passCategoryTitleColor(passTypeInfo);
+        if (cost && cost->live && maxPassGpuMs > 0.0f) {
+            titleColor = costHeatColor(cost->gpuAvgMs / maxPassGpuMs);
+        }
         ImNodes::PushColorStyle(ImNodesCol_TitleBar, titleColor);
         ImNodes::PushColorStyle(ImNodesCol_TitleBarHovered, brightenColor(titleColor, 18));
         ImNodes::PushColorStyle(ImNodesCol_TitleBarSelected, brightenColor(titleColor, 36));
@@ -669,6 +787,22 @@ void PipelineEditor::renderNodeGraph(PipelineAsset& asset) {
         ImNodes::EndNodeTitleBar();
 
         ImGui::TextDisabled("(%s | %s)", pass.type.c_str(), passTypeInfo.category.c_str());
+        if (m_showCostOverlay) {
+            if (cost && !cost->live) {
+                ImGui::TextDisabled("culled this frame");
+            } else if (cost) {
+                ImGui::Text("GPU %.3f ms%s  CPU %.3f ms",
+                            cost->gpuAvgMs,
+                            cost->gpuMerged ? " (merged)" : "",
+                            cost->cpuRecordMs);
+                if (cost->transientBytes > 0) {
+                    ImGui::Text("creates %.1f MB", bytesToMiB(cost->transientBytes));
+                }
+            } else if (auto bytesIt = m_memoryEstimate.passBytes.find(pass.id);
+                       bytesIt != m_memoryEstimate.passBytes.end() && bytesIt->second > 0) {
+                ImGui::TextDisabled("creates ~%.1f MB", bytesToMiB(bytesIt->second));
+            }
+        }
 
         for (const auto& slot : passTypeInfo.inputSlots) {
             if (slot.hidden) {
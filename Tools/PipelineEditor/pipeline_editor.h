@@ -1,6 +1,8 @@
 #pragma once
 
 #include "pipeline_asset.h"
+#include "pipeline_cost_profile.h"
+#include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -52,7 +54,9 @@ private:
         std::string slotKey;
     };
 
+    void pollCostProfile();
     void renderGraphToolbar(PipelineAsset& asset);
+    void renderCostToolbar(const PipelineAsset& asset);
     void renderNodeGraph(PipelineAsset& asset);
     void renderPropertyPanel(PipelineAsset& asset);
     void renderCompilationPreview(const PipelineAsset& asset);
@@ -87,6 +91,17 @@ private:
     std::vector<PipelineAsset> m_redoStack;
     static constexpr int kMaxUndoLevels = 50;
 
+    // Live costs published by a running Metallic, and the offline transient estimate.
+    bool m_showCostOverlay = true;
+    std::string m_costProfilePath = PipelineCostProfile::defaultChannelPath();
+    PipelineCostProfile m_costProfile;
+    std::filesystem::file_time_type m_costProfileWriteTime{};
+    bool m_costProfileLive = false;
+    double m_lastCostPollTime = -1.0;
+    int m_estimateWidth = 1920;
+    int m_estimateHeight = 1080;
+    PipelineMemoryEstimate m_memoryEstimate;
+
     bool m_hasTextEditSnapshot = false;
     ImVec2 m_contextMenuSpawnPos = {0, 0};
 };